@@ -13,6 +13,12 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// The policy used to pick the assets to remove when the assets store exceeds its maximum size.
+typedef NS_ENUM(NSInteger, ETCoreMLAssetEvictionPolicy) {
+    ETCoreMLAssetEvictionPolicyLeastFrequentlyUsed = 0, // Remove the least accessed assets first.
+    ETCoreMLAssetEvictionPolicyLeastRecentlyUsed, // Remove the assets with the oldest access first.
+};
+
 /// A class responsible for managing the assets created by the delegate.
 @interface ETCoreMLAssetManager : NSObject
 
@@ -110,8 +116,13 @@ NS_ASSUME_NONNULL_BEGIN
 /// directory is tampered externally.
 @property (assign, readonly, atomic) NSInteger estimatedSizeInBytes;
 
-/// The maximum size of the assets store.
-@property (assign, readonly, nonatomic) NSInteger maxAssetsSizeInBytes;
+/// The maximum size of the assets store. Lowering the size compacts the assets store, the assets
+/// in use are never removed.
+@property (assign, nonatomic) NSInteger maxAssetsSizeInBytes;
+
+/// The policy used to pick the assets to remove during compaction, defaults to
+/// `ETCoreMLAssetEvictionPolicyLeastFrequentlyUsed`.
+@property (assign, atomic) ETCoreMLAssetEvictionPolicy evictionPolicy;
 
 /// The trash directory URL, the assets before removal are moved to this directory. The directory
 /// contents are deleted asynchronously.
@@ -223,13 +223,14 @@ std::vector<executorchcoreml::Asset>
 get_assets_to_remove(ModelAssetsStore& store,
                      ssize_t bytes_to_remove,
                      NSMapTable<NSString *, ETCoreMLAsset *> *assets_in_use_map,
+                     ETCoreMLAssetEvictionPolicy eviction_policy,
                      std::error_code &error) {
     std::vector<Asset> assets;
-    store.impl()->get_keys_sorted_by_access_count([store = store.impl(),
-                                                   &bytes_to_remove,
-                                                   &assets,
-                                                   assets_in_use_map,
-                                                   &error](const std::string& key) {
+    auto fn = [store = store.impl(),
+               &bytes_to_remove,
+               &assets,
+               assets_in_use_map,
+               &error](const std::string& key) {
         if (bytes_to_remove <= 0) {
             return false;
         }
@@ -248,7 +249,18 @@ get_assets_to_remove(ModelAssetsStore& store,
         }
         
         return true;
-    }, SortOrder::Ascending, error);
+    };
+    
+    switch (eviction_policy) {
+        case ETCoreMLAssetEvictionPolicyLeastRecentlyUsed: {
+            store.impl()->get_keys_sorted_by_access_time(fn, SortOrder::Ascending, error);
+            break;
+        }
+        default: {
+            store.impl()->get_keys_sorted_by_access_count(fn, SortOrder::Ascending, error);
+            break;
+        }
+    }
     
     return assets;
 }
@@ -316,6 +328,7 @@ get_assets_to_remove(ModelAssetsStore& store,
         _trashDirectoryURL = managedTrashDirectoryURL;
         _estimatedSizeInBytes = sizeInBytes.value();
         _maxAssetsSizeInBytes = maxAssetsSizeInBytes;
+        _evictionPolicy = ETCoreMLAssetEvictionPolicyLeastFrequentlyUsed;
         
         _fileManager = fileManager;
         _trashQueue = dispatch_queue_create("com.executorchcoreml.assetmanager.trash", DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL);
@@ -447,6 +460,11 @@ get_assets_to_remove(ModelAssetsStore& store,
     });
 }
 
+- (void)setMaxAssetsSizeInBytes:(NSInteger)maxAssetsSizeInBytes {
+    _maxAssetsSizeInBytes = maxAssetsSizeInBytes;
+    [self triggerCompaction];
+}
+
 - (nullable ETCoreMLAsset *)storeAssetAtURL:(NSURL *)url
                              withIdentifier:(NSString *)identifier
                                       error:(NSError * __autoreleasing *)error {
@@ -635,7 +653,7 @@ get_assets_to_remove(ModelAssetsStore& store,
     
     std::error_code ec;
     ssize_t bytesToRemove = _estimatedSizeInBytes - sizeInBytes;
-    const auto& assets = ::get_assets_to_remove(_assetsStore, bytesToRemove, self.assetsInUseMap, ec);
+    const auto& assets = ::get_assets_to_remove(_assetsStore, bytesToRemove, self.assetsInUseMap, self.evictionPolicy, ec);
     
     if (ec) {
         ::set_error_from_error_code(ec, error);
@@ -43,6 +43,15 @@ __attribute__((objc_subclassing_restricted))
 - (nullable NSArray<MLMultiArray*>*)prepareOutputBackings:(const std::vector<executorchcoreml::MultiArray>&)outputs
                                                     error:(NSError* __autoreleasing*)error;
 
+/// Predicts the outputs of the model, using and updating the model's state if it has one.
+///
+/// @param inputs The inputs to the model.
+/// @param options The prediction options.
+/// @param error   On failure, error is filled with the failure information.
+- (nullable id<MLFeatureProvider>)predictionFromFeatures:(id<MLFeatureProvider>)inputs
+                                                 options:(MLPredictionOptions*)options
+                                                   error:(NSError* __autoreleasing*)error;
+
 /// The underlying MLModel.
 @property (strong, readonly, nonatomic) MLModel* mlModel;
 
@@ -58,6 +67,10 @@ __attribute__((objc_subclassing_restricted))
 /// The ordered output names of the model.
 @property (copy, readonly, nonatomic) NSOrderedSet<NSString*>* orderedOutputNames;
 
+/// The state of a stateful model, e.g. the KV caches of a LLM, which Core ML keeps across predictions
+/// instead of copying it in and out as inputs and outputs. `nil` if the model has no state.
+@property (strong, readonly, nonatomic, nullable) MLState* state API_AVAILABLE(macos(15.0), ios(18.0), tvos(18.0), watchos(11.0));
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -194,6 +194,11 @@ NSDictionary<NSString *, MLMultiArrayConstraint *> *get_multi_array_output_const
         _cache = [[NSCache alloc] init];
         _inputConstraintsByName = get_multi_array_input_constraints_by_name(mlModel.modelDescription);
         _outputConstraintsByName = get_multi_array_output_constraints_by_name(mlModel.modelDescription);
+        if (@available(macOS 15.0, iOS 18.0, tvOS 18.0, watchOS 11.0, *)) {
+            if (mlModel.modelDescription.stateDescriptionsByName.count > 0) {
+                _state = [mlModel newState];
+            }
+        }
     }
     
     return self;
@@ -262,6 +267,23 @@ NSDictionary<NSString *, MLMultiArrayConstraint *> *get_multi_array_output_const
     
 }
 
+- (nullable id<MLFeatureProvider>)predictionFromFeatures:(id<MLFeatureProvider>)inputs
+                                                 options:(MLPredictionOptions *)options
+                                                   error:(NSError * __autoreleasing *)error {
+    if (@available(macOS 15.0, iOS 18.0, tvOS 18.0, watchOS 11.0, *)) {
+        if (self.state) {
+            return [self.mlModel predictionFromFeatures:inputs
+                                             usingState:self.state
+                                                options:options
+                                                  error:error];
+        }
+    }
+    
+    return [self.mlModel predictionFromFeatures:inputs
+                                        options:options
+                                          error:error];
+}
+
 - (nullable NSArray<MLMultiArray *> *)prepareOutputBackings:(const std::vector<executorchcoreml::MultiArray>&)outputs
                                                       error:(NSError * __autoreleasing *)error {
     return [self prepareArgs:outputs
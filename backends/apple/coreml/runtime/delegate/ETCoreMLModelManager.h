@@ -103,6 +103,18 @@ __attribute__((objc_subclassing_restricted))
 /// @retval `YES` if the model was pre-warmed otherwise `NO`.
 - (BOOL)prewarmModelWithHandle:(ModelHandle*)handle error:(NSError* __autoreleasing*)error;
 
+/// Compiles the model from the AOT data into the models cache and pre-warms it, without keeping
+/// the model loaded. A later call to `loadModelFromAOTData:configuration:error:` with the same
+/// data then loads the compiled model from the cache.
+///
+/// @param data The AOT blob data.
+/// @param configuration The model configuration that will be used to load the model.
+/// @param error   On failure, error is filled with the failure information.
+/// @retval `YES` if the model was compiled and pre-warmed otherwise `NO`.
+- (BOOL)prepareModelFromAOTData:(NSData*)data
+                  configuration:(MLModelConfiguration*)configuration
+                          error:(NSError* __autoreleasing*)error;
+
 /// Purges model cache.
 ///
 /// @param error   On failure, error is filled with the failure information.
@@ -615,6 +615,34 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
     return result;
 }
 
+- (BOOL)prepareModelFromAOTData:(NSData *)data
+                  configuration:(MLModelConfiguration *)configuration
+                          error:(NSError * __autoreleasing *)error {
+    ModelHandle *handle = [self loadModelFromAOTData:data configuration:configuration error:error];
+    if (!handle) {
+        return NO;
+    }
+    
+    // Loading the model compiled it for the device, pre-warming it also runs the compute units once.
+    BOOL result = [self prewarmModelWithHandle:handle error:error];
+    NSString *identifier = [self modelWithHandle:handle].identifier;
+    [self unloadModelWithHandle:handle];
+    
+    // Keep the compiled asset pre-warmed until the model is loaded.
+    ETCoreMLAsset *asset = [self assetWithIdentifier:identifier];
+    NSError *prewarmError = nil;
+    if (asset && [asset prewarmAndReturnError:&prewarmError]) {
+        [self addPrewarmedAsset:asset];
+    } else if (prewarmError) {
+        ETCoreMLLogError(prewarmError,
+                         "%@: Failed to prewarm asset with identifier = %@",
+                         NSStringFromClass(self.assetManager.class),
+                         identifier);
+    }
+    
+    return result;
+}
+
 - (void)prewarmRecentlyUsedAssetsWithMaxCount:(NSUInteger)maxCount {
     NSError *localError = nil;
     NSArray<ETCoreMLAsset *> *assets = [self.assetManager mostRecentlyUsedAssetsWithMaxCount:maxCount error:&localError];
@@ -680,18 +708,17 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
                                                              loggingOptions:loggingOptions
                                                                  eventLogger:eventLogger
                                                                        error:&localError];
-    // Try without output backings.
+    // Try without output backings, the outputs are then copied from the model outputs.
     if (!modelOutputs && predictionOptions.outputBackings.count > 0) {
         localError = nil;
         executor.ignoreOutputBackings = YES;
+        modelOutputs = [executor executeModelWithInputs:inputFeatures
+                                      predictionOptions:predictionOptions
+                                         loggingOptions:loggingOptions
+                                            eventLogger:eventLogger
+                                                  error:&localError];
     }
     
-    modelOutputs = [executor executeModelWithInputs:inputFeatures
-                                  predictionOptions:predictionOptions
-                                     loggingOptions:loggingOptions
-                                        eventLogger:eventLogger
-                                              error:&localError];
-    
     if (error) {
         *error = localError;
     }
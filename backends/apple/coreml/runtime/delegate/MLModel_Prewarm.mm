@@ -78,6 +78,17 @@ id<MLFeatureProvider> _Nullable get_zeroed_inputs(MLModel *model, NSError * __au
             return NO;
         }
         
+        if (@available(macOS 15.0, iOS 18.0, tvOS 18.0, watchOS 11.0, *)) {
+            if (self.modelDescription.stateDescriptionsByName.count > 0) {
+                // A stateful model can't predict without a state, use a throwaway one so that the
+                // state used by the executions is left untouched.
+                id<MLFeatureProvider> outputs = [self predictionFromFeatures:inputs
+                                                                  usingState:[self newState]
+                                                                       error:error];
+                return outputs != nil;
+            }
+        }
+        
         id<MLFeatureProvider> outputs = [self predictionFromFeatures:inputs error:error];
         return outputs != nil;
     }
@@ -24,9 +24,17 @@ public:
     /// The model handle.
     using Handle = void;
 
+    /// The policy used to pick the compiled models to remove when the models cache is full.
+    enum class CacheEvictionPolicy : uint8_t {
+        LeastFrequentlyUsed = 0, // Remove the least accessed models first.
+        LeastRecentlyUsed, // Remove the models with the oldest access first.
+    };
+
     struct Config {
         // Max models cache size in bytes.
         size_t max_models_cache_size = 10 * size_t(1024) * size_t(1024) * size_t(1024);
+        // The models cache eviction policy.
+        CacheEvictionPolicy cache_eviction_policy = CacheEvictionPolicy::LeastFrequentlyUsed;
         // If set to `true`, delegate pre-warms the most recently used asset.
         bool should_prewarm_asset = true;
         // If set to `true`, delegate pre-warms the model in `init`.
@@ -75,6 +83,16 @@ public:
     /// initialization failed.
     virtual Handle* init(Buffer processed, const std::unordered_map<std::string, Buffer>& specs) const noexcept = 0;
 
+    /// Must compile and pre-warm the CoreML model in the background.
+    ///
+    /// The implementation must copy what it needs from `processed` and `specs` before returning.
+    /// The compiled model must be stored in the models cache so that a later call to `init` with
+    /// the same blob skips the compilation.
+    ///
+    /// @param processed The AOT blob.
+    /// @param specs The specs at the time of compilation.
+    virtual void prepare_async(Buffer processed, const std::unordered_map<std::string, Buffer>& specs) const noexcept = 0;
+
     /// Must execute the CoreML model with the specified handle.
     ///
     /// The `args` are inputs and outputs combined. It's the responsibility of the
@@ -114,6 +132,13 @@ public:
     /// @retval `true` if the model handle is valid otherwise `false`.
     virtual bool is_valid_handle(Handle* handle) const noexcept = 0;
 
+    /// Must pre-warm the model with the specified handle, so that its first
+    /// execution is not slower than the next ones.
+    ///
+    /// @param handle The model handle.
+    /// @retval `true` if the model is pre-warmed otherwise `false`.
+    virtual bool prewarm(Handle* handle) const noexcept = 0;
+
     /// Must unload the CoreML model with the specified handle.
     ///
     /// The returned pair's first value is the number of inputs and the second
@@ -128,6 +153,14 @@ public:
     /// method tries to remove all the models that are not currently in-use.
     virtual bool purge_models_cache() const noexcept = 0;
 
+    /// Sets the maximum size of the models cache.
+    ///
+    /// If the cache is larger, the models that are not currently in-use are
+    /// removed following the cache eviction policy.
+    ///
+    /// @param size_in_bytes The maximum models cache size in bytes.
+    virtual void set_max_models_cache_size(size_t size_in_bytes) const noexcept = 0;
+
     /// Returns a delegate implementation with the specified config.
     ///
     /// @param config The delegate config.
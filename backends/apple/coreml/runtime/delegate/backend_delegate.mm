@@ -111,10 +111,19 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
 
 - (BOOL)unloadModelWithHandle:(ModelHandle*)handle;
 
+- (BOOL)prewarmModelWithHandle:(ModelHandle*)handle error:(NSError* __autoreleasing*)error;
+
+- (void)prepareModelAsynchronouslyFromAOTData:(NSData*)data
+                                configuration:(MLModelConfiguration*)configuration;
+
 - (BOOL)purgeModelsCacheAndReturnError:(NSError * _Nullable __autoreleasing *)error;
 
+- (void)setMaxModelsCacheSize:(size_t)sizeInBytes;
+
 @property (assign, readonly, nonatomic) BackendDelegate::Config config;
 @property (strong, readonly, nonatomic) dispatch_queue_t syncQueue;
+@property (strong, readonly, nonatomic) dispatch_queue_t prepareQueue;
+@property (strong, nonatomic, nullable) ETCoreMLAssetManager *assetManager;
 @property (strong, nonatomic, nullable) ETCoreMLModelManager *impl;
 @property (assign, readonly, nonatomic) BOOL isAvailable;
 
@@ -127,6 +136,8 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
     if (self) {
         _config = std::move(config);
         _syncQueue = dispatch_queue_create("com.executorchcoreml.modelmanagerdelegate.sync", DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL);
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL, QOS_CLASS_UTILITY, -1);
+        _prepareQueue = dispatch_queue_create("com.executorchcoreml.modelmanagerdelegate.prepare", attr);
     }
     
     return self;
@@ -147,12 +158,22 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
         return NO;
     }
     
+    switch (self.config.cache_eviction_policy) {
+        case BackendDelegate::CacheEvictionPolicy::LeastFrequentlyUsed:
+            assetManager.evictionPolicy = ETCoreMLAssetEvictionPolicyLeastFrequentlyUsed;
+            break;
+        case BackendDelegate::CacheEvictionPolicy::LeastRecentlyUsed:
+            assetManager.evictionPolicy = ETCoreMLAssetEvictionPolicyLeastRecentlyUsed;
+            break;
+    }
+    
     ETCoreMLModelManager *modelManager = [[ETCoreMLModelManager alloc] initWithAssetManager:assetManager];
     if (!modelManager) {
         return NO;
     }
     
     self.impl = modelManager;
+    self.assetManager = assetManager;
     
     if (self.config.should_prewarm_asset) {
         [modelManager prewarmRecentlyUsedAssetsWithMaxCount:1];
@@ -198,6 +219,22 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
     return handle;
 }
 
+- (BOOL)prewarmModelWithHandle:(ModelHandle*)handle error:(NSError* __autoreleasing*)error {
+    assert(self.impl != nil && "Impl must not be nil");
+    return [self.impl prewarmModelWithHandle:handle error:error];
+}
+
+- (void)prepareModelAsynchronouslyFromAOTData:(NSData*)data
+                                configuration:(MLModelConfiguration*)configuration {
+    dispatch_async(self.prepareQueue, ^{
+        if (![self loadAndReturnError:nil]) {
+            return;
+        }
+        
+        (void)[self.impl prepareModelFromAOTData:data configuration:configuration error:nil];
+    });
+}
+
 - (BOOL)executeModelWithHandle:(ModelHandle*)handle
                        argsVec:(const std::vector<executorchcoreml::MultiArray>&)argsVec
                 loggingOptions:(const executorchcoreml::ModelLoggingOptions&)loggingOptions
@@ -229,6 +266,14 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
     return [self.impl purgeModelsCacheAndReturnError:error];;
 }
 
+- (void)setMaxModelsCacheSize:(size_t)sizeInBytes {
+    if (![self loadAndReturnError:nil]) {
+        return;
+    }
+    
+    self.assetManager.maxAssetsSizeInBytes = static_cast<NSInteger>(sizeInBytes);
+}
+
 - (BOOL)isAvailable {
     if (![self loadAndReturnError:nil]) {
         return NO;
@@ -285,6 +330,13 @@ public:
         return modelHandle;
     }
     
+    void prepare_async(Buffer processed, const std::unordered_map<std::string, Buffer>& specs) const noexcept override {
+        MLModelConfiguration *configuration = get_model_configuration(specs);
+        // The blob is only valid for the duration of the call.
+        NSData *data = [NSData dataWithBytes:processed.data() length:processed.size()];
+        [model_manager_ prepareModelAsynchronouslyFromAOTData:data configuration:configuration];
+    }
+    
     bool execute(Handle* handle,
                  const std::vector<MultiArray>& args,
                  const ModelLoggingOptions& logging_options,
@@ -307,6 +359,15 @@ public:
         return [model_manager_ modelWithHandle:handle] != nil;
     }
     
+    bool prewarm(Handle* handle) const noexcept override {
+        if (config_.should_prewarm_model) {
+            // The model was pre-warmed when it was loaded.
+            return true;
+        }
+        NSError *localError = nil;
+        return static_cast<bool>([model_manager_ prewarmModelWithHandle:handle error:&localError]);
+    }
+    
     bool is_available() const noexcept override {
         return static_cast<bool>(model_manager_.isAvailable);
     }
@@ -326,6 +387,10 @@ public:
         return result;
     }
     
+    void set_max_models_cache_size(size_t size_in_bytes) const noexcept override {
+        [model_manager_ setMaxModelsCacheSize:size_in_bytes];
+    }
+    
     ETCoreMLModelManagerDelegate *model_manager_;
     Config config_;
 };
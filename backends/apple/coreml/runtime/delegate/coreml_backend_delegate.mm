@@ -109,6 +109,15 @@ std::optional<BackendDelegate::Config> parse_config(NSURL *plistURL) {
         }
     }
     
+    {
+        NSString *cache_eviction_policy = SAFE_CAST(dict[@"modelsCacheEvictionPolicy"], NSString);
+        if ([cache_eviction_policy isEqualToString:@"LeastRecentlyUsed"]) {
+            config.cache_eviction_policy = BackendDelegate::CacheEvictionPolicy::LeastRecentlyUsed;
+        } else if ([cache_eviction_policy isEqualToString:@"LeastFrequentlyUsed"]) {
+            config.cache_eviction_policy = BackendDelegate::CacheEvictionPolicy::LeastFrequentlyUsed;
+        }
+    }
+    
     return config;
 }
 
@@ -215,6 +224,15 @@ bool CoreMLBackendDelegate::is_available() const {
     return impl_->is_available();
 }
 
+Error CoreMLBackendDelegate::warmup(DelegateHandle* handle) const {
+    ET_LOG(Debug, "%s: warmup called.", ETCoreMLStrings.delegateIdentifier.UTF8String);
+    ET_CHECK_OR_RETURN_ERROR(impl_->prewarm(handle),
+                             DelegateInvalidHandle,
+                             "%s: Failed to prewarm the model.",
+                             ETCoreMLStrings.delegateIdentifier.UTF8String);
+    return Error::Ok;
+}
+
 void CoreMLBackendDelegate::destroy(DelegateHandle* handle) const {
     ET_LOG(Debug, "%s: destroy called.", ETCoreMLStrings.delegateIdentifier.UTF8String);
     impl_->destroy(handle);
@@ -225,6 +243,26 @@ bool CoreMLBackendDelegate::purge_models_cache() const noexcept {
     return impl_->purge_models_cache();
 }
 
+void CoreMLBackendDelegate::prepare_model_async(const void* processed,
+                                                size_t size,
+                                                ArrayRef<CompileSpec> specs) const noexcept {
+    ET_LOG(Debug, "%s: prepare_model_async called.", ETCoreMLStrings.delegateIdentifier.UTF8String);
+    std::unordered_map<std::string, Buffer> specs_map;
+    specs_map.reserve(specs.size());
+    for (auto it = specs.cbegin(); it != specs.cend(); ++it) {
+        auto& spec = *(it);
+        auto buffer = Buffer(spec.value.buffer, spec.value.nbytes);
+        specs_map.emplace(spec.key, std::move(buffer));
+    }
+    
+    impl_->prepare_async(Buffer(processed, size), specs_map);
+}
+
+void CoreMLBackendDelegate::set_max_models_cache_size(size_t size_in_bytes) const noexcept {
+    ET_LOG(Debug, "%s: set_max_models_cache_size called.", ETCoreMLStrings.delegateIdentifier.UTF8String);
+    impl_->set_max_models_cache_size(size_in_bytes);
+}
+
 CoreMLBackendDelegate *CoreMLBackendDelegate::get_registered_delegate() noexcept {
     return static_cast<CoreMLBackendDelegate *>(get_backend_class(ETCoreMLStrings.delegateIdentifier.UTF8String));
 }
@@ -48,11 +48,27 @@ public:
     /// Returns `true` if the delegate is available otherwise `false`.
     bool is_available() const override;
 
+    /// Pre-warms the loaded model, which runs its compute units once, unless
+    /// `init` already did because the `shouldPrewarmModel` config is set.
+    ///
+    /// @param handle The handle returned by an earlier call to `init`.
+    /// @retval On success, `Error::Ok` otherwise any other `Error` case.
+    Error warmup(DelegateHandle* handle) const override;
+
     /// Unloads the loaded CoreML model with the  specified handle.
     ///
     /// @param handle The handle returned by an earlier call to `init`.
     void destroy(DelegateHandle* handle) const override;
 
+    /// Compiles and pre-warms the model in the background, e.g. right after app launch, so that the
+    /// first `init` of the model loads it from the models cache instead of compiling it.
+    ///
+    /// @param processed The AOT blob that was produced by a call to CoreML's
+    /// backend `preprocess` method, it's copied before the call returns.
+    /// @param compileSpecs The exact same compiler specification that was used to
+    /// produce `processed`.
+    void prepare_model_async(const void* processed, size_t size, ArrayRef<CompileSpec> compileSpecs) const noexcept;
+
     /// Returns the registered `CoreMLBackendDelegate` instance.
     static CoreMLBackendDelegate* get_registered_delegate() noexcept;
 
@@ -62,6 +78,12 @@ public:
     /// asynchronously deleted.
     bool purge_models_cache() const noexcept;
 
+    /// Sets the maximum size of the models cache.
+    ///
+    /// If the cache is larger, the models that are not currently in-use are
+    /// removed following the `modelsCacheEvictionPolicy` of the delegate config.
+    void set_max_models_cache_size(size_t size_in_bytes) const noexcept;
+
 private:
     std::shared_ptr<executorchcoreml::BackendDelegate> impl_;
 };
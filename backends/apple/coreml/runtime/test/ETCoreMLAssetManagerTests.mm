@@ -137,6 +137,35 @@
     XCTAssertEqual([self.assetManager compact:100 error:&localError], 0);
 }
 
+- (void)testCompactionWithLeastRecentlyUsedPolicy {
+    NSUInteger n = 3;
+    NSError *localError = nil;
+    NSMutableArray<NSString *> *identifiers = [NSMutableArray arrayWithCapacity:n];
+    for (NSUInteger i = 0; i < n; i++) {
+        NSString *identifier = [NSUUID UUID].UUIDString;
+        NSURL *assetURL = [ETCoreMLTestUtils createUniqueAssetInDirectoryAtURL:self.testDirectoryURL withContent:@"testing" fileManager:self.fileManager error:&localError];
+        XCTAssertNotNil(assetURL);
+        ETCoreMLAsset *asset = [self.assetManager storeAssetAtURL:assetURL withIdentifier:identifier error:&localError];
+        // Close the asset so that it could be deleted.
+        [asset close];
+        [identifiers addObject:identifier];
+    }
+    
+    // Access the first asset twice and the others once more, so that the first asset is the most
+    // frequently used one but not the most recently used one.
+    [[self.assetManager assetWithIdentifier:identifiers[0] error:&localError] close];
+    [[self.assetManager assetWithIdentifier:identifiers[0] error:&localError] close];
+    [[self.assetManager assetWithIdentifier:identifiers[1] error:&localError] close];
+    [[self.assetManager assetWithIdentifier:identifiers[2] error:&localError] close];
+    
+    self.assetManager.evictionPolicy = ETCoreMLAssetEvictionPolicyLeastRecentlyUsed;
+    NSInteger assetSizeInBytes = self.assetManager.estimatedSizeInBytes / n;
+    XCTAssertEqual([self.assetManager compact:assetSizeInBytes error:&localError], assetSizeInBytes);
+    XCTAssertFalse([self.assetManager hasAssetWithIdentifier:identifiers[0] error:&localError]);
+    XCTAssertFalse([self.assetManager hasAssetWithIdentifier:identifiers[1] error:&localError]);
+    XCTAssertTrue([self.assetManager hasAssetWithIdentifier:identifiers[2] error:&localError]);
+}
+
 - (void)testPurge {
     NSUInteger n = 5;
     NSError *localError = nil;
@@ -17,7 +17,11 @@ from executorch.backends.apple.mps.serialization.mps_graph_schema import (
     MPSGraph,
     MPSNode,
 )
-from executorch.backends.apple.mps.utils.mps_utils import get_input_node
+from executorch.backends.apple.mps.utils.mps_utils import (
+    get_input_node,
+    get_param_tensor,
+    is_parameter,
+)
 
 FORMAT = "[%(levelname)s %(asctime)s %(filename)s:%(lineno)s] %(message)s"
 logging.basicConfig(level=logging.DEBUG, format=FORMAT)
@@ -46,8 +50,17 @@ class OpDequantizePerChannelGroupDefault(NodeVisitor):
         )
         scales_id = self.define_tensor(get_input_node(node, 1), mps_graph)
 
-        # there are no zero points in this quantization method (node.args[2] is all zeros)
+        # Only serialize the zero points when some group has one, so that
+        # symmetric weights skip subtracting them at runtime.
+        zero_points_node = get_input_node(node, 2)
+        zero_points = (
+            get_param_tensor(self.exported_program, zero_points_node)
+            if is_parameter(self.exported_program, zero_points_node)
+            else None
+        )
         zero_points_id = -1
+        if zero_points is None or torch.any(zero_points != 0):
+            zero_points_id = self.define_tensor(zero_points_node, mps_graph)
         quant_min = cast(int, node.args[3])
         quant_max = cast(int, node.args[4])
         dtype = self.torch_dtype_to_mps_dtype(node.args[5])
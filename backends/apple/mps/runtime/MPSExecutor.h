@@ -41,14 +41,26 @@ class MPSExecutor {
   std::vector<id<MTLBuffer>> _inputGPUBuffers;
   std::vector<id<MTLBuffer>> _outputGPUBuffers;
 
+  // With shared memory: host pointers currently wrapped by the GPU buffers,
+  // and the offset of the tensor data within its page aligned GPU buffer
+  std::vector<const void*> _inputHostPtrs;
+  std::vector<const void*> _outputHostPtrs;
+  std::vector<NSUInteger> _inputOffsets;
+  std::vector<NSUInteger> _outputOffsets;
+
   // Input/Output CPU buffer pointers
   std::vector<CPUBufferWrapper> _inputCPUBuffers;
   std::vector<CPUBufferWrapper> _outputCPUBuffers;
 
   std::unordered_map<MPSGraphTensor*, int32_t> _mpsGraphTensorToId;
+
+  // Command buffer of the execution submitted by forward_async(), if it has
+  // not been waited on yet
+  MPSCommandBuffer* _pendingCommandBuffer;
  public:
   MPSExecutor();
   ~MPSExecutor() {
+    (void)wait();
     if (_inputsArray) {
       [_inputsArray release];
       _inputsArray = nil;
@@ -59,6 +71,13 @@ class MPSExecutor {
 
     _inputsArray = nil;
     _outputsArray = nil;
+
+    for (id<MTLBuffer> buffer : _inputGPUBuffers) {
+      [buffer release];
+    }
+    for (id<MTLBuffer> buffer : _outputGPUBuffers) {
+      [buffer release];
+    }
   }
 
   inline size_t getNumInputs() {
@@ -75,6 +94,21 @@ class MPSExecutor {
 
   ET_NODISCARD Error forward(std::vector<const Tensor*>& outputs);
 
+  // Encode the executable and the output copies, and commit them without
+  // waiting for the GPU. The outputs are valid, and the inputs may be
+  // modified again, only after wait() returns. Only one execution can be in
+  // flight; a previous one is waited on first. Falls back to forward() where
+  // the outputs are copied on the CPU (simulator) or commitAndContinue is on.
+  ET_NODISCARD Error forward_async(std::vector<const Tensor*>& outputs);
+
+  // Wait for the execution submitted by forward_async() to complete. No-op if
+  // there is none.
+  ET_NODISCARD Error wait();
+
+  inline bool is_pending() {
+    return _pendingCommandBuffer != nil;
+  }
+
   ET_NODISCARD Error
   set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs);
 
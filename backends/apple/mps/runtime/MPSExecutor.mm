@@ -22,9 +22,40 @@ namespace executor {
 namespace mps {
 namespace delegate {
 
+// Wrap the page aligned block holding the tensor data in a shared storage
+// MTLBuffer, so that the GPU works on the tensor memory in place. The buffer
+// must be page aligned, so the data may start at an offset within it.
+static id<MTLBuffer> wrapSharedBuffer(const Tensor& tensor, NSUInteger* offset) {
+  const void* host_ptr = tensor.const_data_ptr();
+  NSUInteger alignedLength = 0;
+  void* alignedPtr = pageAlignedBlockPtr(host_ptr, (NSUInteger)tensor.nbytes(), &alignedLength);
+  *offset = uintptr_t(host_ptr) - uintptr_t(alignedPtr);
+  MTLResourceOptions options = MTLResourceCPUCacheModeDefaultCache | MTLResourceStorageModeShared;
+  return [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:alignedPtr
+                                                               length:alignedLength
+                                                              options:options
+                                                          deallocator:nil];
+}
+
+static MPSGraphTensorData* makeTensorData(id<MTLBuffer> buffer, NSUInteger offset, MPSGraphShapedType* type) {
+  if (offset == 0) {
+    return [[[MPSGraphTensorData alloc] initWithMTLBuffer:buffer
+                                                    shape:[type shape]
+                                                 dataType:[type dataType]] autorelease];
+  }
+  // MPSGraphTensorData can't start at an offset into a buffer, an MPSNDArray can
+  MPSNDArrayDescriptor* descriptor = [MPSNDArrayDescriptor descriptorWithDataType:[type dataType]
+                                                                            shape:[type shape]];
+  MPSNDArray* ndArray = [[[MPSNDArray alloc] initWithBuffer:buffer
+                                                     offset:offset
+                                                 descriptor:descriptor] autorelease];
+  return [[[MPSGraphTensorData alloc] initWithMPSNDArray:ndArray] autorelease];
+}
+
 MPSExecutor::MPSExecutor() {
   _use_shared_mem = true;
   _buffers_initialized = false;
+  _pendingCommandBuffer = nil;
 
 #if TARGET_OS_SIMULATOR or defined(__x86_64__)
   _use_shared_mem = false;
@@ -41,22 +72,20 @@ ET_NODISCARD Error
 MPSExecutor::set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs) {
   ET_CHECK_OR_RETURN_ERROR(inputs.size() == getNumInputs(), Internal, "Inputs mismatch");
   ET_CHECK_OR_RETURN_ERROR(outputs.size() == getNumOutputs(), Internal, "Outputs mismatch");
+  // The in flight execution may still read the buffers being replaced.
+  ET_CHECK_OK_OR_RETURN_ERROR(wait());
   // updateDataBuffers is a no-op for devices with shared memory.
   // In case of devices with non-shared memory, it will blit the contents to a private GPU buffer.
   updateDataBuffers(inputs, outputs);
   for (MPSGraphTensor *tensor in [_executable feedTensors]) {
     int i = _mpsGraphTensorToId[tensor];
-    MPSGraphTensorData* tensorData = [[[MPSGraphTensorData alloc]initWithMTLBuffer:_inputGPUBuffers[i]
-                                                                            shape:[_inputShapes[i] shape]
-                                                                          dataType:[_inputShapes[i] dataType]] autorelease];
-    _inputsArray[i] = tensorData;
+    _inputsArray[i] = makeTensorData(
+      _inputGPUBuffers[i], _use_shared_mem ? _inputOffsets[i] : 0, _inputShapes[i]);
   }
 
   for (int i = 0; i < outputs.size(); i++) {
-    MPSGraphTensorData* tensorData = [[[MPSGraphTensorData alloc] initWithMTLBuffer:_outputGPUBuffers[i]
-                                                                              shape:[_outputShapes[i] shape]
-                                                                          dataType:[_outputShapes[i] dataType]] autorelease];
-    _outputsArray[i] = tensorData;
+    _outputsArray[i] = makeTensorData(
+      _outputGPUBuffers[i], _use_shared_mem ? _outputOffsets[i] : 0, _outputShapes[i]);
   }
   return Error::Ok;
 }
@@ -64,6 +93,7 @@ MPSExecutor::set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<
 ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
   Error err = Error::Ok;
   MPSStream* mpsStream = getDefaultMPSStream();
+  ET_CHECK_OK_OR_RETURN_ERROR(wait());
   if (mpsStream->commitAndContinueEnabled() || mpsStream->hasLiveCommandBuffer()) {
     id<MTLCommandBuffer> commandBuffer = mpsStream->commandBuffer();
     [_executable encodeToCommandBuffer:commandBuffer
@@ -95,6 +125,46 @@ ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
   return Error::Ok;
 }
 
+ET_NODISCARD Error MPSExecutor::forward_async(std::vector<const Tensor*>& outputs) {
+#if TARGET_OS_SIMULATOR
+  return forward(outputs);
+#else
+  MPSStream* mpsStream = getDefaultMPSStream();
+  if (mpsStream->commitAndContinueEnabled()) {
+    return forward(outputs);
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(wait());
+
+  // Encode on the stream's command buffer, so that the input copies already
+  // encoded by set_inputs_outputs() and the output copies go out with it.
+  [_executable encodeToCommandBuffer:mpsStream->commandBuffer()
+                        inputsArray:_inputsArray
+                       resultsArray:_outputsArray
+                executionDescriptor:nil];
+  syncOutputBuffers(outputs);
+  _pendingCommandBuffer = mpsStream->commitAsync();
+
+  return Error::Ok;
+#endif
+}
+
+ET_NODISCARD Error MPSExecutor::wait() {
+  if (_pendingCommandBuffer == nil) {
+    return Error::Ok;
+  }
+  [_pendingCommandBuffer waitUntilCompleted];
+  MTLCommandBufferStatus status = [_pendingCommandBuffer status];
+  [_pendingCommandBuffer release];
+  _pendingCommandBuffer = nil;
+
+  ET_CHECK_OR_RETURN_ERROR(
+    status == MTLCommandBufferStatusCompleted,
+    Internal,
+    "MPS command buffer failed with status %d",
+    (int)status);
+  return Error::Ok;
+}
+
 Error
 MPSExecutor::initDataBuffers() {
   Error error = Error::Ok;
@@ -111,6 +181,11 @@ MPSExecutor::initDataBuffers() {
   if (!_use_shared_mem) {
     _inputCPUBuffers.resize(nInputs);
     _outputCPUBuffers.resize(nOutputs);
+  } else {
+    _inputHostPtrs.resize(nInputs, nullptr);
+    _outputHostPtrs.resize(nOutputs, nullptr);
+    _inputOffsets.resize(nInputs, 0);
+    _outputOffsets.resize(nOutputs, 0);
   }
 
   // In case of shared memory, the CPU raw buffer is used directly as an MTLBuffer.
@@ -151,8 +226,14 @@ MPSExecutor::updateDataBuffers(
     const Tensor& tensor = *inputs[i];
     void* host_src = tensor.mutable_data_ptr<void*>();
     if (_use_shared_mem) {
-      // Use directly the CPU buffer when using shared memory.
-      _inputGPUBuffers[i] = getMTLBufferStorage(tensor);
+      // Use directly the CPU buffer when using shared memory. Planned memory
+      // keeps its address across runs, so the wrapper is only rebuilt when
+      // the tensor moved.
+      if (tensor.const_data_ptr() != _inputHostPtrs[i]) {
+        [_inputGPUBuffers[i] release];
+        _inputGPUBuffers[i] = wrapSharedBuffer(tensor, &_inputOffsets[i]);
+        _inputHostPtrs[i] = tensor.const_data_ptr();
+      }
     } else {
       _inputCPUBuffers[i].flags = 0;
 #if TARGET_OS_SIMULATOR
@@ -181,7 +262,11 @@ MPSExecutor::updateDataBuffers(
 
   if (_use_shared_mem) {
     for (int i = 0; i < outputs.size(); i++) {
-      _outputGPUBuffers[i] = getMTLBufferStorage(*outputs[i]);
+      if (outputs[i]->const_data_ptr() != _outputHostPtrs[i]) {
+        [_outputGPUBuffers[i] release];
+        _outputGPUBuffers[i] = wrapSharedBuffer(*outputs[i], &_outputOffsets[i]);
+        _outputHostPtrs[i] = outputs[i]->const_data_ptr();
+      }
     }
   }
 
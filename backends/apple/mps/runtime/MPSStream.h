@@ -64,6 +64,10 @@ class MPSStream {
   id<MTLComputeCommandEncoder> commandEncoder();
   void endKernelCoalescing();
   ET_NODISCARD Error synchronize(SyncType syncType);
+  // Commit the live command buffer without waiting for it to complete and
+  // hand it over to the caller, who must release it once done with it.
+  // Returns nil if nothing was encoded.
+  MPSCommandBuffer* commitAsync();
   bool commitAndContinueEnabled();
   void copy(
       id<MTLBuffer> srcBuffer,
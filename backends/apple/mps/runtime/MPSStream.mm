@@ -84,6 +84,18 @@ Error MPSStream::synchronize(SyncType syncType) {
   return Error::Ok;
 }
 
+MPSCommandBuffer* MPSStream::commitAsync() {
+  endKernelCoalescing();
+  MPSCommandBuffer* commandBuffer = _commandBuffer;
+  if (commandBuffer) {
+    [commandBuffer commit];
+    _commandBuffer = nil;
+    // reset the accumulated resource sizes for command buffer
+    _commandBufferResourceSize = 0;
+  }
+  return commandBuffer;
+}
+
 bool MPSStream::commitAndContinueEnabled() {
   return _enableCommitAndContinue;
 }
@@ -40,6 +40,54 @@ MPSGraphBuilder::mpsDequantizePerChannelGroupOp(NodePtr nodePtr) {
                                                 dataType:MPSDataTypeFloat16
                                                     name:nil];
 
+  if (graphNode->zero_points_id() != -1) {
+    // (q - zp) * s == q * s - zp * s, with one zero point per group of
+    // group_size input channels, so subtract zp * s from every group. MPSGraph
+    // folds this into the constant weights when the graph is compiled.
+    MPSGraphTensor* zpTensor = getMPSGraphTensor(graphNode->zero_points_id());
+    zpTensor = [_mpsGraph castTensor:zpTensor
+                              toType:scalesTensor.dataType
+                                name:@"castZeroPoints"];
+    MPSGraphTensor* offsetTensor = [_mpsGraph multiplicationWithPrimaryTensor:zpTensor
+                                                              secondaryTensor:scalesTensor
+                                                                         name:nil];
+    offsetTensor = [_mpsGraph castTensor:offsetTensor
+                                  toType:wDqTensor.dataType
+                                    name:nil];
+
+    MPSShape* weightShape = getMPSShape(graphNode->output_id());
+    ET_CHECK_OR_RETURN_ERROR(
+      [weightShape count] == 2,
+      InvalidProgram,
+      "%s: expected 2D weights, got %lu dims",
+      __FUNCTION__,
+      (unsigned long)[weightShape count]);
+    const NSInteger groupSize = graphNode->group_size();
+    const NSInteger outChannels = [weightShape[0] integerValue];
+    const NSInteger inChannels = [weightShape[1] integerValue];
+    ET_CHECK_OR_RETURN_ERROR(
+      groupSize > 0 && inChannels % groupSize == 0,
+      InvalidProgram,
+      "%s: group size %ld does not divide %ld input channels",
+      __FUNCTION__,
+      (long)groupSize,
+      (long)inChannels);
+    const NSInteger numGroups = inChannels / groupSize;
+
+    MPSGraphTensor* groupedTensor = [_mpsGraph reshapeTensor:wDqTensor
+                                                   withShape:@[@(outChannels), @(numGroups), @(groupSize)]
+                                                        name:nil];
+    offsetTensor = [_mpsGraph reshapeTensor:offsetTensor
+                                  withShape:@[@(outChannels), @(numGroups), @1]
+                                       name:nil];
+    groupedTensor = [_mpsGraph subtractionWithPrimaryTensor:groupedTensor
+                                            secondaryTensor:offsetTensor
+                                                       name:nil];
+    wDqTensor = [_mpsGraph reshapeTensor:groupedTensor
+                               withShape:weightShape
+                                    name:nil];
+  }
+
   _idToMPSGraphTensor[graphNode->output_id()] = wDqTensor;
   return Error::Ok;
 }
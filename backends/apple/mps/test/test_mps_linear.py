@@ -173,6 +173,33 @@ class TestLinear(TestMPS):
                     use_bias=use_bias,
                 )
 
+    def test_qd8_fp32_per_token_weight_per_channel_group_int4_with_zero_points(
+        self,
+    ):
+        for use_bias in [True, False]:
+            mod = self.ManualDQLinear(
+                input_channels=64,
+                output_channels=32,
+                weight_n_bit=4,
+                dtype=torch.float,
+                group_size=32,
+                force_groupwise_quant=True,
+                use_bias=use_bias,
+            )
+            # Asymmetric groups, so the zero points are serialized and
+            # subtracted at runtime.
+            mod.w_zero_points.data = torch.randint(
+                -2, 3, mod.w_zero_points.shape
+            ).to(mod.w_zero_points.dtype)
+
+            inputs = (torch.randn(1, 1, 64),)
+            self._test_manual_dq_linear(
+                mod,
+                inputs,
+                weight_groupwise=True,
+                use_bias=use_bias,
+            )
+
     @unittest.skip("Need to fix the dq_per_channel_group output dtype")
     def _test_qd8_fp16_per_token_weight_per_channel_group_int4(self):
         M_sizes = [1, 2, 17, 31]
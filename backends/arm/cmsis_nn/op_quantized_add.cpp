@@ -0,0 +1,141 @@
+/*
+ * Copyright 2024 Arm Limited and/or its affiliates.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/backends/arm/cmsis_nn/quant_utils.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include "arm_nnfunctions.h"
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// The kernel of kernels/quantized, for the inputs CMSIS-NN does not cover.
+Tensor& quantized_add_out(
+    RuntimeContext& context,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    int64_t a_quant_min,
+    int64_t a_quant_max,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    int64_t b_quant_min,
+    int64_t b_quant_max,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace arm {
+namespace cmsis_nn {
+namespace native {
+
+using exec_aten::Tensor;
+using torch::executor::RuntimeContext;
+
+namespace {
+
+// The inputs are shifted left by this many bits before they are rescaled,
+// so that rescaling them to a common scale keeps their precision.
+constexpr int32_t kLeftShift = 20;
+
+} // namespace
+
+/**
+ * quantized_decomposed::add.out with arm_elementwise_add_s8 for int8 tensors
+ * of the same shape, as the Cortex-M runs them when they are not delegated.
+ * CMSIS-NN uses Helium (MVE) or the DSP extension when the target has them.
+ * Other dtypes go to the kernel of kernels/quantized.
+ */
+Tensor& quantized_add_out(
+    RuntimeContext& ctx,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    int64_t a_quant_min,
+    int64_t a_quant_max,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    int64_t b_quant_min,
+    int64_t b_quant_max,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  if (!is_elementwise_s8(a, b, out)) {
+    return torch::executor::native::quantized_add_out(
+        ctx,
+        a,
+        a_scale,
+        a_zero_point,
+        a_quant_min,
+        a_quant_max,
+        b,
+        b_scale,
+        b_zero_point,
+        b_quant_min,
+        b_quant_max,
+        out_scale,
+        out_zero_point,
+        out_quant_min,
+        out_quant_max,
+        out);
+  }
+  ET_KERNEL_CHECK(
+      ctx,
+      out_quant_min >= -128 && out_quant_max <= 127 &&
+          out_quant_min <= out_quant_max,
+      InvalidArgument,
+      out);
+
+  // Both inputs are rescaled to twice the larger input scale, added, and the
+  // sum rescaled to the output scale.
+  const double twice_max_input_scale = 2 * std::max(a_scale, b_scale);
+  int32_t a_multiplier, a_shift, b_multiplier, b_shift, out_multiplier,
+      out_shift;
+  quantize_multiplier(a_scale / twice_max_input_scale, &a_multiplier, &a_shift);
+  quantize_multiplier(b_scale / twice_max_input_scale, &b_multiplier, &b_shift);
+  quantize_multiplier(
+      twice_max_input_scale / ((1 << kLeftShift) * out_scale),
+      &out_multiplier,
+      &out_shift);
+
+  const arm_cmsis_nn_status status = arm_elementwise_add_s8(
+      a.const_data_ptr<int8_t>(),
+      b.const_data_ptr<int8_t>(),
+      static_cast<int32_t>(-a_zero_point),
+      a_multiplier,
+      a_shift,
+      static_cast<int32_t>(-b_zero_point),
+      b_multiplier,
+      b_shift,
+      kLeftShift,
+      out.mutable_data_ptr<int8_t>(),
+      static_cast<int32_t>(out_zero_point),
+      out_multiplier,
+      out_shift,
+      static_cast<int32_t>(out_quant_min),
+      static_cast<int32_t>(out_quant_max),
+      static_cast<int32_t>(out.numel()));
+  ET_KERNEL_CHECK(ctx, status == ARM_CMSIS_NN_SUCCESS, Internal, out);
+  return out;
+}
+
+} // namespace native
+} // namespace cmsis_nn
+} // namespace arm
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 Arm Limited and/or its affiliates.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace arm {
+namespace cmsis_nn {
+
+/**
+ * Splits `real_multiplier` into a Q31 `multiplier` and a power of two `shift`
+ * such that real_multiplier ~= multiplier * 2^(shift - 31), the fixed-point
+ * form CMSIS-NN requantizes with. A positive shift is a left shift.
+ */
+inline void
+quantize_multiplier(double real_multiplier, int32_t* multiplier, int32_t* shift) {
+  if (real_multiplier == 0.0) {
+    *multiplier = 0;
+    *shift = 0;
+    return;
+  }
+  int exponent = 0;
+  // The fraction is in [0.5, 1).
+  const double fraction = std::frexp(real_multiplier, &exponent);
+  int64_t q_fixed = std::llround(fraction * (int64_t(1) << 31));
+  if (q_fixed == (int64_t(1) << 31)) {
+    q_fixed /= 2;
+    ++exponent;
+  }
+  if (exponent < -31) {
+    // Too small to represent, every product requantizes to zero.
+    *multiplier = 0;
+    *shift = 0;
+    return;
+  }
+  *multiplier = static_cast<int32_t>(q_fixed);
+  *shift = exponent;
+}
+
+/**
+ * Whether `a`, `b` and `out` are int8 tensors of the same shape, which the
+ * CMSIS-NN elementwise kernels work on as flat arrays.
+ */
+inline bool is_elementwise_s8(
+    const exec_aten::Tensor& a,
+    const exec_aten::Tensor& b,
+    const exec_aten::Tensor& out) {
+  using exec_aten::ScalarType;
+  if (a.scalar_type() != ScalarType::Char ||
+      b.scalar_type() != ScalarType::Char ||
+      out.scalar_type() != ScalarType::Char || a.dim() != b.dim() ||
+      a.dim() != out.dim()) {
+    return false;
+  }
+  for (size_t d = 0; d < a.dim(); ++d) {
+    if (a.size(d) != b.size(d) || a.size(d) != out.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace cmsis_nn
+} // namespace arm
@@ -15,6 +15,10 @@
 #include <ethosu_driver.h>
 #include <pmu_ethosu.h>
 
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#endif
+
 #include "executorch/backends/arm/runtime/VelaBinStream.h"
 #include "executorch/runtime/backend/interface.h"
 #include "executorch/runtime/core/error.h"
@@ -145,12 +149,19 @@ class ArmBackend final : public PyTorchBackendInterface {
 
       // Select a compatible copy routine
       if (both_char and permuted_input_shape) {
-        // permuted byte copy CHW to HWC
-        permute_CHW_to_HWC(
-            scratch_addr,
-            tensor_in.mutable_data_ptr<char>(),
+        // permuted byte copy NCHW to NHWC
+        permute_NCHW_to_NHWC(
+            tensor_in.const_data_ptr<int8_t>(),
+            reinterpret_cast<int8_t*>(scratch_addr),
+            tensor_in.size(0),
+            tensor_in.size(1),
             tensor_in.size(2),
             tensor_in.size(3));
+      } else if (
+          (both_char or both_int) and
+          tensor_in.const_data_ptr<char>() == scratch_addr) {
+        // Input was placed directly in its scratch slot, nothing to copy
+        continue;
       } else if (both_char or both_int) {
         // Sizes match and elt size matches so memcpy
         memcpy(
@@ -198,18 +209,24 @@ class ArmBackend final : public PyTorchBackendInterface {
     for (int i = 0; i < handles.outputs->count; i++) {
       const char* output_addr =
           handles.scratch_data + handles.outputs->io[i].offset;
-      // Process input EValue into scratch
       // Outputs are in the index immediately after inputs
       auto tensor_out = args[handles.inputs->count + i]->toTensor();
-      for (int j = 0; j < tensor_out.numel(); j++) {
-        if (tensor_out.scalar_type() == ScalarType::Char) {
-          char* output_address = (char*)output_addr;
-          tensor_out.mutable_data_ptr<char>()[j] = output_address[j];
-        } else {
-          int* output_address = (int*)output_addr;
-          tensor_out.mutable_data_ptr<int>()[j] = output_address[j];
-        }
+      if (tensor_out.element_size() != handles.outputs->io[i].elem_size) {
+        ET_LOG(
+            Error,
+            "Output %d element size %zd doesn't match Ethos-U output size %d",
+            i,
+            tensor_out.element_size(),
+            handles.outputs->io[i].elem_size);
+        return Error::InvalidProgram;
+      }
+      // Layouts match so copy the whole tensor at once, unless the output
+      // already aliases its scratch slot
+      if (tensor_out.const_data_ptr<char>() == output_addr) {
+        continue;
       }
+      memcpy(
+          tensor_out.mutable_data_ptr<char>(), output_addr, tensor_out.nbytes());
     }
 
     return Error::Ok;
@@ -262,11 +279,43 @@ class ArmBackend final : public PyTorchBackendInterface {
     return Error::Ok;
   }
 
-  void permute_CHW_to_HWC(char* input, char* output, int H, int W) const {
-    for (int i = 0; i != H * W; ++i) {
-      output[i * 3 + 0] = input[i + 0 * W * H];
-      output[i * 3 + 1] = input[i + 1 * W * H];
-      output[i * 3 + 2] = input[i + 2 * W * H];
+  // Interleave the C planes of each batch into channel last order. Rather
+  // than a strided read per output element, whole rows of a plane are moved
+  // at a time, using Helium scatter stores where available.
+  void permute_NCHW_to_NHWC(
+      const int8_t* input,
+      int8_t* output,
+      int N,
+      int C,
+      int H,
+      int W) const {
+    const int plane = H * W;
+    for (int n = 0; n < N; ++n) {
+      const int8_t* src = input + n * C * plane;
+      int8_t* dst = output + n * C * plane;
+      if (C == 1) {
+        memcpy(dst, src, plane);
+        continue;
+      }
+      for (int c = 0; c < C; ++c) {
+        const int8_t* src_plane = src + c * plane;
+        int8_t* dst_channel = dst + c;
+        int i = 0;
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+        // Byte offsets of 16 consecutive pixels must fit in 8 bits
+        if (C <= 17) {
+          const uint8x16_t offsets =
+              vmulq_n_u8(vidupq_n_u8(0, 1), static_cast<uint8_t>(C));
+          for (; i + 16 <= plane; i += 16) {
+            vstrbq_scatter_offset_s8(
+                dst_channel + i * C, offsets, vld1q_s8(src_plane + i));
+          }
+        }
+#endif
+        for (; i < plane; ++i) {
+          dst_channel[i * C] = src_plane[i];
+        }
+      }
     }
   }
 };
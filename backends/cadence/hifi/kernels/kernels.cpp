@@ -6,10 +6,18 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/backends/cadence/reference/kernels/kernels.h>
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
 #include "xa_nnlib_common.h"
 #include "xa_nnlib_common_macros.h"
 
+#ifdef CADENCE_HIFI_USE_IDMA
+#include <xtensa/idma.h>
+// Place the tile buffers in local data RAM.
+#define CADENCE_HIFI_LOCAL_DATA __attribute__((section(".dram0.data")))
+#else
+#define CADENCE_HIFI_LOCAL_DATA
+#endif
+
 namespace impl {
 namespace HiFi {
 namespace kernels {
@@ -19,6 +27,49 @@ memcpy(void* dst, const void* src, size_t num_bytes) {
   MEMCPY_8b(dst, src, num_bytes);
 }
 
+alignas(16) static UWORD8 local_tiles[2][kLocalTileBytes]
+    CADENCE_HIFI_LOCAL_DATA;
+
+UWORD8* local_tile(int index) {
+  return local_tiles[index & 1];
+}
+
+#ifdef CADENCE_HIFI_USE_IDMA
+namespace {
+
+constexpr int32_t kDmaChannel = 0;
+// One descriptor per tile buffer is enough, since at most one copy is in
+// flight while the other buffer is being read.
+IDMA_BUFFER_DEFINE(dma_descriptors, 2, IDMA_1D_DESC);
+bool dma_initialized = false;
+
+void dma_init() {
+  if (!dma_initialized) {
+    idma_init(kDmaChannel, 0, MAX_BLOCK_16, 8, TICK_CYCLES_8, 0, nullptr);
+    idma_init_loop(
+        kDmaChannel, dma_descriptors, IDMA_1D_DESC, 2, nullptr, nullptr);
+    dma_initialized = true;
+  }
+}
+
+} // namespace
+
+void dma_copy_start(void* dst, const void* src, size_t num_bytes) {
+  dma_init();
+  idma_copy_desc(kDmaChannel, dst, const_cast<void*>(src), num_bytes, 0);
+}
+
+void dma_wait() {
+  idma_hw_wait_all(kDmaChannel);
+}
+#else
+void dma_copy_start(void* dst, const void* src, size_t num_bytes) {
+  memcpy(dst, src, num_bytes);
+}
+
+void dma_wait() {}
+#endif
+
 // Quantize a fp32 value to an int8_t/uint8_t value
 template <typename T>
 __attribute__((always_inline)) T
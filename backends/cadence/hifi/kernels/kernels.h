@@ -12,6 +12,8 @@
 #include "stddef.h"
 #include "xa_type_def.h"
 
+#include <algorithm>
+
 /* For NNLIB APIs */
 #include "xa_nnlib_kernels_api.h"
 
@@ -21,6 +23,64 @@ namespace kernels {
 
 void memcpy(void* dst, const void* src, size_t num_bytes);
 
+// Weight tiles are staged into two buffers in local data RAM before the nnlib
+// kernels read them. Built with CADENCE_HIFI_USE_IDMA the copies run on an
+// iDMA channel and overlap with compute on the previous tile; otherwise they
+// are plain copies and only the locality is gained.
+#ifndef CADENCE_HIFI_LOCAL_TILE_BYTES
+#define CADENCE_HIFI_LOCAL_TILE_BYTES 8192
+#endif
+constexpr size_t kLocalTileBytes = CADENCE_HIFI_LOCAL_TILE_BYTES;
+#ifdef CADENCE_HIFI_USE_IDMA
+constexpr bool kAsyncTileCopy = true;
+#else
+constexpr bool kAsyncTileCopy = false;
+#endif
+
+// Returns local tile buffer 0 or 1, each kLocalTileBytes long.
+UWORD8* local_tile(int index);
+
+// Starts copying num_bytes from src to dst. The copy is only guaranteed to be
+// complete once dma_wait() returns.
+void dma_copy_start(void* dst, const void* src, size_t num_bytes);
+void dma_wait();
+
+// Calls fn(tile, row_begin, row_count) over consecutive tiles of rows of the
+// [rows x row_bytes] matrix src, each staged in local memory. The copy of the
+// next tile is in flight while fn runs on the current one. Returns false
+// without calling fn when a single row does not fit in a tile.
+template <typename Fn>
+bool for_each_local_row_tile(
+    const UWORD8* src,
+    WORD32 rows,
+    WORD32 row_bytes,
+    Fn fn) {
+  if (row_bytes <= 0 || static_cast<size_t>(row_bytes) > kLocalTileBytes) {
+    return false;
+  }
+  const WORD32 tile_rows =
+      std::min<WORD32>(rows, static_cast<WORD32>(kLocalTileBytes / row_bytes));
+  if (tile_rows <= 0) {
+    return true;
+  }
+  int buffer = 0;
+  dma_copy_start(local_tile(buffer), src, tile_rows * row_bytes);
+  for (WORD32 row = 0; row < rows; row += tile_rows) {
+    const WORD32 count = std::min(tile_rows, rows - row);
+    dma_wait();
+    const WORD32 next = row + count;
+    if (next < rows) {
+      dma_copy_start(
+          local_tile(buffer ^ 1),
+          src + next * row_bytes,
+          std::min(tile_rows, rows - next) * row_bytes);
+    }
+    fn(local_tile(buffer), row, count);
+    buffer ^= 1;
+  }
+  return true;
+}
+
 WORD32 matmul_asym8uxasym8u_asym8u(
     UWORD8* __restrict__ p_out, // output uint8 matrix
     const UWORD8* __restrict__ p_mat1, // weight uint8 matrix
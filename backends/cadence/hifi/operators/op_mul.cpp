@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+Tensor& mul_out(
+    RuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_CHECK_MSG(
+      a.scalar_type() == ScalarType::Float, "Input tensor not a float.\n");
+  ET_CHECK_MSG(
+      b.scalar_type() == ScalarType::Float, "Input tensor not a float.\n");
+  ET_CHECK_MSG(
+      out.scalar_type() == ScalarType::Float, "Output tensor not a float.\n");
+
+  // Same-shape inputs map directly onto the nnlib elementwise kernel.
+  if (tensors_have_same_shape(a, b) && tensors_have_same_shape(a, out)) {
+    WORD32 ret = xa_nn_elm_mul_f32xf32_f32(
+        out.mutable_data_ptr<float>(),
+        a.const_data_ptr<float>(),
+        b.const_data_ptr<float>(),
+        out.numel());
+    ET_DCHECK_MSG(ret == 0, "HiFi mul failed");
+    return out;
+  }
+
+  apply_binary_elementwise_fn<float, float, float>(
+      [](const float val_a, const float val_b) { return val_a * val_b; },
+      a,
+      b,
+      out);
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
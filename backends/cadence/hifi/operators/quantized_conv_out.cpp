@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <cmath>
+
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using RuntimeContext = torch::executor::RuntimeContext;
+
+namespace {
+
+// Size of the on-stack im2col tile used when the runtime context has no temp
+// allocator.
+constexpr size_t kIm2colStackTileBytes = 2048;
+
+// Gathers the receptive fields of output positions [pos_begin, pos_end) of one
+// group into consecutive rows of `cols`, each icpg * wh * ww long. Taps that
+// fall into the padding read as the input zero point, so that they contribute
+// nothing once the zero point is subtracted.
+void im2col_nchw(
+    const uint8_t* __restrict__ in_group,
+    uint8_t* __restrict__ cols,
+    int32_t icpg,
+    int32_t h,
+    int32_t w,
+    int32_t wh,
+    int32_t ww,
+    int32_t ow,
+    int32_t s0,
+    int32_t s1,
+    int32_t p0,
+    int32_t p1,
+    int32_t d0,
+    int32_t d1,
+    uint8_t in_zero_point,
+    int32_t pos_begin,
+    int32_t pos_end) {
+  for (int32_t pos = pos_begin; pos < pos_end; ++pos) {
+    const int32_t _h = (pos / ow) * s0 - p0;
+    const int32_t _w = (pos % ow) * s1 - p1;
+    for (int32_t _ic = 0; _ic < icpg; ++_ic) {
+      const uint8_t* in_plane = in_group + _ic * h * w;
+      for (int32_t _wh = 0; _wh < wh; ++_wh) {
+        const int32_t ih = _h + d0 * _wh;
+        for (int32_t _ww = 0; _ww < ww; ++_ww) {
+          const int32_t iw = _w + d1 * _ww;
+          *cols++ = (ih >= 0 && ih < h && iw >= 0 && iw < w)
+              ? in_plane[ih * w + iw]
+              : in_zero_point;
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+// The quantized convolution kernel, lowered to the nnlib matmul: for every
+// batch and group the receptive fields are gathered into rows (im2col), and
+// the [ocpg x icpg*wh*ww] weight slice is multiplied against them, writing
+// each output channel plane directly. The weight slice is double-buffered
+// through local memory a tile of output channels at a time. The output is
+// requantized with out_multiplier and out_shift, per channel when they hold
+// one entry per output channel. Only NCHW uint8 is handled, as in the
+// reference kernel.
+void quantized_conv_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    exec_aten::IntArrayRef stride,
+    exec_aten::IntArrayRef padding,
+    exec_aten::IntArrayRef dilation,
+    int64_t groups,
+    int64_t in_zero_point,
+    const Tensor& weight_zero_point,
+    const Tensor& bias_scale,
+    double output_scale,
+    int64_t output_zero_point,
+    const Tensor& out_multiplier,
+    const Tensor& out_shift,
+    bool channel_last,
+    Tensor& out) {
+  (void)bias_scale;
+  (void)output_scale;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !channel_last,
+      NotSupported,
+      ,
+      "HiFi quantized::conv only supports NCHW");
+
+  bool conv1d = input.dim() == 3;
+  // input = [n, c, h, w]
+  const int32_t n = input.size(0);
+  const int32_t c = input.size(1);
+  const int32_t h = conv1d ? 1 : input.size(2);
+  const int32_t w = conv1d ? input.size(2) : input.size(3);
+  // weight = [oc, wc, wh, ww]
+  const int32_t oc = weight.size(0);
+  const int32_t wc = weight.size(1);
+  const int32_t wh = conv1d ? 1 : weight.size(2);
+  const int32_t ww = conv1d ? weight.size(2) : weight.size(3);
+  // output = [n, oc, oh, ow]
+  const int32_t oh = conv1d ? 1 : out.size(2);
+  const int32_t ow = conv1d ? out.size(2) : out.size(3);
+
+  const int32_t s0 = conv1d ? 1 : stride[0];
+  const int32_t s1 = conv1d ? stride[0] : stride[1];
+  const int32_t p0 = conv1d ? 0 : padding[0];
+  const int32_t p1 = conv1d ? padding[0] : padding[1];
+  const int32_t d0 = conv1d ? 1 : dilation[0];
+  const int32_t d1 = conv1d ? dilation[0] : dilation[1];
+
+  const int32_t ocpg = oc / groups;
+  const int32_t icpg = c / groups;
+  const int32_t kernel_size = wc * wh * ww;
+  const int32_t out_plane_size = oh * ow;
+
+  // Gather all output positions of a group at once when temp memory is
+  // available, otherwise as many as fit in a fixed tile.
+  uint8_t stack_tile[kIm2colStackTileBytes];
+  uint8_t* cols = stack_tile;
+  int32_t tile_positions = kIm2colStackTileBytes / std::max(kernel_size, 1);
+  torch::executor::Result<void*> scratch =
+      ctx.allocate_temp(static_cast<size_t>(kernel_size) * out_plane_size);
+  if (scratch.ok()) {
+    cols = static_cast<uint8_t*>(scratch.get());
+    tile_positions = out_plane_size;
+  }
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      tile_positions > 0,
+      MemoryAllocationFailed,
+      ,
+      "im2col needs temp memory for kernels larger than %zu",
+      kIm2colStackTileBytes);
+
+  const bool per_channel_quantized = out_multiplier.numel() > 1;
+  const int32_t weight_zero_bias =
+      -weight_zero_point.const_data_ptr<int32_t>()[0];
+  const uint8_t* __restrict__ in_data = input.const_data_ptr<uint8_t>();
+  const uint8_t* __restrict__ weight_data = weight.const_data_ptr<uint8_t>();
+  const int32_t* __restrict__ bias_data = bias.const_data_ptr<int32_t>();
+  const int32_t* __restrict__ multiplier_data =
+      out_multiplier.const_data_ptr<int32_t>();
+  const int32_t* __restrict__ shift_data = out_shift.const_data_ptr<int32_t>();
+  uint8_t* __restrict__ out_data = out.mutable_data_ptr<uint8_t>();
+
+  for (int32_t _n = 0; _n < n; ++_n) {
+    const uint8_t* in_batch = in_data + _n * c * h * w;
+    uint8_t* out_batch = out_data + _n * oc * out_plane_size;
+    for (int32_t _g = 0; _g < groups; ++_g) {
+      const int32_t sic = _g * icpg;
+      const int32_t soc = _g * ocpg;
+      for (int32_t pos = 0; pos < out_plane_size; pos += tile_positions) {
+        const int32_t positions =
+            std::min(tile_positions, out_plane_size - pos);
+        im2col_nchw(
+            in_batch + sic * h * w,
+            cols,
+            icpg,
+            h,
+            w,
+            wh,
+            ww,
+            ow,
+            s0,
+            s1,
+            p0,
+            p1,
+            d0,
+            d1,
+            static_cast<uint8_t>(in_zero_point),
+            pos,
+            pos + positions);
+
+        // The nnlib kernel, with rows [row, row + count) of the weight slice
+        // of this group as the matrix and the gathered receptive fields as
+        // the vectors.
+        auto conv_rows = [&](const uint8_t* weights,
+                             int32_t row,
+                             int32_t count) {
+          const int32_t _oc = soc + row;
+          int32_t ret = impl::HiFi::kernels::matmul_asym8uxasym8u_asym8u(
+              out_batch + _oc * out_plane_size + pos, // p_out
+              weights, // p_mat1,
+              cols, // p_mat2,
+              bias_data + _oc, // p_bias
+              count, // rows of p_mat1
+              kernel_size, // cols of p_mat1
+              kernel_size, // row_stride of p_mat1
+              positions, // vec_count, i.e., rows of p_mat2
+              kernel_size, // vec_offset of p_mat2.
+              1, // out_offset, i.e., offset of next output element written
+              out_plane_size, // out_stride, i.e., stride to next output row
+              weight_zero_bias, // mat1_zero_bias
+              -static_cast<int32_t>(in_zero_point), // mat2_zero_bias
+              multiplier_data + (per_channel_quantized ? _oc : 0),
+              shift_data + (per_channel_quantized ? _oc : 0),
+              output_zero_point, // out_zero_bias
+              per_channel_quantized); // per channel quantization
+          ET_DCHECK_MSG(ret == 0, "HiFi quantized::conv failed");
+        };
+
+        // Stream the weight slice through local memory, overlapping the
+        // copy of the next tile of output channels with the current one.
+        // Slices whose rows do not fit a tile are read in place.
+        const uint8_t* weight_slice = weight_data + soc * kernel_size;
+        if (!impl::HiFi::kernels::for_each_local_row_tile(
+                weight_slice, ocpg, kernel_size, conv_rows)) {
+          conv_rows(weight_slice, 0, ocpg);
+        }
+      }
+    }
+  }
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
@@ -6,7 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/backends/cadence/reference/kernels/kernels.h>
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
 
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
@@ -44,6 +44,45 @@ void quantized_linear_out(
   const int32_t* __restrict__ bias_data = bias.const_data_ptr<int32_t>();
   uint8_t* __restrict__ out_data = out.mutable_data_ptr<uint8_t>();
 
+  const int32_t mat1_zero_bias =
+      -weight_zero_point.const_data_ptr<int32_t>()[0];
+  const int32_t* multiplier_data = out_multiplier.const_data_ptr<int32_t>();
+  const int32_t* shift_data = out_shift.const_data_ptr<int32_t>();
+
+  // The weight is streamed through local memory a tile of rows at a time
+  // when it is reused across input rows, or when the copies overlap with
+  // compute. Each tile produces a column block of the output.
+  if (leading_dims > 1 || impl::HiFi::kernels::kAsyncTileCopy) {
+    const bool tiled = impl::HiFi::kernels::for_each_local_row_tile(
+        weight_data,
+        out_dim,
+        in_dim,
+        [&](const uint8_t* tile, int32_t row, int32_t count) {
+          int32_t ret = impl::HiFi::kernels::matmul_asym8uxasym8u_asym8u(
+              out_data + row, // p_out
+              tile, // p_mat1,
+              in_data, // p_mat2,
+              bias_data + row, // p_bias
+              count, // rows of p_mat1
+              in_dim, // cols of p_mat1
+              in_dim, // row_stride of p_mat1
+              leading_dims, // vec_count, i.e., rows of p_mat2
+              in_dim, // vec_offset of p_mat2.
+              out_dim, // out_offset, i.e., offset of next output element
+              1, // out_stride, i.e., stride to go to next output row
+              mat1_zero_bias, // mat1_zero_bias
+              -src_zero_point, // mat2_zero_bias
+              multiplier_data, // out_multiplier
+              shift_data, // out_shift
+              out_zero_point, // out_zero_bias
+              false); // per channel quantization
+          ET_DCHECK_MSG(ret == 0, "HiFi quantized::linear failed");
+        });
+    if (tiled) {
+      return;
+    }
+  }
+
   // The nnlib kernel to compute quantized linear via matmul.
   int32_t ret = impl::HiFi::kernels::matmul_asym8uxasym8u_asym8u(
       out_data, // p_out
@@ -57,10 +96,10 @@ void quantized_linear_out(
       in_dim, // vec_offset of p_mat2.
       out_dim, // out_offset, i.e., offset of next output element written
       1, // out_stride, i.e., stride to go to next output row
-      -weight_zero_point.const_data_ptr<int32_t>()[0], // mat1_zero_bias
+      mat1_zero_bias, // mat1_zero_bias
       -src_zero_point, // mat2_zero_bias
-      out_multiplier.const_data_ptr<int32_t>(), // out_multiplier
-      out_shift.const_data_ptr<int32_t>(), // out_shift
+      multiplier_data, // out_multiplier
+      shift_data, // out_shift
       out_zero_point, // out_zero_bias
       false); // per channel quantization
   ET_DCHECK_MSG(ret == 0, "HiFi quantized::linear failed");
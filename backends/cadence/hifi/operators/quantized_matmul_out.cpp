@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <cmath>
+
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using RuntimeContext = torch::executor::RuntimeContext;
+
+namespace {
+
+// The generic quantized matmul, used for the cases the nnlib kernel does not
+// cover. Y is [n x p], or [p x n] when transposed.
+template <typename T, bool transposed>
+void qmatmul_generic(
+    T* __restrict__ Z,
+    int32_t Z_multiplier,
+    int32_t Z_shift,
+    int32_t Z_zero_point,
+    const T* __restrict__ X,
+    int32_t X_zero_point,
+    const T* __restrict__ y,
+    int32_t Y_zero_point,
+    size_t m,
+    size_t n,
+    size_t p) {
+  // Compute the Z_scale from Z_multiplier and Z_shift
+  const float Z_scale = Z_multiplier * 1.0 / (1u << 31) * pow(2, Z_shift);
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t j = 0; j < p; ++j) {
+      int32_t sum = 0;
+      for (size_t k = 0; k < n; ++k) {
+        const int32_t rhs = transposed ? y[j * n + k] : y[k * p + j];
+        sum += (X[i * n + k] - X_zero_point) * (rhs - Y_zero_point);
+      }
+      Z[i * p + j] = kernels::quantize<T>(sum, Z_scale, Z_zero_point);
+    }
+  }
+}
+
+} // namespace
+
+// The quantized matmul. uint8 inputs go through the nnlib matmul, which wants
+// the weight operand as [p x n] rows: a transposed Y is used in place, and a
+// non-transposed Y is transposed into temp memory once per batch. Without a
+// temp allocator, and for int8, the generic loop is used instead.
+void quantized_matmul_out(
+    RuntimeContext& ctx,
+    const Tensor& X,
+    int64_t X_zero_point,
+    const Tensor& Y,
+    int64_t Y_zero_point,
+    const exec_aten::optional<Tensor>& bias,
+    int64_t out_multiplier,
+    int64_t out_shift,
+    int64_t out_zero_point,
+    bool transposed,
+    Tensor& out) {
+  (void)bias;
+
+  const size_t batch_size = getLeadingDims(X, X.dim() - 2);
+  const size_t leading_dim = X.size(X.dim() - 2);
+  const size_t out_dim = Y.size(Y.dim() - 1 - transposed);
+  const size_t in_dim = X.size(X.dim() - 1);
+
+  const int32_t multiplier = static_cast<int32_t>(out_multiplier);
+  const int32_t shift = static_cast<int32_t>(out_shift);
+
+  if (out.scalar_type() == exec_aten::ScalarType::Char) {
+    int8_t* __restrict__ out_data = out.mutable_data_ptr<int8_t>();
+    const int8_t* __restrict__ X_data = X.const_data_ptr<int8_t>();
+    const int8_t* __restrict__ Y_data = Y.const_data_ptr<int8_t>();
+    for (size_t i = 0; i < batch_size; ++i) {
+      const int8_t* x = X_data + i * leading_dim * in_dim;
+      const int8_t* y = Y_data + i * in_dim * out_dim;
+      int8_t* z = out_data + i * leading_dim * out_dim;
+      if (transposed) {
+        qmatmul_generic<int8_t, true>(
+            z,
+            multiplier,
+            shift,
+            out_zero_point,
+            x,
+            X_zero_point,
+            y,
+            Y_zero_point,
+            leading_dim,
+            in_dim,
+            out_dim);
+      } else {
+        qmatmul_generic<int8_t, false>(
+            z,
+            multiplier,
+            shift,
+            out_zero_point,
+            x,
+            X_zero_point,
+            y,
+            Y_zero_point,
+            leading_dim,
+            in_dim,
+            out_dim);
+      }
+    }
+    return;
+  }
+
+  uint8_t* __restrict__ out_data = out.mutable_data_ptr<uint8_t>();
+  const uint8_t* __restrict__ X_data = X.const_data_ptr<uint8_t>();
+  const uint8_t* __restrict__ Y_data = Y.const_data_ptr<uint8_t>();
+
+  uint8_t* y_transposed = nullptr;
+  if (!transposed) {
+    torch::executor::Result<void*> scratch =
+        ctx.allocate_temp(in_dim * out_dim * sizeof(uint8_t));
+    if (scratch.ok()) {
+      y_transposed = static_cast<uint8_t*>(scratch.get());
+    }
+  }
+
+  for (size_t i = 0; i < batch_size; ++i) {
+    const uint8_t* x = X_data + i * leading_dim * in_dim;
+    const uint8_t* y = Y_data + i * in_dim * out_dim;
+    uint8_t* z = out_data + i * leading_dim * out_dim;
+
+    if (!transposed) {
+      if (y_transposed == nullptr) {
+        qmatmul_generic<uint8_t, false>(
+            z,
+            multiplier,
+            shift,
+            out_zero_point,
+            x,
+            X_zero_point,
+            y,
+            Y_zero_point,
+            leading_dim,
+            in_dim,
+            out_dim);
+        continue;
+      }
+      for (size_t k = 0; k < in_dim; ++k) {
+        for (size_t j = 0; j < out_dim; ++j) {
+          y_transposed[j * in_dim + k] = y[k * out_dim + j];
+        }
+      }
+      y = y_transposed;
+    }
+
+    // The nnlib kernel to compute quantized matmul, with y as the weight
+    // matrix and the rows of x as the vectors.
+    int32_t ret = impl::HiFi::kernels::matmul_asym8uxasym8u_asym8u(
+        z, // p_out
+        y, // p_mat1,
+        x, // p_mat2,
+        nullptr, // p_bias
+        out_dim, // rows of p_mat1
+        in_dim, // cols of p_mat1
+        in_dim, // row_stride of p_mat1
+        leading_dim, // vec_count, i.e., rows of p_mat2
+        in_dim, // vec_offset of p_mat2.
+        out_dim, // out_offset, i.e., offset of next output element written
+        1, // out_stride, i.e., stride to go to next output row
+        -static_cast<int32_t>(Y_zero_point), // mat1_zero_bias
+        -static_cast<int32_t>(X_zero_point), // mat2_zero_bias
+        &multiplier, // out_multiplier
+        &shift, // out_shift
+        out_zero_point, // out_zero_bias
+        false); // per channel quantization
+    ET_DCHECK_MSG(ret == 0, "HiFi quantized::matmul failed");
+  }
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
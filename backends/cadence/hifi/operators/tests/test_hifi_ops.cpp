@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using exec_aten::ArrayRef;
+using exec_aten::IntArrayRef;
+using exec_aten::Scalar;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::KernelRuntimeContext;
+using torch::executor::MemoryAllocator;
+using torch::executor::RuntimeContext;
+using torch::executor::testing::TensorFactory;
+
+// The HiFi kernels under test. There is no header for them: the generated
+// operator library declares them.
+namespace torch {
+namespace executor {
+namespace native {
+Tensor& add_out(
+    RuntimeContext& ctx,
+    const Tensor& a,
+    const Tensor& b,
+    const Scalar& alpha,
+    Tensor& out);
+Tensor&
+mul_out(RuntimeContext& ctx, const Tensor& a, const Tensor& b, Tensor& out);
+Tensor& softmax_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out);
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace impl {
+namespace HiFi {
+namespace native {
+void quantized_matmul_out(
+    RuntimeContext& ctx,
+    const Tensor& X,
+    int64_t X_zero_point,
+    const Tensor& Y,
+    int64_t Y_zero_point,
+    const exec_aten::optional<Tensor>& bias,
+    int64_t out_multiplier,
+    int64_t out_shift,
+    int64_t out_zero_point,
+    bool transposed,
+    Tensor& out);
+void quantized_conv_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    int64_t in_zero_point,
+    const Tensor& weight_zero_point,
+    const Tensor& bias_scale,
+    double output_scale,
+    int64_t output_zero_point,
+    const Tensor& out_multiplier,
+    const Tensor& out_shift,
+    bool channel_last,
+    Tensor& out);
+} // namespace native
+} // namespace HiFi
+} // namespace impl
+
+namespace {
+
+// An out_multiplier and out_shift pair that requantizes by a scale of 1, so
+// that the expected outputs are exact.
+constexpr int32_t kUnitMultiplier = 1 << 30;
+constexpr int32_t kUnitShift = 1;
+
+class HiFiOperatorTest : public OperatorTest {
+ protected:
+  // A context whose temp allocator the kernels can use for scratch memory,
+  // unlike context_.
+  KernelRuntimeContext& temp_context() {
+    temp_allocator_.reset();
+    return temp_context_;
+  }
+
+  std::vector<uint8_t> temp_buffer_ = std::vector<uint8_t>(64 * 1024);
+  MemoryAllocator temp_allocator_{
+      static_cast<uint32_t>(temp_buffer_.size()),
+      temp_buffer_.data()};
+  KernelRuntimeContext temp_context_{nullptr, &temp_allocator_};
+};
+
+} // namespace
+
+TEST_F(HiFiOperatorTest, AddSameShape) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({2, 3});
+  torch::executor::native::add_out(
+      context_,
+      tf.make({2, 3}, {1, 2, 3, 4, 5, 6}),
+      tf.make({2, 3}, {0.5, -2, 1, 0, 2.5, -7}),
+      Scalar(1.0),
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 3}, {1.5, 0, 4, 4, 7.5, -1}));
+}
+
+TEST_F(HiFiOperatorTest, AddBroadcastWithAlpha) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({2, 3});
+  torch::executor::native::add_out(
+      context_,
+      tf.make({2, 3}, {1, 2, 3, 4, 5, 6}),
+      tf.make({1, 3}, {1, -1, 2}),
+      Scalar(2.0),
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 3}, {3, 0, 7, 6, 3, 10}));
+}
+
+TEST_F(HiFiOperatorTest, MulSameShape) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({5});
+  torch::executor::native::mul_out(
+      context_,
+      tf.make({5}, {1, 2, 3, -4, 0.5}),
+      tf.make({5}, {2, 0, -1, 0.25, 8}),
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({5}, {2, 0, -3, -1, 4}));
+}
+
+TEST_F(HiFiOperatorTest, MulBroadcast) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({2, 2});
+  torch::executor::native::mul_out(
+      context_, tf.make({2, 1}, {2, -3}), tf.make({2}, {1, 4}), out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 2}, {2, 8, -3, -12}));
+}
+
+TEST_F(HiFiOperatorTest, SoftmaxLastDim) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({2, 3});
+  torch::executor::native::softmax_out(
+      context_,
+      tf.make({2, 3}, {0, 0, 0, 1, 2, 3}),
+      /*dim=*/-1,
+      /*half_to_float=*/false,
+      out);
+  EXPECT_TENSOR_CLOSE(
+      out,
+      tf.make(
+          {2, 3},
+          {1.0 / 3,
+           1.0 / 3,
+           1.0 / 3,
+           0.09003057,
+           0.24472847,
+           0.66524096}));
+}
+
+TEST_F(HiFiOperatorTest, SoftmaxInnerDim) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros({2, 2});
+  torch::executor::native::softmax_out(
+      context_,
+      tf.make({2, 2}, {0, 1, 0, 3}),
+      /*dim=*/0,
+      /*half_to_float=*/false,
+      out);
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({2, 2}, {0.5, 0.11920292, 0.5, 0.88079708}));
+}
+
+namespace {
+
+// X is [2 x 3] and Y is [3 x 2], with zero points 1 and 2:
+//   X - 1 = [[1, 2, 3], [0, 4, 1]]
+//   Y - 2 = [[1, 0], [2, 3], [0, 4]]
+// so (X - 1)(Y - 2) = [[5, 18], [8, 16]], and the output is that plus its
+// zero point.
+const std::vector<int32_t> kMatmulX = {2, 3, 4, 1, 5, 2};
+const std::vector<int32_t> kMatmulY = {3, 2, 4, 5, 2, 6};
+const std::vector<int32_t> kMatmulYTransposed = {3, 4, 2, 2, 5, 6};
+const std::vector<int32_t> kMatmulProduct = {5, 18, 8, 16};
+
+// Makes a tensor of 8-bit values with tf, which owns its memory.
+template <ScalarType DTYPE>
+Tensor make_quantized(
+    TensorFactory<DTYPE>& tf,
+    const std::vector<int32_t>& sizes,
+    const std::vector<int32_t>& values) {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  return tf.make(sizes, std::vector<CTYPE>(values.begin(), values.end()));
+}
+
+std::vector<int32_t> plus(std::vector<int32_t> values, int32_t offset) {
+  for (auto& v : values) {
+    v += offset;
+  }
+  return values;
+}
+
+} // namespace
+
+TEST_F(HiFiOperatorTest, QuantizedMatmulUint8) {
+  TensorFactory<ScalarType::Byte> tf;
+  const Tensor x = make_quantized(tf, {2, 3}, kMatmulX);
+  const Tensor expected =
+      make_quantized(tf, {2, 2}, plus(kMatmulProduct, 10));
+
+  // Y is transposed into temp memory for the nnlib kernel.
+  Tensor out = tf.zeros({2, 2});
+  impl::HiFi::native::quantized_matmul_out(
+      temp_context(),
+      x,
+      1,
+      make_quantized(tf, {3, 2}, kMatmulY),
+      2,
+      exec_aten::nullopt,
+      kUnitMultiplier,
+      kUnitShift,
+      10,
+      /*transposed=*/false,
+      out);
+  EXPECT_TENSOR_EQ(out, expected);
+
+  // A transposed Y is used in place.
+  out = tf.zeros({2, 2});
+  impl::HiFi::native::quantized_matmul_out(
+      context_,
+      x,
+      1,
+      make_quantized(tf, {2, 3}, kMatmulYTransposed),
+      2,
+      exec_aten::nullopt,
+      kUnitMultiplier,
+      kUnitShift,
+      10,
+      /*transposed=*/true,
+      out);
+  EXPECT_TENSOR_EQ(out, expected);
+
+  // Without temp memory the generic loop gives the same result.
+  out = tf.zeros({2, 2});
+  impl::HiFi::native::quantized_matmul_out(
+      context_,
+      x,
+      1,
+      make_quantized(tf, {3, 2}, kMatmulY),
+      2,
+      exec_aten::nullopt,
+      kUnitMultiplier,
+      kUnitShift,
+      10,
+      /*transposed=*/false,
+      out);
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST_F(HiFiOperatorTest, QuantizedMatmulUint8Batched) {
+  TensorFactory<ScalarType::Byte> tf;
+  // The second batch has Y at its zero point, so its output is the output
+  // zero point.
+  std::vector<int32_t> x = kMatmulX;
+  x.insert(x.end(), kMatmulX.begin(), kMatmulX.end());
+  std::vector<int32_t> y = kMatmulY;
+  y.insert(y.end(), 6, 2);
+  std::vector<int32_t> expected = plus(kMatmulProduct, 10);
+  expected.insert(expected.end(), 4, 10);
+
+  Tensor out = tf.zeros({2, 2, 2});
+  impl::HiFi::native::quantized_matmul_out(
+      temp_context(),
+      make_quantized(tf, {2, 2, 3}, x),
+      1,
+      make_quantized(tf, {2, 3, 2}, y),
+      2,
+      exec_aten::nullopt,
+      kUnitMultiplier,
+      kUnitShift,
+      10,
+      /*transposed=*/false,
+      out);
+  EXPECT_TENSOR_EQ(out, make_quantized(tf, {2, 2, 2}, expected));
+}
+
+TEST_F(HiFiOperatorTest, QuantizedMatmulInt8) {
+  TensorFactory<ScalarType::Char> tf;
+  Tensor out = tf.zeros({2, 2});
+  impl::HiFi::native::quantized_matmul_out(
+      context_,
+      make_quantized(tf, {2, 3}, kMatmulX),
+      1,
+      make_quantized(tf, {3, 2}, kMatmulY),
+      2,
+      exec_aten::nullopt,
+      kUnitMultiplier,
+      kUnitShift,
+      -10,
+      /*transposed=*/false,
+      out);
+  EXPECT_TENSOR_EQ(
+      out, make_quantized(tf, {2, 2}, plus(kMatmulProduct, -10)));
+}
+
+namespace {
+
+// A direct NCHW uint8 convolution with stride and dilation 1, requantized by
+// 2^(shift - 1) per output channel as kUnitMultiplier does, to check the HiFi
+// kernel against. shift must be at least 1.
+std::vector<int32_t> reference_conv(
+    const std::vector<int32_t>& in,
+    int32_t c,
+    int32_t h,
+    int32_t w,
+    int32_t in_zero_point,
+    const std::vector<int32_t>& weight,
+    int32_t oc,
+    int32_t wh,
+    int32_t ww,
+    int32_t weight_zero_point,
+    const std::vector<int32_t>& bias,
+    int32_t groups,
+    int32_t pad,
+    const std::vector<int32_t>& shift,
+    int32_t out_zero_point) {
+  const int32_t oh = h + 2 * pad - wh + 1;
+  const int32_t ow = w + 2 * pad - ww + 1;
+  const int32_t icpg = c / groups;
+  const int32_t ocpg = oc / groups;
+  std::vector<int32_t> out;
+  for (int32_t o = 0; o < oc; ++o) {
+    const int32_t g = o / ocpg;
+    for (int32_t y = 0; y < oh; ++y) {
+      for (int32_t x = 0; x < ow; ++x) {
+        int32_t acc = bias[o];
+        for (int32_t i = 0; i < icpg; ++i) {
+          for (int32_t ky = 0; ky < wh; ++ky) {
+            for (int32_t kx = 0; kx < ww; ++kx) {
+              const int32_t iy = y - pad + ky;
+              const int32_t ix = x - pad + kx;
+              if (iy < 0 || iy >= h || ix < 0 || ix >= w) {
+                continue;
+              }
+              const int32_t v = in[((g * icpg + i) * h + iy) * w + ix];
+              const int32_t k = weight[((o * icpg + i) * wh + ky) * ww + kx];
+              acc += (v - in_zero_point) * (k - weight_zero_point);
+            }
+          }
+        }
+        const int32_t scaled = acc * (1 << (shift[o] - 1));
+        out.push_back(std::clamp(scaled + out_zero_point, 0, 255));
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST_F(HiFiOperatorTest, QuantizedConvGroupedPerChannel) {
+  TensorFactory<ScalarType::Byte> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Float> tf_float;
+
+  // Two groups of one input and two output channels, with padding.
+  const int32_t c = 2, h = 3, w = 3, oc = 4, wh = 2, ww = 2, pad = 1;
+  std::vector<int32_t> in;
+  for (int32_t i = 0; i < c * h * w; ++i) {
+    in.push_back((i * 7) % 6);
+  }
+  std::vector<int32_t> weight;
+  for (int32_t i = 0; i < oc * wh * ww; ++i) {
+    weight.push_back((i * 5) % 4);
+  }
+  const std::vector<int32_t> bias = {3, -2, 0, 5};
+  const std::vector<int32_t> shift = {1, 2, 1, 2};
+  const std::vector<int32_t> expected = reference_conv(
+      in, c, h, w, 1, weight, oc, wh, ww, 1, bias, 2, pad, shift, 20);
+
+  const int64_t stride[] = {1, 1};
+  const int64_t padding[] = {pad, pad};
+  const int64_t dilation[] = {1, 1};
+  auto conv = [&](RuntimeContext& ctx, Tensor& out) {
+    impl::HiFi::native::quantized_conv_out(
+        ctx,
+        make_quantized(tf, {1, c, h, w}, in),
+        make_quantized(tf, {oc, c / 2, wh, ww}, weight),
+        tf_int.make({oc}, bias),
+        IntArrayRef(stride, 2),
+        IntArrayRef(padding, 2),
+        IntArrayRef(dilation, 2),
+        /*groups=*/2,
+        /*in_zero_point=*/1,
+        tf_int.make({1}, {1}),
+        tf_float.ones({oc}),
+        /*output_scale=*/1.0,
+        /*output_zero_point=*/20,
+        tf_int.full({oc}, kUnitMultiplier),
+        tf_int.make({oc}, shift),
+        /*channel_last=*/false,
+        out);
+  };
+
+  // All output positions are gathered into temp memory at once.
+  Tensor out = tf.zeros({1, oc, 4, 4});
+  conv(temp_context(), out);
+  EXPECT_TENSOR_EQ(
+      out, make_quantized(tf, {1, oc, 4, 4}, expected));
+
+  // Without temp memory they are gathered on the stack.
+  out = tf.zeros({1, oc, 4, 4});
+  conv(context_, out);
+  EXPECT_TENSOR_EQ(
+      out, make_quantized(tf, {1, oc, 4, 4}, expected));
+}
+
+TEST_F(HiFiOperatorTest, QuantizedConv1d) {
+  TensorFactory<ScalarType::Byte> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Float> tf_float;
+
+  const int32_t c = 3, w = 6, oc = 2, ww = 3;
+  std::vector<int32_t> in;
+  for (int32_t i = 0; i < c * w; ++i) {
+    in.push_back(i % 5);
+  }
+  std::vector<int32_t> weight;
+  for (int32_t i = 0; i < oc * c * ww; ++i) {
+    weight.push_back((i * 3) % 4);
+  }
+  const std::vector<int32_t> bias = {1, -1};
+  const std::vector<int32_t> expected = reference_conv(
+      in, c, 1, w, 2, weight, oc, 1, ww, 1, bias, 1, 0, {1, 1}, 30);
+
+  const int64_t stride[] = {1};
+  const int64_t padding[] = {0};
+  const int64_t dilation[] = {1};
+  Tensor out = tf.zeros({1, oc, w - ww + 1});
+  impl::HiFi::native::quantized_conv_out(
+      temp_context(),
+      make_quantized(tf, {1, c, w}, in),
+      make_quantized(tf, {oc, c, ww}, weight),
+      tf_int.make({oc}, bias),
+      IntArrayRef(stride, 1),
+      IntArrayRef(padding, 1),
+      IntArrayRef(dilation, 1),
+      /*groups=*/1,
+      /*in_zero_point=*/2,
+      tf_int.make({1}, {1}),
+      tf_float.ones({1}),
+      /*output_scale=*/1.0,
+      /*output_zero_point=*/30,
+      tf_int.make({1}, {kUnitMultiplier}),
+      tf_int.make({1}, {kUnitShift}),
+      /*channel_last=*/false,
+      out);
+  EXPECT_TENSOR_EQ(
+      out, make_quantized(tf, {1, oc, w - ww + 1}, expected));
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using exec_aten::IntArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using impl::HiFi::kernels::for_each_local_row_tile;
+using impl::HiFi::kernels::kLocalTileBytes;
+using torch::executor::KernelRuntimeContext;
+using torch::executor::MemoryAllocator;
+using torch::executor::RuntimeContext;
+using torch::executor::testing::TensorFactory;
+
+// The HiFi kernels under test. There is no header for them: the generated
+// operator library declares them.
+namespace impl {
+namespace HiFi {
+namespace native {
+void quantized_linear_out(
+    RuntimeContext& ctx,
+    const Tensor& src,
+    const Tensor& weight,
+    const Tensor& bias,
+    int64_t src_zero_point,
+    const Tensor& weight_zero_point,
+    const Tensor& out_multiplier,
+    const Tensor& out_shift,
+    int64_t out_zero_point,
+    const exec_aten::optional<Tensor>& offset,
+    Tensor& out);
+void quantized_conv_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    int64_t in_zero_point,
+    const Tensor& weight_zero_point,
+    const Tensor& bias_scale,
+    double output_scale,
+    int64_t output_zero_point,
+    const Tensor& out_multiplier,
+    const Tensor& out_shift,
+    bool channel_last,
+    Tensor& out);
+} // namespace native
+} // namespace HiFi
+} // namespace impl
+
+namespace {
+
+// An out_multiplier and out_shift pair that requantizes by a scale of 1, so
+// that the expected outputs are exact.
+constexpr int32_t kUnitMultiplier = 1 << 30;
+constexpr int32_t kUnitShift = 1;
+
+// Rows this long fit two to a tile with some room left over, so that tiles
+// don't line up with row boundaries.
+constexpr int32_t kTwoRowsPerTile = kLocalTileBytes / 2 - 1;
+
+class HiFiWeightTilingTest : public OperatorTest {};
+
+} // namespace
+
+TEST(ForEachLocalRowTileTest, CoversRowsThatDontFillTheLastTile) {
+  const int32_t rows = 7;
+  std::vector<uint8_t> src(rows * kTwoRowsPerTile);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i * 13);
+  }
+
+  std::vector<std::pair<int32_t, int32_t>> tiles;
+  const bool tiled = for_each_local_row_tile(
+      src.data(),
+      rows,
+      kTwoRowsPerTile,
+      [&](const uint8_t* tile, int32_t row, int32_t count) {
+        tiles.emplace_back(row, count);
+        // The tile holds exactly the rows it was given.
+        EXPECT_EQ(
+            std::memcmp(
+                tile, src.data() + row * kTwoRowsPerTile,
+                count * kTwoRowsPerTile),
+            0);
+      });
+
+  EXPECT_TRUE(tiled);
+  EXPECT_EQ(
+      tiles,
+      (std::vector<std::pair<int32_t, int32_t>>{{0, 2}, {2, 2}, {4, 2}, {6, 1}}));
+}
+
+TEST(ForEachLocalRowTileTest, DoesNotTileRowsLargerThanATile) {
+  const int32_t row_bytes = kLocalTileBytes + 1;
+  std::vector<uint8_t> src(2 * row_bytes);
+  int32_t calls = 0;
+  EXPECT_FALSE(for_each_local_row_tile(
+      src.data(), 2, row_bytes, [&](const uint8_t*, int32_t, int32_t) {
+        ++calls;
+      }));
+  EXPECT_EQ(calls, 0);
+}
+
+namespace {
+
+constexpr int32_t kSrcZeroPoint = 3;
+constexpr int32_t kWeightZeroPoint = 4;
+constexpr int32_t kOutZeroPoint = 50;
+
+// Checks quantized::linear of two input rows against an [out_dim x in_dim]
+// weight that is at its zero point except for weight[r][r] = 1 and
+// weight[r][in_dim - 1 - r] = 2, above it, so that every output reads both
+// ends of its own weight row.
+void check_linear(int32_t in_dim, int32_t out_dim) {
+  TensorFactory<ScalarType::Byte> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+  const int32_t leading_dims = 2;
+
+  std::vector<uint8_t> src(leading_dims * in_dim);
+  for (int32_t v = 0; v < leading_dims; ++v) {
+    for (int32_t k = 0; k < in_dim; ++k) {
+      src[v * in_dim + k] = kSrcZeroPoint + (k + 3 * v) % 7 - 3;
+    }
+  }
+  std::vector<uint8_t> weight(out_dim * in_dim, kWeightZeroPoint);
+  std::vector<int32_t> bias;
+  for (int32_t r = 0; r < out_dim; ++r) {
+    weight[r * in_dim + r] += 1;
+    weight[r * in_dim + in_dim - 1 - r] += 2;
+    bias.push_back(r - 2);
+  }
+
+  std::vector<uint8_t> expected;
+  for (int32_t v = 0; v < leading_dims; ++v) {
+    for (int32_t r = 0; r < out_dim; ++r) {
+      const uint8_t* x = src.data() + v * in_dim;
+      expected.push_back(
+          (x[r] - kSrcZeroPoint) + 2 * (x[in_dim - 1 - r] - kSrcZeroPoint) +
+          bias[r] + kOutZeroPoint);
+    }
+  }
+
+  Tensor out = tf.zeros({leading_dims, out_dim});
+  RuntimeContext context;
+  impl::HiFi::native::quantized_linear_out(
+      context,
+      tf.make({leading_dims, in_dim}, src),
+      tf.make({out_dim, in_dim}, weight),
+      tf_int.make({out_dim}, bias),
+      kSrcZeroPoint,
+      tf_int.make({1}, {kWeightZeroPoint}),
+      tf_int.make({1}, {kUnitMultiplier}),
+      tf_int.make({1}, {kUnitShift}),
+      kOutZeroPoint,
+      exec_aten::nullopt,
+      out);
+  EXPECT_EQ(context.failure_state(), torch::executor::Error::Ok);
+  EXPECT_TENSOR_EQ(out, tf.make({leading_dims, out_dim}, expected));
+}
+
+} // namespace
+
+TEST_F(HiFiWeightTilingTest, QuantizedLinearWithUnevenTiles) {
+  // Tiles of 2, 2 and 1 weight rows.
+  check_linear(kTwoRowsPerTile, 5);
+}
+
+TEST_F(HiFiWeightTilingTest, QuantizedLinearWithRowsLargerThanATile) {
+  // The weight is read in place.
+  check_linear(kLocalTileBytes + 16, 3);
+}
+
+TEST_F(HiFiWeightTilingTest, QuantizedConvWithUnevenTiles) {
+  TensorFactory<ScalarType::Byte> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Float> tf_float;
+
+  // A 1D conv whose [oc x c * 3] weight fits two output channels to a tile,
+  // so that its 5 output channels take tiles of 2, 2 and 1.
+  const int32_t c = kLocalTileBytes / 8, w = 4, oc = 5, ww = 3;
+  const int32_t kernel_size = c * ww;
+  ASSERT_EQ(kLocalTileBytes / kernel_size, size_t{2});
+
+  std::vector<uint8_t> in(c * w);
+  for (int32_t i = 0; i < c; ++i) {
+    for (int32_t p = 0; p < w; ++p) {
+      in[i * w + p] = kSrcZeroPoint + (i + p) % 5 - 2;
+    }
+  }
+  // Output channel o takes twice the center tap of input channel o, and the
+  // left tap of input channel c - 1 - o.
+  std::vector<uint8_t> weight(oc * kernel_size, kWeightZeroPoint);
+  std::vector<int32_t> bias;
+  for (int32_t o = 0; o < oc; ++o) {
+    weight[o * kernel_size + o * ww + 1] += 2;
+    weight[o * kernel_size + (c - 1 - o) * ww] += 1;
+    bias.push_back(2 * o - 3);
+  }
+
+  std::vector<uint8_t> expected;
+  for (int32_t o = 0; o < oc; ++o) {
+    for (int32_t p = 0; p < w; ++p) {
+      int32_t acc = 2 * (in[o * w + p] - kSrcZeroPoint) + bias[o];
+      if (p > 0) {
+        acc += in[(c - 1 - o) * w + p - 1] - kSrcZeroPoint;
+      }
+      expected.push_back(acc + kOutZeroPoint);
+    }
+  }
+
+  // The receptive fields are gathered into temp memory.
+  std::vector<uint8_t> temp_buffer(kernel_size * w);
+  MemoryAllocator temp_allocator(
+      static_cast<uint32_t>(temp_buffer.size()), temp_buffer.data());
+  KernelRuntimeContext context(nullptr, &temp_allocator);
+
+  const int64_t stride[] = {1};
+  const int64_t padding[] = {1};
+  const int64_t dilation[] = {1};
+  Tensor out = tf.zeros({1, oc, w});
+  impl::HiFi::native::quantized_conv_out(
+      context,
+      tf.make({1, c, w}, in),
+      tf.make({oc, c, ww}, weight),
+      tf_int.make({oc}, bias),
+      IntArrayRef(stride, 1),
+      IntArrayRef(padding, 1),
+      IntArrayRef(dilation, 1),
+      /*groups=*/1,
+      kSrcZeroPoint,
+      tf_int.make({1}, {kWeightZeroPoint}),
+      tf_float.ones({1}),
+      /*output_scale=*/1.0,
+      kOutZeroPoint,
+      tf_int.make({1}, {kUnitMultiplier}),
+      tf_int.make({1}, {kUnitShift}),
+      /*channel_last=*/false,
+      out);
+  EXPECT_EQ(context.failure_state(), torch::executor::Error::Ok);
+  EXPECT_TENSOR_EQ(out, tf.make({1, oc, w}, expected));
+}
@@ -94,8 +94,14 @@ Error NeuronExecuTorchDelegate::execute(
     return Error::InvalidState;
   };
 
+  // Planned memory and I/O buffers are allocated from the process-wide Neuron
+  // allocator, so look tensors up there even when the method was loaded
+  // without it as the temp allocator.
   auto allocator =
       dynamic_cast<neuron::BufferAllocator*>(context.get_temp_allocator());
+  if (allocator == nullptr) {
+    allocator = &GET_NEURON_ALLOCATOR;
+  }
   size_t inputCount = mInputSizes.size(), outputCount = mOutputSizes.size();
 
   for (int i = 0; i < inputCount; i++) {
@@ -104,7 +110,7 @@ Error NeuronExecuTorchDelegate::execute(
     if (IsCached</*isInput=*/true>(i, data_ptr)) {
       continue;
     };
-    auto unit = allocator != nullptr ? allocator->Find(data_ptr) : nullptr;
+    auto unit = allocator->FindContaining(data_ptr);
     if (unit) {
       UpdateCache<true>(i, data_ptr);
       size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
@@ -122,7 +128,7 @@ Error NeuronExecuTorchDelegate::execute(
     if (IsCached</*isInput=*/false>(output_index, data_ptr)) {
       continue;
     };
-    auto unit = allocator != nullptr ? allocator->Find(data_ptr) : nullptr;
+    auto unit = allocator->FindContaining(data_ptr);
     if (unit) {
       UpdateCache</*isInput=*/false>(output_index, data_ptr);
       size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
@@ -147,10 +153,11 @@ int NeuronExecuTorchDelegate::HintNeuronBackend(EValue** args) const {
       if (mHasImported.count(data_ptr)) {
         continue;
       }
-      auto unit = allocator.Find(data_ptr);
+      auto unit = allocator.FindContaining(data_ptr);
       if (unit) {
+        size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
         mExecutor.SetInputOutputFromMemory</*isInput*/ true>(
-            i, unit->GetNeuronMemory(), 0, unit->GetSize());
+            i, unit->GetNeuronMemory(), offset, args[i]->toTensor().nbytes());
         mHasImported.insert(data_ptr);
       }
     }
@@ -160,10 +167,14 @@ int NeuronExecuTorchDelegate::HintNeuronBackend(EValue** args) const {
         continue;
       }
       auto output_index = o - inputCount;
-      auto unit = allocator.Find(data_ptr);
+      auto unit = allocator.FindContaining(data_ptr);
       if (unit) {
+        size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
         mExecutor.SetInputOutputFromMemory</*isInput*/ false>(
-            output_index, unit->GetNeuronMemory(), 0, unit->GetSize());
+            output_index,
+            unit->GetNeuronMemory(),
+            offset,
+            args[o]->toTensor().nbytes());
         mHasImported.insert(data_ptr);
       }
     }
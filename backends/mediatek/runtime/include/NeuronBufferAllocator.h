@@ -116,6 +116,22 @@ class BufferAllocator : public MemoryAllocator {
 
   const MemoryUnit* Find(void* address);
 
+  // Returns the unit whose range contains the address, so that tensors placed
+  // inside a larger buffer (e.g. a memory-planned arena) can still be bound by
+  // handle at their offset.
+  const MemoryUnit* FindContaining(const void* address) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mPool.upper_bound(const_cast<void*>(address));
+    if (it == mPool.begin()) {
+      return nullptr;
+    }
+    const MemoryUnit* unit = (--it)->second.get();
+    const char* begin = static_cast<const char*>(unit->GetAddress());
+    const char* target = static_cast<const char*>(address);
+    return (target >= begin && target < begin + unit->GetSize()) ? unit
+                                                                  : nullptr;
+  }
+
   void Clear();
 
  private:
@@ -52,6 +52,9 @@ struct CustomMemTensorInfo {
 /// alignment as MemoryAllocator::kDefaultAlignment.
 /// See runtime/core/memory_allocator.h. The function returns a valid pointer
 /// if allocation is successful.
+/// Memory planned buffers could be allocated here as well. With shared_buffer
+/// enabled, delegate inputs and outputs placed inside them by memory planning
+/// are then registered automatically, without adding them beforehand.
 void* QnnExecuTorchAllocCustomMem(size_t bytes, size_t alignment);
 
 /// Add tensor to custom memory with custom type descriptor. Create memory
@@ -65,6 +68,14 @@ void QnnExecuTorchAddCustomMemTensorInfo(const CustomMemTensorInfo& info);
 /// Free the allocated shared memory.
 void QnnExecuTorchFreeCustomMem(void* buffer_ptr);
 
+/// Switch the HTP performance vote of all loaded QNN delegates, e.g. to raise
+/// it while generating and to drop it when idle, without reloading the model.
+/// performance_mode takes the values of QnnExecuTorchHtpPerformanceMode in
+/// schema.fbs, where kHtpDefault (0) releases the vote. With dcvs_enable, DCVS
+/// may scale the clocks within the voltage corners of the performance mode.
+/// Returns false if the vote failed for any of the delegates.
+bool QnnExecuTorchSetHtpPerformanceMode(int performance_mode, bool dcvs_enable);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
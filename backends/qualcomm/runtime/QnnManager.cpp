@@ -11,9 +11,13 @@
 #include <executorch/backends/qualcomm/runtime/backends/QnnImplementation.h>
 #include <algorithm>
 #include <cstdlib>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <string>
+#include <string_view>
 
 namespace torch {
 namespace executor {
@@ -30,9 +34,15 @@ bool CompareExportedInput(
 }
 
 QnnManager::~QnnManager() {
+  // the library of a shared backend is unloaded by its last user
+  const bool owns_library = logger_ != nullptr;
   backend_params_ptr_.reset(new BackendConfigParameters());
+  shared_context_.reset();
+  shared_backend_.reset();
   logger_.reset();
-  qnn_loaded_backend_.TerminateAllBackends();
+  if (owns_library) {
+    qnn_loaded_backend_.TerminateAllBackends();
+  }
 }
 
 QnnManager::QnnManager(
@@ -71,6 +81,13 @@ QnnManager::QnnManager(
         "Is on-device graph construction: %d", options->online_prepare());
     QNN_EXECUTORCH_LOG_INFO(
         "Enable shared buffer: %d", options->shared_buffer());
+    QNN_EXECUTORCH_LOG_INFO(
+        "Enable shared context: %d", options->shared_context());
+    if (options->online_prepare_cache_dir() != nullptr) {
+      QNN_EXECUTORCH_LOG_INFO(
+          "online_prepare_cache_dir: %s",
+          options->online_prepare_cache_dir()->c_str());
+    }
   }
 
   if (library_path.empty()) {
@@ -89,6 +106,7 @@ QnnManager::QnnManager(
         break;
     }
   }
+  library_path_ = library_path;
   qnn_loaded_backend_ = QnnImplementation(library_path);
   backend_params_ptr_ = std::make_unique<BackendConfigParameters>();
 }
@@ -244,7 +262,7 @@ Error QnnManager::RegisterCustomMem(
   size_t tensor_offset = static_cast<char*>(custom_mem_base) -
       static_cast<char*>(unaligned_custom_mem_base) + info.pos;
   size_t total_custom_mem_size =
-      shared_buffer_manager.GetAllocatedSize(custom_mem_base);
+      shared_buffer_manager.GetAllocatedSize(unaligned_custom_mem_base);
 
   int32_t mem_fd = shared_buffer_manager.MemToFd(unaligned_custom_mem_base);
   if (mem_fd == -1) {
@@ -269,34 +287,38 @@ Error QnnManager::RegisterCustomMem(
 }
 
 Error QnnManager::Init() {
-  ET_CHECK_OR_RETURN_ERROR(
-      LoadQnnLibrary() == Error::Ok, Internal, "Fail to load Qnn library");
-  logger_ = std::make_unique<QnnLogger>(
-      qnn_loaded_backend_, LoggingCallback, options_->log_level());
   if (backend_params_ptr_->backend_init_state_ ==
       BackendInitializeState::UNINITIALIZED) {
     QNN_EXECUTORCH_LOG_INFO(
         "Initialize Qnn backend "
         "parameters for Qnn executorch backend type %d",
         options_->backend_options()->backend_type());
-    backend_params_ptr_ = QnnBackendFactory().Create(
-        qnn_loaded_backend_, logger_.get(), qnn_context_blob_, options_);
-    ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_backend_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn backend");
-    ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_device_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn device");
+    LoadContextCache();
+    Error status = Error::Ok;
+    if (!context_cache_.empty()) {
+      QnnExecuTorchContextBinary context_cache;
+      context_cache.buffer = context_cache_.data();
+      context_cache.nbytes = context_cache_.size();
+      status = InitContext(context_cache);
+      if (status != Error::Ok) {
+        // e.g. the cache was created with another version of the QNN SDK
+        QNN_EXECUTORCH_LOG_WARN(
+            "Fail to restore context cache %s, "
+            "the graph will be composed on device.",
+            context_cache_path_.c_str());
+        std::remove(context_cache_path_.c_str());
+        context_cache_.clear();
+        shared_context_.reset();
+        backend_params_ptr_->qnn_context_ptr_.reset();
+      }
+    }
+    if (context_cache_.empty()) {
+      status = InitContext(qnn_context_blob_);
+    }
     ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_context_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn context");
+        status == Error::Ok, Internal, "Fail to configure Qnn context");
     ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_graph_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn graph");
+        InitGraph() == Error::Ok, Internal, "Fail to configure Qnn graph");
     backend_params_ptr_->backend_init_state_ =
         BackendInitializeState::INITIALIZED;
   }
@@ -310,11 +332,183 @@ Error QnnManager::Init() {
   return Error::Ok;
 }
 
+Error QnnManager::InitContext(
+    const QnnExecuTorchContextBinary& qnn_context_blob) {
+  if (UseSharedContext()) {
+    QnnBackendPool& backend_pool = QnnBackendPool::GetBackendPool();
+    ET_CHECK_OR_RETURN_ERROR(
+        backend_pool.GetBackend(library_path_, options_, shared_backend_) ==
+            Error::Ok,
+        Internal,
+        "Fail to get shared Qnn backend");
+    ET_CHECK_OR_RETURN_ERROR(
+        backend_pool.GetContext(
+            shared_backend_,
+            qnn_context_blob,
+            IsOnlinePrepare(),
+            options_,
+            shared_context_) == Error::Ok,
+        Internal,
+        "Fail to get shared Qnn context");
+    backend_params_ptr_->qnn_backend_ptr_ = shared_backend_->backend_;
+    backend_params_ptr_->qnn_device_ptr_ = shared_backend_->device_;
+    backend_params_ptr_->qnn_context_ptr_ = shared_context_->context_;
+    return Error::Ok;
+  }
+
+  QnnBackendFactory factory;
+  if (backend_params_ptr_->qnn_backend_ptr_ == nullptr) {
+    ET_CHECK_OR_RETURN_ERROR(
+        LoadQnnLibrary() == Error::Ok, Internal, "Fail to load Qnn library");
+    logger_ = std::make_unique<QnnLogger>(
+        qnn_loaded_backend_, LoggingCallback, options_->log_level());
+    backend_params_ptr_->qnn_backend_ptr_ =
+        factory.CreateBackend(qnn_loaded_backend_, logger_.get(), options_);
+    backend_params_ptr_->qnn_device_ptr_ =
+        factory.CreateDevice(qnn_loaded_backend_, logger_.get(), options_);
+    ET_CHECK_OR_RETURN_ERROR(
+        backend_params_ptr_->qnn_backend_ptr_ != nullptr &&
+            backend_params_ptr_->qnn_device_ptr_ != nullptr,
+        Internal,
+        "Backend %s is not supported",
+        EnumNameQnnExecuTorchBackendType(
+            options_->backend_options()->backend_type()));
+    ET_CHECK_OR_RETURN_ERROR(
+        backend_params_ptr_->qnn_backend_ptr_->Configure() == Error::Ok,
+        Internal,
+        "Fail to configure Qnn backend");
+    ET_CHECK_OR_RETURN_ERROR(
+        backend_params_ptr_->qnn_device_ptr_->Configure() == Error::Ok,
+        Internal,
+        "Fail to configure Qnn device");
+  }
+
+  backend_params_ptr_->qnn_context_ptr_ = factory.CreateContext(
+      qnn_loaded_backend_,
+      backend_params_ptr_->qnn_backend_ptr_.get(),
+      backend_params_ptr_->qnn_device_ptr_.get(),
+      qnn_context_blob,
+      options_);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend_params_ptr_->qnn_context_ptr_->Configure() == Error::Ok,
+      Internal,
+      "Fail to configure Qnn context");
+  return Error::Ok;
+}
+
+Error QnnManager::InitGraph() {
+  QnnContext* context = backend_params_ptr_->qnn_context_ptr_.get();
+  std::string graph_name = options_->graph_name()->str();
+  if (context->GetCacheState() == QnnBackendCache::DESERIALIZE) {
+    // a context binary holding several graphs is looked up by graph name
+    const std::vector<std::string>& graph_names = context->GetGraphNames();
+    if (graph_names.size() == 1) {
+      graph_name = graph_names[0];
+    } else {
+      ET_CHECK_OR_RETURN_ERROR(
+          std::find(graph_names.begin(), graph_names.end(), graph_name) !=
+              graph_names.end(),
+          Internal,
+          "Graph %s is not found among the %zu graphs of the context binary",
+          graph_name.c_str(),
+          graph_names.size());
+    }
+  } else if (shared_context_ != nullptr) {
+    graph_name = QnnBackendPool::GetBackendPool().ReserveGraphName(
+        *shared_context_, graph_name);
+  }
+
+  backend_params_ptr_->qnn_graph_ptr_ = QnnBackendFactory().CreateGraph(
+      GetImplementation(),
+      backend_params_ptr_->qnn_backend_ptr_.get(),
+      context,
+      graph_name,
+      options_);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend_params_ptr_->qnn_graph_ptr_->Configure() == Error::Ok,
+      Internal,
+      "Fail to configure Qnn graph");
+  backend_params_ptr_->qnn_mem_manager_ptr_ =
+      std::make_unique<QnnMemManager>(GetImplementation(), context);
+  return Error::Ok;
+}
+
+void QnnManager::LoadContextCache() {
+  if (!options_->online_prepare() || qnn_context_blob_.buffer == nullptr ||
+      options_->online_prepare_cache_dir() == nullptr ||
+      options_->online_prepare_cache_dir()->size() == 0) {
+    return;
+  }
+  if (UseSharedContext()) {
+    // a cache of the shared context would hold the graphs of every delegate
+    QNN_EXECUTORCH_LOG_WARN(
+        "Context cache is not supported for shared contexts composed on "
+        "device, it is disabled.");
+    return;
+  }
+
+  // the cache is keyed by the graph it was composed from
+  const std::string_view blob(
+      static_cast<const char*>(qnn_context_blob_.buffer),
+      qnn_context_blob_.nbytes);
+  context_cache_path_ = options_->online_prepare_cache_dir()->str() + "/" +
+      options_->graph_name()->str() + "_" +
+      std::to_string(qnn_context_blob_.nbytes) + "_" +
+      std::to_string(std::hash<std::string_view>{}(blob)) + ".bin";
+
+  std::ifstream file(context_cache_path_, std::ios::binary);
+  if (file.fail()) {
+    return;
+  }
+  context_cache_.assign(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (file.bad()) {
+    context_cache_.clear();
+    return;
+  }
+  QNN_EXECUTORCH_LOG_INFO(
+      "Restore context cache %s", context_cache_path_.c_str());
+}
+
+void QnnManager::SaveContextCache() {
+  QnnExecuTorchContextBinary context_binary;
+  if (backend_params_ptr_->qnn_context_ptr_->GetContextBinary(
+          context_binary) != Error::Ok) {
+    QNN_EXECUTORCH_LOG_WARN(
+        "Fail to get context binary, context cache %s is not saved.",
+        context_cache_path_.c_str());
+    return;
+  }
+
+  CreateDirectory(context_cache_path_);
+  // Write to a temporary file and rename it, so that readers never see a
+  // partially written cache
+  const std::string tmp_path = context_cache_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(
+        static_cast<const char*>(context_binary.buffer), context_binary.nbytes);
+    if (file.fail()) {
+      QNN_EXECUTORCH_LOG_WARN(
+          "Fail to write context cache %s.", tmp_path.c_str());
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), context_cache_path_.c_str()) != 0) {
+    QNN_EXECUTORCH_LOG_WARN(
+        "Fail to save context cache %s.", context_cache_path_.c_str());
+    std::remove(tmp_path.c_str());
+  }
+}
+
 Error QnnManager::AllocateTensor() {
+  const std::string& graph_name =
+      backend_params_ptr_->qnn_graph_ptr_->GetGraphName();
   std::vector<Qnn_Tensor_t> input_tensors =
-      backend_params_ptr_->qnn_context_ptr_->GetGraphInputs();
+      backend_params_ptr_->qnn_context_ptr_->GetGraphInputs(graph_name);
   std::vector<Qnn_Tensor_t> output_tensors =
-      backend_params_ptr_->qnn_context_ptr_->GetGraphOutputs();
+      backend_params_ptr_->qnn_context_ptr_->GetGraphOutputs(graph_name);
 
   for (auto& tensor : input_tensors) {
     std::shared_ptr<TensorWrapper> tensor_wrapper = CreateTensorWrapper(tensor);
@@ -420,10 +614,15 @@ Error QnnManager::ProfileExecuteData(EventTracer* event_tracer) {
 
 void QnnManager::Destroy() {
   QNN_EXECUTORCH_LOG_INFO("Destroy Qnn backend parameters");
+  const bool owns_library = logger_ != nullptr;
   backend_params_ptr_.reset(new BackendConfigParameters());
+  shared_context_.reset();
+  shared_backend_.reset();
   logger_.reset();
 
-  qnn_loaded_backend_.TerminateAllBackends();
+  if (owns_library) {
+    qnn_loaded_backend_.TerminateAllBackends();
+  }
 }
 
 bool QnnManager::IsNodeSupportedByBackend(
@@ -514,13 +713,16 @@ Error QnnManager::Compile(
     return Error::Internal;
   }
 
-  // no need to generate extra context binary in online prepare scenario
+  // no need to generate extra context binary in online prepare scenario,
+  // unless it is cached for the next run
   if (!IsOnlinePrepare()) {
     ET_CHECK_OR_RETURN_ERROR(
         backend_params_ptr_->qnn_context_ptr_->GetContextBinary(
             qnn_executorch_context_binary) == Error::Ok,
         Internal,
         "Fail to get context binary.");
+  } else if (!context_cache_path_.empty()) {
+    SaveContextCache();
   }
 
   return Error::Ok;
@@ -549,3 +751,19 @@ void QnnExecuTorchAddCustomMemTensorInfo(const CustomMemTensorInfo& info) {
   torch::executor::qnn::SharedBuffer::GetSharedBufferManager()
       .AddCusomMemTensorInfo(info);
 }
+
+bool QnnExecuTorchSetHtpPerformanceMode(
+    int performance_mode,
+    bool dcvs_enable) {
+  using qnn_delegate::QnnExecuTorchHtpPerformanceMode;
+  if (performance_mode <
+          static_cast<int>(QnnExecuTorchHtpPerformanceMode::MIN) ||
+      performance_mode >
+          static_cast<int>(QnnExecuTorchHtpPerformanceMode::MAX)) {
+    ET_LOG(Error, "Invalid HTP performance mode %d", performance_mode);
+    return false;
+  }
+  return torch::executor::qnn::HtpDevice::SetPerformanceModeOfAllDevices(
+             static_cast<QnnExecuTorchHtpPerformanceMode>(performance_mode),
+             dcvs_enable) == torch::executor::Error::Ok;
+}
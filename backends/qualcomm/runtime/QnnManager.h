@@ -12,11 +12,14 @@
 #include <executorch/backends/qualcomm/runtime/Logging.h>
 #include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
 #include <executorch/backends/qualcomm/runtime/backends/QnnBackendFactory.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnBackendPool.h>
 #include <executorch/backends/qualcomm/schema_generated.h>
 #include <executorch/runtime/core/error.h>
 
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace torch {
 namespace executor {
@@ -47,8 +50,9 @@ class QnnManager {
     return true;
   }
 
+  // False if the context composed on device was restored from the cache
   bool IsOnlinePrepare() {
-    return options_->online_prepare();
+    return options_->online_prepare() && context_cache_.empty();
   }
 
   bool IsTensorDump() {
@@ -78,6 +82,21 @@ class QnnManager {
 
  private:
   Error LoadQnnLibrary();
+  // Context binaries given at compile time are never shared
+  bool UseSharedContext() {
+    return options_->shared_context() && qnn_context_blob_.buffer != nullptr;
+  }
+  Error InitContext(const QnnExecuTorchContextBinary& qnn_context_blob);
+  Error InitGraph();
+
+  // Restores the context composed on device by an earlier run, if any
+  void LoadContextCache();
+  void SaveContextCache();
+
+  const QnnImplementation& GetImplementation() const {
+    return shared_backend_ != nullptr ? shared_backend_->implementation_
+                                      : qnn_loaded_backend_;
+  }
 
   static constexpr const char* htp_library_name_ = "libQnnHtp.so";
   static constexpr const char* gpu_library_name_ = "libQnnGpu.so";
@@ -85,8 +104,14 @@ class QnnManager {
 
   QnnExecuTorchContextBinary qnn_context_blob_;
   std::unique_ptr<BackendConfigParameters> backend_params_ptr_;
+  std::string library_path_;
   QnnImplementation qnn_loaded_backend_;
   std::unique_ptr<QnnLogger> logger_;
+  // set if the backend and context are shared with other delegates
+  std::shared_ptr<SharedBackend> shared_backend_;
+  std::shared_ptr<SharedContext> shared_context_;
+  std::string context_cache_path_;
+  std::vector<char> context_cache_;
   const QnnExecuTorchOptions* options_;
   std::vector<std::shared_ptr<TensorWrapper>> input_tensors_;
   std::vector<std::shared_ptr<TensorWrapper>> output_tensors_;
@@ -61,10 +61,24 @@ std::mutex SharedBuffer::init_mutex_;
 
 void* SharedBuffer::GetCustomMemBase(void* buf) {
   auto it = tensor_addr_to_custom_mem_.find(buf);
-  if (it == tensor_addr_to_custom_mem_.end()) {
+  if (it != tensor_addr_to_custom_mem_.end()) {
+    return it->second;
+  }
+  if (restore_map_.count(buf) != 0) {
     return nullptr;
   }
-  return it->second;
+
+  // tensors placed inside an allocation don't need to be added beforehand
+  auto alloc_it = aligned_allocations_.upper_bound(buf);
+  if (alloc_it == aligned_allocations_.begin()) {
+    return nullptr;
+  }
+  --alloc_it;
+  if (static_cast<char*>(buf) >=
+      static_cast<char*>(alloc_it->first) + alloc_it->second) {
+    return nullptr;
+  }
+  return alloc_it->first;
 }
 
 void* SharedBuffer::GetUnAlignedAddr(void* buf) {
@@ -127,8 +141,11 @@ void* SharedBuffer::AllocMem(size_t bytes, size_t alignment) {
   bool status = restore_map_.insert({aligned_buf, buf}).second;
   if (!status) {
     QNN_EXECUTORCH_LOG_ERROR("Failed to allocate the tensor by RPC memory.");
+    allocated_size_map_.erase(buf);
     rpc_mem_free_(buf);
+    return nullptr;
   }
+  aligned_allocations_.insert({aligned_buf, bytes});
   return aligned_buf;
 }
 
@@ -148,6 +165,8 @@ void SharedBuffer::FreeMem(void* buf) {
   } else if (restore_map_.count(buf) == 0) {
     QNN_EXECUTORCH_LOG_WARN("Don't free an unallocated tensor.");
   } else {
+    allocated_size_map_.erase(restore_map_[buf]);
+    aligned_allocations_.erase(buf);
     rpc_mem_free_(restore_map_[buf]);
     restore_map_.erase(buf);
   }
@@ -11,6 +11,7 @@
 #include <executorch/runtime/core/error.h>
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -64,6 +65,9 @@ class SharedBuffer final {
 
   size_t GetAllocatedSize(void* buf);
 
+  // Returns the custom memory that buf was added to, or else the allocation
+  // buf lies in, e.g. a memory planned buffer allocated by AllocMem. Returns
+  // nullptr for the start of an allocation, which is registered as ion memory.
   void* GetCustomMemBase(void* buf);
 
   void* GetUnAlignedAddr(void* buf);
@@ -91,6 +95,8 @@ class SharedBuffer final {
   RpcMemToFdFn_t rpc_mem_to_fd_;
   std::unordered_map<void*, void*> restore_map_;
   std::unordered_map<void*, size_t> allocated_size_map_;
+  // Maps the aligned address of each allocation to its requested size
+  std::map<void*, size_t> aligned_allocations_;
   // Maps for the custom memory
   std::unordered_map<void*, void*> tensor_addr_to_custom_mem_;
   std::unordered_set<CustomMemTensorInfo> custom_mem_tensor_info_set_;
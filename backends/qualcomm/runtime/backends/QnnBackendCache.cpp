@@ -47,35 +47,34 @@ Error QnnBackendCache::GetQnnGraphInfoFromBinary() {
     return Error::Internal;
   }
 
-  if (num_graphs > 1) {
-    QNN_EXECUTORCH_LOG_WARN(
-        "The context binary contains %lu graphs. But now "
-        "assume that one context binary contains one graph.",
-        num_graphs);
-    return Error::Internal;
-  }
-
-  // only have version_1 now
-  if (graph[0].version != QNN_SYSTEM_CONTEXT_GRAPH_INFO_VERSION_1) {
-    QNN_EXECUTORCH_LOG_WARN(
-        "Unknown QNN GraphInfo version %d.", graph[0].version);
-    return Error::Internal;
-  }
-  // get graph name from metadata
-  graph_name_ = graph->graphInfoV1.graphName;
-
-  // get graph inputs from metadata
-  uint32_t numGraphInputs = graph->graphInfoV1.numGraphInputs;
-  input_tensor_structs_.reserve(numGraphInputs);
-  for (std::uint32_t i = 0; i < numGraphInputs; ++i) {
-    input_tensor_structs_.emplace_back(graph->graphInfoV1.graphInputs[i]);
-  }
+  // a context binary could hold several graphs sharing the same weights,
+  // e.g. the prefill and decode graphs of a LLM
+  for (std::uint32_t i = 0; i < num_graphs; ++i) {
+    // only have version_1 now
+    if (graph[i].version != QNN_SYSTEM_CONTEXT_GRAPH_INFO_VERSION_1) {
+      QNN_EXECUTORCH_LOG_WARN(
+          "Unknown QNN GraphInfo version %d.", graph[i].version);
+      return Error::Internal;
+    }
+    // get graph name from metadata
+    const std::string graph_name = graph[i].graphInfoV1.graphName;
+    graph_names_.push_back(graph_name);
+
+    // get graph inputs from metadata
+    uint32_t numGraphInputs = graph[i].graphInfoV1.numGraphInputs;
+    std::vector<Qnn_Tensor_t>& inputs = input_tensor_structs_[graph_name];
+    inputs.reserve(numGraphInputs);
+    for (std::uint32_t j = 0; j < numGraphInputs; ++j) {
+      inputs.emplace_back(graph[i].graphInfoV1.graphInputs[j]);
+    }
 
-  // get graph outputs from metadata
-  uint32_t numGraphOutputs = graph->graphInfoV1.numGraphOutputs;
-  output_tensor_structs_.reserve(numGraphOutputs);
-  for (std::uint32_t i = 0; i < numGraphOutputs; ++i) {
-    output_tensor_structs_.emplace_back(graph->graphInfoV1.graphOutputs[i]);
+    // get graph outputs from metadata
+    uint32_t numGraphOutputs = graph[i].graphInfoV1.numGraphOutputs;
+    std::vector<Qnn_Tensor_t>& outputs = output_tensor_structs_[graph_name];
+    outputs.reserve(numGraphOutputs);
+    for (std::uint32_t j = 0; j < numGraphOutputs; ++j) {
+      outputs.emplace_back(graph[i].graphInfoV1.graphOutputs[j]);
+    }
   }
 
   return Error::Ok;
@@ -151,18 +150,26 @@ QnnBackendCache::~QnnBackendCache() {
   qnn_sys_impl_.Unload();
 }
 
-std::vector<Qnn_Tensor_t> QnnBackendCache::GetGraphInputs() {
+std::vector<Qnn_Tensor_t> QnnBackendCache::GetGraphInputs(
+    const std::string& graph_name) {
   if (state_ != DESERIALIZE)
     return {};
 
-  return input_tensor_structs_;
+  auto it = input_tensor_structs_.find(graph_name);
+  if (it == input_tensor_structs_.end())
+    return {};
+  return it->second;
 }
 
-std::vector<Qnn_Tensor_t> QnnBackendCache::GetGraphOutputs() {
+std::vector<Qnn_Tensor_t> QnnBackendCache::GetGraphOutputs(
+    const std::string& graph_name) {
   if (state_ != DESERIALIZE)
     return {};
 
-  return output_tensor_structs_;
+  auto it = output_tensor_structs_.find(graph_name);
+  if (it == output_tensor_structs_.end())
+    return {};
+  return it->second;
 }
 } // namespace qnn
 } // namespace executor
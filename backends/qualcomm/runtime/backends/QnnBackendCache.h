@@ -11,6 +11,7 @@
 #include <executorch/backends/qualcomm/runtime/backends/QnnSysImplementation.h>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 namespace torch {
 namespace executor {
@@ -31,9 +32,9 @@ class QnnBackendCache {
   QnnBackendCache& operator=(const QnnBackendCache&) = delete;
   QnnBackendCache& operator=(QnnBackendCache&&) = delete;
 
-  std::vector<Qnn_Tensor_t> GetGraphInputs();
+  std::vector<Qnn_Tensor_t> GetGraphInputs(const std::string& graph_name);
 
-  std::vector<Qnn_Tensor_t> GetGraphOutputs();
+  std::vector<Qnn_Tensor_t> GetGraphOutputs(const std::string& graph_name);
 
   const QnnExecuTorchContextBinary& GetQnnContextBlob() {
     return qnn_context_blob_;
@@ -47,8 +48,9 @@ class QnnBackendCache {
     state_ = INVALID;
   }
 
-  std::string GetGraphName() {
-    return graph_name_;
+  // Names of the graphs in the context binary, in the order they are stored
+  const std::vector<std::string>& GetGraphNames() {
+    return graph_names_;
   }
 
  private:
@@ -59,9 +61,11 @@ class QnnBackendCache {
   QnnExecuTorchContextBinary qnn_context_blob_;
   QnnSystemContext_Handle_t sys_context_handle_{nullptr};
   QnnSystemImplementation qnn_sys_impl_{"libQnnSystem.so"};
-  std::string graph_name_;
-  std::vector<Qnn_Tensor_t> input_tensor_structs_;
-  std::vector<Qnn_Tensor_t> output_tensor_structs_;
+  std::vector<std::string> graph_names_;
+  std::unordered_map<std::string, std::vector<Qnn_Tensor_t>>
+      input_tensor_structs_;
+  std::unordered_map<std::string, std::vector<Qnn_Tensor_t>>
+      output_tensor_structs_;
 };
 } // namespace qnn
 } // namespace executor
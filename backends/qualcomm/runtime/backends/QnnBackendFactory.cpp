@@ -10,12 +10,10 @@
 namespace torch {
 namespace executor {
 namespace qnn {
-std::unique_ptr<BackendConfigParameters> QnnBackendFactory::Create(
+std::unique_ptr<QnnBackend> QnnBackendFactory::CreateBackend(
     const QnnImplementation& implementation,
     QnnLogger* logger,
-    const QnnExecuTorchContextBinary& qnn_context_blob,
     const QnnExecuTorchOptions* options) {
-  auto backend_params = std::make_unique<BackendConfigParameters>();
   switch (options->backend_options()->backend_type()) {
     case QnnExecuTorchBackendType::kHtpBackend: {
       auto htp_options = options->backend_options()->htp_options();
@@ -49,40 +47,82 @@ std::unique_ptr<BackendConfigParameters> QnnBackendFactory::Create(
         QNN_EXECUTORCH_LOG_INFO(
             "use_fold_relu in htp_options: %d", htp_options->use_fold_relu());
       }
-      backend_params->qnn_backend_ptr_ =
-          std::make_unique<HtpBackend>(implementation, logger);
-      backend_params->qnn_device_ptr_ = std::make_unique<HtpDevice>(
-          implementation, logger, options->soc_info(), htp_options);
+      return std::make_unique<HtpBackend>(implementation, logger);
+    } break;
+    case QnnExecuTorchBackendType::kGpuBackend:
+    case QnnExecuTorchBackendType::kDspBackend:
+    case QnnExecuTorchBackendType::kUndefinedBackend:
+    default:
+      return nullptr;
+  }
+
+  // should not reach here
+  return nullptr;
+}
+
+std::unique_ptr<QnnDevice> QnnBackendFactory::CreateDevice(
+    const QnnImplementation& implementation,
+    QnnLogger* logger,
+    const QnnExecuTorchOptions* options) {
+  switch (options->backend_options()->backend_type()) {
+    case QnnExecuTorchBackendType::kHtpBackend:
+      return std::make_unique<HtpDevice>(
+          implementation,
+          logger,
+          options->soc_info(),
+          options->backend_options()->htp_options());
+    case QnnExecuTorchBackendType::kGpuBackend:
+    case QnnExecuTorchBackendType::kDspBackend:
+    case QnnExecuTorchBackendType::kUndefinedBackend:
+    default:
+      return nullptr;
+  }
+}
 
-      backend_params->qnn_context_ptr_ = std::make_unique<HtpContext>(
+std::unique_ptr<QnnContext> QnnBackendFactory::CreateContext(
+    const QnnImplementation& implementation,
+    QnnBackend* backend,
+    QnnDevice* device,
+    const QnnExecuTorchContextBinary& qnn_context_blob,
+    const QnnExecuTorchOptions* options) {
+  switch (options->backend_options()->backend_type()) {
+    case QnnExecuTorchBackendType::kHtpBackend:
+      return std::make_unique<HtpContext>(
           implementation,
-          backend_params->qnn_backend_ptr_.get(),
-          backend_params->qnn_device_ptr_.get(),
+          backend,
+          device,
           qnn_context_blob,
-          htp_options);
+          options->backend_options()->htp_options());
+    case QnnExecuTorchBackendType::kGpuBackend:
+    case QnnExecuTorchBackendType::kDspBackend:
+    case QnnExecuTorchBackendType::kUndefinedBackend:
+    default:
+      return nullptr;
+  }
+}
 
-      backend_params->qnn_graph_ptr_ = std::make_unique<HtpGraph>(
+std::unique_ptr<QnnGraph> QnnBackendFactory::CreateGraph(
+    const QnnImplementation& implementation,
+    QnnBackend* backend,
+    QnnContext* context,
+    const std::string& graph_name,
+    const QnnExecuTorchOptions* options) {
+  switch (options->backend_options()->backend_type()) {
+    case QnnExecuTorchBackendType::kHtpBackend:
+      return std::make_unique<HtpGraph>(
           implementation,
-          backend_params->qnn_backend_ptr_.get(),
-          backend_params->qnn_context_ptr_.get(),
+          backend,
+          context,
           options->profile_level(),
-          options->graph_name()->str(),
+          graph_name,
           options->soc_info(),
-          htp_options);
-      backend_params->qnn_mem_manager_ptr_ = std::make_unique<QnnMemManager>(
-          implementation, backend_params->qnn_context_ptr_.get());
-      backend_params->backend_init_state_ = BackendInitializeState::INITIALIZED;
-      return backend_params;
-    } break;
+          options->backend_options()->htp_options());
     case QnnExecuTorchBackendType::kGpuBackend:
     case QnnExecuTorchBackendType::kDspBackend:
     case QnnExecuTorchBackendType::kUndefinedBackend:
     default:
       return nullptr;
   }
-
-  // should not reach here
-  return nullptr;
 }
 } // namespace qnn
 } // namespace executor
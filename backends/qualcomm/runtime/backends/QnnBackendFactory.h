@@ -28,11 +28,13 @@ namespace qnn {
 typedef enum { UNINITIALIZED, INITIALIZED } BackendInitializeState;
 
 // @brief Struct containing all handles for a given QNN backend
+// The backend, device and context could be shared with other delegates, see
+// QnnBackendPool.
 typedef struct BackendConfigParameters {
-  std::unique_ptr<QnnBackend> qnn_backend_ptr_;
+  std::shared_ptr<QnnBackend> qnn_backend_ptr_;
   BackendInitializeState backend_init_state_;
-  std::unique_ptr<QnnContext> qnn_context_ptr_;
-  std::unique_ptr<QnnDevice> qnn_device_ptr_;
+  std::shared_ptr<QnnContext> qnn_context_ptr_;
+  std::shared_ptr<QnnDevice> qnn_device_ptr_;
   std::unique_ptr<QnnGraph> qnn_graph_ptr_;
   std::unique_ptr<QnnMemManager> qnn_mem_manager_ptr_;
 
@@ -56,13 +58,34 @@ typedef struct BackendConfigParameters {
 
 } BackendConfigParameters;
 
+// The graph is created apart from the other handles, since the graph to
+// retrieve from a context binary is only known once the context is created.
+// All methods return nullptr for unsupported backend types.
 class QnnBackendFactory {
  public:
-  std::unique_ptr<BackendConfigParameters> Create(
+  std::unique_ptr<QnnBackend> CreateBackend(
       const QnnImplementation& implementation,
       QnnLogger* logger,
+      const QnnExecuTorchOptions* options);
+
+  std::unique_ptr<QnnDevice> CreateDevice(
+      const QnnImplementation& implementation,
+      QnnLogger* logger,
+      const QnnExecuTorchOptions* options);
+
+  std::unique_ptr<QnnContext> CreateContext(
+      const QnnImplementation& implementation,
+      QnnBackend* backend,
+      QnnDevice* device,
       const QnnExecuTorchContextBinary& qnn_context_blob,
       const QnnExecuTorchOptions* options);
+
+  std::unique_ptr<QnnGraph> CreateGraph(
+      const QnnImplementation& implementation,
+      QnnBackend* backend,
+      QnnContext* context,
+      const std::string& graph_name,
+      const QnnExecuTorchOptions* options);
 };
 } // namespace qnn
 } // namespace executor
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <executorch/backends/qualcomm/runtime/backends/QnnBackendFactory.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnBackendPool.h>
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+namespace torch {
+namespace executor {
+namespace qnn {
+SharedBackend::~SharedBackend() {
+  device_.reset();
+  backend_.reset();
+  logger_.reset();
+  implementation_.TerminateAllBackends();
+}
+
+QnnBackendPool& QnnBackendPool::GetBackendPool() {
+  static QnnBackendPool backend_pool;
+  return backend_pool;
+}
+
+Error QnnBackendPool::GetBackend(
+    const std::string& library_path,
+    const QnnExecuTorchOptions* options,
+    std::shared_ptr<SharedBackend>& shared_backend) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  shared_backend = backends_[library_path].lock();
+  if (shared_backend != nullptr) {
+    return Error::Ok;
+  }
+
+  QNN_EXECUTORCH_LOG_INFO(
+      "Create shared Qnn backend for library %s", library_path.c_str());
+  auto backend = std::make_shared<SharedBackend>(library_path);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend->implementation_.Load(nullptr) == Error::Ok,
+      Internal,
+      "Fail to load Qnn library");
+  backend->logger_ = std::make_unique<QnnLogger>(
+      backend->implementation_, LoggingCallback, options->log_level());
+
+  QnnBackendFactory factory;
+  backend->backend_ = factory.CreateBackend(
+      backend->implementation_, backend->logger_.get(), options);
+  backend->device_ = factory.CreateDevice(
+      backend->implementation_, backend->logger_.get(), options);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend->backend_ != nullptr && backend->device_ != nullptr,
+      Internal,
+      "Backend %s is not supported",
+      EnumNameQnnExecuTorchBackendType(
+          options->backend_options()->backend_type()));
+  ET_CHECK_OR_RETURN_ERROR(
+      backend->backend_->Configure() == Error::Ok,
+      Internal,
+      "Fail to configure Qnn backend");
+  ET_CHECK_OR_RETURN_ERROR(
+      backend->device_->Configure() == Error::Ok,
+      Internal,
+      "Fail to configure Qnn device");
+
+  backends_[library_path] = backend;
+  shared_backend = std::move(backend);
+  return Error::Ok;
+}
+
+Error QnnBackendPool::GetContext(
+    const std::shared_ptr<SharedBackend>& shared_backend,
+    const QnnExecuTorchContextBinary& qnn_context_blob,
+    bool online_prepare,
+    const QnnExecuTorchOptions* options,
+    std::shared_ptr<SharedContext>& shared_context) {
+  // Hashing the context binary is much cheaper than creating a context from
+  // it, so identical binaries embedded in several delegates are detected by
+  // their contents.
+  std::string key =
+      std::to_string(reinterpret_cast<uintptr_t>(shared_backend.get())) + "/";
+  if (online_prepare) {
+    key += "online_prepare";
+  } else {
+    const std::string_view blob(
+        static_cast<const char*>(qnn_context_blob.buffer),
+        qnn_context_blob.nbytes);
+    key += std::to_string(qnn_context_blob.nbytes) + "_" +
+        std::to_string(std::hash<std::string_view>{}(blob));
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+  shared_context = contexts_[key].lock();
+  if (shared_context != nullptr) {
+    return Error::Ok;
+  }
+
+  QNN_EXECUTORCH_LOG_INFO("Create shared Qnn context %s", key.c_str());
+  auto context = std::make_shared<SharedContext>();
+  context->backend_ = shared_backend;
+  context->context_ = QnnBackendFactory().CreateContext(
+      shared_backend->implementation_,
+      shared_backend->backend_.get(),
+      shared_backend->device_.get(),
+      qnn_context_blob,
+      options);
+  ET_CHECK_OR_RETURN_ERROR(
+      context->context_ != nullptr,
+      Internal,
+      "Backend %s is not supported",
+      EnumNameQnnExecuTorchBackendType(
+          options->backend_options()->backend_type()));
+  ET_CHECK_OR_RETURN_ERROR(
+      context->context_->Configure() == Error::Ok,
+      Internal,
+      "Fail to configure Qnn context");
+
+  contexts_[key] = context;
+  shared_context = std::move(context);
+  return Error::Ok;
+}
+
+std::string QnnBackendPool::ReserveGraphName(
+    SharedContext& shared_context,
+    const std::string& graph_name) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  std::string unique_name = graph_name;
+  for (size_t i = 1; shared_context.graph_names_.count(unique_name) > 0; ++i) {
+    unique_name = graph_name + "_" + std::to_string(i);
+  }
+  shared_context.graph_names_.insert(unique_name);
+  return unique_name;
+}
+} // namespace qnn
+} // namespace executor
+} // namespace torch
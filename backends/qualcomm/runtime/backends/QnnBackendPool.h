@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <executorch/backends/qualcomm/runtime/Logging.h>
+#include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnBackendCommon.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnContextCommon.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnDeviceCommon.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnImplementation.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnLogger.h>
+#include <executorch/backends/qualcomm/schema_generated.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+namespace torch {
+namespace executor {
+namespace qnn {
+// @brief Backend and device shared by the delegates loading the same QNN
+// library. The library is unloaded once the last of them is destroyed.
+struct SharedBackend {
+  explicit SharedBackend(const std::string& library_path)
+      : implementation_(library_path) {}
+  ~SharedBackend();
+
+  QnnImplementation implementation_;
+  std::unique_ptr<QnnLogger> logger_;
+  std::shared_ptr<QnnBackend> backend_;
+  std::shared_ptr<QnnDevice> device_;
+};
+
+// @brief Context holding the graphs of several delegates, together with the
+// weights of a multi-graph context binary.
+struct SharedContext {
+  // declared first so that it outlives the context
+  std::shared_ptr<SharedBackend> backend_;
+  std::shared_ptr<QnnContext> context_;
+  // graphs composed in an online prepared context
+  std::unordered_set<std::string> graph_names_;
+};
+
+// Keeps track of the backends and contexts shared between the delegates that
+// enable QnnExecuTorchOptions::shared_context. Entries are weak references, so
+// the resources are released as soon as no QnnManager uses them anymore.
+//
+// Delegates sharing a backend run it with the options of the first delegate
+// that created it. Those options must outlive the shared backend.
+class QnnBackendPool final {
+ public:
+  QnnBackendPool(const QnnBackendPool&) = delete;
+  QnnBackendPool& operator=(const QnnBackendPool&) = delete;
+  QnnBackendPool(QnnBackendPool&&) = delete;
+  QnnBackendPool& operator=(QnnBackendPool&&) = delete;
+
+  static QnnBackendPool& GetBackendPool();
+
+  // Returns the configured backend and device for library_path, creating them
+  // on first use.
+  Error GetBackend(
+      const std::string& library_path,
+      const QnnExecuTorchOptions* options,
+      std::shared_ptr<SharedBackend>& shared_backend);
+
+  // Returns the configured context for qnn_context_blob. Context binaries are
+  // shared when their contents are identical, and all delegates composing
+  // their graphs on device share a single context.
+  Error GetContext(
+      const std::shared_ptr<SharedBackend>& shared_backend,
+      const QnnExecuTorchContextBinary& qnn_context_blob,
+      bool online_prepare,
+      const QnnExecuTorchOptions* options,
+      std::shared_ptr<SharedContext>& shared_context);
+
+  // Returns graph_name, or graph_name with a suffix if another delegate
+  // already composed a graph with that name in the shared context.
+  std::string ReserveGraphName(
+      SharedContext& shared_context,
+      const std::string& graph_name);
+
+ private:
+  QnnBackendPool() = default;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<SharedBackend>> backends_;
+  std::unordered_map<std::string, std::weak_ptr<SharedContext>> contexts_;
+};
+} // namespace qnn
+} // namespace executor
+} // namespace torch
@@ -23,12 +23,12 @@ Error QnnGraph::Configure() {
   if (context_->GetCacheState() == QnnBackendCache::DESERIALIZE) {
     // retrieve QNN Graph
     error = qnn_interface.qnn_graph_retrieve(
-        context_->GetHandle(), context_->GetGraphName().c_str(), &handle_);
+        context_->GetHandle(), graph_name_.c_str(), &handle_);
     if (error != QNN_SUCCESS) {
       QNN_EXECUTORCH_LOG_ERROR(
           "Can't retrieve graph "
           "%s from context. Error %d.",
-          context_->GetGraphName().c_str(),
+          graph_name_.c_str(),
           QNN_GET_ERROR_CODE(error));
       return Error::Internal;
     }
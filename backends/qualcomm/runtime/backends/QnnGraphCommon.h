@@ -60,6 +60,9 @@ class QnnGraph {
   Qnn_GraphHandle_t GetHandle() {
     return handle_;
   }
+  const std::string& GetGraphName() const {
+    return graph_name_;
+  }
 
  protected:
   virtual Error MakeConfig(std::vector<const QnnGraph_Config_t*>& config) {
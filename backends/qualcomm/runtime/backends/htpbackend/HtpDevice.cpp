@@ -280,6 +280,10 @@ std::vector<QnnHtpPerfInfrastructure_PowerConfig_t> SetRpcPollingPowerConfig(
 } // namespace
 
 HtpDevice::~HtpDevice() {
+  {
+    const std::lock_guard<std::mutex> lock(devices_mutex_);
+    devices_.erase(this);
+  }
   if (htp_perf_infra_ != nullptr && powerconfig_client_id_ != 0 &&
       !down_vote_power_configs_ptr_.empty()) {
     htp_perf_infra_->setPowerConfig(
@@ -358,69 +362,114 @@ Error HtpDevice::MakeConfig(std::vector<const QnnDevice_Config_t*>& config) {
   return Error::Ok;
 }
 
-void HtpDevice::PerformanceVote() {
-  if (IsPerfModeEnabled()) {
-    htp_perf_infra_->setPowerConfig(
-        powerconfig_client_id_, perf_power_configs_ptr_.data());
+Error HtpDevice::CreatePowerConfigId() {
+  if (htp_perf_infra_ != nullptr) {
+    return Error::Ok;
   }
-};
+  const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
 
-void HtpDevice::ReleasePerformanceVote() {
-  if (IsPerfModeEnabled()) {
-    htp_perf_infra_->setPowerConfig(
-        powerconfig_client_id_, down_vote_power_configs_ptr_.data());
+  // Get htp_perf_infra
+  if (GetPerfInfra(qnn_interface, &owned_htp_perf_infra_) != Error::Ok) {
+    return Error::Internal;
   }
-};
-
-Error HtpDevice::AfterCreateDevice() {
-  if (IsPerfModeEnabled()) {
-    const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
-    Qnn_ErrorHandle_t error = QNN_SUCCESS;
 
-    // Get htp_perf_infra
-    htp_perf_infra_ = &owned_htp_perf_infra_;
-    if (GetPerfInfra(qnn_interface, htp_perf_infra_) != Error::Ok) {
-      return Error::Internal;
-    }
+  // Get power client id
+  error = owned_htp_perf_infra_.createPowerConfigId(
+      /*device_id=*/0, /*core_id=*/0, &powerconfig_client_id_);
 
-    // Get power client id
-    error = htp_perf_infra_->createPowerConfigId(
-        /*device_id=*/0, /*core_id=*/0, &powerconfig_client_id_);
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG_ERROR(
+        "HTP backend unable to create "
+        "power config. Error %d",
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
+  htp_perf_infra_ = &owned_htp_perf_infra_;
+
+  down_vote_power_configs_ = SetVotePowerConfig(
+      powerconfig_client_id_,
+      QnnExecuTorchHtpPerformanceMode::kHtpDefault,
+      PerformanceModeVoteType::kDownVote);
+  down_vote_power_configs_ptr_ =
+      ObtainNullTermPtrVector(down_vote_power_configs_);
+  return Error::Ok;
+}
 
-    if (error != QNN_SUCCESS) {
-      QNN_EXECUTORCH_LOG_ERROR(
-          "HTP backend unable to create "
-          "power config. Error %d",
-          QNN_GET_ERROR_CODE(error));
-      return Error::Internal;
-    }
+Error HtpDevice::SetPerformanceMode(
+    QnnExecuTorchHtpPerformanceMode performance_mode,
+    bool dcvs_enable) {
+  ET_CHECK_OR_RETURN_ERROR(
+      CreatePowerConfigId() == Error::Ok,
+      Internal,
+      "Fail to create HTP power config");
+  performance_mode_ = performance_mode;
 
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
+  if (IsPerfModeEnabled()) {
     // Set vector of PowerConfigs and map it to a vector of pointers.
     perf_power_configs_ = SetVotePowerConfig(
         powerconfig_client_id_,
-        htp_options_->performance_mode(),
+        performance_mode_,
         PerformanceModeVoteType::kUpVote);
+    perf_power_configs_[0].dcvsV3Config.dcvsEnable =
+        dcvs_enable ? kDcvsEnable : kDcvsDisable;
     perf_power_configs_ptr_ = ObtainNullTermPtrVector(perf_power_configs_);
+    error = htp_perf_infra_->setPowerConfig(
+        powerconfig_client_id_, perf_power_configs_ptr_.data());
+  } else {
+    error = htp_perf_infra_->setPowerConfig(
+        powerconfig_client_id_, down_vote_power_configs_ptr_.data());
+  }
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG_ERROR(
+        "HTP backend unable to vote for performance mode %s. Error %d",
+        EnumNameQnnExecuTorchHtpPerformanceMode(performance_mode_),
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
 
-    down_vote_power_configs_ = SetVotePowerConfig(
-        powerconfig_client_id_,
-        QnnExecuTorchHtpPerformanceMode::kHtpDefault,
-        PerformanceModeVoteType::kDownVote);
-    down_vote_power_configs_ptr_ =
-        ObtainNullTermPtrVector(down_vote_power_configs_);
-
-    // vote immediately
-    PerformanceVote();
-
-    // Set Rpc polling mode
-    rpc_power_configs_ =
-        SetRpcPollingPowerConfig(htp_options_->performance_mode());
-    rpc_power_configs_ptr_ = ObtainNullTermPtrVector(rpc_power_configs_);
+  // Set Rpc polling mode
+  rpc_power_configs_ = SetRpcPollingPowerConfig(performance_mode_);
+  rpc_power_configs_ptr_ = ObtainNullTermPtrVector(rpc_power_configs_);
+  error = htp_perf_infra_->setPowerConfig(
+      powerconfig_client_id_, rpc_power_configs_ptr_.data());
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG_ERROR(
+        "HTP backend unable to set rpc polling. Error %d",
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
+  return Error::Ok;
+}
 
-    htp_perf_infra_->setPowerConfig(
-        powerconfig_client_id_, rpc_power_configs_ptr_.data());
+Error HtpDevice::SetPerformanceModeOfAllDevices(
+    QnnExecuTorchHtpPerformanceMode performance_mode,
+    bool dcvs_enable) {
+  const std::lock_guard<std::mutex> lock(devices_mutex_);
+  Error status = Error::Ok;
+  for (HtpDevice* device : devices_) {
+    if (device->SetPerformanceMode(performance_mode, dcvs_enable) !=
+        Error::Ok) {
+      status = Error::Internal;
+    }
   }
+  return status;
+}
 
+Error HtpDevice::AfterCreateDevice() {
+  {
+    const std::lock_guard<std::mutex> lock(devices_mutex_);
+    devices_.insert(this);
+  }
+  if (IsPerfModeEnabled()) {
+    ET_CHECK_OR_RETURN_ERROR(
+        CreatePowerConfigId() == Error::Ok,
+        Internal,
+        "Fail to create HTP power config");
+    // vote immediately, a failed vote is logged but doesn't fail the init
+    SetPerformanceMode(performance_mode_, /*dcvs_enable=*/false);
+  }
   return Error::Ok;
 }
 
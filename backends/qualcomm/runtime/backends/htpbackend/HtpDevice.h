@@ -11,6 +11,8 @@
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDeviceCustomConfig.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDevicePlatformInfoConfig.h>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #include "HTP/QnnHtpDevice.h"
 
@@ -28,6 +30,7 @@ class HtpDevice : public QnnDevice {
       const SocInfo* soc_info,
       const QnnExecuTorchHtpBackendOptions* htp_options)
       : QnnDevice(implementation, logger),
+        performance_mode_(htp_options->performance_mode()),
         qcom_target_soc_info_(soc_info),
         htp_options_(htp_options) {
     htp_device_platform_info_config_ =
@@ -44,18 +47,28 @@ class HtpDevice : public QnnDevice {
     kDownVote = 2,
   };
 
+  // Votes for performance_mode in place of the mode given at compile time.
+  // kHtpDefault releases the vote. With dcvs_enable, DCVS is allowed to scale
+  // the clocks between the voltage corners of the mode.
+  Error SetPerformanceMode(
+      QnnExecuTorchHtpPerformanceMode performance_mode,
+      bool dcvs_enable);
+
+  // Calls SetPerformanceMode() on every HTP device alive in the process
+  static Error SetPerformanceModeOfAllDevices(
+      QnnExecuTorchHtpPerformanceMode performance_mode,
+      bool dcvs_enable);
+
  protected:
   Error MakeConfig(std::vector<const QnnDevice_Config_t*>& config) override;
 
   Error AfterCreateDevice() override;
 
  private:
-  void PerformanceVote();
-  void ReleasePerformanceVote();
+  Error CreatePowerConfigId();
 
   inline bool IsPerfModeEnabled() {
-    return htp_options_->performance_mode() !=
-        QnnExecuTorchHtpPerformanceMode::kHtpDefault;
+    return performance_mode_ != QnnExecuTorchHtpPerformanceMode::kHtpDefault;
   }
 
   template <typename T>
@@ -88,8 +101,13 @@ class HtpDevice : public QnnDevice {
   std::vector<const QnnHtpPerfInfrastructure_PowerConfig_t*>
       down_vote_power_configs_ptr_;
 
+  QnnExecuTorchHtpPerformanceMode performance_mode_;
+
   const SocInfo* qcom_target_soc_info_;
   const QnnExecuTorchHtpBackendOptions* htp_options_;
+
+  static inline std::mutex devices_mutex_;
+  static inline std::unordered_set<HtpDevice*> devices_;
 };
 } // namespace qnn
 } // namespace executor
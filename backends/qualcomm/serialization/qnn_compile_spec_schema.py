@@ -133,3 +133,5 @@ class QnnExecuTorchOptions:
     profile_level: QnnExecuTorchProfileLevel = QnnExecuTorchProfileLevel.kProfileOff
     shared_buffer: bool = False
     is_from_context_binary: bool = False
+    shared_context: bool = False
+    online_prepare_cache_dir: str = ""
@@ -384,6 +384,9 @@ def generate_qnn_executorch_compiler_spec(
     profile: bool = False,
     shared_buffer: bool = False,
     is_from_context_binary: bool = False,
+    graph_name: str = "executorch",
+    shared_context: bool = False,
+    online_prepare_cache_dir: str = "",
 ) -> List[CompileSpec]:
     """
     Helper function generating compiler specs for Qualcomm AI Engine Direct
@@ -411,6 +414,16 @@ def generate_qnn_executorch_compiler_spec(
             profile the performance of each operator with cycle unit.
         shared_buffer: Enables usage of shared buffer between application
             and backend for graph I/O.
+        is_from_context_binary: Whether the model is loaded from a QNN
+            context binary.
+        graph_name: Name of the graph to create, or to retrieve from a
+            context binary holding several graphs.
+        shared_context: Share the QNN backend, device and context with the
+            other delegates that set this option in runtime, e.g. the
+            prefill and decode graphs of a LLM.
+        online_prepare_cache_dir: Directory to cache the contexts composed
+            on device in online prepare mode. Later loads restore the cache
+            instead of composing the graph again.
 
     Returns:
         List[CompileSpec]: Compiler specs for Qualcomm AI Engine Direct.
@@ -426,7 +439,7 @@ def generate_qnn_executorch_compiler_spec(
     qnn_executorch_options = QnnExecuTorchOptions(
         _soc_info_table[soc_model], backend_options
     )
-    qnn_executorch_options.graph_name = "executorch"
+    qnn_executorch_options.graph_name = graph_name
     qnn_executorch_options.log_level = (
         QnnExecuTorchLogLevel.kLogLevelDebug
         if debug
@@ -459,6 +472,8 @@ def generate_qnn_executorch_compiler_spec(
     qnn_executorch_options.shared_buffer = shared_buffer
     qnn_executorch_options.online_prepare = online_prepare
     qnn_executorch_options.is_from_context_binary = is_from_context_binary
+    qnn_executorch_options.shared_context = shared_context
+    qnn_executorch_options.online_prepare_cache_dir = online_prepare_cache_dir
 
     return [
         CompileSpec(
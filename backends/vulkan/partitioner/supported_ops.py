@@ -8,10 +8,27 @@
 
 import operator
 
-from executorch.backends.vulkan.passes.custom_ops_defs import grid_priors_op  # noqa
+from executorch.backends.vulkan.passes.custom_ops_defs import (  # noqa
+    grid_priors_op,
+    linear_weight_int4_op,
+)
+
+# Defines the quantized_decomposed embedding ops
+from executorch.exir.passes import _quant_patterns_and_replacements  # noqa
 
 from executorch.exir.dialects._ops import ops as exir_ops
 
+try:
+    # Defines the llama.sdpa_with_kv_cache op
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    LLM_OPS = [
+        exir_ops.edge.llama.sdpa_with_kv_cache.default,
+    ]
+except (AssertionError, ImportError, OSError):
+    # The custom ops library is not available in this build
+    LLM_OPS = []
+
 
 class OpFeatures:
     __slots__ = ["supports_texture", "supports_buffer", "supports_dynamic_shape"]
@@ -75,6 +92,7 @@ MATMUL_OPS = [
     exir_ops.edge.aten.mm.default,
     exir_ops.edge.aten.addmm.default,
     exir_ops.edge.aten.linear.default,
+    exir_ops.edge.et_vk.linear_weight_int4.default,
 ]
 
 POOLING_OPS = [
@@ -111,6 +129,8 @@ INDEXING_OPS = [
     exir_ops.edge.aten.index_select.default,
     exir_ops.edge.aten.select_copy.int,
     exir_ops.edge.aten.slice_copy.Tensor,
+    exir_ops.edge.quantized_decomposed.embedding_4bit.default,
+    exir_ops.edge.quantized_decomposed.embedding_4bit.dtype,
 ]
 
 ORCHESTRATION_OPS = [
@@ -161,6 +181,7 @@ def register_dynamic_shape_ops(ops: OpList):
         *MATMUL_OPS,
         *POOLING_OPS,
         *CONVOLUTION_OPS,
+        *LLM_OPS,
     ]:
         ops[op].supports_dynamic_shape = True
 
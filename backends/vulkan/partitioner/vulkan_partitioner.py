@@ -140,6 +140,12 @@ def parse_compile_options(compile_options: Dict[str, Any]) -> List[CompileSpec]:
             value_bytes = int(value).to_bytes(4, byteorder="little")
             compile_specs.append(CompileSpec(key, value_bytes))
 
+        if key in ("pipeline_cache_path", "local_wg_size_tuning_path"):
+            compile_specs.append(CompileSpec(key, str(value).encode("utf-8")))
+
+        if key == "force_fp16":
+            compile_specs.append(CompileSpec(key, bytes([int(bool(value))])))
+
         # Unhandled options are ignored
 
     return compile_specs
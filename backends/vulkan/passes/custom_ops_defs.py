@@ -88,3 +88,33 @@ lib.define(
     f"{name}(Tensor self, int stride, float offset, *, Tensor(a!) out) -> Tensor(a!)"
 )
 lib.impl(name, grid_priors_out_impl, "CompositeExplicitAutograd")
+
+
+def linear_weight_int4_impl(
+    x,
+    weight,
+    weight_scales,
+    weight_zero_points,
+    group_size,
+):
+    # Two int4 values are packed in every byte, the even one in the high nibble
+    weight = weight.to(torch.int32)
+    weight_int4 = torch.stack([weight // 16, weight % 16], dim=-1).reshape(
+        weight.shape[0], -1
+    )
+
+    weight_int4 = (weight_int4 - 8).to(x.dtype)
+    if weight_zero_points is not None:
+        weight_int4 = weight_int4 - weight_zero_points.repeat_interleave(
+            group_size, dim=-1
+        )
+    weight_dq = weight_int4 * weight_scales.repeat_interleave(group_size, dim=-1)
+    return torch.nn.functional.linear(x, weight_dq)
+
+
+name = "linear_weight_int4"
+lib.define(
+    f"{name}(Tensor self, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, int group_size) -> Tensor"
+)
+lib.impl(name, linear_weight_int4_impl, "CompositeExplicitAutograd")
+linear_weight_int4_op = getattr(getattr(torch.ops, namespace), name)
@@ -122,3 +122,47 @@ class TestCustomOps(unittest.TestCase):
             "custom op `grid_priors` output shape matches expected",
         )
         self.assertTrue(torch.allclose(custom_out, expected_out))
+
+    def test_linear_weight_int4(self):
+        class LinearWeightInt4(torch.nn.Module):
+            def __init__(self, weight, weight_scales, weight_zero_points, group_size):
+                super().__init__()
+                self.weight = weight
+                self.weight_scales = weight_scales
+                self.weight_zero_points = weight_zero_points
+                self.group_size = group_size
+
+            def forward(self, x):
+                return torch.ops.et_vk.linear_weight_int4(
+                    x,
+                    self.weight,
+                    self.weight_scales,
+                    self.weight_zero_points,
+                    self.group_size,
+                )
+
+        N, K, group_size = 8, 64, 32
+        weight_int4 = torch.randint(0, 16, (N, K), dtype=torch.uint8)
+        # Two int4 values are packed in every byte, the even one in the high
+        # nibble
+        weight = weight_int4[:, ::2] * 16 + weight_int4[:, 1::2]
+        weight_scales = torch.rand(N, K // group_size)
+        weight_zero_points = torch.randint(-2, 2, (N, K // group_size)).float()
+        x = torch.rand(3, K)
+
+        for zero_points in [None, weight_zero_points]:
+            model = LinearWeightInt4(weight, weight_scales, zero_points, group_size)
+            custom_out = model(x)
+
+            weight_dq = weight_int4.float() - 8
+            if zero_points is not None:
+                weight_dq -= zero_points.repeat_interleave(group_size, dim=-1)
+            weight_dq *= weight_scales.repeat_interleave(group_size, dim=-1)
+            expected_out = x @ weight_dq.t()
+
+            self.assertEqual(
+                custom_out.shape,
+                expected_out.shape,
+                "custom op `linear_weight_int4` output shape matches expected",
+            )
+            self.assertTrue(torch.allclose(custom_out, expected_out))
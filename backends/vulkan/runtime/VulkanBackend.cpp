@@ -27,6 +27,7 @@
 #include <cstdlib> /* strtol */
 #include <cstring>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -76,6 +77,28 @@ vkapi::ScalarType get_scalar_type(const vkgraph::VkDataType& vk_datatype) {
   }
 }
 
+// Returns the dtype of the data of an input or output tensor, so that the graph
+// can convert it if it stores the tensor with another dtype.
+vkapi::ScalarType get_scalar_type(const exec_aten::ScalarType& et_dtype) {
+  switch (et_dtype) {
+    case exec_aten::ScalarType::Bool:
+      return vkapi::kBool;
+    case exec_aten::ScalarType::Byte:
+      return vkapi::kByte;
+    case exec_aten::ScalarType::Char:
+      return vkapi::kChar;
+    case exec_aten::ScalarType::Int:
+      return vkapi::kInt;
+    case exec_aten::ScalarType::Half:
+      return vkapi::kHalf;
+    case exec_aten::ScalarType::Float:
+      return vkapi::kFloat;
+    default:
+      break;
+  }
+  VK_THROW("Unsupported input or output dtype ", static_cast<int>(et_dtype));
+}
+
 utils::StorageType get_storage_type(
     const vkgraph::VkStorageType& vk_storage_type) {
   switch (vk_storage_type) {
@@ -128,13 +151,45 @@ GraphConfig get_graph_config(ArrayRef<CompileSpec>& compile_specs) {
 
       config.set_memory_layout_override(memory_layout);
     }
+    if (strcmp(spec.key, "force_fp16") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_fp16 = value_data[0] != 0;
+    }
+    if (strcmp(spec.key, "local_wg_size_tuning_path") == 0) {
+      config.enable_local_wg_size_tuning = true;
+      config.local_wg_size_tuning_path = std::string(
+          static_cast<const char*>(spec.value.buffer), spec.value.nbytes);
+    }
   }
+  // Tensors not assigned a shared object ahead of time, like the temporary
+  // tensors of operators, share memory according to their lifetimes.
+  config.enable_memory_planning = true;
+  // Dynamic shapes shrink the dispatches of resized operators.
+  config.enable_indirect_dispatch = true;
+  // On devices with unified memory, buffer backed inputs and outputs skip the
+  // copies through staging buffers.
+  config.enable_host_visible_io = true;
+  // The last prepacking commands are submitted with the first inference, so
+  // that init() does not wait for the GPU.
+  config.defer_prepack_submit = true;
 #ifdef ET_EVENT_TRACER_ENABLED
   config.enable_querypool = true;
 #endif // ET_EVENT_TRACER_ENABLED
   return config;
 }
 
+// Returns the file that compute pipelines are persisted to across launches, or
+// an empty string if the "pipeline_cache_path" compile spec is not set.
+std::string get_pipeline_cache_path(ArrayRef<CompileSpec>& compile_specs) {
+  for (const CompileSpec& spec : compile_specs) {
+    if (strcmp(spec.key, "pipeline_cache_path") == 0) {
+      return std::string(
+          static_cast<const char*>(spec.value.buffer), spec.value.nbytes);
+    }
+  }
+  return "";
+}
+
 class GraphBuilder {
   ComputeGraph* compute_graph_;
   VkGraphPtr flatbuffer_;
@@ -236,6 +291,12 @@ class GraphBuilder {
     ref_mapping_[fb_id] = ref;
   }
 
+  void add_symint_to_graph(const uint32_t fb_id, VkValuePtr value) {
+    const int32_t fb_symint = value->value_as_SymInt()->value();
+    ValueRef ref = compute_graph_->add_symint(fb_symint);
+    ref_mapping_[fb_id] = ref;
+  }
+
   void add_value_to_graph(const uint32_t fb_id, VkValuePtr value) {
     ET_CHECK_MSG(
         !fb_id_exists(fb_id),
@@ -288,6 +349,9 @@ class GraphBuilder {
       case vkgraph::GraphTypes::String:
         add_string_to_graph(fb_id, value);
         break;
+      case vkgraph::GraphTypes::SymInt:
+        add_symint_to_graph(fb_id, value);
+        break;
       default:
         ET_CHECK_MSG(false, "Unsupported value type.");
     }
@@ -303,7 +367,11 @@ class GraphBuilder {
     // Parse the inputs
     for (const uint32_t fb_id : *flatbuffer_->input_ids()) {
       const ValueRef ref = get_fb_id_valueref(fb_id);
-      compute_graph_->set_input_tensor(ref);
+      if (compute_graph_->val_is_symint(ref)) {
+        compute_graph_->set_val_as_input(ref);
+      } else {
+        compute_graph_->set_input_tensor(ref);
+      }
     }
 
     // Parse the operators
@@ -459,6 +527,7 @@ class VulkanBackend final : public PyTorchBackendInterface {
     compute_graph->prepack();
 
     compute_graph->encode_execute();
+    compute_graph->tune_local_wg_sizes();
 
     return Error::Ok;
   }
@@ -472,8 +541,24 @@ class VulkanBackend final : public PyTorchBackendInterface {
 
     new (compute_graph) ComputeGraph(get_graph_config(compile_specs));
 
+    // Pipelines are cached by the global context, so the stored pipelines are
+    // available to every delegate once any of them sets the path.
+    vkapi::ComputePipelineCache& pipeline_cache =
+        compute_graph->context()->pipeline_cache();
+    const std::string pipeline_cache_path =
+        get_pipeline_cache_path(compile_specs);
+    if (!pipeline_cache_path.empty()) {
+      pipeline_cache.set_cache_data_path(pipeline_cache_path);
+    }
+
     Error err = compileModel(processed->data(), compute_graph);
 
+    // Persist the pipelines compiled for prepacking and execution right away,
+    // since the global context is usually not destroyed when an app exits.
+    if (err == Error::Ok) {
+      pipeline_cache.save_cache();
+    }
+
     // This backend does not need its processed data after compiling the model.
     processed->Free();
 
@@ -495,12 +580,20 @@ class VulkanBackend final : public PyTorchBackendInterface {
     const size_t num_inputs = compute_graph->inputs().size();
     bool should_propagate_resize = false;
     for (size_t i = 0; i < num_inputs; i++) {
+      const ValueRef in_ref = compute_graph->inputs()[i].value;
+      if (compute_graph->val_is_symint(in_ref)) {
+        ET_CHECK_MSG(args[i]->isInt(), "Expected an int for a SymInt input");
+        compute_graph->set_symint(
+            in_ref, static_cast<int32_t>(args[i]->toInt()));
+        continue;
+      }
       bool was_resized =
           maybe_resize_input(compute_graph, i, args[i]->toTensor());
       should_propagate_resize = should_propagate_resize || was_resized;
       compute_graph->copy_into_staging(
           compute_graph->inputs()[i].staging,
           args[i]->toTensor().const_data_ptr(),
+          get_scalar_type(args[i]->toTensor().scalar_type()),
           args[i]->toTensor().numel());
     }
 
@@ -516,6 +609,7 @@ class VulkanBackend final : public PyTorchBackendInterface {
       compute_graph->copy_from_staging(
           compute_graph->outputs()[i].staging,
           args[num_inputs + i]->toTensor().mutable_data_ptr(),
+          get_scalar_type(args[num_inputs + i]->toTensor().scalar_type()),
           args[num_inputs + i]->toTensor().numel());
     }
 
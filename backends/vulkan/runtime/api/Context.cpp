@@ -31,12 +31,17 @@ Context::Context(size_t adapter_i, const ContextConfig& config)
       command_pool_(device_, queue_.family_index, config_.cmd_pool_config),
       descriptor_pool_(device_, config_.descriptor_pool_config),
       fences_(device_),
+      timeline_(
+          adapter_p_->has_timeline_semaphore()
+              ? vkapi::TimelineSemaphore(device_)
+              : vkapi::TimelineSemaphore()),
       // Profiling
       querypool_(config_.query_pool_config, nullptr),
       // Command buffer submission
       cmd_mutex_{},
       cmd_(VK_NULL_HANDLE, 0u),
       submit_count_{0u},
+      batched_cmds_{},
       // Memory Management
       buffer_clearlist_mutex_{},
       buffers_to_clear_{},
@@ -84,7 +89,7 @@ void Context::report_shader_dispatch_end() {
   }
 }
 
-vkapi::DescriptorSet Context::get_descriptor_set(
+VkDescriptorSetLayout Context::bind_pipeline(
     const vkapi::ShaderInfo& shader_descriptor,
     const utils::uvec3& local_workgroup_size,
     const vkapi::SpecVarList& additional_constants) {
@@ -108,6 +113,16 @@ vkapi::DescriptorSet Context::get_descriptor_set(
 
   cmd_.bind_pipeline(pipeline, pipeline_layout, local_workgroup_size);
 
+  return shader_layout;
+}
+
+vkapi::DescriptorSet Context::get_descriptor_set(
+    const vkapi::ShaderInfo& shader_descriptor,
+    const utils::uvec3& local_workgroup_size,
+    const vkapi::SpecVarList& additional_constants) {
+  VkDescriptorSetLayout shader_layout = bind_pipeline(
+      shader_descriptor, local_workgroup_size, additional_constants);
+
   return descriptor_pool().get_descriptor_set(
       shader_layout, shader_descriptor.kernel_layout);
 }
@@ -145,17 +160,75 @@ void Context::register_shader_dispatch(
   cmd_.dispatch(effective_global_wg);
 }
 
-void Context::submit_cmd_to_gpu(VkFence fence_handle, const bool final_use) {
+void Context::register_shader_dispatch_indirect(
+    const vkapi::DescriptorSet& descriptors,
+    vkapi::PipelineBarrier& pipeline_barrier,
+    const vkapi::VulkanBuffer& dispatch_buffer) {
+  cmd_.bind_descriptors(descriptors.get_bind_handle());
+  cmd_.insert_barrier(pipeline_barrier);
+
+  cmd_.dispatch_indirect(dispatch_buffer.handle(), 0u);
+}
+
+utils::uvec3 Context::get_dispatch_size(
+    const vkapi::ShaderInfo& shader_descriptor,
+    const utils::uvec3& global_workgroup_size,
+    const utils::uvec3& local_workgroup_size) {
+  utils::uvec3 dispatch_size{};
+  for (uint32_t i = 0; i < 3u; ++i) {
+    dispatch_size[i] = utils::div_up(
+        utils::div_up(
+            global_workgroup_size[i], shader_descriptor.out_tile_size[i]),
+        local_workgroup_size[i]);
+  }
+  // Mirror register_shader_dispatch(), which dispatches a single work group
+  // instead of an empty dispatch
+  if (dispatch_size[0u] == 0u || dispatch_size[1u] == 0u ||
+      dispatch_size[2u] == 0u) {
+    dispatch_size = {1u, 1u, 1u};
+  }
+  return dispatch_size;
+}
+
+void Context::batch_cmd(const bool final_use) {
   if (cmd_) {
     cmd_.end();
-    adapter_p_->submit_cmd(
-        queue_, cmd_.get_submit_handle(final_use), fence_handle);
+    batched_cmds_.push_back(cmd_.get_submit_handle(final_use));
 
     submit_count_ = 0u;
   }
 }
 
+uint64_t Context::submit_cmd_to_gpu(
+    VkFence fence_handle,
+    const bool final_use) {
+  batch_cmd(final_use);
+  if (batched_cmds_.empty()) {
+    return 0u;
+  }
+
+  const uint64_t signal_value = timeline_ ? timeline_.next_value() : 0u;
+  adapter_p_->submit_cmds(
+      queue_,
+      batched_cmds_.data(),
+      utils::safe_downcast<uint32_t>(batched_cmds_.size()),
+      fence_handle,
+      timeline_.handle(),
+      signal_value);
+
+  batched_cmds_.clear();
+  return signal_value;
+}
+
 void Context::flush() {
+  // Command buffers are reset below, so batched ones must be executed first
+  if (!batched_cmds_.empty()) {
+    adapter_p_->submit_cmds(
+        queue_,
+        batched_cmds_.data(),
+        utils::safe_downcast<uint32_t>(batched_cmds_.size()));
+    batched_cmds_.clear();
+  }
   VK_CHECK(vkQueueWaitIdle(queue()));
 
   command_pool_.flush();
@@ -61,12 +61,16 @@ class Context final {
   vkapi::CommandPool command_pool_;
   vkapi::DescriptorPool descriptor_pool_;
   vkapi::FencePool fences_;
+  // Signaled by every queue submission, if the device supports it
+  vkapi::TimelineSemaphore timeline_;
   // Diagnostics
   vkapi::QueryPool querypool_;
   // Command buffers submission
   std::mutex cmd_mutex_;
   vkapi::CommandBuffer cmd_;
   uint32_t submit_count_;
+  // Command buffers that have been ended but not yet submitted
+  std::vector<VkCommandBuffer> batched_cmds_;
   // Memory Management
   std::mutex buffer_clearlist_mutex_;
   std::vector<vkapi::VulkanBuffer> buffers_to_clear_;
@@ -116,6 +120,10 @@ class Context final {
     return fences_;
   }
 
+  inline vkapi::TimelineSemaphore& timeline() {
+    return timeline_;
+  }
+
   // Diagnostics
 
   inline vkapi::QueryPool& querypool() {
@@ -171,6 +179,10 @@ class Context final {
     return std::unique_lock<std::mutex>(cmd_mutex_);
   }
 
+  inline bool has_cmd() const {
+    return cmd_;
+  }
+
   inline void set_cmd(bool reusable = false) {
     if (!cmd_) {
       cmd_ = command_pool_.get_new_cmd(reusable);
@@ -178,6 +190,15 @@ class Context final {
     }
   }
 
+  /*
+   * Binds the compute pipeline of a shader to the current command buffer, and
+   * returns the layout of the descriptor sets of the shader.
+   */
+  VkDescriptorSetLayout bind_pipeline(
+      const vkapi::ShaderInfo&,
+      const utils::uvec3&,
+      const vkapi::SpecVarList&);
+
   vkapi::DescriptorSet get_descriptor_set(
       const vkapi::ShaderInfo&,
       const utils::uvec3&,
@@ -195,6 +216,25 @@ class Context final {
       const vkapi::ShaderInfo&,
       const utils::uvec3&);
 
+  /*
+   * Records a dispatch whose work group counts are read from a
+   * VkDispatchIndirectCommand in the given buffer when it executes, so that
+   * they can be changed without recording the command buffer again.
+   */
+  void register_shader_dispatch_indirect(
+      const vkapi::DescriptorSet&,
+      vkapi::PipelineBarrier&,
+      const vkapi::VulkanBuffer&);
+
+  /*
+   * Returns the number of work groups that register_shader_dispatch() records
+   * for the given global work group size.
+   */
+  static utils::uvec3 get_dispatch_size(
+      const vkapi::ShaderInfo&,
+      const utils::uvec3& global_workgroup_size,
+      const utils::uvec3& local_workgroup_size);
+
   template <typename... Arguments>
   bool submit_compute_job(
       const vkapi::ShaderInfo&,
@@ -206,7 +246,24 @@ class Context final {
       const uint32_t dispatch_id,
       Arguments&&...);
 
-  void submit_cmd_to_gpu(
+  /*
+   * Ends the current command buffer without submitting it. It is submitted by
+   * the next call to submit_cmd_to_gpu(), in the same queue submission as the
+   * command buffer current at that point, and executes before it.
+   */
+  void batch_cmd(const bool final_use = false);
+
+  inline bool has_batched_cmds() const {
+    return !batched_cmds_.empty();
+  }
+
+  /*
+   * Submits the batched command buffers and the current command buffer to the
+   * GPU in a single queue submission. If the device supports timeline
+   * semaphores, returns the value that timeline() reaches once the submission
+   * has completed, otherwise returns 0.
+   */
+  uint64_t submit_cmd_to_gpu(
       VkFence fence_handle = VK_NULL_HANDLE,
       const bool final_use = false);
 
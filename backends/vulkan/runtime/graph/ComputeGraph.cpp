@@ -15,8 +15,21 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/utils/StagingUtils.h>
 
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace vkcompute {
 
+namespace {
+
+// Size of the uniform buffers that params are packed into. Every device
+// supports binding ranges of at least this size.
+constexpr VkDeviceSize kParamsBufferNbytes = 16384u;
+
+} // namespace
+
 //
 // VTensorPtr
 //
@@ -43,6 +56,7 @@ VALUE_PTR_CLASS_IMPL(IntListPtr, std::vector<int64_t>, IntList)
 VALUE_PTR_CLASS_IMPL(DoubleListPtr, std::vector<double>, DoubleList)
 VALUE_PTR_CLASS_IMPL(BoolListPtr, std::vector<bool>, BoolList)
 VALUE_PTR_CLASS_IMPL(ValueListPtr, std::vector<ValueRef>, ValueList)
+VALUE_PTR_CLASS_IMPL(SymIntPtr, SymInt, SymInt)
 
 #undef VALUE_PTR_CLASS_IMPL
 
@@ -58,12 +72,23 @@ ComputeGraph::ComputeGraph(GraphConfig config)
           vkapi::runtime()->default_adapter_i(),
           config_.context_config)},
       shared_objects_{},
+      planned_tensors_{},
+      planned_objects_{},
       values_{},
       param_ubos_{},
+      param_ubos_offset_{0u},
+      execute_descriptor_pool_{},
       prepack_nodes_{},
       execute_nodes_{},
       inputs_{},
-      outputs_{} {
+      outputs_{},
+      prepack_staging_{},
+      prepack_staging_nbytes_{0u},
+      submitted_prepack_staging_{},
+      prepack_fence_{},
+      prepack_submit_deferred_{false},
+      execute_timeline_value_{0u},
+      execute_fence_{} {
   // Ensure that descriptor counts are initialized to 0
   prepack_descriptor_counts_.descriptor_pool_max_sets = 0;
   prepack_descriptor_counts_.descriptor_uniform_buffer_count = 0;
@@ -112,6 +137,14 @@ utils::GPUMemoryLayout ComputeGraph::suggested_memory_layout(
   return utils::kChannelsPacked;
 }
 
+vkapi::ScalarType ComputeGraph::stored_dtype(const vkapi::ScalarType dtype) {
+  if (config_.enable_fp16 && dtype == vkapi::kFloat &&
+      context_->adapter_ptr()->has_full_float16_buffers_support()) {
+    return vkapi::kHalf;
+  }
+  return dtype;
+}
+
 void ComputeGraph::check_no_active_value_ptrs() {
   VK_CHECK_COND(
       values_in_use_ == 0,
@@ -147,14 +180,23 @@ ValueRef ComputeGraph::add_tensor(
     const utils::StorageType storage_type,
     const utils::GPUMemoryLayout memory_layout,
     const int64_t shared_object_idx) {
-  bool allocate_memory = shared_object_idx < 0;
+  const bool plan_memory =
+      shared_object_idx < 0 && config_.enable_memory_planning;
+  bool allocate_memory = shared_object_idx < 0 && !plan_memory;
 
   ValueRef idx(static_cast<int>(values_.size()));
   check_no_active_value_ptrs();
   values_.emplace_back(api::vTensor(
-      context(), sizes, dtype, storage_type, memory_layout, allocate_memory));
+      context(),
+      sizes,
+      stored_dtype(dtype),
+      storage_type,
+      memory_layout,
+      allocate_memory));
 
-  if (!allocate_memory) {
+  if (plan_memory) {
+    planned_tensors_.emplace_back(idx);
+  } else if (!allocate_memory) {
     get_shared_object(shared_object_idx).add_user(this, idx);
   }
   return idx;
@@ -208,6 +250,10 @@ ValueRef ComputeGraph::add_tensor_view(
     const std::vector<int64_t>& sizes,
     const std::vector<int64_t>& strides,
     const size_t offset_numel) {
+  // A view copies the buffer handle of the tensor it views, so the viewed
+  // tensor needs its memory before the view is created.
+  allocate_planned_tensor(vref);
+
   const vTensorPtr t = get_tensor(vref);
   ValueRef idx(static_cast<int>(values_.size()));
   values_.emplace_back(api::vTensor(*t, sizes, strides, offset_numel));
@@ -254,9 +300,20 @@ ValueRef ComputeGraph::add_string(std::string&& str) {
   return idx;
 }
 
+ValueRef ComputeGraph::add_symint(const int32_t val) {
+  ValueRef idx(static_cast<int>(values_.size()));
+  check_no_active_value_ptrs();
+  values_.emplace_back(SymInt(context(), val));
+  return idx;
+}
+
 ValueRef ComputeGraph::set_input_tensor(
     const ValueRef idx,
     const bool use_staging) {
+  if (use_staging && bind_host_visible_memory(idx)) {
+    inputs_.push_back({idx, idx});
+    return idx;
+  }
   if (use_staging) {
     vkapi::ScalarType dtype = get_tensor(idx)->dtype();
     // For texture storage, the buffer size needs to account for the zero
@@ -271,9 +328,26 @@ ValueRef ComputeGraph::set_input_tensor(
   return idx;
 }
 
+void ComputeGraph::set_val_as_input(const ValueRef idx) {
+  VK_CHECK_COND(val_is_symint(idx));
+  inputs_.push_back({idx, kDummyValueRef});
+}
+
+void ComputeGraph::set_symint(const ValueRef idx, const int32_t val) {
+  get_symint(idx)->set(val);
+}
+
+int32_t ComputeGraph::read_symint(const ValueRef idx) {
+  return get_symint(idx)->value;
+}
+
 ValueRef ComputeGraph::set_output_tensor(
     const ValueRef idx,
     const bool use_staging) {
+  if (use_staging && bind_host_visible_memory(idx)) {
+    outputs_.push_back({idx, idx});
+    return idx;
+  }
   if (use_staging) {
     vkapi::ScalarType dtype = get_tensor(idx)->dtype();
     // For texture storage, the buffer size needs to account for the zero
@@ -293,6 +367,161 @@ ValueRef ComputeGraph::set_output_tensor(
   return idx;
 }
 
+void ComputeGraph::allocate_planned_tensor(const ValueRef idx) {
+  auto it = std::find(planned_tensors_.begin(), planned_tensors_.end(), idx);
+  if (it == planned_tensors_.end()) {
+    return;
+  }
+  planned_tensors_.erase(it);
+
+  SharedObject& object = planned_objects_.emplace_back();
+  object.add_user(this, idx);
+  object.allocate(this);
+  object.bind_users(this);
+}
+
+bool ComputeGraph::bind_host_visible_memory(const ValueRef idx) {
+  if (!config_.enable_host_visible_io ||
+      !context_->adapter_ptr()->has_unified_memory()) {
+    return false;
+  }
+
+  auto it = std::find(planned_tensors_.begin(), planned_tensors_.end(), idx);
+  if (it == planned_tensors_.end()) {
+    return false;
+  }
+
+  {
+    vTensorPtr t = get_tensor(idx);
+    // The buffer of a width packed tensor is contiguous, like a staging buffer
+    if (t->storage_type() != utils::kBuffer ||
+        t->gpu_memory_layout() != utils::kWidthPacked ||
+        t->staging_buffer_numel() != t->numel()) {
+      return false;
+    }
+  }
+  planned_tensors_.erase(it);
+
+  SharedObject& object = planned_objects_.emplace_back();
+  object.add_user(this, idx);
+  object.aggregate_create_info.flags |=
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+  object.aggregate_create_info.requiredFlags |=
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  object.aggregate_create_info.preferredFlags |=
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  object.allocate(this);
+  object.bind_users(this);
+  return true;
+}
+
+void ComputeGraph::plan_memory() {
+  // Ranges of execute node indices over which tensors hold data
+  using Lifetime = std::pair<size_t, size_t>;
+  const Lifetime whole_graph{0u, SIZE_MAX};
+
+  std::unordered_map<ValueRef, Lifetime> lifetimes;
+  for (const ValueRef idx : planned_tensors_) {
+    lifetimes[idx] = {SIZE_MAX, 0u};
+  }
+
+  const auto extend_lifetime = [&](const ValueRef idx, const size_t node_i) {
+    auto it = lifetimes.find(idx);
+    if (it != lifetimes.end()) {
+      it->second.first = std::min(it->second.first, node_i);
+      it->second.second = std::max(it->second.second, node_i);
+    }
+  };
+  for (size_t i = 0; i < execute_nodes_.size(); ++i) {
+    for (const ArgGroup& group : execute_nodes_[i]->args_) {
+      for (const ValueRef idx : group.refs) {
+        if (val_is_value_list(idx)) {
+          for (const ValueRef elem : values_.at(idx).toConstValueList()) {
+            extend_lifetime(elem, i);
+          }
+        } else {
+          extend_lifetime(idx, i);
+        }
+      }
+    }
+  }
+
+  // Tensors holding data across executions, and tensors not used by any
+  // execute node, which may be accessed from outside the graph, are not shared
+  for (const std::unique_ptr<PrepackNode>& node : prepack_nodes_) {
+    if (lifetimes.count(node->packed_) > 0) {
+      lifetimes[node->packed_] = whole_graph;
+    }
+  }
+  for (const std::vector<IOValueRef>* io_values : {&inputs_, &outputs_}) {
+    for (const IOValueRef& io_value : *io_values) {
+      if (lifetimes.count(io_value.value) > 0) {
+        lifetimes[io_value.value] = whole_graph;
+      }
+    }
+  }
+  for (auto& entry : lifetimes) {
+    if (entry.second.first > entry.second.second) {
+      entry.second = whole_graph;
+    }
+  }
+
+  // Place the largest tensors first, so that the smaller ones are packed into
+  // their memory
+  std::vector<std::pair<ValueRef, VkMemoryRequirements>> tensors;
+  tensors.reserve(planned_tensors_.size());
+  for (const ValueRef idx : planned_tensors_) {
+    tensors.emplace_back(idx, get_tensor(idx)->get_memory_requirements());
+  }
+  std::stable_sort(
+      tensors.begin(), tensors.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.size > rhs.second.size;
+      });
+
+  const size_t first_object = planned_objects_.size();
+  std::vector<std::vector<Lifetime>> object_lifetimes;
+  for (const auto& [idx, mem_reqs] : tensors) {
+    const Lifetime& lifetime = lifetimes.at(idx);
+    const VmaMemoryUsage usage =
+        get_tensor(idx)->get_allocation_create_info().usage;
+
+    // Find a memory object of the same kind whose users are all dead while
+    // this tensor is alive. Images and buffers may alias the same memory.
+    size_t object_i = 0;
+    for (; object_i < object_lifetimes.size(); ++object_i) {
+      const SharedObject& object = planned_objects_[first_object + object_i];
+      if (object.aggregate_create_info.usage != usage ||
+          object.aggregate_memory_requirements.memoryTypeBits !=
+              mem_reqs.memoryTypeBits) {
+        continue;
+      }
+      const bool overlaps = std::any_of(
+          object_lifetimes[object_i].begin(),
+          object_lifetimes[object_i].end(),
+          [&](const Lifetime& other) {
+            return lifetime.first <= other.second &&
+                other.first <= lifetime.second;
+          });
+      if (!overlaps) {
+        break;
+      }
+    }
+    if (object_i == object_lifetimes.size()) {
+      planned_objects_.emplace_back();
+      object_lifetimes.emplace_back();
+    }
+
+    planned_objects_[first_object + object_i].add_user(this, idx);
+    object_lifetimes[object_i].emplace_back(lifetime);
+  }
+  planned_tensors_.clear();
+
+  for (size_t i = first_object; i < planned_objects_.size(); ++i) {
+    planned_objects_[i].allocate(this);
+    planned_objects_[i].bind_users(this);
+  }
+}
+
 SharedObject& ComputeGraph::get_shared_object(const int64_t idx) {
   if (idx >= shared_objects_.size()) {
     shared_objects_.resize(static_cast<size_t>(idx + 1));
@@ -368,70 +597,204 @@ void ComputeGraph::copy_into_staging(
     const ValueRef idx,
     const void* data,
     const size_t numel) {
+  if (val_is_tensor(idx)) {
+    vTensorPtr t = get_tensor(idx);
+    copy_ptr_to_tensor(data, *t, numel * vkapi::element_size(t->dtype()));
+    return;
+  }
   StagingPtr staging = get_staging(idx);
   size_t nbytes = numel * vkapi::element_size(staging->dtype());
   copy_ptr_to_staging(data, *staging, nbytes);
 }
 
+void ComputeGraph::copy_into_staging(
+    const ValueRef idx,
+    const void* data,
+    const vkapi::ScalarType data_dtype,
+    const size_t numel) {
+  if (val_is_tensor(idx)) {
+    vTensorPtr t = get_tensor(idx);
+    copy_ptr_to_tensor(data, data_dtype, *t, numel);
+    return;
+  }
+  StagingPtr staging = get_staging(idx);
+  copy_ptr_to_staging(data, data_dtype, *staging, numel);
+}
+
 void ComputeGraph::copy_from_staging(
     const ValueRef idx,
     void* data,
     const size_t numel) {
+  if (val_is_tensor(idx)) {
+    vTensorPtr t = get_tensor(idx);
+    copy_tensor_to_ptr(*t, data, numel * vkapi::element_size(t->dtype()));
+    return;
+  }
   StagingPtr staging = get_staging(idx);
   size_t nbytes = numel * vkapi::element_size(staging->dtype());
   copy_staging_to_ptr(*staging, data, nbytes);
 }
 
+void ComputeGraph::copy_from_staging(
+    const ValueRef idx,
+    void* data,
+    const vkapi::ScalarType data_dtype,
+    const size_t numel) {
+  if (val_is_tensor(idx)) {
+    vTensorPtr t = get_tensor(idx);
+    copy_tensor_to_ptr(*t, data, data_dtype, numel);
+    return;
+  }
+  StagingPtr staging = get_staging(idx);
+  copy_staging_to_ptr(*staging, data, data_dtype, numel);
+}
+
+const vkapi::BufferBindInfo ComputeGraph::create_params_buffer(
+    const void* data,
+    const size_t nbytes) {
+  const VkDeviceSize alignment =
+      std::max<VkDeviceSize>(context_->adapter_ptr()->min_ubo_alignment(), 1u);
+  VkDeviceSize offset = utils::align_up(param_ubos_offset_, alignment);
+  if (param_ubos_.empty() ||
+      offset + nbytes > param_ubos_.back().mem_range()) {
+    param_ubos_.emplace_back(
+        context_->adapter_ptr()->vma().create_uniform_buffer(
+            std::max<VkDeviceSize>(kParamsBufferNbytes, nbytes)));
+    offset = 0u;
+  }
+  vkapi::VulkanBuffer& buffer = param_ubos_.back();
+  {
+    vkapi::MemoryMap mapping(buffer, vkapi::MemoryAccessType::WRITE);
+    memcpy(mapping.template data<uint8_t>() + offset, data, nbytes);
+  }
+  param_ubos_offset_ = offset + nbytes;
+  return vkapi::BufferBindInfo(buffer, offset, nbytes);
+}
+
 void ComputeGraph::prepare() {
-#define MERGE_FIELD(field)                    \
-  static_cast<uint32_t>(std::ceil(            \
-      std::max(                               \
-          execute_descriptor_counts_.field,   \
-          prepack_descriptor_counts_.field) * \
-      config_.descriptor_pool_safety_factor))
-
-  uint32_t max_sets = MERGE_FIELD(descriptor_pool_max_sets);
-  vkapi::DescriptorPoolConfig config{
-      max_sets,
-      std::max(MERGE_FIELD(descriptor_uniform_buffer_count), max_sets),
-      std::max(MERGE_FIELD(descriptor_storage_buffer_count), max_sets),
-      std::max(MERGE_FIELD(descriptor_combined_sampler_count), max_sets),
-      std::max(MERGE_FIELD(descriptor_storage_image_count), max_sets),
-      1u,
+  // Packed weights are written by prepacking, so memory must be assigned
+  // before encode_prepack()
+  plan_memory();
+
+  // Execute nodes allocate their descriptor sets from a pool of the graph, so
+  // the descriptor pool of the context only holds those of prepacking
+#define SCALE_FIELD(counts, field) \
+  static_cast<uint32_t>(           \
+      std::ceil(counts.field * config_.descriptor_pool_safety_factor))
+
+  auto create_pool_config = [&](const vkapi::DescriptorPoolConfig& counts) {
+    const uint32_t max_sets =
+        std::max(SCALE_FIELD(counts, descriptor_pool_max_sets), 1u);
+    return vkapi::DescriptorPoolConfig{
+        max_sets,
+        std::max(
+            SCALE_FIELD(counts, descriptor_uniform_buffer_count), max_sets),
+        std::max(
+            SCALE_FIELD(counts, descriptor_storage_buffer_count), max_sets),
+        std::max(
+            SCALE_FIELD(counts, descriptor_combined_sampler_count), max_sets),
+        std::max(SCALE_FIELD(counts, descriptor_storage_image_count), max_sets),
+        1u,
+    };
   };
+#undef SCALE_FIELD
 
   if (!context_->descriptor_pool()) {
-    context_->descriptor_pool().init(config);
+    context_->descriptor_pool().init(
+        create_pool_config(prepack_descriptor_counts_));
+  }
+  if (!execute_descriptor_pool_) {
+    execute_descriptor_pool_ = std::make_unique<vkapi::DescriptorPool>(
+        context_->device(), create_pool_config(execute_descriptor_counts_));
   }
-#undef MERGE_FIELD
 
   if (config_.enable_querypool) {
     context_->initialize_querypool();
   }
 }
 
+void ComputeGraph::retain_prepack_staging(api::StorageBuffer& staging) {
+  prepack_staging_nbytes_ += staging.nbytes();
+  prepack_staging_.emplace_back(std::move(staging.buffer()));
+}
+
 void ComputeGraph::encode_prepack() {
   for (std::unique_ptr<PrepackNode>& node : prepack_nodes_) {
     node->encode(this);
+
+    if (config_.prepack_threshold_nbytes > 0 &&
+        prepack_staging_nbytes_ >= config_.prepack_threshold_nbytes) {
+      submit_prepack_batch();
+    }
   }
 }
 
-void ComputeGraph::prepack() const {
+void ComputeGraph::submit_prepack_batch() {
+  // Wait for the previous batch before submitting this one, so that its
+  // staging buffers can be freed while the GPU packs this batch
+  prepack_fence_.wait();
+  submitted_prepack_staging_.clear();
+
+  if (!prepack_fence_) {
+    prepack_fence_ = context_->fences().get_fence();
+  }
+  context_->submit_cmd_to_gpu(
+      prepack_fence_.get_submit_handle(), /*final_use = */ true);
+
+  submitted_prepack_staging_ = std::move(prepack_staging_);
+  prepack_staging_.clear();
+  prepack_staging_nbytes_ = 0u;
+
+  // Record the remaining prepacking commands in a new command buffer
+  context_->set_cmd();
+}
+
+void ComputeGraph::prepack() {
+  if (config_.defer_prepack_submit) {
+    context_->batch_cmd(/*final_use = */ true);
+    prepack_submit_deferred_ = context_->has_batched_cmds();
+    return;
+  }
+
   // Submit and execute the command buffer
   vkapi::VulkanFence fence = context_->fences().get_fence();
   context_->submit_cmd_to_gpu(fence.get_submit_handle(), /*final_use = */ true);
   fence.wait();
+  release_prepack_staging();
 
   context_->flush();
 }
 
+void ComputeGraph::release_prepack_staging() {
+  // Batches execute in submission order, so the last batch submitted by
+  // encode_prepack() has completed as well.
+  prepack_fence_.wait();
+
+  prepack_staging_.clear();
+  prepack_staging_nbytes_ = 0u;
+  submitted_prepack_staging_.clear();
+  prepack_submit_deferred_ = false;
+}
+
 void ComputeGraph::encode_execute() {
-  context_->flush();
+  // The descriptor sets and command buffer of deferred prepacking commands
+  // must stay valid until they are submitted by the first execution. If the
+  // graph is encoded again before that, flush() submits them instead.
+  if (!prepack_submit_deferred_ || context_->has_cmd()) {
+    context_->flush();
+  }
+  if (prepack_submit_deferred_ && !context_->has_batched_cmds()) {
+    release_prepack_staging();
+  }
   context_->set_cmd(/*reusable = */ true);
 
   context_->cmd_reset_querypool();
 
   for (SharedObject& shared_object : shared_objects_) {
+    // The graph may be encoded more than once
+    if (shared_object.allocation) {
+      continue;
+    }
     shared_object.allocate(this);
     shared_object.bind_users(this);
   }
@@ -441,10 +804,32 @@ void ComputeGraph::encode_execute() {
   }
 }
 
-void ComputeGraph::execute() const {
-  vkapi::VulkanFence fence = context_->fences().get_fence();
-  context_->submit_cmd_to_gpu(fence.get_submit_handle());
-  fence.wait();
+void ComputeGraph::execute() {
+  execute_async();
+  wait_for_execute();
+}
+
+void ComputeGraph::execute_async() {
+  wait_for_execute();
+
+  if (context_->timeline()) {
+    execute_timeline_value_ = context_->submit_cmd_to_gpu();
+  } else {
+    if (!execute_fence_) {
+      execute_fence_ = context_->fences().get_fence();
+    }
+    context_->submit_cmd_to_gpu(execute_fence_.get_submit_handle());
+  }
+}
+
+void ComputeGraph::wait_for_execute() {
+  context_->timeline().wait(execute_timeline_value_);
+  execute_fence_.wait();
+
+  // The deferred prepacking commands are submitted with the first execution
+  if (prepack_submit_deferred_ && !context_->has_batched_cmds()) {
+    release_prepack_staging();
+  }
 }
 
 void ComputeGraph::resize_input(
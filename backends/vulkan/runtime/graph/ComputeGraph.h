@@ -63,6 +63,7 @@ DECL_VALUE_PTR_CLASS(IntListPtr, std::vector<int64_t>)
 DECL_VALUE_PTR_CLASS(DoubleListPtr, std::vector<double>)
 DECL_VALUE_PTR_CLASS(BoolListPtr, std::vector<bool>)
 DECL_VALUE_PTR_CLASS(ValueListPtr, std::vector<ValueRef>)
+DECL_VALUE_PTR_CLASS(SymIntPtr, SymInt)
 
 #undef DECL_VALUE_PTR_CLASS
 
@@ -94,8 +95,18 @@ class ComputeGraph final {
 
   std::unique_ptr<api::Context> context_;
   std::vector<SharedObject> shared_objects_;
+  // Tensors whose memory will be assigned by plan_memory(), and the memory
+  // objects created for them
+  std::vector<ValueRef> planned_tensors_;
+  std::vector<SharedObject> planned_objects_;
   std::vector<Value> values_;
-  std::vector<api::ParamsBuffer> param_ubos_;
+  // Uniform buffers that the params created by create_params_buffer() are
+  // packed into, and the offset of the first free byte of the last one
+  std::vector<vkapi::VulkanBuffer> param_ubos_;
+  VkDeviceSize param_ubos_offset_;
+  // Descriptor sets of the execute nodes, which keep them across encodings
+  // of the graph, see ExecuteNode::encode()
+  std::unique_ptr<vkapi::DescriptorPool> execute_descriptor_pool_;
 
   std::vector<std::unique_ptr<PrepackNode>> prepack_nodes_;
   std::vector<std::unique_ptr<ExecuteNode>> execute_nodes_;
@@ -103,6 +114,21 @@ class ComputeGraph final {
   std::vector<IOValueRef> inputs_;
   std::vector<IOValueRef> outputs_;
 
+  // Staging buffers of the prepacking commands being recorded, and of the
+  // batch of prepacking commands last submitted to the GPU
+  std::vector<vkapi::VulkanBuffer> prepack_staging_;
+  size_t prepack_staging_nbytes_;
+  std::vector<vkapi::VulkanBuffer> submitted_prepack_staging_;
+  vkapi::VulkanFence prepack_fence_;
+  // Whether the last batch of prepacking commands will be submitted with the
+  // next execution, see GraphConfig::defer_prepack_submit
+  bool prepack_submit_deferred_;
+
+  // Signaled when the last submitted execution completes. The timeline value
+  // is used if the device supports timeline semaphores, the fence otherwise.
+  uint64_t execute_timeline_value_;
+  vkapi::VulkanFence execute_fence_;
+
  protected:
   size_t values_in_use_ = 0;
 
@@ -154,6 +180,7 @@ class ComputeGraph final {
   GET_AND_CHECK_VAL_AS_PTR_TYPE_FNS(DoubleListPtr, double_list, DoubleList)
   GET_AND_CHECK_VAL_AS_PTR_TYPE_FNS(BoolListPtr, bool_list, BoolList)
   GET_AND_CHECK_VAL_AS_PTR_TYPE_FNS(ValueListPtr, value_list, ValueList)
+  GET_AND_CHECK_VAL_AS_PTR_TYPE_FNS(SymIntPtr, symint, SymInt)
 
 #undef GET_AND_CHECK_VAL_AS_PTR_TYPE_FNS
 
@@ -244,6 +271,10 @@ class ComputeGraph final {
     if (value.isBool()) {
       return static_cast<T>(value.toBool());
     }
+    // The value of a SymInt at the time of the call
+    if (value.isSymInt()) {
+      return static_cast<T>(value.toConstSymInt().value);
+    }
     VK_THROW("Cannot extract scalar from Value with type ", value.type());
   }
 
@@ -285,6 +316,13 @@ class ComputeGraph final {
   utils::GPUMemoryLayout suggested_memory_layout(
       const std::vector<int64_t>& sizes);
 
+  /*
+   * Returns the dtype that tensors of the given dtype are stored with, which is
+   * kHalf instead of kFloat if GraphConfig::enable_fp16 is set and the device
+   * supports 16 bit storage buffers and shaderFloat16.
+   */
+  vkapi::ScalarType stored_dtype(const vkapi::ScalarType dtype);
+
   //
   // Graph Building
   //
@@ -292,6 +330,29 @@ class ComputeGraph final {
  private:
   void check_no_active_value_ptrs();
 
+  /*
+   * Binds memory of its own to a tensor whose memory was to be planned.
+   */
+  void allocate_planned_tensor(const ValueRef idx);
+
+  /*
+   * If GraphConfig::enable_host_visible_io is set and the device has memory
+   * that is both device local and host visible, binds such memory to a buffer
+   * backed input or output tensor whose memory was to be planned, so that the
+   * CPU can read and write its data directly. Only applies to tensors whose
+   * buffer holds the data in the same order as a staging buffer would. Returns
+   * whether the memory was bound.
+   */
+  bool bind_host_visible_memory(const ValueRef idx);
+
+  /*
+   * Assigns memory to the tensors in planned_tensors_. Tensors used by
+   * execute nodes whose ranges don't overlap share memory. Tensors that must
+   * keep their data across executions, i.e. the packed weights and the graph
+   * inputs and outputs, get memory of their own.
+   */
+  void plan_memory();
+
  public:
   /*
    * Add a `api::vTensor` value to the graph with the specified properties.
@@ -393,13 +454,48 @@ class ComputeGraph final {
 
   ValueRef add_string(std::string&& str);
 
+  ValueRef add_symint(const int32_t val);
+
   ValueRef set_input_tensor(const ValueRef idx, const bool use_staging = true);
   ValueRef set_output_tensor(const ValueRef idx, const bool use_staging = true);
 
+  /*
+   * Marks a non-tensor value, i.e. a SymInt, as an input of the graph. Its
+   * value is set with set_symint() before each execution.
+   */
+  void set_val_as_input(const ValueRef idx);
+
+  void set_symint(const ValueRef idx, const int32_t val);
+
+  int32_t read_symint(const ValueRef idx);
+
+  inline vkapi::BufferBindInfo symint_ubo(const ValueRef idx) {
+    return vkapi::BufferBindInfo(get_symint(idx)->gpu_symint.buffer());
+  }
+
+  /*
+   * Params are packed into a few uniform buffers owned by the graph instead of
+   * each getting a buffer of its own, and cannot be updated once created.
+   */
   template <typename Block>
   const vkapi::BufferBindInfo create_params_buffer(const Block& data) {
-    param_ubos_.emplace_back(api::ParamsBuffer(context_.get(), data));
-    return vkapi::BufferBindInfo(param_ubos_.back().buffer());
+    return create_params_buffer(&data, sizeof(Block));
+  }
+
+  const vkapi::BufferBindInfo create_params_buffer(
+      const void* data,
+      const size_t nbytes);
+
+  /*
+   * The descriptor pool that execute nodes allocate their descriptor sets
+   * from. Unlike the descriptor pool of the context, it is not reset when the
+   * graph is encoded again. Initialized by prepare().
+   */
+  inline vkapi::DescriptorPool& execute_descriptor_pool() {
+    VK_CHECK_COND(
+        execute_descriptor_pool_,
+        "prepare() must be called before encoding the graph");
+    return *execute_descriptor_pool_;
   }
 
   /*
@@ -495,23 +591,76 @@ class ComputeGraph final {
   // Input/Output
   //
 
+  /*
+   * idx is the staging buffer returned by set_input_tensor() or
+   * set_output_tensor(), which may be the tensor itself if it is bound to host
+   * visible memory.
+   */
   void
   copy_into_staging(const ValueRef idx, const void* data, const size_t numel);
   void copy_from_staging(const ValueRef idx, void* data, const size_t numel);
 
+  /*
+   * Same as above, but data holds elements of data_dtype, which are converted
+   * if the graph stores the tensor with another dtype, e.g. float data of a
+   * tensor stored as half because GraphConfig::enable_fp16 is set.
+   */
+  void copy_into_staging(
+      const ValueRef idx,
+      const void* data,
+      const vkapi::ScalarType data_dtype,
+      const size_t numel);
+  void copy_from_staging(
+      const ValueRef idx,
+      void* data,
+      const vkapi::ScalarType data_dtype,
+      const size_t numel);
+
   //
   // Graph Prepacking
   //
 
+  /*
+   * Keeps the staging buffer of a prepacking command alive until the GPU has
+   * executed the command.
+   */
+  void retain_prepack_staging(api::StorageBuffer& staging);
+
   void encode_prepack();
-  void prepack() const;
+  void prepack();
+
+ private:
+  void submit_prepack_batch();
+  void release_prepack_staging();
+
+ public:
 
   //
   // Graph Execution
   //
 
   void encode_execute();
-  void execute() const;
+  void execute();
+
+  /*
+   * Submits the encoded graph to the GPU and returns without waiting for it
+   * to complete, so that the CPU can do other work in the meantime, e.g.
+   * prepare the inputs of the next inference. wait_for_execute() must be
+   * called before the outputs are read or the inputs are written, since every
+   * execution uses the same staging buffers. If a previous execution is still
+   * in flight, waits for it first, since every execution also uses the same
+   * command buffer.
+   */
+  void execute_async();
+  void wait_for_execute();
+
+  /*
+   * If local work group size tuning is enabled, picks the local work group
+   * size of every execute node by executing the graph with each candidate size
+   * and comparing the shader timestamps, then encodes the graph again. Must be
+   * called after encode_execute(). Implemented in Tuning.cpp.
+   */
+  void tune_local_wg_sizes();
 
   //
   // Dynamic Shape support
@@ -531,6 +680,14 @@ class ComputeGraph final {
     return context_->adapter_ptr()->has_full_int8_buffers_support();
   }
 
+  /*
+   * Check whether compute shaders can use subgroup arithmetic and ballot
+   * operations.
+   */
+  inline bool subgroup_reductions_enabled() const {
+    return context_->adapter_ptr()->has_subgroup_reductions();
+  }
+
   //
   // Debug support (implemented in Logging.cpp)
   //
@@ -61,8 +61,23 @@ GraphConfig::GraphConfig() {
   // dispatches. By default, this functionality is disabled.
   enable_querypool = false;
 
+  enable_memory_planning = false;
+
+  enable_indirect_dispatch = false;
+
+  enable_host_visible_io = false;
+
+  prepack_threshold_nbytes = 16 * 1024 * 1024;
+
+  defer_prepack_submit = false;
+
+  enable_fp16 = false;
+
   enable_local_wg_size_override = false;
   local_wg_size_override = {};
+
+  enable_local_wg_size_tuning = false;
+  local_wg_size_tuning_path = "";
 }
 
 void GraphConfig::set_storage_type_override(utils::StorageType storage_type) {
@@ -30,9 +30,56 @@ struct GraphConfig final {
 
   bool enable_querypool;
 
+  // If set, tensors that are not assigned a shared object are not given memory
+  // of their own when they are added. Instead, prepare() computes the lifetime
+  // of every such tensor from the order of the execute nodes, and packs the
+  // tensors whose lifetimes don't overlap into the same memory.
+  bool enable_memory_planning;
+
+  // If set, nodes that can be resized and whose global work group size is the
+  // extents of their output are dispatched indirectly. Resizing the graph then
+  // shrinks or grows their dispatches without recording the command buffer
+  // again, instead of always dispatching for the largest sizes.
+  bool enable_indirect_dispatch;
+
+  // If set, and the device has memory that is both device local and host
+  // visible, buffer backed inputs and outputs whose memory is planned are
+  // bound to such memory instead of being copied through staging buffers.
+  // copy_into_staging() and copy_from_staging() then access them directly.
+  bool enable_host_visible_io;
+
+  // Prepacking commands are submitted to the GPU in batches whose staging
+  // buffers hold at least this many bytes, so that the CPU fills the staging
+  // buffers of the next batch while the GPU packs the current one, and only
+  // two batches of staging buffers are alive at a time. If 0, all prepacking
+  // commands are submitted at once.
+  size_t prepack_threshold_nbytes;
+
+  // If set, prepack() does not submit the last batch of prepacking commands
+  // and wait for it. The batch is submitted together with the first execution
+  // of the graph in a single queue submission instead, and its staging
+  // buffers are kept alive until that execution has completed.
+  bool defer_prepack_submit;
+
+  // If set, float tensors, including packed weights, are stored as half
+  // precision so that they take half the GPU memory and bandwidth, and their
+  // ops run the half variants of their shaders, which compute in float16_t
+  // where they operate on buffers. Tensors stay float if the device does not
+  // support both 16 bit storage buffers and shaderFloat16. Inputs, outputs and
+  // weights are still provided as float, and are converted when copied
+  // through staging buffers.
+  bool enable_fp16;
+
   bool enable_local_wg_size_override;
   utils::uvec3 local_wg_size_override;
 
+  // If set, ComputeGraph::tune_local_wg_sizes() times candidate local work
+  // group sizes for every execute node and keeps the fastest one. If the path
+  // is not empty, the results are stored in that file, keyed by device,
+  // shader and global work group size, and reused by later graphs.
+  bool enable_local_wg_size_tuning;
+  std::string local_wg_size_tuning_path;
+
   // Generate a default graph config with pre-configured settings
   explicit GraphConfig();
 
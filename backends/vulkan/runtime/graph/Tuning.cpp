@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/vulkan/runtime/graph/ComputeGraph.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+#include <unordered_map>
+
+namespace vkcompute {
+
+namespace {
+
+// Local work group sizes that are tried for every node, besides the one the
+// node was created with. All of them are within the limits guaranteed by the
+// Vulkan spec, i.e. at most 128 invocations and at most 64 along z.
+const utils::uvec3 kCandidateLocalWgSizes[] = {
+    {64u, 1u, 1u},
+    {128u, 1u, 1u},
+    {32u, 2u, 1u},
+    {16u, 4u, 1u},
+    {8u, 8u, 1u},
+    {4u, 16u, 1u},
+    {16u, 8u, 1u},
+    {8u, 4u, 2u},
+    {4u, 4u, 4u},
+    {8u, 8u, 2u},
+};
+
+// Maps "<device>/<driver version>/<shader>/<global wg size>" to the fastest
+// local work group size.
+using TuningCache = std::unordered_map<std::string, utils::uvec3>;
+
+std::string uvec3_to_string(const utils::uvec3& v) {
+  return std::to_string(v[0u]) + "," + std::to_string(v[1u]) + "," +
+      std::to_string(v[2u]);
+}
+
+// Each line of the file holds a key and a local work group size, separated by
+// a tab. Malformed lines are ignored.
+TuningCache load_tuning_cache(const std::string& path) {
+  TuningCache cache;
+  if (path.empty()) {
+    return cache;
+  }
+
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    const size_t sep = line.rfind('\t');
+    if (sep == std::string::npos) {
+      continue;
+    }
+    unsigned int x = 0u, y = 0u, z = 0u;
+    if (std::sscanf(line.c_str() + sep + 1, "%u,%u,%u", &x, &y, &z) != 3 ||
+        x == 0u || y == 0u || z == 0u) {
+      continue;
+    }
+    cache[line.substr(0, sep)] = {x, y, z};
+  }
+  return cache;
+}
+
+void save_tuning_cache(const std::string& path, const TuningCache& cache) {
+  if (path.empty()) {
+    return;
+  }
+
+  // Write to a temporary file and rename it, so that readers never see a
+  // partially written file
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    for (const auto& entry : cache) {
+      file << entry.first << '\t' << uvec3_to_string(entry.second) << '\n';
+    }
+    if (file.fail()) {
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+} // namespace
+
+void ComputeGraph::tune_local_wg_sizes() {
+  if (!config_.enable_local_wg_size_tuning ||
+      config_.enable_local_wg_size_override || execute_nodes_.empty()) {
+    return;
+  }
+
+  vkapi::Adapter* const adapter = context_->adapter_ptr();
+  // Every dispatch writes two timestamps
+  if (!adapter->timestamp_compute_and_graphics() ||
+      execute_nodes_.size() * 2 >
+          config_.context_config.query_pool_config.max_query_count) {
+    return;
+  }
+
+  const std::string device_key = adapter->device_name() + "/" +
+      std::to_string(adapter->driver_version()) + "/";
+
+  TuningCache cache = load_tuning_cache(config_.local_wg_size_tuning_path);
+
+  // Apply the stored results, and collect the nodes that need to be timed
+  std::vector<std::string> keys(execute_nodes_.size());
+  std::vector<size_t> untuned_nodes;
+  for (size_t i = 0; i < execute_nodes_.size(); ++i) {
+    const ExecuteNode& node = *execute_nodes_[i];
+    keys[i] = device_key + node.shader_.kernel_name + "/" +
+        uvec3_to_string(node.global_workgroup_size_);
+
+    auto it = cache.find(keys[i]);
+    if (it != cache.end()) {
+      execute_nodes_[i]->set_local_workgroup_size(it->second);
+    } else {
+      untuned_nodes.push_back(i);
+    }
+  }
+
+  if (!untuned_nodes.empty()) {
+    const bool had_querypool = static_cast<bool>(context_->querypool());
+    context_->initialize_querypool();
+
+    std::vector<utils::uvec3> initial_sizes(execute_nodes_.size());
+    std::vector<utils::uvec3> best_sizes(execute_nodes_.size());
+    std::vector<uint64_t> best_times(execute_nodes_.size(), UINT64_MAX);
+    for (const size_t i : untuned_nodes) {
+      initial_sizes[i] = execute_nodes_[i]->local_workgroup_size_;
+      best_sizes[i] = initial_sizes[i];
+    }
+
+    // Candidate 0 is the local work group size each node was created with
+    const size_t num_candidates = 1 + std::size(kCandidateLocalWgSizes);
+    for (size_t c = 0; c < num_candidates; ++c) {
+      for (const size_t i : untuned_nodes) {
+        execute_nodes_[i]->set_local_workgroup_size(
+            c == 0 ? initial_sizes[i] : kCandidateLocalWgSizes[c - 1]);
+      }
+
+      encode_execute();
+      // The first execution warms up the caches and the GPU clocks
+      execute();
+      execute();
+
+      context_->querypool().extract_results();
+      const auto timestamps = context_->querypool().get_shader_timestamp_data();
+      // Every execute node records exactly one dispatch, in order
+      if (timestamps.size() != execute_nodes_.size()) {
+        continue;
+      }
+      for (const size_t i : untuned_nodes) {
+        const uint64_t start_ns = std::get<2>(timestamps[i]);
+        const uint64_t end_ns = std::get<3>(timestamps[i]);
+        const uint64_t duration_ns = end_ns > start_ns ? end_ns - start_ns : 0u;
+        if (duration_ns < best_times[i]) {
+          best_times[i] = duration_ns;
+          best_sizes[i] = execute_nodes_[i]->local_workgroup_size_;
+        }
+      }
+    }
+
+    for (const size_t i : untuned_nodes) {
+      execute_nodes_[i]->set_local_workgroup_size(best_sizes[i]);
+      cache[keys[i]] = best_sizes[i];
+    }
+
+    // Timestamps are only kept in the final encoding if profiling was
+    // requested
+    if (!had_querypool) {
+      context_->querypool().deinitialize();
+    }
+
+    save_tuning_cache(config_.local_wg_size_tuning_path, cache);
+  }
+
+  encode_execute();
+}
+
+} // namespace vkcompute
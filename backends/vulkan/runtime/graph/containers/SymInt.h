@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/backends/vulkan/runtime/api/Context.h>
+#include <executorch/backends/vulkan/runtime/api/containers/ParamsBuffer.h>
+
+namespace vkcompute {
+
+/*
+ * Represents a symbolic integer whose value can change between executions of
+ * the graph, such as the position of the current token in an LLM. The value
+ * is kept in a uniform buffer so that shaders can read it without the command
+ * buffer having to be re-encoded when it changes.
+ */
+struct SymInt final {
+  int32_t value;
+  api::ParamsBuffer gpu_symint;
+
+  explicit SymInt(api::Context* context_p, const int32_t val);
+
+  void set(const int32_t val);
+};
+
+} // namespace vkcompute
@@ -14,6 +14,33 @@
 
 namespace vkcompute {
 
+namespace {
+
+// Returns the first tensor written by a node if the global work group size of
+// the node is the one ComputeGraph::create_global_wg_size() creates for it.
+ValueRef get_dispatch_ref(
+    ComputeGraph& graph,
+    const std::vector<ArgGroup>& args,
+    const utils::uvec3& global_workgroup_size) {
+  for (const ArgGroup& group : args) {
+    if (!(group.access & vkapi::MemoryAccessType::WRITE) ||
+        group.refs.empty() || !graph.val_is_tensor(group.refs[0])) {
+      continue;
+    }
+    const utils::uvec3 out_wg_size =
+        graph.create_global_wg_size(group.refs[0]);
+    if (out_wg_size[0u] == global_workgroup_size[0u] &&
+        out_wg_size[1u] == global_workgroup_size[1u] &&
+        out_wg_size[2u] == global_workgroup_size[2u]) {
+      return group.refs[0];
+    }
+    break;
+  }
+  return kDummyValueRef;
+}
+
+} // namespace
+
 ExecuteNode::ExecuteNode(
     ComputeGraph& graph,
     const vkapi::ShaderInfo& shader,
@@ -31,8 +58,16 @@ ExecuteNode::ExecuteNode(
       params_(params),
       spec_vars_(spec_vars),
       resize_fn_(resize_fn),
-      resize_args_(resize_args) {
+      resize_args_(resize_args),
+      dispatch_ref_(kDummyValueRef),
+      dispatch_buffer_{},
+      descriptor_set_{} {
   graph.update_descriptor_counts(shader, /*execute = */ true);
+
+  // Only nodes that can be resized benefit from indirect dispatch
+  if (graph.graphconfig().enable_indirect_dispatch && resize_fn_ != nullptr) {
+    dispatch_ref_ = get_dispatch_ref(graph, args_, global_workgroup_size_);
+  }
 }
 
 void ExecuteNode::encode(ComputeGraph* graph) {
@@ -47,8 +82,13 @@ void ExecuteNode::encode(ComputeGraph* graph) {
       local_workgroup_size_,
       node_id_);
 
-  vkapi::DescriptorSet descriptor_set =
-      context->get_descriptor_set(shader_, local_workgroup_size_, spec_vars_);
+  VkDescriptorSetLayout shader_layout =
+      context->bind_pipeline(shader_, local_workgroup_size_, spec_vars_);
+  if (!descriptor_set_) {
+    descriptor_set_.emplace(graph->execute_descriptor_pool().get_descriptor_set(
+        shader_layout, shader_.kernel_layout));
+  }
+  vkapi::DescriptorSet& descriptor_set = *descriptor_set_;
 
   uint32_t idx = 0;
   idx = bind_values_to_descriptor_set(
@@ -56,10 +96,51 @@ void ExecuteNode::encode(ComputeGraph* graph) {
 
   bind_params_to_descriptor_set(params_, descriptor_set, idx);
 
-  context->register_shader_dispatch(
-      descriptor_set, pipeline_barrier, shader_, global_workgroup_size_);
+  if (dispatch_ref_ != kDummyValueRef) {
+    if (!dispatch_buffer_) {
+      dispatch_buffer_ = context->adapter_ptr()->vma().create_indirect_buffer(
+          sizeof(VkDispatchIndirectCommand));
+    }
+    // The local work group size may have changed since the last encoding
+    update_dispatch_buffer(graph);
+    context->register_shader_dispatch_indirect(
+        descriptor_set, pipeline_barrier, dispatch_buffer_);
+  } else {
+    context->register_shader_dispatch(
+        descriptor_set, pipeline_barrier, shader_, global_workgroup_size_);
+  }
 
   context->report_shader_dispatch_end();
 }
 
+void ExecuteNode::update_dispatch_buffer(ComputeGraph* graph) {
+  if (!dispatch_buffer_) {
+    return;
+  }
+
+  // Textures are bounded by the extents of the current sizes of the tensor,
+  // which are at most the extents the node was created with
+  utils::uvec3 global_wg_size;
+  if (graph->is_buffer_storage(dispatch_ref_)) {
+    global_wg_size = {uint32_t(graph->numel_of(dispatch_ref_)), 1u, 1u};
+  } else {
+    const utils::ivec3 limits =
+        graph->get_tensor(dispatch_ref_)->texture_limits();
+    global_wg_size = {
+        utils::safe_downcast<uint32_t>(limits[0u]),
+        utils::safe_downcast<uint32_t>(limits[1u]),
+        utils::safe_downcast<uint32_t>(limits[2u])};
+  }
+
+  const utils::uvec3 dispatch_size = api::Context::get_dispatch_size(
+      shader_, global_wg_size, local_workgroup_size_);
+
+  vkapi::MemoryMap mapping(dispatch_buffer_, vkapi::MemoryAccessType::WRITE);
+  VkDispatchIndirectCommand* command =
+      mapping.data<VkDispatchIndirectCommand>();
+  command->x = dispatch_size[0u];
+  command->y = dispatch_size[1u];
+  command->z = dispatch_size[2u];
+}
+
 } // namespace vkcompute
@@ -12,6 +12,8 @@
 
 #include <executorch/backends/vulkan/runtime/graph/containers/Value.h>
 
+#include <optional>
+
 namespace vkcompute {
 
 class ComputeGraph;
@@ -66,6 +68,7 @@ class ExecuteNode final {
   inline void trigger_resize(ComputeGraph* graph) {
     if (resize_fn_ != nullptr) {
       resize_fn_(graph, args_, resize_args_);
+      update_dispatch_buffer(graph);
     }
   }
 
@@ -73,16 +76,38 @@ class ExecuteNode final {
     node_id_ = node_id;
   }
 
+  /*
+   * Changes the local work group size of the node. Takes effect the next time
+   * the graph is encoded.
+   */
+  inline void set_local_workgroup_size(const utils::uvec3& local_wg_size) {
+    local_workgroup_size_ = local_wg_size;
+  }
+
  protected:
   uint32_t node_id_;
   const vkapi::ShaderInfo shader_;
   const utils::uvec3 global_workgroup_size_;
-  const utils::uvec3 local_workgroup_size_;
+  utils::uvec3 local_workgroup_size_;
   const std::vector<ArgGroup> args_;
   const vkapi::ParamsBindList params_;
   const vkapi::SpecVarList spec_vars_;
   const ResizeFunction resize_fn_;
   const std::vector<ValueRef> resize_args_;
+
+  // If not kDummyValueRef, the node is dispatched indirectly and its global
+  // work group size follows the current sizes of this tensor, so that resizes
+  // change the work group counts in dispatch_buffer_ instead of requiring the
+  // command buffer to be recorded again.
+  ValueRef dispatch_ref_;
+  vkapi::VulkanBuffer dispatch_buffer_;
+
+  // Allocated from ComputeGraph::execute_descriptor_pool() the first time the
+  // node is encoded, and only written again by later encodings
+  std::optional<vkapi::DescriptorSet> descriptor_set_;
+
+ private:
+  void update_dispatch_buffer(ComputeGraph* graph);
 };
 
 } // namespace vkcompute
@@ -60,9 +60,14 @@ api::StorageBuffer PrepackNode::create_staging_buffer(ComputeGraph* graph) {
 
   TensorRefPtr tref = graph->get_tref(tref_);
   size_t numel = utils::multiply_integers(tref->sizes);
-  api::StorageBuffer staging(graph->context(), tref->dtype, numel);
-  size_t nbytes = numel * vkapi::element_size(tref->dtype);
-  copy_ptr_to_staging(tref->data, staging, nbytes);
+  // The packed tensor may store float weights as half, see
+  // GraphConfig::enable_fp16, in which case they are converted when staged.
+  const vkapi::ScalarType staging_dtype =
+      tref->dtype == vkapi::kFloat && packed->dtype() == vkapi::kHalf
+      ? vkapi::kHalf
+      : tref->dtype;
+  api::StorageBuffer staging(graph->context(), staging_dtype, numel);
+  copy_ptr_to_staging(tref->data, tref->dtype, staging, numel);
   return staging;
 }
 
@@ -112,6 +117,8 @@ void PrepackNode::encode(ComputeGraph* graph) {
     context->register_shader_dispatch(
         descriptor_set, pipeline_barrier, noop_shader_, {1, 1, 1});
   }
+
+  graph->retain_prepack_staging(staging);
 }
 
 } // namespace vkcompute
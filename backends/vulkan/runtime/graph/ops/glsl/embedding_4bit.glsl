@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_type(DTYPE)}
+
+${define_required_extensions(DTYPE)}
+
+layout(std430) buffer;
+
+#include "indexing_utils.h"
+
+${layout_declare_tensor(0, "w", "t_out", DTYPE, "texture3d")}
+${layout_declare_tensor(1, "r", "t_indices", "int", "texture3d")}
+${layout_declare_tensor(2, "r", "t_weight", "int", "buffer")}
+${layout_declare_tensor(3, "r", "t_scales", DTYPE, "buffer")}
+${layout_declare_tensor(4, "r", "t_zeros", DTYPE, "buffer")}
+${layout_declare_ubo(5, "ivec4", "out_sizes")}
+${layout_declare_ubo(6, "ivec4", "indices_sizes")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+layout(constant_id = 3) const int out_packed_dim = C_DIM;
+layout(constant_id = 4) const int indices_packed_dim = C_DIM;
+layout(constant_id = 5) const int group_size = 32;
+layout(constant_id = 6) const bool has_zeros = false;
+
+/*
+ * Looks up rows of a [V, D] int4 embedding table, quantized group-wise along D
+ * with a scale and an optional zero point per group:
+ *
+ *   weight[v][d] = (q[v][d] - 8 - zeros[v][g]) * scales[v][g]
+ *
+ * The table is stored in a buffer, since the height of a texture would limit
+ * V, with each int holding 8 consecutive values of a row. Two values are
+ * packed in every byte, the even one in the high nibble.
+ */
+void main() {
+  const ivec3 out_pos = ivec3(gl_GlobalInvocationID);
+
+  if (pos_out_of_bounds(out_pos, out_sizes, out_packed_dim)) {
+    return;
+  }
+
+  const ivec4 out_idx = to_tensor_idx(out_pos, out_sizes, out_packed_dim);
+  const int num_groups = out_sizes.x / group_size;
+
+  VEC4_T out_texel = VEC4_T(0);
+  for (int i = 0; i < 4; ++i) {
+    ivec4 idx = out_idx;
+    idx[out_packed_dim] += i;
+    if (idx[out_packed_dim] >= out_sizes[out_packed_dim]) {
+      break;
+    }
+
+    // The output has one more dim than the indices, i.e. the embedding dim
+    const ivec4 in_elem_pos = to_texture_elem_pos(
+        ivec4(idx.yzw, 0), indices_sizes, indices_packed_dim);
+    const int token = texelFetch(t_indices, in_elem_pos.xyz, 0)[in_elem_pos.w];
+
+    const int elem = token * out_sizes.x + idx.x;
+    const int q = t_weight[elem / 8];
+    // Byte (elem % 8) / 2 of q, the high nibble for even elements
+    const int shift = (elem % 8 / 2) * 8 + (1 - elem % 2) * 4;
+
+    const int group_idx = token * num_groups + idx.x / group_size;
+    float zero = 8.0;
+    if (has_zeros) {
+      zero += float(t_zeros[group_idx]);
+    }
+    out_texel[i] =
+        (float((q >> shift) & 0xF) - zero) * float(t_scales[group_idx]);
+  }
+
+  imageStore(t_out, out_pos, out_texel);
+}
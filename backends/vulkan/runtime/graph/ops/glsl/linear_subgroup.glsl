@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, "texture3d")}
+
+${define_active_storage_type("texture3d")}
+
+${define_required_extensions(DTYPE)}
+$if QUANTIZED:
+  ${define_required_extensions("int8")}
+
+#extension GL_KHR_shader_subgroup_arithmetic : require
+#extension GL_KHR_shader_subgroup_ballot : require
+
+#include "indexing_utils.h"
+
+layout(std430) buffer;
+
+${layout_declare_tensor(0, "w", "t_out", DTYPE, "texture3d")}
+${layout_declare_tensor(1, "r", "t_mat1", DTYPE, "texture3d")}
+$if QUANTIZED:
+  ${layout_declare_tensor(2, "r", "t_mat2", "int8", "texture3d")}
+  ${layout_declare_tensor(3, "r", "t_scales", DTYPE, "texture3d")}
+  ${layout_declare_ubo(4, "ivec3", "out_limits")}
+  ${layout_declare_ubo(5, "ivec4", "mat1_sizes")}
+$elif HAS_BIAS:
+  ${layout_declare_tensor(2, "r", "t_mat2", DTYPE, "texture3d")}
+  ${layout_declare_tensor(3, "r", "t_bias", DTYPE, "texture3d")}
+  ${layout_declare_ubo(4, "ivec3", "out_limits")}
+  ${layout_declare_ubo(5, "ivec4", "mat1_sizes")}
+$else:
+  ${layout_declare_tensor(2, "r", "t_mat2", DTYPE, "texture3d")}
+  ${layout_declare_ubo(3, "ivec3", "out_limits")}
+  ${layout_declare_ubo(4, "ivec4", "mat1_sizes")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+/*
+ * Computes out = mat1 @ mat2^T, where mat1 and out are width packed and mat2
+ * is the width packed [N, K] weight of a linear layer.
+ *
+ * Every subgroup computes one output texel: its invocations split the K
+ * dimension between them and the partial sums are combined with subgroupAdd.
+ * This is much faster than looping over K in a single invocation when there
+ * are few output texels, e.g. for the linear layers of LLM decoding. Output
+ * texels are indexed by subgroup rather than by invocation, so the shader is
+ * correct for any local work group size and subgroup size.
+ */
+void main() {
+  const uint workgroup_idx = gl_WorkGroupID.x +
+      gl_NumWorkGroups.x *
+          (gl_WorkGroupID.y + gl_NumWorkGroups.y * gl_WorkGroupID.z);
+  const int texel_idx = int(workgroup_idx * gl_NumSubgroups + gl_SubgroupID);
+
+  const ivec3 out_pos = ivec3(
+      texel_idx % out_limits.x,
+      (texel_idx / out_limits.x) % out_limits.y,
+      texel_idx / (out_limits.x * out_limits.y));
+
+  // Uniform across the subgroup
+  if (out_pos.z >= out_limits.z) {
+    return;
+  }
+
+  // The last subgroup of a work group may not be full, so the K dimension is
+  // split among the invocations that are active
+  const uvec4 active = subgroupBallot(true);
+  const int lane = int(subgroupBallotExclusiveBitCount(active));
+  const int num_lanes = int(subgroupBallotBitCount(active));
+
+  const int K = (mat1_sizes.x + 3) / 4;
+  const int n = out_pos.x * 4;
+
+  VEC4_T sums = VEC4_T(0);
+  for (int k = lane; k < K; k += num_lanes) {
+    const VEC4_T mat1_tex = load_texel(t_mat1, ivec3(k, out_pos.yz));
+    sums += VEC4_T(
+        dot(mat1_tex, VEC4_T(load_texel(t_mat2, ivec3(k, n, 0)))),
+        dot(mat1_tex, VEC4_T(load_texel(t_mat2, ivec3(k, n + 1, 0)))),
+        dot(mat1_tex, VEC4_T(load_texel(t_mat2, ivec3(k, n + 2, 0)))),
+        dot(mat1_tex, VEC4_T(load_texel(t_mat2, ivec3(k, n + 3, 0)))));
+  }
+
+  sums = subgroupAdd(sums);
+
+  if (subgroupElect()) {
+    $if QUANTIZED:
+      sums *= load_texel(t_scales, ivec3(out_pos.x, 0, 0));
+    $elif HAS_BIAS:
+      sums += load_texel(t_bias, ivec3(out_pos.x, 0, 0));
+    write_texel(t_out, out_pos, sums);
+  }
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, "texture3d")}
+
+${define_active_storage_type("texture3d")}
+
+${define_required_extensions(DTYPE)}
+
+$if SUBGROUP:
+  #extension GL_KHR_shader_subgroup_arithmetic : require
+  #extension GL_KHR_shader_subgroup_ballot : require
+
+#include "indexing_utils.h"
+
+layout(std430) buffer;
+
+${layout_declare_tensor(0, "w", "t_out", DTYPE, "texture3d")}
+${layout_declare_tensor(1, "r", "t_mat1", DTYPE, "texture3d")}
+${layout_declare_tensor(2, "r", "t_weight", "int", "buffer", is_scalar_array=False)}
+${layout_declare_tensor(3, "r", "t_scales", DTYPE, "buffer")}
+${layout_declare_tensor(4, "r", "t_zeros", DTYPE, "buffer")}
+${layout_declare_ubo(5, "ivec3", "out_limits")}
+${layout_declare_ubo(6, "ivec4", "out_sizes")}
+${layout_declare_ubo(7, "ivec4", "mat1_sizes")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+layout(constant_id = 3) const int group_size = 32;
+layout(constant_id = 4) const bool has_zeros = false;
+
+/*
+ * Computes out = mat1 @ dequantize(weight)^T, where mat1 and out are width
+ * packed and weight is the [N, K] int4 weight of a linear layer, quantized
+ * group-wise along K with a scale and an optional zero point per group:
+ *
+ *   weight[n][k] = (q[n][k] - 8 - zeros[n][g]) * scales[n][g]
+ *
+ * The weight is stored in a buffer, since the height of a texture would limit
+ * N, with each ivec4 holding 32 consecutive values of a row. Two values are
+ * packed in every byte, the even one in the high nibble.
+ *
+ * The K dimension is processed in blocks of 32, which never straddle a group.
+ * Within a block the zero point is factored out of the dot product:
+ *
+ *   sum(x * w) = scale * (sum(x * q) - (8 + zero) * sum(x))
+ */
+
+// Dot product of 8 consecutive mat1 values with the int4 values packed in q
+float dot8(const VEC4_T a, const VEC4_T b, const int q) {
+  const vec4 q_lo =
+      vec4((q >> 4) & 0xF, q & 0xF, (q >> 12) & 0xF, (q >> 8) & 0xF);
+  const vec4 q_hi =
+      vec4((q >> 20) & 0xF, (q >> 16) & 0xF, (q >> 28) & 0xF, (q >> 24) & 0xF);
+  return dot(vec4(a), q_lo) + dot(vec4(b), q_hi);
+}
+
+// Adds the contribution of the given block of K to the 4 output values of
+// out_pos
+void accumulate_block(const int block, const ivec3 out_pos, inout vec4 sums) {
+  const int num_blocks = mat1_sizes.x / 32;
+  const int num_groups = mat1_sizes.x / group_size;
+  const int group = (block * 32) / group_size;
+
+  VEC4_T x[8];
+  vec4 x_sum = vec4(0);
+  for (int i = 0; i < 8; ++i) {
+    x[i] = load_texel(t_mat1, ivec3(block * 8 + i, out_pos.yz));
+    x_sum += vec4(x[i]);
+  }
+  const float x_total = x_sum.x + x_sum.y + x_sum.z + x_sum.w;
+
+  const int n = out_pos.x * 4;
+  for (int r = 0; r < 4 && n + r < out_sizes.x; ++r) {
+    const ivec4 q = t_weight[(n + r) * num_blocks + block];
+    const float qx = dot8(x[0], x[1], q.x) + dot8(x[2], x[3], q.y) +
+        dot8(x[4], x[5], q.z) + dot8(x[6], x[7], q.w);
+
+    const int group_idx = (n + r) * num_groups + group;
+    float zero = 8.0;
+    if (has_zeros) {
+      zero += float(t_zeros[group_idx]);
+    }
+    sums[r] += float(t_scales[group_idx]) * (qx - zero * x_total);
+  }
+}
+
+$if SUBGROUP:
+  /*
+   * Every subgroup computes one output texel, splitting the blocks of K among
+   * its invocations. See linear_subgroup.glsl.
+   */
+  void main() {
+    const uint workgroup_idx = gl_WorkGroupID.x +
+        gl_NumWorkGroups.x *
+            (gl_WorkGroupID.y + gl_NumWorkGroups.y * gl_WorkGroupID.z);
+    const int texel_idx = int(workgroup_idx * gl_NumSubgroups + gl_SubgroupID);
+
+    const ivec3 out_pos = ivec3(
+        texel_idx % out_limits.x,
+        (texel_idx / out_limits.x) % out_limits.y,
+        texel_idx / (out_limits.x * out_limits.y));
+
+    // Uniform across the subgroup
+    if (out_pos.z >= out_limits.z) {
+      return;
+    }
+
+    const uvec4 active = subgroupBallot(true);
+    const int lane = int(subgroupBallotExclusiveBitCount(active));
+    const int num_lanes = int(subgroupBallotBitCount(active));
+
+    vec4 sums = vec4(0);
+    for (int block = lane; block < mat1_sizes.x / 32; block += num_lanes) {
+      accumulate_block(block, out_pos, sums);
+    }
+
+    sums = subgroupAdd(sums);
+
+    if (subgroupElect()) {
+      write_texel(t_out, out_pos, VEC4_T(sums));
+    }
+  }
+$else:
+  void main() {
+    const ivec3 out_pos = ivec3(gl_GlobalInvocationID);
+    if (any(greaterThanEqual(out_pos, out_limits))) {
+      return;
+    }
+
+    vec4 sums = vec4(0);
+    for (int block = 0; block < mat1_sizes.x / 32; ++block) {
+      accumulate_block(block, out_pos, sums);
+    }
+
+    write_texel(t_out, out_pos, VEC4_T(sums));
+  }
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, "texture3d")}
+
+${define_active_storage_type("texture3d")}
+
+${define_required_extensions(DTYPE)}
+
+#include "indexing_utils.h"
+
+layout(std430) buffer;
+
+${layout_declare_tensor(0, "w", "t_out", DTYPE, "texture3d")}
+${layout_declare_tensor(1, "r", "t_q", DTYPE, "texture3d")}
+${layout_declare_tensor(2, "r", "t_k_cache", DTYPE, "buffer", is_scalar_array=False)}
+${layout_declare_tensor(3, "r", "t_v_cache", DTYPE, "buffer", is_scalar_array=False)}
+${layout_declare_ubo(4, "ivec4", "q_sizes")}
+${layout_declare_ubo(5, "ivec4", "cache_sizes")}
+${layout_declare_ubo(6, "int", "start_pos")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+layout(constant_id = 3) const float scale = 1.0;
+layout(constant_id = 4) const bool is_causal = false;
+
+// Upper bounds of the work group size and of the head dim divided by 4
+#define MAX_WORKERS 128
+#define MAX_D4 128
+// Number of output texels accumulated per pass over the value cache
+#define D4_CHUNK 32
+
+shared vec4 sh_q[MAX_D4];
+shared float sh_max[MAX_WORKERS];
+shared float sh_sum[MAX_WORKERS];
+shared vec4 sh_partial[MAX_WORKERS];
+
+float dot_qk(const int k_idx, const int D4) {
+  vec4 sums = vec4(0);
+  for (int i = 0; i < D4; ++i) {
+    sums += sh_q[i] * vec4(t_k_cache[k_idx + i]);
+  }
+  return sums.x + sums.y + sums.z + sums.w;
+}
+
+/*
+ * Computes softmax(q @ k^T * scale) @ v for one row of a width packed
+ * [B, S, H, D] query, where k and v are the first start_pos + S tokens of the
+ * contiguous [B, max_seq_len, H_kv, D] caches. H must be a multiple of H_kv;
+ * query heads are mapped to cache heads as in grouped query attention. If
+ * is_causal is true, query s only attends to tokens up to start_pos + s.
+ *
+ * A work group computes one row at a time and splits the cached tokens among
+ * its invocations. The first pass computes the maximum and the sum of the
+ * exponentiated scores with an online softmax, and the second pass
+ * accumulates the value rows weighted by the normalized scores.
+ */
+void compute_row(const int row, const int worker, const int num_workers) {
+  const int D4 = q_sizes.x / 4;
+  const int H = q_sizes.y;
+  const int S = q_sizes.z;
+  const int H_kv = cache_sizes.y;
+  const int max_seq_len = cache_sizes.z;
+
+  const int h = row % H;
+  const int s = (row / H) % S;
+  const int b = row / (H * S);
+  const int h_kv = h / (H / H_kv);
+
+  // The batch dim is folded into the sequence dim along z
+  const ivec3 q_pos = ivec3(0, h, b * S + s);
+  for (int i = worker; i < D4; i += num_workers) {
+    sh_q[i] = vec4(load_texel(t_q, ivec3(i, q_pos.yz))) * scale;
+  }
+  barrier();
+
+  const int num_tokens =
+      min(is_causal ? start_pos + s + 1 : start_pos + S, max_seq_len);
+  // Index of the first texel of token 0 in the caches
+  const int cache_idx = (b * max_seq_len * H_kv + h_kv) * D4;
+  const int token_stride = H_kv * D4;
+
+  // Pass 1: maximum and sum of exp of the scores of this invocation's tokens
+  float m = -3.402823e38;
+  float l = 0.0;
+  for (int j = worker; j < num_tokens; j += num_workers) {
+    const float score = dot_qk(cache_idx + j * token_stride, D4);
+    const float new_m = max(m, score);
+    l = l * exp(m - new_m) + exp(score - new_m);
+    m = new_m;
+  }
+  sh_max[worker] = m;
+  sh_sum[worker] = l;
+  barrier();
+
+  float row_max = -3.402823e38;
+  for (int w = 0; w < num_workers; ++w) {
+    row_max = max(row_max, sh_max[w]);
+  }
+  float row_sum = 0.0;
+  for (int w = 0; w < num_workers; ++w) {
+    row_sum += sh_sum[w] * exp(sh_max[w] - row_max);
+  }
+
+  // Pass 2: weighted sum of the value rows, D4_CHUNK texels at a time
+  for (int d4_start = 0; d4_start < D4; d4_start += D4_CHUNK) {
+    const int chunk = min(D4_CHUNK, D4 - d4_start);
+
+    vec4 acc[D4_CHUNK];
+    for (int i = 0; i < D4_CHUNK; ++i) {
+      acc[i] = vec4(0);
+    }
+    for (int j = worker; j < num_tokens; j += num_workers) {
+      const int token_idx = cache_idx + j * token_stride;
+      const float p = exp(dot_qk(token_idx, D4) - row_max);
+      for (int i = 0; i < chunk; ++i) {
+        acc[i] += p * vec4(t_v_cache[token_idx + d4_start + i]);
+      }
+    }
+
+    for (int i = 0; i < chunk; ++i) {
+      sh_partial[worker] = acc[i];
+      barrier();
+      for (int active = num_workers; active > 1;) {
+        const int half_active = (active + 1) / 2;
+        if (worker < active - half_active) {
+          sh_partial[worker] += sh_partial[worker + half_active];
+        }
+        barrier();
+        active = half_active;
+      }
+      if (worker == 0) {
+        write_texel(
+            t_out,
+            ivec3(d4_start + i, q_pos.yz),
+            VEC4_T(sh_partial[0] / row_sum));
+      }
+      barrier();
+    }
+  }
+}
+
+/*
+ * Rows are distributed over the work groups in a strided loop, so the shader is
+ * correct for any local work group size and number of work groups.
+ */
+void main() {
+  const int worker = int(gl_LocalInvocationIndex);
+  const int num_workers =
+      int(gl_WorkGroupSize.x * gl_WorkGroupSize.y * gl_WorkGroupSize.z);
+
+  const int workgroup_idx = int(
+      gl_WorkGroupID.x +
+      gl_NumWorkGroups.x *
+          (gl_WorkGroupID.y + gl_NumWorkGroups.y * gl_WorkGroupID.z));
+  const int num_workgroups =
+      int(gl_NumWorkGroups.x * gl_NumWorkGroups.y * gl_NumWorkGroups.z);
+
+  // The loop condition is uniform across the work group
+  const int num_rows = q_sizes.w * q_sizes.z * q_sizes.y;
+  for (int row = workgroup_idx; row < num_rows; row += num_workgroups) {
+    compute_row(row, worker, num_workers);
+  }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, "texture3d")}
+#define BUF_VEC4_T ${buffer_gvec_type(DTYPE, 4)}
+
+${define_active_storage_type("texture3d")}
+
+${define_required_extensions(DTYPE)}
+
+#include "indexing_utils.h"
+
+layout(std430) buffer;
+
+${layout_declare_tensor(0, "w", "t_k_cache", DTYPE, "buffer", is_scalar_array=False)}
+${layout_declare_tensor(1, "w", "t_v_cache", DTYPE, "buffer", is_scalar_array=False)}
+${layout_declare_tensor(2, "r", "t_k", DTYPE, "texture3d")}
+${layout_declare_tensor(3, "r", "t_v", DTYPE, "texture3d")}
+${layout_declare_ubo(4, "ivec3", "kv_limits")}
+${layout_declare_ubo(5, "ivec4", "kv_sizes")}
+${layout_declare_ubo(6, "ivec4", "cache_sizes")}
+${layout_declare_ubo(7, "int", "start_pos")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+/*
+ * Writes the width packed [B, S, H, D] key and value projections of the
+ * current tokens into the contiguous [B, max_seq_len, H, D] caches, starting
+ * at sequence position start_pos.
+ */
+void main() {
+  const ivec3 pos = ivec3(gl_GlobalInvocationID);
+  if (any(greaterThanEqual(pos, kv_limits))) {
+    return;
+  }
+
+  // The batch dim is folded into the sequence dim along z
+  const int s = pos.z % kv_sizes.z;
+  const int b = pos.z / kv_sizes.z;
+
+  const int token = start_pos + s;
+  if (token >= cache_sizes.z) {
+    return;
+  }
+
+  const int D4 = cache_sizes.x / 4;
+  const int cache_idx =
+      ((b * cache_sizes.z + token) * cache_sizes.y + pos.y) * D4 + pos.x;
+
+  t_k_cache[cache_idx] = BUF_VEC4_T(load_texel(t_k, pos));
+  t_v_cache[cache_idx] = BUF_VEC4_T(load_texel(t_v, pos));
+}
@@ -59,8 +59,90 @@ void embedding(ComputeGraph& graph, const std::vector<ValueRef>& args) {
   add_embedding_node(graph, weight, in, out);
 }
 
+void add_embedding_4bit_node(
+    ComputeGraph& graph,
+    const ValueRef weight_data,
+    const ValueRef scales_data,
+    const ValueRef zeros_data,
+    const ValueRef indices,
+    const ValueRef out) {
+  const std::vector<int64_t> weight_sizes = graph.sizes_of(weight_data);
+  VK_CHECK_COND(weight_sizes.size() == 2);
+  const int64_t dim = weight_sizes.at(1) * 2;
+  VK_CHECK_COND(utils::val_at(-1, graph.sizes_of(out)) == dim);
+  VK_CHECK_COND(graph.storage_type_of(out) == utils::kTexture3D);
+  VK_CHECK_COND(graph.storage_type_of(indices) == utils::kTexture3D);
+  VK_CHECK_COND(graph.val_is_tref(scales_data));
+
+  // Per row scales are treated as a single group per row
+  std::vector<int64_t> scales_sizes = graph.sizes_of(scales_data);
+  VK_CHECK_COND(scales_sizes.size() == 1 || scales_sizes.size() == 2);
+  VK_CHECK_COND(scales_sizes.at(0) == weight_sizes.at(0));
+  const int64_t num_groups = scales_sizes.size() == 2 ? scales_sizes.at(1) : 1;
+  VK_CHECK_COND(dim % num_groups == 0);
+  VK_CHECK_COND(
+      graph.stored_dtype(graph.dtype_of(scales_data)) == graph.dtype_of(out));
+
+  auto prepack_qparams = [&](const ValueRef qparams_data) {
+    VK_CHECK_COND(graph.val_is_tref(qparams_data));
+    VK_CHECK_COND(
+        graph.stored_dtype(graph.dtype_of(qparams_data)) ==
+        graph.dtype_of(out));
+    VK_CHECK_COND(
+        utils::multiply_integers(graph.sizes_of(qparams_data)) ==
+        weight_sizes.at(0) * num_groups);
+    const void* data = graph.get_tref(qparams_data)->data;
+    return prepack_buffer(
+        graph,
+        graph.add_tensorref(
+            {weight_sizes.at(0), num_groups},
+            graph.dtype_of(qparams_data),
+            data));
+  };
+
+  const bool has_zeros = zeros_data != kDummyValueRef;
+
+  // The table is stored in a buffer, since the vocabulary size of LLMs often
+  // exceeds the maximum texture extents
+  ValueRef weight = prepack_int4_weight(graph, weight_data);
+  ValueRef scales = prepack_qparams(scales_data);
+  // The shader always binds a zeros buffer, which is not read if has_zeros is
+  // false
+  ValueRef zeros = has_zeros ? prepack_qparams(zeros_data) : scales;
+
+  std::string kernel_name = "embedding_4bit";
+  kernel_name.reserve(kShaderNameReserve);
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  graph.execute_nodes().emplace_back(new ExecuteNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      graph.create_global_wg_size(out),
+      graph.create_local_wg_size(out),
+      {{out, vkapi::MemoryAccessType::WRITE},
+       {{indices, weight, scales, zeros}, vkapi::MemoryAccessType::READ}},
+      {graph.sizes_ubo(out), graph.sizes_ubo(indices)},
+      // Specialization Constants
+      {SV(graph.packed_dim_whcn_idx_of(out)),
+       SV(graph.packed_dim_whcn_idx_of(indices)),
+       SV(utils::safe_downcast<int32_t>(dim / num_groups)),
+       SV(has_zeros)}));
+}
+
+void embedding_4bit(ComputeGraph& graph, const std::vector<ValueRef>& args) {
+  // weight, weight_scales, weight_zero_points, weight_quant_min,
+  // weight_quant_max, indices, [dtype], out
+  const ValueRef zeros =
+      graph.val_is_none(args[2]) ? kDummyValueRef : args[2];
+  const ValueRef indices = prepack_if_tensor_ref(graph, args[5]);
+  add_embedding_4bit_node(
+      graph, args[0], args[1], zeros, indices, args.back());
+}
+
 REGISTER_OPERATORS {
   VK_REGISTER_OP(aten.embedding.default, embedding);
+  VK_REGISTER_OP(quantized_decomposed.embedding_4bit.default, embedding_4bit);
+  VK_REGISTER_OP(quantized_decomposed.embedding_4bit.dtype, embedding_4bit);
 }
 
 } // namespace vkcompute
@@ -8,6 +8,7 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/OperatorRegistry.h>
 
+#include <executorch/backends/vulkan/runtime/graph/ops/impl/Linear.h>
 #include <executorch/backends/vulkan/runtime/graph/ops/impl/MatMul.h>
 #include <executorch/backends/vulkan/runtime/graph/ops/impl/Staging.h>
 
@@ -235,6 +236,122 @@ void add_addmm_node(
   }
 }
 
+// Linear layers whose input has at most this many rows use the subgroup
+// shaders, e.g. the linear layers of LLM decoding
+constexpr int64_t kLinearSubgroupMaxRows = 4;
+
+bool can_use_linear_subgroup_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef out) {
+  if (!graph.subgroup_reductions_enabled()) {
+    return false;
+  }
+  if (graph.storage_type_of(mat1) != utils::kTexture3D ||
+      graph.storage_type_of(out) != utils::kTexture3D) {
+    return false;
+  }
+
+  const std::vector<int64_t> mat1_sizes = graph.sizes_of(mat1);
+  int64_t rows = 1;
+  for (size_t i = 0; i + 1 < mat1_sizes.size(); ++i) {
+    rows *= mat1_sizes.at(i);
+  }
+  return rows <= kLinearSubgroupMaxRows;
+}
+
+void resize_linear_subgroup_node(
+    ComputeGraph* graph,
+    const std::vector<ArgGroup>& args,
+    const std::vector<ValueRef>& extra_args) {
+  (void)extra_args;
+
+  vTensorPtr out = graph->get_tensor(args[0].refs[0]);
+  vTensorPtr mat1 = graph->get_tensor(args[1].refs[0]);
+  vTensorPtr weight = graph->get_tensor(args[1].refs[1]);
+
+  std::vector<int64_t> new_out_sizes = mat1->sizes();
+  new_out_sizes.back() = utils::val_at(-2, weight->sizes());
+
+  out->virtual_resize(new_out_sizes);
+}
+
+void add_linear_subgroup_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef weight_data,
+    const ValueRef bias_data,
+    const ValueRef scales_data,
+    const ValueRef out) {
+  const bool is_quantized = scales_data != kDummyValueRef;
+  const bool has_bias = bias_data != kDummyValueRef;
+
+  // The shaders read and write width packed textures
+  auto viewFn = VK_GET_OP_FN("aten.view_copy.default");
+  auto width_packed = [&](const ValueRef arg) {
+    const ValueRef tensor =
+        prepack_if_tensor_ref(graph, arg, utils::kWidthPacked);
+    if (graph.memory_layout_of(tensor) == utils::kWidthPacked) {
+      return tensor;
+    }
+    const ValueRef tensor_W_packed =
+        graph.add_tensor_like(tensor, utils::kWidthPacked);
+    viewFn(graph, {tensor, graph.add_none(), tensor_W_packed});
+    return tensor_W_packed;
+  };
+
+  std::vector<ValueRef> read_args = {
+      width_packed(mat1), width_packed(weight_data)};
+  if (is_quantized) {
+    read_args.push_back(width_packed(scales_data));
+  } else if (has_bias) {
+    read_args.push_back(width_packed(bias_data));
+  }
+
+  ValueRef out_W_packed = out;
+  if (graph.memory_layout_of(out) != utils::kWidthPacked) {
+    out_W_packed = graph.add_tensor_like(out, utils::kWidthPacked);
+  }
+
+  std::string kernel_name = "linear_subgroup";
+  if (is_quantized) {
+    kernel_name = "q_8w_linear_subgroup";
+  } else if (has_bias) {
+    kernel_name = "linear_bias_subgroup";
+  }
+  kernel_name.reserve(kShaderNameReserve);
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  // Every subgroup computes one output texel
+  const uint32_t subgroup_size =
+      graph.context()->adapter_ptr()->subgroup_size();
+  utils::uvec3 global_size = graph.image_extents_of(out_W_packed);
+  global_size[0u] *= subgroup_size;
+  const utils::uvec3 local_size = {subgroup_size, 1u, 1u};
+
+  graph.execute_nodes().emplace_back(new ExecuteNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      global_size,
+      local_size,
+      // Inputs and Outputs
+      {{out_W_packed, vkapi::MemoryAccessType::WRITE},
+       {read_args, vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {
+          graph.texture_limits_ubo(out_W_packed),
+          graph.sizes_ubo(read_args.at(0)),
+      },
+      // Specialization Constants
+      {},
+      // Resizing Logic
+      resize_linear_subgroup_node));
+
+  if (out_W_packed != out) {
+    viewFn(graph, {out_W_packed, graph.add_none(), out});
+  }
+}
+
 void addmm(ComputeGraph& graph, const std::vector<ValueRef>& args) {
   check_addmm_args(graph, args[0], args[1], args[2], args[3], args[4], args[5]);
   ValueRef mat2_is_transposed = graph.add_scalar(false);
@@ -254,6 +371,15 @@ void linear(ComputeGraph& graph, const std::vector<ValueRef>& args) {
   ValueRef weight_data = args.at(1);
   ValueRef bias = args.at(2);
   ValueRef out = args.at(3);
+  if (can_use_linear_subgroup_node(graph, input, out)) {
+    return add_linear_subgroup_node(
+        graph,
+        input,
+        weight_data,
+        graph.val_is_none(bias) ? kDummyValueRef : bias,
+        kDummyValueRef,
+        out);
+  }
   ValueRef weight =
       prepack_if_tensor_ref(graph, weight_data, utils::kWidthPacked);
   ValueRef mat2_is_transposed = graph.add_scalar(true);
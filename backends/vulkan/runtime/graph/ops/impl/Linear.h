@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/backends/vulkan/runtime/graph/ComputeGraph.h>
+
+namespace vkcompute {
+
+/*
+ * Check whether a linear layer with the given input and output can be
+ * computed by the linear_subgroup shaders. These are used when the device
+ * supports subgroup reductions and the input has only a few rows, since the
+ * regular shaders loop over the K dimension in a single invocation and leave
+ * most of the GPU idle in that case.
+ */
+bool can_use_linear_subgroup_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef out);
+
+/*
+ * Adds a node computing out = mat1 @ weight^T, reducing along K with subgroup
+ * operations. If bias_data is not kDummyValueRef it is added to the result.
+ * If scales_data is not kDummyValueRef, the weight is int8 and the result is
+ * multiplied by the per output channel scales.
+ */
+void add_linear_subgroup_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef weight_data,
+    const ValueRef bias_data,
+    const ValueRef scales_data,
+    const ValueRef out);
+
+} // namespace vkcompute
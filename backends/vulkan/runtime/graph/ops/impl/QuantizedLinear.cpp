@@ -8,6 +8,7 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/OperatorRegistry.h>
 
+#include <executorch/backends/vulkan/runtime/graph/ops/impl/Linear.h>
 #include <executorch/backends/vulkan/runtime/graph/ops/impl/Staging.h>
 
 #include <executorch/backends/vulkan/runtime/graph/ops/impl/utils/ScalarUtils.h>
@@ -117,11 +118,141 @@ void weight_int8pack_mm(
     ComputeGraph& graph,
     const std::vector<ValueRef>& args) {
   check_qlinear_args(graph, args[0], args[1], args[2], args[3]);
+  if (can_use_linear_subgroup_node(graph, args[0], args[3])) {
+    return add_linear_subgroup_node(
+        graph, args[0], args[1], kDummyValueRef, args[2], args[3]);
+  }
   return add_q_8w_linear_node(graph, args[0], args[1], args[2], args[3]);
 }
 
+void check_q_4w_linear_args(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef q_mat2_data,
+    const ValueRef scales,
+    const ValueRef zeros,
+    const int64_t group_size,
+    const ValueRef out) {
+  std::vector<int64_t> mat1_sizes = graph.sizes_of(mat1);
+  std::vector<int64_t> qmat2_sizes = graph.sizes_of(q_mat2_data);
+  std::vector<int64_t> scales_sizes = graph.sizes_of(scales);
+
+  VK_CHECK_COND(mat1_sizes.size() == 2 || mat1_sizes.size() == 3);
+  VK_CHECK_COND(qmat2_sizes.size() == 2);
+  VK_CHECK_COND(scales_sizes.size() == 2);
+
+  VK_CHECK_COND(graph.storage_type_of(mat1) == utils::kTexture3D);
+  VK_CHECK_COND(graph.storage_type_of(out) == utils::kTexture3D);
+  VK_CHECK_COND(graph.val_is_tref(q_mat2_data));
+  VK_CHECK_COND(graph.val_is_tref(scales));
+
+  // Two int4 values are packed in every byte of the weight
+  const int64_t K = utils::val_at(-1, mat1_sizes);
+  VK_CHECK_COND(utils::val_at(-1, qmat2_sizes) * 2 == K);
+
+  // The shader processes K in blocks of 32 values that belong to one group
+  VK_CHECK_COND(group_size > 0 && group_size % 32 == 0);
+  VK_CHECK_COND(K % group_size == 0);
+
+  VK_CHECK_COND(scales_sizes.at(0) == qmat2_sizes.at(0));
+  VK_CHECK_COND(scales_sizes.at(1) == K / group_size);
+  VK_CHECK_COND(
+      graph.stored_dtype(graph.dtype_of(scales)) == graph.dtype_of(out));
+  if (zeros != kDummyValueRef) {
+    VK_CHECK_COND(graph.val_is_tref(zeros));
+    VK_CHECK_COND(graph.sizes_of(zeros) == scales_sizes);
+    VK_CHECK_COND(
+        graph.stored_dtype(graph.dtype_of(zeros)) == graph.dtype_of(out));
+  }
+}
+
+void add_q_4w_linear_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef q_mat2_data,
+    const ValueRef scales_data,
+    const ValueRef zeros_data,
+    const ValueRef group_size,
+    const ValueRef out) {
+  const int64_t group_size_val = graph.extract_scalar<int64_t>(group_size);
+  check_q_4w_linear_args(
+      graph, mat1, q_mat2_data, scales_data, zeros_data, group_size_val, out);
+
+  const bool has_zeros = zeros_data != kDummyValueRef;
+
+  // The weight, scales and zeros are stored in buffers, since the number of
+  // output channels of LLM layers often exceeds the maximum texture extents
+  ValueRef q_mat2 = prepack_int4_weight(graph, q_mat2_data);
+  ValueRef scales = prepack_buffer(graph, scales_data);
+  // The shader always binds a zeros buffer, which is not read if has_zeros is
+  // false
+  ValueRef zeros = has_zeros ? prepack_buffer(graph, zeros_data) : scales;
+
+  // The shaders read and write width packed textures
+  auto viewFn = VK_GET_OP_FN("aten.view_copy.default");
+  ValueRef mat1_W_packed = mat1;
+  if (graph.memory_layout_of(mat1) != utils::kWidthPacked) {
+    mat1_W_packed = graph.add_tensor_like(mat1, utils::kWidthPacked);
+    viewFn(graph, {mat1, graph.add_none(), mat1_W_packed});
+  }
+  ValueRef out_W_packed = out;
+  if (graph.memory_layout_of(out) != utils::kWidthPacked) {
+    out_W_packed = graph.add_tensor_like(out, utils::kWidthPacked);
+  }
+
+  const bool use_subgroup = can_use_linear_subgroup_node(graph, mat1, out);
+
+  std::string kernel_name =
+      use_subgroup ? "q_4w_linear_subgroup" : "q_4w_linear";
+  kernel_name.reserve(kShaderNameReserve);
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  utils::uvec3 global_size = graph.image_extents_of(out_W_packed);
+  utils::uvec3 local_size = graph.create_local_wg_size(global_size);
+  if (use_subgroup) {
+    // Every subgroup computes one output texel
+    const uint32_t subgroup_size =
+        graph.context()->adapter_ptr()->subgroup_size();
+    global_size[0u] *= subgroup_size;
+    local_size = {subgroup_size, 1u, 1u};
+  }
+
+  graph.execute_nodes().emplace_back(new ExecuteNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      global_size,
+      local_size,
+      // Inputs and Outputs
+      {{out_W_packed, vkapi::MemoryAccessType::WRITE},
+       {{mat1_W_packed, q_mat2, scales, zeros},
+        vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {graph.texture_limits_ubo(out_W_packed),
+       graph.sizes_ubo(out_W_packed),
+       graph.sizes_ubo(mat1_W_packed)},
+      // Specialization Constants
+      {SV(utils::safe_downcast<int32_t>(group_size_val)), SV(has_zeros)},
+      // Resizing Logic
+      resize_qlinear_node));
+
+  if (out_W_packed != out) {
+    viewFn(graph, {out_W_packed, graph.add_none(), out});
+  }
+}
+
+void linear_weight_int4(
+    ComputeGraph& graph,
+    const std::vector<ValueRef>& args) {
+  // self, weight, weight_scales, weight_zero_points, group_size, out
+  const ValueRef zeros =
+      graph.val_is_none(args[3]) ? kDummyValueRef : args[3];
+  return add_q_4w_linear_node(
+      graph, args[0], args[1], args[2], zeros, args[4], args[5]);
+}
+
 REGISTER_OPERATORS {
   VK_REGISTER_OP(aten._weight_int8pack_mm.default, weight_int8pack_mm);
+  VK_REGISTER_OP(et_vk.linear_weight_int4.default, linear_weight_int4);
 }
 
 } // namespace vkcompute
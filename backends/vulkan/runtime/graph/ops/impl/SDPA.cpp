@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/vulkan/runtime/graph/ops/OperatorRegistry.h>
+
+#include <executorch/backends/vulkan/runtime/graph/ops/impl/Staging.h>
+
+#include <executorch/backends/vulkan/runtime/graph/ops/utils/ShaderNameUtils.h>
+
+#include <cmath>
+
+namespace vkcompute {
+
+// Number of invocations that split the cached tokens of one attention row
+constexpr uint32_t kSDPAWorkers = 64u;
+
+void check_sdpa_with_kv_cache_args(
+    ComputeGraph& graph,
+    const ValueRef q,
+    const ValueRef k,
+    const ValueRef v,
+    const ValueRef k_cache,
+    const ValueRef v_cache,
+    const ValueRef out) {
+  const std::vector<int64_t> q_sizes = graph.sizes_of(q);
+  const std::vector<int64_t> k_sizes = graph.sizes_of(k);
+  const std::vector<int64_t> cache_sizes = graph.sizes_of(k_cache);
+
+  // q and out are [B, S, H, D], k and v are [B, S, H_kv, D] and the caches
+  // are [B, max_seq_len, H_kv, D]
+  VK_CHECK_COND(q_sizes.size() == 4);
+  VK_CHECK_COND(k_sizes.size() == 4);
+  VK_CHECK_COND(cache_sizes.size() == 4);
+  VK_CHECK_COND(graph.sizes_of(v) == k_sizes);
+  VK_CHECK_COND(graph.sizes_of(v_cache) == cache_sizes);
+  VK_CHECK_COND(graph.sizes_of(out) == q_sizes);
+
+  VK_CHECK_COND(k_sizes.at(0) == q_sizes.at(0));
+  VK_CHECK_COND(k_sizes.at(1) == q_sizes.at(1));
+  VK_CHECK_COND(cache_sizes.at(0) == q_sizes.at(0));
+  VK_CHECK_COND(cache_sizes.at(2) == k_sizes.at(2));
+  VK_CHECK_COND(q_sizes.at(2) % k_sizes.at(2) == 0);
+
+  // The shaders load 4 elements of the head dim at a time, and keep the query
+  // row in shared memory
+  const int64_t head_dim = q_sizes.at(3);
+  VK_CHECK_COND(k_sizes.at(3) == head_dim);
+  VK_CHECK_COND(cache_sizes.at(3) == head_dim);
+  VK_CHECK_COND(head_dim % 4 == 0 && head_dim <= 512);
+
+  for (const ValueRef arg : {q, k, v, out}) {
+    VK_CHECK_COND(graph.storage_type_of(arg) == utils::kTexture3D);
+    VK_CHECK_COND(graph.dtype_of(arg) == graph.dtype_of(out));
+  }
+  for (const ValueRef cache : {k_cache, v_cache}) {
+    VK_CHECK_COND(graph.dtype_of(cache) == graph.dtype_of(out));
+  }
+}
+
+void resize_sdpa_node(
+    ComputeGraph* graph,
+    const std::vector<ArgGroup>& args,
+    const std::vector<ValueRef>& extra_args) {
+  (void)extra_args;
+  vTensorPtr out = graph->get_tensor(args[0].refs[0]);
+  vTensorPtr q = graph->get_tensor(args[1].refs[0]);
+
+  out->virtual_resize(q->sizes());
+}
+
+ValueRef get_width_packed(ComputeGraph& graph, const ValueRef tensor) {
+  if (graph.memory_layout_of(tensor) == utils::kWidthPacked) {
+    return tensor;
+  }
+  const ValueRef tensor_W_packed =
+      graph.add_tensor_like(tensor, utils::kWidthPacked);
+  VK_GET_OP_FN("aten.view_copy.default")
+  (graph, {tensor, graph.add_none(), tensor_W_packed});
+  return tensor_W_packed;
+}
+
+// The caches are kept in buffers, since max_seq_len usually exceeds the
+// maximum texture extents. Serialized caches, i.e. mutable buffers of the
+// model, are prepacked once and then stay resident on the GPU.
+ValueRef get_cache_buffer(ComputeGraph& graph, const ValueRef cache) {
+  if (graph.val_is_tref(cache)) {
+    return prepack_buffer(graph, cache);
+  }
+  VK_CHECK_COND(
+      graph.is_buffer_storage(cache) &&
+          graph.memory_layout_of(cache) == utils::kWidthPacked,
+      "The KV cache of sdpa_with_kv_cache must be a constant or a width "
+      "packed buffer");
+  return cache;
+}
+
+void add_sdpa_with_kv_cache_node(
+    ComputeGraph& graph,
+    const ValueRef q,
+    const ValueRef k,
+    const ValueRef v,
+    const ValueRef k_cache_data,
+    const ValueRef v_cache_data,
+    const ValueRef start_pos,
+    const ValueRef is_causal,
+    const ValueRef scale,
+    const ValueRef out) {
+  check_sdpa_with_kv_cache_args(
+      graph, q, k, v, k_cache_data, v_cache_data, out);
+
+  const ValueRef k_cache = get_cache_buffer(graph, k_cache_data);
+  const ValueRef v_cache = get_cache_buffer(graph, v_cache_data);
+
+  const ValueRef q_W_packed = get_width_packed(graph, q);
+  const ValueRef k_W_packed = get_width_packed(graph, k);
+  const ValueRef v_W_packed = get_width_packed(graph, v);
+  ValueRef out_W_packed = out;
+  if (graph.memory_layout_of(out) != utils::kWidthPacked) {
+    out_W_packed = graph.add_tensor_like(out, utils::kWidthPacked);
+  }
+
+  // start_pos is either a constant or a SymInt that is updated before every
+  // execution, e.g. the position of the current token during decoding
+  const vkapi::BufferBindInfo start_pos_ubo = graph.val_is_symint(start_pos)
+      ? graph.symint_ubo(start_pos)
+      : graph.create_params_buffer(
+            utils::safe_downcast<int32_t>(
+                graph.extract_scalar<int64_t>(start_pos)));
+
+  const int64_t head_dim = graph.sizes_of(q).back();
+  const float scale_val = graph.extract_optional_scalar<double>(scale).value_or(
+      1.0 / std::sqrt(static_cast<double>(head_dim)));
+  const bool is_causal_val = graph.extract_scalar<bool>(is_causal);
+
+  std::string kernel_name = "sdpa_kv_cache_update";
+  kernel_name.reserve(kShaderNameReserve);
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  graph.execute_nodes().emplace_back(new ExecuteNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      graph.create_global_wg_size(k_W_packed),
+      graph.create_local_wg_size(k_W_packed),
+      // Inputs and Outputs
+      {{{k_cache, v_cache}, vkapi::MemoryAccessType::WRITE},
+       {{k_W_packed, v_W_packed}, vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {graph.texture_limits_ubo(k_W_packed),
+       graph.sizes_ubo(k_W_packed),
+       graph.sizes_ubo(k_cache),
+       start_pos_ubo},
+      // Specialization Constants
+      {}));
+
+  kernel_name = "sdpa_attention";
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  // One work group per row of the query, i.e. per token and head
+  const std::vector<int64_t> q_sizes = graph.sizes_of(q);
+  const utils::uvec3 global_size = {
+      kSDPAWorkers * utils::safe_downcast<uint32_t>(q_sizes.at(2)),
+      utils::safe_downcast<uint32_t>(q_sizes.at(0) * q_sizes.at(1)),
+      1u};
+
+  graph.execute_nodes().emplace_back(new ExecuteNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      global_size,
+      {kSDPAWorkers, 1u, 1u},
+      // Inputs and Outputs
+      {{out_W_packed, vkapi::MemoryAccessType::WRITE},
+       {{q_W_packed, k_cache, v_cache}, vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {graph.sizes_ubo(q_W_packed), graph.sizes_ubo(k_cache), start_pos_ubo},
+      // Specialization Constants
+      {SV(scale_val), SV(is_causal_val)},
+      // Resizing Logic
+      resize_sdpa_node));
+
+  if (out_W_packed != out) {
+    VK_GET_OP_FN("aten.view_copy.default")
+    (graph, {out_W_packed, graph.add_none(), out});
+  }
+}
+
+void sdpa_with_kv_cache(
+    ComputeGraph& graph,
+    const std::vector<ValueRef>& args) {
+  // query, key, value, key_cache, value_cache, start_pos, seq_len, attn_mask,
+  // dropout_p, is_causal, scale, out
+  VK_CHECK_COND(
+      graph.val_is_none(args[7]),
+      "sdpa_with_kv_cache: attn_mask is not supported, use is_causal instead");
+  VK_CHECK_COND(graph.extract_scalar<double>(args[8]) == 0.0);
+  return add_sdpa_with_kv_cache_node(
+      graph,
+      args[0],
+      args[1],
+      args[2],
+      args[3],
+      args[4],
+      args[5],
+      args[9],
+      args[10],
+      args[11]);
+}
+
+REGISTER_OPERATORS {
+  VK_REGISTER_OP(llama.sdpa_with_kv_cache.default, sdpa_with_kv_cache);
+}
+
+} // namespace vkcompute
@@ -100,12 +100,10 @@ void add_tensor_to_staging_node(
       {SV(graph.packed_dim_whcn_idx_of(in_tensor))}));
 }
 
-ValueRef prepack(
+void add_prepack_node(
     ComputeGraph& graph,
     const ValueRef vref,
-    const utils::GPUMemoryLayout layout) {
-  ValueRef v = graph.add_tensor_like(vref, layout);
-
+    const ValueRef v) {
   vkapi::ShaderInfo shader = get_nchw_to_tensor_shader(
       *graph.get_tensor(v), graph.int8_buffers_enabled());
 
@@ -128,10 +126,46 @@ ValueRef prepack(
       ubos,
       // Specialization Constants
       {SV(graph.packed_dim_whcn_idx_of(v))}));
+}
+
+ValueRef prepack(
+    ComputeGraph& graph,
+    const ValueRef vref,
+    const utils::GPUMemoryLayout layout) {
+  ValueRef v = graph.add_tensor_like(vref, layout);
+  add_prepack_node(graph, vref, v);
+  return v;
+}
 
+ValueRef prepack_buffer(ComputeGraph& graph, const ValueRef vref) {
+  VK_CHECK_COND(graph.val_is_tref(vref));
+  ValueRef v = graph.add_tensor_like(vref, utils::kBuffer, utils::kWidthPacked);
+  add_prepack_node(graph, vref, v);
   return v;
 }
 
+ValueRef prepack_int4_weight(ComputeGraph& graph, const ValueRef vref) {
+  VK_CHECK_COND(graph.val_is_tref(vref));
+
+  std::vector<int64_t> sizes;
+  const void* data = nullptr;
+  {
+    TensorRefPtr tref = graph.get_tref(vref);
+    VK_CHECK_COND(tref->dtype == vkapi::kByte);
+    VK_CHECK_COND(tref->sizes.size() == 2);
+    sizes = tref->sizes;
+    data = tref->data;
+  }
+  // Every texel-sized load, i.e. 4 int32s, must hold 32 values of one row
+  VK_CHECK_COND(sizes.at(1) % 16 == 0);
+
+  // Reinterpret every 4 bytes of a row as an int32, so that the packed values
+  // are copied to the GPU unchanged
+  const ValueRef int_vref = graph.add_tensorref(
+      {sizes.at(0), sizes.at(1) / 4}, vkapi::kInt, data);
+  return prepack_buffer(graph, int_vref);
+}
+
 ValueRef prepack_if_tensor_ref(
     ComputeGraph& graph,
     const ValueRef v,
@@ -31,4 +31,19 @@ ValueRef prepack_if_tensor_ref(
 
 ValueRef prepack_if_tensor_ref(ComputeGraph& graph, const ValueRef v);
 
+/*
+ * Prepacks a TensorRef into a tensor with buffer storage, so that the tensor
+ * is not subject to the maximum image extents of the device.
+ */
+ValueRef prepack_buffer(ComputeGraph& graph, const ValueRef vref);
+
+/*
+ * Prepacks a [R, C / 2] uint8 TensorRef holding two int4 values per byte, with
+ * the even element in the high nibble as in embedding_4bit, into a [R, C / 8]
+ * int32 tensor with buffer storage. Every int32 holds 8 consecutive values of
+ * a row, so a shader can load 32 values with a single ivec4 load. C must be a
+ * multiple of 32.
+ */
+ValueRef prepack_int4_weight(ComputeGraph& graph, const ValueRef vref);
+
 } // namespace vkcompute
@@ -71,6 +71,109 @@ void memcpy_from_mapping(
 #undef DTYPE_CASE
 }
 
+namespace {
+
+// Returns the bits of the half closest to `value`, rounding ties to even.
+uint16_t float_to_half_bits(const float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  const uint32_t abs_bits = bits & 0x7FFFFFFFu;
+  if (abs_bits > 0x7F800000u) {
+    // NaN
+    return sign | 0x7E00u;
+  }
+  if (abs_bits >= 0x477FF000u) {
+    // Rounds to a magnitude of at least 65520, which is out of range
+    return sign | 0x7C00u;
+  }
+  if (abs_bits < 0x38800000u) {
+    // Below the smallest normal half, 2^-14. Adding 0.5 leaves the value
+    // rounded to a multiple of 2^-24, the half subnormal step, in the low
+    // mantissa bits.
+    float abs_value;
+    memcpy(&abs_value, &abs_bits, sizeof(abs_value));
+    abs_value += 0.5f;
+    uint32_t rounded;
+    memcpy(&rounded, &abs_value, sizeof(rounded));
+    return sign | static_cast<uint16_t>(rounded - 0x3F000000u);
+  }
+  // Rebias the exponent from 127 to 15 and round the mantissa to 10 bits.
+  const uint32_t mantissa_odd = (abs_bits >> 13) & 1u;
+  return sign |
+      static_cast<uint16_t>((abs_bits + 0xC8000FFFu + mantissa_odd) >> 13);
+}
+
+float half_bits_to_float(const uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1Fu;
+  const uint32_t mantissa = half & 0x3FFu;
+  uint32_t bits;
+  if (exponent == 0x1Fu) {
+    bits = sign | 0x7F800000u | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else {
+    // Zero or subnormal, which is a multiple of 2^-24
+    const float value = static_cast<float>(mantissa) * 5.9604645e-8f;
+    memcpy(&bits, &value, sizeof(bits));
+    bits |= sign;
+  }
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void copy_ptr_to_mapping(
+    const void* src,
+    const vkapi::ScalarType src_dtype,
+    vkapi::MemoryMap& dst_mapping,
+    const vkapi::ScalarType dst_dtype,
+    const size_t numel) {
+  if (src_dtype == dst_dtype) {
+    memcpy_to_mapping(
+        src, dst_mapping, numel * vkapi::element_size(dst_dtype), dst_dtype);
+    return;
+  }
+  VK_CHECK_COND(
+      src_dtype == vkapi::kFloat && dst_dtype == vkapi::kHalf,
+      "Unsupported staging conversion from ",
+      src_dtype,
+      " to ",
+      dst_dtype);
+  const float* src_data = reinterpret_cast<const float*>(src);
+  uint16_t* dst_data = dst_mapping.template data<uint16_t>();
+  for (size_t i = 0; i < numel; ++i) {
+    dst_data[i] = float_to_half_bits(src_data[i]);
+  }
+}
+
+void copy_mapping_to_ptr(
+    vkapi::MemoryMap& src_mapping,
+    const vkapi::ScalarType src_dtype,
+    void* dst,
+    const vkapi::ScalarType dst_dtype,
+    const size_t numel) {
+  if (src_dtype == dst_dtype) {
+    memcpy_from_mapping(
+        src_mapping, dst, numel * vkapi::element_size(src_dtype), src_dtype);
+    return;
+  }
+  VK_CHECK_COND(
+      src_dtype == vkapi::kHalf && dst_dtype == vkapi::kFloat,
+      "Unsupported staging conversion from ",
+      src_dtype,
+      " to ",
+      dst_dtype);
+  const uint16_t* src_data = src_mapping.template data<uint16_t>();
+  float* dst_data = reinterpret_cast<float*>(dst);
+  for (size_t i = 0; i < numel; ++i) {
+    dst_data[i] = half_bits_to_float(src_data[i]);
+  }
+}
+
+} // namespace
+
 void copy_ptr_to_staging(
     const void* src,
     api::StorageBuffer& staging,
@@ -89,12 +192,67 @@ void copy_staging_to_ptr(
   memcpy_from_mapping(mapping, dst, nbytes, staging.dtype());
 }
 
+void copy_ptr_to_staging(
+    const void* src,
+    const vkapi::ScalarType data_dtype,
+    api::StorageBuffer& staging,
+    const size_t numel) {
+  vkapi::MemoryMap mapping(staging.buffer(), vkapi::MemoryAccessType::WRITE);
+  mapping.invalidate();
+  copy_ptr_to_mapping(src, data_dtype, mapping, staging.dtype(), numel);
+}
+
+void copy_staging_to_ptr(
+    api::StorageBuffer& staging,
+    void* dst,
+    const vkapi::ScalarType data_dtype,
+    const size_t numel) {
+  vkapi::MemoryMap mapping(staging.buffer(), vkapi::MemoryAccessType::READ);
+  mapping.invalidate();
+  copy_mapping_to_ptr(mapping, staging.dtype(), dst, data_dtype, numel);
+}
+
 void set_staging_zeros(api::StorageBuffer& staging, const size_t nbytes) {
   vkapi::MemoryMap mapping(staging.buffer(), vkapi::MemoryAccessType::WRITE);
   uint8_t* data_ptr = mapping.template data<uint8_t>();
   memset(data_ptr, 0, staging.nbytes());
 }
 
+void copy_ptr_to_tensor(
+    const void* src,
+    api::vTensor& tensor,
+    const size_t nbytes) {
+  vkapi::MemoryMap mapping(tensor.buffer(), vkapi::MemoryAccessType::WRITE);
+  mapping.invalidate();
+  memcpy_to_mapping(src, mapping, nbytes, tensor.dtype());
+}
+
+void copy_tensor_to_ptr(api::vTensor& tensor, void* dst, const size_t nbytes) {
+  vkapi::MemoryMap mapping(tensor.buffer(), vkapi::MemoryAccessType::READ);
+  mapping.invalidate();
+  memcpy_from_mapping(mapping, dst, nbytes, tensor.dtype());
+}
+
+void copy_ptr_to_tensor(
+    const void* src,
+    const vkapi::ScalarType data_dtype,
+    api::vTensor& tensor,
+    const size_t numel) {
+  vkapi::MemoryMap mapping(tensor.buffer(), vkapi::MemoryAccessType::WRITE);
+  mapping.invalidate();
+  copy_ptr_to_mapping(src, data_dtype, mapping, tensor.dtype(), numel);
+}
+
+void copy_tensor_to_ptr(
+    api::vTensor& tensor,
+    void* dst,
+    const vkapi::ScalarType data_dtype,
+    const size_t numel) {
+  vkapi::MemoryMap mapping(tensor.buffer(), vkapi::MemoryAccessType::READ);
+  mapping.invalidate();
+  copy_mapping_to_ptr(mapping, tensor.dtype(), dst, data_dtype, numel);
+}
+
 vkapi::ShaderInfo get_nchw_to_tensor_shader(
     const api::vTensor& v_dst,
     const bool int8_buffer_enabled) {
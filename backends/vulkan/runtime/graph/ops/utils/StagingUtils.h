@@ -25,8 +25,46 @@ void copy_staging_to_ptr(
     void* dst,
     const size_t nbytes);
 
+/*
+ * Same as above, but the data pointed to by `src` or `dst` holds `numel`
+ * elements of `data_dtype`, which are converted to or from the dtype of the
+ * staging buffer. Only conversions between kFloat and kHalf are supported.
+ */
+void copy_ptr_to_staging(
+    const void* src,
+    const vkapi::ScalarType data_dtype,
+    api::StorageBuffer& staging,
+    const size_t numel);
+void copy_staging_to_ptr(
+    api::StorageBuffer& staging,
+    void* dst,
+    const vkapi::ScalarType data_dtype,
+    const size_t numel);
+
 void set_staging_zeros(api::StorageBuffer& staging, const size_t nbytes);
 
+//
+// Functions to copy data into and out of a buffer backed tensor whose memory
+// is host visible
+//
+
+void copy_ptr_to_tensor(
+    const void* src,
+    api::vTensor& tensor,
+    const size_t nbytes);
+void copy_tensor_to_ptr(api::vTensor& tensor, void* dst, const size_t nbytes);
+
+void copy_ptr_to_tensor(
+    const void* src,
+    const vkapi::ScalarType data_dtype,
+    api::vTensor& tensor,
+    const size_t numel);
+void copy_tensor_to_ptr(
+    api::vTensor& tensor,
+    void* dst,
+    const vkapi::ScalarType data_dtype,
+    const size_t numel);
+
 //
 // Functions to get shaders
 //
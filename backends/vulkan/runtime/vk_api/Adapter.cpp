@@ -73,6 +73,7 @@ VkDevice create_logical_device(
       VK_KHR_16BIT_STORAGE_EXTENSION_NAME,
       VK_KHR_8BIT_STORAGE_EXTENSION_NAME,
       VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME,
+      VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
   };
 
   std::vector<const char*> enabled_device_extensions;
@@ -181,16 +182,37 @@ void Adapter::submit_cmd(
     const Adapter::Queue& device_queue,
     VkCommandBuffer cmd,
     VkFence fence) {
+  submit_cmds(device_queue, &cmd, 1u, fence);
+}
+
+void Adapter::submit_cmds(
+    const Adapter::Queue& device_queue,
+    const VkCommandBuffer* cmds,
+    const uint32_t cmd_count,
+    VkFence fence,
+    VkSemaphore timeline_semaphore,
+    const uint64_t signal_value) {
+  const bool signal_timeline = timeline_semaphore != VK_NULL_HANDLE;
+
+  const VkTimelineSemaphoreSubmitInfo timeline_info{
+      VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO, // sType
+      nullptr, // pNext
+      0u, // waitSemaphoreValueCount
+      nullptr, // pWaitSemaphoreValues
+      1u, // signalSemaphoreValueCount
+      &signal_value, // pSignalSemaphoreValues
+  };
+
   const VkSubmitInfo submit_info{
       VK_STRUCTURE_TYPE_SUBMIT_INFO, // sType
-      nullptr, // pNext
+      signal_timeline ? &timeline_info : nullptr, // pNext
       0u, // waitSemaphoreCount
       nullptr, // pWaitSemaphores
       nullptr, // pWaitDstStageMask
-      1u, // commandBufferCount
-      &cmd, // pCommandBuffers
-      0u, // signalSemaphoreCount
-      nullptr, // pSignalSemaphores
+      cmd_count, // commandBufferCount
+      cmds, // pCommandBuffers
+      signal_timeline ? 1u : 0u, // signalSemaphoreCount
+      signal_timeline ? &timeline_semaphore : nullptr, // pSignalSemaphores
   };
 
   std::lock_guard<std::mutex> queue_lock(
@@ -258,6 +280,16 @@ std::string Adapter::stringize() const {
   PRINT_PROP(physical_device_.shader_float16_int8_types, shaderInt8);
   ss << "    }" << std::endl;
 
+  ss << "    Timeline Semaphore Features {" << std::endl;
+  PRINT_PROP(physical_device_.timeline_semaphore, timelineSemaphore);
+  ss << "    }" << std::endl;
+
+  ss << "    Subgroup Properties {" << std::endl;
+  PRINT_PROP(physical_device_.subgroup_properties, subgroupSize);
+  PRINT_PROP(physical_device_.subgroup_properties, supportedStages);
+  PRINT_PROP(physical_device_.subgroup_properties, supportedOperations);
+  ss << "    }" << std::endl;
+
   const VkPhysicalDeviceMemoryProperties& mem_props =
       physical_device_.memory_properties;
 
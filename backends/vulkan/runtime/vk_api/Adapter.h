@@ -118,6 +118,18 @@ class Adapter final {
     return physical_device_.timestamp_period;
   }
 
+  inline std::string device_name() const {
+    return physical_device_.properties.deviceName;
+  }
+
+  inline uint32_t driver_version() const {
+    return physical_device_.properties.driverVersion;
+  }
+
+  inline VkDeviceSize min_ubo_alignment() const {
+    return physical_device_.properties.limits.minUniformBufferOffsetAlignment;
+  }
+
   // Queue Management
 
   Queue request_queue();
@@ -179,11 +191,44 @@ class Adapter final {
     return has_8bit_storage() && has_8bit_compute();
   }
 
+  inline uint32_t subgroup_size() const {
+    return physical_device_.subgroup_properties.subgroupSize;
+  }
+
+  // Whether compute shaders can use the subgroup arithmetic and ballot
+  // operations, e.g. subgroupAdd() and subgroupBallot()
+  inline bool has_subgroup_reductions() const {
+    const VkPhysicalDeviceSubgroupProperties& props =
+        physical_device_.subgroup_properties;
+    const VkSubgroupFeatureFlags required_ops = VK_SUBGROUP_FEATURE_BASIC_BIT |
+        VK_SUBGROUP_FEATURE_ARITHMETIC_BIT | VK_SUBGROUP_FEATURE_BALLOT_BIT;
+    return (props.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+        (props.supportedOperations & required_ops) == required_ops &&
+        props.subgroupSize > 0u;
+  }
+
+  inline bool has_timeline_semaphore() const {
+    return physical_device_.timeline_semaphore.timelineSemaphore == VK_TRUE;
+  }
+
   // Command Buffer Submission
 
   void
   submit_cmd(const Queue&, VkCommandBuffer, VkFence fence = VK_NULL_HANDLE);
 
+  /*
+   * Submits several command buffers in a single queue submission. They
+   * execute in the order given. If a timeline semaphore is provided, it is
+   * set to signal_value once all of them have completed.
+   */
+  void submit_cmds(
+      const Queue&,
+      const VkCommandBuffer* cmds,
+      const uint32_t cmd_count,
+      VkFence fence = VK_NULL_HANDLE,
+      VkSemaphore timeline_semaphore = VK_NULL_HANDLE,
+      const uint64_t signal_value = 0u);
+
   std::string stringize() const;
   friend std::ostream& operator<<(std::ostream&, const Adapter&);
 };
@@ -179,6 +179,19 @@ void CommandBuffer::dispatch(const utils::uvec3& global_workgroup_size) {
   state_ = CommandBuffer::State::RECORDING;
 }
 
+void CommandBuffer::dispatch_indirect(
+    VkBuffer buffer,
+    const VkDeviceSize offset) {
+  VK_CHECK_COND(
+      state_ == CommandBuffer::State::BARRIERS_INSERTED,
+      "Vulkan CommandBuffer: called dispatch_indirect() on a command buffer "
+      "whose state is not BARRIERS_INSERTED.");
+
+  vkCmdDispatchIndirect(handle_, buffer, offset);
+
+  state_ = CommandBuffer::State::RECORDING;
+}
+
 void CommandBuffer::write_timestamp(VkQueryPool querypool, const uint32_t idx)
     const {
   VK_CHECK_COND(
@@ -28,6 +28,14 @@ BufferBindInfo::BufferBindInfo(const VulkanBuffer& buffer_p)
       offset(buffer_p.mem_offset()),
       range(buffer_p.mem_range()) {}
 
+BufferBindInfo::BufferBindInfo(
+    const VulkanBuffer& buffer_p,
+    const VkDeviceSize offset_p,
+    const VkDeviceSize range_p)
+    : handle(buffer_p.handle()),
+      offset(buffer_p.mem_offset() + offset_p),
+      range(range_p) {}
+
 //
 // ParamsBindList
 //
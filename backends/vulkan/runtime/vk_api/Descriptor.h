@@ -34,6 +34,11 @@ struct BufferBindInfo final {
 
   BufferBindInfo();
   BufferBindInfo(const VulkanBuffer& buffer_p);
+  // Binds range bytes of the buffer, starting offset bytes into it
+  BufferBindInfo(
+      const VulkanBuffer& buffer_p,
+      const VkDeviceSize offset,
+      const VkDeviceSize range);
 };
 
 struct ParamsBindList final {
@@ -22,12 +22,16 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
     : handle(physical_device_handle),
       properties{},
       memory_properties{},
+      subgroup_properties{
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES},
       shader_16bit_storage{
           VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES},
       shader_8bit_storage{
           VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_8BIT_STORAGE_FEATURES},
       shader_float16_int8_types{
           VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR},
+      timeline_semaphore{
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES},
       queue_families{},
       num_compute_queues(0),
       has_unified_memory(false),
@@ -38,6 +42,11 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
   vkGetPhysicalDeviceProperties(handle, &properties);
   vkGetPhysicalDeviceMemoryProperties(handle, &memory_properties);
 
+  VkPhysicalDeviceProperties2 properties2{
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+  properties2.pNext = &subgroup_properties;
+  vkGetPhysicalDeviceProperties2(handle, &properties2);
+
   VkPhysicalDeviceFeatures2 features2{
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
 
@@ -45,16 +54,18 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
   features2.pNext = &shader_16bit_storage;
   shader_16bit_storage.pNext = &shader_8bit_storage;
   shader_8bit_storage.pNext = &shader_float16_int8_types;
-  shader_float16_int8_types.pNext = nullptr;
+  shader_float16_int8_types.pNext = &timeline_semaphore;
+  timeline_semaphore.pNext = nullptr;
 
   vkGetPhysicalDeviceFeatures2(handle, &features2);
 
   // Check if there are any memory types have both the HOST_VISIBLE and the
   // DEVICE_LOCAL property flags
   const VkMemoryPropertyFlags unified_memory_flags =
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
   for (size_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
-    if (memory_properties.memoryTypes[i].propertyFlags | unified_memory_flags) {
+    if ((memory_properties.memoryTypes[i].propertyFlags &
+         unified_memory_flags) == unified_memory_flags) {
       has_unified_memory = true;
       break;
     }
@@ -25,10 +25,12 @@ struct PhysicalDevice final {
   // Properties obtained from Vulkan
   VkPhysicalDeviceProperties properties;
   VkPhysicalDeviceMemoryProperties memory_properties;
+  VkPhysicalDeviceSubgroupProperties subgroup_properties;
   // Additional features available from extensions
   VkPhysicalDevice16BitStorageFeatures shader_16bit_storage;
   VkPhysicalDevice8BitStorageFeatures shader_8bit_storage;
   VkPhysicalDeviceShaderFloat16Int8Features shader_float16_int8_types;
+  VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore;
 
   // Available GPU queues
   std::vector<VkQueueFamilyProperties> queue_families;
@@ -72,5 +72,95 @@ void VulkanFence::wait() {
   }
 }
 
+TimelineSemaphore::TimelineSemaphore()
+    : device_(VK_NULL_HANDLE), handle_(VK_NULL_HANDLE), last_value_(0u) {}
+
+TimelineSemaphore::TimelineSemaphore(VkDevice device)
+    : device_(device), handle_(VK_NULL_HANDLE), last_value_(0u) {
+  const VkSemaphoreTypeCreateInfo type_create_info{
+      VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO, // sType
+      nullptr, // pNext
+      VK_SEMAPHORE_TYPE_TIMELINE, // semaphoreType
+      0u, // initialValue
+  };
+
+  const VkSemaphoreCreateInfo semaphore_create_info{
+      VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, // sType
+      &type_create_info, // pNext
+      0u, // flags
+  };
+
+  VK_CHECK(
+      vkCreateSemaphore(device_, &semaphore_create_info, nullptr, &handle_));
+}
+
+TimelineSemaphore::TimelineSemaphore(TimelineSemaphore&& other) noexcept
+    : device_(other.device_),
+      handle_(other.handle_),
+      last_value_(other.last_value_) {
+  other.handle_ = VK_NULL_HANDLE;
+  other.last_value_ = 0u;
+}
+
+TimelineSemaphore& TimelineSemaphore::operator=(
+    TimelineSemaphore&& other) noexcept {
+  if (VK_NULL_HANDLE != handle_) {
+    vkDestroySemaphore(device_, handle_, nullptr);
+  }
+
+  device_ = other.device_;
+  handle_ = other.handle_;
+  last_value_ = other.last_value_;
+
+  other.device_ = VK_NULL_HANDLE;
+  other.handle_ = VK_NULL_HANDLE;
+  other.last_value_ = 0u;
+
+  return *this;
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+  if (VK_NULL_HANDLE == handle_) {
+    return;
+  }
+  vkDestroySemaphore(device_, handle_, nullptr);
+}
+
+uint64_t TimelineSemaphore::completed_value() const {
+  if (VK_NULL_HANDLE == handle_) {
+    return last_value_;
+  }
+  uint64_t value = 0u;
+  VK_CHECK(vkGetSemaphoreCounterValueKHR(device_, handle_, &value));
+  return value;
+}
+
+void TimelineSemaphore::wait(const uint64_t value) const {
+  if (VK_NULL_HANDLE == handle_) {
+    return;
+  }
+
+  const VkSemaphoreWaitInfo wait_info{
+      VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO, // sType
+      nullptr, // pNext
+      0u, // flags
+      1u, // semaphoreCount
+      &handle_, // pSemaphores
+      &value, // pValues
+  };
+
+  VkResult wait_status = VK_TIMEOUT;
+  // As with VulkanFence::wait(), wait in a loop with a short timeout to keep
+  // the CPU hot
+  do {
+    // The timeout (last) arg is in units of ns
+    wait_status = vkWaitSemaphoresKHR(device_, &wait_info, 100000);
+
+    VK_CHECK_COND(
+        wait_status != VK_ERROR_DEVICE_LOST,
+        "Vulkan TimelineSemaphore: Device lost while waiting for semaphore!");
+  } while (wait_status != VK_SUCCESS);
+}
+
 } // namespace vkapi
 } // namespace vkcompute
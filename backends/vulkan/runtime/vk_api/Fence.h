@@ -66,6 +66,58 @@ class VulkanFence final {
   }
 };
 
+// A timeline semaphore, i.e. a semaphore holding a 64 bit counter that queue
+// submissions set when they complete. Unlike a fence, it does not need to be
+// reset, and the host can check or wait for any submission that signals it.
+class TimelineSemaphore final {
+ public:
+  explicit TimelineSemaphore();
+
+  explicit TimelineSemaphore(VkDevice);
+
+  TimelineSemaphore(const TimelineSemaphore&) = delete;
+  TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+
+  TimelineSemaphore(TimelineSemaphore&&) noexcept;
+  TimelineSemaphore& operator=(TimelineSemaphore&&) noexcept;
+
+  ~TimelineSemaphore();
+
+ private:
+  VkDevice device_;
+  VkSemaphore handle_;
+  // The last value that a queue submission was asked to signal
+  uint64_t last_value_;
+
+ public:
+  VkSemaphore handle() const {
+    return handle_;
+  }
+
+  // Returns the value that the next queue submission should signal
+  uint64_t next_value() {
+    return ++last_value_;
+  }
+
+  uint64_t last_value() const {
+    return last_value_;
+  }
+
+  // Returns the largest value signaled so far
+  uint64_t completed_value() const;
+
+  bool is_complete(const uint64_t value) const {
+    return completed_value() >= value;
+  }
+
+  // Trigger a synchronous wait for the semaphore to reach the value
+  void wait(const uint64_t value) const;
+
+  operator bool() const {
+    return (VK_NULL_HANDLE != handle_);
+  }
+};
+
 // A pool to track created Fences and reuse ones that are available.
 // Only intended to be modified by one thread at a time.
 struct FencePool final {
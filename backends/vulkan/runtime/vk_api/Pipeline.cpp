@@ -8,6 +8,7 @@
 
 #include <executorch/backends/vulkan/runtime/vk_api/Pipeline.h>
 
+#include <cstdio>
 #include <fstream>
 
 namespace vkcompute {
@@ -371,7 +372,8 @@ ComputePipelineCache::ComputePipelineCache(
       device_(device),
       pipeline_cache_{VK_NULL_HANDLE},
       cache_{},
-      cache_data_path_(cache_data_path) {
+      cache_data_path_(cache_data_path),
+      num_saved_pipelines_{0u} {
   VkPipelineCacheCreateInfo pipeline_cache_create_info{};
 
   auto buffer = load_cache();
@@ -393,21 +395,25 @@ ComputePipelineCache::ComputePipelineCache(
     : cache_mutex_{},
       device_(other.device_),
       pipeline_cache_(other.pipeline_cache_),
-      cache_(std::move(other.cache_)) {
+      cache_(std::move(other.cache_)),
+      cache_data_path_(std::move(other.cache_data_path_)),
+      num_saved_pipelines_(other.num_saved_pipelines_) {
   std::lock_guard<std::mutex> lock(other.cache_mutex_);
 
   other.pipeline_cache_ = VK_NULL_HANDLE;
 }
 
 ComputePipelineCache::~ComputePipelineCache() {
+  if (VK_NULL_HANDLE != pipeline_cache_) {
+    save_cache();
+  }
+
   purge();
 
   if (VK_NULL_HANDLE == pipeline_cache_) {
     return;
   }
 
-  save_cache();
-
   vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
   pipeline_cache_ = VK_NULL_HANDLE;
 }
@@ -453,15 +459,79 @@ std::vector<char> ComputePipelineCache::load_cache() {
   return buffer;
 }
 
+void ComputePipelineCache::set_cache_data_path(
+    const std::string& cache_data_path) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  if (cache_data_path == cache_data_path_) {
+    return;
+  }
+  cache_data_path_ = cache_data_path;
+
+  auto buffer = load_cache();
+  if (buffer.empty()) {
+    return;
+  }
+
+  // Pipelines may already have been created with pipeline_cache_, so merge the
+  // stored data into it rather than replacing it
+  const VkPipelineCacheCreateInfo pipeline_cache_create_info{
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, // sType
+      nullptr, // pNext
+      0u, // flags
+      buffer.size(), // initialDataSize
+      buffer.data(), // pInitialData
+  };
+
+  VkPipelineCache stored_cache{VK_NULL_HANDLE};
+  VK_CHECK(vkCreatePipelineCache(
+      device_, &pipeline_cache_create_info, nullptr, &stored_cache));
+  const VkResult result =
+      vkMergePipelineCaches(device_, pipeline_cache_, 1u, &stored_cache);
+  vkDestroyPipelineCache(device_, stored_cache, nullptr);
+  VK_CHECK(result);
+}
+
 void ComputePipelineCache::save_cache() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  // Return if path is not specified, or if no pipelines were created since the
+  // cache data was last loaded or saved
+  if (cache_data_path_.empty() || cache_.size() == num_saved_pipelines_) {
+    return;
+  }
+
+  // This is called from the destructor, so failures are ignored rather than
+  // thrown; the cache is only an optimization
   size_t size{};
-  vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr);
+  if (VK_SUCCESS !=
+      vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr)) {
+    return;
+  }
 
   std::vector<char> buffer(size);
-  vkGetPipelineCacheData(device_, pipeline_cache_, &size, buffer.data());
+  if (VK_SUCCESS !=
+      vkGetPipelineCacheData(device_, pipeline_cache_, &size, buffer.data())) {
+    return;
+  }
+
+  // Write to a temporary file and rename it so that a process that is killed
+  // while saving, or that loads the cache concurrently, never sees a partially
+  // written file
+  const std::string tmp_path = cache_data_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), size);
+    if (file.fail()) {
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_data_path_.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return;
+  }
 
-  std::ofstream file(cache_data_path_, std::ios::binary);
-  file.write(buffer.data(), buffer.size());
+  num_saved_pipelines_ = cache_.size();
 }
 
 } // namespace vkapi
@@ -271,7 +271,6 @@ class ComputePipelineCache final {
 
  private:
   std::vector<char> load_cache();
-  void save_cache();
 
   // Multiple threads could potentially be adding entries into the cache, so use
   // a mutex to manage access
@@ -280,11 +279,26 @@ class ComputePipelineCache final {
   VkDevice device_;
   VkPipelineCache pipeline_cache_;
   std::unordered_map<Key, Value, Hasher> cache_;
-  const std::string cache_data_path_;
+  std::string cache_data_path_;
+  // Number of pipelines in cache_ when the cache data was last loaded or saved
+  size_t num_saved_pipelines_;
 
  public:
   VkPipeline retrieve(const Key&);
   void purge();
+
+  /*
+   * Sets the file that the pipeline cache data is persisted to, and merges
+   * the data already stored in it into the cache. A missing or incompatible
+   * file is ignored, and will be overwritten by the next save_cache().
+   */
+  void set_cache_data_path(const std::string& cache_data_path);
+
+  /*
+   * Writes the pipeline cache data to the cache data path, if one is set and
+   * pipelines were created since the data was last loaded or saved.
+   */
+  void save_cache();
 };
 
 //
@@ -75,6 +75,15 @@ void QueryPool::initialize(const Adapter* adapter_p) {
   VK_CHECK(vkCreateQueryPool(device_, &info, nullptr, &querypool_));
 }
 
+void QueryPool::deinitialize() {
+  EARLY_RETURN_IF_UNINITIALIZED();
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  vkDestroyQueryPool(device_, querypool_, nullptr);
+  querypool_ = VK_NULL_HANDLE;
+  reset_state();
+}
+
 size_t QueryPool::write_timestamp(const CommandBuffer& cmd) {
   VK_CHECK_COND(
       num_queries_ < config_.max_query_count,
@@ -78,6 +78,12 @@ class QueryPool final {
 
   void initialize(const Adapter* adapter_p);
 
+  /*
+   * Destroys the query pool, after which no timestamps are recorded until it
+   * is initialized again.
+   */
+  void deinitialize();
+
  private:
   size_t write_timestamp(const CommandBuffer&);
 
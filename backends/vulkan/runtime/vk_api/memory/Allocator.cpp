@@ -173,6 +173,19 @@ VulkanBuffer Allocator::create_staging_buffer(const VkDeviceSize size) {
   return VulkanBuffer(allocator_, size, alloc_create_info, buffer_usage);
 }
 
+VulkanBuffer Allocator::create_indirect_buffer(const VkDeviceSize size) {
+  VmaAllocationCreateInfo alloc_create_info = {};
+  alloc_create_info.flags = DEFAULT_ALLOCATION_STRATEGY |
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+  alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO;
+
+  VkBufferUsageFlags buffer_usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+  VulkanBuffer indirect_buffer(
+      allocator_, size, alloc_create_info, buffer_usage);
+  return indirect_buffer;
+}
+
 VulkanBuffer Allocator::create_uniform_buffer(const VkDeviceSize size) {
   VmaAllocationCreateInfo alloc_create_info = {};
   alloc_create_info.flags = DEFAULT_ALLOCATION_STRATEGY |
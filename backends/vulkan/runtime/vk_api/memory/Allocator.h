@@ -74,6 +74,12 @@ class Allocator final {
    */
   VulkanBuffer create_uniform_buffer(const VkDeviceSize);
 
+  /*
+   * Create a host writable buffer holding the work group counts of an
+   * indirect dispatch
+   */
+  VulkanBuffer create_indirect_buffer(const VkDeviceSize);
+
   /*
    * Create a uniform buffer containing the data in an arbitrary struct
    */
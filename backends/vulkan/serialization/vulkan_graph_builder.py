@@ -148,6 +148,10 @@ class VkGraphBuilder:
             new_id = self.create_value_list_value(spec)
             self.node_to_value_ids[node] = new_id
             return new_id
+        elif isinstance(node.meta.get("val"), torch.SymInt):
+            new_id = self.create_symint_value()
+            self.node_to_value_ids[node] = new_id
+            return new_id
         else:
             raise RuntimeError(f"Cannot create value for spec of type {type(spec)}")
 
@@ -166,6 +170,11 @@ class VkGraphBuilder:
             self.values.append(vk_graph_schema.VkValue(vk_graph_schema.Double(scalar)))
         return new_id
 
+    def create_symint_value(self) -> int:
+        new_id = len(self.values)
+        self.values.append(vk_graph_schema.VkValue(vk_graph_schema.SymInt(0)))
+        return new_id
+
     def create_tensor_value(self, spec: TensorSpec, constant_id: int = -1) -> int:
         # Negative id indicates that this tensor will have its own dedicated memory.
         mem_obj_id = -1
@@ -100,6 +100,11 @@ class String:
     string_val: str
 
 
+@dataclass
+class SymInt:
+    value: int
+
+
 GraphTypes = Union[
     Null,
     Int,
@@ -111,6 +116,7 @@ GraphTypes = Union[
     DoubleList,
     ValueList,
     String,
+    SymInt,
 ]
 
 
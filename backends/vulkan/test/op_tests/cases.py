@@ -133,6 +133,10 @@ def get_linear_inputs():
     inputs_list += [((3, M, K), (N, K), None) for M, K, N in MKN_list]
     inputs_list += [((3, M, K), (N, K), (N)) for M, K, N in MKN_list]
     inputs_list += [((3, 6, K), (N, K), (N)) for M, K, N in MKN_list]
+    # A single row, as in LLM decoding
+    inputs_list += [((1, K), (N, K), None) for M, K, N in MKN_list]
+    inputs_list += [((1, K), (N, K), (N)) for M, K, N in MKN_list]
+    inputs_list += [((3, 1, K), (N, K), (N)) for M, K, N in MKN_list]
 
     test_suite = VkTestSuite(inputs_list)
     test_suite.dtypes = ["at::kFloat"]
@@ -148,6 +152,7 @@ def get_weight_int8pack_mm_inputs():
     MKN_list = common_MKN_list
 
     inputs_list = [((M, K), (N, K), (N)) for M, K, N in MKN_list]
+    inputs_list += [((1, K), (N, K), (N)) for M, K, N in MKN_list]
 
     test_suite = VkTestSuite(inputs_list)
     test_suite.dtypes = ["at::kFloat", "at::kHalf"]
@@ -8,6 +8,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
 #include <utility>
 #include <vector>
 
@@ -538,6 +540,40 @@ TEST_F(VulkanComputeAPITest, texture_add_sanity_check) {
   }
 }
 
+TEST_F(VulkanComputeAPITest, pipeline_cache_save_test) {
+  const std::string cache_path = "vulkan_compute_api_test_pipeline_cache.bin";
+  std::remove(cache_path.c_str());
+
+  vkapi::ComputePipelineCache& pipeline_cache = context()->pipeline_cache();
+  pipeline_cache.set_cache_data_path(cache_path);
+
+  // Make sure that at least one pipeline was compiled
+  std::vector<int64_t> sizes = {4, 4, 1};
+  vTensor a = CREATE_FLOAT_TEXTURE(sizes, /*allocate_memory = */ true);
+  vTensor b = CREATE_FLOAT_TEXTURE(sizes, /*allocate_memory = */ true);
+  vTensor c = CREATE_FLOAT_TEXTURE(sizes, /*allocate_memory = */ true);
+  fill_vtensor(a, 2.5f);
+  fill_vtensor(b, 1.5f);
+  record_binary_op(context(), "add", a, b, c);
+  extract_vtensor(c);
+
+  pipeline_cache.save_cache();
+
+  {
+    std::ifstream file(cache_path, std::ios::binary | std::ios::ate);
+    ASSERT_TRUE(file.good());
+    EXPECT_GT(file.tellg(), 0);
+  }
+
+  // Loading the saved data back must be accepted by the driver
+  pipeline_cache.set_cache_data_path("");
+  pipeline_cache.set_cache_data_path(cache_path);
+
+  // Stop persisting the cache so that later tests don't write the file
+  pipeline_cache.set_cache_data_path("");
+  std::remove(cache_path.c_str());
+}
+
 TEST_F(VulkanComputeAPITest, tensor_copy_test) {
   std::vector<int64_t> sizes = {9, 9};
   std::vector<int64_t> strides =
@@ -1224,6 +1260,307 @@ TEST(VulkanComputeGraphTest, test_simple_prepacked_graph) {
   }
 }
 
+TEST(VulkanComputeGraphTest, test_prepacked_graph_in_batches) {
+  GraphConfig config;
+  // Submit the prepacking commands of every node separately
+  config.prepack_threshold_nbytes = 1;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+  std::vector<int64_t> size_small = {8, 73, 1};
+
+  CREATE_WEIGHT_TENSOR(w1, size_small, vkapi::kFloat, 3.5f);
+  CREATE_WEIGHT_TENSOR(w2, size_small, vkapi::kFloat, 3.0f);
+  CREATE_WEIGHT_TENSOR(w3, size_small, vkapi::kFloat, 1.5f);
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+
+  ValueRef c = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef d = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef e = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, w1, kDummyValueRef, c});
+
+  auto mulFn = VK_GET_OP_FN("aten.mul.Tensor");
+  mulFn(graph, {c, w2, d});
+
+  addFn(graph, {d, w3, kDummyValueRef, e});
+
+  IOValueRef out = {};
+  out.value = e;
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+
+  graph.encode_prepack();
+  graph.prepack();
+
+  graph.encode_execute();
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_out = (i + 3.5f) * 3.0f + 1.5f;
+
+    fill_vtensor(graph, a, i);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_deferred_prepack_and_async_execute) {
+  GraphConfig config;
+  // Submit the prepacking commands with the first execution
+  config.defer_prepack_submit = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+  std::vector<int64_t> size_small = {8, 73, 1};
+
+  CREATE_WEIGHT_TENSOR(w1, size_small, vkapi::kFloat, 3.5f);
+  CREATE_WEIGHT_TENSOR(w2, size_small, vkapi::kFloat, 3.0f);
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+
+  ValueRef c = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef e = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, w1, kDummyValueRef, c});
+
+  auto mulFn = VK_GET_OP_FN("aten.mul.Tensor");
+  mulFn(graph, {c, w2, e});
+
+  IOValueRef out = {};
+  out.value = e;
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+
+  graph.encode_prepack();
+  graph.prepack();
+  EXPECT_TRUE(graph.context()->has_batched_cmds());
+
+  graph.encode_execute();
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_out = (i + 3.5f) * 3.0f;
+
+    fill_vtensor(graph, a, i);
+
+    graph.execute_async();
+    EXPECT_FALSE(graph.context()->has_batched_cmds());
+    graph.wait_for_execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_graph_with_memory_planning) {
+  GraphConfig config;
+  config.enable_memory_planning = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+  std::vector<int64_t> size_small = {8, 73, 1};
+
+  CREATE_WEIGHT_TENSOR(w1, size_small, vkapi::kFloat, 3.5f);
+  CREATE_WEIGHT_TENSOR(w2, size_small, vkapi::kFloat, 3.0f);
+
+  // Build graph. c is dead once d is computed, and d once e is computed, so
+  // e can reuse the memory of c, and f the memory of d.
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+
+  ValueRef c = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef d = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef e = graph.add_tensor(size_big, vkapi::kFloat);
+  ValueRef f = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  auto mulFn = VK_GET_OP_FN("aten.mul.Tensor");
+  addFn(graph, {a.value, w1, kDummyValueRef, c});
+  mulFn(graph, {c, w2, d});
+  addFn(graph, {d, w1, kDummyValueRef, e});
+  mulFn(graph, {e, w2, f});
+
+  IOValueRef out = {};
+  out.value = f;
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+
+  graph.encode_prepack();
+  graph.prepack();
+
+  graph.encode_execute();
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_out = (((i + 3.5f) * 3.0f) + 3.5f) * 3.0f;
+
+    fill_vtensor(graph, a, i);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_graph_with_host_visible_io) {
+  GraphConfig config;
+  config.enable_memory_planning = true;
+  config.enable_host_visible_io = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+  std::vector<int64_t> size_small = {8, 73, 1};
+
+  CREATE_WEIGHT_TENSOR(w1, size_small, vkapi::kFloat, 3.5f);
+
+  IOValueRef a =
+      graph.add_input_tensor(size_big, vkapi::kFloat, utils::kBuffer);
+
+  ValueRef c = graph.add_tensor(size_big, vkapi::kFloat, utils::kBuffer);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, w1, kDummyValueRef, c});
+
+  IOValueRef out = {};
+  out.value = c;
+  out.staging = graph.set_output_tensor(out.value);
+
+  // Inputs and outputs are accessed directly if the device has unified memory
+  if (graph.context()->adapter_ptr()->has_unified_memory()) {
+    EXPECT_TRUE(a.staging == a.value);
+    EXPECT_TRUE(out.staging == out.value);
+  } else {
+    EXPECT_TRUE(graph.val_is_staging(a.staging));
+    EXPECT_TRUE(graph.val_is_staging(out.staging));
+  }
+
+  graph.prepare();
+
+  graph.encode_prepack();
+  graph.prepack();
+
+  graph.encode_execute();
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_out = i + 3.5f;
+
+    fill_vtensor(graph, a, i);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_graph_with_fp16) {
+  GraphConfig config;
+  config.enable_fp16 = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 73, 62};
+  std::vector<int64_t> size_small = {8, 73, 1};
+
+  CREATE_WEIGHT_TENSOR(w1, size_small, vkapi::kFloat, 3.5f);
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+
+  ValueRef c = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, w1, kDummyValueRef, c});
+
+  IOValueRef out = {};
+  out.value = c;
+  out.staging = graph.set_output_tensor(out.value);
+
+  // Float tensors are stored as half if the device supports it
+  const vkapi::ScalarType stored_dtype =
+      graph.context()->adapter_ptr()->has_full_float16_buffers_support()
+      ? vkapi::kHalf
+      : vkapi::kFloat;
+  EXPECT_TRUE(graph.dtype_of(a.value) == stored_dtype);
+  EXPECT_TRUE(graph.dtype_of(c) == stored_dtype);
+
+  graph.prepare();
+
+  graph.encode_prepack();
+  graph.prepack();
+
+  graph.encode_execute();
+
+  // Run graph, passing float data that is converted when staged
+
+  const size_t numel = utils::multiply_integers(size_big);
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_out = i + 3.5f;
+
+    std::vector<float> data_a(numel, i);
+    graph.copy_into_staging(a.staging, data_a.data(), vkapi::kFloat, numel);
+
+    graph.execute();
+
+    std::vector<float> data_out(numel);
+    graph.copy_from_staging(
+        out.staging, data_out.data(), vkapi::kFloat, numel);
+
+    // The inputs and result are exactly representable as half
+    for (size_t i = 0; i < numel; ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_params_buffers_are_packed) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  const size_t initial_count = get_vma_allocation_count();
+
+  const vkapi::BufferBindInfo sizes =
+      graph.create_params_buffer(utils::make_ivec4({1, 2, 3, 4}));
+  const vkapi::BufferBindInfo alpha = graph.create_params_buffer(1.5f);
+
+  // Both params are packed into one uniform buffer, at aligned offsets
+  EXPECT_TRUE(get_vma_allocation_count() == initial_count + 1);
+  EXPECT_TRUE(sizes.handle == alpha.handle);
+  EXPECT_TRUE(sizes.range == sizeof(utils::ivec4));
+  EXPECT_TRUE(alpha.range == sizeof(float));
+  EXPECT_TRUE(alpha.offset >= sizes.offset + sizes.range);
+  EXPECT_TRUE(
+      alpha.offset % graph.context()->adapter_ptr()->min_ubo_alignment() == 0);
+}
+
 TEST(VulkanComputeGraphTest, test_simple_shared_objects_with_resize) {
   GraphConfig config;
   ComputeGraph graph(config);
@@ -1259,10 +1596,11 @@ TEST(VulkanComputeGraphTest, test_simple_shared_objects_with_resize) {
       vkapi::kFloat,
       /*shared_object_idx = */ 2);
 
-  // +2: alpha UBO, broadcast UBO for arithmetic shader
+  // +1: uniform buffer that the alpha and broadcast params of the arithmetic
+  //     shader are packed into
   // +1: t.sizes_ubo() uniform buffer for staging shader
   // +1: staging buffer for the input tensor
-  EXPECT_TRUE(get_vma_allocation_count() == 9);
+  EXPECT_TRUE(get_vma_allocation_count() == 8);
 
   ValueRef e = graph.add_tensor(
       size_big,
@@ -1276,16 +1614,17 @@ TEST(VulkanComputeGraphTest, test_simple_shared_objects_with_resize) {
   out.value = e;
   out.staging = graph.set_output_tensor(out.value);
 
-  // +2: alpha UBO, broadcast UBO for arithmetic shader
+  // +0: alpha and broadcast params for arithmetic shader, which are packed
+  //     into the uniform buffer of the previous params
   // +1: t.sizes_ubo() for staging shader
   // +1 staging buffer for the input tensor
-  EXPECT_TRUE(get_vma_allocation_count() == 13);
+  EXPECT_TRUE(get_vma_allocation_count() == 10);
 
   graph.prepare();
   graph.encode_execute();
 
   // +3: shared memory allocations for tensors
-  EXPECT_TRUE(get_vma_allocation_count() == 16);
+  EXPECT_TRUE(get_vma_allocation_count() == 13);
 
   // Run graph
 
@@ -1352,9 +1691,10 @@ TEST(VulkanComputeGraphTest, test_simple_shared_objects_with_resize) {
   }
 }
 
-TEST(VulkanComputeGraphTest, test_large_graph) {
+void run_large_graph_test(
+    const GraphConfig& config,
+    const bool tune_local_wg_sizes = false) {
   auto build_start_time = std::chrono::system_clock::now();
-  GraphConfig config;
   ComputeGraph graph(config);
 
   int64_t input_w = 256;
@@ -1391,6 +1731,9 @@ TEST(VulkanComputeGraphTest, test_large_graph) {
 
   graph.prepare();
   graph.encode_execute();
+  if (tune_local_wg_sizes) {
+    graph.tune_local_wg_sizes();
+  }
 
   auto build_end_time = std::chrono::system_clock::now();
 
@@ -1446,6 +1789,25 @@ TEST(VulkanComputeGraphTest, test_large_graph) {
   std::cout << ss.str();
 }
 
+TEST(VulkanComputeGraphTest, test_large_graph) {
+  GraphConfig config;
+  run_large_graph_test(config);
+}
+
+TEST(VulkanComputeGraphTest, test_large_graph_with_indirect_dispatch) {
+  // Resizing shrinks the dispatches of the add nodes
+  GraphConfig config;
+  config.enable_indirect_dispatch = true;
+  run_large_graph_test(config);
+}
+
+TEST(VulkanComputeGraphTest, test_large_graph_with_local_wg_size_tuning) {
+  // Results must not depend on the local work group sizes that were picked
+  GraphConfig config;
+  config.enable_local_wg_size_tuning = true;
+  run_large_graph_test(config, /*tune_local_wg_sizes=*/true);
+}
+
 TEST(VulkanComputeGraphTest, test_etvk_copy_offset_node) {
   GraphConfig config;
   ComputeGraph graph(config);
@@ -2565,3 +2927,175 @@ TEST(VulkanComputeGraphOpsTest, grid_priors_test) {
       /*offset = */ 0.5,
       /*data_out_expected = */ {4, 4, 12, 4, 20, 4, 4, 12, 12, 12, 20, 12});
 }
+
+void test_linear_weight_int4(
+    const int64_t M,
+    const int64_t N,
+    const int64_t K,
+    const int64_t group_size,
+    const bool has_zeros) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  IOValueRef mat1 = graph.add_input_tensor(
+      {M, K}, vkapi::kFloat, utils::GPUMemoryLayout::TENSOR_WIDTH_PACKED);
+
+  // Every byte holds the int4 values 9 and 10, i.e. weights of 1 and 2 before
+  // the zero point is applied
+  std::vector<uint8_t> data_weight(N * K / 2, 0x9A);
+  ValueRef weight =
+      graph.add_tensorref({N, K / 2}, vkapi::kByte, data_weight.data());
+  std::vector<int64_t> qparams_sizes = {N, K / group_size};
+  CREATE_WEIGHT_TENSOR(scales, qparams_sizes, vkapi::kFloat, 0.5f);
+  CREATE_WEIGHT_TENSOR(zeros, qparams_sizes, vkapi::kFloat, 1.0f);
+
+  IOValueRef out;
+  out.value = graph.add_tensor(
+      {M, N}, vkapi::kFloat, utils::GPUMemoryLayout::TENSOR_WIDTH_PACKED);
+
+  VK_GET_OP_FN("et_vk.linear_weight_int4.default")
+  (graph,
+   {mat1.value,
+    weight,
+    scales,
+    has_zeros ? zeros : graph.add_none(),
+    graph.add_scalar<int64_t>(group_size),
+    out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_prepack();
+  graph.prepack();
+  graph.encode_execute();
+
+  // Without zero points the weights alternate between 1 and 2, with a zero
+  // point of 1 between 0 and 1
+  const float weight_sum = has_zeros ? K / 2 : K / 2 * 3;
+  for (float val : {1.0f, 2.5f}) {
+    execute_graph_and_check_output(graph, {val}, {val * weight_sum * 0.5f});
+  }
+}
+
+TEST(VulkanComputeGraphOpsTest, linear_weight_int4_test) {
+  test_linear_weight_int4(
+      /*M = */ 3, /*N = */ 10, /*K = */ 128, /*group_size = */ 32, false);
+  test_linear_weight_int4(
+      /*M = */ 3, /*N = */ 10, /*K = */ 128, /*group_size = */ 64, true);
+  // Few rows, which may use the subgroup shader
+  test_linear_weight_int4(
+      /*M = */ 1, /*N = */ 36, /*K = */ 256, /*group_size = */ 128, true);
+}
+
+void test_embedding_4bit(const bool has_zeros) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  const int64_t V = 5;
+  const int64_t D = 64;
+
+  // Row v of the table holds the int4 value v + 8 in every nibble, so that it
+  // is dequantized to v * scale without zero points
+  std::vector<uint8_t> data_weight(V * D / 2);
+  for (int64_t v = 0; v < V; ++v) {
+    std::fill(
+        data_weight.begin() + v * D / 2,
+        data_weight.begin() + (v + 1) * D / 2,
+        static_cast<uint8_t>((v + 8) * 0x11));
+  }
+  ValueRef weight =
+      graph.add_tensorref({V, D / 2}, vkapi::kByte, data_weight.data());
+  std::vector<int64_t> qparams_sizes = {V, 2};
+  CREATE_WEIGHT_TENSOR(scales, qparams_sizes, vkapi::kFloat, 0.5f);
+  CREATE_WEIGHT_TENSOR(zeros, qparams_sizes, vkapi::kFloat, 1.0f);
+
+  std::vector<int32_t> data_indices(6, 3);
+  ValueRef indices =
+      graph.add_tensorref({2, 3}, vkapi::kInt, data_indices.data());
+
+  IOValueRef out;
+  out.value = graph.add_tensor(
+      {2, 3, D}, vkapi::kFloat, utils::GPUMemoryLayout::TENSOR_WIDTH_PACKED);
+
+  VK_GET_OP_FN("quantized_decomposed.embedding_4bit.default")
+  (graph,
+   {weight,
+    scales,
+    has_zeros ? zeros : graph.add_none(),
+    graph.add_scalar<int64_t>(-8),
+    graph.add_scalar<int64_t>(7),
+    indices,
+    out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_prepack();
+  graph.prepack();
+  graph.encode_execute();
+
+  execute_graph_and_check_output(graph, {}, {has_zeros ? 1.0f : 1.5f});
+}
+
+TEST(VulkanComputeGraphOpsTest, embedding_4bit_test) {
+  test_embedding_4bit(false);
+  test_embedding_4bit(true);
+}
+
+TEST(VulkanComputeGraphOpsTest, sdpa_with_kv_cache_test) {
+  GraphConfig config;
+  ComputeGraph graph(config);
+
+  const int64_t max_seq_len = 8;
+  const int64_t n_heads = 4;
+  const int64_t n_kv_heads = 2;
+  const int64_t head_dim = 8;
+
+  std::vector<int64_t> q_sizes = {1, 1, n_heads, head_dim};
+  std::vector<int64_t> kv_sizes = {1, 1, n_kv_heads, head_dim};
+  std::vector<int64_t> cache_sizes = {1, max_seq_len, n_kv_heads, head_dim};
+
+  IOValueRef q = graph.add_input_tensor(q_sizes, vkapi::kFloat);
+  IOValueRef k = graph.add_input_tensor(kv_sizes, vkapi::kFloat);
+  IOValueRef v = graph.add_input_tensor(kv_sizes, vkapi::kFloat);
+
+  // Every key is the same, so the attention weights are uniform over the
+  // cached tokens and the output is the mean of their values
+  CREATE_WEIGHT_TENSOR(k_cache, cache_sizes, vkapi::kFloat, 1.0f);
+  CREATE_WEIGHT_TENSOR(v_cache, cache_sizes, vkapi::kFloat, 2.0f);
+
+  ValueRef start_pos = graph.add_symint(2);
+
+  IOValueRef out;
+  out.value = graph.add_tensor(q_sizes, vkapi::kFloat);
+
+  VK_GET_OP_FN("llama.sdpa_with_kv_cache.default")
+  (graph,
+   {q.value,
+    k.value,
+    v.value,
+    k_cache,
+    v_cache,
+    start_pos,
+    graph.add_scalar<int64_t>(1),
+    graph.add_none(),
+    graph.add_scalar<double>(0.0),
+    graph.add_scalar<bool>(false),
+    graph.add_none(),
+    out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_prepack();
+  graph.prepack();
+  graph.encode_execute();
+
+  // Tokens 0 and 1 come from the prepacked cache, token 2 is the new value
+  execute_graph_and_check_output(graph, {1.0f, 1.0f, 5.0f}, {3.0f});
+
+  // The cache stays on the GPU, so token 2 keeps the value written by the
+  // previous execution
+  graph.set_symint(start_pos, 3);
+  execute_graph_and_check_output(graph, {1.0f, 1.0f, 5.0f}, {3.5f});
+}
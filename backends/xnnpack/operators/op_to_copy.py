@@ -16,6 +16,7 @@ from executorch.backends.xnnpack.operators.node_visitor import (
 from executorch.backends.xnnpack.operators.quant_params import QuantParams
 
 from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNConvert,
     XNNGraph,
     XNNStaticTranspose,
     XNode,
@@ -42,6 +43,21 @@ class ConvertMemoryFormat(NodeVisitor):
         vals_to_ids: Dict[torch.fx.Node, int],
         debug_handle: int,
     ) -> None:
+        dtype = node.kwargs.get("dtype", None)
+        if dtype is not None and dtype != get_input_node(node, 0).meta["val"].dtype:
+            # Casts between fp32 and fp16, see ToCopyConfig
+            self.define_nodes_tensor_inputs_outputs(node, xnn_graph, vals_to_ids)
+            ser_node = XNode(
+                xnode_union=XNNConvert(
+                    input_id=vals_to_ids[get_input_node(node, 0)],
+                    output_id=vals_to_ids[node],
+                    flags=0,
+                ),
+                debug_handle=debug_handle,
+            )
+            xnn_graph.xnodes.append(ser_node)
+            return
+
         memory_format_target = node.kwargs.get("memory_format", torch.contiguous_format)
         to_channels_last = bool(memory_format_target == torch.channels_last)
         to_contiguous = bool(memory_format_target == torch.contiguous_format)
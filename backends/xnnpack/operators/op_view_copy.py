@@ -0,0 +1,97 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Dict
+
+import torch
+from executorch.backends.xnnpack.operators.node_visitor import (
+    NodeVisitor,
+    register_node_visitor,
+)
+from executorch.backends.xnnpack.operators.quant_params import QuantParams
+from executorch.backends.xnnpack.passes.channels_last_tagged_reshape_pass import (
+    ChannelsLastTaggedReshapePass,
+)
+from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNGraph,
+    XNNStaticReshape,
+    XNode,
+)
+from executorch.backends.xnnpack.utils.utils import (
+    check_or_raise,
+    get_input_node,
+    PERM_NCHW_TO_NHWC,
+)
+
+
+class OpCopyToShape(NodeVisitor):
+    """
+    Parent Class for ops which copy their first input into the shape of their
+    output, serialized as XNNStaticReshape
+    """
+
+    def __init__(self, *args) -> None:
+        super().__init__(*args)
+
+    def define_node(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        input_node = get_input_node(node, 0)
+        self.define_tensor(
+            input_node,
+            xnn_graph,
+            vals_to_ids,
+            quant_params=QuantParams.from_inputs(input_node, self._exported_program),
+        )
+        self.define_tensor(
+            node,
+            xnn_graph,
+            vals_to_ids,
+            quant_params=QuantParams.from_outputs(node),
+        )
+
+        # XNNPACK infers a dim given as 0 from the size of the input, which it
+        # can only do for one dynamic dim
+        new_shape = [
+            0 if isinstance(dim, torch.SymInt) else dim
+            for dim in node.meta["val"].shape
+        ]
+        check_or_raise(
+            new_shape.count(0) <= 1,
+            "XNNPACK reshape only supports 1 dynamic dimension",
+        )
+        if node.meta.get(ChannelsLastTaggedReshapePass.XNN_NHWC_NODE, False):
+            new_shape = [new_shape[i] for i in PERM_NCHW_TO_NHWC]
+
+        ser_node = XNode(
+            xnode_union=XNNStaticReshape(
+                num_dims=len(new_shape),
+                new_shape=new_shape,
+                input_id=vals_to_ids[input_node],
+                output_id=vals_to_ids[node],
+                flags=0,
+            ),
+            debug_handle=debug_handle,
+        )
+        xnn_graph.xnodes.append(ser_node)
+
+
+@register_node_visitor
+class ViewCopyVisitor(OpCopyToShape):
+    target = "aten.view_copy.default"
+
+
+@register_node_visitor
+class CloneVisitor(OpCopyToShape):
+    """
+    A clone is a copy into the same shape
+    """
+
+    target = "aten.clone.default"
@@ -9,6 +9,9 @@ from __future__ import annotations
 from typing import cast, Optional, Union
 
 import torch
+from executorch.backends.xnnpack.passes.channels_last_tagged_reshape_pass import (
+    ChannelsLastTaggedReshapePass,
+)
 from executorch.backends.xnnpack.passes.tag_implicit_q_dq_pass import TagImplicitQDqPass
 from executorch.backends.xnnpack.utils.quant_utils import is_dequant, is_quant
 from executorch.backends.xnnpack.utils.utils import (
@@ -127,6 +130,10 @@ class QuantParams:
         assert isinstance(q_input, torch.fx.Node)
         # TODO - materialize this from the quant_node scale count and val shape
         num_nonbatch_dims = 1
+        if quant_node.meta.get(ChannelsLastTaggedReshapePass.XNN_NHWC_NODE, False):
+            # NHWC inputs of convolution are quantized per image, which is the
+            # closest XNNPACK gets to per tensor quantization for them
+            num_nonbatch_dims = 3
 
         return cls(
             per_channel=False,  # True is not valid
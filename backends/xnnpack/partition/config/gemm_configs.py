@@ -28,6 +28,7 @@ from executorch.backends.xnnpack.utils.utils import (
 from executorch.exir.backend.canonical_partitioners.config_partitioner import (
     format_target_name,
 )
+from executorch.exir.dialects._ops import ops as exir_ops
 from torch.export import ExportedProgram
 from torch.fx.passes.utils.source_matcher_utils import (
     get_source_partitions,
@@ -269,7 +270,8 @@ class ConvolutionConfig(GEMMConfig):
 
     def check_constraints(self, node: torch.fx.Node, ep: ExportedProgram) -> bool:
         """
-        Currently we have no support for convolution 3d and transposed convolution
+        Currently we have no support for convolution 3d and transposed convolution,
+        and dynamically quantized convolution must be 2d and non-grouped
         """
         if not super().check_constraints(node, ep):
             return False
@@ -282,10 +284,24 @@ class ConvolutionConfig(GEMMConfig):
         if transposed:
             return False  # Currently don't support transposed conv
 
+        if self._detect_precision(node) == ConfigPrecisionType.DYNAMIC_QUANT:
+            # XNNPACK only has dynamically quantized kernels for 2D,
+            # non-grouped convolution with per channel quantized weights
+            groups = cast(int, node.args[8])
+            weight = get_input_node(node, self.weight_idx)
+            if (
+                len(conv_stride) != 2
+                or groups != 1
+                or weight.target
+                != exir_ops.edge.quantized_decomposed.dequantize_per_channel.default
+            ):
+                return False
+
         return True
 
     def supported_precision_types(self):
         return [
+            ConfigPrecisionType.DYNAMIC_QUANT,
             ConfigPrecisionType.FP32,
             ConfigPrecisionType.STATIC_QUANT,
         ]
@@ -384,6 +384,96 @@ class SliceCopyConfig(GenericNodePartitionerConfig):
         return [ConfigPrecisionType.FP32, ConfigPrecisionType.STATIC_QUANT]
 
 
+class ViewCopyConfig(GenericNodePartitionerConfig):
+    target_name = "view_copy.default"
+
+    def check_constraints(self, node: torch.fx.Node, ep: ExportedProgram) -> bool:
+        """
+        XNNPACK can infer at most one dynamic dim of the new shape
+        """
+        if not self.check_common_constraints(node, ep):
+            return False
+
+        return _is_reshapable(node)
+
+    def supported_precision_types(self) -> List[ConfigPrecisionType]:
+        return [ConfigPrecisionType.FP32, ConfigPrecisionType.STATIC_QUANT]
+
+
+class CloneConfig(GenericNodePartitionerConfig):
+    target_name = "clone.default"
+
+    def check_constraints(self, node: torch.fx.Node, ep: ExportedProgram) -> bool:
+        """
+        Clones are serialized as a reshape into the same shape, so they have the
+        same constraints as view_copy, and may not convert to channels last
+        """
+        if not self.check_common_constraints(node, ep):
+            return False
+
+        memory_format = node.kwargs.get("memory_format", None)
+        if memory_format not in [
+            None,
+            torch.preserve_format,
+            torch.contiguous_format,
+        ]:
+            return False
+
+        return _is_reshapable(node)
+
+    def supported_precision_types(self) -> List[ConfigPrecisionType]:
+        return [ConfigPrecisionType.FP32, ConfigPrecisionType.STATIC_QUANT]
+
+
+class ToCopyConfig(GenericNodePartitionerConfig):
+    target_name = "_to_copy.default"
+
+    def check_constraints(self, node: torch.fx.Node, ep: ExportedProgram) -> bool:
+        """
+        Only casts between fp32 and fp16 are supported, which may not change the
+        memory format
+        """
+        if not self.check_common_constraints(node, ep):
+            return False
+
+        if not set(node.kwargs.keys()).issubset({"dtype", "memory_format"}):
+            return False
+
+        memory_format = node.kwargs.get("memory_format", None)
+        if memory_format not in [
+            None,
+            torch.preserve_format,
+            torch.contiguous_format,
+        ]:
+            return False
+
+        fp_dtypes = [torch.float32, torch.float16]
+        input_dtype = get_input_node(node, 0).meta["val"].dtype
+        output_dtype = node.kwargs.get("dtype", None)
+        return (
+            input_dtype in fp_dtypes
+            and output_dtype in fp_dtypes
+            and input_dtype != output_dtype
+        )
+
+    def supported_precision_types(self) -> List[ConfigPrecisionType]:
+        return [ConfigPrecisionType.FP32]
+
+
+def _is_reshapable(node: torch.fx.Node) -> bool:
+    """
+    Whether XNNPACK can reshape the first input of node into the shape of its
+    output
+    """
+    input_shape = get_input_node(node, 0).meta["val"].shape
+    output_shape = node.meta["val"].shape
+    if len(input_shape) > 6 or len(output_shape) > 6:
+        return False  # more dims than XNN_MAX_TENSOR_DIMS
+
+    num_dynamic_dims = sum(isinstance(dim, torch.SymInt) for dim in output_shape)
+    return num_dynamic_dims <= 1
+
+
 class SquareRootConfig(GenericNodePartitionerConfig):
     target_name = "sqrt.default"
 
@@ -18,6 +18,7 @@ from executorch.exir.backend.backend_details import ExportedProgram
 from executorch.exir.backend.canonical_partitioners.config_partitioner import (
     ConfigerationBasedPartitioner,
 )
+from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.backend.partitioner import DelegationSpec
 from torch.fx.passes.infra.partitioner import Partition
 
@@ -30,8 +31,20 @@ class XnnpackPartitioner(ConfigerationBasedPartitioner):
             Union[ConfigPrecisionType, List[ConfigPrecisionType]]
         ] = None,
         per_op_mode=False,
+        num_threads: Optional[int] = None,
     ):
-        delegation_spec = DelegationSpec(XnnpackBackend.__name__, [])
+        # num_threads gives each delegate instance a threadpool of its own with
+        # that many threads, instead of running on the threadpool of the thread
+        # that loads it. This lets models running concurrently use separate
+        # cores.
+        compile_specs = []
+        if num_threads is not None:
+            if num_threads <= 0:
+                raise ValueError(f"num_threads must be positive, got {num_threads}")
+            compile_specs.append(
+                CompileSpec("num_threads", num_threads.to_bytes(4, "little"))
+            )
+        delegation_spec = DelegationSpec(XnnpackBackend.__name__, compile_specs)
         configs_to_use = configs or ALL_PARTITIONER_CONFIGS
         # Can do logic and have extra args to filter/delete/select
         # Certain configs based on user specification
@@ -8,7 +8,8 @@ from typing import Optional, Tuple
 
 import torch
 from executorch.backends.xnnpack.passes.xnnpack_pass import XNNPACKPass
-from executorch.backends.xnnpack.utils.utils import is_param_node
+from executorch.backends.xnnpack.utils.quant_utils import is_dequant, is_dynamic_qdq
+from executorch.backends.xnnpack.utils.utils import get_input_node, is_param_node
 from executorch.exir.dialects._ops import ops as exir_ops
 from executorch.exir.pass_base import PassResult
 
@@ -56,6 +57,7 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
     # Set of ops that require memory format to be NCHW
     memory_sensitive_ops_nchw = {
         "output",
+        exir_ops.edge.aten.view_copy.default,
         exir_ops.edge.aten.squeeze_copy.dim,
         exir_ops.edge.aten.unsqueeze_copy.default,
     }
@@ -248,6 +250,47 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
             # in that case
             self.make_partners(original_input, copy_node)
 
+    def dynamic_input_to_nhwc(
+        self,
+        graph_module: torch.fx.GraphModule,
+        dq: torch.fx.Node,
+    ) -> None:
+        """
+        Dynamically quantized inputs are quantized at runtime, ex.
+            input -> choose_qparams -> q -> dq -> conv
+        A copy can't be inserted between dq and conv without breaking the
+        dynamically quantized pattern, so we convert the fp32 input instead, ex.
+            input -> (copy) -> choose_qparams -> q -> dq -> conv
+        """
+        q = get_input_node(dq, 0)
+        choose_qparams = get_input_node(get_input_node(q, 1), 0)
+        if len(dq.users) != 1 or len(q.users) != 1:
+            raise AssertionError(
+                "Expected dynamically quantized NHWC input to only be used once"
+            )
+
+        fp32_input = get_input_node(q, 0)
+        if ChannelsLastTaggedReshapePass.PARTNER_NODE in fp32_input.meta:
+            # Already has an associated NHWC node
+            input_node_nhwc = fp32_input.meta[
+                ChannelsLastTaggedReshapePass.PARTNER_NODE
+            ]
+        else:
+            with graph_module.graph.inserting_after(fp32_input):
+                input_node_nhwc = self.create_call_function_node(
+                    graph_module=graph_module,
+                    target=exir_ops.edge.aten._to_copy.default,
+                    args=(fp32_input,),
+                    memory_format=torch.channels_last,
+                )
+            self.mark_as_nhwc_node(input_node_nhwc)
+            self.make_partners(fp32_input, input_node_nhwc)
+
+        choose_qparams.replace_input_with(fp32_input, input_node_nhwc)
+        q.replace_input_with(fp32_input, input_node_nhwc)
+        self.mark_as_nhwc_node(q)
+        self.mark_as_nhwc_node(dq)
+
     def input_to_nhwc(
         self,
         graph_module: torch.fx.GraphModule,
@@ -276,6 +319,10 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
                 "Attempting to convert non-NHWC compatible node to NHWC"
             )
 
+        if is_dequant(input_node) and is_dynamic_qdq(input_node):
+            self.dynamic_input_to_nhwc(graph_module, input_node)
+            return
+
         if ChannelsLastTaggedReshapePass.PARTNER_NODE in input_node.meta:
             # Already has an associated NHWC node
             input_node_nhwc = input_node.meta[
@@ -403,11 +403,16 @@ Error defineTensor(
             buffer_ptr == nullptr,
             Internal,
             "Dynamically quantized tensor should not have constant data but found non-nullptr");
-        // TODO(T179441835): Dynamic Quantization with num_nonbatch_dims > 1
+        // Tensors are quantized per token for fully connected, and per image
+        // (num_nonbatch_dims = 3) for NHWC convolution inputs.
         ET_CHECK_OR_RETURN_ERROR(
-            qparams->num_nonbatch_dims() == 1,
+            qparams->num_nonbatch_dims() >= 1 &&
+                static_cast<uint32_t>(qparams->num_nonbatch_dims()) <
+                    tensor_value->num_dims(),
             Internal,
-            "Dynamically Quantized Tensors currently only support per token quantization");
+            "Dynamically Quantized Tensors need 1 to %u non-batch dims, got %i",
+            tensor_value->num_dims() - 1,
+            qparams->num_nonbatch_dims());
         status = xnn_define_dynamically_quantized_tensor_value(
             /*subgraph=*/subgraph_ptr,
             /*datatype=*/getDataType(tensor_value->datatype()),
@@ -1613,7 +1618,9 @@ ET_NODISCARD Error XNNCompiler::compileModel(
     size_t num_bytes,
     XNNExecutor* executor,
     MemoryAllocator* runtime_allocator,
-    xnn_workspace_t workspace) {
+    std::shared_ptr<XNNWorkspace> workspace,
+    std::shared_ptr<XNNWeightsCache> weights_cache,
+    std::unique_ptr<torch::executorch::threadpool::ThreadPool> threadpool) {
   Result<XNNHeader> header = XNNHeader::Parse(buffer_pointer, num_bytes);
   const uint8_t* flatbuffer_data = nullptr;
   const uint8_t* constant_data = nullptr;
@@ -1695,12 +1702,15 @@ ET_NODISCARD Error XNNCompiler::compileModel(
     }
   }
 
+  std::vector<uint32_t> node_debug_handles;
+  node_debug_handles.reserve(flatbuffer_graph->xnodes()->size());
   for (auto node : *flatbuffer_graph->xnodes()) {
     err = getDefineNodeFunc(node->xnode_union_type())(
         subgraph.get(), remapped_ids, node);
     if (err != Error::Ok) {
       return err;
     }
+    node_debug_handles.push_back(node->debug_handle());
   }
   uint32_t runtime_flags = 0;
 
@@ -1709,21 +1719,38 @@ ET_NODISCARD Error XNNCompiler::compileModel(
 #endif
 
   xnn_runtime_t runtime_ptr = nullptr;
+  xnn_weights_cache_t weights_cache_ptr =
+      weights_cache ? weights_cache->get() : nullptr;
+
+  // The runtime runs on the threadpool it is created with, which is the
+  // delegate's own one when it has one.
+  torch::executorch::threadpool::ThreadPool* const runtime_threadpool =
+      threadpool ? threadpool.get()
+                 : torch::executorch::threadpool::get_threadpool();
+  torch::executorch::threadpool::UseThreadPoolGuard threadpool_guard(
+      runtime_threadpool);
+  // XNNPACK runs on the raw pthreadpool, so ThreadPool::run() never sees its
+  // work. Have the runtime send the workers to sleep after each invocation
+  // instead.
+  if (runtime_threadpool->get_worker_wait_policy() ==
+      torch::executorch::threadpool::WorkerWaitPolicy::Sleep) {
+    runtime_flags |= XNN_FLAG_YIELD_WORKERS;
+  }
 
 #ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
   ET_CHECK_OR_RETURN_ERROR(
       workspace != nullptr, Internal, "Failed to initialize XNNPACK workspace");
   status = xnn_create_runtime_v4(
       subgraph.get(),
-      /*weight_cache=*/nullptr, // TODO - support weight cache
-      workspace,
+      weights_cache_ptr,
+      workspace->get(),
       torch::executorch::threadpool::get_pthreadpool(),
       runtime_flags,
       &runtime_ptr);
 #else
   status = xnn_create_runtime_v3(
       subgraph.get(),
-      /*weight_cache=*/nullptr, // TODO - support weight cache
+      weights_cache_ptr,
       torch::executorch::threadpool::get_pthreadpool(),
       runtime_flags,
       &runtime_ptr);
@@ -1735,10 +1762,14 @@ ET_NODISCARD Error XNNCompiler::compileModel(
       "XNN Runtime creation failed with code: %s",
       xnn_status_to_string(status));
 
+  executor->threadpool_ = std::move(threadpool);
   err = executor->initialize( // NOLINT: runtime_ptr is non-null
       runtime_ptr,
       std::move(input_ids),
-      std::move(output_ids));
+      std::move(output_ids),
+      std::move(node_debug_handles),
+      std::move(workspace),
+      std::move(weights_cache));
 
   return err;
 };
@@ -30,7 +30,10 @@ class XNNCompiler {
       size_t num_bytes,
       XNNExecutor* executor,
       MemoryAllocator* runtime_allocator,
-      xnn_workspace_t workspace);
+      std::shared_ptr<XNNWorkspace> workspace,
+      std::shared_ptr<XNNWeightsCache> weights_cache = nullptr,
+      std::unique_ptr<torch::executorch::threadpool::ThreadPool> threadpool =
+          nullptr);
 };
 
 } // namespace delegate
@@ -17,6 +17,13 @@ using Tensor = exec_aten::Tensor;
 using ScalarType = exec_aten::ScalarType;
 using SizesType = exec_aten::SizesType;
 
+namespace {
+// The number of entries per value in input_shapes_ and output_shapes_.
+constexpr size_t kShapeStride = XNN_MAX_TENSOR_DIMS + 1;
+// A number of dims no tensor has, so that the next shape never matches.
+constexpr size_t kUnknownShape = SIZE_MAX;
+} // namespace
+
 /**
  * Initializes the XNNExecutor with the runtime and given number of
  * inputs/outputs externals_ is resized to the total number of inputs and
@@ -25,11 +32,16 @@ using SizesType = exec_aten::SizesType;
 ET_NODISCARD Error XNNExecutor::initialize(
     xnn_runtime_t runtime,
     std::vector<uint32_t>&& input_ids,
-    std::vector<uint32_t>&& output_ids) {
+    std::vector<uint32_t>&& output_ids,
+    std::vector<uint32_t>&& node_debug_handles,
+    std::shared_ptr<XNNWorkspace> workspace,
+    std::shared_ptr<XNNWeightsCache> weights_cache) {
+  weights_cache_ = std::move(weights_cache);
+  workspace_ = std::move(workspace);
   runtime_ = std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)>(
       runtime, xnn_delete_runtime);
 
-  auto error = profiler_.initialize(runtime);
+  auto error = profiler_.initialize(runtime, std::move(node_debug_handles));
   if (error != Error::Ok) {
     ET_LOG(
         Error,
@@ -46,6 +58,10 @@ ET_NODISCARD Error XNNExecutor::initialize(
   std::sort(output_ids_.begin(), output_ids_.end());
 
   externals_.resize(input_ids_.size() + output_ids_.size());
+  input_shapes_.assign(input_ids_.size() * kShapeStride, kUnknownShape);
+  output_shapes_.assign(output_ids_.size() * kShapeStride, kUnknownShape);
+  outputs_reshaped_ = true;
+  setup_needed_ = true;
 
   return Error::Ok;
 }
@@ -54,9 +70,12 @@ ET_NODISCARD Error XNNExecutor::initialize(
  * Prepares the args for XNNPACK Runtime.
  *
  * Creates an array of xnn_externals_values from the EValues passed in.
- * Reshapes all the external input tensors, in case any input shapes have
- * changed. The reshapes the entire runtime, propagating shape information
- * through the runtime.
+ * Reshapes the external input tensors whose shapes have changed since the
+ * last call, and if any did, reshapes the entire runtime, propagating shape
+ * information through the runtime. Calls with the same shapes as the last
+ * one, like every step of LLM decoding, skip reshaping altogether, and if
+ * the args also point to the same buffers as the last call, forward() skips
+ * setting up the runtime and only invokes it.
  *
  * Note: the external ids given to the external tensors in the XNNPACK
  * runtime correspond to their index in the list of arg passed into
@@ -65,6 +84,7 @@ ET_NODISCARD Error XNNExecutor::initialize(
 ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
   // Create xnn_externals_value from evalue args
   xnn_status status;
+  bool reshape_runtime = false;
   for (uint32_t i = 0; i < externals_.size(); ++i) {
     if (i < input_ids_.size()) {
       externals_[i].id = input_ids_[i];
@@ -81,7 +101,11 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
         static_cast<uint32_t>(args[ext_id]->tag));
 
     Tensor* tensor = &args[ext_id]->toTensor();
-    externals_[i].data = tensor->mutable_data_ptr<float>();
+    void* data = tensor->mutable_data_ptr<float>();
+    if (externals_[i].data != data) {
+      externals_[i].data = data;
+      setup_needed_ = true;
+    }
 
     // Reshape runtime inputs
     if (i < input_ids_.size()) {
@@ -98,9 +122,18 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
           "XNNPACK backend accepts tensors with at most %d dims, but got %zu",
           XNN_MAX_TENSOR_DIMS,
           num_dims);
+      size_t* last_shape = &input_shapes_[i * kShapeStride];
+      bool shape_changed = last_shape[0] != num_dims;
       for (int d = 0; d < num_dims; ++d) {
         dims[d] = tensor->size(d);
+        shape_changed = shape_changed || last_shape[d + 1] != dims[d];
+      }
+      if (!shape_changed) {
+        continue;
       }
+      // Forget the last shape until the runtime has been reshaped with the
+      // new one.
+      last_shape[0] = kUnknownShape;
       status =
           xnn_reshape_external_value(runtime_.get(), ext_id, num_dims, dims);
       ET_CHECK_OR_RETURN_ERROR(
@@ -108,8 +141,13 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
           Internal,
           "Internal Error: Reshape Input Tensor Failed with code: %s",
           xnn_status_to_string(status));
+      reshape_runtime = true;
     }
   }
+  if (!reshape_runtime) {
+    return Error::Ok;
+  }
+
   // // Propagate Input Shape and Memory Plan for increased allocation
   status = xnn_reshape_runtime(runtime_.get());
 
@@ -119,14 +157,48 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
       "Internal Error: Propagating input shapes failed with code: %s",
       xnn_status_to_string(status));
 
+  // Only remember the new shapes now that the runtime has taken them.
+  for (uint32_t i = 0; i < input_ids_.size(); ++i) {
+    const Tensor& tensor = args[externals_[i].id]->toTensor();
+    size_t* last_shape = &input_shapes_[i * kShapeStride];
+    const size_t num_dims = tensor.dim();
+    last_shape[0] = num_dims;
+    for (size_t d = 0; d < num_dims; ++d) {
+      last_shape[d + 1] = tensor.size(d);
+    }
+  }
+  outputs_reshaped_ = true;
+  setup_needed_ = true;
+  if (workspace_ != nullptr) {
+    workspace_->on_runtime_reshaped();
+  }
+
+  return Error::Ok;
+}
+
+ET_NODISCARD Error XNNExecutor::warmup() {
+  // The shapes of the first inputs are still unknown, so prepare_args() will
+  // reshape the runtime again, but into the memory allocated here.
+  xnn_status status = xnn_reshape_runtime(runtime_.get());
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Internal Error: Planning runtime memory failed with code: %s",
+      xnn_status_to_string(status));
+  setup_needed_ = true;
+  if (workspace_ != nullptr) {
+    workspace_->on_runtime_reshaped();
+  }
   return Error::Ok;
 }
 
 /**
  * Runs the XNNPACK Runtime.
  *
- * We first setup the runtime by feeding the externals_ to runtime setup.
- * After which we then execute the runtime through invoke_runtime.
+ * We first setup the runtime by feeding the externals_ to runtime setup,
+ * unless neither the externals_ nor the shared workspace moved since the
+ * last setup. After which we then execute the runtime through
+ * invoke_runtime.
  */
 ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
   ET_CHECK_OR_RETURN_ERROR(
@@ -134,14 +206,29 @@ ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
       Internal,
       "XNNPACK Delegate did not compile correctly");
 
-  xnn_status status = xnn_setup_runtime_v2(
-      runtime_.get(), externals_.size(), externals_.data());
+  // Other runtimes reshaped on the shared workspace since the last setup may
+  // have moved it.
+  if (workspace_ != nullptr &&
+      workspace_->generation() != setup_workspace_generation_) {
+    setup_needed_ = true;
+  }
+
+  xnn_status status = xnn_status_success;
+  if (setup_needed_) {
+    status = xnn_setup_runtime_v2(
+        runtime_.get(), externals_.size(), externals_.data());
 
-  ET_CHECK_OR_RETURN_ERROR(
-      status == xnn_status_success,
-      Internal,
-      "Internal Error: Setting up the runtime failed with code: %s",
-      xnn_status_to_string(status));
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Internal Error: Setting up the runtime failed with code: %s",
+        xnn_status_to_string(status));
+    setup_needed_ = false;
+    if (workspace_ != nullptr) {
+      setup_workspace_generation_ = workspace_->generation();
+    }
+    ++num_setups_;
+  }
 
   auto error = profiler_.start(context.event_tracer());
   if (error != Error::Ok) {
@@ -174,44 +261,53 @@ ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
  * Prepares the outputs for ExecuTorch
  *
  * Resizes the output tensors based on the output shapes returned by
- * the xnnpack runtime.
+ * the xnnpack runtime. The shapes are only fetched from the runtime when it
+ * was reshaped, and tensors that already have them are left alone.
  *
  * Note: For arg_max pooling, we recast the output index tensor. Since
  * XNNPACK gives the index tensor to us as int32, we need to convert it
  * back to int64 for ExecuTorch.
  */
-ET_NODISCARD Error XNNExecutor::resize_outputs(EValue** args) const {
+ET_NODISCARD Error XNNExecutor::resize_outputs(EValue** args) {
   size_t output_idx_start = input_ids_.size();
   for (size_t i = output_idx_start; i < externals_.size(); ++i) {
     uint32_t ext_id = externals_[i].id;
     Tensor* out_tensor = &args[ext_id]->toTensor();
 
-    size_t num_dim;
-    size_t dims[XNN_MAX_TENSOR_DIMS];
+    size_t* shape = &output_shapes_[(i - output_idx_start) * kShapeStride];
+    size_t& num_dim = shape[0];
+    size_t* dims = shape + 1;
 
-    // Fetch the updated output shapes from xnnpack runtime
-    xnn_status status =
-        xnn_get_external_value_shape(runtime_.get(), ext_id, &num_dim, dims);
+    if (outputs_reshaped_) {
+      // Fetch the updated output shapes from xnnpack runtime
+      xnn_status status =
+          xnn_get_external_value_shape(runtime_.get(), ext_id, &num_dim, dims);
 
-    ET_CHECK_OR_RETURN_ERROR(
-        status == xnn_status_success,
-        Internal,
-        "Internal Error: Failed to retrieve graph output shapes");
+      ET_CHECK_OR_RETURN_ERROR(
+          status == xnn_status_success,
+          Internal,
+          "Internal Error: Failed to retrieve graph output shapes");
+    }
 
     // Convert new output shape into SizesType
     SizesType expected_output_size[kTensorDimensionLimit];
+    bool same_size = static_cast<size_t>(out_tensor->dim()) == num_dim;
     for (size_t d = 0; d < num_dim; ++d) {
       expected_output_size[d] = static_cast<SizesType>(dims[d]);
+      same_size =
+          same_size && static_cast<size_t>(out_tensor->size(d)) == dims[d];
     }
 
-    exec_aten::ArrayRef<SizesType> output_size{
-        expected_output_size, static_cast<size_t>(num_dim)};
+    if (!same_size) {
+      exec_aten::ArrayRef<SizesType> output_size{
+          expected_output_size, static_cast<size_t>(num_dim)};
 
-    ET_LOG(Debug, "Resizing output tensor to a new shape");
-    Error err = resize_tensor(*out_tensor, output_size);
-    if (err != Error::Ok) {
-      ET_LOG(Error, "Failed to resize output tensor for XNNExecutor");
-      return err;
+      ET_LOG(Debug, "Resizing output tensor to a new shape");
+      Error err = resize_tensor(*out_tensor, output_size);
+      if (err != Error::Ok) {
+        ET_LOG(Error, "Failed to resize output tensor for XNNExecutor");
+        return err;
+      }
     }
 
     // Output datatype is int64. However, XNNPACK doesn't support
@@ -225,6 +321,7 @@ ET_NODISCARD Error XNNExecutor::resize_outputs(EValue** args) const {
       }
     }
   }
+  outputs_reshaped_ = false;
 
   return Error::Ok;
 }
@@ -9,7 +9,10 @@
 #pragma once
 
 #include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/backends/xnnpack/runtime/profiling/XNNProfiler.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
@@ -26,6 +29,11 @@ namespace delegate {
 
 class XNNExecutor {
  private:
+  // Declared before runtime_ so that they outlive it.
+  std::shared_ptr<XNNWeightsCache> weights_cache_;
+  std::shared_ptr<XNNWorkspace> workspace_;
+  // The threadpool dedicated to this delegate instance, if it has one.
+  std::unique_ptr<torch::executorch::threadpool::ThreadPool> threadpool_;
   std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_{
       nullptr,
       &xnn_delete_runtime};
@@ -34,6 +42,21 @@ class XNNExecutor {
   std::vector<uint32_t> input_ids_;
   std::vector<uint32_t> output_ids_;
   std::vector<xnn_external_value> externals_;
+  // The last shape of each input and output, as XNN_MAX_TENSOR_DIMS + 1
+  // entries per value: the number of dims followed by the dims. Used to only
+  // reshape the runtime when an input shape changes.
+  std::vector<size_t> input_shapes_;
+  std::vector<size_t> output_shapes_;
+  // Whether the runtime was reshaped since output_shapes_ was last updated.
+  bool outputs_reshaped_ = true;
+  // Whether the runtime must be set up before the next invocation, because it
+  // was reshaped or an external value moved since the last setup.
+  bool setup_needed_ = true;
+  // The generation of the shared workspace at the last setup. The runtime is
+  // set up again when another runtime moved the workspace since.
+  uint64_t setup_workspace_generation_ = 0;
+  // The number of times the runtime has been set up.
+  size_t num_setups_ = 0;
 
  public:
   XNNExecutor() = default;
@@ -46,15 +69,45 @@ class XNNExecutor {
     return output_ids_.size();
   }
 
+  /**
+   * The weights cache the runtime packed its weights into, if any.
+   */
+  inline XNNWeightsCache* weights_cache() const {
+    return weights_cache_.get();
+  }
+
+  /**
+   * The workspace the runtime shares with other runtimes, if any.
+   */
+  inline XNNWorkspace* workspace() const {
+    return workspace_.get();
+  }
+
+  /**
+   * The number of times forward() has set up the runtime, which it skips
+   * when neither the external values nor the workspace moved.
+   */
+  inline size_t num_setups() const {
+    return num_setups_;
+  }
+
   /**
    * Initialize the XNNExecutor with a given runtime and input/output ids.
    * The input/output ids are expected to be sorted in order of their
-   * flatbuffer id_outs
+   * flatbuffer id_outs. node_debug_handles holds the debug handle of each
+   * node of the runtime's subgraph, in the order they were defined, and is
+   * used to attribute profiling events to the nodes of the exported graph.
+   * workspace is the workspace the runtime was created with, if it shares
+   * one with other runtimes, and weights_cache the weights cache it packed
+   * its weights into, if any.
    */
   ET_NODISCARD Error initialize(
       xnn_runtime_t runtime,
       std::vector<uint32_t>&& input_ids,
-      std::vector<uint32_t>&& output_ids);
+      std::vector<uint32_t>&& output_ids,
+      std::vector<uint32_t>&& node_debug_handles = {},
+      std::shared_ptr<XNNWorkspace> workspace = nullptr,
+      std::shared_ptr<XNNWeightsCache> weights_cache = nullptr);
 
   /**
    * Prepares the arguments for runtime graph execution.
@@ -64,6 +117,12 @@ class XNNExecutor {
    */
   ET_NODISCARD Error prepare_args(EValue** args);
 
+  /**
+   * Plans and allocates the memory of the runtime for the shapes it was
+   * built with, as the first prepare_args() would, without running it.
+   */
+  ET_NODISCARD Error warmup();
+
   /**
    * Executes the graph using the args prepared at prepare_args().
    */
@@ -74,7 +133,7 @@ class XNNExecutor {
    *
    * Performs any post processing of outputs like tensor resizing
    */
-  ET_NODISCARD Error resize_outputs(EValue** args) const;
+  ET_NODISCARD Error resize_outputs(EValue** args);
 
   friend class XNNCompiler;
 };
@@ -12,6 +12,9 @@
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/platform/profiler.h>
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <mutex>
 
@@ -32,26 +35,7 @@ class XnnpackBackend final : public PyTorchBackendInterface {
           Error,
           "Failed to initialize, XNNPACK status: 0x%x",
           (unsigned int)status);
-      return;
     }
-
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    // Create a workspace for the XNNExecutor to use. This workspace will be
-    // shared across all delegate instances.
-    ET_LOG(Debug, "Creating XNN workspace");
-    xnn_workspace_t workspace = nullptr;
-    status = xnn_create_workspace(&workspace);
-    if (status != xnn_status_success) {
-      ET_LOG(
-          Error,
-          "Failed to create XNN workspace, XNNPACK status: 0x%x",
-          (unsigned int)status);
-      workspace = nullptr;
-      return;
-    }
-    workspace_.reset(workspace);
-    ET_LOG(Debug, "Created XNN workspace: %p", workspace_.get());
-#endif // ENABLE_XNNPACK_SHARED_WORKSPACE
   }
 
   bool is_available() const override {
@@ -70,13 +54,59 @@ class XnnpackBackend final : public PyTorchBackendInterface {
     // new and since this type is not trivially destructible, we must call the
     // destructor manually in destroy().
     new (executor) xnnpack::delegate::XNNExecutor;
+
+    Result<uint32_t> exported_num_threads = get_num_threads(compile_specs);
+    if (!exported_num_threads.ok()) {
+      executor->~XNNExecutor();
+      return exported_num_threads.error();
+    }
+    uint32_t num_threads = exported_num_threads.get();
+    // A thread count set at runtime takes precedence over the exported one.
+    const int64_t runtime_num_threads = runtime_num_threads_.load();
+    if (runtime_num_threads >= 0) {
+      num_threads = static_cast<uint32_t>(runtime_num_threads);
+    }
+    std::unique_ptr<torch::executorch::threadpool::ThreadPool> threadpool;
+    if (num_threads > 0) {
+      threadpool = std::make_unique<torch::executorch::threadpool::ThreadPool>(
+          num_threads);
+    }
+
+    std::shared_ptr<xnnpack::delegate::XNNWorkspace> workspace;
+#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
+    auto thread_workspace = get_thread_workspace();
+    if (!thread_workspace.ok()) {
+      executor->~XNNExecutor();
+      return thread_workspace.error();
+    }
+    workspace = std::move(thread_workspace.get());
+#endif // ENABLE_XNNPACK_SHARED_WORKSPACE
+
+    std::shared_ptr<xnnpack::delegate::XNNWeightsCache> weights_cache;
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    // Runtimes can't be added to a cache that has been finalized, so hold the
+    // lock until this one has been created.
+    const std::lock_guard<std::mutex> lock(weights_cache_mutex_);
+    auto open_cache = weights_caches_.open_cache();
+    if (!open_cache.ok()) {
+      executor->~XNNExecutor();
+      return open_cache.error();
+    }
+    weights_cache = std::move(open_cache.get());
+#endif // ENABLE_XNNPACK_WEIGHTS_CACHE
+
     Error err = xnnpack::delegate::XNNCompiler::compileModel(
         processed->data(),
         processed->size(),
         executor,
         context.get_runtime_allocator(),
-        workspace_.get());
-    // This backend does not need its processed data after compiling the model.
+        std::move(workspace),
+        std::move(weights_cache),
+        std::move(threadpool));
+    // This backend does not need its processed data after compiling the model:
+    // XNNPACK has packed the weights into its runtime by now. When the data is
+    // in a segment this unmaps or frees the serialized weights; data stored
+    // inline in the program flatbuffer stays resident with the program.
     processed->Free();
 
     if (err != Error::Ok) {
@@ -97,12 +127,20 @@ class XnnpackBackend final : public PyTorchBackendInterface {
       EValue** args) const override {
     auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
+    Error err = finalize_weights_cache(executor);
+    if (err != Error::Ok) {
+      return err;
+    }
+
+    // Runtimes sharing a workspace overwrite each other's intermediate
+    // tensors, so they take turns. Runtimes on other workspaces don't wait.
+    std::unique_lock<std::mutex> workspace_lock;
+    if (executor->workspace() != nullptr) {
+      workspace_lock = executor->workspace()->lock();
+    }
 
     // Prepare Inputs/Outputs and Propagate Input Shapes
-    Error err = executor->prepare_args(args);
+    err = executor->prepare_args(args);
     if (err != Error::Ok) {
       return err;
     }
@@ -119,6 +157,52 @@ class XnnpackBackend final : public PyTorchBackendInterface {
     return err;
   }
 
+  /**
+   * Finalizes the weights cache, as the first execution would, and plans and
+   * allocates the memory of the runtime for the shapes it was built with.
+   */
+  Error warmup(DelegateHandle* handle) const override {
+    auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+
+    Error err = finalize_weights_cache(executor);
+    if (err != Error::Ok) {
+      return err;
+    }
+
+    std::unique_lock<std::mutex> workspace_lock;
+    if (executor->workspace() != nullptr) {
+      workspace_lock = executor->workspace()->lock();
+    }
+    return executor->warmup();
+  }
+
+  /**
+   * Supports the "num_threads" option, which replaces the num_threads compile
+   * spec of the delegate instances initialized afterwards. -1 goes back to
+   * using the compile spec.
+   */
+  Error set_options(
+      ArrayRef<::executorch::runtime::BackendOption> options) override {
+    const ::executorch::runtime::BackendOption* num_threads = nullptr;
+    for (const ::executorch::runtime::BackendOption& option : options) {
+      ET_CHECK_OR_RETURN_ERROR(
+          strcmp(option.key, "num_threads") == 0,
+          NotSupported,
+          "Unsupported XNNPACK backend option %s",
+          option.key);
+      ET_CHECK_OR_RETURN_ERROR(
+          option.type == ::executorch::runtime::BackendOption::Type::Int &&
+              option.int_value >= -1 && option.int_value <= UINT32_MAX,
+          InvalidArgument,
+          "Invalid XNNPACK num_threads option");
+      num_threads = &option;
+    }
+    if (num_threads != nullptr) {
+      runtime_num_threads_.store(num_threads->int_value);
+    }
+    return Error::Ok;
+  }
+
   void destroy(DelegateHandle* handle) const override {
     if (handle != nullptr) {
       auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
@@ -132,11 +216,83 @@ class XnnpackBackend final : public PyTorchBackendInterface {
   }
 
  private:
-  // This is a global workspace for all delegate instances.
-  mutable std::mutex workspace_mutex_;
-  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_{
-      nullptr,
-      &xnn_release_workspace};
+#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
+  /**
+   * Returns the workspace shared by the delegate instances initialized on the
+   * calling thread. Instances initialized on the same thread, like the
+   * methods of a model loaded together, share the memory of their
+   * intermediate tensors, while instances initialized on different threads
+   * can run concurrently.
+   */
+  static Result<std::shared_ptr<xnnpack::delegate::XNNWorkspace>>
+  get_thread_workspace() {
+    thread_local std::shared_ptr<xnnpack::delegate::XNNWorkspace> workspace;
+    if (!workspace) {
+      auto new_workspace = xnnpack::delegate::XNNWorkspace::create();
+      if (!new_workspace.ok()) {
+        return new_workspace.error();
+      }
+      workspace = std::move(new_workspace.get());
+      ET_LOG(Debug, "Created XNN workspace: %p", workspace->get());
+    }
+    return workspace;
+  }
+#endif // ENABLE_XNNPACK_SHARED_WORKSPACE
+
+  /**
+   * Returns the number of threads of the threadpool dedicated to a delegate
+   * instance, from its "num_threads" compile spec, which holds a little
+   * endian uint32. Returns 0 when the instance has no dedicated threadpool,
+   * and runs on the threadpool of the thread that initializes it.
+   */
+  static Result<uint32_t> get_num_threads(
+      ArrayRef<CompileSpec> compile_specs) {
+    for (const CompileSpec& spec : compile_specs) {
+      if (strcmp(spec.key, "num_threads") != 0) {
+        continue;
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          spec.value.nbytes == sizeof(uint32_t),
+          InvalidArgument,
+          "Expected a %zu byte num_threads compile spec, got %zu bytes",
+          sizeof(uint32_t),
+          spec.value.nbytes);
+      const auto* data = static_cast<const uint8_t*>(spec.value.buffer);
+      return static_cast<uint32_t>(data[0]) |
+          static_cast<uint32_t>(data[1]) << 8 |
+          static_cast<uint32_t>(data[2]) << 16 |
+          static_cast<uint32_t>(data[3]) << 24;
+    }
+    return 0;
+  }
+
+  /**
+   * Finalizes the weights cache of a delegate instance the first time it, or
+   * any instance sharing its cache, runs or warms up. The instances
+   * initialized before that share the cache, which is then closed to new
+   * ones.
+   */
+  Error finalize_weights_cache(
+      ET_UNUSED xnnpack::delegate::XNNExecutor* executor) const {
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    auto* weights_cache = executor->weights_cache();
+    if (weights_cache != nullptr && !weights_cache->is_finalized()) {
+      const std::lock_guard<std::mutex> lock(weights_cache_mutex_);
+      return weights_caches_.finalize(weights_cache);
+    }
+#endif // ENABLE_XNNPACK_WEIGHTS_CACHE
+    return Error::Ok;
+  }
+
+  // The thread count set through set_options(), or -1 if there is none.
+  std::atomic<int64_t> runtime_num_threads_{-1};
+
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+  // The weights cache that new delegate instances pack their weights into,
+  // until one of the instances using it runs.
+  mutable std::mutex weights_cache_mutex_;
+  mutable xnnpack::delegate::XNNWeightsCacheManager weights_caches_;
+#endif // ENABLE_XNNPACK_WEIGHTS_CACHE
 };
 
 namespace {
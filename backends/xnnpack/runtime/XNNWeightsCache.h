@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <xnnpack.h>
+#include <atomic>
+#include <memory>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK weights cache shared by the runtimes of several delegate
+ * instances. XNNPACK looks packed weights up by their contents, so runtimes
+ * whose operators pack the same weights, like the prefill and decode graphs
+ * of an LLM, share a single packed copy.
+ *
+ * Runtimes can only add weights to the cache until it is finalized, and it
+ * must be finalized before any of them runs. Every runtime using the cache
+ * keeps a reference to it, so it lives as long as the last of them.
+ */
+class XNNWeightsCache final {
+ public:
+  static Result<std::shared_ptr<XNNWeightsCache>> create() {
+    xnn_weights_cache_t cache = nullptr;
+    xnn_status status = xnn_create_weights_cache(&cache);
+    if (status != xnn_status_success) {
+      ET_LOG(
+          Error,
+          "Failed to create XNN weights cache, XNNPACK status: 0x%x",
+          (unsigned int)status);
+      return Error::Internal;
+    }
+    return std::make_shared<XNNWeightsCache>(cache);
+  }
+
+  explicit XNNWeightsCache(xnn_weights_cache_t cache)
+      : cache_(cache, &xnn_delete_weights_cache) {}
+
+  xnn_weights_cache_t get() const {
+    return cache_.get();
+  }
+
+  bool is_finalized() const {
+    return finalized_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Finalizes the cache, trimming its memory. No more runtimes can be
+   * created with it afterwards. The caller is responsible for making sure no
+   * runtime is being created with it concurrently.
+   */
+  ET_NODISCARD Error finalize() {
+    if (is_finalized()) {
+      return Error::Ok;
+    }
+    xnn_status status = xnn_finalize_weights_cache(
+        cache_.get(), xnn_weights_cache_finalization_kind_hard);
+    if (status != xnn_status_success) {
+      ET_LOG(
+          Error,
+          "Failed to finalize XNN weights cache, XNNPACK status: 0x%x",
+          (unsigned int)status);
+      return Error::Internal;
+    }
+    finalized_.store(true, std::memory_order_release);
+    return Error::Ok;
+  }
+
+ private:
+  std::unique_ptr<xnn_weights_cache, decltype(&xnn_delete_weights_cache)>
+      cache_;
+  std::atomic<bool> finalized_{false};
+};
+
+/**
+ * Hands out the weights cache that new runtimes pack their weights into. The
+ * runtimes created until one of them first runs share a cache, which is then
+ * finalized, once for all of them, and new runtimes get a new cache.
+ *
+ * Not thread safe. Callers must also not finalize the open cache while a
+ * runtime is being created with it.
+ */
+class XNNWeightsCacheManager final {
+ public:
+  /**
+   * Returns the cache to create a new runtime with, creating one if none is
+   * open.
+   */
+  Result<std::shared_ptr<XNNWeightsCache>> open_cache() {
+    if (!open_cache_ || open_cache_->is_finalized()) {
+      auto cache = XNNWeightsCache::create();
+      if (!cache.ok()) {
+        return cache.error();
+      }
+      open_cache_ = std::move(cache.get());
+    }
+    return open_cache_;
+  }
+
+  /**
+   * Finalizes `cache` before one of its runtimes runs, if it isn't already.
+   * New runtimes no longer get it.
+   */
+  ET_NODISCARD Error finalize(XNNWeightsCache* cache) {
+    Error err = cache->finalize();
+    if (err != Error::Ok) {
+      return err;
+    }
+    if (open_cache_.get() == cache) {
+      open_cache_.reset();
+    }
+    return Error::Ok;
+  }
+
+ private:
+  std::shared_ptr<XNNWeightsCache> open_cache_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <xnnpack.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK workspace, the memory that runtimes place their intermediate
+ * tensors in, shared by the runtimes of several delegate instances.
+ *
+ * Runtimes using the same workspace overwrite each other's intermediate
+ * tensors, so only one of them may run at a time; lock() the workspace
+ * around their executions. Every runtime using the workspace keeps a
+ * reference to it, so it lives as long as the last of them.
+ *
+ * Reshaping any of the runtimes can reallocate the workspace, which moves the
+ * intermediate tensors of all of them. The workspace counts these
+ * reallocations as generations, so that a runtime only needs to be set up
+ * again when the workspace moved since its last setup.
+ */
+class XNNWorkspace final {
+ public:
+  static Result<std::shared_ptr<XNNWorkspace>> create() {
+    xnn_workspace_t workspace = nullptr;
+    xnn_status status = xnn_create_workspace(&workspace);
+    if (status != xnn_status_success) {
+      ET_LOG(
+          Error,
+          "Failed to create XNN workspace, XNNPACK status: 0x%x",
+          (unsigned int)status);
+      return Error::Internal;
+    }
+    return std::make_shared<XNNWorkspace>(workspace);
+  }
+
+  explicit XNNWorkspace(xnn_workspace_t workspace)
+      : workspace_(workspace, &xnn_release_workspace) {}
+
+  xnn_workspace_t get() const {
+    return workspace_.get();
+  }
+
+  /**
+   * Locks the workspace for the execution of one of the runtimes using it.
+   */
+  std::unique_lock<std::mutex> lock() {
+    return std::unique_lock<std::mutex>(mutex_);
+  }
+
+  /**
+   * The number of times the workspace may have been reallocated.
+   */
+  uint64_t generation() const {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Records that a runtime using the workspace was reshaped, which may have
+   * reallocated it. Call with the workspace locked.
+   */
+  void on_runtime_reshaped() {
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+ private:
+  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_;
+  std::mutex mutex_;
+  std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
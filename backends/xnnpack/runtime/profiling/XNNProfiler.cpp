@@ -25,16 +25,40 @@
 namespace torch::executor::xnnpack::delegate::profiling {
 
 #if defined(ET_EVENT_TRACER_ENABLED) || defined(ENABLE_XNNPACK_PROFILING)
+namespace {
+// The debug handle of nodes that have none, DEFAULT_DEBUG_HANDLE in
+// xnnpack_preprocess.py.
+constexpr uint32_t kMissingDebugHandle = 65535;
+} // namespace
+
 XNNProfiler::XNNProfiler()
     : state_(XNNProfilerState::Uninitialized), run_count_(0) {}
 
-Error XNNProfiler::initialize(xnn_runtime_t runtime) {
+Error XNNProfiler::initialize(
+    xnn_runtime_t runtime,
+    std::vector<uint32_t>&& node_debug_handles) {
   runtime_ = runtime;
 
   // Fetch the runtime operator information from XNNPACK.
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_num_operators());
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_operator_names());
 
+  // XNNPACK creates an operator for each node, in the order they were
+  // defined, unless it fuses or removes nodes when optimizing the subgraph.
+  // The operators can then no longer be matched to the nodes, and are only
+  // reported by name.
+  if (node_debug_handles.size() == op_count_) {
+    op_debug_handles_ = std::move(node_debug_handles);
+  } else {
+    ET_LOG(
+        Debug,
+        "XNNPACK created %zu operators for %zu nodes, profiling events will "
+        "not have debug handles",
+        op_count_,
+        node_debug_handles.size());
+    op_debug_handles_.clear();
+  }
+
   state_ = XNNProfilerState::Ready;
 
   return Error::Ok;
@@ -210,12 +234,28 @@ void XNNProfiler::submit_trace() {
 
     auto end_time = time + interval_ticks;
 
-    torch::executor::event_tracer_log_profiling_delegate(
-        event_tracer_,
-        name_formatted.c_str(),
-        /*delegate_debug_id=*/static_cast<torch::executor::DebugHandle>(-1),
-        time,
-        end_time);
+    if (!op_debug_handles_.empty() &&
+        op_debug_handles_[i] != kMissingDebugHandle) {
+      // The preprocessed delegate maps the debug handle of each node to
+      // itself, so the event is attributed to the node it was created from.
+      // The operator name is kept as metadata.
+      torch::executor::event_tracer_log_profiling_delegate(
+          event_tracer_,
+          /*name=*/nullptr,
+          /*delegate_debug_id=*/
+          static_cast<torch::executor::DebugHandle>(op_debug_handles_[i]),
+          time,
+          end_time,
+          name_formatted.c_str(),
+          name_formatted.size());
+    } else {
+      torch::executor::event_tracer_log_profiling_delegate(
+          event_tracer_,
+          name_formatted.c_str(),
+          /*delegate_debug_id=*/static_cast<torch::executor::DebugHandle>(-1),
+          time,
+          end_time);
+    }
 
     // Assume that the next op starts immediately after the previous op.
     // This may not be strictly true, but it should be close enough.
@@ -230,8 +270,11 @@ void XNNProfiler::submit_trace() {
 // Stub implementation for when profiling is disabled.
 XNNProfiler::XNNProfiler() {}
 
-Error XNNProfiler::initialize(xnn_runtime_t runtime) {
+Error XNNProfiler::initialize(
+    xnn_runtime_t runtime,
+    std::vector<uint32_t>&& node_debug_handles) {
   (void)runtime;
+  (void)node_debug_handles;
   return Error::Ok;
 }
 
@@ -28,9 +28,13 @@ class XNNProfiler {
 
   /**
    * Initialize the profiler. This must be called after model is
-   * compiled and before calling begin_execution.
+   * compiled and before calling begin_execution. node_debug_handles holds
+   * the debug handle of each node of the runtime's subgraph, in the order
+   * they were defined.
    */
-  Error initialize(xnn_runtime_t runtime);
+  Error initialize(
+      xnn_runtime_t runtime,
+      std::vector<uint32_t>&& node_debug_handles = {});
 
   /**
    * Start a new profiling session. This is typically invoked
@@ -53,6 +57,9 @@ class XNNProfiler {
 
   size_t op_count_;
   std::vector<char> op_names_;
+  // The debug handle of the node each operator was created from, or empty
+  // if the operators can't be matched to the nodes.
+  std::vector<uint32_t> op_debug_handles_;
   std::vector<uint64_t> op_timings_;
   uint64_t run_count_;
   et_timestamp_t start_time_;
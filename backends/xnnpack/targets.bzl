@@ -38,8 +38,10 @@ def define_common_targets():
         preprocessor_flags = [
             # Uncomment to enable per operator timings
             # "-DENABLE_XNNPACK_PROFILING",
-            # Uncomment to enable workspace sharing across delegates
-            # "-DENABLE_XNNPACK_SHARED_WORKSPACE"
+            # Comment out to disable workspace sharing across delegates
+            "-DENABLE_XNNPACK_SHARED_WORKSPACE",
+            # Uncomment to enable weights cache sharing across delegates
+            # "-DENABLE_XNNPACK_WEIGHTS_CACHE"
         ],
         exported_deps = [
             "//executorch/runtime/backend:interface",
@@ -0,0 +1,47 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+import torch
+from executorch.backends.xnnpack.test.tester import Tester
+
+
+class TestClone(unittest.TestCase):
+    class Clone(torch.nn.Module):
+        def forward(self, x):
+            z = x + x
+            z = torch.clone(z)
+            return z * z
+
+    class ConvClone(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.conv = torch.nn.Conv2d(2, 4, 3)
+
+        def forward(self, x):
+            return torch.relu(torch.clone(self.conv(x)))
+
+    def _test_clone(self, module, inputs):
+        (
+            Tester(module, inputs)
+            .export()
+            .to_edge_transform_and_lower()
+            .check_count({"torch.ops.higher_order.executorch_call_delegate": 1})
+            .check_not(["executorch_exir_dialects_edge__ops_aten_clone_default"])
+            .to_executorch()
+            .serialize()
+            .run_method_and_compare_outputs()
+        )
+
+    def test_fp16_clone(self):
+        self._test_clone(self.Clone(), (torch.randn(2, 3, 4).to(torch.float16),))
+
+    def test_fp32_clone(self):
+        self._test_clone(self.Clone(), (torch.randn(2, 3, 4),))
+
+    def test_fp32_clone_nhwc(self):
+        self._test_clone(self.ConvClone(), (torch.randn(1, 2, 6, 6),))
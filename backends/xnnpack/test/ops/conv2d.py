@@ -13,8 +13,22 @@ from executorch.backends.xnnpack.test.test_xnnpack_utils import randomize_bn
 from executorch.backends.xnnpack.test.tester import Quantize, Tester
 from torch.ao.quantization.quantizer.xnnpack_quantizer import (
     get_symmetric_quantization_config,
+    XNNPACKQuantizer,
 )
-from torch.ao.quantization.quantizer.xnnpack_quantizer_utils import QuantizationConfig
+from torch.ao.quantization.quantizer.xnnpack_quantizer_utils import (
+    OP_TO_ANNOTATOR,
+    QuantizationConfig,
+)
+
+
+class DynamicConvQuantizer(XNNPACKQuantizer):
+    """
+    XNNPACKQuantizer only annotates linear for dynamic quantization
+    """
+
+    def annotate(self, model: torch.fx.GraphModule) -> torch.fx.GraphModule:
+        OP_TO_ANNOTATOR["conv"](model, self.global_config)
+        return model
 
 
 class Conv2d(torch.nn.Module):
@@ -154,11 +168,14 @@ class TestConv2d(unittest.TestCase):
         quant_config: Optional[QuantizationConfig] = None,
         conv_count=1,
         dtype: torch.dtype = torch.float,
+        quantizer: Optional[XNNPACKQuantizer] = None,
     ):
         tester = Tester(m.eval(), m.get_inputs())
 
         if quant_config is not None:
-            tester = tester.quantize(Quantize(quantization_config=quant_config))
+            tester = tester.quantize(
+                Quantize(quantizer=quantizer, quantization_config=quant_config)
+            )
             tester.check(["torch.ops.quantized_decomposed"])
 
         (
@@ -201,6 +218,16 @@ class TestConv2d(unittest.TestCase):
             quant_config=get_symmetric_quantization_config(is_per_channel=True),
         )
 
+    def test_qd8_conv2d_per_channel(self) -> None:
+        for has_bias in (True, False):
+            self._test(
+                Conv2d(bias=has_bias, batches=2),
+                quant_config=get_symmetric_quantization_config(
+                    is_per_channel=True, is_dynamic=True
+                ),
+                quantizer=DynamicConvQuantizer(),
+            )
+
     def test_fp32_conv2d_seq(self) -> None:
         self._test(Conv2dSeq(), conv_count=2)
 
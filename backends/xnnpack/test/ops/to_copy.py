@@ -0,0 +1,40 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+import torch
+from executorch.backends.xnnpack.test.tester import Tester
+
+
+class TestToCopy(unittest.TestCase):
+    class Cast(torch.nn.Module):
+        def __init__(self, dtype):
+            super().__init__()
+            self.dtype = dtype
+
+        def forward(self, x):
+            z = x + x
+            z = z.to(self.dtype)
+            return z * z
+
+    def _test_cast(self, dtype, inputs):
+        (
+            Tester(self.Cast(dtype), inputs)
+            .export()
+            .to_edge_transform_and_lower()
+            .check_count({"torch.ops.higher_order.executorch_call_delegate": 1})
+            .check_not(["executorch_exir_dialects_edge__ops_aten__to_copy_default"])
+            .to_executorch()
+            .serialize()
+            .run_method_and_compare_outputs()
+        )
+
+    def test_fp32_to_fp16(self):
+        self._test_cast(torch.float16, (torch.randn(2, 3, 4),))
+
+    def test_fp16_to_fp32(self):
+        self._test_cast(torch.float32, (torch.randn(2, 3, 4).to(torch.float16),))
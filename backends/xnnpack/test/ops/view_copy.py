@@ -0,0 +1,75 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+import torch
+from executorch.backends.xnnpack.test.tester import Tester
+
+
+class TestViewCopy(unittest.TestCase):
+    class View(torch.nn.Module):
+        def __init__(self, new_shape):
+            super().__init__()
+            self.new_shape = new_shape
+
+        def forward(self, x):
+            z = x + x
+            z = z.view(self.new_shape)
+            return z * z
+
+    class ConvView(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.conv = torch.nn.Conv2d(2, 4, 3)
+
+        def forward(self, x):
+            z = self.conv(x)
+            return z.view(z.shape[0], -1)
+
+    def _test_view(self, module, inputs):
+        (
+            Tester(module, inputs)
+            .export()
+            .to_edge_transform_and_lower()
+            .check_count({"torch.ops.higher_order.executorch_call_delegate": 1})
+            .check_not(["executorch_exir_dialects_edge__ops_aten_view_copy_default"])
+            .to_executorch()
+            .serialize()
+            .run_method_and_compare_outputs()
+        )
+
+    def test_fp16_view_copy(self):
+        inputs = (torch.randn(2, 3, 4).to(torch.float16),)
+        self._test_view(self.View([6, 4]), inputs)
+
+    def test_fp32_view_copy(self):
+        inputs = (torch.randn(2, 3, 4),)
+        self._test_view(self.View([4, -1]), inputs)
+
+    def test_fp32_view_copy_nhwc_input(self):
+        # The view is done on the NCHW layout of the conv output
+        inputs = (torch.randn(1, 2, 6, 6),)
+        self._test_view(self.ConvView(), inputs)
+
+    def test_qs8_view_copy(self):
+        inputs = (torch.randn(2, 3, 4),)
+        (
+            Tester(self.View([6, 4]), inputs)
+            .quantize()
+            .export()
+            .to_edge_transform_and_lower()
+            .check_count({"torch.ops.higher_order.executorch_call_delegate": 1})
+            .check_not(
+                [
+                    "executorch_exir_dialects_edge__ops_aten_view_copy_default",
+                    "torch.ops.quantized_decomposed",
+                ]
+            )
+            .to_executorch()
+            .serialize()
+            .run_method_and_compare_outputs()
+        )
@@ -8,13 +8,20 @@
 
 #include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 #include <gtest/gtest.h>
 #include <xnnpack/subgraph.h>
 
+#include <limits>
+
 using torch::executor::Error;
 using torch::executor::EValue;
+using torch::executor::TensorShapeDynamism;
 using torch::executor::testing::TensorFactory;
 using torch::executor::xnnpack::delegate::XNNExecutor;
+using torch::executor::xnnpack::delegate::XNNWeightsCache;
+using torch::executor::xnnpack::delegate::XNNWeightsCacheManager;
+using torch::executor::xnnpack::delegate::XNNWorkspace;
 
 TEST(XNNExecutorTest, ArgumentWithTooManyDimensions) {
   XNNExecutor executor;
@@ -92,3 +99,397 @@ TEST(XNNExecutorTest, ArgumentWithTooManyDimensions) {
   // Check for invalid number of dimensions should fail without stack overflow.
   EXPECT_EQ(executor.prepare_args(args.data()), Error::InvalidArgument);
 }
+
+TEST(XNNExecutorTest, ReshapesAndSetsUpOnlyWhenArgsChange) {
+  XNNExecutor executor;
+  xnn_subgraph_t subgraph = nullptr;
+  xnn_runtime_t rt = nullptr;
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  ASSERT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  std::vector<size_t> dims = {
+      2,
+  };
+  auto input_id = XNN_INVALID_NODE_ID;
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id));
+  auto output_id = XNN_INVALID_NODE_ID;
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id));
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_clamp(subgraph, 0.0f, 1.0f, input_id, output_id, 0));
+
+  ASSERT_EQ(xnn_create_runtime(subgraph, &rt), xnn_status_success);
+  EXPECT_EQ(executor.initialize(rt, {0}, {1}), Error::Ok);
+
+  TensorFactory<exec_aten::ScalarType::Float> tf;
+  torch::executor::BackendExecutionContext context;
+  auto run = [&](exec_aten::Tensor input, exec_aten::Tensor output) {
+    EValue input_ev(input);
+    EValue output_ev(output);
+    std::array<EValue*, 2> args = {&input_ev, &output_ev};
+    EXPECT_EQ(executor.prepare_args(args.data()), Error::Ok);
+    EXPECT_EQ(executor.forward(context), Error::Ok);
+    EXPECT_EQ(executor.resize_outputs(args.data()), Error::Ok);
+  };
+
+  // The same shape twice, which skips reshaping the second time.
+  auto output = tf.zeros({2});
+  run(tf.make({2}, {-1.0f, 0.5f}), output);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {0.0f, 0.5f}));
+  run(tf.make({2}, {2.0f, 0.25f}), output);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {1.0f, 0.25f}));
+
+  // The same buffers with new data, which skips setting up the runtime.
+  auto input = tf.make({2}, {-3.0f, 0.125f});
+  run(input, output);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {0.0f, 0.125f}));
+  input.mutable_data_ptr<float>()[0] = 0.625f;
+  run(input, output);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {0.625f, 0.125f}));
+
+  // A new shape reshapes the runtime and resizes the output.
+  auto resized_output = tf.zeros({3}, TensorShapeDynamism::DYNAMIC_BOUND);
+  run(tf.make({1}, {0.75f}), resized_output);
+  EXPECT_TENSOR_EQ(resized_output, tf.make({1}, {0.75f}));
+}
+
+namespace {
+
+// Creates a runtime that clamps a 1-D fp32 input of two elements to [0, 1],
+// in `workspace` when given.
+xnn_runtime_t create_clamp_runtime(xnn_workspace_t workspace) {
+  xnn_subgraph_t subgraph = nullptr;
+  EXPECT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  std::vector<size_t> dims = {
+      2,
+  };
+  auto input_id = XNN_INVALID_NODE_ID;
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id));
+  auto output_id = XNN_INVALID_NODE_ID;
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id));
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_clamp(subgraph, 0.0f, 1.0f, input_id, output_id, 0));
+
+  xnn_runtime_t rt = nullptr;
+  if (workspace != nullptr) {
+    EXPECT_EQ(
+        xnn_create_runtime_v4(
+            subgraph,
+            /*weights_cache=*/nullptr,
+            workspace,
+            /*threadpool=*/nullptr,
+            /*flags=*/0,
+            &rt),
+        xnn_status_success);
+  } else {
+    EXPECT_EQ(xnn_create_runtime(subgraph, &rt), xnn_status_success);
+  }
+  return rt;
+}
+
+void run_executor(
+    XNNExecutor& executor,
+    exec_aten::Tensor input,
+    exec_aten::Tensor output) {
+  torch::executor::BackendExecutionContext context;
+  EValue input_ev(input);
+  EValue output_ev(output);
+  std::array<EValue*, 2> args = {&input_ev, &output_ev};
+  EXPECT_EQ(executor.prepare_args(args.data()), Error::Ok);
+  EXPECT_EQ(executor.forward(context), Error::Ok);
+  EXPECT_EQ(executor.resize_outputs(args.data()), Error::Ok);
+}
+
+} // namespace
+
+// Runs with a runtime of its own (false) and with one in a shared workspace
+// (true), as with and without ENABLE_XNNPACK_SHARED_WORKSPACE.
+class XNNExecutorSetupTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    et_pal_init();
+    ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+    if (GetParam()) {
+      auto workspace = XNNWorkspace::create();
+      ASSERT_TRUE(workspace.ok());
+      workspace_ = std::move(workspace.get());
+    }
+  }
+
+  std::shared_ptr<XNNWorkspace> workspace_;
+};
+
+TEST_P(XNNExecutorSetupTest, SetsUpOnlyWhenExternalValuesMove) {
+  XNNExecutor executor;
+  ASSERT_EQ(
+      executor.initialize(
+          create_clamp_runtime(workspace_ ? workspace_->get() : nullptr),
+          {0},
+          {1},
+          {},
+          workspace_),
+      Error::Ok);
+
+  TensorFactory<exec_aten::ScalarType::Float> tf;
+  auto input = tf.make({2}, {-1.0f, 0.5f});
+  auto output = tf.zeros({2});
+  run_executor(executor, input, output);
+  EXPECT_EQ(executor.num_setups(), 1);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {0.0f, 0.5f}));
+
+  // The same pointers with new data only invoke the runtime.
+  input.mutable_data_ptr<float>()[0] = 0.25f;
+  run_executor(executor, input, output);
+  EXPECT_EQ(executor.num_setups(), 1);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {0.25f, 0.5f}));
+
+  // A new input buffer sets the runtime up again, once.
+  auto other_input = tf.make({2}, {2.0f, 0.75f});
+  run_executor(executor, other_input, output);
+  EXPECT_EQ(executor.num_setups(), 2);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {1.0f, 0.75f}));
+  run_executor(executor, other_input, output);
+  EXPECT_EQ(executor.num_setups(), 2);
+
+  // So does a new output buffer.
+  auto other_output = tf.zeros({2});
+  run_executor(executor, other_input, other_output);
+  EXPECT_EQ(executor.num_setups(), 3);
+  EXPECT_TENSOR_EQ(other_output, tf.make({2}, {1.0f, 0.75f}));
+  run_executor(executor, other_input, other_output);
+  EXPECT_EQ(executor.num_setups(), 3);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SharedWorkspace,
+    XNNExecutorSetupTest,
+    ::testing::Bool());
+
+TEST(XNNExecutorTest, SetsUpAgainAfterAnotherRuntimeMovesSharedWorkspace) {
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  auto workspace = XNNWorkspace::create();
+  ASSERT_TRUE(workspace.ok());
+  std::shared_ptr<XNNWorkspace> shared = std::move(workspace.get());
+
+  XNNExecutor first;
+  ASSERT_EQ(
+      first.initialize(
+          create_clamp_runtime(shared->get()), {0}, {1}, {}, shared),
+      Error::Ok);
+  XNNExecutor second;
+  ASSERT_EQ(
+      second.initialize(
+          create_clamp_runtime(shared->get()), {0}, {1}, {}, shared),
+      Error::Ok);
+
+  TensorFactory<exec_aten::ScalarType::Float> tf;
+  auto input = tf.make({2}, {-1.0f, 0.5f});
+  auto output = tf.zeros({2});
+  run_executor(first, input, output);
+  run_executor(first, input, output);
+  EXPECT_EQ(first.num_setups(), 1);
+
+  // Reshaping the second runtime may reallocate the workspace under the
+  // first one, which then has to be set up again before it runs.
+  auto second_output = tf.zeros({2});
+  run_executor(second, input, second_output);
+  EXPECT_EQ(second.num_setups(), 1);
+
+  input.mutable_data_ptr<float>()[1] = 0.125f;
+  run_executor(first, input, output);
+  EXPECT_EQ(first.num_setups(), 2);
+  EXPECT_TENSOR_EQ(output, tf.make({2}, {0.0f, 0.125f}));
+  run_executor(first, input, output);
+  EXPECT_EQ(first.num_setups(), 2);
+
+  // The second runtime was set up after the last reshape.
+  run_executor(second, input, second_output);
+  EXPECT_EQ(second.num_setups(), 1);
+  EXPECT_TENSOR_EQ(second_output, tf.make({2}, {0.0f, 0.125f}));
+}
+
+namespace {
+
+// Creates a runtime that multiplies a [batch_size, 3] fp32 input by the
+// transpose of the [2, 3] `weights`, packing them into `weights_cache`.
+xnn_runtime_t create_fully_connected_runtime(
+    size_t batch_size,
+    const float* weights,
+    XNNWeightsCache& weights_cache) {
+  xnn_subgraph_t subgraph = nullptr;
+  EXPECT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  std::vector<size_t> input_dims = {batch_size, 3};
+  auto input_id = XNN_INVALID_NODE_ID;
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          input_dims.size(),
+          input_dims.data(),
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id));
+  std::vector<size_t> weights_dims = {2, 3};
+  auto weights_id = XNN_INVALID_NODE_ID;
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          weights_dims.size(),
+          weights_dims.data(),
+          weights,
+          /*external_id=*/XNN_INVALID_VALUE_ID,
+          /*flags=*/0,
+          &weights_id));
+  std::vector<size_t> output_dims = {batch_size, 2};
+  auto output_id = XNN_INVALID_NODE_ID;
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          output_dims.size(),
+          output_dims.data(),
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id));
+  EXPECT_EQ(
+      xnn_status_success,
+      xnn_define_fully_connected(
+          subgraph,
+          -std::numeric_limits<float>::infinity(),
+          std::numeric_limits<float>::infinity(),
+          input_id,
+          weights_id,
+          /*bias_id=*/XNN_INVALID_VALUE_ID,
+          output_id,
+          /*flags=*/0));
+
+  xnn_runtime_t rt = nullptr;
+  EXPECT_EQ(
+      xnn_create_runtime_v3(
+          subgraph,
+          weights_cache.get(),
+          /*threadpool=*/nullptr,
+          /*flags=*/0,
+          &rt),
+      xnn_status_success);
+  return rt;
+}
+
+} // namespace
+
+TEST(XNNExecutorTest, RuntimesSharingWeightsFinalizeTheCacheOnce) {
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+
+  // Two delegates with the same weights, loaded before either runs, as the
+  // backend does in init().
+  const float weights[] = {1.0f, 2.0f, 3.0f, -1.0f, 0.0f, 1.0f};
+  XNNWeightsCacheManager weights_caches;
+  auto first_cache = weights_caches.open_cache();
+  ASSERT_TRUE(first_cache.ok());
+  XNNExecutor first;
+  ASSERT_EQ(
+      first.initialize(
+          create_fully_connected_runtime(1, weights, *first_cache.get()),
+          {0},
+          {1},
+          {},
+          nullptr,
+          first_cache.get()),
+      Error::Ok);
+  auto second_cache = weights_caches.open_cache();
+  ASSERT_TRUE(second_cache.ok());
+  XNNExecutor second;
+  ASSERT_EQ(
+      second.initialize(
+          create_fully_connected_runtime(2, weights, *second_cache.get()),
+          {0},
+          {1},
+          {},
+          nullptr,
+          second_cache.get()),
+      Error::Ok);
+  ASSERT_EQ(first.weights_cache(), second.weights_cache());
+  XNNWeightsCache* weights_cache = first.weights_cache();
+
+  // Each delegate finalizes the cache before it first runs, as the backend
+  // does in execute(). XNNPACK fails to finalize a cache twice, so only the
+  // first one finalizes it.
+  ASSERT_EQ(weights_caches.finalize(first.weights_cache()), Error::Ok);
+  EXPECT_TRUE(weights_cache->is_finalized());
+  TensorFactory<exec_aten::ScalarType::Float> tf;
+  auto first_output = tf.zeros({1, 2});
+  run_executor(first, tf.make({1, 3}, {1.0f, 1.0f, 1.0f}), first_output);
+  EXPECT_TENSOR_EQ(first_output, tf.make({1, 2}, {6.0f, 0.0f}));
+
+  ASSERT_EQ(weights_caches.finalize(second.weights_cache()), Error::Ok);
+  auto second_output = tf.zeros({2, 2});
+  run_executor(
+      second,
+      tf.make({2, 3}, {1.0f, 0.0f, 2.0f, 0.0f, 1.0f, -1.0f}),
+      second_output);
+  EXPECT_TENSOR_EQ(second_output, tf.make({2, 2}, {7.0f, 1.0f, -1.0f, -1.0f}));
+
+  // Delegates loaded after that get a new cache.
+  auto next_cache = weights_caches.open_cache();
+  ASSERT_TRUE(next_cache.ok());
+  EXPECT_NE(next_cache.get().get(), weights_cache);
+  EXPECT_FALSE(next_cache.get()->is_finalized());
+}
@@ -7,6 +7,9 @@
  */
 
 #include <executorch/runtime/platform/assert.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
 #include <fstream>
 #include <mutex>
 #include <string>
@@ -27,8 +30,8 @@ namespace cpuinfo {
 #define RIVISION_MASK UINT32_C(0xFFFFFFF0)
 
 namespace {
-bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
-  switch (uarch_info->uarch) {
+bool is_non_performant_uarch(enum cpuinfo_uarch uarch, uint32_t midr) {
+  switch (uarch) {
     case cpuinfo_uarch_cortex_a55:
     case cpuinfo_uarch_cortex_a53:
     case cpuinfo_uarch_cortex_a510:
@@ -41,16 +44,22 @@ bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
     default:
       break;
   }
-    // A520 is not yet updated in cpuinfo
-    // Hence decode it separately.
-#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-  if ((uarch_info->midr & RIVISION_MASK) == CPUINFO_ARM_MIDR_CORTEX_A520) {
+  // A520 is not yet updated in cpuinfo
+  // Hence decode it separately.
+  if ((midr & RIVISION_MASK) == CPUINFO_ARM_MIDR_CORTEX_A520) {
     return true;
   }
-#endif
   return false;
 }
 
+bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+  return is_non_performant_uarch(uarch_info->uarch, uarch_info->midr);
+#else
+  return is_non_performant_uarch(uarch_info->uarch, 0);
+#endif
+}
+
 std::vector<uint32_t>* get_static_cpu_midr_vector() {
   static std::vector<uint32_t> cpu_midrs;
   return &cpu_midrs;
@@ -171,6 +180,94 @@ uint32_t get_num_performant_cores() {
   }
 }
 
+std::vector<uint32_t> get_performant_cpu_ids() {
+  ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo cannot be initialized.");
+  std::vector<uint32_t> cpu_ids;
+#if defined(__linux__)
+  const uint32_t num_processors = cpuinfo_get_processors_count();
+  for (uint32_t i = 0; i < num_processors; ++i) {
+    const struct cpuinfo_processor* processor = cpuinfo_get_processor(i);
+    const struct cpuinfo_core* core = processor->core;
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+    const uint32_t midr = core->midr;
+#else
+    const uint32_t midr = 0;
+#endif
+    if (!is_non_performant_uarch(core->uarch, midr)) {
+      cpu_ids.push_back(static_cast<uint32_t>(processor->linux_id));
+    }
+  }
+  if (cpu_ids.size() == num_processors) {
+    // Nothing to exclude.
+    cpu_ids.clear();
+  }
+#endif
+  ET_LOG(Info, "Number of performant CPU ids %zu", cpu_ids.size());
+  return cpu_ids;
+}
+
+namespace {
+// Reads a list of ids in the format of sysfs, e.g. "0-3,8,10-11", calling
+// `fn` for each id. Returns false if the list can't be read or is malformed.
+template <typename Fn>
+bool read_id_list(const std::string& path, Fn fn) {
+  std::ifstream file(path);
+  std::string list;
+  if (!file || !std::getline(file, list)) {
+    return false;
+  }
+  const char* pos = list.c_str();
+  while (*pos != '\0') {
+    char* end = nullptr;
+    const unsigned long first = std::strtoul(pos, &end, 10);
+    if (end == pos) {
+      return false;
+    }
+    unsigned long last = first;
+    if (*end == '-') {
+      pos = end + 1;
+      last = std::strtoul(pos, &end, 10);
+      if (end == pos || last < first) {
+        return false;
+      }
+    }
+    for (unsigned long id = first; id <= last; ++id) {
+      fn(static_cast<uint32_t>(id));
+    }
+    pos = *end == ',' ? end + 1 : end;
+  }
+  return true;
+}
+} // namespace
+
+uint32_t get_numa_node_count() {
+  uint32_t count = 1;
+#if defined(__linux__)
+  read_id_list("/sys/devices/system/node/online", [&](uint32_t node) {
+    count = std::max(count, node + 1);
+  });
+#endif
+  return count;
+}
+
+std::vector<uint32_t> get_numa_node_cpu_ids(uint32_t numa_node) {
+  std::vector<uint32_t> cpu_ids;
+#if defined(__linux__)
+  if (!read_id_list(
+          "/sys/devices/system/node/node" + std::to_string(numa_node) +
+              "/cpulist",
+          [&](uint32_t cpu_id) { cpu_ids.push_back(cpu_id); })) {
+    cpu_ids.clear();
+  }
+#endif
+  ET_LOG(
+      Info,
+      "Number of CPU ids of NUMA node %" PRIu32 ": %zu",
+      numa_node,
+      cpu_ids.size());
+  return cpu_ids;
+}
+
 } // namespace cpuinfo
 } // namespace executorch
 } // namespace torch
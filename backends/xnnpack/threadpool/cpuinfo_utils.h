@@ -10,12 +10,39 @@
 
 #include <cpuinfo.h>
 
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <vector>
+
 namespace torch {
 namespace executorch {
 namespace cpuinfo {
 
 uint32_t get_num_performant_cores();
 
+/**
+ * Returns the OS ids of the logical CPUs that are not efficiency cores, for
+ * use as ThreadPoolOptions::cpu_ids. Returns an empty vector if all cores
+ * are of the same kind or if they cannot be told apart, e.g. on platforms
+ * where cpuinfo does not report OS CPU ids.
+ */
+std::vector<uint32_t> get_performant_cpu_ids();
+
+/**
+ * Returns the number of NUMA nodes, i.e. one more than the highest node
+ * number the OS reports as online, or 1 if it doesn't report NUMA nodes or
+ * isn't Linux.
+ */
+uint32_t get_numa_node_count();
+
+/**
+ * Returns the OS ids of the logical CPUs of NUMA node `numa_node`, for use as
+ * ThreadPoolOptions::cpu_ids so that a pool only runs on that node, e.g. to
+ * give each model replica of a multi-socket server its own pool next to its
+ * memory. Returns an empty vector if the node doesn't exist or the OS doesn't
+ * report it.
+ */
+std::vector<uint32_t> get_numa_node_cpu_ids(uint32_t numa_node);
+
 } // namespace cpuinfo
 } // namespace executorch
 } // namespace torch
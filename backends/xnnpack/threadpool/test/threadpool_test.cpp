@@ -7,10 +7,18 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <numeric>
 #include <random>
+#include <thread>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <executorch/backends/xnnpack/threadpool/cpuinfo_utils.h>
 #include <executorch/backends/xnnpack/threadpool/threadpool.h>
 #include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
 
@@ -186,3 +194,150 @@ TEST(TestNoThreadPoolGuard, TestRunWithGuard) {
   }
   ASSERT_EQ(inner, 6);
 }
+
+TEST(ThreadPoolTest, RunWithContext) {
+  std::vector<std::atomic<int32_t>> counts(64);
+  for (auto& count : counts) {
+    count = 0;
+  }
+  auto pool = torch::executorch::threadpool::get_threadpool();
+  pool->run(
+      [](void* context, const size_t task_id) {
+        auto* counts = static_cast<std::vector<std::atomic<int32_t>>*>(context);
+        (*counts)[task_id] += 1;
+      },
+      &counts,
+      counts.size());
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(ThreadPoolTest, ConfigureWorkerThreadsWithDefaults) {
+  torch::executorch::threadpool::ThreadPool pool(2);
+  EXPECT_TRUE(pool.configure_worker_threads(
+      {}, torch::executorch::threadpool::ThreadPriority::Default));
+
+  std::atomic<size_t> sum{0};
+  pool.run([&sum](const size_t task_id) { sum += task_id; }, 10);
+  EXPECT_EQ(sum.load(), 45);
+}
+
+#if defined(__linux__)
+TEST(ThreadPoolTest, WorkerThreadsArePinned) {
+  cpu_set_t allowed;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  uint32_t cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed)) {
+    ++cpu;
+  }
+
+  torch::executorch::threadpool::ThreadPoolOptions options;
+  options.thread_count = 2;
+  options.cpu_ids = {cpu};
+  torch::executorch::threadpool::ThreadPool pool(options);
+
+  const std::thread::id caller = std::this_thread::get_id();
+  std::mutex mutex;
+  std::vector<int> worker_cpus;
+  pool.run(
+      [&](const size_t /* task_id */) {
+        if (std::this_thread::get_id() != caller) {
+          std::lock_guard<std::mutex> lock(mutex);
+          worker_cpus.push_back(sched_getcpu());
+        }
+      },
+      100);
+  for (const int worker_cpu : worker_cpus) {
+    EXPECT_EQ(worker_cpu, cpu);
+  }
+
+  // The calling thread keeps its own affinity.
+  cpu_set_t current;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(current), &current), 0);
+  EXPECT_TRUE(CPU_EQUAL(&current, &allowed));
+}
+
+TEST(ThreadPoolTest, NumaNodePoolRunsOnTheNode) {
+  ASSERT_GE(torch::executorch::cpuinfo::get_numa_node_count(), 1);
+  const std::vector<uint32_t> node_cpus =
+      torch::executorch::cpuinfo::get_numa_node_cpu_ids(0);
+  if (node_cpus.empty()) {
+    GTEST_SKIP() << "The OS doesn't report NUMA nodes";
+  }
+  EXPECT_TRUE(torch::executorch::cpuinfo::get_numa_node_cpu_ids(
+                  torch::executorch::cpuinfo::get_numa_node_count())
+                  .empty());
+
+  torch::executorch::threadpool::ThreadPoolOptions options;
+  options.thread_count = 2;
+  options.cpu_ids = node_cpus;
+  torch::executorch::threadpool::ThreadPool pool(options);
+
+  const std::thread::id caller = std::this_thread::get_id();
+  std::mutex mutex;
+  std::vector<int> worker_cpus;
+  pool.run(
+      [&](const size_t /* task_id */) {
+        if (std::this_thread::get_id() != caller) {
+          std::lock_guard<std::mutex> lock(mutex);
+          worker_cpus.push_back(sched_getcpu());
+        }
+      },
+      100);
+  for (const int worker_cpu : worker_cpus) {
+    EXPECT_NE(
+        std::find(node_cpus.begin(), node_cpus.end(), worker_cpu),
+        node_cpus.end());
+  }
+}
+#endif
+
+TEST(ThreadPoolTest, WorkerWaitPolicy) {
+  using torch::executorch::threadpool::WorkerWaitPolicy;
+
+  torch::executorch::threadpool::ThreadPoolOptions options;
+  options.thread_count = 2;
+  options.wait_policy = WorkerWaitPolicy::Sleep;
+  torch::executorch::threadpool::ThreadPool pool(options);
+  EXPECT_EQ(pool.get_worker_wait_policy(), WorkerWaitPolicy::Sleep);
+
+  std::atomic<size_t> sum{0};
+  auto fn = [&sum](const size_t task_id) { sum += task_id; };
+  pool.run(fn, 10);
+  pool.run(fn, 10);
+  EXPECT_EQ(sum.load(), 2 * 45);
+
+  pool.set_worker_wait_policy(WorkerWaitPolicy::Spin);
+  EXPECT_EQ(pool.get_worker_wait_policy(), WorkerWaitPolicy::Spin);
+  pool.run(fn, 10);
+  EXPECT_EQ(sum.load(), 3 * 45);
+}
+
+TEST(TestUseThreadPoolGuard, InstallsPoolOnThisThread) {
+  auto default_pool = torch::executorch::threadpool::get_threadpool();
+  auto default_pthreadpool = torch::executorch::threadpool::get_pthreadpool();
+
+  torch::executorch::threadpool::ThreadPool pool(2);
+  {
+    torch::executorch::threadpool::UseThreadPoolGuard g1(&pool);
+    EXPECT_EQ(torch::executorch::threadpool::get_threadpool(), &pool);
+    EXPECT_NE(
+        torch::executorch::threadpool::get_pthreadpool(), default_pthreadpool);
+
+    // Other threads keep using the default pool.
+    std::thread other([default_pool]() {
+      EXPECT_EQ(torch::executorch::threadpool::get_threadpool(), default_pool);
+    });
+    other.join();
+
+    {
+      torch::executorch::threadpool::UseThreadPoolGuard g2(default_pool);
+      EXPECT_EQ(torch::executorch::threadpool::get_threadpool(), default_pool);
+    }
+    EXPECT_EQ(torch::executorch::threadpool::get_threadpool(), &pool);
+  }
+  EXPECT_EQ(torch::executorch::threadpool::get_threadpool(), default_pool);
+  EXPECT_EQ(
+      torch::executorch::threadpool::get_pthreadpool(), default_pthreadpool);
+}
@@ -9,16 +9,33 @@
 #include <executorch/backends/xnnpack/threadpool/threadpool.h>
 #include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
 #include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/log.h>
 #include <algorithm>
 
 #include <cpuinfo.h>
 
 #include <atomic>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace torch {
 namespace executorch {
 namespace threadpool {
 
+namespace {
+// Set by UseThreadPoolGuard.
+thread_local ThreadPool* current_threadpool = nullptr;
+} // namespace
+
 #if !(defined(WIN32))
 namespace {
 // After fork, the child process inherits the data-structures of the parent
@@ -37,6 +54,21 @@ void child_atfork() {
 ThreadPool::ThreadPool(size_t thread_count)
     : threadpool_(pthreadpool_create(thread_count), pthreadpool_destroy) {}
 
+ThreadPool::ThreadPool(const ThreadPoolOptions& options)
+    : threadpool_(
+          pthreadpool_create(options.thread_count),
+          pthreadpool_destroy),
+      cpu_ids_(options.cpu_ids),
+      priority_(options.priority),
+      wait_policy_(options.wait_policy) {
+  if (!cpu_ids_.empty() || priority_ != ThreadPriority::Default) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!configure_worker_threads_locked()) {
+      ET_LOG(Error, "Failed to configure the threads of a new threadpool");
+    }
+  }
+}
+
 size_t ThreadPool::get_thread_count() const {
   std::lock_guard<std::mutex> lock{mutex_};
 
@@ -53,48 +85,130 @@ bool ThreadPool::_unsafe_reset_threadpool(uint32_t new_thread_count) {
   std::lock_guard<std::mutex> lock{mutex_};
 
   threadpool_.reset(pthreadpool_create(new_thread_count));
+  if (!cpu_ids_.empty() || priority_ != ThreadPriority::Default) {
+    return configure_worker_threads_locked();
+  }
   return true;
 }
 
-void ThreadPool::run(
-    const std::function<void(size_t)>& fn,
-    const size_t range) {
-  // Run on same thread if NoThreadPoolGuard guard is enabled
+bool ThreadPool::configure_worker_threads(
+    const std::vector<uint32_t>& cpu_ids,
+    ThreadPriority priority) {
   if (NoThreadPoolGuard::is_enabled()) {
-    for (size_t i = 0; i < range; ++i) {
-      fn(i);
-    }
-    return;
+    ET_LOG(Error, "Cannot configure a threadpool inside a threadpool guard");
+    return false;
   }
 
   std::lock_guard<std::mutex> lock{mutex_};
+  cpu_ids_ = cpu_ids;
+  priority_ = priority;
+  return configure_worker_threads_locked();
+}
 
-  ET_CHECK_MSG(!NoThreadPoolGuard::is_enabled(), "Inside a threadpool guard!");
+bool ThreadPool::configure_worker_threads_locked() {
   ET_CHECK_MSG(threadpool_.get(), "Invalid threadpool!");
+  const size_t thread_count = pthreadpool_get_threads_count(threadpool_.get());
 
+  // pthreadpool gives each of its threads an equal share of the range, so a
+  // range of thread_count items puts exactly one item on every thread as long
+  // as no thread finishes early and steals another's item. Holding every item
+  // until all of them have started guarantees that.
   struct Context final {
-    const std::function<void(size_t)>& fn;
+    const std::vector<uint32_t>& cpu_ids;
+    const ThreadPriority priority;
+    const size_t thread_count;
+    const std::thread::id caller;
+    std::atomic<size_t> num_started;
+    std::atomic<bool> ok;
   } context{
-      fn,
+      cpu_ids_,
+      priority_,
+      thread_count,
+      std::this_thread::get_id(),
+      {0},
+      {true},
   };
 
   pthreadpool_parallelize_1d(
       threadpool_.get(),
-      // Note: pthreadpool_parallelize_1d() is a blocking function.  The
-      // function pointer to this lambda passed on to
-      // pthreadpool_parallelize_1d() cannot go out of scope until
-      // pthreadpool_parallelize_1d() returns.
-      [](void* const context, const size_t item) {
-        reinterpret_cast<Context*>(context)->fn(item);
+      [](void* const context, const size_t /* item */) {
+        Context* const ctx = reinterpret_cast<Context*>(context);
+        ctx->num_started.fetch_add(1);
+        while (ctx->num_started.load() < ctx->thread_count) {
+          std::this_thread::yield();
+        }
+        // The calling thread also runs one of the items; leave it alone.
+        if (std::this_thread::get_id() == ctx->caller) {
+          return;
+        }
+        if (!set_current_thread_affinity(ctx->cpu_ids)) {
+          ctx->ok.store(false);
+        }
+        if (!set_current_thread_priority(ctx->priority)) {
+          ctx->ok.store(false);
+        }
       },
       &context,
-      range,
+      thread_count,
       0u);
+  return context.ok.load();
+}
+
+void ThreadPool::run(
+    const std::function<void(size_t)>& fn,
+    const size_t range) {
+  run(
+      [](void* const context, const size_t item) {
+        (*reinterpret_cast<const std::function<void(size_t)>*>(context))(item);
+      },
+      const_cast<std::function<void(size_t)>*>(&fn),
+      range);
+}
+
+void ThreadPool::run(
+    void (*fn)(void* context, size_t task_id),
+    void* context,
+    const size_t range) {
+  // Run on same thread if NoThreadPoolGuard guard is enabled
+  if (NoThreadPoolGuard::is_enabled()) {
+    for (size_t i = 0; i < range; ++i) {
+      fn(context, i);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  ET_CHECK_MSG(!NoThreadPoolGuard::is_enabled(), "Inside a threadpool guard!");
+  ET_CHECK_MSG(threadpool_.get(), "Invalid threadpool!");
+
+  // Note: pthreadpool_parallelize_1d() is a blocking function, so `context`
+  // only has to outlive this call.
+  pthreadpool_parallelize_1d(
+      threadpool_.get(), fn, context, range, run_flags());
+}
+
+void ThreadPool::set_worker_wait_policy(WorkerWaitPolicy policy) {
+  wait_policy_.store(policy);
+}
+
+WorkerWaitPolicy ThreadPool::get_worker_wait_policy() const {
+  return wait_policy_.load();
+}
+
+uint32_t ThreadPool::run_flags() const {
+  if (wait_policy_.load() == WorkerWaitPolicy::Spin) {
+    return 0u;
+  }
+  return PTHREADPOOL_FLAG_YIELD_WORKERS;
 }
 
 // get_threadpool is not thread safe due to leak_corrupted_threadpool
 // Make this part threadsafe: TODO(kimishpatel)
 ThreadPool* get_threadpool() {
+  if (current_threadpool != nullptr) {
+    return current_threadpool;
+  }
   ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo initialization failed");
   int num_threads = cpuinfo_get_processors_count();
   /*
@@ -137,6 +251,74 @@ pthreadpool_t get_pthreadpool() {
   return threadpool->threadpool_.get();
 }
 
+UseThreadPoolGuard::UseThreadPoolGuard(ThreadPool* threadpool)
+    : prev_threadpool_(current_threadpool) {
+  current_threadpool = threadpool;
+}
+
+UseThreadPoolGuard::~UseThreadPoolGuard() {
+  current_threadpool = prev_threadpool_;
+}
+
+bool set_current_thread_affinity(const std::vector<uint32_t>& cpu_ids) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (cpu_ids.empty()) {
+    // The kernel drops CPUs that are offline or outside of this process'
+    // cpuset, so setting all of them lifts any restriction.
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  for (const uint32_t cpu : cpu_ids) {
+    if (cpu >= CPU_SETSIZE) {
+      ET_LOG(Error, "CPU id %u is out of range", (unsigned)cpu);
+      return false;
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    ET_LOG(Error, "Failed to set the CPU affinity of the current thread");
+    return false;
+  }
+  return true;
+#else
+  if (!cpu_ids.empty()) {
+    ET_LOG(Error, "CPU affinity is not supported on this platform");
+    return false;
+  }
+  return true;
+#endif
+}
+
+bool set_current_thread_priority(ThreadPriority priority) {
+  if (priority == ThreadPriority::Default) {
+    return true;
+  }
+#if defined(__APPLE__)
+  const qos_class_t qos_class = priority == ThreadPriority::Low
+      ? QOS_CLASS_UTILITY
+      : QOS_CLASS_USER_INTERACTIVE;
+  if (pthread_set_qos_class_self_np(qos_class, 0) != 0) {
+    ET_LOG(Error, "Failed to set the QoS class of the current thread");
+    return false;
+  }
+  return true;
+#elif defined(__linux__)
+  // On Linux, setpriority() on a thread id only affects that thread.
+  const int nice_value = priority == ThreadPriority::Low ? 10 : -10;
+  if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice_value) != 0) {
+    ET_LOG(Error, "Failed to set the priority of the current thread");
+    return false;
+  }
+  return true;
+#else
+  ET_LOG(Error, "Thread priorities are not supported on this platform");
+  return false;
+#endif
+}
+
 } // namespace threadpool
 } // namespace executorch
 } // namespace torch
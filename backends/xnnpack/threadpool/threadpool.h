@@ -2,20 +2,72 @@
 
 #include <pthreadpool.h>
 
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <atomic>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <functional>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <memory>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <mutex>
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <vector>
 
 namespace torch {
 namespace executorch {
 namespace threadpool {
 
+/**
+ * Scheduling priority of the threads of a ThreadPool.
+ */
+enum class ThreadPriority {
+  /// Leave the priority that the threads were created with.
+  Default,
+  /// Below normal priority, for work that should not compete with the UI.
+  /// Maps to QOS_CLASS_UTILITY on Apple platforms and to a positive nice
+  /// value on Linux and Android.
+  Low,
+  /// Above normal priority, for latency sensitive work. Maps to
+  /// QOS_CLASS_USER_INTERACTIVE on Apple platforms and to a negative nice
+  /// value on Linux and Android, which may require extra privileges.
+  High,
+};
+
+/**
+ * What the worker threads of a ThreadPool do between two calls to run().
+ */
+enum class WorkerWaitPolicy {
+  /// Spin for a short while waiting for the next run() before going to sleep,
+  /// so that back to back runs don't pay for waking the workers up. The length
+  /// of the spin is fixed when pthreadpool is built.
+  Spin,
+  /// Go to sleep as soon as a run() is done, or, for XNNPACK delegates, as
+  /// soon as each of their executions is done. Saves power when runs are rare,
+  /// at the cost of waking the workers up for the next one.
+  Sleep,
+};
+
+struct ThreadPoolOptions {
+  /// Number of threads, including the thread that calls run(). Zero means one
+  /// thread per processor.
+  size_t thread_count = 0;
+  /// Logical CPUs, as numbered by the OS, that the worker threads may run on.
+  /// Empty means no restriction. Only supported on Linux and Android.
+  std::vector<uint32_t> cpu_ids;
+  ThreadPriority priority = ThreadPriority::Default;
+  WorkerWaitPolicy wait_policy = WorkerWaitPolicy::Spin;
+};
+
 class ThreadPool final {
  public:
   explicit ThreadPool(size_t thread_count = 0);
+
+  /*
+   * Creates a threadpool and configures its worker threads as described by
+   * `options`. Settings that cannot be applied on this platform are logged
+   * and otherwise ignored.
+   */
+  explicit ThreadPool(const ThreadPoolOptions& options);
   ~ThreadPool() = default;
 
   // Make threadpool non copyable
@@ -45,6 +97,31 @@ class ThreadPool final {
    */
   bool _unsafe_reset_threadpool(uint32_t num_threads);
 
+  /*
+   * Pins the worker threads of this pool to `cpu_ids` (no restriction when
+   * empty) and sets their priority. The settings are also applied to the
+   * threads created by later calls to _unsafe_reset_threadpool().
+   *
+   * The thread that calls run() takes part in running the tasks but is not
+   * changed by this call; use set_current_thread_affinity() and
+   * set_current_thread_priority() to configure it.
+   *
+   * Returns false if any of the settings could not be applied. Must not be
+   * called from one of the tasks of this pool.
+   */
+  bool configure_worker_threads(
+      const std::vector<uint32_t>& cpu_ids,
+      ThreadPriority priority);
+
+  /*
+   * Sets what the worker threads do between runs; see WorkerWaitPolicy.
+   * XNNPACK delegates take the policy of their pool when they are
+   * initialized, so set it before loading methods that use them.
+   */
+  void set_worker_wait_policy(WorkerWaitPolicy policy);
+
+  WorkerWaitPolicy get_worker_wait_policy() const;
+
   // Run, in parallel, function fn(task_id) over task_id in range [0, range).
   // This function is blocking.  All input is processed by the time it returns.
   // NoThreadPoolGuard (see threadpool_guard.h) can used to disable
@@ -52,9 +129,21 @@ class ThreadPool final {
   // When NoThreadPoolGuard is not used all calls to run method are serialized.
   void run(const std::function<void(size_t)>& fn, size_t range);
 
+  // Same as above, but calls fn(context, task_id) directly instead of through
+  // a std::function, so that it never allocates.
+  void run(
+      void (*fn)(void* context, size_t task_id),
+      void* context,
+      size_t range);
+
  private:
   friend pthreadpool_t get_pthreadpool();
 
+  bool configure_worker_threads_locked();
+
+  // pthreadpool flags for the next run.
+  uint32_t run_flags() const;
+
  private:
   // This mutex is used inside get_thread_count API but it is not
   // really needed. Since data members of ThreadPool objects are not
@@ -64,11 +153,48 @@ class ThreadPool final {
   // TODO(kimishpatel)
   mutable std::mutex mutex_;
   std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool_;
+  std::vector<uint32_t> cpu_ids_;
+  ThreadPriority priority_ = ThreadPriority::Default;
+  std::atomic<WorkerWaitPolicy> wait_policy_{WorkerWaitPolicy::Spin};
 };
 
-// Return a singleton instance of ThreadPool for ATen/TH multithreading.
+// Return the ThreadPool installed on this thread by a UseThreadPoolGuard, or
+// else a singleton instance of ThreadPool for ATen/TH multithreading.
 ThreadPool* get_threadpool();
 
+/**
+ * A RAII, thread local guard that makes get_threadpool() and
+ * get_pthreadpool() return `threadpool` on this thread for the lifetime of
+ * the guard, so that two models can run on separate pools instead of
+ * sharing the singleton. XNNPACK delegates take their pool when they are
+ * initialized, so load methods that use them under the same guard as the
+ * one used to execute them.
+ */
+class UseThreadPoolGuard final {
+ public:
+  explicit UseThreadPoolGuard(ThreadPool* threadpool);
+  ~UseThreadPoolGuard();
+
+  UseThreadPoolGuard(const UseThreadPoolGuard&) = delete;
+  UseThreadPoolGuard& operator=(const UseThreadPoolGuard&) = delete;
+
+ private:
+  ThreadPool* const prev_threadpool_;
+};
+
+/**
+ * Restricts the calling thread to the logical CPUs in `cpu_ids`, or lifts
+ * the restriction when it is empty. Returns false if the affinity could not
+ * be set, including on platforms without affinity support.
+ */
+bool set_current_thread_affinity(const std::vector<uint32_t>& cpu_ids);
+
+/**
+ * Sets the scheduling priority of the calling thread. Returns false if it
+ * could not be set.
+ */
+bool set_current_thread_priority(ThreadPriority priority);
+
 // Exposes the underlying implementation of ThreadPool.
 // Only for use in external libraries so as to unify threading across
 // internal (i.e. ATen, etc.) and external (e.g. NNPACK, QNNPACK, XNNPACK)
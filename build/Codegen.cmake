@@ -9,8 +9,15 @@
 
 # Selective build. See codegen/tools/gen_oplist.py for how to use these
 # arguments.
+#
+# OPS_FROM_MODEL selects the ops of a serialized model (.pte), along with the
+# dtypes that the model calls them with. When DTYPE_SELECTIVE_BUILD is also
+# set, selected_op_variants.h is generated from those dtypes, see
+# gen_operators_lib().
 function(gen_selected_ops)
-  set(arg_names LIB_NAME OPS_SCHEMA_YAML ROOT_OPS INCLUDE_ALL_OPS)
+  set(arg_names LIB_NAME OPS_SCHEMA_YAML ROOT_OPS INCLUDE_ALL_OPS
+                OPS_FROM_MODEL DTYPE_SELECTIVE_BUILD
+  )
   cmake_parse_arguments(GEN "" "" "${arg_names}" ${ARGN})
 
   message(STATUS "Generating operator lib:")
@@ -18,6 +25,8 @@ function(gen_selected_ops)
   message(STATUS "  OPS_SCHEMA_YAML: ${GEN_OPS_SCHEMA_YAML}")
   message(STATUS "  ROOT_OPS: ${GEN_ROOT_OPS}")
   message(STATUS "  INCLUDE_ALL_OPS: ${GEN_INCLUDE_ALL_OPS}")
+  message(STATUS "  OPS_FROM_MODEL: ${GEN_OPS_FROM_MODEL}")
+  message(STATUS "  DTYPE_SELECTIVE_BUILD: ${GEN_DTYPE_SELECTIVE_BUILD}")
 
   set(_oplist_yaml
       ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/selected_operators.yaml
@@ -41,16 +50,38 @@ function(gen_selected_ops)
   if(GEN_INCLUDE_ALL_OPS)
     list(APPEND _gen_oplist_command --include_all_operators)
   endif()
+  set(_gen_oplist_deps ${GEN_OPS_SCHEMA_YAML} ${_codegen_tools_srcs})
+  if(GEN_OPS_FROM_MODEL)
+    list(APPEND _gen_oplist_command --model_file_path="${GEN_OPS_FROM_MODEL}")
+    list(APPEND _gen_oplist_deps ${GEN_OPS_FROM_MODEL})
+  endif()
 
   message("Command - ${_gen_oplist_command}")
   add_custom_command(
     COMMENT "Generating selected_operators.yaml for ${GEN_LIB_NAME}"
     OUTPUT ${_oplist_yaml}
     COMMAND ${_gen_oplist_command}
-    DEPENDS ${GEN_OPS_SCHEMA_YAML} ${_codegen_tools_srcs}
+    DEPENDS ${_gen_oplist_deps}
     WORKING_DIRECTORY ${EXECUTORCH_ROOT}
   )
 
+  if(GEN_DTYPE_SELECTIVE_BUILD)
+    # Generated where the portable kernels include it from, see
+    # kernels/portable/cpu/selective_build.h.
+    set(_opvariant_dir
+        ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/selected_op_variants/executorch/kernels/portable/cpu
+    )
+    file(MAKE_DIRECTORY ${_opvariant_dir})
+    add_custom_command(
+      COMMENT "Generating selected_op_variants.h for ${GEN_LIB_NAME}"
+      OUTPUT ${_opvariant_dir}/selected_op_variants.h
+      COMMAND
+        "${PYTHON_EXECUTABLE}" -m codegen.tools.gen_selected_op_variants
+        --yaml_file_path=${_oplist_yaml} --output_dir=${_opvariant_dir}
+      DEPENDS ${_oplist_yaml} ${_codegen_tools_srcs}
+      WORKING_DIRECTORY ${EXECUTORCH_ROOT}
+    )
+  endif()
 endfunction()
 
 # Codegen for registering kernels. Kernels are defined in functions_yaml and
@@ -159,14 +190,20 @@ function(gen_custom_ops_aot_lib)
 endfunction()
 
 # Generate a runtime lib for registering operators in Executorch
+#
+# With DTYPE_SELECTIVE_BUILD, which needs gen_selected_ops() to have been called
+# with DTYPE_SELECTIVE_BUILD too, the portable kernels are compiled into the
+# lib with only the dtypes that were selected for each op, instead of linking
+# portable_kernels. Pass the other kernel libs as KERNEL_LIBS.
 function(gen_operators_lib)
-  set(multi_arg_names LIB_NAME KERNEL_LIBS DEPS)
+  set(multi_arg_names LIB_NAME KERNEL_LIBS DEPS DTYPE_SELECTIVE_BUILD)
   cmake_parse_arguments(GEN "" "" "${multi_arg_names}" ${ARGN})
 
   message(STATUS "Generating operator lib:")
   message(STATUS "  LIB_NAME: ${GEN_LIB_NAME}")
   message(STATUS "  KERNEL_LIBS: ${GEN_KERNEL_LIBS}")
   message(STATUS "  DEPS: ${GEN_DEPS}")
+  message(STATUS "  DTYPE_SELECTIVE_BUILD: ${GEN_DTYPE_SELECTIVE_BUILD}")
 
   set(_out_dir ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME})
 
@@ -181,6 +218,35 @@ function(gen_operators_lib)
     target_link_libraries(${GEN_LIB_NAME} PUBLIC ${GEN_KERNEL_LIBS})
   endif()
 
+  if(GEN_DTYPE_SELECTIVE_BUILD)
+    set(_opvariant_dir ${_out_dir}/selected_op_variants)
+    file(GLOB_RECURSE _portable_kernels__srcs
+         "${EXECUTORCH_ROOT}/kernels/portable/cpu/*.cpp"
+    )
+    list(FILTER _portable_kernels__srcs EXCLUDE REGEX "test/*.cpp")
+    list(FILTER _portable_kernels__srcs EXCLUDE REGEX "codegen")
+    add_library(${GEN_LIB_NAME}_portable_kernels ${_portable_kernels__srcs})
+    target_sources(
+      ${GEN_LIB_NAME}_portable_kernels
+      PRIVATE
+        ${_opvariant_dir}/executorch/kernels/portable/cpu/selected_op_variants.h
+    )
+    # Must come before the source tree so that the generated header is found.
+    target_include_directories(
+      ${GEN_LIB_NAME}_portable_kernels BEFORE PRIVATE ${_opvariant_dir}
+    )
+    target_compile_definitions(
+      ${GEN_LIB_NAME}_portable_kernels PRIVATE EXECUTORCH_SELECTIVE_BUILD_DTYPE
+    )
+    target_compile_options(
+      ${GEN_LIB_NAME}_portable_kernels PUBLIC -Wno-deprecated-declarations
+    )
+    target_link_libraries(${GEN_LIB_NAME}_portable_kernels PRIVATE ${GEN_DEPS})
+    target_link_libraries(
+      ${GEN_LIB_NAME} PUBLIC ${GEN_LIB_NAME}_portable_kernels
+    )
+  endif()
+
   target_link_options_shared_lib(${GEN_LIB_NAME})
   set(_generated_headers ${_out_dir}/Functions.h ${_out_dir}/NativeFunctions.h)
   set_target_properties(
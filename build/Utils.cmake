@@ -46,10 +46,16 @@ function(executorch_print_configuration_summary)
   message(STATUS "  EXECUTORCH_BUILD_ARM_BAREMETAL         : "
                  "${EXECUTORCH_BUILD_ARM_BAREMETAL}"
   )
+  message(STATUS "  EXECUTORCH_BUILD_BENCHMARK_RUNNER      : "
+                 "${EXECUTORCH_BUILD_BENCHMARK_RUNNER}"
+  )
   message(
     STATUS
       "  EXECUTORCH_BUILD_COREML                : ${EXECUTORCH_BUILD_COREML}"
   )
+  message(STATUS "  EXECUTORCH_BUILD_KERNELS_BENCHMARK     : "
+                 "${EXECUTORCH_BUILD_KERNELS_BENCHMARK}"
+  )
   message(STATUS "  EXECUTORCH_BUILD_KERNELS_CUSTOM        : "
                  "${EXECUTORCH_BUILD_KERNELS_CUSTOM}"
   )
@@ -36,6 +36,8 @@ endif()
 
 set(lib_list
     etdump
+    etdump_chrome_trace
+    memory_timeline
     bundled_program
     extension_data_loader
     ${FLATCCRT_LIB}
@@ -59,8 +59,10 @@ NSErrorDomain const LLaMARunnerErrorDomain = @"LLaMARunnerErrorDomain";
     withTokenCallback:(nullable void (^)(NSString*))callback
                 error:(NSError**)error {
   const auto status = _runner->generate(
-      prompt.UTF8String, seq_len, [callback](const std::string& token) {
-        callback(@(token.c_str()));
+      prompt.UTF8String, seq_len, [callback](std::string_view token) {
+        callback([[NSString alloc] initWithBytes:token.data()
+                                          length:token.size()
+                                        encoding:NSUTF8StringEncoding]);
       });
   if (status != Error::Ok) {
     if (error) {
@@ -30,12 +30,19 @@ using util::FileDataLoader;
 
 static constexpr size_t kMethodAllocatorPoolSize = 4 * 1024U * 1024U; // 4MB
 
+// Returns a planned buffer to the Neuron buffer allocator.
+struct NeuronBufferDeleter {
+  void operator()(uint8_t* buffer) const {
+    GET_NEURON_ALLOCATOR.RemoveBuffer(buffer);
+  }
+};
+
 // ExecuTorch model instance
 // The member ordering affects the order of destruction.
 struct ModelInstance {
   std::unique_ptr<Program> program;
 
-  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers;
+  std::vector<std::unique_ptr<uint8_t[], NeuronBufferDeleter>> planned_buffers;
   std::vector<Span<uint8_t>> planned_spans;
 
   std::vector<uint8_t> method_allocator_pool;
@@ -537,7 +544,13 @@ void* ModelChunk::CreateModelInstance(const std::string& modelPath) {
     size_t buffer_size =
         static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
     ET_LOG(Debug, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
-    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    // Back the planned memory with AHardwareBuffer so that the Neuron delegate
+    // binds the tensors placed in it by memory handle instead of copying.
+    auto* buffer =
+        static_cast<uint8_t*>(GET_NEURON_ALLOCATOR.Allocate(buffer_size));
+    ET_CHECK_MSG(
+        buffer != nullptr, "Could not allocate planned buffer %zu.", id);
+    planned_buffers.emplace_back(buffer);
     planned_spans.push_back({planned_buffers.back().get(), buffer_size});
   }
   modelInstance->planned_memory = std::make_unique<HierarchicalAllocator>(
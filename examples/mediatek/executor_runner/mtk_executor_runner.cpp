@@ -33,6 +33,8 @@
 #include <executorch/runtime/platform/log.h>
 #include <executorch/runtime/platform/runtime.h>
 
+#include "NeuronBufferAllocator.h"
+
 static uint8_t method_allocator_pool[4 * 1024U * 1024U]; // 4 MB
 
 DEFINE_string(
@@ -44,6 +46,13 @@ DEFINE_int32(iteration, 1, "Iterations of inference.");
 using namespace torch::executor;
 using torch::executor::util::FileDataLoader;
 
+// Returns a planned buffer to the Neuron buffer allocator.
+struct NeuronBufferDeleter {
+  void operator()(uint8_t* buffer) const {
+    GET_NEURON_ALLOCATOR.RemoveBuffer(buffer);
+  }
+};
+
 int main(int argc, char** argv) {
   runtime_init();
 
@@ -123,7 +132,12 @@ int main(int argc, char** argv) {
   // mobile environments will only have a single buffer. Some embedded
   // environments may have more than one for, e.g., slow/large DRAM and
   // fast/small SRAM, or for memory associated with particular cores.
-  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers; // Owns the memory
+  //
+  // The buffers are allocated from the Neuron buffer allocator, so they are
+  // backed by AHardwareBuffer and the Neuron delegate binds the inputs and
+  // outputs placed in them by memory handle instead of copying them.
+  std::vector<std::unique_ptr<uint8_t[], NeuronBufferDeleter>>
+      planned_buffers; // Owns the memory
   std::vector<Span<uint8_t>> planned_spans; // Passed to the allocator
   size_t num_memory_planned_buffers = method_meta->num_memory_planned_buffers();
   for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
@@ -131,7 +145,11 @@ int main(int argc, char** argv) {
     size_t buffer_size =
         static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
     ET_LOG(Info, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
-    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    auto* buffer =
+        static_cast<uint8_t*>(GET_NEURON_ALLOCATOR.Allocate(buffer_size));
+    ET_CHECK_MSG(
+        buffer != nullptr, "Could not allocate planned buffer %zu.", id);
+    planned_buffers.emplace_back(buffer);
     planned_spans.push_back({planned_buffers.back().get(), buffer_size});
   }
   HierarchicalAllocator planned_memory(
@@ -14,6 +14,7 @@ import json
 import logging
 import shlex
 from enum import Enum
+from functools import partial
 from json import JSONDecodeError
 from pathlib import Path
 from typing import Optional, Union
@@ -49,12 +50,22 @@ from .source_transformation.quantize import (
     get_quant_embedding_transform,
     get_quant_weight_transform,
 )
-from .source_transformation.rope import materialze_broadcast_of_rope_freq_cis
+from .source_transformation.linear_quantized import (
+    replace_linear_with_quantized_custom_op,
+)
+from .source_transformation.moe import replace_moe_with_custom_op
+from .source_transformation.rms_norm import replace_rms_norm_with_custom_op
+from .source_transformation.rope import (
+    materialze_broadcast_of_rope_freq_cis,
+    replace_rope_with_custom_op,
+)
 from .source_transformation.sdpa import (
     replace_causal_mask,
     replace_kv_cache_with_simple_kv_cache,
     replace_sdpa_with_custom_op,
     replace_sdpa_with_flex_sdpa,
+    replace_sdpa_with_quantized_kv_cache_custom_op,
+    replace_sdpa_with_sink_kv_cache_custom_op,
     replace_sdpa_with_simple_sdpa,
 )
 
@@ -199,6 +210,42 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_true",
         help="Whether to use sdpa_with_kv_cache update op when using kv cache",
     )
+    parser.add_argument(
+        "--quantize_kv_cache",
+        default=False,
+        action="store_true",
+        help="Store the kv cache as int8 with a scale per head of each token. Requires --use_sdpa_with_kv_cache.",
+    )
+    parser.add_argument(
+        "--num_sink_tokens",
+        type=int,
+        default=0,
+        help="Generate past max_seq_length by evicting the oldest tokens from a full kv cache, but the first num_sink_tokens. Requires --use_sdpa_with_kv_cache and dynamic shape.",
+    )
+    parser.add_argument(
+        "--use_rms_norm_custom_op",
+        default=False,
+        action="store_true",
+        help="Whether to use the fused rms_norm custom op for RMSNorm. Requires a float32 model.",
+    )
+    parser.add_argument(
+        "--use_rope_custom_op",
+        default=False,
+        action="store_true",
+        help="Whether to apply RoPE with the fused apply_rotary_emb custom op. Requires a float32 model.",
+    )
+    parser.add_argument(
+        "--use_moe_custom_op",
+        default=False,
+        action="store_true",
+        help="Whether to run the experts of MoE layers with the llama::moe_ffn custom op, which only computes the experts each token is routed to. Requires a float32 model.",
+    )
+    parser.add_argument(
+        "--quantized_linear_custom_op",
+        type=str,
+        default=None,
+        help="Quantize the weights of bias-free linear layers and run them with the prepacked llama::linear_int4/linear_int8 custom ops, e.g. '4,128' for 4 bits in groups of 128, or '8,0' for 8 bits per channel. Requires a float32 model.",
+    )
     parser.add_argument(
         "--disable_dynamic_shape",
         dest="enable_dynamic_shape",
@@ -268,6 +315,12 @@ def build_args_parser() -> argparse.ArgumentParser:
         default=128,
         help="maximum length sequence to evaluate",
     )
+    parser.add_argument(
+        "--max_batch_size",
+        type=int,
+        default=1,
+        help="number of sequences the kv cache holds, for batched generation with the runner's generate_batch",
+    )
 
     parser.add_argument("-2", "--fairseq2", action="store_true")
     parser.add_argument("-v", "--verbose", action="store_true")
@@ -380,11 +433,48 @@ def _prepare_for_llama_export(modelname: str, args) -> LLMEdgeManager:
         modelname = f"{modelname}_e"
         transforms.append(get_quant_embedding_transform(args))
 
+    if args.use_rope_custom_op:
+        if args.expand_rope_table:
+            raise ValueError(
+                "--use_rope_custom_op does not support --expand_rope_table"
+            )
+        transforms.append(replace_rope_with_custom_op)
+
     if args.expand_rope_table:
         transforms.append(materialze_broadcast_of_rope_freq_cis)
 
+    if args.num_sink_tokens > 0 and (
+        args.quantize_kv_cache or args.expand_rope_table
+    ):
+        raise ValueError(
+            "--num_sink_tokens supports neither --quantize_kv_cache nor --expand_rope_table"
+        )
+
     if args.use_sdpa_with_kv_cache:
-        transforms.append(replace_sdpa_with_custom_op)
+        if args.quantize_kv_cache:
+            transforms.append(replace_sdpa_with_quantized_kv_cache_custom_op)
+        elif args.num_sink_tokens > 0:
+            transforms.append(replace_sdpa_with_sink_kv_cache_custom_op)
+        else:
+            transforms.append(replace_sdpa_with_custom_op)
+    elif args.quantize_kv_cache:
+        raise ValueError("--quantize_kv_cache requires --use_sdpa_with_kv_cache")
+
+    if args.use_rms_norm_custom_op:
+        transforms.append(replace_rms_norm_with_custom_op)
+
+    if args.use_moe_custom_op:
+        transforms.append(replace_moe_with_custom_op)
+
+    if args.quantized_linear_custom_op:
+        bitwidth, group_size = args.quantized_linear_custom_op.split(",")
+        transforms.append(
+            partial(
+                replace_linear_with_quantized_custom_op,
+                bitwidth=int(bitwidth),
+                group_size=int(group_size),
+            )
+        )
 
     if args.use_kv_cache:
         if args.qnn:
@@ -407,8 +497,10 @@ def _prepare_for_llama_export(modelname: str, args) -> LLMEdgeManager:
             use_sdpa_with_kv_cache=args.use_sdpa_with_kv_cache,
             weight_type=weight_type,
             enable_dynamic_shape=args.enable_dynamic_shape,
+            num_sink_tokens=args.num_sink_tokens,
             verbose=args.verbose,
             max_seq_len=args.max_seq_length,
+            max_batch_size=args.max_batch_size,
             metadata_str=args.metadata,
         )
         .set_output_dir(output_dir_path)
@@ -571,6 +663,7 @@ def _load_llama_model_metadata(
         "use_kv_cache": use_kv_cache,
         "use_sdpa_with_kv_cache": use_sdpa_with_kv_cache,
         "enable_dynamic_shape": enable_dynamic_shape,
+        "get_num_sink_tokens": model_args.num_sink_tokens,
     }
     if metadata_str:
         try:
@@ -592,8 +685,10 @@ def _load_llama_model(
     use_sdpa_with_kv_cache: bool = False,
     weight_type: WeightType = WeightType.LLAMA,
     enable_dynamic_shape: bool = False,
+    num_sink_tokens: int = 0,
     verbose: bool = False,
     max_seq_len: int = 128,
+    max_batch_size: int = 1,
     metadata_str: Optional[str] = None,
 ) -> "LLMEdgeManager":
     """
@@ -618,7 +713,9 @@ def _load_llama_model(
         use_sdpa_with_kv_cache=use_sdpa_with_kv_cache,
         fairseq2=weight_type == WeightType.FAIRSEQ2,
         max_seq_len=max_seq_len,
+        max_batch_size=max_batch_size,
         enable_dynamic_shape=enable_dynamic_shape,
+        num_sink_tokens=num_sink_tokens,
     )
     state_dict = model.state_dict()
     dtype = state_dict[next(iter(state_dict))].dtype
@@ -103,6 +103,10 @@ class ModelArgs:
     )
     rope_freq_base: float = 10000.0  # The base frequency for RoPE. Keep it for BC.
     use_scaled_rope: bool = False  # Use scaled RoPE, introduced in llama3.1.
+    # Generate past max_seq_len by evicting old tokens from the kv cache, but
+    # the first num_sink_tokens, see SDPACustomSinkKVCache. RoPE then applies
+    # at the position of the tokens in the cache rather than input_pos.
+    num_sink_tokens: int = 0
     # Additional Model Metadata needed at runtime
     bos_idx: int = 1
     eos_idx: int = 3
@@ -120,6 +124,14 @@ class ModelArgs:
         if self.use_sdpa_with_kv_cache_op:
             assert self.use_kv_cache, "use_sdpa_with_kv_cache_op requires use_kv_cache"
 
+        if self.num_sink_tokens > 0:
+            assert (
+                self.use_sdpa_with_kv_cache_op and self.enable_dynamic_shape
+            ), "num_sink_tokens requires use_sdpa_with_kv_cache_op and enable_dynamic_shape"
+            assert (
+                self.num_sink_tokens < self.max_seq_len
+            ), f"num_sink_tokens must be less than max_seq_len {self.max_seq_len}"
+
         if self.hidden_dim is None:
             # If hidden_dim is not explicitly set in the ModelArgs,
             # then calculate implicitly based on dim and also multiple of `args.multiple_of`
@@ -486,7 +498,14 @@ class Transformer(nn.Module):
                 # when KV cache is used, seqlen is most likely 1. We want to slice from the start_pos.
                 input_pos_item = input_pos[-1].item()
                 torch._check_is_size(input_pos_item)
-                torch._check(input_pos_item < self.params.max_seq_len)
+                if self.params.num_sink_tokens > 0:
+                    # input_pos grows without bound, and the sink kv cache
+                    # holds the last tokens at its end once it is full.
+                    input_pos_item = torch.sym_min(
+                        input_pos_item, self.params.max_seq_len - seqlen
+                    )
+                else:
+                    torch._check(input_pos_item < self.params.max_seq_len)
                 # pyre-ignore: Incompatible parameter type [6]: torch.narrow does expect int or Tensor
                 freqs_cos = self.freqs_cos.narrow(0, input_pos_item, seqlen)
                 # pyre-ignore: Incompatible parameter type [6]
@@ -6,9 +6,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <gflags/gflags.h>
 
 #include <executorch/examples/models/llama2/runner/runner.h>
+#include <executorch/extension/llm/runner/benchmark.h>
 
 #if defined(ET_USE_THREADPOOL)
 #include <executorch/backends/xnnpack/threadpool/cpuinfo_utils.h>
@@ -32,13 +39,132 @@ DEFINE_double(
 DEFINE_int32(
     seq_len,
     128,
-    "Total number of tokens to generate (prompt + output). Defaults to max_seq_len. If the number of input tokens + seq_len > max_seq_len, the output will be truncated to max_seq_len tokens.");
+    "Total number of tokens to generate (prompt + output). Defaults to max_seq_len. If the number of input tokens + seq_len > max_seq_len, the output will be truncated to max_seq_len tokens, unless the model was exported with --num_sink_tokens.");
 
 DEFINE_int32(
     cpu_threads,
     -1,
     "Number of CPU threads for inference. Defaults to -1, which implies we'll use a heuristic to derive the # of performant cores for a specific device.");
 
+DEFINE_int32(
+    prefill_chunk_size,
+    0,
+    "Maximum number of prompt tokens to prefill per forward call, which bounds the activation memory of long prompts. Only used by models exported with dynamic shapes. Defaults to 0, which prefills the whole prompt at once.");
+
+DEFINE_string(
+    draft_model_path,
+    "",
+    "Optional smaller model with the same tokenizer. When set, tokens are generated with speculative decoding, with model_path verifying the tokens proposed by the draft model.");
+
+DEFINE_int32(
+    num_draft_tokens,
+    4,
+    "Number of tokens the draft model proposes per verification step when draft_model_path is set.");
+
+DEFINE_bool(
+    benchmark,
+    false,
+    "Instead of generating from prompt, benchmark every combination of benchmark_prompt_lengths and benchmark_generation_lengths and write one JSON object per combination to benchmark_output.");
+
+DEFINE_string(
+    benchmark_prompt_lengths,
+    "32,128,512",
+    "Comma separated prompt lengths in tokens for benchmark. The prompts are a repeated word, so the actual token count may differ slightly and is reported as prompt_tokens. Prompt length + generation length must not exceed the max_seq_len of the model.");
+
+DEFINE_string(
+    benchmark_generation_lengths,
+    "32,128",
+    "Comma separated numbers of tokens to generate for benchmark. Fewer tokens are generated if the model emits EOS first, see generated_tokens.");
+
+DEFINE_int32(
+    benchmark_warmup_runs,
+    1,
+    "Untimed runs of each combination before the timed ones.");
+
+DEFINE_int32(
+    benchmark_runs,
+    3,
+    "Timed runs of each combination, summarized as min/mean/max.");
+
+DEFINE_string(
+    benchmark_output,
+    "",
+    "File the JSON results of benchmark are appended to, one line per combination. Defaults to stdout.");
+
+namespace {
+
+std::vector<int32_t> parse_lengths(const std::string& list) {
+  std::vector<int32_t> lengths;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    const int32_t length = std::atoi(item.c_str());
+    ET_CHECK_MSG(
+        length > 0, "Invalid length '%s' in %s", item.c_str(), list.c_str());
+    lengths.push_back(length);
+  }
+  return lengths;
+}
+
+// A prompt of about num_tokens tokens for both the sentencepiece and the
+// tiktoken tokenizers.
+std::string make_prompt(int32_t num_tokens) {
+  std::string prompt = "the";
+  for (int32_t i = 1; i < num_tokens; ++i) {
+    prompt += " the";
+  }
+  return prompt;
+}
+
+int32_t run_benchmark(::torch::executor::Runner& runner) {
+  FILE* output = stdout;
+  if (!FLAGS_benchmark_output.empty()) {
+    output = fopen(FLAGS_benchmark_output.c_str(), "a");
+    ET_CHECK_MSG(
+        output != nullptr, "Failed to open %s", FLAGS_benchmark_output.c_str());
+  }
+  runner.set_echo(false);
+  for (int32_t prompt_length : parse_lengths(FLAGS_benchmark_prompt_lengths)) {
+    const std::string prompt = make_prompt(prompt_length);
+    for (int32_t generation_length :
+         parse_lengths(FLAGS_benchmark_generation_lengths)) {
+      ::executorch::llm::BenchmarkResult result(
+          prompt_length, generation_length);
+      // One more token for the BOS the runner prepends.
+      const int32_t seq_len = prompt_length + generation_length + 1;
+      const int32_t num_runs =
+          FLAGS_benchmark_warmup_runs + FLAGS_benchmark_runs;
+      for (int32_t i = 0; i < num_runs; ++i) {
+        // Every run prefills the whole prompt.
+        runner.reset_prefix_cache();
+        const bool timed = i >= FLAGS_benchmark_warmup_runs;
+        const auto error = runner.generate(
+            prompt,
+            seq_len,
+            {},
+            [&result, timed](const ::torch::executor::Stats& stats) {
+              if (timed) {
+                result.add(stats);
+              }
+            });
+        ET_CHECK_MSG(
+            error == ::torch::executor::Error::Ok,
+            "Generation failed for prompt length %d",
+            prompt_length);
+      }
+      result.set_peak_rss_bytes(::executorch::llm::peak_rss_bytes());
+      fprintf(output, "%s\n", result.to_json_string().c_str());
+      fflush(output);
+    }
+  }
+  if (output != stdout) {
+    fclose(output);
+  }
+  return 0;
+}
+
+} // namespace
+
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -57,6 +183,12 @@ int32_t main(int32_t argc, char** argv) {
 
   int32_t cpu_threads = FLAGS_cpu_threads;
 
+  int32_t prefill_chunk_size = FLAGS_prefill_chunk_size;
+
+  const char* draft_model_path = FLAGS_draft_model_path.c_str();
+
+  int32_t num_draft_tokens = FLAGS_num_draft_tokens;
+
 #if defined(ET_USE_THREADPOOL)
   uint32_t num_performant_cores = cpu_threads == -1
       ? torch::executorch::cpuinfo::get_num_performant_cores()
@@ -69,7 +201,17 @@ int32_t main(int32_t argc, char** argv) {
   }
 #endif
   // create llama runner
-  ::torch::executor::Runner runner(model_path, tokenizer_path, temperature);
+  ::torch::executor::Runner runner(
+      model_path,
+      tokenizer_path,
+      temperature,
+      prefill_chunk_size,
+      draft_model_path,
+      num_draft_tokens);
+
+  if (FLAGS_benchmark) {
+    return run_benchmark(runner);
+  }
 
   // generate
   runner.generate(prompt, seq_len);
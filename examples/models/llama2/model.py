@@ -62,8 +62,10 @@ class Llama2Model(EagerModelBase):
         self.use_kv_cache = kwargs.get("use_kv_cache", False)
         self.use_sdpa_with_kv_cache_op = kwargs.get("use_sdpa_with_kv_cache", False)
         self.enable_dynamic_shape = kwargs.get("enable_dynamic_shape", False)
+        self.num_sink_tokens = kwargs.get("num_sink_tokens", 0)
 
         self.max_seq_len = kwargs.get("max_seq_len", 128)
+        self.max_batch_size = kwargs.get("max_batch_size", 1)
         # The example is using a dummy small model with random weights for demo purpose only.
         # Follow the instruction in https://github.com/facebookresearch/llama to download the model
         device = "cpu"
@@ -139,13 +141,14 @@ the checkpoint format to avoid generating faulty models.
         with open(params_path, "r") as f:
             params = json.loads(f.read())
         max_seq_len = self.max_seq_len
-        max_batch_size = 1
+        max_batch_size = self.max_batch_size
         model_args: ModelArgs = ModelArgs(
             max_seq_len=max_seq_len,
             max_batch_size=max_batch_size,
             use_kv_cache=self.use_kv_cache,
             use_sdpa_with_kv_cache_op=self.use_sdpa_with_kv_cache_op,
             enable_dynamic_shape=self.enable_dynamic_shape,
+            num_sink_tokens=self.num_sink_tokens,
             **params,
         )
         if kwargs.get("fairseq2", False):
@@ -211,13 +214,13 @@ the checkpoint format to avoid generating faulty models.
     def get_example_inputs_kvcache_sdpa(self):
         if self.enable_dynamic_shape:
             return (
-                torch.tensor([[2, 3, 4]], dtype=torch.long),
+                torch.tensor([[2, 3, 4]] * self.max_batch_size, dtype=torch.long),
                 torch.tensor([0], dtype=torch.long),
             )
         else:
             return (
                 torch.tensor(
-                    [[1]], dtype=torch.long
+                    [[1]] * self.max_batch_size, dtype=torch.long
                 ),  # tokens, with kv cache our input token length is always just 1 token.
                 torch.tensor(
                     [0], dtype=torch.long
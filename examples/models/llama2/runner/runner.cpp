@@ -13,7 +13,9 @@
 
 #include <ctime>
 
+#include <executorch/extension/llm/runner/metadata_util.h>
 #include <executorch/extension/llm/runner/util.h>
+#include <executorch/extension/llm/tokenizer/incremental_detokenizer.h>
 #include <executorch/extension/runner_util/managed_tensor.h>
 
 #if ET_USE_TIKTOKEN
@@ -31,6 +33,7 @@ static constexpr auto kEosIds = "get_eos_ids";
 static constexpr auto kMaxSeqLen = "get_max_seq_len";
 static constexpr auto kNBos = "get_n_bos";
 static constexpr auto kNEos = "get_n_eos";
+static constexpr auto kNumSinkTokens = "get_num_sink_tokens";
 static constexpr auto kVocabSize = "get_vocab_size";
 static constexpr auto kUseKVCache = "use_kv_cache";
 static constexpr auto kUseSDPAWithKVCache = "use_sdpa_with_kv_cache";
@@ -39,11 +42,16 @@ static constexpr auto kUseSDPAWithKVCache = "use_sdpa_with_kv_cache";
 Runner::Runner(
     const std::string& model_path,
     const std::string& tokenizer_path,
-    const float temperature)
+    const float temperature,
+    const int32_t prefill_chunk_size,
+    const std::string& draft_model_path,
+    const int32_t num_draft_tokens)
     // NOTE: we observed ~2x loading performance increase on iPhone 15
     // and a ~5% improvement on Galaxy S22 by switching to
     // FileDataLoader instead of MmapDataLoader + UseMlockIgnoreErrors.
     : temperature_(temperature),
+      prefill_chunk_size_(prefill_chunk_size),
+      num_draft_tokens_(num_draft_tokens),
       module_(std::make_unique<Module>(model_path, Module::LoadMode::File)),
       tokenizer_path_(tokenizer_path),
       tokenizer_(
@@ -59,9 +67,11 @@ Runner::Runner(
           {kMaxSeqLen, 128},
           {kNBos, 1},
           {kNEos, 1},
+          {kNumSinkTokens, 0},
           {kUseKVCache, true},
           {kUseSDPAWithKVCache, false},
-      }) {
+      }),
+      draft_model_path_(draft_model_path) {
   ET_LOG(
       Info,
       "Creating LLaMa runner: model_path=%s, tokenizer_path=%s",
@@ -71,7 +81,8 @@ Runner::Runner(
 
 bool Runner::is_loaded() const {
   return module_->is_loaded() && tokenizer_ && text_decoder_runner_ &&
-      text_prefiller_ && text_token_generator_;
+      text_prefiller_ && text_token_generator_ &&
+      (draft_model_path_.empty() || speculative_token_generator_);
 }
 
 Error Runner::load() {
@@ -126,7 +137,27 @@ Error Runner::load() {
       tokenizer_.get(),
       text_decoder_runner_.get(),
       metadata_.at(kUseKVCache),
-      enable_parallel_prefill_);
+      metadata_.at(kEnableDynamicShape),
+      prefill_chunk_size_);
+
+  if (!draft_model_path_.empty()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(load_draft_model(*eos_ids));
+  }
+
+  if (metadata_.at(kUseKVCache)) {
+    // The batch size is the first dim of the tokens input.
+    const auto method_meta = ET_UNWRAP(module_->method_meta("forward"));
+    const auto tokens_meta = ET_UNWRAP(method_meta.input_tensor_meta(0));
+    batched_text_generator_ = std::make_unique<BatchedTextGenerator>(
+        tokenizer_.get(),
+        text_decoder_runner_.get(),
+        tokens_meta.sizes()[0],
+        metadata_.at(kVocabSize),
+        temperature_,
+        metadata_.at(kEnableDynamicShape),
+        std::make_unique<std::unordered_set<uint64_t>>(*eos_ids),
+        &stats_);
+  }
 
   text_token_generator_ = std::make_unique<TextTokenGenerator>(
       tokenizer_.get(),
@@ -138,10 +169,49 @@ Error Runner::load() {
   return Error::Ok;
 }
 
+Error Runner::load_draft_model(const std::unordered_set<uint64_t>& eos_ids) {
+  ET_LOG(Info, "Loading draft model: %s", draft_model_path_.c_str());
+  // The verification step feeds several tokens to the model at once.
+  ET_CHECK_OR_RETURN_ERROR(
+      metadata_.at(kUseKVCache) && metadata_.at(kEnableDynamicShape),
+      InvalidArgument,
+      "Speculative decoding needs a model with kv cache and dynamic shapes");
+  draft_module_ =
+      std::make_unique<Module>(draft_model_path_, Module::LoadMode::File);
+  ET_CHECK_OK_OR_RETURN_ERROR(draft_module_->load_method("forward"));
+  ET_CHECK_OR_RETURN_ERROR(
+      get_module_metadata<int64_t>(draft_module_.get(), kUseKVCache, true),
+      InvalidArgument,
+      "Speculative decoding needs a draft model with kv cache");
+  const bool draft_enable_dynamic_shape = get_module_metadata<int64_t>(
+      draft_module_.get(), kEnableDynamicShape, false);
+
+  draft_text_decoder_runner_ = std::make_unique<TextDecoderRunner>(
+      draft_module_.get(),
+      /*use_kv_cache=*/true,
+      metadata_.at(kVocabSize),
+      temperature_);
+  draft_text_prefiller_ = std::make_unique<TextPrefiller>(
+      tokenizer_.get(),
+      draft_text_decoder_runner_.get(),
+      /*use_kv_cache=*/true,
+      draft_enable_dynamic_shape,
+      prefill_chunk_size_);
+  speculative_token_generator_ = std::make_unique<SpeculativeTokenGenerator>(
+      tokenizer_.get(),
+      draft_text_decoder_runner_.get(),
+      text_decoder_runner_.get(),
+      num_draft_tokens_,
+      std::make_unique<std::unordered_set<uint64_t>>(eos_ids),
+      &stats_);
+
+  return Error::Ok;
+}
+
 Error Runner::generate(
     const std::string& prompt,
     int32_t seq_len,
-    std::function<void(const std::string&)> token_callback,
+    std::function<void(std::string_view)> token_callback,
     std::function<void(const Stats&)> stats_callback) {
   // Prepare the inputs.
   // Use ones-initialized inputs.
@@ -153,10 +223,12 @@ Error Runner::generate(
   }
 
   // Wrap the token_callback with print function
-  std::function<void(const std::string&)> wrapped_callback =
-      [token_callback](const std::string& piece) {
-        util::safe_printf(piece.c_str());
-        fflush(stdout);
+  std::function<void(std::string_view)> wrapped_callback =
+      [this, token_callback](std::string_view piece) {
+        if (echo_) {
+          util::safe_printf(piece);
+          fflush(stdout);
+        }
         if (token_callback) {
           token_callback(piece);
         }
@@ -167,8 +239,13 @@ Error Runner::generate(
   stats_.inference_start_ms = util::time_in_ms();
   shouldStop_ = false;
 
-  // Set the sequence length to the max seq length if not provided
-  seq_len = (seq_len > 0 && seq_len <= metadata_.at(kMaxSeqLen))
+  // Set the sequence length to the max seq length if not provided. A model
+  // with sink tokens evicts old tokens from its kv cache to generate past it,
+  // but the draft model of speculative decoding does not.
+  const bool evicts_kv_cache =
+      metadata_.at(kNumSinkTokens) > 0 && !speculative_token_generator_;
+  seq_len = (seq_len > 0 &&
+             (evicts_kv_cache || seq_len <= metadata_.at(kMaxSeqLen)))
       ? seq_len
       : metadata_.at(kMaxSeqLen);
 
@@ -197,26 +274,75 @@ Error Runner::generate(
       num_prompt_tokens,
       seq_len);
 
+  // Skip the tokens the KV cache already holds from the previous prompt, e.g.
+  // a system prompt shared by every turn of a chat.
+  int64_t num_cached_tokens =
+      metadata_.at(kUseKVCache) ? prefix_cache_.match(prompt_tokens) : 0;
+  if (num_cached_tokens > 0) {
+    ET_LOG(
+        Info,
+        "Reusing %" PRId64 " of %d prompt tokens from the KV cache",
+        num_cached_tokens,
+        num_prompt_tokens);
+    // Echo the reused tokens, which prefill would otherwise have printed.
+    IncrementalDetokenizer detokenizer(tokenizer_.get());
+    uint64_t prev = prompt_tokens[0];
+    for (int64_t i = 0; i < num_cached_tokens; ++i) {
+      uint64_t cur = prompt_tokens[i];
+      if (cur != tokenizer_->bos_tok()) {
+        std::string_view text = ET_UNWRAP(detokenizer.next(prev, cur));
+        if (!text.empty()) {
+          wrapped_callback(text);
+        }
+      }
+      prev = cur;
+    }
+  }
+  std::vector<uint64_t> prefill_tokens(
+      prompt_tokens.begin() + num_cached_tokens, prompt_tokens.end());
+
   // Prefill first
   // Here feed all tokens to the model and get the next predicted token
   // after the prompt. After that we will enter generate loop.
-  auto prefill_res =
-      text_prefiller_->prefill(prompt_tokens, 0, wrapped_callback);
+  auto prefill_res = text_prefiller_->prefill(
+      prefill_tokens, num_cached_tokens, wrapped_callback);
   stats_.first_token_ms = util::time_in_ms();
   stats_.prompt_eval_end_ms = util::time_in_ms();
+  if (prefill_res.error() != Error::Ok) {
+    prefix_cache_.reset();
+  }
   ET_CHECK_OK_OR_RETURN_ERROR(prefill_res.error());
   uint64_t cur_token = prefill_res.get();
+  if (speculative_token_generator_) {
+    // The draft model holds the same prompt tokens in its kv cache, so it
+    // shares the prefix cache with the verifier. The next token comes from
+    // the verifier.
+    auto draft_prefill_res =
+        draft_text_prefiller_->prefill(prefill_tokens, num_cached_tokens);
+    if (draft_prefill_res.error() != Error::Ok) {
+      prefix_cache_.reset();
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(draft_prefill_res.error());
+  }
+  prefix_cache_.update(prefill_tokens, num_cached_tokens);
 
-  // print the first token from prefill. No prev_token so use cur_token for it.
-  wrapped_callback(ET_UNWRAP(tokenizer_->decode(cur_token, cur_token)));
-
-  // start the main loop
+  // start the main loop, which first prints the token from prefill
   prompt_tokens.push_back(cur_token);
-  int64_t num_generated_tokens = ET_UNWRAP(text_token_generator_->generate(
-      prompt_tokens, num_prompt_tokens, seq_len, wrapped_callback));
+  int64_t num_generated_tokens = ET_UNWRAP(
+      speculative_token_generator_
+          ? speculative_token_generator_->generate(
+                prompt_tokens, num_prompt_tokens, seq_len, wrapped_callback)
+          : text_token_generator_->generate(
+                prompt_tokens, num_prompt_tokens, seq_len, wrapped_callback));
 
   stats_.inference_end_ms = util::time_in_ms();
-  printf("\n");
+  if (echo_) {
+    printf("\n");
+  }
+  // The prompt did not all survive in the kv cache.
+  if (num_prompt_tokens + num_generated_tokens > metadata_.at(kMaxSeqLen)) {
+    prefix_cache_.reset();
+  }
 
   if (num_prompt_tokens + num_generated_tokens == seq_len) {
     ET_LOG(Info, "Sequence length (%i tokens) reached!", seq_len);
@@ -224,7 +350,69 @@ Error Runner::generate(
 
   stats_.num_prompt_tokens = num_prompt_tokens;
   stats_.num_generated_tokens = num_generated_tokens;
-  ::executorch::llm::print_report(stats_);
+  if (echo_) {
+    ::executorch::llm::print_report(stats_);
+  }
+  if (stats_callback) {
+    stats_callback(stats_);
+  }
+
+  return Error::Ok;
+}
+
+Error Runner::generate_batch(
+    const std::vector<std::string>& prompts,
+    int32_t seq_len,
+    std::function<void(int32_t, std::string_view)> token_callback,
+    std::function<void(const Stats&)> stats_callback) {
+  ET_CHECK_OR_RETURN_ERROR(!prompts.empty(), InvalidArgument, "No prompts");
+  if (!is_loaded()) {
+    stats_.model_load_start_ms = util::time_in_ms();
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+    stats_.model_load_end_ms = util::time_in_ms();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      batched_text_generator_ != nullptr,
+      NotSupported,
+      "Batched generation needs a model with kv cache");
+
+  stats_.inference_start_ms = util::time_in_ms();
+  shouldStop_ = false;
+
+  // Set the sequence length to the max seq length if not provided
+  seq_len = (seq_len > 0 && seq_len <= metadata_.at(kMaxSeqLen))
+      ? seq_len
+      : metadata_.at(kMaxSeqLen);
+
+  std::vector<std::vector<uint64_t>> prompts_tokens;
+  prompts_tokens.reserve(prompts.size());
+  int64_t num_prompt_tokens = 0;
+  for (const auto& prompt : prompts) {
+    Result<std::vector<uint64_t>> encode_res = tokenizer_->encode(
+        prompt,
+        metadata_.at(kNBos),
+        metadata_.at(kAppendEosToPrompt) ? metadata_.at(kNEos) : 0);
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        encode_res.error(), "Failed to encode prompt %s", prompt.c_str());
+    prompts_tokens.push_back(std::move(encode_res.get()));
+    num_prompt_tokens += prompts_tokens.back().size();
+  }
+
+  // Every row of the kv cache is rewritten from position 0.
+  prefix_cache_.reset();
+  std::vector<int64_t> num_generated_tokens = ET_UNWRAP(
+      batched_text_generator_->generate(
+          prompts_tokens, seq_len, token_callback));
+  stats_.inference_end_ms = util::time_in_ms();
+
+  stats_.num_prompt_tokens = num_prompt_tokens;
+  stats_.num_generated_tokens = 0;
+  for (int64_t num_generated : num_generated_tokens) {
+    stats_.num_generated_tokens += num_generated;
+  }
+  if (echo_) {
+    ::executorch::llm::print_report(stats_);
+  }
   if (stats_callback) {
     stats_callback(stats_);
   }
@@ -232,9 +420,23 @@ Error Runner::generate(
   return Error::Ok;
 }
 
+void Runner::set_echo(bool echo) {
+  echo_ = echo;
+}
+
+void Runner::reset_prefix_cache() {
+  prefix_cache_.reset();
+}
+
 void Runner::stop() {
   if (is_loaded()) {
     text_token_generator_->stop();
+    if (batched_text_generator_) {
+      batched_text_generator_->stop();
+    }
+    if (speculative_token_generator_) {
+      speculative_token_generator_->stop();
+    }
   } else {
     ET_LOG(Error, "Token generator is not loaded, cannot stop");
   }
@@ -15,8 +15,13 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 
+#include <executorch/extension/llm/runner/batched_text_generator.h>
+#include <executorch/extension/llm/runner/prefix_cache.h>
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -29,24 +34,65 @@ using Stats = ::executorch::llm::Stats;
 
 class Runner {
  public:
+  /**
+   * @param prefill_chunk_size Maximum number of prompt tokens fed to the model
+   * per step when the model supports parallel prefill. 0 feeds the whole
+   * prompt in one step.
+   * @param draft_model_path Optional smaller model with the same tokenizer.
+   * When set, tokens are generated with speculative decoding: the draft model
+   * proposes num_draft_tokens tokens that the model at model_path verifies in
+   * one step. This needs both models to use a kv cache, and the model at
+   * model_path to be exported with dynamic shapes.
+   */
   explicit Runner(
       const std::string& model_path,
       const std::string& tokenizer_path,
-      const float temperature = 0.8f);
+      const float temperature = 0.8f,
+      const int32_t prefill_chunk_size = 0,
+      const std::string& draft_model_path = "",
+      const int32_t num_draft_tokens = 4);
 
   bool is_loaded() const;
   Error load();
   Error generate(
       const std::string& prompt,
       int32_t seq_len = 128,
-      std::function<void(const std::string&)> token_callback = {},
+      std::function<void(std::string_view)> token_callback = {},
+      std::function<void(const Stats&)> stats_callback = {});
+  /**
+   * Generate text for several prompts at once, each in its own row of the kv
+   * cache. This needs a model exported with kv cache and a batch size of at
+   * least prompts.size().
+   * @param token_callback Called with the prompt index and the text of each
+   * generated token.
+   */
+  Error generate_batch(
+      const std::vector<std::string>& prompts,
+      int32_t seq_len = 128,
+      std::function<void(int32_t, std::string_view)> token_callback = {},
       std::function<void(const Stats&)> stats_callback = {});
   void stop();
+  /**
+   * Whether generate() prints the prompt, the generated text and the stats
+   * report to stdout. On by default; benchmarks turn it off to keep their
+   * output machine readable.
+   */
+  void set_echo(bool echo);
+  /**
+   * Forget the prompt held in the KV cache, so that the next generate()
+   * prefills its whole prompt even if it shares a prefix with the previous
+   * one.
+   */
+  void reset_prefix_cache();
 
  private:
+  Error load_draft_model(const std::unordered_set<uint64_t>& eos_ids);
+
   float temperature_;
-  bool enable_parallel_prefill_;
+  int32_t prefill_chunk_size_;
+  int32_t num_draft_tokens_;
   bool shouldStop_{false};
+  bool echo_{true};
 
   // model
   std::unique_ptr<Module> module_;
@@ -56,6 +102,16 @@ class Runner {
   std::unique_ptr<TextDecoderRunner> text_decoder_runner_;
   std::unique_ptr<TextPrefiller> text_prefiller_;
   std::unique_ptr<TextTokenGenerator> text_token_generator_;
+  std::unique_ptr<BatchedTextGenerator> batched_text_generator_;
+  // tokens held in the KV cache by the previous prompt
+  PrefixCache prefix_cache_;
+
+  // speculative decoding
+  std::string draft_model_path_;
+  std::unique_ptr<Module> draft_module_;
+  std::unique_ptr<TextDecoderRunner> draft_text_decoder_runner_;
+  std::unique_ptr<TextPrefiller> draft_text_prefiller_;
+  std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator_;
 
   // stats
   Stats stats_;
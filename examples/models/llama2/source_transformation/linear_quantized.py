@@ -0,0 +1,86 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+import torch
+import torch.nn.functional as F
+
+from .quantize import dynamically_quantize_per_channel
+
+# Output features interleaved per block, see op_linear_quantized.h.
+BLOCK_SIZE = 8
+
+
+def pack_weight(weight: torch.Tensor, bitwidth: int) -> torch.Tensor:
+    """
+    Prepacks an (N, K) int8 weight, with values in range for `bitwidth`, into
+    the blocked layout read by llama::linear_int4 / llama::linear_int8.
+    """
+    n, k = weight.shape
+    weight = F.pad(weight, (0, 0, 0, -n % BLOCK_SIZE))
+    # (N / 8, K, 8): the 8 features of a block are contiguous for each k.
+    blocks = weight.view(-1, BLOCK_SIZE, k).transpose(1, 2).contiguous()
+    if bitwidth == 8:
+        return blocks.to(torch.int8)
+    assert bitwidth == 4, f"Unsupported bitwidth {bitwidth}"
+    nibbles = (blocks.to(torch.int16) + 8).to(torch.uint8)
+    return (nibbles[..., 0::2] | (nibbles[..., 1::2] << 4)).contiguous()
+
+
+class QuantizedLinearCustom(torch.nn.Module):
+    """
+    Weight-only quantized linear computed by the llama::linear_int4 or
+    llama::linear_int8 custom op. The weight is quantized symmetrically in
+    groups of `group_size` input features and prepacked at export time, so it
+    is stored in the program as a constant in the layout the kernel reads.
+    """
+
+    def __init__(self, linear: torch.nn.Linear, bitwidth: int, group_size: int):
+        super().__init__()
+        self.bitwidth = bitwidth
+        in_features = linear.in_features
+        self.group_size = group_size if group_size > 0 else in_features
+        qmax = 2 ** (bitwidth - 1) - 1
+        weight, scales, _ = dynamically_quantize_per_channel(
+            linear.weight.detach().float(),
+            -qmax - 1,
+            qmax,
+            torch.int8,
+            self.group_size,
+            scales_dtype=torch.float32,
+            enable_non_multiple_groups=False,
+        )
+        self.register_buffer("packed_weight", pack_weight(weight, bitwidth))
+        self.register_buffer(
+            "scales", scales.view(linear.out_features, -1).contiguous()
+        )
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        if self.bitwidth == 4:
+            op = torch.ops.llama.linear_int4
+        else:
+            op = torch.ops.llama.linear_int8
+        return op(x, self.packed_weight, self.scales, self.group_size)
+
+
+def _replace_linear_with_custom_op(
+    module: torch.nn.Module, bitwidth: int, group_size: int
+):
+    for name, child in module.named_children():
+        if isinstance(child, torch.nn.Linear) and child.bias is None:
+            setattr(module, name, QuantizedLinearCustom(child, bitwidth, group_size))
+        else:
+            _replace_linear_with_custom_op(child, bitwidth, group_size)
+
+
+def replace_linear_with_quantized_custom_op(
+    module: torch.nn.Module, bitwidth: int, group_size: int
+) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_linear_with_custom_op(module, bitwidth, group_size)
+    return module
@@ -0,0 +1,52 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+import torch
+
+from executorch.examples.models.llama2.llama_transformer import MOEFeedForward
+
+
+class MOEFeedForwardCustom(torch.nn.Module):
+    """
+    MOEFeedForward that runs its experts with the llama::moe_ffn custom op,
+    which only computes the experts each token is routed to, instead of the
+    index, einsum and silu ops over gathered per-token expert weights that
+    ConditionalFeedForward exports to. Routing stays in the graph.
+    """
+
+    def __init__(self, moe: MOEFeedForward):
+        super().__init__()
+        self.gate = moe.gate
+        self.w1 = moe.cond_ffn.w1
+        self.w2 = moe.cond_ffn.w2
+        self.w3 = moe.cond_ffn.w3
+        self.dim = moe.dim
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        x = x.view(-1, self.dim)
+        scores = self.gate(x)
+        expert_weights, expert_indices = torch.topk(scores, 2, dim=-1)
+        expert_weights = expert_weights.softmax(dim=-1)
+        return torch.ops.llama.moe_ffn(
+            x, expert_indices, expert_weights, self.w1, self.w2, self.w3
+        )
+
+
+def _replace_moe_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, MOEFeedForward):
+            setattr(module, name, MOEFeedForwardCustom(child))
+        else:
+            _replace_moe_with_custom_op(child)
+
+
+def replace_moe_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_moe_with_custom_op(module)
+    return module
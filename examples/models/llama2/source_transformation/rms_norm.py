@@ -0,0 +1,41 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+import torch
+
+from executorch.examples.models.llama2.llama_transformer import RMSNorm
+
+
+class RMSNormCustom(torch.nn.Module):
+    """
+    RMSNorm computed by the fused llama::rms_norm custom op, instead of the
+    mul, mean, add, rsqrt and mul ops that RMSNorm exports to.
+    """
+
+    def __init__(self, norm: RMSNorm):
+        super().__init__()
+        self.eps = norm.eps
+        self.weight = norm.weight
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        return torch.ops.llama.rms_norm(x, self.weight.type_as(x), self.eps)
+
+
+def _replace_rms_norm_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, RMSNorm):
+            setattr(module, name, RMSNormCustom(child))
+        else:
+            _replace_rms_norm_with_custom_op(child)
+
+
+def replace_rms_norm_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_rms_norm_with_custom_op(module)
+    return module
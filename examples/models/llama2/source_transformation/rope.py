@@ -6,7 +6,7 @@
 
 import torch
 
-from ..llama_transformer import Transformer
+from ..llama_transformer import Attention, Transformer
 
 
 def materialze_broadcast_of_rope_freq_cis(
@@ -33,3 +33,35 @@ def materialze_broadcast_of_rope_freq_cis(
     module.freqs_sin = module.freqs_sin.view(dim0, 1, dim1)
     module.freqs_sin = module.freqs_sin.expand(dim0, num_heads, dim1).contiguous()
     return module
+
+
+class RotaryEmbeddingCustom(torch.nn.Module):
+    """
+    Applies RoPE to q and k with the fused llama::apply_rotary_emb custom
+    op, instead of the reshape, mul, sub, add and stack ops that rope.py
+    exports to. The op reads the rope tables of both layouts, interleaved
+    pairs or HuggingFace halves, as the Transformer passes them.
+    """
+
+    def forward(
+        self,
+        q: torch.Tensor,
+        k: torch.Tensor,
+        freqs_cos: torch.Tensor,
+        freqs_sin: torch.Tensor,
+    ):
+        freqs_cos = freqs_cos.type_as(q)
+        freqs_sin = freqs_sin.type_as(q)
+        return (
+            torch.ops.llama.apply_rotary_emb(q, freqs_cos, freqs_sin),
+            torch.ops.llama.apply_rotary_emb(k, freqs_cos, freqs_sin),
+        )
+
+
+def replace_rope_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    for child in list(module.modules()):
+        if isinstance(child, Attention):
+            child.apply_rotary_emb = RotaryEmbeddingCustom()
+    return module
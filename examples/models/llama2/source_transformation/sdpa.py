@@ -70,6 +70,179 @@ def replace_sdpa_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
     return module
 
 
+class SDPACustomQuantizedKVCache(torch.nn.Module):
+    """
+    SDPACustom with an int8 kv cache. The llama::sdpa_with_quantized_kv_cache
+    op quantizes each head of the new keys and values with its own scale as
+    it writes them to the cache.
+    """
+
+    def __init__(
+        self,
+        kv_cache: KVCache,
+        dim: int,
+    ):
+        super().__init__()
+        assert (
+            not kv_cache.transpose_cache
+        ), "The quantized kv cache must be [batch, seq len, heads, head dim]"
+        self.dim = dim
+        cache_shape = kv_cache.k_cache.shape
+        self.register_buffer(
+            "k_cache", torch.zeros(cache_shape, dtype=torch.int8, device="cpu")
+        )
+        self.register_buffer(
+            "v_cache", torch.zeros(cache_shape, dtype=torch.int8, device="cpu")
+        )
+        self.register_buffer(
+            "k_scales",
+            torch.zeros(cache_shape[:3], dtype=torch.float32, device="cpu"),
+        )
+        self.register_buffer(
+            "v_scales",
+            torch.zeros(cache_shape[:3], dtype=torch.float32, device="cpu"),
+        )
+
+    def forward(
+        self,
+        input_pos: torch.Tensor,
+        q: torch.Tensor,
+        k: torch.Tensor,
+        v: torch.Tensor,
+        bsz,
+        seqlen,
+        mask,
+    ):
+        output = torch.ops.llama.sdpa_with_quantized_kv_cache(
+            q,
+            k,
+            v,
+            self.k_cache,
+            self.v_cache,
+            self.k_scales,
+            self.v_scales,
+            input_pos[-1].item(),
+            seqlen,
+            None,  # Attention mask
+            0,  # dropout probability. Ignored by the code
+            True,  # is_causal
+        )
+        return output.view(bsz, seqlen, self.dim)
+
+
+def _replace_sdpa_with_quantized_kv_cache_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, SDPA):
+            setattr(
+                module,
+                name,
+                SDPACustomQuantizedKVCache(child.kv_cache, child.dim),
+            )
+        else:
+            _replace_sdpa_with_quantized_kv_cache_custom_op(child)
+
+
+def replace_sdpa_with_quantized_kv_cache_custom_op(
+    module: torch.nn.Module,
+) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_sdpa_with_quantized_kv_cache_custom_op(module)
+    return module
+
+
+class SDPACustomSinkKVCache(torch.nn.Module):
+    """
+    SDPACustom for generation past max_seq_len. Once the kv cache is full,
+    the llama::sdpa_with_sink_kv_cache op keeps its first num_sink_tokens
+    tokens, which draw much of the attention of the model, and evicts the
+    oldest of the others, so that memory and the cost of a token stay
+    constant. The op rotates the remaining keys to their new position in the
+    cache with the rope tables of the model, shared by all layers.
+    """
+
+    def __init__(
+        self,
+        kv_cache: KVCache,
+        dim: int,
+        freqs_cos: torch.Tensor,
+        freqs_sin: torch.Tensor,
+        num_sink_tokens: int,
+    ):
+        super().__init__()
+        assert (
+            not kv_cache.transpose_cache
+        ), "The sink kv cache must be [batch, seq len, heads, head dim]"
+        self.kv_cache = kv_cache
+        self.dim = dim
+        self.register_buffer("freqs_cos", freqs_cos, persistent=False)
+        self.register_buffer("freqs_sin", freqs_sin, persistent=False)
+        self.num_sink_tokens = num_sink_tokens
+
+    def forward(
+        self,
+        input_pos: torch.Tensor,
+        q: torch.Tensor,
+        k: torch.Tensor,
+        v: torch.Tensor,
+        bsz,
+        seqlen,
+        mask,
+    ):
+        output = torch.ops.llama.sdpa_with_sink_kv_cache(
+            q,
+            k,
+            v,
+            self.kv_cache.k_cache,
+            self.kv_cache.v_cache,
+            self.freqs_cos,
+            self.freqs_sin,
+            input_pos[-1].item(),
+            seqlen,
+            self.num_sink_tokens,
+        )
+        return output.view(bsz, seqlen, self.dim)
+
+
+def _replace_sdpa_with_sink_kv_cache_custom_op(
+    module: torch.nn.Module,
+    freqs_cos: torch.Tensor,
+    freqs_sin: torch.Tensor,
+    num_sink_tokens: int,
+):
+    for name, child in module.named_children():
+        if isinstance(child, SDPA):
+            setattr(
+                module,
+                name,
+                SDPACustomSinkKVCache(
+                    child.kv_cache, child.dim, freqs_cos, freqs_sin, num_sink_tokens
+                ),
+            )
+        else:
+            _replace_sdpa_with_sink_kv_cache_custom_op(
+                child, freqs_cos, freqs_sin, num_sink_tokens
+            )
+
+
+def replace_sdpa_with_sink_kv_cache_custom_op(
+    module: torch.nn.Module,
+) -> torch.nn.Module:
+    """
+    Replaces the SDPA of a Transformer exported with
+    ModelArgs.num_sink_tokens, which applies RoPE at the position of the
+    tokens in the cache.
+    """
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    num_sink_tokens = module.params.num_sink_tokens
+    assert num_sink_tokens > 0, "The model must be built with num_sink_tokens"
+    _replace_sdpa_with_sink_kv_cache_custom_op(
+        module, module.freqs_cos, module.freqs_sin, num_sink_tokens
+    )
+    return module
+
+
 class SDPASimple(torch.nn.Module):
 
     def __init__(
@@ -16,6 +16,7 @@ def define_common_targets():
                 ] if aten else [],
                 deps = [
                     "//executorch/examples/models/llama2/runner:runner" + aten_suffix,
+                    "//executorch/extension/llm/runner:benchmark",
                     "//executorch/extension/evalue_util:print_evalue",
                     "//executorch/backends/xnnpack/threadpool:threadpool",
                     "//executorch/backends/xnnpack/threadpool:cpuinfo_utils",
@@ -44,6 +44,11 @@ DEFINE_int32(
     -1,
     "Number of CPU threads for inference. Defaults to -1, which implies we'll use a heuristic to derive the # of performant cores for a specific device.");
 
+DEFINE_bool(
+    pipelined_image_encoding,
+    false,
+    "Encode the image on a background thread while the text before it is prefilled. Uses a second instance of the image encoder.");
+
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -77,6 +82,7 @@ int32_t main(int32_t argc, char** argv) {
 #endif
   // create llama runner
   torch::executor::LlavaRunner runner(model_path, tokenizer_path, temperature);
+  runner.set_pipelined_image_encoding(FLAGS_pipelined_image_encoding);
 
   // read image and resize the longest edge to 336
   std::vector<uint8_t> image_data;
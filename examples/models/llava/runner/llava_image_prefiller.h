@@ -17,7 +17,15 @@ namespace torch::executor {
 
 class LlavaImagePrefiller : public ImagePrefiller {
  public:
-  LlavaImagePrefiller(Module* module) : ImagePrefiller(module){};
+  /**
+   * @param module The Module that runs the text model.
+   * @param encoder_module The Module that runs the image encoder. Defaults to
+   * `module`; a separate Module over the same program lets the encoder run
+   * concurrently with the text model.
+   */
+  explicit LlavaImagePrefiller(Module* module, Module* encoder_module = nullptr)
+      : ImagePrefiller(module),
+        encoder_module_(encoder_module ? encoder_module : module){};
   /**
    * Prefill an LLM Module with the given image input.
    * @param image The image input to LLaVa.
@@ -26,19 +34,34 @@ class LlavaImagePrefiller : public ImagePrefiller {
    */
   inline Result<exec_aten::Tensor> prefill(Image& image, int64_t start_pos = 0)
       override {
+    exec_aten::Tensor embeddings = ET_UNWRAP(encode(image));
+    return prefill_embeddings(embeddings, start_pos);
+  }
+
+  inline Result<exec_aten::Tensor> encode(Image& image) override {
     ManagedTensor managed_images(
         image.data.data(), {3, image.height, image.width}, ScalarType::Byte);
     // Run image encoder
-    std::vector<EValue> image_encoder_outputs = ET_UNWRAP(module_->execute(
-        kImageEncoderMethod, {managed_images.get_aliasing_tensor()}));
+    std::vector<EValue> image_encoder_outputs =
+        ET_UNWRAP(encoder_module_->execute(
+            kImageEncoderMethod, {managed_images.get_aliasing_tensor()}));
+    ET_CHECK_OR_RETURN_ERROR(
+        image_encoder_outputs[0].isTensor(),
+        InvalidState,
+        "Non Tensor Output returned from executing image encoder");
+    return image_encoder_outputs[0].toTensor();
+  }
 
+  inline Result<exec_aten::Tensor> prefill_embeddings(
+      exec_aten::Tensor& embeddings,
+      int64_t start_pos = 0) override {
     // inputs:[start_pos, embeds]
     ManagedTensor managed_start_pos(&start_pos, {1}, ScalarType::Long);
     auto start_pos_tensor = managed_start_pos.get_aliasing_tensor();
 
     // Run text model
-    std::vector<EValue> outputs_res = ET_UNWRAP(module_->execute(
-        kTextModelMethod, {start_pos_tensor, image_encoder_outputs[0]}));
+    std::vector<EValue> outputs_res = ET_UNWRAP(
+        module_->execute(kTextModelMethod, {start_pos_tensor, embeddings}));
     ET_CHECK_MSG(
         outputs_res[0].isTensor(),
         "Non Tensor Output returned from executing image prefill");
@@ -54,7 +77,8 @@ class LlavaImagePrefiller : public ImagePrefiller {
     if (is_method_loaded()) {
       return Error::Ok;
     }
-    ET_CHECK_OK_OR_RETURN_ERROR(module_->load_method(kImageEncoderMethod));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        encoder_module_->load_method(kImageEncoderMethod));
     ET_CHECK_OK_OR_RETURN_ERROR(module_->load_method(kTextModelMethod));
     return Error::Ok;
   }
@@ -82,13 +106,17 @@ class LlavaImagePrefiller : public ImagePrefiller {
           kImageEncoderMethod.c_str(),
           kTextModelMethod.c_str());
     }
-    bool methods_loaded = module_->is_method_loaded(kImageEncoderMethod) &&
+    bool methods_loaded =
+        encoder_module_->is_method_loaded(kImageEncoderMethod) &&
         module_->is_method_loaded(kTextModelMethod);
     return methods_loaded;
   }
 
   inline static const std::string kImageEncoderMethod = "image_encoder";
   inline static const std::string kTextModelMethod = "text_model";
+
+ private:
+  Module* encoder_module_;
 };
 
 } // namespace torch::executor
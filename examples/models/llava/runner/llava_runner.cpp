@@ -42,6 +42,24 @@ Error LlavaRunner::load() {
   tokenizer_ = std::make_unique<BPETokenizer>();
   tokenizer_->load(tokenizer_path_);
 
+  if (pipelined_image_encoding_) {
+    // The image encoder runs concurrently with the text model, so it gets a
+    // Module of its own, with its own planned memory and allocators. Mapping
+    // the program lets both Modules share the pages of the weights.
+    encoder_module_ =
+        std::make_unique<Module>(model_path_, Module::LoadMode::Mmap);
+  } else if (
+      !module_->is_method_loaded(LlavaImagePrefiller::kImageEncoderMethod) &&
+      !module_->is_method_loaded(
+          LlavaTextDecoderRunner::kTokenEmbeddingMethod)) {
+    // The image encoder and the token embedding never run at the same time,
+    // and the text model consumes their outputs right away, so they can
+    // share planned memory. The text model keeps its own for the KV cache.
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->load_methods_with_shared_memory(
+        {LlavaImagePrefiller::kImageEncoderMethod,
+         LlavaTextDecoderRunner::kTokenEmbeddingMethod}));
+  }
+
   // Load the text decoder runner
   text_decoder_runner_ = std::make_unique<LlavaTextDecoderRunner>(
       module_.get(), tokenizer_->vocab_size(), temperature_);
@@ -55,7 +73,8 @@ Error LlavaRunner::load() {
       /*enable_parallel_prefill=*/true);
 
   // Load the image prefiller
-  image_prefiller_ = std::make_unique<LlavaImagePrefiller>(module_.get());
+  image_prefiller_ = std::make_unique<LlavaImagePrefiller>(
+      module_.get(), encoder_module_.get());
   image_prefiller_->load();
 
   // Load the text token generator
@@ -75,7 +94,7 @@ Error LlavaRunner::generate(
     std::vector<Image>& images,
     const std::string& prompt,
     int32_t seq_len,
-    std::function<void(const std::string&)> token_callback,
+    std::function<void(std::string_view)> token_callback,
     std::function<void(const Stats&)> stats_callback) {
   ET_CHECK_MSG(!prompt.empty(), "Prompt cannot be null");
   if (!is_loaded()) {
@@ -83,9 +102,9 @@ Error LlavaRunner::generate(
   }
 
   // Wrap the token_callback with print function
-  std::function<void(const std::string&)> wrapped_callback =
-      [token_callback](const std::string& piece) {
-        util::safe_printf(piece.c_str());
+  std::function<void(std::string_view)> wrapped_callback =
+      [token_callback](std::string_view piece) {
+        util::safe_printf(piece);
         fflush(stdout);
         if (token_callback) {
           token_callback(piece);
@@ -99,14 +118,16 @@ Error LlavaRunner::generate(
       ET_UNWRAP(tokenizer_->encode(kPresetPrompt, /*bos=*/1, /*eos=*/0));
   size_t num_preset_tokens = preset_prompt_tokens.size();
 
-  ET_UNWRAP(text_prefiller_->prefill(preset_prompt_tokens, pos));
-  pos += num_preset_tokens;
-
-  // prefill images
-  for (auto& image : images) {
-    auto logits = ET_UNWRAP(image_prefiller_->prefill(image, pos));
-    pos += logits.size(1);
-  }
+  // prefill images after it, encoding the first one meanwhile in pipelined
+  // mode
+  ET_CHECK_OK_OR_RETURN_ERROR(prefill_text_and_images(
+      [&]() -> Error {
+        ET_UNWRAP(text_prefiller_->prefill(preset_prompt_tokens, pos));
+        pos += num_preset_tokens;
+        return Error::Ok;
+      },
+      images,
+      pos));
 
   // prefill user prompt. No BOS because preset prompt already has it.
   std::vector<uint64_t> user_prompt_tokens =
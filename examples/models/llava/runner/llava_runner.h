@@ -34,7 +34,7 @@ class LlavaRunner : public MultimodalRunner {
       std::vector<Image>& images,
       const std::string& prompt,
       int32_t seq_len = 1024,
-      std::function<void(const std::string&)> token_callback = {},
+      std::function<void(std::string_view)> token_callback = {},
       std::function<void(const Stats&)> stats_callback = {});
 
  private:
@@ -22,26 +22,26 @@ class LlavaTextDecoderRunner : public TextDecoderRunner {
   inline Result<exec_aten::Tensor> step(
       ManagedTensor& managed_tokens,
       ManagedTensor& managed_start_pos) override {
-    auto tokens = managed_tokens.get_aliasing_tensor();
-    auto start_pos = managed_start_pos.get_aliasing_tensor();
-
     // run token embedding
-    std::vector<EValue> token_embedding_outputs =
-        ET_UNWRAP(module_->execute(kTokenEmbeddingMethod, {tokens}));
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->set_input(
+        kTokenEmbeddingMethod, managed_tokens.get_aliasing_tensor(), 0));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        module_->execute_in_place(kTokenEmbeddingMethod));
+    EValue embedding = ET_UNWRAP(module_->get_output(kTokenEmbeddingMethod, 0));
 
     // run text model
-    std::vector<EValue> outputs_res = ET_UNWRAP(module_->execute(
-        kTextModelMethod, {start_pos, token_embedding_outputs[0]}));
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->set_input(
+        kTextModelMethod, managed_start_pos.get_aliasing_tensor(), 0));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        module_->set_input(kTextModelMethod, embedding, 1));
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->execute_in_place(kTextModelMethod));
+    EValue logits = ET_UNWRAP(module_->get_output(kTextModelMethod, 0));
 
     ET_CHECK_MSG(
-        outputs_res.size() == 1,
-        "More then one output returned from executing LLM.");
-    ET_CHECK_MSG(
-        outputs_res[0].isTensor(),
-        "Non Tensor Output returned from executing LLM");
+        logits.isTensor(), "Non Tensor Output returned from executing LLM");
 
     // Return the logits tensor
-    return outputs_res[0].toTensor();
+    return logits.toTensor();
   }
 
   /**
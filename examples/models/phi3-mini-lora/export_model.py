@@ -9,6 +9,7 @@ from executorch.exir import to_edge
 from torch import int64, long, no_grad, randint, Tensor, zeros
 from torch.export import export, ExportedProgram
 from torch.export.experimental import _export_forward_backward
+from torch.func import functional_call
 from torch.nn.attention import sdpa_kernel, SDPBackend
 from torchtune.models.phi3._model_builders import lora_phi3_mini
 from torchtune.modules.peft import get_adapter_params, set_trainable_params
@@ -35,6 +36,85 @@ class TrainingModule(torch.nn.Module):
         return self.loss(output, target)
 
 
+class AdapterSlotsModule(torch.nn.Module):
+    """
+    Wraps a LoRA model so that its adapter weights are inputs that follow
+    the model input, the adapter slots. At runtime, Module::load_adapter()
+    fills the slots with the weights of an adapter program, so that one
+    base program can switch between adapters without being reloaded.
+    """
+
+    def __init__(self, model, adapter_names):
+        super().__init__()
+        self.model = model
+        self.adapter_names = adapter_names
+
+    def forward(self, input, *adapter_weights):
+        weights = dict(zip(self.adapter_names, adapter_weights))
+        return functional_call(self.model, weights, (input,))
+
+
+class AdapterWeights(torch.nn.Module):
+    """
+    Returns the weights of an adapter in the order of the adapter slots.
+    """
+
+    def __init__(self, weights):
+        super().__init__()
+        for i, weight in enumerate(weights):
+            self.register_buffer(f"weight_{i}", weight.detach().clone())
+
+    def forward(self):
+        return tuple(weight.clone() for weight in self.buffers())
+
+
+def _save(program, path: str) -> None:
+    print(f"Saving to {path}")
+    with open(path, "wb") as file:
+        file.write(program.buffer)
+
+
+@no_grad()
+def export_phi3_mini_lora_adapter(model, adapter_names, path: str) -> None:
+    """
+    Export the current adapter weights of the example phi3-mini with LoRA
+    model to an adapter program, which can be loaded into the adapter slots
+    of the program exported by export_phi3_mini_lora_with_adapter_slots().
+    """
+    adapter_params = get_adapter_params(model)
+    adapter = AdapterWeights([adapter_params[name] for name in adapter_names])
+    edge_program = to_edge(export(adapter, ()))
+    _save(edge_program.to_executorch(), path)
+
+
+@no_grad()
+def export_phi3_mini_lora_with_adapter_slots(model) -> None:
+    """
+    Export the example phi3-mini with LoRA model to executorch with its
+    adapter weights as adapter slots instead of constants, along with its
+    current adapter. Other adapters of the same model, e.g. other fine-tunes,
+    exported with export_phi3_mini_lora_adapter() can be swapped in at
+    runtime while the base weights stay loaded.
+    """
+    model.eval()
+    adapter_params = get_adapter_params(model)
+    adapter_names = sorted(adapter_params)
+    slots_model = AdapterSlotsModule(model, adapter_names)
+    example_args = (
+        randint(0, 100, (1, 100), dtype=long),
+        *[adapter_params[name].detach() for name in adapter_names],
+    )
+    print("Exporting phi3-mini with LoRA adapter slots")
+    with sdpa_kernel([SDPBackend.MATH]):
+        edge_program = to_edge(export(slots_model, example_args))
+    _save(edge_program.to_executorch(), "phi3_mini_lora_base.pte")
+
+    export_phi3_mini_lora_adapter(
+        model, adapter_names, "phi3_mini_lora_adapter.pte"
+    )
+    print("Done.")
+
+
 @no_grad()
 def export_phi3_mini_lora(model) -> None:
     """
@@ -124,6 +204,9 @@ def main() -> None:
     # Export for inference.
     export_phi3_mini_lora(lora_model)
 
+    # Export for inference with adapters that can be swapped at runtime.
+    export_phi3_mini_lora_with_adapter_slots(lora_model)
+
     # Export for training.
     lora_training_model = TrainingModule(lora_model, torch.nn.CrossEntropyLoss())
     export_phi3_mini_lora_training(lora_training_model)
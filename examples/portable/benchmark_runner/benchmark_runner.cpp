@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Measures the steady state latency of a method of an ExecuTorch program.
+ *
+ * The program is loaded with Module, the inputs of the method are filled with
+ * ones, and after a number of untimed warmup runs the method is executed
+ * repeatedly and the distribution of the run times is reported, along with
+ * the load times, the memory planned for the method and the peak resident set
+ * size of the process. Linking this file against different kernel libraries
+ * and backends gives comparable numbers for each of them.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/runner_util/inputs.h>
+#include <executorch/runtime/platform/clock.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/backends/xnnpack/threadpool/cpuinfo_utils.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+DEFINE_string(
+    model_path,
+    "model.pte",
+    "Model serialized in flatbuffer format.");
+DEFINE_string(method_name, "forward", "Method of the program to run.");
+DEFINE_int32(
+    warmup_iterations,
+    5,
+    "Untimed runs before the timed ones, to warm up caches and threads.");
+DEFINE_int32(iterations, 50, "Number of timed runs.");
+DEFINE_int32(
+    cpu_threads,
+    -1,
+    "Number of threads of the threadpool. -1 uses the number of performant cores and 0 leaves the threadpool as it is. Only used in builds with the threadpool.");
+DEFINE_string(
+    cpu_ids,
+    "",
+    "Comma separated logical CPUs to pin the calling thread and the threadpool workers to, e.g. '4,5,6,7', or 'performant' for the cores that are not efficiency cores. Empty leaves the threads unpinned. Only used in builds with the threadpool, on Linux and Android.");
+
+using executorch::extension::Module;
+using executorch::runtime::Error;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Result;
+
+namespace {
+
+uint64_t now_ns() {
+  return executorch::runtime::ticks_to_ns(et_pal_current_ticks());
+}
+
+/// The value below which `percent` percent of the sorted `samples` fall,
+/// using the nearest-rank method.
+uint64_t percentile(const std::vector<uint64_t>& samples, double percent) {
+  const size_t rank =
+      static_cast<size_t>(std::ceil(percent / 100.0 * samples.size()));
+  return samples[std::min(std::max<size_t>(rank, 1), samples.size()) - 1];
+}
+
+/// Peak resident set size of the process in bytes, or 0 if unknown.
+uint64_t peak_rss_bytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // Reported in kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+#if defined(ET_USE_THREADPOOL)
+bool parse_cpu_ids(const std::string& spec, std::vector<uint32_t>& cpu_ids) {
+  if (spec == "performant") {
+    cpu_ids = torch::executorch::cpuinfo::get_performant_cpu_ids();
+    return true;
+  }
+  std::stringstream stream(spec);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    char* end = nullptr;
+    const unsigned long id = std::strtoul(item.c_str(), &end, 10);
+    if (item.empty() || *end != '\0') {
+      return false;
+    }
+    cpu_ids.push_back(static_cast<uint32_t>(id));
+  }
+  return true;
+}
+
+/// Resizes the threadpool and pins its threads as asked by the flags.
+bool configure_threads() {
+  auto* threadpool = torch::executorch::threadpool::get_threadpool();
+  const uint32_t num_threads = FLAGS_cpu_threads == -1
+      ? torch::executorch::cpuinfo::get_num_performant_cores()
+      : static_cast<uint32_t>(FLAGS_cpu_threads);
+  if (num_threads > 0) {
+    ET_LOG(
+        Info, "Resetting threadpool with num threads = %" PRIu32, num_threads);
+    threadpool->_unsafe_reset_threadpool(num_threads);
+  }
+  if (FLAGS_cpu_ids.empty()) {
+    return true;
+  }
+  std::vector<uint32_t> cpu_ids;
+  if (!parse_cpu_ids(FLAGS_cpu_ids, cpu_ids)) {
+    ET_LOG(Error, "Invalid --cpu_ids '%s'", FLAGS_cpu_ids.c_str());
+    return false;
+  }
+  if (cpu_ids.empty()) {
+    ET_LOG(Info, "No performant cores to pin to, leaving threads unpinned");
+    return true;
+  }
+  // The calling thread takes part in every run, so it is pinned as well.
+  if (!torch::executorch::threadpool::set_current_thread_affinity(cpu_ids) ||
+      !threadpool->configure_worker_threads(
+          cpu_ids, torch::executorch::threadpool::ThreadPriority::Default)) {
+    ET_LOG(Error, "Failed to pin the threads to --cpu_ids");
+    return false;
+  }
+  return true;
+}
+#endif
+
+/// Sum of the memory planned buffers of the method, in bytes.
+int64_t planned_memory_bytes(const MethodMeta& meta) {
+  int64_t total = 0;
+  for (size_t i = 0; i < meta.num_memory_planned_buffers(); ++i) {
+    Result<int64_t> size = meta.memory_planned_buffer_size(i);
+    if (size.ok()) {
+      total += size.get();
+    }
+  }
+  return total;
+}
+
+double to_ms(uint64_t ns) {
+  return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_iterations <= 0 || FLAGS_warmup_iterations < 0) {
+    ET_LOG(
+        Error,
+        "--iterations must be positive and --warmup_iterations non-negative");
+    return 1;
+  }
+
+#if defined(ET_USE_THREADPOOL)
+  if (!configure_threads()) {
+    return 1;
+  }
+#else
+  if (!FLAGS_cpu_ids.empty()) {
+    ET_LOG(Info, "Built without the threadpool, ignoring --cpu_ids");
+  }
+#endif
+
+  const std::string& method_name = FLAGS_method_name;
+  Module module(FLAGS_model_path, Module::LoadMode::Mmap);
+
+  uint64_t start = now_ns();
+  Error status = module.load();
+  const uint64_t program_load_ns = now_ns() - start;
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "Loading %s failed: 0x%" PRIx32,
+      FLAGS_model_path.c_str(),
+      static_cast<uint32_t>(status));
+
+  start = now_ns();
+  status = module.load_method(method_name);
+  const uint64_t method_load_ns = now_ns() - start;
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "Loading method %s failed: 0x%" PRIx32,
+      method_name.c_str(),
+      static_cast<uint32_t>(status));
+
+  Result<MethodMeta> meta = module.method_meta(method_name);
+  ET_CHECK_MSG(
+      meta.ok(), "Failed to get the metadata of %s", method_name.c_str());
+
+  auto handle = module.method_handle(method_name);
+  ET_CHECK_MSG(handle.ok(), "Failed to get method %s", method_name.c_str());
+  // Holds the memory of the inputs until the end of the runs.
+  auto inputs = executorch::extension::prepare_input_tensors(handle->method());
+  ET_CHECK_MSG(
+      inputs.ok(),
+      "Preparing the inputs failed: 0x%" PRIx32,
+      static_cast<uint32_t>(inputs.error()));
+
+  for (int32_t i = 0; i < FLAGS_warmup_iterations; ++i) {
+    status = module.execute_in_place(method_name);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Execution of %s failed: 0x%" PRIx32,
+        method_name.c_str(),
+        static_cast<uint32_t>(status));
+  }
+
+  std::vector<uint64_t> samples;
+  samples.reserve(FLAGS_iterations);
+  uint64_t total_ns = 0;
+  for (int32_t i = 0; i < FLAGS_iterations; ++i) {
+    start = now_ns();
+    status = module.execute_in_place(method_name);
+    const uint64_t elapsed = now_ns() - start;
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Execution of %s failed: 0x%" PRIx32,
+        method_name.c_str(),
+        static_cast<uint32_t>(status));
+    samples.push_back(elapsed);
+    total_ns += elapsed;
+  }
+  std::sort(samples.begin(), samples.end());
+
+  printf("Model:            %s\n", FLAGS_model_path.c_str());
+  printf("Method:           %s\n", method_name.c_str());
+  printf("Program load:     %.3f ms\n", to_ms(program_load_ns));
+  printf("Method load:      %.3f ms\n", to_ms(method_load_ns));
+  printf(
+      "Planned memory:   %" PRId64 " bytes in %zu buffers\n",
+      planned_memory_bytes(meta.get()),
+      meta->num_memory_planned_buffers());
+  printf("Peak RSS:         %" PRIu64 " bytes\n", peak_rss_bytes());
+  printf(
+      "Iterations:       %" PRId32 " (after %" PRId32 " warmup)\n",
+      FLAGS_iterations,
+      FLAGS_warmup_iterations);
+  printf(
+      "Latency (ms):     min %.3f  mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f  "
+      "max %.3f\n",
+      to_ms(samples.front()),
+      to_ms(total_ns) / samples.size(),
+      to_ms(percentile(samples, 50)),
+      to_ms(percentile(samples, 90)),
+      to_ms(percentile(samples, 99)),
+      to_ms(samples.back()));
+  return 0;
+}
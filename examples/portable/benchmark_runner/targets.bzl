@@ -0,0 +1,29 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Measures the latency of a method of a model with the portable and
+    # quantized kernels. To benchmark other kernel libraries or backends,
+    # define a new binary with the same srcs and different deps.
+    runtime.cxx_binary(
+        name = "benchmark_runner",
+        srcs = ["benchmark_runner.cpp"],
+        deps = [
+            "//executorch/backends/xnnpack/threadpool:cpuinfo_utils",
+            "//executorch/backends/xnnpack/threadpool:threadpool",
+            "//executorch/extension/module:module",
+            "//executorch/extension/runner_util:inputs",
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/kernels/quantized:generated_lib",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
@@ -179,7 +179,11 @@ int main(int argc, char** argv) {
   // mobile environments will only have a single buffer. Some embedded
   // environments may have more than one for, e.g., slow/large DRAM and
   // fast/small SRAM, or for memory associated with particular cores.
-  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers; // Owns the memory
+  //
+  // With shared buffers, the planned buffers are allocated on shared memory
+  // too, so that the tensors planned in them, e.g. the ones passed between
+  // delegates, are registered to the backend without copies.
+  std::vector<std::unique_ptr<CustomMemory>> planned_buffers; // Owns the memory
   std::vector<Span<uint8_t>> planned_spans; // Passed to the allocator
   size_t num_memory_planned_buffers = method_meta->num_memory_planned_buffers();
   for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
@@ -187,8 +191,16 @@ int main(int argc, char** argv) {
     size_t buffer_size =
         static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
     ET_LOG(Info, "Setting up planned buffer %zu, size %zu.", id, buffer_size);
-    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
-    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+    planned_buffers.push_back(
+        std::make_unique<CustomMemory>(FLAGS_shared_buffer));
+    ET_CHECK_MSG(
+        planned_buffers.back()->Allocate(
+            buffer_size, MemoryAllocator::kDefaultAlignment),
+        "Failed to allocate planned buffer %zu, bytes: %zu",
+        id,
+        buffer_size);
+    planned_spans.push_back(
+        {static_cast<uint8_t*>(planned_buffers.back()->GetPtr()), buffer_size});
   }
   HierarchicalAllocator planned_memory(
       {planned_spans.data(), planned_spans.size()});
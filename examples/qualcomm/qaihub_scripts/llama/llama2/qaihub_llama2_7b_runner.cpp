@@ -48,6 +48,10 @@ DEFINE_int32(
     "Total number of tokens to generate (prompt + output). Defaults to max_seq_len. If the number of input tokens + seq_len > max_seq_len, the output will be truncated to max_seq_len tokens.");
 DEFINE_double(logits_scale, 0.0, "Path to logits scale file");
 DEFINE_int32(logits_offset, 0, "Path to logits offset file");
+DEFINE_bool(
+    stream_shards,
+    false,
+    "Keep only the running shard and the next one loaded, loading each shard while the one before it executes. Lowers peak memory at the cost of throughput.");
 
 int main(int argc, char** argv) {
   using namespace torch::executor;
@@ -71,7 +75,8 @@ int main(int argc, char** argv) {
       FLAGS_eval_mode,
       FLAGS_temperature,
       FLAGS_logits_scale,
-      FLAGS_logits_offset);
+      FLAGS_logits_offset,
+      FLAGS_stream_shards);
 
   // generate tokens & store inference output
   std::ofstream fout(FLAGS_output_path.c_str());
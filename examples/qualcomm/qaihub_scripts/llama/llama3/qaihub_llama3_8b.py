@@ -145,6 +145,7 @@ def main(args):
         f"--eval_mode {0 if args.use_prompt_processor else 1}",
         f"--logits_scale {scale}",
         f"--logits_offset {-offset}",
+        f"--stream_shards={str(args.stream_shards).lower()}",
     ]
     runner_cmds = " ".join(
         [
@@ -217,6 +218,13 @@ if __name__ == "__main__":
         action="store_true",
     )
 
+    parser.add_argument(
+        "--stream_shards",
+        help="keep only the running shard and the next one loaded on device",
+        default=False,
+        action="store_true",
+    )
+
     parser.add_argument(
         "--tokenizer_model",
         help="llama3 tokenizer model",
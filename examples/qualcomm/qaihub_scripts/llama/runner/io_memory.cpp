@@ -25,6 +25,10 @@ Memory::Memory(
 
 Memory::~Memory() {}
 
+void Memory::set_bind_outputs(bool bind_outputs) {
+  bind_outputs_ = bind_outputs;
+}
+
 void* Memory::get_mutable_ptr() {
   return data_ptr_.get();
 }
@@ -418,6 +422,9 @@ void KVCachedMemory::update_io(
         v_cache_out_[i]->set_data(
             v_cache_out_[i]->mutable_data<uint8_t>() + 128);
       }
+      if (!bind_outputs_) {
+        return;
+      }
       // update output tensors of v_cache, 256 is the number of kvs per shard
       int shard = lr->start >> 8, offset = shard << 8;
       int start = lr->start - offset, end = lr->end - offset;
@@ -447,7 +454,8 @@ void KVCachedMemory::update_io(
       v_cache_in_[i]->set_data(v_cache_in_[i]->mutable_data<uint8_t>() + 128);
       v_cache_out_[i]->set_data(v_cache_out_[i]->mutable_data<uint8_t>() + 128);
     }
-    for (int shard = 0; shard < output_tensors.size(); shard++) {
+    for (int shard = 0; bind_outputs_ && shard < output_tensors.size();
+         shard++) {
       for (int index = 0; index < output_tensors[shard].size(); index++) {
         ET_CHECK_MSG(
             modules_[shard]->set_output_data_ptr(
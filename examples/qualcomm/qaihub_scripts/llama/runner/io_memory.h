@@ -44,6 +44,10 @@ class Memory {
   void* get_mutable_ptr();
   std::vector<Tensor> get_input_tensors(int shard_index);
   std::vector<Tensor> get_output_tensors(int shard_index);
+  // Whether update_io points the outputs of the modules at the moved caches.
+  // Turned off when the runner streams the shards in, since it points the
+  // outputs of every shard it loads itself.
+  void set_bind_outputs(bool bind_outputs);
 
  protected:
   std::unique_ptr<void, void (*)(void*)> data_ptr_;
@@ -51,6 +55,7 @@ class Memory {
   std::vector<std::vector<TensorImpl*>> output_tensors_;
   std::vector<std::string> pos_embs_path_;
   std::vector<std::shared_ptr<Module>> modules_;
+  bool bind_outputs_{true};
 };
 
 class BertMemory : public Memory {
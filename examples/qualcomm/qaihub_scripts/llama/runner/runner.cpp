@@ -23,6 +23,7 @@
 #include <executorch/runtime/platform/log.h>
 
 #include <ctime>
+#include <future>
 #include <memory>
 #include <sstream>
 
@@ -47,7 +48,8 @@ Runner::Runner(
     const int eval_mode,
     const float temperature,
     const float logits_scale,
-    const int logits_offset)
+    const int logits_offset,
+    const bool stream_shards)
     : tokenizer_path_(tokenizer_path),
       temperature_(temperature),
       bos_id_(1),
@@ -59,10 +61,16 @@ Runner::Runner(
       eval_mode_(eval_mode),
       stats_({}),
       logits_scale_(logits_scale),
-      logits_offset_(logits_offset) {
+      logits_offset_(logits_offset),
+      // With two shards or less, every shard is the current or the next one.
+      stream_shards_(stream_shards && models_path.size() > 2) {
   for (size_t i = 0; i < models_path.size(); ++i) {
+    // Streamed shards are not locked in memory, so that the pages of the ones
+    // which are not loaded can be reclaimed.
     modules_.push_back(std::make_shared<Module>(
-        models_path[i], Module::LoadMode::MmapUseMlockIgnoreErrors));
+        models_path[i],
+        stream_shards_ ? Module::LoadMode::Mmap
+                       : Module::LoadMode::MmapUseMlockIgnoreErrors));
     ET_LOG(Info, "creating module: model_path=%s", models_path[i].c_str());
   }
   ET_LOG(Info, "creating runner: tokenizer_path=%s", tokenizer_path_.c_str());
@@ -79,6 +87,7 @@ Runner::Runner(
     default:
       ET_CHECK_MSG(false, "unsupported evaluation mode");
   }
+  io_mem_->set_bind_outputs(!stream_shards_);
   ET_LOG(Info, "creating io_memory");
 }
 
@@ -95,7 +104,12 @@ Error Runner::load() {
     return Error::Ok;
   }
   for (std::shared_ptr<Module>& module : modules_) {
-    ET_CHECK_OK_OR_RETURN_ERROR(module->load_method("forward"));
+    if (stream_shards_) {
+      // The shards are loaded one at a time while the model runs.
+      ET_CHECK_OK_OR_RETURN_ERROR(module->load());
+    } else {
+      ET_CHECK_OK_OR_RETURN_ERROR(module->load_method("forward"));
+    }
   }
 
 // load tokenizer
@@ -116,6 +130,9 @@ Error Runner::load() {
   // prepare io
   auto methods_meta = get_methods_meta();
   io_mem_->prepare_io(methods_meta);
+  if (stream_shards_) {
+    prefetch_shard(0);
+  }
   return Error::Ok;
 }
 
@@ -146,11 +163,53 @@ int32_t Runner::logitsToToken(const Tensor& logits_tensor) {
   return sampler_->sample(logits_f.data());
 }
 
-void Runner::run_model_step(std::vector<std::vector<EValue>>& inputs) {
+void Runner::prefetch_shard(size_t shard_index) {
+  std::shared_ptr<Module> module = modules_[shard_index];
+  pending_load_ = std::async(std::launch::async, [module]() {
+    return module->load_method("forward");
+  });
+  pending_shard_ = shard_index;
+}
+
+void Runner::wait_for_shard(
+    size_t shard_index,
+    std::vector<std::vector<Tensor>>& output_tensors) {
+  ET_CHECK_MSG(
+      pending_load_.valid() && pending_shard_ == shard_index,
+      "shard %zu is not being loaded",
+      shard_index);
+  ET_CHECK_MSG(
+      pending_load_.get() == Error::Ok, "failed to load shard %zu", shard_index);
+  // A newly loaded method writes to its planned outputs, so point them at the
+  // current io buffers again.
+  for (size_t j = 0; j < output_tensors[shard_index].size(); ++j) {
+    ET_CHECK_MSG(
+        modules_[shard_index]->set_output_data_ptr(
+            output_tensors[shard_index][j], j) == Error::Ok,
+        "failed to set output tensor for module %zu's %zu'th output",
+        shard_index,
+        j);
+  }
+}
+
+void Runner::run_model_step(
+    std::vector<std::vector<EValue>>& inputs,
+    std::vector<std::vector<Tensor>>& output_tensors) {
   for (size_t i = 0, num_modules = modules_.size(); i < num_modules; ++i) {
+    if (stream_shards_) {
+      wait_for_shard(i, output_tensors);
+      // The shard after the last one is the first shard of the next step.
+      prefetch_shard((i + 1) % num_modules);
+    }
     Result<std::vector<EValue>> outputs_res = modules_[i]->forward(inputs[i]);
     ET_CHECK_MSG(
         outputs_res.error() == Error::Ok, "shard %zu inference failed", i);
+    if (stream_shards_) {
+      ET_CHECK_MSG(
+          modules_[i]->unload_method("forward") == Error::Ok,
+          "failed to unload shard %zu",
+          i);
+    }
   }
 }
 
@@ -170,7 +229,9 @@ Error Runner::generate(
     for (int i = 0; i < modules_.size(); ++i) {
       input_tensors.emplace_back(io_mem_->get_input_tensors(i));
       output_tensors.emplace_back(io_mem_->get_output_tensors(i));
-      for (size_t j = 0; j < output_tensors[i].size(); ++j) {
+      // Streamed shards get their outputs set whenever they are loaded.
+      for (size_t j = 0; !stream_shards_ && j < output_tensors[i].size();
+           ++j) {
         ET_CHECK_MSG(
             modules_[i]->set_output_data_ptr(output_tensors[i][j], j) ==
                 Error::Ok,
@@ -237,7 +298,7 @@ Error Runner::generate(
 
   while (pos < seq_len - 1) {
     // inference
-    run_model_step(inputs);
+    run_model_step(inputs, output_tensors);
     Tensor& logits_tensor = output_tensors.back().back();
 
     if (pos == num_prompt_tokens) {
@@ -375,7 +436,12 @@ std::vector<Result<MethodMeta>> Runner::get_methods_meta() {
   std::vector<Result<MethodMeta>> methods_meta;
   methods_meta.reserve(modules_.size());
   for (std::shared_ptr<Module>& module : modules_) {
-    methods_meta.emplace_back(module->method_meta("forward"));
+    if (stream_shards_) {
+      // Read the metadata from the program so that the shard stays unloaded.
+      methods_meta.emplace_back(module->program()->method_meta("forward"));
+    } else {
+      methods_meta.emplace_back(module->method_meta("forward"));
+    }
   }
   return methods_meta;
 }
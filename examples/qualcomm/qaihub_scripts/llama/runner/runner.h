@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -36,7 +37,8 @@ class Runner {
       const int eval_mode,
       const float temperature,
       const float logits_scale,
-      const int logits_offset);
+      const int logits_offset,
+      const bool stream_shards = false);
 
   struct Stats {
     // Scaling factor for timestamps - in this case, we use ms.
@@ -82,7 +84,13 @@ class Runner {
   };
 
   int32_t logitsToToken(const exec_aten::Tensor& logits_tensor);
-  void run_model_step(std::vector<std::vector<EValue>>& inputs);
+  void run_model_step(
+      std::vector<std::vector<EValue>>& inputs,
+      std::vector<std::vector<Tensor>>& output_tensors);
+  void prefetch_shard(size_t shard_index);
+  void wait_for_shard(
+      size_t shard_index,
+      std::vector<std::vector<Tensor>>& output_tensors);
   // metadata
   const int32_t bos_id_;
   const int32_t eos_id_;
@@ -101,6 +109,11 @@ class Runner {
   std::unique_ptr<Memory> io_mem_;
   const float logits_scale_;
   const int32_t logits_offset_;
+  // Keep only the running shard and the one after it loaded, loading the
+  // next shard in the background while the current one executes.
+  const bool stream_shards_;
+  std::future<Error> pending_load_;
+  size_t pending_shard_{0};
 };
 
 } // namespace executor
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Converts an ETDump file, or a stream of ETDumps written by the streaming
+ * mode of ETDumpGen, to a Chrome trace JSON file that can be opened in
+ * Perfetto (ui.perfetto.dev) or chrome://tracing. It has no dependency on
+ * Python, so it can run on the device that generated the ETDump.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/etdump/chrome_trace.h>
+
+DEFINE_string(etdump_path, "etdump.etdp", "ETDump file to convert.");
+
+DEFINE_string(output_path, "trace.json", "Chrome trace file to write.");
+
+DEFINE_double(
+    ns_per_tick,
+    1.0,
+    "Duration of a timestamp tick in nanoseconds on the device that generated the ETDump.");
+
+using namespace torch::executor;
+
+namespace {
+
+class FileWriter : public ETDumpWriter {
+ public:
+  explicit FileWriter(FILE* file) : file_(file) {}
+
+  Error write(const void* data, size_t size) override {
+    return fwrite(data, 1, size, file_) == size ? Error::Ok
+                                                : Error::AccessFailed;
+  }
+
+ private:
+  FILE* file_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+
+  std::ifstream etdump_file(
+      FLAGS_etdump_path, std::ios::binary | std::ios::ate);
+  if (!etdump_file) {
+    ET_LOG(Error, "Could not open '%s'", FLAGS_etdump_path.c_str());
+    return 1;
+  }
+  const size_t etdump_size = etdump_file.tellg();
+  etdump_file.seekg(0, std::ios::beg);
+  std::vector<uint8_t> etdump(etdump_size);
+  if (!etdump_file.read(reinterpret_cast<char*>(etdump.data()), etdump_size)) {
+    ET_LOG(Error, "Could not read '%s'", FLAGS_etdump_path.c_str());
+    return 1;
+  }
+
+  FILE* output = fopen(FLAGS_output_path.c_str(), "w");
+  if (output == nullptr) {
+    ET_LOG(Error, "Could not open '%s'", FLAGS_output_path.c_str());
+    return 1;
+  }
+  FileWriter writer(output);
+  Error err =
+      write_chrome_trace(etdump.data(), etdump.size(), &writer, FLAGS_ns_per_tick);
+  fclose(output);
+  if (err != Error::Ok) {
+    ET_LOG(
+        Error,
+        "Conversion of '%s' failed: 0x%" PRIx32,
+        FLAGS_etdump_path.c_str(),
+        static_cast<uint32_t>(err));
+    return 1;
+  }
+  ET_LOG(Info, "Wrote %s", FLAGS_output_path.c_str());
+  return 0;
+}
@@ -0,0 +1,25 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Converts ETDumps to Chrome traces.
+    runtime.cxx_binary(
+        name = "etdump_to_chrome_trace",
+        srcs = [
+            "etdump_to_chrome_trace.cpp",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+            "//executorch/sdk/etdump:chrome_trace",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
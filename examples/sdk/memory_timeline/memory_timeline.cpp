@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Runs a method of a program once on inputs of ones, then writes a Chrome
+ * trace JSON file of its memory usage over its instructions: the lifetimes of
+ * its memory-planned tensors, the live bytes of each planned buffer, and the
+ * usage of the temp and method allocators. Open the file in Perfetto
+ * (ui.perfetto.dev) or chrome://tracing.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/extension/runner_util/inputs.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/memory_timeline/memory_timeline.h>
+
+DEFINE_string(
+    model_path,
+    "model.pte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(method_name, "forward", "Method to run.");
+
+DEFINE_string(
+    output_path,
+    "memory_timeline.json",
+    "Chrome trace file to write.");
+
+DEFINE_int32(
+    method_allocator_bytes,
+    4 * 1024U * 1024U,
+    "Size of the method allocator pool.");
+
+DEFINE_int32(
+    temp_allocator_bytes,
+    4 * 1024U * 1024U,
+    "Size of the temp allocator pool.");
+
+DEFINE_int32(
+    num_top_tensors,
+    5,
+    "Number of the largest tensors live at the peak instruction to log.");
+
+using namespace torch::executor;
+
+namespace {
+
+std::vector<uint8_t> load_file_or_die(const char* path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  const size_t nbytes = file.tellg();
+  file.seekg(0, std::ios::beg);
+  auto file_data = std::vector<uint8_t>(nbytes);
+  ET_CHECK_MSG(
+      file.read(reinterpret_cast<char*>(file_data.data()), nbytes),
+      "Could not load contents of file '%s'",
+      path);
+  return file_data;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+
+  const char* model_path = FLAGS_model_path.c_str();
+  const char* method_name = FLAGS_method_name.c_str();
+  std::vector<uint8_t> file_data = load_file_or_die(model_path);
+  auto loader = util::BufferDataLoader(file_data.data(), file_data.size());
+  Result<Program> program = Program::load(&loader);
+  if (!program.ok()) {
+    ET_LOG(Error, "Failed to parse model file %s", model_path);
+    return 1;
+  }
+
+  Result<MethodMeta> method_meta = program->method_meta(method_name);
+  ET_CHECK_MSG(
+      method_meta.ok(),
+      "Failed to get method_meta for %s: 0x%" PRIx32,
+      method_name,
+      static_cast<uint32_t>(method_meta.error()));
+
+  std::vector<uint8_t> method_allocator_pool(FLAGS_method_allocator_bytes);
+  MemoryAllocator method_allocator(
+      method_allocator_pool.size(), method_allocator_pool.data());
+  std::vector<uint8_t> temp_allocator_pool(FLAGS_temp_allocator_bytes);
+  MemoryAllocator temp_allocator(
+      temp_allocator_pool.size(), temp_allocator_pool.data());
+
+  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers;
+  std::vector<Span<uint8_t>> planned_spans;
+  for (size_t id = 0; id < method_meta->num_memory_planned_buffers(); ++id) {
+    size_t buffer_size =
+        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
+    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+  }
+  HierarchicalAllocator planned_memory(
+      {planned_spans.data(), planned_spans.size()});
+  MemoryManager memory_manager(
+      &method_allocator, &planned_memory, &temp_allocator);
+
+  Result<Method> method = program->load_method(method_name, &memory_manager);
+  ET_CHECK_MSG(
+      method.ok(),
+      "Loading of method %s failed with status 0x%" PRIx32,
+      method_name,
+      static_cast<uint32_t>(method.error()));
+  // Measure the method allocator before execution: inputs prepared below are
+  // not allocated from it.
+  const size_t method_allocator_bytes = method_allocator.used_size();
+
+  auto inputs = util::prepare_input_tensors(*method);
+  ET_CHECK_MSG(
+      inputs.ok(),
+      "Could not prepare inputs: 0x%" PRIx32,
+      static_cast<uint32_t>(inputs.error()));
+  Error status = method->execute();
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "Execution of method %s failed with status 0x%" PRIx32,
+      method_name,
+      static_cast<uint32_t>(status));
+
+  Result<MemoryTimeline> timeline =
+      MemoryTimeline::load(file_data.data(), file_data.size(), method_name);
+  ET_CHECK_MSG(
+      timeline.ok(),
+      "Could not compute the memory timeline: 0x%" PRIx32,
+      static_cast<uint32_t>(timeline.error()));
+  status = timeline->record_allocator_usage(*method, method_allocator_bytes);
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "Could not record allocator usage: 0x%" PRIx32,
+      static_cast<uint32_t>(status));
+
+  // Summarize the peak, largest tensors first.
+  const size_t peak = timeline->peak_instruction();
+  for (size_t buffer = 0; buffer < timeline->num_buffers(); ++buffer) {
+    ET_LOG(
+        Info,
+        "Instruction %zu: %zu planned bytes live in buffer %zu",
+        peak,
+        timeline->planned_bytes(buffer, peak),
+        buffer);
+  }
+  std::vector<PlannedTensorLifetime> live;
+  for (const PlannedTensorLifetime& tensor : timeline->tensors()) {
+    if (tensor.first_instruction <= peak && peak <= tensor.last_instruction) {
+      live.push_back(tensor);
+    }
+  }
+  std::sort(
+      live.begin(),
+      live.end(),
+      [](const PlannedTensorLifetime& a, const PlannedTensorLifetime& b) {
+        return a.nbytes > b.nbytes;
+      });
+  for (size_t i = 0;
+       i < live.size() && i < static_cast<size_t>(FLAGS_num_top_tensors);
+       ++i) {
+    ET_LOG(
+        Info,
+        "  value %zu: %zu bytes at offset %zu of buffer %zu, "
+        "live over instructions %zu-%zu",
+        live[i].value_index,
+        live[i].nbytes,
+        live[i].offset,
+        live[i].buffer_index,
+        live[i].first_instruction,
+        live[i].last_instruction);
+  }
+  size_t temp_peak = 0;
+  for (size_t i = 0; i < timeline->num_instructions(); ++i) {
+    temp_peak = std::max(temp_peak, timeline->temp_bytes(i));
+  }
+  ET_LOG(
+      Info,
+      "Method allocator: %zu bytes, temp allocator peak: %zu bytes",
+      method_allocator_bytes,
+      temp_peak);
+
+  FILE* output = fopen(FLAGS_output_path.c_str(), "w");
+  if (output == nullptr) {
+    ET_LOG(Error, "Could not open '%s'", FLAGS_output_path.c_str());
+    return 1;
+  }
+  const std::string json = timeline->to_chrome_trace();
+  const bool written =
+      fwrite(json.data(), 1, json.size(), output) == json.size();
+  fclose(output);
+  if (!written) {
+    ET_LOG(Error, "Could not write '%s'", FLAGS_output_path.c_str());
+    return 1;
+  }
+  ET_LOG(Info, "Wrote %s", FLAGS_output_path.c_str());
+  return 0;
+}
@@ -0,0 +1,28 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Writes the memory timeline of a method as a Chrome trace.
+    runtime.cxx_binary(
+        name = "memory_timeline",
+        srcs = [
+            "memory_timeline.cpp",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/runner_util:inputs",
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/sdk/memory_timeline:memory_timeline",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
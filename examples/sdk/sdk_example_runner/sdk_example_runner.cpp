@@ -17,18 +17,22 @@
  * all fp32 tensors.
  */
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
+#include <vector>
 
 #include <gflags/gflags.h>
 
 #include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/clock.h>
 #include <executorch/runtime/platform/log.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <executorch/sdk/bundled_program/bundled_program.h>
 #include <executorch/sdk/etdump/etdump_flatcc.h>
+#include <executorch/sdk/etdump/op_costs.h>
 #include <executorch/util/util.h>
 
 static uint8_t method_allocator_pool[4 * 1024U * 1024U]; // 4MB
@@ -78,6 +82,36 @@ DEFINE_int32(
     262144, // 256 KB
     "Size of the debug buffer in bytes to allocate for intermediate outputs and program outputs logging.");
 
+DEFINE_bool(
+    perf_counters,
+    false,
+    "Record the hardware performance counters of each event in the etdump file (Linux only).");
+
+DEFINE_bool(
+    op_costs,
+    false,
+    "Record the FLOPs and bytes moved by each call of the common portable ops in the etdump file.");
+
+DEFINE_bool(
+    perf_check,
+    false,
+    "Instead of a single run, time every bundled test case of the method and fail when one is slower or uses more memory than the expectation bundled with it.");
+
+DEFINE_int32(
+    perf_warmup_iterations,
+    1,
+    "Untimed runs of each test case before the timed ones in --perf_check mode.");
+
+DEFINE_int32(
+    perf_iterations,
+    10,
+    "Timed runs of each test case in --perf_check mode. Their median is compared with the expectation.");
+
+DEFINE_double(
+    perf_tolerance,
+    0.1,
+    "Allowed regression in --perf_check mode, as a fraction of the bundled expectation.");
+
 using namespace torch::executor;
 
 std::vector<uint8_t> load_file_or_die(const char* path) {
@@ -92,6 +126,84 @@ std::vector<uint8_t> load_file_or_die(const char* path) {
   return file_data;
 }
 
+/**
+ * Runs every bundled test case of the method, and compares the median time of
+ * its executions and the memory it allocated with the bundled expectation.
+ * Returns the number of test cases that regressed.
+ */
+size_t run_perf_check(
+    Method& method,
+    void* bundled_program,
+    size_t method_allocator_bytes) {
+  Result<size_t> num_test_cases =
+      bundled_program::GetNumBundledTestCases(method, bundled_program);
+  ET_CHECK_MSG(
+      num_test_cases.ok(),
+      "Could not find the bundled test cases: 0x%" PRIx32,
+      static_cast<uint32_t>(num_test_cases.error()));
+
+  size_t num_regressions = 0;
+  std::vector<uint64_t> samples(FLAGS_perf_iterations);
+  for (size_t testset_idx = 0; testset_idx < num_test_cases.get();
+       ++testset_idx) {
+    Error status =
+        bundled_program::LoadBundledInput(method, bundled_program, testset_idx);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "LoadBundledInput failed with status 0x%" PRIx32,
+        static_cast<uint32_t>(status));
+    for (int32_t i = 0; i < FLAGS_perf_warmup_iterations; ++i) {
+      status = method.execute();
+      ET_CHECK_MSG(
+          status == Error::Ok,
+          "Execution failed with status 0x%" PRIx32,
+          static_cast<uint32_t>(status));
+    }
+    for (uint64_t& sample : samples) {
+      const et_timestamp_t start = et_pal_current_ticks();
+      status = method.execute();
+      sample = ticks_to_ns(et_pal_current_ticks() - start);
+      ET_CHECK_MSG(
+          status == Error::Ok,
+          "Execution failed with status 0x%" PRIx32,
+          static_cast<uint32_t>(status));
+    }
+    std::nth_element(
+        samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    const double latency_us = samples[samples.size() / 2] / 1000.0;
+    const size_t memory_bytes =
+        method_allocator_bytes + method.temp_memory_peak_bytes();
+
+    Result<bundled_program::PerfExpectation> expectation =
+        bundled_program::GetBundledPerfExpectation(
+            method, bundled_program, testset_idx);
+    ET_CHECK_MSG(
+        expectation.ok(),
+        "Could not read the bundled perf expectation: 0x%" PRIx32,
+        static_cast<uint32_t>(expectation.error()));
+    ET_LOG(
+        Info,
+        "Test case %zu: %.1f us (expected %.1f us), %zu bytes (expected %zu "
+        "bytes)",
+        testset_idx,
+        latency_us,
+        expectation->latency_us,
+        memory_bytes,
+        expectation->memory_bytes);
+    status = bundled_program::VerifyPerfWithBundledExpectation(
+        method,
+        bundled_program,
+        testset_idx,
+        latency_us,
+        memory_bytes,
+        FLAGS_perf_tolerance);
+    if (status != Error::Ok) {
+      ++num_regressions;
+    }
+  }
+  return num_regressions;
+}
+
 int main(int argc, char** argv) {
   runtime_init();
 
@@ -104,6 +216,10 @@ int main(int argc, char** argv) {
     ET_LOG(Error, "%s", msg.c_str());
     return 1;
   }
+  if (FLAGS_perf_check && FLAGS_perf_iterations <= 0) {
+    ET_LOG(Error, "--perf_iterations must be positive");
+    return 1;
+  }
 
   // Read in the entire file.
   const char* bundled_program_path = FLAGS_bundled_program_path.c_str();
@@ -205,9 +321,10 @@ int main(int argc, char** argv) {
   // the method can mutate the memory-planned buffers, so the method should only
   // be used by a single thread at at time, but it can be reused.
   //
+  // Profiling would skew the timings of a perf check.
   torch::executor::ETDumpGen etdump_gen = torch::executor::ETDumpGen();
-  Result<Method> method =
-      program->load_method(method_name, &memory_manager, &etdump_gen);
+  Result<Method> method = program->load_method(
+      method_name, &memory_manager, FLAGS_perf_check ? nullptr : &etdump_gen);
   ET_CHECK_MSG(
       method.ok(),
       "Loading of method %s failed with status 0x%" PRIx32,
@@ -215,6 +332,17 @@ int main(int argc, char** argv) {
       method.error());
   ET_LOG(Info, "Method loaded.");
 
+  if (FLAGS_perf_check) {
+    const size_t num_regressions = run_perf_check(
+        *method, file_data.data(), method_allocator.used_size());
+    if (num_regressions > 0) {
+      ET_LOG(Error, "%zu test cases regressed.", num_regressions);
+      return 1;
+    }
+    ET_LOG(Info, "No performance regression.");
+    return 0;
+  }
+
   void* debug_buffer = malloc(FLAGS_debug_buffer_size);
   if (FLAGS_dump_intermediate_outputs) {
     Span<uint8_t> buffer((uint8_t*)debug_buffer, FLAGS_debug_buffer_size);
@@ -227,6 +355,18 @@ int main(int argc, char** argv) {
     etdump_gen.set_event_tracer_debug_level(
         EventTracerDebugLogLevel::kProgramOutputs);
   }
+  std::unique_ptr<PerfCounters> perf_counters;
+  if (FLAGS_perf_counters) {
+    perf_counters = std::make_unique<PerfCounters>();
+    etdump_gen.set_perf_counters(perf_counters.get());
+  }
+  if (FLAGS_op_costs) {
+    status = register_default_op_costs();
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "register_default_op_costs() failed with status 0x%" PRIx32,
+        status);
+  }
   // Use the inputs embedded in the bundled program.
   status = torch::executor::bundled_program::LoadBundledInput(
       *method, file_data.data(), FLAGS_testset_idx);
@@ -21,6 +21,7 @@ def define_common_targets():
             "//executorch/extension/data_loader:buffer_data_loader",
             "//executorch/util:util",
             "//executorch/sdk/etdump:etdump_flatcc",
+            "//executorch/sdk/etdump:op_costs",
             "//executorch/sdk/bundled_program:runtime",
         ],
         external_deps = [
@@ -9,7 +9,7 @@
 # 1. Select all ops
 # 2. Select from a list of ops
 # 3. Select from a yaml file
-# 4. (TODO) Select from a serialized model (.pte)
+# 4. Select from a serialized model (.pte), optionally with its dtypes
 set -e
 
 # shellcheck source=/dev/null
@@ -165,6 +165,32 @@ test_cmake_select_ops_in_yaml() {
     rm "./custom_ops_1.pte"
 }
 
+test_cmake_select_ops_from_model_dtypes() {
+    echo "Exporting add_mul"
+    ${PYTHON_EXECUTABLE} -m examples.portable.scripts.export --model_name="add_mul"
+
+    local example_dir=examples/selective_build
+    local build_dir=cmake-out/${example_dir}
+    rm -rf ${build_dir}
+    retry cmake -DBUCK2="$BUCK" \
+            -DCMAKE_BUILD_TYPE=Release \
+            -DEXECUTORCH_SELECT_OPS_FROM_MODEL="$(pwd)/add_mul.pte" \
+            -DEXECUTORCH_DTYPE_SELECTIVE_BUILD=ON \
+            -DCMAKE_INSTALL_PREFIX=cmake-out \
+            -DPYTHON_EXECUTABLE="$PYTHON_EXECUTABLE" \
+            -B${build_dir} \
+            ${example_dir}
+
+    echo "Building ${example_dir}"
+    cmake --build ${build_dir} -j9 --config Release
+
+    echo 'Running selective build test'
+    ${build_dir}/selective_build_test --model_path="./add_mul.pte"
+
+    echo "Removing add_mul.pte"
+    rm "./add_mul.pte"
+}
+
 if [[ -z $BUCK ]];
 then
   BUCK=buck2
@@ -181,6 +207,7 @@ then
     test_cmake_select_all_ops
     test_cmake_select_ops_in_list
     test_cmake_select_ops_in_yaml
+    test_cmake_select_ops_from_model_dtypes
 elif [[ $1 == "buck2" ]];
 then
     test_buck2_select_all_ops
@@ -0,0 +1,173 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""Compression of program segments in the LZ4_BLOCKS format of program.fbs.
+
+A compressed segment is a sequence of blocks, each an 8-byte header followed
+by the data of the block. The header holds the stored size then the
+uncompressed size of the block as little-endian uint32s. A block whose stored
+size equals its uncompressed size is stored as is, any other one in the LZ4
+block format. The runtime loads and decompresses one block at a time, so the
+block size bounds the extra memory that loading needs.
+"""
+
+from typing import Dict, List
+
+# The uncompressed size of each block but the last.
+DEFAULT_BLOCK_SIZE: int = 1 << 20
+
+_BLOCK_HEADER_SIZE = 8
+_MIN_MATCH = 4
+# The LZ4 block format requires the last 5 bytes to be literals, and the last
+# match to start at least 12 bytes before the end.
+_LAST_LITERALS = 5
+_MATCH_FIND_LIMIT = 12
+_MAX_OFFSET = 0xFFFF
+
+
+def _write_length(out: bytearray, length: int) -> None:
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _write_sequence(
+    out: bytearray, literals: bytes, offset: int, match_length: int
+) -> None:
+    literal_length = len(literals)
+    match_code = match_length - _MIN_MATCH if match_length else 0
+    out.append(min(literal_length, 15) << 4 | min(match_code, 15))
+    if literal_length >= 15:
+        _write_length(out, literal_length - 15)
+    out += literals
+    if match_length:
+        out += offset.to_bytes(2, byteorder="little")
+        if match_code >= 15:
+            _write_length(out, match_code - 15)
+
+
+def _compress_lz4_block_python(data: bytes) -> bytes:
+    """A greedy LZ4 block compressor, for when the lz4 package is missing."""
+    size = len(data)
+    out = bytearray()
+    # The last position of each 4-byte sequence.
+    last_positions: Dict[bytes, int] = {}
+    anchor = 0
+    pos = 0
+    while pos < size - _MATCH_FIND_LIMIT:
+        key = data[pos : pos + _MIN_MATCH]
+        candidate = last_positions.get(key)
+        last_positions[key] = pos
+        if candidate is None or pos - candidate > _MAX_OFFSET:
+            pos += 1
+            continue
+        length = _MIN_MATCH
+        max_length = size - _LAST_LITERALS - pos
+        while length < max_length and data[candidate + length] == data[pos + length]:
+            length += 1
+        _write_sequence(out, data[anchor:pos], pos - candidate, length)
+        pos += length
+        anchor = pos
+    _write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def compress_lz4_block(data: bytes) -> bytes:
+    """Returns `data` compressed in the LZ4 block format, without its size."""
+    try:
+        import lz4.block  # pyre-ignore[21]
+
+        return lz4.block.compress(data, store_size=False)
+    except ImportError:
+        return _compress_lz4_block_python(data)
+
+
+def decompress_lz4_block(data: bytes, uncompressed_size: int) -> bytes:
+    """Returns the `uncompressed_size` bytes that an LZ4 block decodes to."""
+    out = bytearray()
+    pos = 0
+
+    def read_length(length: int) -> int:
+        nonlocal pos
+        while True:
+            byte = data[pos]
+            pos += 1
+            length += byte
+            if byte != 255:
+                return length
+
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        literal_length = token >> 4
+        if literal_length == 15:
+            literal_length = read_length(literal_length)
+        out += data[pos : pos + literal_length]
+        pos += literal_length
+        if pos == len(data):
+            break
+        offset = int.from_bytes(data[pos : pos + 2], byteorder="little")
+        pos += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError(f"LZ4 match offset {offset} is out of range")
+        match_length = token & 15
+        if match_length == 15:
+            match_length = read_length(match_length)
+        # The match may overlap the bytes it produces.
+        start = len(out) - offset
+        for i in range(match_length + _MIN_MATCH):
+            out.append(out[start + i])
+    if len(out) != uncompressed_size:
+        raise ValueError(
+            f"LZ4 block decompressed to {len(out)} bytes, not {uncompressed_size}"
+        )
+    return bytes(out)
+
+
+def compress_segment(data: bytes, block_size: int = DEFAULT_BLOCK_SIZE) -> bytes:
+    """Returns `data` as a sequence of LZ4 blocks."""
+    blocks: List[bytes] = []
+    for start in range(0, len(data), block_size):
+        block = data[start : start + block_size]
+        compressed = compress_lz4_block(block)
+        # Blocks that don't compress are stored as is.
+        stored = compressed if len(compressed) < len(block) else block
+        blocks.append(
+            len(stored).to_bytes(4, byteorder="little")
+            + len(block).to_bytes(4, byteorder="little")
+            + stored
+        )
+    return b"".join(blocks)
+
+
+def decompress_segment(data: bytes, uncompressed_size: int) -> bytes:
+    """Returns the data of a segment compressed by compress_segment()."""
+    blocks: List[bytes] = []
+    pos = 0
+    while pos < len(data):
+        if len(data) - pos < _BLOCK_HEADER_SIZE:
+            raise ValueError(f"Truncated block header at {pos}")
+        stored_size = int.from_bytes(data[pos : pos + 4], byteorder="little")
+        block_size = int.from_bytes(data[pos + 4 : pos + 8], byteorder="little")
+        pos += _BLOCK_HEADER_SIZE
+        stored = data[pos : pos + stored_size]
+        if len(stored) != stored_size:
+            raise ValueError(f"Block at {pos} overflows the segment")
+        pos += stored_size
+        blocks.append(
+            stored
+            if stored_size == block_size
+            else decompress_lz4_block(stored, block_size)
+        )
+    result = b"".join(blocks)
+    if len(result) != uncompressed_size:
+        raise ValueError(
+            f"Segment decompressed to {len(result)} bytes, not {uncompressed_size}"
+        )
+    return result
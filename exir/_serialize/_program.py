@@ -11,8 +11,12 @@ import json
 import re
 
 from dataclasses import dataclass
-from typing import ClassVar, List, Literal, Optional, Tuple
+from typing import ClassVar, Dict, List, Literal, Optional, Tuple
 
+from executorch.exir._serialize._compression import (
+    compress_segment,
+    decompress_segment,
+)
 from executorch.exir._serialize._cord import Cord
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 from executorch.exir._serialize._flatbuffer import (
@@ -27,7 +31,9 @@ from executorch.exir.schema import (
     Buffer,
     DataLocation,
     DataSegment,
+    NamedData,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
 )
 from executorch.exir.tensor import ALIGNMENT
@@ -346,16 +352,21 @@ def serialize_pte_binary(
     program: Program,
     *,
     mutable_data: Optional[List[Buffer]] = None,
+    named_data: Optional[Dict[str, bytes]] = None,
     extract_delegate_segments: bool = False,
     extract_constant_segment: bool = False,
     segment_alignment: int = 4096,
     constant_tensor_alignment: Optional[int] = None,
     delegate_alignment: Optional[int] = None,
+    compress_segments: bool = False,
 ) -> Cord:
     """Returns the runtime binary representation of the given Program.
 
     Args:
         program: The Program to serialize.
+        mutable_data: The initial data of mutable tensors, stored in a segment.
+        named_data: Data that delegates refer to by key. Each key's data is
+            stored in a segment of its own, listed in Program.named_data.
         extract_delegate_segments: Whether to move delegate data blobs from the
             Program into separate segments, rather than encoding those blobs
             in the flatbuffer data. When true, will also:
@@ -369,9 +380,18 @@ def serialize_pte_binary(
             segment will be aligned to this value in the output data.
         constant_tensor_alignment: The minimum alignment of tensor
             buffers in the program. Must be a power of 2. Defaults to ALIGNMENT.
+            When extract_constant_segment is true, segment_alignment must be a
+            multiple of it. Setting both to the page size (e.g. 4096 or 16384)
+            lets a runtime that mmaps the file use every constant tensor in
+            place with page alignment.
         delegate_alignment: If provided, the minimum alignment of delegate data
             in the program. Must be a power of 2. If not provided, uses the
             value in the schema file.
+        compress_segments: Whether to store the constant, named and delegate
+            segments LZ4-compressed when that makes them smaller. The runtime
+            must then load the program through a DecompressingDataLoader.
+            Mutable data segments are never compressed, since the runtime
+            loads them piecewise.
     Returns:
         The serialized form of the Program, ready for execution by the runtime.
     """
@@ -386,8 +406,18 @@ def serialize_pte_binary(
 
     # Store extracted segment data; this may be constant data or delegate data.
     segments: List[Cord] = []
+    # Indices of the segments that must not be compressed.
+    uncompressible_segments: List[int] = []
 
     if extract_constant_segment:
+        # Tensor offsets are relative to the segment, so the segment must be at
+        # least as aligned as the tensors for them to be aligned in the file,
+        # and in the memory that maps it.
+        if segment_alignment % constant_tensor_alignment != 0:
+            raise ValueError(
+                f"segment_alignment {segment_alignment} must be a multiple of "
+                + f"constant_tensor_alignment {constant_tensor_alignment}"
+            )
         constant_segment_data, constant_segment_offsets = _extract_constant_segment(
             program.constant_buffer, tensor_alignment=constant_tensor_alignment
         )
@@ -414,8 +444,16 @@ def serialize_pte_binary(
                 ),
             ]
             # Add to the aggregate segments cord.
+            uncompressible_segments.append(len(segments))
             segments.append(mutable_segment_data)
 
+    if named_data is not None:
+        for key, data in named_data.items():
+            program.named_data.append(
+                NamedData(key=key, segment_index=len(segments))
+            )
+            segments.append(Cord(data))
+
     if extract_delegate_segments:
         _extract_delegate_segments(program, segments)
 
@@ -423,17 +461,24 @@ def serialize_pte_binary(
     # each segment begins at the required alignment.
     # Update program.segments with the offsets to each segment.
     segments_data = Cord()
-    for data in segments:
+    for index, data in enumerate(segments):
         prev_end = (
             (program.segments[-1].offset + program.segments[-1].size)
             if program.segments
             else 0
         )
-        program.segments.append(
-            DataSegment(
-                offset=_aligned_size(prev_end, segment_alignment), size=len(data)
-            )
+        segment = DataSegment(
+            offset=_aligned_size(prev_end, segment_alignment), size=len(data)
         )
+        if compress_segments and index not in uncompressible_segments:
+            compressed = compress_segment(bytes(data))
+            # The runtime relies on compressed segments being smaller.
+            if len(compressed) < len(data):
+                segment.compression = SegmentCompression.LZ4_BLOCKS
+                segment.uncompressed_size = len(data)
+                segment.size = len(compressed)
+                data = Cord(compressed)
+        program.segments.append(segment)
         # Add to aggregate segments cord with padding.
         padding_length = _padding_required(len(segments_data), segment_alignment)
         if padding_length > 0:
@@ -528,7 +573,10 @@ def _restore_segments(program: Program, segment_data: bytes) -> Program:
             raise ValueError(
                 f"Segment {i} {segment} overflows data length {len(segment_data)}"
             )
-        segments.append(segment_data[segment.offset : segment.offset + segment.size])
+        data = segment_data[segment.offset : segment.offset + segment.size]
+        if segment.compression == SegmentCompression.LZ4_BLOCKS:
+            data = decompress_segment(data, segment.uncompressed_size)
+        segments.append(data)
 
     # Find and replace the Program's references to these segments, inlining the
     # data.
@@ -0,0 +1,134 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import ctypes
+import ctypes.util
+import random
+import unittest
+from typing import Callable, Optional
+
+from executorch.exir._serialize._compression import (
+    _compress_lz4_block_python,
+    compress_segment,
+    decompress_lz4_block,
+    decompress_segment,
+)
+
+# Blocks produced by LZ4_compress_default() of the reference LZ4 library
+# (version 1.9.4), with the data they decode to.
+_REFERENCE_LZ4_BLOCKS = [
+    (
+        b"The quick brown fox jumps over the lazy dog. " * 4 + b"The end.",
+        bytes.fromhex(
+            "ff1e54686520717569636b2062726f776e20666f78206a756d7073206f766572"
+            "20746865206c617a7920646f672e202d00775020656e642e"
+        ),
+    ),
+    (
+        b"\x00" * 1000 + b"tail!",
+        bytes.fromhex("1f000100ffffffd7507461696c21"),
+    ),
+    (
+        bytes(range(40)) * 3 + b"end of data.",
+        bytes.fromhex(
+            "ff19000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d"
+            "1e1f202122232425262728003dc0656e64206f6620646174612e"
+        ),
+    ),
+    (
+        b"".join(f"row {i % 3}: value {i % 5};".encode() for i in range(12)),
+        bytes.fromhex(
+            "f000726f7720303a2076616c756520303b0f0014310f0011310f0014320f0011"
+            "320f00052d0011330f00052d0011340f00052d00024b00052d00024b00052d00"
+            "024b00052d00024b00052d00024b00052d00024b00b0323a2076616c75652031"
+            "3b"
+        ),
+    ),
+]
+
+
+def _reference_lz4_decompress() -> Optional[Callable[[bytes, int], bytes]]:
+    """Returns the decompressor of the reference LZ4 library, if installed."""
+    try:
+        import lz4.block  # pyre-ignore[21]
+
+        return lambda data, size: lz4.block.decompress(data, uncompressed_size=size)
+    except ImportError:
+        pass
+    path = ctypes.util.find_library("lz4")
+    if path is None:
+        return None
+    lib = ctypes.CDLL(path)
+
+    def decompress(data: bytes, size: int) -> bytes:
+        out = ctypes.create_string_buffer(max(size, 1))
+        result = lib.LZ4_decompress_safe(data, out, len(data), size)
+        if result != size:
+            raise ValueError(f"LZ4_decompress_safe returned {result}")
+        return out.raw[:size]
+
+    return decompress
+
+
+class TestCompression(unittest.TestCase):
+    def test_lz4_block_round_trip(self) -> None:
+        for data in (
+            b"",
+            b"short",
+            b"abcd" * 1000,
+            bytes(range(256)) * 300,
+            random.Random(0).randbytes(5000),
+        ):
+            compressed = _compress_lz4_block_python(data)
+            self.assertEqual(decompress_lz4_block(compressed, len(data)), data)
+
+    def test_decompresses_reference_lz4_blocks(self) -> None:
+        for data, compressed in _REFERENCE_LZ4_BLOCKS:
+            self.assertEqual(decompress_lz4_block(compressed, len(data)), data)
+
+    def test_reference_lz4_decompresses_blocks(self) -> None:
+        reference_decompress = _reference_lz4_decompress()
+        if reference_decompress is None:
+            self.skipTest("The reference LZ4 library is not installed")
+        rng = random.Random(0)
+        datas = [b"", b"short", b"x" * 13, b"abcd" * 1000]
+        datas += [data for data, _ in _REFERENCE_LZ4_BLOCKS]
+        for _ in range(100):
+            alphabet_size = rng.randrange(1, 20)
+            datas.append(
+                bytes(rng.randrange(alphabet_size) for _ in range(rng.randrange(3000)))
+            )
+        for data in datas:
+            compressed = _compress_lz4_block_python(data)
+            self.assertEqual(reference_decompress(compressed, len(data)), data)
+
+    def test_lz4_block_overlapping_match(self) -> None:
+        # One literal then a match of length 9 at offset 1, then 5 literals.
+        compressed = b"\x15a\x01\x00" + b"\x50bcdef"
+        self.assertEqual(decompress_lz4_block(compressed, 15), b"a" * 10 + b"bcdef")
+
+    def test_lz4_block_invalid_offset(self) -> None:
+        with self.assertRaises(ValueError):
+            decompress_lz4_block(b"\x10a\x02\x00\x00", 6)
+
+    def test_segment_round_trip(self) -> None:
+        data = b"".join(bytes([i % 7]) * (i % 50) for i in range(2000))
+        compressed = compress_segment(data, block_size=4096)
+        self.assertLess(len(compressed), len(data))
+        self.assertEqual(decompress_segment(compressed, len(data)), data)
+
+    def test_segment_stores_incompressible_blocks(self) -> None:
+        data = random.Random(0).randbytes(1000)
+        compressed = compress_segment(data, block_size=4096)
+        # The block header says the block is stored as is.
+        self.assertEqual(compressed[:8], (1000).to_bytes(4, "little") * 2)
+        self.assertEqual(compressed[8:], data)
+        self.assertEqual(decompress_segment(compressed, len(data)), data)
+
+    def test_segment_size_mismatch(self) -> None:
+        compressed = compress_segment(b"abcd" * 100)
+        with self.assertRaises(ValueError):
+            decompress_segment(compressed, 401)
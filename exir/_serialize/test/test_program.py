@@ -8,10 +8,12 @@
 import copy
 import difflib
 import json
+import random
 import unittest
 
 from typing import List, Sequence
 
+from executorch.exir._serialize._compression import decompress_segment
 from executorch.exir._serialize._flatbuffer import _program_flatbuffer_to_json
 from executorch.exir._serialize._program import (
     _ExtendedHeader,
@@ -31,7 +33,9 @@ from executorch.exir.schema import (
     DataLocation,
     DataSegment,
     ExecutionPlan,
+    NamedData,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
 )
 from executorch.exir.tests.common import get_test_program
@@ -144,7 +148,9 @@ class TestProgram(unittest.TestCase):
         return eh
 
     def constant_segment_with_tensor_alignment(
-        self, constant_tensor_alignment: int
+        self,
+        constant_tensor_alignment: int,
+        segment_alignment: int = SEGMENT_ALIGNMENT,
     ) -> None:
         """Utility to test constant segment with varying alignment.
         Args:
@@ -168,7 +174,7 @@ class TestProgram(unittest.TestCase):
             serialize_pte_binary(
                 program,
                 extract_constant_segment=True,
-                segment_alignment=SEGMENT_ALIGNMENT,
+                segment_alignment=segment_alignment,
                 constant_tensor_alignment=constant_tensor_alignment,
             )
         )
@@ -222,6 +228,14 @@ class TestProgram(unittest.TestCase):
         # Check constant_buffer is empty, because the data was moved into the segment.
         self.assertEqual(len(program_with_segments.constant_buffer), 0)
 
+        # Every tensor is aligned in the file, not only within the segment.
+        for offset in subsegment_offsets.offsets:
+            self.assertEqual(
+                (eh.segment_base_offset + segment_table[0].offset + offset)
+                % constant_tensor_alignment,
+                0,
+            )
+
         # Check segment data.
         offsets = subsegment_offsets.offsets
         segment_data: bytes = pte_data[eh.segment_base_offset :]
@@ -618,12 +632,109 @@ class TestProgram(unittest.TestCase):
                 segment_alignment=SEGMENT_ALIGNMENT,
             )
 
+    def test_named_data_segments(self) -> None:
+        program = get_test_program()
+        named_data = {
+            "weight_a": self.gen_blob_data(SEGMENT_ALIGNMENT // 2, b"\x10\x11\x01"),
+            "weight_b": self.gen_blob_data(SEGMENT_ALIGNMENT + 1, b"\x20\x22\x02"),
+        }
+
+        pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                named_data=named_data,
+                segment_alignment=SEGMENT_ALIGNMENT,
+            )
+        )
+
+        # The input Program should not be modified.
+        self.assertEqual(program.named_data, [])
+
+        eh = self.get_and_validate_extended_header(pte_data)
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+
+        # Each key's data is in a segment of its own.
+        self.assertEqual(
+            program_with_segments.named_data,
+            [
+                NamedData(key="weight_a", segment_index=0),
+                NamedData(key="weight_b", segment_index=1),
+            ],
+        )
+        segment_table: List[DataSegment] = program_with_segments.segments
+        self.assertEqual(len(segment_table), len(named_data))
+        for entry in program_with_segments.named_data:
+            segment = segment_table[entry.segment_index]
+            start = eh.segment_base_offset + segment.offset
+            self.assertEqual(
+                pte_data[start : start + segment.size], named_data[entry.key]
+            )
+
+    def test_compressed_named_data_segments(self) -> None:
+        program = get_test_program()
+        named_data = {
+            # Repetitive data compresses, random-looking data doesn't.
+            "weight_a": self.gen_blob_data(SEGMENT_ALIGNMENT * 4, b"\x10\x11\x01"),
+            "weight_b": random.Random(0).randbytes(1000),
+        }
+
+        pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                named_data=named_data,
+                segment_alignment=SEGMENT_ALIGNMENT,
+                compress_segments=True,
+            )
+        )
+
+        eh = self.get_and_validate_extended_header(pte_data)
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        segment_a = program_with_segments.segments[0]
+        segment_b = program_with_segments.segments[1]
+
+        # Only the segment that gets smaller is compressed.
+        self.assertEqual(segment_a.compression, SegmentCompression.LZ4_BLOCKS)
+        self.assertEqual(segment_a.uncompressed_size, SEGMENT_ALIGNMENT * 4)
+        self.assertLess(segment_a.size, SEGMENT_ALIGNMENT * 4)
+        self.assertEqual(segment_b.compression, SegmentCompression.NONE)
+        self.assertEqual(segment_b.size, 1000)
+
+        start = eh.segment_base_offset + segment_a.offset
+        self.assertEqual(
+            decompress_segment(
+                pte_data[start : start + segment_a.size], segment_a.uncompressed_size
+            ),
+            named_data["weight_a"],
+        )
+        start = eh.segment_base_offset + segment_b.offset
+        self.assertEqual(
+            pte_data[start : start + segment_b.size], named_data["weight_b"]
+        )
+
     def test_constant_segment_tensor_alignment_16(self) -> None:
         self.constant_segment_with_tensor_alignment(16)
 
     def test_constant_segment_tensor_alignment_128(self) -> None:
         self.constant_segment_with_tensor_alignment(128)
 
+    def test_constant_segment_tensor_alignment_page_size(self) -> None:
+        self.constant_segment_with_tensor_alignment(16384, segment_alignment=16384)
+
+    def test_constant_segment_tensor_alignment_above_segment_alignment_fails(
+        self,
+    ) -> None:
+        program = get_test_program()
+        program.constant_buffer.append(Buffer(storage=b"12345"))
+
+        # Tensors can't be more aligned in the file than their segment.
+        with self.assertRaises(ValueError):
+            serialize_pte_binary(
+                program,
+                extract_constant_segment=True,
+                segment_alignment=4096,
+                constant_tensor_alignment=16384,
+            )
+
     def test_constant_segment_tensor_alignment_non_power_of_2_fails(self) -> None:
         # Create a program with some constant tensor data.
         program = get_test_program()
@@ -713,6 +824,14 @@ class TestProgram(unittest.TestCase):
         # Check constant_buffer is empty, because the data was moved into the segment.
         self.assertEqual(len(program_with_segments.constant_buffer), 0)
 
+        # Every tensor is aligned in the file, not only within the segment.
+        for offset in subsegment_offsets.offsets:
+            self.assertEqual(
+                (eh.segment_base_offset + segment_table[0].offset + offset)
+                % constant_tensor_alignment,
+                0,
+            )
+
         # The first segment should begin at zero; i.e., at the segment base
         # offset.
         self.assertEqual(segment_table[0].offset, 0, f"{segment_table}")
@@ -119,6 +119,7 @@ def _(
                 backend_id=backend_id,
                 processed_bytes=preprocess_result.processed_bytes,
                 compile_specs=compile_specs,
+                named_data=preprocess_result.named_data,
             )
             lowered_module.meta = {
                 "debug_handle_map": preprocess_result.debug_handle_map
@@ -5,7 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 from abc import ABC, abstractmethod
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 
 from typing import Dict, List, Optional, Tuple, Union
 
@@ -24,6 +24,12 @@ class PreprocessResult:
     debug_handle_map: Optional[Union[Dict[int, Tuple[int]], Dict[str, Tuple[int]]]] = (
         None
     )
+    # Data that processed_bytes refers to by key instead of embedding it, such as
+    # weights that the delegates of several methods share. The program stores the
+    # data of each key once, and the runtime backend looks it up by key through
+    # BackendInitContext::get_named_data_map(). Delegates that use the same key
+    # must use the same data.
+    named_data: Dict[str, bytes] = field(default_factory=dict)
 
 
 """
@@ -72,16 +72,25 @@ class ExecutorchBackendConfig:
     extract_constant_segment: bool = True
 
     # When extracting segments, the starting offset of each segment will be
-    # aligned to this value (in bytes). Must be a power of two.
+    # aligned to this value (in bytes). Must be a power of two. Delegate and
+    # named data segments start at this alignment in the file.
     segment_alignment: int = 4096
 
     # If provided, the minimum alignment of tensor buffers in the program. Must
-    # be a power of 2. If not provided, uses the value in the schema file.
+    # be a power of 2. If not provided, uses the value in the schema file. With
+    # extract_constant_segment, segment_alignment must be a multiple of it; set
+    # both to the page size (e.g. 16384) to page-align every constant tensor,
+    # so that an mmap-ing runtime uses them in place without copies.
     constant_tensor_alignment: Optional[int] = None
 
     # If provided, the minimum alignment of delegate data in the program. Must
     # be a power of 2. If not provided, uses the value in the schema file.
     delegate_alignment: Optional[int] = None
+
+    # If set to true, the constant, named and delegate segments are stored
+    # LZ4-compressed when that makes them smaller, and the program must be
+    # loaded through a DecompressingDataLoader (Module does this already).
+    compress_segments: bool = False
     sym_shape_eval_pass: PassType = HintBasedSymShapeEvalPass()
 
     # If set to true, view_copy operations will be converted to lightweight
@@ -47,6 +47,9 @@ class EmitterOutput:
 
     mutable_data: Optional[List[Buffer]]
 
+    # Data that delegates refer to by key, stored in segments at serialization time.
+    named_data: Optional[Dict[str, bytes]] = None
+
 
 def _remove_non_user_outputs(exported_program: ExportedProgram) -> torch.fx.GraphModule:
     gm = exported_program.graph_module
@@ -166,4 +169,5 @@ def emit_program(
             if len(program_state.mutable_buffer) > 1
             else None
         ),
+        named_data=program_state.named_data or None,
     )
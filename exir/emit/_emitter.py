@@ -62,12 +62,14 @@ from executorch.exir.schema import (
     DoubleList,
     EValue,
     ExecutionPlan,
+    ExtraTensorInfo,
     FreeCall,
     Instruction,
     Int,
     IntList,
     JumpFalseCall,
     KernelCall,
+    MemoryPlanBucket,
     MoveCall,
     Null,
     Operator,
@@ -118,6 +120,11 @@ class _ProgramState:
     # Delegate data stored directly in the flatbuffer. Pointed to by BackendDelegateDataReference,
     # and should be copied to Program.backend_delegate_data.
     backend_delegate_data: List[BackendDelegateInlineData] = field(default_factory=list)
+    # Hash of each delegate blob in backend_delegate_data to its index, so that methods
+    # lowered to the same blob share one copy.
+    cached_delegate_data_hash_values: Dict[str, int] = field(default_factory=dict)
+    # Data that delegates of any method refer to by key. Stored once per key.
+    named_data: Dict[str, bytes] = field(default_factory=dict)
 
 
 @dataclass
@@ -1032,13 +1039,31 @@ class _Emitter(torch.fx.Interpreter):
                 f"self.node.meta['spec'] {type(self.node.meta['spec'])} is not supported"
             )
         assert delegate_ret is not None, "Can't have a None delegate_ret"
+        for key, data in lowered_module.named_data.items():
+            existing = self.program_state.named_data.setdefault(key, data)
+            if existing != data:
+                raise InternalError(
+                    self._emit_node_specific_error(
+                        self.node,
+                        f"Delegates use the named data key {key} for different data",
+                    )
+                )
+
         if delegate_index is None:
-            # Allocate an entry for the data. TODO(T150113674): Reuse any duplicate entries if
-            # present.
-            data_index: int = len(self.program_state.backend_delegate_data)
-            self.program_state.backend_delegate_data.append(
-                BackendDelegateInlineData(data=processed_bytes)
+            # Allocate an entry for the data, unless another method already uses the
+            # same blob.
+            hashed = hashlib.sha256(processed_bytes).hexdigest()
+            data_index = self.program_state.cached_delegate_data_hash_values.get(
+                hashed
             )
+            if data_index is None:
+                data_index = len(self.program_state.backend_delegate_data)
+                self.program_state.backend_delegate_data.append(
+                    BackendDelegateInlineData(data=processed_bytes)
+                )
+                self.program_state.cached_delegate_data_hash_values[hashed] = (
+                    data_index
+                )
 
             backend_delegate = BackendDelegate(
                 id=lowered_module.backend_id,
@@ -1525,6 +1550,7 @@ class _TopLevelEmitter(_Emitter):
         """
         spec = self.node.meta["spec"]
         is_user_input = True
+        fqn = None
 
         if isinstance(target, str) and isinstance(spec, TensorSpec):
 
@@ -1571,6 +1597,10 @@ class _TopLevelEmitter(_Emitter):
             if isinstance(spec, TensorSpec)
             else self._constant_to_evalue(spec, None)
         )
+        # Name constants so that loaders can find them at runtime, e.g. to
+        # serve them from an external weights file.
+        if isinstance(spec, TensorSpec) and spec.const and fqn is not None:
+            evalue.val.extra_tensor_info = ExtraTensorInfo(fully_qualified_name=fqn)
         value = self._emit_evalue(evalue)
 
         # Only user inputs should remain as inputs.
@@ -1624,4 +1654,27 @@ class _TopLevelEmitter(_Emitter):
                 List[int], self.module.meta["non_const_buffer_sizes"]
             ),
             container_meta_type=self.container_meta_type,
+            memory_plan_buckets=self._emit_memory_plan_buckets(),
+        )
+
+    def _emit_memory_plan_buckets(self) -> List[MemoryPlanBucket]:
+        """Returns the shape buckets planned by the memory planning pass, if any."""
+        buckets = self.module.meta.get("memory_plan_buckets", [])
+        if not buckets:
+            return []
+        relocated = sorted(
+            (value_id, spec)
+            for spec, value_id in self.emitter_state.spec2id_dict.items()
+            if spec.bucket_mem_offsets is not None
         )
+        return [
+            MemoryPlanBucket(
+                input_sizes=bucket["input_sizes"],
+                value_indices=[value_id for value_id, _ in relocated],
+                allocations=[
+                    make_allocation_info(spec.mem_id, spec.bucket_mem_offsets[i])
+                    for _, spec in relocated
+                ],
+            )
+            for i, bucket in enumerate(buckets)
+        ]
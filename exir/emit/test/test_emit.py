@@ -1538,6 +1538,27 @@ class TestEmit(unittest.TestCase):
         self.assertEqual(len(program.constant_buffer), 2)
         self.assertEqual(len(program.constant_buffer[1].storage), 24)
 
+    def test_constants_record_fully_qualified_names(self) -> None:
+        class Linear(nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.linear = nn.Linear(4, 2)
+
+            def forward(self, x):
+                return self.linear(x)
+
+        program = to_edge(export(Linear(), (torch.ones(1, 4),))).to_executorch()
+        exec_plan = program._emitter_output.program.execution_plan[0]
+
+        names = {
+            value.val.extra_tensor_info.fully_qualified_name
+            for value in exec_plan.values
+            if isinstance(value.val, Tensor) and value.val.data_buffer_idx > 0
+        }
+        self.assertEqual(names, {"linear.weight", "linear.bias"})
+        # Inputs are not constants and are not named.
+        self.assertIsNone(exec_plan.values[exec_plan.inputs[0]].val.extra_tensor_info)
+
     def test_mutable_buffers(self) -> None:
         def count_copies(gm: torch.fx.GraphModule) -> int:
             return sum(
@@ -57,6 +57,7 @@ class LoweredBackendModule(torch.nn.Module):
 
     _backend_id: str  # The backend's name
     _processed_bytes: bytes  # The delegate blobs created from backend.preprocess
+    _named_data: Dict[str, bytes]  # Data the delegate blob refers to by key
     _compile_specs: List[
         CompileSpec
     ]  # A list of backend-specific objects with static metadata to configure the "compilation" process.
@@ -68,12 +69,14 @@ class LoweredBackendModule(torch.nn.Module):
         backend_id: str,
         processed_bytes: bytes,
         compile_specs: List[CompileSpec],
+        named_data: Optional[Dict[str, bytes]] = None,
     ) -> None:
         super().__init__()
         self._original_exported_program = edge_program
         self._backend_id = backend_id
         self._processed_bytes = processed_bytes
         self._compile_specs = compile_specs
+        self._named_data = named_data if named_data is not None else {}
 
     # pyre-ignore
     def __deepcopy__(self, memo: Optional[Dict[int, Any]]) -> "LoweredBackendModule":
@@ -100,6 +103,7 @@ class LoweredBackendModule(torch.nn.Module):
             backend_id=self._backend_id,
             processed_bytes=self._processed_bytes,
             compile_specs=copy.deepcopy(self._compile_specs, memo),
+            named_data=self._named_data,
         )
         res.meta = copy.copy(getattr(self, "meta", {}))
         return res
@@ -118,6 +122,13 @@ class LoweredBackendModule(torch.nn.Module):
         """
         return self._processed_bytes
 
+    @property
+    def named_data(self) -> Dict[str, bytes]:
+        """
+        Returns the data that the delegate blob refers to by key
+        """
+        return self._named_data
+
     @property
     def compile_specs(self) -> List[CompileSpec]:
         """
@@ -148,6 +159,7 @@ class LoweredBackendModule(torch.nn.Module):
         out = bytes(
             _serialize_pte_binary(
                 program=self.program(memory_planning=memory_planning),
+                named_data=self._named_data or None,
                 extract_delegate_segments=extract_delegate_segments,
                 segment_alignment=segment_alignment,
                 constant_tensor_alignment=constant_tensor_alignment,
@@ -12,7 +12,18 @@ import operator
 import typing
 from collections import defaultdict
 from dataclasses import dataclass
-from typing import Any, Callable, Dict, Iterable, List, Optional, Set, Tuple, Union
+from typing import (
+    Any,
+    Callable,
+    Dict,
+    Iterable,
+    List,
+    Optional,
+    Sequence,
+    Set,
+    Tuple,
+    Union,
+)
 
 import torch
 from executorch.exir import memory
@@ -26,12 +37,18 @@ from executorch.exir.error import (
 )
 from executorch.exir.operator.convert import is_inplace_variant, is_out_variant
 from executorch.exir.schema import TensorShapeDynamism
-from executorch.exir.tensor import TensorSpec
+from executorch.exir.tensor import (
+    calculate_aligned_num_bytes,
+    num_bytes_from_shape_and_dtype,
+    TensorSpec,
+)
 
 from torch import fx
+from torch._subclasses.fake_tensor import FakeTensor
 from torch.export.exported_program import ExportGraphSignature
 from torch.fx import Node
 from torch.utils._pytree import tree_flatten
+from torch.utils._sympy.value_ranges import bound_sympy, ValueRanges
 
 REGISTERED_ALGOS: Dict[str, Callable[..., List[int]]] = {}
 
@@ -500,35 +517,42 @@ def materialize_buffer(
     return total_size
 
 
-def _size_abs_dif(sobj: SharedObject, spec: TensorSpec) -> int:
+def _size_abs_dif(
+    sobj: SharedObject, spec: TensorSpec, nbytes: Optional[int] = None
+) -> int:
     r"""
     Calculate the absolute different between the size of a shared object and
-    a tensor.
+    a tensor, which takes nbytes if given instead of its allocated memory.
     """
-    return abs(sobj.size - spec.allocated_memory)
+    return abs(sobj.size - (spec.allocated_memory if nbytes is None else nbytes))
 
 
 def pick_shared_obj(
-    shared_objects: List[SharedObject], spec: TensorSpec
+    shared_objects: List[SharedObject],
+    spec: TensorSpec,
+    nbytes: Optional[int] = None,
 ) -> SharedObject:
     r"""
     Pick the available shared object with closest size to the tensor.
     If there are no available shared object left, create a new one.
+
+    nbytes overrides the number of bytes the tensor needs, which is its
+    allocated memory by default.
     """
+    if nbytes is None:
+        nbytes = spec.allocated_memory
     # TODO: do better than linear scan
     picked = None
     for sobj in shared_objects:
         if spec.lifetime[0] > sobj.last_used_index:
-            if picked is None or _size_abs_dif(sobj, spec) < _size_abs_dif(
-                picked, spec
+            if picked is None or _size_abs_dif(sobj, spec, nbytes) < _size_abs_dif(
+                picked, spec, nbytes
             ):
                 picked = sobj
                 sobj.last_used_index = spec.lifetime[1]
-                sobj.size = max(sobj.size, spec.allocated_memory)
+                sobj.size = max(sobj.size, nbytes)
     if picked is None:
-        picked = SharedObject(
-            len(shared_objects), -1, spec.allocated_memory, spec.lifetime[1]
-        )
+        picked = SharedObject(len(shared_objects), -1, nbytes, spec.lifetime[1])
         shared_objects.append(picked)
 
     return picked
@@ -808,3 +832,165 @@ def apply_algo(
     graph_module.meta.update({"non_const_buffer_sizes": bufsizes})
 
     return bufsizes
+
+
+def _bucket_nbytes(
+    spec: TensorSpec,
+    val: Optional[torch.Tensor],
+    ranges: Dict[Any, Any],
+) -> int:
+    r"""
+    Return the number of bytes the tensor of spec needs when the symbols of its
+    symbolic shape in val take values in ranges, never more than its upper
+    bound.
+    """
+    from torch.utils._sympy.numbers import int_oo
+
+    if val is None or len(val.shape) != len(spec.shape):
+        return spec.allocated_memory
+    shape = []
+    for dim, upper_bound in zip(val.shape, spec.shape):
+        if isinstance(dim, torch.SymInt):
+            bound = bound_sympy(dim.node.expr, ranges).upper
+            if bound is int_oo or not bound.is_number:
+                shape.append(upper_bound)
+            else:
+                shape.append(min(int(bound), upper_bound))
+        else:
+            shape.append(int(dim))
+    nbytes = num_bytes_from_shape_and_dtype(torch.Size(shape), spec.dtype)
+    return calculate_aligned_num_bytes(nbytes, spec.alignment)
+
+
+def plan_shape_buckets(  # noqa: C901
+    graph_module: torch.fx.GraphModule,
+    shape_buckets: Sequence[Sequence[Sequence[int]]],
+    graph_signature: Optional[ExportGraphSignature] = None,
+    alloc_graph_output: bool = True,
+) -> List[Dict[str, List[int]]]:
+    r"""
+    Plan the memory of graph_module once more for each shape bucket, so that the
+    runtime can pack the tensors of a method more tightly when its inputs are
+    smaller than their upper bounds.
+
+    A shape bucket lists the largest shape of each user input tensor, in input
+    order. Within a bucket, each planned tensor needs the bytes of its symbolic
+    shape bounded by the bucket, and is placed by the greedy algorithm after the
+    graph inputs and mutable buffers, which keep their default offsets so that
+    the runtime never has to move their data. The bucket offsets of a tensor are
+    stored in spec.bucket_mem_offsets.
+
+    Must run after apply_algo(). Updates graph_module.meta["non_const_buffer_sizes"]
+    so that every buffer also holds the tensors of every bucket at their upper
+    bounds, and returns one dict per bucket with its flattened "input_sizes" and
+    the "non_const_buffer_sizes" it uses.
+    """
+    if not shape_buckets:
+        return []
+    internal_assert(
+        not any(
+            itertools.chain(
+                get_cond_nodes(graph_module),
+                get_while_nodes(graph_module),
+                get_map_nodes(graph_module),
+            )
+        ),
+        "Shape buckets are not supported for graphs with control flow",
+    )
+    user_inputs = (
+        set(graph_signature.user_inputs) if graph_signature is not None else None
+    )
+    input_nodes = [
+        node
+        for node in graph_module.graph.nodes
+        if node.op == "placeholder"
+        and (user_inputs is None or node.name in user_inputs)
+        and isinstance(node.meta.get("val"), torch.Tensor)
+    ]
+
+    spec_to_val: Dict[TensorSpec, torch.Tensor] = {}
+    shape_env = None
+    for node in graph_module.graph.nodes:
+        specs = tree_flatten(node.meta.get("spec"))[0]
+        vals = tree_flatten(node.meta.get("val"))[0]
+        if len(specs) != len(vals):
+            continue
+        for spec, val in zip(specs, vals):
+            if isinstance(spec, TensorSpec) and isinstance(val, torch.Tensor):
+                spec_to_val.setdefault(spec, val)
+                if shape_env is None and isinstance(val, FakeTensor):
+                    shape_env = val.fake_mode.shape_env
+    internal_assert(
+        shape_env is not None, "Shape buckets need a graph traced with fake tensors"
+    )
+
+    pinned_specs: Set[TensorSpec] = set()
+    for node in graph_module.graph.nodes:
+        if node.op == "placeholder":
+            pinned_specs.update(get_node_tensor_specs(node))
+    bucket_specs = [
+        spec
+        for spec in collect_specs_from_nodes(
+            graph_module.graph.nodes,
+            graph_signature,
+            ignore_graph_output=not alloc_graph_output,
+            do_assertion=False,
+        )
+        if spec not in pinned_specs
+        and spec.mem_id is not None
+        and spec.mem_offset is not None
+    ]
+    # Buckets place their tensors after the pinned ones.
+    bufsizes = list(graph_module.meta["non_const_buffer_sizes"])
+    base_sizes = [0] * len(bufsizes)
+    for spec in pinned_specs:
+        if spec.mem_id is not None and spec.mem_offset is not None:
+            base_sizes[spec.mem_id] = max(
+                base_sizes[spec.mem_id], spec.mem_offset + spec.allocated_memory
+            )
+    for spec in bucket_specs:
+        spec.bucket_mem_offsets = []
+
+    buckets = []
+    for shapes in shape_buckets:
+        internal_assert(
+            len(shapes) == len(input_nodes),
+            f"Shape bucket {shapes} has {len(shapes)} shapes for {len(input_nodes)} input tensors",
+        )
+        ranges = dict(shape_env.var_to_range)
+        input_sizes = []
+        for node, shape in zip(input_nodes, shapes):
+            val = node.meta["val"]
+            internal_assert(
+                len(shape) == len(val.shape),
+                f"Shape bucket {shapes} does not match the rank of input {node.name}",
+            )
+            for dim, size in zip(val.shape, shape):
+                input_sizes.append(int(size))
+                if isinstance(dim, torch.SymInt) and dim.node.expr in ranges:
+                    symbol = dim.node.expr
+                    ranges[symbol] = ValueRanges(
+                        ranges[symbol].lower, min(ranges[symbol].upper, int(size))
+                    )
+
+        shared_objects = defaultdict(list)
+        spec2obj = {}
+        for spec in bucket_specs:
+            nbytes = _bucket_nbytes(spec, spec_to_val.get(spec), ranges)
+            spec2obj[spec] = pick_shared_obj(shared_objects[spec.mem_id], spec, nbytes)
+        sizes = list(base_sizes)
+        for mem_id in shared_objects:
+            sizes[mem_id] = materialize_buffer(
+                shared_objects[mem_id], base_sizes[mem_id]
+            )
+        for spec, sobj in spec2obj.items():
+            spec.bucket_mem_offsets.append(sobj.offset)
+            # The runtime validates bucket offsets against upper bound sizes.
+            bufsizes[spec.mem_id] = max(
+                bufsizes[spec.mem_id], sobj.offset + spec.allocated_memory
+            )
+        buckets.append({"input_sizes": input_sizes, "non_const_buffer_sizes": sizes})
+        logging.debug(f"shape bucket {shapes} needs bufsizes: {sizes}")
+
+    graph_module.meta.update({"non_const_buffer_sizes": bufsizes})
+    return buckets
@@ -308,6 +308,68 @@ quantized_decomposed_lib.define(
     "mixed_linear(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, ScalarType? dtype=None) -> Tensor",
 )
 
+quantized_decomposed_lib.define(
+    "dynamic_linear(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "Tensor? bias, int group_size) -> Tensor",
+)
+
+quantized_decomposed_lib.define(
+    "dynamic_linear.out(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "Tensor? bias, int group_size, *, Tensor(a!) out) -> Tensor(a!)",
+)
+
+
+@impl(quantized_decomposed_lib, "dynamic_linear", "CompositeExplicitAutograd")
+def dynamic_linear(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    bias: Optional[torch.Tensor],
+    group_size: int,
+) -> torch.Tensor:
+    """Linear with the input quantized per token to int8 on the fly and an int8
+    weight quantized per channel group, as in the 8-bit dynamic activation,
+    grouped weight quantization scheme."""
+    scales, zero_points = (
+        torch.ops.quantized_decomposed.choose_qparams_per_token_asymmetric.default(
+            input, torch.int8
+        )
+    )
+    input = torch.ops.quantized_decomposed.quantize_per_token.default(
+        input, scales, zero_points, -128, 127, torch.int8
+    )
+    input = torch.ops.quantized_decomposed.dequantize_per_token.default(
+        input, scales, zero_points, -128, 127, torch.int8, torch.float32
+    )
+    weight = torch.ops.quantized_decomposed.dequantize_per_channel_group.default(
+        weight,
+        weight_scales,
+        weight_zero_points,
+        -128,
+        127,
+        torch.int8,
+        group_size,
+        torch.float32,
+    )
+    return torch.nn.functional.linear(input, weight, bias)
+
+
+@register_fake("quantized_decomposed::dynamic_linear.out")
+def dynamic_linear_out_meta(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    bias: Optional[torch.Tensor],
+    group_size: int,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    return dynamic_linear(
+        input, weight, weight_scales, weight_zero_points, bias, group_size
+    )
+
+
 quantized_decomposed_lib.define(
     "add(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
 )
@@ -320,6 +382,14 @@ quantized_decomposed_lib.define(
     "add_relu(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
 )
 
+quantized_decomposed_lib.define(
+    "mul(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
+)
+
+quantized_decomposed_lib.define(
+    "relu(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
+)
+
 
 def _trace_and_lower_to_edge_ops(f: Callable) -> fx.GraphModule:
     gm = fx.symbolic_trace(f)
@@ -0,0 +1,68 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import operator
+
+import executorch.exir.passes.fused_pool_ops_registry  # noqa: F401
+from executorch.exir.dialects._ops import ops as exir_ops
+from executorch.exir.pass_base import ExportPass
+from torch.fx import GraphModule, Node
+from torch.fx.passes.infra.pass_base import PassResult
+
+
+def _only_values_used(node: Node) -> bool:
+    return all(
+        user.op == "call_function"
+        and user.target == operator.getitem
+        and user.args[1] == 0
+        for user in node.users
+    )
+
+
+class DropUnusedMaxPoolIndicesPass(ExportPass):
+    """
+    Replaces max_pool2d_with_indices calls whose indices output is never read,
+    which is how torch.nn.MaxPool2d and F.max_pool2d export, with
+    fused_ops::max_pool2d. Its kernels skip tracking which tap holds each max
+    and do not write an int64 indices tensor, so the program neither plans nor
+    fills memory that nothing reads.
+
+    Run it on the edge program before to_executorch(), e.g.
+    `edge.transform([DropUnusedMaxPoolIndicesPass()])`. The runtime needs the
+    portable or optimized max_pool2d kernel registered.
+    """
+
+    def call(self, graph_module: GraphModule) -> PassResult:
+        modified = False
+        for node in list(graph_module.graph.nodes):
+            if (
+                node.op != "call_function"
+                or node.target
+                != exir_ops.edge.aten.max_pool2d_with_indices.default
+                or not _only_values_used(node)
+            ):
+                continue
+            with graph_module.graph.inserting_before(node):
+                pooled = graph_module.graph.call_function(
+                    exir_ops.edge.fused_ops.max_pool2d.default,
+                    node.args,
+                    node.kwargs,
+                )
+            pooled.meta = node.meta.copy()
+            if "val" in node.meta:
+                pooled.meta["val"] = node.meta["val"][0]
+            for user in list(node.users):
+                user.replace_all_uses_with(pooled)
+                graph_module.graph.erase_node(user)
+            graph_module.graph.erase_node(node)
+            modified = True
+
+        if modified:
+            graph_module.graph.lint()
+            graph_module.recompile()
+        return PassResult(graph_module, modified)
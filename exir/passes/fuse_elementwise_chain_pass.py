@@ -0,0 +1,195 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+from typing import Dict, List, Optional, Tuple
+
+import torch
+from executorch.exir.dialects._ops import ops as exir_ops
+from executorch.exir.pass_base import ExportPass
+from executorch.exir.passes.fused_elementwise_ops_registry import (
+    BINARY_OPS,
+    ElementwiseChainOp,
+    MAX_INPUTS,
+    MAX_STEPS,
+)
+from torch.fx import GraphModule, Node
+from torch.fx.passes.infra.pass_base import PassResult
+
+_TENSOR_OPS: Dict[torch._ops.OpOverload, ElementwiseChainOp] = {
+    exir_ops.edge.aten.add.Tensor: ElementwiseChainOp.ADD,
+    exir_ops.edge.aten.sub.Tensor: ElementwiseChainOp.SUB,
+    exir_ops.edge.aten.mul.Tensor: ElementwiseChainOp.MUL,
+    exir_ops.edge.aten.div.Tensor: ElementwiseChainOp.DIV,
+    exir_ops.edge.aten.neg.default: ElementwiseChainOp.NEG,
+    exir_ops.edge.aten.relu.default: ElementwiseChainOp.RELU,
+    exir_ops.edge.aten.sigmoid.default: ElementwiseChainOp.SIGMOID,
+    exir_ops.edge.aten.tanh.default: ElementwiseChainOp.TANH,
+    exir_ops.edge.aten.exp.default: ElementwiseChainOp.EXP,
+}
+
+# Ops whose second operand may be a Python number instead of a tensor, and the
+# step that runs them then.
+_SCALAR_OPS: Dict[torch._ops.OpOverload, ElementwiseChainOp] = {
+    exir_ops.edge.aten.add.Tensor: ElementwiseChainOp.ADD_SCALAR,
+    exir_ops.edge.aten.add.Scalar: ElementwiseChainOp.ADD_SCALAR,
+    exir_ops.edge.aten.sub.Tensor: ElementwiseChainOp.ADD_SCALAR,
+    exir_ops.edge.aten.sub.Scalar: ElementwiseChainOp.ADD_SCALAR,
+    exir_ops.edge.aten.mul.Tensor: ElementwiseChainOp.MUL_SCALAR,
+    exir_ops.edge.aten.mul.Scalar: ElementwiseChainOp.MUL_SCALAR,
+}
+
+_FLOAT_DTYPES = (torch.float32, torch.float64)
+
+
+def _scalar_operand(node: Node) -> Optional[float]:
+    """
+    The number that `node` adds or multiplies by, negated for sub, or None if
+    both operands are tensors.
+    """
+    if node.target not in _SCALAR_OPS or len(node.args) < 2:
+        return None
+    other = node.args[1]
+    if isinstance(other, bool) or not isinstance(other, (int, float)):
+        return None
+    if node.target in (
+        exir_ops.edge.aten.sub.Tensor,
+        exir_ops.edge.aten.sub.Scalar,
+    ):
+        return -float(other)
+    return float(other)
+
+
+def _tensor_args(node: Node) -> List[Node]:
+    if _scalar_operand(node) is not None:
+        return [node.args[0]]
+    return list(node.args)
+
+
+def _is_fusible(node: Node) -> bool:
+    """
+    Whether `node` is an elementwise op that elementwise_chain can run: every
+    tensor operand has the shape, dtype and strides of the float result, so
+    nothing broadcasts or changes dtype.
+    """
+    if node.op != "call_function":
+        return False
+    if _scalar_operand(node) is None and node.target not in _TENSOR_OPS:
+        return False
+    if node.kwargs.get("alpha", 1) != 1:
+        return False
+    val = node.meta.get("val")
+    if not isinstance(val, torch.Tensor) or val.dtype not in _FLOAT_DTYPES:
+        return False
+    for arg in _tensor_args(node):
+        if not isinstance(arg, Node):
+            return False
+        arg_val = arg.meta.get("val")
+        if (
+            not isinstance(arg_val, torch.Tensor)
+            or arg_val.dtype != val.dtype
+            or arg_val.shape != val.shape
+            or arg_val.stride() != val.stride()
+        ):
+            return False
+    return True
+
+
+def _count_inputs(group: List[Node]) -> int:
+    members = set(group)
+    inputs = {arg for node in group for arg in _tensor_args(node)}
+    return len(inputs - members)
+
+
+def _build_program(
+    group: List[Node],
+) -> Tuple[List[Node], List[int], List[float]]:
+    members = set(group)
+    inputs: List[Node] = []
+    for node in group:
+        for arg in _tensor_args(node):
+            if arg not in members and arg not in inputs:
+                inputs.append(arg)
+
+    registers: Dict[Node, int] = {arg: i for i, arg in enumerate(inputs)}
+    program: List[int] = []
+    scalars: List[float] = []
+    for node in group:
+        args = _tensor_args(node)
+        scalar = _scalar_operand(node)
+        if scalar is not None:
+            operand = len(scalars)
+            scalars.append(scalar)
+            opcode = _SCALAR_OPS[node.target]
+        else:
+            opcode = _TENSOR_OPS[node.target]
+            operand = registers[args[1]] if opcode in BINARY_OPS else -1
+        program += [int(opcode), registers[args[0]], operand]
+        registers[node] = len(registers)
+    return inputs, program, scalars
+
+
+class FuseElementwiseChainPass(ExportPass):
+    """
+    Replaces chains of elementwise edge ops over same-shaped float tensors,
+    e.g. mul -> add -> sigmoid -> mul, with one
+    fused_ops::elementwise_chain call. The fused kernel runs the whole chain
+    block by block and keeps the intermediates in registers, so only the
+    chain's inputs are read and only its result is written, instead of one
+    planned tensor per op.
+
+    An op joins the chain of each operand that it is the only user of, so the
+    fused intermediates are never visible outside the chain. Chains are
+    capped at MAX_STEPS ops and MAX_INPUTS distinct inputs.
+
+    Run it on the edge program before to_executorch(), e.g.
+    `edge.transform([FuseElementwiseChainPass()])`. The runtime needs the
+    portable elementwise_chain kernel registered.
+    """
+
+    def __init__(self, min_chain_length: int = 2) -> None:
+        super().__init__()
+        self.min_chain_length = min_chain_length
+
+    def call(self, graph_module: GraphModule) -> PassResult:
+        # The chain each node belongs to, keyed by the chain's last node.
+        chains: Dict[Node, List[Node]] = {}
+        for node in graph_module.graph.nodes:
+            if not _is_fusible(node):
+                continue
+            chain: List[Node] = []
+            for arg in dict.fromkeys(_tensor_args(node)):
+                producer: Optional[List[Node]] = chains.get(arg)
+                if producer is None or len(arg.users) != 1:
+                    continue
+                merged = chain + producer + [node]
+                if len(merged) > MAX_STEPS or _count_inputs(merged) > MAX_INPUTS:
+                    continue
+                chain += producer
+                del chains[arg]
+            chains[node] = chain + [node]
+
+        modified = False
+        for last, chain in chains.items():
+            if len(chain) < self.min_chain_length:
+                continue
+            inputs, program, scalars = _build_program(chain)
+            with graph_module.graph.inserting_before(last):
+                fused = graph_module.graph.call_function(
+                    exir_ops.edge.fused_ops.elementwise_chain.default,
+                    (inputs, program, scalars),
+                )
+            fused.meta = last.meta.copy()
+            last.replace_all_uses_with(fused)
+            for node in reversed(chain):
+                graph_module.graph.erase_node(node)
+            modified = True
+
+        if modified:
+            graph_module.graph.lint()
+            graph_module.recompile()
+        return PassResult(graph_module, modified)
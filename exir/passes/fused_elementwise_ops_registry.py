@@ -0,0 +1,114 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from enum import IntEnum
+from typing import List, Sequence
+
+import torch
+
+from torch.library import impl, Library
+
+lib = Library("fused_ops", "DEF")
+
+# Runs a chain of elementwise ops over same-shaped tensors as one kernel; see
+# FuseElementwiseChainPass for how calls are built and
+# kernels/portable/cpu/op_elementwise_chain.cpp for the runtime kernel.
+lib.define(
+    "elementwise_chain(Tensor[] inputs, int[] program, float[] scalars) -> Tensor"
+)
+
+lib.define(
+    "elementwise_chain.out(Tensor[] inputs, int[] program, float[] scalars, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+
+class ElementwiseChainOp(IntEnum):
+    """
+    The opcodes of an elementwise_chain program. They are serialized into
+    programs, so only append; keep in sync with ChainOp in
+    kernels/portable/cpu/op_elementwise_chain.cpp.
+    """
+
+    ADD = 0
+    SUB = 1
+    MUL = 2
+    DIV = 3
+    ADD_SCALAR = 4
+    MUL_SCALAR = 5
+    NEG = 6
+    RELU = 7
+    SIGMOID = 8
+    TANH = 9
+    EXP = 10
+
+
+# Each step is (opcode, register, register or scalar index).
+STEP_SIZE = 3
+MAX_STEPS = 16
+MAX_INPUTS = 16
+
+BINARY_OPS = (
+    ElementwiseChainOp.ADD,
+    ElementwiseChainOp.SUB,
+    ElementwiseChainOp.MUL,
+    ElementwiseChainOp.DIV,
+)
+SCALAR_OPS = (ElementwiseChainOp.ADD_SCALAR, ElementwiseChainOp.MUL_SCALAR)
+
+
+def _run_elementwise_chain(
+    inputs: Sequence[torch.Tensor], program: Sequence[int], scalars: Sequence[float]
+) -> torch.Tensor:
+    registers: List[torch.Tensor] = list(inputs)
+    for i in range(0, len(program), STEP_SIZE):
+        op = ElementwiseChainOp(program[i])
+        a = registers[program[i + 1]]
+        operand = program[i + 2]
+        if op == ElementwiseChainOp.ADD:
+            result = a + registers[operand]
+        elif op == ElementwiseChainOp.SUB:
+            result = a - registers[operand]
+        elif op == ElementwiseChainOp.MUL:
+            result = a * registers[operand]
+        elif op == ElementwiseChainOp.DIV:
+            result = a / registers[operand]
+        elif op == ElementwiseChainOp.ADD_SCALAR:
+            result = a + scalars[operand]
+        elif op == ElementwiseChainOp.MUL_SCALAR:
+            result = a * scalars[operand]
+        elif op == ElementwiseChainOp.NEG:
+            result = -a
+        elif op == ElementwiseChainOp.RELU:
+            result = torch.relu(a)
+        elif op == ElementwiseChainOp.SIGMOID:
+            result = torch.sigmoid(a)
+        elif op == ElementwiseChainOp.TANH:
+            result = torch.tanh(a)
+        else:
+            result = torch.exp(a)
+        registers.append(result)
+    return registers[-1]
+
+
+@impl(lib, "elementwise_chain", "CompositeExplicitAutograd")
+def elementwise_chain_impl(
+    inputs: List[torch.Tensor], program: List[int], scalars: List[float]
+) -> torch.Tensor:
+    return _run_elementwise_chain(inputs, program, scalars)
+
+
+@impl(lib, "elementwise_chain.out", "CompositeExplicitAutograd")
+def elementwise_chain_out_impl(
+    inputs: List[torch.Tensor],
+    program: List[int],
+    scalars: List[float],
+    *,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    result = _run_elementwise_chain(inputs, program, scalars)
+    out.resize_(result.shape)
+    out.copy_(result)
+    return out
@@ -0,0 +1,56 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import List
+
+import torch
+
+from torch.library import impl, Library
+
+# fused_ops is defined by fused_elementwise_ops_registry; this adds to it.
+lib = Library("fused_ops", "FRAGMENT")
+
+# max_pool2d_with_indices without the indices output; see
+# DropUnusedMaxPoolIndicesPass for when it is used and
+# kernels/portable/cpu/op_max_pool2d.cpp for the runtime kernel.
+lib.define(
+    "max_pool2d(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, int[2] dilation=1, bool ceil_mode=False) -> Tensor"
+)
+
+lib.define(
+    "max_pool2d.out(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, int[2] dilation=1, bool ceil_mode=False, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+
+@impl(lib, "max_pool2d", "CompositeExplicitAutograd")
+def max_pool2d_impl(
+    self: torch.Tensor,
+    kernel_size: List[int],
+    stride: List[int],
+    padding: List[int],
+    dilation: List[int],
+    ceil_mode: bool,
+) -> torch.Tensor:
+    return torch.ops.aten.max_pool2d_with_indices.default(
+        self, kernel_size, stride, padding, dilation, ceil_mode
+    )[0]
+
+
+@impl(lib, "max_pool2d.out", "CompositeExplicitAutograd")
+def max_pool2d_out_impl(
+    self: torch.Tensor,
+    kernel_size: List[int],
+    stride: List[int],
+    padding: List[int],
+    dilation: List[int],
+    ceil_mode: bool,
+    *,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    result = max_pool2d_impl(self, kernel_size, stride, padding, dilation, ceil_mode)
+    out.resize_(result.shape)
+    out.copy_(result)
+    return out
@@ -6,23 +6,92 @@
 
 import logging
 import warnings
-from typing import Optional
+from typing import List, Optional, Sequence
 
 import torch
 from executorch.exir.error import internal_assert
 from executorch.exir.memory import alloc
 from executorch.exir.memory_planning import (
+    _is_mutable_buffer,
     _is_out_var_node,
     apply_algo,
     get_algo,
     get_node_tensor_specs,
+    plan_shape_buckets,
     Verifier,
 )
 from executorch.exir.operator.convert import get_out_args_from_opoverload
 from executorch.exir.pass_base import PassBase, PassResult
-from executorch.exir.tensor import ALIGNMENT
+from executorch.exir.tensor import ALIGNMENT, TensorSpec
 from torch.export.exported_program import ExportGraphSignature
 
+# Out-variant ops that may write their result over a same-shaped input. Their
+# kernels read element i of every input before writing element i of the
+# output; see the aliasing contract in runtime/kernel/kernel_runtime_context.h.
+_INPLACE_ELEMENTWISE_OPS = {
+    "aten::abs",
+    "aten::add",
+    "aten::clamp",
+    "aten::div",
+    "aten::exp",
+    "aten::gelu",
+    "aten::hardtanh",
+    "aten::leaky_relu",
+    "aten::mul",
+    "aten::neg",
+    "aten::relu",
+    "aten::sigmoid",
+    "aten::silu",
+    "aten::sub",
+    "aten::tanh",
+    "fused_ops::elementwise_chain",
+}
+
+# Out-variant ops whose result is their first argument with some slices
+# overwritten. When `out` is that argument, their optimized kernels only write
+# the updated slices instead of copying the whole tensor first.
+_INPLACE_BUFFER_UPDATE_OPS = {
+    "aten::index_put",
+    "aten::slice_scatter",
+}
+
+
+def _tensor_inputs(node: torch.fx.Node) -> List[torch.fx.Node]:
+    inputs = []
+    for arg in node.args:
+        for value in arg if isinstance(arg, (list, tuple)) else [arg]:
+            if isinstance(value, torch.fx.Node) and value not in inputs:
+                inputs.append(value)
+    return inputs
+
+
+def _can_write_over(node: torch.fx.Node, arg: torch.fx.Node) -> bool:
+    """
+    Whether `node` may write its result into the memory of its input `arg`:
+    `arg` is an intermediate that `node` is the last user of, and it has the
+    dtype, shape and strides of the result, so nothing broadcasts.
+    """
+    if len(arg.users) != 1 or not _is_out_var_node(arg):
+        return False
+    if len(get_out_args_from_opoverload(arg.target)) != 1:
+        return False
+    return _same_layout(node, arg)
+
+
+def _same_layout(node: torch.fx.Node, arg: torch.fx.Node) -> bool:
+    spec = arg.meta.get("spec")
+    out_spec = node.meta.get("spec")
+    if not isinstance(spec, TensorSpec) or not isinstance(out_spec, TensorSpec):
+        return False
+    return (
+        not spec.const
+        and spec.is_static_shape_tensor
+        and out_spec.is_static_shape_tensor
+        and spec.dtype == out_spec.dtype
+        and list(spec.shape) == list(out_spec.shape)
+        and tuple(spec.stride) == tuple(out_spec.stride)
+    )
+
 
 class MemoryPlanningPass(PassBase):
     def __init__(
@@ -32,18 +101,40 @@ class MemoryPlanningPass(PassBase):
         alloc_graph_input: bool = True,
         alloc_graph_output: bool = True,
         alignment: int = ALIGNMENT,
+        shape_buckets: Optional[Sequence[Sequence[Sequence[int]]]] = None,
+        inplace_elementwise: bool = False,
+        inplace_buffer_updates: bool = False,
     ) -> None:
         r"""
         alloc_graph_input/alloc_graph_output will have 4 different combinations
         to control if the memory planning algorithm need allocate memory for
         the graph input/output. The default behavior is the algorithm will allocate
         memory for both graph input and output.
+
+        shape_buckets lists additional plans for inputs smaller than their
+        upper bounds, each as the largest shape of every user input tensor,
+        smallest bucket first. At runtime, Method uses the first bucket that
+        fits its inputs, so that short inputs touch less memory. See
+        plan_shape_buckets().
+
+        inplace_elementwise lets elementwise ops such as relu, add and clamp
+        write their result over an input that they are the last user of, so
+        the two tensors share one allocation instead of being live at the same
+        time. See _plan_inplace_elementwise().
+
+        inplace_buffer_updates lets index_put and slice_scatter write their
+        result straight into the mutable buffer they update, e.g. a KV cache,
+        so each call only writes the new slices instead of copying the whole
+        buffer twice. See _plan_inplace_buffer_updates().
         """
         self.memory_planning_algo = memory_planning_algo
         self.allow_lifetime_and_storage_overlap = allow_lifetime_and_storage_overlap
         self.alloc_graph_input = alloc_graph_input
         self.alloc_graph_output = alloc_graph_output
         self.alignment = alignment
+        self.shape_buckets = shape_buckets
+        self.inplace_elementwise = inplace_elementwise
+        self.inplace_buffer_updates = inplace_buffer_updates
 
     def _set_alloc_node_spec(self, graph_module: torch.fx.GraphModule) -> None:
         """
@@ -83,6 +174,111 @@ class MemoryPlanningPass(PassBase):
                         )
                         out_alloc_node.meta["spec"] = specs[i]
 
+    def _plan_inplace_elementwise(
+        self, graph_module: torch.fx.GraphModule
+    ) -> None:
+        """
+        Passes an input of each allow-listed elementwise op as its out argument
+        when the op is the input's last user and the two have the same dtype,
+        shape and strides. The op's memory.alloc node is dropped and the op
+        takes the input's spec, so the emitter gives both the same value and
+        the planner extends the input's lifetime over the op's users.
+
+        Graph inputs, constants, graph outputs and views are never written
+        over: the input must be the out-variant result of another op, and
+        neither the input nor the op's result may have other users such as
+        memory.view or the graph output.
+        """
+        for subgm in graph_module.modules():
+            if not isinstance(subgm, torch.fx.GraphModule):
+                continue
+            modified = False
+            for node in subgm.graph.nodes:
+                if (
+                    not _is_out_var_node(node)
+                    or node.target._schema.name not in _INPLACE_ELEMENTWISE_OPS
+                    or any(user.op == "output" for user in node.users)
+                ):
+                    continue
+                out_alloc_node = node.kwargs.get("out")
+                if (
+                    not isinstance(out_alloc_node, torch.fx.Node)
+                    or out_alloc_node.target != alloc
+                    or len(out_alloc_node.users) != 1
+                ):
+                    continue
+                arg = next(
+                    (a for a in _tensor_inputs(node) if _can_write_over(node, a)),
+                    None,
+                )
+                if arg is None:
+                    continue
+                node.update_kwarg("out", arg)
+                node.meta["spec"] = arg.meta["spec"]
+                subgm.graph.erase_node(out_alloc_node)
+                modified = True
+            if modified:
+                subgm.recompile()
+
+    def _plan_inplace_buffer_updates(
+        self,
+        graph_module: torch.fx.GraphModule,
+        graph_signature: Optional[ExportGraphSignature],
+    ) -> None:
+        """
+        Passes the mutable buffer that an index_put or slice_scatter updates
+        as the op's out argument, when a copy_ writes the op's result back into
+        that buffer. The copy_ then copies the buffer onto itself, which its
+        kernels skip, and later readers of the result, such as attention
+        reading an updated KV cache, read the buffer.
+
+        The buffer may have no users other than the op and the copy_, since
+        anything else reading it would see the update too early, and the
+        result may not be a graph output.
+        """
+        if graph_signature is None:
+            return
+        modified = False
+        for node in graph_module.graph.nodes:
+            if (
+                not _is_out_var_node(node)
+                or node.target._schema.name not in _INPLACE_BUFFER_UPDATE_OPS
+                or any(user.op == "output" for user in node.users)
+            ):
+                continue
+            buffer = node.args[0]
+            write_back = next(
+                (
+                    user
+                    for user in node.users
+                    if user.target == torch.ops.aten.copy_.default
+                    and user.args[0] is buffer
+                    and user.args[1] is node
+                ),
+                None,
+            )
+            if (
+                write_back is None
+                or not isinstance(buffer, torch.fx.Node)
+                or not _is_mutable_buffer(buffer, graph_signature)
+                or set(buffer.users) != {node, write_back}
+            ):
+                continue
+            out_alloc_node = node.kwargs.get("out")
+            if (
+                not isinstance(out_alloc_node, torch.fx.Node)
+                or out_alloc_node.target != alloc
+                or len(out_alloc_node.users) != 1
+                or not _same_layout(node, buffer)
+            ):
+                continue
+            node.update_kwarg("out", buffer)
+            node.meta["spec"] = buffer.meta["spec"]
+            graph_module.graph.erase_node(out_alloc_node)
+            modified = True
+        if modified:
+            graph_module.recompile()
+
     def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
         return self.run(graph_module)
 
@@ -96,6 +292,10 @@ class MemoryPlanningPass(PassBase):
         memory_planning_algo
         """
         self._set_alloc_node_spec(graph_module)
+        if self.inplace_elementwise:
+            self._plan_inplace_elementwise(graph_module)
+        if self.inplace_buffer_updates:
+            self._plan_inplace_buffer_updates(graph_module, graph_signature)
         algo = get_algo(self.memory_planning_algo)
         # TODO(shunting) if people have concern of adding a field to GraphModule
         # directly, we should define a GraphModule subclass that we can add our
@@ -128,4 +328,12 @@ class MemoryPlanningPass(PassBase):
                 f"The {self.memory_planning_algo} algorithm reuses storage for {num_reuse_pairs} pair of tensors"
             )
         verifier.verify_graph_input_output()
+
+        if self.shape_buckets:
+            graph_module.meta["memory_plan_buckets"] = plan_shape_buckets(
+                graph_module,
+                self.shape_buckets,
+                graph_signature,
+                self.alloc_graph_output,
+            )
         return PassResult(graph_module, True)
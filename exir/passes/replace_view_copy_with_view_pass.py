@@ -108,6 +108,7 @@ class _ViewSpec(TensorSpec):
             "mem_id",
             "mem_obj_id",
             "mem_offset",
+            "bucket_mem_offsets",
             "dtype",  # property
         ]
 
@@ -443,6 +443,7 @@ class ExirExportedProgram:
             segment_alignment=config.segment_alignment,
             constant_tensor_alignment=config.constant_tensor_alignment,
             delegate_alignment=config.delegate_alignment,
+            compress_segments=config.compress_segments,
         )
         executorch_prog.graph_module.meta.update(new_gm.meta)
         executorch_prog.graph_module.meta.update(
@@ -472,6 +473,7 @@ class ExecutorchProgram:
         segment_alignment: int,
         constant_tensor_alignment: Optional[int] = None,
         delegate_alignment: Optional[int] = None,
+        compress_segments: bool = False,
     ) -> None:
         if not exir_exported_program.after_to_edge_passes:
             raise RuntimeError(
@@ -487,16 +489,21 @@ class ExecutorchProgram:
         self._segment_alignment: int = segment_alignment
         self._constant_tensor_alignment: Optional[int] = constant_tensor_alignment
         self._delegate_alignment: Optional[int] = delegate_alignment
+        self._compress_segments: bool = compress_segments
 
     def _get_pte_data(self) -> Cord:
         if self._pte_data is None:
+            program = self.program
+            assert self._emitter_output is not None
             self._pte_data = _serialize_pte_binary(
-                program=self.program,
+                program=program,
+                named_data=self._emitter_output.named_data,
                 extract_delegate_segments=self._extract_delegate_segments,
                 extract_constant_segment=self._extract_constant_segment,
                 segment_alignment=self._segment_alignment,
                 constant_tensor_alignment=self._constant_tensor_alignment,
                 delegate_alignment=self._delegate_alignment,
+                compress_segments=self._compress_segments,
             )
         return self._pte_data
 
@@ -1327,11 +1334,13 @@ class ExecutorchProgramManager:
         self._pte_data: Cord = _serialize_pte_binary(
             program=self._emitter_output.program,
             mutable_data=self._emitter_output.mutable_data,
+            named_data=self._emitter_output.named_data,
             extract_delegate_segments=backend_config.extract_delegate_segments,
             extract_constant_segment=backend_config.extract_constant_segment,
             segment_alignment=backend_config.segment_alignment,
             constant_tensor_alignment=backend_config.constant_tensor_alignment,
             delegate_alignment=backend_config.delegate_alignment,
+            compress_segments=backend_config.compress_segments,
         )
         self._buffer: Optional[bytes] = None
 
@@ -6,7 +6,7 @@
 
 # pyre-strict
 
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from enum import IntEnum
 from typing import List, Optional, Union
 
@@ -43,6 +43,16 @@ class TensorShapeDynamism(IntEnum):
     DYNAMIC_UNBOUND = 2
 
 
+@dataclass
+class ExtraTensorInfo:
+    """
+    Check schema.fbs for explanations.
+    """
+
+    mutable_data_segments_idx: int = 0
+    fully_qualified_name: Optional[str] = None
+
+
 @dataclass
 class Tensor:
     scalar_type: ScalarType
@@ -56,6 +66,7 @@ class Tensor:
 
     # check schema.fbs for explanations
     shape_dynamism: TensorShapeDynamism
+    extra_tensor_info: Optional[ExtraTensorInfo] = None
 
 
 @dataclass
@@ -228,6 +239,13 @@ class Operator:
     overload: str
 
 
+@dataclass
+class MemoryPlanBucket:
+    input_sizes: List[int]
+    value_indices: List[int]
+    allocations: List[AllocationDetails]
+
+
 @dataclass
 class ExecutionPlan:
     name: str
@@ -243,12 +261,22 @@ class ExecutionPlan:
     # Runtime should use the len(constant_buffer) as the ground truch of
     # constant memory buffer size, and ignore non_const_buffer_sizes[0].
     non_const_buffer_sizes: List[int]
+    # Alternative memory plans for smaller inputs, smallest first.
+    memory_plan_buckets: List[MemoryPlanBucket] = field(default_factory=list)
+
+
+class SegmentCompression(IntEnum):
+    NONE = 0
+    LZ4_BLOCKS = 1
 
 
 @dataclass
 class DataSegment:
     offset: int
     size: int
+    compression: SegmentCompression = SegmentCompression.NONE
+    # The size of the data once decompressed; zero if not compressed.
+    uncompressed_size: int = 0
 
 
 @dataclass
@@ -257,6 +285,12 @@ class SubsegmentOffsets:
     offsets: List[int]
 
 
+@dataclass
+class NamedData:
+    key: str
+    segment_index: int
+
+
 @dataclass
 class Program:
     version: int
@@ -266,3 +300,4 @@ class Program:
     segments: List[DataSegment]
     constant_segment: SubsegmentOffsets
     mutable_data_segments: Optional[List[SubsegmentOffsets]] = None
+    named_data: List[NamedData] = field(default_factory=list)
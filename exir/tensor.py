@@ -183,6 +183,8 @@ class TensorSpec:
         self.mem_id = None
         self.mem_obj_id = None
         self.mem_offset = None
+        # Offsets of the tensor in each shape bucket, if it is planned in them.
+        self.bucket_mem_offsets: Optional[List[int]] = None
 
     @property
     def dtype(self) -> torch.dtype:
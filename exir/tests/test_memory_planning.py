@@ -591,3 +591,97 @@ class TestMisc(unittest.TestCase):
             num_placeholders,
             5,
         )
+
+    def test_shape_buckets(self) -> None:
+        class Simple(torch.nn.Module):
+            def forward(self, x: torch.Tensor) -> torch.Tensor:
+                return torch.sin(x * 2) + 1
+
+        seq = torch.export.Dim("seq", max=1024)
+        program = (
+            to_edge(
+                export(
+                    Simple(), (torch.randn(1, 8),), dynamic_shapes={"x": {1: seq}}
+                )
+            )
+            .to_executorch(
+                config=ExecutorchBackendConfig(
+                    memory_planning_pass=MemoryPlanningPass(
+                        "greedy", shape_buckets=[[[1, 64]]]
+                    ),
+                    sym_shape_eval_pass=ConstraintBasedSymShapeEvalPass(),
+                )
+            )
+            .executorch_program
+        )
+        plan = program.execution_plan[0]
+        self.assertEqual(len(plan.memory_plan_buckets), 1)
+        bucket = plan.memory_plan_buckets[0]
+        self.assertEqual(bucket.input_sizes, [1, 64])
+        self.assertGreater(len(bucket.value_indices), 0)
+        self.assertEqual(len(bucket.value_indices), len(bucket.allocations))
+
+        # The input keeps its place, and the other tensors are packed after it
+        # at their bucket sizes of 64 floats.
+        input_info = plan.values[plan.inputs[0]].val.allocation_info
+        input_end = input_info.memory_offset + 1024 * 4
+        for value_index, allocation in zip(bucket.value_indices, bucket.allocations):
+            self.assertNotIn(value_index, plan.inputs)
+            self.assertEqual(allocation.memory_id, input_info.memory_id)
+            self.assertGreaterEqual(allocation.memory_offset, input_end)
+            self.assertLess(allocation.memory_offset, input_end + 3 * 64 * 4)
+            # The buffer still holds the tensor at its upper bound size.
+            self.assertLessEqual(
+                allocation.memory_offset + 1024 * 4,
+                plan.non_const_buffer_sizes[allocation.memory_id],
+            )
+
+    def test_inplace_elementwise(self) -> None:
+        class Branches(torch.nn.Module):
+            def forward(self, x: torch.Tensor) -> torch.Tensor:
+                a = torch.relu(x * 2)
+                b = torch.relu(x * 3)
+                return a * b + 1
+
+        def plan(inplace_elementwise: bool) -> Any:
+            return (
+                to_edge(export(Branches(), (torch.randn(4, 16),)))
+                .to_executorch(
+                    config=ExecutorchBackendConfig(
+                        memory_planning_pass=MemoryPlanningPass(
+                            "greedy", inplace_elementwise=inplace_elementwise
+                        ),
+                    )
+                )
+                .executorch_program.execution_plan[0]
+            )
+
+        baseline = plan(False)
+        inplace = plan(True)
+
+        # Each relu writes over its mul, and a * b over a. The add's result is
+        # the graph output, so it keeps its own allocation.
+        def kernel_args(plan: Any, op_name: str) -> List[List[int]]:
+            return [
+                instruction.instr_args.args
+                for chain in plan.chains
+                for instruction in chain.instructions
+                if hasattr(instruction.instr_args, "op_index")
+                and plan.operators[instruction.instr_args.op_index].name
+                == op_name
+            ]
+
+        relu_args = kernel_args(inplace, "aten::relu")
+        self.assertEqual(len(relu_args), 2)
+        for args in relu_args:
+            self.assertEqual(args[0], args[-1])
+        product_args = kernel_args(inplace, "aten::mul")[-1]
+        self.assertEqual(product_args[0], product_args[-1])
+        self.assertEqual(product_args[-1], relu_args[0][-1])
+        add_args = kernel_args(inplace, "aten::add")
+        self.assertNotEqual(add_args[0][0], add_args[0][-1])
+
+        # The relu and product results no longer need buffers of their own.
+        self.assertLess(
+            inplace.non_const_buffer_sizes[1], baseline.non_const_buffer_sizes[1]
+        )
@@ -34,6 +34,12 @@ from executorch.exir.passes import (
 )
 from executorch.exir.passes.constant_prop_pass import constant_prop_pass
 from executorch.exir.passes.debug_handle_generator_pass import DebugHandleGeneratorPass
+from executorch.exir.passes.drop_max_pool_indices_pass import (
+    DropUnusedMaxPoolIndicesPass,
+)
+from executorch.exir.passes.fuse_elementwise_chain_pass import (
+    FuseElementwiseChainPass,
+)
 from executorch.exir.passes.insert_write_back_for_buffers_pass import (
     insert_write_back_for_buffers_pass,
 )
@@ -230,6 +236,99 @@ class TestPasses(unittest.TestCase):
             if node.op == "call_function":
                 self.assertNotEqual(node.target, torch.ops.aten.to.dtype)
 
+    def test_fuse_elementwise_chain_pass(self) -> None:
+        class Foo(torch.nn.Module):
+            def forward(
+                self, x: torch.Tensor, y: torch.Tensor, z: torch.Tensor
+            ) -> Tuple[torch.Tensor, torch.Tensor]:
+                a = torch.sigmoid(x * y + z) * x
+                # b is used twice, so the chain stops at it.
+                b = torch.tanh(a - 1.0)
+                return b, torch.relu(b * 2.0)
+
+        inputs = (torch.randn(2, 8), torch.randn(2, 8), torch.randn(2, 8))
+        edge_prog = to_edge(export(Foo(), inputs))
+        expected = edge_prog.exported_program().module()(*inputs)
+
+        edge_prog = edge_prog.transform([FuseElementwiseChainPass()])
+        graph_module = edge_prog.exported_program().graph_module
+        fused = [
+            node
+            for node in graph_module.graph.nodes
+            if node.target == exir_ops.edge.fused_ops.elementwise_chain.default
+        ]
+        # x * y + z -> sigmoid -> * x -> - 1 -> tanh, then * 2 -> relu.
+        self.assertEqual(len(fused), 2)
+        self.assertEqual(len(fused[0].args[1]), 6 * 3)
+        self.assertEqual(len(fused[1].args[1]), 2 * 3)
+        for node in graph_module.graph.nodes:
+            self.assertNotIn(
+                node.target,
+                (
+                    exir_ops.edge.aten.mul.Tensor,
+                    exir_ops.edge.aten.sigmoid.default,
+                    exir_ops.edge.aten.tanh.default,
+                ),
+            )
+
+        actual = edge_prog.exported_program().module()(*inputs)
+        for e, a in zip(expected, actual):
+            self.assertTrue(torch.allclose(e, a))
+
+        # The fused op lowers to its out variant.
+        et_prog = edge_prog.to_executorch()
+        FileCheck().check_count(
+            "torch.ops.fused_ops.elementwise_chain.out", 2, exactly=True
+        ).run(et_prog.exported_program().graph_module.code)
+
+    def test_fuse_elementwise_chain_pass_skips_broadcasts(self) -> None:
+        class Foo(torch.nn.Module):
+            def forward(self, x: torch.Tensor, y: torch.Tensor) -> torch.Tensor:
+                return torch.sigmoid(x * y) + x
+
+        edge_prog = to_edge(export(Foo(), (torch.randn(2, 8), torch.randn(8))))
+        edge_prog = edge_prog.transform([FuseElementwiseChainPass()])
+        graph_module = edge_prog.exported_program().graph_module
+        # x * y broadcasts; only sigmoid -> add fuses.
+        FileCheck().check("executorch_exir_dialects_edge__ops_aten_mul_Tensor").check(
+            "executorch_exir_dialects_edge__ops_fused_ops_elementwise_chain_default"
+        ).run(graph_module.code)
+
+    def test_drop_max_pool_indices_pass(self) -> None:
+        class Foo(torch.nn.Module):
+            def forward(self, x: torch.Tensor) -> Tuple[torch.Tensor, torch.Tensor]:
+                pooled = torch.nn.functional.max_pool2d(x, 3, 2, padding=1)
+                # The indices of the second pool are returned, so it keeps them.
+                return torch.nn.functional.max_pool2d(
+                    pooled, 2, return_indices=True
+                )
+
+        inputs = (torch.randn(1, 4, 16, 16),)
+        edge_prog = to_edge(export(Foo(), inputs))
+        expected = edge_prog.exported_program().module()(*inputs)
+
+        edge_prog = edge_prog.transform([DropUnusedMaxPoolIndicesPass()])
+        graph_module = edge_prog.exported_program().graph_module
+        FileCheck().check_count(
+            "executorch_exir_dialects_edge__ops_fused_ops_max_pool2d_default",
+            1,
+            exactly=True,
+        ).run(graph_module.code)
+        FileCheck().check_count(
+            "executorch_exir_dialects_edge__ops_aten_max_pool2d_with_indices_default",
+            1,
+            exactly=True,
+        ).run(graph_module.code)
+
+        actual = edge_prog.exported_program().module()(*inputs)
+        for e, a in zip(expected, actual):
+            self.assertTrue(torch.equal(e, a))
+
+        et_prog = edge_prog.to_executorch()
+        FileCheck().check_count(
+            "torch.ops.fused_ops.max_pool2d.out", 1, exactly=True
+        ).run(et_prog.exported_program().graph_module.code)
+
     def test_redundant_slice_copy_removal(self) -> None:
         class FooWithNoSlice(torch.nn.Module):
             def forward(self, x: torch.Tensor) -> torch.Tensor:
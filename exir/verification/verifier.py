@@ -235,6 +235,7 @@ def EXIREdgeDialectVerifier(  # noqa: C901
                     "nimble",
                     "quantized",
                     "dim_order_ops",
+                    "fused_ops",
                 ) or op in (
                     torch.ops.aten.mkldnn_rnn_layer.default,
                     torch.ops.aten._upsample_bilinear2d_aa.default,
@@ -8,7 +8,9 @@
 
 #include <cassert>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -235,6 +237,21 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
   friend HybridBase;
   std::unique_ptr<Module> module_;
 
+  // A Java tensor bound to an input or output of a method, so that repeated
+  // executions use its direct buffer without converting anything.
+  struct BoundTensor {
+    // Keeps the direct buffer of the tensor alive while it is bound.
+    facebook::jni::global_ref<JEValue::javaobject> jvalue;
+    ManagedTensor tensor;
+    // For outputs: whether the method writes to the buffer directly. If not,
+    // the output is copied to it after each execution.
+    bool aliased;
+  };
+  std::unordered_map<std::string, std::map<size_t, BoundTensor>>
+      bound_inputs_;
+  std::unordered_map<std::string, std::map<size_t, BoundTensor>>
+      bound_outputs_;
+
  public:
   constexpr static auto kJavaDescriptor = "Lorg/pytorch/executorch/NativePeer;";
 
@@ -287,6 +304,85 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
     return static_cast<jint>(module_->load_method(methodName->toStdString()));
   }
 
+  jint bind_input(
+      facebook::jni::alias_ref<jstring> methodName,
+      jint index,
+      facebook::jni::alias_ref<JEValue> jinput) {
+    const std::string method = methodName->toStdString();
+    BoundTensor bound{
+        facebook::jni::make_global(jinput),
+        JEValue::JEValueToTensorImpl(jinput),
+        /*aliased=*/false};
+    const Error error = module_->set_input(
+        method, EValue(bound.tensor.get_aliasing_tensor()), index);
+    if (error == Error::Ok) {
+      bound_inputs_[method].insert_or_assign(index, std::move(bound));
+    }
+    return static_cast<jint>(error);
+  }
+
+  jint bind_output(
+      facebook::jni::alias_ref<jstring> methodName,
+      jint index,
+      facebook::jni::alias_ref<JEValue> joutput) {
+    const std::string method = methodName->toStdString();
+    BoundTensor bound{
+        facebook::jni::make_global(joutput),
+        JEValue::JEValueToTensorImpl(joutput),
+        /*aliased=*/false};
+    Error error = module_->load_method(method);
+    if (error != Error::Ok) {
+      return static_cast<jint>(error);
+    }
+    auto output = module_->method_meta(method)->output_tensor_meta(index);
+    if (!output.ok()) {
+      return static_cast<jint>(output.error());
+    }
+    if (output->nbytes() > bound.tensor.get_aliasing_tensor().nbytes()) {
+      return static_cast<jint>(Error::InvalidArgument);
+    }
+    // Outputs that the method cannot write to the buffer, e.g. because
+    // another value shares their memory, are copied after each execution.
+    exec_aten::Tensor tensor = bound.tensor.get_aliasing_tensor();
+    bound.aliased =
+        module_->set_output_data_ptr(method, tensor, index) == Error::Ok;
+    bound_outputs_[method].insert_or_assign(index, std::move(bound));
+    return static_cast<jint>(Error::Ok);
+  }
+
+  jint execute_bound(facebook::jni::alias_ref<jstring> methodName) {
+    const std::string method = methodName->toStdString();
+    // Planned inputs are copied by set_input(), so the buffers are applied
+    // again to pick up what the app wrote to them since the last execution.
+    for (auto& [index, bound] : bound_inputs_[method]) {
+      const Error error = module_->set_input(
+          method, EValue(bound.tensor.get_aliasing_tensor()), index);
+      if (error != Error::Ok) {
+        return static_cast<jint>(error);
+      }
+    }
+    Error error = module_->execute_in_place(method);
+    if (error != Error::Ok) {
+      return static_cast<jint>(error);
+    }
+    for (auto& [index, bound] : bound_outputs_[method]) {
+      if (bound.aliased) {
+        continue;
+      }
+      auto output = module_->get_output(method, index);
+      if (!output.ok()) {
+        return static_cast<jint>(output.error());
+      }
+      exec_aten::Tensor src = output->toTensor();
+      exec_aten::Tensor dst = bound.tensor.get_aliasing_tensor();
+      if (src.nbytes() > dst.nbytes()) {
+        return static_cast<jint>(Error::InvalidArgument);
+      }
+      std::memcpy(dst.mutable_data_ptr(), src.const_data_ptr(), src.nbytes());
+    }
+    return static_cast<jint>(Error::Ok);
+  }
+
   facebook::jni::local_ref<facebook::jni::JArrayClass<JEValue>> execute_method(
       std::string method,
       facebook::jni::alias_ref<
@@ -358,6 +454,9 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
         makeNativeMethod("forward", ExecuTorchJni::forward),
         makeNativeMethod("execute", ExecuTorchJni::execute),
         makeNativeMethod("loadMethod", ExecuTorchJni::load_method),
+        makeNativeMethod("bindInput", ExecuTorchJni::bind_input),
+        makeNativeMethod("bindOutput", ExecuTorchJni::bind_output),
+        makeNativeMethod("executeBound", ExecuTorchJni::execute_bound),
     });
   }
 };
@@ -8,10 +8,13 @@
 
 #include <cassert>
 #include <chrono>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -88,6 +91,90 @@ class ExecuTorchLlamaCallbackJni
   }
 };
 
+class ExecuTorchLlamaBufferedCallbackJni
+    : public facebook::jni::JavaClass<ExecuTorchLlamaBufferedCallbackJni> {
+ public:
+  constexpr static const char* kJavaDescriptor =
+      "Lorg/pytorch/executorch/LlamaBufferedCallback;";
+
+  void onResultBytes(jint length) const {
+    static auto cls = ExecuTorchLlamaBufferedCallbackJni::javaClassStatic();
+    static const auto method = cls->getMethod<void(jint)>("onResultBytes");
+    method(self(), length);
+  }
+
+  void onStats(const Stats& result) const {
+    static auto cls = ExecuTorchLlamaBufferedCallbackJni::javaClassStatic();
+    static const auto method = cls->getMethod<void(jfloat)>("onStats");
+    double eval_time =
+        (double)(result.inference_end_ms - result.prompt_eval_end_ms);
+
+    float tps = result.num_generated_tokens / eval_time *
+        result.SCALING_FACTOR_UNITS_PER_SECOND;
+
+    method(self(), tps);
+  }
+};
+
+/**
+ * Collects the UTF-8 text of generated tokens in a direct buffer owned by the
+ * app, and hands it over every `max_tokens` tokens or `max_delay_ms`
+ * milliseconds, whichever comes first. This replaces a JNI call and a new
+ * jstring per token with one call per batch and no allocation.
+ */
+class TokenBatcher {
+ public:
+  TokenBatcher(
+      uint8_t* buffer,
+      size_t capacity,
+      int max_tokens,
+      int max_delay_ms,
+      facebook::jni::alias_ref<ExecuTorchLlamaBufferedCallbackJni> callback)
+      : buffer_(buffer),
+        capacity_(capacity),
+        max_tokens_(max_tokens),
+        max_delay_(max_delay_ms),
+        callback_(callback),
+        last_flush_(std::chrono::steady_clock::now()) {}
+
+  void add(std::string_view piece) {
+    // A piece that does not fit is split across batches.
+    while (size_ + piece.size() > capacity_) {
+      const size_t n = capacity_ - size_;
+      std::memcpy(buffer_ + size_, piece.data(), n);
+      size_ += n;
+      piece.remove_prefix(n);
+      flush();
+    }
+    std::memcpy(buffer_ + size_, piece.data(), piece.size());
+    size_ += piece.size();
+    ++num_tokens_;
+    if (num_tokens_ >= max_tokens_ ||
+        std::chrono::steady_clock::now() - last_flush_ >= max_delay_) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (size_ > 0) {
+      callback_->onResultBytes(static_cast<jint>(size_));
+    }
+    size_ = 0;
+    num_tokens_ = 0;
+    last_flush_ = std::chrono::steady_clock::now();
+  }
+
+ private:
+  uint8_t* const buffer_;
+  const size_t capacity_;
+  const int max_tokens_;
+  const std::chrono::milliseconds max_delay_;
+  facebook::jni::alias_ref<ExecuTorchLlamaBufferedCallbackJni> callback_;
+  size_t size_ = 0;
+  int num_tokens_ = 0;
+  std::chrono::steady_clock::time_point last_flush_;
+};
+
 class ExecuTorchLlamaJni
     : public facebook::jni::HybridClass<ExecuTorchLlamaJni> {
  private:
@@ -151,6 +238,68 @@ class ExecuTorchLlamaJni
       facebook::jni::alias_ref<jstring> prompt,
       jint seq_len,
       facebook::jni::alias_ref<ExecuTorchLlamaCallbackJni> callback) {
+    return run_generate(
+        image,
+        width,
+        height,
+        channels,
+        prompt,
+        seq_len,
+        [callback](std::string_view result) {
+          callback->onResult(std::string(result));
+        },
+        [callback](const Stats& result) { callback->onStats(result); });
+  }
+
+  jint generate_buffered(
+      facebook::jni::alias_ref<jintArray> image,
+      jint width,
+      jint height,
+      jint channels,
+      facebook::jni::alias_ref<jstring> prompt,
+      jint seq_len,
+      facebook::jni::alias_ref<facebook::jni::JByteBuffer> result_buffer,
+      jint max_tokens,
+      jint max_delay_ms,
+      facebook::jni::alias_ref<ExecuTorchLlamaBufferedCallbackJni> callback) {
+    if (!result_buffer->isDirect() || result_buffer->getDirectSize() == 0) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "The result buffer must be a non-empty direct ByteBuffer");
+    }
+    TokenBatcher batcher(
+        result_buffer->getDirectBytes(),
+        result_buffer->getDirectSize(),
+        max_tokens,
+        max_delay_ms,
+        callback);
+    const jint result = run_generate(
+        image,
+        width,
+        height,
+        channels,
+        prompt,
+        seq_len,
+        [&batcher](std::string_view piece) { batcher.add(piece); },
+        [&batcher, callback](const Stats& result) {
+          batcher.flush();
+          callback->onStats(result);
+        });
+    // Deliver what is left when generation stops early.
+    batcher.flush();
+    return result;
+  }
+
+ private:
+  jint run_generate(
+      facebook::jni::alias_ref<jintArray> image,
+      jint width,
+      jint height,
+      jint channels,
+      facebook::jni::alias_ref<jstring> prompt,
+      jint seq_len,
+      std::function<void(std::string_view)> token_callback,
+      std::function<void(const Stats&)> stats_callback) {
     if (model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL) {
       auto image_size = image->size();
       std::vector<Image> images;
@@ -168,18 +317,16 @@ class ExecuTorchLlamaJni
           images,
           prompt->toStdString(),
           seq_len,
-          [callback](std::string result) { callback->onResult(result); },
-          [callback](const Stats& result) { callback->onStats(result); });
+          token_callback,
+          stats_callback);
     } else if (model_type_category_ == MODEL_TYPE_CATEGORY_LLM) {
       runner_->generate(
-          prompt->toStdString(),
-          seq_len,
-          [callback](std::string result) { callback->onResult(result); },
-          [callback](const Stats& result) { callback->onStats(result); });
+          prompt->toStdString(), seq_len, token_callback, stats_callback);
     }
     return 0;
   }
 
+ public:
   void stop() {
     if (model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL) {
       multi_modal_runner_->stop();
@@ -201,6 +348,8 @@ class ExecuTorchLlamaJni
     registerHybrid({
         makeNativeMethod("initHybrid", ExecuTorchLlamaJni::initHybrid),
         makeNativeMethod("generate", ExecuTorchLlamaJni::generate),
+        makeNativeMethod(
+            "generateBuffered", ExecuTorchLlamaJni::generate_buffered),
         makeNativeMethod("stop", ExecuTorchLlamaJni::stop),
         makeNativeMethod("load", ExecuTorchLlamaJni::load),
     });
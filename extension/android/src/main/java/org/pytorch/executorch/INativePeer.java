@@ -25,4 +25,25 @@ interface INativePeer {
    * @return the Error code if there was an error loading the method
    */
   int loadMethod(String methodName);
+
+  /**
+   * Bind a tensor to an input of a method, to be used by {@link #executeBound}.
+   *
+   * @return the Error code if the tensor can not be used as this input
+   */
+  int bindInput(String methodName, int index, EValue input);
+
+  /**
+   * Bind a tensor to an output of a method, to be filled by {@link #executeBound}.
+   *
+   * @return the Error code if the tensor can not hold this output
+   */
+  int bindOutput(String methodName, int index, EValue output);
+
+  /**
+   * Run a method on its bound inputs and outputs.
+   *
+   * @return the Error code if the execution failed
+   */
+  int executeBound(String methodName);
 }
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+package org.pytorch.executorch;
+
+import com.facebook.jni.annotations.DoNotStrip;
+
+/**
+ * Callback for {@link LlamaModule#generate(String, int, java.nio.ByteBuffer, int, int,
+ * LlamaBufferedCallback)}, which delivers generated text in batches through a buffer owned by the
+ * app instead of one String per token.
+ */
+public interface LlamaBufferedCallback {
+  /**
+   * Called when a batch of generated text is available. The text is UTF-8 encoded, starts at
+   * position 0 of the result buffer, and is only valid until this method returns. A batch may end
+   * in the middle of a multi-byte character when a token does not fit in the buffer.
+   *
+   * @param length Number of bytes of the batch
+   */
+  @DoNotStrip
+  public void onResultBytes(int length);
+
+  /**
+   * Called when the statistics for the generate() is available.
+   *
+   * @param tps Tokens/second for generated tokens.
+   */
+  @DoNotStrip
+  public void onStats(float tps);
+}
@@ -12,6 +12,7 @@ import com.facebook.jni.HybridData;
 import com.facebook.jni.annotations.DoNotStrip;
 import com.facebook.soloader.nativeloader.NativeLoader;
 import com.facebook.soloader.nativeloader.SystemDelegate;
+import java.nio.ByteBuffer;
 
 public class LlamaModule {
 
@@ -88,6 +89,58 @@ public class LlamaModule {
       int seqLen,
       LlamaCallback llamaCallback);
 
+  /**
+   * Start generating tokens from the module, delivering the text in batches. Instead of a String
+   * per token, the UTF-8 text of several tokens is written to {@code resultBuffer} and handed to
+   * the callback every {@code maxTokens} tokens or {@code maxDelayMs} milliseconds, whichever comes
+   * first. This avoids a JNI call and an allocation for every token.
+   *
+   * @param prompt Input prompt
+   * @param seqLen sequence length
+   * @param resultBuffer direct buffer that receives the text of each batch, reused for all batches.
+   * @param maxTokens maximum number of tokens per batch
+   * @param maxDelayMs maximum time in milliseconds to hold generated text before delivering it
+   * @param callback callback object to receive results.
+   */
+  public int generate(
+      String prompt,
+      int seqLen,
+      ByteBuffer resultBuffer,
+      int maxTokens,
+      int maxDelayMs,
+      LlamaBufferedCallback callback) {
+    return generateBuffered(
+        null, 0, 0, 0, prompt, seqLen, resultBuffer, maxTokens, maxDelayMs, callback);
+  }
+
+  /**
+   * Start generating tokens from the module, delivering the text in batches. See {@link
+   * #generate(String, int, ByteBuffer, int, int, LlamaBufferedCallback)}.
+   *
+   * @param image Input image as a byte array
+   * @param width Input image width
+   * @param height Input image height
+   * @param channels Input image number of channels
+   * @param prompt Input prompt
+   * @param seqLen sequence length
+   * @param resultBuffer direct buffer that receives the text of each batch, reused for all batches.
+   * @param maxTokens maximum number of tokens per batch
+   * @param maxDelayMs maximum time in milliseconds to hold generated text before delivering it
+   * @param callback callback object to receive results.
+   */
+  @DoNotStrip
+  public native int generateBuffered(
+      int[] image,
+      int width,
+      int height,
+      int channels,
+      String prompt,
+      int seqLen,
+      ByteBuffer resultBuffer,
+      int maxTokens,
+      int maxDelayMs,
+      LlamaBufferedCallback callback);
+
   /** Stop current generate() before it finishes. */
   @DoNotStrip
   public native void stop();
@@ -106,6 +106,51 @@ public class Module {
     return mNativePeer.loadMethod(methodName);
   }
 
+  /**
+   * Binds a tensor to an input of a method, so that {@link #executeBound} reads the input from
+   * the tensor's buffer each time it runs, without wrapping it again. Write the next input to the
+   * buffer between executions. The tensor must be created from a direct buffer, e.g. one returned
+   * by {@link Tensor#allocateFloatBuffer}, and stays referenced until another tensor is bound to
+   * the same input.
+   *
+   * @param methodName name of the ExecuTorch method.
+   * @param index index of the input in the method.
+   * @param tensor the tensor to read the input from.
+   * @return the Error code if the tensor can not be used as this input
+   */
+  public int bindInput(String methodName, int index, Tensor tensor) {
+    return mNativePeer.bindInput(methodName, index, EValue.from(tensor));
+  }
+
+  /**
+   * Binds a tensor to an output of a method, so that {@link #executeBound} writes the output to
+   * the tensor's buffer instead of returning new objects. This avoids allocating on every
+   * inference. When the method can not write the output to the buffer directly, it is copied
+   * there after each execution. The tensor must be created from a direct buffer and have room
+   * for the output.
+   *
+   * @param methodName name of the ExecuTorch method.
+   * @param index index of the output in the method.
+   * @param tensor the tensor to write the output to.
+   * @return the Error code if the tensor can not hold this output
+   */
+  public int bindOutput(String methodName, int index, Tensor tensor) {
+    return mNativePeer.bindOutput(methodName, index, EValue.from(tensor));
+  }
+
+  /**
+   * Runs the specified method on the inputs and outputs bound with {@link #bindInput} and {@link
+   * #bindOutput}. Inputs that are not bound keep the value they were last set to. Unlike {@link
+   * #execute}, this allocates no Java objects, which suits pipelines that run a model for every
+   * camera frame.
+   *
+   * @param methodName name of the ExecuTorch method to run.
+   * @return the Error code if the execution failed
+   */
+  public int executeBound(String methodName) {
+    return mNativePeer.executeBound(methodName);
+  }
+
   /**
    * Explicitly destroys the native torch::jit::Module. Calling this method is not required, as the
    * native object will be destroyed when this object is garbage-collected. However, the timing of
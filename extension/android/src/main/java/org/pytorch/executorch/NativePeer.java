@@ -41,4 +41,13 @@ class NativePeer implements INativePeer {
 
   @DoNotStrip
   public native int loadMethod(String methodName);
+
+  @DoNotStrip
+  public native int bindInput(String methodName, int index, EValue input);
+
+  @DoNotStrip
+  public native int bindOutput(String methodName, int index, EValue output);
+
+  @DoNotStrip
+  public native int executeBound(String methodName);
 }
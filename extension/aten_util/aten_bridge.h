@@ -28,6 +28,9 @@ c10::ScalarType executorch_to_torch_scalar_type(
     torch::executor::ScalarType type);
 
 /*
+ * aten_tensor must be dense, in any dim order, and mutable_et must have the
+ * same sizes and strides.
+ *
  * @param[in] aten_tensor Input at::Tensor
  * @param[in,out] mutable_et ETensor whose underlying memory now will alias to
  * aten_tensor
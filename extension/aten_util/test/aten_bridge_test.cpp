@@ -126,6 +126,27 @@ TEST(ATenBridgeTest, AliasETensorToATenTensorNonContiguousFail) {
   ET_EXPECT_DEATH(alias_etensor_to_attensor(sliced_tensor, etensor), "");
 }
 
+TEST(ATenBridgeTest, AliasETensorToATenTensorChannelsLast) {
+  auto at_tensor =
+      at::empty({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast);
+  std::vector<Tensor::SizesType> sizes(
+      at_tensor.sizes().begin(), at_tensor.sizes().end());
+  std::vector<Tensor::DimOrderType> dim_order = {0, 2, 3, 1};
+  std::vector<Tensor::StridesType> strides(
+      at_tensor.strides().begin(), at_tensor.strides().end());
+  auto dtype = torchToExecuTorchScalarType(at_tensor.options().dtype());
+  torch::executor::TensorImpl tensor_impl(
+      dtype,
+      at_tensor.dim(),
+      sizes.data(),
+      nullptr,
+      dim_order.data(),
+      strides.data());
+  torch::executor::Tensor etensor(&tensor_impl);
+  alias_etensor_to_attensor(at_tensor, etensor);
+  EXPECT_EQ(at_tensor.const_data_ptr(), etensor.const_data_ptr());
+}
+
 TEST(ATenBridgeTest, AliasATTensorToETensor) {
   auto at_tensor = generate_at_tensor();
   std::vector<Tensor::SizesType> sizes(
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/decompressing_data_loader.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+// Each block starts with its stored size then its uncompressed size.
+constexpr size_t kBlockHeaderSize = 8;
+
+uint32_t read_le32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) |
+      (static_cast<uint32_t>(data[1]) << 8) |
+      (static_cast<uint32_t>(data[2]) << 16) |
+      (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// Reads the extra bytes of a literal or match length, which continue while
+// they are 255. Returns false if the input ends first.
+bool read_length(const uint8_t*& src, const uint8_t* src_end, size_t& length) {
+  uint8_t byte;
+  do {
+    if (src == src_end) {
+      return false;
+    }
+    byte = *src++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+void free_decompressed(
+    ET_UNUSED void* context,
+    void* data,
+    ET_UNUSED size_t size) {
+  std::free(data);
+}
+
+} // namespace
+
+Error decompress_lz4_block(
+    const void* src,
+    size_t src_size,
+    void* dst,
+    size_t dst_size) {
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  const uint8_t* const in_end = in + src_size;
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  uint8_t* const out_begin = out;
+  uint8_t* const out_end = out + dst_size;
+
+  while (in < in_end) {
+    // A sequence is a token, literals, then a match, except for the last
+    // one, which ends after its literals.
+    const uint8_t token = *in++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !read_length(in, in_end, literal_length)) {
+      return Error::InvalidProgram;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        literal_length <= static_cast<size_t>(in_end - in) &&
+            literal_length <= static_cast<size_t>(out_end - out),
+        InvalidProgram,
+        "LZ4 literals overflow the block");
+    std::memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    if (in == in_end) {
+      break;
+    }
+
+    ET_CHECK_OR_RETURN_ERROR(
+        in_end - in >= 2, InvalidProgram, "LZ4 match offset is truncated");
+    const size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    ET_CHECK_OR_RETURN_ERROR(
+        offset > 0 && offset <= static_cast<size_t>(out - out_begin),
+        InvalidProgram,
+        "LZ4 match offset %zu is out of range",
+        offset);
+    size_t match_length = token & 15;
+    if (match_length == 15 && !read_length(in, in_end, match_length)) {
+      return Error::InvalidProgram;
+    }
+    match_length += 4;
+    ET_CHECK_OR_RETURN_ERROR(
+        match_length <= static_cast<size_t>(out_end - out),
+        InvalidProgram,
+        "LZ4 match overflows the block");
+    // A match may overlap the bytes it produces, which repeats its first
+    // `offset` bytes. Copying from the start of the match as much as has
+    // been produced so far keeps each copy disjoint and doubles its size.
+    const uint8_t* match = out - offset;
+    while (match_length > 0) {
+      const size_t chunk =
+          std::min(match_length, static_cast<size_t>(out - match));
+      std::memcpy(out, match, chunk);
+      out += chunk;
+      match_length -= chunk;
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      out == out_end,
+      InvalidProgram,
+      "LZ4 block decompressed to %zu bytes instead of %zu",
+      static_cast<size_t>(out - out_begin),
+      dst_size);
+  return Error::Ok;
+}
+
+Result<FreeableBuffer> DecompressingDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  if (segment_info.compression == SegmentInfo::Compression::None) {
+    return loader_->load(offset, size, segment_info);
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_info.compression == SegmentInfo::Compression::Lz4Blocks,
+      NotSupported,
+      "Unknown compression %d",
+      static_cast<int>(segment_info.compression));
+  const size_t uncompressed_size = segment_info.uncompressed_size;
+  if (uncompressed_size == 0) {
+    return FreeableBuffer(nullptr, 0, /*free_fn=*/nullptr);
+  }
+  uint8_t* const data = static_cast<uint8_t*>(std::malloc(uncompressed_size));
+  ET_CHECK_OR_RETURN_ERROR(
+      data != nullptr,
+      MemoryAllocationFailed,
+      "malloc(%zu) failed",
+      uncompressed_size);
+
+  // The blocks are stored as is in the wrapped data source.
+  SegmentInfo stored_info = segment_info;
+  stored_info.compression = SegmentInfo::Compression::None;
+  stored_info.uncompressed_size = 0;
+  size_t in_pos = 0;
+  size_t out_pos = 0;
+  Error error = Error::Ok;
+  while (error == Error::Ok && in_pos < size) {
+    if (size - in_pos < kBlockHeaderSize) {
+      ET_LOG(Error, "Truncated block header at %zu", in_pos);
+      error = Error::InvalidProgram;
+      break;
+    }
+    auto header =
+        loader_->load(offset + in_pos, kBlockHeaderSize, stored_info);
+    if (!header.ok()) {
+      error = header.error();
+      break;
+    }
+    const auto* header_data = static_cast<const uint8_t*>(header->data());
+    const size_t stored_size = read_le32(header_data);
+    const size_t block_size = read_le32(header_data + 4);
+    header->Free();
+    in_pos += kBlockHeaderSize;
+    if (stored_size > size - in_pos ||
+        block_size > uncompressed_size - out_pos) {
+      ET_LOG(Error, "Block at %zu overflows the segment", in_pos);
+      error = Error::InvalidProgram;
+      break;
+    }
+
+    auto block = loader_->load(offset + in_pos, stored_size, stored_info);
+    if (!block.ok()) {
+      error = block.error();
+      break;
+    }
+    if (stored_size == block_size) {
+      std::memcpy(data + out_pos, block->data(), block_size);
+    } else {
+      error = decompress_lz4_block(
+          block->data(), stored_size, data + out_pos, block_size);
+    }
+    in_pos += stored_size;
+    out_pos += block_size;
+  }
+  if (error == Error::Ok && out_pos != uncompressed_size) {
+    ET_LOG(
+        Error,
+        "Segment decompressed to %zu bytes instead of %zu",
+        out_pos,
+        uncompressed_size);
+    error = Error::InvalidProgram;
+  }
+  if (error != Error::Ok) {
+    std::free(data);
+    return error;
+  }
+  return FreeableBuffer(data, uncompressed_size, free_decompressed);
+}
+
+Error DecompressingDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_info.compression == SegmentInfo::Compression::None,
+      NotSupported,
+      "Compressed data can only be loaded whole");
+  return loader_->load_into(offset, size, segment_info, buffer);
+}
+
+Result<size_t> DecompressingDataLoader::size() const {
+  return loader_->size();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that wraps another DataLoader and decompresses the segments
+ * that the program stores compressed, e.g. constant and delegate segments
+ * serialized with `compress_segments=True`.
+ *
+ * The stored blocks of a segment are loaded from the wrapped loader one at a
+ * time and decompressed straight into the buffer returned to the caller, so
+ * decompression overlaps the reads and needs the memory of one stored block
+ * on top of the decompressed data. Loads of uncompressed data go straight to
+ * the wrapped loader.
+ *
+ * Example:
+ * @code
+ *   auto file_loader = FileDataLoader::from(path);
+ *   DecompressingDataLoader loader(&file_loader.get());
+ *   auto program = Program::load(&loader);
+ * @endcode
+ */
+class DecompressingDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * @param[in] loader The loader to read the stored data from. Must outlive
+   *     this instance.
+   */
+  explicit DecompressingDataLoader(executorch::runtime::DataLoader* loader)
+      : loader_(loader) {}
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+ private:
+  executorch::runtime::DataLoader* const loader_;
+};
+
+/**
+ * Decompresses one block in the LZ4 block format.
+ *
+ * @param[in] src The compressed block.
+ * @param[in] src_size The size of the compressed block in bytes.
+ * @param[out] dst Receives the decompressed data.
+ * @param[in] dst_size The size of the decompressed data in bytes.
+ *
+ * @returns Error::Ok if the block decompresses to exactly `dst_size` bytes,
+ *     or Error::InvalidProgram if it is malformed. Never reads or writes out
+ *     of bounds, whatever the input.
+ */
+ET_NODISCARD executorch::runtime::Error decompress_lz4_block(
+    const void* src,
+    size_t src_size,
+    void* dst,
+    size_t dst_size);
+
+} // namespace extension
+} // namespace executorch
@@ -72,11 +72,15 @@ FileDataLoader::~FileDataLoader() {
   // fd_ can be -1 if this instance was moved from, but closing a negative fd is
   // safe (though it will return an error).
   ::close(fd_);
+  if (direct_fd_ >= 0) {
+    ::close(direct_fd_);
+  }
 }
 
 Result<FileDataLoader> FileDataLoader::from(
     const char* file_name,
-    size_t alignment) {
+    size_t alignment,
+    IoMode io_mode) {
   ET_CHECK_OR_RETURN_ERROR(
       is_power_of_2(alignment),
       InvalidArgument,
@@ -116,7 +120,27 @@ Result<FileDataLoader> FileDataLoader::from(
     return Error::MemoryAllocationFailed;
   }
 
-  return FileDataLoader(fd, file_size, alignment, file_name_copy);
+  // Keep a second descriptor for direct reads; reads that aren't aligned
+  // enough for O_DIRECT still go through `fd`. Without pread(), reads would
+  // have to seek this shared descriptor, so only use it when pread() works.
+  int direct_fd = -1;
+#if ET_HAVE_PREAD && defined(O_DIRECT)
+  if (io_mode == IoMode::Direct) {
+    direct_fd = ::open(file_name, O_RDONLY | O_DIRECT);
+    if (direct_fd < 0) {
+      ET_LOG(
+          Info,
+          "Direct I/O unavailable for %s, using buffered reads: %s (%d)",
+          file_name,
+          ::strerror(errno),
+          errno);
+    }
+  }
+#else
+  (void)io_mode;
+#endif
+
+  return FileDataLoader(fd, file_size, alignment, file_name_copy, direct_fd);
 }
 
 namespace {
@@ -156,9 +180,17 @@ Result<FreeableBuffer> FileDataLoader::load(
     return FreeableBuffer(nullptr, 0, /*free_fn=*/nullptr);
   }
 
+  // For direct reads, place the data at an address that is congruent to its
+  // file offset modulo kDirectIoAlignment. That is only compatible with
+  // `alignment_` if the offset itself is aligned to it.
+  const bool place_for_direct_io = direct_fd_ >= 0 &&
+      alignment_ <= kDirectIoAlignment && (offset & (alignment_ - 1)) == 0;
+
   // Allocate memory for the FreeableBuffer.
   size_t alloc_size = size;
-  if (alignment_ > alignof(std::max_align_t)) {
+  if (place_for_direct_io) {
+    alloc_size += kDirectIoAlignment - 1;
+  } else if (alignment_ > alignof(std::max_align_t)) {
     // malloc() will align to smaller values, but we must manually align to
     // larger values.
     alloc_size += alignment_;
@@ -175,7 +207,11 @@ Result<FreeableBuffer> FileDataLoader::load(
   }
 
   // Align.
-  void* aligned_buffer = align_pointer(buffer, alignment_);
+  void* aligned_buffer = place_for_direct_io
+      ? static_cast<uint8_t*>(buffer) +
+          ((offset - reinterpret_cast<uintptr_t>(buffer)) &
+           (kDirectIoAlignment - 1))
+      : align_pointer(buffer, alignment_);
 
   // Assert that the alignment didn't overflow the buffer.
   ET_DCHECK_MSG(
@@ -219,6 +255,83 @@ Result<size_t> FileDataLoader::size() const {
   return file_size_;
 }
 
+int FileDataLoader::read_fully(
+    int fd,
+    uint8_t* buffer,
+    size_t size,
+    size_t offset) {
+  // Reads on macOS will fail with EINVAL if size > INT32_MAX. Keep chunks a
+  // multiple of kDirectIoAlignment so that direct reads stay aligned.
+  constexpr size_t kMaxChunkSize =
+      static_cast<size_t>(std::numeric_limits<int32_t>::max()) &
+      ~(kDirectIoAlignment - 1);
+  while (size > 0) {
+    const auto chunk_size = std::min<size_t>(size, kMaxChunkSize);
+    const auto nread =
+#if ET_HAVE_PREAD
+        ::pread(fd, buffer, chunk_size, offset);
+#else
+        (::lseek(fd, offset, SEEK_SET) == (off_t)-1)
+        ? -1
+        : ::read(fd, buffer, chunk_size);
+#endif
+    if (nread < 0 && errno == EINTR) {
+      // Interrupted by a signal; zero bytes read.
+      continue;
+    }
+    if (nread < 0) {
+      return errno;
+    }
+    if (nread == 0) {
+      // EOF, which we shouldn't see if we were able to read the full amount.
+      return -1;
+    }
+    size -= nread;
+    buffer += nread;
+    offset += nread;
+  }
+  return 0;
+}
+
+bool FileDataLoader::load_into_direct(
+    size_t offset,
+    size_t size,
+    uint8_t* buffer) const {
+  constexpr size_t kMask = kDirectIoAlignment - 1;
+  if (((reinterpret_cast<uintptr_t>(buffer) - offset) & kMask) != 0) {
+    // The destination and the file offset can never be aligned at once.
+    return false;
+  }
+  const size_t head = (kDirectIoAlignment - (offset & kMask)) & kMask;
+  if (head >= size) {
+    return false;
+  }
+  const size_t body = (size - head) & ~kMask;
+  if (body == 0) {
+    return false;
+  }
+  int err = read_fully(direct_fd_, buffer + head, body, offset + head);
+  if (err != 0) {
+    ET_LOG(
+        Debug,
+        "Direct read of %zu bytes at offset %zu from %s failed: %s",
+        body,
+        offset + head,
+        file_name_,
+        err < 0 ? "EOF" : strerror(err));
+    return false;
+  }
+  // Read the unaligned ends through the page cache.
+  if (head > 0) {
+    err = read_fully(fd_, buffer, head, offset);
+  }
+  const size_t tail = size - head - body;
+  if (err == 0 && tail > 0) {
+    err = read_fully(fd_, buffer + head + body, tail, offset + head + body);
+  }
+  return err == 0;
+}
+
 ET_NODISCARD Error FileDataLoader::load_into(
     size_t offset,
     size_t size,
@@ -240,9 +353,10 @@ ET_NODISCARD Error FileDataLoader::load_into(
   ET_CHECK_OR_RETURN_ERROR(
       buffer != nullptr, InvalidArgument, "Provided buffer cannot be null");
 
-  // Read the data into the aligned address.
-  size_t needed = size;
   uint8_t* buf = reinterpret_cast<uint8_t*>(buffer);
+  if (direct_fd_ >= 0 && load_into_direct(offset, size, buf)) {
+    return Error::Ok;
+  }
 
   // Make a duplicate fd if pread() is not available and we have to seek().
   // Cannot use the standard dup() or fcntl() calls because the returned
@@ -250,44 +364,20 @@ ET_NODISCARD Error FileDataLoader::load_into(
   // when seeking on multiple threads simultaneously.
   const auto dup_fd = ET_HAVE_PREAD ? fd_ : ::open(file_name_, O_RDONLY);
 
-  while (needed > 0) {
-    // Reads on macOS will fail with EINVAL if size > INT32_MAX.
-    const auto chunk_size = std::min<size_t>(
-        needed, static_cast<size_t>(std::numeric_limits<int32_t>::max()));
-    const auto nread =
-#if ET_HAVE_PREAD
-        ::pread(dup_fd, buf, chunk_size, offset);
-#else
-        (::lseek(dup_fd, offset, SEEK_SET) == (off_t)-1)
-        ? -1
-        : ::read(dup_fd, buf, chunk_size);
-#endif
-    if (nread < 0 && errno == EINTR) {
-      // Interrupted by a signal; zero bytes read.
-      continue;
-    }
-    if (nread <= 0) {
-      // nread == 0 means EOF, which we shouldn't see if we were able to read
-      // the full amount. nread < 0 means an error occurred.
-      ET_LOG(
-          Error,
-          "Reading from %s: failed to read %zu bytes at offset %zu: %s",
-          file_name_,
-          size,
-          offset,
-          nread == 0 ? "EOF" : strerror(errno));
-      if (!ET_HAVE_PREAD) {
-        ::close(dup_fd);
-      }
-      return Error::AccessFailed;
-    }
-    needed -= nread;
-    buf += nread;
-    offset += nread;
-  }
+  const int err = read_fully(dup_fd, buf, size, offset);
   if (!ET_HAVE_PREAD) {
     ::close(dup_fd);
   }
+  if (err != 0) {
+    ET_LOG(
+        Error,
+        "Reading from %s: failed to read %zu bytes at offset %zu: %s",
+        file_name_,
+        size,
+        offset,
+        err < 0 ? "EOF" : strerror(err));
+    return Error::AccessFailed;
+  }
   return Error::Ok;
 }
 
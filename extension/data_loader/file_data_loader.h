@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include <executorch/runtime/core/data_loader.h>
 #include <executorch/runtime/core/result.h>
@@ -26,12 +27,33 @@ namespace extension {
  */
 class FileDataLoader final : public executorch::runtime::DataLoader {
  public:
+  /**
+   * Describes whether reads go through the OS page cache.
+   */
+  enum class IoMode {
+    /// Read through the page cache.
+    Buffered,
+    /**
+     * Read with `O_DIRECT` where the host supports it, bypassing the page
+     * cache. Only the parts of a read whose file offset and destination
+     * address are both kDirectIoAlignment-aligned are read directly; the rest
+     * is read through the page cache. load_into() benefits the most, since
+     * callers can size and align their destination buffers for it.
+     */
+    Direct,
+  };
+
+  /// The file offset and memory alignment that direct reads require.
+  static constexpr size_t kDirectIoAlignment = 4096;
+
   /**
    * Creates a new FileDataLoader that wraps the named file.
    *
    * @param[in] file_name Path to the file to read from.
    * @param[in] alignment Alignment in bytes of pointers returned by this
    *     instance. Must be a power of two.
+   * @param[in] io_mode Whether to bypass the page cache. If the file can't be
+   *     opened for direct I/O, falls back to IoMode::Buffered.
    *
    * @returns A new FileDataLoader on success.
    * @retval Error::InvalidArgument `alignment` is not a power of two.
@@ -41,7 +63,8 @@ class FileDataLoader final : public executorch::runtime::DataLoader {
    */
   static executorch::runtime::Result<FileDataLoader> from(
       const char* file_name,
-      size_t alignment = alignof(std::max_align_t));
+      size_t alignment = alignof(std::max_align_t),
+      IoMode io_mode = IoMode::Buffered);
 
   /// DEPRECATED: Use the lowercase `from()` instead.
   ET_DEPRECATED static executorch::runtime::Result<FileDataLoader> From(
@@ -55,11 +78,13 @@ class FileDataLoader final : public executorch::runtime::DataLoader {
       : file_name_(rhs.file_name_),
         file_size_(rhs.file_size_),
         alignment_(rhs.alignment_),
-        fd_(rhs.fd_) {
+        fd_(rhs.fd_),
+        direct_fd_(rhs.direct_fd_) {
     const_cast<const char*&>(rhs.file_name_) = nullptr;
     const_cast<size_t&>(rhs.file_size_) = 0;
     const_cast<size_t&>(rhs.alignment_) = 0;
     const_cast<int&>(rhs.fd_) = -1;
+    const_cast<int&>(rhs.direct_fd_) = -1;
   }
 
   ~FileDataLoader() override;
@@ -83,11 +108,21 @@ class FileDataLoader final : public executorch::runtime::DataLoader {
       int fd,
       size_t file_size,
       size_t alignment,
-      const char* file_name)
+      const char* file_name,
+      int direct_fd)
       : file_name_(file_name),
         file_size_(file_size),
         alignment_(alignment),
-        fd_(fd) {}
+        fd_(fd),
+        direct_fd_(direct_fd) {}
+
+  /// Reads exactly `size` bytes at `offset` on `fd`. Returns 0 on success, or
+  /// an errno value on failure.
+  static int read_fully(int fd, uint8_t* buffer, size_t size, size_t offset);
+
+  /// Reads the aligned middle of the range with `direct_fd_`. Returns true if
+  /// the whole range was read.
+  bool load_into_direct(size_t offset, size_t size, uint8_t* buffer) const;
 
   // Not safely copyable.
   FileDataLoader(const FileDataLoader&) = delete;
@@ -98,6 +133,9 @@ class FileDataLoader final : public executorch::runtime::DataLoader {
   const size_t file_size_;
   const size_t alignment_;
   const int fd_; // Owned by the instance.
+  /// Opened with O_DIRECT if requested and supported, else -1. Owned by the
+  /// instance.
+  const int direct_fd_;
 };
 
 } // namespace extension
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/gguf_data_loader.h>
+
+#include <cinttypes>
+#include <cstring>
+
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+constexpr uint32_t kGGUFMagic = 0x46554747; // "GGUF" in little endian.
+constexpr uint32_t kDefaultAlignment = 32;
+constexpr const char* kAlignmentKey = "general.alignment";
+
+// The gguf_type of metadata values.
+enum ValueType : uint32_t {
+  kUint8 = 0,
+  kInt8 = 1,
+  kUint16 = 2,
+  kInt16 = 3,
+  kUint32 = 4,
+  kInt32 = 5,
+  kFloat32 = 6,
+  kBool = 7,
+  kString = 8,
+  kArray = 9,
+  kUint64 = 10,
+  kInt64 = 11,
+  kFloat64 = 12,
+};
+
+// Reads the little-endian fields of a GGUF header, failing instead of reading
+// past its end.
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  size_t position() const {
+    return position_;
+  }
+
+  bool skip(uint64_t n) {
+    if (n > size_ - position_) {
+      return false;
+    }
+    position_ += n;
+    return true;
+  }
+
+  template <typename T>
+  bool read(T& value) {
+    if (sizeof(T) > size_ - position_) {
+      return false;
+    }
+    std::memcpy(&value, data_ + position_, sizeof(T));
+    position_ += sizeof(T);
+    return true;
+  }
+
+  bool read_string(std::string& value) {
+    uint64_t length;
+    if (!read(length) || length > size_ - position_) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char*>(data_ + position_), length);
+    position_ += length;
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+// Returns the size of a metadata value of a fixed-size type, or zero.
+size_t value_size(uint32_t type) {
+  switch (type) {
+    case kUint8:
+    case kInt8:
+    case kBool:
+      return 1;
+    case kUint16:
+    case kInt16:
+      return 2;
+    case kUint32:
+    case kInt32:
+    case kFloat32:
+      return 4;
+    case kUint64:
+    case kInt64:
+    case kFloat64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+bool skip_value(Reader& reader, uint32_t type, int depth = 0) {
+  if (type == kString) {
+    uint64_t length;
+    return reader.read(length) && reader.skip(length);
+  }
+  if (type == kArray) {
+    uint32_t element_type;
+    uint64_t count;
+    // Arrays of arrays are allowed, but not arbitrarily deep ones.
+    if (depth > 4 || !reader.read(element_type) || !reader.read(count)) {
+      return false;
+    }
+    const size_t element_size = value_size(element_type);
+    if (element_size != 0) {
+      return count <= UINT64_MAX / element_size &&
+          reader.skip(count * element_size);
+    }
+    // Arrays of strings or arrays, e.g. the tokenizer vocabulary.
+    for (uint64_t i = 0; i < count; ++i) {
+      if (!skip_value(reader, element_type, depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  const size_t size = value_size(type);
+  return size != 0 && reader.skip(size);
+}
+
+// Returns the size of a tensor with `num_elements` elements of `type`, or
+// zero if the type is not supported.
+size_t tensor_nbytes(uint32_t type, uint64_t num_elements) {
+  using TensorType = GGUFDataLoader::TensorType;
+  // Quantized types are stored in blocks of 32 elements.
+  constexpr uint64_t kBlockElements = 32;
+  switch (static_cast<TensorType>(type)) {
+    case TensorType::F32:
+      return num_elements * 4;
+    case TensorType::F16:
+    case TensorType::BF16:
+      return num_elements * 2;
+    case TensorType::Q4_0:
+      // A float16 scale and 32 4-bit values.
+      return num_elements % kBlockElements == 0
+          ? num_elements / kBlockElements * 18
+          : 0;
+    case TensorType::Q8_0:
+      // A float16 scale and 32 8-bit values.
+      return num_elements % kBlockElements == 0
+          ? num_elements / kBlockElements * 34
+          : 0;
+  }
+  return 0;
+}
+
+} // namespace
+
+Result<GGUFDataLoader> GGUFDataLoader::from(
+    const char* gguf_path,
+    DataLoader* program_loader,
+    std::unordered_map<std::string, std::string> tensor_names) {
+  ET_CHECK_OR_RETURN_ERROR(
+      program_loader != nullptr, InvalidArgument, "program_loader is null");
+  // The weights are read on demand and may be much larger than RAM, so they
+  // are mapped without locking them in.
+  auto gguf_loader = MmapDataLoader::from(
+      gguf_path, MmapDataLoader::MlockConfig::NoMlock);
+  if (!gguf_loader.ok()) {
+    return gguf_loader.error();
+  }
+  auto file_size = gguf_loader->size();
+  if (!file_size.ok()) {
+    return file_size.error();
+  }
+  // The mapping outlives the loader, which only holds the file descriptor.
+  auto gguf_data = gguf_loader->load(
+      /*offset=*/0,
+      file_size.get(),
+      SegmentInfo(SegmentInfo::Type::Constant));
+  if (!gguf_data.ok()) {
+    return gguf_data.error();
+  }
+
+  Reader reader(
+      static_cast<const uint8_t*>(gguf_data->data()), gguf_data->size());
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t num_tensors = 0;
+  uint64_t num_metadata = 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      reader.read(magic) && magic == kGGUFMagic,
+      InvalidArgument,
+      "%s is not a GGUF file",
+      gguf_path);
+  ET_CHECK_OR_RETURN_ERROR(
+      reader.read(version) && (version == 2 || version == 3),
+      InvalidArgument,
+      "Unsupported GGUF version %" PRIu32,
+      version);
+  ET_CHECK_OR_RETURN_ERROR(
+      reader.read(num_tensors) && reader.read(num_metadata),
+      InvalidArgument,
+      "Truncated GGUF header");
+
+  uint32_t alignment = kDefaultAlignment;
+  for (uint64_t i = 0; i < num_metadata; ++i) {
+    std::string key;
+    uint32_t type;
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read_string(key) && reader.read(type),
+        InvalidArgument,
+        "Truncated GGUF metadata");
+    if (key == kAlignmentKey && type == kUint32) {
+      ET_CHECK_OR_RETURN_ERROR(
+          reader.read(alignment) && alignment != 0 &&
+              (alignment & (alignment - 1)) == 0,
+          InvalidArgument,
+          "Invalid GGUF alignment %" PRIu32,
+          alignment);
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        skip_value(reader, type),
+        InvalidArgument,
+        "Invalid GGUF metadata %s",
+        key.c_str());
+  }
+
+  std::unordered_map<std::string, TensorInfo> tensors;
+  for (uint64_t i = 0; i < num_tensors; ++i) {
+    std::string name;
+    TensorInfo info;
+    uint32_t num_dims;
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read_string(name) && reader.read(num_dims) && num_dims <= 8,
+        InvalidArgument,
+        "Invalid GGUF tensor info %" PRIu64,
+        i);
+    uint64_t num_elements = 1;
+    info.dims.resize(num_dims);
+    for (auto& dim : info.dims) {
+      ET_CHECK_OR_RETURN_ERROR(
+          reader.read(dim) &&
+              (dim == 0 || num_elements <= UINT64_MAX / 8 / dim),
+          InvalidArgument,
+          "Invalid dims for GGUF tensor %s",
+          name.c_str());
+      num_elements *= dim;
+    }
+    uint64_t offset;
+    ET_CHECK_OR_RETURN_ERROR(
+        reader.read(info.type) && reader.read(offset),
+        InvalidArgument,
+        "Invalid GGUF tensor info for %s",
+        name.c_str());
+    // Offsets are relative to the data section, fixed up below.
+    info.offset = offset;
+    info.nbytes = tensor_nbytes(info.type, num_elements);
+    tensors.emplace(std::move(name), std::move(info));
+  }
+
+  // The data section starts at the next multiple of the alignment.
+  const size_t data_offset =
+      (reader.position() + alignment - 1) / alignment * alignment;
+  ET_CHECK_OR_RETURN_ERROR(
+      data_offset <= gguf_data->size() || tensors.empty(),
+      InvalidArgument,
+      "Truncated GGUF data");
+  for (auto& entry : tensors) {
+    auto& info = entry.second;
+    ET_CHECK_OR_RETURN_ERROR(
+        info.offset <= gguf_data->size() - data_offset &&
+            info.nbytes <= gguf_data->size() - data_offset - info.offset,
+        InvalidArgument,
+        "GGUF tensor %s overflows the file",
+        entry.first.c_str());
+    info.offset += data_offset;
+  }
+
+  return GGUFDataLoader(
+      program_loader,
+      std::move(gguf_data.get()),
+      std::move(tensors),
+      std::move(tensor_names));
+}
+
+const GGUFDataLoader::TensorInfo* GGUFDataLoader::tensor_info(
+    const std::string& name) const {
+  const auto it = tensors_.find(name);
+  return it != tensors_.end() ? &it->second : nullptr;
+}
+
+const GGUFDataLoader::TensorInfo* GGUFDataLoader::find_tensor(
+    const SegmentInfo& segment_info) const {
+  if (segment_info.descriptor == nullptr ||
+      (segment_info.segment_type != SegmentInfo::Type::Constant &&
+       segment_info.segment_type != SegmentInfo::Type::Backend)) {
+    return nullptr;
+  }
+  const std::string name = segment_info.descriptor;
+  const auto renamed = tensor_names_.find(name);
+  return tensor_info(renamed != tensor_names_.end() ? renamed->second : name);
+}
+
+Result<const void*> GGUFDataLoader::tensor_data(
+    const TensorInfo& tensor,
+    size_t size,
+    const SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      tensor.nbytes != 0,
+      NotSupported,
+      "GGUF tensor %s has unsupported type %" PRIu32,
+      segment_info.descriptor,
+      tensor.type);
+  // Compressed named data would be decompressed to this size.
+  const size_t expected_size =
+      segment_info.compression == SegmentInfo::Compression::None
+      ? size
+      : segment_info.uncompressed_size;
+  ET_CHECK_OR_RETURN_ERROR(
+      tensor.nbytes == expected_size,
+      InvalidArgument,
+      "GGUF tensor %s has %zu bytes, but the program expects %zu",
+      segment_info.descriptor,
+      tensor.nbytes,
+      expected_size);
+  return static_cast<const uint8_t*>(gguf_data_.data()) + tensor.offset;
+}
+
+Result<FreeableBuffer> GGUFDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  const TensorInfo* tensor = find_tensor(segment_info);
+  if (tensor == nullptr) {
+    return program_loader_->load(offset, size, segment_info);
+  }
+  auto data = tensor_data(*tensor, size, segment_info);
+  if (!data.ok()) {
+    return data.error();
+  }
+  // The mapping of the whole file owns the data.
+  return FreeableBuffer(data.get(), tensor->nbytes, /*free_fn=*/nullptr);
+}
+
+Error GGUFDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  const TensorInfo* tensor = find_tensor(segment_info);
+  if (tensor == nullptr) {
+    return program_loader_->load_into(offset, size, segment_info, buffer);
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_info.compression == SegmentInfo::Compression::None,
+      NotSupported,
+      "Compressed data can only be loaded whole");
+  auto data = tensor_data(*tensor, size, segment_info);
+  if (!data.ok()) {
+    return data.error();
+  }
+  std::memcpy(buffer, data.get(), tensor->nbytes);
+  return Error::Ok;
+}
+
+Result<size_t> GGUFDataLoader::size() const {
+  return program_loader_->size();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that wraps the DataLoader of a program and serves named
+ * tensors from the memory-mapped weights of a GGUF file, e.g. the Q4_0 or
+ * Q8_0 weights of a community-quantized LLM, without converting them.
+ *
+ * Loads whose SegmentInfo descriptor names a tensor of the GGUF file return
+ * its data in place in the mapping. Those are the constants of a program
+ * loaded with Program::ConstantLoading::Lazy that records their fully
+ * qualified names, and the named data of its delegates. All other loads go to
+ * the program's loader. The program's tensor must have exactly the size of
+ * the GGUF data, e.g. a uint8 tensor of the raw blocks consumed by
+ * llama::linear_q4_0, and otherwise the load fails.
+ *
+ * Example:
+ * @code
+ *   auto program_loader = MmapDataLoader::from(pte_path);
+ *   auto loader = GGUFDataLoader::from(gguf_path, &program_loader.get());
+ *   auto program = Program::load(
+ *       &loader.get(),
+ *       Program::Verification::Minimal,
+ *       Program::ConstantLoading::Lazy);
+ * @endcode
+ */
+class GGUFDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /// The ggml_type values of the tensor types whose size is known.
+  enum class TensorType : uint32_t {
+    F32 = 0,
+    F16 = 1,
+    Q4_0 = 2,
+    Q8_0 = 8,
+    BF16 = 30,
+  };
+
+  /// Describes a tensor of the GGUF file.
+  struct TensorInfo {
+    /// The ggml_type of the tensor, one of TensorType if it is supported.
+    uint32_t type;
+    /// The dimensions of the tensor, innermost first as stored in GGUF.
+    std::vector<uint64_t> dims;
+    /// The offset of the data from the start of the file.
+    size_t offset;
+    /// The size of the data in bytes; zero if the type is not supported.
+    size_t nbytes;
+  };
+
+  /**
+   * Creates a new GGUFDataLoader that maps the GGUF file and wraps the loader
+   * of the program.
+   *
+   * @param[in] gguf_path The path to the GGUF file.
+   * @param[in] program_loader The loader of the program. Must outlive this
+   *     instance.
+   * @param[in] tensor_names Maps the names that the program gives tensors to
+   *     the names of the GGUF file, e.g. "layers.0.attention.wq.weight" to
+   *     "blk.0.attn_q.weight". Names that aren't in it are looked up as is.
+   *
+   * @returns A new GGUFDataLoader, or Error::InvalidArgument if the file is
+   *     not a valid GGUF file of version 2 or 3.
+   */
+  static executorch::runtime::Result<GGUFDataLoader> from(
+      const char* gguf_path,
+      executorch::runtime::DataLoader* program_loader,
+      std::unordered_map<std::string, std::string> tensor_names = {});
+
+  GGUFDataLoader(GGUFDataLoader&&) = default;
+
+  /**
+   * Returns the tensor of the GGUF file named `name`, or nullptr if there is
+   * none. Names are those of the GGUF file.
+   */
+  const TensorInfo* tensor_info(const std::string& name) const;
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+ private:
+  GGUFDataLoader(
+      executorch::runtime::DataLoader* program_loader,
+      executorch::runtime::FreeableBuffer&& gguf_data,
+      std::unordered_map<std::string, TensorInfo>&& tensors,
+      std::unordered_map<std::string, std::string>&& tensor_names)
+      : program_loader_(program_loader),
+        gguf_data_(std::move(gguf_data)),
+        tensors_(std::move(tensors)),
+        tensor_names_(std::move(tensor_names)) {}
+
+  // Returns the GGUF tensor that a load with `segment_info` refers to, or
+  // nullptr if it must go to the program's loader.
+  const TensorInfo* find_tensor(const SegmentInfo& segment_info) const;
+
+  // Returns the data of `tensor` if it has the size that the program expects.
+  executorch::runtime::Result<const void*> tensor_data(
+      const TensorInfo& tensor,
+      size_t size,
+      const SegmentInfo& segment_info) const;
+
+  executorch::runtime::DataLoader* program_loader_;
+  /// The whole GGUF file, mapped read-only.
+  executorch::runtime::FreeableBuffer gguf_data_;
+  std::unordered_map<std::string, TensorInfo> tensors_;
+  std::unordered_map<std::string, std::string> tensor_names_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -14,6 +14,7 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -55,6 +56,19 @@ Range get_overlapping_pages(uintptr_t offset, size_t size, size_t page_size) {
   };
 }
 
+/**
+ * The size of a transparent huge page. 2 MiB is the PMD size on x86-64 and on
+ * arm64 with 4 KiB base pages, which covers the hosts that support them.
+ */
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+/**
+ * Set in the FreeableBuffer context of segments that should be reclaimed when
+ * freed. The context otherwise holds the page size, a power of 2 that is
+ * larger than 1, so the low bit is always free.
+ */
+constexpr uintptr_t kReleaseOnFreeBit = 1;
+
 } // namespace
 
 MmapDataLoader::~MmapDataLoader() {
@@ -69,6 +83,13 @@ MmapDataLoader::~MmapDataLoader() {
 Result<MmapDataLoader> MmapDataLoader::from(
     const char* file_name,
     MmapDataLoader::MlockConfig mlock_config) {
+  return from(file_name, mlock_config, AccessConfig());
+}
+
+Result<MmapDataLoader> MmapDataLoader::from(
+    const char* file_name,
+    MmapDataLoader::MlockConfig mlock_config,
+    const MmapDataLoader::AccessConfig& access_config) {
   // Cache the page size.
   long page_size = sysconf(_SC_PAGESIZE);
   if (page_size < 0) {
@@ -120,20 +141,44 @@ Result<MmapDataLoader> MmapDataLoader::from(
       file_size,
       file_name_copy,
       static_cast<size_t>(page_size),
-      mlock_config);
+      mlock_config,
+      access_config);
+}
+
+Result<MmapDataLoader::PageFaultCounts> MmapDataLoader::page_fault_counts() {
+  struct rusage usage;
+  if (::getrusage(RUSAGE_SELF, &usage) < 0) {
+    ET_LOG(Error, "getrusage() failed: %s (%d)", ::strerror(errno), errno);
+    return Error::NotSupported;
+  }
+  return PageFaultCounts{
+      /*minor=*/static_cast<size_t>(usage.ru_minflt),
+      /*major=*/static_cast<size_t>(usage.ru_majflt),
+  };
 }
 
 namespace {
 /**
  * FreeableBuffer::FreeFn-compatible callback.
  *
- * `context` is actually the OS page size as a uintptr_t.
+ * `context` is actually the OS page size as a uintptr_t, possibly with
+ * kReleaseOnFreeBit set.
  */
 void MunmapSegment(void* context, void* data, size_t size) {
-  const uintptr_t page_size = reinterpret_cast<uintptr_t>(context);
+  const uintptr_t bits = reinterpret_cast<uintptr_t>(context);
+  const uintptr_t page_size = bits & ~kReleaseOnFreeBit;
 
   Range range =
       get_overlapping_pages(reinterpret_cast<uintptr_t>(data), size, page_size);
+  if (bits & kReleaseOnFreeBit) {
+    // Unmapping alone leaves the pages in the page cache. Ask the kernel to
+    // reclaim them now; this is only a hint, so ignore failures.
+#if defined(MADV_PAGEOUT)
+    ::madvise(reinterpret_cast<void*>(range.start), range.size, MADV_PAGEOUT);
+#elif defined(MADV_DONTNEED)
+    ::madvise(reinterpret_cast<void*>(range.start), range.size, MADV_DONTNEED);
+#endif
+  }
   int ret = ::munmap(reinterpret_cast<void*>(range.start), range.size);
   if (ret < 0) {
     // Let the user know that something went wrong, but there's nothing we can
@@ -149,6 +194,99 @@ void MunmapSegment(void* context, void* data, size_t size) {
 }
 } // namespace
 
+void* MmapDataLoader::map_pages(uintptr_t start, size_t size) const {
+#if defined(MADV_HUGEPAGE) && defined(MAP_ANONYMOUS) && defined(MAP_FIXED)
+  if (access_config_.huge_pages && size >= kHugePageSize) {
+    // The kernel can only back a file mapping with huge pages where the
+    // virtual address and the file offset agree modulo the huge page size,
+    // which mmap() alone doesn't guarantee. Reserve enough address space to
+    // find such an address, map the file over it, and return the slack.
+    const size_t reserved_size = size + kHugePageSize;
+    void* reserved = ::mmap(
+        nullptr,
+        reserved_size,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        /*fd=*/-1,
+        /*offset=*/0);
+    if (reserved != MAP_FAILED) {
+      const uintptr_t base = reinterpret_cast<uintptr_t>(reserved);
+      const uintptr_t addr = base + ((start - base) & (kHugePageSize - 1));
+      void* pages = ::mmap(
+          reinterpret_cast<void*>(addr),
+          size,
+          PROT_READ,
+          MAP_PRIVATE | MAP_FIXED,
+          fd_,
+          static_cast<off_t>(start));
+      if (pages == MAP_FAILED) {
+        ::munmap(reserved, reserved_size);
+        return MAP_FAILED;
+      }
+      if (addr > base) {
+        ::munmap(reserved, addr - base);
+      }
+      const uintptr_t end = addr + size;
+      if (base + reserved_size > end) {
+        ::munmap(reinterpret_cast<void*>(end), base + reserved_size - end);
+      }
+      if (::madvise(pages, size, MADV_HUGEPAGE) < 0) {
+        ET_LOG(
+            Debug,
+            "Ignoring madvise(MADV_HUGEPAGE) error for file %s: %s (%d)",
+            file_name_,
+            ::strerror(errno),
+            errno);
+      }
+      return pages;
+    }
+    // Fall back to a regular mapping if the reservation failed.
+  }
+#endif
+  // Map the pages read-only. MAP_PRIVATE vs. MAP_SHARED doesn't matter since
+  // the data is read-only, but use PRIVATE just to further avoid accidentally
+  // modifying the file.
+  return ::mmap(
+      nullptr, size, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(start));
+}
+
+void MmapDataLoader::advise_pages(void* pages, size_t size) const {
+  int advice[2];
+  size_t num_advice = 0;
+  switch (access_config_.pattern) {
+    case AccessPattern::Normal:
+      break;
+    case AccessPattern::Sequential:
+#if defined(MADV_SEQUENTIAL)
+      advice[num_advice++] = MADV_SEQUENTIAL;
+#endif
+      break;
+    case AccessPattern::Random:
+#if defined(MADV_RANDOM)
+      advice[num_advice++] = MADV_RANDOM;
+#endif
+      break;
+  }
+#if defined(MADV_WILLNEED)
+  if (access_config_.will_need) {
+    advice[num_advice++] = MADV_WILLNEED;
+  }
+#endif
+  for (size_t i = 0; i < num_advice; ++i) {
+    if (::madvise(pages, size, advice[i]) < 0) {
+      ET_LOG(
+          Debug,
+          "Ignoring madvise(%p, %zu, %d) error for file %s: %s (%d)",
+          pages,
+          size,
+          advice[i],
+          file_name_,
+          ::strerror(errno),
+          errno);
+    }
+  }
+}
+
 Result<FreeableBuffer> MmapDataLoader::load(
     size_t offset,
     size_t size,
@@ -182,16 +320,7 @@ Result<FreeableBuffer> MmapDataLoader::load(
   Range range =
       get_overlapping_pages(static_cast<uintptr_t>(offset), size, page_size_);
 
-  // Map the pages read-only. MAP_PRIVATE vs. MAP_SHARED doesn't matter since
-  // the data is read-only, but use PRIVATE just to further avoid accidentally
-  // modifying the file.
-  void* pages = ::mmap(
-      nullptr,
-      range.size,
-      PROT_READ,
-      MAP_PRIVATE,
-      fd_,
-      static_cast<off_t>(range.start));
+  void* pages = map_pages(range.start, range.size);
   ET_CHECK_OR_RETURN_ERROR(
       pages != MAP_FAILED,
       AccessFailed,
@@ -201,6 +330,8 @@ Result<FreeableBuffer> MmapDataLoader::load(
       fd_,
       range.start);
 
+  advise_pages(pages, range.size);
+
   if (mlock_config_ == MlockConfig::UseMlock ||
       mlock_config_ == MlockConfig::UseMlockIgnoreErrors) {
     int err = ::mlock(pages, size);
@@ -245,7 +376,8 @@ Result<FreeableBuffer> MmapDataLoader::load(
       reinterpret_cast<void*>(
           // Pass the cached OS page size to the callback so it doesn't need to
           // query it again.
-          static_cast<uintptr_t>(page_size_)));
+          static_cast<uintptr_t>(page_size_) |
+          (access_config_.release_on_free ? kReleaseOnFreeBit : 0)));
 }
 
 Result<size_t> MmapDataLoader::size() const {
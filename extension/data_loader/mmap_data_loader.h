@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <executorch/runtime/core/data_loader.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/compiler.h>
@@ -16,8 +18,13 @@ namespace executorch {
 namespace extension {
 
 /**
- * A DataLoader that loads segments from a file, allocating the memory
- * with `malloc()`.
+ * A DataLoader that loads segments from a file by mapping them with `mmap()`.
+ *
+ * Loaded data is never copied: it points into read-only mapped pages, which
+ * are shared through the page cache with every other process that maps the
+ * same file, and has the same alignment relative to the page size in memory
+ * as in the file. Programs serialized with page-aligned segments and constant
+ * tensors thus get page-aligned constants that Methods use in place.
  *
  * Note that this will keep the file open for the duration of its lifetime, to
  * avoid the overhead of opening it again for every load() call.
@@ -40,6 +47,48 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
     UseMlockIgnoreErrors,
   };
 
+  /**
+   * Describes how loaded pages are expected to be read, passed to the kernel
+   * with `madvise()`.
+   */
+  enum class AccessPattern {
+    /// Do not give an access pattern hint.
+    Normal,
+    /// Pages will be read in order; read ahead aggressively
+    /// (`MADV_SEQUENTIAL`).
+    Sequential,
+    /// Pages will be read in no particular order; disable read-ahead
+    /// (`MADV_RANDOM`).
+    Random,
+  };
+
+  /**
+   * Paging hints for loaded segments. All of them are advisory: if the host
+   * doesn't support one, or the kernel rejects it, the load still succeeds.
+   */
+  struct AccessConfig {
+    /// The expected access pattern of the mapped pages.
+    AccessPattern pattern = AccessPattern::Normal;
+    /// Start reading the pages in the background as soon as they are mapped
+    /// (`MADV_WILLNEED`), so that the first accesses fault less.
+    bool will_need = false;
+    /// Align mappings of at least one huge page so that the kernel can back
+    /// them with transparent huge pages, and request them (`MADV_HUGEPAGE`).
+    bool huge_pages = false;
+    /// When a segment is freed, ask the kernel to reclaim its pages
+    /// (`MADV_PAGEOUT`, or `MADV_DONTNEED` where that is unavailable) instead
+    /// of leaving them in the page cache.
+    bool release_on_free = false;
+  };
+
+  /// Process-wide page fault counters; see page_fault_counts().
+  struct PageFaultCounts {
+    /// Faults served without I/O, e.g. from the page cache.
+    size_t minor;
+    /// Faults that had to read from storage.
+    size_t major;
+  };
+
   /**
    * Creates a new MmapDataLoader that wraps the named file. Fails if
    * the file can't be opened for reading or if its size can't be found.
@@ -54,6 +103,28 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
       const char* file_name,
       MlockConfig mlock_config = MlockConfig::UseMlock);
 
+  /**
+   * Creates a new MmapDataLoader that wraps the named file and applies the
+   * paging hints in `access_config` to every loaded segment.
+   *
+   * @param[in] file_name The path to the file to load from.
+   * @param[in] mlock_config How and whether to lock loaded pages with
+   *     `mlock()`.
+   * @param[in] access_config The `madvise()` hints to give for loaded pages.
+   */
+  static executorch::runtime::Result<MmapDataLoader> from(
+      const char* file_name,
+      MlockConfig mlock_config,
+      const AccessConfig& access_config);
+
+  /**
+   * Returns the number of page faults that the current process has taken so
+   * far. Sample it before and after loading and running a model to measure
+   * the effect of an AccessConfig. Fails with NotSupported if the host can't
+   * report page faults.
+   */
+  static executorch::runtime::Result<PageFaultCounts> page_fault_counts();
+
   /// DEPRECATED: Use the lowercase `from()` instead.
   ET_DEPRECATED static executorch::runtime::Result<MmapDataLoader> From(
       const char* file_name,
@@ -77,7 +148,8 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
         file_size_(rhs.file_size_),
         page_size_(rhs.page_size_),
         fd_(rhs.fd_),
-        mlock_config_(rhs.mlock_config_) {
+        mlock_config_(rhs.mlock_config_),
+        access_config_(rhs.access_config_) {
     const_cast<const char*&>(rhs.file_name_) = nullptr;
     const_cast<size_t&>(rhs.file_size_) = 0;
     const_cast<size_t&>(rhs.page_size_) = 0;
@@ -101,12 +173,21 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
       size_t file_size,
       const char* file_name,
       size_t page_size,
-      MlockConfig mlock_config)
+      MlockConfig mlock_config,
+      const AccessConfig& access_config)
       : file_name_(file_name),
         file_size_(file_size),
         page_size_(page_size),
         fd_(fd),
-        mlock_config_(mlock_config) {}
+        mlock_config_(mlock_config),
+        access_config_(access_config) {}
+
+  /// Maps `size` bytes of the file at the page-aligned offset `start`,
+  /// honoring `access_config_.huge_pages`.
+  void* map_pages(uintptr_t start, size_t size) const;
+
+  /// Applies the access pattern and read-ahead hints to mapped pages.
+  void advise_pages(void* pages, size_t size) const;
 
   // Not safely copyable.
   MmapDataLoader(const MmapDataLoader&) = delete;
@@ -118,6 +199,7 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
   const size_t page_size_;
   const int fd_; // Owned by the instance.
   const MlockConfig mlock_config_;
+  const AccessConfig access_config_;
 };
 
 } // namespace extension
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/prefetching_data_loader.h>
+
+#include <cinttypes>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+PrefetchingDataLoader::PrefetchingDataLoader(
+    executorch::runtime::DataLoader* loader)
+    : loader_(loader), worker_([this]() { run_worker(); }) {}
+
+PrefetchingDataLoader::~PrefetchingDataLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+  // Unclaimed data is freed when requests_ is destroyed.
+}
+
+void PrefetchingDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(Request{
+        offset,
+        size,
+        segment_info,
+        Request::State::Queued,
+        /*claimed=*/false,
+        Error::Ok,
+        std::nullopt});
+  }
+  cv_.notify_all();
+}
+
+void PrefetchingDataLoader::run_worker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    auto it = requests_.begin();
+    while (it != requests_.end() && it->state != Request::State::Queued) {
+      ++it;
+    }
+    if (it == requests_.end()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    // load() waits for requests in this state instead of erasing them, so
+    // `it` stays valid while the lock is released.
+    it->state = Request::State::Loading;
+    const size_t offset = it->offset;
+    const size_t size = it->size;
+    const SegmentInfo segment_info = it->segment_info;
+    lock.unlock();
+    Result<FreeableBuffer> data = loader_->load(offset, size, segment_info);
+    lock.lock();
+
+    if (data.ok()) {
+      it->data.emplace(std::move(data.get()));
+      it->error = Error::Ok;
+    } else {
+      it->error = data.error();
+    }
+    it->state = Request::State::Done;
+    cv_.notify_all();
+  }
+}
+
+Result<FreeableBuffer> PrefetchingDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = requests_.begin(); it != requests_.end(); ++it) {
+      if (it->claimed || it->offset != offset || it->size != size) {
+        continue;
+      }
+      if (it->state == Request::State::Queued) {
+        // Not started yet; reading it here is at least as fast as waiting.
+        requests_.erase(it);
+        break;
+      }
+      it->claimed = true;
+      cv_.wait(lock, [&]() { return it->state == Request::State::Done; });
+      if (it->error == Error::Ok) {
+        FreeableBuffer data(std::move(*it->data));
+        requests_.erase(it);
+        ++num_prefetch_hits_;
+        return data;
+      }
+      // Retry the failed read below, so the caller sees a fresh error.
+      ET_LOG(
+          Info,
+          "Prefetch of offset %zu size %zu failed: 0x%" PRIx32 "; retrying",
+          offset,
+          size,
+          static_cast<uint32_t>(it->error));
+      requests_.erase(it);
+      break;
+    }
+  }
+  return loader_->load(offset, size, segment_info);
+}
+
+Error PrefetchingDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  // The destination is only known now, so there is nothing to prefetch into.
+  return loader_->load_into(offset, size, segment_info, buffer);
+}
+
+Result<size_t> PrefetchingDataLoader::size() const {
+  return loader_->size();
+}
+
+size_t PrefetchingDataLoader::num_prefetch_hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_prefetch_hits_;
+}
+
+} // namespace extension
+} // namespace executorch
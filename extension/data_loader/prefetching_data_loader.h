@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that wraps another DataLoader and reads ahead on a background
+ * thread, so that the I/O for segments like delegate blobs and constants
+ * overlaps with Program::load() and Method::init() parsing.
+ *
+ * Callers describe the reads that will come with prefetch(). Each call queues
+ * a load of the wrapped loader on the background thread. When load() is later
+ * called with the same offset and size, it returns the prefetched data,
+ * waiting for the read to finish if it is still in flight. Other loads go
+ * straight to the wrapped loader.
+ *
+ * Example:
+ * @code
+ *   auto file_loader = FileDataLoader::from(path);
+ *   PrefetchingDataLoader loader(&file_loader.get());
+ *   // Offsets from the program's extended header and segment table.
+ *   loader.prefetch(
+ *       segment_base_offset + constant_offset,
+ *       constant_size,
+ *       SegmentInfo(SegmentInfo::Type::Constant, 0));
+ *   auto program = Program::load(&loader);
+ * @endcode
+ */
+class PrefetchingDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * Creates a new PrefetchingDataLoader and starts its background thread.
+   *
+   * @param[in] loader The loader to read from. Must be thread-safe, as
+   *     required by the DataLoader interface, and must outlive this instance.
+   */
+  explicit PrefetchingDataLoader(executorch::runtime::DataLoader* loader);
+
+  /// Waits for the read in progress, if any, and frees unclaimed data.
+  ~PrefetchingDataLoader() override;
+
+  /**
+   * Queues a read of `size` bytes at `offset` and returns immediately. Reads
+   * are issued in the order they are queued.
+   *
+   * @param[in] offset The byte offset in the data source to start loading
+   *     from.
+   * @param[in] size The number of bytes to load.
+   * @param[in] segment_info Information about the segment being loaded. Its
+   *     descriptor, if any, must stay valid until the data is claimed.
+   */
+  void prefetch(size_t offset, size_t size, const SegmentInfo& segment_info);
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+  /// Returns the number of load() calls that were served by a prefetch.
+  size_t num_prefetch_hits() const;
+
+ private:
+  struct Request {
+    enum class State { Queued, Loading, Done };
+
+    size_t offset;
+    size_t size;
+    SegmentInfo segment_info;
+    State state;
+    /// True once a load() call has taken ownership of this request.
+    bool claimed;
+    executorch::runtime::Error error;
+    std::optional<executorch::runtime::FreeableBuffer> data;
+  };
+
+  // Not copyable or movable: the background thread points to this instance.
+  PrefetchingDataLoader(const PrefetchingDataLoader&) = delete;
+  PrefetchingDataLoader& operator=(const PrefetchingDataLoader&) = delete;
+  PrefetchingDataLoader(PrefetchingDataLoader&&) = delete;
+  PrefetchingDataLoader& operator=(PrefetchingDataLoader&&) = delete;
+
+  void run_worker();
+
+  executorch::runtime::DataLoader* const loader_;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cv_;
+  /// Requests that load() has not consumed yet, in prefetch() order.
+  mutable std::list<Request> requests_;
+  mutable size_t num_prefetch_hits_ = 0;
+  bool stop_ = false;
+
+  std::thread worker_;
+};
+
+} // namespace extension
+} // namespace executorch
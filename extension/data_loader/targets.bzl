@@ -67,3 +67,45 @@ def define_common_targets():
             "//executorch/runtime/core:core",
         ],
     )
+
+    runtime.cxx_library(
+        name = "decompressing_data_loader",
+        srcs = ["decompressing_data_loader.cpp"],
+        exported_headers = ["decompressing_data_loader.h"],
+        visibility = [
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "gguf_data_loader",
+        srcs = ["gguf_data_loader.cpp"],
+        exported_headers = ["gguf_data_loader.h"],
+        visibility = [
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            ":mmap_data_loader",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "prefetching_data_loader",
+        srcs = ["prefetching_data_loader.cpp"],
+        exported_headers = ["prefetching_data_loader.h"],
+        visibility = [
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/decompressing_data_loader.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::decompress_lz4_block;
+using executorch::extension::DecompressingDataLoader;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace {
+
+// "abc" then a match of 12 bytes 3 back, then the literal "X".
+const std::vector<uint8_t> kRepeatBlock = {
+    0x38, 'a', 'b', 'c', 0x03, 0x00, 0x10, 'X'};
+const std::string kRepeatText = "abcabcabcabcabcX";
+
+// A zero then a match of 100 bytes 1 back, whose length takes an extra byte.
+const std::vector<uint8_t> kZerosBlock = {0x1F, 0x00, 0x01, 0x00, 81};
+
+// Blocks produced by LZ4_compress_default() of the reference LZ4 library
+// (version 1.9.4), as hex, with the data they decode to.
+struct ReferenceBlock {
+  const char* hex;
+  std::string data;
+};
+
+std::vector<ReferenceBlock> reference_blocks() {
+  std::string text;
+  for (int i = 0; i < 4; ++i) {
+    text += "The quick brown fox jumps over the lazy dog. ";
+  }
+  text += "The end.";
+  std::string literals;
+  for (int i = 0; i < 3; ++i) {
+    for (char c = 0; c < 40; ++c) {
+      literals.push_back(c);
+    }
+  }
+  literals += "end of data.";
+  std::string rows;
+  for (int i = 0; i < 12; ++i) {
+    rows += "row " + std::to_string(i % 3) + ": value " +
+        std::to_string(i % 5) + ";";
+  }
+  return {
+      {"ff1e54686520717569636b2062726f776e20666f78206a756d7073206f766572"
+       "20746865206c617a7920646f672e202d00775020656e642e",
+       text},
+      {"1f000100ffffffd7507461696c21", std::string(1000, '\0') + "tail!"},
+      {"ff19000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d"
+       "1e1f202122232425262728003dc0656e64206f6620646174612e",
+       literals},
+      {"f000726f7720303a2076616c756520303b0f0014310f0011310f0014320f0011"
+       "320f00052d0011330f00052d0011340f00052d00024b00052d00024b00052d00"
+       "024b00052d00024b00052d00024b00052d00024b00b0323a2076616c75652031"
+       "3b",
+       rows},
+  };
+}
+
+std::vector<uint8_t> from_hex(const char* hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; hex[i] != '\0' && hex[i + 1] != '\0'; i += 2) {
+    bytes.push_back(
+        static_cast<uint8_t>(std::stoi(std::string(hex + i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+void append_block(
+    std::vector<uint8_t>& segment,
+    const std::vector<uint8_t>& stored,
+    uint32_t uncompressed_size) {
+  for (uint32_t value : {static_cast<uint32_t>(stored.size()),
+                         uncompressed_size}) {
+    for (int shift = 0; shift < 32; shift += 8) {
+      segment.push_back(static_cast<uint8_t>(value >> shift));
+    }
+  }
+  segment.insert(segment.end(), stored.begin(), stored.end());
+}
+
+DataLoader::SegmentInfo compressed_info(size_t uncompressed_size) {
+  DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Constant, 0);
+  info.compression = DataLoader::SegmentInfo::Compression::Lz4Blocks;
+  info.uncompressed_size = uncompressed_size;
+  return info;
+}
+
+} // namespace
+
+class DecompressingDataLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(DecompressingDataLoaderTest, DecompressesLz4Blocks) {
+  std::vector<uint8_t> out(kRepeatText.size());
+  EXPECT_EQ(
+      decompress_lz4_block(
+          kRepeatBlock.data(), kRepeatBlock.size(), out.data(), out.size()),
+      Error::Ok);
+  EXPECT_EQ(std::string(out.begin(), out.end()), kRepeatText);
+
+  out.assign(101, 0xFF);
+  EXPECT_EQ(
+      decompress_lz4_block(
+          kZerosBlock.data(), kZerosBlock.size(), out.data(), out.size()),
+      Error::Ok);
+  EXPECT_EQ(out, std::vector<uint8_t>(101, 0));
+
+  // 20 literals, whose length takes an extra byte.
+  std::vector<uint8_t> literals = {0xF0, 5};
+  for (uint8_t i = 0; i < 20; ++i) {
+    literals.push_back(i);
+  }
+  out.resize(20);
+  EXPECT_EQ(
+      decompress_lz4_block(
+          literals.data(), literals.size(), out.data(), out.size()),
+      Error::Ok);
+  EXPECT_TRUE(std::equal(out.begin(), out.end(), literals.begin() + 2));
+}
+
+TEST_F(DecompressingDataLoaderTest, DecompressesReferenceLz4Blocks) {
+  for (const ReferenceBlock& reference : reference_blocks()) {
+    const std::vector<uint8_t> block = from_hex(reference.hex);
+    std::vector<uint8_t> out(reference.data.size());
+    EXPECT_EQ(
+        decompress_lz4_block(block.data(), block.size(), out.data(), out.size()),
+        Error::Ok);
+    EXPECT_EQ(std::string(out.begin(), out.end()), reference.data);
+  }
+}
+
+TEST_F(DecompressingDataLoaderTest, RejectsMalformedBlocks) {
+  std::vector<uint8_t> out(kRepeatText.size());
+  // The block decompresses to fewer bytes than expected.
+  EXPECT_EQ(
+      decompress_lz4_block(
+          kRepeatBlock.data(), kRepeatBlock.size(), out.data(), out.size() + 1),
+      Error::InvalidProgram);
+  // And doesn't fit in fewer.
+  EXPECT_EQ(
+      decompress_lz4_block(
+          kRepeatBlock.data(), kRepeatBlock.size(), out.data(), out.size() - 1),
+      Error::InvalidProgram);
+  // A match can't reach before the start of the block.
+  std::vector<uint8_t> block = kRepeatBlock;
+  block[4] = 4;
+  EXPECT_EQ(
+      decompress_lz4_block(block.data(), block.size(), out.data(), out.size()),
+      Error::InvalidProgram);
+  block[4] = 0;
+  EXPECT_EQ(
+      decompress_lz4_block(block.data(), block.size(), out.data(), out.size()),
+      Error::InvalidProgram);
+  // Nor can literals run past the end of the input.
+  block = {0x50, 'a', 'b'};
+  EXPECT_EQ(
+      decompress_lz4_block(block.data(), block.size(), out.data(), 5),
+      Error::InvalidProgram);
+}
+
+TEST_F(DecompressingDataLoaderTest, LoadsCompressedSegments) {
+  // Some padding before the segment, a compressed block then a stored one.
+  std::vector<uint8_t> data(7, 0xAA);
+  std::vector<uint8_t> segment;
+  append_block(segment, kRepeatBlock, kRepeatText.size());
+  append_block(segment, {'y', 'z'}, 2);
+  data.insert(data.end(), segment.begin(), segment.end());
+
+  BufferDataLoader buffer_loader(data.data(), data.size());
+  DecompressingDataLoader loader(&buffer_loader);
+  EXPECT_EQ(loader.size().get(), data.size());
+
+  const std::string expected = kRepeatText + "yz";
+  Result<FreeableBuffer> loaded =
+      loader.load(7, segment.size(), compressed_info(expected.size()));
+  ASSERT_EQ(loaded.error(), Error::Ok);
+  EXPECT_EQ(
+      std::string(
+          static_cast<const char*>(loaded->data()),
+          static_cast<const char*>(loaded->data()) + loaded->size()),
+      expected);
+
+  // The sizes must add up.
+  EXPECT_EQ(
+      loader.load(7, segment.size(), compressed_info(expected.size() + 1))
+          .error(),
+      Error::InvalidProgram);
+  EXPECT_EQ(
+      loader.load(7, segment.size() - 1, compressed_info(expected.size()))
+          .error(),
+      Error::InvalidProgram);
+
+  // Parts of a compressed segment can't be loaded.
+  std::vector<uint8_t> buffer(segment.size());
+  EXPECT_EQ(
+      loader.load_into(
+          7, segment.size(), compressed_info(expected.size()), buffer.data()),
+      Error::NotSupported);
+}
+
+TEST_F(DecompressingDataLoaderTest, PassesThroughUncompressedData) {
+  const std::vector<uint8_t> data = {1, 2, 3, 4};
+  BufferDataLoader buffer_loader(data.data(), data.size());
+  DecompressingDataLoader loader(&buffer_loader);
+
+  Result<FreeableBuffer> loaded = loader.load(
+      1, 2, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend));
+  ASSERT_EQ(loaded.error(), Error::Ok);
+  EXPECT_EQ(loaded->data(), data.data() + 1);
+  EXPECT_EQ(loaded->size(), 2);
+}
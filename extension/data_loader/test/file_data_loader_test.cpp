@@ -209,6 +209,63 @@ TEST_P(FileDataLoaderTest, MoveCtor) {
   EXPECT_EQ(0, std::memcmp(fb->data(), contents.data(), fb->size()));
 }
 
+TEST_P(FileDataLoaderTest, DirectIoLoadsSucceed) {
+  // Several direct I/O blocks' worth of heterogeneous data.
+  constexpr size_t kBlock = FileDataLoader::kDirectIoAlignment;
+  const size_t contents_size = 5 * kBlock + 123;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i * 7);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  Result<FileDataLoader> fdl = FileDataLoader::from(
+      tf.path().c_str(), alignment(), FileDataLoader::IoMode::Direct);
+  ASSERT_EQ(fdl.error(), Error::Ok);
+
+  // load() returns aligned, correct data for aligned and unaligned offsets.
+  for (size_t offset : {size_t(0), kBlock, alignment() * 3, size_t(17)}) {
+    const size_t size = contents_size - offset;
+    Result<FreeableBuffer> fb = fdl->load(
+        offset,
+        size,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_ALIGNED(fb->data(), alignment());
+    ASSERT_EQ(fb->size(), size);
+    EXPECT_EQ(0, std::memcmp(fb->data(), &contents[offset], size));
+  }
+
+  // load_into() fills caller buffers, whether or not they are aligned for
+  // direct reads.
+  auto storage = std::make_unique<uint8_t[]>(contents_size + 2 * kBlock);
+  uint8_t* aligned = reinterpret_cast<uint8_t*>(
+      (reinterpret_cast<uintptr_t>(storage.get()) + kBlock - 1) &
+      ~(kBlock - 1));
+  for (uint8_t* dst : {aligned, aligned + 1}) {
+    std::memset(dst, 0, contents_size);
+    Error err = fdl->load_into(
+        /*offset=*/0,
+        contents_size,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program),
+        dst);
+    ASSERT_EQ(err, Error::Ok);
+    EXPECT_EQ(0, std::memcmp(dst, contents.get(), contents_size));
+  }
+
+  // An unaligned range whose middle can be read directly.
+  const size_t offset = kBlock / 2;
+  const size_t size = 3 * kBlock;
+  std::memset(aligned, 0, size + offset);
+  Error err = fdl->load_into(
+      offset,
+      size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program),
+      aligned + offset);
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(0, std::memcmp(aligned + offset, &contents[offset], size));
+}
+
 // Test that the deprecated From method (capital 'F') still works.
 TEST_P(FileDataLoaderTest, DEPRECATEDFrom) {
   // Write some heterogeneous data to a file.
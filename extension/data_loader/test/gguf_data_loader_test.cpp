@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/gguf_data_loader.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::GGUFDataLoader;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace {
+
+// Builds a GGUF file, little-endian as the format requires.
+class GGUFWriter {
+ public:
+  template <typename T>
+  void put(T value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(T));
+  }
+
+  void put_string(const std::string& value) {
+    put<uint64_t>(value.size());
+    data_.insert(data_.end(), value.begin(), value.end());
+  }
+
+  void pad_to(size_t alignment) {
+    data_.resize((data_.size() + alignment - 1) / alignment * alignment);
+  }
+
+  void append(const std::vector<uint8_t>& bytes) {
+    data_.insert(data_.end(), bytes.begin(), bytes.end());
+  }
+
+  const std::vector<uint8_t>& data() const {
+    return data_;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; ++i) {
+    bytes[i] = static_cast<uint8_t>(seed + i * 7);
+  }
+  return bytes;
+}
+
+// Two Q4_0 blocks of 32 elements and three F32 values.
+const std::vector<uint8_t> kQ4Data = pattern(2 * 18, 1);
+const std::vector<uint8_t> kF32Data = pattern(3 * 4, 100);
+
+std::vector<uint8_t> make_gguf(uint32_t version = 3) {
+  constexpr uint32_t kAlignment = 64;
+  GGUFWriter w;
+  w.put<uint32_t>(0x46554747);
+  w.put<uint32_t>(version);
+  w.put<uint64_t>(/*num_tensors=*/2);
+  w.put<uint64_t>(/*num_metadata=*/3);
+  // A string, an array of strings like a vocabulary, and the alignment.
+  w.put_string("general.name");
+  w.put<uint32_t>(8);
+  w.put_string("test");
+  w.put_string("tokenizer.ggml.tokens");
+  w.put<uint32_t>(9);
+  w.put<uint32_t>(8);
+  w.put<uint64_t>(2);
+  w.put_string("a");
+  w.put_string("bc");
+  w.put_string("general.alignment");
+  w.put<uint32_t>(4);
+  w.put<uint32_t>(kAlignment);
+
+  w.put_string("blk.0.attn_q.weight");
+  w.put<uint32_t>(2);
+  w.put<uint64_t>(32);
+  w.put<uint64_t>(2);
+  w.put<uint32_t>(2); // Q4_0
+  w.put<uint64_t>(0);
+  w.put_string("output_norm.weight");
+  w.put<uint32_t>(1);
+  w.put<uint64_t>(3);
+  w.put<uint32_t>(0); // F32
+  w.put<uint64_t>(kAlignment);
+
+  w.pad_to(kAlignment);
+  w.append(kQ4Data);
+  w.pad_to(kAlignment);
+  w.append(kF32Data);
+  return w.data();
+}
+
+DataLoader::SegmentInfo named_constant(const char* name) {
+  return DataLoader::SegmentInfo(
+      DataLoader::SegmentInfo::Type::Constant, /*segment_index=*/0, name);
+}
+
+} // namespace
+
+class GGUFDataLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+
+  // Stands in for the data of a program.
+  const std::vector<uint8_t> program_data_ = pattern(256, 50);
+  BufferDataLoader program_loader_{program_data_.data(), program_data_.size()};
+};
+
+TEST_F(GGUFDataLoaderTest, ParsesTensorInfo) {
+  const auto gguf = make_gguf();
+  TempFile tf(gguf.data(), gguf.size());
+  Result<GGUFDataLoader> loader =
+      GGUFDataLoader::from(tf.path().c_str(), &program_loader_);
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  const auto* q4 = loader->tensor_info("blk.0.attn_q.weight");
+  ASSERT_NE(q4, nullptr);
+  EXPECT_EQ(
+      q4->type, static_cast<uint32_t>(GGUFDataLoader::TensorType::Q4_0));
+  EXPECT_EQ(q4->dims, (std::vector<uint64_t>{32, 2}));
+  EXPECT_EQ(q4->nbytes, kQ4Data.size());
+  EXPECT_EQ(q4->offset % 64, 0);
+
+  const auto* f32 = loader->tensor_info("output_norm.weight");
+  ASSERT_NE(f32, nullptr);
+  EXPECT_EQ(f32->nbytes, kF32Data.size());
+  EXPECT_EQ(f32->offset, q4->offset + 64);
+
+  EXPECT_EQ(loader->tensor_info("missing"), nullptr);
+}
+
+TEST_F(GGUFDataLoaderTest, ServesNamedConstantsFromTheFile) {
+  const auto gguf = make_gguf(/*version=*/2);
+  TempFile tf(gguf.data(), gguf.size());
+  Result<GGUFDataLoader> loader = GGUFDataLoader::from(
+      tf.path().c_str(),
+      &program_loader_,
+      {{"layers.0.attention.wq.weight", "blk.0.attn_q.weight"}});
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // The offset is the tensor's in the program, which doesn't matter.
+  Result<FreeableBuffer> q4 = loader->load(
+      /*offset=*/16,
+      kQ4Data.size(),
+      named_constant("layers.0.attention.wq.weight"));
+  ASSERT_EQ(q4.error(), Error::Ok);
+  ASSERT_EQ(q4->size(), kQ4Data.size());
+  EXPECT_EQ(0, std::memcmp(q4->data(), kQ4Data.data(), kQ4Data.size()));
+
+  std::vector<uint8_t> buffer(kF32Data.size());
+  ASSERT_EQ(
+      loader->load_into(
+          /*offset=*/0,
+          buffer.size(),
+          named_constant("output_norm.weight"),
+          buffer.data()),
+      Error::Ok);
+  EXPECT_EQ(buffer, kF32Data);
+}
+
+TEST_F(GGUFDataLoaderTest, ForwardsOtherLoadsToTheProgram) {
+  const auto gguf = make_gguf();
+  TempFile tf(gguf.data(), gguf.size());
+  Result<GGUFDataLoader> loader =
+      GGUFDataLoader::from(tf.path().c_str(), &program_loader_);
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  for (const auto& info :
+       {DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program),
+        named_constant("not.in.the.gguf"),
+        // Mutable data is never served from the GGUF file.
+        DataLoader::SegmentInfo(
+            DataLoader::SegmentInfo::Type::Mutable, 0, "output_norm.weight")}) {
+    Result<FreeableBuffer> data = loader->load(/*offset=*/8, /*size=*/12, info);
+    ASSERT_EQ(data.error(), Error::Ok);
+    EXPECT_EQ(0, std::memcmp(data->data(), &program_data_[8], 12));
+  }
+  EXPECT_EQ(loader->size().get(), program_data_.size());
+}
+
+TEST_F(GGUFDataLoaderTest, SizeMismatchFails) {
+  const auto gguf = make_gguf();
+  TempFile tf(gguf.data(), gguf.size());
+  Result<GGUFDataLoader> loader =
+      GGUFDataLoader::from(tf.path().c_str(), &program_loader_);
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // E.g. the program holds the weight as float rather than as Q4_0 blocks.
+  Result<FreeableBuffer> data = loader->load(
+      /*offset=*/0,
+      /*size=*/32 * 2 * sizeof(float),
+      named_constant("blk.0.attn_q.weight"));
+  EXPECT_EQ(data.error(), Error::InvalidArgument);
+}
+
+TEST_F(GGUFDataLoaderTest, InvalidFilesFail) {
+  auto gguf = make_gguf(/*version=*/1);
+  {
+    TempFile tf(gguf.data(), gguf.size());
+    EXPECT_EQ(
+        GGUFDataLoader::from(tf.path().c_str(), &program_loader_).error(),
+        Error::InvalidArgument);
+  }
+
+  gguf = make_gguf();
+  gguf[0] = 'X';
+  {
+    TempFile tf(gguf.data(), gguf.size());
+    EXPECT_EQ(
+        GGUFDataLoader::from(tf.path().c_str(), &program_loader_).error(),
+        Error::InvalidArgument);
+  }
+
+  // Every truncation of the header fails cleanly.
+  gguf = make_gguf();
+  const size_t data_offset = gguf.size() - 64 - kF32Data.size();
+  for (size_t size = 4; size < data_offset; size += 5) {
+    TempFile tf(gguf.data(), size);
+    EXPECT_NE(
+        GGUFDataLoader::from(tf.path().c_str(), &program_loader_).error(),
+        Error::Ok)
+        << "size " << size;
+  }
+}
@@ -284,6 +284,31 @@ TEST_F(MmapDataLoaderTest, FinalPageOfUnevenFileSucceeds) {
   }
 }
 
+TEST_F(MmapDataLoaderTest, LoadsKeepFileAlignment) {
+  // Create a multi-page file; contents don't matter.
+  const size_t contents_size = 4 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  TempFile tf(contents.get(), contents_size);
+
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(tf.path().c_str());
+  ASSERT_EQ(mdl.error(), Error::Ok);
+
+  // Data is used in place in the mapping, so it is aligned in memory as it is
+  // in the file: page-aligned data, e.g. constants serialized with a page
+  // constant_tensor_alignment, is page-aligned without any copy.
+  for (size_t offset :
+       {size_t(0), page_size_, page_size_ + 64, 2 * page_size_ - 1}) {
+    Result<FreeableBuffer> fb = mdl->load(
+        offset,
+        /*size=*/page_size_,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(
+        reinterpret_cast<uintptr_t>(fb->data()) % page_size_,
+        offset % page_size_);
+  }
+}
+
 TEST_F(MmapDataLoaderTest, OutOfBoundsLoadFails) {
   // Create a multi-page file; contents don't matter.
   const size_t contents_size = 8 * page_size_;
@@ -357,6 +382,82 @@ TEST_F(MmapDataLoaderTest, MoveCtor) {
   EXPECT_EQ(0, std::memcmp(fb->data(), contents.data(), fb->size()));
 }
 
+// Tests that loads with each paging hint return the file contents, including
+// huge-page-aligned mappings that don't start at a huge page boundary.
+TEST_F(MmapDataLoaderTest, AccessConfigLoadsSucceed) {
+  // Larger than a huge page so that the huge page path is exercised.
+  const size_t contents_size = 4 * 1024 * 1024 + 3 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size / sizeof(uint32_t); ++i) {
+    (reinterpret_cast<uint32_t*>(contents.get()))[i] = i;
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  MmapDataLoader::AccessConfig configs[4];
+  configs[0].pattern = MmapDataLoader::AccessPattern::Sequential;
+  configs[0].will_need = true;
+  configs[1].pattern = MmapDataLoader::AccessPattern::Random;
+  configs[2].huge_pages = true;
+  configs[3].huge_pages = true;
+  configs[3].release_on_free = true;
+
+  for (const auto& config : configs) {
+    Result<MmapDataLoader> mdl = MmapDataLoader::from(
+        tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock, config);
+    ASSERT_EQ(mdl.error(), Error::Ok);
+
+    // An unaligned region spanning multiple huge pages.
+    const size_t offset = page_size_ + 7;
+    const size_t size = contents_size - offset - 13;
+    Result<FreeableBuffer> fb = mdl->load(
+        offset,
+        size,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(fb->size(), size);
+    EXPECT_EQ(0, std::memcmp(fb->data(), &contents[offset], fb->size()));
+    fb->Free();
+    EXPECT_EQ(fb->data(), nullptr);
+
+    // Data stays readable after pages of an earlier segment were released.
+    Result<FreeableBuffer> fb2 = mdl->load(
+        /*offset=*/0,
+        /*size=*/page_size_,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(fb2.error(), Error::Ok);
+    EXPECT_EQ(0, std::memcmp(fb2->data(), &contents[0], fb2->size()));
+  }
+}
+
+TEST_F(MmapDataLoaderTest, PageFaultCountsReflectMappedReads) {
+  Result<MmapDataLoader::PageFaultCounts> before =
+      MmapDataLoader::page_fault_counts();
+  ASSERT_EQ(before.error(), Error::Ok);
+
+  // Read every page of a fresh mapping so that it has to be faulted in.
+  const size_t contents_size = 16 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  TempFile tf(contents.get(), contents_size);
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(
+      tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+  Result<FreeableBuffer> fb = mdl->load(
+      /*offset=*/0,
+      contents_size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  uint32_t sum = 0;
+  for (size_t i = 0; i < contents_size; i += page_size_) {
+    sum += static_cast<const volatile uint8_t*>(fb->data())[i];
+  }
+  EXPECT_EQ(sum, 0);
+
+  Result<MmapDataLoader::PageFaultCounts> after =
+      MmapDataLoader::page_fault_counts();
+  ASSERT_EQ(after.error(), Error::Ok);
+  EXPECT_GT(after->minor + after->major, before->minor + before->major);
+}
+
 // Test that the deprecated From method (capital 'F') still works.
 TEST_F(MmapDataLoaderTest, DEPRECATEDFrom) {
   // Create a file containing multiple pages' worth of data, where each
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/prefetching_data_loader.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::PrefetchingDataLoader;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace {
+
+/// Counts the loads it forwards, and can hold them until released.
+class CountingDataLoader final : public DataLoader {
+ public:
+  CountingDataLoader(const void* data, size_t size) : inner_(data, size) {}
+
+  Result<FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const override {
+    num_started_++;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return !blocked_; });
+    }
+    num_loads_++;
+    return inner_.load(offset, size, segment_info);
+  }
+
+  Result<size_t> size() const override {
+    return inner_.size();
+  }
+
+  void set_blocked(bool blocked) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      blocked_ = blocked;
+    }
+    cv_.notify_all();
+  }
+
+  size_t num_started() const {
+    return num_started_;
+  }
+
+  size_t num_loads() const {
+    return num_loads_;
+  }
+
+ private:
+  BufferDataLoader inner_;
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cv_;
+  bool blocked_ = false;
+  mutable std::atomic<size_t> num_started_{0};
+  mutable std::atomic<size_t> num_loads_{0};
+};
+
+} // namespace
+
+class PrefetchingDataLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+    for (size_t i = 0; i < sizeof(data_); ++i) {
+      data_[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  uint8_t data_[256];
+};
+
+TEST_F(PrefetchingDataLoaderTest, PrefetchedLoadIsServedOnce) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  const DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Constant);
+  loader.prefetch(/*offset=*/16, /*size=*/32, info);
+
+  Result<FreeableBuffer> fb = loader.load(/*offset=*/16, /*size=*/32, info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(fb->size(), 32);
+  EXPECT_EQ(0, std::memcmp(fb->data(), &data_[16], 32));
+
+  // The wrapped loader was only asked once, either by the prefetch or by the
+  // load if it got there first.
+  EXPECT_EQ(inner.num_loads(), 1);
+  EXPECT_LE(loader.num_prefetch_hits(), 1);
+
+  // A second load of the same range goes to the wrapped loader.
+  Result<FreeableBuffer> fb2 = loader.load(/*offset=*/16, /*size=*/32, info);
+  ASSERT_EQ(fb2.error(), Error::Ok);
+  EXPECT_EQ(inner.num_loads(), 2);
+}
+
+TEST_F(PrefetchingDataLoaderTest, LoadWaitsForInFlightPrefetch) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  const DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Backend);
+  inner.set_blocked(true);
+  loader.prefetch(/*offset=*/0, /*size=*/64, info);
+
+  // Wait for the worker to start the read, then release it from another
+  // thread while load() waits for it.
+  while (inner.num_started() == 0) {
+    std::this_thread::yield();
+  }
+  std::thread unblocker([&inner]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    inner.set_blocked(false);
+  });
+
+  Result<FreeableBuffer> fb = loader.load(/*offset=*/0, /*size=*/64, info);
+  unblocker.join();
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), data_, 64));
+  EXPECT_EQ(inner.num_loads(), 1);
+  EXPECT_EQ(loader.num_prefetch_hits(), 1);
+}
+
+TEST_F(PrefetchingDataLoaderTest, UnplannedLoadsPassThrough) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  const DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Program);
+  Result<FreeableBuffer> fb = loader.load(/*offset=*/8, /*size=*/8, info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), &data_[8], 8));
+  EXPECT_EQ(loader.num_prefetch_hits(), 0);
+
+  Result<size_t> size = loader.size();
+  ASSERT_EQ(size.error(), Error::Ok);
+  EXPECT_EQ(*size, sizeof(data_));
+
+  // Errors from the wrapped loader are returned as-is.
+  Result<FreeableBuffer> bad = loader.load(/*offset=*/250, /*size=*/8, info);
+  EXPECT_NE(bad.error(), Error::Ok);
+}
+
+TEST_F(PrefetchingDataLoaderTest, FailedPrefetchIsRetried) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  const DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Constant);
+  loader.prefetch(/*offset=*/250, /*size=*/8, info);
+  Result<FreeableBuffer> fb = loader.load(/*offset=*/250, /*size=*/8, info);
+  EXPECT_NE(fb.error(), Error::Ok);
+  EXPECT_EQ(loader.num_prefetch_hits(), 0);
+}
+
+TEST_F(PrefetchingDataLoaderTest, UnclaimedPrefetchesAreFreed) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  {
+    PrefetchingDataLoader loader(&inner);
+    const DataLoader::SegmentInfo info(
+        DataLoader::SegmentInfo::Type::Constant);
+    for (size_t i = 0; i < 8; ++i) {
+      loader.prefetch(/*offset=*/i * 16, /*size=*/16, info);
+    }
+    // Destroying the loader with outstanding prefetches must not hang.
+  }
+  EXPECT_LE(inner.num_loads(), 8);
+}
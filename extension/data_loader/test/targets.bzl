@@ -48,3 +48,37 @@ def define_common_targets():
             "//executorch/extension/data_loader:mmap_data_loader",
         ],
     )
+
+    runtime.cxx_test(
+        name = "decompressing_data_loader_test",
+        srcs = [
+            "decompressing_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/data_loader:decompressing_data_loader",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "gguf_data_loader_test",
+        srcs = [
+            "gguf_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/testing_util:temp_file",
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/data_loader:gguf_data_loader",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "prefetching_data_loader_test",
+        srcs = [
+            "prefetching_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/data_loader:prefetching_data_loader",
+        ],
+    )
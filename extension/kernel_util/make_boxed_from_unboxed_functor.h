@@ -31,6 +31,11 @@
 ///
 /// The trick here is to convert each EValue to inferred argument type. This
 /// uses a lot of C++17 features.
+///
+/// When every argument is a Tensor, int64_t, double, bool or ScalarType, the
+/// kernel is also registered with an unboxed entry point, whose arguments
+/// Method binds once at init time instead of unboxing them on every call. See
+/// OpBindFunction.
 //===----------------------------------------------------------------------===//
 
 #pragma once
@@ -122,6 +127,116 @@ void call_functor_with_args_from_stack(
           *stack[evalue_arg_indices])...);
 }
 
+/**
+ * bound_arg<T>: how an argument of type T is bound once at Method init time
+ * and read on each call, see OpBindFunction. Only arguments that live inside
+ * their EValue can be bound; for any other type, e.g. lists, the kernel is
+ * only called boxed.
+ */
+template <class T>
+struct bound_arg final {
+  static constexpr bool supported = false;
+};
+
+template <>
+struct bound_arg<exec_aten::Tensor&> final {
+  static constexpr bool supported = true;
+  static void* bind(executorch::runtime::EValue& v) {
+    return v.isTensor() ? &v.toTensor() : nullptr;
+  }
+  static exec_aten::Tensor& get(void* p) {
+    return *static_cast<exec_aten::Tensor*>(p);
+  }
+};
+
+template <>
+struct bound_arg<const exec_aten::Tensor&> final {
+  static constexpr bool supported = true;
+  static void* bind(executorch::runtime::EValue& v) {
+    return bound_arg<exec_aten::Tensor&>::bind(v);
+  }
+  static const exec_aten::Tensor& get(void* p) {
+    return *static_cast<const exec_aten::Tensor*>(p);
+  }
+};
+
+template <>
+struct bound_arg<int64_t> final {
+  static constexpr bool supported = true;
+  static void* bind(executorch::runtime::EValue& v) {
+    return v.isInt() ? &v.payload.copyable_union.as_int : nullptr;
+  }
+  static int64_t get(void* p) {
+    return *static_cast<const int64_t*>(p);
+  }
+};
+
+template <>
+struct bound_arg<double> final {
+  static constexpr bool supported = true;
+  static void* bind(executorch::runtime::EValue& v) {
+    return v.isDouble() ? &v.payload.copyable_union.as_double : nullptr;
+  }
+  static double get(void* p) {
+    return *static_cast<const double*>(p);
+  }
+};
+
+template <>
+struct bound_arg<bool> final {
+  static constexpr bool supported = true;
+  static void* bind(executorch::runtime::EValue& v) {
+    return v.isBool() ? &v.payload.copyable_union.as_bool : nullptr;
+  }
+  static bool get(void* p) {
+    return *static_cast<const bool*>(p);
+  }
+};
+
+template <>
+struct bound_arg<exec_aten::ScalarType> final {
+  static constexpr bool supported = true;
+  // ScalarTypes are stored as ints, see EValue::toScalarType().
+  static void* bind(executorch::runtime::EValue& v) {
+    return bound_arg<int64_t>::bind(v);
+  }
+  static exec_aten::ScalarType get(void* p) {
+    return static_cast<exec_aten::ScalarType>(bound_arg<int64_t>::get(p));
+  }
+};
+
+template <typename... ArgTypes>
+constexpr bool all_args_bindable(typelist<ArgTypes...>*) {
+  return (
+      bound_arg<typename decay_if_not_tensor<ArgTypes>::type>::supported &&
+      ...);
+}
+
+template <size_t... evalue_arg_indices, typename... ArgTypes>
+bool bind_args_from_stack(
+    executorch::runtime::EValue** stack,
+    void** bound_args,
+    std::index_sequence<evalue_arg_indices...>,
+    typelist<ArgTypes...>*) {
+  return (
+      ((bound_args[evalue_arg_indices] =
+            bound_arg<typename decay_if_not_tensor<ArgTypes>::type>::bind(
+                *stack[evalue_arg_indices])) != nullptr) &&
+      ...);
+}
+
+template <class Functor, size_t... evalue_arg_indices, typename... ArgTypes>
+void call_functor_with_bound_args(
+    ::executorch::runtime::KernelRuntimeContext& ctx,
+    void** bound_args,
+    std::index_sequence<evalue_arg_indices...>,
+    typelist<ArgTypes...>*) {
+  (*Functor::func_ptr())(
+      ctx,
+      bound_arg<typename decay_if_not_tensor<ArgTypes>::type>::get(
+          bound_args[evalue_arg_indices])...);
+}
+
 } // namespace kernel_util_internal
 
 /**
@@ -160,14 +275,52 @@ struct WrapUnboxedIntoFunctor {
         std::make_index_sequence<num_inputs>(),
         static_cast<ContextRemovedArgsType*>(nullptr));
   }
+
+  // Whether every argument can be bound at init time, so that Method can call
+  // the kernel through call_bound() instead of call().
+  static constexpr bool bindable = kernel_util_internal::all_args_bindable(
+      static_cast<ContextRemovedArgsType*>(nullptr));
+
+  static bool bind(
+      executorch::runtime::EValue** stack,
+      size_t num_args,
+      void** bound_args) {
+    constexpr size_t num_inputs =
+        kernel_util_internal::size<ContextRemovedArgsType>::value;
+    if (num_args != num_inputs) {
+      return false;
+    }
+    return kernel_util_internal::bind_args_from_stack(
+        stack,
+        bound_args,
+        std::make_index_sequence<num_inputs>(),
+        static_cast<ContextRemovedArgsType*>(nullptr));
+  }
+
+  static void call_bound(
+      ::executorch::runtime::KernelRuntimeContext& ctx,
+      void** bound_args) {
+    constexpr size_t num_inputs =
+        kernel_util_internal::size<ContextRemovedArgsType>::value;
+    return kernel_util_internal::call_functor_with_bound_args<FuncType>(
+        ctx,
+        bound_args,
+        std::make_index_sequence<num_inputs>(),
+        static_cast<ContextRemovedArgsType*>(nullptr));
+  }
 };
 
 template <typename FuncType>
 static executorch::runtime::Kernel make_boxed_kernel(
     const char* name,
     FuncType) {
-  return executorch::runtime::Kernel(
-      name, WrapUnboxedIntoFunctor<FuncType>::call);
+  using Wrapper = WrapUnboxedIntoFunctor<FuncType>;
+  if constexpr (Wrapper::bindable) {
+    return executorch::runtime::Kernel(
+        name, Wrapper::call, Wrapper::bind, Wrapper::call_bound);
+  } else {
+    return executorch::runtime::Kernel(name, Wrapper::call);
+  }
 }
 
 } // namespace extension
@@ -22,8 +22,10 @@ using exec_aten::Tensor;
 using exec_aten::TensorImpl;
 using executorch::runtime::BoxedEvalueList;
 using executorch::runtime::EValue;
+using executorch::runtime::get_kernel;
 using executorch::runtime::getOpsFn;
 using executorch::runtime::hasOpsFn;
+using executorch::runtime::Kernel;
 using executorch::runtime::KernelRuntimeContext;
 
 Tensor& my_op_out(KernelRuntimeContext& ctx, const Tensor& a, Tensor& out) {
@@ -82,6 +84,21 @@ Tensor& add_optional_tensor_out(
   return out;
 }
 
+Tensor& fill_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    int64_t i,
+    double d,
+    bool negate,
+    ScalarType dtype,
+    Tensor& out) {
+  (void)ctx;
+  (void)self;
+  int32_t value = static_cast<int32_t>(i + d) + static_cast<int32_t>(dtype);
+  out.mutable_data_ptr<int32_t>()[0] = negate ? -value : value;
+  return out;
+}
+
 class MakeBoxedFromUnboxedFunctorTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -199,3 +216,64 @@ TEST_F(MakeBoxedFromUnboxedFunctorTest, UnboxOptionalArrayRef) {
     EXPECT_EQ(stack[1]->toTensor().const_data_ptr<int32_t>()[i], 1);
   }
 }
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, BindScalarsAndTensors) {
+  EXECUTORCH_LIBRARY(my_ns, "fill.out", fill_out);
+  const Kernel* kernel = get_kernel("my_ns::fill.out");
+  ASSERT_NE(kernel, nullptr);
+  ASSERT_NE(kernel->bind_, nullptr);
+  ASSERT_NE(kernel->bound_op_, nullptr);
+
+  torch::executor::testing::TensorFactory<ScalarType::Int> tf;
+  EValue values[6] = {
+      EValue(tf.zeros({1})),
+      EValue((int64_t)2),
+      EValue(0.5),
+      EValue(false),
+      EValue(static_cast<int64_t>(ScalarType::Int)),
+      EValue(tf.zeros({1}))};
+  EValue* stack[6];
+  for (int i = 0; i < 6; i++) {
+    stack[i] = &values[i];
+  }
+  void* bound_args[6];
+  ASSERT_TRUE(kernel->bind_(stack, 6, bound_args));
+
+  KernelRuntimeContext context;
+  kernel->bound_op_(context, bound_args);
+  EXPECT_EQ(values[5].toTensor().const_data_ptr<int32_t>()[0], 5);
+
+  // Bound arguments see values written after binding.
+  values[1] = EValue((int64_t)7);
+  values[3] = EValue(true);
+  kernel->bound_op_(context, bound_args);
+  EXPECT_EQ(values[5].toTensor().const_data_ptr<int32_t>()[0], -10);
+
+  // The boxed entry point computes the same.
+  kernel->op_(context, stack);
+  EXPECT_EQ(values[5].toTensor().const_data_ptr<int32_t>()[0], -10);
+}
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, BindRejectsMismatchedArgs) {
+  EXECUTORCH_LIBRARY(my_ns, "my_op_bind.out", my_op_out);
+  const Kernel* kernel = get_kernel("my_ns::my_op_bind.out");
+  ASSERT_NE(kernel, nullptr);
+  ASSERT_NE(kernel->bind_, nullptr);
+
+  torch::executor::testing::TensorFactory<ScalarType::Int> tf;
+  EValue values[2] = {EValue((int64_t)1), EValue(tf.zeros({1}))};
+  EValue* stack[2] = {&values[0], &values[1]};
+  void* bound_args[2];
+  // A scalar where the kernel takes a Tensor.
+  EXPECT_FALSE(kernel->bind_(stack, 2, bound_args));
+  // The wrong number of arguments.
+  EXPECT_FALSE(kernel->bind_(stack, 1, bound_args));
+}
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, ListArgsAreNotBound) {
+  EXECUTORCH_LIBRARY(my_ns, "add_tensor_bind.out", add_tensor_out);
+  const Kernel* kernel = get_kernel("my_ns::add_tensor_bind.out");
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->bind_, nullptr);
+  EXPECT_EQ(kernel->bound_op_, nullptr);
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_gguf.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+// Values per block of the ggml quantized types.
+constexpr int64_t kBlockValues = 32;
+// Output features are split across threads in chunks of at least this many
+// multiply-adds.
+constexpr int64_t kGrainSize = 1 << 16;
+
+// Bytes per block: a float16 scale, then the values.
+template <int kBits>
+constexpr int64_t block_bytes() {
+  return 2 + kBlockValues * kBits / 8;
+}
+
+// Decodes a block into its 32 dequantized values.
+template <int kBits>
+inline void decode_block(const uint8_t* block, float* values) {
+  uint16_t scale_bits;
+  std::memcpy(&scale_bits, block, sizeof(scale_bits));
+  const float scale = static_cast<float>(
+      exec_aten::Half(scale_bits, exec_aten::Half::from_bits()));
+  const uint8_t* q = block + 2;
+  if constexpr (kBits == 8) {
+    for (int64_t j = 0; j < kBlockValues; ++j) {
+      values[j] = scale * static_cast<int8_t>(q[j]);
+    }
+  } else {
+    for (int64_t j = 0; j < kBlockValues / 2; ++j) {
+      values[j] = scale * (static_cast<int32_t>(q[j] & 0xF) - 8);
+      values[j + kBlockValues / 2] =
+          scale * (static_cast<int32_t>(q[j] >> 4) - 8);
+    }
+  }
+}
+
+// Checks that `weight` holds whole blocks of a GGUF tensor and returns the
+// number of values per row through `K`.
+template <int kBits>
+bool validate_gguf_weight(const Tensor& weight, int64_t& K) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight.scalar_type() == ScalarType::Byte,
+      "weight must hold the raw uint8 blocks of the GGUF tensor");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 2));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight.size(1) % block_bytes<kBits>() == 0,
+      "weight rows must hold whole blocks of %" PRId64 " bytes",
+      block_bytes<kBits>());
+  K = weight.size(1) / block_bytes<kBits>() * kBlockValues;
+  return true;
+}
+
+template <int kBits>
+Tensor& linear_gguf_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out) {
+  int64_t K = 0;
+  ET_KERNEL_CHECK(
+      ctx, validate_gguf_weight<kBits>(weight, K), InvalidArgument, out);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      input.scalar_type() == ScalarType::Float &&
+          out.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      out,
+      "input and out must be float");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      input.dim() >= 1 && input.size(input.dim() - 1) == K,
+      InvalidArgument,
+      out,
+      "input must have the %" PRId64 " input features of the weight",
+      K);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      is_contiguous_dim_order(
+          input.dim_order().data(), input.dim_order().size()),
+      InvalidArgument,
+      out,
+      "input must be contiguous");
+
+  exec_aten::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t d = 0; d < input.dim() - 1; ++d) {
+    out_sizes[d] = input.size(d);
+  }
+  out_sizes[input.dim() - 1] = weight.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {out_sizes, static_cast<size_t>(input.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const float* in = input.const_data_ptr<float>();
+  const auto* w = static_cast<const uint8_t*>(weight.const_data_ptr());
+  float* o = out.mutable_data_ptr<float>();
+  const int64_t N = weight.size(0);
+  const int64_t M = input.numel() / std::max<int64_t>(K, 1);
+  const int64_t num_blocks = K / kBlockValues;
+  const int64_t row_bytes = weight.size(1);
+  const int64_t grain_size =
+      std::max<int64_t>(1, kGrainSize / std::max<int64_t>(1, M * K));
+
+  torch::executor::parallel_for(
+      0, N, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t n = begin; n < end; ++n) {
+          for (int64_t m = 0; m < M; ++m) {
+            o[m * N + n] = 0;
+          }
+          // Each block is decoded once and applied to every input row.
+          for (int64_t b = 0; b < num_blocks; ++b) {
+            float values[kBlockValues];
+            decode_block<kBits>(
+                w + n * row_bytes + b * block_bytes<kBits>(), values);
+            for (int64_t m = 0; m < M; ++m) {
+              const float* x = in + m * K + b * kBlockValues;
+              float acc = 0;
+              for (int64_t j = 0; j < kBlockValues; ++j) {
+                acc += x[j] * values[j];
+              }
+              o[m * N + n] += acc;
+            }
+          }
+        }
+      });
+  return out;
+}
+
+template <int kBits>
+Tensor& embedding_gguf_out(
+    RuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  int64_t D = 0;
+  ET_KERNEL_CHECK(
+      ctx, validate_gguf_weight<kBits>(weight, D), InvalidArgument, out);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      indices.scalar_type() == ScalarType::Long,
+      InvalidArgument,
+      out,
+      "indices must be int64");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      out,
+      "out must be float");
+  ET_KERNEL_CHECK(
+      ctx, indices.dim() < kTensorDimensionLimit, InvalidArgument, out);
+
+  exec_aten::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t d = 0; d < indices.dim(); ++d) {
+    out_sizes[d] = indices.size(d);
+  }
+  out_sizes[indices.dim()] = D;
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {out_sizes, static_cast<size_t>(indices.dim() + 1)}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t V = weight.size(0);
+  const auto* w = static_cast<const uint8_t*>(weight.const_data_ptr());
+  const int64_t* idx = indices.const_data_ptr<int64_t>();
+  float* o = out.mutable_data_ptr<float>();
+  const int64_t row_bytes = weight.size(1);
+  for (int64_t i = 0; i < indices.numel(); ++i) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        idx[i] >= 0 && idx[i] < V,
+        InvalidArgument,
+        out,
+        "index %" PRId64 " is out of range for %" PRId64 " rows",
+        idx[i],
+        V);
+    const uint8_t* row = w + idx[i] * row_bytes;
+    for (int64_t b = 0; b < D / kBlockValues; ++b) {
+      decode_block<kBits>(
+          row + b * block_bytes<kBits>(), o + i * D + b * kBlockValues);
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+Tensor& linear_q4_0_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out) {
+  return linear_gguf_out<4>(ctx, input, weight, out);
+}
+
+Tensor& linear_q8_0_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out) {
+  return linear_gguf_out<8>(ctx, input, weight, out);
+}
+
+Tensor& embedding_q4_0_out(
+    RuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  return embedding_gguf_out<4>(ctx, weight, indices, out);
+}
+
+Tensor& embedding_q8_0_out(
+    RuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  return embedding_gguf_out<8>(ctx, weight, indices, out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace {
+// EXECUTORCH_LIBRARY registers a single op per namespace per file, so the ops
+// for both block types are registered together.
+const ::executorch::runtime::Kernel gguf_kernels[] = {
+    ::executorch::extension::make_boxed_kernel(
+        "llama::linear_q4_0.out",
+        EXECUTORCH_FN(torch::executor::native::linear_q4_0_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::linear_q8_0.out",
+        EXECUTORCH_FN(torch::executor::native::linear_q8_0_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::embedding_q4_0.out",
+        EXECUTORCH_FN(torch::executor::native::embedding_q4_0_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::embedding_q8_0.out",
+        EXECUTORCH_FN(torch::executor::native::embedding_q8_0_out)),
+};
+auto res_llama_gguf = ::executorch::runtime::register_kernels(gguf_kernels);
+} // namespace
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Computes `input @ weight^T` for an (N, K) weight stored as the raw blocks
+ * of a GGUF Q4_0 tensor, so that weights served by GGUFDataLoader are used
+ * without repacking.
+ *
+ * `weight` is a uint8 tensor of shape (N, K / 32 * 18): each row holds the
+ * blocks of 32 input features of one output feature, each a float16 scale
+ * followed by 16 bytes whose low nibbles are features 0-15 and high nibbles
+ * features 16-31, offset by 8.
+ */
+Tensor& linear_q4_0_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out);
+
+/**
+ * Same as linear_q4_0_out() for a GGUF Q8_0 weight of shape
+ * (N, K / 32 * 34), whose blocks are a float16 scale followed by 32 int8
+ * values.
+ */
+Tensor& linear_q8_0_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out);
+
+/**
+ * Looks up the rows of a (V, D) embedding table stored as the raw blocks of
+ * a GGUF Q4_0 tensor, laid out like the weight of linear_q4_0_out(), and
+ * dequantizes them to float.
+ */
+Tensor& embedding_q4_0_out(
+    RuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out);
+
+/**
+ * Same as embedding_q4_0_out() for a GGUF Q8_0 embedding table.
+ */
+Tensor& embedding_q8_0_out(
+    RuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_gguf.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpGGUFOutTest : public OperatorTest {
+ protected:
+  // Quantizes the rows of an (N, K) matrix into GGUF blocks the way ggml
+  // does, and replaces `values` with the values the blocks hold.
+  static std::vector<uint8_t>
+  quantize(std::vector<float>& values, int32_t N, int32_t K, int bits) {
+    const int32_t block_bytes = 2 + 32 * bits / 8;
+    const int32_t qmax = bits == 4 ? 8 : 127;
+    std::vector<uint8_t> blocks(N * K / 32 * block_bytes, 0);
+    for (int32_t b = 0; b < N * K / 32; ++b) {
+      float* x = values.data() + b * 32;
+      uint8_t* block = blocks.data() + b * block_bytes;
+      float amax = 0;
+      for (int32_t j = 0; j < 32; ++j) {
+        amax = std::max(amax, std::abs(x[j]));
+      }
+      // Round the scale through float16 as the stored scale is.
+      const exec_aten::Half half_scale(amax / qmax);
+      std::memcpy(block, &half_scale.x, 2);
+      const float scale = static_cast<float>(half_scale);
+      for (int32_t j = 0; j < 32; ++j) {
+        int32_t q = scale == 0 ? 0 : std::lround(x[j] / scale);
+        q = std::min(std::max(q, -qmax), bits == 4 ? 7 : qmax);
+        x[j] = q * scale;
+        if (bits == 8) {
+          block[2 + j] = static_cast<uint8_t>(static_cast<int8_t>(q));
+        } else {
+          block[2 + j % 16] |= static_cast<uint8_t>(q + 8) << (4 * (j / 16));
+        }
+      }
+    }
+    return blocks;
+  }
+
+  static std::vector<float> make_values(size_t size) {
+    std::vector<float> values(size);
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = std::sin(0.7f * i) * (1 + i % 5);
+    }
+    return values;
+  }
+
+  void test_linear(const std::vector<int32_t>& in_sizes, int32_t N, int bits) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Byte> tf_byte;
+
+    const int32_t K = in_sizes.back();
+    int32_t M = 1;
+    for (size_t d = 0; d + 1 < in_sizes.size(); ++d) {
+      M *= in_sizes[d];
+    }
+    std::vector<float> in_data(M * K);
+    for (size_t i = 0; i < in_data.size(); ++i) {
+      in_data[i] = std::cos(0.3f * i) + 0.25f;
+    }
+    std::vector<float> weight = make_values(N * K);
+    const std::vector<uint8_t> blocks = quantize(weight, N, K, bits);
+
+    std::vector<float> expected_data(M * N);
+    for (int32_t m = 0; m < M; ++m) {
+      for (int32_t n = 0; n < N; ++n) {
+        double acc = 0;
+        for (int32_t k = 0; k < K; ++k) {
+          acc += in_data[m * K + k] * weight[n * K + k];
+        }
+        expected_data[m * N + n] = acc;
+      }
+    }
+
+    std::vector<int32_t> out_sizes = in_sizes;
+    out_sizes.back() = N;
+    Tensor input = tf.make(in_sizes, in_data);
+    Tensor weight_blocks = tf_byte.make(
+        {N, static_cast<int32_t>(blocks.size()) / N}, blocks);
+    Tensor out = tf.zeros(out_sizes);
+    if (bits == 4) {
+      torch::executor::native::linear_q4_0_out(
+          context_, input, weight_blocks, out);
+    } else {
+      torch::executor::native::linear_q8_0_out(
+          context_, input, weight_blocks, out);
+    }
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.make(out_sizes, expected_data), 1e-4, 1e-3);
+  }
+
+  void test_embedding(int bits) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Byte> tf_byte;
+    TensorFactory<ScalarType::Long> tf_long;
+
+    constexpr int32_t V = 5;
+    constexpr int32_t D = 64;
+    std::vector<float> table = make_values(V * D);
+    const std::vector<uint8_t> blocks = quantize(table, V, D, bits);
+    const std::vector<int64_t> indices_data = {4, 0, 2, 4};
+
+    std::vector<float> expected_data;
+    for (int64_t index : indices_data) {
+      expected_data.insert(
+          expected_data.end(),
+          table.begin() + index * D,
+          table.begin() + (index + 1) * D);
+    }
+
+    Tensor weight_blocks = tf_byte.make(
+        {V, static_cast<int32_t>(blocks.size()) / V}, blocks);
+    Tensor indices = tf_long.make({2, 2}, indices_data);
+    Tensor out = tf.zeros({2, 2, D});
+    if (bits == 4) {
+      torch::executor::native::embedding_q4_0_out(
+          context_, weight_blocks, indices, out);
+    } else {
+      torch::executor::native::embedding_q8_0_out(
+          context_, weight_blocks, indices, out);
+    }
+    EXPECT_TENSOR_CLOSE(out, tf.make({2, 2, D}, expected_data));
+  }
+};
+
+TEST_F(OpGGUFOutTest, LinearQ4_0) {
+  test_linear({3, 64}, /*N=*/7, /*bits=*/4);
+}
+
+TEST_F(OpGGUFOutTest, LinearQ8_0) {
+  test_linear({2, 3, 96}, /*N=*/5, /*bits=*/8);
+}
+
+TEST_F(OpGGUFOutTest, EmbeddingQ4_0) {
+  test_embedding(/*bits=*/4);
+}
+
+TEST_F(OpGGUFOutTest, EmbeddingQ8_0) {
+  test_embedding(/*bits=*/8);
+}
+
+TEST_F(OpGGUFOutTest, PartialBlockWeightDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tf_byte;
+
+  Tensor input = tf.ones({2, 32});
+  // Q4_0 rows are whole 18-byte blocks.
+  Tensor weight = tf_byte.zeros({4, 20});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      torch::executor::native::linear_q4_0_out(context_, input, weight, out));
+}
+
+TEST_F(OpGGUFOutTest, MismatchedInputFeaturesDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tf_byte;
+
+  // The weight holds 64 input features.
+  Tensor input = tf.ones({2, 32});
+  Tensor weight = tf_byte.zeros({4, 2 * 34});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      torch::executor::native::linear_q8_0_out(context_, input, weight, out));
+}
+
+TEST_F(OpGGUFOutTest, OutOfRangeIndexDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tf_byte;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor weight = tf_byte.zeros({3, 18});
+  Tensor indices = tf_long.make({2}, {1, 3});
+  Tensor out = tf.zeros({2, 32});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      torch::executor::native::embedding_q4_0_out(
+          context_, weight, indices, out));
+}
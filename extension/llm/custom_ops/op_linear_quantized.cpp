@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_linear_quantized.h>
+
+#include <algorithm>
+#include <cinttypes>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+constexpr int64_t kBlockSize = kLinearPackedBlockSize;
+// Input rows that share each decoded row of weights.
+constexpr int64_t kTileRows = 4;
+// Input rows are processed in panels of about this many bytes, so that a
+// panel stays in L2 while every block of weights of a thread streams over it.
+constexpr int64_t kPanelBytes = 256 * 1024;
+// Blocks are split across threads in chunks of at least this many
+// multiply-adds.
+constexpr int64_t kLinearGrainSize = 1 << 16;
+
+// Bytes per input feature in a block of the packed weight.
+template <int kBits>
+constexpr int64_t packed_row_bytes() {
+  return kBlockSize * kBits / 8;
+}
+
+bool validate_linear_quantized_args(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    const int64_t bits,
+    Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.scalar_type() == ScalarType::Float, "input must be float");
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, scales, out));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.dim() >= 1, "input must have at least one dim");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(out, input.dim()));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          input.dim_order().data(), input.dim_order().size()),
+      "input must be contiguous");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      packed_weight.scalar_type() ==
+          (bits == 4 ? ScalarType::Byte : ScalarType::Char),
+      "packed_weight must be %s for %" PRId64 "-bit weights",
+      bits == 4 ? "uint8" : "int8",
+      bits);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(packed_weight, 3));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_size_at_dims(input, input.dim() - 1, packed_weight, 1));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      packed_weight.size(2) == kBlockSize * bits / 8,
+      "packed_weight must hold %" PRId64 " bytes per input feature",
+      kBlockSize * bits / 8);
+
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(scales, 2));
+  const int64_t N = scales.size(0);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      packed_weight.size(0) == (N + kBlockSize - 1) / kBlockSize,
+      "packed_weight must have one block per %" PRId64 " output features",
+      kBlockSize);
+  const int64_t K = packed_weight.size(1);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      group_size > 0 && K % group_size == 0,
+      "group_size %" PRId64 " must evenly divide the input features",
+      group_size);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      scales.size(1) == K / group_size,
+      "scales must hold one scale per group");
+  return true;
+}
+
+// Decodes the weights of one input feature of a block into w.
+template <int kBits>
+inline void decode_row(const uint8_t* row, float* w) {
+  if constexpr (kBits == 8) {
+    for (int64_t j = 0; j < kBlockSize; ++j) {
+      w[j] = static_cast<int8_t>(row[j]);
+    }
+  } else {
+    for (int64_t j = 0; j < kBlockSize / 2; ++j) {
+      w[2 * j] = static_cast<int32_t>(row[j] & 0xF) - 8;
+      w[2 * j + 1] = static_cast<int32_t>(row[j] >> 4) - 8;
+    }
+  }
+}
+
+// Computes kRows rows of the output features of one block. The weights of a
+// group are accumulated unscaled and the group's scales are applied once at
+// its end.
+template <int kBits, int64_t kRows>
+void linear_block(
+    const float* in,
+    const int64_t K,
+    const uint8_t* block,
+    const float* scales,
+    const int64_t num_groups,
+    const int64_t group_size,
+    const int64_t valid,
+    float* out,
+    const int64_t N) {
+  float acc[kRows][kBlockSize] = {};
+  for (int64_t g = 0; g < num_groups; ++g) {
+    float partial[kRows][kBlockSize] = {};
+    for (int64_t k = g * group_size; k < (g + 1) * group_size; ++k) {
+      float w[kBlockSize];
+      decode_row<kBits>(block + k * packed_row_bytes<kBits>(), w);
+      for (int64_t m = 0; m < kRows; ++m) {
+        const float x = in[m * K + k];
+        for (int64_t j = 0; j < kBlockSize; ++j) {
+          partial[m][j] += x * w[j];
+        }
+      }
+    }
+    float s[kBlockSize];
+    for (int64_t j = 0; j < kBlockSize; ++j) {
+      s[j] = j < valid ? scales[j * num_groups + g] : 0.0f;
+    }
+    for (int64_t m = 0; m < kRows; ++m) {
+      for (int64_t j = 0; j < kBlockSize; ++j) {
+        acc[m][j] += partial[m][j] * s[j];
+      }
+    }
+  }
+  for (int64_t m = 0; m < kRows; ++m) {
+    for (int64_t j = 0; j < valid; ++j) {
+      out[m * N + j] = acc[m][j];
+    }
+  }
+}
+
+template <int kBits>
+void linear_quantized_kernel(
+    const float* in,
+    const uint8_t* packed_weight,
+    const float* scales,
+    const int64_t M,
+    const int64_t K,
+    const int64_t N,
+    const int64_t group_size,
+    float* out) {
+  const int64_t num_blocks = (N + kBlockSize - 1) / kBlockSize;
+  const int64_t num_groups = K / group_size;
+  const int64_t block_bytes = K * packed_row_bytes<kBits>();
+  const int64_t panel_rows = std::max<int64_t>(
+      kTileRows,
+      kPanelBytes / (K * static_cast<int64_t>(sizeof(float))) / kTileRows *
+          kTileRows);
+  const int64_t grain_size = std::max<int64_t>(
+      1, kLinearGrainSize / std::max<int64_t>(1, M * K * kBlockSize));
+
+  torch::executor::parallel_for(
+      0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t m0 = 0; m0 < M; m0 += panel_rows) {
+          const int64_t m_end = std::min(M, m0 + panel_rows);
+          for (int64_t b = begin; b < end; ++b) {
+            const uint8_t* block = packed_weight + b * block_bytes;
+            const int64_t n0 = b * kBlockSize;
+            const int64_t valid = std::min(kBlockSize, N - n0);
+            const float* block_scales = scales + n0 * num_groups;
+            int64_t m = m0;
+            for (; m + kTileRows <= m_end; m += kTileRows) {
+              linear_block<kBits, kTileRows>(
+                  in + m * K,
+                  K,
+                  block,
+                  block_scales,
+                  num_groups,
+                  group_size,
+                  valid,
+                  out + m * N + n0,
+                  N);
+            }
+            for (; m < m_end; ++m) {
+              linear_block<kBits, 1>(
+                  in + m * K,
+                  K,
+                  block,
+                  block_scales,
+                  num_groups,
+                  group_size,
+                  valid,
+                  out + m * N + n0,
+                  N);
+            }
+          }
+        }
+      });
+}
+
+template <int kBits>
+Tensor& linear_quantized_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_linear_quantized_args(
+          input, packed_weight, scales, group_size, kBits, out),
+      InvalidArgument,
+      out);
+
+  exec_aten::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t d = 0; d < input.dim() - 1; ++d) {
+    out_sizes[d] = input.size(d);
+  }
+  out_sizes[input.dim() - 1] = scales.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {out_sizes, static_cast<size_t>(input.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t K = packed_weight.size(1);
+  const int64_t N = scales.size(0);
+  if (out.numel() == 0 || K == 0) {
+    return out;
+  }
+
+  linear_quantized_kernel<kBits>(
+      input.const_data_ptr<float>(),
+      static_cast<const uint8_t*>(packed_weight.const_data_ptr()),
+      scales.const_data_ptr<float>(),
+      input.numel() / K,
+      K,
+      N,
+      group_size,
+      out.mutable_data_ptr<float>());
+  return out;
+}
+
+} // namespace
+
+Tensor& linear_int4_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out) {
+  return linear_quantized_out<4>(
+      ctx, input, packed_weight, scales, group_size, out);
+}
+
+Tensor& linear_int8_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out) {
+  return linear_quantized_out<8>(
+      ctx, input, packed_weight, scales, group_size, out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+namespace {
+// EXECUTORCH_LIBRARY registers a single op per namespace per file, so both
+// weight widths are registered together.
+const ::executorch::runtime::Kernel linear_quantized_kernels[] = {
+    ::executorch::extension::make_boxed_kernel(
+        "llama::linear_int4.out",
+        EXECUTORCH_FN(torch::executor::native::linear_int4_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::linear_int8.out",
+        EXECUTORCH_FN(torch::executor::native::linear_int8_out)),
+};
+auto res_llama_linear =
+    ::executorch::runtime::register_kernels(linear_quantized_kernels);
+} // namespace
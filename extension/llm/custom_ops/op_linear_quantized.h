@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Number of output features interleaved in each block of a packed weight.
+ */
+constexpr int64_t kLinearPackedBlockSize = 8;
+
+/**
+ * Computes `input @ (weight * scales)^T` for an (N, K) weight quantized
+ * symmetrically to 4 bits in groups of `group_size` input features, with an
+ * (N, K / group_size) float `scales`.
+ *
+ * `packed_weight` is the weight prepacked ahead of time into a uint8 tensor of
+ * shape (ceil(N / 8), K, 4): output features are taken 8 at a time and
+ * interleaved per input feature, so that byte `j` of row `k` of block `b`
+ * holds feature `8b + 2j` in its low nibble and `8b + 2j + 1` in its high
+ * nibble, each offset by 8. Features past N are zero padding.
+ */
+Tensor& linear_int4_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out);
+
+/**
+ * Same as linear_int4_out() for an 8-bit weight, prepacked into an int8
+ * tensor of shape (ceil(N / 8), K, 8) where row `k` of block `b` holds
+ * features `8b` to `8b + 7`.
+ */
+Tensor& linear_int8_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_linear_quantized.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::kLinearPackedBlockSize;
+using torch::executor::testing::TensorFactory;
+
+class OpLinearQuantizedOutTest : public OperatorTest {
+ protected:
+  // Packs an (N, K) weight the way the llama export does, see
+  // op_linear_quantized.h for the layout.
+  static std::vector<uint8_t>
+  pack(const std::vector<int8_t>& weight, int32_t N, int32_t K, int bits) {
+    const int32_t blocks = (N + kLinearPackedBlockSize - 1) /
+        static_cast<int32_t>(kLinearPackedBlockSize);
+    const int32_t row_bytes = kLinearPackedBlockSize * bits / 8;
+    std::vector<uint8_t> packed(blocks * K * row_bytes, 0);
+    for (int32_t n = 0; n < N; ++n) {
+      const int32_t b = n / kLinearPackedBlockSize;
+      const int32_t j = n % kLinearPackedBlockSize;
+      for (int32_t k = 0; k < K; ++k) {
+        uint8_t* row = packed.data() + (b * K + k) * row_bytes;
+        const int8_t w = weight[n * K + k];
+        if (bits == 8) {
+          row[j] = static_cast<uint8_t>(w);
+        } else {
+          row[j / 2] |= static_cast<uint8_t>(w + 8) << (4 * (j % 2));
+        }
+      }
+    }
+    return packed;
+  }
+
+  void test_linear(
+      const std::vector<int32_t>& in_sizes,
+      int32_t N,
+      int32_t group_size,
+      int bits) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Byte> tf_byte;
+    TensorFactory<ScalarType::Char> tf_char;
+
+    const int32_t K = in_sizes.back();
+    const int32_t num_groups = K / group_size;
+    int32_t M = 1;
+    for (size_t d = 0; d + 1 < in_sizes.size(); ++d) {
+      M *= in_sizes[d];
+    }
+    const int32_t qmax = bits == 4 ? 7 : 127;
+
+    std::vector<float> in_data(M * K);
+    for (size_t i = 0; i < in_data.size(); ++i) {
+      in_data[i] = std::sin(0.3f * i) + 0.25f;
+    }
+    std::vector<int8_t> weight(N * K);
+    for (size_t i = 0; i < weight.size(); ++i) {
+      weight[i] = static_cast<int8_t>((i * 37) % (2 * qmax + 2)) - qmax - 1;
+    }
+    std::vector<float> scales_data(N * num_groups);
+    for (size_t i = 0; i < scales_data.size(); ++i) {
+      scales_data[i] = 0.01f * (1 + i % 7);
+    }
+
+    std::vector<float> expected_data(M * N);
+    for (int32_t m = 0; m < M; ++m) {
+      for (int32_t n = 0; n < N; ++n) {
+        double acc = 0;
+        for (int32_t k = 0; k < K; ++k) {
+          acc += in_data[m * K + k] * weight[n * K + k] *
+              scales_data[n * num_groups + k / group_size];
+        }
+        expected_data[m * N + n] = acc;
+      }
+    }
+
+    const int32_t blocks = (N + kLinearPackedBlockSize - 1) /
+        static_cast<int32_t>(kLinearPackedBlockSize);
+    const int32_t row_bytes = kLinearPackedBlockSize * bits / 8;
+    const std::vector<uint8_t> packed = pack(weight, N, K, bits);
+
+    std::vector<int32_t> out_sizes = in_sizes;
+    out_sizes.back() = N;
+    Tensor input = tf.make(in_sizes, in_data);
+    Tensor scales = tf.make({N, num_groups}, scales_data);
+    Tensor out = tf.zeros(out_sizes);
+    if (bits == 4) {
+      Tensor packed_weight = tf_byte.make({blocks, K, row_bytes}, packed);
+      torch::executor::native::linear_int4_out(
+          context_, input, packed_weight, scales, group_size, out);
+    } else {
+      Tensor packed_weight = tf_char.make(
+          {blocks, K, row_bytes},
+          std::vector<int8_t>(packed.begin(), packed.end()));
+      torch::executor::native::linear_int8_out(
+          context_, input, packed_weight, scales, group_size, out);
+    }
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.make(out_sizes, expected_data), 1e-4, 1e-4);
+  }
+};
+
+TEST_F(OpLinearQuantizedOutTest, Int4) {
+  test_linear({3, 32}, /*N=*/16, /*group_size=*/8, /*bits=*/4);
+}
+
+TEST_F(OpLinearQuantizedOutTest, Int8PerChannel) {
+  test_linear({3, 32}, /*N=*/16, /*group_size=*/32, /*bits=*/8);
+}
+
+TEST_F(OpLinearQuantizedOutTest, PartialBlocksAndRowTiles) {
+  // N that is not a multiple of the block size and M that is not a multiple
+  // of the row tile cover the padded features and the single-row tail.
+  test_linear({2, 3, 24}, /*N=*/13, /*group_size=*/12, /*bits=*/4);
+  test_linear({7, 24}, /*N=*/5, /*group_size=*/6, /*bits=*/8);
+}
+
+TEST_F(OpLinearQuantizedOutTest, MismatchedPackedWeightDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tf_byte;
+
+  Tensor input = tf.ones({2, 16});
+  // Packed for 8 input features instead of 16.
+  Tensor packed_weight = tf_byte.zeros({1, 8, 4});
+  Tensor scales = tf.ones({8, 2});
+  Tensor out = tf.zeros({2, 8});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      torch::executor::native::linear_int4_out(
+          context_, input, packed_weight, scales, 8, out));
+}
+
+TEST_F(OpLinearQuantizedOutTest, WrongPackedDtypeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Byte> tf_byte;
+
+  Tensor input = tf.ones({2, 16});
+  Tensor packed_weight = tf_byte.zeros({1, 16, 8});
+  Tensor scales = tf.ones({8, 1});
+  Tensor out = tf.zeros({2, 8});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      torch::executor::native::linear_int8_out(
+          context_, input, packed_weight, scales, 16, out));
+}
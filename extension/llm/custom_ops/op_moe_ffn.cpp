@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_moe_ffn.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+namespace vec = ::executorch::vec;
+using ::executorch::cpublas::TransposeType;
+
+// The tokens routed to an expert are multiplied with its weights in blocks of
+// up to this many rows, each split into this many output features, so that a
+// decode step with a single token per expert still spreads over all threads.
+constexpr int64_t kMoeRowBlock = 64;
+constexpr int64_t kMoeColBlock = 256;
+
+// Tokens are gathered and combined across threads in chunks of at least this
+// many elements.
+constexpr int64_t kMoeGrainSize = 32768;
+
+bool is_contiguous(const Tensor& t) {
+  return is_contiguous_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+bool validate_moe_ffn_args(
+    const Tensor& input,
+    const Tensor& expert_indices,
+    const Tensor& expert_weights,
+    const Tensor& w1,
+    const Tensor& w2,
+    const Tensor& w3,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.scalar_type() == ScalarType::Float, "input must be float32");
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_dtype(input, expert_weights, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, w1, w2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, w3));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      expert_indices.scalar_type() == ScalarType::Long,
+      "expert_indices must be int64");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.dim() >= 1, "input must have at least one dim");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(w1, 3));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_shape(w1, w2, w3));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      w1.size(2) == input.size(input.dim() - 1),
+      "expert weights must have as many input features as the last dim of "
+      "input");
+
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_shape(expert_indices, expert_weights));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      expert_indices.dim() == input.dim(),
+      "expert_indices must have as many dims as input");
+  for (size_t d = 0; d + 1 < input.dim(); ++d) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        expert_indices.size(d) == input.size(d),
+        "expert_indices must have the leading dims of input");
+  }
+
+  for (const Tensor* t :
+       {&input, &expert_indices, &expert_weights, &w1, &w2, &w3}) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        is_contiguous(*t), "moe_ffn arguments must be contiguous");
+  }
+
+  const int64_t num_experts = w1.size(0);
+  const int64_t* indices = expert_indices.const_data_ptr<int64_t>();
+  for (size_t i = 0; i < expert_indices.numel(); ++i) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        indices[i] >= 0 && indices[i] < num_experts,
+        "expert index %" PRId64 " out of range for %" PRId64 " experts",
+        indices[i],
+        num_experts);
+  }
+  return true;
+}
+
+// The rows [begin, end), in expert order, that expert `expert` runs on.
+struct MoeRowBlock {
+  int64_t expert;
+  int64_t begin;
+  int64_t end;
+};
+
+} // namespace
+
+Tensor& moe_ffn_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& expert_indices,
+    const Tensor& expert_weights,
+    const Tensor& w1,
+    const Tensor& w2,
+    const Tensor& w3,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_moe_ffn_args(
+          input, expert_indices, expert_weights, w1, w2, w3, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t num_experts = w1.size(0);
+  const int64_t H = w1.size(1);
+  const int64_t D = w1.size(2);
+  const int64_t top_k = expert_indices.size(expert_indices.dim() - 1);
+  // Each token is routed top_k times; an assignment is one of those routes.
+  const int64_t num_assignments = expert_indices.numel();
+  const int64_t num_tokens = D == 0 ? 0 : input.numel() / D;
+
+  float* out_data = out.mutable_data_ptr<float>();
+  if (num_tokens == 0 || D == 0) {
+    return out;
+  }
+  if (top_k == 0 || H == 0) {
+    std::memset(out_data, 0, out.nbytes());
+    return out;
+  }
+
+  const float* input_data = input.const_data_ptr<float>();
+  const int64_t* indices = expert_indices.const_data_ptr<int64_t>();
+  const float* weights = expert_weights.const_data_ptr<float>();
+  const float* w1_data = w1.const_data_ptr<float>();
+  const float* w2_data = w2.const_data_ptr<float>();
+  const float* w3_data = w3.const_data_ptr<float>();
+
+  // Counting sort of the assignments by expert. Row `row` of the grouped
+  // activations belongs to assignment assignment_of_row[row], and assignment
+  // `a` is at row row_of_assignment[a].
+  std::vector<int64_t> expert_begin(num_experts + 1, 0);
+  for (int64_t a = 0; a < num_assignments; ++a) {
+    expert_begin[indices[a] + 1]++;
+  }
+  for (int64_t e = 0; e < num_experts; ++e) {
+    expert_begin[e + 1] += expert_begin[e];
+  }
+  std::vector<int64_t> row_of_assignment(num_assignments);
+  std::vector<int64_t> assignment_of_row(num_assignments);
+  {
+    std::vector<int64_t> next_row(expert_begin.begin(), expert_begin.end() - 1);
+    for (int64_t a = 0; a < num_assignments; ++a) {
+      const int64_t row = next_row[indices[a]]++;
+      row_of_assignment[a] = row;
+      assignment_of_row[row] = a;
+    }
+  }
+
+  std::vector<MoeRowBlock> blocks;
+  for (int64_t e = 0; e < num_experts; ++e) {
+    for (int64_t begin = expert_begin[e]; begin < expert_begin[e + 1];
+         begin += kMoeRowBlock) {
+      blocks.push_back(
+          {e, begin, std::min(begin + kMoeRowBlock, expert_begin[e + 1])});
+    }
+  }
+
+  // Inputs in expert order, the SwiGLU activations of each row, and the
+  // output of its expert.
+  std::vector<float> grouped_input(num_assignments * D);
+  std::vector<float> hidden(num_assignments * H);
+  std::vector<float> grouped_out(num_assignments * D);
+
+#ifdef ET_USE_THREADPOOL
+  const int64_t num_thread =
+      torch::executorch::threadpool::get_threadpool()->get_thread_count();
+#else
+  const int64_t num_thread = 1;
+#endif
+  // Per thread, the up projection of a tile, next to whose gate projection
+  // in `hidden` it is multiplied.
+  std::vector<float> up_buffers(num_thread * kMoeRowBlock * kMoeColBlock);
+
+  using Vec = vec::Vectorized<float>;
+  const int64_t row_grain = std::max<int64_t>(1, kMoeGrainSize / D);
+
+  torch::executor::parallel_for(
+      0, num_assignments, row_grain, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          std::memcpy(
+              grouped_input.data() + row * D,
+              input_data + assignment_of_row[row] / top_k * D,
+              D * sizeof(float));
+        }
+      });
+
+  // hidden = silu(x @ w1^T) * (x @ w3^T), a tile of rows and hidden features
+  // at a time. cpublas::gemm is column major, so each row major product
+  // C = A @ B^T is computed as C^T = B @ A^T.
+  ::executorch::extension::parallel_for_2d(
+      0,
+      blocks.size(),
+      1,
+      0,
+      H,
+      kMoeColBlock,
+      [&](int64_t block_begin, int64_t, int64_t h_begin, int64_t h_end) {
+        const MoeRowBlock& block = blocks[block_begin];
+        const int64_t rows = block.end - block.begin;
+        const int64_t cols = h_end - h_begin;
+        const int64_t weight_offset = block.expert * H * D + h_begin * D;
+        const float* x = grouped_input.data() + block.begin * D;
+        float* gate = hidden.data() + block.begin * H + h_begin;
+        float* up = up_buffers.data() +
+            torch::executor::get_thread_num() * kMoeRowBlock * kMoeColBlock;
+
+        // clang-format off
+        ::executorch::cpublas::gemm(
+            TransposeType::Transpose, TransposeType::NoTranspose,
+            cols, rows, D,
+            1.0f,
+            w1_data + weight_offset, D,
+            x, D,
+            0.0f,
+            gate, H);
+        ::executorch::cpublas::gemm(
+            TransposeType::Transpose, TransposeType::NoTranspose,
+            cols, rows, D,
+            1.0f,
+            w3_data + weight_offset, D,
+            x, D,
+            0.0f,
+            up, cols);
+        // clang-format on
+
+        for (int64_t i = 0; i < rows; ++i) {
+          vec::map2<float>(
+              [](Vec g, Vec u) {
+                return g * vec::vec_sigmoid<vec::VecMathAccuracy::kFast>(g) *
+                    u;
+              },
+              gate + i * H,
+              gate + i * H,
+              up + i * cols,
+              cols);
+        }
+      });
+
+  // grouped_out = hidden @ w2, a tile of rows and output features at a time.
+  ::executorch::extension::parallel_for_2d(
+      0,
+      blocks.size(),
+      1,
+      0,
+      D,
+      kMoeColBlock,
+      [&](int64_t block_begin, int64_t, int64_t d_begin, int64_t d_end) {
+        const MoeRowBlock& block = blocks[block_begin];
+        // clang-format off
+        ::executorch::cpublas::gemm(
+            TransposeType::NoTranspose, TransposeType::NoTranspose,
+            d_end - d_begin, block.end - block.begin, H,
+            1.0f,
+            w2_data + block.expert * H * D + d_begin, D,
+            hidden.data() + block.begin * H, H,
+            0.0f,
+            grouped_out.data() + block.begin * D + d_begin, D);
+        // clang-format on
+      });
+
+  // Each token's output is the weighted sum of its experts' outputs, summed
+  // in routing order so that results do not depend on the thread count.
+  torch::executor::parallel_for(
+      0,
+      num_tokens,
+      std::max<int64_t>(1, row_grain / top_k),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t t = begin; t < end; ++t) {
+          float* dst = out_data + t * D;
+          for (int64_t j = 0; j < top_k; ++j) {
+            const int64_t a = t * top_k + j;
+            const float* src = grouped_out.data() + row_of_assignment[a] * D;
+            const Vec weight(weights[a]);
+            if (j == 0) {
+              vec::map<float>(
+                  [weight](Vec y) { return y * weight; }, dst, src, D);
+            } else {
+              vec::map2<float>(
+                  [weight](Vec acc, Vec y) { return acc + y * weight; },
+                  dst,
+                  dst,
+                  src,
+                  D);
+            }
+          }
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(llama, "moe_ffn.out", torch::executor::native::moe_ffn_out);
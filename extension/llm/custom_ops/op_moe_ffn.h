@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Runs the SwiGLU feed forward of a mixture of experts layer over the experts
+ * that each token was routed to, and sums their outputs weighted by
+ * `expert_weights`:
+ *
+ *   out[t] = sum_a expert_weights[t, a] *
+ *       (silu(x[t] @ w1[e]^T) * (x[t] @ w3[e]^T)) @ w2[e]
+ *
+ * where e = expert_indices[t, a]. `input` has shape (..., D), and
+ * `expert_indices` (Long) and `expert_weights` have shape (..., top_k) with
+ * the same leading dims. `w1`, `w2` and `w3` have shape (E, H, D), as in
+ * ConditionalFeedForward of the llama example.
+ *
+ * Tokens are grouped by expert so that each expert runs as a matmul over just
+ * the tokens routed to it, so compute scales with top_k instead of E.
+ */
+Tensor& moe_ffn_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& expert_indices,
+    const Tensor& expert_weights,
+    const Tensor& w1,
+    const Tensor& w2,
+    const Tensor& w3,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
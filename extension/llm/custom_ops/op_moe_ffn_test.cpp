@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_moe_ffn.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpMoeFfnOutTest : public OperatorTest {
+ protected:
+  Tensor& op_moe_ffn_out(
+      const Tensor& input,
+      const Tensor& expert_indices,
+      const Tensor& expert_weights,
+      const Tensor& w1,
+      const Tensor& w2,
+      const Tensor& w3,
+      Tensor& out) {
+    return torch::executor::native::moe_ffn_out(
+        context_, input, expert_indices, expert_weights, w1, w2, w3, out);
+  }
+
+  static std::vector<float> make_values(size_t size, double scale) {
+    std::vector<float> values(size);
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = std::sin(i * 0.37 + 1) * scale;
+    }
+    return values;
+  }
+
+  // Checks moe_ffn against a dense computation of each token's experts, for
+  // tokens of shape `leading_sizes` routed to experts by `route(token, j)`.
+  template <typename Route>
+  void test_moe_ffn(
+      const std::vector<int32_t>& leading_sizes,
+      int32_t D,
+      int32_t H,
+      int32_t E,
+      int32_t top_k,
+      const Route& route) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Long> tf_long;
+
+    int32_t T = 1;
+    for (const int32_t size : leading_sizes) {
+      T *= size;
+    }
+    const std::vector<float> x = make_values(T * D, 1.0);
+    const std::vector<float> w1 = make_values(E * H * D, 0.3);
+    const std::vector<float> w2 = make_values(E * H * D + 5, 0.2);
+    const std::vector<float> w3 = make_values(E * H * D + 11, 0.3);
+
+    std::vector<int64_t> indices(T * top_k);
+    std::vector<float> weights(T * top_k);
+    std::vector<float> expected(T * D, 0);
+    for (int32_t t = 0; t < T; ++t) {
+      for (int32_t j = 0; j < top_k; ++j) {
+        const int32_t e = route(t, j);
+        const float weight = 1.0f / (j + 2);
+        indices[t * top_k + j] = e;
+        weights[t * top_k + j] = weight;
+
+        std::vector<double> hidden(H);
+        for (int32_t h = 0; h < H; ++h) {
+          double gate = 0;
+          double up = 0;
+          for (int32_t d = 0; d < D; ++d) {
+            gate += x[t * D + d] * w1[(e * H + h) * D + d];
+            up += x[t * D + d] * w3[(e * H + h) * D + d];
+          }
+          hidden[h] = gate / (1 + std::exp(-gate)) * up;
+        }
+        for (int32_t d = 0; d < D; ++d) {
+          double y = 0;
+          for (int32_t h = 0; h < H; ++h) {
+            y += hidden[h] * w2[(e * H + h) * D + d];
+          }
+          expected[t * D + d] += weight * y;
+        }
+      }
+    }
+
+    std::vector<int32_t> input_sizes = leading_sizes;
+    input_sizes.push_back(D);
+    std::vector<int32_t> routing_sizes = leading_sizes;
+    routing_sizes.push_back(top_k);
+    const std::vector<int32_t> weight_sizes = {E, H, D};
+
+    Tensor out = tf.zeros(input_sizes);
+    op_moe_ffn_out(
+        tf.make(input_sizes, x),
+        tf_long.make(routing_sizes, indices),
+        tf.make(routing_sizes, weights),
+        tf.make(weight_sizes, w1),
+        tf.make(weight_sizes, {w2.begin(), w2.begin() + E * H * D}),
+        tf.make(weight_sizes, {w3.begin(), w3.begin() + E * H * D}),
+        out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.make(input_sizes, expected), 1e-4, 1e-4);
+  }
+};
+
+TEST_F(OpMoeFfnOutTest, MatchesDenseExperts) {
+  // A hidden dim that spans several column blocks and ends in a partial one.
+  test_moe_ffn(
+      {2, 3}, 20, 300, 4, 2, [](int32_t t, int32_t j) { return (t + j) % 4; });
+}
+
+TEST_F(OpMoeFfnOutTest, SingleToken) {
+  test_moe_ffn({1, 1}, 64, 96, 8, 2, [](int32_t, int32_t j) {
+    return j == 0 ? 5 : 2;
+  });
+}
+
+TEST_F(OpMoeFfnOutTest, ManyTokensPerExpert) {
+  // More tokens per expert than a row block, while expert 2 gets none.
+  test_moe_ffn({150}, 12, 40, 3, 1, [](int32_t t, int32_t) {
+    return t % 5 == 0 ? 1 : 0;
+  });
+}
+
+TEST_F(OpMoeFfnOutTest, OutOfRangeExpertDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf.ones({2, 4});
+  Tensor indices = tf_long.make({2, 1}, {0, 3});
+  Tensor weights = tf.ones({2, 1});
+  Tensor w = tf.ones({3, 5, 4});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_moe_ffn_out(input, indices, weights, w, w, w, out));
+}
+
+TEST_F(OpMoeFfnOutTest, MismatchedInputFeaturesDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf.ones({2, 4});
+  Tensor indices = tf_long.zeros({2, 1});
+  Tensor weights = tf.ones({2, 1});
+  Tensor w = tf.ones({3, 5, 6});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_moe_ffn_out(input, indices, weights, w, w, w, out));
+}
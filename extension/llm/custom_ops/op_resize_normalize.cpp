@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/llm/custom_ops/op_resize_normalize.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+bool check_resize_normalize_out_args(
+    const Tensor& in,
+    int64_t height,
+    int64_t width,
+    ArrayRef<double> mean,
+    ArrayRef<double> std,
+    bool channels_last,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(in.scalar_type() == ScalarType::Byte);
+  ET_LOG_AND_RETURN_IF_FALSE(out.scalar_type() == ScalarType::Float);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(in, 3));
+  ET_LOG_AND_RETURN_IF_FALSE(height > 0 && width > 0);
+  const int64_t channels = in.size(channels_last ? 2 : 0);
+  ET_LOG_AND_RETURN_IF_FALSE(static_cast<int64_t>(mean.size()) == channels);
+  ET_LOG_AND_RETURN_IF_FALSE(static_cast<int64_t>(std.size()) == channels);
+  for (double s : std) {
+    ET_LOG_AND_RETURN_IF_FALSE(s != 0);
+  }
+  return true;
+}
+
+// The two source pixels that a destination pixel interpolates between along
+// one axis, and the weight of the second one.
+struct Tap {
+  int64_t i0;
+  int64_t i1;
+  float lambda;
+};
+
+// Computes the taps of every destination pixel along an axis, with the same
+// source coordinates as upsample_bilinear2d with align_corners=False.
+std::vector<Tap> compute_taps(int64_t in_size, int64_t out_size) {
+  std::vector<Tap> taps(out_size);
+  const float ratio = static_cast<float>(in_size) / out_size;
+  for (int64_t i = 0; i < out_size; ++i) {
+    const float src = std::max(0.0f, (i + 0.5f) * ratio - 0.5f);
+    const int64_t i0 = std::min(static_cast<int64_t>(src), in_size - 1);
+    taps[i] = {i0, std::min(i0 + 1, in_size - 1), src - i0};
+  }
+  return taps;
+}
+
+} // namespace
+
+Tensor& resize_normalize_out_impl(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const int64_t height,
+    const int64_t width,
+    const ArrayRef<double> mean,
+    const ArrayRef<double> std,
+    const double scale,
+    const bool channels_last,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_resize_normalize_out_args(
+          input, height, width, mean, std, channels_last, out),
+      InvalidArgument,
+      out);
+
+  const int64_t channels = input.size(channels_last ? 2 : 0);
+  const int64_t in_height = input.size(channels_last ? 0 : 1);
+  const int64_t in_width = input.size(channels_last ? 1 : 2);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  Tensor::SizesType expected_out_size[3] = {
+      static_cast<Tensor::SizesType>(channels),
+      static_cast<Tensor::SizesType>(height),
+      static_cast<Tensor::SizesType>(width)};
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, 3}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  // Strides of the input in elements, so that both layouts share one loop.
+  const int64_t c_stride = channels_last ? 1 : in_height * in_width;
+  const int64_t h_stride = channels_last ? in_width * channels : in_width;
+  const int64_t w_stride = channels_last ? channels : 1;
+
+  const std::vector<Tap> h_taps = compute_taps(in_height, height);
+  const std::vector<Tap> w_taps = compute_taps(in_width, width);
+
+  // (x * scale - mean) / std is folded into x * mul + add.
+  std::vector<float> mul(channels);
+  std::vector<float> add(channels);
+  for (int64_t c = 0; c < channels; ++c) {
+    mul[c] = static_cast<float>(scale / std[c]);
+    add[c] = static_cast<float>(-mean[c] / std[c]);
+  }
+
+  const uint8_t* const in_data = input.const_data_ptr<uint8_t>();
+  float* const out_data = out.mutable_data_ptr<float>();
+
+  // Each output row is independent, so rows are split across threads. The
+  // inner loop over the columns of a row has no dependencies between
+  // iterations and vectorizes.
+  parallel_for(
+      0, channels * height, /*grain_size=*/1, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t c = row / height;
+          const Tap& ht = h_taps[row % height];
+          const uint8_t* const top = in_data + c * c_stride + ht.i0 * h_stride;
+          const uint8_t* const bottom =
+              in_data + c * c_stride + ht.i1 * h_stride;
+          const float c_mul = mul[c];
+          const float c_add = add[c];
+          float* const dst = out_data + row * width;
+          for (int64_t w = 0; w < width; ++w) {
+            const Tap& wt = w_taps[w];
+            const int64_t x0 = wt.i0 * w_stride;
+            const int64_t x1 = wt.i1 * w_stride;
+            const float t = top[x0] + wt.lambda * (top[x1] - top[x0]);
+            const float b = bottom[x0] + wt.lambda * (bottom[x1] - bottom[x0]);
+            const float v = t + ht.lambda * (b - t);
+            dst[w] = v * c_mul + c_add;
+          }
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    preprocess,
+    "resize_normalize.out",
+    torch::executor::native::resize_normalize_out_impl);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Resizes a uint8 image with bilinear interpolation, scales and normalizes it
+ * per channel, and writes it as a float [C, height, width] tensor, in one pass
+ * over the output. This matches
+ *
+ *   F.interpolate(img.float(), (height, width), mode="bilinear")
+ *   (x * scale - mean[c]) / std[c]
+ *
+ * with align_corners=False.
+ *
+ * @param input A uint8 image of shape [C, H, W], or [H, W, C] if
+ *     `channels_last`, e.g. the interleaved pixels of a camera frame.
+ * @param mean The per-channel mean, subtracted after scaling.
+ * @param std The per-channel standard deviation, divided by last.
+ * @param scale The factor applied to the pixel values, e.g. 1/255.
+ */
+Tensor& resize_normalize_out_impl(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const int64_t height,
+    const int64_t width,
+    const ArrayRef<double> mean,
+    const ArrayRef<double> std,
+    const double scale,
+    const bool channels_last,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_resize_normalize.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpResizeNormalizeOutTest : public OperatorTest {
+ protected:
+  Tensor& op_resize_normalize_out(
+      const Tensor& self,
+      int64_t height,
+      int64_t width,
+      ArrayRef<double> mean,
+      ArrayRef<double> std,
+      double scale,
+      bool channels_last,
+      Tensor& out) {
+    return torch::executor::native::resize_normalize_out_impl(
+        context_, self, height, width, mean, std, scale, channels_last, out);
+  }
+};
+
+TEST_F(OpResizeNormalizeOutTest, NormalizesWithoutResizing) {
+  TensorFactory<ScalarType::Byte> tf_in;
+  TensorFactory<ScalarType::Float> tf_out;
+
+  const std::vector<double> mean = {1.0, 2.0};
+  const std::vector<double> std = {2.0, 0.5};
+  Tensor out = tf_out.zeros({2, 1, 2});
+  op_resize_normalize_out(
+      tf_in.make({2, 1, 2}, {3, 5, 4, 6}),
+      1,
+      2,
+      {mean.data(), mean.size()},
+      {std.data(), std.size()},
+      1.0,
+      /*channels_last=*/false,
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf_out.make({2, 1, 2}, {1.0, 2.0, 4.0, 8.0}));
+}
+
+TEST_F(OpResizeNormalizeOutTest, ChannelsLastMatchesChannelsFirst) {
+  TensorFactory<ScalarType::Byte> tf_in;
+  TensorFactory<ScalarType::Float> tf_out;
+
+  const std::vector<double> mean = {0.5, 0.25};
+  const std::vector<double> std = {0.5, 0.25};
+  // clang-format off
+  Tensor chw = tf_in.make({2, 2, 3}, {  0,  10,  20,
+                                       30,  40,  50,
+                                      255, 200, 100,
+                                        0,   5,  60});
+  Tensor hwc = tf_in.make({2, 3, 2}, {  0, 255,  10, 200,  20, 100,
+                                       30,   0,  40,   5,  50,  60});
+  // clang-format on
+  Tensor out_chw = tf_out.zeros({2, 3, 5});
+  Tensor out_hwc = tf_out.zeros({2, 3, 5});
+  op_resize_normalize_out(
+      chw,
+      3,
+      5,
+      {mean.data(), mean.size()},
+      {std.data(), std.size()},
+      1.0 / 255,
+      /*channels_last=*/false,
+      out_chw);
+  op_resize_normalize_out(
+      hwc,
+      3,
+      5,
+      {mean.data(), mean.size()},
+      {std.data(), std.size()},
+      1.0 / 255,
+      /*channels_last=*/true,
+      out_hwc);
+  EXPECT_TENSOR_CLOSE(out_chw, out_hwc);
+}
+
+TEST_F(OpResizeNormalizeOutTest, BilinearUpsampleMatchesInterpolate) {
+  TensorFactory<ScalarType::Byte> tf_in;
+  TensorFactory<ScalarType::Float> tf_out;
+
+  const std::vector<double> mean = {0.0};
+  const std::vector<double> std = {1.0};
+  Tensor out = tf_out.zeros({1, 1, 4});
+  op_resize_normalize_out(
+      tf_in.make({1, 1, 2}, {0, 100}),
+      1,
+      4,
+      {mean.data(), mean.size()},
+      {std.data(), std.size()},
+      1.0,
+      /*channels_last=*/false,
+      out);
+  // torch.nn.functional.interpolate(
+  //     torch.tensor([[[[0.0, 100.0]]]]), size=(1, 4), mode="bilinear")
+  EXPECT_TENSOR_CLOSE(out, tf_out.make({1, 1, 4}, {0.0, 25.0, 75.0, 100.0}));
+}
+
+TEST_F(OpResizeNormalizeOutTest, WrongMeanSizeDies) {
+  TensorFactory<ScalarType::Byte> tf_in;
+  TensorFactory<ScalarType::Float> tf_out;
+
+  const std::vector<double> mean = {0.0, 0.0};
+  const std::vector<double> std = {1.0, 1.0, 1.0};
+  Tensor out = tf_out.zeros({3, 2, 2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_resize_normalize_out(
+          tf_in.ones({3, 2, 2}),
+          2,
+          2,
+          {mean.data(), mean.size()},
+          {std.data(), std.size()},
+          1.0,
+          false,
+          out));
+}
+
+TEST_F(OpResizeNormalizeOutTest, NonByteInputDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const std::vector<double> mean = {0.0};
+  const std::vector<double> std = {1.0};
+  Tensor out = tf.zeros({1, 2, 2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_resize_normalize_out(
+          tf.ones({1, 2, 2}),
+          2,
+          2,
+          {mean.data(), mean.size()},
+          {std.data(), std.size()},
+          1.0,
+          false,
+          out));
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+namespace vec = ::executorch::vec;
+
+// Rows are split across threads in chunks of at least this many elements.
+constexpr int64_t kRmsNormGrainSize = 32768;
+
+bool validate_rms_norm_args(
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, weight, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_floating_type(input));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.dim() >= 1, "input must have at least one dim");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 1));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight.size(0) == input.size(input.dim() - 1),
+      "weight must have as many elements as the last dim of input");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          input.dim_order().data(), input.dim_order().size()),
+      "input must be contiguous");
+  return true;
+}
+
+template <typename CTYPE>
+void rms_norm_kernel(
+    const CTYPE* input_data,
+    const CTYPE* weight_data,
+    const CTYPE eps,
+    const int64_t M,
+    const int64_t N,
+    CTYPE* out_data) {
+  using Vec = vec::Vectorized<CTYPE>;
+  const int64_t grain_size = std::max<int64_t>(1, kRmsNormGrainSize / N);
+  torch::executor::parallel_for(
+      0, M, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE* src_ptr = input_data + i * N;
+          CTYPE* dst_ptr = out_data + i * N;
+
+          const CTYPE sum_of_squares = vec::map_reduce_all<CTYPE>(
+              [](Vec x) { return x * x; },
+              [](Vec x, Vec y) { return x + y; },
+              src_ptr,
+              N);
+          const CTYPE rstd = CTYPE(1) /
+              std::sqrt(sum_of_squares / static_cast<CTYPE>(N) + eps);
+
+          vec::map2<CTYPE>(
+              [rstd](Vec x, Vec weight) { return x * Vec(rstd) * weight; },
+              dst_ptr,
+              src_ptr,
+              weight_data,
+              N);
+        }
+      });
+}
+
+} // namespace
+
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_rms_norm_args(input, weight, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (input.numel() == 0) {
+    return out;
+  }
+
+  const int64_t N = input.size(input.dim() - 1);
+  const int64_t M = input.numel() / N;
+
+  constexpr auto name = "rms_norm.out";
+
+  ET_SWITCH_FLOAT_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    rms_norm_kernel<CTYPE>(
+        input.const_data_ptr<CTYPE>(),
+        weight.const_data_ptr<CTYPE>(),
+        static_cast<CTYPE>(eps),
+        M,
+        N,
+        out.mutable_data_ptr<CTYPE>());
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "rms_norm.out",
+    torch::executor::native::rms_norm_out);
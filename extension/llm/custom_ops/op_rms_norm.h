@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Computes `x * rsqrt(mean(x * x) + eps) * weight` over the last dim of
+ * `input`, i.e. the RMSNorm of each row, in a single kernel.
+ */
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
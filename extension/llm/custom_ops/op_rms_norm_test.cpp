@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpRmsNormOutTest : public OperatorTest {
+ protected:
+  Tensor& op_rms_norm_out(
+      const Tensor& input,
+      const Tensor& weight,
+      double eps,
+      Tensor& out) {
+    return torch::executor::native::rms_norm_out(
+        context_, input, weight, eps, out);
+  }
+
+  template <ScalarType DTYPE>
+  void test_rms_norm() {
+    TensorFactory<DTYPE> tf;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    // Rows long enough to cover the vectorized loops and their tails.
+    const std::vector<int32_t> sizes = {2, 3, 37};
+    const int32_t rows = 6;
+    const int32_t cols = 37;
+    const double eps = 1e-5;
+
+    std::vector<CTYPE> input_data(rows * cols);
+    std::vector<CTYPE> weight_data(cols);
+    for (int32_t j = 0; j < cols; ++j) {
+      weight_data[j] = 0.5 + 0.1 * (j % 5);
+    }
+    std::vector<CTYPE> expected_data(rows * cols);
+    for (int32_t i = 0; i < rows; ++i) {
+      double sum_of_squares = 0;
+      for (int32_t j = 0; j < cols; ++j) {
+        input_data[i * cols + j] = std::sin(i * cols + j) * (i + 1);
+        sum_of_squares += input_data[i * cols + j] * input_data[i * cols + j];
+      }
+      const double rstd = 1 / std::sqrt(sum_of_squares / cols + eps);
+      for (int32_t j = 0; j < cols; ++j) {
+        expected_data[i * cols + j] =
+            input_data[i * cols + j] * rstd * weight_data[j];
+      }
+    }
+
+    Tensor input = tf.make(sizes, input_data);
+    Tensor weight = tf.make({cols}, weight_data);
+    Tensor out = tf.zeros(sizes);
+
+    op_rms_norm_out(input, weight, eps, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected_data));
+  }
+};
+
+TEST_F(OpRmsNormOutTest, FloatDtypesSupported) {
+  test_rms_norm<ScalarType::Float>();
+  test_rms_norm<ScalarType::Double>();
+}
+
+TEST_F(OpRmsNormOutTest, ResizesOut) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.make({2, 2}, {3, 4, 0, 1});
+  Tensor weight = tf.make({2}, {1, 2});
+  Tensor out = tf.zeros(
+      {4, 4}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
+
+  op_rms_norm_out(input, weight, 0, out);
+  const float rstd0 = 1 / std::sqrt(12.5f);
+  const float rstd1 = 1 / std::sqrt(0.5f);
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({2, 2}, {3 * rstd0, 8 * rstd0, 0, 2 * rstd1}));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedWeightSizeDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({3});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 1e-5, out));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedDtypeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({4});
+  Tensor out = tf_double.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 1e-5, out));
+}
+
+TEST_F(OpRmsNormOutTest, IntegerDtypeDies) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({4});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 1e-5, out));
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+
+#include <algorithm>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+namespace {
+
+namespace vec = ::executorch::vec;
+
+// Heads are split across threads in chunks of at least this many elements.
+constexpr int64_t kRotaryEmbGrainSize = 32768;
+
+bool validate_rotary_emb_args(
+    const Tensor& input,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_dtype(input, freqs_cos, freqs_sin));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_floating_type(input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(input, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(freqs_cos, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_shape(freqs_cos, freqs_sin));
+
+  const int64_t head_dim = input.size(3);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      head_dim % 2 == 0, "head dim must be even, got %zd", input.size(3));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.size(0) == input.size(1),
+      "rope tables must have a row per position, %zd rows for %zd positions",
+      freqs_cos.size(0),
+      input.size(1));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.size(1) == head_dim / 2 || freqs_cos.size(1) == head_dim,
+      "rope tables must have head dim / 2 or head dim columns, not %zd",
+      freqs_cos.size(1));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(input.dim_order().data(), input.dim()) &&
+          is_contiguous_dim_order(freqs_cos.dim_order().data(), 2) &&
+          is_contiguous_dim_order(freqs_sin.dim_order().data(), 2),
+      "input and rope tables must be contiguous");
+  return true;
+}
+
+template <typename CTYPE>
+void rotary_emb_kernel(
+    const CTYPE* input_data,
+    const CTYPE* cos_data,
+    const CTYPE* sin_data,
+    const int64_t seq_len,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t table_cols,
+    const int64_t num_rows,
+    CTYPE* out_data) {
+  using Vec = vec::Vectorized<CTYPE>;
+  const int64_t half = head_dim / 2;
+  const bool interleaved = table_cols == half;
+  const int64_t grain_size =
+      std::max<int64_t>(1, kRotaryEmbGrainSize / head_dim);
+  torch::executor::parallel_for(
+      0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t pos = (row / num_heads) % seq_len;
+          const CTYPE* cos = cos_data + pos * table_cols;
+          const CTYPE* sin = sin_data + pos * table_cols;
+          const CTYPE* x = input_data + row * head_dim;
+          CTYPE* y = out_data + row * head_dim;
+          if (interleaved) {
+            for (int64_t i = 0; i < half; ++i) {
+              const CTYPE x0 = x[2 * i];
+              const CTYPE x1 = x[2 * i + 1];
+              y[2 * i] = x0 * cos[i] - x1 * sin[i];
+              y[2 * i + 1] = x0 * sin[i] + x1 * cos[i];
+            }
+          } else {
+            // x * cos + rotate_half(x) * sin
+            vec::map4<CTYPE>(
+                [](Vec x0, Vec x1, Vec c, Vec s) { return x0 * c - x1 * s; },
+                y,
+                x,
+                x + half,
+                cos,
+                sin,
+                half);
+            vec::map4<CTYPE>(
+                [](Vec x1, Vec x0, Vec c, Vec s) { return x1 * c + x0 * s; },
+                y + half,
+                x + half,
+                x,
+                cos + half,
+                sin + half,
+                half);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& apply_rotary_emb_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_rotary_emb_args(input, freqs_cos, freqs_sin, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (input.numel() == 0) {
+    return out;
+  }
+
+  constexpr auto name = "apply_rotary_emb.out";
+
+  ET_SWITCH_FLOAT_TYPES(input.scalar_type(), ctx, name, CTYPE, [&]() {
+    rotary_emb_kernel<CTYPE>(
+        input.const_data_ptr<CTYPE>(),
+        freqs_cos.const_data_ptr<CTYPE>(),
+        freqs_sin.const_data_ptr<CTYPE>(),
+        input.size(1),
+        input.size(2),
+        input.size(3),
+        freqs_cos.size(1),
+        input.numel() / input.size(3),
+        out.mutable_data_ptr<CTYPE>());
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "apply_rotary_emb.out",
+    torch::executor::native::apply_rotary_emb_out);
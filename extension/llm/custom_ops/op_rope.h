@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+/**
+ * Applies rotary position embeddings to `input`, [batch size, seq len, num
+ * heads, head dim], in a single kernel. Row s of `freqs_cos` and `freqs_sin`
+ * holds the rotation of position s. Tables of head dim / 2 columns rotate
+ * interleaved pairs of the head dim, as llama does; tables of head dim
+ * columns rotate its two halves, as HuggingFace does.
+ */
+Tensor& apply_rotary_emb_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
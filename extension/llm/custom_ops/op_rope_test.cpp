@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpApplyRotaryEmbOutTest : public OperatorTest {
+ protected:
+  Tensor& op_apply_rotary_emb_out(
+      const Tensor& input,
+      const Tensor& freqs_cos,
+      const Tensor& freqs_sin,
+      Tensor& out) {
+    return torch::executor::native::apply_rotary_emb_out(
+        context_, input, freqs_cos, freqs_sin, out);
+  }
+
+  // Compares the op to rope.py, with interleaved pairs (llama) or rotated
+  // halves (HuggingFace) of the head dim.
+  template <ScalarType DTYPE>
+  void test_rotary_emb(bool interleaved) {
+    TensorFactory<DTYPE> tf;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+    // A head dim long enough to cover the vectorized loops and their tails.
+    const int32_t batch = 2;
+    const int32_t seq_len = 3;
+    const int32_t num_heads = 2;
+    const int32_t head_dim = 36;
+    const int32_t half = head_dim / 2;
+    const int32_t cols = interleaved ? half : head_dim;
+    const int32_t start_pos = 5;
+
+    std::vector<CTYPE> cos_data(seq_len * cols);
+    std::vector<CTYPE> sin_data(seq_len * cols);
+    for (int32_t s = 0; s < seq_len; ++s) {
+      for (int32_t c = 0; c < cols; ++c) {
+        const double freq = std::pow(10000.0, -2.0 * (c % half) / head_dim);
+        cos_data[s * cols + c] = std::cos((start_pos + s) * freq);
+        sin_data[s * cols + c] = std::sin((start_pos + s) * freq);
+      }
+    }
+
+    const int32_t numel = batch * seq_len * num_heads * head_dim;
+    std::vector<CTYPE> input_data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      input_data[i] = std::sin(i * 0.37);
+    }
+    std::vector<CTYPE> expected_data(numel);
+    for (int32_t row = 0; row < numel / head_dim; ++row) {
+      const int32_t s = (row / num_heads) % seq_len;
+      const CTYPE* x = input_data.data() + row * head_dim;
+      CTYPE* y = expected_data.data() + row * head_dim;
+      for (int32_t i = 0; i < half; ++i) {
+        const int32_t i0 = interleaved ? 2 * i : i;
+        const int32_t i1 = interleaved ? 2 * i + 1 : i + half;
+        const CTYPE c = cos_data[s * cols + i];
+        const CTYPE sn = sin_data[s * cols + i];
+        y[i0] = x[i0] * c - x[i1] * sn;
+        y[i1] = x[i0] * sn + x[i1] * c;
+      }
+    }
+
+    const std::vector<int32_t> sizes = {batch, seq_len, num_heads, head_dim};
+    Tensor input = tf.make(sizes, input_data);
+    Tensor freqs_cos = tf.make({seq_len, cols}, cos_data);
+    Tensor freqs_sin = tf.make({seq_len, cols}, sin_data);
+    Tensor out = tf.zeros(sizes);
+
+    op_apply_rotary_emb_out(input, freqs_cos, freqs_sin, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected_data));
+  }
+};
+
+TEST_F(OpApplyRotaryEmbOutTest, InterleavedPairs) {
+  test_rotary_emb<ScalarType::Float>(/*interleaved=*/true);
+  test_rotary_emb<ScalarType::Double>(/*interleaved=*/true);
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, RotatedHalves) {
+  test_rotary_emb<ScalarType::Float>(/*interleaved=*/false);
+  test_rotary_emb<ScalarType::Double>(/*interleaved=*/false);
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, QuarterTurn) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // A rotation by pi / 2 maps (x0, x1) to (-x1, x0).
+  Tensor input = tf.make({1, 1, 1, 4}, {1, 2, 3, 4});
+  Tensor freqs_cos = tf.make({1, 2}, {0, 1});
+  Tensor freqs_sin = tf.make({1, 2}, {1, 0});
+  Tensor out = tf.zeros({1, 1, 1, 4});
+
+  op_apply_rotary_emb_out(input, freqs_cos, freqs_sin, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 1, 4}, {-2, 1, 3, 4}));
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, MismatchedTableRowsDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.ones({1, 3, 2, 4});
+  Tensor freqs = tf.ones({2, 2});
+  Tensor out = tf.zeros({1, 3, 2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_apply_rotary_emb_out(input, freqs, freqs, out));
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, MismatchedTableColumnsDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.ones({1, 3, 2, 4});
+  Tensor freqs = tf.ones({3, 3});
+  Tensor out = tf.zeros({1, 3, 2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_apply_rotary_emb_out(input, freqs, freqs, out));
+}
@@ -9,13 +9,17 @@
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/cpu/activation_utils.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 // @lint-ignore CLANGTIDY facebook-unused-include-check
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
 // patternlint-disable-next-line executorch-cpp-nostdinc
 #include <vector>
 
@@ -84,6 +88,21 @@ using Tensor = exec_aten::Tensor;
 
 namespace {
 
+// The fewest keys that a thread attends to in split-KV decode.
+constexpr int64_t kMinKeysPerKVPartition = 256;
+
+template <typename T>
+inline vec::Vectorized<T> _vec_exp(const vec::Vectorized<T>& x) {
+  return x.exp();
+}
+
+// The polynomial exp stays in vector registers where Vectorized<float>::exp()
+// may fall back to libm per lane. The outputs are compared against eager
+// softmax, so keep the accurate tier.
+inline vec::Vectorized<float> _vec_exp(const vec::Vectorized<float>& x) {
+  return vec::vec_exp<vec::VecMathAccuracy::kUlp>(x);
+}
+
 // 1) out = exp(a - val)
 // 2) val = sum(out)
 template <typename T1, typename T2>
@@ -96,9 +115,7 @@ _exp_reduce_sum_fusion_kernel(T1* a, const int& size, T2* out, T1& val) {
   for (int i = 0; i < vec_size * (size / vec_size); i += vec_size) {
     auto tmp0 = vec::Vectorized<T1>::loadu(a + i);
     auto tmp1 = tmp0 - vec_max;
-    // Replace with exp_u20 later
-    // auto tmp2 = tmp1.exp_u20();
-    auto tmp2 = tmp1.exp();
+    auto tmp2 = _vec_exp(tmp1);
     vec_tmp_sum += tmp2;
     util::_store(out + i, tmp2);
   }
@@ -149,22 +166,6 @@ inline void _mul_reduce_max_fusion_kernel(
           vec_tmp_max));
 }
 
-template <typename scalar_t>
-static inline scalar_t* conditional_data_ptr(scalar_t* ptr, scalar_t* ptr2) {
-  ET_CHECK(ptr2 == nullptr);
-  return ptr;
-}
-
-template <
-    typename scalar_t,
-    typename std::enable_if_t<
-        torch::executor::is_reduced_floating_point<scalar_t>::value,
-        int> = 0>
-static inline scalar_t* conditional_data_ptr(float* ptr, scalar_t* ptr2) {
-  (void)ptr;
-  return ptr2;
-}
-
 template <typename scalar_t>
 inline void fill_stub(scalar_t* data, scalar_t val, int64_t size) {
   using Vec = vec::Vectorized<scalar_t>;
@@ -178,6 +179,140 @@ inline void fill_stub(scalar_t* data, scalar_t val, int64_t size) {
   }
 }
 
+/*
+Paged kv cache:
+The key and value caches are pools of fixed-size blocks,
+[num_blocks, block_size, num heads, head dim], instead of one
+[batch, max_seq_len, num heads, head dim] buffer. Row b of the block table,
+[batch, max_blocks_per_seq], lists the blocks that hold the tokens of
+sequence b in order: token t of sequence b lives at row t % block_size of
+block block_table[b][t / block_size]. Blocks are only needed for the tokens
+that have been seen so far, and sequences with a common prefix can point at
+the same blocks.
+*/
+struct PagedKVCacheView {
+  const int64_t* block_table;
+  int64_t block_table_stride;
+  int64_t block_size;
+  // Number of tokens of every sequence that attention reads from the cache.
+  int64_t num_tokens;
+};
+
+// Returns the rows [start, start + count) of sequence `seq` in a paged cache,
+// starting `head_offset` elements into each row, and stores their leading
+// dimension in `ld`. Rows that are in a single block are returned in place;
+// otherwise head_size elements of each are gathered into `scratch`, which
+// must have room for count * head_size elements.
+template <typename scalar_t>
+const scalar_t* paged_kv_rows(
+    const scalar_t* cache_data,
+    int64_t block_stride,
+    int64_t row_stride,
+    int64_t head_offset,
+    const PagedKVCacheView& paged_kv,
+    int64_t seq,
+    int64_t start,
+    int64_t count,
+    int64_t head_size,
+    scalar_t* scratch,
+    int64_t& ld) {
+  const int64_t* table =
+      paged_kv.block_table + seq * paged_kv.block_table_stride;
+  const int64_t block_size = paged_kv.block_size;
+  const int64_t row_in_block = start % block_size;
+  if (row_in_block + count <= block_size) {
+    ld = row_stride;
+    return cache_data + table[start / block_size] * block_stride +
+        row_in_block * row_stride + head_offset;
+  }
+  for (int64_t row = 0; row < count; ++row) {
+    const int64_t pos = start + row;
+    const scalar_t* src = cache_data + table[pos / block_size] * block_stride +
+        (pos % block_size) * row_stride + head_offset;
+    std::memcpy(scratch + row * head_size, src, head_size * sizeof(scalar_t));
+  }
+  ld = head_size;
+  return scratch;
+}
+
+/*
+Quantized kv cache:
+The key and value caches hold int8 values, [batch, max_seq_len, num heads,
+head dim], and every head of every token has its own float scale in a
+[batch, max_seq_len, num heads] scales tensor: value = int8 value * scale.
+Heads are quantized symmetrically as they are written to the cache, and a
+kv split is dequantized into a small per thread buffer right before it is
+used, so attention reads a quarter of the bytes of a float cache.
+*/
+struct QuantizedKVCacheView {
+  const int8_t* key_data;
+  const int8_t* value_data;
+  const float* key_scales;
+  const float* value_scales;
+  int64_t scales_stride_b;
+  int64_t scales_stride_n;
+  // Number of tokens of every sequence that attention reads from the cache.
+  int64_t num_tokens;
+};
+
+// Dequantizes `count` rows of head_size int8 values, row_stride apart and
+// with one scale per row, scale_stride apart, into `out`.
+template <typename scalar_t>
+void dequantize_kv_rows(
+    const int8_t* data,
+    int64_t row_stride,
+    const float* scales,
+    int64_t scale_stride,
+    int64_t count,
+    int64_t head_size,
+    scalar_t* out) {
+  for (int64_t row = 0; row < count; ++row) {
+    const int8_t* src = data + row * row_stride;
+    const scalar_t row_scale =
+        static_cast<scalar_t>(scales[row * scale_stride]);
+    scalar_t* dst = out + row * head_size;
+    for (int64_t d = 0; d < head_size; ++d) {
+      dst[d] = static_cast<scalar_t>(src[d]) * row_scale;
+    }
+  }
+}
+
+// Converts `count` rows of head_size Half or BFloat16 values, row_stride
+// apart, to the float type that attention accumulates in.
+template <typename scalar_t, typename accum_t>
+void convert_rows_to_accum(
+    const scalar_t* data,
+    int64_t row_stride,
+    int64_t count,
+    int64_t head_size,
+    accum_t* out) {
+  for (int64_t row = 0; row < count; ++row) {
+    const scalar_t* src = data + row * row_stride;
+    accum_t* dst = out + row * head_size;
+    for (int64_t d = 0; d < head_size; ++d) {
+      dst[d] = ActivationCompute<scalar_t>::to_compute(src[d]);
+    }
+  }
+}
+
+// out <- src * scale, converting to the type of the output.
+template <typename scalar_t, typename accum_t>
+void store_scaled_row(
+    scalar_t* out,
+    const accum_t* src,
+    accum_t scale,
+    int64_t size) {
+  if constexpr (std::is_same_v<scalar_t, accum_t>) {
+    using Vec = vec::Vectorized<accum_t>;
+    vec::map<accum_t>(
+        [scale](Vec x) { return x * Vec(scale); }, out, src, size);
+  } else {
+    for (int64_t d = 0; d < size; ++d) {
+      out[d] = ActivationCompute<scalar_t>::from_compute(src[d] * scale);
+    }
+  }
+}
+
 /*
 Note on start_pos as a parameter:
 What is start_pos?
@@ -225,7 +360,9 @@ void cpu_flash_attention(
     const optional<Tensor>& attn_mask,
     const optional<double>& scale,
     bool is_with_kv_cache = false,
-    const int64_t start_pos = 0) {
+    const int64_t start_pos = 0,
+    const PagedKVCacheView* paged_kv = nullptr,
+    const QuantizedKVCacheView* quantized_kv = nullptr) {
   (void)dropout_p;
   // Query (Batch x Num_heads  x Q_seq_len  x Dim_per_head)
   // Key   (Batch x Num_heads  x KV_seq_len x Dim_per_head)
@@ -249,11 +386,10 @@ void cpu_flash_attention(
   constexpr bool is_reduced_type =
       torch::executor::is_reduced_floating_point<scalar_t>::value;
 
-  ET_CHECK_MSG(
-      !is_reduced_type, "FlashAttention does not support reduced types.");
-  // Figure out mixed precision a little later
-  // using accum_t = at::opmath_type<scalar_t>;
-  using accum_t = scalar_t;
+  // Half and BFloat16 are only stored: q and each kv split are converted
+  // to float before they are used, and the output is converted back, so the
+  // math is that of the float kernel on half the bytes of cache.
+  using accum_t = std::conditional_t<is_reduced_type, float, scalar_t>;
   using Vec = vec::Vectorized<accum_t>;
   accum_t scaling_factor =
       static_cast<accum_t>(util::calculate_scale(query, scale));
@@ -272,6 +408,15 @@ void cpu_flash_attention(
     kvSize = value.size(1);
   }
 
+  // Paged caches are [num_blocks, block_size, num heads, head dim] and hold
+  // num_tokens tokens of each sequence.
+  if (paged_kv != nullptr) {
+    kvSize = paged_kv->num_tokens;
+  }
+  if (quantized_kv != nullptr) {
+    kvSize = quantized_kv->num_tokens;
+  }
+
   ET_CHECK_MSG(
       num_heads_kv <= num_head,
       "FlashAttention does not support num kv heads > num query heads.Got num query heads=%" PRId64
@@ -288,13 +433,11 @@ void cpu_flash_attention(
 
   bool has_attn_mask = attn_mask.has_value() && attn_mask.value().numel();
   if (has_attn_mask) {
-    /*
-    TODO: fix this for upcasting attn mask
-    if (is_reduced_type) {
-      // SHould not come here for now.
-      attn_mask.value() = attn_mask.value().to(at::kFloat);
-    }
-    */
+    ET_CHECK_MSG(
+        attn_mask.value().scalar_type() ==
+            torch::executor::CppTypeToScalarType<accum_t>::value,
+        "attn_mask must be float for Half and BFloat16 queries, and have "
+        "the dtype of the query otherwise");
     ET_CHECK_MSG(attn_mask.value().dim() == 2, "attn_mask must be 2D");
     ET_CHECK_MSG(
         attn_mask.value().size(0) == qSize, "attn_mask shape mismatch");
@@ -365,6 +508,9 @@ void cpu_flash_attention(
   int64_t qSplitSize = q_split_size > qSize ? qSize : q_split_size;
   int64_t kvSplitSize = kv_split_size > kvSize ? kvSize : kv_split_size;
   int64_t qSlice = (qSize - 1) / qSplitSize + 1;
+  // In decode, the query heads that share a kv head attend together, as the
+  // rows of one block, so that each key and value is read once per kv head.
+  int64_t qBlockRows = qSize == 1 ? num_reps : qSplitSize;
 #ifdef ET_USE_THREADPOOL
   int64_t num_thread =
       torch::executorch::threadpool::get_threadpool()->get_thread_count();
@@ -378,52 +524,408 @@ void cpu_flash_attention(
 
   // allocate per thread temp buf (accumulate type)
   int64_t size_per_thread =
-      /* qk     */ qSplitSize * kvSplitSize +
-      /* qk_max */ qSplitSize +
-      /* qk_sum */ qSplitSize +
-      /* dst    */ qSplitSize * headSize;
+      /* qk     */ qBlockRows * kvSplitSize +
+      /* qk_max */ qBlockRows +
+      /* qk_sum */ qBlockRows +
+      /* dst    */ qBlockRows * headSize;
 
-  int64_t size_bytes = size_per_thread * num_thread * query.element_size();
+  int64_t size_bytes = size_per_thread * num_thread * sizeof(accum_t);
   std::vector<char> buf_vec(size_bytes);
   void* buf = reinterpret_cast<void*>(buf_vec.data());
-  // Need to double check the following
-  size_bytes = num_thread * qSplitSize * kvSplitSize * query.element_size();
-  std::vector<char> buf_reduced_vec(size_bytes);
-  void* buf_reduced = reinterpret_cast<void*>(buf_reduced_vec.data());
-  // at::Tensor buf_reduced = at::empty(
-  //    {num_thread, qSplitSize, is_reduced_type ? kvSplitSize : 0},
-  //    query.options());
+  // Keys and values of a kv split that spans several cache blocks, that is
+  // dequantized or that is converted from a reduced type, are stored here,
+  // followed by the converted query block for reduced types.
+  int64_t kv_size_per_thread =
+      paged_kv != nullptr || quantized_kv != nullptr || is_reduced_type
+      ? 2 * kvSplitSize * headSize
+      : 0;
+  int64_t q_size_per_thread = is_reduced_type ? qBlockRows * headSize : 0;
+  size_bytes =
+      num_thread * (kv_size_per_thread + q_size_per_thread) * sizeof(accum_t);
+  std::vector<char> buf_kv_vec(size_bytes);
+  accum_t* buf_kv_data = reinterpret_cast<accum_t*>(buf_kv_vec.data());
 
   // Data ptrs
   const scalar_t* q_data = query.const_data_ptr<scalar_t>();
-  const scalar_t* k_data = key.const_data_ptr<scalar_t>();
-  const scalar_t* v_data = value.const_data_ptr<scalar_t>();
+  // Quantized caches are read through quantized_kv instead.
+  const scalar_t* k_data =
+      quantized_kv == nullptr ? key.const_data_ptr<scalar_t>() : nullptr;
+  const scalar_t* v_data =
+      quantized_kv == nullptr ? value.const_data_ptr<scalar_t>() : nullptr;
   const accum_t* mask_data =
       has_attn_mask ? attn_mask.value().const_data_ptr<accum_t>() : nullptr;
   scalar_t* out_data = output.mutable_data_ptr<scalar_t>();
   accum_t* buf_data = reinterpret_cast<accum_t*>(buf);
-  scalar_t* buf_reduced_data =
-      is_reduced_type ? reinterpret_cast<scalar_t*>(buf_reduced) : nullptr;
+
+  // Per thread buffers, see size_per_thread.
+  struct ThreadBuffers {
+    accum_t* qk_data;
+    accum_t* qk_max_data;
+    accum_t* qk_sum_data;
+    accum_t* dst_data;
+    accum_t* k_buf_data;
+    accum_t* v_buf_data;
+    accum_t* q_buf_data;
+  };
+  auto thread_buffers = [&](int ompIdx) {
+    ThreadBuffers buffers;
+    buffers.qk_data = buf_data + ompIdx * size_per_thread;
+    buffers.qk_max_data = buffers.qk_data + qBlockRows * kvSplitSize;
+    buffers.qk_sum_data = buffers.qk_max_data + qBlockRows;
+    buffers.dst_data = buffers.qk_sum_data + qBlockRows;
+    buffers.k_buf_data =
+        buf_kv_data + ompIdx * (kv_size_per_thread + q_size_per_thread);
+    buffers.v_buf_data = buffers.k_buf_data + kvSplitSize * headSize;
+    buffers.q_buf_data = buffers.k_buf_data + kv_size_per_thread;
+    return buffers;
+  };
+
+  // Attends qBlockSize query rows of batch i to the keys [kv_begin, kv_end)
+  // of the kv head of head j. The rows are either the positions
+  // [m, m + qBlockSize) of head j, or, if heads_as_rows, the heads
+  // [j, j + qBlockSize) at position m. Leaves the running max and sum of
+  // each row in qk_max_data and qk_sum_data, and the output before its
+  // division by the sum in dst_data.
+  auto attend = [&](int64_t i,
+                    int64_t j,
+                    int64_t m,
+                    int64_t qBlockSize,
+                    bool heads_as_rows,
+                    int64_t kv_begin,
+                    int64_t kv_end,
+                    const ThreadBuffers& buffers) {
+    accum_t* qk_data = buffers.qk_data;
+    accum_t* qk_max_data = buffers.qk_max_data;
+    accum_t* qk_sum_data = buffers.qk_sum_data;
+    accum_t* dst_data = buffers.dst_data;
+    accum_t* k_buf_data = buffers.k_buf_data;
+    accum_t* v_buf_data = buffers.v_buf_data;
+    const int64_t row_pos_step = heads_as_rows ? 0 : 1;
+    const accum_t* q_block = nullptr;
+    int64_t q_ld = heads_as_rows ? qStrideH : qStrideM;
+    if constexpr (is_reduced_type) {
+      convert_rows_to_accum(
+          q_data + i * qStrideB + j * qStrideH + m * qStrideM,
+          q_ld,
+          qBlockSize,
+          headSize,
+          buffers.q_buf_data);
+      q_block = buffers.q_buf_data;
+      q_ld = headSize;
+    } else {
+      q_block = q_data + i * qStrideB + j * qStrideH + m * qStrideM;
+    }
+
+    // Initialize max and sum
+    fill_stub(
+        qk_max_data, -std::numeric_limits<accum_t>::infinity(), qBlockSize);
+    auto j_kv = j / num_reps;
+    for (int64_t n = kv_begin; n < kv_end; n += kvSplitSize) {
+      int64_t kvBlockSize = std::min(kvSplitSize, kv_end - n);
+      const accum_t* k_block = nullptr;
+      const accum_t* v_block = nullptr;
+      int64_t k_ld = kStrideN;
+      int64_t v_ld = vStrideN;
+      if (quantized_kv != nullptr) {
+        const int64_t scales_offset = i * quantized_kv->scales_stride_b +
+            n * quantized_kv->scales_stride_n + j_kv;
+        dequantize_kv_rows(
+            quantized_kv->key_data + i * kStrideB + j_kv * kStrideH +
+                n * kStrideN,
+            kStrideN,
+            quantized_kv->key_scales + scales_offset,
+            quantized_kv->scales_stride_n,
+            kvBlockSize,
+            headSize,
+            k_buf_data);
+        dequantize_kv_rows(
+            quantized_kv->value_data + i * vStrideB + j_kv * vStrideH +
+                n * vStrideN,
+            vStrideN,
+            quantized_kv->value_scales + scales_offset,
+            quantized_kv->scales_stride_n,
+            kvBlockSize,
+            headSize,
+            v_buf_data);
+        k_block = k_buf_data;
+        v_block = v_buf_data;
+        k_ld = headSize;
+        v_ld = headSize;
+      } else if constexpr (is_reduced_type) {
+        convert_rows_to_accum(
+            k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN,
+            kStrideN,
+            kvBlockSize,
+            headSize,
+            k_buf_data);
+        convert_rows_to_accum(
+            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
+            vStrideN,
+            kvBlockSize,
+            headSize,
+            v_buf_data);
+        k_block = k_buf_data;
+        v_block = v_buf_data;
+        k_ld = headSize;
+        v_ld = headSize;
+      } else if (paged_kv == nullptr) {
+        k_block = k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN;
+        v_block = v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN;
+      } else {
+        k_block = paged_kv_rows(
+            k_data,
+            kStrideB,
+            kStrideN,
+            j_kv * kStrideH,
+            *paged_kv,
+            i,
+            n,
+            kvBlockSize,
+            headSize,
+            k_buf_data,
+            k_ld);
+        v_block = paged_kv_rows(
+            v_data,
+            vStrideB,
+            vStrideN,
+            j_kv * vStrideH,
+            *paged_kv,
+            i,
+            n,
+            kvBlockSize,
+            headSize,
+            v_buf_data,
+            v_ld);
+      }
+      // Calculate scale * q @ k.T
+      fill_stub(qk_data, static_cast<accum_t>(0), qBlockRows * kvSplitSize);
+      ::executorch::cpublas::gemm(
+          ::executorch::cpublas::TransposeType::Transpose,
+          ::executorch::cpublas::TransposeType::NoTranspose,
+          kvBlockSize,
+          qBlockSize,
+          headSize,
+          static_cast<accum_t>(1),
+          k_block,
+          k_ld,
+          q_block,
+          q_ld,
+          static_cast<accum_t>(0),
+          qk_data,
+          kvBlockSize);
+      // Apply causal mask, fill unused, i.e. future values, with -inf
+      // Say you have q @ k.T size = [16, 32]
+      // With qblock size = 4, say you are processing
+      // q seq len dim = 8:11.
+      // Say kvSplitSize = 4
+      // Then for causal mask, the entries that needs to be
+      // ignored are
+      // [8, 9:31], [9, 10:31], [10, 10:31], [11, 11:31]
+      // Following condition says that num_keys = 8 + 4 =12
+      // (num_keys - n) <= kvSplitSize
+      // num_keys <= n + kvSplitSize
+      // If n + kvSplitSize is larger than 12, then some
+      // entries need masked out. In our example n = 4
+      // will qualify for that
+      // With start_pos > 0 the rows of the query block can end in
+      // different kv splits, so every split that the first row does not
+      // see entirely is masked, and rows that end before the split are
+      // masked out completely. The first split is always seen by every
+      // row, so no row is masked out in all splits.
+      if (is_causal && m + start_pos - n + 1 < kvBlockSize) {
+        for (int32_t row = 0; row < qBlockSize; ++row) {
+          int64_t first_masked_col = std::max<int64_t>(
+              m + (row * row_pos_step + start_pos) - n + 1, 0);
+          if (first_masked_col >= kvBlockSize) {
+            continue;
+          }
+          accum_t* row_ptr = qk_data + row * kvBlockSize;
+          fill_stub(
+              row_ptr + first_masked_col,
+              -std::numeric_limits<accum_t>::infinity(),
+              kvBlockSize - first_masked_col);
+        }
+      }
+      // Update attention weights with attention mask
+      // And apply scaling factor
+      // qk <- qk * scaling + attn_mask
+      if (has_attn_mask) {
+        for (int64_t row = 0; row < qBlockSize; ++row) {
+          vec::map2<accum_t>(
+              [scaling_factor](Vec x, Vec y) {
+                return x * Vec(scaling_factor) + y;
+              },
+              qk_data + row * kvBlockSize,
+              qk_data + row * kvBlockSize,
+              mask_data + i * mStrideB + j * mStrideH +
+                  (m + row * row_pos_step) * mStrideM + n,
+              kvBlockSize);
+        }
+      }
+      // Update coefficients with Softmax
+      accum_t tmp_max = 0, tmp_sum = 0, exp_tmp = 0;
+      for (int64_t row = 0; row < qBlockSize; ++row) {
+        if (has_attn_mask) {
+          // max per row
+          tmp_max = vec::reduce_all<accum_t>(
+              [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+              qk_data + row * kvBlockSize,
+              kvBlockSize);
+        } else {
+          // apply scaling factor and max per row in fusion
+          _mul_reduce_max_fusion_kernel(
+              qk_data + row * kvBlockSize,
+              scaling_factor,
+              kvBlockSize,
+              qk_data + row * kvBlockSize,
+              tmp_max);
+        }
+        tmp_max = qk_max_data[row] > tmp_max ? qk_max_data[row] : tmp_max;
+        // qk <- exp(qk - max) and sum per row
+        tmp_sum = tmp_max;
+        _exp_reduce_sum_fusion_kernel(
+            qk_data + row * kvBlockSize,
+            kvBlockSize,
+            qk_data + row * kvBlockSize,
+            tmp_sum);
+        // exp_tmp <- exp(max[row] - max)
+        exp_tmp = std::exp(qk_max_data[row] - tmp_max);
+        // sum[row] <- sum + exp_tmp * sum[row]
+        qk_sum_data[row] = tmp_sum + exp_tmp * qk_sum_data[row];
+        // max[row] <- max
+        qk_max_data[row] = tmp_max;
+        // dst <- dst * exp_tmp
+        if (n > kv_begin) {
+          vec::map<accum_t>(
+              [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
+              dst_data + row * headSize,
+              dst_data + row * headSize,
+              headSize);
+        }
+      }
+      // Calculate Softmax(q @ k.T) @ v
+      ::executorch::cpublas::gemm(
+          ::executorch::cpublas::TransposeType::NoTranspose,
+          ::executorch::cpublas::TransposeType::NoTranspose,
+          headSize,
+          qBlockSize,
+          kvBlockSize,
+          static_cast<accum_t>(1),
+          v_block,
+          v_ld,
+          qk_data,
+          kvBlockSize,
+          n == kv_begin ? static_cast<accum_t>(0) : static_cast<accum_t>(1),
+          dst_data,
+          headSize);
+    }
+  };
+
+  // Decode attends one block of num_reps rows per kv head. With fewer kv
+  // heads than threads, most threads would sit idle while each busy one
+  // reads the whole kv cache, so the keys are split across threads as well,
+  // and the partial results are merged with their log-sum-exp.
+  if (qSize == 1) {
+    const int64_t num_groups = batchSize * num_heads_kv;
+    const int64_t num_keys =
+        is_causal ? std::min(start_pos + 1, kvSize) : kvSize;
+    const int64_t wanted_partitions =
+        (num_thread + num_groups - 1) / num_groups;
+    // Keep partitions long enough to amortize their merge.
+    const int64_t kv_partition_size = std::max(
+        (num_keys + wanted_partitions - 1) / wanted_partitions,
+        kMinKeysPerKVPartition);
+    const int64_t num_kv_partitions =
+        (num_keys + kv_partition_size - 1) / kv_partition_size;
+
+    // Per partition and row: max, sum, then the output before its division
+    // by the sum.
+    const int64_t partial_size = 2 + headSize;
+    std::vector<accum_t> partials(
+        num_groups * num_kv_partitions * num_reps * partial_size);
+    auto split_kv_lambda = [&](int64_t begin, int64_t end) {
+      const ThreadBuffers buffers =
+          thread_buffers(torch::executor::get_thread_num());
+      for (int64_t z = begin; z < end; z++) {
+        const int64_t group = z / num_kv_partitions;
+        const int64_t kv_begin = (z % num_kv_partitions) * kv_partition_size;
+        const int64_t kv_end = std::min(kv_begin + kv_partition_size, num_keys);
+        attend(
+            group / num_heads_kv,
+            group % num_heads_kv * num_reps,
+            /*m=*/0,
+            /*qBlockSize=*/num_reps,
+            /*heads_as_rows=*/true,
+            kv_begin,
+            kv_end,
+            buffers);
+        for (int64_t row = 0; row < num_reps; ++row) {
+          accum_t* partial =
+              partials.data() + (z * num_reps + row) * partial_size;
+          partial[0] = buffers.qk_max_data[row];
+          partial[1] = buffers.qk_sum_data[row];
+          std::memcpy(
+              partial + 2,
+              buffers.dst_data + row * headSize,
+              headSize * sizeof(accum_t));
+        }
+      }
+    };
+    torch::executor::parallel_for(
+        0, num_groups * num_kv_partitions, 1, split_kv_lambda);
+
+    // out = sum(dst_p * exp(max_p - max)) / sum(sum_p * exp(max_p - max))
+    auto merge_lambda = [&](int64_t begin, int64_t end) {
+      std::vector<accum_t> merged(headSize);
+      for (int64_t head = begin; head < end; head++) {
+        const int64_t i = head / num_head;
+        const int64_t j = head % num_head;
+        const int64_t group = i * num_heads_kv + j / num_reps;
+        const accum_t* row_partials = partials.data() +
+            (group * num_kv_partitions * num_reps + j % num_reps) *
+                partial_size;
+        const int64_t partition_stride = num_reps * partial_size;
+        accum_t max = -std::numeric_limits<accum_t>::infinity();
+        for (int64_t p = 0; p < num_kv_partitions; ++p) {
+          max = std::max(max, row_partials[p * partition_stride]);
+        }
+        fill_stub(merged.data(), static_cast<accum_t>(0), headSize);
+        accum_t sum = 0;
+        for (int64_t p = 0; p < num_kv_partitions; ++p) {
+          const accum_t* partial = row_partials + p * partition_stride;
+          // A partition that is masked out entirely adds nothing.
+          if (partial[0] == -std::numeric_limits<accum_t>::infinity()) {
+            continue;
+          }
+          const accum_t weight = std::exp(partial[0] - max);
+          sum += weight * partial[1];
+          vec::map2<accum_t>(
+              [weight](Vec x, Vec y) { return x + y * Vec(weight); },
+              merged.data(),
+              merged.data(),
+              partial + 2,
+              headSize);
+        }
+        store_scaled_row(
+            out_data + i * oStrideB + j * oStrideH,
+            merged.data(),
+            static_cast<accum_t>(1 / sum),
+            headSize);
+      }
+    };
+    torch::executor::parallel_for(0, batchSize * num_head, 1, merge_lambda);
+    return;
+  }
 
   auto compute_lambda = [&](int64_t begin, int64_t end) {
     int64_t i = 0, j = 0, k = 0;
     util::data_index_init(begin, i, batchSize, j, num_head, k, qSlice);
-    int ompIdx = torch::executor::get_thread_num();
-    accum_t* buf_ptr = buf_data + ompIdx * size_per_thread;
-    accum_t* qk_data = buf_ptr;
-    accum_t* qk_max_data = qk_data + qSplitSize * kvSplitSize;
-    accum_t* qk_sum_data = qk_max_data + qSplitSize;
-    accum_t* dst_data = qk_sum_data + qSplitSize;
-    scalar_t* qk_reduced_data = is_reduced_type
-        ? buf_reduced_data + ompIdx * qSplitSize * kvSplitSize
-        : nullptr;
+    const ThreadBuffers buffers =
+        thread_buffers(torch::executor::get_thread_num());
 
     for (int64_t z = begin; z < end; z++) {
       int64_t m = k * qSplitSize;
       int64_t qBlockSize = std::min(qSplitSize, qSize - m);
-      // Initialize max and sum
-      fill_stub(
-          qk_max_data, -std::numeric_limits<accum_t>::infinity(), qBlockSize);
       // Original flash sdpa wasnt really meant to be used
       // for decode the way we are using via start_pos here.
       // Thus when num_keys is 1 during decode phase, we
@@ -453,133 +955,15 @@ void cpu_flash_attention(
       // However, lets just fix that as well.
       int64_t num_keys =
           is_causal ? std::min(m + start_pos + qBlockSize, kvSize) : kvSize;
-      auto j_kv = j / num_reps;
-      for (int64_t n = 0; n < num_keys; n += kvSplitSize) {
-        int64_t kvBlockSize = std::min(kvSplitSize, kvSize - n);
-        // Calculate scale * q @ k.T
-        fill_stub(qk_data, static_cast<accum_t>(0), qSplitSize * kvSplitSize);
-        ::executorch::cpublas::gemm(
-            ::executorch::cpublas::TransposeType::Transpose,
-            ::executorch::cpublas::TransposeType::NoTranspose,
-            kvBlockSize,
-            qBlockSize,
-            headSize,
-            static_cast<accum_t>(1),
-            k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN,
-            kStrideN,
-            q_data + i * qStrideB + j * qStrideH + m * qStrideM,
-            qStrideM,
-            static_cast<accum_t>(0),
-            qk_data,
-            kvBlockSize);
-        // Apply causal mask, fill unused, i.e. future values, with -inf
-        // Say you have q @ k.T size = [16, 32]
-        // With qblock size = 4, say you are processing
-        // q seq len dim = 8:11.
-        // Say kvSplitSize = 4
-        // Then for causal mask, the entries that needs to be
-        // ignored are
-        // [8, 9:31], [9, 10:31], [10, 10:31], [11, 11:31]
-        // Following condition says that num_keys = 8 + 4 =12
-        // (num_keys - n) <= kvSplitSize
-        // num_keys <= n + kvSplitSize
-        // If n + kvSplitSize is larger than 12, then some
-        // entries need masked out. In our example n = 4
-        // will qualify for that
-        if (is_causal && num_keys - n <= kvSplitSize) {
-          // For this fn to work k_split_size > q_split_size
-          for (int32_t row = 0; row < qBlockSize; ++row) {
-            int64_t last_col = m + (row + start_pos) - n;
-            accum_t* row_ptr = qk_data + row * kvBlockSize;
-            fill_stub(
-                row_ptr + last_col + 1,
-                -std::numeric_limits<accum_t>::infinity(),
-                kvBlockSize - last_col - 1);
-          }
-        }
-        // Update attention weights with attention mask
-        // And apply scaling factor
-        // qk <- qk * scaling + attn_mask
-        if (has_attn_mask) {
-          for (int64_t row = 0; row < qBlockSize; ++row) {
-            vec::map2<accum_t>(
-                [scaling_factor](Vec x, Vec y) {
-                  return x * Vec(scaling_factor) + y;
-                },
-                qk_data + row * kvBlockSize,
-                qk_data + row * kvBlockSize,
-                mask_data + i * mStrideB + j * mStrideH + (m + row) * mStrideM +
-                    n,
-                kvBlockSize);
-          }
-        }
-        // Update coefficients with Softmax
-        accum_t tmp_max = 0, tmp_sum = 0, exp_tmp = 0;
-        for (int64_t row = 0; row < qBlockSize; ++row) {
-          if (has_attn_mask) {
-            // max per row
-            tmp_max = vec::reduce_all<accum_t>(
-                [](Vec& x, Vec& y) { return vec::maximum(x, y); },
-                qk_data + row * kvBlockSize,
-                kvBlockSize);
-          } else {
-            // apply scaling factor and max per row in fusion
-            _mul_reduce_max_fusion_kernel(
-                qk_data + row * kvBlockSize,
-                scaling_factor,
-                kvBlockSize,
-                qk_data + row * kvBlockSize,
-                tmp_max);
-          }
-          tmp_max = qk_max_data[row] > tmp_max ? qk_max_data[row] : tmp_max;
-          // qk <- exp(qk - max) and sum per row
-          tmp_sum = tmp_max;
-          _exp_reduce_sum_fusion_kernel(
-              qk_data + row * kvBlockSize,
-              kvBlockSize,
-              conditional_data_ptr(qk_data, qk_reduced_data) +
-                  row * kvBlockSize,
-              tmp_sum);
-          // exp_tmp <- exp(max[row] - max)
-          exp_tmp = std::exp(qk_max_data[row] - tmp_max);
-          // sum[row] <- sum + exp_tmp * sum[row]
-          qk_sum_data[row] = tmp_sum + exp_tmp * qk_sum_data[row];
-          // max[row] <- max
-          qk_max_data[row] = tmp_max;
-          // dst <- dst * exp_tmp
-          if (n > 0) {
-            vec::map<accum_t>(
-                [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
-                dst_data + row * headSize,
-                dst_data + row * headSize,
-                headSize);
-          }
-        }
-        // Calculate Softmax(q @ k.T) @ v
-        ::executorch::cpublas::gemm(
-            ::executorch::cpublas::TransposeType::NoTranspose,
-            ::executorch::cpublas::TransposeType::NoTranspose,
-            headSize,
-            qBlockSize,
-            kvBlockSize,
-            static_cast<accum_t>(1),
-            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
-            vStrideN,
-            conditional_data_ptr(qk_data, qk_reduced_data),
-            kvBlockSize,
-            n == 0 ? static_cast<accum_t>(0) : static_cast<accum_t>(1),
-            dst_data,
-            headSize);
-      }
+      attend(i, j, m, qBlockSize, false, 0, num_keys, buffers);
       // dst <- dst / sum[row]
       // reorder MHA output with strides
       for (int64_t row = 0; row < qBlockSize; ++row) {
-        accum_t sum_reciprocal = 1 / qk_sum_data[row];
-        vec::map<scalar_t>(
-            [sum_reciprocal](Vec x) { return x * Vec(sum_reciprocal); },
+        store_scaled_row(
             out_data + i * oStrideB + j * oStrideH + m * oStrideM +
                 row * oStrideM,
-            dst_data + row * headSize,
+            buffers.dst_data + row * headSize,
+            1 / buffers.qk_sum_data[row],
             headSize);
       }
       // Move to the next query
@@ -695,6 +1079,46 @@ bool validate_cache_params(
 }
 
 // TODO: seq_length is not yet used for copy
+// Checks that the projected keys and values have the heads of the cache,
+// which are shared by groups of query heads: grouped-query attention reads
+// each kv head once per group instead of repeating it for every query head.
+bool validate_kv_heads(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    const Tensor& k_cache,
+    const Tensor& v_cache) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      q_projected.dim() == 4 && k_projected.dim() == 4 &&
+          v_projected.dim() == 4,
+      "projected query, key and value must be 4D tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.scalar_type() == q_projected.scalar_type() &&
+          v_projected.scalar_type() == q_projected.scalar_type() &&
+          k_cache.scalar_type() == q_projected.scalar_type() &&
+          v_cache.scalar_type() == q_projected.scalar_type(),
+      "projected query, key and value and the caches must have one dtype");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(2) == k_cache.size(2) &&
+          v_projected.size(2) == v_cache.size(2),
+      "projected key and value must have the num heads of the cache");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(3) == k_cache.size(3) &&
+          v_projected.size(3) == v_cache.size(3) &&
+          q_projected.size(3) == k_cache.size(3),
+      "projected query, key and value must have the head dim of the cache");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      q_projected.size(2) % k_cache.size(2) == 0,
+      "num query heads (%zd) must be a multiple of num kv heads (%zd)",
+      q_projected.size(2),
+      k_cache.size(2));
+  return true;
+}
+
 void update_cache(
     const Tensor& projected_value,
     const Tensor& cache,
@@ -726,6 +1150,256 @@ void update_cache(
       (uint8_t*)cache_data + pos_offset_bytes, projected_value_data, num_bytes);
 }
 
+bool validate_paged_cache_params(
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    const Tensor& k_cache,
+    const Tensor& v_cache,
+    const Tensor& block_table,
+    int64_t start_pos,
+    int64_t seq_length) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_cache.dim() == 4, "kcache must be a 4D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      v_cache.dim() == 4, "v_cache must be a 4D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.dim() == 4 && v_projected.dim() == 4,
+      "projected key and value must be 4D tensors");
+
+  for (size_t d = 0; d < util::kKVDim; ++d) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        k_cache.size(d) == v_cache.size(d),
+        "key and value cache must have the same sizes");
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        k_projected.size(d) == v_projected.size(d),
+        "projected key and value must have the same sizes");
+  }
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(2) == k_cache.size(2) &&
+          k_projected.size(3) == k_cache.size(3),
+      "projected key and value must match the num heads and head dim of the cache");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(1) == seq_length,
+      "seq_length must match dim 1 of the projected key and value");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.dim() == 2, "block_table must be a 2D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.scalar_type() == ScalarType::Long,
+      "block_table must be a Long tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.size(0) == k_projected.size(0),
+      "block_table must have a row for each sequence in the batch");
+
+  const int64_t block_size = k_cache.size(1);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos >= 0 &&
+          (start_pos + seq_length) <= block_table.size(1) * block_size,
+      "start_pos + seq_length must fit in the blocks of the block table. "
+      "start pos: %" PRId64 ", seq_length: %" PRId64
+      ", block table size: %zd, block size: %" PRId64,
+      start_pos,
+      seq_length,
+      block_table.size(1),
+      block_size);
+
+  // Make sure they are in contiguous dim order
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(k_cache.dim_order().data(), k_cache.dim()),
+      "key cache must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(v_cache.dim_order().data(), v_cache.dim()),
+      "value cache must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          k_projected.dim_order().data(), k_projected.dim()) &&
+          is_contiguous_dim_order(
+              v_projected.dim_order().data(), v_projected.dim()),
+      "projected key and value must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          block_table.dim_order().data(), block_table.dim()),
+      "block_table must be in contiguous dim order");
+
+  // Every block that is read or written must be in the cache.
+  const int64_t* table = block_table.const_data_ptr<int64_t>();
+  const int64_t num_used_blocks =
+      (start_pos + seq_length + block_size - 1) / block_size;
+  for (int64_t b = 0; b < block_table.size(0); ++b) {
+    for (int64_t i = 0; i < num_used_blocks; ++i) {
+      const int64_t block = table[b * block_table.size(1) + i];
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          block >= 0 && block < k_cache.size(0),
+          "block_table[%" PRId64 "][%" PRId64 "] = %" PRId64
+          " is not a block of the cache, which has %zd blocks",
+          b,
+          i,
+          block,
+          k_cache.size(0));
+    }
+  }
+
+  return true;
+}
+
+// Writes the seq_length tokens of every sequence in projected_value to
+// positions [start_pos, start_pos + seq_length) of the paged cache.
+void update_paged_cache(
+    const Tensor& projected_value,
+    const Tensor& cache,
+    const Tensor& block_table,
+    int64_t start_pos,
+    int64_t seq_length) {
+  const uint8_t* projected_value_data =
+      static_cast<const uint8_t*>(projected_value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+
+  ET_CHECK_MSG(projected_value_data != nullptr, "projected_value data is null");
+  ET_CHECK_MSG(cache_data, "cache data is null");
+
+  const size_t element_size = projected_value.element_size();
+  const int64_t block_size = cache.size(1);
+  const size_t block_bytes = cache.strides()[0] * element_size;
+  const size_t token_bytes = cache.strides()[1] * element_size;
+  const int64_t* table = block_table.const_data_ptr<int64_t>();
+  for (int64_t b = 0; b < projected_value.size(0); ++b) {
+    const int64_t* seq_table = table + b * block_table.size(1);
+    for (int64_t t = 0; t < seq_length; ++t) {
+      const int64_t pos = start_pos + t;
+      // NOLINTNEXTLINE
+      std::memcpy(
+          cache_data + seq_table[pos / block_size] * block_bytes +
+              (pos % block_size) * token_bytes,
+          projected_value_data + (b * seq_length + t) * token_bytes,
+          token_bytes);
+    }
+  }
+}
+
+bool validate_quantized_cache_params(
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    const Tensor& k_cache,
+    const Tensor& v_cache,
+    const Tensor& k_scales,
+    const Tensor& v_scales,
+    int64_t start_pos,
+    int64_t seq_length) {
+  if (!validate_cache_params(k_cache, v_cache, start_pos, seq_length)) {
+    return false;
+  }
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_cache.scalar_type() == ScalarType::Char &&
+          v_cache.scalar_type() == ScalarType::Char,
+      "Quantized key and value cache must be Char tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_scales.scalar_type() == ScalarType::Float &&
+          v_scales.scalar_type() == ScalarType::Float,
+      "key and value scales must be Float tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_scales.dim() == 3 && v_scales.dim() == 3,
+      "key and value scales must be 3D tensors");
+
+  for (size_t d = 0; d < util::kKVDim - 1; ++d) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        k_scales.size(d) == k_cache.size(d) &&
+            v_scales.size(d) == v_cache.size(d),
+        "scales must be [batch, max_seq_len, num heads] of their cache");
+  }
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.dim() == 4 && v_projected.dim() == 4,
+      "projected key and value must be 4D tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.scalar_type() == ScalarType::Float &&
+          v_projected.scalar_type() == ScalarType::Float,
+      "projected key and value must be Float tensors");
+
+  for (size_t d = 0; d < util::kKVDim; ++d) {
+    const int64_t expected_size = d == 1 ? seq_length : k_cache.size(d);
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        k_projected.size(d) == expected_size &&
+            v_projected.size(d) == expected_size,
+        "projected key and value must be [batch, seq_length, num heads, "
+        "head dim] of the cache");
+  }
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(k_scales.dim_order().data(), k_scales.dim()) &&
+          is_contiguous_dim_order(
+              v_scales.dim_order().data(), v_scales.dim()),
+      "key and value scales must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          k_projected.dim_order().data(), k_projected.dim()) &&
+          is_contiguous_dim_order(
+              v_projected.dim_order().data(), v_projected.dim()),
+      "projected key and value must be in contiguous dim order");
+
+  return true;
+}
+
+// Quantizes each head of the seq_length tokens in projected_value to int8,
+// with a scale of max(abs(head)) / 127, and writes them to positions
+// [start_pos, start_pos + seq_length) of the cache and its scales.
+void update_quantized_cache(
+    const Tensor& projected_value,
+    const Tensor& cache,
+    const Tensor& scales,
+    int64_t start_pos,
+    int64_t seq_length) {
+  const float* projected_value_data = projected_value.const_data_ptr<float>();
+  int8_t* cache_data = cache.mutable_data_ptr<int8_t>();
+  float* scales_data = scales.mutable_data_ptr<float>();
+
+  ET_CHECK_MSG(projected_value_data != nullptr, "projected_value data is null");
+  ET_CHECK_MSG(cache_data, "cache data is null");
+  ET_CHECK_MSG(scales_data, "scales data is null");
+
+  const int64_t num_heads = cache.size(2);
+  const int64_t head_dim = cache.size(3);
+  auto cache_strides = cache.strides();
+  auto scales_strides = scales.strides();
+  for (int64_t b = 0; b < projected_value.size(0); ++b) {
+    for (int64_t t = 0; t < seq_length; ++t) {
+      const int64_t pos = start_pos + t;
+      for (int64_t h = 0; h < num_heads; ++h) {
+        const float* src = projected_value_data +
+            ((b * seq_length + t) * num_heads + h) * head_dim;
+        int8_t* dst = cache_data + b * cache_strides[0] +
+            pos * cache_strides[1] + h * cache_strides[2];
+        float max_abs = 0;
+        for (int64_t d = 0; d < head_dim; ++d) {
+          max_abs = std::max(max_abs, std::abs(src[d]));
+        }
+        const float inv_scale = max_abs > 0 ? 127.0f / max_abs : 0.0f;
+        for (int64_t d = 0; d < head_dim; ++d) {
+          const float quantized = std::nearbyint(src[d] * inv_scale);
+          dst[d] = static_cast<int8_t>(
+              std::min(std::max(quantized, -127.0f), 127.0f));
+        }
+        scales_data
+            [b * scales_strides[0] + pos * scales_strides[1] +
+             h * scales_strides[2]] = max_abs / 127.0f;
+      }
+    }
+  }
+}
+
 } // anonymous namespace
 
 Tensor& flash_attention_kernel_out(
@@ -839,7 +1513,12 @@ Tensor& sdpa_with_kv_cache_out(
       output,
       "attn_mask and is_causal cannot be set at the same time");
 
-  ET_CHECK_MSG(q_projected.dim() == 4, "query must be a 4D tensor");
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_kv_heads(
+          q_projected, k_projected, v_projected, key_cache, value_cache),
+      InvalidArgument,
+      output);
 
   update_cache(k_projected, key_cache, start_pos, seq_len);
   update_cache(v_projected, value_cache, start_pos, seq_len);
@@ -908,7 +1587,9 @@ Tensor& sdpa_with_kv_cache_out(
 
   // TODO(task): replace the template param selection logic
   // with whatever apprpriately makes more sense for
-  ET_SWITCH_FLOAT_TYPES(
+  // Half and BFloat16 caches take half the memory and bandwidth of Float
+  // ones, and attention accumulates them in float.
+  ET_SWITCH_FLOATHBF16_TYPES(
       q_projected.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
         // TODO we need to re-evaluate this for ARM CPUs
         // And there can be many so instead of templatizing
@@ -953,11 +1634,471 @@ Tensor& sdpa_with_kv_cache_out(
       });
   return output;
 }
+
+/*
+  Same as sdpa_with_kv_cache_out, but with a paged kv cache; see the note on
+  PagedKVCacheView.
+  @param[in] key_cache Blocks of previous k_projected.
+  Format [num_blocks, block_size, num heads, head dim]
+  @param[in] value_cache Blocks of previous v_projected.
+  Format [num_blocks, block_size, num heads, head dim]
+  @param[in] block_table Blocks of each sequence, as Long.
+  Format [batch size, max_blocks_per_seq]
+  @param[in] start_pos: sequence position, shared by all sequences
+  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
+*/
+Tensor& sdpa_with_paged_kv_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_paged_cache_params(
+          k_projected,
+          v_projected,
+          key_cache,
+          value_cache,
+          block_table,
+          start_pos,
+          seq_len),
+      InvalidArgument,
+      output);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value() || !is_causal,
+      InvalidArgument,
+      output,
+      "attn_mask and is_causal cannot be set at the same time");
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q_projected.dim() == 4 && q_projected.size(0) == k_projected.size(0),
+      InvalidArgument,
+      output,
+      "query must be a 4D tensor with the batch size of key and value");
+
+  update_paged_cache(k_projected, key_cache, block_table, start_pos, seq_len);
+  update_paged_cache(v_projected, value_cache, block_table, start_pos, seq_len);
+
+  PagedKVCacheView paged_kv{
+      block_table.const_data_ptr<int64_t>(),
+      block_table.size(1),
+      key_cache.size(1),
+      start_pos + seq_len};
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  auto q_seq_len = q_projected.size(1);
+
+  ET_SWITCH_FLOAT_TYPES(
+      q_projected.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
+        if (q_seq_len >= 768) {
+          cpu_flash_attention<CTYPE, 256, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true,
+              start_pos,
+              &paged_kv);
+        } else if (q_seq_len >= 192) {
+          cpu_flash_attention<CTYPE, 64, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true,
+              start_pos,
+              &paged_kv);
+        } else {
+          cpu_flash_attention<CTYPE, 32, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true,
+              start_pos,
+              &paged_kv);
+        }
+      });
+  return output;
+}
+/*
+  Same as sdpa_with_kv_cache_out, but with an int8 kv cache; see the note on
+  QuantizedKVCacheView.
+  @param[in] key_cache Quantized previous k_projected, as Char.
+  Format [batch size, max_seq_len, num heads, head dim]
+  @param[in] value_cache Quantized previous v_projected, as Char.
+  Format [batch size, max_seq_len, num heads, head dim]
+  @param[in] key_scales Scale of each head of key_cache, as Float.
+  Format [batch size, max_seq_len, num heads]
+  @param[in] value_scales Scale of each head of value_cache, as Float.
+  Format [batch size, max_seq_len, num heads]
+*/
+Tensor& sdpa_with_quantized_kv_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_quantized_cache_params(
+          k_projected,
+          v_projected,
+          key_cache,
+          value_cache,
+          key_scales,
+          value_scales,
+          start_pos,
+          seq_len),
+      InvalidArgument,
+      output);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value() || !is_causal,
+      InvalidArgument,
+      output,
+      "attn_mask and is_causal cannot be set at the same time");
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q_projected.dim() == 4 && q_projected.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      output,
+      "query must be a 4D Float tensor");
+
+  update_quantized_cache(
+      k_projected, key_cache, key_scales, start_pos, seq_len);
+  update_quantized_cache(
+      v_projected, value_cache, value_scales, start_pos, seq_len);
+
+  QuantizedKVCacheView quantized_kv{
+      key_cache.const_data_ptr<int8_t>(),
+      value_cache.const_data_ptr<int8_t>(),
+      key_scales.const_data_ptr<float>(),
+      value_scales.const_data_ptr<float>(),
+      key_scales.strides()[0],
+      key_scales.strides()[1],
+      start_pos + seq_len};
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  auto q_seq_len = q_projected.size(1);
+
+  if (q_seq_len >= 768) {
+    cpu_flash_attention<float, 256, 512>(
+        output,
+        q_projected,
+        key_cache,
+        value_cache,
+        dropout_p,
+        is_causal,
+        attn_mask,
+        scale,
+        true,
+        start_pos,
+        nullptr,
+        &quantized_kv);
+  } else if (q_seq_len >= 192) {
+    cpu_flash_attention<float, 64, 512>(
+        output,
+        q_projected,
+        key_cache,
+        value_cache,
+        dropout_p,
+        is_causal,
+        attn_mask,
+        scale,
+        true,
+        start_pos,
+        nullptr,
+        &quantized_kv);
+  } else {
+    cpu_flash_attention<float, 32, 512>(
+        output,
+        q_projected,
+        key_cache,
+        value_cache,
+        dropout_p,
+        is_causal,
+        attn_mask,
+        scale,
+        true,
+        start_pos,
+        nullptr,
+        &quantized_kv);
+  }
+  return output;
+}
+
+bool validate_sink_cache_params(
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    int64_t start_pos,
+    int64_t seq_len,
+    int64_t num_sink_tokens) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      key_cache.dim() == 4 && value_cache.dim() == 4 &&
+          key_cache.sizes() == value_cache.sizes(),
+      "key and value caches must be 4D tensors of the same size");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      key_cache.scalar_type() == ScalarType::Float &&
+          value_cache.scalar_type() == ScalarType::Float,
+      "key and value caches must be Float");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(key_cache.dim_order().data(), key_cache.dim()) &&
+          is_contiguous_dim_order(
+              value_cache.dim_order().data(), value_cache.dim()),
+      "key and value caches must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos >= 0 && seq_len > 0, "start_pos and seq_len must be valid");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      num_sink_tokens >= 0 &&
+          num_sink_tokens + seq_len <= key_cache.size(1),
+      "The %" PRId64 " sink tokens and the %" PRId64
+      " new tokens must fit in the cache of %zd tokens",
+      num_sink_tokens,
+      seq_len,
+      key_cache.size(1));
+
+  const int64_t head_dim = key_cache.size(3);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      head_dim % 2 == 0, "head dim must be even to apply rope");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.dim() == 2 && freqs_cos.sizes() == freqs_sin.sizes() &&
+          freqs_cos.scalar_type() == ScalarType::Float &&
+          freqs_sin.scalar_type() == ScalarType::Float,
+      "freqs_cos and freqs_sin must be 2D Float tensors of the same size");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.size(1) == head_dim / 2 || freqs_cos.size(1) == head_dim,
+      "rope tables must have head dim / 2 or head dim columns, not %zd",
+      freqs_cos.size(1));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.size(0) > seq_len,
+      "rope tables must have more rows than seq_len");
+  return true;
+}
+
+// Drops the num_evicted oldest tokens that follow the sinks in the first
+// num_cached positions of the cache, and moves the newer ones down in their
+// place. Keys were rotated at their position in the cache, so when freqs_cos
+// and freqs_sin are given, the moved keys are rotated back by num_evicted
+// positions with that row of the rope tables. Rope tables with head dim / 2
+// columns rotate interleaved pairs, those with head dim columns rotate the
+// two halves of the head dim, as HuggingFace does.
+void evict_from_sink_cache(
+    Tensor& cache,
+    const Tensor* freqs_cos,
+    const Tensor* freqs_sin,
+    int64_t num_cached,
+    int64_t num_sink_tokens,
+    int64_t num_evicted) {
+  const int64_t token_stride = cache.strides()[1];
+  const int64_t num_moved = num_cached - num_sink_tokens - num_evicted;
+  float* window =
+      cache.mutable_data_ptr<float>() + num_sink_tokens * token_stride;
+  std::memmove(
+      window,
+      window + num_evicted * token_stride,
+      num_moved * token_stride * sizeof(float));
+  if (freqs_cos == nullptr) {
+    return;
+  }
+
+  const int64_t head_dim = cache.size(3);
+  const int64_t half = head_dim / 2;
+  const bool interleaved = freqs_cos->size(1) == half;
+  const float* cos = freqs_cos->const_data_ptr<float>() +
+      num_evicted * freqs_cos->size(1);
+  const float* sin = freqs_sin->const_data_ptr<float>() +
+      num_evicted * freqs_sin->size(1);
+  torch::executor::parallel_for(
+      0, num_moved * cache.size(2), 1, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          float* x = window + row * head_dim;
+          for (int64_t i = 0; i < half; ++i) {
+            const int64_t i0 = interleaved ? 2 * i : i;
+            const int64_t i1 = interleaved ? 2 * i + 1 : i + half;
+            const float x0 = x[i0];
+            const float x1 = x[i1];
+            x[i0] = x0 * cos[i] + x1 * sin[i];
+            x[i1] = x1 * cos[i] - x0 * sin[i];
+          }
+        }
+      });
+}
+
+/*
+  Same as sdpa_with_kv_cache_out with is_causal set, but for generation that
+  outlives the cache: once the cache is full, the first num_sink_tokens
+  tokens stay, as attention sinks, and the oldest of the others are evicted
+  to make room for the new ones.
+
+  start_pos counts all the tokens generated so far, without bound. The cache
+  stays in order, so the model must apply rope at the position of the tokens
+  in the cache, min(start_pos, max_seq_len - seq_len), rather than at
+  start_pos; eviction rotates the remaining keys to their new position.
+  @param[in] freqs_cos Rope table of the model, [rows, head dim / 2] for
+  interleaved pairs or [rows, head dim] for rotated halves.
+  @param[in] freqs_sin Rope table of the model, same size as freqs_cos.
+  @param[in] num_sink_tokens Number of tokens kept at the start of the cache.
+*/
+Tensor& sdpa_with_sink_kv_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sink_tokens,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_sink_cache_params(
+          key_cache,
+          value_cache,
+          freqs_cos,
+          freqs_sin,
+          start_pos,
+          seq_len,
+          num_sink_tokens),
+      InvalidArgument,
+      output);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      key_cache.size(0) == 1,
+      InvalidArgument,
+      output,
+      "The sink kv cache must have batch size of 1");
+
+  // Check the rest before evicting, so that a bad call leaves the cache as is.
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_kv_heads(
+          q_projected, k_projected, v_projected, key_cache, value_cache),
+      InvalidArgument,
+      output);
+
+  const int64_t max_seq_len = key_cache.size(1);
+  int64_t cache_pos = start_pos;
+  if (start_pos + seq_len > max_seq_len) {
+    const int64_t num_cached = std::min(start_pos, max_seq_len);
+    const int64_t num_evicted = num_cached + seq_len - max_seq_len;
+    evict_from_sink_cache(
+        key_cache,
+        &freqs_cos,
+        &freqs_sin,
+        num_cached,
+        num_sink_tokens,
+        num_evicted);
+    evict_from_sink_cache(
+        value_cache,
+        nullptr,
+        nullptr,
+        num_cached,
+        num_sink_tokens,
+        num_evicted);
+    cache_pos = max_seq_len - seq_len;
+  }
+
+  return sdpa_with_kv_cache_out(
+      ctx,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      cache_pos,
+      seq_len,
+      {},
+      0.0,
+      true,
+      scale,
+      output);
+}
 } // namespace native
 } // namespace executor
 } // namespace torch
 
-EXECUTORCH_LIBRARY(
-    llama,
-    "sdpa_with_kv_cache.out",
-    torch::executor::native::sdpa_with_kv_cache_out);
+namespace {
+// EXECUTORCH_LIBRARY registers a single op per namespace per file, so the
+// sdpa variants are registered together.
+const ::executorch::runtime::Kernel sdpa_kernels[] = {
+    ::executorch::extension::make_boxed_kernel(
+        "llama::sdpa_with_kv_cache.out",
+        EXECUTORCH_FN(torch::executor::native::sdpa_with_kv_cache_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::sdpa_with_paged_kv_cache.out",
+        EXECUTORCH_FN(torch::executor::native::sdpa_with_paged_kv_cache_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::sdpa_with_quantized_kv_cache.out",
+        EXECUTORCH_FN(
+            torch::executor::native::sdpa_with_quantized_kv_cache_out)),
+    ::executorch::extension::make_boxed_kernel(
+        "llama::sdpa_with_sink_kv_cache.out",
+        EXECUTORCH_FN(torch::executor::native::sdpa_with_sink_kv_cache_out)),
+};
+auto res_llama = ::executorch::runtime::register_kernels(sdpa_kernels);
+} // namespace
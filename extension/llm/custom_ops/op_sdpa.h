@@ -31,6 +31,81 @@ Tensor& sdpa_with_kv_cache_out(
     const optional<double> scale,
     Tensor& output);
 
+/**
+ * Same as sdpa_with_kv_cache_out, except that key_cache and value_cache are
+ * pools of blocks, [num_blocks, block_size, num heads, head dim], and row b
+ * of the Long block_table, [batch size, max_blocks_per_seq], lists the
+ * blocks that hold the tokens of sequence b. The cache then only needs as
+ * many blocks as there are tokens, and sequences can share blocks.
+ */
+Tensor& sdpa_with_paged_kv_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+/**
+ * Same as sdpa_with_kv_cache_out, except that key_cache and value_cache hold
+ * int8 values, [batch size, max_seq_len, num heads, head dim], with a Float
+ * scale per head of each token in key_scales and value_scales, [batch size,
+ * max_seq_len, num heads]. k_projected and v_projected are quantized as they
+ * are written to the cache, which then takes a quarter of the memory of a
+ * Float cache.
+ */
+Tensor& sdpa_with_quantized_kv_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+/**
+ * Same as sdpa_with_kv_cache_out with is_causal set, except that start_pos
+ * may grow past the cache: once it is full, the first num_sink_tokens tokens
+ * stay and the oldest of the others are evicted, so that generation can go
+ * on with constant memory. The model must apply rope at the position of the
+ * tokens in the cache, min(start_pos, max_seq_len - seq_len); freqs_cos and
+ * freqs_sin are its rope tables, which rotate the keys that remain after an
+ * eviction to their new position.
+ */
+Tensor& sdpa_with_sink_kv_cache_out(
+    RuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sink_tokens,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
 Tensor& flash_attention_kernel_out(
     RuntimeContext& ctx,
     const Tensor& query,
@@ -8,6 +8,11 @@
 
 #include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/llm/custom_ops/op_gguf.h>
+#include <executorch/extension/llm/custom_ops/op_linear_quantized.h>
+#include <executorch/extension/llm/custom_ops/op_moe_ffn.h>
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/extension/llm/custom_ops/op_rope.h>
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
 
 #include <torch/library.h>
@@ -82,6 +87,399 @@ at::Tensor sdpa_with_kv_cache_aten(
   return output;
 }
 
+Tensor& sdpa_with_paged_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::sdpa_with_paged_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      block_table,
+      start_pos,
+      seq_len,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_paged_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    const at::Tensor& block_table,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const c10::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const c10::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_paged_kv_cache_out_no_context, 12)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   block_table,
+   start_pos,
+   seq_len,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& sdpa_with_quantized_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::sdpa_with_quantized_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      key_scales,
+      value_scales,
+      start_pos,
+      seq_len,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_quantized_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& key_scales,
+    at::Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const c10::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const c10::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_quantized_kv_cache_out_no_context, 13)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   key_scales,
+   value_scales,
+   start_pos,
+   seq_len,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& sdpa_with_sink_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sink_tokens,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::sdpa_with_sink_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      freqs_cos,
+      freqs_sin,
+      start_pos,
+      seq_len,
+      num_sink_tokens,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_sink_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    const at::Tensor& freqs_cos,
+    const at::Tensor& freqs_sin,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sink_tokens,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const c10::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_sink_kv_cache_out_no_context, 11)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   freqs_cos,
+   freqs_sin,
+   start_pos,
+   seq_len,
+   num_sink_tokens,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& rms_norm_out_no_context(
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::rms_norm_out(
+      context, input, weight, eps, out);
+}
+
+at::Tensor rms_norm_aten(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const double eps) {
+  auto out = at::empty_like(input);
+  WRAP_TO_ATEN(rms_norm_out_no_context, 3)
+  (input, weight, eps, out);
+  return out;
+}
+
+Tensor& apply_rotary_emb_out_no_context(
+    const Tensor& input,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::apply_rotary_emb_out(
+      context, input, freqs_cos, freqs_sin, out);
+}
+
+at::Tensor apply_rotary_emb_aten(
+    const at::Tensor& input,
+    const at::Tensor& freqs_cos,
+    const at::Tensor& freqs_sin) {
+  auto out = at::empty_like(input);
+  WRAP_TO_ATEN(apply_rotary_emb_out_no_context, 3)
+  (input, freqs_cos, freqs_sin, out);
+  return out;
+}
+
+Tensor& linear_int4_out_no_context(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::linear_int4_out(
+      context, input, packed_weight, scales, group_size, out);
+}
+
+at::Tensor linear_int4_aten(
+    const at::Tensor& input,
+    const at::Tensor& packed_weight,
+    const at::Tensor& scales,
+    const int64_t group_size) {
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = scales.size(0);
+  auto out = at::empty(out_sizes, input.options());
+  WRAP_TO_ATEN(linear_int4_out_no_context, 4)
+  (input, packed_weight, scales, group_size, out);
+  return out;
+}
+
+Tensor& linear_int8_out_no_context(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& scales,
+    const int64_t group_size,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::linear_int8_out(
+      context, input, packed_weight, scales, group_size, out);
+}
+
+at::Tensor linear_int8_aten(
+    const at::Tensor& input,
+    const at::Tensor& packed_weight,
+    const at::Tensor& scales,
+    const int64_t group_size) {
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = scales.size(0);
+  auto out = at::empty(out_sizes, input.options());
+  WRAP_TO_ATEN(linear_int8_out_no_context, 4)
+  (input, packed_weight, scales, group_size, out);
+  return out;
+}
+
+Tensor& linear_q4_0_out_no_context(
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::linear_q4_0_out(context, input, weight, out);
+}
+
+at::Tensor linear_q4_0_aten(const at::Tensor& input, const at::Tensor& weight) {
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = weight.size(0);
+  auto out = at::empty(out_sizes, input.options());
+  WRAP_TO_ATEN(linear_q4_0_out_no_context, 2)
+  (input, weight, out);
+  return out;
+}
+
+Tensor& linear_q8_0_out_no_context(
+    const Tensor& input,
+    const Tensor& weight,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::linear_q8_0_out(context, input, weight, out);
+}
+
+at::Tensor linear_q8_0_aten(const at::Tensor& input, const at::Tensor& weight) {
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = weight.size(0);
+  auto out = at::empty(out_sizes, input.options());
+  WRAP_TO_ATEN(linear_q8_0_out_no_context, 2)
+  (input, weight, out);
+  return out;
+}
+
+Tensor& embedding_q4_0_out_no_context(
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::embedding_q4_0_out(
+      context, weight, indices, out);
+}
+
+at::Tensor embedding_q4_0_aten(
+    const at::Tensor& weight,
+    const at::Tensor& indices) {
+  // Each 18-byte block holds 32 values.
+  std::vector<int64_t> out_sizes = indices.sizes().vec();
+  out_sizes.push_back(weight.size(1) / 18 * 32);
+  auto out = at::empty(out_sizes, indices.options().dtype(at::kFloat));
+  WRAP_TO_ATEN(embedding_q4_0_out_no_context, 2)
+  (weight, indices, out);
+  return out;
+}
+
+Tensor& embedding_q8_0_out_no_context(
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::embedding_q8_0_out(
+      context, weight, indices, out);
+}
+
+at::Tensor embedding_q8_0_aten(
+    const at::Tensor& weight,
+    const at::Tensor& indices) {
+  // Each 34-byte block holds 32 values.
+  std::vector<int64_t> out_sizes = indices.sizes().vec();
+  out_sizes.push_back(weight.size(1) / 34 * 32);
+  auto out = at::empty(out_sizes, indices.options().dtype(at::kFloat));
+  WRAP_TO_ATEN(embedding_q8_0_out_no_context, 2)
+  (weight, indices, out);
+  return out;
+}
+
+Tensor& moe_ffn_out_no_context(
+    const Tensor& input,
+    const Tensor& expert_indices,
+    const Tensor& expert_weights,
+    const Tensor& w1,
+    const Tensor& w2,
+    const Tensor& w3,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::moe_ffn_out(
+      context, input, expert_indices, expert_weights, w1, w2, w3, out);
+}
+
+at::Tensor moe_ffn_aten(
+    const at::Tensor& input,
+    const at::Tensor& expert_indices,
+    const at::Tensor& expert_weights,
+    const at::Tensor& w1,
+    const at::Tensor& w2,
+    const at::Tensor& w3) {
+  auto out = at::empty_like(input);
+  WRAP_TO_ATEN(moe_ffn_out_no_context, 6)
+  (input, expert_indices, expert_weights, w1, w2, w3, out);
+  return out;
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -95,6 +493,76 @@ TORCH_LIBRARY(llama, m) {
       "sdpa_with_kv_cache.out(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
       "Tensor(b!) value_cache, SymInt start_pos, SymInt seq_len, Tensor? attn_mask=None, "
       "float drpout_p=0.0, bool is_causal=False, float? scale=None, *, Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "sdpa_with_paged_kv_cache(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor block_table, SymInt start_pos, SymInt seq_len, "
+      "Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_paged_kv_cache.out(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor block_table, SymInt start_pos, SymInt seq_len, "
+      "Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, float? scale=None, *, "
+      "Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "sdpa_with_quantized_kv_cache(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor(c!) key_scales, Tensor(d!) value_scales, SymInt start_pos, "
+      "SymInt seq_len, Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, "
+      "float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_quantized_kv_cache.out(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor(c!) key_scales, Tensor(d!) value_scales, SymInt start_pos, "
+      "SymInt seq_len, Tensor? attn_mask=None, float drpout_p=0.0, bool is_causal=False, "
+      "float? scale=None, *, Tensor(e!) out) -> Tensor(e!)");
+  m.def(
+      "sdpa_with_sink_kv_cache(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor freqs_cos, Tensor freqs_sin, SymInt start_pos, "
+      "SymInt seq_len, int num_sink_tokens, float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_sink_kv_cache.out(Tensor query, Tensor key, Tensor value, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor freqs_cos, Tensor freqs_sin, SymInt start_pos, "
+      "SymInt seq_len, int num_sink_tokens, float? scale=None, *, Tensor(c!) out) -> Tensor(c!)");
+  m.def("rms_norm(Tensor input, Tensor weight, float eps) -> Tensor");
+  m.def(
+      "rms_norm.out(Tensor input, Tensor weight, float eps, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "apply_rotary_emb(Tensor input, Tensor freqs_cos, Tensor freqs_sin) -> Tensor");
+  m.def(
+      "apply_rotary_emb.out(Tensor input, Tensor freqs_cos, Tensor freqs_sin, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "linear_int4(Tensor input, Tensor packed_weight, Tensor scales, "
+      "int group_size) -> Tensor");
+  m.def(
+      "linear_int4.out(Tensor input, Tensor packed_weight, Tensor scales, "
+      "int group_size, *, Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "linear_int8(Tensor input, Tensor packed_weight, Tensor scales, "
+      "int group_size) -> Tensor");
+  m.def(
+      "linear_int8.out(Tensor input, Tensor packed_weight, Tensor scales, "
+      "int group_size, *, Tensor(a!) out) -> Tensor(a!)");
+  m.def("linear_q4_0(Tensor input, Tensor weight) -> Tensor");
+  m.def(
+      "linear_q4_0.out(Tensor input, Tensor weight, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def("linear_q8_0(Tensor input, Tensor weight) -> Tensor");
+  m.def(
+      "linear_q8_0.out(Tensor input, Tensor weight, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def("embedding_q4_0(Tensor weight, Tensor indices) -> Tensor");
+  m.def(
+      "embedding_q4_0.out(Tensor weight, Tensor indices, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def("embedding_q8_0(Tensor weight, Tensor indices) -> Tensor");
+  m.def(
+      "embedding_q8_0.out(Tensor weight, Tensor indices, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "moe_ffn(Tensor input, Tensor expert_indices, Tensor expert_weights, "
+      "Tensor w1, Tensor w2, Tensor w3) -> Tensor");
+  m.def(
+      "moe_ffn.out(Tensor input, Tensor expert_indices, Tensor expert_weights, "
+      "Tensor w1, Tensor w2, Tensor w3, *, Tensor(a!) out) -> Tensor(a!)");
 }
 
 TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
@@ -104,4 +572,65 @@ TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
       "sdpa_with_kv_cache.out",
       WRAP_TO_ATEN(
           torch::executor::native::sdpa_with_kv_cache_out_no_context, 11));
+  m.impl(
+      "sdpa_with_paged_kv_cache",
+      torch::executor::native::sdpa_with_paged_kv_cache_aten);
+  m.impl(
+      "sdpa_with_paged_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_paged_kv_cache_out_no_context,
+          12));
+  m.impl(
+      "sdpa_with_quantized_kv_cache",
+      torch::executor::native::sdpa_with_quantized_kv_cache_aten);
+  m.impl(
+      "sdpa_with_quantized_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_quantized_kv_cache_out_no_context,
+          13));
+  m.impl(
+      "sdpa_with_sink_kv_cache",
+      torch::executor::native::sdpa_with_sink_kv_cache_aten);
+  m.impl(
+      "sdpa_with_sink_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_sink_kv_cache_out_no_context,
+          11));
+  m.impl("rms_norm", torch::executor::native::rms_norm_aten);
+  m.impl(
+      "rms_norm.out",
+      WRAP_TO_ATEN(torch::executor::native::rms_norm_out_no_context, 3));
+  m.impl("apply_rotary_emb", torch::executor::native::apply_rotary_emb_aten);
+  m.impl(
+      "apply_rotary_emb.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::apply_rotary_emb_out_no_context, 3));
+  m.impl("linear_int4", torch::executor::native::linear_int4_aten);
+  m.impl(
+      "linear_int4.out",
+      WRAP_TO_ATEN(torch::executor::native::linear_int4_out_no_context, 4));
+  m.impl("linear_int8", torch::executor::native::linear_int8_aten);
+  m.impl(
+      "linear_int8.out",
+      WRAP_TO_ATEN(torch::executor::native::linear_int8_out_no_context, 4));
+  m.impl("linear_q4_0", torch::executor::native::linear_q4_0_aten);
+  m.impl(
+      "linear_q4_0.out",
+      WRAP_TO_ATEN(torch::executor::native::linear_q4_0_out_no_context, 2));
+  m.impl("linear_q8_0", torch::executor::native::linear_q8_0_aten);
+  m.impl(
+      "linear_q8_0.out",
+      WRAP_TO_ATEN(torch::executor::native::linear_q8_0_out_no_context, 2));
+  m.impl("embedding_q4_0", torch::executor::native::embedding_q4_0_aten);
+  m.impl(
+      "embedding_q4_0.out",
+      WRAP_TO_ATEN(torch::executor::native::embedding_q4_0_out_no_context, 2));
+  m.impl("embedding_q8_0", torch::executor::native::embedding_q8_0_aten);
+  m.impl(
+      "embedding_q8_0.out",
+      WRAP_TO_ATEN(torch::executor::native::embedding_q8_0_out_no_context, 2));
+  m.impl("moe_ffn", torch::executor::native::moe_ffn_aten);
+  m.impl(
+      "moe_ffn.out",
+      WRAP_TO_ATEN(torch::executor::native::moe_ffn_out_no_context, 6));
 }
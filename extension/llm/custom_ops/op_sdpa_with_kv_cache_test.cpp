@@ -6,9 +6,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 #include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/kernels/optimized/cpu/activation_utils.h>
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
@@ -984,3 +988,362 @@ TEST(OpScaledDotProductAttentionTest, SequenceTest) {
       out);
   EXPECT_TENSOR_CLOSE_WITH_TOL(ret, ret_expected_3, 1e-4, 1e-4);
 }
+
+namespace {
+
+// Decodes one token after a cache of a thousand tokens, enough for the keys
+// to be split across threads, and checks the output against a direct
+// computation of the attention. Each kv head is shared by
+// num_heads / num_kv_heads query heads.
+void check_long_cache_decode(int32_t num_heads, int32_t num_kv_heads) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  constexpr int32_t kHeadDim = 8;
+  constexpr int32_t kMaxSeqLen = 1200;
+  constexpr int64_t kStartPos = 1000;
+  const int32_t kv_row = num_kv_heads * kHeadDim;
+
+  auto make_data = [](size_t numel, float seed) {
+    std::vector<float> data(numel);
+    for (size_t i = 0; i < numel; ++i) {
+      data[i] = std::sin(seed * 31.0f + static_cast<float>(i) * 0.37f);
+    }
+    return data;
+  };
+  std::vector<float> keys = make_data((kStartPos + 1) * kv_row, 1.0f);
+  std::vector<float> values = make_data((kStartPos + 1) * kv_row, 2.0f);
+  std::vector<float> q_data = make_data(num_heads * kHeadDim, 3.0f);
+
+  // Fill the cache with the first kStartPos tokens, then decode the last.
+  std::vector<float> k_cache_data(kMaxSeqLen * kv_row, 0.0f);
+  std::vector<float> v_cache_data(kMaxSeqLen * kv_row, 0.0f);
+  std::copy(keys.begin(), keys.end() - kv_row, k_cache_data.begin());
+  std::copy(values.begin(), values.end() - kv_row, v_cache_data.begin());
+  exec_aten::Tensor key_cache =
+      tfFloat.make({1, kMaxSeqLen, num_kv_heads, kHeadDim}, k_cache_data);
+  exec_aten::Tensor value_cache =
+      tfFloat.make({1, kMaxSeqLen, num_kv_heads, kHeadDim}, v_cache_data);
+  exec_aten::Tensor query = tfFloat.make({1, 1, num_heads, kHeadDim}, q_data);
+  exec_aten::Tensor key = tfFloat.make(
+      {1, 1, num_kv_heads, kHeadDim},
+      std::vector<float>(keys.end() - kv_row, keys.end()));
+  exec_aten::Tensor value = tfFloat.make(
+      {1, 1, num_kv_heads, kHeadDim},
+      std::vector<float>(values.end() - kv_row, values.end()));
+
+  std::vector<float> expected(num_heads * kHeadDim, 0.0f);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadDim));
+  for (int32_t h = 0; h < num_heads; ++h) {
+    const int32_t kv_h = h / (num_heads / num_kv_heads);
+    std::vector<float> scores(kStartPos + 1);
+    float max_score = -std::numeric_limits<float>::infinity();
+    for (int64_t t = 0; t <= kStartPos; ++t) {
+      float dot = 0;
+      for (int32_t d = 0; d < kHeadDim; ++d) {
+        dot += q_data[h * kHeadDim + d] *
+            keys[(t * num_kv_heads + kv_h) * kHeadDim + d];
+      }
+      scores[t] = dot * scale;
+      max_score = std::max(max_score, scores[t]);
+    }
+    float sum = 0;
+    for (int64_t t = 0; t <= kStartPos; ++t) {
+      scores[t] = std::exp(scores[t] - max_score);
+      sum += scores[t];
+    }
+    for (int64_t t = 0; t <= kStartPos; ++t) {
+      for (int32_t d = 0; d < kHeadDim; ++d) {
+        expected[h * kHeadDim + d] += scores[t] / sum *
+            values[(t * num_kv_heads + kv_h) * kHeadDim + d];
+      }
+    }
+  }
+
+  exec_aten::Tensor out = tfFloat.zeros({1, 1, num_heads, kHeadDim});
+  exec_aten::optional<exec_aten::Tensor> attn_mask;
+  op_sdpa_with_kv_cache(
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      kStartPos,
+      1,
+      attn_mask,
+      0.0,
+      true,
+      {},
+      out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out, tfFloat.make({1, 1, num_heads, kHeadDim}, expected), 1e-4, 1e-4);
+}
+
+} // namespace
+
+TEST(OpScaledDotProductAttentionTest, LongCacheDecodeTest) {
+  check_long_cache_decode(2, 2);
+}
+
+TEST(OpScaledDotProductAttentionTest, GroupedQueryAttentionDecodeTest) {
+  check_long_cache_decode(8, 2);
+}
+
+TEST(OpScaledDotProductAttentionTest, GroupedQueryAttentionPrefillTest) {
+  // Six query heads share two kv heads. Running each kv head against its
+  // group of query heads on its own gives the same output.
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  constexpr int32_t kSeqLen = 5;
+  constexpr int32_t kHeadDim = 4;
+  std::vector<float> q_data(kSeqLen * 6 * kHeadDim);
+  std::vector<float> k_data(kSeqLen * 2 * kHeadDim);
+  std::vector<float> v_data(kSeqLen * 2 * kHeadDim);
+  for (size_t i = 0; i < q_data.size(); ++i) {
+    q_data[i] = std::sin(static_cast<float>(i) * 0.37f);
+  }
+  for (size_t i = 0; i < k_data.size(); ++i) {
+    k_data[i] = std::cos(static_cast<float>(i) * 0.53f);
+    v_data[i] = std::sin(static_cast<float>(i) * 0.71f + 1.0f);
+  }
+  exec_aten::Tensor key_cache = tfFloat.zeros({1, kSeqLen, 2, kHeadDim});
+  exec_aten::Tensor value_cache = tfFloat.zeros({1, kSeqLen, 2, kHeadDim});
+  exec_aten::Tensor out = tfFloat.zeros({1, kSeqLen, 6, kHeadDim});
+  exec_aten::optional<exec_aten::Tensor> attn_mask;
+  op_sdpa_with_kv_cache(
+      tfFloat.make({1, kSeqLen, 6, kHeadDim}, q_data),
+      tfFloat.make({1, kSeqLen, 2, kHeadDim}, k_data),
+      tfFloat.make({1, kSeqLen, 2, kHeadDim}, v_data),
+      key_cache,
+      value_cache,
+      0,
+      kSeqLen,
+      attn_mask,
+      0.0,
+      true,
+      {},
+      out);
+
+  for (int32_t kv_h = 0; kv_h < 2; ++kv_h) {
+    std::vector<float> group_q(kSeqLen * 3 * kHeadDim);
+    std::vector<float> group_k(kSeqLen * kHeadDim);
+    std::vector<float> group_v(kSeqLen * kHeadDim);
+    std::vector<float> group_expected(kSeqLen * 3 * kHeadDim);
+    for (int32_t t = 0; t < kSeqLen; ++t) {
+      for (int32_t d = 0; d < kHeadDim; ++d) {
+        group_k[t * kHeadDim + d] = k_data[(t * 2 + kv_h) * kHeadDim + d];
+        group_v[t * kHeadDim + d] = v_data[(t * 2 + kv_h) * kHeadDim + d];
+        for (int32_t r = 0; r < 3; ++r) {
+          const int32_t h = kv_h * 3 + r;
+          group_q[(t * 3 + r) * kHeadDim + d] =
+              q_data[(t * 6 + h) * kHeadDim + d];
+          group_expected[(t * 3 + r) * kHeadDim + d] =
+              out.const_data_ptr<float>()[(t * 6 + h) * kHeadDim + d];
+        }
+      }
+    }
+    // The kv head repeated for each query head of the group.
+    std::vector<float> repeated_k(kSeqLen * 3 * kHeadDim);
+    std::vector<float> repeated_v(kSeqLen * 3 * kHeadDim);
+    for (int32_t t = 0; t < kSeqLen; ++t) {
+      for (int32_t r = 0; r < 3; ++r) {
+        std::copy(
+            group_k.begin() + t * kHeadDim,
+            group_k.begin() + (t + 1) * kHeadDim,
+            repeated_k.begin() + (t * 3 + r) * kHeadDim);
+        std::copy(
+            group_v.begin() + t * kHeadDim,
+            group_v.begin() + (t + 1) * kHeadDim,
+            repeated_v.begin() + (t * 3 + r) * kHeadDim);
+      }
+    }
+    exec_aten::Tensor repeated_key_cache =
+        tfFloat.zeros({1, kSeqLen, 3, kHeadDim});
+    exec_aten::Tensor repeated_value_cache =
+        tfFloat.zeros({1, kSeqLen, 3, kHeadDim});
+    exec_aten::Tensor group_out = tfFloat.zeros({1, kSeqLen, 3, kHeadDim});
+    op_sdpa_with_kv_cache(
+        tfFloat.make({1, kSeqLen, 3, kHeadDim}, group_q),
+        tfFloat.make({1, kSeqLen, 3, kHeadDim}, repeated_k),
+        tfFloat.make({1, kSeqLen, 3, kHeadDim}, repeated_v),
+        repeated_key_cache,
+        repeated_value_cache,
+        0,
+        kSeqLen,
+        attn_mask,
+        0.0,
+        true,
+        {},
+        group_out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        group_out,
+        tfFloat.make({1, kSeqLen, 3, kHeadDim}, group_expected),
+        1e-5,
+        1e-5);
+  }
+}
+
+TEST(OpScaledDotProductAttentionTest, RejectsRepeatedKVHeads) {
+  // The projected key and value must have the heads of the cache, not one
+  // per query head.
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  exec_aten::Tensor query = tfFloat.ones({1, 1, 4, 4});
+  exec_aten::Tensor key = tfFloat.ones({1, 1, 4, 4});
+  exec_aten::Tensor value = tfFloat.ones({1, 1, 4, 4});
+  exec_aten::Tensor key_cache = tfFloat.zeros({1, 8, 2, 4});
+  exec_aten::Tensor value_cache = tfFloat.zeros({1, 8, 2, 4});
+  exec_aten::Tensor out = tfFloat.zeros({1, 1, 4, 4});
+  exec_aten::RuntimeContext context{};
+  torch::executor::native::sdpa_with_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      0,
+      1,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+  EXPECT_EQ(context.failure_state(), torch::executor::Error::InvalidArgument);
+}
+
+namespace {
+
+// Prefills a long prompt, then decodes a token with the keys split across
+// threads, with Half or BFloat16 tensors, and checks both outputs against
+// those of Float tensors of the same values.
+template <exec_aten::ScalarType DTYPE>
+void check_reduced_precision(double tol) {
+  using CTYPE =
+      typename torch::executor::testing::TensorFactory<DTYPE>::ctype;
+  using Compute = torch::executor::native::ActivationCompute<CTYPE>;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<DTYPE> tf;
+  constexpr int32_t kNumHeads = 4;
+  constexpr int32_t kNumKVHeads = 2;
+  constexpr int32_t kHeadDim = 8;
+  constexpr int32_t kMaxSeqLen = 640;
+  constexpr int32_t kPromptLen = 600;
+
+  // Values that Half and BFloat16 hold exactly, so that both runs attend
+  // over the same inputs.
+  auto make_data = [](size_t numel, float seed) {
+    std::vector<float> data(numel);
+    for (size_t i = 0; i < numel; ++i) {
+      data[i] = Compute::to_compute(Compute::from_compute(
+          std::sin(seed * 31.0f + static_cast<float>(i) * 0.37f)));
+    }
+    return data;
+  };
+  auto to_reduced = [](const std::vector<float>& data) {
+    std::vector<CTYPE> out(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      out[i] = Compute::from_compute(data[i]);
+    }
+    return out;
+  };
+  // TensorFactory cannot fill BFloat16 tensors with a constant.
+  auto reduced_zeros = [&](const std::vector<int32_t>& sizes) {
+    size_t numel = 1;
+    for (int32_t size : sizes) {
+      numel *= size;
+    }
+    return tf.make(sizes, to_reduced(std::vector<float>(numel, 0.0f)));
+  };
+
+  const std::vector<int32_t> cache_sizes = {
+      1, kMaxSeqLen, kNumKVHeads, kHeadDim};
+  exec_aten::Tensor key_cache = tfFloat.zeros(cache_sizes);
+  exec_aten::Tensor value_cache = tfFloat.zeros(cache_sizes);
+  exec_aten::Tensor reduced_key_cache = reduced_zeros(cache_sizes);
+  exec_aten::Tensor reduced_value_cache = reduced_zeros(cache_sizes);
+  exec_aten::optional<exec_aten::Tensor> attn_mask;
+
+  int64_t start_pos = 0;
+  for (int32_t len : {kPromptLen, 1}) {
+    const std::vector<int32_t> q_sizes = {1, len, kNumHeads, kHeadDim};
+    const std::vector<int32_t> kv_sizes = {1, len, kNumKVHeads, kHeadDim};
+    const float seed = static_cast<float>(start_pos);
+    std::vector<float> q_data = make_data(len * kNumHeads * kHeadDim, seed);
+    std::vector<float> k_data =
+        make_data(len * kNumKVHeads * kHeadDim, seed + 0.25f);
+    std::vector<float> v_data =
+        make_data(len * kNumKVHeads * kHeadDim, seed + 0.5f);
+
+    exec_aten::Tensor out = tfFloat.zeros(q_sizes);
+    op_sdpa_with_kv_cache(
+        tfFloat.make(q_sizes, q_data),
+        tfFloat.make(kv_sizes, k_data),
+        tfFloat.make(kv_sizes, v_data),
+        key_cache,
+        value_cache,
+        start_pos,
+        len,
+        attn_mask,
+        0.0,
+        true,
+        {},
+        out);
+    exec_aten::Tensor reduced_out = reduced_zeros(q_sizes);
+    op_sdpa_with_kv_cache(
+        tf.make(q_sizes, to_reduced(q_data)),
+        tf.make(kv_sizes, to_reduced(k_data)),
+        tf.make(kv_sizes, to_reduced(v_data)),
+        reduced_key_cache,
+        reduced_value_cache,
+        start_pos,
+        len,
+        attn_mask,
+        0.0,
+        true,
+        {},
+        reduced_out);
+
+    std::vector<float> reduced_out_data(reduced_out.numel());
+    for (size_t i = 0; i < reduced_out_data.size(); ++i) {
+      reduced_out_data[i] =
+          Compute::to_compute(reduced_out.const_data_ptr<CTYPE>()[i]);
+    }
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        tfFloat.make(q_sizes, reduced_out_data), out, tol, tol);
+    start_pos += len;
+  }
+}
+
+} // namespace
+
+TEST(OpScaledDotProductAttentionTest, HalfMatchesFloat) {
+  check_reduced_precision<exec_aten::ScalarType::Half>(2e-3);
+}
+
+TEST(OpScaledDotProductAttentionTest, BFloat16MatchesFloat) {
+  check_reduced_precision<exec_aten::ScalarType::BFloat16>(1e-2);
+}
+
+TEST(OpScaledDotProductAttentionTest, RejectsMixedDtypes) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Half> tfHalf;
+  exec_aten::Tensor query = tfHalf.ones({1, 1, 2, 4});
+  exec_aten::Tensor key = tfHalf.ones({1, 1, 2, 4});
+  exec_aten::Tensor value = tfHalf.ones({1, 1, 2, 4});
+  exec_aten::Tensor key_cache = tfFloat.zeros({1, 8, 2, 4});
+  exec_aten::Tensor value_cache = tfFloat.zeros({1, 8, 2, 4});
+  exec_aten::Tensor out = tfHalf.zeros({1, 1, 2, 4});
+  exec_aten::RuntimeContext context{};
+  torch::executor::native::sdpa_with_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      0,
+      1,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+  EXPECT_EQ(context.failure_state(), torch::executor::Error::InvalidArgument);
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/extension/llm/custom_ops/paged_kv_cache_manager.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::PagedKVCacheManager;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_sdpa_with_kv_cache(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    bool is_causal,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::sdpa_with_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      start_pos,
+      seq_len,
+      {},
+      0.0,
+      is_causal,
+      {},
+      out);
+}
+
+Tensor& op_sdpa_with_paged_kv_cache(
+    exec_aten::RuntimeContext& context,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    bool is_causal,
+    Tensor& out) {
+  return torch::executor::native::sdpa_with_paged_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      block_table,
+      start_pos,
+      seq_len,
+      {},
+      0.0,
+      is_causal,
+      {},
+      out);
+}
+
+// Deterministic values in [-1, 1] that differ between tensors.
+std::vector<float> make_data(size_t numel, float seed) {
+  std::vector<float> data(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    data[i] = std::sin(seed * 31.0f + static_cast<float>(i) * 0.37f);
+  }
+  return data;
+}
+
+constexpr int32_t kNumHeads = 4;
+constexpr int32_t kNumKVHeads = 2;
+constexpr int32_t kHeadDim = 8;
+
+// Causal attention of `len` queries at positions [start_pos, start_pos + len)
+// over the first start_pos + len rows of `keys` and `values`, all laid out as
+// [seq len, num heads, head dim].
+std::vector<float> reference_sdpa(
+    const std::vector<float>& query,
+    const std::vector<float>& keys,
+    const std::vector<float>& values,
+    int64_t start_pos,
+    int64_t len) {
+  std::vector<float> out(len * kNumHeads * kHeadDim, 0.0f);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadDim));
+  for (int64_t r = 0; r < len; ++r) {
+    for (int64_t h = 0; h < kNumHeads; ++h) {
+      const int64_t kv_h = h / (kNumHeads / kNumKVHeads);
+      const float* q = query.data() + (r * kNumHeads + h) * kHeadDim;
+      const int64_t num_keys = start_pos + r + 1;
+      std::vector<float> scores(num_keys);
+      float max_score = -std::numeric_limits<float>::infinity();
+      for (int64_t t = 0; t < num_keys; ++t) {
+        const float* k = keys.data() + (t * kNumKVHeads + kv_h) * kHeadDim;
+        float dot = 0;
+        for (int64_t d = 0; d < kHeadDim; ++d) {
+          dot += q[d] * k[d];
+        }
+        scores[t] = dot * scale;
+        max_score = std::max(max_score, scores[t]);
+      }
+      float sum = 0;
+      for (int64_t t = 0; t < num_keys; ++t) {
+        scores[t] = std::exp(scores[t] - max_score);
+        sum += scores[t];
+      }
+      float* o = out.data() + (r * kNumHeads + h) * kHeadDim;
+      for (int64_t t = 0; t < num_keys; ++t) {
+        const float* v = values.data() + (t * kNumKVHeads + kv_h) * kHeadDim;
+        for (int64_t d = 0; d < kHeadDim; ++d) {
+          o[d] += scores[t] / sum * v[d];
+        }
+      }
+    }
+  }
+  return out;
+}
+
+// Runs the same prefill and decode steps with a dense cache and with a paged
+// cache of `block_size` blocks, laid out by `block_ids`, and checks that the
+// outputs match each other and a reference.
+void check_paged_matches_dense(
+    int32_t block_size,
+    const std::vector<int64_t>& block_ids,
+    const std::vector<int32_t>& step_lengths) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  int32_t max_seq_len = 0;
+  for (int32_t len : step_lengths) {
+    max_seq_len += len;
+  }
+  const int32_t num_blocks = static_cast<int32_t>(block_ids.size()) + 2;
+  Tensor key_cache = tf.zeros({1, max_seq_len, kNumKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({1, max_seq_len, kNumKVHeads, kHeadDim});
+  Tensor paged_key_cache =
+      tf.zeros({num_blocks, block_size, kNumKVHeads, kHeadDim});
+  Tensor paged_value_cache =
+      tf.zeros({num_blocks, block_size, kNumKVHeads, kHeadDim});
+  Tensor block_table =
+      tf_long.make({1, static_cast<int32_t>(block_ids.size())}, block_ids);
+
+  std::vector<float> keys;
+  std::vector<float> values;
+  int64_t start_pos = 0;
+  for (size_t step = 0; step < step_lengths.size(); ++step) {
+    const int32_t len = step_lengths[step];
+    const float seed = static_cast<float>(step);
+    std::vector<float> q_data = make_data(len * kNumHeads * kHeadDim, seed);
+    std::vector<float> k_data =
+        make_data(len * kNumKVHeads * kHeadDim, seed + 0.25f);
+    std::vector<float> v_data =
+        make_data(len * kNumKVHeads * kHeadDim, seed + 0.5f);
+    keys.insert(keys.end(), k_data.begin(), k_data.end());
+    values.insert(values.end(), v_data.begin(), v_data.end());
+    Tensor q = tf.make({1, len, kNumHeads, kHeadDim}, q_data);
+    Tensor k = tf.make({1, len, kNumKVHeads, kHeadDim}, k_data);
+    Tensor v = tf.make({1, len, kNumKVHeads, kHeadDim}, v_data);
+
+    Tensor expected = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_kv_cache(
+        q, k, v, key_cache, value_cache, start_pos, len, true, expected);
+
+    exec_aten::RuntimeContext context{};
+    Tensor out = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_paged_kv_cache(
+        context,
+        q,
+        k,
+        v,
+        paged_key_cache,
+        paged_value_cache,
+        block_table,
+        start_pos,
+        len,
+        true,
+        out);
+    EXPECT_EQ(context.failure_state(), Error::Ok);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out,
+        tf.make(
+            {1, len, kNumHeads, kHeadDim},
+            reference_sdpa(q_data, keys, values, start_pos, len)),
+        1e-4,
+        1e-4);
+    start_pos += len;
+  }
+}
+
+} // namespace
+
+TEST(OpSdpaWithPagedKVCacheTest, MatchesDenseCacheWithSmallBlocks) {
+  // Blocks of 4 tokens in no particular order, so most kv splits are
+  // gathered from several blocks.
+  check_paged_matches_dense(4, {5, 2, 7, 0, 3, 6, 1, 4}, {7, 1, 1, 9, 1});
+}
+
+TEST(OpSdpaWithPagedKVCacheTest, MatchesDenseCacheWithLargeBlocks) {
+  // Every kv split is read in place from a single block.
+  check_paged_matches_dense(32, {1}, {5, 1, 1, 1});
+}
+
+TEST(OpSdpaWithPagedKVCacheTest, MatchesDenseCacheAcrossKVSplits) {
+  // Sequences longer than a kv split, with splits that start in the middle
+  // of a block.
+  check_paged_matches_dense(
+      96, {6, 0, 5, 1, 4, 2, 3}, {300, 1, 250, 1, 50, 1});
+}
+
+TEST(OpSdpaWithPagedKVCacheTest, SharedPrefix) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  constexpr int32_t kBlockSize = 4;
+  constexpr int32_t kMaxBlocks = 4;
+  constexpr int32_t kPrefixLen = 8;
+  PagedKVCacheManager manager(
+      /*num_blocks=*/8, kBlockSize, /*max_batch_size=*/2, kMaxBlocks);
+  Tensor key_cache = tf.zeros({8, kBlockSize, kNumKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({8, kBlockSize, kNumKVHeads, kHeadDim});
+  Tensor dense_key_cache = tf.zeros({1, 16, kNumKVHeads, kHeadDim});
+  Tensor dense_value_cache = tf.zeros({1, 16, kNumKVHeads, kHeadDim});
+
+  auto table_of = [&](int64_t seq) {
+    const int64_t* row = manager.block_table() + seq * kMaxBlocks;
+    return tf_long.make(
+        {1, kMaxBlocks}, std::vector<int64_t>(row, row + kMaxBlocks));
+  };
+
+  // Prefill sequence 0 with the prefix.
+  Tensor q = tf.make(
+      {1, kPrefixLen, kNumHeads, kHeadDim},
+      make_data(kPrefixLen * kNumHeads * kHeadDim, 0));
+  Tensor k = tf.make(
+      {1, kPrefixLen, kNumKVHeads, kHeadDim},
+      make_data(kPrefixLen * kNumKVHeads * kHeadDim, 1));
+  Tensor v = tf.make(
+      {1, kPrefixLen, kNumKVHeads, kHeadDim},
+      make_data(kPrefixLen * kNumKVHeads * kHeadDim, 2));
+  ASSERT_EQ(manager.reserve(0, kPrefixLen), Error::Ok);
+  Tensor block_table = table_of(0);
+  exec_aten::RuntimeContext context{};
+  Tensor out = tf.zeros({1, kPrefixLen, kNumHeads, kHeadDim});
+  op_sdpa_with_paged_kv_cache(
+      context,
+      q,
+      k,
+      v,
+      key_cache,
+      value_cache,
+      block_table,
+      0,
+      kPrefixLen,
+      true,
+      out);
+  ASSERT_EQ(context.failure_state(), Error::Ok);
+  op_sdpa_with_kv_cache(
+      q, k, v, dense_key_cache, dense_value_cache, 0, kPrefixLen, true, out);
+
+  // Sequence 1 reuses the prefix blocks and only needs a block for its next
+  // token.
+  ASSERT_EQ(manager.share_prefix(0, 1, kPrefixLen), Error::Ok);
+  ASSERT_EQ(manager.reserve(1, kPrefixLen + 1), Error::Ok);
+  EXPECT_EQ(manager.num_free_blocks(), 5);
+
+  Tensor q1 = tf.make(
+      {1, 1, kNumHeads, kHeadDim}, make_data(kNumHeads * kHeadDim, 3));
+  Tensor k1 = tf.make(
+      {1, 1, kNumKVHeads, kHeadDim}, make_data(kNumKVHeads * kHeadDim, 4));
+  Tensor v1 = tf.make(
+      {1, 1, kNumKVHeads, kHeadDim}, make_data(kNumKVHeads * kHeadDim, 5));
+  Tensor expected = tf.zeros({1, 1, kNumHeads, kHeadDim});
+  op_sdpa_with_kv_cache(
+      q1,
+      k1,
+      v1,
+      dense_key_cache,
+      dense_value_cache,
+      kPrefixLen,
+      1,
+      true,
+      expected);
+
+  block_table = table_of(1);
+  Tensor out1 = tf.zeros({1, 1, kNumHeads, kHeadDim});
+  op_sdpa_with_paged_kv_cache(
+      context,
+      q1,
+      k1,
+      v1,
+      key_cache,
+      value_cache,
+      block_table,
+      kPrefixLen,
+      1,
+      true,
+      out1);
+  EXPECT_EQ(context.failure_state(), Error::Ok);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out1, expected, 1e-5, 1e-5);
+}
+
+TEST(OpSdpaWithPagedKVCacheTest, RejectsMissingBlocks) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor key_cache = tf.zeros({2, 4, kNumKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({2, 4, kNumKVHeads, kHeadDim});
+  // The second block is needed but has not been assigned.
+  Tensor block_table =
+      tf_long.make({1, 2}, {1, PagedKVCacheManager::kNoBlock});
+  Tensor q = tf.zeros({1, 6, kNumHeads, kHeadDim});
+  Tensor k = tf.zeros({1, 6, kNumKVHeads, kHeadDim});
+  Tensor v = tf.zeros({1, 6, kNumKVHeads, kHeadDim});
+  Tensor out = tf.zeros({1, 6, kNumHeads, kHeadDim});
+
+  exec_aten::RuntimeContext context{};
+  op_sdpa_with_paged_kv_cache(
+      context, q, k, v, key_cache, value_cache, block_table, 0, 6, true, out);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_sdpa_with_kv_cache(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::sdpa_with_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      start_pos,
+      seq_len,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+}
+
+Tensor& op_sdpa_with_quantized_kv_cache(
+    exec_aten::RuntimeContext& context,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& value_scales,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    Tensor& out) {
+  return torch::executor::native::sdpa_with_quantized_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      key_scales,
+      value_scales,
+      start_pos,
+      seq_len,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+}
+
+// Deterministic values in [-1, 1] that differ between tensors.
+std::vector<float> make_data(size_t numel, float seed) {
+  std::vector<float> data(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    data[i] = std::sin(seed * 31.0f + static_cast<float>(i) * 0.37f);
+  }
+  return data;
+}
+
+// Dequantizes the rows [start_pos, start_pos + seq_len) of a quantized cache.
+std::vector<float> dequantize(
+    const Tensor& cache,
+    const Tensor& scales,
+    int64_t start_pos,
+    int64_t seq_len) {
+  const int64_t row_size = cache.size(3);
+  const int64_t first_row = start_pos * cache.size(2);
+  const int64_t num_rows = seq_len * cache.size(2);
+  const int8_t* data = cache.const_data_ptr<int8_t>();
+  const float* scales_data = scales.const_data_ptr<float>();
+  std::vector<float> out(num_rows * row_size);
+  for (int64_t r = 0; r < num_rows; ++r) {
+    for (int64_t d = 0; d < row_size; ++d) {
+      out[r * row_size + d] = data[(first_row + r) * row_size + d] *
+          scales_data[first_row + r];
+    }
+  }
+  return out;
+}
+
+constexpr int32_t kMaxSeqLen = 640;
+constexpr int32_t kNumHeads = 4;
+constexpr int32_t kNumKVHeads = 2;
+constexpr int32_t kHeadDim = 16;
+
+} // namespace
+
+TEST(OpSdpaWithQuantizedKVCacheTest, MatchesDequantizedCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor key_cache = tf_char.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+  Tensor value_cache = tf_char.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+  Tensor key_scales = tf.zeros({1, kMaxSeqLen, kNumKVHeads});
+  Tensor value_scales = tf.zeros({1, kMaxSeqLen, kNumKVHeads});
+  // Holds the dequantized values of the quantized cache.
+  Tensor dequantized_key_cache =
+      tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+  Tensor dequantized_value_cache =
+      tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+  // Holds the Float values, to bound the quantization error.
+  Tensor float_key_cache = tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+  Tensor float_value_cache = tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+
+  // A prefill that spans two kv splits, then a few decode steps.
+  int64_t start_pos = 0;
+  const std::vector<int32_t> step_lengths = {520, 1, 1, 50, 1};
+  for (size_t step = 0; step < step_lengths.size(); ++step) {
+    const int32_t len = step_lengths[step];
+    const float seed = static_cast<float>(step);
+    Tensor q = tf.make(
+        {1, len, kNumHeads, kHeadDim},
+        make_data(len * kNumHeads * kHeadDim, seed));
+    Tensor k = tf.make(
+        {1, len, kNumKVHeads, kHeadDim},
+        make_data(len * kNumKVHeads * kHeadDim, seed + 0.25f));
+    Tensor v = tf.make(
+        {1, len, kNumKVHeads, kHeadDim},
+        make_data(len * kNumKVHeads * kHeadDim, seed + 0.5f));
+
+    exec_aten::RuntimeContext context{};
+    Tensor out = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_quantized_kv_cache(
+        context,
+        q,
+        k,
+        v,
+        key_cache,
+        value_cache,
+        key_scales,
+        value_scales,
+        start_pos,
+        len,
+        out);
+    ASSERT_EQ(context.failure_state(), Error::Ok);
+
+    Tensor dequantized_k = tf.make(
+        {1, len, kNumKVHeads, kHeadDim},
+        dequantize(key_cache, key_scales, start_pos, len));
+    Tensor dequantized_v = tf.make(
+        {1, len, kNumKVHeads, kHeadDim},
+        dequantize(value_cache, value_scales, start_pos, len));
+    // Quantization keeps every value within half a step of its scale.
+    EXPECT_TENSOR_CLOSE_WITH_TOL(dequantized_k, k, 0, 1.0 / 254);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(dequantized_v, v, 0, 1.0 / 254);
+
+    Tensor expected = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_kv_cache(
+        q,
+        dequantized_k,
+        dequantized_v,
+        dequantized_key_cache,
+        dequantized_value_cache,
+        start_pos,
+        len,
+        expected);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+
+    Tensor float_out = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_kv_cache(
+        q,
+        k,
+        v,
+        float_key_cache,
+        float_value_cache,
+        start_pos,
+        len,
+        float_out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, float_out, 0, 2e-2);
+
+    start_pos += len;
+  }
+}
+
+TEST(OpSdpaWithQuantizedKVCacheTest, ZeroHeadsHaveZeroScale) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor key_cache = tf_char.ones({1, 4, 1, 4});
+  Tensor value_cache = tf_char.ones({1, 4, 1, 4});
+  Tensor key_scales = tf.ones({1, 4, 1});
+  Tensor value_scales = tf.ones({1, 4, 1});
+  Tensor q = tf.ones({1, 1, 1, 4});
+  Tensor k = tf.zeros({1, 1, 1, 4});
+  Tensor v = tf.make({1, 1, 1, 4}, {0.5, -1, 0.25, 0});
+  Tensor out = tf.zeros({1, 1, 1, 4});
+
+  exec_aten::RuntimeContext context{};
+  op_sdpa_with_quantized_kv_cache(
+      context,
+      q,
+      k,
+      v,
+      key_cache,
+      value_cache,
+      key_scales,
+      value_scales,
+      0,
+      1,
+      out);
+  ASSERT_EQ(context.failure_state(), Error::Ok);
+  EXPECT_TENSOR_EQ(
+      key_cache,
+      tf_char.make(
+          {1, 4, 1, 4}, {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}));
+  EXPECT_TENSOR_CLOSE(key_scales, tf.make({1, 4, 1}, {0, 1, 1, 1}));
+  EXPECT_TENSOR_EQ(
+      value_cache,
+      tf_char.make(
+          {1, 4, 1, 4}, {64, -127, 32, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}));
+  EXPECT_TENSOR_CLOSE(value_scales, tf.make({1, 4, 1}, {1.0 / 127, 1, 1, 1}));
+  // A single token attends to itself only.
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out, tf.make({1, 1, 1, 4}, {64.0 / 127, -1, 32.0 / 127, 0}), 1e-6, 0);
+}
+
+TEST(OpSdpaWithQuantizedKVCacheTest, RejectsFloatCache) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor key_cache = tf.zeros({1, 4, 1, 4});
+  Tensor value_cache = tf.zeros({1, 4, 1, 4});
+  Tensor key_scales = tf.zeros({1, 4, 1});
+  Tensor value_scales = tf.zeros({1, 4, 1});
+  Tensor q = tf.ones({1, 1, 1, 4});
+  Tensor out = tf.zeros({1, 1, 1, 4});
+
+  exec_aten::RuntimeContext context{};
+  op_sdpa_with_quantized_kv_cache(
+      context,
+      q,
+      q,
+      q,
+      key_cache,
+      value_cache,
+      key_scales,
+      value_scales,
+      0,
+      1,
+      out);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_sdpa_with_kv_cache(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::sdpa_with_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      start_pos,
+      seq_len,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+}
+
+Tensor& op_sdpa_with_sink_kv_cache(
+    exec_aten::RuntimeContext& context,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sink_tokens,
+    Tensor& out) {
+  return torch::executor::native::sdpa_with_sink_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      freqs_cos,
+      freqs_sin,
+      start_pos,
+      seq_len,
+      num_sink_tokens,
+      {},
+      out);
+}
+
+constexpr int32_t kMaxSeqLen = 12;
+constexpr int32_t kNumSinkTokens = 2;
+constexpr int32_t kNumHeads = 4;
+constexpr int32_t kNumKVHeads = 2;
+constexpr int32_t kHeadDim = 8;
+
+// Deterministic values in [-1, 1] that differ between tokens.
+std::vector<float> make_token(int32_t num_heads, float seed) {
+  std::vector<float> data(num_heads * kHeadDim);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::sin(seed * 31.0f + static_cast<float>(i) * 0.37f);
+  }
+  return data;
+}
+
+// Rope tables of kMaxSeqLen rows, as the model computes them.
+std::vector<float> make_rope_table(bool interleaved, bool is_cos) {
+  const int32_t half = kHeadDim / 2;
+  const int32_t cols = interleaved ? half : kHeadDim;
+  std::vector<float> table(kMaxSeqLen * cols);
+  for (int32_t pos = 0; pos < kMaxSeqLen; ++pos) {
+    for (int32_t c = 0; c < cols; ++c) {
+      const double theta = std::pow(10000.0, -2.0 * (c % half) / kHeadDim);
+      table[pos * cols + c] = static_cast<float>(
+          is_cos ? std::cos(pos * theta) : std::sin(pos * theta));
+    }
+  }
+  return table;
+}
+
+// Applies rope at pos to every head of a token.
+std::vector<float> rotate(std::vector<float> x, int32_t pos, bool interleaved) {
+  const int32_t half = kHeadDim / 2;
+  for (size_t head = 0; head < x.size() / kHeadDim; ++head) {
+    float* h = x.data() + head * kHeadDim;
+    for (int32_t i = 0; i < half; ++i) {
+      const double theta = std::pow(10000.0, -2.0 * i / kHeadDim);
+      const float c = static_cast<float>(std::cos(pos * theta));
+      const float s = static_cast<float>(std::sin(pos * theta));
+      const int32_t i0 = interleaved ? 2 * i : i;
+      const int32_t i1 = interleaved ? 2 * i + 1 : i + half;
+      const float x0 = h[i0];
+      const float x1 = h[i1];
+      h[i0] = x0 * c - x1 * s;
+      h[i1] = x0 * s + x1 * c;
+    }
+  }
+  return x;
+}
+
+std::vector<float> concat(const std::vector<std::vector<float>>& tokens) {
+  std::vector<float> out;
+  for (const auto& token : tokens) {
+    out.insert(out.end(), token.begin(), token.end());
+  }
+  return out;
+}
+
+// Generates past the cache in prefill and decode steps, and checks each
+// step against the plain kv cache op over the tokens that the sink cache
+// should hold: the sinks then the most recent tokens, each rotated at its
+// position in the cache.
+void check_generation_past_cache(bool interleaved) {
+  TensorFactory<ScalarType::Float> tf;
+  const int32_t cols = interleaved ? kHeadDim / 2 : kHeadDim;
+  Tensor freqs_cos =
+      tf.make({kMaxSeqLen, cols}, make_rope_table(interleaved, true));
+  Tensor freqs_sin =
+      tf.make({kMaxSeqLen, cols}, make_rope_table(interleaved, false));
+
+  Tensor key_cache = tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+
+  // The keys and values of all tokens so far, before rope.
+  std::vector<std::vector<float>> keys;
+  std::vector<std::vector<float>> values;
+
+  int64_t start_pos = 0;
+  const std::vector<int32_t> step_lengths = {
+      6, 1, 1, 1, 1, 1, 1, 3, 1, 4, 1, 10};
+  for (int32_t len : step_lengths) {
+    const int64_t cache_pos = std::min<int64_t>(start_pos, kMaxSeqLen - len);
+    std::vector<std::vector<float>> q_tokens, k_tokens, v_tokens;
+    for (int32_t r = 0; r < len; ++r) {
+      const float seed = static_cast<float>(start_pos + r);
+      keys.push_back(make_token(kNumKVHeads, seed + 0.25f));
+      values.push_back(make_token(kNumKVHeads, seed + 0.5f));
+      q_tokens.push_back(
+          rotate(make_token(kNumHeads, seed), cache_pos + r, interleaved));
+      k_tokens.push_back(rotate(keys.back(), cache_pos + r, interleaved));
+      v_tokens.push_back(values.back());
+    }
+    Tensor q = tf.make({1, len, kNumHeads, kHeadDim}, concat(q_tokens));
+    Tensor k = tf.make({1, len, kNumKVHeads, kHeadDim}, concat(k_tokens));
+    Tensor v = tf.make({1, len, kNumKVHeads, kHeadDim}, concat(v_tokens));
+
+    exec_aten::RuntimeContext context{};
+    Tensor out = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_sink_kv_cache(
+        context,
+        q,
+        k,
+        v,
+        key_cache,
+        value_cache,
+        freqs_cos,
+        freqs_sin,
+        start_pos,
+        len,
+        kNumSinkTokens,
+        out);
+    ASSERT_EQ(context.failure_state(), Error::Ok);
+
+    // The tokens before this step that the cache should hold.
+    std::vector<int64_t> kept;
+    const int64_t first_recent = start_pos + len - kMaxSeqLen + kNumSinkTokens;
+    for (int64_t t = 0; t < start_pos; ++t) {
+      if (t < kNumSinkTokens || t >= first_recent) {
+        kept.push_back(t);
+      }
+    }
+    ASSERT_EQ(kept.size(), cache_pos);
+    Tensor expected_key_cache =
+        tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+    Tensor expected_value_cache =
+        tf.zeros({1, kMaxSeqLen, kNumKVHeads, kHeadDim});
+    float* expected_keys = expected_key_cache.mutable_data_ptr<float>();
+    float* expected_values = expected_value_cache.mutable_data_ptr<float>();
+    for (size_t i = 0; i < kept.size(); ++i) {
+      const auto key = rotate(keys[kept[i]], i, interleaved);
+      std::copy(key.begin(), key.end(), expected_keys + i * key.size());
+      const auto& value = values[kept[i]];
+      std::copy(value.begin(), value.end(), expected_values + i * key.size());
+    }
+    Tensor expected = tf.zeros({1, len, kNumHeads, kHeadDim});
+    op_sdpa_with_kv_cache(
+        q,
+        k,
+        v,
+        expected_key_cache,
+        expected_value_cache,
+        cache_pos,
+        len,
+        expected);
+
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(key_cache, expected_key_cache, 1e-5, 1e-5);
+    EXPECT_TENSOR_CLOSE(value_cache, expected_value_cache);
+
+    start_pos += len;
+  }
+  EXPECT_GT(start_pos, 2 * kMaxSeqLen);
+}
+
+} // namespace
+
+TEST(OpSdpaWithSinkKVCacheTest, GeneratesPastCacheWithInterleavedRope) {
+  check_generation_past_cache(/*interleaved=*/true);
+}
+
+TEST(OpSdpaWithSinkKVCacheTest, GeneratesPastCacheWithHalvesRope) {
+  check_generation_past_cache(/*interleaved=*/false);
+}
+
+TEST(OpSdpaWithSinkKVCacheTest, RejectsChunkLargerThanWindow) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor key_cache = tf.ones({1, 4, 1, 2});
+  Tensor value_cache = tf.ones({1, 4, 1, 2});
+  Tensor freqs = tf.ones({4, 1});
+  Tensor q = tf.zeros({1, 3, 1, 2});
+  Tensor out = tf.zeros({1, 3, 1, 2});
+
+  // Three new tokens do not fit next to two sinks in a cache of four.
+  exec_aten::RuntimeContext context{};
+  op_sdpa_with_sink_kv_cache(
+      context, q, q, q, key_cache, value_cache, freqs, freqs, 8, 3, 2, out);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+  EXPECT_TENSOR_EQ(key_cache, tf.ones({1, 4, 1, 2}));
+}
@@ -66,6 +66,30 @@ TEST_F(OpTileCropOutTest, AllRealDtypesSupported){
 #undef ENUMERATE_TEST_ENTRY
 }
 
+TEST_F(OpTileCropOutTest, MultipleChannelsAndTileColumns) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // 2 channels of 2x4 pixels, cropped into 2 tiles side by side.
+  Tensor out = tf.zeros({2, 2, 2, 2});
+  // clang-format off
+  op_tile_crop_out(
+      tf.make(
+          {2, 2, 4}, { 0,  1,  2,  3,
+                       4,  5,  6,  7,
+                      10, 11, 12, 13,
+                      14, 15, 16, 17}),
+      2,
+      out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          {2, 2, 2, 2}, { 0,  1,  4,  5,
+                         10, 11, 14, 15,
+                          2,  3,  6,  7,
+                         12, 13, 16, 17}));
+  // clang-format on
+}
+
 // Mismatched shape tests.
 TEST_F(OpTileCropOutTest, InvalidInputShapeDies) {
   TensorFactory<ScalarType::Int> tf;
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/paged_kv_cache_manager.h>
+
+#include <cinttypes>
+
+#include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace torch::executor {
+
+PagedKVCacheManager::PagedKVCacheManager(
+    int64_t num_blocks,
+    int64_t block_size,
+    int64_t max_batch_size,
+    int64_t max_blocks_per_seq)
+    : block_size_(block_size),
+      max_batch_size_(max_batch_size),
+      max_blocks_per_seq_(max_blocks_per_seq),
+      block_table_(max_batch_size * max_blocks_per_seq, kNoBlock),
+      num_seq_blocks_(max_batch_size, 0),
+      ref_counts_(num_blocks, 0) {
+  ET_CHECK_MSG(
+      num_blocks > 0 && block_size > 0 && max_batch_size > 0 &&
+          max_blocks_per_seq > 0,
+      "Paged kv cache sizes must be positive");
+  // Hand out low blocks first.
+  free_blocks_.reserve(num_blocks);
+  for (int64_t block = num_blocks; block > 0; --block) {
+    free_blocks_.push_back(block - 1);
+  }
+}
+
+bool PagedKVCacheManager::is_valid_seq(int64_t seq) const {
+  return seq >= 0 && seq < max_batch_size_;
+}
+
+Error PagedKVCacheManager::reserve(int64_t seq, int64_t num_tokens) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_valid_seq(seq), InvalidArgument, "Invalid sequence %" PRId64, seq);
+  const int64_t needed = (num_tokens + block_size_ - 1) / block_size_;
+  ET_CHECK_OR_RETURN_ERROR(
+      needed <= max_blocks_per_seq_,
+      InvalidArgument,
+      "%" PRId64 " tokens need %" PRId64
+      " blocks, but a sequence can have at most %" PRId64,
+      num_tokens,
+      needed,
+      max_blocks_per_seq_);
+  int64_t& count = num_seq_blocks_[seq];
+  if (needed <= count) {
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      needed - count <= num_free_blocks(),
+      MemoryAllocationFailed,
+      "Need %" PRId64 " more blocks but only %" PRId64 " are free",
+      needed - count,
+      num_free_blocks());
+  int64_t* table = block_table_.data() + seq * max_blocks_per_seq_;
+  for (; count < needed; ++count) {
+    const int64_t block = free_blocks_.back();
+    free_blocks_.pop_back();
+    ref_counts_[block] = 1;
+    table[count] = block;
+  }
+  return Error::Ok;
+}
+
+Error PagedKVCacheManager::share_prefix(
+    int64_t src,
+    int64_t dst,
+    int64_t num_tokens) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_valid_seq(src) && is_valid_seq(dst) && src != dst,
+      InvalidArgument,
+      "Invalid sequences %" PRId64 " and %" PRId64,
+      src,
+      dst);
+  ET_CHECK_OR_RETURN_ERROR(
+      num_seq_blocks_[dst] == 0,
+      InvalidState,
+      "Sequence %" PRId64 " already has blocks",
+      dst);
+  ET_CHECK_OR_RETURN_ERROR(
+      num_tokens % block_size_ == 0,
+      InvalidArgument,
+      "Only whole blocks can be shared, but %" PRId64
+      " tokens is not a multiple of the block size %" PRId64,
+      num_tokens,
+      block_size_);
+  const int64_t shared = num_tokens / block_size_;
+  ET_CHECK_OR_RETURN_ERROR(
+      shared <= num_seq_blocks_[src],
+      InvalidArgument,
+      "Sequence %" PRId64 " has fewer than %" PRId64 " tokens",
+      src,
+      num_tokens);
+  const int64_t* src_table = block_table_.data() + src * max_blocks_per_seq_;
+  int64_t* dst_table = block_table_.data() + dst * max_blocks_per_seq_;
+  for (int64_t i = 0; i < shared; ++i) {
+    dst_table[i] = src_table[i];
+    ++ref_counts_[src_table[i]];
+  }
+  num_seq_blocks_[dst] = shared;
+  return Error::Ok;
+}
+
+void PagedKVCacheManager::release(int64_t seq) {
+  if (!is_valid_seq(seq)) {
+    ET_LOG(Error, "Invalid sequence %" PRId64, seq);
+    return;
+  }
+  int64_t* table = block_table_.data() + seq * max_blocks_per_seq_;
+  for (int64_t i = 0; i < num_seq_blocks_[seq]; ++i) {
+    if (--ref_counts_[table[i]] == 0) {
+      free_blocks_.push_back(table[i]);
+    }
+    table[i] = kNoBlock;
+  }
+  num_seq_blocks_[seq] = 0;
+}
+
+} // namespace torch::executor
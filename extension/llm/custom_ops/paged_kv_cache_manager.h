@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Hands out the blocks of a paged kv cache to sequences and keeps the block
+// table that is passed to llama::sdpa_with_paged_kv_cache.
+
+#pragma once
+
+#include <cstdint>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+
+namespace torch::executor {
+
+class PagedKVCacheManager {
+ public:
+  // Entry of the block table for logical blocks that have no block.
+  static constexpr int64_t kNoBlock = -1;
+
+  /**
+   * @param num_blocks Number of blocks in the key and value caches, i.e. dim
+   * 0 of each [num_blocks, block_size, num heads, head dim] cache.
+   * @param block_size Number of tokens per block, i.e. dim 1 of each cache.
+   * @param max_batch_size Number of sequences, i.e. rows of the block table.
+   * @param max_blocks_per_seq Number of blocks a sequence can have, i.e.
+   * columns of the block table.
+   */
+  PagedKVCacheManager(
+      int64_t num_blocks,
+      int64_t block_size,
+      int64_t max_batch_size,
+      int64_t max_blocks_per_seq);
+
+  /**
+   * Makes sure sequence `seq` has blocks for its first `num_tokens` tokens,
+   * taking new blocks from the free list as needed.
+   * @return Error::MemoryAllocationFailed if there are not enough free
+   * blocks, in which case the sequence keeps the blocks it had.
+   */
+  Error reserve(int64_t seq, int64_t num_tokens);
+
+  /**
+   * Makes the empty sequence `dst` start with the blocks holding the first
+   * `num_tokens` tokens of `src`, which must be a multiple of the block size,
+   * so that a common prefix is stored once. Tokens after the prefix go to
+   * new blocks, so the shared blocks are only read from as long as neither
+   * sequence rewrites the prefix.
+   */
+  Error share_prefix(int64_t src, int64_t dst, int64_t num_tokens);
+
+  /**
+   * Drops the blocks of sequence `seq`. Blocks return to the free list once
+   * no sequence uses them.
+   */
+  void release(int64_t seq);
+
+  int64_t num_free_blocks() const {
+    return static_cast<int64_t>(free_blocks_.size());
+  }
+
+  int64_t num_blocks(int64_t seq) const {
+    return num_seq_blocks_[seq];
+  }
+
+  int64_t block_size() const {
+    return block_size_;
+  }
+
+  /**
+   * The [max_batch_size, max_blocks_per_seq] block table, which can be
+   * wrapped in a Long tensor for sdpa_with_paged_kv_cache. It is updated in
+   * place by reserve, share_prefix and release.
+   */
+  const int64_t* block_table() const {
+    return block_table_.data();
+  }
+
+ private:
+  bool is_valid_seq(int64_t seq) const;
+
+  int64_t block_size_;
+  int64_t max_batch_size_;
+  int64_t max_blocks_per_seq_;
+  std::vector<int64_t> block_table_;
+  std::vector<int64_t> num_seq_blocks_;
+  std::vector<int32_t> ref_counts_;
+  std::vector<int64_t> free_blocks_;
+};
+
+} // namespace torch::executor
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/paged_kv_cache_manager.h>
+
+#include <gtest/gtest.h>
+
+using torch::executor::Error;
+using torch::executor::PagedKVCacheManager;
+
+TEST(PagedKVCacheManagerTest, ReserveGrowsWithTokens) {
+  PagedKVCacheManager manager(
+      /*num_blocks=*/4,
+      /*block_size=*/4,
+      /*max_batch_size=*/1,
+      /*max_blocks_per_seq=*/4);
+  EXPECT_EQ(manager.num_free_blocks(), 4);
+
+  EXPECT_EQ(manager.reserve(0, 3), Error::Ok);
+  EXPECT_EQ(manager.num_blocks(0), 1);
+  EXPECT_EQ(manager.reserve(0, 4), Error::Ok);
+  EXPECT_EQ(manager.num_blocks(0), 1);
+  EXPECT_EQ(manager.reserve(0, 9), Error::Ok);
+  EXPECT_EQ(manager.num_blocks(0), 3);
+  EXPECT_EQ(manager.num_free_blocks(), 1);
+
+  const int64_t* table = manager.block_table();
+  EXPECT_EQ(table[0], 0);
+  EXPECT_EQ(table[1], 1);
+  EXPECT_EQ(table[2], 2);
+  EXPECT_EQ(table[3], PagedKVCacheManager::kNoBlock);
+}
+
+TEST(PagedKVCacheManagerTest, ReserveFailsWithoutFreeBlocks) {
+  PagedKVCacheManager manager(
+      /*num_blocks=*/2,
+      /*block_size=*/4,
+      /*max_batch_size=*/2,
+      /*max_blocks_per_seq=*/4);
+  EXPECT_EQ(manager.reserve(0, 4), Error::Ok);
+  EXPECT_EQ(manager.reserve(1, 12), Error::MemoryAllocationFailed);
+  // The failed reserve does not take any blocks.
+  EXPECT_EQ(manager.num_blocks(1), 0);
+  EXPECT_EQ(manager.num_free_blocks(), 1);
+
+  EXPECT_EQ(manager.reserve(0, 17), Error::InvalidArgument);
+  EXPECT_EQ(manager.reserve(2, 1), Error::InvalidArgument);
+}
+
+TEST(PagedKVCacheManagerTest, ReleaseReturnsBlocks) {
+  PagedKVCacheManager manager(
+      /*num_blocks=*/4,
+      /*block_size=*/2,
+      /*max_batch_size=*/2,
+      /*max_blocks_per_seq=*/4);
+  EXPECT_EQ(manager.reserve(0, 4), Error::Ok);
+  EXPECT_EQ(manager.reserve(1, 4), Error::Ok);
+  EXPECT_EQ(manager.num_free_blocks(), 0);
+
+  manager.release(0);
+  EXPECT_EQ(manager.num_blocks(0), 0);
+  EXPECT_EQ(manager.num_free_blocks(), 2);
+  EXPECT_EQ(manager.block_table()[0], PagedKVCacheManager::kNoBlock);
+
+  // Sequence 0 can grow again into the freed blocks.
+  EXPECT_EQ(manager.reserve(0, 3), Error::Ok);
+  EXPECT_EQ(manager.num_free_blocks(), 0);
+}
+
+TEST(PagedKVCacheManagerTest, SharedBlocksAreFreedByLastUser) {
+  PagedKVCacheManager manager(
+      /*num_blocks=*/4,
+      /*block_size=*/2,
+      /*max_batch_size=*/2,
+      /*max_blocks_per_seq=*/4);
+  EXPECT_EQ(manager.reserve(0, 5), Error::Ok);
+  EXPECT_EQ(manager.num_free_blocks(), 1);
+
+  // Only whole blocks can be shared.
+  EXPECT_EQ(manager.share_prefix(0, 1, 3), Error::InvalidArgument);
+  EXPECT_EQ(manager.share_prefix(0, 1, 8), Error::InvalidArgument);
+  EXPECT_EQ(manager.share_prefix(0, 1, 4), Error::Ok);
+  EXPECT_EQ(manager.share_prefix(0, 1, 4), Error::InvalidState);
+  EXPECT_EQ(manager.num_blocks(1), 2);
+  EXPECT_EQ(manager.block_table()[4], manager.block_table()[0]);
+  EXPECT_EQ(manager.block_table()[5], manager.block_table()[1]);
+  EXPECT_EQ(manager.num_free_blocks(), 1);
+
+  manager.release(0);
+  // The blocks shared with sequence 1 stay in use.
+  EXPECT_EQ(manager.num_free_blocks(), 2);
+  manager.release(1);
+  EXPECT_EQ(manager.num_free_blocks(), 4);
+}
@@ -7,6 +7,8 @@
 # pyre-unsafe
 
 
+from typing import List
+
 import torch
 
 from torch.library import impl, Library
@@ -59,3 +61,82 @@ def tile_crop(output: torch.Tensor, tile_size: int) -> torch.Tensor:
     # Returned tensor is of size [n, 3, 224, 224], where n is the number of tiles.
     # We should export with n = max_num_tiles. Set 50 for now.
     return torch.empty([50, output.size(0), 224, 224])
+
+
+# Register and define resize_normalize and out variant.
+preprocess_op_lib.define(
+    "resize_normalize(Tensor input, int height, int width, float[] mean, "
+    "float[] std, float scale, bool channels_last) -> Tensor"
+)
+
+
+def _resize_normalize(
+    input: torch.Tensor,
+    height: int,
+    width: int,
+    mean: List[float],
+    std: List[float],
+    scale: float,
+    channels_last: bool,
+) -> torch.Tensor:
+    if channels_last:
+        input = input.permute(2, 0, 1)
+    resized = torch.nn.functional.interpolate(
+        input.unsqueeze(0).float(),
+        size=(height, width),
+        mode="bilinear",
+        align_corners=False,
+    ).squeeze(0)
+    mean_t = torch.tensor(mean, dtype=torch.float).view(-1, 1, 1)
+    std_t = torch.tensor(std, dtype=torch.float).view(-1, 1, 1)
+    return (resized * scale - mean_t) / std_t
+
+
+@impl(preprocess_op_lib, "resize_normalize", dispatch_key="CompositeExplicitAutograd")
+def resize_normalize_impl(
+    input: torch.Tensor,
+    height: int,
+    width: int,
+    mean: List[float],
+    std: List[float],
+    scale: float,
+    channels_last: bool,
+) -> torch.Tensor:
+    return _resize_normalize(input, height, width, mean, std, scale, channels_last)
+
+
+preprocess_op_lib.define(
+    "resize_normalize.out(Tensor input, int height, int width, float[] mean, "
+    "float[] std, float scale, bool channels_last, *, Tensor(a!) out) "
+    "-> Tensor(a!)"
+)
+
+
+@impl(
+    preprocess_op_lib, "resize_normalize.out", dispatch_key="CompositeExplicitAutograd"
+)
+def resize_normalize_out_impl(
+    input: torch.Tensor,
+    height: int,
+    width: int,
+    mean: List[float],
+    std: List[float],
+    scale: float,
+    channels_last: bool,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    return _resize_normalize(input, height, width, mean, std, scale, channels_last)
+
+
+@torch.library.register_fake("preprocess::resize_normalize")
+def resize_normalize(
+    input: torch.Tensor,
+    height: int,
+    width: int,
+    mean: List[float],
+    std: List[float],
+    scale: float,
+    channels_last: bool,
+) -> torch.Tensor:
+    channels = input.size(2) if channels_last else input.size(0)
+    return torch.empty([channels, height, width], dtype=torch.float)
@@ -43,6 +43,7 @@ def _validate_params(
     drpout_p,
     is_causal,
     scale,
+    supported_dtypes=(torch.float32,),
 ):
     assert (
         query.dim() == 4
@@ -55,12 +56,14 @@ def _validate_params(
     ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
 
     assert (
-        query.dtype == torch.float32
-    ), f"Expected query to be float32 but got {query.dtype}"
-    assert key.dtype == torch.float32, f"Expected key to be float32 but got {key.dtype}"
+        query.dtype in supported_dtypes
+    ), f"Expected query to be one of {supported_dtypes} but got {query.dtype}"
     assert (
-        value.dtype == torch.float32
-    ), f"Expected value to be float32 but got {value.dtype}"
+        key.dtype == query.dtype
+    ), f"Expected key to be {query.dtype} but got {key.dtype}"
+    assert (
+        value.dtype == query.dtype
+    ), f"Expected value to be {query.dtype} but got {value.dtype}"
 
     assert (
         key_cache.dim() == 4
@@ -70,16 +73,25 @@ def _validate_params(
     ), f"Expected value_cache to be 4 dimensional but got {value_cache.dim()}"
 
     assert (
-        key_cache.dtype == torch.float32
-    ), f"Expected key_cache to be float32 but got {key_cache.dtype}"
+        key_cache.dtype == query.dtype
+    ), f"Expected key_cache to be {query.dtype} but got {key_cache.dtype}"
     assert (
-        value_cache.dtype == torch.float32
-    ), f"Expected value_cache to be float32 but got {value_cache.dtype}"
+        value_cache.dtype == query.dtype
+    ), f"Expected value_cache to be {query.dtype} but got {value_cache.dtype}"
 
     assert (
         key_cache.size() == value_cache.size()
     ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
 
+    # Grouped-query attention: the cache holds the kv heads, each shared by
+    # a group of query heads, so key and value must not be repeated.
+    assert (
+        key.size(2) == key_cache.size(2) and value.size(2) == key_cache.size(2)
+    ), f"Expected key and value to have the {key_cache.size(2)} heads of the cache but got {key.size(2)} and {value.size(2)}"
+    assert (
+        query.size(2) % key_cache.size(2) == 0
+    ), f"Expected the {query.size(2)} query heads to be a multiple of the {key_cache.size(2)} kv heads"
+
     # These asserts are real but they require me to add constrain_as_size/value calls to the model and I dont want to do that right now
     # assert start_pos < key_cache.size(
     #     1
@@ -123,6 +135,297 @@ def sdpa_with_kv_cache_meta(
         drpout_p,
         is_causal,
         scale,
+        # Half and bfloat16 are accumulated in float.
+        supported_dtypes=(torch.float32, torch.float16, torch.bfloat16),
+    )
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_paged_kv_cache", "Meta")
+def sdpa_with_paged_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    block_table,
+    start_pos,
+    seq_len,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    _validate_params(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        attn_mask,
+        drpout_p,
+        is_causal,
+        scale,
+    )
+    assert (
+        block_table.dim() == 2
+    ), f"Expected block_table to be 2 dimensional but got {block_table.dim()} dimensions."
+    assert (
+        block_table.dtype == torch.int64
+    ), f"Expected block_table to be int64 but got {block_table.dtype}"
+    assert block_table.size(0) == query.size(
+        0
+    ), f"Expected block_table to have {query.size(0)} rows but got {block_table.size(0)}"
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_quantized_kv_cache", "Meta")
+def sdpa_with_quantized_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    key_scales,
+    value_scales,
+    start_pos,
+    seq_len,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    for name, t in [("query", query), ("key", key), ("value", value)]:
+        assert (
+            t.dim() == 4
+        ), f"Expected {name} to be 4 dimensional but got {t.dim()} dimensions."
+        assert (
+            t.dtype == torch.float32
+        ), f"Expected {name} to be float32 but got {t.dtype}"
+    for name, t in [("key_cache", key_cache), ("value_cache", value_cache)]:
+        assert (
+            t.dim() == 4
+        ), f"Expected {name} to be 4 dimensional but got {t.dim()}"
+        assert t.dtype == torch.int8, f"Expected {name} to be int8 but got {t.dtype}"
+    for name, t in [("key_scales", key_scales), ("value_scales", value_scales)]:
+        assert (
+            t.size() == key_cache.size()[:3]
+        ), f"Expected {name} to have size {key_cache.size()[:3]} but got {t.size()}"
+        assert (
+            t.dtype == torch.float32
+        ), f"Expected {name} to be float32 but got {t.dtype}"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+
+    if attn_mask is not None:
+        assert (
+            attn_mask.dim() == 2
+        ), f"Expected attn_mask to be 2 dimensional but got {attn_mask.dim()} dimensions."
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_sink_kv_cache", "Meta")
+def sdpa_with_sink_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    freqs_cos,
+    freqs_sin,
+    start_pos,
+    seq_len,
+    num_sink_tokens,
+    scale=None,
+):
+    _validate_params(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        None,
+        0.0,
+        True,
+        scale,
     )
+    assert (
+        key_cache.size(0) == 1
+    ), f"Expected the sink kv cache to have batch size 1 but got {key_cache.size(0)}"
+    assert (
+        num_sink_tokens < key_cache.size(1)
+    ), f"Expected fewer than {key_cache.size(1)} sink tokens but got {num_sink_tokens}"
+    head_dim = key_cache.size(3)
+    assert freqs_cos.size() == freqs_sin.size() and freqs_cos.size(1) in (
+        head_dim // 2,
+        head_dim,
+    ), f"Expected rope tables with {head_dim // 2} or {head_dim} columns but got {freqs_cos.size()} and {freqs_sin.size()}"
 
     return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "rms_norm", "Meta")
+def rms_norm_meta(input, weight, eps):
+    assert (
+        weight.dim() == 1
+    ), f"Expected weight to be 1 dimensional but got {weight.dim()} dimensions."
+    assert input.size(-1) == weight.size(
+        0
+    ), f"Expected weight of size {input.size(-1)} but got {weight.size(0)}"
+    assert (
+        input.dtype == weight.dtype
+    ), f"Expected input and weight to have the same dtype but got {input.dtype} and {weight.dtype}"
+
+    return torch.empty_like(input)
+
+
+def _linear_quantized_meta(input, packed_weight, scales, group_size, bitwidth):
+    assert (
+        input.dtype == torch.float32
+    ), f"Expected input to be float32 but got {input.dtype}"
+    assert (
+        packed_weight.dim() == 3
+    ), f"Expected packed_weight to be 3 dimensional but got {packed_weight.dim()} dimensions."
+    assert packed_weight.size(1) == input.size(
+        -1
+    ), f"Expected packed_weight to have {input.size(-1)} input features but got {packed_weight.size(1)}"
+    assert (
+        packed_weight.size(2) == bitwidth
+    ), f"Expected {bitwidth} bytes per input feature in packed_weight but got {packed_weight.size(2)}"
+    assert (
+        scales.dim() == 2 and scales.dtype == torch.float32
+    ), f"Expected scales to be a 2 dimensional float32 tensor but got {scales.dim()} dimensions of {scales.dtype}"
+    assert (
+        group_size > 0
+        and input.size(-1) % group_size == 0
+        and scales.size(1) == input.size(-1) // group_size
+    ), f"Expected one scale per group of {group_size} input features"
+
+    return input.new_empty(input.shape[:-1] + (scales.size(0),))
+
+
+@impl(custom_ops_lib, "apply_rotary_emb", "Meta")
+def apply_rotary_emb_meta(input, freqs_cos, freqs_sin):
+    assert (
+        input.dim() == 4
+    ), f"Expected input to be 4 dimensional but got {input.dim()} dimensions."
+    assert (
+        freqs_cos.dim() == 2 and freqs_cos.size() == freqs_sin.size()
+    ), f"Expected 2 dimensional rope tables of the same size but got {freqs_cos.size()} and {freqs_sin.size()}"
+    head_dim = input.size(-1)
+    assert freqs_cos.size(1) in (
+        head_dim // 2,
+        head_dim,
+    ), f"Expected rope tables with {head_dim // 2} or {head_dim} columns but got {freqs_cos.size(1)}"
+    assert (
+        input.dtype == freqs_cos.dtype and input.dtype == freqs_sin.dtype
+    ), f"Expected input and rope tables to have the same dtype but got {input.dtype}, {freqs_cos.dtype} and {freqs_sin.dtype}"
+
+    return torch.empty_like(input)
+
+
+@impl(custom_ops_lib, "linear_int4", "Meta")
+def linear_int4_meta(input, packed_weight, scales, group_size):
+    assert (
+        packed_weight.dtype == torch.uint8
+    ), f"Expected packed_weight to be uint8 but got {packed_weight.dtype}"
+    return _linear_quantized_meta(input, packed_weight, scales, group_size, 4)
+
+
+@impl(custom_ops_lib, "linear_int8", "Meta")
+def linear_int8_meta(input, packed_weight, scales, group_size):
+    assert (
+        packed_weight.dtype == torch.int8
+    ), f"Expected packed_weight to be int8 but got {packed_weight.dtype}"
+    return _linear_quantized_meta(input, packed_weight, scales, group_size, 8)
+
+
+# Bytes per block of 32 values of the GGUF quantized types: a float16 scale and
+# the quantized values.
+_GGUF_BLOCK_BYTES = {"q4_0": 18, "q8_0": 34}
+
+
+def _gguf_weight_features(weight, block_type):
+    assert (
+        weight.dtype == torch.uint8 and weight.dim() == 2
+    ), f"Expected weight to be a 2 dimensional uint8 tensor of GGUF blocks but got {weight.dim()} dimensions of {weight.dtype}"
+    block_bytes = _GGUF_BLOCK_BYTES[block_type]
+    assert (
+        weight.size(1) % block_bytes == 0
+    ), f"Expected weight rows to hold whole {block_type} blocks of {block_bytes} bytes but got {weight.size(1)} bytes"
+    return weight.size(1) // block_bytes * 32
+
+
+def _linear_gguf_meta(input, weight, block_type):
+    assert (
+        input.dtype == torch.float32
+    ), f"Expected input to be float32 but got {input.dtype}"
+    in_features = _gguf_weight_features(weight, block_type)
+    assert (
+        input.size(-1) == in_features
+    ), f"Expected input to have {in_features} features but got {input.size(-1)}"
+    return input.new_empty(input.shape[:-1] + (weight.size(0),))
+
+
+def _embedding_gguf_meta(weight, indices, block_type):
+    assert (
+        indices.dtype == torch.int64
+    ), f"Expected indices to be int64 but got {indices.dtype}"
+    dim = _gguf_weight_features(weight, block_type)
+    return indices.new_empty(indices.shape + (dim,), dtype=torch.float32)
+
+
+@impl(custom_ops_lib, "linear_q4_0", "Meta")
+def linear_q4_0_meta(input, weight):
+    return _linear_gguf_meta(input, weight, "q4_0")
+
+
+@impl(custom_ops_lib, "linear_q8_0", "Meta")
+def linear_q8_0_meta(input, weight):
+    return _linear_gguf_meta(input, weight, "q8_0")
+
+
+@impl(custom_ops_lib, "embedding_q4_0", "Meta")
+def embedding_q4_0_meta(weight, indices):
+    return _embedding_gguf_meta(weight, indices, "q4_0")
+
+
+@impl(custom_ops_lib, "embedding_q8_0", "Meta")
+def embedding_q8_0_meta(weight, indices):
+    return _embedding_gguf_meta(weight, indices, "q8_0")
+
+
+@impl(custom_ops_lib, "moe_ffn", "Meta")
+def moe_ffn_meta(input, expert_indices, expert_weights, w1, w2, w3):
+    assert (
+        input.dtype == torch.float32
+    ), f"Expected input to be float32 but got {input.dtype}"
+    assert (
+        w1.dim() == 3 and w1.size() == w2.size() and w1.size() == w3.size()
+    ), f"Expected expert weights of the same 3 dimensional shape but got {w1.size()}, {w2.size()} and {w3.size()}"
+    assert (
+        w1.size(2) == input.size(-1)
+    ), f"Expected expert weights with {input.size(-1)} input features but got {w1.size(2)}"
+    assert (
+        expert_indices.dtype == torch.int64
+    ), f"Expected expert_indices to be int64 but got {expert_indices.dtype}"
+    assert (
+        expert_indices.size() == expert_weights.size()
+        and expert_indices.shape[:-1] == input.shape[:-1]
+    ), f"Expected expert_indices and expert_weights of shape {input.shape[:-1]} + (top_k,) but got {expert_indices.size()} and {expert_weights.size()}"
+    assert (
+        input.dtype == expert_weights.dtype
+        and input.dtype == w1.dtype
+        and input.dtype == w2.dtype
+        and input.dtype == w3.dtype
+    ), "Expected input, expert_weights and expert weights to have the same dtype"
+
+    return torch.empty_like(input)
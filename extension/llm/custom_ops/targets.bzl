@@ -8,13 +8,30 @@ def define_common_targets():
     """
     runtime.cxx_library(
         name = "custom_ops",
-        srcs = ["op_sdpa.cpp"],
-        exported_headers = ["op_sdpa.h"],
+        srcs = [
+            "op_gguf.cpp",
+            "op_linear_quantized.cpp",
+            "op_moe_ffn.cpp",
+            "op_rms_norm.cpp",
+            "op_rope.cpp",
+            "op_sdpa.cpp",
+            "paged_kv_cache_manager.cpp",
+        ],
+        exported_headers = [
+            "op_gguf.h",
+            "op_linear_quantized.h",
+            "op_moe_ffn.h",
+            "op_rms_norm.h",
+            "op_rope.h",
+            "op_sdpa.h",
+            "paged_kv_cache_manager.h",
+        ],
         exported_deps = [
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/optimized:libblas",
             "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/optimized/cpu:activation_utils",
             "//executorch/extension/kernel_util:kernel_util",
             "//executorch/extension/parallel:thread_parallel",
             "//executorch/backends/xnnpack/threadpool:threadpool",
@@ -87,6 +104,129 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "op_sdpa_with_paged_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_paged_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_sdpa_with_quantized_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_quantized_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_sdpa_with_sink_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_sink_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "paged_kv_cache_manager_test",
+        srcs = [
+            "paged_kv_cache_manager_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rms_norm_test",
+        srcs = [
+            "op_rms_norm_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rope_test",
+        srcs = [
+            "op_rope_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_linear_quantized_test",
+        srcs = [
+            "op_linear_quantized_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_moe_ffn_test",
+        srcs = [
+            "op_moe_ffn_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_gguf_test",
+        srcs = [
+            "op_gguf_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
     ## For preprocess
     runtime.python_library(
         name = "preprocess_custom_ops_py",
@@ -109,6 +249,26 @@ def define_common_targets():
         exported_deps = [
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/extension/kernel_util:kernel_util",
+            "//executorch/extension/parallel:thread_parallel",
+        ],
+        compiler_flags = ["-Wno-missing-prototypes", "-Wno-global-constructors"],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        # @lint-ignore BUCKLINT link_whole
+        link_whole = True,
+        force_static = True,
+    )
+
+    runtime.cxx_library(
+        name = "op_resize_normalize",
+        srcs = ["op_resize_normalize.cpp"],
+        exported_headers = ["op_resize_normalize.h"],
+        exported_deps = [
+            "//executorch/runtime/kernel:kernel_includes",
+            "//executorch/extension/kernel_util:kernel_util",
+            "//executorch/extension/parallel:thread_parallel",
         ],
         compiler_flags = ["-Wno-missing-prototypes", "-Wno-global-constructors"],
         visibility = [
@@ -120,6 +280,20 @@ def define_common_targets():
         force_static = True,
     )
 
+    runtime.cxx_test(
+        name = "op_resize_normalize_test",
+        srcs = [
+            "op_resize_normalize_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":op_resize_normalize",
+        ],
+    )
+
     runtime.cxx_test(
         name = "op_tile_crop_test",
         srcs = [
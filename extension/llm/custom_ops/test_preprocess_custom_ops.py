@@ -52,3 +52,24 @@ class PreprocessTest(unittest.TestCase):
 
     def test_op_tile_crop_4x2(self):
         self._test_tile_crop(torch.ones(3, 896, 448), (8, 3, 224, 224))
+
+    def test_op_resize_normalize(self):
+        image = torch.randint(0, 256, (3, 20, 30), dtype=torch.uint8)
+        mean = [0.5, 0.4, 0.3]
+        std = [0.2, 0.25, 0.3]
+        output = torch.ops.preprocess.resize_normalize.default(
+            image, 10, 12, mean, std, 1 / 255, False
+        )
+        resized = torch.nn.functional.interpolate(
+            image.unsqueeze(0).float(), size=(10, 12), mode="bilinear"
+        ).squeeze(0)
+        mean_t = torch.tensor(mean).view(3, 1, 1)
+        std_t = torch.tensor(std).view(3, 1, 1)
+        output_ref = (resized / 255 - mean_t) / std_t
+        self.assertTrue(torch.allclose(output_ref, output, atol=1e-5))
+
+        # Interleaved pixels give the same result.
+        output_hwc = torch.ops.preprocess.resize_normalize.default(
+            image.permute(1, 2, 0).contiguous(), 10, 12, mean, std, 1 / 255, True
+        )
+        self.assertTrue(torch.allclose(output, output_hwc))
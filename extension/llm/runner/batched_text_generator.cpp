@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Prefill and generate several sequences at once through a LLM exported with a
+// batch size larger than 1.
+
+#include <executorch/extension/llm/runner/batched_text_generator.h>
+
+#include <executorch/extension/runner_util/managed_tensor.h>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <algorithm>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <ctime>
+
+namespace torch::executor {
+
+BatchedTextGenerator::BatchedTextGenerator(
+    Tokenizer* tokenizer,
+    TextDecoderRunner* text_decoder_runner,
+    int32_t batch_size,
+    int32_t vocab_size,
+    float temperature,
+    bool enable_parallel_prefill,
+    std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+    Stats* stats)
+    : tokenizer_(tokenizer),
+      text_decoder_runner_(text_decoder_runner),
+      batch_size_(batch_size),
+      enable_parallel_prefill_(enable_parallel_prefill),
+      eos_ids_(std::move(eos_ids)),
+      detokenizers_(batch_size, IncrementalDetokenizer(tokenizer)),
+      stats_(stats) {
+  ET_CHECK_MSG(batch_size > 0, "Batch size must be positive");
+  const auto seed = static_cast<unsigned long long>(std::time(nullptr));
+  samplers_.reserve(batch_size);
+  for (int32_t i = 0; i < batch_size; ++i) {
+    samplers_.push_back(std::make_unique<Sampler>(
+        vocab_size, temperature, ::executorch::llm::kTopp, seed + i));
+  }
+}
+
+int32_t BatchedTextGenerator::sample(
+    const exec_aten::Tensor& logits_tensor,
+    int32_t seq,
+    int64_t index) {
+  const int64_t vocab_size = logits_tensor.size(2);
+  const int64_t offset = (seq * logits_tensor.size(1) + index) * vocab_size;
+  switch (logits_tensor.scalar_type()) {
+    case ScalarType::Float:
+      return samplers_[seq]->sample(
+          logits_tensor.mutable_data_ptr<float>() + offset);
+    case ScalarType::Half:
+      return samplers_[seq]->sample(
+          logits_tensor.mutable_data_ptr<exec_aten::Half>() + offset);
+    case ScalarType::BFloat16:
+      return samplers_[seq]->sample(
+          logits_tensor.mutable_data_ptr<exec_aten::BFloat16>() + offset);
+    default:
+      ET_CHECK_MSG(
+          false,
+          "Unsupported dtype output %hhd",
+          static_cast<int8_t>(logits_tensor.scalar_type()));
+  }
+}
+
+Result<std::vector<int64_t>> BatchedTextGenerator::generate(
+    const std::vector<std::vector<uint64_t>>& prompts,
+    int32_t seq_len,
+    std::function<void(int32_t, std::string_view)> token_callback) {
+  const int32_t num_seqs = prompts.size();
+  ET_CHECK_OR_RETURN_ERROR(
+      num_seqs > 0 && num_seqs <= batch_size_,
+      InvalidArgument,
+      "Expected 1 to %d prompts, got %d",
+      batch_size_,
+      num_seqs);
+  int64_t min_prompt_len = seq_len;
+  for (int32_t i = 0; i < num_seqs; ++i) {
+    const int64_t prompt_len = prompts[i].size();
+    ET_CHECK_OR_RETURN_ERROR(
+        prompt_len > 0 && prompt_len < seq_len,
+        InvalidArgument,
+        "Prompt %d has %" PRId64 " tokens, expected 1 to %d",
+        i,
+        prompt_len,
+        seq_len - 1);
+    min_prompt_len = std::min(min_prompt_len, prompt_len);
+  }
+  if (!text_decoder_runner_->is_method_loaded()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(text_decoder_runner_->load());
+  }
+
+  should_stop_ = false;
+  for (auto& detokenizer : detokenizers_) {
+    detokenizer.reset();
+  }
+  std::vector<int64_t> num_generated(num_seqs, 0);
+  // The last token fed for each row, which is fed again by the rows that are
+  // done or unused.
+  std::vector<uint64_t> last_tokens(batch_size_, tokenizer_->bos_tok());
+  std::vector<bool> done(num_seqs, false);
+  int32_t num_active = num_seqs;
+  bool sampled_any = false;
+
+  std::vector<uint64_t> token_data;
+  int64_t pos = 0;
+  // The first step covers the positions every prompt has.
+  int32_t num_step_tokens = enable_parallel_prefill_ ? min_prompt_len : 1;
+
+  // The logits of the last fed position predict the token at next_pos, which
+  // has to be within the sequence.
+  while (num_active > 0 && pos + num_step_tokens < seq_len) {
+    token_data.resize(batch_size_ * num_step_tokens);
+    for (int32_t seq = 0; seq < batch_size_; ++seq) {
+      for (int32_t i = 0; i < num_step_tokens; ++i) {
+        const int64_t p = pos + i;
+        token_data[seq * num_step_tokens + i] =
+            seq < num_seqs && p < prompts[seq].size() ? prompts[seq][p]
+                                                      : last_tokens[seq];
+      }
+      last_tokens[seq] = token_data[(seq + 1) * num_step_tokens - 1];
+    }
+
+    ManagedTensor managed_tokens(
+        token_data.data(), {batch_size_, num_step_tokens}, ScalarType::Long);
+    ManagedTensor managed_start_pos(&pos, {1}, ScalarType::Long);
+    stats_->on_step_begin();
+    Result<exec_aten::Tensor> logits_res =
+        text_decoder_runner_->step(managed_tokens, managed_start_pos);
+    stats_->on_step_end();
+    ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+    const exec_aten::Tensor& logits_tensor = logits_res.get();
+    ET_CHECK_OR_RETURN_ERROR(
+        logits_tensor.dim() == 3 && logits_tensor.size(0) == batch_size_,
+        InvalidArgument,
+        "Expected logits for a batch of %d, got %zd dims",
+        batch_size_,
+        logits_tensor.dim());
+    const int64_t index = logits_tensor.size(1) - 1;
+
+    const int64_t next_pos = pos + num_step_tokens;
+    for (int32_t seq = 0; seq < num_seqs; ++seq) {
+      // Sequences that are still in their prompt feed the next prompt token.
+      if (done[seq] || next_pos < prompts[seq].size()) {
+        continue;
+      }
+      const uint64_t prev_token = last_tokens[seq];
+
+      stats_->on_sampling_begin();
+      const uint64_t cur_token = sample(logits_tensor, seq, index);
+      stats_->on_sampling_end();
+
+      last_tokens[seq] = cur_token;
+      num_generated[seq]++;
+      if (!sampled_any) {
+        // The shortest prompt has been prefilled once its first token is out.
+        stats_->first_token_ms = util::time_in_ms();
+        stats_->prompt_eval_end_ms = stats_->first_token_ms;
+        sampled_any = true;
+      }
+
+      if (token_callback) {
+        stats_->on_decode_begin();
+        std::string_view text =
+            ET_UNWRAP(detokenizers_[seq].next(prev_token, cur_token));
+        stats_->on_decode_end();
+        if (!text.empty()) {
+          token_callback(seq, text);
+        }
+      }
+
+      if (eos_ids_->find(cur_token) != eos_ids_->end()) {
+        done[seq] = true;
+        num_active--;
+      }
+    }
+
+    if (should_stop_) {
+      break;
+    }
+    pos = next_pos;
+    num_step_tokens = 1;
+  }
+  return num_generated;
+}
+
+} // namespace torch::executor
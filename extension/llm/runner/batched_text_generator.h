@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Prefill and generate several sequences at once through a LLM exported with a
+// batch size larger than 1.
+
+#pragma once
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/sampler/sampler.h>
+#include <executorch/extension/llm/tokenizer/incremental_detokenizer.h>
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <functional>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <memory>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <unordered_set>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <vector>
+
+namespace torch::executor {
+using Stats = ::executorch::llm::Stats;
+
+/**
+ * Each sequence of the batch owns one row of the model's kv cache. The model
+ * takes [batch_size, n] tokens and a single start_pos shared by all rows, so
+ * the sequences advance in lockstep: at every position, a sequence feeds its
+ * next prompt token while it has one, and the token it sampled afterwards.
+ * Prompts of different lengths thus need no padding, and the first
+ * min(prompt lengths) positions are prefilled in one step when parallel
+ * prefill is enabled.
+ */
+class BatchedTextGenerator {
+ public:
+  /**
+   * @param batch_size The batch size the model was exported with. Fewer
+   * prompts than that can be generated, in which case the remaining rows are
+   * computed and dropped.
+   * @param enable_parallel_prefill Whether the model takes several tokens per
+   * row in one step.
+   */
+  BatchedTextGenerator(
+      Tokenizer* tokenizer,
+      TextDecoderRunner* text_decoder_runner,
+      int32_t batch_size,
+      int32_t vocab_size,
+      float temperature,
+      bool enable_parallel_prefill,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats);
+
+  /**
+   * Generate tokens for every prompt until each one reaches EOS or seq_len.
+   * @param prompts The encoded prompts, at most batch_size of them.
+   * @param seq_len The total sequence length of each sequence, including its
+   * prompt tokens.
+   * @param token_callback Called with the sequence index and the text of the
+   * generated tokens of that sequence, as soon as they make up whole UTF-8
+   * characters. The view is only valid during the call.
+   * @return The number of tokens generated for each prompt.
+   */
+  Result<std::vector<int64_t>> generate(
+      const std::vector<std::vector<uint64_t>>& prompts,
+      int32_t seq_len,
+      std::function<void(int32_t, std::string_view)> token_callback = {});
+
+  /**
+   * Stop the generation loop.
+   */
+  void stop() {
+    should_stop_ = true;
+  }
+
+ private:
+  int32_t sample(
+      const exec_aten::Tensor& logits_tensor,
+      int32_t seq,
+      int64_t index);
+
+  Tokenizer* tokenizer_;
+  TextDecoderRunner* text_decoder_runner_;
+  int32_t batch_size_;
+  bool enable_parallel_prefill_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+  // one sampler per kv cache row, so that sequences sample independently
+  std::vector<std::unique_ptr<Sampler>> samplers_;
+  // one detokenizer per kv cache row, as each sequence is its own text stream
+  std::vector<IncrementalDetokenizer> detokenizers_;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+
+} // namespace torch::executor
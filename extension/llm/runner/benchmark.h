@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Aggregates the stats of repeated generations into benchmark results.
+#pragma once
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <algorithm>
+#include <cstdint>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <sstream>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace executorch::llm {
+
+/**
+ * Min, mean and max of a metric over the runs of a benchmark.
+ */
+class MetricSummary {
+ public:
+  void add(double value) {
+    min_ = count_ == 0 ? value : std::min(min_, value);
+    max_ = count_ == 0 ? value : std::max(max_, value);
+    sum_ += value;
+    ++count_;
+  }
+
+  uint64_t count() const {
+    return count_;
+  }
+
+  double min() const {
+    return min_;
+  }
+
+  double mean() const {
+    return count_ == 0 ? 0 : sum_ / count_;
+  }
+
+  double max() const {
+    return max_;
+  }
+
+  /**
+   * Returns {"min":..,"mean":..,"max":..}, or null if no value was added.
+   */
+  std::string to_json_string() const {
+    if (count_ == 0) {
+      return "null";
+    }
+    std::stringstream ss;
+    ss << "{\"min\":" << min() << ",\"mean\":" << mean()
+       << ",\"max\":" << max() << "}";
+    return ss.str();
+  }
+
+ private:
+  uint64_t count_ = 0;
+  double sum_ = 0;
+  double min_ = 0;
+  double max_ = 0;
+};
+
+/**
+ * Results of the repeated generations of one benchmark configuration: the
+ * requested prompt and generation lengths, the token counts of the last run,
+ * and the time to first token, prefill rate and decode rate of every run.
+ *
+ * Rates are computed the same way as print_report() does, and are only
+ * recorded for runs whose phase took at least one millisecond, which is the
+ * resolution of Stats.
+ */
+class BenchmarkResult {
+ public:
+  BenchmarkResult(int64_t prompt_length, int64_t generation_length)
+      : prompt_length_(prompt_length), generation_length_(generation_length) {}
+
+  void add(const Stats& stats) {
+    num_prompt_tokens_ = stats.num_prompt_tokens;
+    num_generated_tokens_ = stats.num_generated_tokens;
+    model_load_ms_ = stats.model_load_end_ms - stats.model_load_start_ms;
+    ttft_ms_.add(stats.first_token_ms - stats.inference_start_ms);
+    const long prefill_ms = stats.prompt_eval_end_ms - stats.inference_start_ms;
+    if (prefill_ms > 0) {
+      prefill_tokens_per_s_.add(
+          stats.num_prompt_tokens * stats.SCALING_FACTOR_UNITS_PER_SECOND /
+          static_cast<double>(prefill_ms));
+    }
+    const long decode_ms = stats.inference_end_ms - stats.prompt_eval_end_ms;
+    if (decode_ms > 0) {
+      decode_tokens_per_s_.add(
+          stats.num_generated_tokens * stats.SCALING_FACTOR_UNITS_PER_SECOND /
+          static_cast<double>(decode_ms));
+    }
+  }
+
+  /// Sets the peak resident set size of the process after the runs.
+  void set_peak_rss_bytes(uint64_t peak_rss_bytes) {
+    peak_rss_bytes_ = peak_rss_bytes;
+  }
+
+  uint64_t num_runs() const {
+    return ttft_ms_.count();
+  }
+
+  const MetricSummary& ttft_ms() const {
+    return ttft_ms_;
+  }
+
+  const MetricSummary& prefill_tokens_per_s() const {
+    return prefill_tokens_per_s_;
+  }
+
+  const MetricSummary& decode_tokens_per_s() const {
+    return decode_tokens_per_s_;
+  }
+
+  std::string to_json_string() const {
+    std::stringstream ss;
+    ss << "{\"prompt_length\":" << prompt_length_ << ","
+       << "\"generation_length\":" << generation_length_ << ","
+       << "\"runs\":" << num_runs() << ","
+       << "\"prompt_tokens\":" << num_prompt_tokens_ << ","
+       << "\"generated_tokens\":" << num_generated_tokens_ << ","
+       << "\"model_load_ms\":" << model_load_ms_ << ","
+       << "\"ttft_ms\":" << ttft_ms_.to_json_string() << ","
+       << "\"prefill_tokens_per_s\":" << prefill_tokens_per_s_.to_json_string()
+       << "," << "\"decode_tokens_per_s\":"
+       << decode_tokens_per_s_.to_json_string() << ","
+       << "\"peak_rss_bytes\":" << peak_rss_bytes_ << "}";
+    return ss.str();
+  }
+
+ private:
+  int64_t prompt_length_;
+  int64_t generation_length_;
+  int64_t num_prompt_tokens_ = 0;
+  int64_t num_generated_tokens_ = 0;
+  long model_load_ms_ = 0;
+  uint64_t peak_rss_bytes_ = 0;
+  MetricSummary ttft_ms_;
+  MetricSummary prefill_tokens_per_s_;
+  MetricSummary decode_tokens_per_s_;
+};
+
+/**
+ * Returns the peak resident set size of the process in bytes, or 0 where it
+ * is not available.
+ */
+inline uint64_t peak_rss_bytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // Reported in kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+} // namespace executorch::llm
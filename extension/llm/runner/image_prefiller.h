@@ -29,6 +29,33 @@ class ImagePrefiller {
       Image& image,
       int64_t start_pos = 0) = 0;
 
+  /**
+   * Run only the vision encoder on the given image, the first half of
+   * prefill(). Lets a runner encode one image while the text model prefills
+   * another.
+   * @param image The image input to the multimodal LLM.
+   * @return The image embeddings, valid until the encoder runs again.
+   */
+  virtual Result<exec_aten::Tensor> encode(Image& image) {
+    (void)image;
+    return Error::NotSupported;
+  }
+
+  /**
+   * Prefill an LLM Module with embeddings returned by encode(), the second
+   * half of prefill().
+   * @param embeddings The image embeddings.
+   * @param start_pos The starting position in KV cache of the input in the LLM
+   * @return The logits of the image prefill.
+   */
+  virtual Result<exec_aten::Tensor> prefill_embeddings(
+      exec_aten::Tensor& embeddings,
+      int64_t start_pos = 0) {
+    (void)embeddings;
+    (void)start_pos;
+    return Error::NotSupported;
+  }
+
   virtual Error load() = 0;
   virtual bool is_method_loaded() = 0;
 
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// A fixed-size histogram of latencies, for percentiles of per-token timings.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <sstream>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <string>
+
+namespace executorch::llm {
+
+/**
+ * Counts latencies in log-linear buckets: values below 8 have a bucket each,
+ * and every power of two above that is split into 8 buckets, so a bucket is
+ * at most 12.5% wider than its lower bound. Recording is a few relaxed atomic
+ * adds and never allocates, so it can stay on in production and be recorded
+ * from any thread.
+ */
+class LatencyHistogram {
+ public:
+  // Values at or above 2^kMaxValueBits are counted in the last bucket.
+  static constexpr int kMaxValueBits = 36;
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr size_t kNumBuckets =
+      kSubBuckets + (kMaxValueBits - kSubBucketBits) * kSubBuckets;
+
+  LatencyHistogram() = default;
+
+  LatencyHistogram(const LatencyHistogram& rhs) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      counts_[i].store(rhs.counts_[i].load(std::memory_order_relaxed));
+    }
+    count_.store(rhs.count());
+    sum_.store(rhs.sum());
+    max_.store(rhs.max());
+  }
+
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(uint64_t value) {
+    counts_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max &&
+           !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  void reset() {
+    for (auto& count : counts_) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t sum() const {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns an upper bound of the given percentile in [0, 100], which is the
+   * largest value of the bucket holding it, capped by the largest recorded
+   * value. Returns 0 if nothing was recorded.
+   */
+  uint64_t percentile(double percent) const {
+    const uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+    // The rank of the percentile among the recorded values, from 1.
+    uint64_t rank = static_cast<uint64_t>(percent / 100.0 * total + 0.5);
+    rank = rank < 1 ? 1 : (rank > total ? total : rank);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        const uint64_t upper = bucket_upper_bound(i) - 1;
+        return upper < max() ? upper : max();
+      }
+    }
+    return max();
+  }
+
+  /**
+   * Returns the histogram as a JSON object with the count, sum, max and
+   * p50/p90/p99 of the values, and the non-empty buckets as
+   * [lower bound, count] pairs.
+   */
+  std::string to_json_string() const {
+    std::stringstream ss;
+    ss << "{\"count\":" << count() << ",\"sum\":" << sum()
+       << ",\"max\":" << max() << ",\"p50\":" << percentile(50)
+       << ",\"p90\":" << percentile(90) << ",\"p99\":" << percentile(99)
+       << ",\"buckets\":[";
+    bool first = true;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      const uint64_t count = counts_[i].load(std::memory_order_relaxed);
+      if (count == 0) {
+        continue;
+      }
+      ss << (first ? "" : ",") << "[" << bucket_lower_bound(i) << ","
+         << count << "]";
+      first = false;
+    }
+    ss << "]}";
+    return ss.str();
+  }
+
+  static size_t bucket_index(uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    if (value >= (uint64_t(1) << kMaxValueBits)) {
+      return kNumBuckets - 1;
+    }
+    int msb = 63;
+    while (!(value >> msb)) {
+      --msb;
+    }
+    const int shift = msb - kSubBucketBits;
+    const size_t sub_bucket = (value >> shift) & (kSubBuckets - 1);
+    return kSubBuckets + shift * kSubBuckets + sub_bucket;
+  }
+
+  static uint64_t bucket_lower_bound(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const size_t shift = (index - kSubBuckets) / kSubBuckets;
+    const uint64_t sub_bucket = (index - kSubBuckets) % kSubBuckets;
+    return (kSubBuckets + sub_bucket) << shift;
+  }
+
+  static uint64_t bucket_upper_bound(size_t index) {
+    return index + 1 < kNumBuckets ? bucket_lower_bound(index + 1)
+                                   : UINT64_MAX;
+  }
+
+ private:
+  std::atomic<uint64_t> counts_[kNumBuckets] = {};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+} // namespace executorch::llm
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/logits_processor.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace torch::executor {
+
+namespace {
+
+constexpr int32_t kBitsPerWord = 32;
+constexpr uint32_t kAllAllowed = ~0u;
+
+// The bit of each token of a word.
+constexpr std::array<uint32_t, kBitsPerWord> make_lane_bits() {
+  std::array<uint32_t, kBitsPerWord> bits{};
+  for (int32_t i = 0; i < kBitsPerWord; ++i) {
+    bits[i] = 1u << i;
+  }
+  return bits;
+}
+constexpr std::array<uint32_t, kBitsPerWord> kLaneBits = make_lane_bits();
+
+} // namespace
+
+void LogitBiasProcessor::set_bias(int32_t token, float bias) {
+  for (auto& token_bias : biases_) {
+    if (token_bias.first == token) {
+      token_bias.second = bias;
+      return;
+    }
+  }
+  biases_.emplace_back(token, bias);
+}
+
+void LogitBiasProcessor::process(float* logits, int32_t vocab_size) {
+  for (const auto& [token, bias] : biases_) {
+    if (token >= 0 && token < vocab_size) {
+      logits[token] += bias;
+    }
+  }
+}
+
+TokenBitmaskProcessor::TokenBitmaskProcessor(int32_t vocab_size)
+    : vocab_size_(vocab_size),
+      bitmask_((vocab_size + kBitsPerWord - 1) / kBitsPerWord, kAllAllowed) {}
+
+void TokenBitmaskProcessor::allow_all() {
+  std::fill(bitmask_.begin(), bitmask_.end(), kAllAllowed);
+}
+
+void TokenBitmaskProcessor::disallow_all() {
+  std::fill(bitmask_.begin(), bitmask_.end(), 0u);
+}
+
+void TokenBitmaskProcessor::allow(int32_t token) {
+  if (token >= 0 && token < vocab_size_) {
+    bitmask_[token / kBitsPerWord] |= 1u << (token % kBitsPerWord);
+  }
+}
+
+void TokenBitmaskProcessor::process(float* logits, int32_t vocab_size) {
+  constexpr float kMasked = -std::numeric_limits<float>::infinity();
+  const int32_t masked_size = std::min(vocab_size, vocab_size_);
+  for (int32_t begin = 0; begin < masked_size; begin += kBitsPerWord) {
+    const uint32_t word = bitmask_[begin / kBitsPerWord];
+    const int32_t end = std::min(begin + kBitsPerWord, masked_size);
+    if (word == kAllAllowed) {
+      continue;
+    }
+    float* block = logits + begin;
+    if (word == 0) {
+      std::fill(block, logits + end, kMasked);
+      continue;
+    }
+    if (end - begin < kBitsPerWord) {
+      for (int32_t i = 0; i < end - begin; ++i) {
+        block[i] = word & kLaneBits[i] ? block[i] : kMasked;
+      }
+      continue;
+    }
+    // A fixed trip count and a constant bit per lane, rather than a
+    // variable shift, let compilers vectorize the selects.
+    for (int32_t i = 0; i < kBitsPerWord; ++i) {
+      block[i] = word & kLaneBits[i] ? block[i] : kMasked;
+    }
+  }
+  if (vocab_size > masked_size) {
+    std::fill(logits + masked_size, logits + vocab_size, kMasked);
+  }
+}
+
+void logits_to_float(const exec_aten::Half* logits, int32_t size, float* out) {
+  for (int32_t i = 0; i < size; ++i) {
+    out[i] = static_cast<float>(logits[i]);
+  }
+}
+
+void logits_to_float(
+    const exec_aten::BFloat16* logits,
+    int32_t size,
+    float* out) {
+  for (int32_t i = 0; i < size; ++i) {
+    // A bfloat16 is the upper half of a float.
+    const uint32_t bits = static_cast<uint32_t>(logits[i].x) << 16;
+    std::memcpy(out + i, &bits, sizeof(float));
+  }
+}
+
+} // namespace torch::executor
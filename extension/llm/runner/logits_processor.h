@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Processors that modify the logits of the next token in place before it is
+// sampled, e.g. to constrain the output to a JSON schema or a grammar.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch::executor {
+
+/**
+ * A step of the chain of logits processors of a TextDecoderRunner. Each step
+ * modifies the float logits of the next token in place, then learns which
+ * token was sampled from them.
+ */
+class LogitsProcessor {
+ public:
+  virtual ~LogitsProcessor() = default;
+
+  /**
+   * Modify the logits of the next token in place.
+   * @param logits The logits of the next token.
+   * @param vocab_size The number of logits.
+   */
+  virtual void process(float* logits, int32_t vocab_size) = 0;
+
+  /**
+   * Called with the token sampled from the processed logits, e.g. to advance
+   * the state of a grammar.
+   * @param token The sampled token.
+   */
+  virtual void accept_token(int32_t token) {
+    (void)token;
+  }
+};
+
+/**
+ * Adds a bias to the logits of some tokens. A bias of -infinity bans a token.
+ */
+class LogitBiasProcessor : public LogitsProcessor {
+ public:
+  /**
+   * Set the bias of a token, replacing its previous bias.
+   */
+  void set_bias(int32_t token, float bias);
+
+  /**
+   * Remove the biases of all tokens.
+   */
+  void clear() {
+    biases_.clear();
+  }
+
+  void process(float* logits, int32_t vocab_size) override;
+
+ private:
+  std::vector<std::pair<int32_t, float>> biases_;
+};
+
+/**
+ * Masks out the logits of the tokens that a bitmask doesn't allow, e.g. the
+ * tokens that a grammar doesn't accept next. Token t is allowed if bit t % 32
+ * of word t / 32 of the bitmask is set, the layout that grammar engines
+ * usually fill. Words that allow or mask out all of their tokens are handled
+ * in bulk, and the others without branches, so that a mask costs
+ * microseconds per token even for large vocabularies.
+ */
+class TokenBitmaskProcessor : public LogitsProcessor {
+ public:
+  /**
+   * @param vocab_size The number of tokens of the bitmask, all allowed at
+   * first. Tokens past it are masked out.
+   */
+  explicit TokenBitmaskProcessor(int32_t vocab_size);
+
+  /**
+   * The bitmask, for the application or a grammar engine to fill in place
+   * before each token, with bitmask_size() words.
+   */
+  uint32_t* mutable_bitmask() {
+    return bitmask_.data();
+  }
+
+  size_t bitmask_size() const {
+    return bitmask_.size();
+  }
+
+  /**
+   * Allow every token.
+   */
+  void allow_all();
+
+  /**
+   * Mask out every token, e.g. before allowing some with allow().
+   */
+  void disallow_all();
+
+  /**
+   * Allow a token.
+   */
+  void allow(int32_t token);
+
+  void process(float* logits, int32_t vocab_size) override;
+
+ private:
+  int32_t vocab_size_;
+  std::vector<uint32_t> bitmask_;
+};
+
+/**
+ * Convert reduced precision logits to float, for the logits processors.
+ */
+void logits_to_float(const exec_aten::Half* logits, int32_t size, float* out);
+void logits_to_float(
+    const exec_aten::BFloat16* logits,
+    int32_t size,
+    float* out);
+
+} // namespace torch::executor
@@ -15,12 +15,16 @@
 #include <cstdint>
 // patternlint-disable-next-line executorch-cpp-nostdinc
 #include <functional>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <future>
 #include <memory>
 // patternlint-disable-next-line executorch-cpp-nostdinc
 #include <string>
 #include <type_traits>
 // patternlint-disable-next-line executorch-cpp-nostdinc
 #include <unordered_map>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <vector>
 
 #include <executorch/extension/llm/runner/image.h>
 #include <executorch/extension/llm/runner/image_prefiller.h>
@@ -43,6 +47,7 @@ class MultimodalRunner {
       const std::string& tokenizer_path,
       const float temperature = 0.8f)
       : temperature_(temperature),
+        model_path_(model_path),
         module_(std::make_unique<Module>(model_path, Module::LoadMode::File)),
         tokenizer_path_(tokenizer_path) {
     ET_LOG(
@@ -58,16 +63,78 @@ class MultimodalRunner {
       std::vector<Image>& images,
       const std::string& prompt,
       int32_t seq_len = 1024,
-      std::function<void(const std::string&)> token_callback = {},
+      std::function<void(std::string_view)> token_callback = {},
       std::function<void(const Stats&)> stats_callback = {}) = 0;
 
   inline void stop() {
     text_token_generator_->stop();
   }
 
+  /**
+   * Encode the images on a background thread while the text model prefills,
+   * one image ahead of it: the first image is encoded while the text before
+   * it is prefilled, and image K + 1 while image K is. This lowers the time
+   * to first token of prompts with several images, most of all when the
+   * encoder is delegated to another processor than the text model.
+   *
+   * The encoder then runs on a second Module over the same program, with its
+   * own planned memory, and the embeddings of one image are copied out of
+   * it. Must be called before load(), and requires an ImagePrefiller that
+   * implements encode() and prefill_embeddings().
+   */
+  inline void set_pipelined_image_encoding(bool pipelined) {
+    pipelined_image_encoding_ = pipelined;
+  }
+
   virtual ~MultimodalRunner() = default;
 
  protected:
+  /**
+   * Prefill the KV cache with `prefill_text`, then with the images, starting
+   * at `pos`, which is advanced past everything prefilled. `prefill_text`
+   * advances `pos` past the text it prefills. In pipelined mode, the first
+   * image is encoded while `prefill_text` runs.
+   */
+  inline Error prefill_text_and_images(
+      const std::function<Error()>& prefill_text,
+      std::vector<Image>& images,
+      int64_t& pos) {
+    if (!pipelined_image_encoding_ || images.empty()) {
+      ET_CHECK_OK_OR_RETURN_ERROR(prefill_text());
+      for (auto& image : images) {
+        auto logits = ET_UNWRAP(image_prefiller_->prefill(image, pos));
+        pos += logits.size(1);
+      }
+      return Error::Ok;
+    }
+
+    // The encoder overwrites its outputs when it encodes the next image, so
+    // the text model reads copies. Destroying a future returned by
+    // std::async waits for its task, so no task outlives `encoded`.
+    EncodedImage encoded[2];
+    auto encode_async = [&](size_t index) {
+      return std::async(std::launch::async, [this, &images, &encoded, index]() {
+        return encode_image(images[index], encoded[index % 2]);
+      });
+    };
+    std::future<Error> pending = encode_async(0);
+    ET_CHECK_OK_OR_RETURN_ERROR(prefill_text());
+    for (size_t i = 0; i < images.size(); ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(pending.get());
+      if (i + 1 < images.size()) {
+        pending = encode_async(i + 1);
+      }
+      EncodedImage& current = encoded[i % 2];
+      ManagedTensor managed_embeddings(
+          current.data.data(), current.sizes, current.dtype);
+      exec_aten::Tensor embeddings = managed_embeddings.get_aliasing_tensor();
+      auto logits =
+          ET_UNWRAP(image_prefiller_->prefill_embeddings(embeddings, pos));
+      pos += logits.size(1);
+    }
+    return Error::Ok;
+  }
+
   // metadata
   int32_t vocab_size_;
   int32_t bos_id_;
@@ -76,10 +143,14 @@ class MultimodalRunner {
   int32_t n_eos_;
   int32_t max_seq_len_;
   float temperature_;
+  bool pipelined_image_encoding_ = false;
 
   // model
+  std::string model_path_;
   std::unordered_set<std::string> model_methods_;
   std::unique_ptr<Module> module_;
+  // Only set in pipelined mode, to run the image encoder.
+  std::unique_ptr<Module> encoder_module_;
   std::unique_ptr<TextDecoderRunner> text_decoder_runner_;
   std::unique_ptr<TextPrefiller> text_prefiller_;
   std::unique_ptr<ImagePrefiller> image_prefiller_;
@@ -89,6 +160,23 @@ class MultimodalRunner {
 
   // stats
   Stats stats_;
+
+ private:
+  struct EncodedImage {
+    std::vector<uint8_t> data;
+    std::vector<exec_aten::SizesType> sizes;
+    exec_aten::ScalarType dtype = exec_aten::ScalarType::Float;
+  };
+
+  inline Error encode_image(Image& image, EncodedImage& encoded) {
+    exec_aten::Tensor embeddings = ET_UNWRAP(image_prefiller_->encode(image));
+    const auto* bytes =
+        static_cast<const uint8_t*>(embeddings.const_data_ptr());
+    encoded.data.assign(bytes, bytes + embeddings.nbytes());
+    encoded.sizes.assign(embeddings.sizes().begin(), embeddings.sizes().end());
+    encoded.dtype = embeddings.scalar_type();
+    return Error::Ok;
+  }
 };
 
 } // namespace torch::executor
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Keeps track of the tokens held in the KV cache of a LLM, so that a prompt
+// that starts with the same tokens as the previous one only prefills the rest.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <vector>
+
+namespace torch::executor {
+
+/**
+ * The KV cache lives in the mutable buffers of the loaded method and prefill
+ * only writes the positions from its start_pos onwards, so after a prompt has
+ * been prefilled the cache still holds its tokens at positions [0, n) until a
+ * later prefill overwrites them. This class records those tokens instead of
+ * copying the cache, which makes restoring a prefix free.
+ */
+class PrefixCache {
+ public:
+  /**
+   * Returns the number of leading tokens of `prompt_tokens` that are already
+   * in the KV cache, which is the position prefill can start from. The last
+   * prompt token is never reused so that prefill has logits to sample from.
+   */
+  int64_t match(const std::vector<uint64_t>& prompt_tokens) const {
+    const size_t max_len =
+        prompt_tokens.empty() ? 0 : prompt_tokens.size() - 1;
+    size_t len = 0;
+    while (len < max_len && len < tokens_.size() &&
+           tokens_[len] == prompt_tokens[len]) {
+      ++len;
+    }
+    return static_cast<int64_t>(len);
+  }
+
+  /**
+   * Records that the KV cache now holds `tokens` at positions
+   * [start_pos, start_pos + tokens.size()). Tokens after them are dropped as
+   * they may be overwritten by decoding.
+   */
+  void update(const std::vector<uint64_t>& tokens, int64_t start_pos) {
+    tokens_.resize(start_pos);
+    tokens_.insert(tokens_.end(), tokens.begin(), tokens.end());
+  }
+
+  /**
+   * Forgets all tokens, e.g. after a failed prefill left the KV cache in an
+   * unknown state.
+   */
+  void reset() {
+    tokens_.clear();
+  }
+
+  int64_t size() const {
+    return static_cast<int64_t>(tokens_.size());
+  }
+
+ private:
+  std::vector<uint64_t> tokens_;
+};
+
+} // namespace torch::executor
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens in a loop with speculative decoding: a small draft model
+// proposes a few tokens that a larger verifier model checks in one step.
+#pragma once
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/incremental_detokenizer.h>
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <algorithm>
+
+namespace torch::executor {
+using Stats = ::executorch::llm::Stats;
+
+class SpeculativeTokenGenerator {
+ public:
+  /**
+   * @param draft_decoder_runner Runs the draft model one token at a time.
+   * @param verifier_decoder_runner Runs the verifier model, which must take
+   * several tokens per step and return the logits of every one of them.
+   * @param num_draft_tokens Number of tokens the draft model proposes before
+   * each verification step.
+   */
+  SpeculativeTokenGenerator(
+      Tokenizer* tokenizer,
+      TextDecoderRunner* draft_decoder_runner,
+      TextDecoderRunner* verifier_decoder_runner,
+      int32_t num_draft_tokens,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats)
+      : tokenizer_(tokenizer),
+        detokenizer_(tokenizer),
+        draft_decoder_runner_(draft_decoder_runner),
+        verifier_decoder_runner_(verifier_decoder_runner),
+        num_draft_tokens_(num_draft_tokens),
+        eos_ids_(std::move(eos_ids)),
+        stats_(stats) {}
+
+  /**
+   * Token generation loop. Both models use a kv cache, and both have been
+   * prefilled with the tokens before start_pos.
+   *
+   * Every generated token is sampled from the verifier logits, so the output
+   * follows the verifier model: draft tokens are accepted as long as they
+   * match the verifier's samples, and the first mismatch is replaced by the
+   * verifier's token. Rejected tokens are rolled back by rewinding the
+   * position, since the kv cache entries after it are overwritten by the next
+   * step before they are attended to.
+   *
+   * @param tokens prompt tokens as well as the first token generated by
+   * prefill.
+   * @param start_pos the start position of the new tokens, based on how many
+   * prompt tokens is prefilled.
+   * @param seq_len the total sequence length, including the prompt tokens, next
+   * token from prefill and new tokens.
+   * @param token_callback called with the text of the token from prefill and
+   * of each generated token, as soon as it makes up whole UTF-8 characters.
+   * The view is only valid during the call.
+   * @return how many tokens are generated.
+   */
+  inline Result<int64_t> generate(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t seq_len,
+      std::function<void(std::string_view)> token_callback) {
+    ET_CHECK_MSG(
+        static_cast<int64_t>(tokens.size()) == start_pos + 1,
+        "Expected the prompt tokens and the token after them");
+    // Position of the last token, which neither model has been run on yet.
+    int64_t pos = start_pos;
+    // The draft kv cache holds the right tokens before this position.
+    int64_t draft_pos = start_pos;
+
+    uint64_t cur_token = tokens.back();
+    uint64_t prev_token;
+
+    // print the token from prefill. No prev_token so use cur_token for it.
+    detokenizer_.reset();
+    stats_->on_generation_begin();
+    std::string_view text = ET_UNWRAP(detokenizer_.next(cur_token, cur_token));
+    if (!text.empty()) {
+      token_callback(text);
+    }
+    stats_->on_token_generated();
+
+    int64_t draft_data;
+    int64_t draft_pos_data;
+    ManagedTensor draft_tokens_managed(&draft_data, {1, 1}, ScalarType::Long);
+    ManagedTensor draft_start_pos_managed(
+        &draft_pos_data, {1}, ScalarType::Long);
+
+    std::vector<uint64_t> verify_data;
+    int64_t verify_pos_data;
+    ManagedTensor verify_start_pos_managed(
+        &verify_pos_data, {1}, ScalarType::Long);
+
+    int64_t num_proposed = 0;
+    int64_t num_accepted = 0;
+    bool done = false;
+
+    while (!done && pos < seq_len - 1) {
+      // Each round generates up to num_draft + 1 tokens, so don't propose
+      // tokens past the end of the sequence.
+      const int64_t num_draft =
+          std::min<int64_t>(num_draft_tokens_, seq_len - 2 - pos);
+      verify_data.assign(1, cur_token);
+
+      if (num_draft > 0) {
+        // Catch the draft model up to the last token; its logits then
+        // predict the first draft token.
+        draft_data = tokens[draft_pos];
+        draft_pos_data = draft_pos;
+        exec_aten::Tensor draft_logits = ET_UNWRAP(draft_decoder_runner_->step(
+            draft_tokens_managed, draft_start_pos_managed));
+        while (++draft_pos <= pos) {
+          draft_data = tokens[draft_pos];
+          draft_pos_data = draft_pos;
+          draft_logits = ET_UNWRAP(draft_decoder_runner_->step(
+              draft_tokens_managed, draft_start_pos_managed));
+        }
+        for (int64_t i = 0; i < num_draft; ++i) {
+          stats_->on_sampling_begin();
+          draft_data = draft_decoder_runner_->logits_to_token(draft_logits);
+          stats_->on_sampling_end();
+          verify_data.push_back(draft_data);
+          if (i + 1 == num_draft ||
+              eos_ids_->find(draft_data) != eos_ids_->end()) {
+            break;
+          }
+          draft_pos_data = draft_pos++;
+          draft_logits = ET_UNWRAP(draft_decoder_runner_->step(
+              draft_tokens_managed, draft_start_pos_managed));
+        }
+      }
+
+      // Run the verifier on the last token and the draft tokens at once.
+      const int32_t num_verify = verify_data.size();
+      verify_pos_data = pos;
+      ManagedTensor verify_tokens_managed(
+          verify_data.data(), {1, num_verify}, ScalarType::Long);
+      stats_->on_step_begin();
+      Result<exec_aten::Tensor> logits_res = verifier_decoder_runner_->step(
+          verify_tokens_managed, verify_start_pos_managed);
+      stats_->on_step_end();
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+      exec_aten::Tensor& logits_tensor = logits_res.get();
+      ET_CHECK_OR_RETURN_ERROR(
+          logits_tensor.dim() == 3 && logits_tensor.size(1) == num_verify,
+          InvalidArgument,
+          "The verifier model must return the logits of all %d input tokens",
+          num_verify);
+      num_proposed += num_verify - 1;
+
+      for (int32_t i = 0; i < num_verify; ++i) {
+        prev_token = cur_token;
+
+        stats_->on_sampling_begin();
+        cur_token = verifier_decoder_runner_->logits_to_token(logits_tensor, i);
+        stats_->on_sampling_end();
+
+        tokens.push_back(cur_token);
+        pos++;
+
+        // print the token as string, decode it with the Tokenizer object
+        stats_->on_decode_begin();
+        text = ET_UNWRAP(detokenizer_.next(prev_token, cur_token));
+        stats_->on_decode_end();
+        if (!text.empty()) {
+          token_callback(text);
+        }
+        stats_->on_token_generated();
+
+        if (should_stop_) {
+          done = true;
+          break;
+        }
+
+        // data-dependent terminating condition: we have n_eos_ number of EOS
+        if (eos_ids_->find(cur_token) != eos_ids_->end()) {
+          printf("\n");
+          ET_LOG(Info, "\nReached to the end of generation");
+          done = true;
+          break;
+        }
+
+        // Stop at the first draft token the verifier disagrees with.
+        if (i + 1 == num_verify || cur_token != verify_data[i + 1]) {
+          break;
+        }
+        num_accepted++;
+      }
+      // The draft kv cache only stays valid up to the first rejected token.
+      draft_pos = std::min(draft_pos, pos);
+    }
+    ET_LOG(
+        Info,
+        "Accepted %" PRId64 " of %" PRId64 " draft tokens",
+        num_accepted,
+        num_proposed);
+    return pos - start_pos;
+  }
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+ private:
+  Tokenizer* tokenizer_;
+  IncrementalDetokenizer detokenizer_;
+  TextDecoderRunner* draft_decoder_runner_;
+  TextDecoderRunner* verifier_decoder_runner_;
+  int32_t num_draft_tokens_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+} // namespace torch::executor
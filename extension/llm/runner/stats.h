@@ -8,6 +8,7 @@
 
 // Runner stats for LLM
 #pragma once
+#include <executorch/extension/llm/runner/latency_histogram.h>
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/runtime/platform/log.h>
 #include <cinttypes>
@@ -40,18 +41,62 @@ struct Stats {
   int64_t num_prompt_tokens;
   // Token count from generated (total - prompt)
   int64_t num_generated_tokens;
+  // Per-token latencies in microseconds, across all generations.
+  // inter_token_latency_us: Between consecutive tokens of a generation.
+  LatencyHistogram inter_token_latency_us;
+  // step_latency_us: Running the model, per step of token generation. With
+  // speculative decoding, only the steps of the verifier model.
+  LatencyHistogram step_latency_us;
+  // sampling_latency_us: Sampling a token from the logits.
+  LatencyHistogram sampling_latency_us;
+  // decode_latency_us: Decoding a generated token into text.
+  LatencyHistogram decode_latency_us;
   inline void on_sampling_begin() {
     aggregate_sampling_timer_start_timestamp =
         ::torch::executor::util::time_in_ms();
+    sampling_timer_start_us = ::torch::executor::util::time_in_us();
   }
   inline void on_sampling_end() {
     aggregate_sampling_time_ms += ::torch::executor::util::time_in_ms() -
         aggregate_sampling_timer_start_timestamp;
     aggregate_sampling_timer_start_timestamp = 0;
+    sampling_latency_us.record(
+        ::torch::executor::util::time_in_us() - sampling_timer_start_us);
+  }
+  inline void on_step_begin() {
+    step_timer_start_us = ::torch::executor::util::time_in_us();
+  }
+  inline void on_step_end() {
+    step_latency_us.record(
+        ::torch::executor::util::time_in_us() - step_timer_start_us);
+  }
+  inline void on_decode_begin() {
+    decode_timer_start_us = ::torch::executor::util::time_in_us();
+  }
+  inline void on_decode_end() {
+    decode_latency_us.record(
+        ::torch::executor::util::time_in_us() - decode_timer_start_us);
+  }
+  // Starts a new generation, whose first token has no latency to the
+  // previous one.
+  inline void on_generation_begin() {
+    last_token_us = 0;
+  }
+  // Called when a token of the generation is emitted.
+  inline void on_token_generated() {
+    const long now_us = ::torch::executor::util::time_in_us();
+    if (last_token_us != 0) {
+      inter_token_latency_us.record(now_us - last_token_us);
+    }
+    last_token_us = now_us;
   }
 
  private:
   long aggregate_sampling_timer_start_timestamp = 0;
+  long sampling_timer_start_us = 0;
+  long step_timer_start_us = 0;
+  long decode_timer_start_us = 0;
+  long last_token_us = 0;
 };
 
 static constexpr auto kTopp = 0.9f;
@@ -68,7 +113,14 @@ inline std::string stats_to_json_string(const Stats& stats) {
      << "\"first_token_ms\":" << stats.first_token_ms << ","
      << "\"aggregate_sampling_time_ms\":" << stats.aggregate_sampling_time_ms
      << "," << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
-     << stats.SCALING_FACTOR_UNITS_PER_SECOND << "}";
+     << stats.SCALING_FACTOR_UNITS_PER_SECOND << ","
+     << "\"inter_token_latency_us\":"
+     << stats.inter_token_latency_us.to_json_string() << ","
+     << "\"step_latency_us\":" << stats.step_latency_us.to_json_string()
+     << "," << "\"sampling_latency_us\":"
+     << stats.sampling_latency_us.to_json_string() << ","
+     << "\"decode_latency_us\":" << stats.decode_latency_us.to_json_string()
+     << "}";
   return ss.str();
 }
 
@@ -130,6 +182,22 @@ inline void print_report(const Stats& stats) {
       stats.num_prompt_tokens + stats.num_generated_tokens,
       (double)stats.aggregate_sampling_time_ms /
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
+
+  ET_LOG(
+      Info,
+      "\tInter-token latency:\tp50 %" PRIu64 "\tp90 %" PRIu64 "\tp99 %" PRIu64
+      "\tmax %" PRIu64 " (microseconds)",
+      stats.inter_token_latency_us.percentile(50),
+      stats.inter_token_latency_us.percentile(90),
+      stats.inter_token_latency_us.percentile(99),
+      stats.inter_token_latency_us.max());
+
+  ET_LOG(
+      Info,
+      "\tModel step / sampling / decode time:\t%f / %f / %f (seconds)",
+      stats.step_latency_us.sum() / 1e6,
+      stats.sampling_latency_us.sum() / 1e6,
+      stats.decode_latency_us.sum() / 1e6);
 }
 
 } // namespace executorch::llm
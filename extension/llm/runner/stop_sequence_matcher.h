@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Detect stop sequences in the generated tokens.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace torch::executor {
+
+/**
+ * Matches the generated tokens against a set of stop sequences of token ids,
+ * one token at a time. This is an Aho-Corasick automaton over token ids, so
+ * each token costs an amortized constant number of lookups however many stop
+ * sequences there are and however long they are, and sequences that overlap
+ * or are suffixes of each other are all found.
+ */
+class StopSequenceMatcher {
+ public:
+  StopSequenceMatcher() : nodes_(1) {}
+
+  /**
+   * @param stop_sequences The token ids of each stop sequence. Empty sequences
+   * are ignored.
+   */
+  explicit StopSequenceMatcher(
+      const std::vector<std::vector<uint64_t>>& stop_sequences)
+      : nodes_(1) {
+    for (const auto& sequence : stop_sequences) {
+      if (sequence.empty()) {
+        continue;
+      }
+      int32_t node = 0;
+      for (uint64_t token : sequence) {
+        auto it = nodes_[node].children.find(token);
+        if (it == nodes_[node].children.end()) {
+          it = nodes_[node].children.emplace(token, nodes_.size()).first;
+          nodes_.emplace_back();
+        }
+        node = it->second;
+      }
+      nodes_[node].match_length = sequence.size();
+    }
+    build_failure_links();
+  }
+
+  /**
+   * Whether there is no stop sequence to match.
+   */
+  bool empty() const {
+    return nodes_.size() == 1;
+  }
+
+  /**
+   * Forget the tokens seen so far, e.g. at the start of a generation.
+   */
+  void reset() {
+    state_ = 0;
+  }
+
+  /**
+   * Feed the next token.
+   * @return The length of the longest stop sequence that ends with this
+   * token, or 0 if none does.
+   */
+  size_t next(uint64_t token) {
+    while (true) {
+      const auto& children = nodes_[state_].children;
+      const auto it = children.find(token);
+      if (it != children.end()) {
+        state_ = it->second;
+        break;
+      }
+      if (state_ == 0) {
+        break;
+      }
+      state_ = nodes_[state_].failure;
+    }
+    return nodes_[state_].match_length;
+  }
+
+ private:
+  struct Node {
+    std::unordered_map<uint64_t, int32_t> children;
+    // The node of the longest proper suffix of this node's tokens that is a
+    // prefix of some stop sequence.
+    int32_t failure = 0;
+    // The length of the longest stop sequence that is a suffix of this
+    // node's tokens.
+    size_t match_length = 0;
+  };
+
+  // Visits the nodes by depth so that the failure link of each node is known
+  // before the ones of its children.
+  void build_failure_links() {
+    std::deque<int32_t> queue;
+    for (const auto& [token, child] : nodes_[0].children) {
+      queue.push_back(child);
+    }
+    while (!queue.empty()) {
+      const int32_t node = queue.front();
+      queue.pop_front();
+      for (const auto& [token, child] : nodes_[node].children) {
+        int32_t failure = nodes_[node].failure;
+        while (true) {
+          const auto& children = nodes_[failure].children;
+          const auto it = children.find(token);
+          if (it != children.end()) {
+            failure = it->second;
+            break;
+          }
+          if (failure == 0) {
+            break;
+          }
+          failure = nodes_[failure].failure;
+        }
+        nodes_[child].failure = failure;
+        nodes_[child].match_length = std::max(
+            nodes_[child].match_length, nodes_[failure].match_length);
+        queue.push_back(child);
+      }
+    }
+  }
+
+  std::vector<Node> nodes_;
+  int32_t state_ = 0;
+};
+
+} // namespace torch::executor
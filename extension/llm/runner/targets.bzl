@@ -1,9 +1,37 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
 def define_common_targets():
+    runtime.cxx_library(
+        name = "benchmark",
+        exported_headers = ["benchmark.h"],
+        exported_deps = [
+            ":stats",
+        ],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "prefix_cache",
+        exported_headers = ["prefix_cache.h"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "stop_sequence_matcher",
+        exported_headers = ["stop_sequence_matcher.h"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     runtime.cxx_library(
         name = "stats",
         exported_headers = [
+            "latency_histogram.h",
             "stats.h",
             "util.h",
         ],
@@ -15,6 +43,18 @@ def define_common_targets():
     for aten in (True, False):
         aten_suffix = "_aten" if aten else ""
 
+        runtime.cxx_library(
+            name = "logits_processor" + aten_suffix,
+            exported_headers = ["logits_processor.h"],
+            srcs = ["logits_processor.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "text_decoder_runner" + aten_suffix,
             exported_headers = ["text_decoder_runner.h"],
@@ -23,6 +63,7 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":logits_processor" + aten_suffix,
                 ":stats",
                 "//executorch/extension/llm/sampler:sampler" + aten_suffix,
                 "//executorch/extension/module:module" + aten_suffix,
@@ -39,6 +80,7 @@ def define_common_targets():
             ],
             exported_deps = [
                 ":text_decoder_runner" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:incremental_detokenizer",
                 "//executorch/extension/llm/tokenizer:tokenizer_header",
                 "//executorch/extension/module:module" + aten_suffix,
                 "//executorch/extension/runner_util:managed_tensor" + aten_suffix,
@@ -51,8 +93,42 @@ def define_common_targets():
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
+            exported_deps = [
+                ":stop_sequence_matcher",
+                ":text_decoder_runner" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:incremental_detokenizer",
+                "//executorch/extension/llm/tokenizer:tokenizer_header",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/runner_util:managed_tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "batched_text_generator" + aten_suffix,
+            exported_headers = ["batched_text_generator.h"],
+            srcs = ["batched_text_generator.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                "//executorch/extension/llm/sampler:sampler" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:incremental_detokenizer",
+                "//executorch/extension/llm/tokenizer:tokenizer_header",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/runner_util:managed_tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "speculative_token_generator" + aten_suffix,
+            exported_headers = ["speculative_token_generator.h"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
             exported_deps = [
                 ":text_decoder_runner" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:incremental_detokenizer",
                 "//executorch/extension/llm/tokenizer:tokenizer_header",
                 "//executorch/extension/module:module" + aten_suffix,
                 "//executorch/extension/runner_util:managed_tensor" + aten_suffix,
@@ -90,7 +166,10 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":batched_text_generator" + aten_suffix,
                 ":image_prefiller" + aten_suffix,
+                ":prefix_cache",
+                ":speculative_token_generator" + aten_suffix,
                 ":text_decoder_runner" + aten_suffix,
                 ":text_prefiller" + aten_suffix,
                 ":text_token_generator" + aten_suffix,
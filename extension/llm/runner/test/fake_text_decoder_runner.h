@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Stand-ins for the tokenizer and the model of the LLM runner components.
+
+#pragma once
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+#include <executorch/extension/runner_util/managed_tensor.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace torch::executor::testing {
+
+/// Decodes token i into the text "<i> ".
+class FakeTokenizer : public Tokenizer {
+ public:
+  FakeTokenizer(int32_t vocab_size, uint64_t bos_tok, uint64_t eos_tok) {
+    vocab_size_ = vocab_size;
+    bos_tok_ = bos_tok;
+    eos_tok_ = eos_tok;
+    initialized_ = true;
+  }
+
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return Error::NotSupported;
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    ET_CHECK_OK_OR_RETURN_ERROR(decode_verify(token));
+    return std::to_string(token) + " ";
+  }
+};
+
+/**
+ * A model whose row `row` predicts `next_token(row, pos)` as the token at
+ * position `pos`, whatever the tokens before it. Every step returns the
+ * logits of all of its input tokens, and is recorded. Tokens are sampled
+ * greedily.
+ */
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  struct Step {
+    // The input tokens of each row.
+    std::vector<std::vector<uint64_t>> tokens;
+    int64_t start_pos;
+  };
+
+  FakeTextDecoderRunner(
+      int32_t vocab_size,
+      std::function<uint64_t(int64_t row, int64_t pos)> next_token)
+      : TextDecoderRunner(
+            /*module=*/nullptr,
+            /*use_kv_cache=*/true,
+            vocab_size,
+            /*temperature=*/0.0f),
+        vocab_size_(vocab_size),
+        next_token_(std::move(next_token)) {}
+
+  Result<exec_aten::Tensor> step(
+      ManagedTensor& managed_tokens,
+      ManagedTensor& managed_start_pos) override {
+    const exec_aten::Tensor tokens = managed_tokens.get_aliasing_tensor();
+    const int64_t start_pos =
+        managed_start_pos.get_aliasing_tensor().const_data_ptr<int64_t>()[0];
+    const int32_t num_rows = tokens.size(0);
+    const int32_t num_tokens = tokens.size(1);
+
+    Step step{{}, start_pos};
+    logits_.assign(num_rows * num_tokens * vocab_size_, 0.0f);
+    for (int32_t row = 0; row < num_rows; ++row) {
+      step.tokens.emplace_back();
+      for (int32_t i = 0; i < num_tokens; ++i) {
+        const int64_t index = row * num_tokens + i;
+        step.tokens.back().push_back(tokens.const_data_ptr<int64_t>()[index]);
+        // The logits of a token predict the one after it.
+        logits_[index * vocab_size_ + next_token_(row, start_pos + i + 1)] =
+            1.0f;
+      }
+    }
+    steps_.push_back(std::move(step));
+
+    managed_logits_ = std::make_unique<ManagedTensor>(
+        logits_.data(),
+        std::vector<exec_aten::SizesType>{num_rows, num_tokens, vocab_size_},
+        ScalarType::Float);
+    return managed_logits_->get_aliasing_tensor();
+  }
+
+  Error load() override {
+    return Error::Ok;
+  }
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  const std::vector<Step>& steps() const {
+    return steps_;
+  }
+
+ private:
+  int32_t vocab_size_;
+  std::function<uint64_t(int64_t, int64_t)> next_token_;
+  std::vector<Step> steps_;
+  std::vector<float> logits_;
+  std::unique_ptr<ManagedTensor> managed_logits_;
+};
+
+} // namespace torch::executor::testing
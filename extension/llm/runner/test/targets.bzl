@@ -0,0 +1,97 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_test(
+        name = "test_benchmark",
+        srcs = [
+            "test_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:benchmark",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_logits_processor",
+        srcs = [
+            "test_logits_processor.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:logits_processor",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_latency_histogram",
+        srcs = [
+            "test_latency_histogram.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:stats",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_stop_sequence_matcher",
+        srcs = [
+            "test_stop_sequence_matcher.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:stop_sequence_matcher",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "fake_text_decoder_runner",
+        exported_headers = [
+            "fake_text_decoder_runner.h",
+        ],
+        visibility = [
+            "//executorch/extension/llm/runner/test/...",
+        ],
+        exported_deps = [
+            "//executorch/extension/llm/runner:text_decoder_runner",
+            "//executorch/extension/llm/tokenizer:tokenizer_header",
+            "//executorch/extension/runner_util:managed_tensor",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_speculative_token_generator",
+        srcs = [
+            "test_speculative_token_generator.cpp",
+        ],
+        deps = [
+            ":fake_text_decoder_runner",
+            "//executorch/extension/llm/runner:speculative_token_generator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_batched_text_generator",
+        srcs = [
+            "test_batched_text_generator.cpp",
+        ],
+        deps = [
+            ":fake_text_decoder_runner",
+            "//executorch/extension/llm/runner:batched_text_generator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_prefix_cache",
+        srcs = [
+            "test_prefix_cache.cpp",
+        ],
+        deps = [
+            ":fake_text_decoder_runner",
+            "//executorch/extension/llm/runner:prefix_cache",
+            "//executorch/extension/llm/runner:text_prefiller",
+        ],
+    )
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/batched_text_generator.h>
+#include <executorch/extension/llm/runner/test/fake_text_decoder_runner.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace ::testing;
+using ::torch::executor::BatchedTextGenerator;
+using ::torch::executor::Error;
+using ::torch::executor::Stats;
+using ::torch::executor::testing::FakeTextDecoderRunner;
+using ::torch::executor::testing::FakeTokenizer;
+
+namespace {
+
+constexpr int32_t kVocabSize = 100;
+constexpr uint64_t kBos = 1;
+constexpr uint64_t kEos = 2;
+
+// Row 0 generates 20 + pos and row 1 generates 40 + pos.
+uint64_t row_token(int64_t row, int64_t pos) {
+  return 20 * (row + 1) + pos;
+}
+
+class BatchedTextGeneratorTest : public Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Generates from `prompts` through `runner` with parallel prefill, keeping
+  // the text of each sequence.
+  std::vector<int64_t> generate(
+      FakeTextDecoderRunner& runner,
+      int32_t batch_size,
+      const std::vector<std::vector<uint64_t>>& prompts,
+      int32_t seq_len) {
+    BatchedTextGenerator generator(
+        &tokenizer_,
+        &runner,
+        batch_size,
+        kVocabSize,
+        /*temperature=*/0.0f,
+        /*enable_parallel_prefill=*/true,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{kEos}),
+        &stats_);
+    texts_.assign(prompts.size(), "");
+    auto result = generator.generate(
+        prompts, seq_len, [this](int32_t seq, std::string_view piece) {
+          texts_[seq] += piece;
+        });
+    EXPECT_EQ(result.error(), Error::Ok);
+    return result.ok() ? result.get() : std::vector<int64_t>();
+  }
+
+  FakeTokenizer tokenizer_{kVocabSize, kBos, kEos};
+  Stats stats_;
+  std::vector<std::string> texts_;
+};
+
+} // namespace
+
+TEST_F(BatchedTextGeneratorTest, PromptsOfDifferentLengthsAdvanceTogether) {
+  FakeTextDecoderRunner runner(kVocabSize, row_token);
+
+  // Three rows for two prompts, so the last row is unused.
+  EXPECT_EQ(
+      generate(runner, /*batch_size=*/3, {{3, 4, 5, 6}, {7, 8}}, /*seq_len=*/7),
+      (std::vector<int64_t>{3, 5}));
+  EXPECT_EQ(texts_, (std::vector<std::string>{"24 25 26 ", "42 43 44 45 46 "}));
+
+  // The first step prefills the positions both prompts have. Then the longer
+  // prompt keeps feeding its own tokens while the shorter one feeds what it
+  // sampled, and the unused row feeds BOS.
+  const auto& steps = runner.steps();
+  ASSERT_EQ(steps.size(), 5);
+  std::vector<int64_t> start_positions;
+  for (const auto& step : steps) {
+    start_positions.push_back(step.start_pos);
+  }
+  EXPECT_EQ(start_positions, (std::vector<int64_t>{0, 2, 3, 4, 5}));
+  using Rows = std::vector<std::vector<uint64_t>>;
+  EXPECT_EQ(steps[0].tokens, (Rows{{3, 4}, {7, 8}, {kBos, kBos}}));
+  EXPECT_EQ(steps[1].tokens, (Rows{{5}, {42}, {kBos}}));
+  EXPECT_EQ(steps[2].tokens, (Rows{{6}, {43}, {kBos}}));
+  EXPECT_EQ(steps[3].tokens, (Rows{{24}, {44}, {kBos}}));
+  EXPECT_EQ(steps[4].tokens, (Rows{{25}, {45}, {kBos}}));
+}
+
+TEST_F(BatchedTextGeneratorTest, SequenceStoppedAtEosLetsTheOthersContinue) {
+  // Row 1 ends its sequence at position 4.
+  FakeTextDecoderRunner runner(kVocabSize, [](int64_t row, int64_t pos) {
+    return row == 1 && pos == 4 ? kEos : row_token(row, pos);
+  });
+
+  EXPECT_EQ(
+      generate(runner, /*batch_size=*/2, {{3, 4, 5, 6}, {7, 8}}, /*seq_len=*/7),
+      (std::vector<int64_t>{3, 3}));
+  EXPECT_EQ(texts_, (std::vector<std::string>{"24 25 26 ", "42 43 2 "}));
+
+  // The stopped row keeps feeding EOS while row 0 finishes.
+  const auto& steps = runner.steps();
+  ASSERT_EQ(steps.size(), 5);
+  using Rows = std::vector<std::vector<uint64_t>>;
+  EXPECT_EQ(steps[3].tokens, (Rows{{24}, {kEos}}));
+  EXPECT_EQ(steps[4].tokens, (Rows{{25}, {kEos}}));
+}
+
+TEST_F(BatchedTextGeneratorTest, StopsOnceEverySequenceIsDone) {
+  // Row 1 ends its sequence at position 4 and row 0 at position 5.
+  FakeTextDecoderRunner runner(kVocabSize, [](int64_t row, int64_t pos) {
+    return (row == 1 && pos == 4) || (row == 0 && pos == 5)
+        ? kEos
+        : row_token(row, pos);
+  });
+
+  EXPECT_EQ(
+      generate(
+          runner, /*batch_size=*/2, {{3, 4, 5, 6}, {7, 8}}, /*seq_len=*/20),
+      (std::vector<int64_t>{2, 3}));
+  EXPECT_EQ(texts_, (std::vector<std::string>{"24 2 ", "42 43 2 "}));
+  EXPECT_EQ(runner.steps().size(), 4);
+}
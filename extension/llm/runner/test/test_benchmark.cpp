@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/benchmark.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::llm::BenchmarkResult;
+using ::executorch::llm::MetricSummary;
+using ::executorch::llm::Stats;
+
+namespace {
+
+Stats make_stats(
+    long prefill_ms,
+    long decode_ms,
+    int64_t num_prompt_tokens,
+    int64_t num_generated_tokens) {
+  Stats stats;
+  stats.model_load_start_ms = 100;
+  stats.model_load_end_ms = 150;
+  stats.inference_start_ms = 1000;
+  stats.prompt_eval_end_ms = 1000 + prefill_ms;
+  stats.first_token_ms = 1000 + prefill_ms;
+  stats.inference_end_ms = 1000 + prefill_ms + decode_ms;
+  stats.aggregate_sampling_time_ms = 0;
+  stats.num_prompt_tokens = num_prompt_tokens;
+  stats.num_generated_tokens = num_generated_tokens;
+  return stats;
+}
+
+} // namespace
+
+TEST(MetricSummaryTest, EmptySummaryIsNull) {
+  MetricSummary summary;
+  EXPECT_EQ(summary.count(), 0);
+  EXPECT_EQ(summary.mean(), 0);
+  EXPECT_EQ(summary.to_json_string(), "null");
+}
+
+TEST(MetricSummaryTest, TracksMinMeanMax) {
+  MetricSummary summary;
+  for (double value : {4.0, 1.0, 7.0}) {
+    summary.add(value);
+  }
+  EXPECT_EQ(summary.count(), 3);
+  EXPECT_EQ(summary.min(), 1.0);
+  EXPECT_EQ(summary.mean(), 4.0);
+  EXPECT_EQ(summary.max(), 7.0);
+  EXPECT_EQ(summary.to_json_string(), "{\"min\":1,\"mean\":4,\"max\":7}");
+}
+
+TEST(BenchmarkResultTest, ComputesRatesFromStats) {
+  BenchmarkResult result(32, 64);
+  result.add(make_stats(100, 1000, 33, 64));
+  result.add(make_stats(200, 500, 33, 64));
+  EXPECT_EQ(result.num_runs(), 2);
+  EXPECT_EQ(result.ttft_ms().min(), 100);
+  EXPECT_EQ(result.ttft_ms().max(), 200);
+  EXPECT_EQ(result.prefill_tokens_per_s().max(), 330);
+  EXPECT_EQ(result.prefill_tokens_per_s().min(), 165);
+  EXPECT_EQ(result.decode_tokens_per_s().min(), 64);
+  EXPECT_EQ(result.decode_tokens_per_s().max(), 128);
+  result.set_peak_rss_bytes(4096);
+  EXPECT_EQ(
+      result.to_json_string(),
+      "{\"prompt_length\":32,\"generation_length\":64,\"runs\":2,"
+      "\"prompt_tokens\":33,\"generated_tokens\":64,\"model_load_ms\":50,"
+      "\"ttft_ms\":{\"min\":100,\"mean\":150,\"max\":200},"
+      "\"prefill_tokens_per_s\":{\"min\":165,\"mean\":247.5,\"max\":330},"
+      "\"decode_tokens_per_s\":{\"min\":64,\"mean\":96,\"max\":128},"
+      "\"peak_rss_bytes\":4096}");
+}
+
+TEST(BenchmarkResultTest, SkipsRatesOfPhasesBelowTheClockResolution) {
+  BenchmarkResult result(8, 8);
+  result.add(make_stats(0, 0, 9, 8));
+  EXPECT_EQ(result.num_runs(), 1);
+  EXPECT_EQ(result.prefill_tokens_per_s().count(), 0);
+  EXPECT_EQ(result.decode_tokens_per_s().count(), 0);
+  EXPECT_NE(
+      result.to_json_string().find("\"decode_tokens_per_s\":null"),
+      std::string::npos);
+}
+
+TEST(BenchmarkResultTest, PeakRssIsAvailable) {
+#if defined(__linux__) || defined(__APPLE__)
+  EXPECT_GT(::executorch::llm::peak_rss_bytes(), 0);
+#endif
+}
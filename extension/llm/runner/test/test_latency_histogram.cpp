@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/latency_histogram.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::llm::LatencyHistogram;
+
+TEST(LatencyHistogramTest, EmptyHistogramHasNoPercentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.percentile(50), 0);
+  EXPECT_EQ(
+      histogram.to_json_string(),
+      "{\"count\":0,\"sum\":0,\"max\":0,\"p50\":0,\"p90\":0,\"p99\":0,"
+      "\"buckets\":[]}");
+}
+
+TEST(LatencyHistogramTest, BucketsCoverAllValues) {
+  for (uint64_t value : {0, 1, 7, 8, 9, 15, 16, 17, 1000, 123456789}) {
+    size_t index = LatencyHistogram::bucket_index(value);
+    EXPECT_LE(LatencyHistogram::bucket_lower_bound(index), value);
+    EXPECT_GT(LatencyHistogram::bucket_upper_bound(index), value);
+  }
+  EXPECT_EQ(
+      LatencyHistogram::bucket_index(UINT64_MAX),
+      LatencyHistogram::kNumBuckets - 1);
+  for (size_t i = 1; i < LatencyHistogram::kNumBuckets; ++i) {
+    EXPECT_EQ(
+        LatencyHistogram::bucket_index(LatencyHistogram::bucket_lower_bound(i)),
+        i);
+  }
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinABucket) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+  EXPECT_EQ(histogram.count(), 1000);
+  EXPECT_EQ(histogram.sum(), 500500);
+  EXPECT_EQ(histogram.max(), 1000);
+  for (double percent : {50.0, 90.0, 99.0}) {
+    const uint64_t expected = static_cast<uint64_t>(percent * 10);
+    const uint64_t actual = histogram.percentile(percent);
+    EXPECT_GE(actual, expected);
+    EXPECT_LE(actual, expected + expected / 8);
+  }
+  EXPECT_EQ(histogram.percentile(100), 1000);
+}
+
+TEST(LatencyHistogramTest, TailIsNotHiddenByTheMedian) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 98; ++i) {
+    histogram.record(10);
+  }
+  histogram.record(5000);
+  histogram.record(5000);
+  EXPECT_EQ(histogram.percentile(50), 10);
+  EXPECT_EQ(histogram.percentile(90), 10);
+  EXPECT_GE(histogram.percentile(99), 5000);
+  EXPECT_EQ(histogram.max(), 5000);
+}
+
+TEST(LatencyHistogramTest, ResetClearsEverything) {
+  LatencyHistogram histogram;
+  histogram.record(42);
+  LatencyHistogram copy(histogram);
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.max(), 0);
+  EXPECT_EQ(copy.count(), 1);
+  EXPECT_EQ(copy.max(), 42);
+}
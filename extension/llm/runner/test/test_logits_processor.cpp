@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/logits_processor.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using ::torch::executor::LogitBiasProcessor;
+using ::torch::executor::TokenBitmaskProcessor;
+
+namespace {
+
+std::vector<float> make_logits(int32_t vocab_size) {
+  std::vector<float> logits(vocab_size);
+  for (int32_t i = 0; i < vocab_size; ++i) {
+    logits[i] = static_cast<float>(i);
+  }
+  return logits;
+}
+
+} // namespace
+
+TEST(LogitsProcessorTest, BiasAddsToTokens) {
+  LogitBiasProcessor processor;
+  processor.set_bias(1, 10.0f);
+  processor.set_bias(2, -INFINITY);
+  processor.set_bias(1, 0.5f);
+  // Out of range tokens are ignored.
+  processor.set_bias(4, 1.0f);
+
+  std::vector<float> logits = make_logits(4);
+  processor.process(logits.data(), logits.size());
+  EXPECT_EQ(logits, (std::vector<float>{0.0f, 1.5f, -INFINITY, 3.0f}));
+
+  processor.clear();
+  logits = make_logits(4);
+  processor.process(logits.data(), logits.size());
+  EXPECT_EQ(logits, make_logits(4));
+}
+
+TEST(LogitsProcessorTest, BitmaskMasksOutDisallowedTokens) {
+  // Three words, the last of them partial.
+  constexpr int32_t kVocabSize = 70;
+  TokenBitmaskProcessor processor(kVocabSize);
+  EXPECT_EQ(processor.bitmask_size(), 3);
+
+  // Everything is allowed at first.
+  std::vector<float> logits = make_logits(kVocabSize);
+  processor.process(logits.data(), kVocabSize);
+  EXPECT_EQ(logits, make_logits(kVocabSize));
+
+  processor.disallow_all();
+  processor.allow(3);
+  processor.allow(40);
+  processor.allow(69);
+  logits = make_logits(kVocabSize);
+  processor.process(logits.data(), kVocabSize);
+  for (int32_t i = 0; i < kVocabSize; ++i) {
+    if (i == 3 || i == 40 || i == 69) {
+      EXPECT_EQ(logits[i], i);
+    } else {
+      EXPECT_EQ(logits[i], -INFINITY) << "token " << i;
+    }
+  }
+
+  // A grammar engine fills the words in place.
+  processor.allow_all();
+  processor.mutable_bitmask()[1] = 0;
+  logits = make_logits(kVocabSize);
+  processor.process(logits.data(), kVocabSize);
+  for (int32_t i = 0; i < kVocabSize; ++i) {
+    EXPECT_EQ(logits[i], i >= 32 && i < 64 ? -INFINITY : i);
+  }
+}
+
+TEST(LogitsProcessorTest, BitmaskMasksOutTokensPastItsVocabulary) {
+  // The model may pad its vocabulary past the one of the tokenizer.
+  TokenBitmaskProcessor processor(10);
+  std::vector<float> logits = make_logits(16);
+  processor.process(logits.data(), logits.size());
+  for (int32_t i = 0; i < 16; ++i) {
+    EXPECT_EQ(logits[i], i < 10 ? i : -INFINITY);
+  }
+}
+
+TEST(LogitsProcessorTest, ConvertsReducedPrecisionLogits) {
+  std::vector<exec_aten::Half> half_logits = {
+      exec_aten::Half(1.5f), exec_aten::Half(-2.0f)};
+  std::vector<float> logits(2);
+  ::torch::executor::logits_to_float(half_logits.data(), 2, logits.data());
+  EXPECT_EQ(logits, (std::vector<float>{1.5f, -2.0f}));
+
+  // 0x3FC0 is 1.5 and 0xC000 is -2 in bfloat16.
+  std::vector<exec_aten::BFloat16> bf16_logits(2);
+  bf16_logits[0].x = 0x3FC0;
+  bf16_logits[1].x = 0xC000;
+  ::torch::executor::logits_to_float(bf16_logits.data(), 2, logits.data());
+  EXPECT_EQ(logits, (std::vector<float>{1.5f, -2.0f}));
+}
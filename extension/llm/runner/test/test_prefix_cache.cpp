@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/prefix_cache.h>
+#include <executorch/extension/llm/runner/test/fake_text_decoder_runner.h>
+#include <executorch/extension/llm/runner/text_prefiller.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using ::torch::executor::Error;
+using ::torch::executor::PrefixCache;
+using ::torch::executor::TextPrefiller;
+using ::torch::executor::testing::FakeTextDecoderRunner;
+using ::torch::executor::testing::FakeTokenizer;
+
+TEST(PrefixCacheTest, FullMatchLeavesTheLastTokenToPrefill) {
+  PrefixCache cache;
+  cache.update({1, 5, 6, 7}, 0);
+  EXPECT_EQ(cache.match({1, 5, 6, 7}), 3);
+  // Also when the cache holds more tokens than the prompt.
+  EXPECT_EQ(cache.match({1, 5, 6}), 2);
+}
+
+TEST(PrefixCacheTest, PartialMatchStopsAtTheFirstDifference) {
+  PrefixCache cache;
+  cache.update({1, 5, 6, 7}, 0);
+  EXPECT_EQ(cache.match({1, 5, 9, 7, 8}), 2);
+  EXPECT_EQ(cache.match({1, 5, 6, 7, 8, 9}), 4);
+}
+
+TEST(PrefixCacheTest, NoMatch) {
+  PrefixCache cache;
+  EXPECT_EQ(cache.match({1, 5}), 0);
+  cache.update({1, 5, 6, 7}, 0);
+  EXPECT_EQ(cache.match({2, 5, 6, 7}), 0);
+  EXPECT_EQ(cache.match({}), 0);
+}
+
+TEST(PrefixCacheTest, UpdateDropsTheTokensAfterIt) {
+  PrefixCache cache;
+  cache.update({1, 5, 6, 7}, 0);
+  cache.update({8}, 2);
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.match({1, 5, 8, 9}), 3);
+  EXPECT_EQ(cache.match({1, 5, 6, 7}), 2);
+}
+
+TEST(PrefixCacheTest, ResetForgetsAllTokens) {
+  PrefixCache cache;
+  cache.update({1, 5, 6, 7}, 0);
+  cache.reset();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.match({1, 5, 6, 7}), 0);
+}
+
+namespace {
+
+class PrefixCachePrefillTest : public Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Prefills `prompt_tokens` the way the llama runner does with a KV cache:
+  // only the tokens after the cached prefix are fed, from its end.
+  uint64_t prefill(const std::vector<uint64_t>& prompt_tokens) {
+    const int64_t num_cached_tokens = cache_.match(prompt_tokens);
+    std::vector<uint64_t> prefill_tokens(
+        prompt_tokens.begin() + num_cached_tokens, prompt_tokens.end());
+    auto result = prefiller_.prefill(prefill_tokens, num_cached_tokens);
+    EXPECT_EQ(result.error(), Error::Ok);
+    cache_.update(prefill_tokens, num_cached_tokens);
+    return result.ok() ? result.get() : 0;
+  }
+
+  // Predicts 50 + pos at every position.
+  FakeTextDecoderRunner runner_{
+      /*vocab_size=*/100,
+      [](int64_t, int64_t pos) { return 50 + pos; }};
+  FakeTokenizer tokenizer_{/*vocab_size=*/100, /*bos_tok=*/1, /*eos_tok=*/2};
+  TextPrefiller prefiller_{
+      &tokenizer_,
+      &runner_,
+      /*use_kv_cache=*/true,
+      /*enable_parallel_prefill=*/true};
+  PrefixCache cache_;
+};
+
+} // namespace
+
+TEST_F(PrefixCachePrefillTest, OnlyTheNewSuffixIsPrefilled) {
+  EXPECT_EQ(prefill({1, 5, 6, 7}), 54);
+  // Shares 1, 5, 6 with the previous prompt.
+  EXPECT_EQ(prefill({1, 5, 6, 8, 9}), 55);
+  // The same prompt again still prefills its last token for the logits.
+  EXPECT_EQ(prefill({1, 5, 6, 8, 9}), 55);
+  // Nothing in common.
+  EXPECT_EQ(prefill({3, 4}), 52);
+
+  const auto& steps = runner_.steps();
+  ASSERT_EQ(steps.size(), 4);
+  EXPECT_EQ(steps[0].start_pos, 0);
+  EXPECT_EQ(steps[0].tokens[0], (std::vector<uint64_t>{1, 5, 6, 7}));
+  EXPECT_EQ(steps[1].start_pos, 3);
+  EXPECT_EQ(steps[1].tokens[0], (std::vector<uint64_t>{8, 9}));
+  EXPECT_EQ(steps[2].start_pos, 4);
+  EXPECT_EQ(steps[2].tokens[0], (std::vector<uint64_t>{9}));
+  EXPECT_EQ(steps[3].start_pos, 0);
+  EXPECT_EQ(steps[3].tokens[0], (std::vector<uint64_t>{3, 4}));
+}
+
+TEST_F(PrefixCachePrefillTest, ResetPrefillsTheWholePrompt) {
+  prefill({1, 5, 6, 7});
+  cache_.reset();
+  prefill({1, 5, 6, 7});
+
+  const auto& steps = runner_.steps();
+  ASSERT_EQ(steps.size(), 2);
+  EXPECT_EQ(steps[1].start_pos, 0);
+  EXPECT_EQ(steps[1].tokens[0], (std::vector<uint64_t>{1, 5, 6, 7}));
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+#include <executorch/extension/llm/runner/test/fake_text_decoder_runner.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace ::testing;
+using ::torch::executor::Error;
+using ::torch::executor::SpeculativeTokenGenerator;
+using ::torch::executor::Stats;
+using ::torch::executor::testing::FakeTextDecoderRunner;
+using ::torch::executor::testing::FakeTokenizer;
+
+namespace {
+
+constexpr int32_t kVocabSize = 100;
+constexpr uint64_t kEos = 2;
+
+// The prompt tokens 1, 2 and the token 3 from prefill.
+const std::vector<uint64_t> kPromptTokens = {1, 2, 3};
+constexpr int64_t kStartPos = 2;
+
+// The verifier predicts the token 10 + pos at every position after the prompt.
+uint64_t verifier_token(int64_t pos) {
+  return 10 + pos;
+}
+
+std::vector<int64_t> start_positions(const FakeTextDecoderRunner& runner) {
+  std::vector<int64_t> positions;
+  for (const auto& step : runner.steps()) {
+    positions.push_back(step.start_pos);
+  }
+  return positions;
+}
+
+std::vector<std::vector<uint64_t>> step_tokens(
+    const FakeTextDecoderRunner& runner) {
+  std::vector<std::vector<uint64_t>> tokens;
+  for (const auto& step : runner.steps()) {
+    tokens.push_back(step.tokens[0]);
+  }
+  return tokens;
+}
+
+class SpeculativeTokenGeneratorTest : public Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Generates up to seq_len tokens, returning how many were generated.
+  int64_t generate(
+      FakeTextDecoderRunner& draft,
+      FakeTextDecoderRunner& verifier,
+      int32_t num_draft_tokens,
+      int32_t seq_len) {
+    SpeculativeTokenGenerator generator(
+        &tokenizer_,
+        &draft,
+        &verifier,
+        num_draft_tokens,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{kEos}),
+        &stats_);
+    auto result = generator.generate(
+        kPromptTokens, kStartPos, seq_len, [this](std::string_view piece) {
+          text_ += piece;
+        });
+    EXPECT_EQ(result.error(), Error::Ok);
+    return result.ok() ? result.get() : -1;
+  }
+
+  FakeTokenizer tokenizer_{kVocabSize, /*bos_tok=*/1, kEos};
+  Stats stats_;
+  std::string text_;
+};
+
+} // namespace
+
+TEST_F(SpeculativeTokenGeneratorTest, AcceptsDraftsThatMatchTheVerifier) {
+  FakeTextDecoderRunner draft(
+      kVocabSize, [](int64_t, int64_t pos) { return verifier_token(pos); });
+  FakeTextDecoderRunner verifier(
+      kVocabSize, [](int64_t, int64_t pos) { return verifier_token(pos); });
+
+  EXPECT_EQ(
+      generate(draft, verifier, /*num_draft_tokens=*/3, /*seq_len=*/10), 7);
+  EXPECT_EQ(text_, "3 13 14 15 16 17 18 19 ");
+
+  // Each verification yields all of its drafts and one more token. The last
+  // one only has room for 2 drafts.
+  EXPECT_EQ(start_positions(verifier), (std::vector<int64_t>{2, 6}));
+  EXPECT_EQ(
+      step_tokens(verifier),
+      (std::vector<std::vector<uint64_t>>{{3, 13, 14, 15}, {16, 17, 18}}));
+  // The draft model catches up on the token it did not propose before
+  // drafting again.
+  EXPECT_EQ(start_positions(draft), (std::vector<int64_t>{2, 3, 4, 5, 6, 7}));
+  EXPECT_EQ(
+      step_tokens(draft),
+      (std::vector<std::vector<uint64_t>>{{3}, {13}, {14}, {15}, {16}, {17}}));
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, RejectsDraftsFromTheFirstMismatch) {
+  // The draft model gets position 4 wrong.
+  FakeTextDecoderRunner draft(kVocabSize, [](int64_t, int64_t pos) {
+    return pos == 4 ? 99 : verifier_token(pos);
+  });
+  FakeTextDecoderRunner verifier(
+      kVocabSize, [](int64_t, int64_t pos) { return verifier_token(pos); });
+
+  EXPECT_EQ(
+      generate(draft, verifier, /*num_draft_tokens=*/3, /*seq_len=*/10), 7);
+  // The output follows the verifier.
+  EXPECT_EQ(text_, "3 13 14 15 16 17 18 19 ");
+
+  // 13 is accepted, 99 is replaced with 14, and the draft after it dropped.
+  // The next round starts after 14.
+  EXPECT_EQ(start_positions(verifier), (std::vector<int64_t>{2, 4, 8}));
+  EXPECT_EQ(
+      step_tokens(verifier),
+      (std::vector<std::vector<uint64_t>>{
+          {3, 13, 99, 15}, {14, 15, 16, 17}, {18}}));
+  // The draft model is rewound to overwrite 99 with 14 at position 4.
+  EXPECT_EQ(start_positions(draft), (std::vector<int64_t>{2, 3, 4, 4, 5, 6}));
+  EXPECT_EQ(
+      step_tokens(draft),
+      (std::vector<std::vector<uint64_t>>{{3}, {13}, {99}, {14}, {15}, {16}}));
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, StopsDraftingAtEos) {
+  // Both models end the sequence at position 5.
+  auto next_token = [](int64_t, int64_t pos) {
+    return pos == 5 ? kEos : verifier_token(pos);
+  };
+  FakeTextDecoderRunner draft(kVocabSize, next_token);
+  FakeTextDecoderRunner verifier(kVocabSize, next_token);
+
+  EXPECT_EQ(
+      generate(draft, verifier, /*num_draft_tokens=*/4, /*seq_len=*/20), 3);
+  EXPECT_EQ(text_, "3 13 14 2 ");
+
+  // Only 3 of the 4 drafts are proposed, and the draft model is not run on
+  // the EOS token.
+  EXPECT_EQ(
+      step_tokens(verifier),
+      (std::vector<std::vector<uint64_t>>{{3, 13, 14, kEos}}));
+  EXPECT_EQ(
+      step_tokens(draft),
+      (std::vector<std::vector<uint64_t>>{{3}, {13}, {14}}));
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/stop_sequence_matcher.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using ::torch::executor::StopSequenceMatcher;
+
+namespace {
+
+// The match length after each token.
+std::vector<size_t> feed(
+    StopSequenceMatcher& matcher,
+    const std::vector<uint64_t>& tokens) {
+  std::vector<size_t> lengths;
+  for (uint64_t token : tokens) {
+    lengths.push_back(matcher.next(token));
+  }
+  return lengths;
+}
+
+} // namespace
+
+TEST(StopSequenceMatcherTest, EmptyMatcherNeverMatches) {
+  // A single empty sequence.
+  StopSequenceMatcher matcher(std::vector<std::vector<uint64_t>>(1));
+  EXPECT_TRUE(matcher.empty());
+  EXPECT_EQ(feed(matcher, {1, 2, 3}), (std::vector<size_t>{0, 0, 0}));
+}
+
+TEST(StopSequenceMatcherTest, MatchesSequencesAcrossFalseStarts) {
+  StopSequenceMatcher matcher({{5, 5, 7}, {9}});
+  EXPECT_FALSE(matcher.empty());
+  // 5 5 5 7 falls back to the 5 5 prefix after the third 5.
+  EXPECT_EQ(
+      feed(matcher, {1, 5, 5, 5, 7}), (std::vector<size_t>{0, 0, 0, 0, 3}));
+  EXPECT_EQ(feed(matcher, {2, 9}), (std::vector<size_t>{0, 1}));
+}
+
+TEST(StopSequenceMatcherTest, MatchesSequencesThatAreSuffixesOfOthers) {
+  StopSequenceMatcher matcher({{1, 2, 3, 4}, {2, 3}, {3, 4}});
+  // 2 3 ends inside the longer sequence, and 3 4 is a suffix of it.
+  EXPECT_EQ(feed(matcher, {1, 2, 3, 4}), (std::vector<size_t>{0, 0, 2, 4}));
+  EXPECT_EQ(feed(matcher, {8, 3, 4}), (std::vector<size_t>{0, 0, 2}));
+}
+
+TEST(StopSequenceMatcherTest, ResetForgetsPartialMatches) {
+  StopSequenceMatcher matcher({{1, 2}});
+  EXPECT_EQ(matcher.next(1), 0);
+  matcher.reset();
+  EXPECT_EQ(matcher.next(2), 0);
+  EXPECT_EQ(feed(matcher, {1, 2}), (std::vector<size_t>{0, 2}));
+}
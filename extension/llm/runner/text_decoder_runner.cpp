@@ -33,40 +33,30 @@ TextDecoderRunner::TextDecoderRunner(
 // This function is functional, meaning it shouldn't modify any state of the
 // input. It should be safe to call multiple times with the same inputs. The
 // outer loop (call site) is responsible for managing state.
+//
+// The inputs are set on the method directly and the logits are read in place
+// from its outputs, so that a step doesn't build any vectors of EValues.
 Result<exec_aten::Tensor> TextDecoderRunner::step(
     ManagedTensor& managed_tokens,
     ManagedTensor& managed_start_pos) {
-  auto tokens = managed_tokens.get_aliasing_tensor();
   // ET_LOG(Info, "Input token %" PRIu64, input_token);
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      module_->set_input("forward", managed_tokens.get_aliasing_tensor(), 0));
   if (use_kv_cache_) {
-    auto start_pos = managed_start_pos.get_aliasing_tensor();
-    Result<std::vector<EValue>> outputs_res =
-        module_->forward({tokens, start_pos});
-    ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
-    ET_CHECK_MSG(
-        outputs_res.get().size() == 1,
-        "More then one output returned from executing LLM.");
-    ET_CHECK_MSG(
-        outputs_res.get()[0].isTensor(),
-        "Non Tensor Output returned from executing LLM");
-
-    // Return the logits tensor
-    return outputs_res.get()[0].toTensor();
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->set_input(
+        "forward", managed_start_pos.get_aliasing_tensor(), 1));
   } else { // no kv cache
     (void)managed_start_pos; // unused
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(module_->execute_in_place("forward"));
 
-    Result<std::vector<EValue>> outputs_res = module_->forward({tokens});
-    ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
-    ET_CHECK_MSG(
-        outputs_res.get().size() == 1,
-        "More then one output returned from executing LLM.");
-    ET_CHECK_MSG(
-        outputs_res.get()[0].isTensor(),
-        "Non Tensor Output returned from executing LLM");
+  Result<EValue> logits = module_->get_output("forward", 0);
+  ET_CHECK_OK_OR_RETURN_ERROR(logits.error());
+  ET_CHECK_MSG(
+      logits.get().isTensor(), "Non Tensor Output returned from executing LLM");
 
-    // Return the logits tensor
-    return outputs_res.get()[0].toTensor();
-  }
+  // Return the logits tensor
+  return logits.get().toTensor();
 }
 
 } // namespace torch::executor
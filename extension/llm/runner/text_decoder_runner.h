@@ -10,11 +10,20 @@
 
 #pragma once
 
+#include <executorch/extension/llm/runner/logits_processor.h>
 #include <executorch/extension/llm/sampler/sampler.h>
 #include <executorch/extension/module/module.h>
 #include <executorch/extension/runner_util/managed_tensor.h>
 // patternlint-disable-next-line executorch-cpp-nostdinc
+#include <cinttypes>
+// patternlint-disable-next-line executorch-cpp-nostdinc
 #include <functional>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <memory>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <type_traits>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <vector>
 
 namespace torch::executor {
 
@@ -59,6 +68,32 @@ class TextDecoderRunner {
     should_stop_ = true;
   }
 
+  /**
+   * Append a processor to the chain that modifies the logits of each next
+   * token before it is sampled, e.g. to constrain the output to a grammar.
+   * The processors run in the order they were added, on float logits, before
+   * the repetition and frequency penalties of the sampler.
+   * @param processor The processor, which the caller may keep updating.
+   */
+  void add_logits_processor(std::shared_ptr<LogitsProcessor> processor) {
+    logits_processors_.push_back(std::move(processor));
+  }
+
+  /**
+   * Remove all the logits processors.
+   */
+  void clear_logits_processors() {
+    logits_processors_.clear();
+  }
+
+  /**
+   * Replace the sampler, e.g. with one that applies repetition penalties.
+   * @param sampler The new sampler.
+   */
+  void set_sampler(std::unique_ptr<Sampler> sampler) {
+    sampler_ = std::move(sampler);
+  }
+
   /**
    * Sample the next token from the logits tensor.
    * @param logits_tensor The logits tensor.
@@ -66,22 +101,40 @@ class TextDecoderRunner {
    */
   inline int32_t logits_to_token(const exec_aten::Tensor& logits_tensor) {
     ET_CHECK_MSG(logits_tensor.dim() == 3, "Logits tensor must be 3D");
-    auto num_tokens = logits_tensor.size(1);
+    return logits_to_token(logits_tensor, logits_tensor.size(1) - 1);
+  }
+
+  /**
+   * Sample the token that follows the input token at `index` from the logits
+   * tensor, for models that return the logits of every input token.
+   * @param logits_tensor The logits tensor.
+   * @param index The position of the input token in the logits tensor.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const exec_aten::Tensor& logits_tensor,
+      int64_t index) {
+    ET_CHECK_MSG(logits_tensor.dim() == 3, "Logits tensor must be 3D");
+    ET_CHECK_MSG(
+        index >= 0 && index < logits_tensor.size(1),
+        "Logits index %" PRId64 " out of range",
+        index);
     auto vocab_size = logits_tensor.size(2);
 
     switch (logits_tensor.scalar_type()) {
       case ScalarType::Float: {
         float* logits = logits_tensor.mutable_data_ptr<float>();
-        float* logits_last = logits;
-        logits_last += (num_tokens - 1) * vocab_size;
-        return sampler_->sample(logits_last);
+        return process_and_sample(logits + index * vocab_size, vocab_size);
       }
       case ScalarType::Half: {
         exec_aten::Half* logits =
             logits_tensor.mutable_data_ptr<exec_aten::Half>();
-        exec_aten::Half* logits_last = logits;
-        logits_last += (num_tokens - 1) * vocab_size;
-        return sampler_->sample(logits_last);
+        return process_and_sample(logits + index * vocab_size, vocab_size);
+      }
+      case ScalarType::BFloat16: {
+        exec_aten::BFloat16* logits =
+            logits_tensor.mutable_data_ptr<exec_aten::BFloat16>();
+        return process_and_sample(logits + index * vocab_size, vocab_size);
       }
       default:
         ET_CHECK_MSG(
@@ -97,6 +150,36 @@ class TextDecoderRunner {
   std::unique_ptr<Sampler> sampler_;
   bool use_kv_cache_;
   bool should_stop_{false};
+  std::vector<std::shared_ptr<LogitsProcessor>> logits_processors_;
+  // Float logits of Half and BFloat16 models for the processors, allocated
+  // on first use.
+  std::vector<float> float_logits_;
+
+ private:
+  // Runs the logits processors on the logits, in place for float logits and
+  // on a float copy otherwise, then samples the next token from them.
+  template <typename T>
+  int32_t process_and_sample(T* logits, int64_t vocab_size) {
+    if (logits_processors_.empty()) {
+      return sampler_->sample(logits);
+    }
+    float* float_logits = nullptr;
+    if constexpr (std::is_same_v<T, float>) {
+      float_logits = logits;
+    } else {
+      float_logits_.resize(vocab_size);
+      float_logits = float_logits_.data();
+      logits_to_float(logits, static_cast<int32_t>(vocab_size), float_logits);
+    }
+    for (auto& processor : logits_processors_) {
+      processor->process(float_logits, static_cast<int32_t>(vocab_size));
+    }
+    const int32_t token = sampler_->sample(float_logits);
+    for (auto& processor : logits_processors_) {
+      processor->accept_token(token);
+    }
+    return token;
+  }
 };
 
 } // namespace torch::executor
@@ -11,22 +11,28 @@
 
 #include <executorch/extension/llm/runner/text_prefiller.h>
 
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <algorithm>
+
 namespace torch::executor {
 
 TextPrefiller::TextPrefiller(
     Tokenizer* tokenizer,
     TextDecoderRunner* text_decoder_runner,
     bool use_kv_cache,
-    bool enable_parallel_prefill)
+    bool enable_parallel_prefill,
+    int32_t max_chunk_size)
     : tokenizer_(tokenizer),
+      detokenizer_(tokenizer),
       text_decoder_runner_(text_decoder_runner),
       use_kv_cache_(use_kv_cache),
-      enable_parallel_prefill_(enable_parallel_prefill) {}
+      enable_parallel_prefill_(enable_parallel_prefill),
+      max_chunk_size_(max_chunk_size) {}
 
 Result<uint64_t> TextPrefiller::prefill(
     std::vector<uint64_t>& prompt_tokens,
     int64_t start_pos,
-    std::function<void(const std::string&)> token_callback) {
+    std::function<void(std::string_view)> token_callback) {
   ET_CHECK_MSG(!prompt_tokens.empty(), "Prompt cannot be null");
   if (!text_decoder_runner_->is_method_loaded()) {
     ET_CHECK_OK_OR_RETURN_ERROR(text_decoder_runner_->load());
@@ -35,26 +41,56 @@ Result<uint64_t> TextPrefiller::prefill(
   // When kv cache is not used, start pos is ignored
   int32_t num_prompt_tokens = prompt_tokens.size();
 
+  detokenizer_.reset();
+  auto echo = [&](uint64_t prev, uint64_t cur) -> Error {
+    Result<std::string_view> text = detokenizer_.next(prev, cur);
+    ET_CHECK_OK_OR_RETURN_ERROR(text.error());
+    if (!text->empty()) {
+      token_callback(*text);
+    }
+    return Error::Ok;
+  };
+
   // store the token
   uint64_t cur_token;
   if (enable_parallel_prefill_ || !use_kv_cache_) {
-    // initialize tensor wrappers
-    ManagedTensor managed_tokens(
-        prompt_tokens.data(), {1, num_prompt_tokens}, ScalarType::Long);
-
-    ManagedTensor managed_start_pos(&start_pos, {1}, ScalarType::Long);
-
-    Result<exec_aten::Tensor> outputs_res =
-        text_decoder_runner_->step(managed_tokens, managed_start_pos);
-
-    ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
-    ET_LOG(
-        Info, "Prefill token result numel(): %zu", outputs_res.get().numel());
-    ET_CHECK_MSG(
-        outputs_res.get().size(1) == num_prompt_tokens,
-        "Expected number of output tokens %d does not match returned value %zu.",
-        num_prompt_tokens,
-        outputs_res.get().size(1));
+    // Without kv cache every step sees the whole sequence, so only prefill
+    // with kv cache can be split into chunks.
+    const int32_t chunk_size =
+        use_kv_cache_ && max_chunk_size_ > 0 ? max_chunk_size_
+                                             : num_prompt_tokens;
+    for (int32_t offset = 0; offset < num_prompt_tokens; offset += chunk_size) {
+      const int32_t num_chunk_tokens =
+          std::min(chunk_size, num_prompt_tokens - offset);
+      int64_t chunk_start_pos = start_pos + offset;
+
+      // initialize tensor wrappers
+      ManagedTensor managed_tokens(
+          prompt_tokens.data() + offset,
+          {1, num_chunk_tokens},
+          ScalarType::Long);
+
+      ManagedTensor managed_start_pos(
+          &chunk_start_pos, {1}, ScalarType::Long);
+
+      Result<exec_aten::Tensor> outputs_res =
+          text_decoder_runner_->step(managed_tokens, managed_start_pos);
+
+      ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+      ET_LOG(
+          Info,
+          "Prefill token result numel(): %zu",
+          outputs_res.get().numel());
+      ET_CHECK_MSG(
+          outputs_res.get().size(1) == num_chunk_tokens,
+          "Expected number of output tokens %d does not match returned value %zu.",
+          num_chunk_tokens,
+          outputs_res.get().size(1));
+      // Only the logits of the last chunk are needed to sample the next token.
+      if (offset + num_chunk_tokens == num_prompt_tokens) {
+        cur_token = text_decoder_runner_->logits_to_token(outputs_res.get());
+      }
+    }
     // insert new token into prompt_tokens
     // NOLINTNEXTLINE(facebook-hte-ParameterUncheckedArrayBounds)
     uint64_t prev = prompt_tokens[0];
@@ -62,16 +98,15 @@ Result<uint64_t> TextPrefiller::prefill(
     for (int i = 0; i < prompt_tokens.size(); i++) {
       cur = prompt_tokens[i];
       if (token_callback && cur != tokenizer_->bos_tok()) {
-        token_callback(ET_UNWRAP(tokenizer_->decode(prev, cur)));
+        ET_CHECK_OK_OR_RETURN_ERROR(echo(prev, cur));
       }
       prev = cur;
     }
-    cur_token = text_decoder_runner_->logits_to_token(outputs_res.get());
   } else { // sequential prefill
     int64_t pos = 0; // position in the sequence
     int64_t prev_token;
     // token & pos
-    int64_t pos_data = 0;
+    int64_t pos_data = start_pos;
     // NOLINTNEXTLINE(facebook-hte-ParameterUncheckedArrayBounds)
     cur_token = prompt_tokens[0];
 
@@ -86,8 +121,8 @@ Result<uint64_t> TextPrefiller::prefill(
         text_decoder_runner_->step(managed_tokens, managed_start_pos));
 
     // if first token is not bos, we need to callback
-    if (cur_token != tokenizer_->bos_tok()) {
-      token_callback(ET_UNWRAP(tokenizer_->decode(cur_token, cur_token)));
+    if (token_callback && cur_token != tokenizer_->bos_tok()) {
+      ET_CHECK_OK_OR_RETURN_ERROR(echo(cur_token, cur_token));
     }
     pos = 1; // start from index 1
 
@@ -104,7 +139,9 @@ Result<uint64_t> TextPrefiller::prefill(
           text_decoder_runner_->step(managed_tokens, managed_start_pos));
 
       // print the token as string, decode it with the Tokenizer object
-      token_callback(ET_UNWRAP(tokenizer_->decode(prev_token, cur_token)));
+      if (token_callback) {
+        ET_CHECK_OK_OR_RETURN_ERROR(echo(prev_token, cur_token));
+      }
 
       pos++;
     }
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/incremental_detokenizer.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 // patternlint-disable-next-line executorch-cpp-nostdinc
 #include <functional>
@@ -20,31 +21,40 @@ namespace torch::executor {
 
 class TextPrefiller {
  public:
+  /**
+   * @param max_chunk_size With parallel prefill and a KV cache, the prompt is
+   * fed in windows of at most this many tokens, which bounds the activation
+   * memory of a step. 0 feeds the whole prompt in one step.
+   */
   TextPrefiller(
       Tokenizer* tokenizer,
       TextDecoderRunner* text_decoder_runner,
       bool use_kv_cache_,
-      bool enable_parallel_prefill);
+      bool enable_parallel_prefill,
+      int32_t max_chunk_size = 0);
   /**
    * Prefill an LLM Module with the given text input.
    * @param prompt_tokens The text prompt tokens to the LLM Module. Encoded by
    * tokenizer.
    * @param start_pos The starting position in KV cache of the input in the LLM
    * Module.
-   * @param token_callback A callback function that will be called for each
-   * token in the prompt.
+   * @param token_callback A callback function that will be called with the
+   * text of the prompt tokens, as soon as they make up whole UTF-8
+   * characters. The view is only valid during the call.
    * @return The next token of the LLM Module after prefill.
    */
   Result<uint64_t> prefill(
       std::vector<uint64_t>& prompt_tokens,
       int64_t start_pos = 0,
-      std::function<void(const std::string&)> token_callback = {});
+      std::function<void(std::string_view)> token_callback = {});
 
  private:
   Tokenizer* tokenizer_;
+  IncrementalDetokenizer detokenizer_;
   TextDecoderRunner* text_decoder_runner_;
   bool use_kv_cache_;
   bool enable_parallel_prefill_;
+  int32_t max_chunk_size_;
 };
 
 } // namespace torch::executor
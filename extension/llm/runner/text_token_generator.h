@@ -10,7 +10,9 @@
 #pragma once
 
 #include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/stop_sequence_matcher.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/incremental_detokenizer.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 
 namespace torch::executor {
@@ -25,11 +27,23 @@ class TextTokenGenerator {
       std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
       Stats* stats)
       : tokenizer_(tokenizer),
+        detokenizer_(tokenizer),
         text_decoder_runner_(text_decoder_runner),
         eos_ids_(std::move(eos_ids)),
         use_kv_cache_(use_kv_cache),
         stats_(stats) {}
 
+  /**
+   * Stop generating as soon as the generated tokens end with one of these
+   * sequences of token ids, e.g. the tokens of "\nUser:" for a chat model.
+   * Like an EOS token, the tokens of the sequence are still passed to the
+   * token callback. This replaces the previous stop sequences.
+   */
+  inline void set_stop_sequences(
+      const std::vector<std::vector<uint64_t>>& stop_sequences) {
+    stop_sequence_matcher_ = StopSequenceMatcher(stop_sequences);
+  }
+
   /**
    * Token generation loop.
    * @param tokens prompt tokens as well as the first token generated by
@@ -38,14 +52,16 @@ class TextTokenGenerator {
    * prompt tokens is prefilled.
    * @param seq_len the total sequence length, including the prompt tokens, next
    * token from prefill and new tokens.
-   * @param token_callback what to do after a token is generated.
+   * @param token_callback called with the text of the token from prefill and
+   * of each generated token, as soon as it makes up whole UTF-8 characters.
+   * The view is only valid during the call.
    * @return how many tokens are generated.
    */
   inline Result<int64_t> generate(
       std::vector<uint64_t> tokens,
       int64_t start_pos,
       int32_t seq_len,
-      std::function<void(const std::string&)> token_callback) {
+      std::function<void(std::string_view)> token_callback) {
     ET_CHECK_MSG(
         !tokens.empty(), "Token generation loop shouldn't take empty tokens");
     int64_t pos = start_pos; // position in the sequence
@@ -57,6 +73,20 @@ class TextTokenGenerator {
     uint64_t cur_token = tokens.back();
     uint64_t prev_token;
 
+    // print the token from prefill. No prev_token so use cur_token for it.
+    detokenizer_.reset();
+    stop_sequence_matcher_.reset();
+    stats_->on_generation_begin();
+    std::string_view text = ET_UNWRAP(detokenizer_.next(cur_token, cur_token));
+    if (!text.empty()) {
+      token_callback(text);
+    }
+    stats_->on_token_generated();
+    if (stop_sequence_matcher_.next(cur_token) > 0) {
+      ET_LOG(Info, "Reached a stop sequence");
+      return 0;
+    }
+
     if (use_kv_cache_) {
       // hard code these to size 1 as kv cache is locked to static size right
       // now.
@@ -76,8 +106,10 @@ class TextTokenGenerator {
     // Generate our tokens
     while (pos < seq_len - 1) {
       // Run the model
+      stats_->on_step_begin();
       Result<exec_aten::Tensor> logits_res =
           text_decoder_runner_->step(tokens_managed, start_pos_managed);
+      stats_->on_step_end();
 
       ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
       exec_aten::Tensor& logits_tensor = logits_res.get();
@@ -101,7 +133,13 @@ class TextTokenGenerator {
       }
 
       // print the token as string, decode it with the Tokenizer object
-      token_callback(ET_UNWRAP(tokenizer_->decode(prev_token, cur_token)));
+      stats_->on_decode_begin();
+      text = ET_UNWRAP(detokenizer_.next(prev_token, cur_token));
+      stats_->on_decode_end();
+      if (!text.empty()) {
+        token_callback(text);
+      }
+      stats_->on_token_generated();
 
       if (should_stop_) {
         break;
@@ -113,6 +151,12 @@ class TextTokenGenerator {
         ET_LOG(Info, "\nReached to the end of generation");
         break;
       }
+
+      if (stop_sequence_matcher_.next(cur_token) > 0) {
+        printf("\n");
+        ET_LOG(Info, "\nReached a stop sequence");
+        break;
+      }
     }
     return pos - start_pos;
   }
@@ -126,8 +170,10 @@ class TextTokenGenerator {
 
  private:
   Tokenizer* tokenizer_;
+  IncrementalDetokenizer detokenizer_;
   TextDecoderRunner* text_decoder_runner_;
   std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+  StopSequenceMatcher stop_sequence_matcher_;
   bool use_kv_cache_;
 
   // state machine
@@ -10,6 +10,8 @@
 #include <stdio.h>
 #include <time.h>
 #include <cctype>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <string_view>
 
 namespace torch {
 namespace executor {
@@ -34,6 +36,20 @@ void inline safe_printf(const char* piece) {
   printf("%s", piece);
 }
 
+void inline safe_printf(std::string_view piece) {
+  // Same as above, for text that isn't null terminated.
+  if (piece.empty()) {
+    return;
+  }
+  if (piece.size() == 1) {
+    unsigned char byte_val = piece[0];
+    if (!(isprint(byte_val) || isspace(byte_val))) {
+      return; // bad byte, don't print it
+    }
+  }
+  fwrite(piece.data(), 1, piece.size(), stdout);
+}
+
 // ----------------------------------------------------------------------------
 // utilities: time
 
@@ -44,6 +60,13 @@ long inline time_in_ms() {
   return time.tv_sec * 1000 + time.tv_nsec / 1000000;
 }
 
+long inline time_in_us() {
+  // return monotonic time in microseconds, for measuring short intervals
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1000000 + time.tv_nsec / 1000;
+}
+
 } // namespace util
 } // namespace executor
 } // namespace torch
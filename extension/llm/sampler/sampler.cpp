@@ -33,31 +33,150 @@
  */
 
 #include <executorch/extension/llm/sampler/sampler.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 
 namespace torch {
 namespace executor {
 
+namespace {
+
+using Vec = ::executorch::vec::Vectorized<float>;
+
+// Logits are read in blocks that are converted to float on the stack, so that
+// reduced precision logits go through the float vector kernels.
+constexpr int kBlockSize = 256;
+
+inline float to_float(float value) {
+  return value;
+}
+
+inline float to_float(exec_aten::Half value) {
+  return static_cast<float>(value);
+}
+
+inline float to_float(exec_aten::BFloat16 value) {
+  // bfloat16 is the upper half of a float
+  const uint32_t bits = static_cast<uint32_t>(value.x) << 16;
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+template <typename T>
+inline T from_float(float value) {
+  return T(value);
+}
+
+template <>
+inline exec_aten::BFloat16 from_float(float value) {
+  // round to nearest even
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  exec_aten::BFloat16 result;
+  result.x = static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+  return result;
+}
+
+// Returns a float view of x[0, size), which is x itself for float logits and
+// a conversion into buffer otherwise.
+inline const float* as_float(const float* x, int size, float* buffer) {
+  (void)size;
+  (void)buffer;
+  return x;
+}
+
+template <typename T>
+inline const float* as_float(const T* x, int size, float* buffer) {
+  for (int i = 0; i < size; i++) {
+    buffer[i] = to_float(x[i]);
+  }
+  return buffer;
+}
+
+inline float max_value(const float* x, int size) {
+  return ::executorch::vec::reduce_all<float>(
+      [](Vec& a, Vec& b) { return ::executorch::vec::maximum(a, b); },
+      x,
+      size);
+}
+
+// Returns the index of the largest logit, with one vectorized max per block
+// and a scan of the block holding the largest one.
+template <typename T>
+int argmax(const T* x, int size) {
+  float buffer[kBlockSize];
+  float max_val = to_float(x[0]);
+  int max_block = 0;
+  for (int begin = 0; begin < size; begin += kBlockSize) {
+    const int n = std::min(kBlockSize, size - begin);
+    const float block_max = max_value(as_float(x + begin, n, buffer), n);
+    if (block_max > max_val) {
+      max_val = block_max;
+      max_block = begin;
+    }
+  }
+  const int n = std::min(kBlockSize, size - max_block);
+  const float* block = as_float(x + max_block, n, buffer);
+  for (int i = 0; i < n; i++) {
+    if (block[i] == max_val) {
+      return max_block + i;
+    }
+  }
+  return max_block;
+}
+
+// Converts x into out while taking its max, so that the logits are read once.
+template <typename T>
+float convert_and_max(const T* x, int size, float* out) {
+  float max_val = to_float(x[0]);
+  for (int begin = 0; begin < size; begin += kBlockSize) {
+    const int n = std::min(kBlockSize, size - begin);
+    as_float(x + begin, n, out + begin);
+    max_val = std::max(max_val, max_value(out + begin, n));
+  }
+  return max_val;
+}
+
+// Replaces x with exp((x - max_val) * scale) and returns its sum, i.e. the
+// tempered softmax before normalization. The samplers fold the normalization
+// into the coin instead of dividing every element.
+float exp_and_sum(float* x, int size, float scale, float max_val) {
+  const Vec vec_max(max_val);
+  const Vec vec_scale(scale);
+  Vec vec_sum(0);
+  int i = 0;
+  for (; i + Vec::size() <= size; i += Vec::size()) {
+    Vec e = ((Vec::loadu(x + i) - vec_max) * vec_scale).exp();
+    e.store(x + i);
+    vec_sum = vec_sum + e;
+  }
+  float sum = ::executorch::vec::vec_reduce_all<float>(
+      [](Vec& a, Vec& b) { return a + b; }, vec_sum);
+  for (; i < size; i++) {
+    x[i] = std::exp((x[i] - max_val) * scale);
+    sum += x[i];
+  }
+  return sum;
+}
+
+} // namespace
+
 // sampler stuff
 template <typename T>
 int32_t Sampler::sample_argmax(T* probabilities) {
   // return the index that has the highest probability
-  int max_i = 0;
-  T max_p = probabilities[0];
-  for (int i = 1; i < vocab_size_; i++) {
-    if (probabilities[i] > max_p) {
-      max_i = i;
-      max_p = probabilities[i];
-    }
-  }
-  return max_i;
+  return argmax(probabilities, vocab_size_);
 }
 
 template <typename T>
 int32_t Sampler::sample_mult(T* probabilities, float coin) {
-  // sample index from probabilities (they must sum to 1!)
-  // coin is a random number in [0, 1), usually from random_f32()
-  T cdf = 0.0;
+  // sample index from probabilities, which sum to the scale of coin
+  // coin is a random number in [0, sum), usually from random_f32()
+  float cdf = 0.0;
   for (int i = 0; i < vocab_size_; i++) {
     cdf += probabilities[i];
     if (coin < cdf) {
@@ -68,85 +187,171 @@ int32_t Sampler::sample_mult(T* probabilities, float coin) {
 }
 
 template <typename T>
-int32_t Sampler::sample_topp(T* probabilities, float coin) {
+int32_t Sampler::sample_topp(T* probabilities, float coin, float sum) {
   // top-p sampling (or "nucleus sampling") samples from the smallest set of
   // tokens that exceed probability topp. This way we never sample tokens that
   // have very low probabilities and are less likely to go "off the rails".
   // coin is a random number in [0, 1), usually from random_f32()
+  // probabilities is unnormalized and sums to sum.
   int n = vocab_size_;
   int n0 = 0;
-  // quicksort indices in descending order of probabilities
   // values smaller than (1 - topp) / (n - 1) cannot be part of the result
-  // so for efficiency we crop these out as candidates before sorting
-  std::unique_ptr<ProbIndex<T>[]> probindex =
-      std::make_unique<ProbIndex<T>[]>(vocab_size_);
-
-  const float cutoff = (1.0f - topp_) / (n - 1);
+  // so for efficiency we crop these out as candidates before selecting
+  const float cutoff = (1.0f - topp_) / (n - 1) * sum;
   for (int i = 0; i < n; i++) {
     if (probabilities[i] >= cutoff) {
-      probindex[n0].index = i;
-      probindex[n0].prob = probabilities[i];
+      candidates_[n0].index = i;
+      candidates_[n0].prob = probabilities[i];
       n0++;
     }
   }
+  if (n0 == 0) {
+    return sample_argmax(probabilities);
+  }
 
-  auto compare = [](const ProbIndex<T>& a, const ProbIndex<T>& b) {
-    return a.prob > b.prob;
+  // Pop candidates from a max-heap in descending order of probabilities until
+  // they exceed topp, which is usually far fewer than n0, instead of sorting
+  // them all. The popped candidates end up in [first, n0) in ascending order.
+  auto compare = [](const ProbIndex<float>& a, const ProbIndex<float>& b) {
+    return a.prob < b.prob;
   };
-  std::sort(probindex.get(), probindex.get() + n0, compare);
-
-  // truncate the list where cumulative probability exceeds topp
-  T cumulative_prob = 0;
-  int last_idx = n0 - 1; // in case of rounding errors consider all elements
-  for (int i = 0; i < n0; i++) {
-    cumulative_prob += probindex[i].prob;
-    if (cumulative_prob > topp_) {
-      last_idx = i;
-      break; // we've exceeded topp by including last_idx
+  auto begin = candidates_.begin();
+  std::make_heap(begin, begin + n0, compare);
+  const float threshold = topp_ * sum;
+  float cumulative_prob = 0;
+  int first = n0;
+  while (first > 0) {
+    std::pop_heap(begin, begin + first, compare);
+    first--;
+    cumulative_prob += candidates_[first].prob;
+    if (cumulative_prob > threshold) {
+      break; // we've exceeded topp by including this candidate
     }
   }
 
   // sample from the truncated list
-  const T& r = coin * cumulative_prob;
-  T cdf = 0;
+  const float r = coin * cumulative_prob;
+  float cdf = 0;
+  for (int i = n0 - 1; i >= first; i--) {
+    cdf += candidates_[i].prob;
+    if (r < cdf) {
+      return candidates_[i].index;
+    }
+  }
+  return candidates_[first].index; // in case of rounding errors
+}
+
+template <typename T>
+int32_t Sampler::sample_topk(T* logits, float coin) {
+  // Keep the topk largest logits in a min-heap, so that most logits cost a
+  // single comparison against the smallest candidate and the vocabulary is
+  // never sorted.
+  auto compare = [](const ProbIndex<float>& a, const ProbIndex<float>& b) {
+    return a.prob > b.prob;
+  };
+  auto begin = candidates_.begin();
+  const int k = topk_;
+  for (int i = 0; i < k; i++) {
+    candidates_[i].index = i;
+    candidates_[i].prob = to_float(logits[i]);
+  }
+  std::make_heap(begin, begin + k, compare);
+  for (int i = k; i < vocab_size_; i++) {
+    const float logit = to_float(logits[i]);
+    if (logit > candidates_[0].prob) {
+      std::pop_heap(begin, begin + k, compare);
+      candidates_[k - 1].index = i;
+      candidates_[k - 1].prob = logit;
+      std::push_heap(begin, begin + k, compare);
+    }
+  }
+  // descending order of logits
+  std::sort_heap(begin, begin + k, compare);
+
+  // softmax over the candidates, then top-p within them
+  const float max_val = candidates_[0].prob;
+  float sum = 0;
+  for (int i = 0; i < k; i++) {
+    candidates_[i].prob =
+        std::exp((candidates_[i].prob - max_val) * inv_temperature_);
+    sum += candidates_[i].prob;
+  }
+  int last_idx = k - 1;
+  float cumulative_prob = sum;
+  if (topp_ > 0 && topp_ < 1) {
+    cumulative_prob = 0;
+    for (int i = 0; i < k; i++) {
+      cumulative_prob += candidates_[i].prob;
+      if (cumulative_prob > topp_ * sum) {
+        last_idx = i;
+        break;
+      }
+    }
+  }
+
+  const float r = coin * cumulative_prob;
+  float cdf = 0;
   for (int i = 0; i <= last_idx; i++) {
-    cdf += probindex[i].prob;
+    cdf += candidates_[i].prob;
     if (r < cdf) {
-      return probindex[i].index;
+      return candidates_[i].index;
+    }
+  }
+  return candidates_[last_idx].index; // in case of rounding errors
+}
+
+template <typename T>
+void Sampler::apply_penalties(T* logits) {
+  for (int32_t token : seen_tokens_) {
+    float logit = to_float(logits[token]);
+    if (repetition_penalty_ != 1.0f) {
+      logit = logit > 0 ? logit / repetition_penalty_
+                        : logit * repetition_penalty_;
     }
+    logit -= frequency_penalty_ * token_counts_[token];
+    logits[token] = from_float<T>(logit);
   }
-  return probindex[last_idx].index; // in case of rounding errors
 }
 
 Sampler::Sampler(
     int vocab_size,
     float temperature,
     float topp,
-    unsigned long long rng_seed)
+    unsigned long long rng_seed,
+    int32_t topk,
+    float repetition_penalty,
+    float frequency_penalty)
     : vocab_size_(vocab_size),
       inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
       topp_(topp),
-      rng_state_(rng_seed) {}
+      topk_(topk > 0 && topk < vocab_size ? topk : 0),
+      repetition_penalty_(repetition_penalty),
+      frequency_penalty_(frequency_penalty),
+      rng_state_(rng_seed) {
+  if (topk_ > 0) {
+    candidates_.resize(topk_);
+  } else if (topp_ > 0 && topp_ < 1) {
+    candidates_.resize(vocab_size_);
+  }
+}
 
-template <typename T>
-static void softmax(T* x, int size) {
-  // find max value (for numerical stability)
-  T max_val = x[0];
-  for (int i = 1; i < size; i++) {
-    if (x[i] > max_val) {
-      max_val = x[i];
-    }
+void Sampler::record_token(int32_t token) {
+  if (token < 0 || token >= vocab_size_) {
+    return;
   }
-  // exp and sum
-  T sum = 0;
-  for (int i = 0; i < size; i++) {
-    x[i] = expf(x[i] - max_val);
-    sum += x[i];
+  if (token_counts_.empty()) {
+    token_counts_.resize(vocab_size_, 0);
   }
-  // normalize
-  for (int i = 0; i < size; i++) {
-    x[i] /= sum;
+  if (token_counts_[token]++ == 0) {
+    seen_tokens_.push_back(token);
+  }
+}
+
+void Sampler::reset_history() {
+  for (int32_t token : seen_tokens_) {
+    token_counts_[token] = 0;
   }
+  seen_tokens_.clear();
 }
 
 static unsigned int random_u32(unsigned long long* state) {
@@ -164,33 +369,59 @@ static float random_f32(unsigned long long* state) { // random float32 in [0,1)
 template <typename T>
 int32_t Sampler::sample(T* logits) {
   // sample the token given the logits and some hyperparameters
+  if (has_penalties()) {
+    apply_penalties(logits);
+  }
   int next;
   if (inv_temperature_ == 0.0f) {
     // greedy argmax sampling: take the token with the highest probability
     next = sample_argmax(logits);
   } else {
-    // apply the temperature to the logits
-    for (int q = 0; q < vocab_size_; q++) {
-      logits[q] *= inv_temperature_;
-    }
-    // apply softmax to the logits to get the probabilities for next token
-    softmax(logits, vocab_size_);
     // flip a (float) coin (this is our source of entropy for sampling)
     float coin = random_f32(&rng_state_);
-    // we sample from this distribution to get the next token
-    if (topp_ <= 0 || topp_ >= 1) {
-      // simply sample from the predicted probability distribution
-      next = sample_mult(logits, coin);
+    if (topk_ > 0) {
+      // top-k sampling only computes the probabilities of the candidates
+      next = sample_topk(logits, coin);
     } else {
-      // top-p (nucleus) sampling, clamping the least likely tokens to zero
-      next = sample_topp(logits, coin);
+      // The probabilities are computed in float: float logits are
+      // overwritten in place, and other logits are converted to float scratch
+      // in the same pass that takes their max.
+      float* probabilities;
+      float max_val;
+      if constexpr (std::is_same<T, float>::value) {
+        probabilities = logits;
+        max_val = max_value(logits, vocab_size_);
+      } else {
+        if (float_logits_.empty()) {
+          float_logits_.resize(vocab_size_);
+        }
+        probabilities = float_logits_.data();
+        max_val = convert_and_max(logits, vocab_size_, probabilities);
+      }
+      // apply the temperature and softmax to the logits to get the
+      // probabilities for next token, up to their sum
+      const float sum =
+          exp_and_sum(probabilities, vocab_size_, inv_temperature_, max_val);
+      // we sample from this distribution to get the next token
+      if (topp_ <= 0 || topp_ >= 1) {
+        // simply sample from the predicted probability distribution
+        next = sample_mult(probabilities, coin * sum);
+      } else {
+        // top-p (nucleus) sampling, clamping the least likely tokens to zero
+        next = sample_topp(probabilities, coin, sum);
+      }
     }
   }
+  if (has_penalties()) {
+    record_token(next);
+  }
   return next;
 }
 
 template int32_t Sampler::sample<float>(float* logits);
 template int32_t Sampler::sample<exec_aten::Half>(exec_aten::Half* logits);
+template int32_t Sampler::sample<exec_aten::BFloat16>(
+    exec_aten::BFloat16* logits);
 
 } // namespace executor
 } // namespace torch
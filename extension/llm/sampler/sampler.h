@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <vector>
 #ifdef USE_ATEN_LIB
 #include <torch/torch.h>
 #endif
@@ -32,18 +33,47 @@ struct ProbIndex {
 
 class Sampler {
  public:
+  /**
+   * @param topk If in (0, vocab_size), only the topk most likely tokens are
+   * sampled from, and top-p is applied to them.
+   * @param repetition_penalty Divides the positive logits and multiplies the
+   * negative logits of tokens seen before. 1 disables it.
+   * @param frequency_penalty Subtracted from the logit of a token once for
+   * every time it was seen before. 0 disables it.
+   */
   Sampler(
       int32_t vocab_size,
       float temperature,
       float topp,
-      unsigned long long rng_seed);
+      unsigned long long rng_seed,
+      int32_t topk = 0,
+      float repetition_penalty = 1.0f,
+      float frequency_penalty = 0.0f);
 
   template <typename T>
   int32_t sample(T* logits);
 
+  /**
+   * Counts `token` as seen by the penalties, e.g. for the prompt tokens.
+   * Sampled tokens are counted automatically when a penalty is enabled.
+   */
+  void record_token(int32_t token);
+
+  /**
+   * Forgets the tokens seen by the penalties, e.g. before a new prompt.
+   */
+  void reset_history();
+
  private:
+  bool has_penalties() const {
+    return repetition_penalty_ != 1.0f || frequency_penalty_ != 0.0f;
+  }
+  template <typename T>
+  void apply_penalties(T* logits);
+  template <typename T>
+  int32_t sample_topk(T* logits, float coin);
   template <typename T>
-  int32_t sample_topp(T* probabilities, float coin);
+  int32_t sample_topp(T* probabilities, float coin, float sum);
   template <typename T>
   int32_t sample_mult(T* probabilities, float coin);
   template <typename T>
@@ -54,7 +84,18 @@ class Sampler {
   // reciprocal of temperature, or 0 if temperature == 0.
   float inv_temperature_;
   float topp_;
+  int32_t topk_;
+  float repetition_penalty_;
+  float frequency_penalty_;
   unsigned long long rng_state_;
+  // Scratch for the top-k or top-p candidates, allocated once so that
+  // sampling doesn't allocate per token.
+  std::vector<ProbIndex<float>> candidates_;
+  // Float probabilities of Half and BFloat16 logits, allocated on first use.
+  std::vector<float> float_logits_;
+  // How many times each token was seen, and the distinct tokens seen.
+  std::vector<int32_t> token_counts_;
+  std::vector<int32_t> seen_tokens_;
 };
 
 } // namespace executor
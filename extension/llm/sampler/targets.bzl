@@ -24,4 +24,7 @@ def define_common_targets():
             exported_deps = [
                 "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
             ],
+            deps = [
+                "//executorch/kernels/optimized:libvec",
+            ],
         )
@@ -8,6 +8,8 @@
 
 #include <executorch/extension/llm/sampler/sampler.h>
 
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <torch/torch.h>
 
@@ -44,5 +46,101 @@ TEST_F(SamplerTest, TestArgMaxWithFP16) {
   EXPECT_EQ(sampler.sample(input.data_ptr<c10::Half>()), 396);
 }
 
+TEST_F(SamplerTest, TestArgMaxWithBF16) {
+  torch::executor::Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 0.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0};
+  torch::Tensor input = torch::rand({1, 1, 32000}, at::kBFloat16);
+  input[0][0][396] = 2.0f;
+  EXPECT_EQ(sampler.sample(input.data_ptr<c10::BFloat16>()), 396);
+}
+
+TEST_F(SamplerTest, TestTemperatureWithBF16SamplesDominantToken) {
+  torch::executor::Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 0.5f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0};
+  torch::Tensor input = torch::rand({1, 1, 32000}, at::kBFloat16);
+  input[0][0][1234] = 40.0f;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(sampler.sample(input.data_ptr<c10::BFloat16>()), 1234);
+  }
+}
+
+TEST_F(SamplerTest, TestTopKOnlySamplesTopTokens) {
+  torch::executor::Sampler sampler{
+      /*vocab_size*/ 1000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0,
+      /*topk*/ 3};
+  for (int i = 0; i < 100; ++i) {
+    std::vector<float> logits(1000, 0.0f);
+    logits[7] = 5.0f;
+    logits[500] = 5.1f;
+    logits[999] = 4.9f;
+    int32_t token = sampler.sample(logits.data());
+    EXPECT_TRUE(token == 7 || token == 500 || token == 999) << token;
+  }
+}
+
+TEST_F(SamplerTest, TestTopPSamplesDominantToken) {
+  torch::executor::Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.5f,
+      /*rng_seed*/ 0};
+  for (int i = 0; i < 100; ++i) {
+    std::vector<float> logits(32000, 0.0f);
+    // exp(12) / (exp(12) + 31999) is about 0.84
+    logits[396] = 12.0f;
+    EXPECT_EQ(sampler.sample(logits.data()), 396);
+  }
+}
+
+TEST_F(SamplerTest, TestRepetitionPenalty) {
+  torch::executor::Sampler sampler{
+      /*vocab_size*/ 4,
+      /*temperature*/ 0.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0,
+      /*topk*/ 0,
+      /*repetition_penalty*/ 1.2f};
+  std::vector<float> logits = {2.0f, 1.9f, -1.0f, -1.1f};
+  EXPECT_EQ(sampler.sample(logits.data()), 0);
+  // 2 / 1.2 < 1.9
+  logits = {2.0f, 1.9f, -1.0f, -1.1f};
+  EXPECT_EQ(sampler.sample(logits.data()), 1);
+
+  sampler.reset_history();
+  sampler.record_token(0);
+  sampler.record_token(1);
+  // -1 * 1.2 < -1.15 < -1.1
+  logits = {-1.0f, -1.0f, -1.15f, -1.1f};
+  EXPECT_EQ(sampler.sample(logits.data()), 3);
+}
+
+TEST_F(SamplerTest, TestFrequencyPenalty) {
+  torch::executor::Sampler sampler{
+      /*vocab_size*/ 3,
+      /*temperature*/ 0.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0,
+      /*topk*/ 0,
+      /*repetition_penalty*/ 1.0f,
+      /*frequency_penalty*/ 0.4f};
+  sampler.record_token(0);
+  sampler.record_token(0);
+  // 1 - 2 * 0.4 < 0.5
+  std::vector<float> logits = {1.0f, 0.5f, 0.0f};
+  EXPECT_EQ(sampler.sample(logits.data()), 1);
+  // 0.5 - 0.4 < 0.2
+  logits = {1.0f, 0.5f, 0.2f};
+  EXPECT_EQ(sampler.sample(logits.data()), 2);
+}
+
 } // namespace executor
 } // namespace torch
@@ -129,6 +129,15 @@ BPETokenizer::~BPETokenizer() {
  */
 Result<std::string> BPETokenizer::decode(uint64_t prev_token, uint64_t token)
     const {
+  std::string res;
+  ET_CHECK_OK_OR_RETURN_ERROR(decode_append(prev_token, token, res));
+  return res;
+}
+
+Error BPETokenizer::decode_append(
+    uint64_t prev_token,
+    uint64_t token,
+    std::string& out) const {
   ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(token));
   const char* piece = vocab_[token];
   // following BOS token, sentencepiece decoder strips any leading
@@ -142,8 +151,8 @@ Result<std::string> BPETokenizer::decode(uint64_t prev_token, uint64_t token)
   if (sscanf(piece, "<0x%02hhX>", &byte_val) == 1) {
     piece = (char*)byte_pieces_ + byte_val * 2;
   }
-  std::string res(piece);
-  return res;
+  out += piece;
+  return Error::Ok;
 }
 
 static int32_t
@@ -34,6 +34,9 @@ class BPETokenizer : public Tokenizer {
   Result<std::string> decode(uint64_t prev_token, uint64_t token)
       const override;
 
+  Error decode_append(uint64_t prev_token, uint64_t token, std::string& out)
+      const override;
+
  private:
   std::unique_ptr<char*[]> vocab_ = nullptr;
   std::unique_ptr<float[]> vocab_scores_ = nullptr;
@@ -0,0 +1,120 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+
+# Script to compile a tiktoken tokenizer model (base64 token and rank per line)
+# into a binary file that the C++ Tiktoken memory maps and uses in place,
+# without decoding the tokens or building hash tables at load time.
+
+import argparse
+import base64
+import logging
+import os
+import struct
+from typing import List
+
+# The first bytes of a compiled file, telling it apart from a text model.
+MAGIC = b"ETTK"
+VERSION = 1
+
+_FNV_OFFSET_BASIS = 2166136261
+_FNV_PRIME = 16777619
+
+
+def fnv1a(data: bytes) -> int:
+    h = _FNV_OFFSET_BASIS
+    for b in data:
+        h = ((h ^ b) * _FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def load_tokens(model_path: str) -> List[bytes]:
+    """
+    Reads a tiktoken model, returning the bytes of the tokens indexed by rank.
+    The ranks must be dense token ids.
+    """
+    ranked = {}
+    with open(model_path, "rb") as f:
+        for line in f:
+            if not line.strip():
+                continue
+            token, rank = line.split()
+            rank = int(rank)
+            assert rank not in ranked, f"duplicate rank: {rank}"
+            ranked[rank] = base64.b64decode(token)
+    assert sorted(ranked) == list(range(len(ranked))), "ranks must be dense"
+    tokens = [ranked[rank] for rank in range(len(ranked))]
+    assert len(set(tokens)) == len(tokens), "duplicate token"
+    return tokens
+
+
+def compile_tokens(tokens: List[bytes]) -> bytes:
+    """
+    Lays out the tokens as the C++ TiktokenVocab expects them. All integers
+    are little endian uint32:
+
+    1. magic: b"ETTK", version, number of tokens n, number of slots m
+    2. offsets: [uint32] * (n + 1), token i is bytes[offsets[i]:offsets[i + 1]]
+    3. slots: [uint32] * m, an open addressing hash table where the slot of
+       token i holds i + 1 and is found by linear probing from
+       fnv1a(token i) % m, and empty slots hold 0
+    4. bytes: the concatenated token bytes
+    """
+    # Keep the table at most half full, so that probes stay short.
+    num_slots = 1
+    while num_slots < 2 * len(tokens):
+        num_slots *= 2
+
+    offsets = [0]
+    for token in tokens:
+        offsets.append(offsets[-1] + len(token))
+    assert offsets[-1] < 2**32, "tokens are too large"
+
+    slots = [0] * num_slots
+    for i, token in enumerate(tokens):
+        slot = fnv1a(token) & (num_slots - 1)
+        while slots[slot] != 0:
+            slot = (slot + 1) & (num_slots - 1)
+        slots[slot] = i + 1
+
+    return b"".join(
+        [
+            MAGIC,
+            struct.pack("<III", VERSION, len(tokens), num_slots),
+            struct.pack(f"<{len(offsets)}I", *offsets),
+            struct.pack(f"<{num_slots}I", *slots),
+            *tokens,
+        ]
+    )
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "-t",
+        "--tokenizer-model",
+        type=str,
+        default="tokenizer.model",
+        help="path to tiktoken tokenizer model",
+    )
+    parser.add_argument(
+        "-o",
+        "--output-path",
+        type=str,
+        default=None,
+        help="output path of the compiled tokenizer",
+    )
+
+    args = parser.parse_args()
+
+    output_path = (
+        args.output_path
+        if args.output_path
+        else os.path.splitext(args.tokenizer_model)[0] + ".ettk"
+    )
+    with open(output_path, "wb") as f:
+        f.write(compile_tokens(load_tokens(args.tokenizer_model)))
+    logging.info(f"Wrote compiled tokenizer to {output_path}")
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Turns a stream of generated tokens into a stream of complete UTF-8 text.
+
+#pragma once
+
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <string>
+// patternlint-disable-next-line executorch-cpp-nostdinc
+#include <string_view>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Decodes tokens one at a time into a buffer that is reused from token to
+ * token, and only hands out whole UTF-8 sequences. A byte level tokenizer
+ * may split a multi-byte character across tokens, and the leading bytes are
+ * held back until the token that completes the character is decoded.
+ */
+class IncrementalDetokenizer {
+ public:
+  explicit IncrementalDetokenizer(const Tokenizer* tokenizer)
+      : tokenizer_(tokenizer) {}
+
+  /**
+   * Decodes `token`, which follows `prev_token`.
+   * @return The text that became complete with this token, which may be
+   * empty. The view is valid until the next call.
+   */
+  Result<std::string_view> next(uint64_t prev_token, uint64_t token) {
+    buffer_.erase(0, num_complete_);
+    num_complete_ = 0;
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        tokenizer_->decode_append(prev_token, token, buffer_));
+    num_complete_ = complete_utf8_size(buffer_);
+    return std::string_view(buffer_.data(), num_complete_);
+  }
+
+  /**
+   * Drops the bytes held back from previous tokens, to start a new stream.
+   */
+  void reset() {
+    buffer_.clear();
+    num_complete_ = 0;
+  }
+
+  /**
+   * Returns the size of the longest prefix of `text` that doesn't end in the
+   * middle of a UTF-8 sequence. Bytes that can't start or continue a valid
+   * sequence are passed through, so that they never stall the stream.
+   */
+  static size_t complete_utf8_size(std::string_view text) {
+    const size_t size = text.size();
+    // A sequence is at most 4 bytes, so its lead byte is among the last 3
+    // bytes if it is incomplete.
+    for (size_t i = 1; i <= 3 && i <= size; ++i) {
+      const uint8_t byte = text[size - i];
+      if ((byte & 0xC0) == 0x80) {
+        // A continuation byte, keep looking for the lead byte.
+        continue;
+      }
+      size_t sequence_size = 1;
+      if ((byte & 0xE0) == 0xC0) {
+        sequence_size = 2;
+      } else if ((byte & 0xF0) == 0xE0) {
+        sequence_size = 3;
+      } else if ((byte & 0xF8) == 0xF0) {
+        sequence_size = 4;
+      }
+      return sequence_size > i ? size - i : size;
+    }
+    return size;
+  }
+
+ private:
+  const Tokenizer* tokenizer_;
+  // The decoded bytes not handed out yet, after the complete ones that the
+  // last call to next() returned.
+  std::string buffer_;
+  size_t num_complete_ = 0;
+};
+
+} // namespace executor
+} // namespace torch
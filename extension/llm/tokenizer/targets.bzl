@@ -46,6 +46,20 @@ def define_common_targets():
         ],
     )
 
+    runtime.python_binary(
+        name = "compile_tiktoken",
+        srcs = [
+            "compile_tiktoken.py",
+        ],
+        main_module = "executorch.extension.llm.tokenizer.compile_tiktoken",
+        base_module = "executorch.extension.llm.tokenizer",
+        visibility = [
+            "//executorch/examples/...",
+            "fbsource//xplat/executorch/examples/...",
+        ],
+        _is_external_target = True,
+    )
+
     runtime.python_binary(
         name = "tokenizer_py",
         main_module = "executorch.extension.llm.tokenizer.tokenizer",
@@ -72,6 +86,19 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "incremental_detokenizer",
+        exported_headers = [
+            "incremental_detokenizer.h",
+        ],
+        exported_deps = [
+            ":tokenizer_header",
+        ],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     runtime.cxx_library(
         name = "bpe_tokenizer",
         srcs = [
@@ -102,6 +129,9 @@ def define_common_targets():
             ":tokenizer_header",
             "//executorch/runtime/core:core",
         ],
+        deps = [
+            "//executorch/extension/data_loader:mmap_data_loader",
+        ],
         visibility = [
             "@EXECUTORCH_CLIENTS",
         ],
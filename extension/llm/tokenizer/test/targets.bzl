@@ -30,6 +30,16 @@ def define_common_targets():
         },
     )
 
+    runtime.cxx_test(
+        name = "test_incremental_detokenizer",
+        srcs = [
+            "test_incremental_detokenizer.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/tokenizer:incremental_detokenizer",
+        ],
+    )
+
     runtime.cxx_test(
         name = "test_tiktoken",
         srcs = [
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/tokenizer/incremental_detokenizer.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ::testing;
+
+namespace torch {
+namespace executor {
+
+namespace {
+// Decodes token i into the i-th string of a fixed vocab.
+class FakeTokenizer : public Tokenizer {
+ public:
+  explicit FakeTokenizer(std::vector<std::string> vocab)
+      : vocab_(std::move(vocab)) {
+    vocab_size_ = vocab_.size();
+    initialized_ = true;
+  }
+
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return Error::NotSupported;
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    ET_CHECK_OK_OR_RETURN_ERROR(decode_verify(token));
+    return vocab_[token];
+  }
+
+ private:
+  std::vector<std::string> vocab_;
+};
+} // namespace
+
+class IncrementalDetokenizerTest : public Test {
+ public:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Decodes tokens one at a time, returning what each of them emitted.
+  std::vector<std::string> decode_all(
+      IncrementalDetokenizer& detokenizer,
+      const std::vector<uint64_t>& tokens) {
+    std::vector<std::string> out;
+    uint64_t prev = tokens.empty() ? 0 : tokens[0];
+    for (uint64_t token : tokens) {
+      Result<std::string_view> text = detokenizer.next(prev, token);
+      EXPECT_EQ(text.error(), Error::Ok);
+      out.emplace_back(text.get());
+      prev = token;
+    }
+    return out;
+  }
+};
+
+TEST_F(IncrementalDetokenizerTest, WholeTokensAreEmittedRightAway) {
+  FakeTokenizer tokenizer({"hello", " world", "!"});
+  IncrementalDetokenizer detokenizer(&tokenizer);
+  std::vector<std::string> expected = {"hello", " world", "!"};
+  EXPECT_EQ(decode_all(detokenizer, {0, 1, 2}), expected);
+}
+
+TEST_F(IncrementalDetokenizerTest, SplitCharactersAreHeldBack) {
+  // "é" is 0xC3 0xA9 and "😀" is 0xF0 0x9F 0x98 0x80.
+  FakeTokenizer tokenizer(
+      {"caf", "\xC3", "\xA9 ", "\xF0\x9F", "\x98", "\x80!", "\xF0\x9F\x98\x80"});
+  IncrementalDetokenizer detokenizer(&tokenizer);
+  std::vector<std::string> expected = {
+      "caf", "", "\xC3\xA9 ", "", "", "\xF0\x9F\x98\x80!", "\xF0\x9F\x98\x80"};
+  EXPECT_EQ(decode_all(detokenizer, {0, 1, 2, 3, 4, 5, 6}), expected);
+}
+
+TEST_F(IncrementalDetokenizerTest, ResetDropsHeldBackBytes) {
+  FakeTokenizer tokenizer({"\xE2\x82", "a"});
+  IncrementalDetokenizer detokenizer(&tokenizer);
+  std::vector<std::string> expected = {""};
+  EXPECT_EQ(decode_all(detokenizer, {0}), expected);
+  detokenizer.reset();
+  expected = {"a"};
+  EXPECT_EQ(decode_all(detokenizer, {1}), expected);
+}
+
+TEST_F(IncrementalDetokenizerTest, InvalidBytesAreNotHeldBack) {
+  // Stray continuation bytes and bytes that can't start a sequence.
+  FakeTokenizer tokenizer({"\x80\x80\x80\x80", "\xFF"});
+  IncrementalDetokenizer detokenizer(&tokenizer);
+  std::vector<std::string> expected = {"\x80\x80\x80\x80", "\xFF"};
+  EXPECT_EQ(decode_all(detokenizer, {0, 1}), expected);
+}
+
+TEST_F(IncrementalDetokenizerTest, DecodeErrorIsReturned) {
+  FakeTokenizer tokenizer({"a"});
+  IncrementalDetokenizer detokenizer(&tokenizer);
+  EXPECT_EQ(detokenizer.next(0, 1).error(), Error::NotSupported);
+}
+
+} // namespace executor
+} // namespace torch
@@ -54,10 +54,13 @@ class TiktokenExtensionTest : public Test {
         _get_special_tokens(), kBOSTokenIndex, kEOSTokenIndex);
     modelPath_ = std::getenv("RESOURCES_PATH") +
         std::string("/test_tiktoken_tokenizer.model");
+    compiledModelPath_ = std::getenv("RESOURCES_PATH") +
+        std::string("/test_tiktoken_tokenizer.ettk");
   }
 
   std::unique_ptr<Tokenizer> tokenizer_;
   std::string modelPath_;
+  std::string compiledModelPath_;
 };
 
 TEST_F(TiktokenExtensionTest, EncodeWithoutLoadFails) {
@@ -101,6 +104,27 @@ TEST_F(TiktokenExtensionTest, TokenizerDecodeCorrectly) {
   }
 }
 
+TEST_F(TiktokenExtensionTest, TokenizerEncodeLongPieceRoundTrips) {
+  Error res = tokenizer_->load(modelPath_.c_str());
+  EXPECT_EQ(res, Error::Ok);
+  // A single regex piece long enough to be merged with a heap.
+  std::string text = " ";
+  for (int i = 0; i < 64; i++) {
+    text += "abcxyz"[i % 6];
+    text += "qwerty"[(i * 7) % 6];
+  }
+  Result<std::vector<uint64_t>> out = tokenizer_->encode(text, 0, 0);
+  EXPECT_EQ(out.error(), Error::Ok);
+  std::string decoded;
+  for (uint64_t token : out.get()) {
+    Result<std::string> piece = tokenizer_->decode(0, token);
+    EXPECT_EQ(piece.error(), Error::Ok);
+    decoded += piece.get();
+  }
+  EXPECT_EQ(decoded, text);
+  EXPECT_LT(out.get().size(), text.size());
+}
+
 TEST_F(TiktokenExtensionTest, TokenizerDecodeOutOfRangeFails) {
   Error res = tokenizer_->load(modelPath_.c_str());
   EXPECT_EQ(res, Error::Ok);
@@ -110,6 +134,36 @@ TEST_F(TiktokenExtensionTest, TokenizerDecodeOutOfRangeFails) {
   EXPECT_EQ(out.error(), Error::NotSupported);
 }
 
+TEST_F(TiktokenExtensionTest, CompiledTokenizerMatchesTextTokenizer) {
+  Error res = tokenizer_->load(modelPath_.c_str());
+  EXPECT_EQ(res, Error::Ok);
+  auto compiled = std::make_unique<Tiktoken>(
+      _get_special_tokens(), kBOSTokenIndex, kEOSTokenIndex);
+  res = compiled->load(compiledModelPath_.c_str());
+  EXPECT_EQ(res, Error::Ok);
+  EXPECT_EQ(compiled->vocab_size(), tokenizer_->vocab_size());
+  EXPECT_EQ(compiled->bos_tok(), tokenizer_->bos_tok());
+  EXPECT_EQ(compiled->eos_tok(), tokenizer_->eos_tok());
+
+  std::string text =
+      "hello world<|eot_id|> The quick brown fox jumps over 12345 lazy dogs!";
+  Result<std::vector<uint64_t>> expected = tokenizer_->encode(text, 1, 1);
+  Result<std::vector<uint64_t>> out = compiled->encode(text, 1, 1);
+  EXPECT_EQ(expected.error(), Error::Ok);
+  EXPECT_EQ(out.error(), Error::Ok);
+  EXPECT_EQ(out.get(), expected.get());
+  for (uint64_t token : {0, 15339, 1917, 127999, 128000, 128255}) {
+    Result<std::string> piece = compiled->decode(0, token);
+    EXPECT_EQ(piece.error(), Error::Ok);
+    EXPECT_EQ(piece.get(), tokenizer_->decode(0, token).get());
+  }
+}
+
+TEST_F(TiktokenExtensionTest, LoadMissingFileFails) {
+  Error res = tokenizer_->load(modelPath_ + ".missing");
+  EXPECT_NE(res, Error::Ok);
+}
+
 TEST_F(TiktokenExtensionTest, ConstructionWithInvalidBOSIndex) {
   // gtest death test doesn't work on iOS:
   // https://github.com/google/googletest/issues/2834
@@ -27,14 +27,41 @@
 
 #include <executorch/extension/llm/tokenizer/base64.h>
 #include <executorch/extension/llm/tokenizer/tiktoken.h>
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <queue>
 
 namespace torch {
 namespace executor {
 
+using executorch::extension::MmapDataLoader;
+
 // ------------------------------Util start------------------------------------
 
+// The header of a compiled tokenizer file, followed by the arrays of a
+// TiktokenVocab. All integers are little endian, as are the hosts this runs
+// on.
+struct CompiledVocabHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t num_tokens;
+  uint32_t num_slots;
+};
+
+static constexpr char kCompiledVocabMagic[4] = {'E', 'T', 'T', 'K'};
+static constexpr uint32_t kCompiledVocabVersion = 1;
+
+static uint32_t _fnv1a(std::string_view bytes) {
+  uint32_t hash = 2166136261u;
+  for (char c : bytes) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
 static uint64_t _max_size() {
   return std::numeric_limits<uint64_t>::max();
 }
@@ -45,13 +72,29 @@ static Re2UPtr _create_regex(const std::string& pattern) {
   return std::make_unique<re2::RE2>("(" + pattern + ")");
 }
 
+// Same as re2::RE2::FindAndConsume() capturing the whole match. Only asking
+// for the match itself lets re2 find it with its DFA, instead of running its
+// much slower submatch engines for the capture group.
+static bool _find_and_consume(
+    re2::StringPiece* input,
+    const re2::RE2& regex,
+    re2::StringPiece* match) {
+  if (!regex.Match(
+          *input, 0, input->size(), re2::RE2::UNANCHORED, match, 1)) {
+    return false;
+  }
+  input->remove_prefix(match->data() + match->size() - input->data());
+  return true;
+}
+
 static Re2UPtr _build_special_token_regex(const Encoder& special_encoder) {
   std::string special_pattern;
   for (const auto& ele : special_encoder) {
     if (!special_pattern.empty()) {
       special_pattern += "|";
     }
-    special_pattern += re2::RE2::QuoteMeta(ele.first);
+    special_pattern += re2::RE2::QuoteMeta(
+        re2::StringPiece(ele.first.data(), ele.first.size()));
   }
 
   if (special_pattern.empty()) {
@@ -77,39 +120,115 @@ static std::pair<std::string, uint64_t> _parse(const std::string& line) {
   return {std::move(token), rank};
 }
 
-static Encoder _load_encoder(const std::string& path) {
+static Decoder _load_decoder(const std::string& path) {
   std::ifstream file(path);
   ET_CHECK_MSG(file, "failed to open encoder file: %s", path.c_str());
 
-  Encoder encoder;
+  std::vector<std::pair<std::string, uint64_t>> items;
   std::string line;
   while (std::getline(file, line)) {
-    auto [token, rank] = _parse(line);
+    items.push_back(_parse(line));
+  }
 
+  // The ranks are the token ids, which are dense.
+  Decoder decoder(items.size());
+  std::vector<bool> decoded(items.size(), false);
+  for (auto& [token, rank] : items) {
     ET_CHECK_MSG(
-        encoder.emplace(std::move(token), rank).second,
-        "duplicate item: %s",
-        line.c_str());
+        rank < items.size() && !decoded[rank],
+        "invalid encoder rank: %" PRIu64,
+        rank);
+    decoder[rank] = std::move(token);
+    decoded[rank] = true;
   }
 
-  return encoder;
+  return decoder;
 }
 
-static Decoder _build_decoder(const Encoder& encoder) {
-  Decoder decoder;
-  for (const auto& [k, v] : encoder) {
-    decoder.emplace(v, k);
+static std::optional<uint64_t> _get_rank(
+    std::string_view piece,
+    const TiktokenVocab& ranks,
+    uint64_t start,
+    uint64_t end) {
+  return ranks.find(piece.substr(start, end - start));
+}
+
+// Pieces at least this long are merged with a heap, see
+// _byte_pair_merge_heap().
+static constexpr size_t kMinHeapMergeSize = 128;
+
+// Does the same merges as the linear scan of _byte_pair_merge(), in
+// O(n log n) instead of O(n^2) for pieces of n bytes. The parts are linked
+// by their start positions, and the heap holds the (rank, start) of the byte
+// pair starting at each part. Merging a pair removes the part after it and
+// changes the ranks of the part and of the one before it, so the entries of
+// the old ranks are skipped when they are popped.
+static std::vector<uint64_t> _byte_pair_merge_heap(
+    std::string_view piece,
+    const TiktokenVocab& ranks,
+    std::function<uint64_t(uint64_t, uint64_t)> func) {
+  const uint64_t size = piece.size();
+  // next[start] and prev[start] are the starts of the neighbouring parts,
+  // where the part starting at size is the end of the piece.
+  std::vector<uint64_t> next(size + 1);
+  std::vector<uint64_t> prev(size + 1);
+  std::vector<uint64_t> part_ranks(size + 1, _max_size());
+  using RankStart = std::pair<uint64_t, uint64_t>;
+  std::priority_queue<RankStart, std::vector<RankStart>, std::greater<>> heap;
+
+  auto update_rank = [&](uint64_t start) {
+    part_ranks[start] = _max_size();
+    if (next[start] < size) {
+      auto rank = _get_rank(piece, ranks, start, next[next[start]]);
+      if (rank) {
+        part_ranks[start] = *rank;
+        heap.emplace(*rank, start);
+      }
+    }
+  };
+
+  for (uint64_t i = 0; i <= size; ++i) {
+    next[i] = i + 1;
+    prev[i] = i - 1;
   }
+  for (uint64_t i = 0; i < size; ++i) {
+    update_rank(i);
+  }
+
+  // Ties between equal ranks go to the leftmost pair, as in the linear scan.
+  while (!heap.empty()) {
+    auto [rank, start] = heap.top();
+    heap.pop();
+    if (part_ranks[start] != rank) {
+      continue;
+    }
 
-  ET_CHECK_MSG(encoder.size() == decoder.size(), "duplicate items in encoder");
+    auto removed = next[start];
+    next[start] = next[removed];
+    prev[next[removed]] = start;
+    part_ranks[removed] = _max_size();
 
-  return decoder;
+    update_rank(start);
+    if (start > 0) {
+      update_rank(prev[start]);
+    }
+  }
+
+  std::vector<uint64_t> out;
+  for (uint64_t start = 0; start < size; start = next[start]) {
+    out.push_back(func(start, next[start]));
+  }
+  return out;
 }
 
 static std::vector<uint64_t> _byte_pair_merge(
-    const std::string& piece,
-    const std::unordered_map<std::string, uint64_t>& ranks,
+    std::string_view piece,
+    const TiktokenVocab& ranks,
     std::function<uint64_t(uint64_t, uint64_t)> func) {
+  if (piece.size() >= kMinHeapMergeSize) {
+    return _byte_pair_merge_heap(piece, ranks, func);
+  }
+
   // This is a vector of (start, rank).
   // The rank is of the byte pair starting at position start.
   // The rank of the last item in the vector is not a valid value.
@@ -126,11 +245,7 @@ static std::vector<uint64_t> _byte_pair_merge(
     if (start_idx + skip + 2 < parts.size()) {
       auto s = parts[start_idx].first;
       auto e = parts[start_idx + skip + 2].first;
-      auto key = piece.substr(s, e - s);
-      auto iter = ranks.find(key);
-      if (iter != ranks.end()) {
-        return iter->second;
-      }
+      return _get_rank(piece, ranks, s, e);
     }
     return std::nullopt;
   };
@@ -140,17 +255,15 @@ static std::vector<uint64_t> _byte_pair_merge(
   for (auto i = 0U; i < parts.size() - 2; ++i) {
     auto rank = get_rank(parts, i, 0);
     if (rank) {
-      // usize::MAX is a sentinel value and cannot be a valid rank
-      ET_CHECK_MSG(*rank != _max_size(), "rank is too large");
       parts[i].second = *rank;
     }
   }
 
   // If you have n parts and m merges, this does O(mn) work.
-  // We could do something with a heap and do O(m log n) work.
   // It is important to consider that n is often small (<100), and as such
   // the cache-locality benefits outweigh the algorithmic complexity downsides
-  // of the `parts` vector data structure above.
+  // of the `parts` vector data structure above. Longer pieces are merged with
+  // a heap instead.
 
   // Note that we hash bytes, not token pairs. As long as we train BPE the way
   // we currently do, this is equivalent. An easy way to break this would be
@@ -211,12 +324,12 @@ static std::vector<uint64_t> _byte_pair_merge(
 }
 
 static std::vector<uint64_t> _byte_pair_encode(
-    const std::string& piece,
-    const Encoder& encoder) {
+    std::string_view piece,
+    const TiktokenVocab& encoder) {
   if (piece.size() == 1) {
-    auto iter = encoder.find(piece);
-    if (iter != encoder.end()) {
-      return std::vector<uint64_t>({iter->second});
+    auto rank = encoder.find(piece);
+    if (rank) {
+      return std::vector<uint64_t>({*rank});
     } else {
       // TODO: is it possible?
       return {};
@@ -225,18 +338,29 @@ static std::vector<uint64_t> _byte_pair_encode(
 
   return _byte_pair_merge(
       piece, encoder, [&piece, &encoder](uint64_t start, uint64_t stop) {
-        std::string key = piece.substr(start, stop - start);
-        auto iter = encoder.find(key);
-        if (iter != encoder.end()) {
-          return iter->second;
-        } else {
-          // TODO: what if key does not exist? Should we return `unknown`?
-          // assert(false); // ??
-          return uint64_t(0);
-        }
+        auto rank = encoder.find(piece.substr(start, stop - start));
+        // TODO: what if key does not exist? Should we return `unknown`?
+        return rank.value_or(uint64_t(0));
       });
 }
 // ------------------------------Util end------------------------------------
+
+std::optional<uint64_t> TiktokenVocab::find(std::string_view piece) const {
+  if (num_slots == 0) {
+    return std::nullopt;
+  }
+  const uint32_t mask = num_slots - 1;
+  for (uint32_t slot = _fnv1a(piece) & mask;; slot = (slot + 1) & mask) {
+    uint32_t entry = slots[slot];
+    if (entry == 0) {
+      return std::nullopt;
+    }
+    if (token(entry - 1) == piece) {
+      return entry - 1;
+    }
+  }
+}
+
 // -------------------------private method start-------------------------------
 
 template <typename T>
@@ -248,19 +372,20 @@ Tiktoken::_split_with_allowed_special_token(
     return std::make_pair(std::nullopt, input);
   }
 
-  auto start = input.begin();
-  std::string special;
+  auto start = input.data();
+  re2::StringPiece special;
   while (true) {
-    if (!re2::RE2::FindAndConsume(&input, *_special_token_regex, &special)) {
+    if (!_find_and_consume(&input, *_special_token_regex, &special)) {
       // No special token.
       break;
     }
 
-    if (allowed_special.count(special) == 1) {
+    if (allowed_special.count(
+            std::string_view(special.data(), special.size())) == 1) {
       // Found an allowed special token, split the text with it.
       return std::make_pair(
-          special,
-          re2::StringPiece(start, input.begin() - start - special.size()));
+          std::string(special.data(), special.size()),
+          re2::StringPiece(start, special.data() - start));
     } // else try to find the next special token
   }
 
@@ -271,16 +396,17 @@ void Tiktoken::_encode(
     re2::StringPiece& input,
     std::vector<uint64_t>& ret,
     uint64_t& last_piece_token_len) const {
-  std::string piece;
+  re2::StringPiece match;
   assert(_regex);
-  while (re2::RE2::FindAndConsume(&input, *_regex, &piece)) {
-    auto iter = _encoder.find(piece);
-    if (iter != _encoder.end()) {
+  while (_find_and_consume(&input, *_regex, &match)) {
+    std::string_view piece(match.data(), match.size());
+    auto rank = _vocab.find(piece);
+    if (rank) {
       last_piece_token_len = 1;
-      ret.push_back(iter->second);
+      ret.push_back(*rank);
       continue;
     }
-    auto tokens = _byte_pair_encode(piece, _encoder);
+    auto tokens = _byte_pair_encode(piece, _vocab);
     last_piece_token_len = tokens.size();
     ret.insert(ret.end(), tokens.begin(), tokens.end());
   }
@@ -324,12 +450,139 @@ std::pair<std::vector<uint64_t>, uint64_t> Tiktoken::_encode_with_special_token(
 
 Encoder Tiktoken::_build_special_token_encoder(ssize_t num_base_tokens) const {
   Encoder special_token_encoder;
-  for (ssize_t i = 0; i < _special_tokens->size(); ++i) {
-    special_token_encoder.emplace(_special_tokens->at(i), num_base_tokens + i);
+  for (ssize_t i = 0; i < _special_token_decoder.size(); ++i) {
+    ET_CHECK_MSG(
+        special_token_encoder
+            .emplace(_special_token_decoder[i], num_base_tokens + i)
+            .second,
+        "duplicate special token: %s",
+        _special_token_decoder[i].c_str());
   }
   return special_token_encoder;
 }
 
+Error Tiktoken::_load_compiled_vocab(const std::string& path) {
+  // The vocab is probed at random, so reading ahead would only waste I/O.
+  MmapDataLoader::AccessConfig access_config;
+  access_config.pattern = MmapDataLoader::AccessPattern::Random;
+  auto loader = MmapDataLoader::from(
+      path.c_str(), MmapDataLoader::MlockConfig::NoMlock, access_config);
+  ET_CHECK_OK_OR_RETURN_ERROR(loader.error());
+  auto size = loader->size();
+  ET_CHECK_OK_OR_RETURN_ERROR(size.error());
+  if (*size < sizeof(CompiledVocabHeader)) {
+    return Error::NotFound;
+  }
+  // The mapping outlives the loader.
+  auto buffer = loader->load(
+      0,
+      *size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ET_CHECK_OK_OR_RETURN_ERROR(buffer.error());
+
+  CompiledVocabHeader header;
+  std::memcpy(&header, buffer->data(), sizeof(header));
+  if (std::memcmp(header.magic, kCompiledVocabMagic, sizeof(header.magic)) !=
+      0) {
+    // Not a compiled file.
+    return Error::NotFound;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      header.version == kCompiledVocabVersion,
+      NotSupported,
+      "Unsupported compiled tokenizer version %" PRIu32,
+      header.version);
+  ET_CHECK_OR_RETURN_ERROR(
+      header.num_slots > header.num_tokens &&
+          (header.num_slots & (header.num_slots - 1)) == 0,
+      InvalidProgram,
+      "Invalid number of slots %" PRIu32,
+      header.num_slots);
+
+  const size_t offsets_size =
+      (static_cast<size_t>(header.num_tokens) + 1) * sizeof(uint32_t);
+  const size_t slots_size = header.num_slots * sizeof(uint32_t);
+  const size_t arrays_end =
+      sizeof(CompiledVocabHeader) + offsets_size + slots_size;
+  ET_CHECK_OR_RETURN_ERROR(
+      arrays_end <= *size,
+      InvalidProgram,
+      "Compiled tokenizer is truncated: %zu < %zu",
+      *size,
+      arrays_end);
+
+  const char* data = static_cast<const char*>(buffer->data());
+  TiktokenVocab vocab;
+  vocab.num_tokens = header.num_tokens;
+  vocab.num_slots = header.num_slots;
+  vocab.offsets =
+      reinterpret_cast<const uint32_t*>(data + sizeof(CompiledVocabHeader));
+  vocab.slots = reinterpret_cast<const uint32_t*>(
+      data + sizeof(CompiledVocabHeader) + offsets_size);
+  vocab.bytes = data + arrays_end;
+  ET_CHECK_OR_RETURN_ERROR(
+      vocab.offsets[vocab.num_tokens] <= *size - arrays_end,
+      InvalidProgram,
+      "Compiled tokenizer is truncated");
+
+  _vocab = vocab;
+  _compiled_vocab = std::make_unique<FreeableBuffer>(std::move(*buffer));
+  return Error::Ok;
+}
+
+void Tiktoken::_build_vocab(const Decoder& decoder) {
+  ET_CHECK_MSG(
+      decoder.size() < std::numeric_limits<uint32_t>::max() / 2,
+      "too many tokens: %zu",
+      decoder.size());
+
+  _vocab_offsets.assign(1, 0);
+  _vocab_offsets.reserve(decoder.size() + 1);
+  _vocab_bytes.clear();
+  for (const auto& token : decoder) {
+    _vocab_bytes.insert(_vocab_bytes.end(), token.begin(), token.end());
+    ET_CHECK_MSG(
+        _vocab_bytes.size() <= std::numeric_limits<uint32_t>::max(),
+        "tokens are too large");
+    _vocab_offsets.push_back(_vocab_bytes.size());
+  }
+
+  // Keep the table at most half full, like compile_tiktoken.py.
+  uint32_t num_slots = 1;
+  while (num_slots < 2 * decoder.size()) {
+    num_slots *= 2;
+  }
+  _vocab_slots.assign(num_slots, 0);
+
+  _vocab.num_tokens = decoder.size();
+  _vocab.num_slots = num_slots;
+  _vocab.offsets = _vocab_offsets.data();
+  _vocab.slots = _vocab_slots.data();
+  _vocab.bytes = _vocab_bytes.data();
+
+  const uint32_t mask = num_slots - 1;
+  for (uint32_t rank = 0; rank < decoder.size(); ++rank) {
+    ET_CHECK_MSG(
+        !_vocab.find(decoder[rank]), "duplicate item: %s", decoder[rank].c_str());
+    uint32_t slot = _fnv1a(decoder[rank]) & mask;
+    while (_vocab_slots[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    _vocab_slots[slot] = rank + 1;
+  }
+}
+
+std::optional<std::string_view> Tiktoken::_decode_token(uint64_t token) const {
+  if (token < _vocab.num_tokens) {
+    return _vocab.token(token);
+  }
+  token -= _vocab.num_tokens;
+  if (token < _special_token_decoder.size()) {
+    return _special_token_decoder[token];
+  }
+  return std::nullopt;
+}
+
 // -------------------------private method end-------------------------------
 // -------------------------public method start-------------------------------
 
@@ -352,11 +605,21 @@ Tiktoken::Tiktoken(
 }
 
 Error Tiktoken::load(const std::string& path) {
-  _encoder = _load_encoder(path);
-  _special_token_encoder = _build_special_token_encoder(_encoder.size());
+  // Use a compiled file (see compile_tiktoken.py) in place, or else parse
+  // the text file.
+  _compiled_vocab.reset();
+  Error err = _load_compiled_vocab(path);
+  if (err == Error::NotFound) {
+    _build_vocab(_load_decoder(path));
+  } else {
+    ET_CHECK_OK_OR_RETURN_ERROR(err);
+    _vocab_offsets = {};
+    _vocab_slots = {};
+    _vocab_bytes = {};
+  }
 
-  _decoder = _build_decoder(_encoder);
-  _special_token_decoder = _build_decoder(_special_token_encoder);
+  _special_token_decoder = *_special_tokens;
+  _special_token_encoder = _build_special_token_encoder(_vocab.num_tokens);
 
   _regex = _create_regex(_pattern);
   // Warmup re2 as it is slow on the first run, void the return value as it's
@@ -369,7 +632,7 @@ Error Tiktoken::load(const std::string& path) {
   (void)_special_token_regex->ReverseProgramSize();
 
   // initialize vocab_size, bos_tok, eos_tok
-  vocab_size_ = _encoder.size() + _special_token_encoder.size();
+  vocab_size_ = _vocab.num_tokens + _special_token_encoder.size();
   bos_tok_ = _special_token_encoder.at(_special_tokens->at(_bos_token_index));
   eos_tok_ = _special_token_encoder.at(_special_tokens->at(_eos_token_index));
 
@@ -393,25 +656,19 @@ Tiktoken::encode(const std::string& text, int8_t bos, int8_t eos) const {
 }
 
 Result<std::string> Tiktoken::decode(uint64_t prev, uint64_t cur) const {
+  std::string res;
+  ET_CHECK_OK_OR_RETURN_ERROR(decode_append(prev, cur, res));
+  return res;
+}
+
+Error Tiktoken::decode_append(uint64_t prev, uint64_t cur, std::string& out)
+    const {
   (void)prev;
   ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(cur));
-  std::string ret;
-
-  std::string token_bytes;
-  auto iter = _decoder.find(cur);
-  if (iter != _decoder.end()) {
-    token_bytes = iter->second;
-  } else {
-    iter = _special_token_decoder.find(cur);
-    if (iter != _special_token_decoder.end()) {
-      token_bytes = iter->second;
-    } else {
-      ET_CHECK_MSG(false, "unknown token: %" PRIu64, cur);
-    }
-  }
-  ret += token_bytes;
-
-  return ret;
+  auto token_bytes = _decode_token(cur);
+  ET_CHECK_MSG(token_bytes.has_value(), "unknown token: %" PRIu64, cur);
+  out += *token_bytes;
+  return Error::Ok;
 }
 // -------------------------public method end-------------------------------
 
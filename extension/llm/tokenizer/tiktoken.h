@@ -9,18 +9,51 @@
 #pragma once
 
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
+#include <executorch/runtime/core/freeable_buffer.h>
 #include <re2/re2.h>
 #include <memory>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace torch {
 namespace executor {
 
-using Encoder = std::unordered_map<std::string, uint64_t>;
-using Decoder = std::unordered_map<uint64_t, std::string>;
+// The keys of an Encoder view the strings owned by the corresponding Decoder,
+// so that substrings of the input are looked up without being copied.
+using Encoder = std::unordered_map<std::string_view, uint64_t>;
+// Indexed by token id, from the first id of the decoder.
+using Decoder = std::vector<std::string>;
 using Re2UPtr = std::unique_ptr<re2::RE2>;
 
+/**
+ * The base tokens of a Tiktoken, laid out like in a compiled tokenizer file
+ * (see compile_tiktoken.py) so that such a file is used in place:
+ *
+ * - The bytes of token i are bytes[offsets[i], offsets[i + 1]).
+ * - slots is an open addressing hash table of num_slots, a power of 2. The
+ *   slot of token i holds i + 1, and is found by linear probing from
+ *   fnv1a(bytes of token i) % num_slots. Empty slots hold 0.
+ *
+ * The arrays either view a memory mapped compiled file, or what load() built
+ * from a text file.
+ */
+struct TiktokenVocab {
+  uint32_t num_tokens = 0;
+  uint32_t num_slots = 0;
+  const uint32_t* offsets = nullptr;
+  const uint32_t* slots = nullptr;
+  const char* bytes = nullptr;
+
+  std::string_view token(uint64_t id) const {
+    return std::string_view(bytes + offsets[id], offsets[id + 1] - offsets[id]);
+  }
+
+  /// Returns the id of the token made of the given bytes, if any.
+  std::optional<uint64_t> find(std::string_view piece) const;
+};
+
 class Tiktoken : public Tokenizer {
  public:
   /**
@@ -41,6 +74,9 @@ class Tiktoken : public Tokenizer {
   Result<std::string> decode(uint64_t prev_token, uint64_t token)
       const override;
 
+  Error decode_append(uint64_t prev_token, uint64_t token, std::string& out)
+      const override;
+
  private:
   template <typename T>
   std::pair<std::optional<std::string>, re2::StringPiece>
@@ -60,15 +96,26 @@ class Tiktoken : public Tokenizer {
 
   Encoder _build_special_token_encoder(ssize_t num_base_tokens) const;
 
+  Error _load_compiled_vocab(const std::string& path);
+
+  void _build_vocab(const Decoder& decoder);
+
+  std::optional<std::string_view> _decode_token(uint64_t token) const;
+
   std::unique_ptr<std::vector<std::string>> _special_tokens;
   size_t _bos_token_index;
   size_t _eos_token_index;
   // Removed negative lookahead \s+(?!\S) since it's not supported by RE2.
   const std::string _pattern =
       R"((?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}| ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+)";
-  Encoder _encoder;
+  TiktokenVocab _vocab;
+  // The storage of _vocab when it is loaded from a text file.
+  std::vector<uint32_t> _vocab_offsets;
+  std::vector<uint32_t> _vocab_slots;
+  std::vector<char> _vocab_bytes;
+  // The storage of _vocab when it is loaded from a compiled file.
+  std::unique_ptr<FreeableBuffer> _compiled_vocab;
   Encoder _special_token_encoder;
-  Decoder _decoder;
   Decoder _special_token_decoder;
 
   Re2UPtr _regex;
@@ -50,6 +50,21 @@ class Tokenizer {
   virtual Result<std::string> decode(uint64_t prev_token, uint64_t token)
       const = 0;
 
+  /**
+   * Appends the text of `token`, which follows `prev_token`, to `out`. Same
+   * as appending the result of decode(), which this defaults to, but
+   * tokenizers override it to append without making a string per token.
+   */
+  virtual Error decode_append(
+      uint64_t prev_token,
+      uint64_t token,
+      std::string& out) const {
+    Result<std::string> piece = decode(prev_token, token);
+    ET_CHECK_OK_OR_RETURN_ERROR(piece.error());
+    out += piece.get();
+    return Error::Ok;
+  }
+
   // getters
   int32_t vocab_size() const {
     return vocab_size_;
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <executorch/extension/memory_allocator/numa_memory_allocator.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * The pages that back the memory of a HugePageMemoryAllocator.
+ */
+enum class HugePages {
+  /// Regular pages.
+  None,
+  /// Transparent huge pages: the memory is aligned to and advised for huge
+  /// pages, which the kernel backs with them when it can and with regular
+  /// pages otherwise.
+  Transparent,
+  /// Explicit huge pages from the pool reserved through
+  /// /proc/sys/vm/nr_hugepages. Falls back to transparent huge pages when the
+  /// pool is empty.
+  Explicit,
+};
+
+/**
+ * Allocates memory from large chunks backed by huge pages, e.g. for the
+ * activation arenas of large models, where 4K pages cost many TLB misses and
+ * page faults on first use. Each allocation is carved from the current chunk,
+ * and a new chunk of at least `chunk_size` bytes is mapped when it doesn't
+ * fit.
+ *
+ * reset() keeps the chunks mapped and reuses them for the allocations that
+ * follow, so that an allocator reset after each execution, like the temp
+ * allocator of a method, doesn't map and fault in its memory again. The
+ * memory is only unmapped when the allocator is destroyed.
+ *
+ * Huge pages are only supported on Linux. Elsewhere the memory comes from
+ * malloc(), with the same chunking and prefaulting.
+ */
+class HugePageMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// The size of the huge pages the memory is aligned to.
+  static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+  /**
+   * Constructs a new allocator.
+   *
+   * @param[in] huge_pages The pages to back the memory with.
+   * @param[in] prefault Whether to fault in each chunk when it is mapped, so
+   * that the first execution doesn't pay for the page faults.
+   * @param[in] numa_node The NUMA node to bind the memory to, or -1 to leave
+   * it to the OS. See bind_memory_to_numa_node().
+   * @param[in] chunk_size The minimum size of the chunks, rounded up to a
+   * whole number of huge pages.
+   */
+  explicit HugePageMemoryAllocator(
+      HugePages huge_pages = HugePages::Transparent,
+      bool prefault = false,
+      int numa_node = -1,
+      size_t chunk_size = kHugePageSize)
+      : MemoryAllocator(0, nullptr),
+        huge_pages_(huge_pages),
+        prefault_(prefault),
+        numa_node_(numa_node),
+        chunk_size_(round_up(chunk_size, kHugePageSize)) {}
+
+  ~HugePageMemoryAllocator() override {
+    for (const auto& chunk : chunks_) {
+      unmap(chunk);
+    }
+  }
+
+  HugePageMemoryAllocator(const HugePageMemoryAllocator&) = delete;
+  HugePageMemoryAllocator& operator=(const HugePageMemoryAllocator&) = delete;
+
+  /**
+   * Allocates 'size' bytes of memory, returning a pointer to the allocated
+   * region, or nullptr upon failure.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+    // Moves on through the chunks kept by reset() until one has room.
+    while (current_ < chunks_.size()) {
+      const Chunk& chunk = chunks_[current_];
+      uint8_t* aligned = alignPointer(chunk.data + offset_, alignment);
+      if (aligned <= chunk.data + chunk.size &&
+          size <= static_cast<size_t>(chunk.data + chunk.size - aligned)) {
+        offset_ = aligned + size - chunk.data;
+        used_size_ += size;
+        return aligned;
+      }
+      ++current_;
+      offset_ = 0;
+    }
+    // Leaves room to align the start of the allocation.
+    Chunk chunk = map(std::max(chunk_size_, size + alignment));
+    if (chunk.data == nullptr) {
+      return nullptr;
+    }
+    chunks_.push_back(chunk);
+    current_ = chunks_.size() - 1;
+    uint8_t* aligned = alignPointer(chunk.data, alignment);
+    offset_ = aligned + size - chunk.data;
+    used_size_ += size;
+    return aligned;
+  }
+
+  // Returns the number of bytes allocated since the last reset.
+  size_t used_size() const override {
+    return used_size_;
+  }
+
+  // Makes all the memory available again, without unmapping it.
+  void reset() override {
+    current_ = 0;
+    offset_ = 0;
+    used_size_ = 0;
+  }
+
+  /// Returns the number of bytes mapped, which stay mapped across resets.
+  size_t mapped_size() const {
+    size_t size = 0;
+    for (const auto& chunk : chunks_) {
+      size += chunk.size;
+    }
+    return size;
+  }
+
+ private:
+  struct Chunk {
+    uint8_t* data;
+    size_t size;
+    // Where to unmap or free the chunk from, if not data.
+    void* base;
+    size_t base_size;
+  };
+
+  static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  Chunk map(size_t size) {
+    size = round_up(size, kHugePageSize);
+    Chunk chunk{nullptr, size, nullptr, 0};
+#if defined(__linux__)
+    if (huge_pages_ == HugePages::Explicit) {
+      void* data = mmap(
+          nullptr,
+          size,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+          /*fd=*/-1,
+          /*offset=*/0);
+      if (data != MAP_FAILED) {
+        chunk = {static_cast<uint8_t*>(data), size, data, size};
+      } else if (!warned_) {
+        ET_LOG(
+            Info,
+            "No explicit huge pages for %zu bytes (errno %d), using "
+            "transparent huge pages",
+            size,
+            errno);
+        warned_ = true;
+      }
+    }
+    if (chunk.data == nullptr) {
+      // Over-maps by a huge page to align the start to one.
+      const size_t base_size =
+          huge_pages_ == HugePages::None ? size : size + kHugePageSize;
+      void* base = mmap(
+          nullptr,
+          base_size,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS,
+          /*fd=*/-1,
+          /*offset=*/0);
+      if (base == MAP_FAILED) {
+        ET_LOG(Error, "Mapping %zu bytes failed: errno %d", base_size, errno);
+        return chunk;
+      }
+      chunk = {
+          huge_pages_ == HugePages::None
+              ? static_cast<uint8_t*>(base)
+              : alignPointer(base, kHugePageSize),
+          size,
+          base,
+          base_size};
+#if defined(MADV_HUGEPAGE)
+      if (huge_pages_ != HugePages::None &&
+          madvise(chunk.data, size, MADV_HUGEPAGE) != 0 && !warned_) {
+        ET_LOG(Info, "Transparent huge pages are not available");
+        warned_ = true;
+      }
+#endif
+    }
+#else
+    void* base = std::malloc(size);
+    if (base == nullptr) {
+      ET_LOG(Error, "Allocating %zu bytes failed", size);
+      return chunk;
+    }
+    chunk = {static_cast<uint8_t*>(base), size, base, size};
+#endif
+    if (numa_node_ >= 0) {
+      // Before the pages are touched, so that they are allocated there.
+      (void)bind_memory_to_numa_node(chunk.data, size, numa_node_);
+    }
+    if (prefault_) {
+      // Writing a byte of each page faults it in.
+      volatile uint8_t* const data = chunk.data;
+      for (size_t offset = 0; offset < size; offset += page_size()) {
+        data[offset] = 0;
+      }
+    }
+    return chunk;
+  }
+
+  static void unmap(const Chunk& chunk) {
+#if defined(__linux__)
+    munmap(chunk.base, chunk.base_size);
+#else
+    std::free(chunk.base);
+#endif
+  }
+
+  static size_t page_size() {
+#if defined(__linux__)
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+  }
+
+  const HugePages huge_pages_;
+  const bool prefault_;
+  const int numa_node_;
+  const size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  // The chunk and offset that the next allocation starts from.
+  size_t current_ = 0;
+  size_t offset_ = 0;
+  size_t used_size_ = 0;
+  bool warned_ = false;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -60,20 +60,29 @@ class MallocMemoryAllocator : public executorch::runtime::MemoryAllocator {
       // this is the only portable way to get aligned memory from the heap.
       size += alignment;
     }
+    used_size_ += size;
     mem_ptrs_.emplace_back(std::malloc(size));
     return alignPointer(mem_ptrs_.back(), alignment);
   }
 
+  // Returns the number of bytes requested from malloc() since the last reset,
+  // including the extra bytes used for alignment.
+  size_t used_size() const override {
+    return used_size_;
+  }
+
   // Free up each hosted memory pointer. The memory was created via malloc.
   void reset() override {
     for (auto mem_ptr : mem_ptrs_) {
       free(mem_ptr);
     }
     mem_ptrs_.clear();
+    used_size_ = 0;
   }
 
  private:
   std::vector<void*> mem_ptrs_;
+  size_t used_size_ = 0;
 };
 
 } // namespace extension
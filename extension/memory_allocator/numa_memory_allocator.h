@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Binds the whole pages of [data, data + size) to the NUMA node `numa_node`,
+ * moving the pages that are already backed there, so that a buffer allocated
+ * by one thread is local to the threads that will use it.
+ *
+ * @returns Error::Ok on success, Error::InvalidArgument if the node doesn't
+ * exist, Error::NotSupported where NUMA binding isn't supported, i.e. off
+ * Linux, and Error::Internal if the kernel refused it.
+ */
+inline executorch::runtime::Error
+bind_memory_to_numa_node(void* data, size_t size, int numa_node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  // From <numaif.h>, which needs libnuma.
+  constexpr int kMpolBind = 2;
+  constexpr unsigned kMpolMfMove = 1 << 1;
+  constexpr int kMaxNodes = 1024;
+  constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+  if (numa_node < 0 || numa_node >= kMaxNodes) {
+    ET_LOG(Error, "Invalid NUMA node %d", numa_node);
+    return executorch::runtime::Error::InvalidArgument;
+  }
+  const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t begin =
+      (reinterpret_cast<uintptr_t>(data) + page_size - 1) & ~(page_size - 1);
+  const uintptr_t end =
+      (reinterpret_cast<uintptr_t>(data) + size) & ~(page_size - 1);
+  if (end <= begin) {
+    // No whole page to bind.
+    return executorch::runtime::Error::Ok;
+  }
+  unsigned long node_mask[kMaxNodes / kBitsPerWord] = {};
+  node_mask[numa_node / kBitsPerWord] = 1UL << (numa_node % kBitsPerWord);
+  // The kernel reads one bit less than maxnode.
+  if (syscall(
+          SYS_mbind,
+          begin,
+          end - begin,
+          kMpolBind,
+          node_mask,
+          kMaxNodes + 1,
+          kMpolMfMove) != 0) {
+    const int error = errno;
+    ET_LOG(
+        Error,
+        "Binding %zu bytes to NUMA node %d failed: errno %d",
+        static_cast<size_t>(end - begin),
+        numa_node,
+        error);
+    return error == EINVAL ? executorch::runtime::Error::InvalidArgument
+                           : executorch::runtime::Error::Internal;
+  }
+  return executorch::runtime::Error::Ok;
+#else
+  (void)data;
+  (void)size;
+  (void)numa_node;
+  return executorch::runtime::Error::NotSupported;
+#endif
+}
+
+/**
+ * Dynamically allocates memory on a NUMA node and frees all of it at
+ * destruction time.
+ *
+ * Memory is mapped in chunks whose pages are bound to the node before they
+ * are first touched, so that it is local to the node whichever thread
+ * allocates or first writes it, e.g. for the allocations of a model replica
+ * that runs on one socket of a multi-socket server. Requests larger than a
+ * chunk get their own mapping.
+ *
+ * If the memory can't be bound, e.g. off Linux or on an invalid node, it is
+ * still allocated, without any placement, and this is logged once.
+ */
+class NumaMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// The default size of the chunks that allocations are carved from.
+  static constexpr size_t kDefaultChunkSize = 2 * 1024 * 1024;
+
+  /**
+   * Constructs an allocator for the NUMA node `numa_node`.
+   *
+   * @param[in] numa_node The node to allocate memory on, as numbered by the
+   * OS.
+   * @param[in] chunk_size The size of the chunks that small allocations are
+   * carved from.
+   */
+  explicit NumaMemoryAllocator(
+      int numa_node,
+      size_t chunk_size = kDefaultChunkSize)
+      : MemoryAllocator(0, nullptr),
+        numa_node_(numa_node),
+        chunk_size_(chunk_size) {}
+
+  ~NumaMemoryAllocator() override {
+    reset();
+  }
+
+  NumaMemoryAllocator(const NumaMemoryAllocator&) = delete;
+  NumaMemoryAllocator& operator=(const NumaMemoryAllocator&) = delete;
+
+  /**
+   * Allocates 'size' bytes of memory, returning a pointer to the allocated
+   * region, or nullptr upon failure.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+    uint8_t* aligned =
+        next_ != nullptr ? alignPointer(next_, alignment) : nullptr;
+    if (aligned == nullptr || aligned > end_ ||
+        size > static_cast<size_t>(end_ - aligned)) {
+      // Leaves room to align the start of the allocation.
+      const size_t padded_size = size + alignment;
+      if (padded_size > chunk_size_ / 2) {
+        // Too large to share a chunk.
+        uint8_t* data = map(padded_size);
+        return data != nullptr ? alignPointer(data, alignment) : nullptr;
+      }
+      uint8_t* chunk = map(chunk_size_);
+      if (chunk == nullptr) {
+        return nullptr;
+      }
+      next_ = chunk;
+      end_ = chunk + chunk_size_;
+      aligned = alignPointer(next_, alignment);
+    }
+    next_ = aligned + size;
+    return aligned;
+  }
+
+  // Returns the number of bytes mapped since the last reset.
+  size_t used_size() const override {
+    return used_size_;
+  }
+
+  // Unmaps all the memory allocated so far.
+  void reset() override {
+    for (const auto& mapping : mappings_) {
+      unmap(mapping.data, mapping.size);
+    }
+    mappings_.clear();
+    next_ = nullptr;
+    end_ = nullptr;
+    used_size_ = 0;
+  }
+
+  int numa_node() const {
+    return numa_node_;
+  }
+
+ private:
+  struct Mapping {
+    void* data;
+    size_t size;
+  };
+
+  uint8_t* map(size_t size) {
+#if defined(__linux__)
+    void* data = mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        /*fd=*/-1,
+        /*offset=*/0);
+    if (data == MAP_FAILED) {
+      ET_LOG(Error, "Mapping %zu bytes failed: errno %d", size, errno);
+      return nullptr;
+    }
+#else
+    void* data = std::malloc(size);
+    if (data == nullptr) {
+      return nullptr;
+    }
+#endif
+    if (bind_memory_to_numa_node(data, size, numa_node_) !=
+            executorch::runtime::Error::Ok &&
+        !warned_) {
+      ET_LOG(
+          Info,
+          "Memory is allocated without binding it to NUMA node %d",
+          numa_node_);
+      warned_ = true;
+    }
+    mappings_.push_back({data, size});
+    used_size_ += size;
+    return static_cast<uint8_t*>(data);
+  }
+
+  static void unmap(void* data, size_t size) {
+#if defined(__linux__)
+    munmap(data, size);
+#else
+    (void)size;
+    std::free(data);
+#endif
+  }
+
+  const int numa_node_;
+  const size_t chunk_size_;
+  std::vector<Mapping> mappings_;
+  uint8_t* next_ = nullptr;
+  uint8_t* end_ = nullptr;
+  size_t used_size_ = 0;
+  bool warned_ = false;
+};
+
+} // namespace extension
+} // namespace executorch
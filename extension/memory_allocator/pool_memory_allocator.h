@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A MemoryAllocator over a fixed buffer that can also free() individual
+ * allocations, so that scratch memory with different lifetimes can share one
+ * buffer without reserving the sum of all of them.
+ *
+ * Requests are rounded up to a power-of-two size class. Freed blocks go on a
+ * per-class free list and are reused by later requests of the same class;
+ * blocks are only carved from the unused tail of the buffer when their free
+ * list is empty. Blocks are never split or merged. reset() returns the whole
+ * buffer to the allocator, just like MemoryAllocator::reset(), which makes
+ * this class a drop-in replacement for the temp allocator.
+ *
+ * Never calls malloc(); all bookkeeping lives inside the provided buffer.
+ * Not thread-safe.
+ *
+ * Example:
+ * @code
+ *   static uint8_t temp_pool[64 * 1024];
+ *   PoolMemoryAllocator temp_allocator(sizeof(temp_pool), temp_pool);
+ *   void* a = temp_allocator.allocate(1000);
+ *   temp_allocator.free(a);
+ *   void* b = temp_allocator.allocate(900); // Reuses a's block.
+ * @endcode
+ */
+class PoolMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// The smallest block size, in bytes. Smaller requests are rounded up.
+  static constexpr size_t kMinBlockSize = 16;
+
+  /**
+   * Constructs a new pool allocator of a given `size`, starting at the
+   * provided `base_address`.
+   *
+   * @param[in] size The size in bytes of the buffer at `base_address`.
+   * @param[in] base_address The buffer to allocate from. Does not take
+   *     ownership of this buffer, so it must be valid for the lifetime of of
+   *     the PoolMemoryAllocator.
+   */
+  PoolMemoryAllocator(uint32_t size, uint8_t* base_address)
+      : MemoryAllocator(size, base_address),
+        cur_(base_address),
+        end_(base_address + size),
+        free_lists_(),
+        allocated_bytes_(0),
+        peak_allocated_bytes_(0),
+        peak_reserved_bytes_(0) {}
+
+  /**
+   * Allocates `size` bytes of memory, reusing a freed block of the same size
+   * class if one is suitably aligned.
+   *
+   * @param[in] size Number of bytes to allocate.
+   * @param[in] alignment Minimum alignment for the returned pointer. Must be a
+   *     power of 2.
+   *
+   * @returns Aligned pointer to the allocated memory on success.
+   * @retval nullptr Not enough memory, or `alignment` was not a power of 2.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+    const size_t size_class = size_class_for(size);
+    if (size_class >= kNumSizeClasses) {
+      ET_LOG(Error, "Memory allocation failed: %zuB requested", size);
+      return nullptr;
+    }
+    const size_t block_size = kMinBlockSize << size_class;
+
+    // Reuse the first free block of this class that is aligned well enough.
+    FreeBlock** link = &free_lists_[size_class];
+    while (*link != nullptr) {
+      FreeBlock* block = *link;
+      if ((reinterpret_cast<uintptr_t>(block) & (alignment - 1)) == 0) {
+        *link = block->next;
+        header_of(block)->in_use = 1;
+        return on_allocated(block, block_size);
+      }
+      link = &block->next;
+    }
+
+    // Carve a new block from the tail, with its header right before it.
+    if (alignment < kMinBlockAlignment) {
+      alignment = kMinBlockAlignment;
+    }
+    uint8_t* start = alignPointer(cur_ + sizeof(BlockHeader), alignment);
+    if (start > end_ || block_size > static_cast<size_t>(end_ - start)) {
+      ET_LOG(
+          Error,
+          "Memory allocation failed: %zuB requested (rounded to %zuB), %zuB available",
+          size,
+          block_size,
+          static_cast<size_t>(end_ - cur_));
+      return nullptr;
+    }
+    BlockHeader* header = header_of(start);
+    header->size_class = static_cast<uint32_t>(size_class);
+    header->in_use = 1;
+    cur_ = start + block_size;
+    const size_t reserved = static_cast<size_t>(cur_ - base_address());
+    if (reserved > peak_reserved_bytes_) {
+      peak_reserved_bytes_ = reserved;
+    }
+    return on_allocated(start, block_size);
+  }
+
+  /**
+   * Returns a block previously returned by allocate() to the pool. Does
+   * nothing if `ptr` is null. Logs an error and ignores the call if `ptr` does
+   * not belong to this allocator or was already freed.
+   */
+  void free(void* ptr) {
+    if (ptr == nullptr) {
+      return;
+    }
+    uint8_t* block = static_cast<uint8_t*>(ptr);
+    if (block < base_address() + sizeof(BlockHeader) || block >= cur_) {
+      ET_LOG(Error, "Pointer %p does not belong to this allocator", ptr);
+      return;
+    }
+    BlockHeader* header = header_of(block);
+    if (header->in_use != 1 || header->size_class >= kNumSizeClasses) {
+      ET_LOG(Error, "Pointer %p is not an allocated block", ptr);
+      return;
+    }
+    header->in_use = 0;
+    allocated_bytes_ -= kMinBlockSize << header->size_class;
+    FreeBlock* free_block = reinterpret_cast<FreeBlock*>(block);
+    free_block->next = free_lists_[header->size_class];
+    free_lists_[header->size_class] = free_block;
+  }
+
+  /// Returns the number of bytes of the buffer that blocks, free or not, and
+  /// their headers occupy.
+  size_t used_size() const override {
+    return static_cast<size_t>(cur_ - base_address());
+  }
+
+  /// Frees every allocation at once. The peak statistics are kept.
+  void reset() override {
+    cur_ = base_address();
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      free_lists_[i] = nullptr;
+    }
+    allocated_bytes_ = 0;
+  }
+
+  /// Returns the number of bytes in currently allocated blocks.
+  size_t allocated_bytes() const {
+    return allocated_bytes_;
+  }
+
+  /// Returns the largest value allocated_bytes() has reached.
+  size_t peak_allocated_bytes() const {
+    return peak_allocated_bytes_;
+  }
+
+  /**
+   * Returns the largest number of bytes of the buffer, including headers and
+   * padding, that have been handed out to blocks at the same time. A buffer
+   * of this size would have satisfied every allocation made so far.
+   */
+  size_t peak_reserved_bytes() const {
+    return peak_reserved_bytes_;
+  }
+
+  /// Clears the peak statistics, e.g. before measuring a new workload.
+  void reset_peak_stats() {
+    peak_allocated_bytes_ = allocated_bytes_;
+    peak_reserved_bytes_ = static_cast<size_t>(cur_ - base_address());
+  }
+
+ private:
+  /// Blocks of the largest class are kMinBlockSize << (kNumSizeClasses - 1)
+  /// bytes, or 2 GiB.
+  static constexpr size_t kNumSizeClasses = 28;
+
+  /// New blocks are at least this aligned, so that free blocks can hold a
+  /// FreeBlock and satisfy the common alignments without being skipped.
+  static constexpr size_t kMinBlockAlignment = alignof(std::max_align_t);
+
+  /// Stored immediately before every block.
+  struct BlockHeader {
+    uint32_t size_class;
+    uint32_t in_use;
+  };
+
+  /// Overlays the contents of a block while it is on a free list.
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static_assert(sizeof(FreeBlock) <= kMinBlockSize, "Block too small");
+
+  static BlockHeader* header_of(void* block) {
+    return reinterpret_cast<BlockHeader*>(
+        static_cast<uint8_t*>(block) - sizeof(BlockHeader));
+  }
+
+  /// Returns the smallest size class that holds `size` bytes.
+  static size_t size_class_for(size_t size) {
+    size_t size_class = 0;
+    while (size_class < kNumSizeClasses &&
+           (kMinBlockSize << size_class) < size) {
+      ++size_class;
+    }
+    return size_class;
+  }
+
+  void* on_allocated(void* block, size_t block_size) {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), block_size);
+    allocated_bytes_ += block_size;
+    if (allocated_bytes_ > peak_allocated_bytes_) {
+      peak_allocated_bytes_ = allocated_bytes_;
+    }
+    return block;
+  }
+
+  uint8_t* cur_;
+  uint8_t* const end_;
+  FreeBlock* free_lists_[kNumSizeClasses];
+  size_t allocated_bytes_;
+  size_t peak_allocated_bytes_;
+  size_t peak_reserved_bytes_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Wraps another MemoryAllocator so that it can be called from several threads
+ * at once, e.g. by backends whose delegates are initialized concurrently by
+ * Program::load_method().
+ *
+ * @code
+ *   MemoryAllocator pool(sizeof(buffer), buffer);
+ *   SynchronizedMemoryAllocator method_allocator(&pool);
+ *   MemoryManager memory_manager(&method_allocator, &planned_memory);
+ *   Result<Method> method = program->load_method(
+ *       "forward", &memory_manager, nullptr, &task_runner);
+ * @endcode
+ */
+class SynchronizedMemoryAllocator
+    : public executorch::runtime::MemoryAllocator {
+ public:
+  /**
+   * @param[in] allocator The allocator that provides the memory. Must outlive
+   *     this allocator, and must not be used directly while it is in use.
+   */
+  explicit SynchronizedMemoryAllocator(
+      executorch::runtime::MemoryAllocator* allocator)
+      : MemoryAllocator(0, nullptr), allocator_(allocator) {}
+
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocator_->allocate(size, alignment);
+  }
+
+  uint8_t* base_address() const override {
+    return allocator_->base_address();
+  }
+
+  uint32_t size() const override {
+    return allocator_->size();
+  }
+
+  size_t used_size() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocator_->used_size();
+  }
+
+  void reset() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    allocator_->reset();
+  }
+
+ private:
+  executorch::runtime::MemoryAllocator* const allocator_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/huge_page_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::HugePageMemoryAllocator;
+using executorch::extension::HugePages;
+
+class HugePageMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+TEST_F(HugePageMemoryAllocatorTest, AllocatesAlignedWritableMemory) {
+  // Explicit huge pages fall back to transparent ones when none are reserved.
+  for (HugePages huge_pages :
+       {HugePages::None, HugePages::Transparent, HugePages::Explicit}) {
+    HugePageMemoryAllocator allocator(huge_pages);
+
+    std::vector<void*> ptrs;
+    for (size_t alignment : {1, 8, 16, 64, 256}) {
+      void* p = allocator.allocate(100, alignment);
+      ASSERT_NE(p, nullptr);
+      EXPECT_TRUE(is_aligned(p, alignment));
+      std::memset(p, static_cast<int>(alignment), 100);
+      ptrs.push_back(p);
+    }
+    // Larger than a chunk.
+    const size_t large_size = 3 * HugePageMemoryAllocator::kHugePageSize;
+    void* large = allocator.allocate(large_size, 4096);
+    ASSERT_NE(large, nullptr);
+    EXPECT_TRUE(is_aligned(large, 4096));
+    std::memset(large, 0xab, large_size);
+
+    // Allocations don't overlap.
+    size_t i = 0;
+    for (size_t alignment : {1, 8, 16, 64, 256}) {
+      const auto* bytes = static_cast<const uint8_t*>(ptrs[i++]);
+      for (size_t j = 0; j < 100; ++j) {
+        ASSERT_EQ(bytes[j], static_cast<uint8_t>(alignment));
+      }
+    }
+    EXPECT_EQ(allocator.used_size(), 5 * 100 + large_size);
+    EXPECT_EQ(
+        allocator.mapped_size() % HugePageMemoryAllocator::kHugePageSize, 0);
+  }
+}
+
+TEST_F(HugePageMemoryAllocatorTest, ChunksAreHugePageAligned) {
+  HugePageMemoryAllocator allocator(HugePages::Transparent);
+  void* p = allocator.allocate(100, 1);
+  ASSERT_NE(p, nullptr);
+  EXPECT_TRUE(is_aligned(p, HugePageMemoryAllocator::kHugePageSize));
+}
+
+TEST_F(HugePageMemoryAllocatorTest, ResetReusesTheMappedMemory) {
+  HugePageMemoryAllocator allocator(HugePages::Transparent, /*prefault=*/true);
+  const size_t large_size = 3 * HugePageMemoryAllocator::kHugePageSize;
+  void* small = allocator.allocate(100);
+  void* large = allocator.allocate(large_size);
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  const size_t mapped_size = allocator.mapped_size();
+
+  allocator.reset();
+  EXPECT_EQ(allocator.used_size(), 0);
+  // The same allocations land in the same memory, without mapping more.
+  EXPECT_EQ(allocator.allocate(100), small);
+  EXPECT_EQ(allocator.allocate(large_size), large);
+  EXPECT_EQ(allocator.mapped_size(), mapped_size);
+}
+
+TEST_F(HugePageMemoryAllocatorTest, InvalidAlignmentFails) {
+  HugePageMemoryAllocator allocator;
+  EXPECT_EQ(allocator.allocate(100, 3), nullptr);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/numa_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::bind_memory_to_numa_node;
+using executorch::extension::NumaMemoryAllocator;
+using executorch::runtime::Error;
+
+class NumaMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+TEST_F(NumaMemoryAllocatorTest, AllocatesAlignedWritableMemory) {
+  // Node 0 exists on every system, NUMA or not.
+  NumaMemoryAllocator allocator(/*numa_node=*/0, /*chunk_size=*/4096);
+  EXPECT_EQ(allocator.numa_node(), 0);
+
+  std::vector<void*> ptrs;
+  for (size_t alignment : {1, 8, 16, 64, 256}) {
+    void* p = allocator.allocate(100, alignment);
+    ASSERT_NE(p, nullptr);
+    EXPECT_TRUE(is_aligned(p, alignment));
+    std::memset(p, static_cast<int>(alignment), 100);
+    ptrs.push_back(p);
+  }
+  // Larger than a chunk.
+  void* large = allocator.allocate(1 << 20, 4096);
+  ASSERT_NE(large, nullptr);
+  EXPECT_TRUE(is_aligned(large, 4096));
+  std::memset(large, 0xab, 1 << 20);
+
+  // Allocations don't overlap.
+  size_t i = 0;
+  for (size_t alignment : {1, 8, 16, 64, 256}) {
+    const auto* bytes = static_cast<const uint8_t*>(ptrs[i++]);
+    for (size_t j = 0; j < 100; ++j) {
+      ASSERT_EQ(bytes[j], static_cast<uint8_t>(alignment));
+    }
+  }
+  EXPECT_GE(allocator.used_size(), (1 << 20) + 4096);
+
+  allocator.reset();
+  EXPECT_EQ(allocator.used_size(), 0);
+  EXPECT_NE(allocator.allocate(100), nullptr);
+}
+
+TEST_F(NumaMemoryAllocatorTest, InvalidAlignmentFails) {
+  NumaMemoryAllocator allocator(/*numa_node=*/0);
+  EXPECT_EQ(allocator.allocate(100, 3), nullptr);
+}
+
+TEST_F(NumaMemoryAllocatorTest, UnboundMemoryIsStillAllocated) {
+  // The node doesn't exist, so the memory can't be bound to it.
+  NumaMemoryAllocator allocator(/*numa_node=*/-1);
+  void* p = allocator.allocate(100);
+  ASSERT_NE(p, nullptr);
+  std::memset(p, 0, 100);
+}
+
+TEST_F(NumaMemoryAllocatorTest, BindInvalidNodeFails) {
+  std::vector<uint8_t> buffer(1 << 16);
+  const Error error =
+      bind_memory_to_numa_node(buffer.data(), buffer.size(), -1);
+  EXPECT_TRUE(error == Error::InvalidArgument || error == Error::NotSupported);
+}
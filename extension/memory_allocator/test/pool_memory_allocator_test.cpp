@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/pool_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::PoolMemoryAllocator;
+
+class PoolMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+
+  alignas(64) uint8_t buffer_[4096];
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+TEST_F(PoolMemoryAllocatorTest, AllocationsDoNotOverlap) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  uint8_t* a = static_cast<uint8_t*>(allocator.allocate(10));
+  uint8_t* b = static_cast<uint8_t*>(allocator.allocate(100));
+  uint8_t* c = static_cast<uint8_t*>(allocator.allocate(1));
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_NE(c, nullptr);
+
+  // Sizes are rounded up to a power of two of at least kMinBlockSize.
+  EXPECT_GE(b, a + PoolMemoryAllocator::kMinBlockSize);
+  EXPECT_GE(c, b + 128);
+  EXPECT_EQ(allocator.allocated_bytes(), 16 + 128 + 16);
+
+  // Every allocation stays inside the buffer.
+  EXPECT_GE(a, buffer_);
+  EXPECT_LE(c + 16, buffer_ + sizeof(buffer_));
+}
+
+TEST_F(PoolMemoryAllocatorTest, FreedBlocksAreReused) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(200);
+  void* b = allocator.allocate(200);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  const size_t reserved = allocator.peak_reserved_bytes();
+
+  allocator.free(a);
+  EXPECT_EQ(allocator.allocated_bytes(), 256);
+
+  // A request of the same size class gets the freed block back.
+  EXPECT_EQ(allocator.allocate(150), a);
+  EXPECT_EQ(allocator.peak_reserved_bytes(), reserved);
+
+  // A different size class does not.
+  allocator.free(b);
+  void* c = allocator.allocate(20);
+  EXPECT_NE(c, b);
+  EXPECT_GT(allocator.peak_reserved_bytes(), reserved);
+}
+
+TEST_F(PoolMemoryAllocatorTest, FreeListRespectsAlignment) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(64, 16);
+  ASSERT_NE(a, nullptr);
+  allocator.free(a);
+
+  void* b = allocator.allocate(64, 256);
+  ASSERT_NE(b, nullptr);
+  EXPECT_TRUE(is_aligned(b, 256));
+  if (!is_aligned(a, 256)) {
+    EXPECT_NE(a, b);
+  }
+
+  // Non-power-of-two alignments are rejected.
+  EXPECT_EQ(allocator.allocate(64, 3), nullptr);
+}
+
+TEST_F(PoolMemoryAllocatorTest, LongLivedAndScratchBlocksShareBuffer) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  // A pattern that a bump allocator cannot serve without reset(): keep one
+  // block alive while repeatedly allocating and freeing scratch space.
+  void* long_lived = allocator.allocate(512);
+  ASSERT_NE(long_lived, nullptr);
+  for (int i = 0; i < 100; ++i) {
+    void* scratch = allocator.allocate(1024);
+    ASSERT_NE(scratch, nullptr);
+    allocator.free(scratch);
+  }
+  EXPECT_EQ(allocator.allocated_bytes(), 512);
+  EXPECT_EQ(allocator.peak_allocated_bytes(), 512 + 1024);
+  EXPECT_LT(allocator.peak_reserved_bytes(), 2 * (512 + 1024));
+}
+
+TEST_F(PoolMemoryAllocatorTest, FailsWhenFull) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  EXPECT_EQ(allocator.allocate(sizeof(buffer_)), nullptr);
+  EXPECT_NE(allocator.allocate(sizeof(buffer_) / 2), nullptr);
+  EXPECT_EQ(allocator.allocate(sizeof(buffer_) / 2), nullptr);
+}
+
+TEST_F(PoolMemoryAllocatorTest, FreeIgnoresInvalidPointers) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(32);
+  ASSERT_NE(a, nullptr);
+  allocator.free(nullptr);
+
+  uint8_t other[64];
+  allocator.free(other);
+  EXPECT_EQ(allocator.allocated_bytes(), 32);
+
+  allocator.free(a);
+  // Double free is detected and does not corrupt the free list.
+  allocator.free(a);
+  EXPECT_EQ(allocator.allocated_bytes(), 0);
+  EXPECT_EQ(allocator.allocate(32), a);
+  EXPECT_NE(allocator.allocate(32), a);
+}
+
+TEST_F(PoolMemoryAllocatorTest, ResetKeepsPeakStats) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(1000);
+  ASSERT_NE(a, nullptr);
+  const size_t peak_reserved = allocator.peak_reserved_bytes();
+  allocator.reset();
+
+  EXPECT_EQ(allocator.allocated_bytes(), 0);
+  EXPECT_EQ(allocator.peak_allocated_bytes(), 1024);
+  EXPECT_EQ(allocator.peak_reserved_bytes(), peak_reserved);
+
+  // The buffer is reused from the start.
+  EXPECT_EQ(allocator.allocate(1000), a);
+
+  allocator.reset();
+  allocator.reset_peak_stats();
+  EXPECT_EQ(allocator.peak_allocated_bytes(), 0);
+  EXPECT_EQ(allocator.peak_reserved_bytes(), 0);
+}
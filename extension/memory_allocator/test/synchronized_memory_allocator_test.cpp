@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/synchronized_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::SynchronizedMemoryAllocator;
+using executorch::runtime::MemoryAllocator;
+
+class SynchronizedMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(SynchronizedMemoryAllocatorTest, ForwardsToWrappedAllocator) {
+  alignas(16) uint8_t buffer[256];
+  MemoryAllocator pool(sizeof(buffer), buffer);
+  SynchronizedMemoryAllocator allocator(&pool);
+
+  EXPECT_EQ(allocator.base_address(), buffer);
+  EXPECT_EQ(allocator.size(), sizeof(buffer));
+  EXPECT_EQ(allocator.allocate(16), buffer);
+  EXPECT_EQ(allocator.used_size(), 16);
+  EXPECT_EQ(pool.used_size(), 16);
+  EXPECT_EQ(allocator.allocate(sizeof(buffer)), nullptr);
+
+  allocator.reset();
+  EXPECT_EQ(pool.used_size(), 0);
+}
+
+TEST_F(SynchronizedMemoryAllocatorTest, ConcurrentAllocationsDoNotOverlap) {
+  constexpr size_t kThreads = 4;
+  constexpr size_t kAllocationsPerThread = 100;
+  constexpr size_t kAllocationSize = 8;
+  std::vector<uint8_t> buffer(kThreads * kAllocationsPerThread * 16);
+  MemoryAllocator pool(buffer.size(), buffer.data());
+  SynchronizedMemoryAllocator allocator(&pool);
+
+  std::vector<std::vector<uint8_t*>> allocations(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < kAllocationsPerThread; ++i) {
+        allocations[t].push_back(static_cast<uint8_t*>(
+            allocator.allocate(kAllocationSize, /*alignment=*/8)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<uint8_t*> all;
+  for (const auto& thread_allocations : allocations) {
+    for (uint8_t* p : thread_allocations) {
+      ASSERT_NE(p, nullptr);
+      all.push_back(p);
+    }
+  }
+  std::sort(all.begin(), all.end());
+  for (size_t i = 1; i < all.size(); ++i) {
+    EXPECT_GE(all[i] - all[i - 1], kAllocationSize);
+  }
+}
@@ -15,3 +15,43 @@ def define_common_targets():
             "//executorch/extension/memory_allocator:malloc_memory_allocator",
         ],
     )
+
+    runtime.cxx_test(
+        name = "synchronized_memory_allocator_test",
+        srcs = [
+            "synchronized_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:synchronized_memory_allocator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "pool_memory_allocator_test",
+        srcs = [
+            "pool_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:pool_memory_allocator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "numa_memory_allocator_test",
+        srcs = [
+            "numa_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:numa_memory_allocator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "huge_page_memory_allocator_test",
+        srcs = [
+            "huge_page_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:huge_page_memory_allocator",
+        ],
+    )
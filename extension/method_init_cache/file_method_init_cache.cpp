@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/method_init_cache/file_method_init_cache.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+void unmap_snapshot(void* /*context*/, void* data, size_t size) {
+  if (::munmap(data, size) < 0) {
+    ET_LOG(
+        Error,
+        "munmap(%p, %zu) failed: %s (ignored)",
+        data,
+        size,
+        ::strerror(errno));
+  }
+}
+
+} // namespace
+
+std::string FileMethodInitCache::snapshot_path(const char* method_name) const {
+  return directory_ + "/" + method_name + ".etinit";
+}
+
+Result<FreeableBuffer> FileMethodInitCache::load(const char* method_name) {
+  const std::string path = snapshot_path(method_name);
+  // Use open() instead of fopen() because mmap() needs a file descriptor.
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    // Nothing was saved yet.
+    return Error::NotFound;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) < 0 || st.st_size == 0) {
+    ::close(fd);
+    return Error::NotFound;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file alive.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    ET_LOG(
+        Info,
+        "Could not map method init snapshot '%s': %s",
+        path.c_str(),
+        ::strerror(errno));
+    return Error::AccessFailed;
+  }
+  return FreeableBuffer(data, size, unmap_snapshot);
+}
+
+void FileMethodInitCache::save(
+    const char* method_name,
+    const void* data,
+    size_t size) {
+  const std::string path = snapshot_path(method_name);
+  const std::string temp_path = path + ".tmp";
+  FILE* file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    ET_LOG(Info, "Could not open method init snapshot '%s'", temp_path.c_str());
+    return;
+  }
+  const bool written = std::fwrite(data, 1, size, file) == size;
+  if (std::fclose(file) != 0 || !written ||
+      std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    ET_LOG(Info, "Could not write method init snapshot '%s'", path.c_str());
+    std::remove(temp_path.c_str());
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <executorch/runtime/executor/method.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A Method::InitCache that keeps one snapshot file per method in a directory,
+ * and maps them into memory to load them, so that a warm load of a method
+ * skips resolving its operators:
+ *
+ * @code
+ *   FileMethodInitCache cache(app_cache_dir + "/model_init");
+ *   auto method = program->load_method(
+ *       "forward", &memory_manager, nullptr, nullptr, &cache);
+ * @endcode
+ *
+ * Snapshots are written to a temporary file that is then renamed over the
+ * previous one, so a concurrent load sees either snapshot whole. The Method
+ * checks what it reads against the program and the kernel registry, so a
+ * stale or damaged file only costs resolving the operators again. Use one
+ * directory per program, since methods of different programs can have the
+ * same name and would keep replacing each other's snapshots.
+ *
+ * The directory must already exist.
+ */
+class FileMethodInitCache final
+    : public executorch::runtime::Method::InitCache {
+ public:
+  /**
+   * @param[in] directory The directory that holds the snapshot files.
+   */
+  explicit FileMethodInitCache(std::string directory)
+      : directory_(std::move(directory)) {}
+
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      const char* method_name) override;
+
+  void save(const char* method_name, const void* data, size_t size) override;
+
+  /// Returns the path of the snapshot file of `method_name`.
+  std::string snapshot_path(const char* method_name) const;
+
+ private:
+  const std::string directory_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/method_init_cache/file_method_init_cache.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::FileMethodInitCache;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+class FileMethodInitCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    char dir[] = "/tmp/method_init_cache_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    dir_ = dir;
+  }
+
+  void TearDown() override {
+    for (const char* name : {"forward", "prefill"}) {
+      std::remove(FileMethodInitCache(dir_).snapshot_path(name).c_str());
+    }
+    rmdir(dir_.c_str());
+  }
+
+  std::string dir_;
+};
+
+TEST_F(FileMethodInitCacheTest, MissingSnapshotIsNotFound) {
+  FileMethodInitCache cache(dir_);
+  EXPECT_EQ(cache.load("forward").error(), Error::NotFound);
+}
+
+TEST_F(FileMethodInitCacheTest, LoadsSavedSnapshot) {
+  const char forward[] = "forward snapshot";
+  const char prefill[] = "prefill";
+  {
+    FileMethodInitCache cache(dir_);
+    cache.save("forward", forward, sizeof(forward));
+    cache.save("prefill", prefill, sizeof(prefill));
+  }
+
+  // A new instance finds the snapshots of each method.
+  FileMethodInitCache cache(dir_);
+  Result<FreeableBuffer> loaded = cache.load("forward");
+  ASSERT_EQ(loaded.error(), Error::Ok);
+  ASSERT_EQ(loaded->size(), sizeof(forward));
+  EXPECT_EQ(std::memcmp(loaded->data(), forward, sizeof(forward)), 0);
+
+  Result<FreeableBuffer> loaded_prefill = cache.load("prefill");
+  ASSERT_EQ(loaded_prefill.error(), Error::Ok);
+  ASSERT_EQ(loaded_prefill->size(), sizeof(prefill));
+  EXPECT_EQ(std::memcmp(loaded_prefill->data(), prefill, sizeof(prefill)), 0);
+}
+
+TEST_F(FileMethodInitCacheTest, SaveReplacesMappedSnapshot) {
+  FileMethodInitCache cache(dir_);
+  const char first[] = "first";
+  cache.save("forward", first, sizeof(first));
+  Result<FreeableBuffer> old_snapshot = cache.load("forward");
+  ASSERT_EQ(old_snapshot.error(), Error::Ok);
+
+  const char second[] = "second, longer";
+  cache.save("forward", second, sizeof(second));
+  Result<FreeableBuffer> new_snapshot = cache.load("forward");
+  ASSERT_EQ(new_snapshot.error(), Error::Ok);
+  ASSERT_EQ(new_snapshot->size(), sizeof(second));
+  EXPECT_EQ(std::memcmp(new_snapshot->data(), second, sizeof(second)), 0);
+
+  // The snapshot mapped before is unchanged.
+  ASSERT_EQ(old_snapshot->size(), sizeof(first));
+  EXPECT_EQ(std::memcmp(old_snapshot->data(), first, sizeof(first)), 0);
+}
+
+TEST_F(FileMethodInitCacheTest, SaveToMissingDirectoryIsIgnored) {
+  FileMethodInitCache cache(dir_ + "/missing");
+  const char data[] = "data";
+  cache.save("forward", data, sizeof(data));
+  EXPECT_EQ(cache.load("forward").error(), Error::NotFound);
+}
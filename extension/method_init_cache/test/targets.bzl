@@ -0,0 +1,18 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_test(
+        name = "file_method_init_cache_test",
+        srcs = [
+            "file_method_init_cache_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/method_init_cache:file_method_init_cache",
+        ],
+    )
@@ -8,9 +8,13 @@
 
 #include <executorch/extension/module/module.h>
 
+#include <algorithm>
+
+#include <executorch/extension/data_loader/decompressing_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/memory_allocator/numa_memory_allocator.h>
 #include <executorch/runtime/platform/runtime.h>
 
 /**
@@ -34,9 +38,12 @@
   })
 
 using ::exec_aten::Tensor;
+using ::executorch::extension::DecompressingDataLoader;
 using ::executorch::extension::FileDataLoader;
+using ::executorch::extension::HugePageMemoryAllocator;
 using ::executorch::extension::MallocMemoryAllocator;
 using ::executorch::extension::MmapDataLoader;
+using ::executorch::extension::NumaMemoryAllocator;
 using ::executorch::runtime::DataLoader;
 using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
@@ -58,7 +65,9 @@ Module::Module(
     std::unique_ptr<EventTracer> event_tracer)
     : file_path_(file_path),
       load_mode_(load_mode),
+      owns_memory_allocator_(true),
       memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      owns_temp_allocator_(true),
       temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
       event_tracer_(std::move(event_tracer)) {
   ::executorch::runtime::runtime_init();
@@ -70,9 +79,11 @@ Module::Module(
     std::unique_ptr<MemoryAllocator> temp_allocator,
     std::unique_ptr<EventTracer> event_tracer)
     : data_loader_(std::move(data_loader)),
+      owns_memory_allocator_(memory_allocator == nullptr),
       memory_allocator_(
           memory_allocator ? std::move(memory_allocator)
                            : std::make_unique<MallocMemoryAllocator>()),
+      owns_temp_allocator_(temp_allocator == nullptr),
       temp_allocator_(
           temp_allocator ? std::move(temp_allocator)
                          : std::make_unique<MallocMemoryAllocator>()),
@@ -86,9 +97,11 @@ Module::Module(
     std::unique_ptr<MemoryAllocator> temp_allocator,
     std::unique_ptr<EventTracer> event_tracer)
     : program_(std::move(program)),
+      owns_memory_allocator_(memory_allocator == nullptr),
       memory_allocator_(
           memory_allocator ? std::move(memory_allocator)
                            : std::make_unique<MallocMemoryAllocator>()),
+      owns_temp_allocator_(temp_allocator == nullptr),
       temp_allocator_(
           temp_allocator ? std::move(temp_allocator)
                          : std::make_unique<MallocMemoryAllocator>()),
@@ -119,11 +132,16 @@ Error Module::load(const Program::Verification verification) {
           break;
       }
     };
-    auto program =
-        ET_UNWRAP_UNIQUE(Program::load(data_loader_.get(), verification));
+    // Decompresses the segments that the program stores compressed.
+    auto decompressing_loader =
+        std::make_unique<DecompressingDataLoader>(data_loader_.get());
+    auto program = ET_UNWRAP_UNIQUE(
+        Program::load(decompressing_loader.get(), verification));
     program_ = std::shared_ptr<Program>(
         program.release(),
-        [data_loader = std::move(data_loader_)](Program* pointer) {
+        [data_loader = std::move(data_loader_),
+         decompressing_loader =
+             std::move(decompressing_loader)](Program* pointer) {
           delete pointer;
         });
   }
@@ -146,43 +164,352 @@ Result<std::unordered_set<std::string>> Module::method_names() {
   return result;
 }
 
+Result<Module::MethodHolder> Module::make_method_holder(
+    const std::string& method_name,
+    MemoryAllocator* memory_allocator,
+    MemoryAllocator* temp_allocator,
+    EventTracer* event_tracer,
+    const PlannedArena* planned_arena) {
+  MethodHolder method_holder;
+  const auto method_metadata =
+      ET_UNWRAP(program_->method_meta(method_name.c_str()));
+  const auto planned_buffersCount =
+      method_metadata.num_memory_planned_buffers();
+  std::vector<size_t> buffer_sizes;
+  buffer_sizes.reserve(planned_buffersCount);
+  for (auto index = 0; index < planned_buffersCount; ++index) {
+    buffer_sizes.push_back(
+        method_metadata.memory_planned_buffer_size(index).get());
+  }
+
+  if (planned_arena) {
+    ET_CHECK_OR_RETURN_ERROR(
+        planned_arena->spans.size() >= planned_buffersCount,
+        InvalidState,
+        "Planned arena has %zu buffers, method %s needs %zu",
+        planned_arena->spans.size(),
+        method_name.c_str(),
+        planned_buffersCount);
+  } else {
+    method_holder.planned_arena = ET_UNWRAP(make_planned_arena(buffer_sizes));
+    planned_arena = &method_holder.planned_arena;
+  }
+  method_holder.planned_spans.reserve(planned_buffersCount);
+  for (auto index = 0; index < planned_buffersCount; ++index) {
+    ET_CHECK_OR_RETURN_ERROR(
+        planned_arena->spans[index].size() >= buffer_sizes[index],
+        InvalidState,
+        "Planned arena buffer %d is too small for method %s",
+        index,
+        method_name.c_str());
+    method_holder.planned_spans.emplace_back(
+        planned_arena->spans[index].data(), buffer_sizes[index]);
+  }
+  method_holder.planned_memory = std::make_unique<HierarchicalAllocator>(Span(
+      method_holder.planned_spans.data(), method_holder.planned_spans.size()));
+  method_holder.memory_manager = std::make_unique<MemoryManager>(
+      memory_allocator, method_holder.planned_memory.get(), temp_allocator);
+  method_holder.method = ET_UNWRAP_UNIQUE(program_->load_method(
+      method_name.c_str(), method_holder.memory_manager.get(), event_tracer));
+  return method_holder;
+}
+
 Error Module::load_method(const std::string& method_name) {
-  if (!is_method_loaded(method_name)) {
+  if (!methods_.count(method_name)) {
     ET_CHECK_OK_OR_RETURN_ERROR(load());
 
-    MethodHolder method_holder;
+    std::unique_ptr<MemoryAllocator> memory_allocator;
+    if (owns_memory_allocator_) {
+      memory_allocator = make_memory_allocator();
+    }
+    auto method_holder = ET_UNWRAP(make_method_holder(
+        method_name,
+        memory_allocator ? memory_allocator.get() : memory_allocator_.get(),
+        temp_allocator_.get(),
+        event_tracer_.get()));
+    method_holder.memory_allocator = std::move(memory_allocator);
+    methods_.emplace(method_name, std::move(method_holder));
+  }
+  return Error::Ok;
+}
+
+Error Module::load_methods_with_shared_memory(
+    const std::vector<std::string>& method_names) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+
+  // Size each buffer of the arena to the largest buffer of that index among
+  // the methods.
+  std::vector<size_t> arena_sizes;
+  for (const auto& method_name : method_names) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !is_method_loaded(method_name),
+        InvalidState,
+        "Method %s is already loaded",
+        method_name.c_str());
     const auto method_metadata =
         ET_UNWRAP(program_->method_meta(method_name.c_str()));
     const auto planned_buffersCount =
         method_metadata.num_memory_planned_buffers();
-    method_holder.planned_buffers.reserve(planned_buffersCount);
-    method_holder.planned_spans.reserve(planned_buffersCount);
-
+    if (arena_sizes.size() < planned_buffersCount) {
+      arena_sizes.resize(planned_buffersCount, 0);
+    }
     for (auto index = 0; index < planned_buffersCount; ++index) {
-      const auto buffer_size =
-          method_metadata.memory_planned_buffer_size(index).get();
-      method_holder.planned_buffers.emplace_back(buffer_size);
-      method_holder.planned_spans.emplace_back(
-          method_holder.planned_buffers.back().data(), buffer_size);
+      arena_sizes[index] = std::max<size_t>(
+          arena_sizes[index],
+          method_metadata.memory_planned_buffer_size(index).get());
     }
-    method_holder.planned_memory = std::make_unique<HierarchicalAllocator>(Span(
-        method_holder.planned_spans.data(),
-        method_holder.planned_spans.size()));
-    method_holder.memory_manager = std::make_unique<MemoryManager>(
+  }
+  auto planned_arena = ET_UNWRAP(make_planned_arena(arena_sizes));
+
+  std::unordered_map<std::string, MethodHolder> methods;
+  for (const auto& method_name : method_names) {
+    auto method_holder = ET_UNWRAP(make_method_holder(
+        method_name,
         memory_allocator_.get(),
-        method_holder.planned_memory.get(),
-        temp_allocator_.get());
-    method_holder.method = ET_UNWRAP_UNIQUE(program_->load_method(
-        method_name.c_str(),
-        method_holder.memory_manager.get(),
-        event_tracer_.get()));
-    methods_.emplace(method_name, std::move(method_holder));
+        temp_allocator_.get(),
+        event_tracer_.get(),
+        &planned_arena));
+    methods.emplace(method_name, std::move(method_holder));
   }
+  // Moving the arena keeps the buffers the methods point into.
+  planned_arenas_.emplace_back(std::move(planned_arena));
+  methods_.merge(methods);
   return Error::Ok;
 }
 
 bool Module::is_method_loaded(const std::string& method_name) const {
-  return methods_.count(method_name);
+  if (methods_.count(method_name)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(pools_mutex_);
+  return pools_.count(method_name);
+}
+
+Error Module::unload_method(const std::string& method_name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      methods_.count(method_name),
+      InvalidArgument,
+      "Method %s is not loaded",
+      method_name.c_str());
+  // The adapter may own the memory of the method's inputs.
+  methods_.erase(method_name);
+  adapters_.erase(method_name);
+  if (methods_.empty()) {
+    // Methods that share planned memory, or use an allocator passed in, only
+    // release it once none of them is left.
+    planned_arenas_.clear();
+    memory_allocator_->reset();
+  }
+  return Error::Ok;
+}
+
+Error Module::unload() {
+  ET_CHECK_OR_RETURN_ERROR(
+      !file_path_.empty(),
+      NotSupported,
+      "Only a module loaded from a file can be unloaded and loaded again");
+  {
+    std::lock_guard<std::mutex> lock(pools_mutex_);
+    for (const auto& [name, pool] : pools_) {
+      ET_CHECK_OR_RETURN_ERROR(
+          pool.idle.size() == pool.instances.size(),
+          InvalidState,
+          "Method %s is in use",
+          name.c_str());
+    }
+    pools_.clear();
+  }
+  methods_.clear();
+  adapters_.clear();
+  planned_arenas_.clear();
+  memory_allocator_->reset();
+  program_.reset();
+  return Error::Ok;
+}
+
+Result<size_t> Module::method_memory_size(
+    const std::string& method_name) const {
+  const auto it = methods_.find(method_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != methods_.end(),
+      InvalidArgument,
+      "Method %s is not loaded",
+      method_name.c_str());
+  const auto& method_holder = it->second;
+  size_t size = 0;
+  for (const auto& span : method_holder.planned_spans) {
+    size += span.size();
+  }
+  if (method_holder.memory_allocator) {
+    size += method_holder.memory_allocator->used_size();
+  }
+  return size;
+}
+
+Error Module::warmup(const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return methods_.at(method_name).method->warmup();
+}
+
+Error Module::set_max_concurrency(size_t max_concurrency) {
+  std::lock_guard<std::mutex> lock(pools_mutex_);
+  ET_CHECK_OR_RETURN_ERROR(
+      pools_.empty(),
+      InvalidState,
+      "Concurrency must be set before executing any method");
+  ET_CHECK_OR_RETURN_ERROR(
+      method_alternatives_.empty(),
+      NotSupported,
+      "Method alternatives cannot be used with pooled methods");
+  max_concurrency_ = max_concurrency;
+  return Error::Ok;
+}
+
+Error Module::set_numa_node(int numa_node) {
+  if (numa_node >= 0) {
+    // Checks the node without binding anything.
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        bind_memory_to_numa_node(nullptr, 0, numa_node));
+  }
+  std::lock_guard<std::mutex> lock(pools_mutex_);
+  numa_node_ = numa_node;
+  return Error::Ok;
+}
+
+Error Module::set_huge_pages(HugePages huge_pages, bool prefault) {
+  std::lock_guard<std::mutex> lock(pools_mutex_);
+  ET_CHECK_OR_RETURN_ERROR(
+      methods_.empty() && pools_.empty(),
+      InvalidState,
+      "Huge pages must be set before loading any method");
+  huge_pages_ = huge_pages;
+  prefault_ = prefault;
+  if (owns_temp_allocator_) {
+    temp_allocator_ = make_temp_allocator();
+  }
+  return Error::Ok;
+}
+
+std::unique_ptr<MemoryAllocator> Module::make_memory_allocator() const {
+  if (numa_node_ >= 0) {
+    return std::make_unique<NumaMemoryAllocator>(numa_node_);
+  }
+  return std::make_unique<MallocMemoryAllocator>();
+}
+
+std::unique_ptr<MemoryAllocator> Module::make_temp_allocator() const {
+  if (huge_pages_ != HugePages::None || prefault_) {
+    return std::make_unique<HugePageMemoryAllocator>(
+        huge_pages_, prefault_, numa_node_);
+  }
+  return make_memory_allocator();
+}
+
+Result<Module::PlannedArena> Module::make_planned_arena(
+    const std::vector<size_t>& sizes) const {
+  PlannedArena planned_arena;
+  planned_arena.spans.reserve(sizes.size());
+  if (huge_pages_ == HugePages::None && !prefault_) {
+    planned_arena.buffers.reserve(sizes.size());
+    for (const auto size : sizes) {
+      planned_arena.buffers.emplace_back(size);
+      place_planned_buffer(planned_arena.buffers.back());
+      planned_arena.spans.emplace_back(
+          planned_arena.buffers.back().data(), size);
+    }
+    return planned_arena;
+  }
+  planned_arena.allocator = std::make_unique<HugePageMemoryAllocator>(
+      huge_pages_, prefault_, numa_node_);
+  for (const auto size : sizes) {
+    auto* data = static_cast<uint8_t*>(planned_arena.allocator->allocate(size));
+    ET_CHECK_OR_RETURN_ERROR(
+        data != nullptr,
+        MemoryAllocationFailed,
+        "Failed to allocate %zu bytes of planned memory",
+        size);
+    planned_arena.spans.emplace_back(data, size);
+  }
+  return planned_arena;
+}
+
+void Module::place_planned_buffer(std::vector<uint8_t>& buffer) const {
+  if (numa_node_ >= 0 &&
+      bind_memory_to_numa_node(buffer.data(), buffer.size(), numa_node_) !=
+          Error::Ok) {
+    ET_LOG(
+        Info,
+        "Planned memory of %zu bytes stays off NUMA node %d",
+        buffer.size(),
+        numa_node_);
+  }
+}
+
+Result<Module::MethodLease> Module::acquire_method(
+    const std::string& method_name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      max_concurrency_ > 0,
+      InvalidState,
+      "Method instances are only pooled after set_max_concurrency()");
+  std::unique_lock<std::mutex> lock(pools_mutex_);
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+  auto& pool = pools_[method_name];
+  while (pool.idle.empty() && pool.instances.size() >= max_concurrency_) {
+    pools_condition_.wait(lock);
+  }
+  if (pool.idle.empty()) {
+    // Each instance gets its own allocators, since they aren't thread-safe,
+    // and no event tracer, since it isn't either.
+    auto memory_allocator = make_memory_allocator();
+    auto temp_allocator = make_temp_allocator();
+    auto method_holder = make_method_holder(
+        method_name, memory_allocator.get(), temp_allocator.get(), nullptr);
+    if (!method_holder.ok()) {
+      if (pool.instances.empty()) {
+        pools_.erase(method_name);
+      }
+      return method_holder.error();
+    }
+    method_holder->memory_allocator = std::move(memory_allocator);
+    method_holder->temp_allocator = std::move(temp_allocator);
+    pool.instances.emplace_back(
+        std::make_unique<MethodHolder>(std::move(*method_holder)));
+    pool.idle.push_back(pool.instances.back().get());
+  }
+  auto* method_holder = pool.idle.back();
+  pool.idle.pop_back();
+  return MethodLease(this, &pool, method_holder);
+}
+
+void Module::release_method(MethodPool* pool, MethodHolder* method_holder) {
+  {
+    std::lock_guard<std::mutex> lock(pools_mutex_);
+    pool->idle.push_back(method_holder);
+  }
+  pools_condition_.notify_one();
+}
+
+Module::MethodLease::MethodLease(
+    Module* module,
+    MethodPool* pool,
+    MethodHolder* method_holder)
+    : module_(module),
+      pool_(pool),
+      method_holder_(method_holder),
+      handle_(method_holder->method.get()) {}
+
+Module::MethodLease::MethodLease(MethodLease&& rhs) noexcept
+    : module_(rhs.module_),
+      pool_(rhs.pool_),
+      method_holder_(rhs.method_holder_),
+      handle_(rhs.handle_) {
+  rhs.module_ = nullptr;
+}
+
+Module::MethodLease::~MethodLease() {
+  if (module_) {
+    module_->release_method(pool_, method_holder_);
+  }
 }
 
 Result<MethodMeta> Module::method_meta(const std::string& method_name) {
@@ -193,28 +520,253 @@ Result<MethodMeta> Module::method_meta(const std::string& method_name) {
 Result<std::vector<EValue>> Module::execute(
     const std::string& method_name,
     const std::vector<EValue>& input) {
+  auto alternative = method_alternatives_.find(method_name);
+  if (alternative != method_alternatives_.end()) {
+    // Both methods have the same number of outputs.
+    ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+    std::vector<EValue> outputs(
+        methods_.at(method_name).method->outputs_size());
+    ET_CHECK_OK_OR_RETURN_ERROR(execute_alternative(
+        method_name,
+        alternative->second,
+        Span<const EValue>(input.data(), input.size()),
+        Span<EValue>(outputs.data(), outputs.size())));
+    return outputs;
+  }
+  if (max_concurrency_ > 0) {
+    auto lease = ET_UNWRAP(acquire_method(method_name));
+    std::vector<EValue> outputs(lease->outputs_size());
+    ET_CHECK_OK_OR_RETURN_ERROR(lease->execute(
+        Span<const EValue>(input.data(), input.size()),
+        Span<EValue>(outputs.data(), outputs.size())));
+    return outputs;
+  }
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
-  auto& method = methods_.at(method_name).method;
+  MethodHandle method(methods_.at(method_name).method.get());
+
+  std::vector<EValue> outputs(method.outputs_size());
+  ET_CHECK_OK_OR_RETURN_ERROR(method.execute(
+      Span<const EValue>(input.data(), input.size()),
+      Span<EValue>(outputs.data(), outputs.size())));
+
+  return outputs;
+}
 
-  for (auto index = 0; index < input.size(); ++index) {
-    ET_CHECK_OK_OR_RETURN_ERROR(method->set_input(input[index], index));
+Error Module::execute(
+    const std::string& method_name,
+    Span<const EValue> inputs,
+    Span<EValue> outputs) {
+  auto alternative = method_alternatives_.find(method_name);
+  if (alternative != method_alternatives_.end()) {
+    return execute_alternative(
+        method_name, alternative->second, inputs, outputs);
   }
-  ET_CHECK_OK_OR_RETURN_ERROR(method->execute());
+  return execute_method(method_name, inputs, outputs);
+}
 
-  const auto outputs_size = method->outputs_size();
-  std::vector<EValue> outputs(outputs_size);
-  ET_CHECK_OK_OR_RETURN_ERROR(
-      method->get_outputs(outputs.data(), outputs_size));
+Error Module::execute_method(
+    const std::string& method_name,
+    Span<const EValue> inputs,
+    Span<EValue> outputs) {
+  if (max_concurrency_ > 0) {
+    auto lease = ET_UNWRAP(acquire_method(method_name));
+    return lease->execute(inputs, outputs);
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return MethodHandle(methods_.at(method_name).method.get())
+      .execute(inputs, outputs);
+}
 
-  return outputs;
+Error Module::set_method_alternative(
+    const std::string& method_name,
+    const std::string& alternative_name,
+    size_t num_timed_runs) {
+  ET_CHECK_OR_RETURN_ERROR(
+      max_concurrency_ == 0,
+      NotSupported,
+      "Method alternatives cannot be used with pooled methods");
+  ET_CHECK_OR_RETURN_ERROR(
+      alternative_name != method_name && num_timed_runs > 0,
+      InvalidArgument,
+      "Method %s needs another method and at least one timed run",
+      method_name.c_str());
+  const auto meta = ET_UNWRAP(method_meta(method_name));
+  const auto alternative_meta = ET_UNWRAP(method_meta(alternative_name));
+  bool same_signature = meta.num_inputs() == alternative_meta.num_inputs() &&
+      meta.num_outputs() == alternative_meta.num_outputs();
+  for (size_t i = 0; same_signature && i < meta.num_inputs(); ++i) {
+    same_signature = meta.input_tag(i).get() ==
+        alternative_meta.input_tag(i).get();
+  }
+  for (size_t i = 0; same_signature && i < meta.num_outputs(); ++i) {
+    same_signature = meta.output_tag(i).get() ==
+        alternative_meta.output_tag(i).get();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      same_signature,
+      InvalidArgument,
+      "Methods %s and %s take or return different values",
+      method_name.c_str(),
+      alternative_name.c_str());
+  MethodAlternative alternative;
+  alternative.alternative_name = alternative_name;
+  alternative.num_timed_runs = num_timed_runs;
+  method_alternatives_[method_name] = std::move(alternative);
+  return Error::Ok;
 }
 
-Error Module::set_output_data_ptr(Tensor& output_tensor, size_t output_index) {
-  ET_CHECK_OK_OR_RETURN_ERROR(load_method("forward"));
-  auto& method = methods_.at("forward").method;
+const std::string& Module::selected_method(
+    const std::string& method_name) const {
+  auto alternative = method_alternatives_.find(method_name);
+  if (alternative == method_alternatives_.end() ||
+      alternative->second.selected.empty()) {
+    return method_name;
+  }
+  return alternative->second.selected;
+}
+
+Error Module::execute_alternative(
+    const std::string& method_name,
+    MethodAlternative& alternative,
+    Span<const EValue> inputs,
+    Span<EValue> outputs) {
+  if (!alternative.selected.empty()) {
+    return execute_method(alternative.selected, inputs, outputs);
+  }
+  const size_t candidate = alternative.num_runs % 2;
+  const std::string& name =
+      candidate == 0 ? method_name : alternative.alternative_name;
+  const auto start = std::chrono::steady_clock::now();
+  ET_CHECK_OK_OR_RETURN_ERROR(execute_method(name, inputs, outputs));
+  const auto time = std::chrono::steady_clock::now() - start;
+
+  // The first run of each method pays for preparing it, so it isn't timed.
+  if (alternative.num_runs >= 2) {
+    alternative.best_time[candidate] =
+        std::min(alternative.best_time[candidate], time);
+  }
+  if (++alternative.num_runs == 2 * (alternative.num_timed_runs + 1)) {
+    alternative.selected = alternative.best_time[1] < alternative.best_time[0]
+        ? alternative.alternative_name
+        : method_name;
+    ET_LOG(
+        Info,
+        "Method %s runs as %s: %lld us vs %lld us",
+        method_name.c_str(),
+        alternative.selected.c_str(),
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                alternative.best_time[0])
+                .count()),
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                alternative.best_time[1])
+                .count()));
+  }
+  return Error::Ok;
+}
+
+Result<MethodHandle> Module::method_handle(const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return MethodHandle(methods_.at(method_name).method.get());
+}
+
+Error Module::set_input(
+    const std::string& method_name,
+    const EValue& input,
+    size_t input_index) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return methods_.at(method_name).method->set_input(input, input_index);
+}
+
+Error Module::execute_in_place(const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return methods_.at(method_name).method->execute();
+}
+
+Result<EValue> Module::get_output(
+    const std::string& method_name,
+    size_t output_index) {
+  ET_CHECK_OR_RETURN_ERROR(
+      methods_.count(method_name),
+      InvalidState,
+      "Method %s is not loaded",
+      method_name.c_str());
+  auto& method = methods_.at(method_name).method;
+  ET_CHECK_OR_RETURN_ERROR(
+      output_index < method->outputs_size(),
+      InvalidArgument,
+      "Output index %zu is out of range for %zu outputs",
+      output_index,
+      method->outputs_size());
+  return method->get_output(output_index);
+}
+
+Error Module::load_adapter(
+    const std::string& method_name,
+    const std::string& adapter_path) {
+  ET_CHECK_OR_RETURN_ERROR(
+      max_concurrency_ == 0,
+      NotSupported,
+      "Adapters cannot be loaded into pooled methods");
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+
+  auto adapter = std::make_unique<Module>(adapter_path, load_mode_);
+  const auto adapter_meta = ET_UNWRAP(adapter->method_meta("forward"));
+  ET_CHECK_OR_RETURN_ERROR(
+      adapter_meta.num_inputs() == 0,
+      InvalidArgument,
+      "Adapter %s must take no inputs, got %zu",
+      adapter_path.c_str(),
+      adapter_meta.num_inputs());
+  const size_t num_slots = adapter_meta.num_outputs();
+  ET_CHECK_OR_RETURN_ERROR(
+      num_slots <= method->inputs_size(),
+      InvalidArgument,
+      "Adapter %s has %zu weights but method %s only has %zu inputs",
+      adapter_path.c_str(),
+      num_slots,
+      method_name.c_str(),
+      method->inputs_size());
+
+  const auto weights = ET_UNWRAP(adapter->forward());
+  const size_t first_slot = method->inputs_size() - num_slots;
+  for (size_t index = 0; index < num_slots; ++index) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        method->set_input(weights[index], first_slot + index));
+  }
+  // Slots that aren't memory planned point into the adapter.
+  adapters_[method_name] = std::move(adapter);
+  return Error::Ok;
+}
+
+Error Module::set_output_data_ptr(
+    const std::string& method_name,
+    Tensor& output_tensor,
+    size_t output_index) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
   return method->set_output_data_ptr(
       output_tensor.mutable_data_ptr(), output_tensor.nbytes(), output_index);
 }
 
+Error MethodHandle::execute(Span<const EValue> inputs, Span<EValue> outputs) {
+  ET_CHECK_OR_RETURN_ERROR(
+      method_ != nullptr, InvalidState, "Method handle is not valid");
+  const auto outputs_size = method_->outputs_size();
+  ET_CHECK_OR_RETURN_ERROR(
+      outputs.size() >= outputs_size,
+      InvalidArgument,
+      "Need room for %zu outputs, got %zu",
+      outputs_size,
+      outputs.size());
+  for (size_t index = 0; index < inputs.size(); ++index) {
+    ET_CHECK_OK_OR_RETURN_ERROR(method_->set_input(inputs[index], index));
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(method_->execute());
+  return method_->get_outputs(outputs.data(), outputs_size);
+}
+
 } // namespace extension
 } // namespace executorch
@@ -8,22 +8,109 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <executorch/extension/memory_allocator/huge_page_memory_allocator.h>
 #include <executorch/runtime/executor/program.h>
 
 namespace executorch {
 namespace extension {
 
+/**
+ * A handle to a method loaded by a Module, for running it repeatedly without
+ * looking it up by name or allocating on each call. The handle is a plain
+ * pointer to the method and is valid as long as the Module that created it.
+ */
+class MethodHandle final {
+ public:
+  MethodHandle() = default;
+
+  explicit MethodHandle(::executorch::runtime::Method* method)
+      : method_(method) {}
+
+  /**
+   * Set the inputs, execute the method and copy its outputs out.
+   *
+   * @param[in] inputs The input values, one per input of the method.
+   * @param[out] outputs Receives the output values. Must hold at least as
+   * many values as the method has outputs.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error execute(
+      ::executorch::runtime::Span<const ::executorch::runtime::EValue> inputs,
+      ::executorch::runtime::Span<::executorch::runtime::EValue> outputs);
+
+  /// The number of inputs of the method.
+  size_t inputs_size() const {
+    return method_->inputs_size();
+  }
+
+  /// The number of outputs of the method.
+  size_t outputs_size() const {
+    return method_->outputs_size();
+  }
+
+  /// The underlying method, for anything the handle doesn't cover.
+  ::executorch::runtime::Method& method() const {
+    return *method_;
+  }
+
+  bool is_valid() const {
+    return method_ != nullptr;
+  }
+
+ private:
+  ::executorch::runtime::Method* method_ = nullptr;
+};
+
 /**
  * A facade class for loading programs and executing methods within them.
  */
 class Module final {
+ private:
+  struct MethodHolder;
+  struct MethodPool;
+
  public:
+  /**
+   * Exclusive use of one pooled instance of a method, returned to the pool
+   * when the lease is destroyed. See Module::set_max_concurrency().
+   */
+  class MethodLease final {
+   public:
+    MethodLease(MethodLease&& rhs) noexcept;
+    MethodLease(const MethodLease&) = delete;
+    MethodLease& operator=(const MethodLease&) = delete;
+    MethodLease& operator=(MethodLease&&) = delete;
+    ~MethodLease();
+
+    MethodHandle& handle() {
+      return handle_;
+    }
+
+    MethodHandle* operator->() {
+      return &handle_;
+    }
+
+   private:
+    friend class Module;
+    MethodLease(Module* module, MethodPool* pool, MethodHolder* method_holder);
+
+    Module* module_;
+    MethodPool* pool_;
+    MethodHolder* method_holder_;
+    MethodHandle handle_;
+  };
+
   /**
    * Enum to define loading behavior.
    */
@@ -143,6 +230,25 @@ class Module final {
   ET_NODISCARD
   ::executorch::runtime::Error load_method(const std::string& method_name);
 
+  /**
+   * Load several methods that never run at the same time, backing all their
+   * planned memory with one arena sized to the largest of them instead of
+   * giving each method its own buffers.
+   *
+   * Running one of these methods overwrites the planned memory of the
+   * others, so none of them may keep state in planned memory from one
+   * execution to the next, e.g. a KV cache in a mutable buffer, and the
+   * tensor outputs of one are only valid until another one runs.
+   *
+   * @param[in] method_names The names of the methods to load, none of which
+   * may be loaded already.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error load_methods_with_shared_memory(
+      const std::vector<std::string>& method_names);
+
   /**
    * Checks if a specific method is loaded.
    *
@@ -153,6 +259,59 @@ class Module final {
    */
   bool is_method_loaded(const std::string& method_name) const;
 
+  /**
+   * Unload a specific method, freeing its planned memory, destroying its
+   * delegates and, if the module owns its memory allocator, freeing what the
+   * method and its delegates allocated from it. Any adapter loaded into the
+   * method is dropped too. The method is loaded again, from its initial
+   * state, the next time it's used.
+   *
+   * @param[in] method_name The name of the method to unload.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error unload_method(const std::string& method_name);
+
+  /**
+   * Unload all methods and the program, releasing the constant and delegate
+   * data it loaded. The program is loaded again from its file the next time
+   * it's used, so this needs a module constructed from a file path, and
+   * pooled methods must not be in use.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error unload();
+
+  /**
+   * Get the number of bytes a loaded method holds: its planned memory, plus
+   * what it and its delegates allocated from its memory allocator at load
+   * when the module owns that allocator. Memory that delegates allocate by
+   * other means isn't counted.
+   *
+   * @param[in] method_name The name of the loaded method.
+   *
+   * @returns A Result object containing either the size or an error to
+   * indicate failure.
+   */
+  ::executorch::runtime::Result<size_t> method_memory_size(
+      const std::string& method_name) const;
+
+  /**
+   * Loads a method if needed and prepares it for its first execution without
+   * executing it; see Method::warmup(). Call it off the critical path, e.g.
+   * on a background thread right after loading, but not while the method
+   * executes.
+   *
+   * @param[in] method_name The name of the method to warm up.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error warmup(
+      const std::string& method_name = "forward");
+
   /**
    * Get a method metadata struct by method name.
    * Loads the program and method if needed.
@@ -181,6 +340,159 @@ class Module final {
       const std::string& method_name,
       const std::vector<::executorch::runtime::EValue>& input);
 
+  /**
+   * Execute a specific method with the given inputs and copy its outputs to
+   * the given values. Unlike the vector overloads, this doesn't allocate.
+   * Loads the program and method before executing if needed.
+   *
+   * @param[in] method_name The name of the method to execute.
+   * @param[in] inputs The input values to be passed to the method.
+   * @param[out] outputs Receives the output values. Must hold at least as
+   * many values as the method has outputs.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error execute(
+      const std::string& method_name,
+      ::executorch::runtime::Span<const ::executorch::runtime::EValue> inputs,
+      ::executorch::runtime::Span<::executorch::runtime::EValue> outputs);
+
+  /**
+   * Lets up to `max_concurrency` threads execute each method at the same time.
+   * Each thread runs its own instance of the method, with its own planned
+   * memory, taken from a per-method pool that grows on demand up to
+   * `max_concurrency` instances. Past that, callers wait for an instance to
+   * be returned. Zero, the default, runs every method on a single instance
+   * that callers must not share across threads.
+   *
+   * In this mode, execute() and forward() check out an instance for the
+   * duration of the call, so tensor outputs they return point into memory
+   * that another thread may reuse right away; use acquire_method() to keep
+   * an instance until its outputs have been read. Pooled instances use their
+   * own malloc allocators and no event tracer. The other methods of this
+   * class, such as set_input() and method_handle(), keep using the single
+   * instance and are not thread-safe.
+   *
+   * @param[in] max_concurrency The maximum number of instances per method.
+   *
+   * @returns An Error to indicate success or failure. Must be called before
+   * any method is executed concurrently.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error set_max_concurrency(size_t max_concurrency);
+
+  /**
+   * Places the memory of the methods loaded from now on, including pooled
+   * instances, on NUMA node `numa_node`, so that replicas of a model running
+   * on different sockets of a server each use memory local to their socket.
+   * This covers their planned memory and, when the module owns its memory
+   * allocators, what they and their delegates allocate from them.
+   *
+   * Pair it with a ThreadPool pinned to the CPUs of the same node, see
+   * get_numa_node_cpu_ids() in backends/xnnpack/threadpool/cpuinfo_utils.h,
+   * installed with a UseThreadPoolGuard while loading and executing methods.
+   *
+   * Constants stay where the data loader puts them. With the mmap load modes
+   * the page cache of the file is shared by all the modules that load it;
+   * with LoadMode::File each module reads its own copy, which the OS places
+   * on the node of the thread that calls load().
+   *
+   * @param[in] numa_node The node, as numbered by the OS, or -1 to stop
+   * placing memory.
+   *
+   * @returns An Error to indicate success or failure, Error::NotSupported on
+   * platforms other than Linux.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error set_numa_node(int numa_node);
+
+  /**
+   * Backs the planned memory of the methods, and the temp memory when the
+   * module owns its temp allocator, with huge pages, so that large models
+   * take fewer TLB misses and page faults on their activations. See
+   * HugePageMemoryAllocator.
+   *
+   * @param[in] huge_pages The pages to back the memory with; HugePages::None
+   * without prefaulting restores the default of plain heap buffers.
+   * @param[in] prefault Whether to fault in the memory when the methods are
+   * loaded rather than on their first execution.
+   *
+   * @returns An Error to indicate success or failure. Must be called before
+   * any method is loaded.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error set_huge_pages(
+      HugePages huge_pages,
+      bool prefault = false);
+
+  /**
+   * Makes execute() and forward() of `method_name` run whichever of it and
+   * `alternative_name` is faster on this device. The program carries both,
+   * e.g. the model lowered to a GPU or NPU delegate as "forward" and left on
+   * CPU kernels as "forward_cpu", for models where the delegate may not make
+   * up for its dispatch and copy overhead. The next executions alternate
+   * between the two methods, each timed `num_timed_runs` times after a first
+   * untimed run, and all executions after that run the one with the lowest
+   * time.
+   *
+   * Both methods must take and return the same values. Outputs of an
+   * execution are those of the method that ran it, so they're read from the
+   * returned values rather than with get_output(). Not supported with
+   * set_max_concurrency().
+   *
+   * @param[in] method_name The name of the method that callers execute.
+   * @param[in] alternative_name The name of the method computing the same
+   * outputs in another way.
+   * @param[in] num_timed_runs The number of timed executions of each method.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error set_method_alternative(
+      const std::string& method_name,
+      const std::string& alternative_name,
+      size_t num_timed_runs = 3);
+
+  /**
+   * Get the name of the method that executions of `method_name` run: the
+   * faster of it and its alternative once they have been timed, and
+   * `method_name` itself otherwise. See set_method_alternative().
+   *
+   * @param[in] method_name The name of the method.
+   *
+   * @returns The name of the method that runs.
+   */
+  const std::string& selected_method(const std::string& method_name) const;
+
+  /**
+   * Check out an instance of a specific method from its pool, loading a new
+   * one if none is idle and the pool is not full, and waiting otherwise.
+   * Safe to call from any thread. Requires set_max_concurrency().
+   *
+   * @param[in] method_name The name of the method.
+   *
+   * @returns A Result object containing either the lease of the instance or
+   * an error to indicate failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Result<MethodLease> acquire_method(
+      const std::string& method_name);
+
+  /**
+   * Get a handle to a specific method, to execute it repeatedly without
+   * looking it up by name on each call. Loads the program and method if
+   * needed.
+   *
+   * @param[in] method_name The name of the method.
+   *
+   * @returns A Result object containing either the handle or an error to
+   * indicate failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Result<MethodHandle> method_handle(
+      const std::string& method_name);
+
   /**
    * Execute a specific method without any input values.
    * Loads the program and method before executing if needed.
@@ -196,6 +508,51 @@ class Module final {
     return execute(method_name, {});
   }
 
+  /**
+   * Set a single input of a specific method, to be used by the next call to
+   * execute() without inputs. Loads the program and method if needed.
+   *
+   * @param[in] method_name The name of the method to set the input of.
+   * @param[in] input The input value.
+   * @param[in] input_index The index of the input.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error set_input(
+      const std::string& method_name,
+      const ::executorch::runtime::EValue& input,
+      size_t input_index);
+
+  /**
+   * Execute a specific method with the inputs already set on it, leaving the
+   * outputs in place to be read with get_output(). Unlike execute(), this
+   * doesn't build any vectors of values, so it suits hot loops that run the
+   * same method over and over.
+   *
+   * @param[in] method_name The name of the method to execute.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error execute_in_place(const std::string& method_name);
+
+  /**
+   * Retrieve a single output of the last execution of a specific method. A
+   * tensor output aliases the memory of the method, so it is only valid until
+   * the method is executed again.
+   *
+   * @param[in] method_name The name of the method to get the output of.
+   * @param[in] output_index The index of the output.
+   *
+   * @returns A Result object containing either the output value or an error
+   * to indicate failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Result<::executorch::runtime::EValue> get_output(
+      const std::string& method_name,
+      size_t output_index);
+
   /**
    * Retrieve the output value of a specific method with the given input.
    * Loads the program and method before execution if needed.
@@ -247,6 +604,23 @@ class Module final {
     return execute("forward", input);
   }
 
+  /**
+   * Execute the 'forward' method with the given inputs and copy its outputs
+   * to the given values, without allocating.
+   * Loads the program and method before executing if needed.
+   *
+   * @param[in] inputs The input values for the 'forward' method.
+   * @param[out] outputs Receives the output values.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error forward(
+      ::executorch::runtime::Span<const ::executorch::runtime::EValue> inputs,
+      ::executorch::runtime::Span<::executorch::runtime::EValue> outputs) {
+    return execute("forward", inputs, outputs);
+  }
+
   /**
    * Execute the 'forward' method without any input values.
    * Loads the program and method before executing if needed.
@@ -260,6 +634,29 @@ class Module final {
     return forward({});
   }
 
+  /**
+   * Load the weights of an adapter, e.g. a LoRA adapter, into the adapter
+   * slots of a method, replacing the adapter loaded before, if any.
+   *
+   * The adapter slots are the last inputs of the method. They are set once
+   * here rather than on every execution, since execute() and forward() only
+   * set the inputs they are given. The adapter file is a program whose
+   * 'forward' method takes no inputs and returns the weights of the slots in
+   * order; see examples/models/phi3-mini-lora. The base program and its
+   * weights stay loaded, so switching adapters only loads and copies the
+   * adapter weights. On failure, load an adapter successfully before
+   * executing the method again.
+   *
+   * @param[in] method_name The name of the method with the adapter slots.
+   * @param[in] adapter_path The path to the adapter program file.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error load_adapter(
+      const std::string& method_name,
+      const std::string& adapter_path);
+
   /**
    * Retrieves the EventTracer instance being used by the Module.
    * EventTracer is used for tracking and logging events during the execution
@@ -272,6 +669,22 @@ class Module final {
     return event_tracer_.get();
   }
 
+  /**
+   * Set output data pointer for a specific method, so that its executions
+   * write the output to the memory of the given tensor.
+   * Loads the program and method if needed.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] output_tensor A Tensor for the output of the method.
+   * @param[in] output_index Index of the output in the method.
+   *
+   * @returns An Error to indicate success or failure of the loading process.
+   */
+  ::executorch::runtime::Error set_output_data_ptr(
+      const std::string& method_name,
+      exec_aten::Tensor& output_tensor,
+      size_t output_index);
+
   /**
    * Set output data pointer for forward method.
    *
@@ -282,27 +695,108 @@ class Module final {
    */
   ::executorch::runtime::Error set_output_data_ptr(
       exec_aten::Tensor& output_tensor,
-      size_t output_index);
+      size_t output_index) {
+    return set_output_data_ptr("forward", output_tensor, output_index);
+  }
 
  private:
+  // Planned memory, as heap buffers or carved from an allocator when huge
+  // pages are set.
+  struct PlannedArena {
+    std::vector<std::vector<uint8_t>> buffers;
+    std::unique_ptr<::executorch::runtime::MemoryAllocator> allocator;
+    std::vector<::executorch::runtime::Span<uint8_t>> spans;
+  };
+
   struct MethodHolder {
-    std::vector<std::vector<uint8_t>> planned_buffers;
+    // Empty when the method uses an arena shared with other methods.
+    PlannedArena planned_arena;
     std::vector<::executorch::runtime::Span<uint8_t>> planned_spans;
     std::unique_ptr<::executorch::runtime::HierarchicalAllocator>
         planned_memory;
     std::unique_ptr<::executorch::runtime::MemoryManager> memory_manager;
     std::unique_ptr<::executorch::runtime::Method> method;
+    // Only set for pooled instances, which don't share the module allocators.
+    std::unique_ptr<::executorch::runtime::MemoryAllocator> memory_allocator;
+    std::unique_ptr<::executorch::runtime::MemoryAllocator> temp_allocator;
+  };
+
+  struct MethodPool {
+    std::vector<std::unique_ptr<MethodHolder>> instances;
+    std::vector<MethodHolder*> idle;
   };
 
+  // Two methods computing the same outputs, timed against each other. See
+  // set_method_alternative().
+  struct MethodAlternative {
+    std::string alternative_name;
+    size_t num_timed_runs;
+    size_t num_runs{0};
+    // The lowest time of the method and of its alternative so far.
+    std::chrono::steady_clock::duration best_time[2]{
+        std::chrono::steady_clock::duration::max(),
+        std::chrono::steady_clock::duration::max()};
+    // Empty until the timed runs are done.
+    std::string selected;
+  };
+
+  ::executorch::runtime::Result<MethodHolder> make_method_holder(
+      const std::string& method_name,
+      ::executorch::runtime::MemoryAllocator* memory_allocator,
+      ::executorch::runtime::MemoryAllocator* temp_allocator,
+      ::executorch::runtime::EventTracer* event_tracer,
+      const PlannedArena* planned_arena = nullptr);
+  void release_method(MethodPool* pool, MethodHolder* method_holder);
+  // Executes a method, ignoring any alternative it has.
+  ::executorch::runtime::Error execute_method(
+      const std::string& method_name,
+      ::executorch::runtime::Span<const ::executorch::runtime::EValue> inputs,
+      ::executorch::runtime::Span<::executorch::runtime::EValue> outputs);
+  // Executes a method or its alternative, timing them until one is selected.
+  ::executorch::runtime::Error execute_alternative(
+      const std::string& method_name,
+      MethodAlternative& alternative,
+      ::executorch::runtime::Span<const ::executorch::runtime::EValue> inputs,
+      ::executorch::runtime::Span<::executorch::runtime::EValue> outputs);
+  // Makes the allocator of a method, on the NUMA node if one is set.
+  std::unique_ptr<::executorch::runtime::MemoryAllocator>
+  make_memory_allocator() const;
+  // Makes the temp allocator of a method, with huge pages if they are set.
+  std::unique_ptr<::executorch::runtime::MemoryAllocator>
+  make_temp_allocator() const;
+  // Allocates planned buffers of the given sizes, on the NUMA node and with
+  // huge pages if they are set.
+  ::executorch::runtime::Result<PlannedArena> make_planned_arena(
+      const std::vector<size_t>& sizes) const;
+  // Moves the pages of planned memory to the NUMA node if one is set.
+  void place_planned_buffer(std::vector<uint8_t>& buffer) const;
+
  private:
   std::string file_path_;
   LoadMode load_mode_{LoadMode::MmapUseMlock};
   std::shared_ptr<::executorch::runtime::Program> program_;
   std::unique_ptr<::executorch::runtime::DataLoader> data_loader_;
+  // Whether memory_allocator_ was created here rather than passed in, in
+  // which case each method gets its own allocator so that it can be
+  // unloaded on its own.
+  bool owns_memory_allocator_;
   std::unique_ptr<::executorch::runtime::MemoryAllocator> memory_allocator_;
+  // Whether temp_allocator_ was created here rather than passed in.
+  bool owns_temp_allocator_;
   std::unique_ptr<::executorch::runtime::MemoryAllocator> temp_allocator_;
   std::unique_ptr<::executorch::runtime::EventTracer> event_tracer_;
   std::unordered_map<std::string, MethodHolder> methods_;
+  std::vector<PlannedArena> planned_arenas_;
+  size_t max_concurrency_{0};
+  int numa_node_{-1};
+  HugePages huge_pages_{HugePages::None};
+  bool prefault_{false};
+  mutable std::mutex pools_mutex_;
+  std::condition_variable pools_condition_;
+  std::unordered_map<std::string, MethodPool> pools_;
+  // The adapter of each method, which holds the weights in its slots.
+  std::unordered_map<std::string, std::unique_ptr<Module>> adapters_;
+  std::unordered_map<std::string, MethodAlternative> method_alternatives_;
 };
 
 } // namespace extension
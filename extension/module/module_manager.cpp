@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/module_manager.h>
+
+#include <fstream>
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+ModuleManager::ModuleManager(size_t memory_budget)
+    : memory_budget_(memory_budget) {}
+
+Error ModuleManager::add_module(
+    const std::string& name,
+    const std::string& file_path,
+    const Module::LoadMode load_mode) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !modules_.count(name),
+      InvalidArgument,
+      "Module %s is already added",
+      name.c_str());
+  std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+  ET_CHECK_OR_RETURN_ERROR(
+      file.good(), AccessFailed, "Failed to open %s", file_path.c_str());
+  ModuleEntry entry;
+  entry.program_size = static_cast<size_t>(file.tellg());
+  entry.module = std::make_unique<Module>(file_path, load_mode);
+  modules_.emplace(name, std::move(entry));
+  return Error::Ok;
+}
+
+Error ModuleManager::load_method(
+    const std::string& module_name,
+    const std::string& method_name) {
+  const auto loaded = loaded_method_index_.find({module_name, method_name});
+  if (loaded != loaded_method_index_.end()) {
+    loaded_methods_.splice(
+        loaded_methods_.begin(), loaded_methods_, loaded->second);
+    return Error::Ok;
+  }
+  const auto it = modules_.find(module_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != modules_.end(),
+      InvalidArgument,
+      "Module %s is not added",
+      module_name.c_str());
+  auto& entry = it->second;
+
+  if (!entry.module->is_loaded()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(make_room(entry.program_size, module_name));
+    ET_CHECK_OK_OR_RETURN_ERROR(entry.module->load());
+    memory_size_ += entry.program_size;
+  }
+  const auto unload_unused_program = [&]() {
+    if (entry.num_loaded_methods == 0 && entry.module->unload() == Error::Ok) {
+      memory_size_ -= entry.program_size;
+    }
+  };
+
+  // The planned memory is known before loading, the rest only after.
+  const auto method_meta =
+      entry.module->program()->method_meta(method_name.c_str());
+  if (!method_meta.ok()) {
+    unload_unused_program();
+    return method_meta.error();
+  }
+  size_t planned_size = 0;
+  for (size_t index = 0; index < method_meta->num_memory_planned_buffers();
+       ++index) {
+    planned_size += method_meta->memory_planned_buffer_size(index).get();
+  }
+  auto error = make_room(planned_size, module_name);
+  if (error == Error::Ok) {
+    error = entry.module->load_method(method_name);
+  }
+  if (error != Error::Ok) {
+    unload_unused_program();
+    return error;
+  }
+
+  const size_t size = entry.module->method_memory_size(method_name).get();
+  loaded_methods_.push_front({module_name, method_name, size});
+  loaded_method_index_[{module_name, method_name}] = loaded_methods_.begin();
+  ++entry.num_loaded_methods;
+  memory_size_ += size;
+  error = make_room(0, module_name, /*num_kept=*/1);
+  if (error != Error::Ok) {
+    // Even alone the method is over the budget.
+    loaded_methods_.pop_front();
+    loaded_method_index_.erase({module_name, method_name});
+    --entry.num_loaded_methods;
+    memory_size_ -= size;
+    ET_CHECK_OK_OR_RETURN_ERROR(entry.module->unload_method(method_name));
+    unload_unused_program();
+    return error;
+  }
+  return Error::Ok;
+}
+
+Result<std::vector<EValue>> ModuleManager::execute(
+    const std::string& module_name,
+    const std::string& method_name,
+    const std::vector<EValue>& input) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(module_name, method_name));
+  return modules_.at(module_name).module->execute(method_name, input);
+}
+
+Result<Module*> ModuleManager::module(const std::string& name) {
+  const auto it = modules_.find(name);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != modules_.end(),
+      InvalidArgument,
+      "Module %s is not added",
+      name.c_str());
+  return it->second.module.get();
+}
+
+Error ModuleManager::set_memory_budget(size_t memory_budget) {
+  memory_budget_ = memory_budget;
+  return make_room(0, /*kept_module=*/"");
+}
+
+Error ModuleManager::make_room(
+    size_t size,
+    const std::string& kept_module,
+    size_t num_kept) {
+  while (memory_size_ + size > memory_budget_ &&
+         loaded_methods_.size() > num_kept) {
+    ET_CHECK_OK_OR_RETURN_ERROR(unload_least_recently_used(kept_module));
+  }
+  if (memory_size_ + size > memory_budget_) {
+    ET_LOG(
+        Error,
+        "%zu bytes don't fit in the budget of %zu bytes, %zu are in use",
+        size,
+        memory_budget_,
+        memory_size_);
+    return Error::MemoryAllocationFailed;
+  }
+  return Error::Ok;
+}
+
+Error ModuleManager::unload_least_recently_used(
+    const std::string& kept_module) {
+  const auto& method = loaded_methods_.back();
+  auto& entry = modules_.at(method.module_name);
+  ET_CHECK_OK_OR_RETURN_ERROR(entry.module->unload_method(method.method_name));
+  memory_size_ -= method.size;
+  if (--entry.num_loaded_methods == 0 && method.module_name != kept_module) {
+    ET_CHECK_OK_OR_RETURN_ERROR(entry.module->unload());
+    memory_size_ -= entry.program_size;
+  }
+  loaded_method_index_.erase({method.module_name, method.method_name});
+  loaded_methods_.pop_back();
+  return Error::Ok;
+}
+
+} // namespace extension
+} // namespace executorch
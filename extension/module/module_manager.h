@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Hosts several modules, e.g. the ASR, language and vision models of an app,
+ * within a global memory budget. Methods are loaded on demand, and loading
+ * one that doesn't fit unloads the least recently used methods of any module
+ * first, along with the program of a module once none of its methods is
+ * left. An unloaded method is loaded again transparently the next time it's
+ * used, from its initial state.
+ *
+ * A method is counted for its planned memory and what it and its delegates
+ * allocate from the runtime allocator at load, see
+ * Module::method_memory_size(). A loaded program is counted for the size of
+ * its file, an upper bound of the constant and delegate data it loads.
+ *
+ * Like Module, this class is not thread-safe.
+ */
+class ModuleManager final {
+ public:
+  /**
+   * @param[in] memory_budget The maximum number of bytes the loaded programs
+   * and methods may hold together.
+   */
+  explicit ModuleManager(size_t memory_budget);
+
+  ModuleManager(const ModuleManager&) = delete;
+  ModuleManager& operator=(const ModuleManager&) = delete;
+
+  /**
+   * Add a module without loading it.
+   *
+   * @param[in] name The name to refer to the module by.
+   * @param[in] file_path The path to the ExecuTorch program file.
+   * @param[in] load_mode The loading mode of the module.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error add_module(
+      const std::string& name,
+      const std::string& file_path,
+      const Module::LoadMode load_mode = Module::LoadMode::MmapUseMlock);
+
+  /**
+   * Load a method of a module if needed, unloading the least recently used
+   * methods until it fits in the budget, and mark it as the most recently
+   * used.
+   *
+   * @param[in] module_name The name of the module.
+   * @param[in] method_name The name of the method.
+   *
+   * @returns An Error to indicate success or failure, MemoryAllocationFailed
+   * if the method doesn't fit in the budget even alone.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error load_method(
+      const std::string& module_name,
+      const std::string& method_name);
+
+  /**
+   * Execute a method of a module with the given inputs, loading it first if
+   * needed.
+   *
+   * @param[in] module_name The name of the module.
+   * @param[in] method_name The name of the method.
+   * @param[in] input A vector of input values to be passed to the method.
+   *
+   * @returns A Result object containing either a vector of output values
+   *          from the method or an error to indicate failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Result<std::vector<::executorch::runtime::EValue>>
+  execute(
+      const std::string& module_name,
+      const std::string& method_name,
+      const std::vector<::executorch::runtime::EValue>& input);
+
+  /**
+   * Get a module, e.g. to set the inputs of a method loaded with
+   * load_method(). Any later call to load_method() or execute() may unload
+   * the methods of the module, so neither method handles nor tensor outputs
+   * should be kept across them, and methods loaded directly on the module
+   * aren't counted against the budget.
+   *
+   * @param[in] name The name of the module.
+   *
+   * @returns A Result object containing either the module or an error to
+   * indicate failure.
+   */
+  ::executorch::runtime::Result<Module*> module(const std::string& name);
+
+  /**
+   * Change the budget, unloading the least recently used methods until the
+   * loaded ones fit in it.
+   *
+   * @param[in] memory_budget The new budget in bytes.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  ::executorch::runtime::Error set_memory_budget(size_t memory_budget);
+
+  size_t memory_budget() const {
+    return memory_budget_;
+  }
+
+  /// The number of bytes the loaded programs and methods hold.
+  size_t memory_size() const {
+    return memory_size_;
+  }
+
+ private:
+  struct ModuleEntry {
+    std::unique_ptr<Module> module;
+    size_t program_size = 0;
+    size_t num_loaded_methods = 0;
+  };
+
+  struct LoadedMethod {
+    std::string module_name;
+    std::string method_name;
+    size_t size = 0;
+  };
+
+  // Unloads the least recently used methods until `size` more bytes fit in
+  // the budget, keeping the `num_kept` most recently used ones and the
+  // program of `kept_module`.
+  ::executorch::runtime::Error make_room(
+      size_t size,
+      const std::string& kept_module,
+      size_t num_kept = 0);
+  ::executorch::runtime::Error unload_least_recently_used(
+      const std::string& kept_module);
+
+  size_t memory_budget_;
+  size_t memory_size_ = 0;
+  std::unordered_map<std::string, ModuleEntry> modules_;
+  // The loaded methods, the most recently used first.
+  std::list<LoadedMethod> loaded_methods_;
+  std::map<
+      std::pair<std::string, std::string>,
+      std::list<LoadedMethod>::iterator>
+      loaded_method_index_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -14,19 +14,24 @@ def define_common_targets():
             name = "module" + aten_suffix,
             srcs = [
                 "module.cpp",
+                "module_manager.cpp",
             ],
             exported_headers = [
                 "module.h",
+                "module_manager.h",
             ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
             deps = [
                 "//executorch/extension/memory_allocator:malloc_memory_allocator",
+                "//executorch/extension/memory_allocator:numa_memory_allocator",
+                "//executorch/extension/data_loader:decompressing_data_loader",
                 "//executorch/extension/data_loader:file_data_loader",
                 "//executorch/extension/data_loader:mmap_data_loader",
             ],
             exported_deps = [
+                "//executorch/extension/memory_allocator:huge_page_memory_allocator",
                 "//executorch/runtime/executor:program" + aten_suffix,
             ],
         )
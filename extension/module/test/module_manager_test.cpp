@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/module_manager.h>
+
+#include <array>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::ModuleManager;
+
+namespace torch::executor {
+
+class ModuleManagerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    model_path_ = std::getenv("RESOURCES_PATH") + std::string("/model.pte");
+  }
+
+  // The bytes one module with its forward method loaded holds.
+  static size_t loaded_size() {
+    ModuleManager manager(std::numeric_limits<size_t>::max());
+    EXPECT_EQ(manager.add_module("model", model_path_), Error::Ok);
+    EXPECT_EQ(manager.load_method("model", "forward"), Error::Ok);
+    return manager.memory_size();
+  }
+
+  static bool is_loaded(ModuleManager& manager, const std::string& name) {
+    return manager.module(name).get()->is_loaded();
+  }
+
+  static std::string model_path_;
+};
+
+std::string ModuleManagerTest::model_path_;
+
+TEST_F(ModuleManagerTest, TestAddModule) {
+  ModuleManager manager(1024);
+
+  EXPECT_EQ(manager.add_module("model", model_path_), Error::Ok);
+  EXPECT_EQ(manager.add_module("model", model_path_), Error::InvalidArgument);
+  EXPECT_EQ(
+      manager.add_module("missing", "/path/to/nonexistent/file.pte"),
+      Error::AccessFailed);
+  EXPECT_TRUE(manager.module("model").ok());
+  EXPECT_EQ(manager.module("missing").error(), Error::InvalidArgument);
+
+  // Nothing is loaded until it's used.
+  EXPECT_FALSE(is_loaded(manager, "model"));
+  EXPECT_EQ(manager.memory_size(), 0);
+}
+
+TEST_F(ModuleManagerTest, TestUnloadsLeastRecentlyUsed) {
+  const size_t size = loaded_size();
+  EXPECT_GT(size, 0);
+  // Room for one module, not two.
+  ModuleManager manager(2 * size - 1);
+  EXPECT_EQ(manager.add_module("asr", model_path_), Error::Ok);
+  EXPECT_EQ(manager.add_module("llm", model_path_), Error::Ok);
+
+  EXPECT_EQ(manager.load_method("asr", "forward"), Error::Ok);
+  EXPECT_EQ(manager.memory_size(), size);
+  EXPECT_EQ(manager.load_method("llm", "forward"), Error::Ok);
+  EXPECT_EQ(manager.memory_size(), size);
+  EXPECT_FALSE(is_loaded(manager, "asr"));
+  EXPECT_TRUE(is_loaded(manager, "llm"));
+
+  // The unloaded module is loaded again on demand.
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result =
+      manager.execute("asr", "forward", {EValue(Tensor(&tensor))});
+  EXPECT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+  EXPECT_TRUE(is_loaded(manager, "asr"));
+  EXPECT_FALSE(is_loaded(manager, "llm"));
+  EXPECT_EQ(manager.memory_size(), size);
+
+  // Lowering the budget unloads everything that doesn't fit.
+  EXPECT_EQ(manager.set_memory_budget(0), Error::Ok);
+  EXPECT_FALSE(is_loaded(manager, "asr"));
+  EXPECT_EQ(manager.memory_size(), 0);
+}
+
+TEST_F(ModuleManagerTest, TestRejectsMethodsOverBudget) {
+  const size_t size = loaded_size();
+  ModuleManager manager(size - 1);
+  EXPECT_EQ(manager.add_module("model", model_path_), Error::Ok);
+
+  EXPECT_EQ(
+      manager.load_method("model", "forward"), Error::MemoryAllocationFailed);
+  EXPECT_FALSE(is_loaded(manager, "model"));
+  EXPECT_EQ(manager.memory_size(), 0);
+
+  EXPECT_EQ(manager.set_memory_budget(size), Error::Ok);
+  EXPECT_EQ(manager.load_method("model", "forward"), Error::Ok);
+  EXPECT_NE(manager.load_method("model", "backward"), Error::Ok);
+  EXPECT_EQ(manager.memory_size(), size);
+}
+
+} // namespace torch::executor
@@ -16,6 +16,8 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 
 using namespace ::testing;
+using ::executorch::extension::HugePages;
+using ::executorch::extension::MethodHandle;
 
 namespace torch::executor {
 
@@ -89,6 +91,97 @@ TEST_F(ModuleTest, TestLoadNonExistentMethod) {
   EXPECT_TRUE(module.is_loaded());
 }
 
+TEST_F(ModuleTest, TestLoadMethodsWithSharedMemory) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.load_methods_with_shared_memory({"forward"}), Error::Ok);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result = module.forward({EValue(Tensor(&tensor))});
+  EXPECT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+
+  // Methods can't be moved into an arena once loaded.
+  EXPECT_EQ(
+      module.load_methods_with_shared_memory({"forward"}),
+      Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestUnloadMethod) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.unload_method("forward"), Error::InvalidArgument);
+  EXPECT_EQ(
+      module.method_memory_size("forward").error(), Error::InvalidArgument);
+
+  EXPECT_EQ(module.load_method("forward"), Error::Ok);
+  const auto size = module.method_memory_size("forward");
+  EXPECT_TRUE(size.ok());
+  EXPECT_GT(*size, 0);
+  EXPECT_EQ(module.unload_method("forward"), Error::Ok);
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+  EXPECT_TRUE(module.is_loaded());
+
+  // The method is loaded again on demand.
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result = module.forward({EValue(Tensor(&tensor))});
+  EXPECT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+}
+
+TEST_F(ModuleTest, TestWarmup) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.warmup("nonexistent"), Error::InvalidArgument);
+
+  // Warming up loads the method.
+  EXPECT_EQ(module.warmup(), Error::Ok);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result = module.forward({EValue(Tensor(&tensor))});
+  EXPECT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+}
+
+TEST_F(ModuleTest, TestUnload) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.load_method("forward"), Error::Ok);
+  EXPECT_EQ(module.unload(), Error::Ok);
+  EXPECT_FALSE(module.is_loaded());
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+
+  EXPECT_EQ(module.load_method("forward"), Error::Ok);
+  EXPECT_TRUE(module.is_loaded());
+
+  // A module without a file can't load its program again.
+  auto loader = util::FileDataLoader::from(model_path_.c_str());
+  EXPECT_TRUE(loader.ok());
+  Module loader_module(
+      std::make_unique<util::FileDataLoader>(std::move(loader.get())));
+  EXPECT_EQ(loader_module.unload(), Error::NotSupported);
+}
+
+TEST_F(ModuleTest, TestLoadNonExistentMethodsWithSharedMemory) {
+  Module module(model_path_);
+
+  EXPECT_NE(
+      module.load_methods_with_shared_memory({"forward", "backward"}),
+      Error::Ok);
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+}
+
 TEST_F(ModuleTest, TestMethodMeta) {
   Module module(model_path_);
 
@@ -255,6 +348,44 @@ TEST_F(ModuleTest, TestForward) {
   EXPECT_NEAR(data2[0], 2.5, 1e-5);
 }
 
+TEST_F(ModuleTest, TestForwardOnNumaNode) {
+  auto module = std::make_unique<Module>(model_path_);
+  const auto error = module->set_numa_node(0);
+  if (error == Error::NotSupported) {
+    GTEST_SKIP() << "NUMA placement is not supported on this platform";
+  }
+  ASSERT_EQ(error, Error::Ok);
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result = module->forward({EValue(Tensor(&tensor))});
+  ASSERT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+
+  EXPECT_EQ(module->set_numa_node(1 << 20), Error::InvalidArgument);
+  EXPECT_EQ(module->set_numa_node(-1), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestForwardWithHugePages) {
+  auto module = std::make_unique<Module>(model_path_);
+  ASSERT_EQ(
+      module->set_huge_pages(HugePages::Transparent, /*prefault=*/true),
+      Error::Ok);
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result = module->forward({EValue(Tensor(&tensor))});
+  ASSERT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+
+  // The planned memory is already allocated.
+  EXPECT_EQ(module->set_huge_pages(HugePages::None), Error::InvalidState);
+}
+
 TEST_F(ModuleTest, TestForwardWithInvalidInputs) {
   Module module(model_path_);
 
@@ -263,6 +394,110 @@ TEST_F(ModuleTest, TestForwardWithInvalidInputs) {
   EXPECT_FALSE(result.ok());
 }
 
+TEST_F(ModuleTest, TestExecuteInPlace) {
+  Module module(model_path_);
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+
+  EXPECT_EQ(module.set_input("forward", EValue(Tensor(&tensor)), 0), Error::Ok);
+  EXPECT_EQ(module.execute_in_place("forward"), Error::Ok);
+
+  const auto result = module.get_output("forward", 0);
+  EXPECT_TRUE(result.ok());
+  EXPECT_NEAR(result->toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+
+  // Running again picks up new input data.
+  input = {2, 3};
+  EXPECT_EQ(module.set_input("forward", EValue(Tensor(&tensor)), 0), Error::Ok);
+  EXPECT_EQ(module.execute_in_place("forward"), Error::Ok);
+
+  const auto result2 = module.get_output("forward", 0);
+  EXPECT_TRUE(result2.ok());
+  EXPECT_NEAR(result2->toTensor().const_data_ptr<float>()[0], 2.5, 1e-5);
+}
+
+TEST_F(ModuleTest, TestGetOutputWithInvalidIndex) {
+  Module module(model_path_);
+
+  EXPECT_FALSE(module.get_output("forward", 0).ok());
+
+  EXPECT_EQ(module.load_method("forward"), Error::Ok);
+  EXPECT_FALSE(module.get_output("forward", 1).ok());
+}
+
+TEST_F(ModuleTest, TestSetInputOnNonExistentMethod) {
+  Module module(model_path_);
+
+  EXPECT_NE(module.set_input("backward", EValue(), 0), Error::Ok);
+  EXPECT_NE(module.execute_in_place("backward"), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestExecuteWithSpans) {
+  Module module(model_path_);
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  std::array<EValue, 1> inputs{EValue(Tensor(&tensor))};
+  std::array<EValue, 1> outputs;
+
+  EXPECT_EQ(
+      module.execute(
+          "forward",
+          Span<const EValue>(inputs.data(), inputs.size()),
+          Span<EValue>(outputs.data(), outputs.size())),
+      Error::Ok);
+  EXPECT_NEAR(outputs[0].toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+
+  // No room for the output.
+  EXPECT_EQ(
+      module.execute(
+          "forward",
+          Span<const EValue>(inputs.data(), inputs.size()),
+          Span<EValue>()),
+      Error::InvalidArgument);
+}
+
+TEST_F(ModuleTest, TestMethodHandle) {
+  Module module(model_path_);
+
+  const auto handle = module.method_handle("forward");
+  EXPECT_TRUE(handle.ok());
+  EXPECT_TRUE(handle->is_valid());
+  EXPECT_EQ(handle->inputs_size(), 1);
+  EXPECT_EQ(handle->outputs_size(), 1);
+
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  std::array<EValue, 1> inputs{EValue(Tensor(&tensor))};
+  std::array<EValue, 1> outputs;
+
+  for (float base : {1.f, 2.f, 3.f}) {
+    input = {base, base + 1};
+    MethodHandle method = handle.get();
+    EXPECT_EQ(
+        method.execute(
+            Span<const EValue>(inputs.data(), inputs.size()),
+            Span<EValue>(outputs.data(), outputs.size())),
+        Error::Ok);
+    EXPECT_NEAR(
+        outputs[0].toTensor().const_data_ptr<float>()[0], base + 0.5, 1e-5);
+  }
+}
+
+TEST_F(ModuleTest, TestMethodHandleOnNonExistentMethod) {
+  Module module(model_path_);
+
+  EXPECT_FALSE(module.method_handle("backward").ok());
+  EXPECT_FALSE(MethodHandle().is_valid());
+}
+
 TEST_F(ModuleTest, TestProgramSharingBetweenModules) {
   Module module1(model_path_);
   EXPECT_FALSE(module1.is_loaded());
@@ -405,4 +640,147 @@ TEST_F(ModuleTest, TestConcurrentExecutionWithSharedProgram) {
   t5.join();
 }
 
+TEST_F(ModuleTest, TestConcurrentExecutionWithPooledMethods) {
+  Module module(model_path_);
+  EXPECT_EQ(module.set_max_concurrency(2), Error::Ok);
+
+  auto thread = [&module](const std::array<float, 2>& input) {
+    std::array<int32_t, 2> sizes{1, 2};
+    TensorImpl tensor(
+        ScalarType::Float, sizes.size(), sizes.data(), (void*)input.data());
+    std::array<EValue, 1> inputs{EValue(Tensor(&tensor))};
+    std::array<EValue, 1> outputs;
+
+    for (int i = 0; i < 10; ++i) {
+      auto lease = module.acquire_method("forward");
+      EXPECT_TRUE(lease.ok());
+      EXPECT_EQ(
+          lease->handle().execute(
+              Span<const EValue>(inputs.data(), inputs.size()),
+              Span<EValue>(outputs.data(), outputs.size())),
+          Error::Ok);
+      const auto data = outputs[0].toTensor().const_data_ptr<float>();
+      EXPECT_NEAR(data[0], (input[0] + input[1]) / 2.0, 1e-5);
+    }
+  };
+
+  std::thread t1(thread, std::array<float, 2>{1, 2});
+  std::thread t2(thread, std::array<float, 2>{2, 3});
+  std::thread t3(thread, std::array<float, 2>{3, 4});
+  std::thread t4(thread, std::array<float, 2>{4, 5});
+
+  t1.join();
+  t2.join();
+  t3.join();
+  t4.join();
+
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+  // Pools can't be resized once in use.
+  EXPECT_EQ(module.set_max_concurrency(4), Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestAcquireMethodRequiresConcurrency) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.acquire_method("forward").error(), Error::InvalidState);
+
+  EXPECT_EQ(module.set_max_concurrency(1), Error::Ok);
+  EXPECT_FALSE(module.acquire_method("backward").ok());
+  EXPECT_TRUE(module.acquire_method("forward").ok());
+}
+
+TEST_F(ModuleTest, TestSetMethodAlternative) {
+  Module module(model_path_);
+
+  EXPECT_NE(module.set_method_alternative("forward", "backward"), Error::Ok);
+  EXPECT_EQ(
+      module.set_method_alternative("forward", "forward"),
+      Error::InvalidArgument);
+  EXPECT_EQ(module.selected_method("forward"), "forward");
+
+  // Executions without an alternative are unaffected.
+  std::array<float, 2> input{1, 2};
+  std::array<int32_t, 2> sizes{1, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto result = module.forward({EValue(Tensor(&tensor))});
+  EXPECT_TRUE(result.ok());
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 1.5, 1e-5);
+
+  EXPECT_EQ(module.set_max_concurrency(2), Error::Ok);
+  EXPECT_EQ(
+      module.set_method_alternative("forward", "backward"),
+      Error::NotSupported);
+}
+
+TEST_F(ModuleTest, TestMethodAlternativeSelectsOneOfThePair) {
+  // "forward" adds 3 and "forward2" adds 5 to a 2x2 input. Real alternatives
+  // compute the same outputs, but different ones show which method ran.
+  const char* path = std::getenv("ET_MODULE_MULTI_ENTRY_PATH");
+  if (path == nullptr) {
+    GTEST_SKIP() << "ET_MODULE_MULTI_ENTRY_PATH is not set";
+  }
+  Module module(path);
+
+  const size_t num_timed_runs = 2;
+  EXPECT_EQ(
+      module.set_method_alternative("forward", "forward2", num_timed_runs),
+      Error::Ok);
+
+  std::array<float, 4> input{1, 1, 1, 1};
+  std::array<int32_t, 2> sizes{2, 2};
+  TensorImpl tensor(
+      ScalarType::Float, sizes.size(), sizes.data(), input.data());
+  const auto run = [&]() {
+    const auto result = module.forward({EValue(Tensor(&tensor))});
+    EXPECT_TRUE(result.ok());
+    // Sized from "forward", whichever method ran.
+    EXPECT_EQ(result->size(), 1);
+    return result->at(0).toTensor().const_data_ptr<float>()[0];
+  };
+
+  // The executions alternate between the two methods, first untimed and
+  // then num_timed_runs times each, before one of them is selected.
+  const size_t num_trial_runs = 2 * (num_timed_runs + 1);
+  for (size_t i = 0; i < num_trial_runs; ++i) {
+    EXPECT_EQ(module.selected_method("forward"), "forward");
+    EXPECT_FLOAT_EQ(run(), i % 2 == 0 ? 4 : 6);
+  }
+
+  const std::string selected = module.selected_method("forward");
+  EXPECT_TRUE(selected == "forward" || selected == "forward2");
+  const float expected = selected == "forward" ? 4 : 6;
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_FLOAT_EQ(run(), expected);
+  }
+  EXPECT_EQ(module.selected_method("forward"), selected);
+
+  // Executions with given outputs run the selected method as well.
+  std::vector<EValue> inputs{EValue(Tensor(&tensor))};
+  std::vector<EValue> outputs(1);
+  EXPECT_EQ(
+      module.execute(
+          "forward",
+          Span<const EValue>(inputs.data(), inputs.size()),
+          Span<EValue>(outputs.data(), outputs.size())),
+      Error::Ok);
+  EXPECT_FLOAT_EQ(
+      outputs[0].toTensor().const_data_ptr<float>()[0], expected);
+}
+
+TEST_F(ModuleTest, TestLoadAdapterRejectsInvalidAdapters) {
+  Module module(model_path_);
+
+  EXPECT_NE(
+      module.load_adapter("forward", "/path/to/nonexistent/adapter.pte"),
+      Error::Ok);
+  // An adapter returns its weights from a forward method without inputs.
+  EXPECT_EQ(
+      module.load_adapter("forward", model_path_), Error::InvalidArgument);
+  EXPECT_NE(module.load_adapter("backward", model_path_), Error::Ok);
+
+  EXPECT_EQ(module.set_max_concurrency(2), Error::Ok);
+  EXPECT_EQ(module.load_adapter("forward", model_path_), Error::NotSupported);
+}
+
 } // namespace torch::executor
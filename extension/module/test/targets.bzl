@@ -7,6 +7,14 @@ def define_common_targets():
     TARGETS and BUCK files that call this function.
     """
 
+    test_env = {
+        "RESOURCES_PATH": "$(location :resources)/resources",
+    }
+    if not runtime.is_oss:
+        # A program with two methods of the same signature, exported by the
+        # fbcode-only authoring tools.
+        test_env["ET_MODULE_MULTI_ENTRY_PATH"] = "$(location fbcode//executorch/test/models:exported_programs[ModuleMultipleEntry.pte])"
+
     runtime.cxx_test(
         name = "test",
         srcs = [
@@ -17,6 +25,18 @@ def define_common_targets():
             "//executorch/extension/data_loader:file_data_loader",
             "//executorch/extension/module:module",
         ],
+        env = test_env,
+    )
+
+    runtime.cxx_test(
+        name = "module_manager_test",
+        srcs = [
+            "module_manager_test.cpp",
+        ],
+        deps = [
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/extension/module:module",
+        ],
         env = {
             "RESOURCES_PATH": "$(location :resources)/resources",
         },
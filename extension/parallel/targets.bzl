@@ -27,4 +27,27 @@ def define_common_targets():
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core/exec_aten/util:tensor_util" + aten_suffix,
             ],
+            exported_deps = [
+                "//executorch/extension/pytree:pytree",
+            ],
         )
+
+    runtime.cxx_library(
+        name = "threadpool_task_runner",
+        srcs = [
+            "threadpool_task_runner.cpp",
+        ],
+        exported_headers = [
+            "threadpool_task_runner.h",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            "//executorch/backends/xnnpack/threadpool:threadpool",
+        ],
+        exported_deps = [
+            "//executorch/runtime/executor:task_runner",
+        ],
+    )
@@ -13,7 +13,20 @@ def define_common_targets():
             "thread_parallel_test.cpp",
         ],
         deps = [
+            "//executorch/backends/xnnpack/threadpool:threadpool",
             "//executorch/extension/parallel:thread_parallel",
             "//executorch/runtime/platform:platform",
         ],
     )
+
+    runtime.cxx_test(
+        name = "threadpool_task_runner_test",
+        srcs = [
+            "threadpool_task_runner_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/extension/parallel:threadpool_task_runner",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
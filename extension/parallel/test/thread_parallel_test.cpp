@@ -8,14 +8,26 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <vector>
 
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
 #include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/runtime/platform/platform.h>
 
 using namespace ::testing;
+using ::executorch::extension::get_parallel_schedule;
+using ::executorch::extension::get_thread_num;
+using ::executorch::extension::in_parallel_region;
 using ::executorch::extension::parallel_for;
+using ::executorch::extension::parallel_for_2d;
+using ::executorch::extension::parallel_reduce;
+using ::executorch::extension::ParallelSchedule;
+using ::executorch::extension::set_parallel_schedule;
 
 class ParallelTest : public ::testing::Test {
  protected:
@@ -191,3 +203,278 @@ TEST_F(ParallelTest, TestChunkSizeTooLarge) {
     EXPECT_EQ(data_[i], i);
   }
 }
+
+TEST_F(ParallelTest, TestDynamicScheduleAllInvoked) {
+  EXPECT_TRUE(parallel_for(
+      0,
+      10,
+      1,
+      [this](int64_t begin, int64_t end) {
+        this->RunExclusiveTask(begin, end);
+      },
+      ParallelSchedule::Dynamic));
+
+  int expected_sum = 0;
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data_[i], i);
+    expected_sum += i;
+  }
+  EXPECT_EQ(sum_of_all_elements_, expected_sum);
+}
+
+TEST_F(ParallelTest, TestDynamicScheduleChunkSize3Middle) {
+  EXPECT_TRUE(parallel_for(
+      1,
+      9,
+      3,
+      [this](int64_t begin, int64_t end) {
+        this->RunExclusiveTask(begin, end);
+      },
+      ParallelSchedule::Dynamic));
+
+  EXPECT_EQ(data_[0], 0);
+  for (int64_t i = 1; i < 9; ++i) {
+    EXPECT_EQ(data_[i], i);
+  }
+  EXPECT_EQ(data_[9], 0);
+}
+
+TEST_F(ParallelTest, TestDynamicScheduleThreadNumIsBelowThreadCount) {
+  const int64_t thread_count =
+      torch::executorch::threadpool::get_threadpool()->get_thread_count();
+  EXPECT_TRUE(parallel_for(
+      0,
+      10,
+      1,
+      [this, thread_count](int64_t begin, int64_t end) {
+        EXPECT_LT(get_thread_num(), thread_count);
+        this->RunExclusiveTask(begin, end);
+      },
+      ParallelSchedule::Dynamic));
+
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data_[i], i);
+  }
+}
+
+TEST_F(ParallelTest, TestDefaultSchedule) {
+  EXPECT_EQ(get_parallel_schedule(), ParallelSchedule::Static);
+
+  set_parallel_schedule(ParallelSchedule::Dynamic);
+  EXPECT_EQ(get_parallel_schedule(), ParallelSchedule::Dynamic);
+  EXPECT_TRUE(parallel_for(0, 10, 1, [this](int64_t begin, int64_t end) {
+    this->RunExclusiveTask(begin, end);
+  }));
+  set_parallel_schedule(ParallelSchedule::Static);
+
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data_[i], i);
+  }
+}
+
+TEST_F(ParallelTest, TestNestedParallelForRunsInline) {
+  EXPECT_FALSE(in_parallel_region());
+
+  EXPECT_TRUE(parallel_for(0, 10, 2, [this](int64_t begin, int64_t end) {
+    EXPECT_TRUE(in_parallel_region());
+    const int64_t thread_num = get_thread_num();
+    // The inner call must not wait on the pool that is running this chunk.
+    EXPECT_TRUE(parallel_for(
+        begin, end, 1, [&](int64_t inner_begin, int64_t inner_end) {
+          EXPECT_EQ(inner_begin, begin);
+          EXPECT_EQ(inner_end, end);
+          EXPECT_EQ(get_thread_num(), thread_num);
+          this->RunExclusiveTask(inner_begin, inner_end);
+        }));
+  }));
+
+  EXPECT_FALSE(in_parallel_region());
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data_[i], i);
+  }
+}
+
+TEST_F(ParallelTest, TestMoveOnlyCallable) {
+  // std::function requires a copyable callable, so this can only bind to the
+  // templated overload.
+  auto offset = std::make_unique<int>(0);
+  auto fn = [this, offset = std::move(offset)](int64_t begin, int64_t end) {
+    this->RunExclusiveTask(begin + *offset, end + *offset);
+  };
+  EXPECT_TRUE(parallel_for(0, 10, 3, fn));
+  EXPECT_TRUE(parallel_for(0, 0, 1, fn, ParallelSchedule::Dynamic));
+
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data_[i], i);
+  }
+}
+
+TEST_F(ParallelTest, TestStdFunction) {
+  const std::function<void(int64_t, int64_t)> fn =
+      [this](int64_t begin, int64_t end) {
+        this->RunExclusiveTask(begin, end);
+      };
+  EXPECT_TRUE(parallel_for(0, 10, 2, fn));
+
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data_[i], i);
+  }
+}
+
+TEST(ParallelReduceTest, TestSum) {
+  std::vector<int64_t> values(1000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  bool ok = false;
+  const int64_t sum = parallel_reduce(
+      0,
+      values.size(),
+      16,
+      int64_t(0),
+      [&](int64_t begin, int64_t end, int64_t ident) {
+        int64_t partial = ident;
+        for (int64_t i = begin; i < end; ++i) {
+          partial += values[i];
+        }
+        return partial;
+      },
+      [](int64_t a, int64_t b) { return a + b; },
+      &ok);
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+}
+
+TEST(ParallelReduceTest, TestMaxOfMiddle) {
+  const std::array<float, 10> values = {9, 1, 4, 7, 3, 8, 2, 6, 5, 10};
+  const float max = parallel_reduce(
+      1,
+      9,
+      1,
+      -std::numeric_limits<float>::infinity(),
+      [&](int64_t begin, int64_t end, float ident) {
+        float partial = ident;
+        for (int64_t i = begin; i < end; ++i) {
+          partial = std::max(partial, values[i]);
+        }
+        return partial;
+      },
+      [](float a, float b) { return std::max(a, b); });
+  EXPECT_EQ(max, 8);
+}
+
+TEST(ParallelReduceTest, TestEmptyRangeReturnsIdentity) {
+  bool ok = false;
+  const int64_t result = parallel_reduce(
+      5,
+      5,
+      1,
+      int64_t(42),
+      [](int64_t, int64_t, int64_t) -> int64_t {
+        ADD_FAILURE() << "f must not be called";
+        return 0;
+      },
+      [](int64_t a, int64_t b) { return a + b; },
+      &ok);
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(result, 42);
+}
+
+TEST(ParallelReduceTest, TestInvalidRange) {
+  bool ok = true;
+  const int64_t result = parallel_reduce(
+      10,
+      0,
+      1,
+      int64_t(0),
+      [](int64_t, int64_t, int64_t ident) { return ident; },
+      [](int64_t a, int64_t b) { return a + b; },
+      &ok);
+  EXPECT_FALSE(ok);
+  EXPECT_EQ(result, 0);
+}
+
+TEST(ParallelReduceTest, TestNestedRunsInline) {
+  EXPECT_TRUE(parallel_for(0, 4, 1, [](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t count = parallel_reduce(
+          0,
+          100,
+          1,
+          int64_t(0),
+          [](int64_t inner_begin, int64_t inner_end, int64_t ident) {
+            EXPECT_EQ(inner_begin, 0);
+            EXPECT_EQ(inner_end, 100);
+            return ident + inner_end - inner_begin;
+          },
+          [](int64_t a, int64_t b) { return a + b; });
+      EXPECT_EQ(count, 100);
+    }
+  }));
+}
+
+TEST(ParallelFor2dTest, TestEachElementVisitedOnce) {
+  constexpr int64_t kRows = 37;
+  constexpr int64_t kCols = 45;
+  std::vector<int> visits(kRows * kCols, 0);
+  for (const ParallelSchedule schedule :
+       {ParallelSchedule::Static, ParallelSchedule::Dynamic}) {
+    std::fill(visits.begin(), visits.end(), 0);
+    EXPECT_TRUE(parallel_for_2d(
+        2,
+        kRows,
+        4,
+        3,
+        kCols,
+        8,
+        [&](int64_t row_begin,
+            int64_t row_end,
+            int64_t col_begin,
+            int64_t col_end) {
+          EXPECT_LE(row_end - row_begin, 4);
+          EXPECT_LE(col_end - col_begin, 8);
+          // Tiles start on the tile grid.
+          EXPECT_EQ((row_begin - 2) % 4, 0);
+          EXPECT_EQ((col_begin - 3) % 8, 0);
+          for (int64_t r = row_begin; r < row_end; ++r) {
+            for (int64_t c = col_begin; c < col_end; ++c) {
+              // Tiles don't overlap, so no two threads write the same element.
+              ++visits[r * kCols + c];
+            }
+          }
+        },
+        schedule));
+    for (int64_t r = 0; r < kRows; ++r) {
+      for (int64_t c = 0; c < kCols; ++c) {
+        EXPECT_EQ(visits[r * kCols + c], r >= 2 && c >= 3 ? 1 : 0)
+            << "row " << r << " col " << c;
+      }
+    }
+  }
+}
+
+TEST(ParallelFor2dTest, TestTileOrderCoversGridInBands) {
+  // 10 x 3 tiles: a band of 8 tile rows, then a band of the last 2.
+  std::vector<std::pair<int64_t, int64_t>> tiles;
+  for (int64_t index = 0; index < 30; ++index) {
+    int64_t row = -1, col = -1;
+    ::executorch::extension::internal::tile_from_index(index, 10, 3, row, col);
+    tiles.emplace_back(row, col);
+  }
+  // The first band goes down its 8 tile rows before moving right.
+  EXPECT_EQ(tiles[0], std::make_pair(int64_t(0), int64_t(0)));
+  EXPECT_EQ(tiles[7], std::make_pair(int64_t(7), int64_t(0)));
+  EXPECT_EQ(tiles[8], std::make_pair(int64_t(0), int64_t(1)));
+  EXPECT_EQ(tiles[23], std::make_pair(int64_t(7), int64_t(2)));
+  EXPECT_EQ(tiles[24], std::make_pair(int64_t(8), int64_t(0)));
+  EXPECT_EQ(tiles[29], std::make_pair(int64_t(9), int64_t(2)));
+  std::sort(tiles.begin(), tiles.end());
+  EXPECT_EQ(std::unique(tiles.begin(), tiles.end()), tiles.end());
+}
+
+TEST(ParallelFor2dTest, TestInvalidTileSize) {
+  EXPECT_FALSE(parallel_for_2d(
+      0, 4, 0, 0, 4, 1, [](int64_t, int64_t, int64_t, int64_t) {
+        ADD_FAILURE() << "f must not be called";
+      }));
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/extension/parallel/threadpool_task_runner.h>
+#include <executorch/runtime/platform/platform.h>
+
+using namespace ::testing;
+using ::executorch::extension::parallel_for;
+using ::executorch::extension::ThreadPoolTaskRunner;
+
+TEST(ThreadPoolTaskRunnerTest, MaxConcurrency) {
+  ThreadPoolTaskRunner default_runner;
+  EXPECT_GE(default_runner.max_concurrency(), 1);
+
+  ThreadPoolTaskRunner runner(3);
+  EXPECT_EQ(runner.max_concurrency(), 3);
+}
+
+TEST(ThreadPoolTaskRunnerTest, RunsEveryTaskOnce) {
+  std::array<std::atomic<int>, 16> counts{};
+  ThreadPoolTaskRunner runner;
+  runner.run(
+      [](void* context, size_t task_index) {
+        auto* counts = static_cast<std::array<std::atomic<int>, 16>*>(context);
+        (*counts)[task_index]++;
+      },
+      &counts,
+      counts.size());
+
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(ThreadPoolTaskRunnerTest, NestedParallelForRunsInline) {
+  std::array<std::array<int, 8>, 4> data{};
+  ThreadPoolTaskRunner runner;
+  runner.run(
+      [](void* context, size_t task_index) {
+        auto& row =
+            (*static_cast<std::array<std::array<int, 8>, 4>*>(context))
+                [task_index];
+        // Would deadlock if the task tried to use the busy threadpool.
+        EXPECT_TRUE(parallel_for(0, row.size(), 1, [&](int64_t b, int64_t e) {
+          for (int64_t i = b; i < e; ++i) {
+            row[i] = static_cast<int>(i);
+          }
+        }));
+      },
+      &data,
+      data.size());
+
+  for (const auto& row : data) {
+    for (size_t i = 0; i < row.size(); ++i) {
+      EXPECT_EQ(row[i], i);
+    }
+  }
+}
@@ -6,9 +6,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
 #include <tuple>
 
 #include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
 #include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/assert.h>
@@ -18,7 +20,32 @@ namespace extension {
 
 namespace {
 thread_local int64_t thread_num_ = 0;
-}
+thread_local bool in_parallel_region_ = false;
+
+std::atomic<ParallelSchedule> default_schedule_{ParallelSchedule::Static};
+
+// With ParallelSchedule::Dynamic, the range is split into about this many
+// chunks per thread, so that a slow thread holds up at most a small fraction
+// of the work.
+constexpr int64_t kDynamicChunksPerThread = 4;
+
+// Marks the current thread as running a parallel_for() chunk for the lifetime
+// of the guard. Nested parallel_for() calls, and anything else that goes
+// through the threadpool, then run serially on this thread.
+class ParallelRegionGuard final {
+ public:
+  ParallelRegionGuard() : prev_in_parallel_region_(in_parallel_region_) {
+    in_parallel_region_ = true;
+  }
+  ~ParallelRegionGuard() {
+    in_parallel_region_ = prev_in_parallel_region_;
+  }
+
+ private:
+  const bool prev_in_parallel_region_;
+  torch::executorch::threadpool::NoThreadPoolGuard no_threadpool_guard_;
+};
+} // namespace
 
 using namespace torch::executorch::threadpool;
 
@@ -48,31 +75,172 @@ calc_num_tasks_and_chunk_size(int64_t begin, int64_t end, int64_t grain_size) {
   return std::make_tuple(num_tasks, chunk_size);
 }
 
-bool parallel_for(
+inline std::tuple<int64_t, int64_t> calc_num_chunks_and_chunk_size_dynamic(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    int64_t thread_count) {
+  if ((end - begin) < grain_size) {
+    return std::make_tuple(1, std::max((int64_t)0, end - begin));
+  }
+  int64_t chunk_size =
+      divup((end - begin), thread_count * kDynamicChunksPerThread);
+  chunk_size = std::max(grain_size, chunk_size);
+  int64_t num_chunks = divup((end - begin), chunk_size);
+  return std::make_tuple(num_chunks, chunk_size);
+}
+
+namespace {
+
+struct StaticTaskContext final {
+  pytree::FunctionRef<void(int64_t, int64_t)> f;
+  int64_t begin;
+  int64_t end;
+  int64_t chunk_size;
+};
+
+void run_static_task(void* const context, const size_t task_id) {
+  const auto* ctx = static_cast<const StaticTaskContext*>(context);
+  ParallelRegionGuard guard;
+  set_thread_num(task_id);
+  int64_t local_start =
+      ctx->begin + static_cast<int64_t>(task_id) * ctx->chunk_size;
+  if (local_start < ctx->end) {
+    int64_t local_end = std::min(ctx->end, ctx->chunk_size + local_start);
+    ctx->f(local_start, local_end);
+  }
+}
+
+struct DynamicTaskContext final {
+  pytree::FunctionRef<void(int64_t, int64_t)> f;
+  int64_t begin;
+  int64_t end;
+  int64_t chunk_size;
+  int64_t num_chunks;
+  std::atomic<int64_t> next_chunk;
+};
+
+// Claims chunks until none are left, so that faster threads process more of
+// them. Task ids stay below the thread count, so get_thread_num() can still
+// index per-thread scratch buffers.
+void run_dynamic_task(void* const context, const size_t task_id) {
+  auto* ctx = static_cast<DynamicTaskContext*>(context);
+  ParallelRegionGuard guard;
+  set_thread_num(task_id);
+  for (int64_t chunk = ctx->next_chunk.fetch_add(1); chunk < ctx->num_chunks;
+       chunk = ctx->next_chunk.fetch_add(1)) {
+    const int64_t local_start = ctx->begin + chunk * ctx->chunk_size;
+    ctx->f(local_start, std::min(ctx->end, local_start + ctx->chunk_size));
+  }
+}
+
+} // namespace
+
+namespace internal {
+
+bool parallel_for_impl(
     const int64_t begin,
     const int64_t end,
     const int64_t grain_size,
-    const std::function<void(int64_t, int64_t)>& f) {
+    pytree::FunctionRef<void(int64_t, int64_t)> f,
+    ParallelSchedule schedule) {
   ET_LOG_AND_RETURN_IF_FALSE(begin >= 0 && end >= 0);
   ET_LOG_AND_RETURN_IF_FALSE(end >= begin);
   ET_LOG_AND_RETURN_IF_FALSE(grain_size > 0);
+
+  // A nested parallel region: the pool is busy with the outer parallel_for(),
+  // so run the whole range on this thread, which keeps its thread number.
+  if (in_parallel_region_) {
+    f(begin, end);
+    return true;
+  }
+
+  // The threadpool is disabled for this thread, typically because this thread
+  // is already one of its workers. Don't touch the pool at all: even querying
+  // its size would block on the run() that is in progress.
+  if (NoThreadPoolGuard::is_enabled()) {
+    set_thread_num(0);
+    f(begin, end);
+    return true;
+  }
+
+  // Per protocol from threadpool (pthreadpool), when run() returns, all tasks
+  // are executed, so this is synchronous and the contexts can live on the
+  // stack.
+  if (schedule == ParallelSchedule::Dynamic) {
+    const int64_t thread_count = get_threadpool()->get_thread_count();
+    int64_t num_chunks = 0, chunk_size = 0;
+    std::tie(num_chunks, chunk_size) = calc_num_chunks_and_chunk_size_dynamic(
+        begin, end, grain_size, thread_count);
+    if (num_chunks == 0) {
+      return true;
+    }
+    DynamicTaskContext context{f, begin, end, chunk_size, num_chunks, {0}};
+    get_threadpool()->run(
+        run_dynamic_task, &context, std::min(thread_count, num_chunks));
+    return true;
+  }
+
   int64_t num_tasks = 0, chunk_size = 0;
   std::tie(num_tasks, chunk_size) =
       calc_num_tasks_and_chunk_size(begin, end, grain_size);
+  StaticTaskContext context{f, begin, end, chunk_size};
+  get_threadpool()->run(run_static_task, &context, num_tasks);
+  return true;
+}
 
-  auto task = [f, begin, end, chunk_size](size_t task_id) {
-    set_thread_num(task_id);
-    int64_t local_start = begin + static_cast<int64_t>(task_id) * chunk_size;
-    if (local_start < end) {
-      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-      f(local_start, local_end);
-    }
+int64_t static_chunk_size(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size) {
+  // Such calls run the whole range on the calling thread; see
+  // parallel_for_impl().
+  if (in_parallel_region_ || NoThreadPoolGuard::is_enabled()) {
+    return std::max((int64_t)1, end - begin);
+  }
+  int64_t num_tasks = 0, chunk_size = 0;
+  std::tie(num_tasks, chunk_size) =
+      calc_num_tasks_and_chunk_size(begin, end, grain_size);
+  return std::max((int64_t)1, chunk_size);
+}
+
+} // namespace internal
+
+bool parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f,
+    ParallelSchedule schedule) {
+  auto call = [&f](int64_t chunk_begin, int64_t chunk_end) {
+    f(chunk_begin, chunk_end);
   };
+  return internal::parallel_for_impl(
+      begin,
+      end,
+      grain_size,
+      pytree::FunctionRef<void(int64_t, int64_t)>(call),
+      schedule);
+}
 
-  // Per protocol from threadpool (pthreadpool), when this returns, all tasks
-  // are executed, so this is synchronous.
-  get_threadpool()->run(task, num_tasks);
-  return true;
+bool parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f) {
+  return parallel_for(begin, end, grain_size, f, get_parallel_schedule());
+}
+
+void set_parallel_schedule(ParallelSchedule schedule) {
+  default_schedule_.store(schedule, std::memory_order_relaxed);
+}
+
+ParallelSchedule get_parallel_schedule() {
+  return default_schedule_.load(std::memory_order_relaxed);
+}
+
+bool in_parallel_region() {
+  return in_parallel_region_;
 }
 
 } // namespace extension
@@ -8,13 +8,33 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <functional>
+#include <type_traits>
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <vector>
+
+#include <executorch/extension/pytree/function_ref.h>
 
 namespace executorch {
 namespace extension {
 
+/**
+ * How parallel_for() hands out chunks of work to the threads of the pool.
+ */
+enum class ParallelSchedule {
+  /// The range is split into one chunk per thread up front. This has the
+  /// lowest overhead, but the slowest thread sets the latency of the whole
+  /// call, e.g. on big.LITTLE CPUs.
+  Static,
+  /// The range is split into several smaller chunks per thread, which the
+  /// threads claim one at a time as they finish their previous chunk, so
+  /// faster threads end up processing more of the range.
+  Dynamic,
+};
+
 /**
  * A helper to run function in parallel.
  *
@@ -24,18 +44,261 @@ namespace extension {
  * described below
  * f: user function applied in parallel to the chunks, signature:
  *   void f(int64_t begin, int64_t end)
+ * schedule: how chunks are assigned to threads; see ParallelSchedule. The
+ * overload without this argument uses get_parallel_schedule().
  * Returns true if all work items are processed successfully, false otherwise
  *
+ * Calls to parallel_for() made from inside f, i.e. nested parallel regions,
+ * run serially on the calling thread instead of oversubscribing the pool.
+ *
  * Warning: parallel_for does NOT copy thread local states from the current
  * thread to the worker threads. Users need to protect the access to captured
  * data if they mutate them in f.
  */
+bool parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f,
+    ParallelSchedule schedule);
+
 bool parallel_for(
     const int64_t begin,
     const int64_t end,
     const int64_t grain_size,
     const std::function<void(int64_t, int64_t)>& f);
 
+/**
+ * Sets the schedule used by parallel_for() calls that do not pass one.
+ * Defaults to ParallelSchedule::Static.
+ */
+void set_parallel_schedule(ParallelSchedule schedule);
+
+ParallelSchedule get_parallel_schedule();
+
+/**
+ * Returns true if the calling thread is running a chunk of a parallel_for()
+ * call.
+ */
+bool in_parallel_region();
+
+namespace internal {
+bool parallel_for_impl(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    pytree::FunctionRef<void(int64_t, int64_t)> f,
+    ParallelSchedule schedule);
+
+/**
+ * Returns the size of the chunks that parallel_for() splits [begin, end) into
+ * with ParallelSchedule::Static, or the whole range if the call would run
+ * serially, e.g. inside another parallel region.
+ */
+int64_t static_chunk_size(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size);
+
+// The number of tile rows in a band of parallel_for_2d(); see
+// tile_from_index().
+constexpr int64_t kTileBandRows = 8;
+
+/**
+ * Maps the index of a tile to its (row, col) in a grid of num_tile_rows x
+ * num_tile_cols tiles. Tiles are visited in bands of kTileBandRows tile rows,
+ * column by column within a band, so a run of consecutive tiles covers a few
+ * rows and a few columns of the grid instead of one long row. A thread that
+ * takes such a run reuses the rows and columns that its earlier tiles loaded
+ * into cache.
+ */
+inline void tile_from_index(
+    const int64_t index,
+    const int64_t num_tile_rows,
+    const int64_t num_tile_cols,
+    int64_t& tile_row,
+    int64_t& tile_col) {
+  const int64_t band = index / (kTileBandRows * num_tile_cols);
+  const int64_t band_begin = band * kTileBandRows;
+  const int64_t band_rows =
+      std::min(kTileBandRows, num_tile_rows - band_begin);
+  const int64_t index_in_band = index - band_begin * num_tile_cols;
+  tile_row = band_begin + index_in_band % band_rows;
+  tile_col = index_in_band / band_rows;
+}
+} // namespace internal
+
+/**
+ * Same as the overloads above, but takes any callable with the signature
+ * void f(int64_t begin, int64_t end) by reference. Unlike a std::function, it
+ * is never copied or allocated, and calling it costs a single indirect call
+ * per chunk, which matters for loops that start many small parallel regions.
+ */
+template <typename Func>
+bool parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const Func& f,
+    ParallelSchedule schedule) {
+  auto call = [&f](int64_t chunk_begin, int64_t chunk_end) {
+    f(chunk_begin, chunk_end);
+  };
+  return internal::parallel_for_impl(
+      begin,
+      end,
+      grain_size,
+      pytree::FunctionRef<void(int64_t, int64_t)>(call),
+      schedule);
+}
+
+template <typename Func>
+bool parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const Func& f) {
+  return parallel_for(begin, end, grain_size, f, get_parallel_schedule());
+}
+
+/**
+ * Reduces [begin, end) in parallel.
+ *
+ * The range is split into the chunks that parallel_for() would use with
+ * ParallelSchedule::Static, at most one per thread. f(chunk_begin, chunk_end,
+ * ident) reduces each chunk into a per-chunk partial, and combine(a, b) folds
+ * the partials into ident in chunk order. combine must be associative, and
+ * ident must be its identity, e.g. 0 for a sum or -inf for a max.
+ *
+ * Since partials are combined in a fixed order, the result only depends on
+ * the number of chunks, not on which thread ran which chunk. Floating point
+ * sums may still differ from a serial loop, and between thread counts.
+ *
+ * Returns ident for an empty range. Sets *ok to false, if given, when the
+ * range or grain size is invalid; see parallel_for().
+ */
+template <typename T, typename Func, typename Combine>
+T parallel_reduce(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const T& ident,
+    const Func& f,
+    const Combine& combine,
+    bool* ok = nullptr) {
+  // The partials of a std::vector<bool> share bytes, so threads writing
+  // neighbouring chunks would race.
+  static_assert(
+      !std::is_same<T, bool>::value, "Reduce bool ranges into an integer");
+  const bool valid = begin >= 0 && end >= begin && grain_size > 0;
+  if (ok != nullptr) {
+    *ok = valid;
+  }
+  if (!valid || begin == end) {
+    return ident;
+  }
+  const int64_t chunk_size =
+      internal::static_chunk_size(begin, end, grain_size);
+  const int64_t num_chunks = (end - begin + chunk_size - 1) / chunk_size;
+  if (num_chunks == 1) {
+    return combine(ident, f(begin, end, ident));
+  }
+
+  std::vector<T> partials(num_chunks, ident);
+  const bool success = parallel_for(
+      0,
+      num_chunks,
+      1,
+      [&](int64_t chunk_begin, int64_t chunk_end) {
+        for (int64_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+          const int64_t local_begin = begin + chunk * chunk_size;
+          partials[chunk] =
+              f(local_begin, std::min(end, local_begin + chunk_size), ident);
+        }
+      },
+      ParallelSchedule::Static);
+  if (ok != nullptr) {
+    *ok = success;
+  }
+
+  T result = ident;
+  for (const T& partial : partials) {
+    result = combine(result, partial);
+  }
+  return result;
+}
+
+/**
+ * Runs f over the tiles of the 2-D range [row_begin, row_end) x
+ * [col_begin, col_end) in parallel, with signature:
+ *   void f(int64_t row_begin, int64_t row_end,
+ *          int64_t col_begin, int64_t col_end)
+ *
+ * Tiles are tile_rows x tile_cols, clipped at the end of the range, and each
+ * is passed to f exactly once. Threads take runs of consecutive tiles in the
+ * cache-friendly order of internal::tile_from_index(), so pick tiles that fit
+ * a thread's working set in L1/L2, e.g. the blocks of a transpose or a GEMM.
+ *
+ * Returns true if all tiles are processed successfully, false otherwise.
+ */
+template <typename Func>
+bool parallel_for_2d(
+    const int64_t row_begin,
+    const int64_t row_end,
+    const int64_t tile_rows,
+    const int64_t col_begin,
+    const int64_t col_end,
+    const int64_t tile_cols,
+    const Func& f,
+    ParallelSchedule schedule) {
+  if (tile_rows <= 0 || tile_cols <= 0 || row_begin < 0 || col_begin < 0 ||
+      row_end < row_begin || col_end < col_begin) {
+    return false;
+  }
+  const int64_t num_tile_rows =
+      (row_end - row_begin + tile_rows - 1) / tile_rows;
+  const int64_t num_tile_cols =
+      (col_end - col_begin + tile_cols - 1) / tile_cols;
+  return parallel_for(
+      0,
+      num_tile_rows * num_tile_cols,
+      1,
+      [&](int64_t tiles_begin, int64_t tiles_end) {
+        for (int64_t index = tiles_begin; index < tiles_end; ++index) {
+          int64_t tile_row = 0, tile_col = 0;
+          internal::tile_from_index(
+              index, num_tile_rows, num_tile_cols, tile_row, tile_col);
+          const int64_t r = row_begin + tile_row * tile_rows;
+          const int64_t c = col_begin + tile_col * tile_cols;
+          f(r,
+            std::min(row_end, r + tile_rows),
+            c,
+            std::min(col_end, c + tile_cols));
+        }
+      },
+      schedule);
+}
+
+template <typename Func>
+bool parallel_for_2d(
+    const int64_t row_begin,
+    const int64_t row_end,
+    const int64_t tile_rows,
+    const int64_t col_begin,
+    const int64_t col_end,
+    const int64_t tile_cols,
+    const Func& f) {
+  return parallel_for_2d(
+      row_begin,
+      row_end,
+      tile_rows,
+      col_begin,
+      col_end,
+      tile_cols,
+      f,
+      get_parallel_schedule());
+}
+
 int64_t get_thread_num();
 
 void set_thread_num(int64_t thread_num);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/parallel/threadpool_task_runner.h>
+
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
+
+namespace executorch {
+namespace extension {
+
+using ::torch::executorch::threadpool::get_threadpool;
+using ::torch::executorch::threadpool::NoThreadPoolGuard;
+
+ThreadPoolTaskRunner::ThreadPoolTaskRunner(size_t max_concurrency)
+    : max_concurrency_(max_concurrency) {}
+
+size_t ThreadPoolTaskRunner::max_concurrency() const {
+  if (max_concurrency_ > 0) {
+    return max_concurrency_;
+  }
+  return get_threadpool()->get_thread_count();
+}
+
+void ThreadPoolTaskRunner::run(
+    TaskFunction task,
+    void* context,
+    size_t num_tasks) {
+  // Per protocol from threadpool (pthreadpool), when this returns, all tasks
+  // are executed, so this is synchronous.
+  get_threadpool()->run(
+      [task, context](size_t task_index) {
+        // The pool is busy running this task, so nested parallel_for() calls
+        // from the kernel must not try to use it again.
+        NoThreadPoolGuard guard;
+        task(context, task_index);
+      },
+      num_tasks);
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/executor/task_runner.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A TaskRunner that runs tasks on the shared ExecuTorch threadpool, for use
+ * with Method::enable_parallel_execution().
+ *
+ * Tasks run with the threadpool disabled for the calling thread (see
+ * NoThreadPoolGuard), so kernels that use parallel_for() internally run
+ * single-threaded instead of contending for the pool that is already running
+ * them.
+ */
+class ThreadPoolTaskRunner final : public ::executorch::runtime::TaskRunner {
+ public:
+  /**
+   * @param[in] max_concurrency The maximum number of tasks to run at the same
+   *     time. If zero, uses the number of threads in the threadpool.
+   */
+  explicit ThreadPoolTaskRunner(size_t max_concurrency = 0);
+
+  size_t max_concurrency() const override;
+
+  void run(TaskFunction task, void* context, size_t num_tasks) override;
+
+ private:
+  size_t max_concurrency_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -10,6 +10,7 @@
 #include <cstdio>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -21,6 +22,7 @@
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
 #include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/runtime/kernel/operator_registry.h>
@@ -58,8 +60,9 @@
 
 // Our logs work by writing to stderr. By default this is done through fprintf
 // (as defined in posix.cpp) which then does not show up in python environments.
-// Here we override the pal to use std::cerr which can be properly redirected by
-// scoped_estream_redirect.
+// Here we override the pal to write to python's sys.stderr. Methods execute
+// without the GIL, possibly on several threads at once, so take the GIL here
+// instead of redirecting std::cerr around each call.
 void et_pal_emit_log_message(
     et_timestamp_t timestamp,
     et_pal_log_level_t level,
@@ -68,7 +71,18 @@ void et_pal_emit_log_message(
     size_t line,
     const char* message,
     ET_UNUSED size_t length) {
-  std::cerr << "[" << filename << ":" << line << "] " << message << std::endl;
+  const std::string log = std::string("[") + filename + ":" +
+      std::to_string(line) + "] " + message + "\n";
+  if (Py_IsInitialized()) {
+    pybind11::gil_scoped_acquire gil;
+    try {
+      pybind11::module_::import("sys").attr("stderr").attr("write")(log);
+      return;
+    } catch (const pybind11::error_already_set&) {
+      // Fall back to std::cerr.
+    }
+  }
+  std::cerr << log << std::flush;
 }
 
 namespace py = pybind11;
@@ -77,6 +91,7 @@ using ::executorch::extension::MallocMemoryAllocator;
 using ::executorch::extension::MmapDataLoader;
 using ::executorch::runtime::ArrayRef;
 using ::executorch::runtime::DataLoader;
+using ::executorch::runtime::dim_order_to_stride;
 using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
 using ::executorch::runtime::EventTracerDebugLogLevel;
@@ -154,6 +169,42 @@ void setup_output_storage(
   }
 }
 
+/**
+ * Returns `tensor` if its data is laid out densely in `dim_order`, so that a
+ * method input with that dim order can alias it, and a copy of it laid out
+ * that way otherwise.
+ */
+at::Tensor with_dim_order(
+    const at::Tensor& tensor,
+    Span<const uint8_t> dim_order) {
+  const size_t dim = tensor.dim();
+  if (dim_order.size() != dim) {
+    // Let Method::set_input() report the mismatch.
+    return tensor.contiguous();
+  }
+  int64_t expected_stride = 1;
+  bool dense = true;
+  for (size_t i = dim; dense && i > 0; --i) {
+    const size_t d = dim_order[i - 1];
+    dense = tensor.size(d) == 1 || tensor.stride(d) == expected_stride;
+    expected_stride *= tensor.size(d);
+  }
+  if (dense) {
+    return tensor;
+  }
+  // Allocate the copy in dim order, then view it in the original dim order.
+  std::vector<int64_t> permuted_sizes(dim);
+  std::vector<int64_t> inverse(dim);
+  for (size_t i = 0; i < dim; ++i) {
+    permuted_sizes[i] = tensor.size(dim_order[i]);
+    inverse[dim_order[i]] = i;
+  }
+  at::Tensor copy =
+      at::empty(permuted_sizes, tensor.options()).permute(inverse);
+  copy.copy_(tensor);
+  return copy;
+}
+
 class Module final {
  public:
   explicit Module(
@@ -266,7 +317,13 @@ class Module final {
     if (output_storages) {
       setup_output_storage(*method, *output_storages);
     }
-    Error execute_status = method->execute();
+    Error execute_status;
+    {
+      // The inputs and outputs don't refer to python objects, so other python
+      // threads can run meanwhile.
+      py::gil_scoped_release release;
+      execute_status = method->execute();
+    }
     THROW_IF_ERROR(
         execute_status,
         "method->execute() failed with error 0x%" PRIx32,
@@ -512,102 +569,40 @@ struct PyModule final {
   py::list run_method(
       const std::string& method_name,
       const py::sequence& inputs) {
-    const auto inputs_size = py::len(inputs);
-    std::vector<EValue> cpp_inputs;
-    cpp_inputs.reserve(inputs_size);
-
-#ifndef USE_ATEN_LIB // Portable mode
-    // So the ETensors and their metadata stay in scope for
-    // Module->run_method.
-    std::vector<torch::executor::TensorImpl> input_tensors;
-    std::vector<std::vector<torch::executor::Tensor::SizesType>> input_sizes;
-    std::vector<std::vector<torch::executor::Tensor::StridesType>>
-        input_strides;
-    std::vector<std::vector<torch::executor::Tensor::DimOrderType>>
-        input_dim_order;
-    // We store pointers to these vector elements so important to reserve so
-    // that we don't lose those on a vector resize. Don't need to do this for
-    // the others since they are vectors of vectors, and we don't store a
-    // pointer to the root level vector data.
-    input_tensors.reserve(inputs_size);
-#endif
-
-    // Convert python objects into EValues.
-    for (size_t i = 0; i < inputs_size; ++i) {
-      auto python_input = inputs[i];
-      const std::string& type_str = py::str(python_input.get_type());
-      if (type_str == "<class 'torch.Tensor'>") {
-        auto at_tensor = python_input.cast<at::Tensor>();
-        // alias_etensor_to_attensor will assert on this later, so to better
-        // propogate up to python we check early and throw an exception.
-        if (!at_tensor.is_contiguous()) {
-          auto error_msg = "Input " + std::to_string(i) + "for method " +
-              method_name + " is not contiguous.";
-          throw std::runtime_error(error_msg);
-        }
-
-#ifdef USE_ATEN_LIB
-        EValue evalue(at_tensor);
-#else
-        // convert at::Tensor to torch::executor::Tensor
-        auto type =
-            torch_to_executorch_scalar_type(at_tensor.options().dtype());
-        size_t dim = at_tensor.dim();
-        // cant directly alias at::Tensor sizes and strides due to int64 vs
-        // int32 typing conflict
-        input_sizes.emplace_back(
-            at_tensor.sizes().begin(), at_tensor.sizes().end());
-        input_strides.emplace_back(
-            at_tensor.strides().begin(), at_tensor.strides().end());
-
-        // Only works for MemoryFormat::Contiguous inputs
-        std::vector<torch::executor::Tensor::DimOrderType> dim_order;
-        for (size_t cur_dim = 0; cur_dim < dim; cur_dim++) {
-          dim_order.push_back(cur_dim);
-        }
-        input_dim_order.push_back(std::move(dim_order));
-        input_tensors.emplace_back(
-            type,
-            dim,
-            input_sizes.back().data(),
-            nullptr,
-            input_dim_order.back().data(),
-            input_strides.back().data());
-
-        torch::executor::Tensor temp =
-            torch::executor::Tensor(&input_tensors.back());
-        alias_etensor_to_attensor(at_tensor, temp);
-        EValue evalue(temp);
-#endif
-
-        cpp_inputs.push_back(evalue);
-      } else if (py::isinstance<py::none>(python_input)) {
-        cpp_inputs.push_back(EValue());
-      } else if (py::isinstance<py::bool_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<bool>(python_input)));
-      } else if (py::isinstance<py::int_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<int64_t>(python_input)));
-      } else {
-        // Unsupported pytype
-        ET_ASSERT_UNREACHABLE_MSG(type_str.c_str());
-      }
-    }
-
-    const auto& method = module_->get_method(method_name);
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
-    auto outputs =
-        module_->run_method(method_name, cpp_inputs, output_storage_spans);
+    auto lock = lock_module();
+    set_inputs_from_python(method_name, inputs);
+    auto outputs = module_->run_method(
+        method_name, input_evalues_, get_output_storage_spans(method_name));
+    // Don't keep the inputs alive past the call.
+    input_tensors_.clear();
 
     // Retrieve outputs
     return get_outputs_as_py_list(outputs);
   }
 
+  /// Runs the method once per input set in `batch` and returns a list of
+  /// their output lists. Equivalent to calling run_method() in a loop, but
+  /// the module is locked once and the output storages are only looked up
+  /// once, which matters for small models where the per-call overhead
+  /// dominates.
+  py::list run_method_batch(
+      const std::string& method_name,
+      const py::sequence& batch) {
+    auto lock = lock_module();
+    const std::optional<std::vector<Span<uint8_t>>> output_storage_spans =
+        get_output_storage_spans(method_name);
+    const auto batch_size = py::len(batch);
+    py::list results(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+      set_inputs_from_python(method_name, batch[i].cast<py::sequence>());
+      auto outputs = module_->run_method(
+          method_name, input_evalues_, output_storage_spans);
+      results[i] = get_outputs_as_py_list(outputs);
+    }
+    input_tensors_.clear();
+    return results;
+  }
+
   py::list forward(const py::sequence& inputs) {
     return run_method("forward", inputs);
   }
@@ -625,6 +620,7 @@ struct PyModule final {
   void write_etdump_result_to_file(
       const std::string& path,
       const py::object& debug_buffer_path) {
+    auto lock = lock_module();
     if (!has_etdump()) {
       throw std::runtime_error("No etdump found");
     }
@@ -655,6 +651,7 @@ struct PyModule final {
       PyBundledModule& m,
       const std::string method_name,
       size_t testset_idx) {
+    auto lock = lock_module();
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
     Error status = LoadBundledInput(
         module_->get_method(method_name), bundled_program_ptr, testset_idx);
@@ -670,6 +667,7 @@ struct PyModule final {
       size_t testset_idx,
       double rtol = 1e-5,
       double atol = 1e-8) {
+    auto lock = lock_module();
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
     auto& method = module_->get_method(method_name);
     Error status = LoadBundledInput(method, bundled_program_ptr, testset_idx);
@@ -677,7 +675,7 @@ struct PyModule final {
         status,
         "LoadBundledInput failed with status %" PRIu32,
         static_cast<uint32_t>(status));
-    py::list outputs = plan_execute(method_name);
+    py::list outputs = execute_loaded_inputs(method_name);
     status = VerifyResultWithBundledExpectedOutput(
         method, bundled_program_ptr, testset_idx, rtol, atol);
     THROW_IF_ERROR(
@@ -688,23 +686,8 @@ struct PyModule final {
   }
 
   py::list plan_execute(const std::string method_name) {
-    auto& method = module_->get_method(method_name);
-    // Need to pre-allocate space for outputs just like in run_method.
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
-    setup_output_storage(method, output_storage_spans);
-    auto status = method.execute();
-    THROW_IF_ERROR(
-        status,
-        "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
-        static_cast<uint32_t>(status));
-    const auto outputs = module_->get_outputs(method_name);
-    return get_outputs_as_py_list(outputs);
+    auto lock = lock_module();
+    return execute_loaded_inputs(method_name);
   }
 
   py::list get_outputs_as_py_list(const std::vector<EValue>& outputs) {
@@ -740,8 +723,161 @@ struct PyModule final {
  private:
   std::unique_ptr<Module> module_;
   // Need to keep-alive output storages until they can be compared in case of
-  // bundled programs.
+  // bundled programs. Reused while the same method runs again.
   std::vector<std::vector<uint8_t>> output_storages_;
+  std::string output_storages_method_;
+
+  // Reused across run_method() calls so that each call does not allocate
+  // metadata for its inputs again.
+  std::vector<EValue> input_evalues_;
+  // The input index and the tensor, in the dim order the method expects, of
+  // each tensor input.
+  std::vector<std::pair<size_t, at::Tensor>> input_tensors_;
+#ifndef USE_ATEN_LIB
+  std::vector<torch::executor::TensorImpl> input_tensor_impls_;
+  std::vector<torch::executor::Tensor::SizesType> input_sizes_;
+  std::vector<torch::executor::Tensor::StridesType> input_strides_;
+  std::vector<torch::executor::Tensor::DimOrderType> input_dim_order_;
+#endif
+
+  // Serializes the calls that use module_, whose methods share one memory
+  // manager. Behind a pointer to keep PyModule movable.
+  std::unique_ptr<std::mutex> mutex_ = std::make_unique<std::mutex>();
+
+  /// Locks mutex_, waiting without the GIL since its holder may need the GIL
+  /// to finish.
+  std::unique_lock<std::mutex> lock_module() {
+    py::gil_scoped_release release;
+    return std::unique_lock<std::mutex>(*mutex_);
+  }
+
+  /// Converts `inputs` into input_evalues_, aliasing the tensors among them.
+  /// Needs mutex_.
+  void set_inputs_from_python(
+      const std::string& method_name,
+      const py::sequence& inputs) {
+    const auto inputs_size = py::len(inputs);
+    auto& method = module_->get_method(method_name);
+    const auto method_meta = method.method_meta();
+    input_evalues_.clear();
+    input_tensors_.clear();
+
+    // Convert python objects into EValues. Tensors are converted below, once
+    // the number of dims to allocate metadata for is known.
+    size_t num_input_dims = 0;
+    for (size_t i = 0; i < inputs_size; ++i) {
+      auto python_input = inputs[i];
+      const std::string& type_str = py::str(python_input.get_type());
+      if (type_str == "<class 'torch.Tensor'>") {
+        auto at_tensor = python_input.cast<at::Tensor>();
+        // Alias inputs in the dim order the method expects, which also covers
+        // channels-last and other permuted layouts, and only copy the others.
+        auto tensor_meta = method_meta.input_tensor_meta(i);
+        at_tensor = tensor_meta.ok()
+            ? with_dim_order(at_tensor, tensor_meta->dim_order())
+            : at_tensor.contiguous();
+        num_input_dims += at_tensor.dim();
+        input_tensors_.emplace_back(i, std::move(at_tensor));
+        input_evalues_.emplace_back();
+      } else if (py::isinstance<py::none>(python_input)) {
+        input_evalues_.push_back(EValue());
+      } else if (py::isinstance<py::bool_>(python_input)) {
+        input_evalues_.push_back(EValue(py::cast<bool>(python_input)));
+      } else if (py::isinstance<py::int_>(python_input)) {
+        input_evalues_.push_back(EValue(py::cast<int64_t>(python_input)));
+      } else {
+        // Unsupported pytype
+        ET_ASSERT_UNREACHABLE_MSG(type_str.c_str());
+      }
+    }
+
+#ifdef USE_ATEN_LIB
+    for (const auto& input : input_tensors_) {
+      input_evalues_[input.first] = EValue(input.second);
+    }
+#else // Portable mode
+    // The ETensors alias the inputs, and their metadata lives in buffers that
+    // are only resized, so steady-state calls do not allocate. The TensorImpls
+    // are pointed to, so reserve before creating them.
+    input_sizes_.resize(num_input_dims);
+    input_strides_.resize(num_input_dims);
+    input_dim_order_.resize(num_input_dims);
+    input_tensor_impls_.clear();
+    input_tensor_impls_.reserve(input_tensors_.size());
+    size_t offset = 0;
+    for (auto& input : input_tensors_) {
+      at::Tensor& at_tensor = input.second;
+      const size_t dim = at_tensor.dim();
+      auto* sizes = input_sizes_.data() + offset;
+      auto* strides = input_strides_.data() + offset;
+      auto* dim_order = input_dim_order_.data() + offset;
+      offset += dim;
+      // cant directly alias at::Tensor sizes and strides due to int64 vs
+      // int32 typing conflict
+      for (size_t d = 0; d < dim; ++d) {
+        sizes[d] = at_tensor.size(d);
+        dim_order[d] = d;
+      }
+      auto tensor_meta = method_meta.input_tensor_meta(input.first);
+      if (tensor_meta.ok() && tensor_meta->dim_order().size() == dim) {
+        std::copy(
+            tensor_meta->dim_order().begin(),
+            tensor_meta->dim_order().end(),
+            dim_order);
+      }
+      Error status = dim_order_to_stride(sizes, dim_order, dim, strides);
+      THROW_IF_ERROR(
+          status,
+          "Input %zu for method %s has an invalid dim order",
+          input.first,
+          method_name.c_str());
+      input_tensor_impls_.emplace_back(
+          torch_to_executorch_scalar_type(at_tensor.options().dtype()),
+          dim,
+          sizes,
+          nullptr,
+          dim_order,
+          strides);
+      torch::executor::Tensor temp =
+          torch::executor::Tensor(&input_tensor_impls_.back());
+      alias_etensor_to_attensor(at_tensor, temp);
+      input_evalues_[input.first] = EValue(temp);
+    }
+#endif
+  }
+
+  /// Executes the method on the inputs it already has. Needs mutex_.
+  py::list execute_loaded_inputs(const std::string& method_name) {
+    auto& method = module_->get_method(method_name);
+    // Need to pre-allocate space for outputs just like in run_method.
+    setup_output_storage(method, get_output_storage_spans(method_name));
+    Error status;
+    {
+      py::gil_scoped_release release;
+      status = method.execute();
+    }
+    THROW_IF_ERROR(
+        status,
+        "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
+        static_cast<uint32_t>(status));
+    const auto outputs = module_->get_outputs(method_name);
+    return get_outputs_as_py_list(outputs);
+  }
+
+  std::vector<Span<uint8_t>> get_output_storage_spans(
+      const std::string& method_name) {
+    if (output_storages_method_ != method_name) {
+      output_storages_ =
+          make_output_storages(module_->get_method(method_name));
+      output_storages_method_ = method_name;
+    }
+    std::vector<Span<uint8_t>> output_storage_spans(output_storages_.size());
+    for (size_t i = 0; i < output_storages_.size(); ++i) {
+      output_storage_spans[i] =
+          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
+    }
+    return output_storage_spans;
+  }
 
   std::vector<std::vector<uint8_t>> make_output_storages(const Method& method) {
     const auto num_outputs = method.outputs_size();
@@ -835,8 +971,11 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
       []() { EXECUTORCH_RESET_PROFILE_RESULTS(); },
       call_guard);
 
+  // PyModule calls release the GIL while they wait for the module and while
+  // methods execute, so they can't redirect the process-wide std::cout and
+  // std::cerr like call_guard does. Logs go to sys.stderr regardless.
   py::class_<PyModule>(m, "ExecuTorchModule")
-      .def("load_bundled_input", &PyModule::load_bundled_input, call_guard)
+      .def("load_bundled_input", &PyModule::load_bundled_input)
       .def(
           "verify_result_with_bundled_expected_output",
           &PyModule::verify_result_with_bundled_expected_output,
@@ -844,25 +983,27 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           py::arg("method_name"),
           py::arg("testset_idx"),
           py::arg("rtol") = 1e-5,
-          py::arg("atol") = 1e-8,
-          call_guard)
-      .def("plan_execute", &PyModule::plan_execute, call_guard)
+          py::arg("atol") = 1e-8)
+      .def("plan_execute", &PyModule::plan_execute)
       .def(
           "run_method",
           &PyModule::run_method,
           py::arg("method_name"),
-          py::arg("inputs") = py::list(),
-          call_guard)
-      .def("forward", &PyModule::forward, call_guard)
+          py::arg("inputs") = py::list())
+      .def(
+          "run_method_batch",
+          &PyModule::run_method_batch,
+          py::arg("method_name"),
+          py::arg("batch"))
+      .def("forward", &PyModule::forward)
       .def("has_etdump", &PyModule::has_etdump, call_guard)
       .def(
           "write_etdump_result_to_file",
           &PyModule::write_etdump_result_to_file,
           py::arg("path"),
-          py::arg("debug_buffer_path") = py::none(),
-          call_guard)
-      .def("__call__", &PyModule::forward, call_guard)
-      .def("__call__", &PyModule::forward_single_input, call_guard);
+          py::arg("debug_buffer_path") = py::none())
+      .def("__call__", &PyModule::forward)
+      .def("__call__", &PyModule::forward_single_input);
 
   py::class_<PyBundledModule>(m, "BundledModule");
 }
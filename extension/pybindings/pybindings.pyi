@@ -13,6 +13,10 @@ class ExecuTorchModule:
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
     def run_method(self, method_name: str, inputs: Sequence[Any]) -> List[Any]: ...
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
+    def run_method_batch(
+        self, method_name: str, batch: Sequence[Sequence[Any]]
+    ) -> List[List[Any]]: ...
+    # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
     def forward(self, inputs: Sequence[Any]) -> List[Any]: ...
     # pyre-ignore[3]: "Any" in return type annotations.
     def plan_execute(self) -> List[Any]: ...
@@ -174,6 +174,44 @@ def make_test(  # noqa: C901
             expected = inputs[0] + inputs[0]
             tester.assertEqual(str(expected), str(executorch_output))
 
+        def test_non_contiguous_inputs(tester):
+            exported_program, _ = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+
+            # Inputs in other layouts are laid out the way the method expects,
+            # and calls in a row reuse the input metadata.
+            x = torch.arange(4.0).reshape(2, 2)
+            for y in (x.t(), torch.arange(8.0).reshape(2, 4)[:, ::2], x):
+                executorch_output = executorch_module.forward((x, y))[0]
+                tester.assertTrue(torch.allclose(executorch_output, x + y))
+
+        def test_run_method_batch(tester):
+            program, _ = create_program(ModuleMulti())
+            executorch_module = load_fn(program.buffer)
+
+            batch = [(torch.full((2, 2), float(i)), torch.ones(2, 2)) for i in range(4)]
+            executorch_outputs = executorch_module.run_method_batch("forward2", batch)
+            tester.assertEqual(len(executorch_outputs), len(batch))
+            for (x, y), executorch_output in zip(batch, executorch_outputs):
+                tester.assertTrue(torch.allclose(executorch_output[0], x + y + 1))
+
+        def test_concurrent_execution(tester):
+            from concurrent.futures import ThreadPoolExecutor
+
+            program, inputs = create_program(ModuleMulti())
+            # Calls on different modules run in parallel, and calls on the same
+            # module take turns.
+            executorch_modules = [load_fn(program.buffer) for _ in range(2)]
+
+            def run(i):
+                x = torch.full((2, 2), float(i))
+                executorch_module = executorch_modules[i % 2]
+                return x, executorch_module.run_method("forward2", (x, x))[0]
+
+            with ThreadPoolExecutor(max_workers=4) as executor:
+                for x, executorch_output in executor.map(run, range(32)):
+                    tester.assertTrue(torch.allclose(executorch_output, x + x + 1))
+
         def test_stderr_redirect(tester):
             import sys
             from io import StringIO
@@ -216,6 +254,9 @@ def make_test(  # noqa: C901
         test_output_lifespan(tester)
         test_module_callable(tester)
         test_module_single_input(tester)
+        test_non_contiguous_inputs(tester)
+        test_run_method_batch(tester)
+        test_concurrent_execution(tester)
         test_stderr_redirect(tester)
 
     return wrapper
@@ -8,6 +8,8 @@
 
 #include <executorch/extension/runner_util/inputs.h>
 
+#include <cstddef>
+
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/method_meta.h>
 #include <executorch/runtime/platform/log.h>
@@ -16,12 +18,18 @@ using executorch::runtime::Error;
 using executorch::runtime::Method;
 using executorch::runtime::MethodMeta;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 using executorch::runtime::Tag;
 using executorch::runtime::TensorInfo;
 
 namespace executorch {
 namespace extension {
 
+namespace {
+// Keeps every pooled buffer at least as aligned as a malloc() result.
+constexpr size_t kInputBufferAlignment = alignof(std::max_align_t);
+} // namespace
+
 Result<BufferCleanup> prepare_input_tensors(Method& method) {
   MethodMeta method_meta = method.method_meta();
   size_t num_inputs = method_meta.num_inputs();
@@ -59,5 +67,78 @@ Result<BufferCleanup> prepare_input_tensors(Method& method) {
   return BufferCleanup({inputs, num_allocated});
 }
 
+Result<InputBufferPool> InputBufferPool::create(Method& method) {
+  MethodMeta method_meta = method.method_meta();
+  const size_t num_inputs = method_meta.num_inputs();
+  std::vector<Input> inputs;
+  inputs.reserve(num_inputs);
+  size_t total_nbytes = 0;
+
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto tag = method_meta.input_tag(i);
+    if (!tag.ok()) {
+      return tag.error();
+    }
+    if (tag.get() != Tag::Tensor) {
+      ET_LOG(Debug, "Skipping non-tensor input %zu", i);
+      continue;
+    }
+    Result<TensorInfo> tensor_meta = method_meta.input_tensor_meta(i);
+    if (!tensor_meta.ok()) {
+      return tensor_meta.error();
+    }
+    const size_t nbytes = tensor_meta->nbytes();
+    inputs.push_back({i, total_nbytes, nbytes});
+    total_nbytes += (nbytes + kInputBufferAlignment - 1) /
+        kInputBufferAlignment * kInputBufferAlignment;
+  }
+
+  std::unique_ptr<uint8_t[]> data(new uint8_t[total_nbytes]);
+  for (const Input& input : inputs) {
+    TensorInfo tensor_meta = method_meta.input_tensor_meta(input.index).get();
+    Error err = internal::fill_and_set_input(
+        method, tensor_meta, input.index, data.get() + input.offset);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to prepare input %zu: 0x%" PRIx32,
+          input.index,
+          (uint32_t)err);
+      return err;
+    }
+  }
+  return InputBufferPool(method, std::move(data), std::move(inputs));
+}
+
+Error InputBufferPool::bind() {
+  MethodMeta method_meta = method_->method_meta();
+  for (const Input& input : inputs_) {
+    Result<TensorInfo> tensor_meta = method_meta.input_tensor_meta(input.index);
+    if (!tensor_meta.ok()) {
+      return tensor_meta.error();
+    }
+    Error err = internal::set_input(
+        *method_, tensor_meta.get(), input.index, data_.get() + input.offset);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to bind input %zu: 0x%" PRIx32,
+          input.index,
+          (uint32_t)err);
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+Span<uint8_t> InputBufferPool::buffer(size_t input_index) const {
+  for (const Input& input : inputs_) {
+    if (input.index == input_index) {
+      return {data_.get() + input.offset, input.nbytes};
+    }
+  }
+  return {};
+}
+
 } // namespace extension
 } // namespace executorch
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/method_meta.h>
@@ -64,6 +68,78 @@ class BufferCleanup final {
 executorch::runtime::Result<BufferCleanup> prepare_input_tensors(
     executorch::runtime::Method& method);
 
+/**
+ * Owns one buffer per Tensor input of a Method, sized from its MethodMeta and
+ * filled with ones when created, and sets the inputs of the Method to them.
+ * Unlike prepare_input_tensors(), which allocates new buffers on every call,
+ * the buffers are allocated once, so a loop that executes the Method many
+ * times does not measure the allocator:
+ *
+ * @code
+ *   auto pool = InputBufferPool::create(method);
+ *   for (int i = 0; i < num_iterations; ++i) {
+ *     // Optionally write new data to pool->buffer(input_index).
+ *     ET_CHECK_OK_OR_RETURN_ERROR(pool->bind());
+ *     ET_CHECK_OK_OR_RETURN_ERROR(method.execute());
+ *   }
+ * @endcode
+ *
+ * The Method must outlive the pool. Movable.
+ */
+class InputBufferPool final {
+ public:
+  /**
+   * Allocates the buffers of the Tensor inputs of `method`, fills them with
+   * ones and sets the inputs to them. Does not modify inputs that are not
+   * Tensors.
+   *
+   * @param[in] method The Method that owns the inputs to prepare.
+   *
+   * @returns The pool on success, or an error on failure.
+   */
+  static executorch::runtime::Result<InputBufferPool> create(
+      executorch::runtime::Method& method);
+
+  InputBufferPool(InputBufferPool&&) = default;
+  ~InputBufferPool() = default;
+
+  /**
+   * Sets the Tensor inputs of the Method to the pooled buffers again, e.g.
+   * after their contents changed or another caller set other inputs. Does not
+   * allocate. Call before each `method.execute()`.
+   */
+  executorch::runtime::Error bind();
+
+  /**
+   * Returns the buffer of the input at `input_index`, or an empty Span if that
+   * input is not a Tensor.
+   */
+  executorch::runtime::Span<uint8_t> buffer(size_t input_index) const;
+
+ private:
+  struct Input {
+    size_t index;
+    size_t offset;
+    size_t nbytes;
+  };
+
+  InputBufferPool(
+      executorch::runtime::Method& method,
+      std::unique_ptr<uint8_t[]> data,
+      std::vector<Input> inputs)
+      : method_(&method), data_(std::move(data)), inputs_(std::move(inputs)) {}
+
+  // Delete other rule-of-five methods.
+  InputBufferPool(const InputBufferPool&) = delete;
+  InputBufferPool& operator=(const InputBufferPool&) = delete;
+  InputBufferPool& operator=(InputBufferPool&&) = delete;
+
+  executorch::runtime::Method* method_;
+  // A single allocation that holds the buffers of all Tensor inputs.
+  std::unique_ptr<uint8_t[]> data_;
+  std::vector<Input> inputs_;
+};
+
 namespace internal {
 /**
  * INTERNAL-ONLY: Creates a Tensor using the provided shape and buffer,
@@ -74,6 +150,16 @@ executorch::runtime::Error fill_and_set_input(
     executorch::runtime::TensorInfo& tensor_meta,
     size_t input_index,
     void* data_ptr);
+
+/**
+ * INTERNAL-ONLY: Creates a Tensor using the provided shape and buffer, and
+ * sets the input at `input_index` without touching the buffer.
+ */
+executorch::runtime::Error set_input(
+    executorch::runtime::Method& method,
+    executorch::runtime::TensorInfo& tensor_meta,
+    size_t input_index,
+    void* data_ptr);
 } // namespace internal
 
 } // namespace extension
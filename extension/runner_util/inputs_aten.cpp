@@ -22,6 +22,21 @@ namespace executorch {
 namespace extension {
 namespace internal {
 
+Error set_input(
+    Method& method,
+    TensorInfo& tensor_meta,
+    size_t input_index,
+    void* data_ptr) {
+  // Convert the sizes array from int32_t to int64_t.
+  std::vector<int64_t> sizes;
+  for (auto s : tensor_meta.sizes()) {
+    sizes.push_back(s);
+  }
+  at::Tensor t = at::from_blob(
+      data_ptr, sizes, at::TensorOptions(tensor_meta.scalar_type()));
+  return method.set_input(t, input_index);
+}
+
 Error fill_and_set_input(
     Method& method,
     TensorInfo& tensor_meta,
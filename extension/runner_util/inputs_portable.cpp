@@ -52,7 +52,7 @@ Error fill_ones(torch::executor::Tensor tensor) {
 }
 } // namespace
 
-Error fill_and_set_input(
+Error set_input(
     Method& method,
     TensorInfo& tensor_meta,
     size_t input_index,
@@ -67,9 +67,22 @@ Error fill_and_set_input(
       const_cast<TensorImpl::SizesType*>(tensor_meta.sizes().data()),
       data_ptr,
       const_cast<TensorImpl::DimOrderType*>(tensor_meta.dim_order().data()));
-  Tensor t(&impl);
-  ET_CHECK_OK_OR_RETURN_ERROR(fill_ones(t));
-  return method.set_input(t, input_index);
+  return method.set_input(Tensor(&impl), input_index);
+}
+
+Error fill_and_set_input(
+    Method& method,
+    TensorInfo& tensor_meta,
+    size_t input_index,
+    void* data_ptr) {
+  TensorImpl impl = TensorImpl(
+      tensor_meta.scalar_type(),
+      /*dim=*/tensor_meta.sizes().size(),
+      const_cast<TensorImpl::SizesType*>(tensor_meta.sizes().data()),
+      data_ptr,
+      const_cast<TensorImpl::DimOrderType*>(tensor_meta.dim_order().data()));
+  ET_CHECK_OK_OR_RETURN_ERROR(fill_ones(Tensor(&impl)));
+  return set_input(method, tensor_meta, input_index, data_ptr);
 }
 
 } // namespace internal
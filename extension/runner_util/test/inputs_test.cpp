@@ -8,6 +8,8 @@
 
 #include <executorch/extension/runner_util/inputs.h>
 
+#include <algorithm>
+
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/span.h>
@@ -22,6 +24,7 @@ using exec_aten::ScalarType;
 using exec_aten::Tensor;
 using executorch::extension::BufferCleanup;
 using executorch::extension::FileDataLoader;
+using executorch::extension::InputBufferPool;
 using executorch::extension::prepare_input_tensors;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
@@ -100,6 +103,43 @@ TEST_F(InputsTest, Smoke) {
   // the pointers.
 }
 
+TEST_F(InputsTest, InputBufferPoolIsReused) {
+  Result<InputBufferPool> pool = InputBufferPool::create(*method_);
+  ASSERT_EQ(pool.error(), Error::Ok);
+
+  // ModuleAdd has two Tensor inputs.
+  Span<uint8_t> a = pool->buffer(0);
+  Span<uint8_t> b = pool->buffer(1);
+  ASSERT_GT(a.size(), 0);
+  ASSERT_GT(b.size(), 0);
+  EXPECT_TRUE(pool->buffer(2).empty());
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(pool->bind(), Error::Ok);
+    ASSERT_EQ(method_->execute(), Error::Ok);
+
+    // The buffers were filled with ones, so the outputs are all 2.
+    Tensor output = method_->get_output(0).toTensor();
+    Span<float> elements(output.mutable_data_ptr<float>(), output.numel());
+    EXPECT_GT(elements.size(), 0);
+    for (float e : elements) {
+      EXPECT_EQ(e, 2.0);
+    }
+
+    // Binding again does not move the buffers.
+    EXPECT_EQ(pool->buffer(0).data(), a.data());
+    EXPECT_EQ(pool->buffer(1).data(), b.data());
+  }
+
+  // New data written to the buffers is seen by the next execution.
+  float* a_data = reinterpret_cast<float*>(a.data());
+  std::fill(a_data, a_data + a.size() / sizeof(float), 2.0f);
+  ASSERT_EQ(pool->bind(), Error::Ok);
+  ASSERT_EQ(method_->execute(), Error::Ok);
+  Tensor output = method_->get_output(0).toTensor();
+  EXPECT_EQ(output.const_data_ptr<float>()[0], 3.0);
+}
+
 TEST(BufferCleanupTest, Smoke) {
   // Returns the size of the buffer at index `i`.
   auto test_buffer_size = [](size_t i) {
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adamw.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using exec_aten::TensorImpl;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+bool AdamWParamGroup::has_options() const {
+  return options_ != nullptr;
+}
+
+AdamWOptions& AdamWParamGroup::options() {
+  return *options_.get();
+}
+
+const AdamWOptions& AdamWParamGroup::options() const {
+  return *options_.get();
+}
+
+void AdamWParamGroup::set_options(std::unique_ptr<AdamWOptions> options) {
+  options_ = std::move(options);
+}
+
+Span<const char*> AdamWParamGroup::param_names() {
+  return param_names_;
+}
+
+const Span<const char*> AdamWParamGroup::param_names() const {
+  return param_names_;
+}
+
+Span<Tensor> AdamWParamGroup::param_data() {
+  return param_data_;
+}
+
+const Span<Tensor> AdamWParamGroup::param_data() const {
+  return param_data_;
+}
+
+void AdamW::add_param_group(const AdamWParamGroup& param_group) {
+  AdamWParamGroup param_group_(
+      param_group.param_names(), param_group.param_data());
+  if (!param_group.has_options()) {
+    param_group_.set_options(defaults_->clone());
+  } else {
+    param_group_.set_options(param_group.options().clone());
+  }
+  param_groups_.emplace_back(std::move(param_group_));
+
+  const size_t group_index = param_groups_.size() - 1;
+  const auto names = param_groups_.back().param_names();
+  for (size_t i = 0; i < names.size(); ++i) {
+    param_locations_.emplace(names[i], ParamLocation{group_index, i, 0});
+  }
+}
+
+namespace {
+
+// The raw bits of a bfloat16 value. Used instead of exec_aten::BFloat16,
+// which has no arithmetic outside of ATen mode.
+struct BFloat16Bits {
+  uint16_t x;
+};
+
+float load_state(const float* state, int64_t i) {
+  return state[i];
+}
+
+double load_state(const double* state, int64_t i) {
+  return state[i];
+}
+
+float load_state(const exec_aten::Half* state, int64_t i) {
+  return static_cast<float>(state[i]);
+}
+
+float load_state(const BFloat16Bits* state, int64_t i) {
+  const uint32_t bits = static_cast<uint32_t>(state[i].x) << 16;
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void store_state(float* state, int64_t i, float value) {
+  state[i] = value;
+}
+
+void store_state(double* state, int64_t i, double value) {
+  state[i] = value;
+}
+
+void store_state(exec_aten::Half* state, int64_t i, float value) {
+  state[i] = exec_aten::Half(value);
+}
+
+void store_state(BFloat16Bits* state, int64_t i, float value) {
+  if (std::isnan(value)) {
+    state[i].x = 0x7fc0;
+    return;
+  }
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  // Round to nearest, ties to even.
+  bits += 0x7fff + ((bits >> 16) & 1);
+  state[i].x = static_cast<uint16_t>(bits >> 16);
+}
+
+/**
+ * Applies one AdamW step to `numel` elements in a single pass: the decoupled
+ * weight decay, the update of both moments with bias correction, and the
+ * update of the parameter. `step` is the 1-based index of this step for the
+ * parameter. The moments are computed in CTYPE and stored as STATE.
+ */
+template <typename CTYPE, typename STATE>
+void fused_adamw_update(
+    CTYPE* param,
+    const CTYPE* grad,
+    STATE* exp_avg,
+    STATE* exp_avg_sq,
+    int64_t step,
+    int64_t numel,
+    const AdamWOptions& options) {
+  const double bias_correction1 = 1 - std::pow(options.beta1(), step);
+  const double bias_correction2 = 1 - std::pow(options.beta2(), step);
+  const CTYPE decay =
+      static_cast<CTYPE>(1 - options.lr() * options.weight_decay());
+  const CTYPE beta1 = static_cast<CTYPE>(options.beta1());
+  const CTYPE beta2 = static_cast<CTYPE>(options.beta2());
+  const CTYPE step_size = static_cast<CTYPE>(options.lr() / bias_correction1);
+  const CTYPE bias_correction2_sqrt =
+      static_cast<CTYPE>(std::sqrt(bias_correction2));
+  const CTYPE eps = static_cast<CTYPE>(options.eps());
+  torch::executor::elementwise_parallel_for(
+      numel, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE g = grad[i];
+          const CTYPE m =
+              beta1 * load_state(exp_avg, i) + (1 - beta1) * g;
+          const CTYPE v =
+              beta2 * load_state(exp_avg_sq, i) + (1 - beta2) * g * g;
+          store_state(exp_avg, i, m);
+          store_state(exp_avg_sq, i, v);
+          const CTYPE denom = std::sqrt(v) / bias_correction2_sqrt + eps;
+          param[i] = param[i] * decay - step_size * m / denom;
+        }
+      });
+}
+
+template <typename STATE>
+void fused_adamw_update_float(
+    Tensor& p,
+    const Tensor& grad,
+    AdamWParamState& state,
+    const AdamWOptions& options) {
+  fused_adamw_update<float, STATE>(
+      p.mutable_data_ptr<float>(),
+      grad.const_data_ptr<float>(),
+      static_cast<STATE*>(state.exp_avg().mutable_data_ptr()),
+      static_cast<STATE*>(state.exp_avg_sq().mutable_data_ptr()),
+      state.step(),
+      p.numel(),
+      options);
+}
+
+} // namespace
+
+Tensor AdamW::create_moment(const Tensor& like, ScalarType dtype) {
+  // This memory needs to be freed when the optimizer is destroyed. The
+  // moments start at zero.
+  void* buf_ptr = calloc(like.numel(), executorch::runtime::elementSize(dtype));
+#ifdef USE_ATEN_LIB
+  std::vector<int64_t> sizes(like.sizes().begin(), like.sizes().end());
+  return torch::from_blob(buf_ptr, sizes, dtype);
+#else
+  TensorImpl* buf_impl = new TensorImpl(
+      dtype,
+      like.sizes().size(),
+      const_cast<TensorImpl::SizesType*>(like.sizes().data()),
+      buf_ptr,
+      const_cast<TensorImpl::DimOrderType*>(like.dim_order().data()));
+  return Tensor(buf_impl);
+#endif
+}
+
+Error AdamW::update_param(
+    const AdamWOptions& options,
+    Tensor p,
+    const Tensor& grad) {
+  const ScalarType dtype = p.scalar_type();
+  ET_CHECK_OR_RETURN_ERROR(
+      dtype == ScalarType::Float || dtype == ScalarType::Double,
+      InvalidArgument,
+      "AdamW only supports float and double parameters, got %hhd",
+      static_cast<int8_t>(dtype));
+  ET_CHECK_OR_RETURN_ERROR(
+      grad.scalar_type() == dtype && p.sizes() == grad.sizes() &&
+          p.strides() == grad.strides(),
+      InvalidArgument,
+      "Gradient must have the dtype, shape and layout of its parameter");
+#ifdef USE_ATEN_LIB
+  // ATen tensors may be views with gaps between their elements.
+  ET_CHECK_OR_RETURN_ERROR(
+      p.is_contiguous() && grad.is_contiguous(),
+      InvalidArgument,
+      "AdamW only supports contiguous parameters and gradients");
+#endif
+
+  auto param_state = state_.find(p.unsafeGetTensorImpl());
+  if (param_state == state_.end()) {
+    ScalarType state_dtype = dtype;
+    if (dtype == ScalarType::Float) {
+      state_dtype = options.state_dtype();
+      ET_CHECK_OR_RETURN_ERROR(
+          state_dtype == ScalarType::Float || state_dtype == ScalarType::Half ||
+              state_dtype == ScalarType::BFloat16,
+          InvalidArgument,
+          "AdamW state must be float, half or bfloat16, got %hhd",
+          static_cast<int8_t>(state_dtype));
+    }
+    Tensor exp_avg = create_moment(p, state_dtype);
+    Tensor exp_avg_sq = create_moment(p, state_dtype);
+    // save the moments to be reused in later epochs
+    param_state =
+        state_
+            .emplace(
+                p.unsafeGetTensorImpl(),
+                std::make_unique<AdamWParamState>(exp_avg, exp_avg_sq))
+            .first;
+  }
+  AdamWParamState& state = *param_state->second;
+  state.increment_step();
+
+  if (dtype == ScalarType::Double) {
+    fused_adamw_update<double, double>(
+        p.mutable_data_ptr<double>(),
+        grad.const_data_ptr<double>(),
+        state.exp_avg().mutable_data_ptr<double>(),
+        state.exp_avg_sq().mutable_data_ptr<double>(),
+        state.step(),
+        p.numel(),
+        options);
+    return Error::Ok;
+  }
+  switch (state.exp_avg().scalar_type()) {
+    case ScalarType::Half:
+      fused_adamw_update_float<exec_aten::Half>(p, grad, state, options);
+      break;
+    case ScalarType::BFloat16:
+      fused_adamw_update_float<BFloat16Bits>(p, grad, state, options);
+      break;
+    default:
+      fused_adamw_update_float<float>(p, grad, state, options);
+      break;
+  }
+  return Error::Ok;
+}
+
+Error AdamW::step(
+    Span<const char*> gradient_names,
+    Span<Tensor> gradient_data) {
+  // check that the number of gradient names matches the number of gradients
+  ET_CHECK_OR_RETURN_ERROR(
+      gradient_names.size() == gradient_data.size(),
+      InvalidState,
+      "Gradient names and gradients must have the same length.");
+
+  // Parameters remember the last step that updated them, so that a name
+  // that appears several times in gradient_names only uses its first
+  // gradient.
+  ++step_count_;
+  for (size_t j = 0; j < gradient_names.size(); j++) {
+    auto range = param_locations_.equal_range(gradient_names[j]);
+    for (auto it = range.first; it != range.second; ++it) {
+      ParamLocation& location = it->second;
+      if (location.last_step == step_count_) {
+        continue;
+      }
+      location.last_step = step_count_;
+      auto& group = param_groups_[location.group_index];
+      Error err = update_param(
+          group.options(),
+          group.param_data()[location.param_index],
+          gradient_data[j]);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+AdamW::~AdamW() {
+  for (const auto& state_kv : state_) {
+    AdamWParamState& state = *state_kv.second;
+    for (Tensor* moment : {&state.exp_avg(), &state.exp_avg_sq()}) {
+      free(moment->unsafeGetTensorImpl()->mutable_data());
+#ifndef USE_ATEN_LIB
+      delete moment->unsafeGetTensorImpl();
+#endif
+    }
+  }
+}
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * AdamW optimizer to perform on-device training, e.g. to fine-tune LoRA
+ * adapters. This uses the gradients calculated in the backwards pass of the
+ * loss function and updates the parameters with Adam and decoupled weight
+ * decay, as described in "Decoupled Weight Decay Regularization" (Loshchilov
+ * and Hutter, 2019).
+ *
+ * This matches torch.optim.AdamW without amsgrad, but without the dependency
+ * on ATen Tensors and autograd.
+ */
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/span.h>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+/**
+ * AdamW optimizer state. This keeps track of the moments of a given parameter
+ * to be used in later steps.
+ */
+class AdamWParamState {
+ public:
+  /**
+   * Constructs a new AdamW param state.
+   *
+   * @param[in] exp_avg A tensor that stores the running average of the
+   *   gradient.
+   * @param[in] exp_avg_sq A tensor that stores the running average of the
+   *   squared gradient.
+   */
+  AdamWParamState(exec_aten::Tensor& exp_avg, exec_aten::Tensor& exp_avg_sq)
+      : exp_avg_(exp_avg), exp_avg_sq_(exp_avg_sq) {}
+
+  exec_aten::Tensor& exp_avg() {
+    return exp_avg_;
+  }
+
+  exec_aten::Tensor& exp_avg_sq() {
+    return exp_avg_sq_;
+  }
+
+  /// The number of steps that updated the parameter so far.
+  int64_t step() const {
+    return step_;
+  }
+
+  void increment_step() {
+    ++step_;
+  }
+
+ private:
+  exec_aten::Tensor exp_avg_;
+  exec_aten::Tensor exp_avg_sq_;
+  int64_t step_ = 0;
+};
+
+/**
+ * AdamW optimizer options. This contains options for performing training on
+ * a param group, such as the learning rate.
+ */
+class AdamWOptions {
+ public:
+  /**
+   * Constructs a new AdamW optimizer options.
+   *
+   * This is used for customizing the AdamW optimizer for a given group of
+   * parameters.
+   *
+   * @param[in] lr The learning rate.
+   * @param[in] beta1 The decay rate of the running average of the gradient.
+   * @param[in] beta2 The decay rate of the running average of the squared
+   *   gradient.
+   * @param[in] eps Added to the denominator of the update for numerical
+   *   stability.
+   * @param[in] weight_decay The fraction of the weight, scaled by the
+   *   learning rate, that is subtracted from it at each step. Unlike the weight
+   *   decay of SGD, it does not go through the moments.
+   * @param[in] state_dtype The dtype of the moments of float parameters.
+   *   Float keeps them at full precision; Half or BFloat16 halves the memory
+   *   of the optimizer state at the cost of precision. Double parameters
+   *   always keep double moments.
+   */
+  explicit AdamWOptions(
+      double lr = 1e-3,
+      double beta1 = 0.9,
+      double beta2 = 0.999,
+      double eps = 1e-8,
+      double weight_decay = 1e-2,
+      exec_aten::ScalarType state_dtype = exec_aten::ScalarType::Float)
+      : lr_(lr),
+        beta1_(beta1),
+        beta2_(beta2),
+        eps_(eps),
+        weight_decay_(weight_decay),
+        state_dtype_(state_dtype) {}
+
+  std::unique_ptr<AdamWOptions> clone() const {
+    return std::make_unique<AdamWOptions>(
+        static_cast<const AdamWOptions&>(*this));
+  }
+
+  double lr() const {
+    return lr_;
+  }
+
+  double beta1() const {
+    return beta1_;
+  }
+
+  double beta2() const {
+    return beta2_;
+  }
+
+  double eps() const {
+    return eps_;
+  }
+
+  double weight_decay() const {
+    return weight_decay_;
+  }
+
+  exec_aten::ScalarType state_dtype() const {
+    return state_dtype_;
+  }
+
+ private:
+  double lr_;
+  double beta1_;
+  double beta2_;
+  double eps_;
+  double weight_decay_;
+  exec_aten::ScalarType state_dtype_;
+};
+
+/**
+ * AdamW optimizer param group. This contains the parameters and
+ * the AdamWOptions associated to it.
+ */
+class AdamWParamGroup {
+ public:
+  // NOTE: In order to store `AdamWParamGroup` in a `std::vector`, it has
+  // to be copy-constructible.
+  AdamWParamGroup(const AdamWParamGroup& param_group)
+      : param_data_(param_group.param_data()),
+        param_names_(param_group.param_names()),
+        options_(
+            param_group.has_options() ? param_group.options().clone()
+                                      : nullptr) {}
+  AdamWParamGroup& operator=(const AdamWParamGroup& param_group) {
+    this->param_data_ = param_group.param_data();
+    this->param_names_ = param_group.param_names();
+    this->options_ =
+        param_group.has_options() ? param_group.options().clone() : nullptr;
+    return *this;
+  }
+
+  /**
+   * This constructs an AdamW param group. We expect that the two spans are of
+   * the same size, and that for a given param data, its index in param_data is
+   * the same as its param name in param_name.
+   *
+   * @param[in] param_names The names of the params for this group.
+   * @param[in] param_data The tensors representing the param data.
+   */
+  /* implicit */ AdamWParamGroup(
+      ::executorch::runtime::Span<const char*> param_names,
+      ::executorch::runtime::Span<exec_aten::Tensor> param_data)
+      : param_data_(std::move(param_data)),
+        param_names_(std::move(param_names)) {}
+  AdamWParamGroup(
+      ::executorch::runtime::Span<const char*> param_names,
+      ::executorch::runtime::Span<exec_aten::Tensor> param_data,
+      std::unique_ptr<AdamWOptions> options)
+      : param_data_(std::move(param_data)),
+        param_names_(std::move(param_names)),
+        options_(std::move(options)) {}
+
+  bool has_options() const;
+  AdamWOptions& options();
+  const AdamWOptions& options() const;
+  void set_options(std::unique_ptr<AdamWOptions> options);
+  ::executorch::runtime::Span<const char*> param_names();
+  const ::executorch::runtime::Span<const char*> param_names() const;
+  ::executorch::runtime::Span<exec_aten::Tensor> param_data();
+  const ::executorch::runtime::Span<exec_aten::Tensor> param_data() const;
+
+ private:
+  ::executorch::runtime::Span<exec_aten::Tensor> param_data_;
+  ::executorch::runtime::Span<const char*> param_names_;
+  std::unique_ptr<AdamWOptions> options_;
+};
+
+/**
+ * AdamW optimizer class. This is responsible for performing the optimization
+ * step.
+ */
+class AdamW {
+ public:
+  explicit AdamW(
+      const std::vector<AdamWParamGroup>& param_groups,
+      AdamWOptions defaults)
+      : defaults_(std::make_unique<AdamWOptions>(defaults)) {
+    for (const auto& param_group : param_groups) {
+      add_param_group(param_group);
+    }
+  }
+
+  explicit AdamW(
+      ::executorch::runtime::Span<const char*> param_names,
+      ::executorch::runtime::Span<exec_aten::Tensor> param_data,
+      AdamWOptions defaults)
+      : AdamW(
+            {AdamWParamGroup(std::move(param_names), std::move(param_data))},
+            defaults) {}
+
+  // Adds the given param_group to the optimizer's param_group list.
+  void add_param_group(const AdamWParamGroup& param_group);
+
+  ~AdamW();
+
+  /**
+   * Performs the optimization step.
+   *
+   * The two spans must be of the same size. It is expected that the gradient in
+   * 'gradient_data' at index 'i' represents the gradient calculated in the loss
+   * function for the parameter with the name in 'gradient_names' at index 'i'.
+   * If a name appears more than once, only its first gradient is used.
+   *
+   * Each parameter is updated in a single pass over its data, split across
+   * threads for large tensors when the portable kernels use the threadpool.
+   * Parameters must be float or double, and have the shape, dtype and layout
+   * of their gradients.
+   *
+   * @param[in] gradient_names The names of the params that matches the gradient
+   *   in 'gradient_data' at the same index.
+   * @param[in] gradient_data The gradient tensors to be used for optimization
+   *   step.
+   *
+   * @retval Error::InvalidArgument A gradient does not match its parameter,
+   *   or the dtype of a parameter or of the state is not supported.
+   */
+  ::executorch::runtime::Error step(
+      ::executorch::runtime::Span<const char*> gradient_names,
+      ::executorch::runtime::Span<exec_aten::Tensor> gradient_data);
+
+ private:
+  // Where a parameter is stored in param_groups_.
+  struct ParamLocation {
+    size_t group_index;
+    size_t param_index;
+    // The value of step_count_ during the last step that updated the param.
+    uint64_t last_step;
+  };
+
+  // Creates a zero-filled moment tensor with the shape of `like`. Freed by
+  // ~AdamW().
+  static exec_aten::Tensor create_moment(
+      const exec_aten::Tensor& like,
+      exec_aten::ScalarType dtype);
+
+  // Applies one step to the parameter `p` with the gradient `grad`.
+  ::executorch::runtime::Error update_param(
+      const AdamWOptions& options,
+      exec_aten::Tensor p,
+      const exec_aten::Tensor& grad);
+
+  std::vector<AdamWParamGroup> param_groups_;
+  std::unordered_map<void*, std::unique_ptr<AdamWParamState>> state_;
+  std::unique_ptr<AdamWOptions> defaults_;
+  // The params of all groups by name. The names are owned by the caller, like
+  // the rest of the param groups.
+  std::unordered_multimap<std::string_view, ParamLocation> param_locations_;
+  uint64_t step_count_ = 0;
+};
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/gradient_accumulator.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include <executorch/runtime/core/error.h>
+
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using exec_aten::TensorImpl;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+namespace {
+
+template <typename CTYPE>
+void scaled_add(CTYPE* acc, const CTYPE* grad, int64_t numel, double scale) {
+  const CTYPE alpha = static_cast<CTYPE>(scale);
+  torch::executor::elementwise_parallel_for(
+      numel, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          acc[i] += alpha * grad[i];
+        }
+      });
+}
+
+} // namespace
+
+GradientAccumulator::GradientAccumulator(
+    Span<const char*> gradient_names,
+    Span<Tensor> gradient_data)
+    : gradient_names_(gradient_names) {
+  ET_CHECK_MSG(
+      gradient_names.size() == gradient_data.size(),
+      "Gradient names and gradients must have the same length.");
+  gradients_.reserve(gradient_data.size());
+  for (size_t i = 0; i < gradient_data.size(); ++i) {
+    const Tensor& like = gradient_data[i];
+    // This memory needs to be freed when the accumulator is destroyed.
+    void* buf_ptr = calloc(1, like.nbytes());
+#ifdef USE_ATEN_LIB
+    std::vector<int64_t> sizes(like.sizes().begin(), like.sizes().end());
+    std::vector<int64_t> strides(like.strides().begin(), like.strides().end());
+    gradients_.push_back(
+        torch::from_blob(buf_ptr, sizes, strides, like.scalar_type()));
+#else
+    auto shape = std::make_unique<BufferShape>();
+    shape->sizes.assign(like.sizes().begin(), like.sizes().end());
+    shape->dim_order.assign(like.dim_order().begin(), like.dim_order().end());
+    shape->strides.assign(like.strides().begin(), like.strides().end());
+    gradients_.push_back(Tensor(new TensorImpl(
+        like.scalar_type(),
+        shape->sizes.size(),
+        shape->sizes.data(),
+        buf_ptr,
+        shape->dim_order.data(),
+        shape->strides.data())));
+    shapes_.push_back(std::move(shape));
+#endif
+    indices_.emplace(gradient_names[i], i);
+  }
+}
+
+GradientAccumulator::~GradientAccumulator() {
+  for (Tensor& gradient : gradients_) {
+    free(gradient.unsafeGetTensorImpl()->mutable_data());
+#ifndef USE_ATEN_LIB
+    delete gradient.unsafeGetTensorImpl();
+#endif
+  }
+}
+
+Error GradientAccumulator::accumulate(
+    Span<const char*> gradient_names,
+    Span<Tensor> gradient_data,
+    double scale) {
+  ET_CHECK_OR_RETURN_ERROR(
+      gradient_names.size() == gradient_data.size(),
+      InvalidState,
+      "Gradient names and gradients must have the same length.");
+
+  // Check all gradients first, so that a bad one does not leave the buffers
+  // with only part of a micro-batch.
+  for (size_t i = 0; i < gradient_names.size(); ++i) {
+    auto it = indices_.find(gradient_names[i]);
+    if (it == indices_.end()) {
+      continue;
+    }
+    const Tensor& acc = gradients_[it->second];
+    const Tensor& grad = gradient_data[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        acc.scalar_type() == ScalarType::Float ||
+            acc.scalar_type() == ScalarType::Double,
+        InvalidArgument,
+        "Only float and double gradients can be accumulated, %s is %hhd",
+        gradient_names[i],
+        static_cast<int8_t>(acc.scalar_type()));
+    ET_CHECK_OR_RETURN_ERROR(
+        grad.scalar_type() == acc.scalar_type() &&
+            grad.sizes() == acc.sizes() && grad.strides() == acc.strides(),
+        InvalidArgument,
+        "Gradient %s does not match its accumulated dtype, shape or layout",
+        gradient_names[i]);
+#ifdef USE_ATEN_LIB
+    // ATen tensors may be views with gaps between their elements.
+    ET_CHECK_OR_RETURN_ERROR(
+        grad.is_contiguous(),
+        InvalidArgument,
+        "Gradient %s must be contiguous",
+        gradient_names[i]);
+#endif
+  }
+
+  for (size_t i = 0; i < gradient_names.size(); ++i) {
+    auto it = indices_.find(gradient_names[i]);
+    if (it == indices_.end()) {
+      continue;
+    }
+    Tensor& acc = gradients_[it->second];
+    const Tensor& grad = gradient_data[i];
+    if (acc.scalar_type() == ScalarType::Float) {
+      scaled_add<float>(
+          acc.mutable_data_ptr<float>(),
+          grad.const_data_ptr<float>(),
+          acc.numel(),
+          scale);
+    } else {
+      scaled_add<double>(
+          acc.mutable_data_ptr<double>(),
+          grad.const_data_ptr<double>(),
+          acc.numel(),
+          scale);
+    }
+  }
+  ++num_accumulated_;
+  return Error::Ok;
+}
+
+void GradientAccumulator::zero() {
+  for (Tensor& gradient : gradients_) {
+    std::memset(gradient.mutable_data_ptr(), 0, gradient.nbytes());
+  }
+  num_accumulated_ = 0;
+}
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
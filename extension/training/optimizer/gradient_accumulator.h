@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Gradient accumulation across micro-batches for on-device training. A
+ * training method keeps its gradients in planned memory, which the next
+ * execution overwrites. To train with an effective batch that is larger than
+ * what fits in the memory plan, run the method once per micro-batch, add its
+ * gradients to the accumulator, and step the optimizer on the accumulated
+ * gradients:
+ *
+ * @code
+ *   GradientAccumulator accumulator(grad_names, method_grads);
+ *   for (size_t i = 0; i < num_micro_batches; ++i) {
+ *     // Set the inputs of micro-batch i.
+ *     method.execute();
+ *     accumulator.accumulate(
+ *         grad_names, method_grads, 1.0 / num_micro_batches);
+ *   }
+ *   optimizer.step(grad_names, accumulator.gradients());
+ *   accumulator.zero();
+ * @endcode
+ *
+ * Only the accumulated gradients live outside the memory plan, so the peak
+ * memory does not grow with the number of micro-batches.
+ */
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/span.h>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+/**
+ * Owns one float or double buffer per gradient, and adds the gradients of
+ * successive executions into them.
+ */
+class GradientAccumulator {
+ public:
+  /**
+   * Allocates zero-filled buffers shaped like the given gradients.
+   *
+   * @param[in] gradient_names The names of the gradients. Must outlive the
+   *   accumulator.
+   * @param[in] gradient_data Tensors with the shape and dtype of each gradient,
+   *   typically the gradient outputs of the training method. Only their
+   *   metadata is used.
+   */
+  GradientAccumulator(
+      ::executorch::runtime::Span<const char*> gradient_names,
+      ::executorch::runtime::Span<exec_aten::Tensor> gradient_data);
+
+  GradientAccumulator(const GradientAccumulator&) = delete;
+  GradientAccumulator& operator=(const GradientAccumulator&) = delete;
+
+  ~GradientAccumulator();
+
+  /**
+   * Adds `scale` times each gradient to the buffer with the same name, in a
+   * single pass over its data. Names that are not known to the accumulator are
+   * ignored.
+   *
+   * @param[in] gradient_names The names of the gradients in 'gradient_data'.
+   * @param[in] gradient_data The gradients of one micro-batch.
+   * @param[in] scale The factor applied to the gradients, e.g. one over the
+   *   number of micro-batches to average the gradients of a mean loss.
+   *
+   * @retval Error::InvalidState The spans have different sizes.
+   * @retval Error::InvalidArgument A gradient does not match its buffer, or
+   *   its dtype is not float or double.
+   */
+  ::executorch::runtime::Error accumulate(
+      ::executorch::runtime::Span<const char*> gradient_names,
+      ::executorch::runtime::Span<exec_aten::Tensor> gradient_data,
+      double scale = 1.0);
+
+  /// Sets all accumulated gradients to zero, e.g. after an optimizer step.
+  void zero();
+
+  /// The names of the accumulated gradients, as passed to the constructor.
+  ::executorch::runtime::Span<const char*> gradient_names() {
+    return gradient_names_;
+  }
+
+  /**
+   * The accumulated gradients, in the order of gradient_names(). Meant to be
+   * passed to the step() of an optimizer.
+   */
+  ::executorch::runtime::Span<exec_aten::Tensor> gradients() {
+    return {gradients_.data(), gradients_.size()};
+  }
+
+  /// The number of accumulate() calls since construction or the last zero().
+  size_t num_accumulated() const {
+    return num_accumulated_;
+  }
+
+ private:
+  // The metadata of a buffer, which must outlive its TensorImpl.
+  struct BufferShape {
+    std::vector<exec_aten::SizesType> sizes;
+    std::vector<exec_aten::DimOrderType> dim_order;
+    std::vector<exec_aten::StridesType> strides;
+  };
+
+  ::executorch::runtime::Span<const char*> gradient_names_;
+  std::vector<exec_aten::Tensor> gradients_;
+  std::vector<std::unique_ptr<BufferShape>> shapes_;
+  std::unordered_map<std::string_view, size_t> indices_;
+  size_t num_accumulated_ = 0;
+};
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/extension/training/optimizer/sgd.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 #include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
 
 #include <executorch/runtime/core/error.h>
@@ -64,6 +65,183 @@ void SGD::add_param_group(const SGDParamGroup& param_group) {
     param_group_.set_options(param_group.options().clone());
   }
   param_groups_.emplace_back(std::move(param_group_));
+
+  const size_t group_index = param_groups_.size() - 1;
+  const auto names = param_groups_.back().param_names();
+  for (size_t i = 0; i < names.size(); ++i) {
+    param_locations_.emplace(names[i], ParamLocation{group_index, i, 0});
+  }
+}
+
+namespace {
+
+/**
+ * Returns true if the update of `param` from `grad` can run as a single loop
+ * over the raw data, without calling kernels.
+ */
+bool can_fuse_update(const Tensor& param, const Tensor& grad) {
+  if (param.scalar_type() != grad.scalar_type() ||
+      (param.scalar_type() != exec_aten::ScalarType::Float &&
+       param.scalar_type() != exec_aten::ScalarType::Double)) {
+    return false;
+  }
+  if (!(param.sizes() == grad.sizes()) ||
+      !(param.strides() == grad.strides())) {
+    return false;
+  }
+#ifdef USE_ATEN_LIB
+  // ATen tensors may be views with gaps between their elements.
+  return param.is_contiguous() && grad.is_contiguous();
+#else
+  return true;
+#endif
+}
+
+/**
+ * Applies one SGD step to `numel` elements in a single pass, computing the
+ * same values as the kernel-based update in SGD::step(). `momentum_buffer` is
+ * null when momentum is off, and `init_momentum_buffer` is true on the first
+ * step of a parameter, when the buffer takes the value of the gradient.
+ */
+template <typename CTYPE>
+void fused_sgd_update(
+    CTYPE* param,
+    const CTYPE* grad,
+    CTYPE* momentum_buffer,
+    bool init_momentum_buffer,
+    int64_t numel,
+    const SGDOptions& options) {
+  const CTYPE lr = static_cast<CTYPE>(options.lr());
+  const CTYPE weight_decay = static_cast<CTYPE>(options.weight_decay());
+  const CTYPE momentum = static_cast<CTYPE>(options.momentum());
+  const CTYPE dampening = static_cast<CTYPE>(1 - options.dampening());
+  const bool nesterov = options.nesterov();
+  torch::executor::elementwise_parallel_for(
+      numel, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          CTYPE d_p = grad[i];
+          if (weight_decay != 0) {
+            d_p += weight_decay * param[i];
+          }
+          if (momentum_buffer != nullptr) {
+            const CTYPE buf = init_momentum_buffer
+                ? d_p
+                : momentum * momentum_buffer[i] + dampening * d_p;
+            momentum_buffer[i] = buf;
+            d_p = nesterov ? d_p + momentum * buf : buf;
+          }
+          param[i] -= lr * d_p;
+        }
+      });
+}
+
+} // namespace
+
+Tensor SGD::create_momentum_buffer(const Tensor& like) {
+  // This memory needs to be freed when the optimizer is destroyed.
+  void* buf_ptr = malloc(like.nbytes());
+#ifdef USE_ATEN_LIB
+  std::vector<int64_t> sizes(like.sizes().begin(), like.sizes().end());
+  return torch::from_blob(buf_ptr, sizes, like.scalar_type());
+#else
+  TensorImpl* buf_impl = new TensorImpl(
+      like.scalar_type(),
+      like.sizes().size(),
+      const_cast<TensorImpl::SizesType*>(like.sizes().data()),
+      buf_ptr,
+      const_cast<TensorImpl::DimOrderType*>(like.dim_order().data()));
+  return Tensor(buf_impl);
+#endif
+}
+
+Error SGD::update_param(
+    const SGDOptions& options,
+    Tensor p,
+    Tensor d_p,
+    KernelRuntimeContext& context) {
+  auto weight_decay = options.weight_decay();
+  auto momentum = options.momentum();
+  auto dampening = options.dampening();
+  auto nesterov = options.nesterov();
+
+  Tensor buf(nullptr);
+  bool init_momentum_buffer = false;
+  if (momentum != 0) {
+    // look for the momentum buffer for the given parameter. this is the
+    // momentum as of the previous epoch
+    auto param_state = state_.find(p.unsafeGetTensorImpl());
+    if (param_state == state_.end()) {
+      buf = create_momentum_buffer(d_p);
+      init_momentum_buffer = true;
+      // save the state of the momentum buffer to be reused in later epochs
+      state_[p.unsafeGetTensorImpl()] = std::make_unique<SGDParamState>(buf);
+    } else {
+      buf = static_cast<SGDParamState&>(*param_state->second)
+                .momentum_buffer();
+    }
+  }
+
+  if (can_fuse_update(p, d_p)) {
+    if (p.scalar_type() == exec_aten::ScalarType::Float) {
+      fused_sgd_update<float>(
+          p.mutable_data_ptr<float>(),
+          d_p.const_data_ptr<float>(),
+          momentum != 0 ? buf.mutable_data_ptr<float>() : nullptr,
+          init_momentum_buffer,
+          p.numel(),
+          options);
+    } else {
+      fused_sgd_update<double>(
+          p.mutable_data_ptr<double>(),
+          d_p.const_data_ptr<double>(),
+          momentum != 0 ? buf.mutable_data_ptr<double>() : nullptr,
+          init_momentum_buffer,
+          p.numel(),
+          options);
+    }
+    return Error::Ok;
+  }
+
+  // Other dtypes and layouts go through the portable kernels, which update
+  // the gradient in place.
+  if (weight_decay != 0) {
+    // uses weight_decay specified and adds it to the gradient
+    torch::executor::aten::add_outf(context, d_p, p, weight_decay, d_p);
+    if (context.failure_state() != Error::Ok) {
+      return context.failure_state();
+    }
+  }
+  if (momentum != 0) {
+    if (init_momentum_buffer) {
+      torch::executor::aten::clone_outf(
+          context, d_p, exec_aten::MemoryFormat::Contiguous, buf);
+      if (context.failure_state() != Error::Ok) {
+        return context.failure_state();
+      }
+    } else {
+      // update the momentum buffer and apply dampening
+      torch::executor::aten::mul_outf(context, buf, momentum, buf);
+      if (context.failure_state() != Error::Ok) {
+        return context.failure_state();
+      }
+      torch::executor::aten::add_outf(context, buf, d_p, 1 - dampening, buf);
+      if (context.failure_state() != Error::Ok) {
+        return context.failure_state();
+      }
+    }
+    if (nesterov) {
+      // apply nesterov momentum
+      torch::executor::aten::add_outf(context, d_p, buf, momentum, d_p);
+      if (context.failure_state() != Error::Ok) {
+        return context.failure_state();
+      }
+    } else {
+      d_p = buf;
+    }
+  }
+  // update the parameter using the gradient and learning rate
+  torch::executor::aten::add_outf(context, p, d_p, -1 * options.lr(), p);
+  return context.failure_state();
 }
 
 Error SGD::step(Span<const char*> gradient_names, Span<Tensor> gradient_data) {
@@ -73,94 +251,27 @@ Error SGD::step(Span<const char*> gradient_names, Span<Tensor> gradient_data) {
       InvalidState,
       "Gradient names and gradients must have the same length.");
 
+  // Parameters remember the last step that updated them, so that a name
+  // that appears several times in gradient_names only uses its first
+  // gradient.
+  ++step_count_;
   KernelRuntimeContext context;
-  for (auto& group : param_groups_) {
-    auto& options = static_cast<SGDOptions&>(group.options());
-    auto weight_decay = options.weight_decay();
-    auto momentum = options.momentum();
-    auto dampening = options.dampening();
-    auto nesterov = options.nesterov();
-
-    for (int i = 0; i < group.param_names().size(); i++) {
-      for (int j = 0; j < gradient_names.size(); j++) {
-        // if param name and gradient name match, run the optimizer step
-        if (strcmp(group.param_names()[i], gradient_names[j]) == 0) {
-          auto d_p = gradient_data[j];
-          auto p = group.param_data()[i];
-          if (weight_decay != 0) {
-            // uses weight_decay specified and adds it to the gradient
-            torch::executor::aten::add_outf(context, d_p, p, weight_decay, d_p);
-            if (context.failure_state() != Error::Ok) {
-              return context.failure_state();
-            }
-          }
-          if (momentum != 0) {
-            Tensor buf(nullptr);
-            auto param_state = state_.find(p.unsafeGetTensorImpl());
-            // look for the momentum buffer for the given parameter. this is the
-            // momentum as of the previous epoch
-            if (param_state == state_.end()) {
-              // create a new momentum buffer if it doesn't exist. this memory
-              // needs to be freed when the optimizer is destroyed
-              void* buf_ptr = malloc(d_p.nbytes());
-
-#ifdef USE_ATEN_LIB
-              std::vector<int64_t> sizes(
-                  d_p.sizes().begin(), d_p.sizes().end());
-              buf = torch::from_blob(buf_ptr, sizes, d_p.scalar_type());
-#else
-              TensorImpl* buf_impl = new TensorImpl(
-                  d_p.scalar_type(),
-                  d_p.sizes().size(),
-                  const_cast<TensorImpl::SizesType*>(d_p.sizes().data()),
-                  buf_ptr,
-                  const_cast<TensorImpl::DimOrderType*>(
-                      d_p.dim_order().data()));
-              buf = Tensor(buf_impl);
-#endif
-              torch::executor::aten::clone_outf(
-                  context, d_p, exec_aten::MemoryFormat::Contiguous, buf);
-              if (context.failure_state() != Error::Ok) {
-                return context.failure_state();
-              }
-
-              // save the state of the momentum buffer to be reused in later
-              // epochs
-              auto state = std::make_unique<SGDParamState>(buf);
-              state_[p.unsafeGetTensorImpl()] = std::move(state);
-            } else {
-              buf = static_cast<SGDParamState&>(*param_state->second)
-                        .momentum_buffer();
-
-              // update the momentum buffer and apply dampening
-              torch::executor::aten::mul_outf(context, buf, momentum, buf);
-              if (context.failure_state() != Error::Ok) {
-                return context.failure_state();
-              }
-              torch::executor::aten::add_outf(
-                  context, buf, d_p, 1 - dampening, buf);
-              if (context.failure_state() != Error::Ok) {
-                return context.failure_state();
-              }
-            }
-            if (nesterov) {
-              // apply nesterov momentum
-              torch::executor::aten::add_outf(context, d_p, buf, momentum, d_p);
-              if (context.failure_state() != Error::Ok) {
-                return context.failure_state();
-              }
-            } else {
-              d_p = buf;
-            }
-          }
-          // update the parameter using the gradient and learning rate
-          torch::executor::aten::add_outf(
-              context, p, d_p, -1 * options.lr(), p);
-          if (context.failure_state() != Error::Ok) {
-            return context.failure_state();
-          }
-          break;
-        }
+  for (size_t j = 0; j < gradient_names.size(); j++) {
+    auto range = param_locations_.equal_range(gradient_names[j]);
+    for (auto it = range.first; it != range.second; ++it) {
+      ParamLocation& location = it->second;
+      if (location.last_step == step_count_) {
+        continue;
+      }
+      location.last_step = step_count_;
+      auto& group = param_groups_[location.group_index];
+      Error err = update_param(
+          group.options(),
+          group.param_data()[location.param_index],
+          gradient_data[j],
+          context);
+      if (err != Error::Ok) {
+        return err;
       }
     }
   }
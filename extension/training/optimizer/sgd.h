@@ -19,7 +19,10 @@
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <cstdint>
 #include <memory>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -215,6 +218,12 @@ class SGD {
    * The two spans must be of the same size. It is expected that the gradient in
    * 'gradient_data' at index 'i' represents the gradient calculated in the loss
    * function for the parameter with the name in 'gradient_names' at index 'i'.
+   * If a name appears more than once, only its first gradient is used.
+   *
+   * Float and double parameters are updated in a single pass over their data,
+   * split across threads for large tensors when the portable kernels use the
+   * threadpool, and their gradients are left unchanged. Other parameters are
+   * updated with the portable kernels, which may modify the gradients.
    *
    * @param[in] gradient_names The names of the params that matches the gradient
    *   in 'gradient_data' at the same index.
@@ -226,9 +235,34 @@ class SGD {
       ::executorch::runtime::Span<exec_aten::Tensor> gradient_data);
 
  private:
+  // Where a parameter is stored in param_groups_.
+  struct ParamLocation {
+    size_t group_index;
+    size_t param_index;
+    // The value of step_count_ during the last step that updated the param.
+    uint64_t last_step;
+  };
+
+  // Creates an uninitialized momentum buffer with the shape and dtype of
+  // `like`. Freed by ~SGD().
+  static exec_aten::Tensor create_momentum_buffer(
+      const exec_aten::Tensor& like);
+
+  // Applies one step to the parameter `p` with the gradient `d_p`.
+  ::executorch::runtime::Error update_param(
+      const SGDOptions& options,
+      exec_aten::Tensor p,
+      exec_aten::Tensor d_p,
+      ::executorch::runtime::KernelRuntimeContext& context);
+
   std::vector<SGDParamGroup> param_groups_;
   std::unordered_map<void*, std::unique_ptr<SGDParamState>> state_;
   std::unique_ptr<SGDOptions> defaults_;
+  // The params of all groups by name, so that step() can find the param of
+  // each gradient without comparing every pair of names. The names are owned
+  // by the caller, like the rest of the param groups.
+  std::unordered_multimap<std::string_view, ParamLocation> param_locations_;
+  uint64_t step_count_ = 0;
 };
 
 } // namespace optimizer
@@ -37,6 +37,48 @@ def define_common_targets():
                 "//executorch/runtime/kernel:kernel_runtime_context" + aten_suffix,
                 "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
             ] + kernel_deps,
+            deps = [
+                "//executorch/kernels/portable/cpu/util:parallel_util",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "adamw" + aten_suffix,
+            srcs = [
+                "adamw.cpp",
+            ],
+            exported_headers = [
+                "adamw.h",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            deps = [
+                "//executorch/kernels/portable/cpu/util:parallel_util",
+                "//executorch/runtime/core/exec_aten/util:scalar_type_util" + aten_suffix,
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "gradient_accumulator" + aten_suffix,
+            srcs = [
+                "gradient_accumulator.cpp",
+            ],
+            exported_headers = [
+                "gradient_accumulator.h",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            deps = [
+                "//executorch/kernels/portable/cpu/util:parallel_util",
+            ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
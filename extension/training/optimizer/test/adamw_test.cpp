@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adamw.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+// @lint-ignore-every CLANGTIDY facebook-hte-CArray
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using ::executorch::extension::training::optimizer::AdamW;
+using ::executorch::extension::training::optimizer::AdamWOptions;
+using ::executorch::extension::training::optimizer::AdamWParamGroup;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Span;
+using ::executorch::runtime::testing::TensorFactory;
+
+class AdamWOptimizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Runs three steps on a float parameter with the given state dtype and
+  // checks the result against the update of torch.optim.AdamW.
+  void run_matches_reference(ScalarType state_dtype, double tolerance) {
+    TensorFactory<ScalarType::Float> tf;
+
+    const char* param_name[1] = {"param1"};
+    Span<const char*> param_names(param_name, 1);
+
+    Tensor param_data[1] = {tf.make({3}, {1.0, 2.0, 3.0})};
+    Span<Tensor> param_data_span(param_data, 1);
+
+    const double lr = 0.1;
+    const double beta1 = 0.8;
+    const double beta2 = 0.9;
+    const double eps = 1e-6;
+    const double weight_decay = 0.1;
+    AdamW optimizer(
+        param_names,
+        param_data_span,
+        AdamWOptions{lr, beta1, beta2, eps, weight_decay, state_dtype});
+
+    double expected[3] = {1.0, 2.0, 3.0};
+    double m[3] = {};
+    double v[3] = {};
+    const float grad[3] = {0.5, -1.0, 2.0};
+    for (int step = 1; step <= 3; ++step) {
+      Tensor grad_data[1] = {tf.make({3}, {grad[0], grad[1], grad[2]})};
+      Span<Tensor> grad_data_span(grad_data, 1);
+      ASSERT_EQ(optimizer.step(param_names, grad_data_span), Error::Ok);
+
+      const double bias_correction1 = 1 - std::pow(beta1, step);
+      const double bias_correction2 = 1 - std::pow(beta2, step);
+      for (int i = 0; i < 3; ++i) {
+        expected[i] *= 1 - lr * weight_decay;
+        m[i] = beta1 * m[i] + (1 - beta1) * grad[i];
+        v[i] = beta2 * v[i] + (1 - beta2) * grad[i] * grad[i];
+        const double denom =
+            std::sqrt(v[i]) / std::sqrt(bias_correction2) + eps;
+        expected[i] -= lr / bias_correction1 * m[i] / denom;
+      }
+      // The gradients are not modified.
+      EXPECT_EQ(grad_data[0].const_data_ptr<float>()[1], grad[1]);
+    }
+
+    const float* p = param_data_span[0].const_data_ptr<float>();
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(p[i], expected[i], tolerance);
+    }
+  }
+};
+
+TEST_F(AdamWOptimizerTest, AdamWOptionsDefaultValuesTest) {
+  AdamWOptions options(0.1);
+
+  EXPECT_EQ(options.lr(), 0.1);
+  EXPECT_EQ(options.beta1(), 0.9);
+  EXPECT_EQ(options.beta2(), 0.999);
+  EXPECT_EQ(options.eps(), 1e-8);
+  EXPECT_EQ(options.weight_decay(), 1e-2);
+  EXPECT_EQ(options.state_dtype(), ScalarType::Float);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerMatchesReference) {
+  run_matches_reference(ScalarType::Float, 1e-5);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerHalfStateMatchesReference) {
+  run_matches_reference(ScalarType::Half, 1e-2);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerBFloat16StateMatchesReference) {
+  run_matches_reference(ScalarType::BFloat16, 2e-2);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerDouble) {
+  TensorFactory<ScalarType::Double> tf;
+
+  const char* param_name[1] = {"param1"};
+  Span<const char*> param_names(param_name, 1);
+
+  Tensor param_data[1] = {tf.make({1}, {1.0})};
+  Span<Tensor> param_data_span(param_data, 1);
+
+  // Without weight decay, the first step moves the parameter by lr against
+  // the sign of the gradient.
+  AdamW optimizer(
+      param_names, param_data_span, AdamWOptions{0.1, 0.9, 0.999, 0, 0});
+
+  Tensor grad_data[1] = {tf.make({1}, {-3.0})};
+  Span<Tensor> grad_data_span(grad_data, 1);
+  ASSERT_EQ(optimizer.step(param_names, grad_data_span), Error::Ok);
+
+  EXPECT_DOUBLE_EQ(param_data_span[0].const_data_ptr<double>()[0], 1.1);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerParamGroupOptions) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const char* param_name1[1] = {"param1"};
+  Tensor param_data1[1] = {tf.make({1}, {1.0})};
+  const char* param_name2[1] = {"param2"};
+  Tensor param_data2[1] = {tf.make({1}, {1.0})};
+
+  std::vector<AdamWParamGroup> param_groups;
+  param_groups.emplace_back(
+      Span<const char*>(param_name1, 1), Span<Tensor>(param_data1, 1));
+  param_groups.emplace_back(
+      Span<const char*>(param_name2, 1),
+      Span<Tensor>(param_data2, 1),
+      std::make_unique<AdamWOptions>(0.5, 0.9, 0.999, 0, 0));
+  AdamW optimizer(param_groups, AdamWOptions{0.1, 0.9, 0.999, 0, 0});
+
+  const char* grad_name[2] = {"param1", "param2"};
+  Tensor grad_data[2] = {tf.make({1}, {1.0}), tf.make({1}, {1.0})};
+  ASSERT_EQ(
+      optimizer.step(
+          Span<const char*>(grad_name, 2), Span<Tensor>(grad_data, 2)),
+      Error::Ok);
+
+  EXPECT_NEAR(param_data1[0].const_data_ptr<float>()[0], 0.9, 1e-5);
+  EXPECT_NEAR(param_data2[0].const_data_ptr<float>()[0], 0.5, 1e-5);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerMismatchedGradientSpans) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const char* param_name[1] = {"param1"};
+  Span<const char*> param_names(param_name, 1);
+
+  Tensor param_data[1] = {tf.make({1, 1}, {1})};
+  Span<Tensor> param_data_span(param_data, 1);
+
+  Tensor grad_data[2] = {tf.make({1, 1}, {-1}), tf.make({1, 1}, {-1})};
+  Span<Tensor> grad_data_span(grad_data, 2);
+
+  AdamW optimizer(param_names, param_data_span, AdamWOptions{0.1});
+
+  EXPECT_EQ(optimizer.step(param_names, grad_data_span), Error::InvalidState);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerRejectsUnsupportedTensors) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+
+  const char* param_name[1] = {"param1"};
+  Span<const char*> param_names(param_name, 1);
+
+  Tensor param_data[1] = {tf.make({2}, {1, 2})};
+  Span<Tensor> param_data_span(param_data, 1);
+  AdamW optimizer(param_names, param_data_span, AdamWOptions{0.1});
+
+  // The gradient must match the parameter.
+  Tensor wrong_shape[1] = {tf.make({1}, {1})};
+  EXPECT_EQ(
+      optimizer.step(param_names, Span<Tensor>(wrong_shape, 1)),
+      Error::InvalidArgument);
+  Tensor wrong_dtype[1] = {tf_int.make({2}, {1, 1})};
+  EXPECT_EQ(
+      optimizer.step(param_names, Span<Tensor>(wrong_dtype, 1)),
+      Error::InvalidArgument);
+
+  // Integer parameters are not supported.
+  Tensor int_param_data[1] = {tf_int.make({2}, {1, 2})};
+  AdamW int_optimizer(
+      param_names, Span<Tensor>(int_param_data, 1), AdamWOptions{0.1});
+  EXPECT_EQ(
+      int_optimizer.step(param_names, Span<Tensor>(wrong_dtype, 1)),
+      Error::InvalidArgument);
+
+  // Nor are integer optimizer states.
+  AdamW int_state_optimizer(
+      param_names,
+      param_data_span,
+      AdamWOptions{0.1, 0.9, 0.999, 1e-8, 0, ScalarType::Int});
+  Tensor grad_data[1] = {tf.make({2}, {1, 1})};
+  EXPECT_EQ(
+      int_state_optimizer.step(param_names, Span<Tensor>(grad_data, 1)),
+      Error::InvalidArgument);
+  EXPECT_EQ(param_data[0].const_data_ptr<float>()[0], 1);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/gradient_accumulator.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+// @lint-ignore-every CLANGTIDY facebook-hte-CArray
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using ::executorch::extension::training::optimizer::GradientAccumulator;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Span;
+using ::executorch::runtime::testing::TensorFactory;
+
+class GradientAccumulatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(GradientAccumulatorTest, AccumulatesScaledGradients) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+
+  const char* grad_name[2] = {"weight.grad", "bias.grad"};
+  Span<const char*> grad_names(grad_name, 2);
+  Tensor grad_data[2] = {
+      tf.make({2, 2}, {1, 2, 3, 4}), tf_double.make({2}, {-1, 1})};
+  Span<Tensor> grad_data_span(grad_data, 2);
+
+  GradientAccumulator accumulator(grad_names, grad_data_span);
+  EXPECT_EQ(accumulator.gradients().size(), 2);
+  EXPECT_EQ(accumulator.gradients()[0].const_data_ptr<float>()[3], 0);
+
+  ASSERT_EQ(accumulator.accumulate(grad_names, grad_data_span, 0.5), Error::Ok);
+  // The names may come in any order.
+  const char* reversed_name[2] = {"bias.grad", "weight.grad"};
+  Tensor reversed_data[2] = {
+      tf_double.make({2}, {3, 3}), tf.make({2, 2}, {1, 1, 1, 1})};
+  ASSERT_EQ(
+      accumulator.accumulate(
+          Span<const char*>(reversed_name, 2),
+          Span<Tensor>(reversed_data, 2),
+          0.5),
+      Error::Ok);
+  EXPECT_EQ(accumulator.num_accumulated(), 2);
+
+  const float* weight = accumulator.gradients()[0].const_data_ptr<float>();
+  EXPECT_FLOAT_EQ(weight[0], 1.0);
+  EXPECT_FLOAT_EQ(weight[3], 2.5);
+  const double* bias = accumulator.gradients()[1].const_data_ptr<double>();
+  EXPECT_DOUBLE_EQ(bias[0], 1.0);
+  EXPECT_DOUBLE_EQ(bias[1], 2.0);
+
+  // The inputs are not modified.
+  EXPECT_EQ(grad_data[0].const_data_ptr<float>()[3], 4);
+
+  accumulator.zero();
+  EXPECT_EQ(accumulator.num_accumulated(), 0);
+  EXPECT_EQ(weight[3], 0);
+  EXPECT_EQ(bias[1], 0);
+}
+
+TEST_F(GradientAccumulatorTest, IgnoresUnknownNames) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const char* grad_name[1] = {"weight.grad"};
+  Tensor grad_data[1] = {tf.make({1}, {1})};
+  GradientAccumulator accumulator(
+      Span<const char*>(grad_name, 1), Span<Tensor>(grad_data, 1));
+
+  const char* other_name[2] = {"other.grad", "weight.grad"};
+  Tensor other_data[2] = {tf.make({3}, {1, 1, 1}), tf.make({1}, {2})};
+  ASSERT_EQ(
+      accumulator.accumulate(
+          Span<const char*>(other_name, 2), Span<Tensor>(other_data, 2)),
+      Error::Ok);
+
+  EXPECT_FLOAT_EQ(accumulator.gradients()[0].const_data_ptr<float>()[0], 2);
+}
+
+TEST_F(GradientAccumulatorTest, RejectsMismatchedGradients) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+
+  const char* grad_name[2] = {"weight.grad", "count.grad"};
+  Span<const char*> grad_names(grad_name, 2);
+  Tensor grad_data[2] = {tf.make({2}, {1, 1}), tf_int.make({1}, {1})};
+  GradientAccumulator accumulator(grad_names, Span<Tensor>(grad_data, 2));
+
+  // Mismatched spans.
+  EXPECT_EQ(
+      accumulator.accumulate(grad_names, Span<Tensor>(grad_data, 1)),
+      Error::InvalidState);
+
+  // Integer gradients are not supported.
+  EXPECT_EQ(
+      accumulator.accumulate(grad_names, Span<Tensor>(grad_data, 2)),
+      Error::InvalidArgument);
+
+  // Nor are gradients with another shape, and nothing is accumulated when
+  // one gradient is bad.
+  const char* wrong_name[2] = {"weight.grad", "weight.grad"};
+  Tensor wrong_data[2] = {tf.make({2}, {1, 1}), tf.make({3}, {1, 1, 1})};
+  EXPECT_EQ(
+      accumulator.accumulate(
+          Span<const char*>(wrong_name, 2), Span<Tensor>(wrong_data, 2)),
+      Error::InvalidArgument);
+  EXPECT_EQ(accumulator.gradients()[0].const_data_ptr<float>()[0], 0);
+  EXPECT_EQ(accumulator.num_accumulated(), 0);
+}
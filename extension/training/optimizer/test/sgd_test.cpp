@@ -136,3 +136,69 @@ TEST_F(SGDOptimizerTest, SGDOptimizerComplex) {
   EXPECT_NEAR(p1[0], 0.540303, 0.1);
   EXPECT_NEAR(p2[0], 0.620909, 0.1);
 }
+
+TEST_F(SGDOptimizerTest, SGDOptimizerMomentumMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const char* param_name[1] = {"param1"};
+  Span<const char*> param_names(param_name, 1);
+
+  Tensor param_data[1] = {tf.make({3}, {1.0, 2.0, 3.0})};
+  Span<Tensor> param_data_span(param_data, 1);
+
+  const double lr = 0.1;
+  const double momentum = 0.9;
+  const double dampening = 0.5;
+  const double weight_decay = 0.01;
+  SGD optimizer(
+      param_names,
+      param_data_span,
+      SGDOptions{lr, momentum, dampening, weight_decay});
+
+  // Mirrors the update of torch.optim.SGD.
+  float expected[3] = {1.0, 2.0, 3.0};
+  float buf[3] = {};
+  const float grad[3] = {0.5, -1.0, 2.0};
+  for (int step = 0; step < 3; ++step) {
+    Tensor grad_data[1] = {tf.make({3}, {grad[0], grad[1], grad[2]})};
+    Span<Tensor> grad_data_span(grad_data, 1);
+    ASSERT_EQ(optimizer.step(param_names, grad_data_span), Error::Ok);
+
+    for (int i = 0; i < 3; ++i) {
+      const float d_p = grad[i] + weight_decay * expected[i];
+      buf[i] = step == 0 ? d_p : momentum * buf[i] + (1 - dampening) * d_p;
+      expected[i] -= lr * buf[i];
+    }
+    // The gradients are not modified.
+    EXPECT_EQ(grad_data[0].const_data_ptr<float>()[1], grad[1]);
+  }
+
+  const float* p = param_data_span[0].const_data_ptr<float>();
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(p[i], expected[i], 1e-6);
+  }
+}
+
+TEST_F(SGDOptimizerTest, SGDOptimizerUsesFirstGradientOfEachParam) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const char* param_name[2] = {"param1", "param2"};
+  Span<const char*> param_names(param_name, 2);
+
+  Tensor param_data[2] = {tf.make({1}, {1.0}), tf.make({1}, {1.0})};
+  Span<Tensor> param_data_span(param_data, 2);
+
+  SGD optimizer(param_names, param_data_span, SGDOptions{1.0});
+
+  // Gradients may come in any order, and only the first one of a name counts.
+  const char* grad_name[3] = {"param2", "param1", "param2"};
+  Span<const char*> grad_names(grad_name, 3);
+  Tensor grad_data[3] = {
+      tf.make({1}, {0.25}), tf.make({1}, {0.5}), tf.make({1}, {100.0})};
+  Span<Tensor> grad_data_span(grad_data, 3);
+
+  ASSERT_EQ(optimizer.step(grad_names, grad_data_span), Error::Ok);
+
+  EXPECT_FLOAT_EQ(param_data_span[0].const_data_ptr<float>()[0], 0.5);
+  EXPECT_FLOAT_EQ(param_data_span[1].const_data_ptr<float>()[0], 0.75);
+}
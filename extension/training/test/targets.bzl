@@ -30,6 +30,7 @@ def define_common_targets(is_fbcode = False):
                 "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
                 "//executorch/extension/evalue_util:print_evalue",
                 "//executorch/runtime/executor/test:managed_memory_manager",
+                "//executorch/extension/training/optimizer:gradient_accumulator",
                 "//executorch/extension/training/optimizer:sgd",
                 "//executorch/kernels/portable:generated_lib",
             ],
@@ -8,6 +8,7 @@
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/evalue_util/print_evalue.h>
+#include <executorch/extension/training/optimizer/gradient_accumulator.h>
 #include <executorch/extension/training/optimizer/sgd.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
@@ -23,7 +24,7 @@
 // @lint-ignore-every CLANGTIDY facebook-hte-CArray
 
 using namespace ::testing;
-using namespace torch::executor::training::optimizer;
+using namespace ::executorch::extension::training::optimizer;
 using namespace torch::executor::testing;
 using exec_aten::ScalarType;
 using exec_aten::Tensor;
@@ -100,3 +101,41 @@ TEST_F(TrainingLoopTest, OptimizerSteps) {
   // Check that the data has changed.
   ASSERT_NE(param_data[0].data_ptr<float>()[0], orig_data);
 }
+
+TEST_F(TrainingLoopTest, AccumulatedGradientsStep) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program_->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  const char* param_name[2] = {"mod.linear1.weight", "mod.linear2.bias"};
+  Span<const char*> param_names(param_name, 2);
+  Tensor param_data[2] = {
+      method.get().get_output(3).toTensor(),
+      method.get().get_output(4).toTensor()};
+  Span<Tensor> param_data_span(param_data, 2);
+  Tensor grad_data[2] = {
+      method.get().get_output(1).toTensor(),
+      method.get().get_output(2).toTensor()};
+  Span<Tensor> grad_data_span(grad_data, 2);
+
+  // The planned gradient outputs are overwritten by every execution, so the
+  // accumulator keeps the sum of both micro-batches.
+  GradientAccumulator accumulator(param_names, grad_data_span);
+  TensorFactory<ScalarType::Float> tf;
+  Tensor inputs[2] = {
+      tf.make({3}, {1.0, 1.0, 1.0}), tf.make({3}, {0.5, -1.0, 2.0})};
+  Tensor label = tf.make({3}, {1.0, 0.0, 0.0});
+  for (Tensor& input : inputs) {
+    ASSERT_EQ(method->set_input(input, 0), Error::Ok);
+    ASSERT_EQ(method->set_input(label, 1), Error::Ok);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    ASSERT_EQ(
+        accumulator.accumulate(param_names, grad_data_span, 0.5), Error::Ok);
+  }
+  EXPECT_EQ(accumulator.num_accumulated(), 2);
+
+  auto orig_data = param_data[0].const_data_ptr<float>()[0];
+  SGD optimizer(param_names, param_data_span, SGDOptions{0.1});
+  ASSERT_EQ(optimizer.step(param_names, accumulator.gradients()), Error::Ok);
+  ASSERT_NE(param_data[0].const_data_ptr<float>()[0], orig_data);
+}
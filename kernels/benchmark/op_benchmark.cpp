@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Times the kernels registered in the OperatorRegistry over a fixed set of
+ * representative shapes and dtypes, calling them through the same boxed
+ * OpFunction interface that Method uses. Link this file against the kernel
+ * library to measure (see targets.bzl and CMakeLists.txt for the portable
+ * and optimized variants); cases whose operator is not registered in that
+ * library are skipped, so the output of two builds can be compared line by
+ * line.
+ *
+ * Example:
+ *   op_benchmark_optimized --filter=softmax --min_time_ms=500
+ */
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/runtime/core/evalue.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/platform/clock.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
+#include <executorch/runtime/platform/runtime.h>
+
+DEFINE_string(
+    filter,
+    "",
+    "Only run the cases whose name contains this string, e.g. 'aten::mm'.");
+DEFINE_int32(
+    min_time_ms,
+    200,
+    "Keep running each case until at least this much time has passed.");
+DEFINE_int32(warmup_iterations, 3, "Untimed runs before timing each case.");
+DEFINE_int32(
+    temp_allocator_bytes,
+    16 * 1024 * 1024,
+    "Size of the temp allocator handed to the kernels.");
+
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::BoxedEvalueList;
+using torch::executor::Error;
+using torch::executor::EValue;
+using torch::executor::KernelRuntimeContext;
+using torch::executor::MemoryAllocator;
+using torch::executor::OpFunction;
+using torch::executor::TensorMeta;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+/**
+ * The boxed arguments of one kernel call, along with the memory backing
+ * them.
+ */
+class BenchmarkCase {
+ public:
+  BenchmarkCase(std::string op_name, std::string shape)
+      : op_name_(std::move(op_name)), name_(op_name_ + "/" + shape) {}
+
+  const std::string& op_name() const {
+    return op_name_;
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  /// Bytes read and written by one call, counting every tensor argument once.
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+  /// Overrides bytes() for ops that only touch part of their inputs.
+  void set_bytes(int64_t bytes) {
+    bytes_ = bytes;
+  }
+
+  /// Floating point operations done by one call, or 0 if not meaningful.
+  int64_t flops() const {
+    return flops_;
+  }
+
+  void set_flops(int64_t flops) {
+    flops_ = flops;
+  }
+
+  /// Appends an argument to the call.
+  EValue* arg(EValue value) {
+    values_.push_back(std::move(value));
+    EValue* slot = &values_.back();
+    stack_.push_back(slot);
+    if (slot->isTensor()) {
+      add_tensor(slot->toTensor());
+    }
+    return slot;
+  }
+
+  /// Appends a float tensor filled with a smooth pattern in [-2, 2].
+  EValue* float_arg(const std::vector<int32_t>& sizes) {
+    return arg(make_float(sizes));
+  }
+
+  /// Appends a float tensor of zeros, meant to be written by the kernel.
+  EValue* float_out(const std::vector<int32_t>& sizes) {
+    return arg(tf_float_.zeros(sizes));
+  }
+
+  /// Appends a Long tensor whose values cycle through [0, bound).
+  EValue* index_arg(const std::vector<int32_t>& sizes, int64_t bound) {
+    std::vector<int64_t> data(numel(sizes));
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<int64_t>((i * 7919) % bound);
+    }
+    return arg(tf_long_.make(sizes, data));
+  }
+
+  /// Appends a Char tensor filled with a repeating pattern.
+  EValue* char_arg(const std::vector<int32_t>& sizes) {
+    std::vector<int8_t> data(numel(sizes));
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+    }
+    return arg(tf_char_.make(sizes, data));
+  }
+
+  /// Appends a Char tensor of zeros, meant to be written by the kernel.
+  EValue* char_out(const std::vector<int32_t>& sizes) {
+    return arg(tf_char_.zeros(sizes));
+  }
+
+  /// Appends an int[] argument.
+  EValue* int_list_arg(const std::vector<int64_t>& ints) {
+    std::vector<EValue*>& wrapped = wrapped_lists_.emplace_back();
+    for (int64_t i : ints) {
+      wrapped.push_back(&list_values_.emplace_back(i));
+    }
+    std::vector<int64_t>& unwrapped = int_lists_.emplace_back(ints);
+    return arg(BoxedEvalueList<int64_t>(
+        wrapped.data(), unwrapped.data(), static_cast<int>(ints.size())));
+  }
+
+  /// Appends a Tensor[] argument of float tensors.
+  EValue* float_list_arg(const std::vector<std::vector<int32_t>>& sizes) {
+    std::vector<EValue*>& wrapped = wrapped_lists_.emplace_back();
+    std::vector<Tensor>& unwrapped = tensor_lists_.emplace_back();
+    for (const auto& s : sizes) {
+      EValue& value = list_values_.emplace_back(make_float(s));
+      bytes_ += value.toTensor().nbytes();
+      wrapped.push_back(&value);
+      unwrapped.push_back(value.toTensor());
+    }
+    return arg(BoxedEvalueList<Tensor>(
+        wrapped.data(), unwrapped.data(), static_cast<int>(sizes.size())));
+  }
+
+  /// Appends the slot that receives the return value, which for out
+  /// variants aliases the out argument.
+  void returns(EValue* out) {
+    stack_.push_back(out);
+  }
+
+  EValue** stack() {
+    return stack_.data();
+  }
+
+  /// The dtype and dim order of every tensor argument, used to look up the
+  /// kernel the way Method does.
+  const std::vector<TensorMeta>& meta() const {
+    return meta_;
+  }
+
+ private:
+  static size_t numel(const std::vector<int32_t>& sizes) {
+    size_t n = 1;
+    for (int32_t s : sizes) {
+      n *= s;
+    }
+    return n;
+  }
+
+  Tensor make_float(const std::vector<int32_t>& sizes) {
+    std::vector<float> data(numel(sizes));
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = 2.0f * std::sin(0.01f * static_cast<float>(i % 4096));
+    }
+    return tf_float_.make(sizes, data);
+  }
+
+  void add_tensor(const Tensor& t) {
+    bytes_ += t.nbytes();
+    meta_.emplace_back(
+        t.scalar_type(),
+        exec_aten::ArrayRef<exec_aten::DimOrderType>(
+            t.dim_order().data(), t.dim_order().size()));
+  }
+
+  std::string op_name_;
+  std::string name_;
+  int64_t bytes_ = 0;
+  int64_t flops_ = 0;
+
+  TensorFactory<ScalarType::Float> tf_float_;
+  TensorFactory<ScalarType::Long> tf_long_;
+  TensorFactory<ScalarType::Char> tf_char_;
+
+  // Deques so that the pointers in stack_ and in the boxed lists stay valid
+  // as arguments are added. values_ comes last since destroying a boxed list
+  // reads the storage it points to.
+  std::deque<EValue> list_values_;
+  std::deque<std::vector<EValue*>> wrapped_lists_;
+  std::deque<std::vector<int64_t>> int_lists_;
+  std::deque<std::vector<Tensor>> tensor_lists_;
+  std::deque<EValue> values_;
+  std::vector<EValue*> stack_;
+  std::vector<TensorMeta> meta_;
+};
+
+using CaseList = std::vector<std::unique_ptr<BenchmarkCase>>;
+
+BenchmarkCase& add_case(CaseList& cases, const char* op, const char* shape) {
+  cases.push_back(std::make_unique<BenchmarkCase>(op, shape));
+  return *cases.back();
+}
+
+void add_binary_cases(CaseList& cases) {
+  for (const char* op : {"aten::add.out", "aten::mul.out"}) {
+    const bool has_alpha = std::string(op) == "aten::add.out";
+    for (bool broadcast : {false, true}) {
+      BenchmarkCase& c = add_case(
+          cases, op, broadcast ? "f32[1024,1024]x[1024]" : "f32[1024,1024]");
+      c.float_arg({1024, 1024});
+      if (broadcast) {
+        c.float_arg({1024});
+      } else {
+        c.float_arg({1024, 1024});
+      }
+      if (has_alpha) {
+        c.arg(exec_aten::Scalar(1));
+      }
+      c.returns(c.float_out({1024, 1024}));
+    }
+  }
+}
+
+void add_unary_cases(CaseList& cases) {
+  for (const char* op :
+       {"aten::exp.out", "aten::sigmoid.out", "aten::tanh.out"}) {
+    BenchmarkCase& c = add_case(cases, op, "f32[1048576]");
+    c.float_arg({1048576});
+    c.returns(c.float_out({1048576}));
+  }
+  BenchmarkCase& gelu = add_case(cases, "aten::gelu.out", "f32[1048576]");
+  gelu.float_arg({1048576});
+  gelu.arg(EValue("tanh", 4));
+  gelu.returns(gelu.float_out({1048576}));
+}
+
+void add_matmul_cases(CaseList& cases) {
+  for (int32_t n : {64, 256, 512}) {
+    const std::string shape = "f32[" + std::to_string(n) + "x" +
+        std::to_string(n) + "x" + std::to_string(n) + "]";
+    BenchmarkCase& c = add_case(cases, "aten::mm.out", shape.c_str());
+    c.float_arg({n, n});
+    c.float_arg({n, n});
+    c.returns(c.float_out({n, n}));
+    c.set_flops(2 * static_cast<int64_t>(n) * n * n);
+  }
+  // Per-head attention scores: [heads, seq, head_dim] x [heads, head_dim,
+  // seq].
+  BenchmarkCase& bmm = add_case(cases, "aten::bmm.out", "f32[32,128,64x128]");
+  bmm.float_arg({32, 128, 64});
+  bmm.float_arg({32, 64, 128});
+  bmm.returns(bmm.float_out({32, 128, 128}));
+  bmm.set_flops(2 * 32 * 128 * 64 * 128);
+}
+
+void add_reduction_cases(CaseList& cases) {
+  BenchmarkCase& softmax =
+      add_case(cases, "aten::_softmax.out", "f32[256,4096],dim=-1");
+  softmax.float_arg({256, 4096});
+  softmax.arg(EValue(static_cast<int64_t>(-1)));
+  softmax.arg(EValue(false));
+  softmax.returns(softmax.float_out({256, 4096}));
+
+  BenchmarkCase& amax =
+      add_case(cases, "aten::amax.out", "f32[1024,1024],dim=1");
+  amax.float_arg({1024, 1024});
+  amax.int_list_arg({1});
+  amax.arg(EValue(false));
+  amax.returns(amax.float_out({1024}));
+}
+
+void add_copy_cases(CaseList& cases) {
+  BenchmarkCase& permute =
+      add_case(cases, "aten::permute_copy.out", "f32[64,256,256],(0,2,1)");
+  permute.float_arg({64, 256, 256});
+  permute.int_list_arg({0, 2, 1});
+  permute.returns(permute.float_out({64, 256, 256}));
+
+  // Appending one token to a [batch, heads, seq, head_dim] KV cache.
+  BenchmarkCase& cat =
+      add_case(cases, "aten::cat.out", "f32[1,32,511,128]+[1,32,1,128],dim=2");
+  cat.float_list_arg({{1, 32, 511, 128}, {1, 32, 1, 128}});
+  cat.arg(EValue(static_cast<int64_t>(2)));
+  cat.returns(cat.float_out({1, 32, 512, 128}));
+
+  BenchmarkCase& slice =
+      add_case(cases, "aten::slice_copy.Tensor_out", "f32[1,32,512,128],dim=2");
+  slice.float_arg({1, 32, 512, 128});
+  slice.arg(EValue(static_cast<int64_t>(2)));
+  slice.arg(EValue(static_cast<int64_t>(0)));
+  slice.arg(EValue(static_cast<int64_t>(256)));
+  slice.arg(EValue(static_cast<int64_t>(1)));
+  slice.returns(slice.float_out({1, 32, 256, 128}));
+}
+
+void add_gather_cases(CaseList& cases) {
+  BenchmarkCase& embedding =
+      add_case(cases, "aten::embedding.out", "f32[32000,512],i64[256]");
+  embedding.float_arg({32000, 512});
+  embedding.index_arg({256}, 32000);
+  embedding.arg(EValue(static_cast<int64_t>(-1)));
+  embedding.arg(EValue(false));
+  embedding.arg(EValue(false));
+  embedding.returns(embedding.float_out({256, 512}));
+  // Only the looked up rows of the table are read.
+  embedding.set_bytes(2 * 256 * 512 * sizeof(float) + 256 * sizeof(int64_t));
+
+  BenchmarkCase& index_select = add_case(
+      cases, "aten::index_select.out", "f32[4096,1024],dim=0,i64[512]");
+  index_select.float_arg({4096, 1024});
+  index_select.arg(EValue(static_cast<int64_t>(0)));
+  index_select.index_arg({512}, 4096);
+  index_select.returns(index_select.float_out({512, 1024}));
+  index_select.set_bytes(
+      2 * 512 * 1024 * sizeof(float) + 512 * sizeof(int64_t));
+}
+
+void add_quantized_cases(CaseList& cases) {
+  BenchmarkCase& quantize = add_case(
+      cases,
+      "quantized_decomposed::quantize_per_tensor.out",
+      "f32[1048576]->i8");
+  quantize.float_arg({1048576});
+  quantize.arg(EValue(0.02));
+  quantize.arg(EValue(static_cast<int64_t>(0)));
+  quantize.arg(EValue(static_cast<int64_t>(-128)));
+  quantize.arg(EValue(static_cast<int64_t>(127)));
+  quantize.arg(EValue(static_cast<int64_t>(ScalarType::Char)));
+  quantize.returns(quantize.char_out({1048576}));
+
+  BenchmarkCase& dequantize = add_case(
+      cases,
+      "quantized_decomposed::dequantize_per_tensor.out",
+      "i8[1048576]->f32");
+  dequantize.char_arg({1048576});
+  dequantize.arg(EValue(0.02));
+  dequantize.arg(EValue(static_cast<int64_t>(0)));
+  dequantize.arg(EValue(static_cast<int64_t>(-128)));
+  dequantize.arg(EValue(static_cast<int64_t>(127)));
+  dequantize.arg(EValue(static_cast<int64_t>(ScalarType::Char)));
+  dequantize.arg(EValue());
+  dequantize.returns(dequantize.float_out({1048576}));
+}
+
+CaseList make_cases() {
+  CaseList cases;
+  add_binary_cases(cases);
+  add_unary_cases(cases);
+  add_matmul_cases(cases);
+  add_reduction_cases(cases);
+  add_copy_cases(cases);
+  add_gather_cases(cases);
+  add_quantized_cases(cases);
+  return cases;
+}
+
+uint64_t now_ns() {
+  return torch::executor::ticks_to_ns(et_pal_current_ticks());
+}
+
+/**
+ * Runs one case until --min_time_ms has passed and prints a line with the
+ * mean time per call and the throughput.
+ */
+void run_case(BenchmarkCase& c, MemoryAllocator& temp_allocator) {
+  const auto meta = c.meta();
+  const OpFunction& op = torch::executor::getOpsFn(
+      c.op_name().c_str(), {meta.data(), meta.size()});
+
+  KernelRuntimeContext context(nullptr, &temp_allocator);
+  for (int32_t i = 0; i < FLAGS_warmup_iterations; ++i) {
+    temp_allocator.reset();
+    op(context, c.stack());
+  }
+  if (context.failure_state() != Error::Ok) {
+    printf(
+        "%-64s FAILED with error 0x%" PRIx32 "\n",
+        c.name().c_str(),
+        static_cast<uint32_t>(context.failure_state()));
+    return;
+  }
+
+  const uint64_t min_time_ns =
+      static_cast<uint64_t>(FLAGS_min_time_ms) * 1000 * 1000;
+  int64_t iterations = 0;
+  const uint64_t start = now_ns();
+  uint64_t elapsed = 0;
+  while (elapsed < min_time_ns || iterations == 0) {
+    temp_allocator.reset();
+    op(context, c.stack());
+    ++iterations;
+    elapsed = now_ns() - start;
+  }
+
+  const double ns_per_call = static_cast<double>(elapsed) / iterations;
+  printf(
+      "%-64s %14.0f ns %10" PRId64 " %9.2f GB/s",
+      c.name().c_str(),
+      ns_per_call,
+      iterations,
+      c.bytes() / ns_per_call);
+  if (c.flops() > 0) {
+    printf(" %9.2f GFLOP/s", c.flops() / ns_per_call);
+  }
+  printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  torch::executor::runtime_init();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::vector<uint8_t> temp_buffer(FLAGS_temp_allocator_bytes);
+  MemoryAllocator temp_allocator(
+      static_cast<uint32_t>(temp_buffer.size()), temp_buffer.data());
+
+  printf(
+      "%-64s %17s %10s %14s\n",
+      "Benchmark",
+      "Time",
+      "Iterations",
+      "Throughput");
+  CaseList cases = make_cases();
+  for (auto& c : cases) {
+    if (c->name().find(FLAGS_filter) == std::string::npos) {
+      continue;
+    }
+    const auto meta = c->meta();
+    if (!torch::executor::hasOpsFn(
+            c->op_name().c_str(), {meta.data(), meta.size()})) {
+      continue;
+    }
+    run_case(*c, temp_allocator);
+  }
+  return 0;
+}
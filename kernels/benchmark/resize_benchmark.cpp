@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Times the shape bookkeeping that kernels do on every call with dynamically
+ * shaped out tensors: resize_tensor() to the sizes the tensor already has,
+ * which is what repeated input shapes lead to, and to new sizes. For
+ * comparison, it also times the check that a per-Method cache of output
+ * shapes would have to do before every kernel call to skip those resizes:
+ * comparing the sizes of the call's tensor arguments with the ones it saw
+ * last time.
+ *
+ * Example:
+ *   resize_benchmark --min_time_ms=500
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/platform/clock.h>
+#include <executorch/runtime/platform/platform.h>
+#include <executorch/runtime/platform/runtime.h>
+
+DEFINE_int32(
+    min_time_ms,
+    200,
+    "Keep running each case until at least this much time has passed.");
+
+using exec_aten::ScalarType;
+using exec_aten::SizesType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::TensorShapeDynamism;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+uint64_t now_ns() {
+  return torch::executor::ticks_to_ns(et_pal_current_ticks());
+}
+
+/**
+ * Runs `body` until --min_time_ms has passed and prints a line with the mean
+ * time per call. `body` returns false if it failed.
+ */
+template <typename Body>
+void run_case(const std::string& name, Body body) {
+  const uint64_t min_time_ns =
+      static_cast<uint64_t>(FLAGS_min_time_ms) * 1000 * 1000;
+  int64_t iterations = 0;
+  const uint64_t start = now_ns();
+  uint64_t elapsed = 0;
+  while (elapsed < min_time_ns || iterations == 0) {
+    // Run a batch between reads of the clock, which costs more than a
+    // resize.
+    for (int32_t i = 0; i < 1000; ++i) {
+      if (!body()) {
+        printf("%-48s FAILED\n", name.c_str());
+        return;
+      }
+    }
+    iterations += 1000;
+    elapsed = now_ns() - start;
+  }
+  printf(
+      "%-48s %10.2f ns %12" PRId64 "\n",
+      name.c_str(),
+      static_cast<double>(elapsed) / iterations,
+      iterations);
+}
+
+std::vector<int32_t> sizes_of_rank(size_t rank) {
+  std::vector<int32_t> sizes(rank, 4);
+  sizes.back() = 64;
+  return sizes;
+}
+
+void run_resize_cases(size_t rank) {
+  TensorFactory<ScalarType::Float> tf;
+  std::vector<int32_t> sizes = sizes_of_rank(rank);
+  std::vector<int32_t> other_sizes = sizes;
+  other_sizes.back() = 32;
+  Tensor out = tf.zeros(sizes, TensorShapeDynamism::DYNAMIC_BOUND);
+  const std::vector<SizesType> new_sizes_data(sizes.begin(), sizes.end());
+  const std::vector<SizesType> other_new_sizes_data(
+      other_sizes.begin(), other_sizes.end());
+  const exec_aten::ArrayRef<SizesType> new_sizes(
+      new_sizes_data.data(), new_sizes_data.size());
+  const exec_aten::ArrayRef<SizesType> other_new_sizes(
+      other_new_sizes_data.data(), other_new_sizes_data.size());
+  const std::string suffix = "/rank=" + std::to_string(rank);
+
+  run_case("resize_tensor/same_sizes" + suffix, [&]() {
+    return torch::executor::resize_tensor(out, new_sizes) == Error::Ok;
+  });
+
+  bool flip = false;
+  run_case("resize_tensor/new_sizes" + suffix, [&]() {
+    flip = !flip;
+    return torch::executor::resize_tensor(
+               out, flip ? other_new_sizes : new_sizes) == Error::Ok;
+  });
+}
+
+/**
+ * The sizes of the tensor arguments of one kernel call, kept from one call
+ * to the next as a per-Method shape cache would.
+ */
+class ShapeSignature {
+ public:
+  /// Returns true if the sizes of `args` are the ones seen last time, and
+  /// records them otherwise.
+  bool matches(const std::vector<Tensor>& args) {
+    size_t n = 0;
+    for (const auto& t : args) {
+      n += 1 + t.dim();
+    }
+    bool match = n == sizes_.size();
+    auto cached = sizes_.begin();
+    for (size_t i = 0; match && i < args.size(); ++i) {
+      const auto sizes = args[i].sizes();
+      match = *cached == sizes.size() &&
+          std::equal(sizes.begin(), sizes.end(), cached + 1);
+      cached += 1 + sizes.size();
+    }
+    if (!match) {
+      sizes_.clear();
+      for (const auto& t : args) {
+        sizes_.push_back(static_cast<SizesType>(t.dim()));
+        sizes_.insert(sizes_.end(), t.sizes().begin(), t.sizes().end());
+      }
+    }
+    return match;
+  }
+
+ private:
+  std::vector<SizesType> sizes_;
+};
+
+void run_signature_cases(size_t rank) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int32_t> sizes = sizes_of_rank(rank);
+  std::vector<int32_t> other_sizes = sizes;
+  other_sizes.back() = 32;
+  // The two inputs and the out tensor of a binary op.
+  const std::vector<Tensor> args = {
+      tf.zeros(sizes), tf.zeros(sizes), tf.zeros(sizes)};
+  const std::vector<Tensor> other_args = {
+      tf.zeros(other_sizes), tf.zeros(other_sizes), tf.zeros(other_sizes)};
+  const std::string suffix = "/3_tensors/rank=" + std::to_string(rank);
+
+  ShapeSignature signature;
+  signature.matches(args);
+  run_case("shape_signature/hit" + suffix, [&]() {
+    return signature.matches(args);
+  });
+
+  bool flip = false;
+  run_case("shape_signature/miss" + suffix, [&]() {
+    flip = !flip;
+    return !signature.matches(flip ? other_args : args);
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  torch::executor::runtime_init();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  printf("%-48s %13s %12s\n", "Benchmark", "Time", "Iterations");
+  for (size_t rank : {1, 2, 4}) {
+    run_resize_cases(rank);
+  }
+  for (size_t rank : {1, 2, 4}) {
+    run_signature_cases(rank);
+  }
+  return 0;
+}
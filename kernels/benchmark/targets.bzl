@@ -0,0 +1,59 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def _op_benchmark(name, kernel_deps):
+    """Defines an op_benchmark binary that times the kernels in kernel_deps.
+    """
+    runtime.cxx_binary(
+        name = name,
+        srcs = ["op_benchmark.cpp"],
+        deps = [
+            "//executorch/runtime/core:evalue",
+            "//executorch/runtime/core:memory_allocator",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/kernel:kernel_runtime_context",
+            "//executorch/runtime/kernel:operator_registry",
+            "//executorch/runtime/platform:platform",
+        ] + kernel_deps,
+        external_deps = [
+            "gflags",
+        ],
+    )
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # The same cases are run against each kernel library, so the output of
+    # the binaries can be compared line by line. The quantized ops are linked
+    # into both.
+    _op_benchmark(
+        "op_benchmark_portable",
+        [
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/kernels/quantized:generated_lib",
+        ],
+    )
+    _op_benchmark(
+        "op_benchmark_optimized",
+        [
+            "//executorch/kernels/optimized:generated_lib",
+            "//executorch/kernels/quantized:generated_lib",
+        ],
+    )
+
+    runtime.cxx_binary(
+        name = "resize_benchmark",
+        srcs = ["resize_benchmark.cpp"],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/runtime/platform:platform",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+    )
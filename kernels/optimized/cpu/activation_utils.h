@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Helpers for running elementwise activation math on executorch::vec types,
+// including for the reduced-precision float types, whose transcendental math
+// runs in float.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/// Elements of reduced-precision types are processed this many at a time, in
+/// a float buffer on the stack.
+constexpr int64_t kActivationBlockSize = 256;
+
+/**
+ * Converts between CTYPE and the type that activation math runs in for it:
+ * CTYPE itself for float and double, and float for Half and BFloat16.
+ */
+template <typename CTYPE>
+struct ActivationCompute {
+  using type = CTYPE;
+  static type to_compute(CTYPE value) {
+    return value;
+  }
+  static CTYPE from_compute(type value) {
+    return value;
+  }
+};
+
+template <>
+struct ActivationCompute<exec_aten::Half> {
+  using type = float;
+  static float to_compute(exec_aten::Half value) {
+    return static_cast<float>(value);
+  }
+  static exec_aten::Half from_compute(float value) {
+    return static_cast<exec_aten::Half>(value);
+  }
+};
+
+template <>
+struct ActivationCompute<exec_aten::BFloat16> {
+  using type = float;
+  static float to_compute(exec_aten::BFloat16 value) {
+    return executorch::vec::internal::bfloat16_bits_to_float(value.x);
+  }
+  static exec_aten::BFloat16 from_compute(float value) {
+    // Rounds to nearest, ties to even.
+    return executorch::vec::internal::from_float<exec_aten::BFloat16>(value);
+  }
+};
+
+template <typename CTYPE>
+using activation_compute_t = typename ActivationCompute<CTYPE>::type;
+
+namespace internal {
+
+// Widens `size` elements of a reduced-precision type to float, a
+// Vectorized<float> at a time.
+template <typename CTYPE>
+void to_compute_block(
+    const CTYPE* in,
+    int64_t size,
+    activation_compute_t<CTYPE>* out) {
+  using FloatVec = executorch::vec::Vectorized<float>;
+  int64_t i = 0;
+  for (; i + FloatVec::size() <= size; i += FloatVec::size()) {
+    executorch::vec::load_as_float(in + i).store(out + i);
+  }
+  for (; i < size; ++i) {
+    out[i] = ActivationCompute<CTYPE>::to_compute(in[i]);
+  }
+}
+
+template <typename CTYPE>
+void from_compute_block(
+    const activation_compute_t<CTYPE>* in,
+    int64_t size,
+    CTYPE* out) {
+  using FloatVec = executorch::vec::Vectorized<float>;
+  int64_t i = 0;
+  for (; i + FloatVec::size() <= size; i += FloatVec::size()) {
+    executorch::vec::store_as_16bit(FloatVec::loadu(in + i), out + i);
+  }
+  for (; i < size; ++i) {
+    out[i] = ActivationCompute<CTYPE>::from_compute(in[i]);
+  }
+}
+
+} // namespace internal
+
+/**
+ * Writes `vec_fun(in)` to `out`, elementwise, for `size` elements.
+ * `vec_fun` maps a Vectorized<activation_compute_t<CTYPE>> to another; for
+ * float and double it runs on the data in place.
+ */
+template <
+    typename CTYPE,
+    typename Op,
+    typename std::enable_if<
+        std::is_same<CTYPE, activation_compute_t<CTYPE>>::value,
+        int>::type = 0>
+void activation_map(
+    const Op& vec_fun,
+    CTYPE* out,
+    const CTYPE* in,
+    int64_t size) {
+  executorch::vec::map<CTYPE>(vec_fun, out, in, size);
+}
+
+/**
+ * Writes `vec_fun(in)` to `out`, elementwise, for `size` elements of a
+ * reduced-precision type, by widening blocks of the input to float.
+ */
+template <
+    typename CTYPE,
+    typename Op,
+    typename std::enable_if<
+        !std::is_same<CTYPE, activation_compute_t<CTYPE>>::value,
+        int>::type = 0>
+void activation_map(
+    const Op& vec_fun,
+    CTYPE* out,
+    const CTYPE* in,
+    int64_t size) {
+  using Compute = activation_compute_t<CTYPE>;
+  Compute buffer[kActivationBlockSize];
+  for (int64_t begin = 0; begin < size; begin += kActivationBlockSize) {
+    const int64_t n = std::min(kActivationBlockSize, size - begin);
+    internal::to_compute_block(in + begin, n, buffer);
+    executorch::vec::map<Compute>(vec_fun, buffer, buffer, n);
+    internal::from_compute_block(buffer, n, out + begin);
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
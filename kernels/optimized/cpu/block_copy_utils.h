@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Strided block copies, as done by cat, stack, split and slice. Along any dim
+// these ops move the same number of contiguous bytes for every index of the
+// leading dims, so each input or output is a batch of equally sized blocks
+// laid out at a fixed stride. The blocks are copied with memcpy, merged into
+// one copy when they are adjacent on both sides, and large copies are split
+// across threads by bytes so that a single big block is split too.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+// Smallest number of bytes worth handing to another thread.
+constexpr int64_t kBlockCopyGrainBytes = 128 * 1024;
+
+/**
+ * Copies `num_blocks` blocks of `block_bytes` bytes, block b going from
+ * `src + b * src_stride` to `dst + b * dst_stride`.
+ */
+inline void copy_blocks(
+    const char* src,
+    size_t src_stride,
+    char* dst,
+    size_t dst_stride,
+    int64_t num_blocks,
+    size_t block_bytes) {
+  if (num_blocks == 0 || block_bytes == 0) {
+    return;
+  }
+  if (src_stride == block_bytes && dst_stride == block_bytes) {
+    block_bytes *= num_blocks;
+    num_blocks = 1;
+  }
+  const int64_t block_size = static_cast<int64_t>(block_bytes);
+  elementwise_parallel_for(
+      num_blocks * block_size,
+      [&](int64_t begin, int64_t end) {
+        int64_t block = begin / block_size;
+        int64_t offset = begin - block * block_size;
+        while (begin < end) {
+          const int64_t n = std::min(block_size - offset, end - begin);
+          std::memcpy(
+              dst + block * dst_stride + offset,
+              src + block * src_stride + offset,
+              n);
+          begin += n;
+          ++block;
+          offset = 0;
+        }
+      },
+      kBlockCopyGrainBytes);
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
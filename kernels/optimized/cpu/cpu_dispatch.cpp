@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/cpu_dispatch.h>
+
+#if defined(ET_CPU_DISPATCH_HAVE_AVX2) || defined(ET_CPU_DISPATCH_HAVE_AVX512)
+#define ET_CPU_DISPATCH_USE_CPUINFO
+#include <cpuinfo.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+CpuCapability compute_cpu_capability() {
+#ifdef ET_CPU_DISPATCH_USE_CPUINFO
+  if (cpuinfo_initialize()) {
+#ifdef ET_CPU_DISPATCH_HAVE_AVX512
+    if (cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512bw() &&
+        cpuinfo_has_x86_avx512dq() && cpuinfo_has_x86_avx512vl() &&
+        cpuinfo_has_x86_fma3()) {
+      return CpuCapability::AVX512;
+    }
+#endif
+#ifdef ET_CPU_DISPATCH_HAVE_AVX2
+    if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3()) {
+      return CpuCapability::AVX2;
+    }
+#endif
+  }
+#endif // ET_CPU_DISPATCH_USE_CPUINFO
+  return CpuCapability::DEFAULT;
+}
+
+} // namespace
+
+CpuCapability get_cpu_capability() {
+  static const CpuCapability capability = compute_cpu_capability();
+  return capability;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Runtime selection between copies of a kernel that were compiled for
+// different vector ISAs. Modeled on ATen's DispatchStub.
+//
+// A kernel source that should be multi-versioned is compiled once per CPU
+// capability with `-DCPU_CAPABILITY=<name>` plus that capability's ISA flags,
+// and registers its implementation with ET_REGISTER_DISPATCH(). Callers
+// invoke the stub like a function; the first call picks the best
+// implementation that both the binary and the host CPU support.
+//
+// The DEFAULT slot is always present and holds the copy built with the
+// target's baseline flags. The other slots only exist when the build defines
+// ET_CPU_DISPATCH_HAVE_<name>, which it must do consistently for every
+// translation unit that includes this header.
+
+#include <cstdint>
+#include <utility>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/// The vector ISAs that kernels can be multi-versioned for, in increasing
+/// order of capability.
+enum class CpuCapability : uint8_t {
+  DEFAULT = 0,
+  AVX2 = 1,
+  AVX512 = 2,
+};
+
+/**
+ * Returns the most capable CpuCapability that the host CPU supports, among
+ * those this binary was built with. Detected with cpuinfo on first use.
+ */
+CpuCapability get_cpu_capability();
+
+template <typename FnType, typename T>
+struct DispatchStub {
+  using FnPtr = FnType;
+
+  template <typename... ArgTypes>
+  auto operator()(ArgTypes&&... args)
+      -> decltype(std::declval<FnPtr>()(std::forward<ArgTypes>(args)...)) {
+    return get_fn()(std::forward<ArgTypes>(args)...);
+  }
+
+  /// Returns the implementation chosen for the host CPU.
+  FnPtr get_fn() {
+    static const FnPtr fn = choose_cpu_impl();
+    return fn;
+  }
+
+  static FnPtr DEFAULT;
+#ifdef ET_CPU_DISPATCH_HAVE_AVX2
+  static FnPtr AVX2;
+#endif
+#ifdef ET_CPU_DISPATCH_HAVE_AVX512
+  static FnPtr AVX512;
+#endif
+
+ private:
+  static FnPtr choose_cpu_impl() {
+    const CpuCapability capability = get_cpu_capability();
+    (void)capability;
+#ifdef ET_CPU_DISPATCH_HAVE_AVX512
+    if (capability >= CpuCapability::AVX512 && AVX512 != nullptr) {
+      return AVX512;
+    }
+#endif
+#ifdef ET_CPU_DISPATCH_HAVE_AVX2
+    if (capability >= CpuCapability::AVX2 && AVX2 != nullptr) {
+      return AVX2;
+    }
+#endif
+    return DEFAULT;
+  }
+};
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+/**
+ * Declares a stub named `name` that dispatches to functions of type `fn`.
+ * Use in a header shared by the callers and the multi-versioned kernels.
+ */
+#define ET_DECLARE_DISPATCH(fn, name)                               \
+  struct name : torch::executor::native::DispatchStub<fn, name> {}; \
+  extern struct name name
+
+/// Defines the stub object for `name`, once, outside the kernel sources.
+#define ET_DEFINE_DISPATCH(name) struct name name
+
+#define ET_REGISTER_ARCH_DISPATCH(name, arch, fn)                  \
+  template <>                                                      \
+  name::FnPtr torch::executor::native::DispatchStub<name::FnPtr,   \
+                                                    struct name>:: \
+      arch = fn
+
+/**
+ * Registers `fn` as the implementation of stub `name` for the CPU_CAPABILITY
+ * that the current translation unit is being compiled for.
+ */
+#define ET_REGISTER_DISPATCH(name, fn) \
+  ET_REGISTER_ARCH_DISPATCH(name, CPU_CAPABILITY, fn)
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Row gathers, as done by embedding and index_select. Each output row is a
+// copy of an input row picked by an index, so the reads jump around the
+// input while the writes are sequential. The rows that are about to be read
+// are prefetched a few rows ahead of the copy, and large gathers are split
+// across threads by output row.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+// How many rows ahead of the current copy the source rows are prefetched.
+constexpr int64_t kGatherPrefetchDistance = 4;
+// At most this many bytes of a source row are prefetched; the rest of the
+// row is sequential and left to the hardware prefetcher.
+constexpr size_t kGatherPrefetchBytes = 256;
+constexpr size_t kGatherCacheLineBytes = 64;
+
+inline void prefetch_row(const char* row, size_t row_bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  const size_t bytes = std::min(row_bytes, kGatherPrefetchBytes);
+  for (size_t offset = 0; offset < bytes; offset += kGatherCacheLineBytes) {
+    __builtin_prefetch(row + offset, /*rw=*/0, /*locality=*/1);
+  }
+#else
+  (void)row;
+  (void)row_bytes;
+#endif
+}
+
+/**
+ * Copies `num_slices * num_indices` rows of `row_bytes` bytes into `dst`.
+ * The input holds `num_slices` slices of `src_rows` rows each, and output row
+ * `s * num_indices + j` is row `indices[j]` of slice `s`.
+ *
+ * PREREQ: every index is in [0, src_rows).
+ */
+template <typename INDEX_T>
+void gather_rows(
+    const char* src,
+    int64_t src_rows,
+    const INDEX_T* indices,
+    int64_t num_indices,
+    int64_t num_slices,
+    size_t row_bytes,
+    char* dst) {
+  if (num_indices == 0 || num_slices == 0 || row_bytes == 0) {
+    return;
+  }
+  const auto src_row = [&](int64_t r) {
+    const int64_t slice = r / num_indices;
+    const int64_t row = slice * src_rows + indices[r - slice * num_indices];
+    return src + row * row_bytes;
+  };
+
+  // Each chunk copies at least a grain's worth of bytes.
+  const int64_t grain = std::max<int64_t>(
+      1, kElementwiseGrainSize / static_cast<int64_t>(row_bytes));
+  elementwise_parallel_for(
+      num_slices * num_indices,
+      [&](int64_t begin, int64_t end) {
+        const int64_t prefetch_end =
+            std::min(end, begin + kGatherPrefetchDistance);
+        for (int64_t r = begin; r < prefetch_end; ++r) {
+          prefetch_row(src_row(r), row_bytes);
+        }
+        for (int64_t r = begin; r < end; ++r) {
+          if (r + kGatherPrefetchDistance < end) {
+            prefetch_row(src_row(r + kGatherPrefetchDistance), row_bytes);
+          }
+          std::memcpy(dst + r * row_bytes, src_row(r), row_bytes);
+        }
+      },
+      grain);
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
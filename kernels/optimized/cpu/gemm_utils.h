@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Helpers for lowering row-major matrix products onto the column-major
+// executorch::cpublas::gemm().
+
+#include <algorithm>
+#include <cstdint>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * A dense 2-D matrix. `row_major` is false when the matrix is stored
+ * column-major, e.g. a tensor with dim order {1, 0} produced by a transpose
+ * that was folded into the memory layout.
+ */
+template <typename T>
+struct MatrixRef {
+  T* data;
+  int64_t rows;
+  int64_t cols;
+  bool row_major;
+};
+
+/// Describes a 2-D tensor as a MatrixRef, based on its dim order.
+template <typename CTYPE>
+MatrixRef<const CTYPE> make_matrix_ref(const exec_aten::Tensor& t) {
+  return {
+      t.const_data_ptr<CTYPE>(),
+      t.size(0),
+      t.size(1),
+      t.dim_order()[0] == 0,
+  };
+}
+
+/// Describes a 2-D tensor as a mutable MatrixRef, based on its dim order.
+template <typename CTYPE>
+MatrixRef<CTYPE> make_mutable_matrix_ref(exec_aten::Tensor& t) {
+  return {
+      t.mutable_data_ptr<CTYPE>(),
+      t.size(0),
+      t.size(1),
+      t.dim_order()[0] == 0,
+  };
+}
+
+namespace internal {
+
+/// Returns the distance between the starts of adjacent rows of a row-major
+/// matrix, or of adjacent columns of a column-major one.
+template <typename T>
+int64_t leading_dim(const MatrixRef<T>& m) {
+  return std::max<int64_t>(m.row_major ? m.cols : m.rows, 1);
+}
+
+/**
+ * Returns how gemm() should read `m` to see `m`, or its transpose if
+ * `transposed`, as a column-major matrix. gemm() sees a row-major matrix as
+ * its own transpose.
+ */
+template <typename T>
+executorch::cpublas::TransposeType blas_transpose(
+    const MatrixRef<T>& m,
+    bool transposed) {
+  using executorch::cpublas::TransposeType;
+  return m.row_major != transposed ? TransposeType::Transpose
+                                   : TransposeType::NoTranspose;
+}
+
+} // namespace internal
+
+/**
+ * Computes `c = alpha * (op(a) @ op(b)) + beta * c` with one gemm() call,
+ * where op(x) is x, or its transpose if the matching `transpose_*` is true.
+ * op(a) must be [m, k], op(b) [k, n] and `c` [m, n].
+ *
+ * Operands may be stored row-major or column-major in any combination; the
+ * layout is expressed as a transposition for gemm() rather than copied. When
+ * `beta` is zero, `c` is not read.
+ */
+template <typename CTYPE>
+void gemm_2d(
+    const MatrixRef<const CTYPE>& a,
+    bool transpose_a,
+    const MatrixRef<const CTYPE>& b,
+    bool transpose_b,
+    CTYPE alpha,
+    CTYPE beta,
+    const MatrixRef<CTYPE>& c) {
+  using internal::blas_transpose;
+  using internal::leading_dim;
+
+  const int64_t k = transpose_a ? a.rows : a.cols;
+  if (c.row_major) {
+    // gemm() sees c as c^T = op(b)^T @ op(a)^T.
+    // clang-format off
+    executorch::cpublas::gemm(
+        blas_transpose(b, !transpose_b), blas_transpose(a, !transpose_a),
+        c.cols, c.rows, k,
+        alpha,
+        b.data, leading_dim(b),
+        a.data, leading_dim(a),
+        beta,
+        c.data, leading_dim(c));
+    // clang-format on
+  } else {
+    // clang-format off
+    executorch::cpublas::gemm(
+        blas_transpose(a, transpose_a), blas_transpose(b, transpose_b),
+        c.rows, c.cols, k,
+        alpha,
+        a.data, leading_dim(a),
+        b.data, leading_dim(b),
+        beta,
+        c.data, leading_dim(c));
+    // clang-format on
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
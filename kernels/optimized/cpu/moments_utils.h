@@ -22,6 +22,10 @@ namespace torch {
 namespace executor {
 namespace native {
 
+// Compiled once per CPU capability by multi-versioned kernels; see
+// Note [CPU_CAPABILITY namespace] in vec256.h.
+inline namespace CPU_CAPABILITY {
+
 template <typename T>
 using acc_t = executorch::utils::compute_dtype<T>;
 
@@ -186,6 +190,7 @@ RowwiseMoments(const T* X, int64_t N, int64_t ddof = 0) {
   }
 }
 
+} // namespace CPU_CAPABILITY
 } // namespace native
 } // namespace executor
 } // namespace torch
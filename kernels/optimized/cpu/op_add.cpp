@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -69,6 +70,8 @@ struct AddInner<false, CTYPE_A, CTYPE_B, CTYPE_IN, CTYPE_OUT>
 using Tensor = exec_aten::Tensor;
 using ScalarType = exec_aten::ScalarType;
 
+ET_DEFINE_DISPATCH(add_stub);
+
 Tensor& opt_add_out(
     RuntimeContext& ctx,
     const Tensor& a,
@@ -81,8 +84,7 @@ Tensor& opt_add_out(
   ScalarType b_type = b.scalar_type();
   ScalarType out_type = out.scalar_type();
 
-  if (a_type == b_type && a_type == out_type && a.sizes().equals(b.sizes()) &&
-      a_type != ScalarType::Half) {
+  if (a_type == b_type && a_type == out_type && a.sizes().equals(b.sizes())) {
     // Resize for dynamic shape
     auto error = resize_tensor(out, a.sizes());
     ET_KERNEL_CHECK_MSG(
@@ -92,17 +94,33 @@ Tensor& opt_add_out(
         out,
         "Failed to resize output tensor.");
 
+    if (a_type == ScalarType::Half || a_type == ScalarType::BFloat16) {
+      // 16-bit floats are added in float, so alpha stays a float.
+      float alpha_val;
+      ET_KERNEL_CHECK(
+          ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, out);
+
+      add_stub(
+          a_type,
+          out.mutable_data_ptr(),
+          a.const_data_ptr(),
+          b.const_data_ptr(),
+          &alpha_val,
+          out.numel());
+      return out;
+    }
+
     ET_SWITCH_REALB_TYPES(a_type, ctx, "add.out", CTYPE, [&]() {
       CTYPE alpha_val;
       ET_KERNEL_CHECK(
           ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
 
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
+      add_stub(
+          a_type,
+          out.mutable_data_ptr(),
+          a.const_data_ptr(),
+          b.const_data_ptr(),
+          &alpha_val,
           out.numel());
     });
   } else {
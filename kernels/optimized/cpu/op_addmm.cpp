@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/gemm_utils.h>
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// Computes out = beta * self + alpha * (mat1 @ mat2), where self is
+// broadcastable to the (n x p) product of mat1 (n x m) and mat2 (m x p).
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using Scalar = exec_aten::Scalar;
+
+namespace {
+
+// Copies `in`, broadcast to the 2-D shape of `out`, into `out`. Both tensors
+// are walked through their strides, so any dim order works.
+template <typename CTYPE>
+void broadcast_into_out(const Tensor& in, Tensor& out) {
+  // Align the dims of `in` with the trailing dims of `out`; missing and
+  // size-1 dims are repeated by not advancing through them.
+  int64_t in_strides[2] = {0, 0};
+  const int64_t offset = 2 - in.dim();
+  for (int64_t d = 0; d < in.dim(); ++d) {
+    if (in.size(d) != 1) {
+      in_strides[d + offset] = in.strides()[d];
+    }
+  }
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t out_stride_0 = out.strides()[0];
+  const int64_t out_stride_1 = out.strides()[1];
+  for (int64_t i = 0; i < out.size(0); ++i) {
+    for (int64_t j = 0; j < out.size(1); ++j) {
+      out_data[i * out_stride_0 + j * out_stride_1] =
+          in_data[i * in_strides[0] + j * in_strides[1]];
+    }
+  }
+}
+
+} // namespace
+
+// addmm.out(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1,
+//     Scalar alpha=1, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_addmm_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Scalar& beta,
+    const Scalar& alpha,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_addmm_args(in, mat1, mat2, beta, alpha, out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_mm_out_target_size(mat1, mat2, output_sizes, &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_broadcastable_to(in, out), InvalidArgument, out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ScalarType alpha_dtype = utils::get_scalar_dtype(alpha);
+  ScalarType beta_dtype = utils::get_scalar_dtype(beta);
+  constexpr auto name = "addmm.out";
+
+  ET_SWITCH_REAL_TYPES_AND(Half, in.scalar_type(), ctx, name, CTYPE, [&]() {
+    ET_SWITCH_SCALAR_OBJ_TYPES(alpha_dtype, ctx, name, ALPHA_T, [&]() {
+      ET_SWITCH_SCALAR_OBJ_TYPES(beta_dtype, ctx, name, BETA_T, [&]() {
+        const CTYPE alpha_val = convert<CTYPE>(alpha.to<ALPHA_T>());
+        const CTYPE beta_val = convert<CTYPE>(beta.to<BETA_T>());
+
+        // Like ATen, ignore self entirely when beta is zero, so that any
+        // NaNs in it do not propagate.
+        if (beta_val != static_cast<CTYPE>(0)) {
+          broadcast_into_out<CTYPE>(in, out);
+        }
+        gemm_2d<CTYPE>(
+            make_matrix_ref<CTYPE>(mat1),
+            /*transpose_a=*/false,
+            make_matrix_ref<CTYPE>(mat2),
+            /*transpose_b=*/false,
+            alpha_val,
+            beta_val,
+            make_mutable_matrix_ref<CTYPE>(out));
+      });
+    });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
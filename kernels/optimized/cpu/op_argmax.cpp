@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <executorch/kernels/optimized/cpu/reduce_utils.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using exec_aten::optional;
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+/**
+ * Same as the portable argmax.out, but reduces rows of a contiguous input
+ * with vectorized loops, splitting a single long row such as the logits of
+ * greedy decoding across threads, and also takes Half and BFloat16 inputs.
+ */
+Tensor& opt_argmax_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    optional<int64_t> dim,
+    bool keepdim,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_argmin_argmax_args(in, dim, keepdim, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "argmax.out";
+
+  const int64_t dim_value = dim.has_value() ? dim.value() : 0;
+  const optional<ArrayRef<int64_t>> dim_list = dim.has_value()
+      ? optional<ArrayRef<int64_t>>(ArrayRef<int64_t>(&dim_value, 1))
+      : optional<ArrayRef<int64_t>>();
+  ReductionShape shape;
+  if (get_reduction_shape(in, dim_list, shape) && shape.inner_size == 1) {
+    ET_SWITCH_REAL_TYPES_AND2(
+        Half, BFloat16, in.scalar_type(), ctx, name, CTYPE, [&] {
+          reduce_arg_extremum</*kMax=*/true>(
+              in.const_data_ptr<CTYPE>(),
+              shape,
+              out.mutable_data_ptr<int64_t>());
+        });
+    return out;
+  }
+
+  const int64_t grain_size = reduction_grain_size(
+      in.numel() / std::max<int64_t>(1, out.numel()));
+  ET_SWITCH_REAL_TYPES_AND2(
+      Half, BFloat16, in.scalar_type(), ctx, name, CTYPE, [&] {
+        int64_t* out_data = out.mutable_data_ptr<int64_t>();
+        elementwise_parallel_for(
+            out.numel(),
+            [&](int64_t begin, int64_t end) {
+              for (int64_t out_ix = begin; out_ix < end; ++out_ix) {
+                std::tuple<CTYPE, long> acc = reduce_over_dim<CTYPE>(
+                    [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
+                      // 16-bit floats are compared as float.
+                      const auto value = internal::arg_value(v);
+                      const auto acc_value = internal::arg_value(acc_val);
+                      if (!std::isnan(acc_value) &&
+                          (std::isnan(value) || value > acc_value)) {
+                        acc_val = v;
+                        acc_ix = ix;
+                      }
+                      return std::tuple<CTYPE, long>{acc_val, acc_ix};
+                    },
+                    in,
+                    dim,
+                    out_ix);
+                out_data[out_ix] = std::get<1>(acc);
+              }
+            },
+            grain_size);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
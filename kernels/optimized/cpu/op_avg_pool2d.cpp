@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/pool_utils.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+namespace {
+
+struct AvgPoolParams {
+  bool count_include_pad;
+  exec_aten::optional<int64_t> divisor_override;
+};
+
+// What the portable kernel divides the sum of window `w` by: the override,
+// every tap up to the end padding with count_include_pad, or else the taps
+// inside the input.
+template <typename CTYPE>
+int64_t avg_pool_divisor(
+    const Pool2dShape& s,
+    const AvgPoolParams& p,
+    const PoolWindow<CTYPE>& w,
+    const int64_t out_y,
+    const int64_t out_x) {
+  if (p.divisor_override.has_value()) {
+    return p.divisor_override.value();
+  }
+  if (!p.count_include_pad) {
+    return w.rows * w.cols;
+  }
+  const int64_t y0 = out_y * s.stride_h - s.pad_h;
+  const int64_t x0 = out_x * s.stride_w - s.pad_w;
+  return (std::min(y0 + s.kernel_h, s.in_h + s.pad_h) - y0) *
+      (std::min(x0 + s.kernel_w, s.in_w + s.pad_w) - x0);
+}
+
+// Sums the taps in the order of the portable kernel, so results match it
+// bit for bit.
+template <typename CTYPE>
+CTYPE sum_window(const PoolWindow<CTYPE>& w) {
+  CTYPE accum = w.first[0];
+  for (int64_t r = 0; r < w.rows; ++r) {
+    const CTYPE* row = w.first + r * w.row_step;
+    for (int64_t c = r == 0 ? 1 : 0; c < w.cols; ++c) {
+      accum = row[c * w.col_step] + accum;
+    }
+  }
+  return accum;
+}
+
+template <typename Vec, typename CTYPE>
+Vec sum_window_lanes(
+    const PoolWindow<CTYPE>& w,
+    const CTYPE* first,
+    const int64_t count) {
+  Vec accum = load_lanes<Vec>(first, count);
+  for (int64_t r = 0; r < w.rows; ++r) {
+    const CTYPE* row = first + r * w.row_step;
+    for (int64_t c = r == 0 ? 1 : 0; c < w.cols; ++c) {
+      accum = load_lanes<Vec>(row + c * w.col_step, count) + accum;
+    }
+  }
+  return accum;
+}
+
+// Any layout and dtype, one output at a time, in parallel over the batch x
+// channel planes.
+template <typename CTYPE>
+void avg_pool2d_planes(
+    const Pool2dShape& s,
+    const AvgPoolParams& p,
+    const CTYPE* in,
+    CTYPE* out) {
+  elementwise_parallel_for(
+      s.batch * s.channels,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const int64_t n = plane / s.channels;
+          const int64_t c = plane % s.channels;
+          const CTYPE* in_plane =
+              in + n * s.in_strides[0] + c * s.in_strides[1];
+          CTYPE* out_plane = out + n * s.out_strides[0] + c * s.out_strides[1];
+          for (int64_t oy = 0; oy < s.out_h; ++oy) {
+            for (int64_t ox = 0; ox < s.out_w; ++ox) {
+              PoolWindow<CTYPE> w;
+              if (!get_pool_window(
+                      s,
+                      in_plane,
+                      s.in_strides[2],
+                      s.in_strides[3],
+                      oy,
+                      ox,
+                      &w)) {
+                continue;
+              }
+              out_plane[oy * s.out_strides[2] + ox * s.out_strides[3]] =
+                  sum_window(w) /
+                  static_cast<CTYPE>(avg_pool_divisor(s, p, w, oy, ox));
+            }
+          }
+        }
+      },
+      pool2d_grain_size(s.out_h * s.out_w * s.kernel_h * s.kernel_w));
+}
+
+// Channels last: a pixel at a time with the channels in Vectorized lanes, in
+// parallel over batch x output rows.
+template <typename CTYPE>
+void avg_pool2d_channels_last(
+    const Pool2dShape& s,
+    const AvgPoolParams& p,
+    const CTYPE* in,
+    CTYPE* out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const int64_t C = s.channels;
+  elementwise_parallel_for(
+      s.batch * s.out_h,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t n = row / s.out_h;
+          const int64_t oy = row % s.out_h;
+          const CTYPE* in_n = in + n * s.in_strides[0];
+          CTYPE* out_row = out + n * s.out_strides[0] + oy * s.out_strides[2];
+          for (int64_t ox = 0; ox < s.out_w; ++ox) {
+            PoolWindow<CTYPE> w;
+            if (!get_pool_window(
+                    s, in_n, s.in_strides[2], s.in_strides[3], oy, ox, &w)) {
+              continue;
+            }
+            const Vec divisor(
+                static_cast<CTYPE>(avg_pool_divisor(s, p, w, oy, ox)));
+            CTYPE* out_pixel = out_row + ox * s.out_strides[3];
+            for (int64_t c = 0; c < C; c += Vec::size()) {
+              const int64_t count = std::min<int64_t>(Vec::size(), C - c);
+              (sum_window_lanes<Vec>(w, w.first + c, count) / divisor)
+                  .store(out_pixel + c, count);
+            }
+          }
+        }
+      },
+      pool2d_grain_size(s.out_w * C * s.kernel_h * s.kernel_w));
+}
+
+// Contiguous with a unit width stride: consecutive outputs of a row in
+// Vectorized lanes, in parallel over the batch x channel planes. Outputs
+// whose window reaches into the left or right padding go one at a time.
+template <typename CTYPE>
+void avg_pool2d_rows(
+    const Pool2dShape& s,
+    const AvgPoolParams& p,
+    const CTYPE* in,
+    CTYPE* out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  // Outputs [ox_begin, ox_end) have every tap of their window in the row.
+  const int64_t ox_begin = std::min(s.out_w, s.pad_w);
+  const int64_t ox_end = std::max(
+      ox_begin, std::min(s.out_w, s.in_w - s.kernel_w + 1 + s.pad_w));
+  elementwise_parallel_for(
+      s.batch * s.channels,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const CTYPE* in_plane = in + plane * s.in_h * s.in_w;
+          CTYPE* out_plane = out + plane * s.out_h * s.out_w;
+          for (int64_t oy = 0; oy < s.out_h; ++oy) {
+            CTYPE* out_row = out_plane + oy * s.out_w;
+            for (int64_t ox = 0; ox < s.out_w; ++ox) {
+              PoolWindow<CTYPE> w;
+              if ((ox >= ox_begin && ox < ox_end) ||
+                  !get_pool_window(s, in_plane, s.in_w, 1, oy, ox, &w)) {
+                continue;
+              }
+              out_row[ox] = sum_window(w) /
+                  static_cast<CTYPE>(avg_pool_divisor(s, p, w, oy, ox));
+            }
+            PoolWindow<CTYPE> w;
+            if (ox_begin == ox_end ||
+                !get_pool_window(s, in_plane, s.in_w, 1, oy, ox_begin, &w)) {
+              continue;
+            }
+            // Every output of the interior has the same divisor.
+            const Vec divisor(
+                static_cast<CTYPE>(avg_pool_divisor(s, p, w, oy, ox_begin)));
+            for (int64_t ox = ox_begin; ox < ox_end; ox += Vec::size()) {
+              const int64_t count = std::min<int64_t>(Vec::size(), ox_end - ox);
+              (sum_window_lanes<Vec>(w, w.first + (ox - ox_begin), count) /
+               divisor)
+                  .store(out_row + ox, count);
+            }
+          }
+        }
+      },
+      pool2d_grain_size(s.out_h * s.out_w * s.kernel_h * s.kernel_w));
+}
+
+template <typename CTYPE>
+bool avg_pool2d_vectorized(
+    const Pool2dShape&,
+    const AvgPoolParams&,
+    const CTYPE*,
+    CTYPE*,
+    std::false_type) {
+  return false;
+}
+
+template <typename CTYPE>
+bool avg_pool2d_vectorized(
+    const Pool2dShape& s,
+    const AvgPoolParams& p,
+    const CTYPE* in,
+    CTYPE* out,
+    std::true_type) {
+  if (s.channels_last) {
+    avg_pool2d_channels_last(s, p, in, out);
+    return true;
+  }
+  if (s.contiguous && s.stride_w == 1) {
+    avg_pool2d_rows(s, p, in, out);
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+Tensor& opt_avg_pool2d_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    exec_aten::optional<int64_t> divisor_override,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_avg_pool2d_args(
+          in,
+          kernel_size,
+          stride,
+          padding,
+          ceil_mode,
+          count_include_pad,
+          divisor_override,
+          out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_avg_pool2d_out_target_size(
+      in, kernel_size, stride, padding, ceil_mode, output_sizes, &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const Pool2dShape shape =
+      get_pool2d_shape(in, out, kernel_size, stride, padding, {});
+  const AvgPoolParams params{count_include_pad, divisor_override};
+
+  ScalarType in_type = in.scalar_type();
+  ET_SWITCH_FLOAT_TYPES_AND(Long, in_type, ctx, "avg_pool2d.out", CTYPE, [&]() {
+    const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    if (!avg_pool2d_vectorized(
+            shape, params, in_data, out_data, PoolVectorizable<CTYPE>())) {
+      avg_pool2d_planes(shape, params, in_data, out_data);
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
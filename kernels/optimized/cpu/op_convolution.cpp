@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// Computes a 1-D or 2-D convolution. Non-transposed convolutions of
+// contiguous tensors are lowered to one GEMM per batch and group: the input
+// patches are unfolded into a matrix (im2col) in temp memory, and multiplied
+// by the weight, which is already laid out as a matrix. Channels-last tensors
+// get the same treatment in their own layout, so that CNNs exported in NHWC
+// don't need transposes around each convolution. Other cases, and contexts
+// without a temp allocator, use a direct loop nest.
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+namespace {
+
+// The geometry of a convolution. 1-D convolutions are described as 2-D
+// convolutions with a height of 1.
+struct ConvParams {
+  int64_t batch;
+  int64_t in_c;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_c;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t k_h;
+  int64_t k_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t groups;
+};
+
+ConvParams get_conv_params(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& out,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  const bool is_1d = in.dim() == 3;
+  ConvParams p;
+  p.batch = in.size(0);
+  p.in_c = in.size(1);
+  p.in_h = is_1d ? 1 : in.size(2);
+  p.in_w = in.size(in.dim() - 1);
+  p.out_c = out.size(1);
+  p.out_h = is_1d ? 1 : out.size(2);
+  p.out_w = out.size(out.dim() - 1);
+  p.k_h = is_1d ? 1 : weight.size(2);
+  p.k_w = weight.size(weight.dim() - 1);
+  if (is_1d) {
+    p.stride_h = 1;
+    p.pad_h = 0;
+    p.dilation_h = 1;
+    p.stride_w = val_at(stride, 0);
+    p.pad_w = val_at(padding, 0, /*default_value=*/0);
+    p.dilation_w = val_at(dilation, 0);
+  } else {
+    p.stride_h = val_at(stride, 0);
+    p.pad_h = val_at(padding, 0, /*default_value=*/0);
+    p.dilation_h = val_at(dilation, 0);
+    p.stride_w = val_at(stride, 1);
+    p.pad_w = val_at(padding, 1, /*default_value=*/0);
+    p.dilation_w = val_at(dilation, 1);
+  }
+  p.groups = groups;
+  return p;
+}
+
+// Returns the NCHW strides of `t`, treating a 3-D tensor as having a height
+// of 1.
+void get_strides_4d(const Tensor& t, int64_t* strides) {
+  if (t.dim() == 3) {
+    strides[0] = t.strides()[0];
+    strides[1] = t.strides()[1];
+    strides[2] = 0;
+    strides[3] = t.strides()[2];
+  } else {
+    for (size_t i = 0; i < 4; ++i) {
+      strides[i] = t.strides()[i];
+    }
+  }
+}
+
+bool is_contiguous(const Tensor& t) {
+  return is_contiguous_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+bool is_channels_last(const Tensor& t) {
+  return is_channels_last_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+/**
+ * Unfolds the receptive fields of one batch and group of a contiguous input
+ * into `col`, a row-major [in_c_per_group * k_h * k_w, out_h * out_w] matrix.
+ * Elements that fall into the padding are zero.
+ */
+template <typename CTYPE>
+void im2col(const CTYPE* in, const ConvParams& p, CTYPE* col) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t out_hw = p.out_h * p.out_w;
+  for (int64_t c = 0; c < in_c_per_group; ++c) {
+    const CTYPE* const in_c = in + c * p.in_h * p.in_w;
+    for (int64_t ky = 0; ky < p.k_h; ++ky) {
+      for (int64_t kx = 0; kx < p.k_w; ++kx) {
+        CTYPE* const row = col + ((c * p.k_h + ky) * p.k_w + kx) * out_hw;
+        for (int64_t oy = 0; oy < p.out_h; ++oy) {
+          CTYPE* const row_y = row + oy * p.out_w;
+          const int64_t iy = oy * p.stride_h - p.pad_h + ky * p.dilation_h;
+          if (iy < 0 || iy >= p.in_h) {
+            std::memset(row_y, 0, p.out_w * sizeof(CTYPE));
+            continue;
+          }
+          const CTYPE* const in_y = in_c + iy * p.in_w;
+          for (int64_t ox = 0; ox < p.out_w; ++ox) {
+            const int64_t ix = ox * p.stride_w - p.pad_w + kx * p.dilation_w;
+            row_y[ox] = (ix >= 0 && ix < p.in_w) ? in_y[ix] : CTYPE(0);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Computes a non-transposed convolution of contiguous tensors with GEMM.
+ * Returns false, without touching `out`, if it needs temp memory that the
+ * context can't provide.
+ */
+template <typename CTYPE, typename CTYPE_BIAS>
+bool conv2d_gemm(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    const ConvParams& p,
+    Tensor& out) {
+  using executorch::cpublas::TransposeType;
+
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t out_c_per_group = p.out_c / p.groups;
+  const int64_t in_hw = p.in_h * p.in_w;
+  const int64_t out_hw = p.out_h * p.out_w;
+  // The reduction dim of the GEMM: one receptive field.
+  const int64_t k = in_c_per_group * p.k_h * p.k_w;
+
+  // A pointwise convolution reads the input as is, without unfolding it.
+  const bool is_pointwise = p.k_h == 1 && p.k_w == 1 && p.stride_h == 1 &&
+      p.stride_w == 1 && p.pad_h == 0 && p.pad_w == 0;
+  CTYPE* col = nullptr;
+  if (!is_pointwise) {
+    Result<void*> temp = ctx.allocate_temp(k * out_hw * sizeof(CTYPE));
+    if (!temp.ok()) {
+      return false;
+    }
+    col = static_cast<CTYPE*>(temp.get());
+  }
+
+  const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+  const CTYPE* const w_ptr = weight.const_data_ptr<CTYPE>();
+  CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+  const CTYPE_BIAS* const bias_ptr =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE_BIAS>() : nullptr;
+
+  for (int64_t n = 0; n < p.batch; ++n) {
+    for (int64_t g = 0; g < p.groups; ++g) {
+      const CTYPE* const in_g =
+          in_ptr + (n * p.in_c + g * in_c_per_group) * in_hw;
+      const CTYPE* const w_g = w_ptr + g * out_c_per_group * k;
+      CTYPE* const out_g =
+          out_ptr + (n * p.out_c + g * out_c_per_group) * out_hw;
+      if (!is_pointwise) {
+        im2col(in_g, p, col);
+      }
+
+      // Accumulate onto the bias, if there is one.
+      if (bias_ptr != nullptr) {
+        for (int64_t oc = 0; oc < out_c_per_group; ++oc) {
+          const CTYPE value = convert<CTYPE, CTYPE_BIAS>(
+              bias_ptr[g * out_c_per_group + oc]);
+          CTYPE* const out_row = out_g + oc * out_hw;
+          for (int64_t i = 0; i < out_hw; ++i) {
+            out_row[i] = value;
+          }
+        }
+      }
+
+      // out_g[out_c_per_group, out_hw] = w_g[out_c_per_group, k] @
+      // col[k, out_hw], all row-major. gemm() is column-major, so compute the
+      // transposed product col^T @ w_g^T instead.
+      // clang-format off
+      executorch::cpublas::gemm(
+          TransposeType::NoTranspose, TransposeType::NoTranspose,
+          out_hw, out_c_per_group, k,
+          static_cast<CTYPE>(1),
+          is_pointwise ? in_g : col, out_hw,
+          w_g, k,
+          static_cast<CTYPE>(bias_ptr != nullptr ? 1 : 0),
+          out_g, out_hw);
+      // clang-format on
+    }
+  }
+  return true;
+}
+
+/**
+ * Unfolds the receptive fields of one batch and group of a channels-last input
+ * into `col`, a row-major [out_h * out_w, k_h * k_w * in_c_per_group] matrix,
+ * so that each row is a receptive field in the order of a channels-last
+ * weight. Elements that fall into the padding are zero.
+ */
+template <typename CTYPE>
+void im2col_channels_last(const CTYPE* in, const ConvParams& p, CTYPE* col) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  for (int64_t oy = 0; oy < p.out_h; ++oy) {
+    for (int64_t ox = 0; ox < p.out_w; ++ox) {
+      CTYPE* row = col + (oy * p.out_w + ox) * p.k_h * p.k_w * in_c_per_group;
+      for (int64_t ky = 0; ky < p.k_h; ++ky) {
+        const int64_t iy = oy * p.stride_h - p.pad_h + ky * p.dilation_h;
+        for (int64_t kx = 0; kx < p.k_w; ++kx) {
+          const int64_t ix = ox * p.stride_w - p.pad_w + kx * p.dilation_w;
+          if (iy < 0 || iy >= p.in_h || ix < 0 || ix >= p.in_w) {
+            std::memset(row, 0, in_c_per_group * sizeof(CTYPE));
+          } else {
+            std::memcpy(
+                row,
+                in + (iy * p.in_w + ix) * p.in_c,
+                in_c_per_group * sizeof(CTYPE));
+          }
+          row += in_c_per_group;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Computes a non-transposed 2-D convolution of channels-last tensors with
+ * GEMM. Returns false, without touching `out`, if it needs temp memory that
+ * the context can't provide.
+ */
+template <typename CTYPE, typename CTYPE_BIAS>
+bool conv2d_gemm_channels_last(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    const ConvParams& p,
+    Tensor& out) {
+  using executorch::cpublas::TransposeType;
+
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t out_c_per_group = p.out_c / p.groups;
+  const int64_t in_hw = p.in_h * p.in_w;
+  const int64_t out_hw = p.out_h * p.out_w;
+  // The reduction dim of the GEMM: one receptive field.
+  const int64_t k = p.k_h * p.k_w * in_c_per_group;
+
+  // A pointwise convolution reads the pixels of the input as the rows of the
+  // matrix, without unfolding them.
+  const bool is_pointwise = p.k_h == 1 && p.k_w == 1 && p.stride_h == 1 &&
+      p.stride_w == 1 && p.pad_h == 0 && p.pad_w == 0;
+  CTYPE* col = nullptr;
+  if (!is_pointwise) {
+    Result<void*> temp = ctx.allocate_temp(out_hw * k * sizeof(CTYPE));
+    if (!temp.ok()) {
+      return false;
+    }
+    col = static_cast<CTYPE*>(temp.get());
+  }
+
+  const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+  const CTYPE* const w_ptr = weight.const_data_ptr<CTYPE>();
+  CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+  const CTYPE_BIAS* const bias_ptr =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE_BIAS>() : nullptr;
+
+  for (int64_t n = 0; n < p.batch; ++n) {
+    for (int64_t g = 0; g < p.groups; ++g) {
+      // The channels of a group are a slice of each pixel.
+      const CTYPE* const in_g =
+          in_ptr + n * in_hw * p.in_c + g * in_c_per_group;
+      const CTYPE* const w_g = w_ptr + g * out_c_per_group * k;
+      CTYPE* const out_g =
+          out_ptr + n * out_hw * p.out_c + g * out_c_per_group;
+      if (!is_pointwise) {
+        im2col_channels_last(in_g, p, col);
+      }
+
+      // Accumulate onto the bias, if there is one.
+      if (bias_ptr != nullptr) {
+        for (int64_t i = 0; i < out_hw; ++i) {
+          CTYPE* const out_pixel = out_g + i * p.out_c;
+          for (int64_t oc = 0; oc < out_c_per_group; ++oc) {
+            out_pixel[oc] = convert<CTYPE, CTYPE_BIAS>(
+                bias_ptr[g * out_c_per_group + oc]);
+          }
+        }
+      }
+
+      // out_g[out_hw, out_c_per_group] = col[out_hw, k] @ w_g[out_c_per_group,
+      // k]^T, all row-major, with the rows of out_g and of a pointwise input
+      // spaced by their channel counts. gemm() is column-major, so compute
+      // the transposed product w_g @ col^T instead.
+      // clang-format off
+      executorch::cpublas::gemm(
+          TransposeType::Transpose, TransposeType::NoTranspose,
+          out_c_per_group, out_hw, k,
+          static_cast<CTYPE>(1),
+          w_g, k,
+          is_pointwise ? in_g : col, is_pointwise ? p.in_c : k,
+          static_cast<CTYPE>(bias_ptr != nullptr ? 1 : 0),
+          out_g, p.out_c);
+      // clang-format on
+    }
+  }
+  return true;
+}
+
+/**
+ * Computes a convolution directly, reading every tensor through its strides.
+ * Handles any dim order and transposed convolutions.
+ */
+template <typename CTYPE, typename CTYPE_BIAS>
+void conv2d_direct(
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    const ConvParams& p,
+    bool transposed,
+    Tensor& out) {
+  int64_t in_s[4];
+  int64_t w_s[4];
+  int64_t out_s[4];
+  get_strides_4d(in, in_s);
+  get_strides_4d(weight, w_s);
+  get_strides_4d(out, out_s);
+
+  const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+  const CTYPE* const w_ptr = weight.const_data_ptr<CTYPE>();
+  CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+  const CTYPE_BIAS* const bias_ptr =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE_BIAS>() : nullptr;
+
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t out_c_per_group = p.out_c / p.groups;
+
+  if (!transposed) {
+    for (int64_t n = 0; n < p.batch; ++n) {
+      for (int64_t oc = 0; oc < p.out_c; ++oc) {
+        const int64_t ic_start = (oc / out_c_per_group) * in_c_per_group;
+        for (int64_t oy = 0; oy < p.out_h; ++oy) {
+          for (int64_t ox = 0; ox < p.out_w; ++ox) {
+            CTYPE accum = 0;
+            for (int64_t icg = 0; icg < in_c_per_group; ++icg) {
+              for (int64_t ky = 0; ky < p.k_h; ++ky) {
+                const int64_t iy =
+                    oy * p.stride_h - p.pad_h + ky * p.dilation_h;
+                if (iy < 0 || iy >= p.in_h) {
+                  continue;
+                }
+                for (int64_t kx = 0; kx < p.k_w; ++kx) {
+                  const int64_t ix =
+                      ox * p.stride_w - p.pad_w + kx * p.dilation_w;
+                  if (ix < 0 || ix >= p.in_w) {
+                    continue;
+                  }
+                  accum += in_ptr
+                               [n * in_s[0] + (ic_start + icg) * in_s[1] +
+                                iy * in_s[2] + ix * in_s[3]] *
+                      w_ptr[oc * w_s[0] + icg * w_s[1] + ky * w_s[2] +
+                            kx * w_s[3]];
+                }
+              }
+            }
+            if (bias_ptr != nullptr) {
+              accum += convert<CTYPE, CTYPE_BIAS>(bias_ptr[oc]);
+            }
+            out_ptr
+                [n * out_s[0] + oc * out_s[1] + oy * out_s[2] +
+                 ox * out_s[3]] = accum;
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  // A transposed convolution scatters each input element into the output,
+  // so initialize the output to the bias first.
+  for (int64_t n = 0; n < p.batch; ++n) {
+    for (int64_t oc = 0; oc < p.out_c; ++oc) {
+      const CTYPE value = bias_ptr != nullptr
+          ? convert<CTYPE, CTYPE_BIAS>(bias_ptr[oc])
+          : CTYPE(0);
+      for (int64_t oy = 0; oy < p.out_h; ++oy) {
+        for (int64_t ox = 0; ox < p.out_w; ++ox) {
+          out_ptr
+              [n * out_s[0] + oc * out_s[1] + oy * out_s[2] + ox * out_s[3]] =
+                  value;
+        }
+      }
+    }
+  }
+  for (int64_t n = 0; n < p.batch; ++n) {
+    for (int64_t ic = 0; ic < p.in_c; ++ic) {
+      const int64_t oc_start = (ic / in_c_per_group) * out_c_per_group;
+      for (int64_t iy = 0; iy < p.in_h; ++iy) {
+        for (int64_t ix = 0; ix < p.in_w; ++ix) {
+          const CTYPE in_val = in_ptr
+              [n * in_s[0] + ic * in_s[1] + iy * in_s[2] + ix * in_s[3]];
+          for (int64_t ocg = 0; ocg < out_c_per_group; ++ocg) {
+            for (int64_t ky = 0; ky < p.k_h; ++ky) {
+              const int64_t oy = iy * p.stride_h - p.pad_h + ky * p.dilation_h;
+              if (oy < 0 || oy >= p.out_h) {
+                continue;
+              }
+              for (int64_t kx = 0; kx < p.k_w; ++kx) {
+                const int64_t ox =
+                    ix * p.stride_w - p.pad_w + kx * p.dilation_w;
+                if (ox < 0 || ox >= p.out_w) {
+                  continue;
+                }
+                out_ptr
+                    [n * out_s[0] + (oc_start + ocg) * out_s[1] +
+                     oy * out_s[2] + ox * out_s[3]] += in_val *
+                    w_ptr[ic * w_s[0] + ocg * w_s[1] + ky * w_s[2] +
+                          kx * w_s[3]];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+// convolution.out(Tensor input, Tensor weight, Tensor? bias, int[] stride,
+//     SymInt[] padding, int[] dilation, bool transposed,
+//     SymInt[] output_padding, int groups, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_convolution_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const ConvParams params =
+      get_conv_params(in, weight, out, stride, padding, dilation, groups);
+  const bool use_gemm = !transposed && is_contiguous(in) &&
+      is_contiguous(weight) && is_contiguous(out);
+  // Channels-last dim orders are only defined for 4-D tensors.
+  const bool use_gemm_channels_last = !transposed && is_channels_last(in) &&
+      is_channels_last(weight) && is_channels_last(out);
+
+  ScalarType in_type = in.scalar_type();
+  ScalarType bias_type = in_type;
+  if (bias.has_value()) {
+    bias_type = bias.value().scalar_type();
+  }
+
+  constexpr auto name = "convolution.out";
+
+  ET_SWITCH_REALH_TYPES(in_type, ctx, name, CTYPE, [&]() {
+    ET_SWITCH_REALHB_TYPES(bias_type, ctx, name, CTYPE_BIAS, [&]() {
+      if (use_gemm &&
+          conv2d_gemm<CTYPE, CTYPE_BIAS>(ctx, in, weight, bias, params, out)) {
+        return;
+      }
+      if (use_gemm_channels_last &&
+          conv2d_gemm_channels_last<CTYPE, CTYPE_BIAS>(
+              ctx, in, weight, bias, params, out)) {
+        return;
+      }
+      conv2d_direct<CTYPE, CTYPE_BIAS>(
+          in, weight, bias, params, transposed, out);
+    });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+/**
+ * Returns true if `src` can be copied into `dst` as raw bytes: both must be
+ * contiguous with the same dtype, and `src` can only be broadcast along
+ * leading dims, so that `dst` is a whole number of copies of `src`.
+ */
+bool can_copy_bytes(const Tensor& src, const Tensor& dst) {
+  if (src.scalar_type() != dst.scalar_type() || src.numel() == 0 ||
+      !is_contiguous_dim_order(
+          src.dim_order().data(), src.dim_order().size()) ||
+      !is_contiguous_dim_order(
+          dst.dim_order().data(), dst.dim_order().size())) {
+    return false;
+  }
+  // Leading size-one dims of src do not change its layout.
+  ssize_t src_start = 0;
+  while (src_start < src.dim() && src.size(src_start) == 1) {
+    ++src_start;
+  }
+  const ssize_t src_dims = src.dim() - src_start;
+  if (src_dims > dst.dim()) {
+    return false;
+  }
+  const ssize_t dst_start = dst.dim() - src_dims;
+  for (ssize_t i = 0; i < src_dims; ++i) {
+    if (src.size(src_start + i) != dst.size(dst_start + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Fills `dst` with back-to-back copies of `src`; see can_copy_bytes().
+ */
+void copy_bytes(const Tensor& src, Tensor& dst) {
+  const char* src_data = static_cast<const char*>(src.const_data_ptr());
+  char* dst_data = static_cast<char*>(dst.mutable_data_ptr());
+  if (src_data == dst_data) {
+    return;
+  }
+  const size_t src_nbytes = src.nbytes();
+  const int64_t num_copies = dst.numel() / src.numel();
+  if (num_copies == 1) {
+    std::memcpy(dst_data, src_data, src_nbytes);
+    return;
+  }
+  const int64_t grain = std::max<int64_t>(
+      1, kElementwiseGrainSize / static_cast<int64_t>(src.numel()));
+  elementwise_parallel_for(
+      num_copies,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          std::memcpy(dst_data + i * src_nbytes, src_data, src_nbytes);
+        }
+      },
+      grain);
+}
+
+} // namespace
+
+// copy.out(const Tensor& in, const Tensor& src, bool non_blocking, Tensor(a!)
+// out) -> Tensor(a!), see caffe2/aten/src/ATen/native/Copy.cpp
+Tensor& opt_copy_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& src,
+    bool non_blocking,
+    Tensor& out) {
+  (void)ctx;
+  // Right now we only support blocking data transfer
+  ET_KERNEL_CHECK(ctx, non_blocking == false, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensors_have_same_dtype(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_broadcastable_to(src, in), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  if (can_copy_bytes(src, out)) {
+    copy_bytes(src, out);
+    return out;
+  }
+
+  ScalarType in_type = in.scalar_type();
+  ScalarType src_type = src.scalar_type();
+
+  ET_SWITCH_REALHB_TYPES(in_type, ctx, "copy.out", CTYPE, [&]() {
+    ET_SWITCH_REALHB_TYPES(src_type, ctx, "copy.out", CTYPE_SRC, [&]() {
+      apply_binary_elementwise_fn<CTYPE, CTYPE_SRC, CTYPE>(
+          [](const CTYPE val_in, const CTYPE_SRC val_src) {
+            return convert<CTYPE, CTYPE_SRC>(val_src);
+          },
+          in,
+          src,
+          out);
+    });
+  });
+
+  return out;
+}
+
+Tensor& opt_copy_(
+    RuntimeContext& ctx,
+    Tensor& in,
+    const Tensor& src,
+    bool non_blocking) {
+  (void)ctx;
+  // Right now we only support blocking data transfer
+  ET_KERNEL_CHECK(ctx, non_blocking == false, InvalidArgument, in);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_broadcastable_to(src, in), InvalidArgument, in);
+
+  if (can_copy_bytes(src, in)) {
+    copy_bytes(src, in);
+    return in;
+  }
+
+  ScalarType in_type = in.scalar_type();
+  ScalarType src_type = src.scalar_type();
+
+  ET_SWITCH_REALHB_TYPES(in_type, ctx, "copy_", CTYPE, [&]() {
+    ET_SWITCH_REALHB_TYPES(src_type, ctx, "copy_", CTYPE_SRC, [&]() {
+      apply_binary_elementwise_fn<CTYPE, CTYPE_SRC, CTYPE>(
+          [](const CTYPE val_in, const CTYPE_SRC val_src) {
+            return convert<CTYPE, CTYPE_SRC>(val_src);
+          },
+          in,
+          src,
+          in);
+    });
+  });
+
+  return in;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -58,6 +58,20 @@ Tensor& opt_div_out(
         out,
         "Failed to resize output tensor.");
 
+    if (out_type == ScalarType::Half || out_type == ScalarType::BFloat16) {
+      ET_SWITCH_TWO_TYPES(
+          Half, BFloat16, out_type, ctx, "div.out", CTYPE, [&]() {
+            using Vec = executorch::vec::Vectorized<CTYPE>;
+            executorch::vec::map2<CTYPE>(
+                [](Vec x, Vec y) { return x / y; },
+                out.mutable_data_ptr<CTYPE>(),
+                a.const_data_ptr<CTYPE>(),
+                b.const_data_ptr<CTYPE>(),
+                out.numel());
+          });
+      return out;
+    }
+
     ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "div.out", CTYPE, [&]() {
       using Vec = executorch::vec::Vectorized<CTYPE>;
       executorch::vec::map2<CTYPE>(
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/gather_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+/**
+ * Checks that every index is in [0, weight_height). The whole batch is
+ * checked with one min/max pass so the gather itself can run without
+ * branches; the offending index is only searched for on failure.
+ */
+template <typename CTYPE>
+bool check_embedding_indices(
+    const CTYPE* indices,
+    int64_t numel,
+    int64_t weight_height) {
+  CTYPE min_index = 0;
+  CTYPE max_index = 0;
+  for (int64_t i = 0; i < numel; ++i) {
+    min_index = std::min(min_index, indices[i]);
+    max_index = std::max(max_index, indices[i]);
+  }
+  if (min_index >= 0 && (numel == 0 || max_index < weight_height)) {
+    return true;
+  }
+  for (int64_t i = 0; i < numel; ++i) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        indices[i] < weight_height,
+        "indices_ptr[%" PRId64 "] %ld >= weight.size(0) %" PRId64,
+        i,
+        static_cast<long>(indices[i]),
+        weight_height);
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        indices[i] >= 0,
+        "indices_ptr[%" PRId64 "] %ld < 0",
+        i,
+        static_cast<long>(indices[i]));
+  }
+  return true;
+}
+
+} // namespace
+
+// embedding.out(Tensor weight, Tensor indices, int padding_idx=-1, bool
+// scale_grad_by_freq=False, bool sparse=False, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_embedding_out(
+    RuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    int64_t padding_idx,
+    bool scale_grad_by_freq,
+    bool sparse,
+    Tensor& out) {
+  (void)padding_idx;
+  (void)scale_grad_by_freq;
+  (void)sparse;
+
+  ET_KERNEL_CHECK(
+      ctx, check_embedding_args(weight, indices, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_embedding_output(weight, indices, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out.size(out.dim() - 1) == weight.size(1),
+      InvalidArgument,
+      out,
+      "out.size(%zd) %zd != weight.size(1) %zd",
+      out.dim() - 1,
+      out.size(1),
+      weight.size(1));
+
+  ScalarType ix_type = indices.scalar_type();
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      ix_type == ScalarType::Long || ix_type == ScalarType::Int,
+      InvalidArgument,
+      out,
+      "Expected indices tensor to have Long or Int scalar types");
+
+  const size_t row_bytes = weight.size(1) * weight.element_size();
+  const char* w_data = weight.const_data_ptr<char>();
+  char* out_data = out.mutable_data_ptr<char>();
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, ix_type, ctx, "op_embedding.out", CTYPE, [&]() {
+        const CTYPE* indices_ptr = indices.const_data_ptr<CTYPE>();
+        ET_KERNEL_CHECK(
+            ctx,
+            check_embedding_indices(
+                indices_ptr, indices.numel(), weight.size(0)),
+            InvalidArgument, );
+        if (w_data != nullptr) {
+          internal::gather_rows(
+              w_data,
+              weight.size(0),
+              indices_ptr,
+              indices.numel(),
+              /*num_slices=*/1,
+              row_bytes,
+              out_data);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,13 +6,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#ifdef __aarch64__
-#include <arm_neon.h>
-#include <sleef.h>
-#endif
-
 #include <cmath>
 
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -33,8 +30,8 @@ namespace {
  *  either 'none' to not approximate or 'tanh'
  *
  * Assumes that the tensors are contiguous, are the same shape, and have the
- * same dtype. CTYPE should be the C type (like `float` or `double`) that
- * matches the dtype of the tensors.
+ * same dtype. CTYPE should be `float`, the only type with vectorized tanh and
+ * erf.
  */
 template <typename CTYPE>
 void gelu(
@@ -46,48 +43,34 @@ void gelu(
   CTYPE* out_data = output.mutable_data_ptr<CTYPE>();
   size_t lim = input.numel();
 
-  // TODO: Add fast path for tanh using sleef's tanh
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  constexpr auto kAccuracy = executorch::vec::VecMathAccuracy::kFast;
+
   if (approximate == "tanh") {
     // 0.5 * x * (1 + Tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))
-    for (size_t i = 0; i < lim; ++i) {
-      const CTYPE x = in_data[i];
-      const CTYPE kBeta = M_SQRT2 * M_2_SQRTPI * 0.5;
-      const CTYPE kKappa = 0.044715;
-      auto x_cube = x * x * x;
-      auto inner = kBeta * (x + kKappa * x_cube);
-      out_data[i] = CTYPE(0.5) * x * (CTYPE(1) + std::tanh(inner));
-    }
+    const CTYPE kBeta = M_SQRT2 * M_2_SQRTPI * 0.5;
+    const CTYPE kKappa = 0.044715;
+    executorch::vec::map<CTYPE>(
+        [kBeta, kKappa](Vec x) {
+          const Vec inner = Vec(kBeta) * (x + Vec(kKappa) * x * x * x);
+          return Vec(0.5) * x *
+              (Vec(1) + executorch::vec::vec_tanh<kAccuracy>(inner));
+        },
+        out_data,
+        in_data,
+        lim);
   } else if (approximate == "none") { // dont appx
     // GELU(x) = x * Φ(x) where Φ(x) is the is the Cumulative Distribution
     // Function for Gaussian Distribution.
-
-#ifndef __aarch64__
-    for (size_t i = 0; i < lim; ++i) {
-      const CTYPE x = in_data[i];
-      out_data[i] = CTYPE(0.5) * x * (CTYPE(1) + std::erf(x * M_SQRT1_2));
-    }
-#else
-    size_t i = 0;
-    if (std::is_same<CTYPE, float>::value) {
-      for (; i + 4 < lim; i += 4) {
-        const float32x4_t in =
-            vld1q_f32(static_cast<const float*>(&in_data[i]));
-        const float32x4_t m_sqrt1_2x4 = {
-            M_SQRT1_2, M_SQRT1_2, M_SQRT1_2, M_SQRT1_2};
-        const float32x4_t ones = vmovq_n_f32(1.0);
-        const float32x4_t halves = vmovq_n_f32(0.5);
-        float32x4_t out = Sleef_erff4_u10(vmulq_f32(in, m_sqrt1_2x4));
-        vst1q_f32(
-            static_cast<float*>(&out_data[i]),
-            vmulq_f32(vmulq_f32(vaddq_f32(out, ones), in), halves));
-      }
-    }
-    for (; i < lim; ++i) {
-      const CTYPE x = in_data[i];
-      out_data[i] = CTYPE(0.5) * x * (CTYPE(1) + std::erf(x * M_SQRT1_2));
-    }
-#endif // __aarch64__
-
+    executorch::vec::map<CTYPE>(
+        [](Vec x) {
+          return Vec(0.5) * x *
+              (Vec(1) +
+               executorch::vec::vec_erf<kAccuracy>(x * Vec(M_SQRT1_2)));
+        },
+        out_data,
+        in_data,
+        lim);
   } else {
     ET_KERNEL_CHECK_MSG(
         context,
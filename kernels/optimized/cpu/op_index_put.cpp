@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/block_copy_utils.h>
+#include <executorch/kernels/portable/cpu/util/advanced_index_util.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+/**
+ * Returns the position of the only non-null index when `indices` is a single
+ * 1-D Long or Int index tensor after zero or more nulls, e.g. the
+ * `cache[:, :, input_pos] = k` of a KV cache update, and -1 otherwise.
+ */
+int64_t get_row_index_dim(
+    const Tensor& in,
+    exec_aten::ArrayRef<exec_aten::optional<Tensor>> indices) {
+  int64_t index_dim = -1;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (!indices[i].has_value()) {
+      continue;
+    }
+    const Tensor& index = indices[i].value();
+    if (index_dim >= 0 || index.dim() != 1 ||
+        (index.scalar_type() != ScalarType::Long &&
+         index.scalar_type() != ScalarType::Int)) {
+      return -1;
+    }
+    index_dim = i;
+  }
+  return index_dim < static_cast<int64_t>(in.dim()) ? index_dim : -1;
+}
+
+/**
+ * Whether `values` has exactly the shape of `in` with dim `index_dim`
+ * replaced by `num_indices`, i.e. holds one row of values per index without
+ * broadcasting.
+ */
+bool values_match_rows(
+    const Tensor& in,
+    const Tensor& values,
+    int64_t index_dim,
+    int64_t num_indices) {
+  if (values.dim() != in.dim() || values.scalar_type() != in.scalar_type()) {
+    return false;
+  }
+  for (size_t d = 0; d < in.dim(); ++d) {
+    const int64_t expected = d == index_dim ? num_indices : in.size(d);
+    if (values.size(d) != expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Writes row j of every leading slice of `values` to row indices[j] of the
+ * same slice of `out`, or adds it there when `accumulate` is set. Rows of
+ * different slices are written by different threads, and the rows of a slice
+ * in index order, so a repeated index keeps its last row as in the portable
+ * kernel.
+ *
+ * PREREQ: every index is in [-dim_length, dim_length).
+ */
+template <typename CTYPE, typename INDEX_T>
+void put_rows(
+    const CTYPE* values,
+    const INDEX_T* indices,
+    int64_t num_indices,
+    int64_t leading_dims,
+    int64_t dim_length,
+    int64_t trailing_dims,
+    bool accumulate,
+    CTYPE* out) {
+  const int64_t slice_bytes =
+      std::max<int64_t>(1, num_indices * trailing_dims * sizeof(CTYPE));
+  elementwise_parallel_for(
+      leading_dims,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          for (int64_t j = 0; j < num_indices; ++j) {
+            int64_t row = indices[j];
+            if (row < 0) {
+              row += dim_length;
+            }
+            CTYPE* dst = out + (i * dim_length + row) * trailing_dims;
+            const CTYPE* src = values + (i * num_indices + j) * trailing_dims;
+            if (accumulate) {
+              for (int64_t k = 0; k < trailing_dims; ++k) {
+                dst[k] += src[k];
+              }
+            } else {
+              std::memcpy(dst, src, trailing_dims * sizeof(CTYPE));
+            }
+          }
+        }
+      },
+      std::max<int64_t>(1, internal::kBlockCopyGrainBytes / slice_bytes));
+}
+
+} // namespace
+
+/**
+ * Same as the portable index_put.out, but skips copying `in` into `out` when
+ * the two are the same tensor, e.g. a KV cache updated in place, so the work
+ * is proportional to the number of indexed elements instead of the size of
+ * `in`. Indexing along one dim with a 1-D index, as KV cache updates do, also
+ * moves whole rows of trailing elements at a time.
+ */
+Tensor& opt_index_put_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    exec_aten::ArrayRef<exec_aten::optional<Tensor>> indices,
+    const Tensor& values,
+    const bool accumulate,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_index_args(in, indices, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dtype(in, values), InvalidArgument, out);
+
+  ScalarType in_type = in.scalar_type();
+  size_t block_count = count_index_blocks(indices);
+
+  // If indices list is empty or all indices are null, then the operation is
+  // performed over then entire input tensor. So, this is equivalent to
+  // out = values when accumulate is false. Otherwise, the operation is
+  // out = in + values where accumulate is true.
+  if (block_count == 0) {
+    ET_KERNEL_CHECK(
+        ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+    // Check that values tensors can be broadcasted to out
+    ET_KERNEL_CHECK(
+        ctx, tensor_is_broadcastable_to(values, out), InvalidArgument, out);
+
+    ET_SWITCH_REALHB_TYPES(in_type, ctx, "index_put.out", CTYPE, [&]() {
+      apply_binary_elementwise_fn<CTYPE, CTYPE, CTYPE>(
+          [accumulate](const CTYPE val_in, const CTYPE val) {
+            return accumulate ? val_in + val : val;
+          },
+          in,
+          values,
+          out);
+    });
+    return out;
+  }
+
+  // The index output shape depends on whether all the non-null indices are
+  // adjacent or not.
+  bool adjacent = (block_count == 1);
+
+  // Compute the expected index output shape.
+  Tensor::SizesType x_sizes[kTensorDimensionLimit];
+  size_t x_dim = 0;
+  ET_KERNEL_CHECK(
+      ctx,
+      get_index_out_target_size(in, indices, adjacent, x_sizes, &x_dim),
+      InvalidArgument,
+      out);
+
+  // Check that values tensors can be broadcasted to indexing result
+  ET_KERNEL_CHECK(
+      ctx,
+      tensor_is_broadcastable_to(values.sizes(), {x_sizes, x_dim}),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  // No further action if the input is empty
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  const int64_t index_dim = get_row_index_dim(in, indices);
+  const bool put_whole_rows = index_dim >= 0 &&
+      values_match_rows(
+          in, values, index_dim, indices[index_dim].value().numel());
+
+  if (put_whole_rows) {
+    // Check the indices before writing anything, so that a bad index leaves
+    // `out` untouched.
+    const Tensor& index = indices[index_dim].value();
+    const int64_t dim_length = in.size(index_dim);
+    bool indices_valid = true;
+    ET_SWITCH_TWO_TYPES(
+        Long, Int, index.scalar_type(), ctx, "index_put.out", INDEX_T, [&]() {
+          const INDEX_T* index_data = index.const_data_ptr<INDEX_T>();
+          for (size_t j = 0; j < index.numel(); ++j) {
+            if (index_data[j] < -dim_length || index_data[j] >= dim_length) {
+              ET_LOG(
+                  Error,
+                  "index %" PRId64 " out of range for dim of size %" PRId64,
+                  static_cast<int64_t>(index_data[j]),
+                  dim_length);
+              indices_valid = false;
+              return;
+            }
+          }
+        });
+    ET_KERNEL_CHECK(ctx, indices_valid, InvalidArgument, out);
+  }
+
+  // To start, copy the input data into the out tensor, unless it is already
+  // there because `out` is `in`.
+  if (out.const_data_ptr() != in.const_data_ptr()) {
+    internal::copy_blocks(
+        in.const_data_ptr<char>(),
+        in.nbytes(),
+        out.mutable_data_ptr<char>(),
+        out.nbytes(),
+        1,
+        in.nbytes());
+  }
+
+  if (put_whole_rows) {
+    const Tensor& index = indices[index_dim].value();
+    ET_SWITCH_REALHB_TYPES(in_type, ctx, "index_put.out", CTYPE, [&]() {
+      ET_SWITCH_TWO_TYPES(
+          Long, Int, index.scalar_type(), ctx, "index_put.out", INDEX_T, [&]() {
+            put_rows(
+                values.const_data_ptr<CTYPE>(),
+                index.const_data_ptr<INDEX_T>(),
+                index.numel(),
+                getLeadingDims(in, index_dim),
+                in.size(index_dim),
+                getTrailingDims(in, index_dim),
+                accumulate,
+                out.mutable_data_ptr<CTYPE>());
+          });
+    });
+    return out;
+  }
+
+  // In what follows, `x = in[indices]`. This tensor is implicit, and its
+  // coordinates are translated to `in`, as in the portable kernel.
+
+  // Compute the dim_map and ix_map needed for `x -> in` coordinate translation
+  int32_t dim_map[kTensorDimensionLimit];
+  int32_t ix_map[kTensorDimensionLimit];
+  size_t start = 0;
+
+  if (adjacent) {
+    start = get_num_leading_null_indices(indices);
+  }
+  size_t bc_ndim = get_indices_broadcast_ndim(indices);
+  compute_dim_map(in, indices, dim_map, block_count == 1);
+  compute_index_map(in, indices, ix_map);
+
+  // Compute the number of elements in the indexed space
+  size_t x_numel = 1;
+  for (size_t i = 0; i < x_dim; i++) {
+    x_numel *= x_sizes[i];
+  }
+
+  ET_SWITCH_REALHB_TYPES(in_type, ctx, "index_put.out", CTYPE, [&]() {
+    const CTYPE* const values_data = values.const_data_ptr<CTYPE>();
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+    for (size_t x_ix = 0; x_ix < x_numel; x_ix++) {
+      size_t x_coord[kTensorDimensionLimit];
+      delinearize_index(x_ix, {x_sizes, x_dim}, x_coord, kTensorDimensionLimit);
+
+      size_t in_coord[kTensorDimensionLimit];
+
+      ET_KERNEL_CHECK(
+          ctx,
+          get_in_coord(
+              in, indices, start, bc_ndim, dim_map, ix_map, x_coord, in_coord),
+          InvalidArgument, );
+
+      size_t in_ix = coordinateToIndex(in, in_coord);
+
+      // Broadcast values
+      size_t val_ix = linearize_access_indexes(x_coord, x_dim, values);
+      if (accumulate) {
+        out_data[in_ix] += values_data[val_ix];
+      } else {
+        out_data[in_ix] = values_data[val_ix];
+      }
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
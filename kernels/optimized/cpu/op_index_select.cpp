@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+Tensor& opt_index_select_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out) {
+  // Also checks that every index is in range, so the gather below does not.
+  ET_KERNEL_CHECK(
+      ctx, check_index_select_args(in, dim, index, out), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  size_t expected_ndim = 0;
+  Tensor::SizesType expected_size[kTensorDimensionLimit];
+  get_index_select_out_target_size(
+      in, dim, index, expected_size, &expected_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_size, expected_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (in.dim() == 0) {
+    memcpy(out.mutable_data_ptr(), in.const_data_ptr(), in.nbytes());
+    return out;
+  }
+
+  const size_t leading_dims = getLeadingDims(in, dim);
+  const size_t trailing_dims = getTrailingDims(in, dim);
+  if (leading_dims == 0 || trailing_dims == 0) {
+    return out;
+  }
+
+  // Every leading index selects from its own slice of in.size(dim) rows of
+  // trailing_dims elements.
+  const size_t row_bytes = trailing_dims * in.element_size();
+  const char* in_data = in.const_data_ptr<char>();
+  char* out_data = out.mutable_data_ptr<char>();
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, index.scalar_type(), ctx, "index_select.out", CTYPE, [&]() {
+        internal::gather_rows(
+            in_data,
+            in.size(dim),
+            index.const_data_ptr<CTYPE>(),
+            out.size(dim),
+            leading_dims,
+            row_bytes,
+            out_data);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
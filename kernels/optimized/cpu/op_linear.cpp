@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/gemm_utils.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// Applies a linear transformation out = in @ weight^T + bias, where in is
+// (*, in_features), weight is (out_features, in_features) and bias, if
+// present, is (out_features). The weight is read in place as the transposed
+// right-hand side of a single GEMM over all leading dims of in.
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+bool is_contiguous(const Tensor& t) {
+  return is_contiguous_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+bool check_linear_args(
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 2));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      in.dim() >= 1, "in.dim() %zd < 1", ssize_t(in.dim()));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(out, in.dim()));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, weight, out));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_size_at_dims(in, in.dim() - 1, weight, 1));
+
+  if (bias.has_value()) {
+    const Tensor& b = bias.value();
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, b));
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(b, 1));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensors_have_same_size_at_dims(b, 0, weight, 0));
+  }
+
+  // Leading dims are flattened into the rows of one matrix, which needs a
+  // row-major layout. 2-D inputs and outputs may also be stored transposed.
+  if (in.dim() != 2) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        is_contiguous(in) && is_contiguous(out),
+        "in and out must use the default dim order when in.dim() != 2");
+  }
+
+  return true;
+}
+
+void get_linear_out_target_size(
+    const Tensor& in,
+    const Tensor& weight,
+    exec_aten::SizesType* out_sizes,
+    size_t* out_ndim) {
+  *out_ndim = in.dim();
+  for (size_t d = 0; d < in.dim() - 1; ++d) {
+    out_sizes[d] = in.size(d);
+  }
+  out_sizes[in.dim() - 1] = weight.size(0);
+}
+
+template <typename CTYPE>
+void linear_kernel(
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    Tensor& out) {
+  const int64_t in_features = weight.size(1);
+  const int64_t out_features = weight.size(0);
+
+  MatrixRef<const CTYPE> in_mat;
+  MatrixRef<CTYPE> out_mat;
+  if (in.dim() == 2) {
+    in_mat = make_matrix_ref<CTYPE>(in);
+    out_mat = make_mutable_matrix_ref<CTYPE>(out);
+  } else {
+    // out.numel() > 0, so out_features > 0.
+    const int64_t rows = out.numel() / out_features;
+    in_mat = {in.const_data_ptr<CTYPE>(), rows, in_features, true};
+    out_mat = {out.mutable_data_ptr<CTYPE>(), rows, out_features, true};
+  }
+
+  // Seed the output with the bias and accumulate the product onto it.
+  if (bias.has_value()) {
+    const CTYPE* const bias_data = bias.value().const_data_ptr<CTYPE>();
+    const int64_t row_stride = out_mat.row_major ? out_features : 1;
+    const int64_t col_stride = out_mat.row_major ? 1 : out_mat.rows;
+    for (int64_t i = 0; i < out_mat.rows; ++i) {
+      for (int64_t j = 0; j < out_features; ++j) {
+        out_mat.data[i * row_stride + j * col_stride] = bias_data[j];
+      }
+    }
+  }
+
+  gemm_2d<CTYPE>(
+      in_mat,
+      /*transpose_a=*/false,
+      make_matrix_ref<CTYPE>(weight),
+      /*transpose_b=*/true,
+      static_cast<CTYPE>(1),
+      static_cast<CTYPE>(bias.has_value() ? 1 : 0),
+      out_mat);
+}
+
+} // namespace
+
+// linear.out(Tensor input, Tensor weight, Tensor? bias=None, *,
+//     Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_linear_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_linear_args(in, weight, bias, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_linear_out_target_size(in, weight, output_sizes, &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ET_SWITCH_REAL_TYPES_AND(
+      Half, in.scalar_type(), ctx, "linear.out", CTYPE, [&]() {
+        linear_kernel<CTYPE>(in, weight, bias, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
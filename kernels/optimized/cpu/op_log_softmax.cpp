@@ -14,6 +14,7 @@
 #include <cmath>
 #include <type_traits>
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -49,6 +50,13 @@ void log_softmax_kernel(const Tensor& input, int64_t dim, Tensor& out) {
     inner_size *= input.size(i);
   }
 
+#ifndef __aarch64__
+  static_assert(
+      std::is_same<IN_T, float>::value && std::is_same<OUT_T, float>::value,
+      "log_softmax_stub only handles float");
+  log_softmax_stub(
+      input_data_base, output_data_base, outer_size, dim_size, inner_size);
+#else
   int64_t dim_stride = inner_size;
   int64_t outer_stride = dim_size * dim_stride;
 
@@ -66,13 +74,6 @@ void log_softmax_kernel(const Tensor& input, int64_t dim, Tensor& out) {
       }
       // calculate sum and exponential in softmax dim
       OUT_T temp_sum = 0;
-#ifndef __aarch64__
-      for (auto d = 0; d < dim_size; ++d) {
-        output_data[d * dim_stride] =
-            std::exp(input_data[d * dim_stride] - max_input);
-        temp_sum += output_data[d * dim_stride];
-      }
-#else
       auto d = 0;
       for (; d + 4 < dim_size; d += 4) {
         auto index = d * dim_stride;
@@ -89,7 +90,6 @@ void log_softmax_kernel(const Tensor& input, int64_t dim, Tensor& out) {
             std::exp(input_data[d * dim_stride] - max_input);
         temp_sum += output_data[d * dim_stride];
       }
-#endif // __aarch64__
 
       temp_sum = std::log(temp_sum);
 
@@ -99,6 +99,7 @@ void log_softmax_kernel(const Tensor& input, int64_t dim, Tensor& out) {
       }
     }
   }
+#endif // __aarch64__
 }
 
 // OUT_T is the corresponding C++ type for out.scalar_type(). Only takes float
@@ -122,6 +123,8 @@ void log_softmax_wrapper(const Tensor& X, int64_t dim, Tensor& out) {
 }
 } // namespace
 
+ET_DEFINE_DISPATCH(log_softmax_stub);
+
 // _log_softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
 // -> Tensor(a!)
 Tensor& opt_log_softmax_out(
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/pool_utils.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+/**
+ * max_pool2d_with_indices without the indices, which
+ * exir/passes/drop_max_pool_indices_pass.py calls when they are unused. The
+ * vectorized loops then skip tracking which tap holds each max.
+ *
+ * max_pool2d.out(Tensor self, int[2] kernel_size, int[2] stride=[], int[2]
+ *     padding=0, int[2] dilation=1, bool ceil_mode=False, *, Tensor(a!) out)
+ *     -> Tensor(a!)
+ */
+Tensor& opt_max_pool2d_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_max_pool2d_args(
+          in, kernel_size, stride, padding, dilation, ceil_mode, out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_max_pool2d_with_indices_out_target_size(
+      in,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      ceil_mode,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const Pool2dShape shape =
+      get_pool2d_shape(in, out, kernel_size, stride, padding, dilation);
+
+  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "max_pool2d.out", CTYPE, [&]() {
+    max_pool2d<CTYPE, /*kWithIndices=*/false>(
+        shape,
+        in.const_data_ptr<CTYPE>(),
+        out.mutable_data_ptr<CTYPE>(),
+        /*indices=*/nullptr);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -34,8 +35,6 @@ bool can_use_optimized_path(
   bool can_use_optimized_path = true;
   can_use_optimized_path =
       can_use_optimized_path && ((a_type == b_type) && (a_type == out_type));
-  can_use_optimized_path = can_use_optimized_path &&
-      (a_type != ScalarType::Half && b_type != ScalarType::Half);
   can_use_optimized_path = can_use_optimized_path &&
       (a.sizes().equals(b.sizes()) ||
        (a.numel() == b.numel() && a.numel() == out.numel()));
@@ -87,6 +86,8 @@ struct MulInner<false, CTYPE_A, CTYPE_B, CTYPE_IN, CTYPE_OUT>
     : public ReportCanCastBug {};
 } // namespace
 
+ET_DEFINE_DISPATCH(mul_stub);
+
 Tensor& opt_mul_out(
     RuntimeContext& ctx,
     const Tensor& a,
@@ -108,15 +109,18 @@ Tensor& opt_mul_out(
         out,
         "Failed to resize output tensor.");
 
-    ET_SWITCH_REALB_TYPES(out_type, ctx, "mul.out", CTYPE, [&]() {
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [](Vec x, Vec y) { return x * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
-    });
+    ET_KERNEL_CHECK(
+        ctx,
+        isRealHBType(out_type) || out_type == ScalarType::BFloat16,
+        InvalidArgument,
+        out);
+
+    mul_stub(
+        out_type,
+        out.mutable_data_ptr(),
+        a.const_data_ptr(),
+        b.const_data_ptr(),
+        out.numel());
   } else {
     ScalarType common_type =
         promoteTypes(a_type, b_type, /*half_to_float*/ true);
@@ -7,19 +7,19 @@
  */
 
 #include <executorch/runtime/kernel/kernel_includes.h>
-#include <cmath>
+#include <algorithm>
 #include <tuple>
 
-#include <executorch/kernels/optimized/cpu/moments_utils.h>
-#include <executorch/kernels/optimized/vec/functional.h>
-#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 
 namespace torch {
 namespace executor {
 namespace native {
 
 using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
 
 namespace {
 
@@ -29,12 +29,10 @@ void layer_norm(
     IntArrayRef normalized_shape,
     const optional<Tensor>& weight,
     const optional<Tensor>& bias,
-    CTYPE eps,
+    double eps,
     Tensor& out,
     Tensor& mean,
     Tensor& rstd) {
-  using Vec = executorch::vec::Vectorized<CTYPE>;
-
   const size_t dim = input.dim() - normalized_shape.size();
   const size_t dim_size = input.size(dim);
 
@@ -45,72 +43,41 @@ void layer_norm(
     return;
   }
 
+  const ScalarType dtype = input.scalar_type();
+  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* gamma_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* beta_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
   CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
   CTYPE* mean_data = mean.mutable_data_ptr<CTYPE>();
   CTYPE* rstd_data = rstd.mutable_data_ptr<CTYPE>();
 
-  if (N == 0) {
-    for (int i = 0; i < M; ++i) {
-      mean_data[i] = static_cast<CTYPE>(0);
-      rstd_data[i] = static_cast<CTYPE>(NAN);
-    }
-    return;
-  }
-
-  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
-  const CTYPE* gamma_data;
-  if (weight.has_value()) {
-    gamma_data = weight.value().const_data_ptr<CTYPE>();
-  } else {
-    gamma_data = nullptr;
-  }
-  const CTYPE* beta_data;
-  if (bias.has_value()) {
-    beta_data = bias.value().const_data_ptr<CTYPE>();
-  } else {
-    beta_data = nullptr;
-  }
-
-  const bool gamma_null = gamma_data == nullptr;
-  const bool beta_null = beta_data == nullptr;
-
-  for (size_t i = 0; i < M; ++i) {
-    const CTYPE* src_ptr = input_data + i * N;
-    CTYPE* dst_ptr = out_data + i * N;
-
-    CTYPE mean_val;
-    CTYPE rstd_val;
-    std::tie(mean_val, rstd_val) = RowwiseMoments(src_ptr, N);
-    rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
-
-    const CTYPE scale = rstd_val;
-    const CTYPE offset = -rstd_val * mean_val;
-
-    if (gamma_null || beta_null) {
-      for (size_t j = 0; j < N; ++j) {
-        const CTYPE gamma_v = gamma_null ? CTYPE(1) : gamma_data[j];
-        const CTYPE beta_v = beta_null ? CTYPE(0) : beta_data[j];
-        dst_ptr[j] = (src_ptr[j] * scale + offset) * gamma_v + beta_v;
-      }
-    } else {
-      executorch::vec::map3<CTYPE>(
-          [scale, offset](Vec x, Vec gamma, Vec beta) {
-            return (x * Vec(scale) + Vec(offset)) * gamma + beta;
-          },
-          dst_ptr,
-          src_ptr,
-          gamma_data,
-          beta_data,
-          N);
-    }
-
-    mean_data[i] = mean_val;
-    rstd_data[i] = rstd_val;
-  }
+  // Rows are normalized independently, so split them across threads.
+  const int64_t N_int = static_cast<int64_t>(N);
+  elementwise_parallel_for(
+      M,
+      [&](int64_t begin, int64_t end) {
+        layer_norm_stub(
+            dtype,
+            input_data + begin * N_int,
+            gamma_data,
+            beta_data,
+            eps,
+            end - begin,
+            N_int,
+            out_data + begin * N_int,
+            mean_data + begin,
+            rstd_data + begin);
+      },
+      std::max<int64_t>(
+          1, kElementwiseGrainSize / std::max<int64_t>(1, N_int)));
 }
 
 } // namespace
 
+ET_DEFINE_DISPATCH(layer_norm_stub);
+
 std::tuple<Tensor&, Tensor&, Tensor&> opt_native_layer_norm_out(
     RuntimeContext& ctx,
     const Tensor& input,
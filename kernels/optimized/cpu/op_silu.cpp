@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/activation_utils.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// Applies the Sigmoid Linear Unit, out = in * sigmoid(in), in one pass over
+// the data instead of the separate sigmoid and mul kernels that the
+// decomposed form would run.
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+// silu.out(Tensor self, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_silu_out(RuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  ET_KERNEL_CHECK(ctx, tensors_have_same_dtype(in, out), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, tensor_is_floating_type(in), InvalidArgument, out);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, "silu.out", CTYPE, [&]() {
+    activation_map<CTYPE>(
+        [](auto x) {
+          using Vec = decltype(x);
+          return x * (Vec(1) + x.neg().exp()).reciprocal();
+        },
+        out.mutable_data_ptr<CTYPE>(),
+        in.const_data_ptr<CTYPE>(),
+        in.numel());
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/block_copy_utils.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+Tensor& opt_slice_copy_Tensor_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    exec_aten::optional<int64_t> start_val,
+    exec_aten::optional<int64_t> end_val,
+    int64_t step,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_slice_copy_args(in, dim, step, out), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  // If user do not set value to end_val, set end to in.size(dim) (largest
+  // value available)
+  int64_t end = end_val.has_value() ? end_val.value() : in.size(dim);
+  // If user do not set value to start_val, set start to 0 (smallest value
+  // available)
+  int64_t start = start_val.has_value() ? start_val.value() : 0;
+
+  int64_t num_values = adjust_slice_indices(in.size(dim), &start, &end, step);
+
+  Tensor::SizesType target_sizes[kTensorDimensionLimit];
+  size_t target_ndim = 0;
+  get_slice_copy_out_target_size(
+      in, dim, num_values, target_sizes, &target_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {target_sizes, target_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const size_t dim_length = in.size(dim);
+  const size_t leading_dims = getLeadingDims(in, dim);
+  const size_t trailing_dims = getTrailingDims(in, dim);
+  if (trailing_dims == 0 || num_values == 0) {
+    return out;
+  }
+
+  const size_t length_per_step = trailing_dims * in.element_size();
+  const char* input_data =
+      in.const_data_ptr<char>() + start * length_per_step;
+  char* dest = out.mutable_data_ptr<char>();
+
+  if (step == 1) {
+    // Every leading index reads one run of num_values rows.
+    internal::copy_blocks(
+        input_data,
+        dim_length * length_per_step,
+        dest,
+        num_values * length_per_step,
+        leading_dims,
+        num_values * length_per_step);
+    return out;
+  }
+
+  for (size_t i = 0; i < leading_dims; ++i) {
+    internal::copy_blocks(
+        input_data + i * dim_length * length_per_step,
+        step * length_per_step,
+        dest + i * num_values * length_per_step,
+        length_per_step,
+        num_values,
+        length_per_step);
+  }
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
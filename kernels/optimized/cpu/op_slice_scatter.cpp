@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdint>
+
+#include <executorch/kernels/optimized/cpu/block_copy_utils.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+/**
+ * Same as the portable slice_scatter.out, but copies whole rows of
+ * trailing elements with memcpy, and skips copying `input` into `out` when
+ * the two are the same tensor, e.g. a KV cache updated in place. The work is
+ * then proportional to the size of `src` instead of `input`.
+ */
+Tensor& opt_slice_scatter_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& src,
+    int64_t dim,
+    exec_aten::optional<int64_t> start_val,
+    exec_aten::optional<int64_t> end_val,
+    int64_t step,
+    Tensor& out) {
+  if (dim < 0) {
+    dim += input.dim();
+  }
+
+  // resize out tensor for dynamic shapes
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (input.numel() == 0) {
+    return out;
+  }
+
+  ET_KERNEL_CHECK(ctx, dim >= 0 && dim < input.dim(), InvalidArgument, out);
+
+  // If user do not set value to end_val, set end to input.size(dim) (largest
+  // value available)
+  int64_t end = end_val.has_value() ? end_val.value() : input.size(dim);
+  // If user do not set value to start_val, set start to 0 (smallest value
+  // available)
+  int64_t start = start_val.has_value() ? start_val.value() : 0;
+
+  ET_KERNEL_CHECK(ctx, step > 0, InvalidArgument, out);
+
+  int64_t num_values =
+      adjust_slice_indices(input.size(dim), &start, &end, step);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_slice_scatter_args(input, src, dim, num_values, step, out),
+      InvalidArgument,
+      out);
+
+  const size_t dim_length = input.size(dim);
+  const size_t leading_dims = getLeadingDims(input, dim);
+  const size_t trailing_dims = getTrailingDims(input, dim);
+
+  // The rows below are read from src by position, so it must hold exactly
+  // one row per written slice.
+  ET_KERNEL_CHECK(
+      ctx,
+      src.numel() == leading_dims * num_values * trailing_dims,
+      InvalidArgument,
+      out);
+
+  if (out.const_data_ptr() != input.const_data_ptr()) {
+    internal::copy_blocks(
+        input.const_data_ptr<char>(),
+        input.nbytes(),
+        out.mutable_data_ptr<char>(),
+        out.nbytes(),
+        1,
+        input.nbytes());
+  }
+
+  if (num_values == 0 || trailing_dims == 0) {
+    return out;
+  }
+
+  ScalarType in_type = input.scalar_type();
+  ScalarType src_type = src.scalar_type();
+
+  if (in_type == src_type) {
+    const size_t row_bytes = trailing_dims * input.element_size();
+    const char* src_data = src.const_data_ptr<char>();
+    char* out_data = out.mutable_data_ptr<char>() + start * row_bytes;
+    if (step == 1) {
+      // Every leading index writes one run of num_values rows.
+      internal::copy_blocks(
+          src_data,
+          num_values * row_bytes,
+          out_data,
+          dim_length * row_bytes,
+          leading_dims,
+          num_values * row_bytes);
+      return out;
+    }
+    for (size_t i = 0; i < leading_dims; ++i) {
+      internal::copy_blocks(
+          src_data + i * num_values * row_bytes,
+          row_bytes,
+          out_data + i * dim_length * row_bytes,
+          step * row_bytes,
+          num_values,
+          row_bytes);
+    }
+    return out;
+  }
+
+  ET_SWITCH_REALHB_TYPES(in_type, ctx, "slice_scatter.out", CTYPE, [&]() {
+    ET_SWITCH_REALHB_TYPES(
+        src_type, ctx, "slice_scatter.out", CTYPE_SRC, [&]() {
+          CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+          const CTYPE_SRC* src_data = src.const_data_ptr<CTYPE_SRC>();
+
+          size_t src_offset = 0;
+
+          for (size_t i = 0; i < leading_dims; i++) {
+            size_t out_offset = (i * dim_length + start) * trailing_dims;
+            for (int64_t j = 0; j < num_values; j++) {
+              for (size_t k = 0; k < trailing_dims; ++k) {
+                out_data[out_offset + k] =
+                    convert<CTYPE, CTYPE_SRC>(src_data[src_offset + k]);
+              }
+              src_offset += trailing_dims;
+              out_offset += step * trailing_dims;
+            }
+          }
+        });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <executorch/kernels/optimized/cpu/activation_utils.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `_softmax_out` Applies the Softmax function to an n-dimensional input Tensor
+// rescaling them so that the elements of the n-dimensional output Tensor lie
+// in the range [0,1] and sum to 1.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// Like std::max(), but propagates NaN from either argument.
+template <typename T>
+T max_propagate_nan(T a, T b) {
+  return (std::isnan(a) || a > b) ? a : b;
+}
+
+/**
+ * Computes softmax over a contiguous row of `size` elements of float or
+ * double, storing the exponentials in `out` and then scaling them in place.
+ */
+template <
+    typename CTYPE,
+    typename std::enable_if<
+        std::is_same<CTYPE, activation_compute_t<CTYPE>>::value,
+        int>::type = 0>
+void softmax_row(const CTYPE* in, CTYPE* out, int64_t size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const CTYPE max_in = executorch::vec::reduce_all<CTYPE>(
+      [](Vec& a, Vec& b) { return executorch::vec::maximum(a, b); },
+      in,
+      size);
+  executorch::vec::map<CTYPE>(
+      [max_in](Vec x) { return (x - Vec(max_in)).exp(); }, out, in, size);
+  const CTYPE sum = executorch::vec::reduce_all<CTYPE>(
+      [](Vec& a, Vec& b) { return a + b; }, out, size);
+  const CTYPE scale = CTYPE(1) / sum;
+  executorch::vec::map<CTYPE>(
+      [scale](Vec x) { return x * Vec(scale); }, out, out, size);
+}
+
+/**
+ * Computes softmax over a contiguous row of a reduced-precision type. The
+ * math runs in float on blocks widened on the stack; the exponentials are
+ * recomputed for the final pass rather than being rounded to `out` and read
+ * back.
+ */
+template <
+    typename CTYPE,
+    typename std::enable_if<
+        !std::is_same<CTYPE, activation_compute_t<CTYPE>>::value,
+        int>::type = 0>
+void softmax_row(const CTYPE* in, CTYPE* out, int64_t size) {
+  using Compute = activation_compute_t<CTYPE>;
+  using Vec = executorch::vec::Vectorized<Compute>;
+
+  Compute block[kActivationBlockSize];
+  Compute max_in = -std::numeric_limits<Compute>::infinity();
+  for (int64_t begin = 0; begin < size; begin += kActivationBlockSize) {
+    const int64_t n = std::min(kActivationBlockSize, size - begin);
+    internal::to_compute_block(in + begin, n, block);
+    max_in = max_propagate_nan(
+        max_in,
+        executorch::vec::reduce_all<Compute>(
+            [](Vec& a, Vec& b) { return executorch::vec::maximum(a, b); },
+            block,
+            n));
+  }
+
+  Compute sum = 0;
+  for (int64_t begin = 0; begin < size; begin += kActivationBlockSize) {
+    const int64_t n = std::min(kActivationBlockSize, size - begin);
+    internal::to_compute_block(in + begin, n, block);
+    sum += executorch::vec::map_reduce_all<Compute>(
+        [max_in](Vec x) { return (x - Vec(max_in)).exp(); },
+        [](Vec& a, Vec& b) { return a + b; },
+        block,
+        n);
+  }
+
+  const Compute scale = Compute(1) / sum;
+  activation_map<CTYPE>(
+      [max_in, scale](Vec x) { return (x - Vec(max_in)).exp() * Vec(scale); },
+      out,
+      in,
+      size);
+}
+
+/**
+ * Computes softmax over `dim_size` elements that are `inner_size` apart, for
+ * `inner_size` adjacent columns at once, vectorizing across the columns.
+ */
+template <
+    typename CTYPE,
+    typename std::enable_if<
+        std::is_same<CTYPE, activation_compute_t<CTYPE>>::value,
+        int>::type = 0>
+void softmax_columns(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t dim_size,
+    int64_t inner_size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  for (int64_t j = 0; j < inner_size; j += Vec::size()) {
+    const int64_t n = std::min<int64_t>(Vec::size(), inner_size - j);
+    const CTYPE* const in_col = in + j;
+    CTYPE* const out_col = out + j;
+
+    Vec max_vec = Vec::loadu(in_col, n);
+    for (int64_t d = 1; d < dim_size; ++d) {
+      max_vec = executorch::vec::maximum(
+          max_vec, Vec::loadu(in_col + d * inner_size, n));
+    }
+    Vec sum_vec(0);
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const Vec e = (Vec::loadu(in_col + d * inner_size, n) - max_vec).exp();
+      e.store(out_col + d * inner_size, n);
+      sum_vec = sum_vec + e;
+    }
+    const Vec scale = sum_vec.reciprocal();
+    for (int64_t d = 0; d < dim_size; ++d) {
+      (Vec::loadu(out_col + d * inner_size, n) * scale)
+          .store(out_col + d * inner_size, n);
+    }
+  }
+}
+
+/**
+ * Computes softmax over `dim_size` elements that are `inner_size` apart, for
+ * `inner_size` adjacent columns of a reduced-precision type, in float.
+ */
+template <
+    typename CTYPE,
+    typename std::enable_if<
+        !std::is_same<CTYPE, activation_compute_t<CTYPE>>::value,
+        int>::type = 0>
+void softmax_columns(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t dim_size,
+    int64_t inner_size) {
+  using Compute = activation_compute_t<CTYPE>;
+  using Cast = ActivationCompute<CTYPE>;
+
+  for (int64_t j = 0; j < inner_size; ++j) {
+    Compute max_in = Cast::to_compute(in[j]);
+    for (int64_t d = 1; d < dim_size; ++d) {
+      max_in =
+          max_propagate_nan(max_in, Cast::to_compute(in[d * inner_size + j]));
+    }
+    Compute sum = 0;
+    for (int64_t d = 0; d < dim_size; ++d) {
+      sum += std::exp(Cast::to_compute(in[d * inner_size + j]) - max_in);
+    }
+    const Compute scale = Compute(1) / sum;
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const int64_t i = d * inner_size + j;
+      out[i] = Cast::from_compute(
+          std::exp(Cast::to_compute(in[i]) - max_in) * scale);
+    }
+  }
+}
+
+template <typename CTYPE>
+void softmax_kernel(const Tensor& in, int64_t dim, Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  if (in.dim() == 0) {
+    out_data[0] = ActivationCompute<CTYPE>::from_compute(1);
+    return;
+  }
+
+  const int64_t dim_size = in.size(dim);
+  int64_t outer_size = 1;
+  int64_t inner_size = 1;
+  for (int64_t i = 0; i < dim; ++i) {
+    outer_size *= in.size(i);
+  }
+  for (int64_t i = dim + 1; i < in.dim(); ++i) {
+    inner_size *= in.size(i);
+  }
+  const int64_t outer_stride = dim_size * inner_size;
+
+  for (int64_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
+    const CTYPE* const in_outer = in_data + outer_idx * outer_stride;
+    CTYPE* const out_outer = out_data + outer_idx * outer_stride;
+    if (inner_size == 1) {
+      softmax_row<CTYPE>(in_outer, out_outer, dim_size);
+    } else {
+      softmax_columns<CTYPE>(in_outer, out_outer, dim_size, inner_size);
+    }
+  }
+}
+
+/**
+ * Computes softmax through the strides of `in` and `out`, for any dim order.
+ */
+template <typename CTYPE>
+void softmax_strided(const Tensor& in, int64_t dim, Tensor& out) {
+  using Compute = activation_compute_t<CTYPE>;
+  using Cast = ActivationCompute<CTYPE>;
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  const int64_t dim_size = in.size(dim);
+  const int64_t in_dim_stride = in.strides()[dim];
+  const int64_t out_dim_stride = out.strides()[dim];
+  const int64_t num_lines = in.numel() / dim_size;
+
+  // Walk the index of every line along `dim`, with `dim` itself fixed at 0.
+  int64_t index[kTensorDimensionLimit] = {0};
+  for (int64_t line = 0; line < num_lines; ++line) {
+    int64_t in_offset = 0;
+    int64_t out_offset = 0;
+    for (int64_t i = 0; i < in.dim(); ++i) {
+      in_offset += index[i] * in.strides()[i];
+      out_offset += index[i] * out.strides()[i];
+    }
+    const CTYPE* const in_line = in_data + in_offset;
+    CTYPE* const out_line = out_data + out_offset;
+
+    Compute max_in = Cast::to_compute(in_line[0]);
+    for (int64_t d = 1; d < dim_size; ++d) {
+      max_in = max_propagate_nan(
+          max_in, Cast::to_compute(in_line[d * in_dim_stride]));
+    }
+    Compute sum = 0;
+    for (int64_t d = 0; d < dim_size; ++d) {
+      sum += std::exp(Cast::to_compute(in_line[d * in_dim_stride]) - max_in);
+    }
+    const Compute scale = Compute(1) / sum;
+    for (int64_t d = 0; d < dim_size; ++d) {
+      out_line[d * out_dim_stride] = Cast::from_compute(
+          std::exp(Cast::to_compute(in_line[d * in_dim_stride]) - max_in) *
+          scale);
+    }
+
+    // Advance to the next line, skipping `dim`.
+    for (int64_t i = in.dim() - 1; i >= 0; --i) {
+      if (i == dim) {
+        continue;
+      }
+      if (++index[i] < in.size(i)) {
+        break;
+      }
+      index[i] = 0;
+    }
+  }
+}
+
+bool is_contiguous(const Tensor& t) {
+  return is_contiguous_dim_order(t.dim_order().data(), t.dim_order().size());
+}
+
+} // namespace
+
+// _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_softmax_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_softmax_args(in, dim, half_to_float, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  // Adjust for negative dim
+  dim = dim < 0 ? dim + nonzero_dim(in) : dim;
+
+  const bool contiguous = is_contiguous(in) && is_contiguous(out);
+  ET_SWITCH_FLOATHBF16_TYPES(
+      in.scalar_type(), ctx, "_softmax.out", CTYPE, [&]() {
+        if (contiguous || in.dim() == 0) {
+          softmax_kernel<CTYPE>(in, dim, out);
+        } else {
+          softmax_strided<CTYPE>(in, dim, out);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
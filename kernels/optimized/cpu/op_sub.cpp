@@ -82,10 +82,13 @@ Tensor& opt_sub_out(
   ScalarType b_type = b.scalar_type();
   ScalarType out_type = out.scalar_type();
 
-  ET_KERNEL_CHECK(ctx, tensor_is_realh_type(out), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      tensor_is_realh_type(out) || out_type == ScalarType::BFloat16,
+      InvalidArgument,
+      out);
 
-  if (a_type == b_type && a_type == out_type && a.sizes().equals(b.sizes()) &&
-      a_type != ScalarType::Half) {
+  if (a_type == b_type && a_type == out_type && a.sizes().equals(b.sizes())) {
     // Resize for dynamic shape
     auto error = resize_tensor(out, a.sizes());
     ET_KERNEL_CHECK_MSG(
@@ -95,6 +98,32 @@ Tensor& opt_sub_out(
         out,
         "Failed to resize output tensor.");
 
+    if (out_type == ScalarType::Half || out_type == ScalarType::BFloat16) {
+      // 16-bit floats are subtracted in float and rounded once, as in the
+      // portable kernel, so alpha stays a float.
+      float alpha_val;
+      ET_KERNEL_CHECK(
+          ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, out);
+
+      ET_SWITCH_TWO_TYPES(
+          Half, BFloat16, out_type, ctx, "sub.out", CTYPE, [&]() {
+            using Vec = executorch::vec::Vectorized<CTYPE>;
+            using FloatVec = executorch::vec::Vectorized<float>;
+            executorch::vec::map2<CTYPE>(
+                [alpha_val](Vec x, Vec y) {
+                  return executorch::vec::binary_op_as_float(
+                      x, y, [alpha_val](FloatVec fx, FloatVec fy) {
+                        return fx - FloatVec(alpha_val) * fy;
+                      });
+                },
+                out.mutable_data_ptr<CTYPE>(),
+                a.const_data_ptr<CTYPE>(),
+                b.const_data_ptr<CTYPE>(),
+                out.numel());
+          });
+      return out;
+    }
+
     ET_SWITCH_REAL_TYPES(out_type, ctx, "sub.out", CTYPE, [&]() {
       CTYPE alpha_val;
       ET_KERNEL_CHECK(
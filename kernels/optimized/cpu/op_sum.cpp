@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/reduce_utils.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+Tensor& opt_sum_dim_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    optional<ArrayRef<int64_t>> dim_list,
+    bool keepdim,
+    optional<ScalarType> dtype,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_reduction_args(in, dim_list, keepdim, dtype, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim_list, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "sum.IntList_out";
+
+  ReductionShape shape;
+  if (in.scalar_type() == out.scalar_type() && isRealType(in.scalar_type()) &&
+      get_reduction_shape(in, dim_list, shape)) {
+    ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, name, CTYPE, [&] {
+      reduce_sum<CTYPE>(
+          in.const_data_ptr<CTYPE>(), shape, out.mutable_data_ptr<CTYPE>());
+    });
+    return out;
+  }
+
+  const int64_t grain_size =
+      reduction_grain_size(get_reduced_dim_product(in, dim_list));
+  ET_SWITCH_REAL_TYPES_AND(Bool, in.scalar_type(), ctx, name, CTYPE_IN, [&] {
+    ET_SWITCH_REAL_TYPES_AND(
+        Bool, out.scalar_type(), ctx, name, CTYPE_OUT, [&] {
+          CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+          elementwise_parallel_for(
+              out.numel(),
+              [&](int64_t begin, int64_t end) {
+                for (int64_t out_ix = begin; out_ix < end; ++out_ix) {
+                  CTYPE_OUT sum = 0;
+                  if (in.numel() > 0) {
+                    sum = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
+                        [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
+                        [](CTYPE_OUT outv, CTYPE_OUT acc) {
+                          return acc + outv;
+                        },
+                        in,
+                        dim_list,
+                        out_ix);
+                  }
+                  out_data[out_ix] = sum;
+                }
+              },
+              grain_size);
+        });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
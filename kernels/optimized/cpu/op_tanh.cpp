@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/activation_utils.h>
+#include <executorch/kernels/portable/cpu/pattern/pattern.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+Tensor& opt_tanh_out(RuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  ScalarType in_type = in.scalar_type();
+
+  // Fast path: no dtype conversion, so the math can be vectorized.
+  if (in_type == out.scalar_type() && isFloatingType(in_type)) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        resize_tensor(out, in.sizes()) == Error::Ok,
+        InvalidArgument,
+        out,
+        "Failed to resize output tensor.");
+
+    ET_SWITCH_FLOATHBF16_TYPES(in_type, ctx, "tanh.out", CTYPE, [&]() {
+      activation_map<CTYPE>(
+          [](auto x) { return x.tanh(); },
+          out.mutable_data_ptr<CTYPE>(),
+          in.const_data_ptr<CTYPE>(),
+          in.numel());
+    });
+    return out;
+  }
+
+  return internal::unary_ufunc_realhb_to_floath(std::tanh, ctx, in, out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/util/topk_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// Rows that select at most this many elements keep their heap on the stack
+// and pre-filter the input with Vectorized compares; larger selections use
+// nth_element on a scratch array of indices.
+constexpr int64_t kSmallTopk = 64;
+
+// The most row ranges that run in parallel, which bounds the scratch memory
+// of the nth_element path to this many rows of indices.
+constexpr int64_t kMaxTopkSlices = 64;
+
+template <typename CTYPE>
+using TopkVectorizable = std::integral_constant<
+    bool,
+    std::is_same<CTYPE, float>::value || std::is_same<CTYPE, double>::value>;
+
+template <typename CTYPE>
+void push_row(
+    TopkHeap<CTYPE>& heap,
+    const CTYPE* in,
+    const int64_t begin,
+    const int64_t end,
+    const int64_t stride) {
+  for (int64_t i = begin; i < end; ++i) {
+    heap.push(in[i * stride], i);
+  }
+}
+
+template <typename CTYPE>
+void push_row_filtered(
+    TopkHeap<CTYPE>& heap,
+    const CTYPE* in,
+    const int64_t begin,
+    const int64_t end,
+    const bool,
+    std::false_type) {
+  push_row(heap, in, begin, end, 1);
+}
+
+/**
+ * Pushes contiguous elements [begin, end) into a full heap, skipping whole
+ * vectors in which no element beats the heap's worst value. Once the heap
+ * holds good candidates almost every vector is skipped, so the heap is only
+ * touched for the few elements that might enter it.
+ */
+template <typename CTYPE>
+void push_row_filtered(
+    TopkHeap<CTYPE>& heap,
+    const CTYPE* in,
+    int64_t begin,
+    const int64_t end,
+    const bool largest,
+    std::true_type) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  constexpr int kAllLanes = (1 << Vec::size()) - 1;
+  for (; begin + Vec::size() <= end; begin += Vec::size()) {
+    const CTYPE worst = heap.worst_value();
+    const Vec v = Vec::loadu(in + begin);
+    // A NaN worst value only happens for inputs full of NaN; push those one
+    // at a time rather than special-casing the compares.
+    if (!std::isnan(worst)) {
+      // Equal values never enter, since they come later in the row. NaN is
+      // greater than every number, so only enters when selecting the largest.
+      const Vec candidates =
+          largest ? (v > Vec(worst)) | v.isnan() : v < Vec(worst);
+      if (candidates.zero_mask() == kAllLanes) {
+        continue;
+      }
+    }
+    push_row(heap, in, begin, begin + Vec::size(), 1);
+  }
+  push_row(heap, in, begin, end, 1);
+}
+
+/**
+ * Selects with a heap on the stack. Fills it with the first k elements of the
+ * row, then pre-filters the rest when the row is contiguous.
+ */
+template <typename CTYPE>
+void topk_small_row(
+    const CTYPE* in,
+    const TopkRows& rows,
+    const int64_t k,
+    const bool largest,
+    CTYPE* values,
+    int64_t* indices) {
+  CTYPE heap_values[kSmallTopk];
+  int64_t heap_indices[kSmallTopk];
+  TopkHeap<CTYPE> heap(heap_values, heap_indices, 1, k, largest);
+  push_row(heap, in, 0, k, rows.stride);
+  if (rows.stride == 1) {
+    push_row_filtered(
+        heap, in, k, rows.size, largest, TopkVectorizable<CTYPE>());
+  } else {
+    push_row(heap, in, k, rows.size, rows.stride);
+  }
+  heap.sort();
+  for (int64_t i = 0; i < k; ++i) {
+    values[i * rows.stride] = heap_values[i];
+    indices[i * rows.stride] = heap_indices[i];
+  }
+}
+
+/**
+ * Selects with nth_element over the row's indices in `scratch`, which has
+ * room for rows.size of them, then sorts the selected ones.
+ */
+template <typename CTYPE>
+void topk_large_row(
+    const CTYPE* in,
+    const TopkRows& rows,
+    const int64_t k,
+    const bool largest,
+    CTYPE* values,
+    int64_t* indices,
+    int64_t* scratch) {
+  const auto before = [&](const int64_t a, const int64_t b) {
+    return topk_before(
+        in[a * rows.stride], a, in[b * rows.stride], b, largest);
+  };
+  std::iota(scratch, scratch + rows.size, int64_t(0));
+  if (k < rows.size) {
+    std::nth_element(scratch, scratch + k, scratch + rows.size, before);
+  }
+  std::sort(scratch, scratch + k, before);
+  for (int64_t i = 0; i < k; ++i) {
+    values[i * rows.stride] = in[scratch[i] * rows.stride];
+    indices[i * rows.stride] = scratch[i];
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> opt_topk_values(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted,
+    Tensor& values,
+    Tensor& indices) {
+  (void)sorted;
+  std::tuple<Tensor&, Tensor&> out(values, indices);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_topk_args(in, k, dim, values, indices),
+      InvalidArgument,
+      out);
+
+  Tensor::SizesType target_size[kTensorDimensionLimit];
+  size_t target_dim = 0;
+  get_topk_out_target_size(in, k, dim, target_size, &target_dim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(values, {target_size, target_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {target_size, target_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const TopkRows rows = get_topk_rows(in, dim);
+  if (k == 0 || rows.count == 0) {
+    return out;
+  }
+
+  // Split the rows into ranges of about kElementwiseGrainSize input elements
+  // each, so that short rows are not dispatched one at a time.
+  const int64_t num_slices = std::min(
+      {rows.count,
+       kMaxTopkSlices,
+       std::max<int64_t>(1, rows.count * rows.size / kElementwiseGrainSize)});
+
+  // The nth_element path needs a row of indices per slice. Without a temp
+  // allocator it keeps the heap in the outputs, like the portable kernel.
+  int64_t* scratch = nullptr;
+  if (k > kSmallTopk) {
+    Result<void*> temp =
+        ctx.allocate_temp(num_slices * rows.size * sizeof(int64_t));
+    if (temp.ok()) {
+      scratch = static_cast<int64_t*>(temp.get());
+    }
+  }
+
+  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "topk.values", CTYPE, [&]() {
+    const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+    CTYPE* values_data = values.mutable_data_ptr<CTYPE>();
+    int64_t* indices_data = indices.mutable_data_ptr<int64_t>();
+    elementwise_parallel_for(
+        num_slices,
+        [&](const int64_t begin, const int64_t end) {
+          for (int64_t slice = begin; slice < end; ++slice) {
+            const int64_t row_end = rows.count * (slice + 1) / num_slices;
+            for (int64_t row = rows.count * slice / num_slices; row < row_end;
+                 ++row) {
+              const CTYPE* in_row = in_data + rows.offset(row, rows.size);
+              const int64_t out_offset = rows.offset(row, k);
+              if (k <= kSmallTopk) {
+                topk_small_row(
+                    in_row,
+                    rows,
+                    k,
+                    largest,
+                    values_data + out_offset,
+                    indices_data + out_offset);
+              } else if (scratch != nullptr) {
+                topk_large_row(
+                    in_row,
+                    rows,
+                    k,
+                    largest,
+                    values_data + out_offset,
+                    indices_data + out_offset,
+                    scratch + slice * rows.size);
+              } else {
+                topk_row(
+                    in_row,
+                    rows,
+                    k,
+                    largest,
+                    values_data + out_offset,
+                    indices_data + out_offset);
+              }
+            }
+          }
+        },
+        /*grain_size=*/1);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/permute_utils.h>
+#include <executorch/kernels/portable/cpu/util/transpose_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+/**
+ * Swaps dimension 'dim0' of 'a' with 'dim1', and copying
+ * that mutation into `out` in a manner such that the data is densely packed
+ * and is_contiguous() would return true (stride dim[size-1] = 1).
+ *
+ * transpose_copy.int_out(Tensor self, int dim0, int dim1, *, Tensor(a!) out)
+ */
+Tensor& opt_transpose_copy_int_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim0,
+    int64_t dim1,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_transpose_copy_args(in, dim0, dim1, out),
+      InvalidArgument,
+      out);
+
+  if (dim0 < 0) {
+    dim0 += nonzero_dim(in);
+  }
+  if (dim1 < 0) {
+    dim1 += nonzero_dim(in);
+  }
+
+  Tensor::SizesType expected_out_size[kTensorDimensionLimit];
+  size_t expected_out_dim = 0;
+  get_transpose_out_target_size(
+      in, dim0, dim1, expected_out_size, &expected_out_dim);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, expected_out_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  // A transpose is the permutation that swaps dim0 and dim1.
+  int64_t perm[kTensorDimensionLimit];
+  for (size_t i = 0; i < static_cast<size_t>(in.dim()); ++i) {
+    perm[i] = i;
+  }
+  if (in.dim() > 0) {
+    perm[dim0] = dim1;
+    perm[dim1] = dim0;
+  }
+  permute_tensor(in, perm, out);
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using exec_aten::OptionalArrayRef;
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// Output columns whose source indices and weights are computed at once, small
+// enough that the tables and gathered inputs of a tile stay on the stack.
+constexpr int64_t kColumnTile = 128;
+
+// Where the output columns of a tile read the input, and their weights.
+template <typename ACC>
+struct ColumnWeights {
+  int64_t index0[kColumnTile];
+  int64_t index1[kColumnTile];
+  ACC lambda0[kColumnTile];
+  ACC lambda1[kColumnTile];
+};
+
+struct Upsample2dShape {
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  bool align_corners;
+};
+
+// Blends the two input rows of one output row for the `count` columns of a
+// tile: horizontally with the column weights, then vertically with
+// `h0lambda` and `h1lambda`, as the portable kernel does, with the columns in
+// Vectorized lanes.
+template <typename CTYPE, typename ACC>
+void blend_row(
+    const ColumnWeights<ACC>& cols,
+    const int64_t count,
+    const CTYPE* row0,
+    const CTYPE* row1,
+    const ACC h0lambda,
+    const ACC h1lambda,
+    CTYPE* out) {
+  using Vec = executorch::vec::Vectorized<ACC>;
+  ACC top0[kColumnTile];
+  ACC top1[kColumnTile];
+  ACC bottom0[kColumnTile];
+  ACC bottom1[kColumnTile];
+  for (int64_t j = 0; j < count; ++j) {
+    top0[j] = static_cast<ACC>(row0[cols.index0[j]]);
+    top1[j] = static_cast<ACC>(row0[cols.index1[j]]);
+    bottom0[j] = static_cast<ACC>(row1[cols.index0[j]]);
+    bottom1[j] = static_cast<ACC>(row1[cols.index1[j]]);
+  }
+  const Vec h0(h0lambda);
+  const Vec h1(h1lambda);
+  for (int64_t j = 0; j < count; j += Vec::size()) {
+    const int64_t n = std::min<int64_t>(Vec::size(), count - j);
+    const Vec w0 = Vec::loadu(cols.lambda0 + j, n);
+    const Vec w1 = Vec::loadu(cols.lambda1 + j, n);
+    const Vec top = w0 * Vec::loadu(top0 + j, n) + w1 * Vec::loadu(top1 + j, n);
+    const Vec bottom =
+        w0 * Vec::loadu(bottom0 + j, n) + w1 * Vec::loadu(bottom1 + j, n);
+    const Vec result = h0 * top + h1 * bottom;
+    if constexpr (std::is_same<CTYPE, ACC>::value) {
+      result.store(out + j, n);
+    } else {
+      ACC blended[Vec::size()];
+      result.store(blended, n);
+      for (int64_t k = 0; k < n; ++k) {
+        out[j + k] = static_cast<CTYPE>(blended[k]);
+      }
+    }
+  }
+}
+
+// Output rows [begin, end) of the batch x channel x out_h rows of `out`. The
+// column weights of a tile are computed once for all of these rows and the
+// row weights once per row, instead of both once per output element.
+template <typename CTYPE, typename ACC>
+void upsample_bilinear2d_rows(
+    const Upsample2dShape& s,
+    const ACC ratio_h,
+    const ACC ratio_w,
+    const CTYPE* in,
+    CTYPE* out,
+    const int64_t begin,
+    const int64_t end) {
+  ColumnWeights<ACC> cols;
+  for (int64_t tile = 0; tile < s.out_w; tile += kColumnTile) {
+    const int64_t count = std::min(kColumnTile, s.out_w - tile);
+    for (int64_t j = 0; j < count; ++j) {
+      compute_source_index_and_lambda<ACC>(
+          cols.index0[j],
+          cols.index1[j],
+          cols.lambda0[j],
+          cols.lambda1[j],
+          ratio_w,
+          tile + j,
+          s.in_w,
+          s.out_w,
+          s.align_corners);
+    }
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t plane = row / s.out_h;
+      const int64_t oh = row % s.out_h;
+      int64_t ih0, ih1;
+      ACC h0lambda, h1lambda;
+      compute_source_index_and_lambda<ACC>(
+          ih0,
+          ih1,
+          h0lambda,
+          h1lambda,
+          ratio_h,
+          oh,
+          s.in_h,
+          s.out_h,
+          s.align_corners);
+      const CTYPE* in_plane = in + plane * s.in_h * s.in_w;
+      blend_row(
+          cols,
+          count,
+          in_plane + ih0 * s.in_w,
+          in_plane + ih1 * s.in_w,
+          h0lambda,
+          h1lambda,
+          out + row * s.out_w + tile);
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Same as the portable upsample_bilinear2d.vec_out, but computes the source
+ * indices and weights of each output column once per tile of columns and
+ * those of each output row once per row instead of once per output element,
+ * blends the gathered inputs with Vectorized, and splits the output rows
+ * across threads.
+ */
+Tensor& opt_upsample_bilinear2d_vec_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const OptionalArrayRef<int64_t> output_size,
+    bool align_corners,
+    const OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_bilinear2d_args(
+          in, output_size, align_corners, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_upsample_2d(in, output_size, scale_factors, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const Upsample2dShape shape{
+      in.size(2), in.size(3), out.size(2), out.size(3), align_corners};
+  const auto scale_h = get_scale_value(scale_factors, 0);
+  const auto scale_w = get_scale_value(scale_factors, 1);
+  const int64_t num_rows = in.size(0) * in.size(1) * shape.out_h;
+
+  ET_SWITCH_FLOATH_TYPES(
+      in.scalar_type(), ctx, "upsample_bilinear2d.vec_out", CTYPE, [&]() {
+        // Blend Half values in float, as ATen does.
+        using ACC = typename std::conditional<
+            std::is_same<CTYPE, double>::value,
+            double,
+            float>::type;
+        const ACC ratio_h = area_pixel_compute_scale<ACC>(
+            shape.in_h, shape.out_h, align_corners, scale_h);
+        const ACC ratio_w = area_pixel_compute_scale<ACC>(
+            shape.in_w, shape.out_w, align_corners, scale_w);
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        elementwise_parallel_for(
+            num_rows,
+            [&](const int64_t begin, const int64_t end) {
+              upsample_bilinear2d_rows<CTYPE, ACC>(
+                  shape, ratio_h, ratio_w, in_data, out_data, begin, end);
+            },
+            std::max<int64_t>(1, kElementwiseGrainSize / (4 * shape.out_w)));
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using exec_aten::OptionalArrayRef;
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// Output columns whose source indices are computed at once, small enough
+// that the table of a tile stays on the stack.
+constexpr int64_t kColumnTile = 256;
+
+struct Nearest2dShape {
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  exec_aten::optional<double> scale_h;
+  exec_aten::optional<double> scale_w;
+};
+
+// Output rows [begin, end) of the batch x channel x out_h rows of `out`. The
+// source column of each output column is computed once per tile for all of
+// these rows. An output row that reads the same input row as the one above
+// it, as every other row of a 2x upsample does, is copied from that row.
+template <typename CTYPE>
+void upsample_nearest2d_rows(
+    const Nearest2dShape& s,
+    const CTYPE* in,
+    CTYPE* out,
+    const int64_t begin,
+    const int64_t end) {
+  if (s.out_w == s.in_w) {
+    // Whole rows of the input.
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t plane = row / s.out_h;
+      const int64_t oh = row % s.out_h;
+      const int64_t ih = nearest_idx(oh, s.in_h, s.out_h, s.scale_h);
+      std::memcpy(
+          out + row * s.out_w,
+          in + (plane * s.in_h + ih) * s.in_w,
+          s.in_w * sizeof(CTYPE));
+    }
+    return;
+  }
+  int64_t index[kColumnTile];
+  for (int64_t tile = 0; tile < s.out_w; tile += kColumnTile) {
+    const int64_t count = std::min(kColumnTile, s.out_w - tile);
+    for (int64_t j = 0; j < count; ++j) {
+      index[j] = nearest_idx(tile + j, s.in_w, s.out_w, s.scale_w);
+    }
+    int64_t prev_ih = -1;
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t plane = row / s.out_h;
+      const int64_t oh = row % s.out_h;
+      const int64_t ih = nearest_idx(oh, s.in_h, s.out_h, s.scale_h);
+      CTYPE* out_row = out + row * s.out_w + tile;
+      if (oh > 0 && row > begin && ih == prev_ih) {
+        std::memcpy(out_row, out_row - s.out_w, count * sizeof(CTYPE));
+        continue;
+      }
+      prev_ih = ih;
+      const CTYPE* in_row = in + (plane * s.in_h + ih) * s.in_w;
+      for (int64_t j = 0; j < count; ++j) {
+        out_row[j] = in_row[index[j]];
+      }
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Same as the portable upsample_nearest2d.vec_out, but computes the source
+ * index of each output column once per tile of columns instead of once per
+ * output element, copies repeated output rows whole, and splits the output
+ * rows across threads.
+ */
+Tensor& opt_upsample_nearest2d_vec_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const OptionalArrayRef<int64_t> output_size,
+    const OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_nearest2d_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_upsample_2d(in, output_size, scale_factors, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const Nearest2dShape shape{
+      in.size(2),
+      in.size(3),
+      out.size(2),
+      out.size(3),
+      get_scale_value(scale_factors, 0),
+      get_scale_value(scale_factors, 1)};
+  const int64_t num_rows = in.size(0) * in.size(1) * shape.out_h;
+
+  ET_SWITCH_REALHB_TYPES(
+      in.scalar_type(), ctx, "upsample_nearest2d.vec_out", CTYPE, [&]() {
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        elementwise_parallel_for(
+            num_rows,
+            [&](const int64_t begin, const int64_t end) {
+              upsample_nearest2d_rows(shape, in_data, out_data, begin, end);
+            },
+            std::max<int64_t>(1, kElementwiseGrainSize / shape.out_w));
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
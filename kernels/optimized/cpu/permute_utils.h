@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Copies a strided view of a tensor into a contiguous output, as done by
+// permute_copy and transpose_copy. The view is first simplified by dropping
+// size-one dims and merging dims that are adjacent in memory, after which
+// most permutations become either a sequence of contiguous rows, which are
+// copied with memcpy, or a batch of 2D transposes, which are done in cache
+// sized tiles so that both the reads and the writes stay local.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+// Side of the square tiles used by the 2D transposes.
+constexpr int64_t kTransposeTileSize = 8;
+// Tiles are grouped into blocks of this many rows and columns so that the
+// source rows touched by one block stay in cache while it is written out.
+constexpr int64_t kTransposeBlockSize = 64;
+
+/**
+ * A strided view in the order of the contiguous output it is copied to.
+ */
+struct StridedView {
+  size_t ndim;
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t in_strides[kTensorDimensionLimit];
+  int64_t out_strides[kTensorDimensionLimit];
+};
+
+/**
+ * Builds the view that reads dim `perm[i]` of `in` as dim i of the output,
+ * dropping size-one dims and merging every dim into the next one when the
+ * pair is contiguous in the input.
+ */
+inline void make_permuted_view(
+    const exec_aten::Tensor& in,
+    const int64_t* perm,
+    StridedView& view) {
+  view.ndim = 0;
+  for (size_t i = 0; i < static_cast<size_t>(in.dim()); ++i) {
+    const int64_t size = in.size(perm[i]);
+    const int64_t stride = in.strides()[perm[i]];
+    if (size == 1) {
+      continue;
+    }
+    if (view.ndim > 0 &&
+        view.in_strides[view.ndim - 1] == stride * size) {
+      view.sizes[view.ndim - 1] *= size;
+      view.in_strides[view.ndim - 1] = stride;
+      continue;
+    }
+    view.sizes[view.ndim] = size;
+    view.in_strides[view.ndim] = stride;
+    ++view.ndim;
+  }
+  int64_t out_stride = 1;
+  for (size_t i = view.ndim; i > 0; --i) {
+    view.out_strides[i - 1] = out_stride;
+    out_stride *= view.sizes[i - 1];
+  }
+}
+
+/**
+ * Walks the dims of a StridedView that are not handled by the inner loops,
+ * tracking the input and output offsets of the current position.
+ */
+class OuterIndex {
+ public:
+  OuterIndex(
+      const StridedView& view,
+      const bool* is_inner,
+      int64_t linear_index)
+      : num_dims_(0), in_offset_(0), out_offset_(0) {
+    for (size_t i = 0; i < view.ndim; ++i) {
+      if (!is_inner[i]) {
+        sizes_[num_dims_] = view.sizes[i];
+        in_strides_[num_dims_] = view.in_strides[i];
+        out_strides_[num_dims_] = view.out_strides[i];
+        ++num_dims_;
+      }
+    }
+    for (size_t i = num_dims_; i > 0; --i) {
+      coordinate_[i - 1] = linear_index % sizes_[i - 1];
+      linear_index /= sizes_[i - 1];
+      in_offset_ += coordinate_[i - 1] * in_strides_[i - 1];
+      out_offset_ += coordinate_[i - 1] * out_strides_[i - 1];
+    }
+  }
+
+  int64_t in_offset() const {
+    return in_offset_;
+  }
+
+  int64_t out_offset() const {
+    return out_offset_;
+  }
+
+  void increment() {
+    for (size_t i = num_dims_; i > 0; --i) {
+      const size_t d = i - 1;
+      ++coordinate_[d];
+      in_offset_ += in_strides_[d];
+      out_offset_ += out_strides_[d];
+      if (coordinate_[d] < sizes_[d]) {
+        return;
+      }
+      in_offset_ -= coordinate_[d] * in_strides_[d];
+      out_offset_ -= coordinate_[d] * out_strides_[d];
+      coordinate_[d] = 0;
+    }
+  }
+
+ private:
+  size_t num_dims_;
+  int64_t in_offset_;
+  int64_t out_offset_;
+  int64_t sizes_[kTensorDimensionLimit];
+  int64_t in_strides_[kTensorDimensionLimit];
+  int64_t out_strides_[kTensorDimensionLimit];
+  int64_t coordinate_[kTensorDimensionLimit];
+};
+
+/**
+ * Writes the transpose of the rows x cols matrix `src`, whose rows are
+ * `ld_src` elements apart, to `dst`, whose rows are `ld_dst` elements apart.
+ */
+template <typename CTYPE>
+void transpose_tiled(
+    const CTYPE* src,
+    int64_t ld_src,
+    int64_t rows,
+    int64_t cols,
+    CTYPE* dst,
+    int64_t ld_dst) {
+  constexpr int64_t kTile = kTransposeTileSize;
+  constexpr int64_t kBlock = kTransposeBlockSize;
+  for (int64_t i0 = 0; i0 < rows; i0 += kBlock) {
+    const int64_t i_end = std::min(i0 + kBlock, rows);
+    for (int64_t j0 = 0; j0 < cols; j0 += kBlock) {
+      const int64_t j_end = std::min(j0 + kBlock, cols);
+      int64_t i = i0;
+      for (; i + kTile <= i_end; i += kTile) {
+        int64_t j = j0;
+        for (; j + kTile <= j_end; j += kTile) {
+          executorch::vec::transpose_mxn<CTYPE, kTile, kTile>(
+              src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst);
+        }
+        for (; j < j_end; ++j) {
+          for (int64_t ii = i; ii < i + kTile; ++ii) {
+            dst[j * ld_dst + ii] = src[ii * ld_src + j];
+          }
+        }
+      }
+      for (; i < i_end; ++i) {
+        for (int64_t j = j0; j < j_end; ++j) {
+          dst[j * ld_dst + i] = src[i * ld_src + j];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Copies `view` of `in_data` into the contiguous `out_data`. CTYPE only
+ * needs to have the element size of the tensor, since values are moved
+ * without being interpreted.
+ */
+template <typename CTYPE>
+void copy_strided_view(
+    const CTYPE* in_data,
+    const StridedView& view,
+    CTYPE* out_data) {
+  const size_t ndim = view.ndim;
+  if (ndim == 0) {
+    out_data[0] = in_data[0];
+    return;
+  }
+
+  bool is_inner[kTensorDimensionLimit] = {false};
+  const size_t last = ndim - 1;
+  is_inner[last] = true;
+  const int64_t row_size = view.sizes[last];
+
+  if (view.in_strides[last] == 1) {
+    // Rows are contiguous in the input: copy them whole.
+    const int64_t num_rows = view.out_strides[0] * view.sizes[0] / row_size;
+    const int64_t grain =
+        std::max<int64_t>(1, kElementwiseGrainSize / row_size);
+    elementwise_parallel_for(
+        num_rows,
+        [&](int64_t begin, int64_t end) {
+          OuterIndex index(view, is_inner, begin);
+          for (int64_t r = begin; r < end; ++r) {
+            std::memcpy(
+                out_data + index.out_offset(),
+                in_data + index.in_offset(),
+                row_size * sizeof(CTYPE));
+            index.increment();
+          }
+        },
+        grain);
+    return;
+  }
+
+  // Look for the output dim that is contiguous in the input. Copying it
+  // along with the last output dim is a 2D transpose.
+  size_t unit_dim = ndim;
+  for (size_t i = 0; i < last; ++i) {
+    if (view.in_strides[i] == 1) {
+      unit_dim = i;
+    }
+  }
+
+  if (unit_dim < ndim) {
+    is_inner[unit_dim] = true;
+    const int64_t cols = view.sizes[unit_dim];
+    const int64_t ld_src = view.in_strides[last];
+    const int64_t ld_dst = view.out_strides[unit_dim];
+    const int64_t num_matrices =
+        view.out_strides[0] * view.sizes[0] / (row_size * cols);
+    const int64_t grain =
+        std::max<int64_t>(1, kElementwiseGrainSize / (row_size * cols));
+    elementwise_parallel_for(
+        num_matrices,
+        [&](int64_t begin, int64_t end) {
+          OuterIndex index(view, is_inner, begin);
+          for (int64_t m = begin; m < end; ++m) {
+            transpose_tiled<CTYPE>(
+                in_data + index.in_offset(),
+                ld_src,
+                row_size,
+                cols,
+                out_data + index.out_offset(),
+                ld_dst);
+            index.increment();
+          }
+        },
+        grain);
+    return;
+  }
+
+  // No dim is contiguous in the input. Gather each output row element by
+  // element.
+  const int64_t num_rows = view.out_strides[0] * view.sizes[0] / row_size;
+  const int64_t in_stride = view.in_strides[last];
+  const int64_t grain = std::max<int64_t>(1, kElementwiseGrainSize / row_size);
+  elementwise_parallel_for(
+      num_rows,
+      [&](int64_t begin, int64_t end) {
+        OuterIndex index(view, is_inner, begin);
+        for (int64_t r = begin; r < end; ++r) {
+          const CTYPE* in_row = in_data + index.in_offset();
+          CTYPE* out_row = out_data + index.out_offset();
+          for (int64_t j = 0; j < row_size; ++j) {
+            out_row[j] = in_row[j * in_stride];
+          }
+          index.increment();
+        }
+      },
+      grain);
+}
+
+} // namespace internal
+
+/**
+ * Copies `in` into the contiguous `out` so that dim i of `out` is dim
+ * `perm[i]` of `in`. `perm` must hold a non-negative permutation of the dims
+ * of `in`, and `out` must already have the permuted sizes.
+ */
+inline void permute_tensor(
+    const exec_aten::Tensor& in,
+    const int64_t* perm,
+    exec_aten::Tensor& out) {
+  if (in.numel() == 0) {
+    return;
+  }
+  internal::StridedView view;
+  internal::make_permuted_view(in, perm, view);
+
+  const void* in_data = in.const_data_ptr();
+  void* out_data = out.mutable_data_ptr();
+  // The copy does not depend on the values, so dispatch on the element size
+  // only. Four byte elements are moved as float to pick up the vectorized
+  // transpose specializations.
+  switch (elementSize(in.scalar_type())) {
+    case 1:
+      internal::copy_strided_view<uint8_t>(
+          static_cast<const uint8_t*>(in_data),
+          view,
+          static_cast<uint8_t*>(out_data));
+      return;
+    case 2:
+      internal::copy_strided_view<uint16_t>(
+          static_cast<const uint16_t*>(in_data),
+          view,
+          static_cast<uint16_t*>(out_data));
+      return;
+    case 4:
+      internal::copy_strided_view<float>(
+          static_cast<const float*>(in_data),
+          view,
+          static_cast<float*>(out_data));
+      return;
+    case 8:
+      internal::copy_strided_view<uint64_t>(
+          static_cast<const uint64_t*>(in_data),
+          view,
+          static_cast<uint64_t*>(out_data));
+      return;
+    default:
+      break;
+  }
+
+  // Element sizes without a matching integer type are copied one element at
+  // a time.
+  const size_t element_size = elementSize(in.scalar_type());
+  const bool is_inner[kTensorDimensionLimit] = {false};
+  internal::OuterIndex index(view, is_inner, 0);
+  const uint8_t* in_bytes = static_cast<const uint8_t*>(in_data);
+  uint8_t* out_bytes = static_cast<uint8_t*>(out_data);
+  for (size_t i = 0; i < static_cast<size_t>(out.numel()); ++i) {
+    std::memcpy(
+        out_bytes + i * element_size,
+        in_bytes + index.in_offset() * element_size,
+        element_size);
+    index.increment();
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * The geometry of a 2-D pooling op over a {C, H, W} or {N, C, H, W} input,
+ * with the defaults of kernel_ops_util applied to the pooling arguments.
+ */
+struct Pool2dShape {
+  int64_t batch;
+  int64_t channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  // Element strides of the N, C, H and W dims; the N stride of a 3-D tensor
+  // is 0.
+  int64_t in_strides[4];
+  int64_t out_strides[4];
+  // Whether the input and output are both contiguous, or both channels last.
+  bool contiguous;
+  bool channels_last;
+};
+
+inline void get_pool2d_strides(const Tensor& t, int64_t* strides) {
+  exec_aten::StridesType t_strides[kTensorDimensionLimit];
+  dim_order_to_stride_nocheck(
+      t.sizes().data(), t.dim_order().data(), t.dim(), t_strides);
+  const size_t offset = t.dim() == 4 ? 1 : 0;
+  strides[0] = t.dim() == 4 ? t_strides[0] : 0;
+  for (size_t i = 0; i < 3; ++i) {
+    strides[i + 1] = t_strides[i + offset];
+  }
+}
+
+inline Pool2dShape get_pool2d_shape(
+    const Tensor& in,
+    const Tensor& out,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const size_t dim = in.dim();
+  Pool2dShape s;
+  s.batch = dim == 4 ? in.size(0) : 1;
+  s.channels = in.size(dim - 3);
+  s.in_h = in.size(dim - 2);
+  s.in_w = in.size(dim - 1);
+  s.out_h = out.size(dim - 2);
+  s.out_w = out.size(dim - 1);
+  s.kernel_h = val_at(kernel_size, 0);
+  s.kernel_w = val_at(kernel_size, 1);
+  s.stride_h = val_at(stride, 0, /*default_value=*/s.kernel_h);
+  s.stride_w = val_at(stride, 1, /*default_value=*/s.kernel_w);
+  s.pad_h = val_at(padding, 0, /*default_value=*/0);
+  s.pad_w = val_at(padding, 1, /*default_value=*/0);
+  s.dilation_h = val_at(dilation, 0, /*default_value=*/1);
+  s.dilation_w = val_at(dilation, 1, /*default_value=*/1);
+  get_pool2d_strides(in, s.in_strides);
+  get_pool2d_strides(out, s.out_strides);
+  s.contiguous =
+      is_contiguous_dim_order(in.dim_order().data(), in.dim()) &&
+      is_contiguous_dim_order(out.dim_order().data(), out.dim());
+  s.channels_last = dim == 4 &&
+      is_channels_last_dim_order(in.dim_order().data(), in.dim()) &&
+      is_channels_last_dim_order(out.dim_order().data(), out.dim());
+  return s;
+}
+
+/**
+ * Sets [*begin, *end) to the taps of a window of `kernel` taps, `dilation`
+ * apart and starting at input position `start`, that fall inside [0, size).
+ * The range is empty if every tap is padding.
+ */
+inline void pool_window_taps(
+    const int64_t start,
+    const int64_t kernel,
+    const int64_t dilation,
+    const int64_t size,
+    int64_t* begin,
+    int64_t* end) {
+  *begin = start >= 0 ? 0 : (-start + dilation - 1) / dilation;
+  *end = start >= size
+      ? 0
+      : std::min(kernel, (size - 1 - start) / dilation + 1);
+  *end = std::max(*begin, *end);
+}
+
+/**
+ * The number of planes or rows that each thread pools at a time, so that a
+ * chunk does about kElementwiseGrainSize window taps.
+ */
+inline int64_t pool2d_grain_size(const int64_t taps_per_item) {
+  return std::max<int64_t>(
+      1, kElementwiseGrainSize / std::max<int64_t>(1, taps_per_item));
+}
+
+// Vectorized<T> paths only run for float and double; the other dtypes use
+// the scalar loops.
+template <typename CTYPE>
+using PoolVectorizable = std::integral_constant<
+    bool,
+    std::is_same<CTYPE, float>::value || std::is_same<CTYPE, double>::value>;
+
+/// Loads `count` <= Vec::size() lanes, zero-filling the rest.
+template <typename Vec, typename CTYPE>
+inline Vec load_lanes(const CTYPE* ptr, const int64_t count) {
+  return count == Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, count);
+}
+
+/**
+ * The taps of one pooling window that fall inside the input: `rows` x `cols`
+ * taps starting at `first`, which is input position (y, x), and `row_step`
+ * and `col_step` elements apart.
+ */
+template <typename CTYPE>
+struct PoolWindow {
+  const CTYPE* first;
+  int64_t rows;
+  int64_t cols;
+  int64_t row_step;
+  int64_t col_step;
+  int64_t y;
+  int64_t x;
+};
+
+/**
+ * Finds the taps of the window of output (out_y, out_x) in the plane that
+ * starts at `plane`, where rows and columns of the input are `row_stride` and
+ * `col_stride` elements apart. Returns false if every tap is padding, in
+ * which case the portable kernels leave the output untouched.
+ */
+template <typename CTYPE>
+inline bool get_pool_window(
+    const Pool2dShape& s,
+    const CTYPE* plane,
+    const int64_t row_stride,
+    const int64_t col_stride,
+    const int64_t out_y,
+    const int64_t out_x,
+    PoolWindow<CTYPE>* window) {
+  const int64_t y0 = out_y * s.stride_h - s.pad_h;
+  const int64_t x0 = out_x * s.stride_w - s.pad_w;
+  int64_t ky_begin = 0, ky_end = 0, kx_begin = 0, kx_end = 0;
+  pool_window_taps(y0, s.kernel_h, s.dilation_h, s.in_h, &ky_begin, &ky_end);
+  pool_window_taps(x0, s.kernel_w, s.dilation_w, s.in_w, &kx_begin, &kx_end);
+  if (ky_begin == ky_end || kx_begin == kx_end) {
+    return false;
+  }
+  window->y = y0 + ky_begin * s.dilation_h;
+  window->x = x0 + kx_begin * s.dilation_w;
+  window->rows = ky_end - ky_begin;
+  window->cols = kx_end - kx_begin;
+  window->row_step = s.dilation_h * row_stride;
+  window->col_step = s.dilation_w * col_stride;
+  window->first = plane + window->y * row_stride + window->x * col_stride;
+  return true;
+}
+
+/**
+ * Max-pools one window. Like the portable kernel, the first tap seeds the
+ * max and later taps replace it only if they are greater, so ties keep the
+ * first tap in row-major order and only a leading NaN propagates. The index
+ * is the tap's position y * in_w + x in its plane.
+ */
+template <typename CTYPE, bool kWithIndices>
+inline void max_pool_window(
+    const PoolWindow<CTYPE>& w,
+    const Pool2dShape& s,
+    CTYPE* out,
+    int64_t* index) {
+  CTYPE accum = w.first[0];
+  int64_t best_row = 0, best_col = 0;
+  for (int64_t r = 0; r < w.rows; ++r) {
+    const CTYPE* row = w.first + r * w.row_step;
+    for (int64_t c = r == 0 ? 1 : 0; c < w.cols; ++c) {
+      const CTYPE v = row[c * w.col_step];
+      if (v > accum) {
+        accum = v;
+        if (kWithIndices) {
+          best_row = r;
+          best_col = c;
+        }
+      }
+    }
+  }
+  *out = accum;
+  if (kWithIndices) {
+    *index = (w.y + best_row * s.dilation_h) * s.in_w + w.x +
+        best_col * s.dilation_w;
+  }
+}
+
+/**
+ * Max-pools `count` lanes of window `w`, whose first taps start at `first`,
+ * with the tie and NaN behavior of max_pool_window(). If kWithIndices, sets
+ * *best_tap to the tap r * w.cols + c holding each lane's max, as a number
+ * in CTYPE, which is exact for windows of fewer than 2^24 taps.
+ */
+template <typename Vec, typename CTYPE, bool kWithIndices>
+inline Vec max_window_lanes(
+    const PoolWindow<CTYPE>& w,
+    const CTYPE* first,
+    const int64_t count,
+    Vec* best_tap) {
+  Vec accum = load_lanes<Vec>(first, count);
+  if (kWithIndices) {
+    *best_tap = Vec(CTYPE(0));
+  }
+  for (int64_t r = 0; r < w.rows; ++r) {
+    const CTYPE* row = first + r * w.row_step;
+    for (int64_t c = r == 0 ? 1 : 0; c < w.cols; ++c) {
+      const Vec v = load_lanes<Vec>(row + c * w.col_step, count);
+      const Vec greater = v > accum;
+      accum = Vec::blendv(accum, v, greater);
+      if (kWithIndices) {
+        *best_tap = Vec::blendv(
+            *best_tap, Vec(static_cast<CTYPE>(r * w.cols + c)), greater);
+      }
+    }
+  }
+  return accum;
+}
+
+/**
+ * Writes the indices of the taps in `best_tap` for `count` lanes, where lane
+ * i pools the window `w` shifted right by i * lane_x_step input columns.
+ */
+template <typename Vec, typename CTYPE>
+inline void store_tap_indices(
+    const PoolWindow<CTYPE>& w,
+    const Pool2dShape& s,
+    const Vec& best_tap,
+    const int64_t count,
+    const int64_t lane_x_step,
+    int64_t* indices) {
+  CTYPE taps[Vec::size()];
+  best_tap.store(taps);
+  for (int64_t i = 0; i < count; ++i) {
+    const int64_t tap = static_cast<int64_t>(taps[i]);
+    indices[i] = (w.y + tap / w.cols * s.dilation_h) * s.in_w + w.x +
+        i * lane_x_step + tap % w.cols * s.dilation_w;
+  }
+}
+
+/**
+ * Max-pools any layout and dtype one output at a time, in parallel over the
+ * batch x channel planes. `indices`, if given, has the layout of `out`.
+ */
+template <typename CTYPE, bool kWithIndices>
+void max_pool2d_planes(
+    const Pool2dShape& s,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t* indices) {
+  elementwise_parallel_for(
+      s.batch * s.channels,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const int64_t n = plane / s.channels;
+          const int64_t c = plane % s.channels;
+          const CTYPE* in_plane =
+              in + n * s.in_strides[0] + c * s.in_strides[1];
+          const int64_t out_offset =
+              n * s.out_strides[0] + c * s.out_strides[1];
+          for (int64_t oy = 0; oy < s.out_h; ++oy) {
+            for (int64_t ox = 0; ox < s.out_w; ++ox) {
+              PoolWindow<CTYPE> w;
+              if (!get_pool_window(
+                      s,
+                      in_plane,
+                      s.in_strides[2],
+                      s.in_strides[3],
+                      oy,
+                      ox,
+                      &w)) {
+                continue;
+              }
+              const int64_t o =
+                  out_offset + oy * s.out_strides[2] + ox * s.out_strides[3];
+              max_pool_window<CTYPE, kWithIndices>(
+                  w, s, out + o, kWithIndices ? indices + o : nullptr);
+            }
+          }
+        }
+      },
+      pool2d_grain_size(s.out_h * s.out_w * s.kernel_h * s.kernel_w));
+}
+
+/**
+ * Max-pools channels-last tensors a pixel at a time, with the channels in
+ * Vectorized lanes, in parallel over batch x output rows.
+ */
+template <typename CTYPE, bool kWithIndices>
+void max_pool2d_channels_last(
+    const Pool2dShape& s,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t* indices) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const int64_t C = s.channels;
+  elementwise_parallel_for(
+      s.batch * s.out_h,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t n = row / s.out_h;
+          const int64_t oy = row % s.out_h;
+          const CTYPE* in_n = in + n * s.in_strides[0];
+          const int64_t out_row = n * s.out_strides[0] + oy * s.out_strides[2];
+          for (int64_t ox = 0; ox < s.out_w; ++ox) {
+            PoolWindow<CTYPE> w;
+            if (!get_pool_window(
+                    s, in_n, s.in_strides[2], s.in_strides[3], oy, ox, &w)) {
+              continue;
+            }
+            const int64_t o = out_row + ox * s.out_strides[3];
+            for (int64_t c = 0; c < C; c += Vec::size()) {
+              const int64_t count = std::min<int64_t>(Vec::size(), C - c);
+              Vec best_tap;
+              max_window_lanes<Vec, CTYPE, kWithIndices>(
+                  w, w.first + c, count, &best_tap)
+                  .store(out + o + c, count);
+              if (kWithIndices) {
+                store_tap_indices(w, s, best_tap, count, 0, indices + o + c);
+              }
+            }
+          }
+        }
+      },
+      pool2d_grain_size(s.out_w * C * s.kernel_h * s.kernel_w));
+}
+
+/**
+ * Max-pools contiguous tensors with a unit width stride, with consecutive
+ * outputs of a row in Vectorized lanes, in parallel over batch x channel
+ * planes. Outputs whose window reaches into the left or right padding use
+ * max_pool_window().
+ */
+template <typename CTYPE, bool kWithIndices>
+void max_pool2d_rows(
+    const Pool2dShape& s,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t* indices) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  // Outputs [ox_begin, ox_end) have every tap of their window in the row.
+  const int64_t ox_begin = std::min(s.out_w, s.pad_w);
+  const int64_t ox_end = std::max(
+      ox_begin,
+      std::min(s.out_w, s.in_w - (s.kernel_w - 1) * s.dilation_w + s.pad_w));
+  elementwise_parallel_for(
+      s.batch * s.channels,
+      [&](const int64_t begin, const int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const CTYPE* in_plane = in + plane * s.in_h * s.in_w;
+          const int64_t out_plane = plane * s.out_h * s.out_w;
+          for (int64_t oy = 0; oy < s.out_h; ++oy) {
+            const int64_t out_row = out_plane + oy * s.out_w;
+            for (int64_t ox = 0; ox < s.out_w; ++ox) {
+              PoolWindow<CTYPE> w;
+              if ((ox >= ox_begin && ox < ox_end) ||
+                  !get_pool_window(s, in_plane, s.in_w, 1, oy, ox, &w)) {
+                continue;
+              }
+              max_pool_window<CTYPE, kWithIndices>(
+                  w,
+                  s,
+                  out + out_row + ox,
+                  kWithIndices ? indices + out_row + ox : nullptr);
+            }
+            PoolWindow<CTYPE> w;
+            if (ox_begin == ox_end ||
+                !get_pool_window(s, in_plane, s.in_w, 1, oy, ox_begin, &w)) {
+              continue;
+            }
+            for (int64_t ox = ox_begin; ox < ox_end; ox += Vec::size()) {
+              const int64_t count = std::min<int64_t>(Vec::size(), ox_end - ox);
+              // Lane i pools the window of output ox + i.
+              PoolWindow<CTYPE> lanes = w;
+              lanes.x += ox - ox_begin;
+              lanes.first += ox - ox_begin;
+              Vec best_tap;
+              max_window_lanes<Vec, CTYPE, kWithIndices>(
+                  lanes, lanes.first, count, &best_tap)
+                  .store(out + out_row + ox, count);
+              if (kWithIndices) {
+                store_tap_indices(
+                    lanes, s, best_tap, count, 1, indices + out_row + ox);
+              }
+            }
+          }
+        }
+      },
+      pool2d_grain_size(s.out_h * s.out_w * s.kernel_h * s.kernel_w));
+}
+
+template <typename CTYPE, bool kWithIndices>
+bool max_pool2d_vectorized(
+    const Pool2dShape&,
+    const CTYPE*,
+    CTYPE*,
+    int64_t*,
+    std::false_type) {
+  return false;
+}
+
+template <typename CTYPE, bool kWithIndices>
+bool max_pool2d_vectorized(
+    const Pool2dShape& s,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t* indices,
+    std::true_type) {
+  if (s.kernel_h * s.kernel_w >= (int64_t(1) << 24)) {
+    return false;
+  }
+  if (s.channels_last) {
+    max_pool2d_channels_last<CTYPE, kWithIndices>(s, in, out, indices);
+    return true;
+  }
+  if (s.contiguous && s.stride_w == 1) {
+    max_pool2d_rows<CTYPE, kWithIndices>(s, in, out, indices);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Max-pools `in` into `out`, and into `indices` if kWithIndices, picking the
+ * fastest loop for the layout and dtype.
+ */
+template <typename CTYPE, bool kWithIndices>
+void max_pool2d(
+    const Pool2dShape& s,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t* indices) {
+  if (!max_pool2d_vectorized<CTYPE, kWithIndices>(
+          s, in, out, indices, PoolVectorizable<CTYPE>())) {
+    max_pool2d_planes<CTYPE, kWithIndices>(s, in, out, indices);
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Vectorized loops for reductions over contiguous tensors. When the reduced
+// dims are adjacent, a reduction can be viewed as collapsing the middle axis
+// of an [outer_size, reduce_size, inner_size] tensor, so that every loop below
+// reads its input in memory order and the outputs are independent of each
+// other.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * A reduction of a contiguous tensor viewed as [outer_size, reduce_size,
+ * inner_size] into a contiguous [outer_size, inner_size] output.
+ */
+struct ReductionShape {
+  int64_t outer_size;
+  int64_t reduce_size;
+  int64_t inner_size;
+};
+
+/**
+ * Returns true and sets `shape` if reducing `in` over `dim_list` can be
+ * expressed as a ReductionShape, i.e. if `in` is contiguous and non-empty and
+ * its reduced dims of size greater than one are adjacent. An empty or missing
+ * `dim_list` reduces over all dims.
+ */
+inline bool get_reduction_shape(
+    const exec_aten::Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    ReductionShape& shape) {
+  if (in.numel() == 0 ||
+      !is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size())) {
+    return false;
+  }
+  const bool reduce_all = !dim_list.has_value() || dim_list.value().empty();
+  int64_t outer_size = 1;
+  int64_t reduce_size = 1;
+  int64_t inner_size = 1;
+  bool seen_reduced = false;
+  for (size_t d = 0; d < in.dim(); ++d) {
+    const int64_t size = in.size(d);
+    if (size == 1) {
+      continue;
+    }
+    if (reduce_all || check_dim_in_dim_list(d, in.dim(), dim_list.value())) {
+      if (inner_size != 1) {
+        // A kept dim separates this reduced dim from the previous ones.
+        return false;
+      }
+      seen_reduced = true;
+      reduce_size *= size;
+    } else if (seen_reduced) {
+      inner_size *= size;
+    } else {
+      outer_size *= size;
+    }
+  }
+  shape = {outer_size, reduce_size, inner_size};
+  return true;
+}
+
+/**
+ * Returns the grain size, in outputs, for a parallel loop over outputs that
+ * each reduce `reduce_size` inputs.
+ */
+inline int64_t reduction_grain_size(int64_t reduce_size) {
+  return std::max<int64_t>(
+      1, kElementwiseGrainSize / std::max<int64_t>(1, reduce_size));
+}
+
+namespace internal {
+
+/// Rows longer than this are split in two and each half summed separately,
+/// which keeps the rounding error of a sum of n elements at O(log(n)) rather
+/// than O(n).
+constexpr int64_t kPairwiseSumBlockSize = 256;
+
+/// Number of vectors of columns that column reductions work on at once.
+constexpr int64_t kColumnVectors = 4;
+
+/**
+ * Returns the sum of `map(data[i], param)` for the `n` contiguous elements of
+ * `data`. `map` is called with both CTYPE and Vectorized<CTYPE> arguments.
+ */
+template <typename CTYPE, typename Map>
+CTYPE row_sum(const CTYPE* data, int64_t n, CTYPE param, const Map& map) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  if (n > kPairwiseSumBlockSize) {
+    const int64_t half = n / 2 / Vec::size() * Vec::size();
+    return row_sum(data, half, param, map) +
+        row_sum(data + half, n - half, param, map);
+  }
+  const Vec param_vec(param);
+  Vec acc0(0);
+  Vec acc1(0);
+  int64_t i = 0;
+  for (; i + 2 * Vec::size() <= n; i += 2 * Vec::size()) {
+    acc0 = acc0 + map(Vec::loadu(data + i), param_vec);
+    acc1 = acc1 + map(Vec::loadu(data + i + Vec::size()), param_vec);
+  }
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    acc0 = acc0 + map(Vec::loadu(data + i), param_vec);
+  }
+  CTYPE sum = executorch::vec::vec_reduce_all<CTYPE>(
+      [](Vec& x, Vec& y) { return x + y; }, acc0 + acc1);
+  for (; i < n; ++i) {
+    sum += map(data[i], param);
+  }
+  return sum;
+}
+
+/// Adds `value` to `sum` with Kahan summation; `comp` carries the low-order
+/// bits lost so far. For integral types `comp` stays zero.
+template <typename T>
+inline void kahan_add(T& sum, T& comp, const T& value) {
+  const T y = value - comp;
+  const T t = sum + y;
+  comp = (t - sum) - y;
+  sum = t;
+}
+
+/**
+ * For each of the `num_cols` contiguous columns of a [reduce_size, stride]
+ * block starting at `in`, writes the sum of `map(x, params[col])` over the
+ * column to `out[col]`. A null `params` passes zero instead. `params` may
+ * alias `out`.
+ */
+template <typename CTYPE, typename Map>
+void column_sum(
+    const CTYPE* in,
+    int64_t reduce_size,
+    int64_t stride,
+    int64_t num_cols,
+    const CTYPE* params,
+    const Map& map,
+    CTYPE* out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  int64_t j = 0;
+  for (; j + kColumnVectors * Vec::size() <= num_cols;
+       j += kColumnVectors * Vec::size()) {
+    Vec sum[kColumnVectors];
+    Vec comp[kColumnVectors];
+    Vec param[kColumnVectors];
+    for (int64_t v = 0; v < kColumnVectors; ++v) {
+      sum[v] = Vec(0);
+      comp[v] = Vec(0);
+      param[v] = params == nullptr ? Vec(0)
+                                   : Vec::loadu(params + j + v * Vec::size());
+    }
+    for (int64_t r = 0; r < reduce_size; ++r) {
+      const CTYPE* row = in + r * stride + j;
+      for (int64_t v = 0; v < kColumnVectors; ++v) {
+        kahan_add(
+            sum[v], comp[v], map(Vec::loadu(row + v * Vec::size()), param[v]));
+      }
+    }
+    for (int64_t v = 0; v < kColumnVectors; ++v) {
+      sum[v].store(out + j + v * Vec::size());
+    }
+  }
+  for (; j + Vec::size() <= num_cols; j += Vec::size()) {
+    Vec sum(0);
+    Vec comp(0);
+    const Vec param = params == nullptr ? Vec(0) : Vec::loadu(params + j);
+    for (int64_t r = 0; r < reduce_size; ++r) {
+      kahan_add(sum, comp, map(Vec::loadu(in + r * stride + j), param));
+    }
+    sum.store(out + j);
+  }
+  for (; j < num_cols; ++j) {
+    CTYPE sum = 0;
+    CTYPE comp = 0;
+    const CTYPE param = params == nullptr ? CTYPE(0) : params[j];
+    for (int64_t r = 0; r < reduce_size; ++r) {
+      kahan_add(sum, comp, map(in[r * stride + j], param));
+    }
+    out[j] = sum;
+  }
+}
+
+/// NaN-propagating max of two scalars, matching Vectorized's `maximum`.
+template <typename CTYPE>
+inline CTYPE nan_max(CTYPE v, CTYPE max_v) {
+  return std::isnan(v) || v > max_v ? v : max_v;
+}
+
+/// NaN-propagating min of two scalars, matching Vectorized's `minimum`.
+template <typename CTYPE>
+inline CTYPE nan_min(CTYPE v, CTYPE min_v) {
+  return std::isnan(v) || v < min_v ? v : min_v;
+}
+
+/// Returns the NaN-propagating max, or min if not `kMax`, of the `n > 0`
+/// contiguous elements of `data`.
+template <bool kMax, typename CTYPE>
+CTYPE row_extremum(const CTYPE* data, int64_t n) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const auto combine = [](const Vec& x, const Vec& y) {
+    return kMax ? executorch::vec::maximum(x, y)
+                : executorch::vec::minimum(x, y);
+  };
+  CTYPE acc_v = data[0];
+  int64_t i = 0;
+  if (n >= Vec::size()) {
+    Vec acc0 = Vec::loadu(data);
+    Vec acc1 = acc0;
+    for (i = Vec::size(); i + 2 * Vec::size() <= n; i += 2 * Vec::size()) {
+      acc0 = combine(acc0, Vec::loadu(data + i));
+      acc1 = combine(acc1, Vec::loadu(data + i + Vec::size()));
+    }
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      acc0 = combine(acc0, Vec::loadu(data + i));
+    }
+    acc_v = executorch::vec::vec_reduce_all<CTYPE>(
+        [&](Vec& x, Vec& y) { return combine(x, y); }, combine(acc0, acc1));
+  }
+  for (; i < n; ++i) {
+    acc_v = kMax ? nan_max(data[i], acc_v) : nan_min(data[i], acc_v);
+  }
+  return acc_v;
+}
+
+/// Returns the NaN-propagating max of the `n > 0` contiguous elements of
+/// `data`.
+template <typename CTYPE>
+CTYPE row_max(const CTYPE* data, int64_t n) {
+  return row_extremum</*kMax=*/true>(data, n);
+}
+
+/// Number of elements of a row that arg reductions search at once, and the
+/// most chunks a row is split into. A row is searched chunk by chunk, possibly
+/// in parallel, and then the chunk holding the result once more to find its
+/// index.
+constexpr int64_t kArgChunkSize = 4096;
+constexpr int64_t kMaxArgChunks = 64;
+
+/// The type that arg reductions compare CTYPE values in: float for the 16-bit
+/// floats, which have no comparisons of their own, and CTYPE otherwise.
+template <typename CTYPE>
+using arg_value_t = std::conditional_t<
+    std::is_same<CTYPE, exec_aten::Half>::value ||
+        std::is_same<CTYPE, exec_aten::BFloat16>::value,
+    float,
+    CTYPE>;
+
+template <typename CTYPE>
+inline arg_value_t<CTYPE> arg_value(CTYPE v) {
+  if constexpr (std::is_same<CTYPE, exec_aten::BFloat16>::value) {
+    return executorch::vec::internal::bfloat16_bits_to_float(v.x);
+  } else {
+    return static_cast<arg_value_t<CTYPE>>(v);
+  }
+}
+
+/// Same as row_extremum(), but returns the result as an arg_value_t, widening
+/// 16-bit floats to float a vector at a time.
+template <bool kMax, typename CTYPE>
+arg_value_t<CTYPE> arg_row_extremum(const CTYPE* data, int64_t n) {
+  if constexpr (std::is_same<arg_value_t<CTYPE>, CTYPE>::value) {
+    return row_extremum<kMax>(data, n);
+  } else {
+    using Vec = executorch::vec::Vectorized<float>;
+    const auto combine = [](const Vec& x, const Vec& y) {
+      return kMax ? executorch::vec::maximum(x, y)
+                  : executorch::vec::minimum(x, y);
+    };
+    float acc_v = arg_value(data[0]);
+    int64_t i = 0;
+    if (n >= Vec::size()) {
+      Vec acc = executorch::vec::load_as_float(data);
+      for (i = Vec::size(); i + Vec::size() <= n; i += Vec::size()) {
+        acc = combine(acc, executorch::vec::load_as_float(data + i));
+      }
+      acc_v = executorch::vec::vec_reduce_all<float>(
+          [&](Vec& x, Vec& y) { return combine(x, y); }, acc);
+    }
+    for (; i < n; ++i) {
+      const float v = arg_value(data[i]);
+      acc_v = kMax ? nan_max(v, acc_v) : nan_min(v, acc_v);
+    }
+    return acc_v;
+  }
+}
+
+/**
+ * Returns the index of the first of the `n` contiguous elements of `data`
+ * equal to `value`, or of the first NaN if `value` is NaN, or `n` if there is
+ * none.
+ */
+template <typename CTYPE>
+int64_t row_find(const CTYPE* data, int64_t n, arg_value_t<CTYPE> value) {
+  if (std::isnan(value)) {
+    for (int64_t i = 0; i < n; ++i) {
+      if (std::isnan(arg_value(data[i]))) {
+        return i;
+      }
+    }
+    return n;
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    if (arg_value(data[i]) == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/**
+ * Returns the index of the first NaN of the `n > 0` contiguous elements of
+ * `data` if there is one, and otherwise of their first max, or min if not
+ * `kMax`, as argmax and argmin do. The chunks of the row are searched in
+ * parallel if `parallel` is set.
+ */
+template <bool kMax, typename CTYPE>
+int64_t row_arg_extremum(const CTYPE* data, int64_t n, bool parallel) {
+  const int64_t chunk_size =
+      std::max(kArgChunkSize, (n + kMaxArgChunks - 1) / kMaxArgChunks);
+  const int64_t num_chunks = (n + chunk_size - 1) / chunk_size;
+  arg_value_t<CTYPE> chunk_values[kMaxArgChunks];
+  const auto search = [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t start = c * chunk_size;
+      chunk_values[c] = arg_row_extremum<kMax>(
+          data + start, std::min(chunk_size, n - start));
+    }
+  };
+  if (parallel) {
+    elementwise_parallel_for(num_chunks, search, /*grain_size=*/1);
+  } else {
+    search(0, num_chunks);
+  }
+  // Keep the first chunk holding a NaN, or else the first one holding the
+  // result.
+  int64_t best = 0;
+  for (int64_t c = 1; c < num_chunks && !std::isnan(chunk_values[best]);
+       ++c) {
+    const auto v = chunk_values[c];
+    if (std::isnan(v) ||
+        (kMax ? v > chunk_values[best] : v < chunk_values[best])) {
+      best = c;
+    }
+  }
+  const int64_t start = best * chunk_size;
+  return start +
+      row_find(data + start,
+               std::min(chunk_size, n - start),
+               chunk_values[best]);
+}
+
+/**
+ * For each of the `num_cols` contiguous columns of a [reduce_size, stride]
+ * block starting at `in`, with `reduce_size > 0`, writes the NaN-propagating
+ * max of the column to `out[col]`.
+ */
+template <typename CTYPE>
+void column_max(
+    const CTYPE* in,
+    int64_t reduce_size,
+    int64_t stride,
+    int64_t num_cols,
+    CTYPE* out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  int64_t j = 0;
+  for (; j + kColumnVectors * Vec::size() <= num_cols;
+       j += kColumnVectors * Vec::size()) {
+    Vec acc[kColumnVectors];
+    for (int64_t v = 0; v < kColumnVectors; ++v) {
+      acc[v] = Vec::loadu(in + j + v * Vec::size());
+    }
+    for (int64_t r = 1; r < reduce_size; ++r) {
+      const CTYPE* row = in + r * stride + j;
+      for (int64_t v = 0; v < kColumnVectors; ++v) {
+        acc[v] =
+            executorch::vec::maximum(acc[v], Vec::loadu(row + v * Vec::size()));
+      }
+    }
+    for (int64_t v = 0; v < kColumnVectors; ++v) {
+      acc[v].store(out + j + v * Vec::size());
+    }
+  }
+  for (; j + Vec::size() <= num_cols; j += Vec::size()) {
+    Vec acc = Vec::loadu(in + j);
+    for (int64_t r = 1; r < reduce_size; ++r) {
+      acc = executorch::vec::maximum(acc, Vec::loadu(in + r * stride + j));
+    }
+    acc.store(out + j);
+  }
+  for (; j < num_cols; ++j) {
+    CTYPE max_v = in[j];
+    for (int64_t r = 1; r < reduce_size; ++r) {
+      max_v = nan_max(in[r * stride + j], max_v);
+    }
+    out[j] = max_v;
+  }
+}
+
+/**
+ * Calls `fn(in_block, out_block, num_cols)` for every group of up to
+ * `kColumnVectors` vectors of columns of `shape`, in parallel.
+ */
+template <typename CTYPE, typename Fn>
+void parallel_for_each_column_block(
+    const CTYPE* in,
+    const ReductionShape& shape,
+    CTYPE* out,
+    const Fn& fn) {
+  constexpr int64_t kBlock =
+      kColumnVectors * executorch::vec::Vectorized<CTYPE>::size();
+  const int64_t blocks_per_outer = (shape.inner_size + kBlock - 1) / kBlock;
+  elementwise_parallel_for(
+      shape.outer_size * blocks_per_outer,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+          const int64_t outer = b / blocks_per_outer;
+          const int64_t col = b % blocks_per_outer * kBlock;
+          fn(in + outer * shape.reduce_size * shape.inner_size + col,
+             out + outer * shape.inner_size + col,
+             std::min(kBlock, shape.inner_size - col));
+        }
+      },
+      reduction_grain_size(shape.reduce_size * kBlock));
+}
+
+} // namespace internal
+
+/**
+ * Writes the sum of each reduced slice of the contiguous `in` to `out`. Sums
+ * along contiguous rows are computed pairwise and sums across rows with Kahan
+ * summation.
+ */
+template <typename CTYPE>
+void reduce_sum(const CTYPE* in, const ReductionShape& shape, CTYPE* out) {
+  const auto identity = [](auto x, auto) { return x; };
+  if (shape.inner_size == 1) {
+    elementwise_parallel_for(
+        shape.outer_size,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            out[i] = internal::row_sum<CTYPE>(
+                in + i * shape.reduce_size, shape.reduce_size, 0, identity);
+          }
+        },
+        reduction_grain_size(shape.reduce_size));
+    return;
+  }
+  internal::parallel_for_each_column_block(
+      in, shape, out, [&](const CTYPE* in_block, CTYPE* out_block, int64_t n) {
+        internal::column_sum<CTYPE>(
+            in_block,
+            shape.reduce_size,
+            shape.inner_size,
+            n,
+            nullptr,
+            identity,
+            out_block);
+      });
+}
+
+/**
+ * Writes the NaN-propagating max of each reduced slice of the contiguous `in`
+ * to `out`.
+ */
+template <typename CTYPE>
+void reduce_amax(const CTYPE* in, const ReductionShape& shape, CTYPE* out) {
+  if (shape.inner_size == 1) {
+    elementwise_parallel_for(
+        shape.outer_size,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            out[i] = internal::row_max<CTYPE>(
+                in + i * shape.reduce_size, shape.reduce_size);
+          }
+        },
+        reduction_grain_size(shape.reduce_size));
+    return;
+  }
+  internal::parallel_for_each_column_block(
+      in, shape, out, [&](const CTYPE* in_block, CTYPE* out_block, int64_t n) {
+        internal::column_max<CTYPE>(
+            in_block, shape.reduce_size, shape.inner_size, n, out_block);
+      });
+}
+
+/**
+ * Writes the index of the max, or min if not `kMax`, of each reduced slice of
+ * the contiguous `in` to `out`, as argmax and argmin do: the first one in case
+ * of ties, and the first NaN if any. A single long row, such as the logits of
+ * a large vocabulary in greedy decoding, is split in chunks that are searched
+ * in parallel.
+ *
+ * PREREQ: shape.inner_size == 1.
+ */
+template <bool kMax, typename CTYPE>
+void reduce_arg_extremum(
+    const CTYPE* in,
+    const ReductionShape& shape,
+    int64_t* out) {
+  if (shape.outer_size == 1) {
+    out[0] = internal::row_arg_extremum<kMax>(
+        in, shape.reduce_size, /*parallel=*/true);
+    return;
+  }
+  elementwise_parallel_for(
+      shape.outer_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          out[i] = internal::row_arg_extremum<kMax>(
+              in + i * shape.reduce_size,
+              shape.reduce_size,
+              /*parallel=*/false);
+        }
+      },
+      reduction_grain_size(shape.reduce_size));
+}
+
+/**
+ * Writes the variance of each reduced slice of the contiguous, floating-point
+ * `in` to `out`: the sum of squared deviations from the slice's mean, divided
+ * by `denominator`. Like the portable kernel, the mean is computed in a
+ * separate pass first.
+ */
+template <typename CTYPE>
+void reduce_var(
+    const CTYPE* in,
+    const ReductionShape& shape,
+    double denominator,
+    CTYPE* out) {
+  const auto identity = [](auto x, auto) { return x; };
+  const auto squared_deviation = [](auto x, auto mean) {
+    const auto d = x - mean;
+    return d * d;
+  };
+  const CTYPE num = static_cast<CTYPE>(shape.reduce_size);
+  const CTYPE denom = static_cast<CTYPE>(denominator);
+  if (shape.inner_size == 1) {
+    elementwise_parallel_for(
+        shape.outer_size,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            const CTYPE* row = in + i * shape.reduce_size;
+            const CTYPE mean =
+                internal::row_sum<CTYPE>(row, shape.reduce_size, 0, identity) /
+                num;
+            out[i] = internal::row_sum<CTYPE>(
+                         row, shape.reduce_size, mean, squared_deviation) /
+                denom;
+          }
+        },
+        reduction_grain_size(2 * shape.reduce_size));
+    return;
+  }
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  internal::parallel_for_each_column_block(
+      in, shape, out, [&](const CTYPE* in_block, CTYPE* out_block, int64_t n) {
+        // Compute the column means in `out_block`, then replace them with the
+        // variances.
+        internal::column_sum<CTYPE>(
+            in_block,
+            shape.reduce_size,
+            shape.inner_size,
+            n,
+            nullptr,
+            identity,
+            out_block);
+        executorch::vec::map<CTYPE>(
+            [num](Vec x) { return x / Vec(num); }, out_block, out_block, n);
+        internal::column_sum<CTYPE>(
+            in_block,
+            shape.reduce_size,
+            shape.inner_size,
+            n,
+            out_block,
+            squared_deviation,
+            out_block);
+        executorch::vec::map<CTYPE>(
+            [denom](Vec x) { return x / Vec(denom); }, out_block, out_block, n);
+      });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -1,12 +1,55 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+load(
+    "@fbsource//xplat/executorch/kernels/optimized:lib_defs.bzl",
+    "define_cpu_dispatch_library",
+    "get_cpu_dispatch_preprocessor_flags",
+    "is_cpu_dispatch_enabled",
+)
 load("@fbsource//xplat/executorch/kernels/optimized:op_registration_util.bzl", "define_op_target", "is_op_disabled", "op_target")
 
 _OPTIMIZED_ATEN_OPS = (
     op_target(
         name = "op_add",
         deps = [
+            ":vec_kernels",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+        ],
+    ),
+    op_target(
+        name = "op_addmm",
+        deps = [
+            ":gemm_utils",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_amax",
+        deps = [
+            ":reduce_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_argmax",
+        deps = [
+            ":reduce_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_argmin",
+        deps = [
+            ":reduce_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_avg_pool2d",
+        deps = [
+            ":pool_utils",
         ],
     ),
     op_target(
@@ -15,6 +58,27 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/optimized:libblas",
         ],
     ),
+    op_target(
+        name = "op_cat",
+        deps = [
+            ":block_copy_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_copy",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
+    ),
     op_target(
         name = "op_div",
         deps = [
@@ -22,15 +86,31 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_embedding",
+        deps = [
+            ":gather_utils",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(name = "op_exp"),
     op_target(
         name = "op_gelu",
-        deps = select({
-            "DEFAULT": [],
-            "ovr_config//cpu:arm64": [
-                "fbsource//third-party/sleef:sleef_arm",
-            ],
-        }),
+    ),
+    op_target(
+        name = "op_index_put",
+        deps = [
+            ":block_copy_utils",
+            "//executorch/kernels/portable/cpu/util:advanced_index_util",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+        ],
+    ),
+    op_target(
+        name = "op_index_select",
+        deps = [
+            ":gather_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
     ),
     op_target(
         name = "op_le",
@@ -38,21 +118,56 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu:scalar_utils",
         ],
     ),
+    op_target(
+        name = "op_linear",
+        deps = [
+            ":gemm_utils",
+        ],
+    ),
     op_target(
         name = "op_log_softmax",
         deps = select({
             "DEFAULT": [
+                ":vec_kernels",
                 "//executorch/kernels/portable/cpu/util:activation_ops_util",
             ],
             "ovr_config//cpu:arm64": [
+                ":vec_kernels",
                 "//executorch/kernels/portable/cpu/util:activation_ops_util",
                 "fbsource//third-party/sleef:sleef_arm",
             ],
         }),
     ),
+    op_target(
+        name = "op_max_pool2d",
+        deps = [
+            ":pool_utils",
+        ],
+    ),
+    op_target(
+        name = "op_max_pool2d_with_indices",
+        deps = [
+            ":pool_utils",
+        ],
+    ),
+    op_target(
+        name = "op_mean",
+        deps = [
+            ":reduce_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_mm",
+        deps = [
+            ":gemm_utils",
+            "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+        ],
+    ),
     op_target(
         name = "op_mul",
         deps = [
+            ":vec_kernels",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
@@ -60,11 +175,70 @@ _OPTIMIZED_ATEN_OPS = (
     op_target(
         name = "op_native_layer_norm",
         deps = [
-            ":moments_utils",
+            ":vec_kernels",
             "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
         ],
     ),
     op_target(name = "op_neg"),
+    op_target(
+        name = "op_permute_copy",
+        deps = [
+            ":permute_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_sigmoid",
+        deps = [
+            ":activation_utils",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/kernels/portable/cpu/util:functional_util",
+        ],
+    ),
+    op_target(
+        name = "op_silu",
+        deps = [
+            ":activation_utils",
+        ],
+    ),
+    op_target(
+        name = "op_slice_copy",
+        deps = [
+            ":block_copy_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
+    op_target(
+        name = "op_slice_scatter",
+        deps = [
+            ":block_copy_utils",
+            "//executorch/kernels/portable/cpu/util:index_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            ":activation_utils",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_split_copy",
+        deps = [
+            ":block_copy_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_stack",
+        deps = [
+            ":block_copy_utils",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
@@ -72,6 +246,56 @@ _OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_sum",
+        deps = [
+            ":reduce_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_tanh",
+        deps = [
+            ":activation_utils",
+            "//executorch/kernels/portable/cpu/pattern:pattern",
+        ],
+    ),
+    op_target(
+        name = "op_topk",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+            "//executorch/kernels/portable/cpu/util:topk_util",
+        ],
+    ),
+    op_target(
+        name = "op_transpose_copy",
+        deps = [
+            ":permute_utils",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_bilinear2d",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_nearest2d",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
+    op_target(
+        name = "op_var",
+        deps = [
+            ":reduce_utils",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
 )
 
 def define_common_targets():
@@ -97,6 +321,65 @@ def define_common_targets():
         exported_deps = all_op_targets,
     )
 
+    runtime.cxx_library(
+        name = "activation_utils",
+        srcs = [],
+        exported_headers = ["activation_utils.h"],
+        visibility = [
+            "//executorch/extension/llm/custom_ops/...",
+            "//executorch/kernels/optimized/...",
+        ],
+        exported_deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "block_copy_utils",
+        srcs = [],
+        exported_headers = ["block_copy_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
+    )
+
+    # Picks between the copies of multi-versioned kernels at runtime. The
+    # capabilities other than DEFAULT are only built with
+    # `-c executorch.cpu_dispatch=true`, which also pulls in cpuinfo.
+    runtime.cxx_library(
+        name = "cpu_dispatch",
+        srcs = ["cpu_dispatch.cpp"],
+        exported_headers = ["cpu_dispatch.h"],
+        exported_preprocessor_flags = get_cpu_dispatch_preprocessor_flags(),
+        deps = [
+            "//executorch/backends/xnnpack/threadpool:cpuinfo_utils",
+        ] if is_cpu_dispatch_enabled() else [],
+        visibility = ["//executorch/kernels/optimized/..."],
+    )
+
+    runtime.cxx_library(
+        name = "gather_utils",
+        srcs = [],
+        exported_headers = ["gather_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "gemm_utils",
+        srcs = [],
+        exported_headers = ["gemm_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
     runtime.cxx_library(
         name = "moments_utils",
         srcs = [],
@@ -107,3 +390,59 @@ def define_common_targets():
             "//executorch/kernels/optimized:libutils",
         ],
     )
+
+    runtime.cxx_library(
+        name = "permute_utils",
+        srcs = [],
+        exported_headers = ["permute_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:scalar_type_util",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "pool_utils",
+        srcs = [],
+        exported_headers = ["pool_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "reduce_utils",
+        srcs = [],
+        exported_headers = ["reduce_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+    )
+
+    define_cpu_dispatch_library(
+        name = "vec_kernels",
+        srcs = ["vec_kernels.cpp"],
+        exported_headers = ["vec_kernels.h"],
+        deps = [
+            ":cpu_dispatch",
+            ":moments_utils",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:scalar_type_util",
+        ],
+        visibility = ["//executorch/kernels/optimized/..."],
+    )
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This file may be compiled several times, once per CPU capability, with
+// CPU_CAPABILITY naming the capability; see cpu_dispatch.h. Builds that
+// compile it only once leave CPU_CAPABILITY unset.
+#ifndef CPU_CAPABILITY
+#define CPU_CAPABILITY DEFAULT
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <executorch/kernels/optimized/cpu/moments_utils.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+template <typename CTYPE>
+void add_kernel_impl(
+    CTYPE* out,
+    const CTYPE* a,
+    const CTYPE* b,
+    CTYPE alpha,
+    int64_t numel) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  executorch::vec::map2<CTYPE>(
+      [alpha](Vec x, Vec y) { return x + Vec(alpha) * y; }, out, a, b, numel);
+}
+
+// 16-bit floats are added in float and rounded once, as the portable kernel
+// does, so `alpha` stays a float.
+template <typename CTYPE>
+void add_kernel_impl_16bit(
+    CTYPE* out,
+    const CTYPE* a,
+    const CTYPE* b,
+    float alpha,
+    int64_t numel) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  using FloatVec = executorch::vec::Vectorized<float>;
+  executorch::vec::map2<CTYPE>(
+      [alpha](Vec x, Vec y) {
+        return executorch::vec::binary_op_as_float(
+            x, y, [alpha](FloatVec fx, FloatVec fy) {
+              return fx + FloatVec(alpha) * fy;
+            });
+      },
+      out,
+      a,
+      b,
+      numel);
+}
+
+void add_kernel(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    const void* alpha,
+    int64_t numel) {
+  switch (dtype) {
+#define ADD_KERNEL_CASE(ctype, name)       \
+  case exec_aten::ScalarType::name:        \
+    add_kernel_impl<ctype>(                \
+        static_cast<ctype*>(out),          \
+        static_cast<const ctype*>(a),      \
+        static_cast<const ctype*>(b),      \
+        *static_cast<const ctype*>(alpha), \
+        numel);                            \
+    break;
+    ET_FORALL_REAL_TYPES_AND(Bool, ADD_KERNEL_CASE)
+#undef ADD_KERNEL_CASE
+#define ADD_KERNEL_16BIT_CASE(ctype, name) \
+  case exec_aten::ScalarType::name:        \
+    add_kernel_impl_16bit<ctype>(          \
+        static_cast<ctype*>(out),          \
+        static_cast<const ctype*>(a),      \
+        static_cast<const ctype*>(b),      \
+        *static_cast<const float*>(alpha), \
+        numel);                            \
+    break;
+    ADD_KERNEL_16BIT_CASE(exec_aten::Half, Half)
+    ADD_KERNEL_16BIT_CASE(exec_aten::BFloat16, BFloat16)
+#undef ADD_KERNEL_16BIT_CASE
+    default:
+      break;
+  }
+}
+
+template <typename CTYPE>
+void mul_kernel_impl(
+    CTYPE* out,
+    const CTYPE* a,
+    const CTYPE* b,
+    int64_t numel) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  executorch::vec::map2<CTYPE>(
+      [](Vec x, Vec y) { return x * y; }, out, a, b, numel);
+}
+
+void mul_kernel(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    int64_t numel) {
+  switch (dtype) {
+#define MUL_KERNEL_CASE(ctype, name)  \
+  case exec_aten::ScalarType::name:   \
+    mul_kernel_impl<ctype>(           \
+        static_cast<ctype*>(out),     \
+        static_cast<const ctype*>(a), \
+        static_cast<const ctype*>(b), \
+        numel);                       \
+    break;
+    ET_FORALL_REAL_TYPES_AND3(Half, Bool, BFloat16, MUL_KERNEL_CASE)
+#undef MUL_KERNEL_CASE
+    default:
+      break;
+  }
+}
+
+template <typename CTYPE>
+void layer_norm_kernel_impl(
+    const CTYPE* input_data,
+    const CTYPE* gamma_data,
+    const CTYPE* beta_data,
+    CTYPE eps,
+    int64_t M,
+    int64_t N,
+    CTYPE* out_data,
+    CTYPE* mean_data,
+    CTYPE* rstd_data) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  if (N == 0) {
+    for (int64_t i = 0; i < M; ++i) {
+      mean_data[i] = static_cast<CTYPE>(0);
+      rstd_data[i] = static_cast<CTYPE>(NAN);
+    }
+    return;
+  }
+
+  const bool gamma_null = gamma_data == nullptr;
+  const bool beta_null = beta_data == nullptr;
+
+  for (int64_t i = 0; i < M; ++i) {
+    const CTYPE* src_ptr = input_data + i * N;
+    CTYPE* dst_ptr = out_data + i * N;
+
+    CTYPE mean_val;
+    CTYPE rstd_val;
+    std::tie(mean_val, rstd_val) = RowwiseMoments(src_ptr, N);
+    rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
+
+    const CTYPE scale = rstd_val;
+    const CTYPE offset = -rstd_val * mean_val;
+
+    if (gamma_null || beta_null) {
+      for (int64_t j = 0; j < N; ++j) {
+        const CTYPE gamma_v = gamma_null ? CTYPE(1) : gamma_data[j];
+        const CTYPE beta_v = beta_null ? CTYPE(0) : beta_data[j];
+        dst_ptr[j] = (src_ptr[j] * scale + offset) * gamma_v + beta_v;
+      }
+    } else {
+      executorch::vec::map3<CTYPE>(
+          [scale, offset](Vec x, Vec gamma, Vec beta) {
+            return (x * Vec(scale) + Vec(offset)) * gamma + beta;
+          },
+          dst_ptr,
+          src_ptr,
+          gamma_data,
+          beta_data,
+          N);
+    }
+
+    mean_data[i] = mean_val;
+    rstd_data[i] = rstd_val;
+  }
+}
+
+void layer_norm_kernel(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    const void* gamma,
+    const void* beta,
+    double eps,
+    int64_t M,
+    int64_t N,
+    void* out,
+    void* mean,
+    void* rstd) {
+  switch (dtype) {
+#define LAYER_NORM_KERNEL_CASE(ctype, name) \
+  case exec_aten::ScalarType::name:         \
+    layer_norm_kernel_impl<ctype>(          \
+        static_cast<const ctype*>(in),      \
+        static_cast<const ctype*>(gamma),   \
+        static_cast<const ctype*>(beta),    \
+        static_cast<ctype>(eps),            \
+        M,                                  \
+        N,                                  \
+        static_cast<ctype*>(out),           \
+        static_cast<ctype*>(mean),          \
+        static_cast<ctype*>(rstd));         \
+    break;
+    ET_FORALL_FLOAT_TYPES(LAYER_NORM_KERNEL_CASE)
+#undef LAYER_NORM_KERNEL_CASE
+    default:
+      break;
+  }
+}
+
+void log_softmax_kernel(
+    const float* input_data_base,
+    float* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  const int64_t dim_stride = inner_size;
+  const int64_t outer_stride = dim_size * dim_stride;
+
+  if (inner_size == 1) {
+    // The softmax dim is contiguous: vectorize along it.
+    using Vec = executorch::vec::Vectorized<float>;
+    for (int64_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
+      const float* input_data = input_data_base + outer_idx * outer_stride;
+      float* output_data = output_data_base + outer_idx * outer_stride;
+
+      const float max_input = executorch::vec::reduce_all<float>(
+          [](Vec& x, Vec& y) { return executorch::vec::maximum(x, y); },
+          input_data,
+          dim_size);
+      executorch::vec::map<float>(
+          [max_input](Vec x) {
+            return executorch::vec::vec_exp(x - Vec(max_input));
+          },
+          output_data,
+          input_data,
+          dim_size);
+      const float temp_sum = std::log(executorch::vec::reduce_all<float>(
+          [](Vec& x, Vec& y) { return x + y; }, output_data, dim_size));
+      executorch::vec::map<float>(
+          [max_input, temp_sum](Vec x) {
+            return x - Vec(max_input + temp_sum);
+          },
+          output_data,
+          input_data,
+          dim_size);
+    }
+    return;
+  }
+
+  for (int64_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
+    for (int64_t inner_idx = 0; inner_idx < inner_size; ++inner_idx) {
+      const float* input_data =
+          input_data_base + outer_idx * outer_stride + inner_idx;
+      float* output_data =
+          output_data_base + outer_idx * outer_stride + inner_idx;
+
+      // calculate max in softmax dim
+      float max_input = input_data[0];
+      for (int64_t d = 0; d < dim_size; ++d) {
+        max_input = std::max(max_input, input_data[d * dim_stride]);
+      }
+      // calculate sum and exponential in softmax dim
+      float temp_sum = 0;
+      for (int64_t d = 0; d < dim_size; ++d) {
+        output_data[d * dim_stride] =
+            std::exp(input_data[d * dim_stride] - max_input);
+        temp_sum += output_data[d * dim_stride];
+      }
+
+      temp_sum = std::log(temp_sum);
+
+      for (int64_t d = 0; d < dim_size; ++d) {
+        output_data[d * dim_stride] =
+            input_data[d * dim_stride] - max_input - temp_sum;
+      }
+    }
+  }
+}
+
+} // namespace
+
+ET_REGISTER_DISPATCH(add_stub, &add_kernel);
+ET_REGISTER_DISPATCH(mul_stub, &mul_kernel);
+ET_REGISTER_DISPATCH(layer_norm_stub, &layer_norm_kernel);
+ET_REGISTER_DISPATCH(log_softmax_stub, &log_softmax_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
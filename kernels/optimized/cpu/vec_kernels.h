@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Inner loops of the hot optimized kernels, which vec_kernels.cpp implements
+// once per CPU capability; see cpu_dispatch.h. The signatures deal only in
+// raw pointers so that the multi-versioned code does not instantiate any
+// non-namespaced inline functions, e.g. Tensor accessors, with ISA flags that
+// the host might not support.
+
+#include <cstdint>
+
+#include <executorch/kernels/optimized/cpu/cpu_dispatch.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Computes `out = a + alpha * b` for `numel` contiguous elements of `dtype`,
+ * which may be any real type, Bool, Half or BFloat16. `alpha` points to a
+ * value of `dtype`, or to a float for Half and BFloat16.
+ */
+using add_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    const void* alpha,
+    int64_t numel);
+
+/**
+ * Computes `out = a * b` for `numel` contiguous elements of `dtype`, which
+ * may be any real type, Bool, Half or BFloat16.
+ */
+using mul_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    int64_t numel);
+
+/**
+ * Normalizes each of the `M` contiguous rows of `N` elements in `in`, a Float
+ * or Double buffer, then applies the optional elementwise `gamma` and `beta`.
+ * Writes each row's mean and reciprocal standard deviation to `mean` and
+ * `rstd`.
+ */
+using layer_norm_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    const void* gamma,
+    const void* beta,
+    double eps,
+    int64_t M,
+    int64_t N,
+    void* out,
+    void* mean,
+    void* rstd);
+
+/**
+ * Computes log_softmax over `dim_size` elements that are `inner_size` apart,
+ * for each of the `outer_size * inner_size` lines of `in`.
+ */
+using log_softmax_fn = void (*)(
+    const float* in,
+    float* out,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size);
+
+ET_DECLARE_DISPATCH(add_fn, add_stub);
+ET_DECLARE_DISPATCH(mul_fn, mul_stub);
+ET_DECLARE_DISPATCH(layer_norm_fn, layer_norm_stub);
+ET_DECLARE_DISPATCH(log_softmax_fn, log_softmax_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -20,23 +20,114 @@ def get_vec_android_preprocessor_flags():
     ]
     return preprocessor_flags
 
+# The vector ISAs, besides the baseline DEFAULT, that multi-versioned kernels
+# are compiled for when building with `-c executorch.cpu_dispatch=true`. Only
+# meaningful for x86-64 targets. See kernels/optimized/cpu/cpu_dispatch.h.
+_CPU_DISPATCH_CAPABILITY_FLAGS = {
+    "AVX2": [
+        "-DCPU_CAPABILITY_AVX2",
+        "-mavx2",
+        "-mfma",
+        "-mf16c",
+    ],
+    "AVX512": [
+        "-DCPU_CAPABILITY_AVX512",
+        "-mavx512f",
+        "-mavx512bw",
+        "-mavx512dq",
+        "-mavx512vl",
+        "-mfma",
+        "-mf16c",
+    ],
+}
+
+# The x86 vector ISA that vec is compiled for. Defaults to AVX2; build with
+# `-c executorch.vec_capability=avx512` to use the 512-bit Vectorized
+# specializations on hosts that support AVX-512F/BW/DQ/VL.
+def _get_vec_x86_flags():
+    if native.read_config("executorch", "vec_capability", "avx2") == "avx512":
+        return _CPU_DISPATCH_CAPABILITY_FLAGS["AVX512"]
+    return ["-DCPU_CAPABILITY_AVX2"]
+
 def get_vec_cxx_preprocessor_flags():
     preprocessor_flags = [
         (
             DEVSERVER_PLATFORM_REGEX,
-            [
-                "-DCPU_CAPABILITY_AVX2",
-            ],
+            _get_vec_x86_flags(),
         ),
     ]
     return preprocessor_flags
 
 def get_vec_fbcode_preprocessor_flags():
-    preprocessor_flags = [
-        "-DCPU_CAPABILITY_AVX2",
-    ]
+    preprocessor_flags = _get_vec_x86_flags()
     return preprocessor_flags
 
+def is_cpu_dispatch_enabled():
+    return native.read_config("executorch", "cpu_dispatch", "false") == "true"
+
+def get_cpu_dispatch_capabilities():
+    """Returns the CPU capabilities that multi-versioned kernels are built for.
+    """
+    if is_cpu_dispatch_enabled():
+        return ["DEFAULT"] + sorted(_CPU_DISPATCH_CAPABILITY_FLAGS.keys())
+    return ["DEFAULT"]
+
+def get_cpu_dispatch_preprocessor_flags():
+    """Returns the flags that every user of cpu_dispatch.h must be built with.
+    """
+    return [
+        "-DET_CPU_DISPATCH_HAVE_{}".format(capability)
+        for capability in get_cpu_dispatch_capabilities()
+        if capability != "DEFAULT"
+    ]
+
+def define_cpu_dispatch_library(name, srcs, exported_headers, deps, visibility):
+    """Defines a library whose sources are compiled once per CPU capability.
+
+    Each copy is built as "<name>_<capability>" with
+    -DCPU_CAPABILITY=<capability> and that capability's ISA flags, and should
+    register its kernels with ET_REGISTER_DISPATCH(). The DEFAULT copy uses
+    the same flags as the op targets.
+
+    Args:
+        name: The name of the library that links all of the copies.
+        srcs: The multi-versioned sources.
+        exported_headers: Headers that declare the dispatch stubs.
+        deps: Deps of each copy; must include the cpu_dispatch target.
+        visibility: Visibility of the library.
+    """
+    capability_targets = []
+    for capability in get_cpu_dispatch_capabilities():
+        capability_name = "{}_{}".format(name, capability)
+        capability_targets.append(":" + capability_name)
+        runtime.cxx_library(
+            name = capability_name,
+            srcs = srcs,
+            headers = exported_headers,
+            preprocessor_flags = [
+                "-DCPU_CAPABILITY={}".format(capability),
+            ] + _CPU_DISPATCH_CAPABILITY_FLAGS.get(capability, []),
+            fbandroid_platform_preprocessor_flags = get_vec_android_preprocessor_flags(),
+            fbandroid_platform_deps = [
+                (
+                    "^android-arm64.*$",
+                    [
+                        "fbsource//third-party/sleef:sleef_arm",
+                    ],
+                ),
+            ],
+            deps = deps,
+            visibility = [":{}".format(name)],
+        )
+
+    runtime.cxx_library(
+        name = name,
+        srcs = [],
+        exported_headers = exported_headers,
+        exported_deps = capability_targets + deps,
+        visibility = visibility,
+    )
+
 # Currently, having a dependency on fbsource//third-party/sleef:sleef may cause
 # duplicate symbol errors when linking fbcode targets in opt mode that also
 # depend on ATen. This is because ATen accesses sleef via the third-party folder
@@ -54,6 +145,10 @@ def define_libs():
             "//executorch/...",
             "@EXECUTORCH_CLIENTS",
         ],
+        exported_deps = [
+            # Vectorized<Half> and Vectorized<BFloat16>.
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
         cxx_platform_deps = select({
             "DEFAULT": [
                 (
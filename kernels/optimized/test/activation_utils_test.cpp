@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/cpu/activation_utils.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using exec_aten::BFloat16;
+using exec_aten::Half;
+using torch::executor::native::activation_map;
+using torch::executor::native::ActivationCompute;
+using torch::executor::native::kActivationBlockSize;
+
+TEST(ActivationUtilsTest, BFloat16RoundTripsExactValues) {
+  using Cast = ActivationCompute<BFloat16>;
+  // Values with at most 8 significant bits survive the round trip.
+  for (float value : {0.0f, 1.0f, -2.5f, 0.15625f, 65536.0f}) {
+    EXPECT_EQ(Cast::to_compute(Cast::from_compute(value)), value);
+  }
+  EXPECT_NEAR(Cast::to_compute(Cast::from_compute(-1.0e-3f)), -1.0e-3f, 1e-5);
+}
+
+TEST(ActivationUtilsTest, BFloat16RoundsToNearestEven) {
+  using Cast = ActivationCompute<BFloat16>;
+  // 1 + 2^-8 is halfway between 1 and 1 + 2^-7; ties go to the even 1.
+  EXPECT_EQ(Cast::from_compute(1.0f + 1.0f / 256).x, 0x3f80);
+  // 1 + 3 * 2^-8 is halfway between 1 + 2^-7 and 1 + 2^-6; ties go to the
+  // even 1 + 2^-6.
+  EXPECT_EQ(Cast::from_compute(1.0f + 3.0f / 256).x, 0x3f82);
+  // Just above halfway rounds up.
+  EXPECT_EQ(Cast::from_compute(1.0f + 1.0f / 256 + 1.0f / 4096).x, 0x3f81);
+}
+
+TEST(ActivationUtilsTest, BFloat16SpecialValues) {
+  using Cast = ActivationCompute<BFloat16>;
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(Cast::to_compute(Cast::from_compute(inf)), inf);
+  EXPECT_EQ(Cast::to_compute(Cast::from_compute(-inf)), -inf);
+  EXPECT_TRUE(std::isnan(Cast::to_compute(
+      Cast::from_compute(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(ActivationUtilsTest, MapFloat) {
+  using Vec = executorch::vec::Vectorized<float>;
+  std::vector<float> in(37);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<float>(i) - 10;
+  }
+  std::vector<float> out(in.size());
+  activation_map<float>(
+      [](Vec x) { return x * Vec(2); }, out.data(), in.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(out[i], in[i] * 2);
+  }
+}
+
+TEST(ActivationUtilsTest, MapAcrossBlocks) {
+  using Vec = executorch::vec::Vectorized<float>;
+  // Two full blocks and a partial one.
+  const int64_t size = 2 * kActivationBlockSize + 13;
+  std::vector<Half> in(size);
+  for (int64_t i = 0; i < size; ++i) {
+    in[i] = Half(static_cast<float>(i % 64) - 32);
+  }
+  std::vector<Half> out(size);
+  activation_map<Half>(
+      [](Vec x) { return x + Vec(1); }, out.data(), in.data(), size);
+  for (int64_t i = 0; i < size; ++i) {
+    EXPECT_EQ(static_cast<float>(out[i]), static_cast<float>(in[i]) + 1);
+  }
+}
+
+TEST(ActivationUtilsTest, MapBFloat16) {
+  using Cast = ActivationCompute<BFloat16>;
+  using Vec = executorch::vec::Vectorized<float>;
+  const int64_t size = kActivationBlockSize + 5;
+  std::vector<BFloat16> in(size);
+  for (int64_t i = 0; i < size; ++i) {
+    in[i] = Cast::from_compute(static_cast<float>(i % 16) / 4);
+  }
+  std::vector<BFloat16> out(size);
+  activation_map<BFloat16>(
+      [](Vec x) { return x * x; }, out.data(), in.data(), size);
+  for (int64_t i = 0; i < size; ++i) {
+    const float x = Cast::to_compute(in[i]);
+    EXPECT_EQ(Cast::to_compute(out[i]), x * x);
+  }
+}
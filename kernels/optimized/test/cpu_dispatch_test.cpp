@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/cpu/cpu_dispatch.h>
+
+using torch::executor::native::CpuCapability;
+using torch::executor::native::get_cpu_capability;
+
+namespace {
+
+using capability_fn = CpuCapability (*)();
+
+ET_DECLARE_DISPATCH(capability_fn, capability_stub);
+ET_DEFINE_DISPATCH(capability_stub);
+
+CpuCapability default_impl() {
+  return CpuCapability::DEFAULT;
+}
+ET_REGISTER_ARCH_DISPATCH(capability_stub, DEFAULT, &default_impl);
+
+#ifdef ET_CPU_DISPATCH_HAVE_AVX2
+CpuCapability avx2_impl() {
+  return CpuCapability::AVX2;
+}
+ET_REGISTER_ARCH_DISPATCH(capability_stub, AVX2, &avx2_impl);
+#endif
+
+#ifdef ET_CPU_DISPATCH_HAVE_AVX512
+CpuCapability avx512_impl() {
+  return CpuCapability::AVX512;
+}
+ET_REGISTER_ARCH_DISPATCH(capability_stub, AVX512, &avx512_impl);
+#endif
+
+using optional_fn = int (*)(int);
+
+ET_DECLARE_DISPATCH(optional_fn, optional_stub);
+ET_DEFINE_DISPATCH(optional_stub);
+
+int add_one(int x) {
+  return x + 1;
+}
+// Only the DEFAULT slot is filled in.
+ET_REGISTER_ARCH_DISPATCH(optional_stub, DEFAULT, &add_one);
+#ifdef ET_CPU_DISPATCH_HAVE_AVX2
+ET_REGISTER_ARCH_DISPATCH(optional_stub, AVX2, nullptr);
+#endif
+#ifdef ET_CPU_DISPATCH_HAVE_AVX512
+ET_REGISTER_ARCH_DISPATCH(optional_stub, AVX512, nullptr);
+#endif
+
+} // namespace
+
+TEST(CpuDispatchTest, CapabilityIsStable) {
+  EXPECT_EQ(get_cpu_capability(), get_cpu_capability());
+}
+
+TEST(CpuDispatchTest, CapabilityIsOneThisBinaryWasBuiltFor) {
+  switch (get_cpu_capability()) {
+    case CpuCapability::DEFAULT:
+      break;
+    case CpuCapability::AVX2:
+#ifndef ET_CPU_DISPATCH_HAVE_AVX2
+      ADD_FAILURE() << "Detected AVX2 without an AVX2 build";
+#endif
+      break;
+    case CpuCapability::AVX512:
+#ifndef ET_CPU_DISPATCH_HAVE_AVX512
+      ADD_FAILURE() << "Detected AVX512 without an AVX512 build";
+#endif
+      break;
+  }
+}
+
+TEST(CpuDispatchTest, StubCallsImplementationForDetectedCapability) {
+  EXPECT_EQ(capability_stub(), get_cpu_capability());
+  EXPECT_EQ(capability_stub.get_fn(), capability_stub.get_fn());
+}
+
+TEST(CpuDispatchTest, StubFallsBackToDefaultForMissingImplementations) {
+  EXPECT_EQ(optional_stub(41), 42);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/cpu/gemm_utils.h>
+
+#include <limits>
+#include <vector>
+
+using torch::executor::native::gemm_2d;
+using torch::executor::native::MatrixRef;
+
+namespace {
+
+// Returns element (i, j) of a matrix.
+template <typename T>
+float at(const MatrixRef<T>& m, int i, int j) {
+  return m.row_major ? m.data[i * m.cols + j] : m.data[j * m.rows + i];
+}
+
+// Fills a rows x cols matrix with distinct values, stored in the given layout.
+std::vector<float> make_matrix(int rows, int cols, bool row_major, int seed) {
+  std::vector<float> data(rows * cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      const float value = static_cast<float>((i * 7 + j * 3 + seed) % 11 - 5);
+      data[row_major ? i * cols + j : j * rows + i] = value;
+    }
+  }
+  return data;
+}
+
+} // namespace
+
+// Checks every combination of operand layouts and transpositions against a
+// naive product.
+TEST(GemmUtilsTest, AllLayoutsMatchNaiveProduct) {
+  constexpr int m = 5;
+  constexpr int k = 3;
+  constexpr int n = 4;
+  constexpr float alpha = 2;
+  constexpr float beta = 0.5;
+
+  for (int layouts = 0; layouts < 32; ++layouts) {
+    const bool a_row_major = layouts & 1;
+    const bool b_row_major = layouts & 2;
+    const bool c_row_major = layouts & 4;
+    const bool transpose_a = layouts & 8;
+    const bool transpose_b = layouts & 16;
+
+    const int a_rows = transpose_a ? k : m;
+    const int a_cols = transpose_a ? m : k;
+    const int b_rows = transpose_b ? n : k;
+    const int b_cols = transpose_b ? k : n;
+
+    std::vector<float> a = make_matrix(a_rows, a_cols, a_row_major, 1);
+    std::vector<float> b = make_matrix(b_rows, b_cols, b_row_major, 2);
+    std::vector<float> c = make_matrix(m, n, c_row_major, 3);
+    const std::vector<float> c_in = c;
+
+    const MatrixRef<const float> a_ref = {
+        a.data(), a_rows, a_cols, a_row_major};
+    const MatrixRef<const float> b_ref = {
+        b.data(), b_rows, b_cols, b_row_major};
+    const MatrixRef<const float> c_in_ref = {c_in.data(), m, n, c_row_major};
+    const MatrixRef<float> c_ref = {c.data(), m, n, c_row_major};
+
+    gemm_2d<float>(a_ref, transpose_a, b_ref, transpose_b, alpha, beta, c_ref);
+
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        float expected = beta * at(c_in_ref, i, j);
+        for (int l = 0; l < k; ++l) {
+          const float a_il = transpose_a ? at(a_ref, l, i) : at(a_ref, i, l);
+          const float b_lj = transpose_b ? at(b_ref, j, l) : at(b_ref, l, j);
+          expected += alpha * a_il * b_lj;
+        }
+        EXPECT_FLOAT_EQ(at(c_ref, i, j), expected)
+            << "layouts " << layouts << " at (" << i << ", " << j << ")";
+      }
+    }
+  }
+}
+
+TEST(GemmUtilsTest, ZeroBetaIgnoresOutput) {
+  std::vector<float> a = {1, 2, 3, 4};
+  std::vector<float> b = {1, 0, 0, 1};
+  std::vector<float> c(4, std::numeric_limits<float>::quiet_NaN());
+
+  gemm_2d<float>(
+      {a.data(), 2, 2, true},
+      /*transpose_a=*/false,
+      {b.data(), 2, 2, true},
+      /*transpose_b=*/false,
+      1,
+      0,
+      {c.data(), 2, 2, true});
+
+  EXPECT_EQ(c, a);
+}
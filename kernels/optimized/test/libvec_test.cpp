@@ -11,6 +11,10 @@
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_) \
@@ -72,3 +76,405 @@ void test_load_and_add() {
 TEST(VecFloatTest, LoadAndAdd) {
   TEST_FORALL_SUPPORTED_CTYPES(test_load_and_add);
 }
+
+template <typename T>
+void test_partial_load_and_store() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+
+  std::vector<T> in(kVecSize);
+  fill_monotonic(in, 1);
+
+  for (size_t count = 0; count <= kVecSize; ++count) {
+    // Lanes past `count` are zeroed on load and left untouched on store.
+    std::vector<T> out(kVecSize, static_cast<T>(-1));
+    Vec::loadu(in.data(), count).store(out.data(), count);
+    std::vector<T> full(kVecSize);
+    Vec::loadu(in.data(), count).store(full.data());
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], i < count ? in[i] : static_cast<T>(-1));
+      EXPECT_EQ(full[i], i < count ? in[i] : static_cast<T>(0));
+    }
+  }
+}
+
+TEST(VecTest, PartialLoadAndStore) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_partial_load_and_store);
+}
+
+template <typename T>
+void test_compare_and_blend() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+
+  std::vector<T> a(kVecSize);
+  fill_monotonic(a);
+  std::vector<T> b(kVecSize, static_cast<T>(kVecSize / 2));
+
+  const Vec a_vec = Vec::loadu(a.data());
+  const Vec b_vec = Vec::loadu(b.data());
+
+  // Picks b where a < b, so the result is max(a, b) lane by lane.
+  std::vector<T> out(kVecSize);
+  Vec::blendv(b_vec, a_vec, a_vec > b_vec).store(out.data());
+  std::vector<T> lt(kVecSize);
+  a_vec.lt(b_vec).store(lt.data());
+  std::vector<T> max(kVecSize);
+  executorch::vec::maximum(a_vec, b_vec).store(max.data());
+
+  for (size_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(out[i], std::max(a[i], b[i]));
+    EXPECT_EQ(lt[i], static_cast<T>(a[i] < b[i] ? 1 : 0));
+    EXPECT_EQ(max[i], std::max(a[i], b[i]));
+  }
+
+  // set() takes the first `count` lanes from its second argument.
+  std::vector<T> mixed(kVecSize);
+  Vec::set(b_vec, a_vec, 3).store(mixed.data());
+  for (size_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(mixed[i], i < 3 ? a[i] : b[i]);
+  }
+}
+
+TEST(VecTest, CompareAndBlend) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_compare_and_blend);
+}
+
+TEST(VecFloatTest, MaximumPropagatesNaN) {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  std::vector<float> a(Vec::size(), 1.0f);
+  a[1] = NAN;
+  std::vector<float> out(Vec::size());
+  executorch::vec::maximum(Vec::loadu(a.data()), Vec(2.0f)).store(out.data());
+
+  for (size_t i = 0; i < out.size(); ++i) {
+    if (i == 1) {
+      EXPECT_TRUE(std::isnan(out[i]));
+    } else {
+      EXPECT_EQ(out[i], 2.0f);
+    }
+  }
+}
+
+TEST(VecFloatTest, ReduceAll) {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  // Longer than several vectors, with a remainder.
+  std::vector<float> in(5 * Vec::size() + 3);
+  fill_monotonic(in, 1);
+
+  const float sum = executorch::vec::reduce_all<float>(
+      [](Vec& x, Vec& y) { return x + y; }, in.data(), in.size());
+  const float max = executorch::vec::reduce_all<float>(
+      [](Vec& x, Vec& y) { return executorch::vec::maximum(x, y); },
+      in.data(),
+      in.size());
+
+  const float n = static_cast<float>(in.size());
+  EXPECT_EQ(sum, n * (n + 1) / 2);
+  EXPECT_EQ(max, n);
+}
+
+namespace {
+
+float to_float(exec_aten::Half value) {
+  return static_cast<float>(value);
+}
+
+float to_float(exec_aten::BFloat16 value) {
+  return executorch::vec::internal::bfloat16_bits_to_float(value.x);
+}
+
+template <typename T>
+T from_float(float value) {
+  return executorch::vec::internal::from_float<T>(value);
+}
+
+} // namespace
+
+template <typename T>
+void test_16bit_arithmetic_matches_scalar() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  // Longer than several vectors, with a remainder.
+  const size_t n = 3 * Vec::size() + 5;
+  std::vector<T> a(n);
+  std::vector<T> b(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = from_float<T>(0.37f * i - 5.0f);
+    b[i] = from_float<T>(1.5f + 0.013f * i);
+  }
+
+  std::vector<T> sum(n);
+  std::vector<T> diff(n);
+  std::vector<T> prod(n);
+  std::vector<T> quot(n);
+  executorch::vec::map2<T>(
+      [](Vec x, Vec y) { return x + y; }, sum.data(), a.data(), b.data(), n);
+  executorch::vec::map2<T>(
+      [](Vec x, Vec y) { return x - y; }, diff.data(), a.data(), b.data(), n);
+  executorch::vec::map2<T>(
+      [](Vec x, Vec y) { return x * y; }, prod.data(), a.data(), b.data(), n);
+  executorch::vec::map2<T>(
+      [](Vec x, Vec y) { return x / y; }, quot.data(), a.data(), b.data(), n);
+
+  // Each result is the float result rounded once to T.
+  for (size_t i = 0; i < n; ++i) {
+    const float x = to_float(a[i]);
+    const float y = to_float(b[i]);
+    EXPECT_EQ(sum[i].x, from_float<T>(x + y).x);
+    EXPECT_EQ(diff[i].x, from_float<T>(x - y).x);
+    EXPECT_EQ(prod[i].x, from_float<T>(x * y).x);
+    EXPECT_EQ(quot[i].x, from_float<T>(x / y).x);
+  }
+}
+
+TEST(Vec16BitTest, ArithmeticMatchesScalar) {
+  test_16bit_arithmetic_matches_scalar<exec_aten::Half>();
+  test_16bit_arithmetic_matches_scalar<exec_aten::BFloat16>();
+}
+
+template <typename T>
+void test_16bit_convert_round_trip() {
+  using Vec = executorch::vec::Vectorized<T>;
+  using FloatVec = executorch::vec::Vectorized<float>;
+
+  std::vector<T> in(Vec::size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = from_float<T>(0.25f * i - 1.0f);
+  }
+
+  FloatVec lo;
+  FloatVec hi;
+  std::tie(lo, hi) = executorch::vec::convert_to_float(Vec::loadu(in.data()));
+  std::vector<float> widened(Vec::size());
+  lo.store(widened.data());
+  hi.store(widened.data() + FloatVec::size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(widened[i], to_float(in[i]));
+  }
+
+  std::vector<T> out(Vec::size());
+  executorch::vec::convert_from_float<T>(lo, hi).store(out.data());
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(out[i].x, in[i].x);
+  }
+}
+
+TEST(Vec16BitTest, ConvertRoundTrip) {
+  test_16bit_convert_round_trip<exec_aten::Half>();
+  test_16bit_convert_round_trip<exec_aten::BFloat16>();
+}
+
+TEST(Vec16BitTest, BFloat16RoundsToNearestEven) {
+  using Vec = executorch::vec::Vectorized<exec_aten::BFloat16>;
+  using FloatVec = executorch::vec::Vectorized<float>;
+
+  std::vector<float> in(Vec::size(), 0.0f);
+  // 1 + 2^-8 is halfway between 1 and the next BFloat16; ties go to even.
+  in[0] = 1.0f + std::ldexp(1.0f, -8);
+  // 1 + 3 * 2^-8 is halfway between two BFloat16s; the even one is larger.
+  in[1] = 1.0f + 3.0f * std::ldexp(1.0f, -8);
+  in[2] = NAN;
+  in[3] = -INFINITY;
+  // The smallest positive float denormal rounds to zero.
+  in[4] = std::numeric_limits<float>::denorm_min();
+
+  std::vector<exec_aten::BFloat16> out(Vec::size());
+  executorch::vec::convert_from_float<exec_aten::BFloat16>(
+      FloatVec::loadu(in.data()),
+      FloatVec::loadu(in.data() + FloatVec::size()))
+      .store(out.data());
+
+  EXPECT_EQ(out[0].x, 0x3f80);
+  EXPECT_EQ(out[1].x, 0x3f82);
+  EXPECT_EQ(out[2].x, 0x7fc0);
+  EXPECT_EQ(out[3].x, 0xff80);
+  EXPECT_EQ(out[4].x, 0x0000);
+}
+
+TEST(Vec16BitTest, PartialLoadAndStore) {
+  using Vec = executorch::vec::Vectorized<exec_aten::Half>;
+
+  std::vector<exec_aten::Half> in(Vec::size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = exec_aten::Half(static_cast<float>(i + 1));
+  }
+  const exec_aten::Half sentinel(-1.0f);
+  for (size_t count = 0; count <= in.size(); ++count) {
+    std::vector<exec_aten::Half> out(in.size(), sentinel);
+    (Vec::loadu(in.data(), count) + Vec(1.0f)).store(out.data(), count);
+    for (size_t i = 0; i < in.size(); ++i) {
+      EXPECT_EQ(
+          static_cast<float>(out[i]),
+          i < count ? static_cast<float>(in[i]) + 1.0f : -1.0f);
+    }
+  }
+}
+
+namespace {
+
+using executorch::vec::VecMathAccuracy;
+
+// Distance from `actual` to `expected` in units of the float ULP at
+// `expected`, subnormal spacing included.
+double ulp_error(float actual, double expected) {
+  if (std::isinf(expected) || expected == 0.0) {
+    return actual == expected ? 0.0 : INFINITY;
+  }
+  int exponent;
+  std::frexp(expected, &exponent);
+  const double ulp = std::ldexp(1.0, std::max(exponent - 24, -149));
+  return std::fabs(actual - expected) / ulp;
+}
+
+struct MathError {
+  double max_ulp = 0;
+  double max_abs = 0;
+  double max_rel = 0;
+};
+
+// Evaluates `fn` on `count` evenly spaced points in [lo, hi] and compares
+// against `ref` computed in double.
+template <typename Fn, typename Ref>
+MathError
+measure(const Fn& fn, const Ref& ref, float lo, float hi, int count = 100003) {
+  std::vector<float> in(count);
+  std::vector<float> out(count);
+  for (int i = 0; i < count; ++i) {
+    in[i] = lo + (hi - lo) * (static_cast<double>(i) / (count - 1));
+  }
+  executorch::vec::map<float>(fn, out.data(), in.data(), count);
+  MathError error;
+  for (int i = 0; i < count; ++i) {
+    const double expected = ref(static_cast<double>(in[i]));
+    const double abs = std::fabs(out[i] - expected);
+    error.max_ulp = std::max(error.max_ulp, ulp_error(out[i], expected));
+    error.max_abs = std::max(error.max_abs, abs);
+    if (expected != 0.0) {
+      error.max_rel = std::max(error.max_rel, abs / std::fabs(expected));
+    }
+  }
+  return error;
+}
+
+using Vec = executorch::vec::Vectorized<float>;
+
+} // namespace
+
+TEST(VecMathTest, ExpWithinBounds) {
+  const auto ref = [](double x) { return std::exp(x); };
+  EXPECT_LE(
+      measure(
+          [](Vec x) { return executorch::vec::vec_exp(x); },
+          ref,
+          -103.9f,
+          88.7f)
+          .max_ulp,
+      2.0);
+  EXPECT_LE(
+      measure(
+          [](Vec x) {
+            return executorch::vec::vec_exp<VecMathAccuracy::kFast>(x);
+          },
+          ref,
+          -86.6f,
+          88.7f)
+          .max_rel,
+      1e-5);
+}
+
+TEST(VecMathTest, LogWithinBounds) {
+  const auto ref = [](double x) { return std::log(x); };
+  const auto log_ulp = [](Vec x) { return executorch::vec::vec_log(x); };
+  const auto log_fast = [](Vec x) {
+    return executorch::vec::vec_log<VecMathAccuracy::kFast>(x);
+  };
+  EXPECT_LE(measure(log_ulp, ref, 1e-3f, 4.0f).max_ulp, 2.0);
+  EXPECT_LE(measure(log_ulp, ref, 1e-44f, 1e-37f).max_ulp, 2.0);
+  EXPECT_LE(measure(log_ulp, ref, 1.0f, 3e38f).max_ulp, 2.0);
+  EXPECT_LE(measure(log_fast, ref, 1e-3f, 4.0f).max_rel, 1e-5);
+  EXPECT_LE(measure(log_fast, ref, 1.0f, 3e38f).max_rel, 1e-5);
+}
+
+TEST(VecMathTest, TanhWithinBounds) {
+  const auto ref = [](double x) { return std::tanh(x); };
+  EXPECT_LE(
+      measure(
+          [](Vec x) { return executorch::vec::vec_tanh(x); }, ref, -10, 10)
+          .max_ulp,
+      2.0);
+  EXPECT_LE(
+      measure(
+          [](Vec x) {
+            return executorch::vec::vec_tanh<VecMathAccuracy::kFast>(x);
+          },
+          ref,
+          -10,
+          10)
+          .max_abs,
+      1e-6);
+}
+
+TEST(VecMathTest, ErfWithinBounds) {
+  const MathError error = measure(
+      [](Vec x) { return executorch::vec::vec_erf(x); },
+      [](double x) { return std::erf(x); },
+      -5,
+      5);
+  EXPECT_LE(error.max_ulp, 7.0);
+  EXPECT_LE(error.max_abs, 4e-7);
+}
+
+TEST(VecMathTest, SigmoidWithinBounds) {
+  const auto ref = [](double x) { return 1.0 / (1.0 + std::exp(-x)); };
+  EXPECT_LE(
+      measure(
+          [](Vec x) { return executorch::vec::vec_sigmoid(x); }, ref, -80, 80)
+          .max_ulp,
+      3.0);
+  EXPECT_LE(
+      measure(
+          [](Vec x) {
+            return executorch::vec::vec_sigmoid<VecMathAccuracy::kFast>(x);
+          },
+          ref,
+          -80,
+          80)
+          .max_rel,
+      1e-5);
+}
+
+TEST(VecMathTest, SpecialValues) {
+  const auto first = [](const Vec& v) {
+    float values[Vec::size()];
+    v.store(values);
+    return values[0];
+  };
+  EXPECT_EQ(first(executorch::vec::vec_exp(Vec(INFINITY))), INFINITY);
+  EXPECT_EQ(first(executorch::vec::vec_exp(Vec(-INFINITY))), 0.0f);
+  EXPECT_EQ(first(executorch::vec::vec_exp(Vec(0.0f))), 1.0f);
+  EXPECT_EQ(first(executorch::vec::vec_log(Vec(0.0f))), -INFINITY);
+  EXPECT_EQ(first(executorch::vec::vec_log(Vec(1.0f))), 0.0f);
+  EXPECT_EQ(first(executorch::vec::vec_log(Vec(INFINITY))), INFINITY);
+  EXPECT_TRUE(std::isnan(first(executorch::vec::vec_log(Vec(-1.0f)))));
+  EXPECT_EQ(first(executorch::vec::vec_tanh(Vec(INFINITY))), 1.0f);
+  EXPECT_NEAR(
+      first(executorch::vec::vec_tanh<VecMathAccuracy::kFast>(
+          Vec(-INFINITY))),
+      -1.0f,
+      1e-6);
+  EXPECT_EQ(first(executorch::vec::vec_erf(Vec(INFINITY))), 1.0f);
+  EXPECT_EQ(first(executorch::vec::vec_sigmoid(Vec(-INFINITY))), 0.0f);
+
+  EXPECT_TRUE(std::isnan(first(executorch::vec::vec_exp(Vec(NAN)))));
+  EXPECT_TRUE(std::isnan(first(executorch::vec::vec_log(Vec(NAN)))));
+  EXPECT_TRUE(std::isnan(first(executorch::vec::vec_tanh(Vec(NAN)))));
+  EXPECT_TRUE(std::isnan(first(
+      executorch::vec::vec_tanh<VecMathAccuracy::kFast>(Vec(NAN)))));
+  EXPECT_TRUE(std::isnan(first(executorch::vec::vec_erf(Vec(NAN)))));
+  EXPECT_TRUE(std::isnan(first(executorch::vec::vec_sigmoid(Vec(NAN)))));
+}
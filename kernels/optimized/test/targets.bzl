@@ -40,4 +40,7 @@ def define_common_targets():
 
     _lib_test_bin("libvec_test_bin")
     _lib_test_bin("moments_utils_test_bin", in_cpu = True)
+    _lib_test_bin("gemm_utils_test_bin", in_cpu = True)
+    _lib_test_bin("activation_utils_test_bin", in_cpu = True)
+    _lib_test_bin("cpu_dispatch_test_bin", in_cpu = True)
     _lib_test_bin("libblas_test_bin")
@@ -0,0 +1,749 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <executorch/kernels/optimized/vec/intrinsics.h>
+#include <executorch/kernels/optimized/vec/vec_base.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+
+// Note [16-bit float Vectorized]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Vectorized<Half> and Vectorized<BFloat16> keep their lanes as 16-bit
+// values, twice as many as a Vectorized<float>, so loads and stores move half
+// the bytes of the float equivalent. Arithmetic widens each half of the
+// vector to a Vectorized<float> (F16C / AVX512F conversions on x86, FCVTL on
+// aarch64, a shift for BFloat16), computes in float and narrows the result
+// with round to nearest even. A float holds more than twice the significand
+// bits of either type, so + - * / and sqrt computed this way give the same
+// bits as the correctly rounded 16-bit result, which is also what the scalar
+// Half operators produce.
+//
+// Where the target has native half-precision arithmetic (AVX512-FP16, or the
+// ARMv8.2 FP16 extension) Half + - * / run directly on the 16-bit lanes; the
+// results are identical for the reason above.
+//
+// Narrowing to BFloat16 uses integer rounding rather than AVX512-BF16's
+// VCVTNEPS2BF16, which flushes denormals and would make results depend on the
+// host.
+
+#if defined(CPU_CAPABILITY_AVX512) && defined(__AVX512FP16__)
+#define ET_VEC_NATIVE_HALF_AVX512
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+#define ET_VEC_NATIVE_HALF_NEON
+#endif
+
+namespace executorch {
+namespace vec {
+
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+namespace internal {
+
+inline float bfloat16_bits_to_float(uint16_t bits) {
+  // A BFloat16 is the upper half of a float.
+  const uint32_t widened = static_cast<uint32_t>(bits) << 16;
+  float result;
+  std::memcpy(&result, &widened, sizeof(result));
+  return result;
+}
+
+inline uint16_t float_to_bfloat16_bits(float value) {
+  if (std::isnan(value)) {
+    return 0x7fc0;
+  }
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  // Round to nearest, ties to even.
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+inline uint16_t half_bits(const exec_aten::Half& value) {
+  return value.x;
+}
+
+inline uint16_t half_bits(const exec_aten::BFloat16& value) {
+  return value.x;
+}
+
+template <typename T>
+inline T from_half_bits(uint16_t bits) {
+  T result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+template <typename T>
+inline T from_float(float value);
+
+template <>
+inline exec_aten::Half from_float<exec_aten::Half>(float value) {
+  return static_cast<exec_aten::Half>(value);
+}
+
+template <>
+inline exec_aten::BFloat16 from_float<exec_aten::BFloat16>(float value) {
+  return from_half_bits<exec_aten::BFloat16>(float_to_bfloat16_bits(value));
+}
+
+// The load_as_float() overloads widen Vectorized<float>::size() consecutive
+// 16-bit values at `src`; the store_as_16bit() overloads narrow `v` into as
+// many values at `dst`.
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+inline Vectorized<float> load_as_float(const exec_aten::Half* src) {
+  return _mm512_cvtph_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+}
+
+inline void store_as_16bit(const Vectorized<float>& v, exec_aten::Half* dst) {
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(dst),
+      _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+
+inline Vectorized<float> load_as_float(const exec_aten::BFloat16* src) {
+  const __m512i widened = _mm512_cvtepu16_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(widened, 16));
+}
+
+inline void store_as_16bit(
+    const Vectorized<float>& v,
+    exec_aten::BFloat16* dst) {
+  const __m512i bits = _mm512_castps_si512(v);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  __m512i rounded = _mm512_srli_epi32(
+      _mm512_add_epi32(bits, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff))),
+      16);
+  const __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+  rounded = _mm512_mask_blend_epi32(nan, rounded, _mm512_set1_epi32(0x7fc0));
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(dst), _mm512_cvtepi32_epi16(rounded));
+}
+
+#elif defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+#if defined(__F16C__)
+inline Vectorized<float> load_as_float(const exec_aten::Half* src) {
+  return _mm256_cvtph_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+inline void store_as_16bit(const Vectorized<float>& v, exec_aten::Half* dst) {
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst),
+      _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+#else // defined(__F16C__)
+inline Vectorized<float> load_as_float(const exec_aten::Half* src) {
+  __at_align__ float tmp[Vectorized<float>::size()];
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    tmp[i] = static_cast<float>(src[i]);
+  }
+  return Vectorized<float>::loadu(tmp);
+}
+
+inline void store_as_16bit(const Vectorized<float>& v, exec_aten::Half* dst) {
+  __at_align__ float tmp[Vectorized<float>::size()];
+  v.store(tmp);
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    dst[i] = static_cast<exec_aten::Half>(tmp[i]);
+  }
+}
+#endif // defined(__F16C__)
+
+inline Vectorized<float> load_as_float(const exec_aten::BFloat16* src) {
+  const __m256i widened = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(widened, 16));
+}
+
+inline void store_as_16bit(
+    const Vectorized<float>& v,
+    exec_aten::BFloat16* dst) {
+  const __m256i bits = _mm256_castps_si256(v);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  __m256i rounded = _mm256_srli_epi32(
+      _mm256_add_epi32(bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff))),
+      16);
+  const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+  rounded = _mm256_blendv_epi8(rounded, _mm256_set1_epi32(0x7fc0), nan);
+  // packus works within 128-bit lanes: {r0..r3, r0..r3, r4..r7, r4..r7} in
+  // 64-bit pieces, so gather pieces 0 and 2 into the low half.
+  const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packus_epi32(rounded, rounded), 0xD8);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(packed));
+}
+
+#elif defined(__aarch64__)
+
+inline Vectorized<float> load_as_float(const exec_aten::Half* src) {
+  const uint16_t* bits = reinterpret_cast<const uint16_t*>(src);
+  return Vectorized<float>(
+      vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(bits))),
+      vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(bits + 4))));
+}
+
+inline void store_as_16bit(const Vectorized<float>& v, exec_aten::Half* dst) {
+  uint16_t* bits = reinterpret_cast<uint16_t*>(dst);
+  vst1_u16(bits, vreinterpret_u16_f16(vcvt_f16_f32(v.get_low())));
+  vst1_u16(bits + 4, vreinterpret_u16_f16(vcvt_f16_f32(v.get_high())));
+}
+
+inline Vectorized<float> load_as_float(const exec_aten::BFloat16* src) {
+  const uint16_t* bits = reinterpret_cast<const uint16_t*>(src);
+  return Vectorized<float>(
+      vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(bits), 16)),
+      vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(bits + 4), 16)));
+}
+
+inline uint16x4_t float_to_bfloat16_neon(float32x4_t v) {
+  const uint32x4_t bits = vreinterpretq_u32_f32(v);
+  const uint32x4_t lsb = vandq_u32(vshrq_n_u32(bits, 16), vdupq_n_u32(1));
+  const uint32x4_t rounded =
+      vaddq_u32(bits, vaddq_u32(lsb, vdupq_n_u32(0x7fff)));
+  const uint32x4_t not_nan = vceqq_f32(v, v);
+  return vshrn_n_u32(
+      vbslq_u32(not_nan, rounded, vdupq_n_u32(0x7fc00000)), 16);
+}
+
+inline void store_as_16bit(
+    const Vectorized<float>& v,
+    exec_aten::BFloat16* dst) {
+  uint16_t* bits = reinterpret_cast<uint16_t*>(dst);
+  vst1_u16(bits, float_to_bfloat16_neon(v.get_low()));
+  vst1_u16(bits + 4, float_to_bfloat16_neon(v.get_high()));
+}
+
+#else
+
+inline Vectorized<float> load_as_float(const exec_aten::Half* src) {
+  __at_align__ float tmp[Vectorized<float>::size()];
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    tmp[i] = static_cast<float>(src[i]);
+  }
+  return Vectorized<float>::loadu(tmp);
+}
+
+inline void store_as_16bit(const Vectorized<float>& v, exec_aten::Half* dst) {
+  __at_align__ float tmp[Vectorized<float>::size()];
+  v.store(tmp);
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    dst[i] = static_cast<exec_aten::Half>(tmp[i]);
+  }
+}
+
+inline Vectorized<float> load_as_float(const exec_aten::BFloat16* src) {
+  __at_align__ float tmp[Vectorized<float>::size()];
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    tmp[i] = bfloat16_bits_to_float(src[i].x);
+  }
+  return Vectorized<float>::loadu(tmp);
+}
+
+inline void store_as_16bit(
+    const Vectorized<float>& v,
+    exec_aten::BFloat16* dst) {
+  __at_align__ float tmp[Vectorized<float>::size()];
+  v.store(tmp);
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    dst[i] = from_float<exec_aten::BFloat16>(tmp[i]);
+  }
+}
+
+#endif
+
+} // namespace internal
+
+/**
+ * Shared implementation of Vectorized<Half> and Vectorized<BFloat16>. See
+ * Note [16-bit float Vectorized].
+ */
+template <typename T>
+class Vectorized16 {
+ protected:
+  __at_align__ T values[2 * Vectorized<float>::size()];
+
+  // Applies `op` to the widened halves of this vector.
+  template <typename Op>
+  Vectorized<T> map_as_float(const Op& op) const {
+    Vectorized<T> result;
+    internal::store_as_16bit(
+        op(internal::load_as_float(values)), result.values);
+    internal::store_as_16bit(
+        op(internal::load_as_float(values + Vectorized<float>::size())),
+        result.values + Vectorized<float>::size());
+    return result;
+  }
+
+  // Applies `op` to the widened halves of this vector and `other`.
+  template <typename Op>
+  Vectorized<T> map2_as_float(const Vectorized<T>& other, const Op& op) const {
+    constexpr int kHalf = Vectorized<float>::size();
+    Vectorized<T> result;
+    internal::store_as_16bit(
+        op(internal::load_as_float(values),
+           internal::load_as_float(other.values)),
+        result.values);
+    internal::store_as_16bit(
+        op(internal::load_as_float(values + kHalf),
+           internal::load_as_float(other.values + kHalf)),
+        result.values + kHalf);
+    return result;
+  }
+
+  // Returns all-ones lanes where `op`, a Vectorized<float> comparison
+  // returning a bit mask, holds.
+  template <typename Op>
+  Vectorized<T> compare_as_float(const Vectorized<T>& other, const Op& op)
+      const {
+    constexpr int kHalf = Vectorized<float>::size();
+    __at_align__ uint32_t masks[2 * kHalf];
+    op(internal::load_as_float(values), internal::load_as_float(other.values))
+        .store(masks);
+    op(internal::load_as_float(values + kHalf),
+       internal::load_as_float(other.values + kHalf))
+        .store(masks + kHalf);
+    Vectorized<T> result;
+    for (int i = 0; i < size(); ++i) {
+      result.values[i] =
+          internal::from_half_bits<T>(masks[i] != 0 ? 0xffff : 0);
+    }
+    return result;
+  }
+
+ public:
+  using value_type = T;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 2 * Vectorized<float>::size();
+  }
+  Vectorized16() {
+    std::memset(values, 0, sizeof(values));
+  }
+  Vectorized16(T val) {
+    for (int i = 0; i < size(); ++i) {
+      values[i] = val;
+    }
+  }
+  Vectorized16(float val) : Vectorized16(internal::from_float<T>(val)) {}
+  inline operator const T*() const {
+    return values;
+  }
+  inline operator T*() {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    Vectorized<T> result;
+    for (int i = 0; i < size(); ++i) {
+      result.values[i] = (mask & (int64_t(1) << i)) ? b.values[i] : a.values[i];
+    }
+    return result;
+  }
+  static Vectorized<T> blendv(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      const Vectorized<T>& mask) {
+    Vectorized<T> result;
+    for (int i = 0; i < size(); ++i) {
+      result.values[i] =
+          internal::half_bits(mask.values[i]) ? b.values[i] : a.values[i];
+    }
+    return result;
+  }
+  static Vectorized<T> set(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      int64_t count = size()) {
+    Vectorized<T> result = a;
+    for (int64_t i = 0; i < count && i < size(); ++i) {
+      result.values[i] = b.values[i];
+    }
+    return result;
+  }
+  static Vectorized<T> loadu(const void* ptr) {
+    Vectorized<T> result;
+    std::memcpy(result.values, ptr, sizeof(result.values));
+    return result;
+  }
+  static Vectorized<T> loadu(const void* ptr, int64_t count) {
+    Vectorized<T> result;
+    std::memcpy(result.values, ptr, count * sizeof(T));
+    return result;
+  }
+  void store(void* ptr, int count = size()) const {
+    std::memcpy(ptr, values, count * sizeof(T));
+  }
+  int zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit
+    // and others are translated to 0-bit
+    int mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      if ((internal::half_bits(values[i]) & 0x7fff) == 0) {
+        mask |= (1 << i);
+      }
+    }
+    return mask;
+  }
+  Vectorized<T> isnan() const {
+    return compare_as_float(
+        *static_cast<const Vectorized<T>*>(this),
+        [](const Vectorized<float>& a, const Vectorized<float>&) {
+          return a.isnan();
+        });
+  }
+  Vectorized<T> map(T (*const f)(T)) const {
+    Vectorized<T> result;
+    for (int i = 0; i < size(); ++i) {
+      result.values[i] = f(values[i]);
+    }
+    return result;
+  }
+  Vectorized<T> abs() const {
+    Vectorized<T> result;
+    for (int i = 0; i < size(); ++i) {
+      result.values[i] = internal::from_half_bits<T>(
+          internal::half_bits(values[i]) & 0x7fff);
+    }
+    return result;
+  }
+  Vectorized<T> neg() const {
+    Vectorized<T> result;
+    for (int i = 0; i < size(); ++i) {
+      result.values[i] = internal::from_half_bits<T>(
+          internal::half_bits(values[i]) ^ 0x8000);
+    }
+    return result;
+  }
+#define ET_VEC16_UNARY_AS_FLOAT(name)                         \
+  Vectorized<T> name() const {                                \
+    return map_as_float(                                      \
+        [](const Vectorized<float>& x) { return x.name(); }); \
+  }
+  ET_VEC16_UNARY_AS_FLOAT(acos)
+  ET_VEC16_UNARY_AS_FLOAT(asin)
+  ET_VEC16_UNARY_AS_FLOAT(atan)
+  ET_VEC16_UNARY_AS_FLOAT(erf)
+  ET_VEC16_UNARY_AS_FLOAT(erfc)
+  ET_VEC16_UNARY_AS_FLOAT(exp)
+  ET_VEC16_UNARY_AS_FLOAT(exp2)
+  ET_VEC16_UNARY_AS_FLOAT(expm1)
+  ET_VEC16_UNARY_AS_FLOAT(frac)
+  ET_VEC16_UNARY_AS_FLOAT(log)
+  ET_VEC16_UNARY_AS_FLOAT(log10)
+  ET_VEC16_UNARY_AS_FLOAT(log1p)
+  ET_VEC16_UNARY_AS_FLOAT(log2)
+  ET_VEC16_UNARY_AS_FLOAT(ceil)
+  ET_VEC16_UNARY_AS_FLOAT(cos)
+  ET_VEC16_UNARY_AS_FLOAT(cosh)
+  ET_VEC16_UNARY_AS_FLOAT(floor)
+  ET_VEC16_UNARY_AS_FLOAT(round)
+  ET_VEC16_UNARY_AS_FLOAT(sin)
+  ET_VEC16_UNARY_AS_FLOAT(sinh)
+  ET_VEC16_UNARY_AS_FLOAT(tan)
+  ET_VEC16_UNARY_AS_FLOAT(tanh)
+  ET_VEC16_UNARY_AS_FLOAT(trunc)
+  ET_VEC16_UNARY_AS_FLOAT(lgamma)
+  ET_VEC16_UNARY_AS_FLOAT(sqrt)
+  ET_VEC16_UNARY_AS_FLOAT(reciprocal)
+  ET_VEC16_UNARY_AS_FLOAT(rsqrt)
+#undef ET_VEC16_UNARY_AS_FLOAT
+#define ET_VEC16_BINARY_AS_FLOAT(name)                                  \
+  Vectorized<T> name(const Vectorized<T>& b) const {                    \
+    return map2_as_float(                                               \
+        b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return x.name(y);                                             \
+        });                                                             \
+  }
+  ET_VEC16_BINARY_AS_FLOAT(atan2)
+  ET_VEC16_BINARY_AS_FLOAT(copysign)
+  ET_VEC16_BINARY_AS_FLOAT(fmod)
+  ET_VEC16_BINARY_AS_FLOAT(hypot)
+  ET_VEC16_BINARY_AS_FLOAT(pow)
+#undef ET_VEC16_BINARY_AS_FLOAT
+#define ET_VEC16_COMPARE_AS_FLOAT(op)                                       \
+  Vectorized<T> operator op(const Vectorized<T>& other) const {             \
+    return compare_as_float(                                                \
+        other, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return x op y;                                                    \
+        });                                                                 \
+  }
+  ET_VEC16_COMPARE_AS_FLOAT(==)
+  ET_VEC16_COMPARE_AS_FLOAT(!=)
+  ET_VEC16_COMPARE_AS_FLOAT(<)
+  ET_VEC16_COMPARE_AS_FLOAT(<=)
+  ET_VEC16_COMPARE_AS_FLOAT(>)
+  ET_VEC16_COMPARE_AS_FLOAT(>=)
+#undef ET_VEC16_COMPARE_AS_FLOAT
+#define ET_VEC16_COMPARE_BOOL_AS_FLOAT(name)                         \
+  Vectorized<T> name(const Vectorized<T>& other) const {             \
+    return map2_as_float(                                            \
+        other,                                                       \
+        [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return x.name(y);                                          \
+        });                                                          \
+  }
+  ET_VEC16_COMPARE_BOOL_AS_FLOAT(eq)
+  ET_VEC16_COMPARE_BOOL_AS_FLOAT(ne)
+  ET_VEC16_COMPARE_BOOL_AS_FLOAT(gt)
+  ET_VEC16_COMPARE_BOOL_AS_FLOAT(ge)
+  ET_VEC16_COMPARE_BOOL_AS_FLOAT(lt)
+  ET_VEC16_COMPARE_BOOL_AS_FLOAT(le)
+#undef ET_VEC16_COMPARE_BOOL_AS_FLOAT
+};
+
+template <>
+class Vectorized<exec_aten::Half> : public Vectorized16<exec_aten::Half> {
+ public:
+  using Vectorized16<exec_aten::Half>::Vectorized16;
+};
+
+template <>
+class Vectorized<exec_aten::BFloat16>
+    : public Vectorized16<exec_aten::BFloat16> {
+ public:
+  using Vectorized16<exec_aten::BFloat16>::Vectorized16;
+};
+
+/**
+ * Widens the lanes of a Vectorized<Half> or Vectorized<BFloat16> into two
+ * Vectorized<float>: the first holds lanes [0, Vectorized<float>::size()),
+ * the second the rest.
+ */
+template <typename T>
+inline std::tuple<Vectorized<float>, Vectorized<float>> convert_to_float(
+    const Vectorized<T>& a) {
+  const T* values = a;
+  return std::make_tuple(
+      internal::load_as_float(values),
+      internal::load_as_float(values + Vectorized<float>::size()));
+}
+
+/**
+ * Narrows two Vectorized<float> into a Vectorized<Half> or
+ * Vectorized<BFloat16>, rounding to nearest even; the inverse of
+ * convert_to_float().
+ */
+template <typename T>
+inline Vectorized<T> convert_from_float(
+    const Vectorized<float>& a,
+    const Vectorized<float>& b) {
+  Vectorized<T> result;
+  T* values = result;
+  internal::store_as_16bit(a, values);
+  internal::store_as_16bit(b, values + Vectorized<float>::size());
+  return result;
+}
+
+/**
+ * Widens Vectorized<float>::size() 16-bit values at `src` to float.
+ */
+template <typename T>
+inline Vectorized<float> load_as_float(const T* src) {
+  return internal::load_as_float(src);
+}
+
+/**
+ * Narrows `v` into Vectorized<float>::size() 16-bit values at `dst`.
+ */
+template <typename T>
+inline void store_as_16bit(const Vectorized<float>& v, T* dst) {
+  internal::store_as_16bit(v, dst);
+}
+
+/**
+ * Computes `op`, which maps two Vectorized<float> to one, on the widened
+ * lanes of `a` and `b`, rounding only the final result to T. Use it to
+ * evaluate an expression of several operations with a single rounding.
+ */
+template <typename T, typename Op>
+inline Vectorized<T> binary_op_as_float(
+    const Vectorized<T>& a,
+    const Vectorized<T>& b,
+    const Op& op) {
+  Vectorized<float> a0, a1, b0, b1;
+  std::tie(a0, a1) = convert_to_float(a);
+  std::tie(b0, b1) = convert_to_float(b);
+  return convert_from_float<T>(op(a0, b0), op(a1, b1));
+}
+
+namespace internal {
+
+#if defined(ET_VEC_NATIVE_HALF_AVX512)
+
+template <typename Op>
+inline Vectorized<exec_aten::Half> native_half_binary_op(
+    const Vectorized<exec_aten::Half>& a,
+    const Vectorized<exec_aten::Half>& b,
+    const Op& op) {
+  static_assert(Vectorized<exec_aten::Half>::size() == 32, "");
+  const __m512h result = op(
+      _mm512_loadu_ph(static_cast<const exec_aten::Half*>(a)),
+      _mm512_loadu_ph(static_cast<const exec_aten::Half*>(b)));
+  __at_align__ exec_aten::Half tmp[32];
+  _mm512_storeu_ph(tmp, result);
+  return Vectorized<exec_aten::Half>::loadu(tmp);
+}
+
+#elif defined(ET_VEC_NATIVE_HALF_NEON)
+
+template <typename Op>
+inline Vectorized<exec_aten::Half> native_half_binary_op(
+    const Vectorized<exec_aten::Half>& a,
+    const Vectorized<exec_aten::Half>& b,
+    const Op& op) {
+  static_assert(Vectorized<exec_aten::Half>::size() == 16, "");
+  const float16_t* a_ptr = reinterpret_cast<const float16_t*>(
+      static_cast<const exec_aten::Half*>(a));
+  const float16_t* b_ptr = reinterpret_cast<const float16_t*>(
+      static_cast<const exec_aten::Half*>(b));
+  __at_align__ float16_t tmp[16];
+  vst1q_f16(tmp, op(vld1q_f16(a_ptr), vld1q_f16(b_ptr)));
+  vst1q_f16(tmp + 8, op(vld1q_f16(a_ptr + 8), vld1q_f16(b_ptr + 8)));
+  return Vectorized<exec_aten::Half>::loadu(tmp);
+}
+
+#endif
+
+} // namespace internal
+
+#if defined(ET_VEC_NATIVE_HALF_AVX512)
+#define ET_VEC_HALF_BINARY_OP(op, avx512_intrinsic, neon_intrinsic)         \
+  template <>                                                               \
+  Vectorized<exec_aten::Half> inline operator op(                           \
+      const Vectorized<exec_aten::Half>& a,                                 \
+      const Vectorized<exec_aten::Half>& b) {                               \
+    return internal::native_half_binary_op(                                 \
+        a, b, [](__m512h x, __m512h y) { return avx512_intrinsic(x, y); }); \
+  }
+#elif defined(ET_VEC_NATIVE_HALF_NEON)
+#define ET_VEC_HALF_BINARY_OP(op, avx512_intrinsic, neon_intrinsic) \
+  template <>                                                       \
+  Vectorized<exec_aten::Half> inline operator op(                   \
+      const Vectorized<exec_aten::Half>& a,                         \
+      const Vectorized<exec_aten::Half>& b) {                       \
+    return internal::native_half_binary_op(                         \
+        a, b, [](float16x8_t x, float16x8_t y) {                    \
+          return neon_intrinsic(x, y);                              \
+        });                                                         \
+  }
+#else
+#define ET_VEC_HALF_BINARY_OP(op, avx512_intrinsic, neon_intrinsic)        \
+  template <>                                                              \
+  Vectorized<exec_aten::Half> inline operator op(                          \
+      const Vectorized<exec_aten::Half>& a,                                \
+      const Vectorized<exec_aten::Half>& b) {                              \
+    return binary_op_as_float(                                             \
+        a, b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return x op y;                                                   \
+        });                                                                \
+  }
+#endif
+
+ET_VEC_HALF_BINARY_OP(+, _mm512_add_ph, vaddq_f16)
+ET_VEC_HALF_BINARY_OP(-, _mm512_sub_ph, vsubq_f16)
+ET_VEC_HALF_BINARY_OP(*, _mm512_mul_ph, vmulq_f16)
+ET_VEC_HALF_BINARY_OP(/, _mm512_div_ph, vdivq_f16)
+#undef ET_VEC_HALF_BINARY_OP
+
+#define ET_VEC_BFLOAT16_BINARY_OP(op)                                      \
+  template <>                                                              \
+  Vectorized<exec_aten::BFloat16> inline operator op(                      \
+      const Vectorized<exec_aten::BFloat16>& a,                            \
+      const Vectorized<exec_aten::BFloat16>& b) {                          \
+    return binary_op_as_float(                                             \
+        a, b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return x op y;                                                   \
+        });                                                                \
+  }
+
+ET_VEC_BFLOAT16_BINARY_OP(+)
+ET_VEC_BFLOAT16_BINARY_OP(-)
+ET_VEC_BFLOAT16_BINARY_OP(*)
+ET_VEC_BFLOAT16_BINARY_OP(/)
+#undef ET_VEC_BFLOAT16_BINARY_OP
+
+#define ET_VEC16_FREE_FUNCTIONS(T)                                         \
+  template <>                                                              \
+  Vectorized<T> inline maximum(                                            \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return binary_op_as_float(                                             \
+        a, b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return maximum(x, y);                                            \
+        });                                                                \
+  }                                                                        \
+  template <>                                                              \
+  Vectorized<T> inline minimum(                                            \
+      const Vectorized<T>& a, const Vectorized<T>& b) {                    \
+    return binary_op_as_float(                                             \
+        a, b, [](const Vectorized<float>& x, const Vectorized<float>& y) { \
+          return minimum(x, y);                                            \
+        });                                                                \
+  }                                                                        \
+  template <>                                                              \
+  Vectorized<T> inline clamp_min(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& min_vec) {              \
+    return binary_op_as_float(                                             \
+        a,                                                                 \
+        min_vec,                                                           \
+        [](const Vectorized<float>& x, const Vectorized<float>& y) {       \
+          return clamp_min(x, y);                                          \
+        });                                                                \
+  }                                                                        \
+  template <>                                                              \
+  Vectorized<T> inline clamp_max(                                          \
+      const Vectorized<T>& a, const Vectorized<T>& max_vec) {              \
+    return binary_op_as_float(                                             \
+        a,                                                                 \
+        max_vec,                                                           \
+        [](const Vectorized<float>& x, const Vectorized<float>& y) {       \
+          return clamp_max(x, y);                                          \
+        });                                                                \
+  }                                                                        \
+  template <>                                                              \
+  Vectorized<T> inline clamp(                                              \
+      const Vectorized<T>& a,                                              \
+      const Vectorized<T>& min_vec,                                        \
+      const Vectorized<T>& max_vec) {                                      \
+    return clamp_max(clamp_min(a, min_vec), max_vec);                      \
+  }                                                                        \
+  template <>                                                              \
+  Vectorized<T> inline fmadd(                                              \
+      const Vectorized<T>& a,                                              \
+      const Vectorized<T>& b,                                              \
+      const Vectorized<T>& c) {                                            \
+    Vectorized<float> a0, a1, b0, b1, c0, c1;                              \
+    std::tie(a0, a1) = convert_to_float(a);                                \
+    std::tie(b0, b1) = convert_to_float(b);                                \
+    std::tie(c0, c1) = convert_to_float(c);                                \
+    return convert_from_float<T>(fmadd(a0, b0, c0), fmadd(a1, b1, c1));    \
+  }
+
+ET_VEC16_FREE_FUNCTIONS(exec_aten::Half)
+ET_VEC16_FREE_FUNCTIONS(exec_aten::BFloat16)
+#undef ET_VEC16_FREE_FUNCTIONS
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace executorch
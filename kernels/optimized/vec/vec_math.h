@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <executorch/kernels/optimized/vec/intrinsics.h>
+#include <executorch/kernels/optimized/vec/vec_base.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Note [Polynomial transcendentals]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// vec_exp(), vec_log(), vec_tanh(), vec_erf() and vec_sigmoid() evaluate
+// their functions with range reduction and polynomial or rational
+// approximations written in Vectorized<float> arithmetic, so they stay in
+// vector registers on every CPU capability. The member functions of
+// Vectorized<float> (exp(), log(), ...) go to Sleef where it is built in,
+// and otherwise to libm one lane at a time, e.g. on aarch64 without
+// ET_BUILD_ARM_VEC256_WITH_SLEEF and in DEFAULT builds.
+//
+// Each function takes a VecMathAccuracy:
+// - kUlp keeps the error within a few ULP of the correctly rounded result
+//   over the whole float range, subnormal results included; see the bounds
+//   on each function.
+// - kFast uses shorter polynomials and bounds the relative error by 1e-5
+//   (the absolute error for tanh), for activations and softmax, whose
+//   consumers don't need more. Results below 2^-125 may flush to zero.
+//
+// NaN inputs give NaN for every function and tier.
+
+namespace executorch {
+namespace vec {
+
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+enum class VecMathAccuracy {
+  kUlp,
+  kFast,
+};
+
+namespace internal {
+
+// 2^n for integral n in [-126, 127].
+inline Vectorized<float> pow2i(const Vectorized<float>& n);
+
+// Splits positive normal floats into a mantissa in [1, 2), which it returns,
+// and an unbiased exponent.
+inline Vectorized<float> frexp1(
+    const Vectorized<float>& x,
+    Vectorized<float>* exponent);
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+inline Vectorized<float> pow2i(const Vectorized<float>& n) {
+  const __m512i biased =
+      _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(biased, 23));
+}
+
+inline Vectorized<float> frexp1(
+    const Vectorized<float>& x,
+    Vectorized<float>* exponent) {
+  const __m512i bits = _mm512_castps_si512(x);
+  *exponent = _mm512_cvtepi32_ps(
+      _mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(127)));
+  return _mm512_castsi512_ps(_mm512_or_si512(
+      _mm512_and_si512(bits, _mm512_set1_epi32(0x007fffff)),
+      _mm512_set1_epi32(0x3f800000)));
+}
+
+#elif defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+inline Vectorized<float> pow2i(const Vectorized<float>& n) {
+  const __m256i biased =
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23));
+}
+
+inline Vectorized<float> frexp1(
+    const Vectorized<float>& x,
+    Vectorized<float>* exponent) {
+  const __m256i bits = _mm256_castps_si256(x);
+  *exponent = _mm256_cvtepi32_ps(
+      _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+  return _mm256_castsi256_ps(_mm256_or_si256(
+      _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+      _mm256_set1_epi32(0x3f800000)));
+}
+
+#elif defined(__aarch64__)
+
+inline float32x4_t pow2i_neon(float32x4_t n) {
+  const int32x4_t biased = vaddq_s32(vcvtnq_s32_f32(n), vdupq_n_s32(127));
+  return vreinterpretq_f32_s32(vshlq_n_s32(biased, 23));
+}
+
+inline Vectorized<float> pow2i(const Vectorized<float>& n) {
+  return Vectorized<float>(
+      pow2i_neon(n.get_low()), pow2i_neon(n.get_high()));
+}
+
+inline float32x4_t frexp1_neon(float32x4_t x, float32x4_t* exponent) {
+  const uint32x4_t bits = vreinterpretq_u32_f32(x);
+  *exponent = vcvtq_f32_s32(vsubq_s32(
+      vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+  return vreinterpretq_f32_u32(vorrq_u32(
+      vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+}
+
+inline Vectorized<float> frexp1(
+    const Vectorized<float>& x,
+    Vectorized<float>* exponent) {
+  float32x4_t exponent_low;
+  float32x4_t exponent_high;
+  const float32x4_t low = frexp1_neon(x.get_low(), &exponent_low);
+  const float32x4_t high = frexp1_neon(x.get_high(), &exponent_high);
+  *exponent = Vectorized<float>(exponent_low, exponent_high);
+  return Vectorized<float>(low, high);
+}
+
+#else
+
+inline Vectorized<float> pow2i(const Vectorized<float>& n) {
+  __at_align__ float values[Vectorized<float>::size()];
+  n.store(values);
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    // NaN lanes stay NaN through the other factor.
+    const int32_t exponent =
+        values[i] == values[i] ? static_cast<int32_t>(values[i]) : 0;
+    const uint32_t bits = static_cast<uint32_t>(exponent + 127) << 23;
+    std::memcpy(&values[i], &bits, sizeof(bits));
+  }
+  return Vectorized<float>::loadu(values);
+}
+
+inline Vectorized<float> frexp1(
+    const Vectorized<float>& x,
+    Vectorized<float>* exponent) {
+  __at_align__ float values[Vectorized<float>::size()];
+  __at_align__ float exponents[Vectorized<float>::size()];
+  x.store(values);
+  for (int i = 0; i < Vectorized<float>::size(); ++i) {
+    uint32_t bits;
+    std::memcpy(&bits, &values[i], sizeof(bits));
+    exponents[i] = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    std::memcpy(&values[i], &bits, sizeof(bits));
+  }
+  *exponent = Vectorized<float>::loadu(exponents);
+  return Vectorized<float>::loadu(values);
+}
+
+#endif
+
+// Rounds to the nearest integer, ties to even, for |x| < 2^22. Adding and
+// subtracting 1.5 * 2^23 leaves no fraction bits to round into.
+inline Vectorized<float> round_small(const Vectorized<float>& x) {
+  const Vectorized<float> magic(12582912.0f);
+  return (x + magic) - magic;
+}
+
+// Evaluates the polynomial with coefficients `c`, highest degree first.
+template <int N>
+inline Vectorized<float> horner(
+    const Vectorized<float>& x,
+    const float (&c)[N]) {
+  Vectorized<float> result(c[0]);
+  for (int i = 1; i < N; ++i) {
+    result = fmadd(result, x, Vectorized<float>(c[i]));
+  }
+  return result;
+}
+
+} // namespace internal
+
+/**
+ * e^x. kUlp: within 2 ULP. kFast: relative error below 1e-5, zero below
+ * e^-86.6.
+ */
+template <VecMathAccuracy accuracy = VecMathAccuracy::kUlp>
+inline Vectorized<float> vec_exp(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  constexpr float kLog2e = 1.44269504088896341f;
+  // ln(2) split so that n * kLn2Hi is exact.
+  constexpr float kLn2Hi = 0.693359375f;
+  constexpr float kLn2Lo = -2.12194440e-4f;
+  // Above this e^x overflows.
+  constexpr float kMaxX = 88.72283935546875f;
+  constexpr bool kUlp = accuracy == VecMathAccuracy::kUlp;
+  // Below this e^x rounds to zero; kFast flushes the subnormal results.
+  constexpr float kMinX = kUlp ? -103.972084045410f : -86.6433982849f;
+
+  const Vec clamped = minimum(maximum(x, Vec(kMinX)), Vec(kMaxX));
+  // x = n * ln(2) + r, |r| <= ln(2) / 2.
+  const Vec n = internal::round_small(clamped * Vec(kLog2e));
+  Vec r = fmadd(n, Vec(-kLn2Hi), clamped);
+  r = fmadd(n, Vec(-kLn2Lo), r);
+
+  // e^r = 1 + r + r^2 * p(r).
+  Vec p;
+  if (kUlp) {
+    constexpr float kCoeffs[] = {
+        1.9875691500e-4f,
+        1.3981999507e-3f,
+        8.3334519073e-3f,
+        4.1665795894e-2f,
+        1.6666665459e-1f,
+        5.0000001201e-1f};
+    p = internal::horner(r, kCoeffs);
+  } else {
+    constexpr float kCoeffs[] = {
+        4.12777352e-2f, 1.67535144e-1f, 5.00051162e-1f};
+    p = internal::horner(r, kCoeffs);
+  }
+  const Vec y = fmadd(p, r * r, r + Vec(1.0f));
+
+  Vec result;
+  if (kUlp) {
+    // n is in [-150, 128]; scale in two steps so that neither factor leaves
+    // the normal range and subnormal results round only once.
+    const Vec n1 = minimum(maximum(n, Vec(-126.0f)), Vec(127.0f));
+    result = y * internal::pow2i(n1) * internal::pow2i(n - n1);
+  } else {
+    // n is in [-125, 128].
+    result = (y + y) * internal::pow2i(n - Vec(1.0f));
+  }
+  result = Vec::blendv(
+      result, Vec(std::numeric_limits<float>::infinity()), x > Vec(kMaxX));
+  return Vec::blendv(result, Vec(0.0f), x < Vec(kMinX));
+}
+
+/**
+ * Natural logarithm. kUlp: within 2 ULP. kFast: relative error below 1e-5.
+ */
+template <VecMathAccuracy accuracy = VecMathAccuracy::kUlp>
+inline Vectorized<float> vec_log(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  constexpr float kLn2Hi = 0.693359375f;
+  constexpr float kLn2Lo = -2.12194440e-4f;
+  constexpr float kSqrt2 = 1.41421356237f;
+
+  // Scale subnormals into the normal range.
+  const Vec subnormal = x < Vec(std::numeric_limits<float>::min());
+  Vec e;
+  Vec m = internal::frexp1(
+      Vec::blendv(x, x * Vec(8388608.0f), subnormal), &e);
+  e = Vec::blendv(e, e - Vec(23.0f), subnormal);
+
+  // x = m * 2^e with m in [sqrt(2) / 2, sqrt(2)).
+  const Vec big = m > Vec(kSqrt2);
+  m = Vec::blendv(m, m * Vec(0.5f), big);
+  e = Vec::blendv(e, e + Vec(1.0f), big);
+  const Vec t = m - Vec(1.0f);
+  const Vec t2 = t * t;
+
+  // log(1 + t) = t - t^2 / 2 + t^3 * p(t).
+  Vec p;
+  if (accuracy == VecMathAccuracy::kUlp) {
+    constexpr float kCoeffs[] = {
+        7.0376836292e-2f,
+        -1.1514610310e-1f,
+        1.1676998740e-1f,
+        -1.2420140846e-1f,
+        1.4249322787e-1f,
+        -1.6668057665e-1f,
+        2.0000714765e-1f,
+        -2.4999993993e-1f,
+        3.3333331174e-1f};
+    p = internal::horner(t, kCoeffs);
+  } else {
+    constexpr float kCoeffs[] = {
+        1.17817891e-1f,
+        -1.84071807e-1f,
+        2.04422071e-1f,
+        -2.49438332e-1f,
+        3.33208601e-1f};
+    p = internal::horner(t, kCoeffs);
+  }
+  Vec y = p * t * t2;
+  y = fmadd(e, Vec(kLn2Lo), y);
+  y = fmadd(t2, Vec(-0.5f), y);
+  Vec result = fmadd(e, Vec(kLn2Hi), t + y);
+
+  result = Vec::blendv(
+      result, Vec(-std::numeric_limits<float>::infinity()), x == Vec(0.0f));
+  result = Vec::blendv(
+      result, Vec(std::numeric_limits<float>::quiet_NaN()), x < Vec(0.0f));
+  result = Vec::blendv(
+      result, x, x == Vec(std::numeric_limits<float>::infinity()));
+  return Vec::blendv(result, x, x.isnan());
+}
+
+/**
+ * Hyperbolic tangent. kUlp: within 2 ULP. kFast: absolute error below 1e-6.
+ */
+template <VecMathAccuracy accuracy = VecMathAccuracy::kUlp>
+inline Vectorized<float> vec_tanh(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  if (accuracy == VecMathAccuracy::kUlp) {
+    const Vec ax = x.abs();
+    // Small inputs: an odd polynomial, tanh(x) = x + x^3 * p(x^2).
+    const Vec x2 = x * x;
+    constexpr float kCoeffs[] = {
+        -5.70498872745e-3f,
+        2.06390887954e-2f,
+        -5.37397155531e-2f,
+        1.33314422036e-1f,
+        -3.33332819422e-1f};
+    const Vec small = fmadd(internal::horner(x2, kCoeffs) * x2, x, x);
+    // Large inputs: 1 - 2 / (e^2|x| + 1), with the sign of x.
+    Vec large = Vec(1.0f) -
+        Vec(2.0f) / (vec_exp<VecMathAccuracy::kUlp>(ax + ax) + Vec(1.0f));
+    large = Vec::blendv(large, large.neg(), x < Vec(0.0f));
+    return Vec::blendv(small, large, ax >= Vec(0.625f));
+  }
+  // A rational approximation, tanh(x) = x * p(x^2) / q(x^2), which reaches
+  // +/-1 in float at the clamp.
+  constexpr float kClamp = 7.90531110763549805f;
+  const Vec clamped = minimum(maximum(x, Vec(-kClamp)), Vec(kClamp));
+  const Vec x2 = clamped * clamped;
+  constexpr float kNumerator[] = {
+      -2.76076847742355e-16f,
+      2.00018790482477e-13f,
+      -8.60467152213735e-11f,
+      5.12229709037114e-08f,
+      1.48572235717979e-05f,
+      6.37261928875436e-04f,
+      4.89352455891786e-03f};
+  constexpr float kDenominator[] = {
+      1.19825839466702e-06f,
+      1.18534705686654e-04f,
+      2.26843463243900e-03f,
+      4.89352518554385e-03f};
+  const Vec result = clamped * internal::horner(x2, kNumerator) /
+      internal::horner(x2, kDenominator);
+  // Tiny inputs, where tanh(x) rounds to x.
+  return Vec::blendv(result, x, x.abs() < Vec(0.0004f));
+}
+
+/**
+ * The error function, within 7 ULP and absolute error 4e-7 for either tier.
+ */
+template <VecMathAccuracy accuracy = VecMathAccuracy::kUlp>
+inline Vectorized<float> vec_erf(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  // erf(x) = x * p(x^2) / q(x^2) on [-4, 4]; erf rounds to +/-1 beyond.
+  constexpr float kClamp = 4.0f;
+  const Vec clamped = minimum(maximum(x, Vec(-kClamp)), Vec(kClamp));
+  const Vec x2 = clamped * clamped;
+  constexpr float kNumerator[] = {
+      -2.72614225801306e-10f,
+      2.77068142495902e-08f,
+      -2.10102402082508e-06f,
+      -5.69250639462346e-05f,
+      -7.34990630326855e-04f,
+      -2.95459980854025e-03f,
+      -1.60960333262415e-02f};
+  constexpr float kDenominator[] = {
+      -1.45660718464996e-05f,
+      -2.13374055278905e-04f,
+      -1.68282697438203e-03f,
+      -7.37332916720468e-03f,
+      -1.42647390514189e-02f};
+  // Both tiers share this approximation, which is already short.
+  (void)accuracy;
+  return clamped *
+      (internal::horner(x2, kNumerator) / internal::horner(x2, kDenominator));
+}
+
+/**
+ * The logistic function 1 / (1 + e^-x), computed as e^x / (1 + e^x) for
+ * negative x so that it keeps its relative accuracy there. kUlp: within 3
+ * ULP. kFast: relative error below 1e-5.
+ */
+template <VecMathAccuracy accuracy = VecMathAccuracy::kUlp>
+inline Vectorized<float> vec_sigmoid(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  const Vec e = vec_exp<accuracy>(x.abs().neg());
+  const Vec s = Vec(1.0f) / (Vec(1.0f) + e);
+  return Vec::blendv(s, e * s, x < Vec(0.0f));
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace executorch
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// The opcodes of an elementwise_chain program. They are serialized into
+// programs, so only append; keep in sync with ElementwiseChainOp in
+// exir/passes/fused_elementwise_ops_registry.py.
+enum class ChainOp : int64_t {
+  kAdd = 0,
+  kSub = 1,
+  kMul = 2,
+  kDiv = 3,
+  kAddScalar = 4,
+  kMulScalar = 5,
+  kNeg = 6,
+  kRelu = 7,
+  kSigmoid = 8,
+  kTanh = 9,
+  kExp = 10,
+};
+
+// Each step is (opcode, register, register or scalar index).
+constexpr size_t kStepSize = 3;
+constexpr size_t kMaxSteps = 16;
+constexpr size_t kMaxInputs = 16;
+
+// The number of elements that a step processes before the next step runs, so
+// that the intermediates of a block stay in L1.
+constexpr int64_t kBlockSize = 128;
+
+bool is_binary(ChainOp op) {
+  return op == ChainOp::kAdd || op == ChainOp::kSub || op == ChainOp::kMul ||
+      op == ChainOp::kDiv;
+}
+
+bool is_scalar(ChainOp op) {
+  return op == ChainOp::kAddScalar || op == ChainOp::kMulScalar;
+}
+
+bool check_elementwise_chain_args(
+    exec_aten::ArrayRef<Tensor> inputs,
+    IntArrayRef program,
+    exec_aten::ArrayRef<double> scalars,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      inputs.size() > 0 && inputs.size() <= kMaxInputs,
+      "Expected 1 to %zu inputs, got %zu",
+      kMaxInputs,
+      inputs.size());
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      program.size() > 0 && program.size() % kStepSize == 0 &&
+          program.size() / kStepSize <= kMaxSteps,
+      "Program must hold 1 to %zu steps of %zu values, got %zu values",
+      kMaxSteps,
+      kStepSize,
+      program.size());
+  for (const Tensor& input : inputs) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_shape_and_dtype(input, out));
+    ET_LOG_AND_RETURN_IF_FALSE(input.dim_order().equals(out.dim_order()));
+  }
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_floating_type(out));
+
+  const size_t num_steps = program.size() / kStepSize;
+  for (size_t step = 0; step < num_steps; ++step) {
+    const int64_t opcode = program[step * kStepSize];
+    const int64_t arg0 = program[step * kStepSize + 1];
+    const int64_t arg1 = program[step * kStepSize + 2];
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        opcode >= 0 && opcode <= static_cast<int64_t>(ChainOp::kExp),
+        "Unknown opcode %" PRId64 " in step %zu",
+        opcode,
+        step);
+    // Steps may only read the inputs and the results of earlier steps.
+    const int64_t num_registers = inputs.size() + step;
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        arg0 >= 0 && arg0 < num_registers,
+        "Step %zu reads register %" PRId64 " of %" PRId64,
+        step,
+        arg0,
+        num_registers);
+    const ChainOp op = static_cast<ChainOp>(opcode);
+    if (is_binary(op)) {
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          arg1 >= 0 && arg1 < num_registers,
+          "Step %zu reads register %" PRId64 " of %" PRId64,
+          step,
+          arg1,
+          num_registers);
+    } else if (is_scalar(op)) {
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          arg1 >= 0 && arg1 < static_cast<int64_t>(scalars.size()),
+          "Step %zu reads scalar %" PRId64 " of %zu",
+          step,
+          arg1,
+          scalars.size());
+    }
+  }
+  return true;
+}
+
+template <typename CTYPE, typename Op>
+inline void
+map_block(const Op& fn, const CTYPE* a, CTYPE* result, const int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    result[i] = fn(a[i]);
+  }
+}
+
+template <typename CTYPE, typename Op>
+inline void map2_block(
+    const Op& fn,
+    const CTYPE* a,
+    const CTYPE* b,
+    CTYPE* result,
+    const int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    result[i] = fn(a[i], b[i]);
+  }
+}
+
+// Runs one step over `count` elements. Each step rounds to CTYPE and matches
+// the portable kernel of the op it replaces, so fusing doesn't change results.
+template <typename CTYPE>
+void run_step(
+    const ChainOp op,
+    const CTYPE* a,
+    const CTYPE* b,
+    const CTYPE scalar,
+    CTYPE* result,
+    const int64_t count) {
+  switch (op) {
+    case ChainOp::kAdd:
+      map2_block([](CTYPE x, CTYPE y) { return x + y; }, a, b, result, count);
+      break;
+    case ChainOp::kSub:
+      map2_block([](CTYPE x, CTYPE y) { return x - y; }, a, b, result, count);
+      break;
+    case ChainOp::kMul:
+      map2_block([](CTYPE x, CTYPE y) { return x * y; }, a, b, result, count);
+      break;
+    case ChainOp::kDiv:
+      map2_block([](CTYPE x, CTYPE y) { return x / y; }, a, b, result, count);
+      break;
+    case ChainOp::kAddScalar:
+      map_block([scalar](CTYPE x) { return x + scalar; }, a, result, count);
+      break;
+    case ChainOp::kMulScalar:
+      map_block([scalar](CTYPE x) { return x * scalar; }, a, result, count);
+      break;
+    case ChainOp::kNeg:
+      map_block([](CTYPE x) { return -x; }, a, result, count);
+      break;
+    case ChainOp::kRelu:
+      map_block(
+          [](CTYPE x) {
+            return (std::isnan(x) || x >= CTYPE(0)) ? x : CTYPE(0);
+          },
+          a,
+          result,
+          count);
+      break;
+    case ChainOp::kSigmoid:
+      map_block(
+          [](CTYPE x) {
+            return static_cast<CTYPE>(
+                1.0 / (1.0 + std::exp(-static_cast<double>(x))));
+          },
+          a,
+          result,
+          count);
+      break;
+    case ChainOp::kTanh:
+      map_block(
+          [](CTYPE x) {
+            return static_cast<CTYPE>(std::tanh(static_cast<double>(x)));
+          },
+          a,
+          result,
+          count);
+      break;
+    case ChainOp::kExp:
+      map_block(
+          [](CTYPE x) {
+            return static_cast<CTYPE>(std::exp(static_cast<double>(x)));
+          },
+          a,
+          result,
+          count);
+      break;
+  }
+}
+
+template <typename CTYPE>
+void run_program(
+    exec_aten::ArrayRef<Tensor> inputs,
+    IntArrayRef program,
+    exec_aten::ArrayRef<double> scalars,
+    Tensor& out) {
+  const size_t num_inputs = inputs.size();
+  const size_t num_steps = program.size() / kStepSize;
+  const CTYPE* input_data[kMaxInputs];
+  for (size_t i = 0; i < num_inputs; ++i) {
+    input_data[i] = inputs[i].const_data_ptr<CTYPE>();
+  }
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  elementwise_parallel_for(
+      out.numel(), [&](const int64_t begin, const int64_t end) {
+        // Intermediates live here; only the last step writes to `out`.
+        CTYPE temps[kMaxSteps - 1][kBlockSize];
+        const CTYPE* registers[kMaxInputs + kMaxSteps];
+        for (int64_t start = begin; start < end; start += kBlockSize) {
+          const int64_t count = std::min(kBlockSize, end - start);
+          for (size_t i = 0; i < num_inputs; ++i) {
+            registers[i] = input_data[i] + start;
+          }
+          for (size_t step = 0; step < num_steps; ++step) {
+            const ChainOp op = static_cast<ChainOp>(program[step * kStepSize]);
+            const int64_t arg1 = program[step * kStepSize + 2];
+            CTYPE* result =
+                step + 1 == num_steps ? out_data + start : temps[step];
+            run_step<CTYPE>(
+                op,
+                registers[program[step * kStepSize + 1]],
+                is_binary(op) ? registers[arg1] : nullptr,
+                is_scalar(op) ? static_cast<CTYPE>(scalars[arg1]) : CTYPE(0),
+                result,
+                count);
+            registers[num_inputs + step] = result;
+          }
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Runs a chain of elementwise ops over same-shaped tensors in one pass,
+ * keeping the intermediates in registers instead of writing them to memory.
+ * exir/passes/fuse_elementwise_chain_pass.py builds the calls.
+ *
+ * Registers [0, inputs.size()) hold the inputs, and step i writes register
+ * inputs.size() + i. `program` lists the steps as (opcode, register, operand)
+ * triples, where the operand is a register for binary ops, an index into
+ * `scalars` for scalar ops, and ignored for unary ops. The last step writes
+ * `out`.
+ *
+ * elementwise_chain.out(Tensor[] inputs, int[] program, float[] scalars, *,
+ *     Tensor(a!) out) -> Tensor(a!)
+ */
+Tensor& elementwise_chain_out(
+    RuntimeContext& ctx,
+    exec_aten::ArrayRef<Tensor> inputs,
+    IntArrayRef program,
+    exec_aten::ArrayRef<double> scalars,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      inputs.size() > 0 &&
+          resize_tensor(out, inputs[0].sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      check_elementwise_chain_args(inputs, program, scalars, out),
+      InvalidArgument,
+      out);
+
+  ET_SWITCH_FLOAT_TYPES(
+      out.scalar_type(), ctx, "elementwise_chain.out", CTYPE, [&]() {
+        run_program<CTYPE>(inputs, program, scalars, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,10 +6,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <tuple>
 
 #include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -66,17 +68,20 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
       InvalidArgument,
       ret_val);
 
-  // For now, only support the contiguous dim order
   ET_KERNEL_CHECK(
       ctx,
-      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      tensor_is_default_or_channels_last_dim_order(in),
       InvalidArgument,
       ret_val);
+  ET_KERNEL_CHECK(
+      ctx, in.dim_order().equals(out.dim_order()), InvalidArgument, ret_val);
 
   size_t C_dim = in.dim() >= 1 ? 1 : 0;
   size_t C = in.size(C_dim);
   size_t outer = getLeadingDims(in, C_dim);
   size_t inner = getTrailingDims(in, C_dim);
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim_order().size());
 
   constexpr auto name = "native_batch_norm_legit_no_training.out";
 
@@ -87,6 +92,39 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
     const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
     const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
 
+    if (channels_last) {
+      // The channels are innermost, so normalize them a block at a time,
+      // with the parameters of the block computed once.
+      constexpr size_t kBlock = 64;
+      const size_t pixels = outer * inner;
+      for (size_t c0 = 0; c0 < C; c0 += kBlock) {
+        const size_t block = std::min(kBlock, C - c0);
+        CTYPE scale[kBlock];
+        CTYPE shift[kBlock];
+        for (size_t c = 0; c < block; ++c) {
+          const CTYPE invstd = 1.0 / std::sqrt(var_data[c0 + c] + eps);
+          CTYPE weight_val = 1;
+          if (weight.has_value()) {
+            weight_val = weight.value().const_data_ptr<CTYPE>()[c0 + c];
+          }
+          CTYPE bias_val = 0;
+          if (bias.has_value()) {
+            bias_val = bias.value().const_data_ptr<CTYPE>()[c0 + c];
+          }
+          scale[c] = invstd * weight_val;
+          shift[c] = bias_val;
+        }
+        for (size_t p = 0; p < pixels; ++p) {
+          const CTYPE* const in_p = in_data + p * C + c0;
+          CTYPE* const out_p = out_data + p * C + c0;
+          for (size_t c = 0; c < block; ++c) {
+            out_p[c] = (in_p[c] - mean_data[c0 + c]) * scale[c] + shift[c];
+          }
+        }
+      }
+      return;
+    }
+
     for (size_t i = 0; i < outer; ++i) {
       for (size_t c = 0; c < C; ++c) {
         CTYPE mean = mean_data[c];
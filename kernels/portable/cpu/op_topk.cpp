@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <tuple>
+
+#include <executorch/kernels/portable/cpu/util/topk_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+/**
+ * Selects the k largest (or smallest) elements along `dim` with a bounded
+ * heap kept in the outputs, so no scratch memory is needed. The results are
+ * always sorted, which also satisfies sorted=false.
+ *
+ * topk.values(Tensor self, SymInt k, int dim=-1, bool largest=True, bool
+ *     sorted=True, *, Tensor(a!) values, Tensor(b!) indices)
+ *     -> (Tensor(a!) values, Tensor(b!) indices)
+ */
+std::tuple<Tensor&, Tensor&> topk_values(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted,
+    Tensor& values,
+    Tensor& indices) {
+  (void)sorted;
+  std::tuple<Tensor&, Tensor&> out(values, indices);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_topk_args(in, k, dim, values, indices),
+      InvalidArgument,
+      out);
+
+  Tensor::SizesType target_size[kTensorDimensionLimit];
+  size_t target_dim = 0;
+  get_topk_out_target_size(in, k, dim, target_size, &target_dim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(values, {target_size, target_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {target_size, target_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const TopkRows rows = get_topk_rows(in, dim);
+
+  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "topk.values", CTYPE, [&]() {
+    const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+    CTYPE* values_data = values.mutable_data_ptr<CTYPE>();
+    int64_t* indices_data = indices.mutable_data_ptr<int64_t>();
+    for (int64_t row = 0; row < rows.count; ++row) {
+      const int64_t out_offset = rows.offset(row, k);
+      topk_row(
+          in_data + rows.offset(row, rows.size),
+          rows,
+          k,
+          largest,
+          values_data + out_offset,
+          indices_data + out_offset);
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <type_traits>
+
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using exec_aten::OptionalArrayRef;
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+template <typename CTYPE>
+void upsample_bilinear2d_kernel_impl(
+    const Tensor& in,
+    bool align_corners,
+    const exec_aten::optional<double>& scale_h,
+    const exec_aten::optional<double>& scale_w,
+    Tensor& out) {
+  // Blend Half values in float, as ATen does.
+  using ACC =
+      typename std::conditional<std::is_same<CTYPE, double>::value, double, float>::
+          type;
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t planes = in.size(0) * in.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+
+  const ACC ratio_h =
+      area_pixel_compute_scale<ACC>(in_h, out_h, align_corners, scale_h);
+  const ACC ratio_w =
+      area_pixel_compute_scale<ACC>(in_w, out_w, align_corners, scale_w);
+
+  for (int64_t p = 0; p < planes; ++p) {
+    const CTYPE* const in_plane = in_data + p * in_h * in_w;
+    CTYPE* const out_plane = out_data + p * out_h * out_w;
+    for (int64_t oh = 0; oh < out_h; ++oh) {
+      int64_t ih0, ih1;
+      ACC h0lambda, h1lambda;
+      compute_source_index_and_lambda<ACC>(
+          ih0, ih1, h0lambda, h1lambda, ratio_h, oh, in_h, out_h, align_corners);
+      for (int64_t ow = 0; ow < out_w; ++ow) {
+        int64_t iw0, iw1;
+        ACC w0lambda, w1lambda;
+        compute_source_index_and_lambda<ACC>(
+            iw0,
+            iw1,
+            w0lambda,
+            w1lambda,
+            ratio_w,
+            ow,
+            in_w,
+            out_w,
+            align_corners);
+        const ACC top = w0lambda * static_cast<ACC>(in_plane[ih0 * in_w + iw0]) +
+            w1lambda * static_cast<ACC>(in_plane[ih0 * in_w + iw1]);
+        const ACC bottom =
+            w0lambda * static_cast<ACC>(in_plane[ih1 * in_w + iw0]) +
+            w1lambda * static_cast<ACC>(in_plane[ih1 * in_w + iw1]);
+        out_plane[oh * out_w + ow] =
+            static_cast<CTYPE>(h0lambda * top + h1lambda * bottom);
+      }
+    }
+  }
+}
+
+} // namespace
+
+Tensor& upsample_bilinear2d_vec_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const OptionalArrayRef<int64_t> output_size,
+    bool align_corners,
+    const OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_bilinear2d_args(
+          in, output_size, align_corners, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_upsample_2d(in, output_size, scale_factors, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const auto scale_h = get_scale_value(scale_factors, 0);
+  const auto scale_w = get_scale_value(scale_factors, 1);
+
+  ET_SWITCH_FLOATH_TYPES(
+      in.scalar_type(), ctx, "upsample_bilinear2d.vec_out", CTYPE, [&]() {
+        upsample_bilinear2d_kernel_impl<CTYPE>(
+            in, align_corners, scale_h, scale_w, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using exec_aten::OptionalArrayRef;
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+template <typename CTYPE>
+void upsample_nearest2d_kernel_impl(
+    const Tensor& in,
+    const exec_aten::optional<double>& scale_h,
+    const exec_aten::optional<double>& scale_w,
+    Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t planes = in.size(0) * in.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+
+  for (int64_t p = 0; p < planes; ++p) {
+    const CTYPE* const in_plane = in_data + p * in_h * in_w;
+    CTYPE* const out_plane = out_data + p * out_h * out_w;
+    for (int64_t oh = 0; oh < out_h; ++oh) {
+      const int64_t ih = nearest_idx(oh, in_h, out_h, scale_h);
+      for (int64_t ow = 0; ow < out_w; ++ow) {
+        const int64_t iw = nearest_idx(ow, in_w, out_w, scale_w);
+        out_plane[oh * out_w + ow] = in_plane[ih * in_w + iw];
+      }
+    }
+  }
+}
+
+} // namespace
+
+Tensor& upsample_nearest2d_vec_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const OptionalArrayRef<int64_t> output_size,
+    const OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_nearest2d_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_upsample_2d(in, output_size, scale_factors, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const auto scale_h = get_scale_value(scale_factors, 0);
+  const auto scale_w = get_scale_value(scale_factors, 1);
+
+  ET_SWITCH_REALHB_TYPES(
+      in.scalar_type(), ctx, "upsample_nearest2d.vec_out", CTYPE, [&]() {
+        upsample_nearest2d_kernel_impl<CTYPE>(in, scale_h, scale_w, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
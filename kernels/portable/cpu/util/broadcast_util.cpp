@@ -317,5 +317,30 @@ size_t linearize_access_indexes(
       broadcast_from.strides());
 }
 
+void get_broadcast_strides(
+    const Tensor& broadcast_from,
+    const Tensor& out,
+    ssize_t* strides) {
+  ET_CHECK(broadcast_from.dim() <= out.dim());
+  const size_t num_skip_dims = out.dim() - broadcast_from.dim();
+  for (size_t d = 0; d < out.dim(); ++d) {
+    if (d < num_skip_dims) {
+      // Missing leading dims are broadcast.
+      strides[d] = 0;
+      continue;
+    }
+    const size_t from_dim = d - num_skip_dims;
+    if (broadcast_from.size(from_dim) == out.size(d)) {
+      strides[d] = broadcast_from.strides()[from_dim];
+    } else {
+      ET_CHECK_MSG(
+          broadcast_from.size(from_dim) == 1,
+          "Expected dim size == 1 if broadcasted, but actual dim size is %zu",
+          static_cast<size_t>(broadcast_from.size(from_dim)));
+      strides[d] = 0;
+    }
+  }
+}
+
 } // namespace executor
 } // namespace torch
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 
@@ -266,6 +267,127 @@ size_t linearize_access_indexes(
     ssize_t broadcast_to_ndim,
     const Tensor& broadcast_from);
 
+/**
+ * Writes to `strides[d]`, for each dim d of `out`, how many elements to step
+ * through the data of `broadcast_from` when the index into dim d of `out`
+ * increases by one: 0 if `broadcast_from` is broadcast along d, and its own
+ * stride otherwise.
+ *
+ * @param[in] broadcast_from The tensor that is broadcast to `out`.
+ * @param[in] out The broadcast target.
+ * @param[out] strides The per-dim steps; must hold `out.dim()` entries.
+ */
+void get_broadcast_strides(
+    const Tensor& broadcast_from,
+    const Tensor& out,
+    ssize_t* strides);
+
+/**
+ * Splits the elements [begin, end) of `out`, in memory order, into runs along
+ * which every input advances by a constant step, and calls
+ * `fn(out_index, count, input_indexes, input_steps)` for each run. Element
+ * `out_index + j` of the run, an offset into the data of `out`, reads element
+ * `input_indexes[k] + j * input_steps[k]` of `inputs[k]`.
+ *
+ * Following the dim order of `out` lets a channels-last output be written
+ * sequentially whatever the dim orders of the inputs.
+ *
+ * Adjacent dims that all inputs step through uniformly are merged first, so
+ * the common patterns (scalar, row, column, or last-dim broadcasting) result
+ * in long runs with steps of 0 or 1 instead of per-element index math.
+ */
+template <size_t kNumInputs, typename Fn>
+inline void for_each_broadcast_run(
+    const Fn& fn,
+    const Tensor* const (&inputs)[kNumInputs],
+    const Tensor& out,
+    const size_t begin,
+    const size_t end) {
+  if (begin >= end) {
+    return;
+  }
+  size_t ndim = 0;
+  size_t sizes[kTensorDimensionLimit];
+  ssize_t strides[kNumInputs][kTensorDimensionLimit];
+  {
+    ssize_t dim_strides[kNumInputs][kTensorDimensionLimit];
+    for (size_t k = 0; k < kNumInputs; ++k) {
+      get_broadcast_strides(*inputs[k], out, dim_strides[k]);
+    }
+    for (size_t i = 0; i < out.dim(); ++i) {
+      const size_t d = out.dim_order()[i];
+      const size_t size = out.size(d);
+      if (size == 1) {
+        // The index into this dim never changes.
+        continue;
+      }
+      bool merge = ndim > 0;
+      for (size_t k = 0; merge && k < kNumInputs; ++k) {
+        merge = strides[k][ndim - 1] == dim_strides[k][d] * (ssize_t)size;
+      }
+      if (!merge) {
+        sizes[ndim] = 1;
+        ++ndim;
+      }
+      sizes[ndim - 1] *= size;
+      for (size_t k = 0; k < kNumInputs; ++k) {
+        strides[k][ndim - 1] = dim_strides[k][d];
+      }
+    }
+    if (ndim == 0) {
+      sizes[0] = 1;
+      for (size_t k = 0; k < kNumInputs; ++k) {
+        strides[k][0] = 0;
+      }
+      ndim = 1;
+    }
+  }
+
+  // Find the position of `begin` in the merged dims.
+  size_t coords[kTensorDimensionLimit];
+  ssize_t indexes[kNumInputs] = {};
+  size_t remaining = begin;
+  for (size_t i = 0; i < ndim; ++i) {
+    const size_t d = ndim - 1 - i;
+    coords[d] = remaining % sizes[d];
+    remaining /= sizes[d];
+    for (size_t k = 0; k < kNumInputs; ++k) {
+      indexes[k] += coords[d] * strides[k][d];
+    }
+  }
+
+  const size_t inner = ndim - 1;
+  ssize_t steps[kNumInputs];
+  for (size_t k = 0; k < kNumInputs; ++k) {
+    steps[k] = strides[k][inner];
+  }
+  size_t input_indexes[kNumInputs];
+  for (size_t i = begin; i < end;) {
+    size_t count = sizes[inner] - coords[inner];
+    if (count > end - i) {
+      count = end - i;
+    }
+    for (size_t k = 0; k < kNumInputs; ++k) {
+      input_indexes[k] = indexes[k];
+    }
+    fn(i, count, input_indexes, steps);
+    i += count;
+
+    // Advance to the start of the next run, carrying into outer dims.
+    coords[inner] += count;
+    for (size_t k = 0; k < kNumInputs; ++k) {
+      indexes[k] += count * steps[k];
+    }
+    for (size_t d = inner; d > 0 && coords[d] == sizes[d]; --d) {
+      coords[d] = 0;
+      ++coords[d - 1];
+      for (size_t k = 0; k < kNumInputs; ++k) {
+        indexes[k] += strides[k][d - 1] - sizes[d] * strides[k][d];
+      }
+    }
+  }
+}
+
 //
 // Mapping with broadcasting
 //
@@ -273,7 +395,8 @@ size_t linearize_access_indexes(
 /**
  * Useful for binary elementwise operators. For each element of the inputs,
  * perform a computation and write to the corresponding element of the output.
- * Tensor broadcasting is applied wherever it is required.
+ * Tensor broadcasting is applied wherever it is required. Large outputs are
+ * split across threads; see elementwise_parallel_for().
  */
 template <typename CTYPE_A, typename CTYPE_B, typename CTYPE_OUT, typename Op>
 inline void apply_binary_elementwise_fn(
@@ -289,30 +412,62 @@ inline void apply_binary_elementwise_fn(
   const CTYPE_B* const data_b = b.const_data_ptr<CTYPE_B>();
   CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
 
-  for (size_t i = 0; i < out.numel(); ++i) {
-    size_t a_linear_index = i;
-    size_t b_linear_index = i;
-
-    if (any_is_broadcasted) {
-      size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
+  // Tensors with the same sizes and dim order hold the same element at each
+  // offset.
+  if (!any_is_broadcasted && a.dim_order().equals(out.dim_order()) &&
+      b.dim_order().equals(out.dim_order())) {
+    elementwise_parallel_for(
+        out.numel(), [&](const int64_t begin, const int64_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            data_out[i] = compute_fun(data_a[i], data_b[i]);
+          }
+        });
+    return;
+  }
 
-      if (a_is_broadcasted) {
-        a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
+  // Specialize the inner loop for the steps that common broadcasts produce,
+  // so that it can be vectorized.
+  const auto compute_run = [&](const size_t out_index,
+                               const size_t count,
+                               const size_t* const input_indexes,
+                               const ssize_t* const input_steps) {
+    const CTYPE_A* const run_a = data_a + input_indexes[0];
+    const CTYPE_B* const run_b = data_b + input_indexes[1];
+    CTYPE_OUT* const run_out = data_out + out_index;
+    const ssize_t step_a = input_steps[0];
+    const ssize_t step_b = input_steps[1];
+    if (step_a == 1 && step_b == 1) {
+      for (size_t j = 0; j < count; ++j) {
+        run_out[j] = compute_fun(run_a[j], run_b[j]);
+      }
+    } else if (step_a == 0 && step_b == 1) {
+      const CTYPE_A val_a = run_a[0];
+      for (size_t j = 0; j < count; ++j) {
+        run_out[j] = compute_fun(val_a, run_b[j]);
       }
-      if (b_is_broadcasted) {
-        b_linear_index = linearize_access_indexes(out_indexes, out.dim(), b);
+    } else if (step_a == 1 && step_b == 0) {
+      const CTYPE_B val_b = run_b[0];
+      for (size_t j = 0; j < count; ++j) {
+        run_out[j] = compute_fun(run_a[j], val_b);
+      }
+    } else {
+      for (size_t j = 0; j < count; ++j) {
+        run_out[j] = compute_fun(run_a[j * step_a], run_b[j * step_b]);
       }
     }
-
-    data_out[i] = compute_fun(data_a[a_linear_index], data_b[b_linear_index]);
-  }
+  };
+  const Tensor* const inputs[] = {&a, &b};
+  elementwise_parallel_for(
+      out.numel(), [&](const int64_t begin, const int64_t end) {
+        for_each_broadcast_run(compute_run, inputs, out, begin, end);
+      });
 }
 
 /**
  * Useful for ternary elementwise operators. For each element of the inputs,
  * perform a computation and write to the corresponding element of the output.
- * Tensor broadcasting is applied wherever it is required.
+ * Tensor broadcasting is applied wherever it is required. Large outputs are
+ * split across threads; see elementwise_parallel_for().
  */
 template <
     typename CTYPE_A,
@@ -337,29 +492,48 @@ inline void apply_ternary_elementwise_fn(
   const CTYPE_C* const data_c = c.const_data_ptr<CTYPE_C>();
   CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
 
-  for (size_t i = 0; i < out.numel(); ++i) {
-    size_t a_linear_index = i;
-    size_t b_linear_index = i;
-    size_t c_linear_index = i;
-
-    if (any_is_broadcasted) {
-      size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
-
-      if (a_is_broadcasted) {
-        a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
-      }
-      if (b_is_broadcasted) {
-        b_linear_index = linearize_access_indexes(out_indexes, out.dim(), b);
+  const auto compute_run = [&](const size_t out_index,
+                               const size_t count,
+                               const size_t* const input_indexes,
+                               const ssize_t* const input_steps) {
+    const CTYPE_A* const run_a = data_a + input_indexes[0];
+    const CTYPE_B* const run_b = data_b + input_indexes[1];
+    const CTYPE_C* const run_c = data_c + input_indexes[2];
+    CTYPE_OUT* const run_out = data_out + out_index;
+    const ssize_t step_a = input_steps[0];
+    const ssize_t step_b = input_steps[1];
+    const ssize_t step_c = input_steps[2];
+    if (step_a == 1 && step_b == 1 && step_c == 1) {
+      for (size_t j = 0; j < count; ++j) {
+        run_out[j] = compute_fun(run_a[j], run_b[j], run_c[j]);
       }
-      if (c_is_broadcasted) {
-        c_linear_index = linearize_access_indexes(out_indexes, out.dim(), c);
+    } else {
+      for (size_t j = 0; j < count; ++j) {
+        run_out[j] = compute_fun(
+            run_a[j * step_a], run_b[j * step_b], run_c[j * step_c]);
       }
     }
-
-    data_out[i] = compute_fun(
-        data_a[a_linear_index], data_b[b_linear_index], data_c[c_linear_index]);
+  };
+  if (!any_is_broadcasted && a.dim_order().equals(out.dim_order()) &&
+      b.dim_order().equals(out.dim_order()) &&
+      c.dim_order().equals(out.dim_order())) {
+    const ssize_t input_steps[] = {1, 1, 1};
+    elementwise_parallel_for(
+        out.numel(), [&](const int64_t begin, const int64_t end) {
+          const size_t input_indexes[] = {
+              static_cast<size_t>(begin),
+              static_cast<size_t>(begin),
+              static_cast<size_t>(begin)};
+          compute_run(begin, end - begin, input_indexes, input_steps);
+        });
+    return;
   }
+
+  const Tensor* const inputs[] = {&a, &b, &c};
+  elementwise_parallel_for(
+      out.numel(), [&](const int64_t begin, const int64_t end) {
+        for_each_broadcast_run(compute_run, inputs, out, begin, end);
+      });
 }
 
 } // namespace executor
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 
@@ -43,6 +44,7 @@ inline CTYPE apply_unary_reduce_fn(
 /**
  * Applies `map_fun` to `size` elements of `data_in`, writing results to
  * `data_out`. The `stride` can also be defined; by default it is set to 1.
+ * Large inputs are split across threads; see elementwise_parallel_for().
  */
 template <typename CTYPE_IN, typename CTYPE_OUT, typename MapOp>
 inline void apply_unary_map_fn(
@@ -51,9 +53,11 @@ inline void apply_unary_map_fn(
     CTYPE_OUT* const data_out,
     const int64_t size,
     const int64_t stride = 1) {
-  for (size_t i = 0; i < size; i++) {
-    data_out[i * stride] = map_fun(data_in[i * stride]);
-  }
+  elementwise_parallel_for(size, [&](const int64_t begin, const int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      data_out[i * stride] = map_fun(data_in[i * stride]);
+    }
+  });
 }
 
 //
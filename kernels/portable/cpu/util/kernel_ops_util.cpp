@@ -462,20 +462,15 @@ bool check_cumsum_args(
   return true;
 }
 
-bool check_max_pool2d_with_indices_args(
+bool check_max_pool2d_args(
     const Tensor& in,
     IntArrayRef kernel_size,
     IntArrayRef stride,
     IntArrayRef padding,
     IntArrayRef dilation,
     bool ceil_mode,
-    Tensor& out,
-    Tensor& indices) {
+    const Tensor& out) {
   ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, out));
-  ET_LOG_MSG_AND_RETURN_IF_FALSE(
-      indices.scalar_type() == ScalarType::Long,
-      "Expected indices to have type of Long, but found %s",
-      toString(indices.scalar_type()));
 
   ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_or_channels_last_dim_order(in));
   ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_or_channels_last_dim_order(out));
@@ -496,6 +491,24 @@ bool check_max_pool2d_with_indices_args(
   return true;
 }
 
+bool check_max_pool2d_with_indices_args(
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out,
+    Tensor& indices) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      indices.scalar_type() == ScalarType::Long,
+      "Expected indices to have type of Long, but found %s",
+      toString(indices.scalar_type()));
+
+  return check_max_pool2d_args(
+      in, kernel_size, stride, padding, dilation, ceil_mode, out);
+}
+
 void get_max_pool2d_with_indices_out_target_size(
     const Tensor& in,
     IntArrayRef kernel_size,
@@ -431,6 +431,15 @@ bool check_cumsum_args(
     optional<ScalarType> enforced_dtype,
     Tensor& out);
 
+bool check_max_pool2d_args(
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    const Tensor& out);
+
 bool check_max_pool2d_with_indices_args(
     const Tensor& in,
     IntArrayRef kernel_size,
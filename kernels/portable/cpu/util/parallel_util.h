@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef ET_PORTABLE_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+namespace torch {
+namespace executor {
+
+/**
+ * The minimum number of elements that each thread handles in
+ * elementwise_parallel_for(). Elementwise ops do little work per element, so
+ * smaller chunks cost more to dispatch than they save.
+ */
+constexpr int64_t kElementwiseGrainSize = 32768;
+
+/**
+ * Calls `fn(begin, end)` on disjoint chunks that together cover [0, size).
+ *
+ * When built with ET_PORTABLE_USE_THREADPOOL, chunks of at least `grain_size`
+ * elements run concurrently on the shared threadpool, so `fn` must be safe to
+ * call from several threads at once for disjoint ranges. Otherwise, and for
+ * ranges smaller than `grain_size`, `fn(0, size)` is called on this thread.
+ */
+template <typename Func>
+inline void elementwise_parallel_for(
+    const int64_t size,
+    const Func& fn,
+    const int64_t grain_size = kElementwiseGrainSize) {
+#ifdef ET_PORTABLE_USE_THREADPOOL
+  if (size > grain_size &&
+      ::executorch::extension::parallel_for(0, size, grain_size, fn)) {
+    return;
+  }
+#else
+  (void)grain_size;
+#endif
+  fn(0, size);
+}
+
+} // namespace executor
+} // namespace torch
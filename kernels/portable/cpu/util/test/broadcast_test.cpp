@@ -183,3 +183,149 @@ TEST(BroadcastUtilTest, LinearizeIndex) {
     EXPECT_EQ(linear_index, 2);
   }
 }
+
+TEST(BroadcastUtilTest, ApplyBinaryElementwiseFnLargeOutput) {
+  TensorFactory<ScalarType::Int> tf;
+
+  // Large enough to be split into several chunks when the threaded build of
+  // the elementwise helpers is enabled.
+  constexpr int32_t kRows = 4 * torch::executor::kElementwiseGrainSize / 64;
+  Tensor a = tf.zeros({kRows, 1});
+  Tensor b = tf.zeros({1, 64});
+  Tensor out = tf.zeros({kRows, 64});
+  int32_t* const data_a = a.mutable_data_ptr<int32_t>();
+  for (int32_t i = 0; i < kRows; ++i) {
+    data_a[i] = i * 64;
+  }
+  int32_t* const data_b = b.mutable_data_ptr<int32_t>();
+  for (int32_t j = 0; j < 64; ++j) {
+    data_b[j] = j;
+  }
+
+  torch::executor::apply_binary_elementwise_fn<int32_t, int32_t, int32_t>(
+      [](const int32_t val_a, const int32_t val_b) { return val_a + val_b; },
+      a,
+      b,
+      out);
+
+  const int32_t* const data_out = out.const_data_ptr<int32_t>();
+  for (int32_t i = 0; i < out.numel(); ++i) {
+    ASSERT_EQ(data_out[i], i);
+  }
+}
+
+namespace {
+// Fills `t` with 0, 1, 2, ... in linear order.
+void fill_iota(Tensor& t) {
+  int32_t* const data = t.mutable_data_ptr<int32_t>();
+  for (int32_t i = 0; i < t.numel(); ++i) {
+    data[i] = i;
+  }
+}
+
+// Returns the element of `t` that broadcasts to linear index `i` of `out`.
+int32_t broadcast_element(const Tensor& t, const Tensor& out, size_t i) {
+  size_t out_indexes[torch::executor::kTensorDimensionLimit];
+  torch::executor::delinearize_index(
+      i, out, out_indexes, torch::executor::kTensorDimensionLimit);
+  return t.const_data_ptr<int32_t>()[linearize_access_indexes(
+      out_indexes, out.dim(), t)];
+}
+} // namespace
+
+TEST(BroadcastUtilTest, ApplyElementwiseFnBroadcastPatterns) {
+  TensorFactory<ScalarType::Int> tf;
+
+  const std::vector<std::vector<std::vector<int32_t>>> cases = {
+      // Scalar.
+      {{1}, {3, 4}, {3, 4}},
+      {{3, 4}, {}, {3, 4}},
+      // Row and column vectors.
+      {{1, 4}, {3, 4}, {3, 4}},
+      {{3, 1}, {3, 4}, {3, 4}},
+      {{3, 1}, {1, 4}, {3, 4}},
+      // Last-dim and middle-dim broadcasting, with missing leading dims.
+      {{2, 3, 1}, {2, 3, 5}, {2, 3, 5}},
+      {{2, 1, 5}, {3, 5}, {2, 3, 5}},
+      {{4, 1, 3, 1}, {2, 1, 6}, {4, 2, 3, 6}},
+      // Size-one dims everywhere.
+      {{1, 1, 1}, {1, 1, 1}, {1, 1, 1}},
+      // Empty.
+      {{0, 1}, {1, 3}, {0, 3}},
+  };
+  for (const auto& shapes : cases) {
+    Tensor a = tf.zeros(shapes[0]);
+    Tensor b = tf.zeros(shapes[1]);
+    Tensor c = tf.zeros(shapes[1]);
+    Tensor out = tf.zeros(shapes[2]);
+    fill_iota(a);
+    fill_iota(b);
+    fill_iota(c);
+
+    torch::executor::apply_binary_elementwise_fn<int32_t, int32_t, int32_t>(
+        [](const int32_t val_a, const int32_t val_b) {
+          return val_a * 1000 + val_b;
+        },
+        a,
+        b,
+        out);
+    const int32_t* data_out = out.const_data_ptr<int32_t>();
+    for (size_t i = 0; i < out.numel(); ++i) {
+      EXPECT_EQ(
+          data_out[i],
+          broadcast_element(a, out, i) * 1000 + broadcast_element(b, out, i));
+    }
+
+    torch::executor::
+        apply_ternary_elementwise_fn<int32_t, int32_t, int32_t, int32_t>(
+            [](const int32_t val_a, const int32_t val_b, const int32_t val_c) {
+              return val_a * 10000 + val_b * 100 + val_c;
+            },
+            a,
+            b,
+            c,
+            out);
+    for (size_t i = 0; i < out.numel(); ++i) {
+      EXPECT_EQ(
+          data_out[i],
+          broadcast_element(a, out, i) * 10000 +
+              broadcast_element(b, out, i) * 100 +
+              broadcast_element(c, out, i));
+    }
+  }
+}
+
+TEST(BroadcastUtilTest, ForEachBroadcastRunStartsMidRun) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor a = tf.zeros({2, 1, 3});
+  Tensor out = tf.zeros({2, 4, 3});
+  fill_iota(a);
+  const Tensor* const inputs[] = {&a};
+
+  // Visiting any sub-range gives the same elements as the reference.
+  for (size_t begin = 0; begin < out.numel(); ++begin) {
+    for (size_t end = begin; end <= out.numel(); ++end) {
+      size_t next = begin;
+      torch::executor::for_each_broadcast_run(
+          [&](size_t out_index,
+              size_t count,
+              const size_t* input_indexes,
+              const ssize_t* input_steps) {
+            EXPECT_EQ(out_index, next);
+            for (size_t j = 0; j < count; ++j) {
+              EXPECT_EQ(
+                  a.const_data_ptr<int32_t>()
+                      [input_indexes[0] + j * input_steps[0]],
+                  broadcast_element(a, out, out_index + j));
+            }
+            next += count;
+          },
+          inputs,
+          out,
+          begin,
+          end);
+      EXPECT_EQ(next, end);
+    }
+  }
+}
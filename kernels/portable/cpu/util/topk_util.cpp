@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/topk_util.h>
+
+namespace torch {
+namespace executor {
+
+bool check_topk_args(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    const Tensor& values,
+    const Tensor& indices) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, values));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      indices.scalar_type() == ScalarType::Long,
+      "Expected indices to have type of Long, but found %s",
+      toString(indices.scalar_type()));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_has_dim(in, dim));
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k >= 0 && k <= nonempty_size(in, dim),
+      "selected number k out of range: k = %" PRId64 ", dim size = %zd",
+      k,
+      nonempty_size(in, dim));
+
+  return true;
+}
+
+void get_topk_out_target_size(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    Tensor::SizesType* out_sizes,
+    size_t* out_ndim) {
+  *out_ndim = in.dim();
+  for (size_t i = 0; i < in.dim(); ++i) {
+    out_sizes[i] = in.size(i);
+  }
+  if (in.dim() > 0) {
+    out_sizes[dim < 0 ? dim + in.dim() : dim] = k;
+  }
+}
+
+TopkRows get_topk_rows(const Tensor& in, int64_t dim) {
+  if (in.dim() == 0) {
+    return {1, 1, 1};
+  }
+  if (dim < 0) {
+    dim += in.dim();
+  }
+  TopkRows rows{1, in.size(dim), 1};
+  for (int64_t i = 0; i < in.dim(); ++i) {
+    if (i < dim) {
+      rows.count *= in.size(i);
+    } else if (i > dim) {
+      rows.stride *= in.size(i);
+    }
+  }
+  rows.count *= rows.stride;
+  return rows;
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+bool check_topk_args(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    const Tensor& values,
+    const Tensor& indices);
+
+void get_topk_out_target_size(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    Tensor::SizesType* out_sizes,
+    size_t* out_ndim);
+
+/**
+ * The rows that topk selects from: `count` rows of `size` elements each, with
+ * the elements of a row `stride` apart.
+ */
+struct TopkRows {
+  int64_t count;
+  int64_t size;
+  int64_t stride;
+
+  /// Where row `row` starts in a tensor whose rows have `row_size` elements.
+  int64_t offset(const int64_t row, const int64_t row_size) const {
+    return row / stride * row_size * stride + row % stride;
+  }
+};
+
+TopkRows get_topk_rows(const Tensor& in, int64_t dim);
+
+/**
+ * Whether element (a, a_index) comes before (b, b_index) in the output of
+ * topk. NaN is greater than every number, as in ATen, and equal values keep
+ * their input order.
+ */
+template <typename CTYPE>
+inline bool topk_before(
+    const CTYPE a,
+    const int64_t a_index,
+    const CTYPE b,
+    const int64_t b_index,
+    const bool largest) {
+  const bool a_nan = std::isnan(a);
+  const bool b_nan = std::isnan(b);
+  if (a_nan || b_nan) {
+    if (a_nan && b_nan) {
+      return a_index < b_index;
+    }
+    return largest ? a_nan : b_nan;
+  }
+  if (a != b) {
+    return largest ? a > b : a < b;
+  }
+  return a_index < b_index;
+}
+
+/**
+ * A binary heap of up to `capacity` (value, index) pairs stored `stride`
+ * elements apart, whose root is the pair that comes last in topk order. It
+ * keeps the best `capacity` pairs pushed into it without any memory of its
+ * own, so it can live in the output tensors.
+ */
+template <typename CTYPE>
+class TopkHeap {
+ public:
+  TopkHeap(
+      CTYPE* values,
+      int64_t* indices,
+      const int64_t stride,
+      const int64_t capacity,
+      const bool largest)
+      : values_(values),
+        indices_(indices),
+        stride_(stride),
+        capacity_(capacity),
+        largest_(largest) {}
+
+  bool full() const {
+    return size_ == capacity_;
+  }
+
+  /// The value that a new element must come before to be kept.
+  CTYPE worst_value() const {
+    return values_[0];
+  }
+
+  void push(const CTYPE value, const int64_t index) {
+    if (!full()) {
+      set(size_, value, index);
+      sift_up(size_++);
+    } else if (topk_before(value, index, values_[0], indices_[0], largest_)) {
+      set(0, value, index);
+      sift_down(0, size_);
+    }
+  }
+
+  /// Sorts the heap in place into topk order, best first.
+  void sort() {
+    for (int64_t end = size_ - 1; end > 0; --end) {
+      swap(0, end);
+      sift_down(0, end);
+    }
+  }
+
+ private:
+  // Whether slot i belongs below slot j, i.e. comes before it.
+  bool below(const int64_t i, const int64_t j) const {
+    return topk_before(
+        values_[i * stride_],
+        indices_[i * stride_],
+        values_[j * stride_],
+        indices_[j * stride_],
+        largest_);
+  }
+
+  void set(const int64_t i, const CTYPE value, const int64_t index) {
+    values_[i * stride_] = value;
+    indices_[i * stride_] = index;
+  }
+
+  void swap(const int64_t i, const int64_t j) {
+    std::swap(values_[i * stride_], values_[j * stride_]);
+    std::swap(indices_[i * stride_], indices_[j * stride_]);
+  }
+
+  void sift_up(int64_t i) {
+    while (i > 0) {
+      const int64_t parent = (i - 1) / 2;
+      if (!below(parent, i)) {
+        return;
+      }
+      swap(parent, i);
+      i = parent;
+    }
+  }
+
+  void sift_down(int64_t i, const int64_t end) {
+    while (true) {
+      int64_t worst = i;
+      for (int64_t child = 2 * i + 1; child <= 2 * i + 2 && child < end;
+           ++child) {
+        if (below(worst, child)) {
+          worst = child;
+        }
+      }
+      if (worst == i) {
+        return;
+      }
+      swap(i, worst);
+      i = worst;
+    }
+  }
+
+  CTYPE* values_;
+  int64_t* indices_;
+  int64_t stride_;
+  int64_t capacity_;
+  bool largest_;
+  int64_t size_ = 0;
+};
+
+/**
+ * Writes the `k` elements of a row that come first in topk order, sorted,
+ * using the outputs as the heap. `in`, `values` and `indices` point at the
+ * start of the row.
+ */
+template <typename CTYPE>
+void topk_row(
+    const CTYPE* in,
+    const TopkRows& rows,
+    const int64_t k,
+    const bool largest,
+    CTYPE* values,
+    int64_t* indices) {
+  if (k == 0) {
+    return;
+  }
+  TopkHeap<CTYPE> heap(values, indices, rows.stride, k, largest);
+  for (int64_t i = 0; i < rows.size; ++i) {
+    heap.push(in[i * rows.stride], i);
+  }
+  heap.sort();
+}
+
+} // namespace executor
+} // namespace torch
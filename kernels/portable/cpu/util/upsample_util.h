@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+bool check_upsample_2d_common_args(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    Tensor& out);
+
+bool check_upsample_bilinear2d_args(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const bool align_corners,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    Tensor& out);
+
+bool check_upsample_nearest2d_args(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    Tensor& out);
+
+/**
+ * Resizes `out` to the NCHW shape given by `output_size`, or else by scaling
+ * the height and width of `in` by `scale_factors`.
+ *
+ * PREREQ: check_upsample_2d_common_args() returned true.
+ */
+Error resize_upsample_2d(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    Tensor& out);
+
+/**
+ * Returns scale_factors[i] if the output size was computed from
+ * `scale_factors`. ATen then maps output to input coordinates with the given
+ * factor instead of the ratio of the sizes, and so does this.
+ */
+inline exec_aten::optional<double> get_scale_value(
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    size_t i) {
+  if (!scale_factors.has_value()) {
+    return exec_aten::nullopt;
+  }
+  return scale_factors.value()[i];
+}
+
+template <typename T>
+inline T compute_scales_value(
+    const exec_aten::optional<double>& scale,
+    int64_t input_size,
+    int64_t output_size) {
+  return scale.has_value() && scale.value() > 0.
+      ? static_cast<T>(1.0 / scale.value())
+      : static_cast<T>(input_size) / output_size;
+}
+
+/**
+ * Returns the step between the input coordinates of consecutive output
+ * elements along one dim.
+ */
+template <typename T>
+inline T area_pixel_compute_scale(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    const exec_aten::optional<double>& scale) {
+  if (align_corners) {
+    return output_size > 1 ? static_cast<T>(input_size - 1) / (output_size - 1)
+                           : static_cast<T>(0);
+  }
+  return compute_scales_value<T>(scale, input_size, output_size);
+}
+
+/**
+ * Returns the input coordinate that output index `dst_index` samples.
+ */
+template <typename T>
+inline T area_pixel_compute_source_index(
+    T scale,
+    int64_t dst_index,
+    bool align_corners) {
+  if (align_corners) {
+    return scale * dst_index;
+  }
+  const T src_idx = scale * (dst_index + static_cast<T>(0.5)) -
+      static_cast<T>(0.5);
+  return src_idx < static_cast<T>(0) ? static_cast<T>(0) : src_idx;
+}
+
+/**
+ * Computes the two input indices that output index `output_index` blends
+ * and their weights, which add up to 1.
+ */
+template <typename T>
+inline void compute_source_index_and_lambda(
+    int64_t& input_index0,
+    int64_t& input_index1,
+    T& lambda0,
+    T& lambda1,
+    T ratio,
+    int64_t output_index,
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners) {
+  if (output_size == input_size) {
+    // Scale factor of 1, so copy the input.
+    input_index0 = output_index;
+    input_index1 = output_index;
+    lambda0 = static_cast<T>(1);
+    lambda1 = static_cast<T>(0);
+    return;
+  }
+  const T real_input_index =
+      area_pixel_compute_source_index<T>(ratio, output_index, align_corners);
+  input_index0 = std::min(
+      static_cast<int64_t>(std::floor(real_input_index)), input_size - 1);
+  input_index1 = input_index0 + (input_index0 < input_size - 1 ? 1 : 0);
+  lambda1 = std::min(
+      std::max(real_input_index - input_index0, static_cast<T>(0)),
+      static_cast<T>(1));
+  lambda0 = static_cast<T>(1) - lambda1;
+}
+
+/**
+ * Returns the input index that output index `output_index` copies in
+ * upsample_nearest2d.
+ */
+inline int64_t nearest_idx(
+    int64_t output_index,
+    int64_t input_size,
+    int64_t output_size,
+    const exec_aten::optional<double>& scale) {
+  if (output_size == input_size) {
+    return output_index;
+  } else if (output_size == 2 * input_size) {
+    return output_index >> 1;
+  }
+  const float ratio = compute_scales_value<float>(scale, input_size, output_size);
+  return std::min(
+      static_cast<int64_t>(std::floor(output_index * ratio)), input_size - 1);
+}
+
+} // namespace executor
+} // namespace torch
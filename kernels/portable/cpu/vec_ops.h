@@ -17,6 +17,12 @@
 #include <numeric>
 #include <ostream>
 #include <type_traits>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
 /**
  * @file
  * This header defines common, low-level operations that can often be
@@ -86,34 +92,203 @@ inline void vec_matmul(
   }
 }
 
+/// Returns sum(x[k] * y[k]) over the `size` elements of `x` and `y`, widening
+/// the int8 elements of `y` to float.
+inline float vec_dot_i8_f32(
+    const float* __restrict__ x,
+    const int8_t* __restrict__ y,
+    size_t size) {
+  size_t k = 0;
+  float sum = 0;
+#if defined(__aarch64__)
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  float32x4_t acc2 = vdupq_n_f32(0);
+  float32x4_t acc3 = vdupq_n_f32(0);
+  for (; k + 16 <= size; k += 16) {
+    const int8x16_t w = vld1q_s8(y + k);
+    const int16x8_t w_lo = vmovl_s8(vget_low_s8(w));
+    const int16x8_t w_hi = vmovl_s8(vget_high_s8(w));
+    acc0 = vfmaq_f32(
+        acc0, vld1q_f32(x + k), vcvtq_f32_s32(vmovl_s16(vget_low_s16(w_lo))));
+    acc1 = vfmaq_f32(
+        acc1,
+        vld1q_f32(x + k + 4),
+        vcvtq_f32_s32(vmovl_s16(vget_high_s16(w_lo))));
+    acc2 = vfmaq_f32(
+        acc2,
+        vld1q_f32(x + k + 8),
+        vcvtq_f32_s32(vmovl_s16(vget_low_s16(w_hi))));
+    acc3 = vfmaq_f32(
+        acc3,
+        vld1q_f32(x + k + 12),
+        vcvtq_f32_s32(vmovl_s16(vget_high_s16(w_hi))));
+  }
+  sum = vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)));
+#elif defined(__AVX2__) && defined(__FMA__)
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (; k + 16 <= size; k += 16) {
+    const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + k));
+    acc0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(x + k),
+        _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(w)),
+        acc0);
+    acc1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(x + k + 8),
+        _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(w, 8))),
+        acc1);
+  }
+  const __m256 acc = _mm256_add_ps(acc0, acc1);
+  __m128 acc4 = _mm_add_ps(
+      _mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  acc4 = _mm_hadd_ps(acc4, acc4);
+  acc4 = _mm_hadd_ps(acc4, acc4);
+  sum = _mm_cvtss_f32(acc4);
+#endif
+  for (; k < size; ++k) {
+    sum += x[k] * static_cast<float>(y[k]);
+  }
+  return sum;
+}
+
+/// Adds `a * y[k]` to each `z[k]` for the `size` elements of `z` and `y`,
+/// widening the int8 elements of `y` to float.
+inline void vec_axpy_i8_f32(
+    float* __restrict__ z,
+    float a,
+    const int8_t* __restrict__ y,
+    size_t size) {
+  size_t k = 0;
+#if defined(__aarch64__)
+  const float32x4_t va = vdupq_n_f32(a);
+  for (; k + 16 <= size; k += 16) {
+    const int8x16_t w = vld1q_s8(y + k);
+    const int16x8_t w_lo = vmovl_s8(vget_low_s8(w));
+    const int16x8_t w_hi = vmovl_s8(vget_high_s8(w));
+    vst1q_f32(
+        z + k,
+        vfmaq_f32(
+            vld1q_f32(z + k),
+            va,
+            vcvtq_f32_s32(vmovl_s16(vget_low_s16(w_lo)))));
+    vst1q_f32(
+        z + k + 4,
+        vfmaq_f32(
+            vld1q_f32(z + k + 4),
+            va,
+            vcvtq_f32_s32(vmovl_s16(vget_high_s16(w_lo)))));
+    vst1q_f32(
+        z + k + 8,
+        vfmaq_f32(
+            vld1q_f32(z + k + 8),
+            va,
+            vcvtq_f32_s32(vmovl_s16(vget_low_s16(w_hi)))));
+    vst1q_f32(
+        z + k + 12,
+        vfmaq_f32(
+            vld1q_f32(z + k + 12),
+            va,
+            vcvtq_f32_s32(vmovl_s16(vget_high_s16(w_hi)))));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256 va = _mm256_set1_ps(a);
+  for (; k + 16 <= size; k += 16) {
+    const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + k));
+    _mm256_storeu_ps(
+        z + k,
+        _mm256_fmadd_ps(
+            va,
+            _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(w)),
+            _mm256_loadu_ps(z + k)));
+    _mm256_storeu_ps(
+        z + k + 8,
+        _mm256_fmadd_ps(
+            va,
+            _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(w, 8))),
+            _mm256_loadu_ps(z + k + 8)));
+  }
+#endif
+  for (; k < size; ++k) {
+    z[k] += a * static_cast<float>(y[k]);
+  }
+}
+
+namespace internal {
+// Generic fallbacks for the int8 matmuls below; the float overloads pick the
+// vectorized helpers above.
+template <typename T, typename U>
+inline T quantized_dot_int8(const U* x, const int8_t* y, size_t size) {
+  T sum = 0;
+  for (size_t k = 0; k < size; ++k) {
+    sum += x[k] * static_cast<U>(y[k]);
+  }
+  return sum;
+}
+
+template <typename T>
+inline T quantized_dot_int8(const float* x, const int8_t* y, size_t size) {
+  return vec_dot_i8_f32(x, y, size);
+}
+
+template <typename T, typename U>
+inline void quantized_axpy_int8(T* z, U a, const int8_t* y, size_t size) {
+  for (size_t k = 0; k < size; ++k) {
+    z[k] += a * static_cast<U>(y[k]);
+  }
+}
+
+inline void
+quantized_axpy_int8(float* z, float a, const int8_t* y, size_t size) {
+  vec_axpy_i8_f32(z, a, y, size);
+}
+} // namespace internal
+
+/// Computes the columns [j_begin, j_end) of vec_quantized_matmul_int8(), so
+/// that callers can split the output features across threads.
 template <typename T, typename U = T>
-inline void vec_quantized_matmul_int8(
+inline void vec_quantized_matmul_int8_cols(
     T* __restrict__ z,
     const U* __restrict__ x,
     const int8_t* __restrict__ y,
     const U* __restrict__ s,
     int64_t m,
     int64_t n,
-    int64_t p) {
+    int64_t p,
+    int64_t j_begin,
+    int64_t j_end) {
   for (size_t i = 0; i < m; ++i) {
-    for (size_t j = 0; j < p; ++j) {
-      T sum = 0;
-      for (size_t k = 0; k < n; ++k) {
-        sum += x[i * n + k] * static_cast<U>(y[k * p + j]) * s[k];
-      }
-      z[i * p + j] = sum;
+    T* z_row = z + i * p + j_begin;
+    std::fill(z_row, z_row + (j_end - j_begin), static_cast<T>(0));
+    for (size_t k = 0; k < n; ++k) {
+      internal::quantized_axpy_int8(
+          z_row, x[i * n + k] * s[k], y + k * p + j_begin, j_end - j_begin);
     }
   }
 }
 
+/// x: m * n, y: n * p, z: m * p, s: n.
+/// z[i][j] = sum(x[i][k] * y[k][j] * s[k])
+template <typename T, typename U = T>
+inline void vec_quantized_matmul_int8(
+    T* __restrict__ z,
+    const U* __restrict__ x,
+    const int8_t* __restrict__ y,
+    const U* __restrict__ s,
+    int64_t m,
+    int64_t n,
+    int64_t p) {
+  vec_quantized_matmul_int8_cols<T, U>(z, x, y, s, m, n, p, 0, p);
+}
+
 static inline size_t bounds_min(size_t a, size_t b) {
   return (a < b) ? a : b;
 }
 
-/// x: m * n, y: p * n, z: m * p, s: p * groups
-/// z[i][j] = sum(x[i][k] * y[j][k] * s[j][k/g])
+/// Computes the columns [j_begin, j_end) of vec_quantized_matmul_transb_int8(),
+/// so that callers can split the output features across threads.
 template <typename T, typename U = T, typename V = U>
-inline void vec_quantized_matmul_transb_int8(
+inline void vec_quantized_matmul_transb_int8_cols(
     T* __restrict__ z,
     const U* __restrict__ x,
     const int8_t* __restrict__ y,
@@ -121,18 +296,19 @@ inline void vec_quantized_matmul_transb_int8(
     int64_t m,
     int64_t n,
     int64_t p,
-    int64_t g) {
+    int64_t g,
+    int64_t j_begin,
+    int64_t j_end) {
   int64_t n_over_g = (n + g - 1) / g;
 
-  for (size_t i = 0; i < m; ++i) {
-    for (size_t j = 0; j < p; ++j) {
+  // Each weight row is streamed once and reused for every row of x.
+  for (size_t j = j_begin; j < j_end; ++j) {
+    for (size_t i = 0; i < m; ++i) {
       T sum = 0;
       for (size_t k = 0; k < n; k += g) {
-        T psum = 0;
         // the last group may have fewer than g elements
-        for (size_t k2 = k; k2 < bounds_min(k + g, n); k2++) {
-          psum += x[i * n + k2] * static_cast<U>(y[j * n + k2]);
-        }
+        T psum = internal::quantized_dot_int8<T>(
+            x + i * n + k, y + j * n + k, bounds_min(k + g, n) - k);
         sum += psum * s[j * n_over_g + k / g];
       }
       z[i * p + j] = sum;
@@ -140,6 +316,21 @@ inline void vec_quantized_matmul_transb_int8(
   }
 }
 
+/// x: m * n, y: p * n, z: m * p, s: p * groups
+/// z[i][j] = sum(x[i][k] * y[j][k] * s[j][k/g])
+template <typename T, typename U = T, typename V = U>
+inline void vec_quantized_matmul_transb_int8(
+    T* __restrict__ z,
+    const U* __restrict__ x,
+    const int8_t* __restrict__ y,
+    const V* __restrict__ s,
+    int64_t m,
+    int64_t n,
+    int64_t p,
+    int64_t g) {
+  vec_quantized_matmul_transb_int8_cols<T, U, V>(z, x, y, s, m, n, p, g, 0, p);
+}
+
 // mat1 (m x n), mat2 (n x p), out (m, p), self (m x p)
 // z[i][j] = sum(x[i][k] * y[k][j]), for k in range(n)
 // T for tensor dtype, U for scalar type
@@ -246,5 +437,608 @@ inline void dequantize_i8_f32(
   }
 }
 
+namespace internal {
+#if defined(__aarch64__)
+// Narrows eight clamped int32 lanes to the output type and stores them.
+inline void store_narrow_8(int8_t* y, int32x4_t lo, int32x4_t hi) {
+  vst1_s8(y, vmovn_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi))));
+}
+inline void store_narrow_8(uint8_t* y, int32x4_t lo, int32x4_t hi) {
+  vst1_u8(
+      y,
+      vmovn_u16(vreinterpretq_u16_s16(
+          vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)))));
+}
+inline void store_narrow_8(int16_t* y, int32x4_t lo, int32x4_t hi) {
+  vst1q_s16(y, vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+}
+
+// Loads eight elements and widens them to int16.
+inline int16x8_t load_widen_8(const int8_t* x) {
+  return vmovl_s8(vld1_s8(x));
+}
+inline int16x8_t load_widen_8(const uint8_t* x) {
+  return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(x)));
+}
+inline int16x8_t load_widen_8(const int16_t* x) {
+  return vld1q_s16(x);
+}
+#elif defined(__AVX2__) && defined(__FMA__)
+// Narrows eight clamped int32 lanes to the output type and stores them.
+inline void store_narrow_8(int8_t* y, __m256i q) {
+  const __m128i q16 = _mm_packs_epi32(
+      _mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(y), _mm_packs_epi16(q16, q16));
+}
+inline void store_narrow_8(uint8_t* y, __m256i q) {
+  const __m128i q16 = _mm_packs_epi32(
+      _mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(y), _mm_packus_epi16(q16, q16));
+}
+inline void store_narrow_8(int16_t* y, __m256i q) {
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(y),
+      _mm_packs_epi32(
+          _mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1)));
+}
+
+// Loads eight elements and widens them to int32.
+inline __m256i load_widen_8(const int8_t* x) {
+  return _mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(x)));
+}
+inline __m256i load_widen_8(const uint8_t* x) {
+  return _mm256_cvtepu8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(x)));
+}
+inline __m256i load_widen_8(const int16_t* x) {
+  return _mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+}
+#endif
+} // namespace internal
+
+/// Quantizes the `size` floats at `x` into `y` as
+/// clamp(zero_point + nearbyint(x * inv_scale), quant_min, quant_max), with
+/// the product and the sum computed in float. OUT must be int8_t, uint8_t or
+/// int16_t, and the quant range must fit in it.
+template <typename OUT>
+inline void vec_quantize_f32(
+    OUT* __restrict__ y,
+    const float* __restrict__ x,
+    float inv_scale,
+    int32_t zero_point,
+    int32_t quant_min,
+    int32_t quant_max,
+    size_t size) {
+  static_assert(
+      std::is_same<OUT, int8_t>::value || std::is_same<OUT, uint8_t>::value ||
+          std::is_same<OUT, int16_t>::value,
+      "OUT must be int8_t, uint8_t or int16_t");
+  size_t i = 0;
+#if defined(__aarch64__)
+  const float32x4_t v_inv_scale = vdupq_n_f32(inv_scale);
+  const float32x4_t v_zero_point = vdupq_n_f32(zero_point);
+  const float32x4_t v_min = vdupq_n_f32(quant_min);
+  const float32x4_t v_max = vdupq_n_f32(quant_max);
+  for (; i + 8 <= size; i += 8) {
+    float32x4_t lo = vrndnq_f32(vmulq_f32(vld1q_f32(x + i), v_inv_scale));
+    float32x4_t hi = vrndnq_f32(vmulq_f32(vld1q_f32(x + i + 4), v_inv_scale));
+    lo = vminq_f32(vmaxq_f32(vaddq_f32(lo, v_zero_point), v_min), v_max);
+    hi = vminq_f32(vmaxq_f32(vaddq_f32(hi, v_zero_point), v_min), v_max);
+    internal::store_narrow_8(y + i, vcvtq_s32_f32(lo), vcvtq_s32_f32(hi));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256 v_inv_scale = _mm256_set1_ps(inv_scale);
+  const __m256 v_zero_point = _mm256_set1_ps(zero_point);
+  const __m256 v_min = _mm256_set1_ps(quant_min);
+  const __m256 v_max = _mm256_set1_ps(quant_max);
+  for (; i + 8 <= size; i += 8) {
+    __m256 v = _mm256_round_ps(
+        _mm256_mul_ps(_mm256_loadu_ps(x + i), v_inv_scale),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    v = _mm256_min_ps(
+        _mm256_max_ps(_mm256_add_ps(v, v_zero_point), v_min), v_max);
+    internal::store_narrow_8(y + i, _mm256_cvtps_epi32(v));
+  }
+#endif
+  for (; i < size; ++i) {
+    int64_t q = static_cast<int64_t>(
+        zero_point + std::nearbyint(static_cast<float>(inv_scale * x[i])));
+    q = std::max<int64_t>(q, quant_min);
+    q = std::min<int64_t>(q, quant_max);
+    y[i] = static_cast<OUT>(q);
+  }
+}
+
+/// Dequantizes the `size` elements at `x` into `y` as
+/// (x - zero_point) * scale, with the product computed in float. IN must be
+/// int8_t, uint8_t or int16_t.
+template <typename IN>
+inline void vec_dequantize_f32(
+    float* __restrict__ y,
+    const IN* __restrict__ x,
+    float scale,
+    int32_t zero_point,
+    size_t size) {
+  static_assert(
+      std::is_same<IN, int8_t>::value || std::is_same<IN, uint8_t>::value ||
+          std::is_same<IN, int16_t>::value,
+      "IN must be int8_t, uint8_t or int16_t");
+  size_t i = 0;
+#if defined(__aarch64__)
+  const float32x4_t v_scale = vdupq_n_f32(scale);
+  const int32x4_t v_zero_point = vdupq_n_s32(zero_point);
+  for (; i + 8 <= size; i += 8) {
+    const int16x8_t q = internal::load_widen_8(x + i);
+    const int32x4_t lo = vsubq_s32(vmovl_s16(vget_low_s16(q)), v_zero_point);
+    const int32x4_t hi = vsubq_s32(vmovl_s16(vget_high_s16(q)), v_zero_point);
+    vst1q_f32(y + i, vmulq_f32(vcvtq_f32_s32(lo), v_scale));
+    vst1q_f32(y + i + 4, vmulq_f32(vcvtq_f32_s32(hi), v_scale));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256 v_scale = _mm256_set1_ps(scale);
+  const __m256i v_zero_point = _mm256_set1_epi32(zero_point);
+  for (; i + 8 <= size; i += 8) {
+    const __m256i q =
+        _mm256_sub_epi32(internal::load_widen_8(x + i), v_zero_point);
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(_mm256_cvtepi32_ps(q), v_scale));
+  }
+#endif
+  for (; i < size; ++i) {
+    y[i] = (x[i] - zero_point) * scale;
+  }
+}
+
+/// Dequantizes the 4-bit values with indices [begin, end) into `y`, which
+/// receives end - begin floats. The values are packed two per byte in `w`,
+/// high nibble first, and stored with an offset of 8, so each one becomes
+/// (q - 8 - zero_point) * scale.
+inline void vec_dequantize_i4_f32(
+    float* __restrict__ y,
+    const uint8_t* __restrict__ w,
+    int64_t begin,
+    int64_t end,
+    float scale,
+    float zero_point) {
+  auto dequantize_one = [&](int64_t j) {
+    const uint8_t packed = w[j >> 1];
+    const int32_t q = (j & 1) ? (packed & 0x0F) : (packed >> 4);
+    return (static_cast<float>(q - 8) - zero_point) * scale;
+  };
+  int64_t j = begin;
+  if ((j & 1) && j < end) {
+    *y++ = dequantize_one(j++);
+  }
+#if defined(__aarch64__)
+  const float32x4_t v_scale = vdupq_n_f32(scale);
+  const float32x4_t v_zero_point = vdupq_n_f32(zero_point);
+  const int8x16_t v_offset = vdupq_n_s8(8);
+  for (; j + 32 <= end; j += 32, y += 32) {
+    const uint8x16_t packed = vld1q_u8(w + (j >> 1));
+    // Interleave the high and low nibbles back into element order.
+    const uint8x16x2_t q = vzipq_u8(
+        vshrq_n_u8(packed, 4), vandq_u8(packed, vdupq_n_u8(0x0F)));
+    for (int half = 0; half < 2; ++half) {
+      const int8x16_t v = vsubq_s8(vreinterpretq_s8_u8(q.val[half]), v_offset);
+      const int16x8_t v_lo = vmovl_s8(vget_low_s8(v));
+      const int16x8_t v_hi = vmovl_s8(vget_high_s8(v));
+      const int32x4_t parts[4] = {
+          vmovl_s16(vget_low_s16(v_lo)),
+          vmovl_s16(vget_high_s16(v_lo)),
+          vmovl_s16(vget_low_s16(v_hi)),
+          vmovl_s16(vget_high_s16(v_hi))};
+      for (int k = 0; k < 4; ++k) {
+        vst1q_f32(
+            y + half * 16 + k * 4,
+            vmulq_f32(
+                vsubq_f32(vcvtq_f32_s32(parts[k]), v_zero_point), v_scale));
+      }
+    }
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256 v_scale = _mm256_set1_ps(scale);
+  const __m256 v_zero_point = _mm256_set1_ps(zero_point);
+  const __m128i v_offset = _mm_set1_epi8(8);
+  const __m128i v_mask = _mm_set1_epi8(0x0F);
+  for (; j + 32 <= end; j += 32, y += 32) {
+    const __m128i packed =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + (j >> 1)));
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), v_mask);
+    const __m128i lo = _mm_and_si128(packed, v_mask);
+    // Interleave the high and low nibbles back into element order.
+    const __m128i q[2] = {
+        _mm_sub_epi8(_mm_unpacklo_epi8(hi, lo), v_offset),
+        _mm_sub_epi8(_mm_unpackhi_epi8(hi, lo), v_offset)};
+    for (int half = 0; half < 2; ++half) {
+      const __m256 f_lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q[half]));
+      const __m256 f_hi = _mm256_cvtepi32_ps(
+          _mm256_cvtepi8_epi32(_mm_srli_si128(q[half], 8)));
+      _mm256_storeu_ps(
+          y + half * 16,
+          _mm256_mul_ps(_mm256_sub_ps(f_lo, v_zero_point), v_scale));
+      _mm256_storeu_ps(
+          y + half * 16 + 8,
+          _mm256_mul_ps(_mm256_sub_ps(f_hi, v_zero_point), v_scale));
+    }
+  }
+#endif
+  for (; j < end; ++j) {
+    *y++ = dequantize_one(j);
+  }
+}
+
+/// Returns sum(x[k] * y[k]) over the `size` int8 elements of `x` and `y`,
+/// accumulated in int32, and stores sum(y[k]) in `y_sum`. The sum of `y` lets
+/// callers apply zero points to the dot product without a second pass.
+inline int32_t vec_dot_i8_i32(
+    const int8_t* __restrict__ x,
+    const int8_t* __restrict__ y,
+    size_t size,
+    int32_t* y_sum) {
+  size_t k = 0;
+  int32_t dot = 0;
+  int32_t sum = 0;
+#if defined(__aarch64__)
+  int32x4_t acc = vdupq_n_s32(0);
+  int32x4_t acc_sum = vdupq_n_s32(0);
+  for (; k + 16 <= size; k += 16) {
+    const int8x16_t a = vld1q_s8(x + k);
+    const int8x16_t b = vld1q_s8(y + k);
+#if defined(__ARM_FEATURE_DOTPROD)
+    acc = vdotq_s32(acc, a, b);
+    acc_sum = vdotq_s32(acc_sum, b, vdupq_n_s8(1));
+#else
+    acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(a), vget_low_s8(b)));
+    acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(a), vget_high_s8(b)));
+    acc_sum = vpadalq_s16(acc_sum, vpaddlq_s8(b));
+#endif
+  }
+  dot = vaddvq_s32(acc);
+  sum = vaddvq_s32(acc_sum);
+#elif defined(__AVX2__) && defined(__FMA__)
+  __m256i acc = _mm256_setzero_si256();
+  __m256i acc_sum = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+  for (; k + 16 <= size; k += 16) {
+    const __m256i a = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + k)));
+    const __m256i b = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + k)));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+    acc_sum = _mm256_add_epi32(acc_sum, _mm256_madd_epi16(b, ones));
+  }
+  const auto hsum = [](__m256i v) {
+    __m128i v4 = _mm_add_epi32(
+        _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    v4 = _mm_hadd_epi32(v4, v4);
+    v4 = _mm_hadd_epi32(v4, v4);
+    return _mm_cvtsi128_si32(v4);
+  };
+  dot = hsum(acc);
+  sum = hsum(acc_sum);
+#endif
+  for (; k < size; ++k) {
+    dot += static_cast<int32_t>(x[k]) * y[k];
+    sum += y[k];
+  }
+  *y_sum = sum;
+  return dot;
+}
+
+/// Splits a positive real multiplier into a Q31 fixed-point `multiplier` in
+/// [2^30, 2^31) and a `shift`, such that
+/// real == multiplier * 2^-31 * 2^-shift. A negative shift is a left shift.
+inline void quantize_multiplier_q31(
+    double real,
+    int32_t* multiplier,
+    int32_t* shift) {
+  int exponent = 0;
+  const double fraction = std::frexp(real, &exponent);
+  int64_t q = std::llround(fraction * (1ll << 31));
+  if (q == (1ll << 31)) {
+    q /= 2;
+    ++exponent;
+  }
+  *multiplier = static_cast<int32_t>(q);
+  *shift = -exponent;
+}
+
+namespace internal {
+// Computes round(x * multiplier / 2^31), then shifts right by `shift` with
+// rounding (or left by -shift beforehand), rounding halves towards +inf.
+inline int32_t requantize_q31(int32_t x, int32_t multiplier, int32_t shift) {
+  const int32_t left_shift = shift < 0 ? -shift : 0;
+  const int32_t right_shift = shift > 0 ? shift : 0;
+  const int64_t product =
+      static_cast<int64_t>(x) * (int64_t(1) << left_shift) * multiplier;
+  const int32_t high = static_cast<int32_t>((product + (1ll << 30)) >> 31);
+  return right_shift == 0
+      ? high
+      : static_cast<int32_t>(
+            (static_cast<int64_t>(high) + (int64_t(1) << (right_shift - 1))) >>
+            right_shift);
+}
+
+#if defined(__aarch64__)
+inline int32x4_t requantize_q31(
+    int32x4_t x,
+    int32x4_t multiplier,
+    int32x4_t left_shift,
+    int32x4_t neg_right_shift) {
+  return vrshlq_s32(
+      vqrdmulhq_s32(vshlq_s32(x, left_shift), multiplier), neg_right_shift);
+}
+#elif defined(__AVX2__) && defined(__FMA__)
+inline __m256i requantize_q31(
+    __m256i x,
+    __m256i multiplier,
+    __m128i left_shift,
+    __m128i right_shift,
+    __m256i right_rounding) {
+  const __m256i rounding = _mm256_set1_epi64x(1ll << 30);
+  x = _mm256_sll_epi32(x, left_shift);
+  // 32x32->64 products of the even and odd lanes; only bits 31..62 of each
+  // product are kept, so the logical 64-bit shifts are exact.
+  const __m256i even = _mm256_srli_epi64(
+      _mm256_add_epi64(_mm256_mul_epi32(x, multiplier), rounding), 31);
+  const __m256i odd = _mm256_slli_epi64(
+      _mm256_srli_epi64(
+          _mm256_add_epi64(
+              _mm256_mul_epi32(
+                  _mm256_srli_epi64(x, 32), _mm256_srli_epi64(multiplier, 32)),
+              rounding),
+          31),
+      32);
+  return _mm256_sra_epi32(
+      _mm256_add_epi32(_mm256_blend_epi32(even, odd, 0xAA), right_rounding),
+      right_shift);
+}
+#endif
+} // namespace internal
+
+/// Adds two quantized tensors without going through float:
+/// z = clamp(z_zero_point + (((x - x_zero_point) * x_multiplier +
+///     (y - y_zero_point) * y_multiplier) >> shift), quant_min, quant_max),
+/// where the shift rounds halves towards +inf. The multipliers are the input
+/// to output scale ratios scaled by 2^shift; they must be below 2^20 and
+/// `shift` must be in [1, 31]. T must be int8_t or uint8_t.
+template <typename T>
+inline void vec_quantized_add(
+    T* __restrict__ z,
+    const T* __restrict__ x,
+    const T* __restrict__ y,
+    int32_t x_zero_point,
+    int32_t x_multiplier,
+    int32_t y_zero_point,
+    int32_t y_multiplier,
+    int32_t shift,
+    int32_t z_zero_point,
+    int32_t quant_min,
+    int32_t quant_max,
+    size_t size) {
+  static_assert(
+      std::is_same<T, int8_t>::value || std::is_same<T, uint8_t>::value,
+      "vec_quantized_add only supports 8-bit types");
+  size_t i = 0;
+#if defined(__aarch64__)
+  const int32x4_t v_x_zero_point = vdupq_n_s32(x_zero_point);
+  const int32x4_t v_y_zero_point = vdupq_n_s32(y_zero_point);
+  const int32x4_t v_x_multiplier = vdupq_n_s32(x_multiplier);
+  const int32x4_t v_y_multiplier = vdupq_n_s32(y_multiplier);
+  const int32x4_t v_neg_shift = vdupq_n_s32(-shift);
+  const int32x4_t v_z_zero_point = vdupq_n_s32(z_zero_point);
+  const int32x4_t v_min = vdupq_n_s32(quant_min);
+  const int32x4_t v_max = vdupq_n_s32(quant_max);
+  const auto add_4 = [&](int16x4_t xv, int16x4_t yv) {
+    int32x4_t acc =
+        vmulq_s32(vsubq_s32(vmovl_s16(xv), v_x_zero_point), v_x_multiplier);
+    acc = vmlaq_s32(
+        acc, vsubq_s32(vmovl_s16(yv), v_y_zero_point), v_y_multiplier);
+    acc = vaddq_s32(vrshlq_s32(acc, v_neg_shift), v_z_zero_point);
+    return vminq_s32(vmaxq_s32(acc, v_min), v_max);
+  };
+  for (; i + 8 <= size; i += 8) {
+    const int16x8_t xv = internal::load_widen_8(x + i);
+    const int16x8_t yv = internal::load_widen_8(y + i);
+    internal::store_narrow_8(
+        z + i,
+        add_4(vget_low_s16(xv), vget_low_s16(yv)),
+        add_4(vget_high_s16(xv), vget_high_s16(yv)));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256i v_x_zero_point = _mm256_set1_epi32(x_zero_point);
+  const __m256i v_y_zero_point = _mm256_set1_epi32(y_zero_point);
+  const __m256i v_x_multiplier = _mm256_set1_epi32(x_multiplier);
+  const __m256i v_y_multiplier = _mm256_set1_epi32(y_multiplier);
+  const __m256i v_rounding = _mm256_set1_epi32(1 << (shift - 1));
+  const __m128i v_shift = _mm_cvtsi32_si128(shift);
+  const __m256i v_z_zero_point = _mm256_set1_epi32(z_zero_point);
+  const __m256i v_min = _mm256_set1_epi32(quant_min);
+  const __m256i v_max = _mm256_set1_epi32(quant_max);
+  for (; i + 8 <= size; i += 8) {
+    __m256i acc = _mm256_add_epi32(
+        _mm256_mullo_epi32(
+            _mm256_sub_epi32(internal::load_widen_8(x + i), v_x_zero_point),
+            v_x_multiplier),
+        _mm256_mullo_epi32(
+            _mm256_sub_epi32(internal::load_widen_8(y + i), v_y_zero_point),
+            v_y_multiplier));
+    acc = _mm256_add_epi32(
+        _mm256_sra_epi32(_mm256_add_epi32(acc, v_rounding), v_shift),
+        v_z_zero_point);
+    internal::store_narrow_8(
+        z + i, _mm256_min_epi32(_mm256_max_epi32(acc, v_min), v_max));
+  }
+#endif
+  for (; i < size; ++i) {
+    const int32_t acc = (x[i] - x_zero_point) * x_multiplier +
+        (y[i] - y_zero_point) * y_multiplier;
+    const int32_t q = z_zero_point + ((acc + (1 << (shift - 1))) >> shift);
+    z[i] = static_cast<T>(std::min(std::max(q, quant_min), quant_max));
+  }
+}
+
+/// Multiplies two quantized tensors without going through float:
+/// z = clamp(z_zero_point + requantize((x - x_zero_point) *
+/// (y - y_zero_point)), quant_min, quant_max), where requantize applies the
+/// Q31 `multiplier` and `shift` from quantize_multiplier_q31(). -shift must
+/// not exceed 15. T must be int8_t or uint8_t.
+template <typename T>
+inline void vec_quantized_mul(
+    T* __restrict__ z,
+    const T* __restrict__ x,
+    const T* __restrict__ y,
+    int32_t x_zero_point,
+    int32_t y_zero_point,
+    int32_t multiplier,
+    int32_t shift,
+    int32_t z_zero_point,
+    int32_t quant_min,
+    int32_t quant_max,
+    size_t size) {
+  static_assert(
+      std::is_same<T, int8_t>::value || std::is_same<T, uint8_t>::value,
+      "vec_quantized_mul only supports 8-bit types");
+  size_t i = 0;
+#if defined(__aarch64__)
+  const int16x8_t v_x_zero_point = vdupq_n_s16(x_zero_point);
+  const int16x8_t v_y_zero_point = vdupq_n_s16(y_zero_point);
+  const int32x4_t v_multiplier = vdupq_n_s32(multiplier);
+  const int32x4_t v_left_shift = vdupq_n_s32(shift < 0 ? -shift : 0);
+  const int32x4_t v_neg_right_shift = vdupq_n_s32(shift > 0 ? -shift : 0);
+  const int32x4_t v_z_zero_point = vdupq_n_s32(z_zero_point);
+  const int32x4_t v_min = vdupq_n_s32(quant_min);
+  const int32x4_t v_max = vdupq_n_s32(quant_max);
+  const auto finish_4 = [&](int32x4_t product) {
+    const int32x4_t q = vaddq_s32(
+        internal::requantize_q31(
+            product, v_multiplier, v_left_shift, v_neg_right_shift),
+        v_z_zero_point);
+    return vminq_s32(vmaxq_s32(q, v_min), v_max);
+  };
+  for (; i + 8 <= size; i += 8) {
+    // The differences fit in int16 for 8-bit inputs.
+    const int16x8_t xv =
+        vsubq_s16(internal::load_widen_8(x + i), v_x_zero_point);
+    const int16x8_t yv =
+        vsubq_s16(internal::load_widen_8(y + i), v_y_zero_point);
+    internal::store_narrow_8(
+        z + i,
+        finish_4(vmull_s16(vget_low_s16(xv), vget_low_s16(yv))),
+        finish_4(vmull_high_s16(xv, yv)));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256i v_x_zero_point = _mm256_set1_epi32(x_zero_point);
+  const __m256i v_y_zero_point = _mm256_set1_epi32(y_zero_point);
+  const __m256i v_multiplier = _mm256_set1_epi32(multiplier);
+  const __m128i v_left_shift = _mm_cvtsi32_si128(shift < 0 ? -shift : 0);
+  const __m128i v_right_shift = _mm_cvtsi32_si128(shift > 0 ? shift : 0);
+  const __m256i v_right_rounding =
+      _mm256_set1_epi32(shift > 0 ? 1 << (shift - 1) : 0);
+  const __m256i v_z_zero_point = _mm256_set1_epi32(z_zero_point);
+  const __m256i v_min = _mm256_set1_epi32(quant_min);
+  const __m256i v_max = _mm256_set1_epi32(quant_max);
+  for (; i + 8 <= size; i += 8) {
+    const __m256i product = _mm256_mullo_epi32(
+        _mm256_sub_epi32(internal::load_widen_8(x + i), v_x_zero_point),
+        _mm256_sub_epi32(internal::load_widen_8(y + i), v_y_zero_point));
+    const __m256i q = _mm256_add_epi32(
+        internal::requantize_q31(
+            product,
+            v_multiplier,
+            v_left_shift,
+            v_right_shift,
+            v_right_rounding),
+        v_z_zero_point);
+    internal::store_narrow_8(
+        z + i, _mm256_min_epi32(_mm256_max_epi32(q, v_min), v_max));
+  }
+#endif
+  for (; i < size; ++i) {
+    const int32_t q = z_zero_point +
+        internal::requantize_q31(
+                      (x[i] - x_zero_point) * (y[i] - y_zero_point),
+                      multiplier,
+                      shift);
+    z[i] = static_cast<T>(std::min(std::max(q, quant_min), quant_max));
+  }
+}
+
+/// Applies relu to a quantized tensor and requantizes the result without
+/// going through float:
+/// z = clamp(z_zero_point + requantize(max(x - x_zero_point, 0)), quant_min,
+/// quant_max), where requantize applies the Q31 `multiplier` and `shift` from
+/// quantize_multiplier_q31(). -shift must not exceed 23. T must be int8_t or
+/// uint8_t.
+template <typename T>
+inline void vec_quantized_relu(
+    T* __restrict__ z,
+    const T* __restrict__ x,
+    int32_t x_zero_point,
+    int32_t multiplier,
+    int32_t shift,
+    int32_t z_zero_point,
+    int32_t quant_min,
+    int32_t quant_max,
+    size_t size) {
+  static_assert(
+      std::is_same<T, int8_t>::value || std::is_same<T, uint8_t>::value,
+      "vec_quantized_relu only supports 8-bit types");
+  size_t i = 0;
+#if defined(__aarch64__)
+  const int16x8_t v_x_zero_point = vdupq_n_s16(x_zero_point);
+  const int32x4_t v_multiplier = vdupq_n_s32(multiplier);
+  const int32x4_t v_left_shift = vdupq_n_s32(shift < 0 ? -shift : 0);
+  const int32x4_t v_neg_right_shift = vdupq_n_s32(shift > 0 ? -shift : 0);
+  const int32x4_t v_z_zero_point = vdupq_n_s32(z_zero_point);
+  const int32x4_t v_min = vdupq_n_s32(quant_min);
+  const int32x4_t v_max = vdupq_n_s32(quant_max);
+  const auto finish_4 = [&](int16x4_t v) {
+    const int32x4_t q = vaddq_s32(
+        internal::requantize_q31(
+            vmovl_s16(v), v_multiplier, v_left_shift, v_neg_right_shift),
+        v_z_zero_point);
+    return vminq_s32(vmaxq_s32(q, v_min), v_max);
+  };
+  for (; i + 8 <= size; i += 8) {
+    const int16x8_t xv = vmaxq_s16(
+        vsubq_s16(internal::load_widen_8(x + i), v_x_zero_point),
+        vdupq_n_s16(0));
+    internal::store_narrow_8(
+        z + i, finish_4(vget_low_s16(xv)), finish_4(vget_high_s16(xv)));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256i v_x_zero_point = _mm256_set1_epi32(x_zero_point);
+  const __m256i v_multiplier = _mm256_set1_epi32(multiplier);
+  const __m128i v_left_shift = _mm_cvtsi32_si128(shift < 0 ? -shift : 0);
+  const __m128i v_right_shift = _mm_cvtsi32_si128(shift > 0 ? shift : 0);
+  const __m256i v_right_rounding =
+      _mm256_set1_epi32(shift > 0 ? 1 << (shift - 1) : 0);
+  const __m256i v_z_zero_point = _mm256_set1_epi32(z_zero_point);
+  const __m256i v_min = _mm256_set1_epi32(quant_min);
+  const __m256i v_max = _mm256_set1_epi32(quant_max);
+  for (; i + 8 <= size; i += 8) {
+    const __m256i v = _mm256_max_epi32(
+        _mm256_sub_epi32(internal::load_widen_8(x + i), v_x_zero_point),
+        _mm256_setzero_si256());
+    const __m256i q = _mm256_add_epi32(
+        internal::requantize_q31(
+            v, v_multiplier, v_left_shift, v_right_shift, v_right_rounding),
+        v_z_zero_point);
+    internal::store_narrow_8(
+        z + i, _mm256_min_epi32(_mm256_max_epi32(q, v_min), v_max));
+  }
+#endif
+  for (; i < size; ++i) {
+    const int32_t q = z_zero_point +
+        internal::requantize_q31(
+                      std::max<int32_t>(x[i] - x_zero_point, 0),
+                      multiplier,
+                      shift);
+    z[i] = static_cast<T>(std::min(std::max(q, quant_min), quant_max));
+  }
+}
+
 } // namespace executor
 } // namespace torch
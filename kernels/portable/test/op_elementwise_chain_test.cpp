@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+// Opcodes from op_elementwise_chain.cpp.
+constexpr int64_t kAdd = 0;
+constexpr int64_t kMul = 2;
+constexpr int64_t kAddScalar = 4;
+constexpr int64_t kMulScalar = 5;
+constexpr int64_t kNeg = 6;
+constexpr int64_t kRelu = 7;
+constexpr int64_t kSigmoid = 8;
+constexpr int64_t kTanh = 9;
+constexpr int64_t kExp = 10;
+
+} // namespace
+
+class OpElementwiseChainOutTest : public OperatorTest {
+ protected:
+  Tensor& elementwise_chain_out(
+      const std::vector<Tensor>& inputs,
+      const std::vector<int64_t>& program,
+      const std::vector<double>& scalars,
+      Tensor& out) {
+    return torch::executor::native::elementwise_chain_out(
+        context_,
+        ArrayRef<Tensor>(inputs.data(), inputs.size()),
+        ArrayRef<int64_t>(program.data(), program.size()),
+        ArrayRef<double>(scalars.data(), scalars.size()),
+        out);
+  }
+};
+
+TEST_F(OpElementwiseChainOutTest, MatchesUnfusedOps) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // More elements than one block, with a partial last block.
+  const int32_t n = 300;
+  std::vector<float> a_data(n);
+  std::vector<float> b_data(n);
+  std::vector<float> c_data(n);
+  std::vector<float> expected(n);
+  for (int32_t i = 0; i < n; ++i) {
+    a_data[i] = 0.01f * i - 1.5f;
+    b_data[i] = 0.5f - 0.003f * i;
+    c_data[i] = 0.25f * (i % 7);
+    // The ops one at a time, each rounding to float like its kernel.
+    const float t0 = a_data[i] * b_data[i];
+    const float t1 = t0 + c_data[i];
+    const float t2 =
+        static_cast<float>(1.0 / (1.0 + std::exp(-static_cast<double>(t1))));
+    expected[i] = t2 * a_data[i];
+  }
+  const Tensor a = tf.make({3, 100}, a_data);
+  const Tensor b = tf.make({3, 100}, b_data);
+  const Tensor c = tf.make({3, 100}, c_data);
+  Tensor out = tf.zeros({3, 100});
+
+  // mul -> add -> sigmoid -> mul, with registers 0-2 holding a, b and c.
+  elementwise_chain_out(
+      {a, b, c},
+      {kMul, 0, 1, kAdd, 3, 2, kSigmoid, 4, -1, kMul, 5, 0},
+      {},
+      out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({3, 100}, expected));
+}
+
+TEST_F(OpElementwiseChainOutTest, ScalarAndUnaryOps) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const Tensor x = tf.make({2, 3}, {-2.0, -1.0, 0.0, 0.5, 1.0, NAN});
+  Tensor out = tf.zeros({2, 3});
+
+  // relu(tanh(exp(-(x * 2 + 1))) * 3)
+  elementwise_chain_out(
+      {x},
+      {kMulScalar,
+       0,
+       0,
+       kAddScalar,
+       1,
+       1,
+       kNeg,
+       2,
+       -1,
+       kExp,
+       3,
+       -1,
+       kTanh,
+       4,
+       -1,
+       kMulScalar,
+       5,
+       2,
+       kRelu,
+       6,
+       -1},
+      {2.0, 1.0, 3.0},
+      out);
+
+  std::vector<float> expected;
+  for (const float v : {-2.0f, -1.0f, 0.0f, 0.5f, 1.0f}) {
+    const float t = -(v * 2.0f + 1.0f);
+    const float e = static_cast<float>(std::exp(static_cast<double>(t)));
+    const float h = static_cast<float>(std::tanh(static_cast<double>(e)));
+    expected.push_back(std::max(h * 3.0f, 0.0f));
+  }
+  expected.push_back(NAN);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 3}, expected));
+}
+
+TEST_F(OpElementwiseChainOutTest, DoubleTensors) {
+  TensorFactory<ScalarType::Double> tf;
+
+  const Tensor a = tf.make({4}, {1.0, 2.0, 3.0, 4.0});
+  const Tensor b = tf.make({4}, {0.5, 0.25, 0.125, 0.0625});
+  Tensor out = tf.zeros({4});
+
+  elementwise_chain_out({a, b}, {kMul, 0, 1, kAdd, 2, 0}, {}, out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({4}, {1.5, 2.5, 3.375, 4.25}));
+}
+
+TEST_F(OpElementwiseChainOutTest, ReadingLaterRegisterDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const Tensor a = tf.ones({2, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  // The first step reads register 1, which only the second step writes.
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      elementwise_chain_out({a}, {kNeg, 1, -1, kNeg, 0, -1}, {}, out));
+}
+
+TEST_F(OpElementwiseChainOutTest, MissingScalarDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const Tensor a = tf.ones({2, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, elementwise_chain_out({a}, {kAddScalar, 0, 1}, {1.0}, out));
+}
+
+TEST_F(OpElementwiseChainOutTest, MismatchedShapesDie) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const Tensor a = tf.ones({2, 2});
+  const Tensor b = tf.ones({4});
+  Tensor out = tf.zeros({2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, elementwise_chain_out({a, b}, {kAdd, 0, 1}, {}, out));
+}
+
+TEST_F(OpElementwiseChainOutTest, IntegerTensorsDie) {
+  TensorFactory<ScalarType::Int> tf;
+
+  const Tensor a = tf.ones({2, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, elementwise_chain_out({a}, {kNeg, 0, -1}, {}, out));
+}
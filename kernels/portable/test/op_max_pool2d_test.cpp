@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpMaxPool2DOutTest : public OperatorTest {
+ protected:
+  Tensor& max_pool2d_out(
+      const Tensor& self,
+      const std::vector<int64_t>& kernel_size,
+      const std::vector<int64_t>& stride,
+      const std::vector<int64_t>& padding,
+      const std::vector<int64_t>& dilation,
+      bool ceil_mode,
+      Tensor& out) {
+    return torch::executor::native::max_pool2d_out(
+        context_,
+        self,
+        ArrayRef<int64_t>(kernel_size.data(), kernel_size.size()),
+        ArrayRef<int64_t>(stride.data(), stride.size()),
+        ArrayRef<int64_t>(padding.data(), padding.size()),
+        ArrayRef<int64_t>(dilation.data(), dilation.size()),
+        ceil_mode,
+        out);
+  }
+};
+
+TEST_F(OpMaxPool2DOutTest, MatchesMaxPool2DWithIndices) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // The values of max_pool2d_with_indices for the same arguments; see
+  // OpMaxPool2DWithIndicesOutTest.SanityTestWideRows.
+  const Tensor self = tf.make(
+      {1, 3, 19},
+      {-8.0, 4.0,  -1.0, -6.0, 6.0,  1.0,  -4.0, 8.0,  3.0,  -2.0, -7.0, 5.0,
+       0.0,  -5.0, 7.0,  2.0,  -3.0, -8.0, 4.0,  -1.0, -6.0, 6.0,  1.0,  -4.0,
+       8.0,  3.0,  -2.0, -7.0, 5.0,  0.0,  -5.0, 7.0,  2.0,  -3.0, -8.0, 4.0,
+       -1.0, -6.0, 6.0,  1.0,  -4.0, 8.0,  3.0,  -2.0, -7.0, 5.0,  0.0,  -5.0,
+       7.0,  2.0,  -3.0, -8.0, 4.0,  -1.0, -6.0, 6.0,  1.0});
+  Tensor out = tf.zeros({1, 2, 19});
+
+  max_pool2d_out(self, {2, 3}, {1, 1}, {0, 1}, {1, 1}, false, out);
+
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          {1, 2, 19},
+          {4.0, 6.0, 6.0, 6.0, 8.0, 8.0, 8.0, 8.0, 8.0, 5.0, 5.0, 7.0, 7.0,
+           7.0, 7.0, 7.0, 4.0, 4.0, 4.0, 6.0, 6.0, 8.0, 8.0, 8.0, 8.0, 8.0,
+           5.0, 5.0, 7.0, 7.0, 7.0, 7.0, 7.0, 4.0, 4.0, 6.0, 6.0, 6.0}));
+}
+
+TEST_F(OpMaxPool2DOutTest, StrideDilationAndCeilMode) {
+  TensorFactory<ScalarType::Int> tf;
+
+  const Tensor self = tf.make(
+      {1, 1, 5, 5}, {1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13,
+                     14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25});
+  Tensor out = tf.zeros({1, 1, 2, 2});
+
+  // Windows of taps 2 apart start at rows and columns 0 and 2; ceil_mode adds
+  // no partial window because it would start past the padded input.
+  max_pool2d_out(self, {2, 2}, {2, 2}, {0, 0}, {2, 2}, true, out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({1, 1, 2, 2}, {13, 15, 23, 25}));
+}
+
+TEST_F(OpMaxPool2DOutTest, LeadingNaNPropagates) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const Tensor self =
+      tf.make({1, 2, 4}, {NAN, 1.0, 2.0, NAN, 3.0, 4.0, 5.0, 6.0});
+  Tensor out = tf.zeros({1, 1, 2});
+
+  max_pool2d_out(self, {2, 2}, {}, {0, 0}, {1, 1}, false, out);
+
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 2}, {NAN, 6.0}));
+}
+
+TEST_F(OpMaxPool2DOutTest, MismatchedDtypeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+
+  const Tensor self = tf.ones({1, 1, 4, 4});
+  Tensor out = tf_double.zeros({1, 1, 2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      max_pool2d_out(self, {2, 2}, {2, 2}, {0, 0}, {1, 1}, false, out));
+}
@@ -12,7 +12,9 @@ def define_common_targets():
 
     op_test(name = "op_allclose_test")
     op_test(name = "op_div_test")
+    op_test(name = "op_elementwise_chain_test")
     op_test(name = "op_gelu_test")
+    op_test(name = "op_max_pool2d_test")
     op_test(name = "op_mul_test")
 
     if is_xplat():
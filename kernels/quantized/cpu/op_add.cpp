@@ -6,6 +6,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -77,6 +79,92 @@ void add_tensors(
   }
 }
 
+/**
+ * Fixed-point version of add_tensors for 8-bit types: the input to output
+ * scale ratios become integer multipliers with a shared shift, so each element
+ * takes two multiply-adds and a rounding shift. Falls back to add_tensors when
+ * a ratio is too large for the multipliers.
+ */
+template <class CTYPE>
+void add_tensors_fixed_point(
+    const Tensor& a,
+    float a_scale,
+    int32_t a_zero_point,
+    const Tensor& b,
+    float b_scale,
+    int32_t b_zero_point,
+    Tensor& out,
+    float out_scale,
+    int32_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max) {
+  const double a_ratio = static_cast<double>(a_scale) / out_scale;
+  const double b_ratio = static_cast<double>(b_scale) / out_scale;
+  int exponent = 0;
+  std::frexp(std::max(a_ratio, b_ratio), &exponent);
+  // Keep the multipliers below 2^20 so that the sum of both products stays
+  // well inside int32 for 8-bit inputs.
+  const int32_t shift = std::min(31, 20 - exponent);
+  if (shift < 1) {
+    add_tensors<CTYPE>(
+        a,
+        a_scale,
+        a_zero_point,
+        b,
+        b_scale,
+        b_zero_point,
+        out,
+        out_scale,
+        out_zero_point,
+        out_quant_min,
+        out_quant_max);
+    return;
+  }
+  const int32_t a_multiplier =
+      static_cast<int32_t>(std::llround(a_ratio * (int64_t(1) << shift)));
+  const int32_t b_multiplier =
+      static_cast<int32_t>(std::llround(b_ratio * (int64_t(1) << shift)));
+
+  const auto data_a = a.const_data_ptr<CTYPE>();
+  const auto data_b = b.const_data_ptr<CTYPE>();
+  auto data_out = out.mutable_data_ptr<CTYPE>();
+
+  elementwise_parallel_for(a.numel(), [&](int64_t begin, int64_t end) {
+    vec_quantized_add<CTYPE>(
+        data_out + begin,
+        data_a + begin,
+        data_b + begin,
+        a_zero_point,
+        a_multiplier,
+        b_zero_point,
+        b_multiplier,
+        shift,
+        out_zero_point,
+        static_cast<int32_t>(out_quant_min),
+        static_cast<int32_t>(out_quant_max),
+        end - begin);
+  });
+}
+
+void check_quant_range(
+    ScalarType dtype,
+    int64_t quant_min,
+    int64_t quant_max,
+    const char* tensor_name) {
+  const int64_t lower = dtype == ScalarType::Char ? -128 : 0;
+  const int64_t upper = dtype == ScalarType::Char ? 127 : 255;
+  ET_CHECK_MSG(
+      quant_min >= lower && quant_max <= upper && quant_min <= quant_max,
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for %s. Min should be <= max and both should be in bounds [%" PRId64
+      ",%" PRId64 "]",
+      quant_min,
+      quant_max,
+      tensor_name,
+      lower,
+      upper);
+}
+
 } // namespace
 
 /**
@@ -84,7 +172,9 @@ void add_tensors(
  * numerically equivalent to Dq -> fp add -> Q
  *
  * PREREQ: a and b should be the same shape, quant_min and max should be in
- * range [0,255]. a and b and out should be the same dtype.
+ * range [0,255], or [-128,127] for int8. a and b and out should be the same
+ * dtype. 8-bit inputs are added in fixed point, which can differ from the
+ * float pattern by one step when the result lands close to a rounding tie.
  */
 Tensor& quantized_add_out(
     const Tensor& a,
@@ -103,25 +193,12 @@ Tensor& quantized_add_out(
     int64_t out_quant_max,
     Tensor& out) {
   ET_CHECK_SAME_SHAPE_AND_DTYPE3(a, b, out);
-  ET_CHECK_MSG(
-      a_quant_min >= 0 && a_quant_max <= 255 && a_quant_min <= a_quant_max,
-      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
-      " for input tensor a. Min should be <= max and both should be in bounds [0,255]",
-      a_quant_min,
-      a_quant_max);
-  ET_CHECK_MSG(
-      b_quant_min >= 0 && b_quant_max <= 255 && b_quant_min <= b_quant_max,
-      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
-      " for input tensor b. Min should be <= max and both should be in bounds [0,255]",
-      b_quant_min,
-      b_quant_max);
-  ET_CHECK_MSG(
-      out_quant_min >= 0 && out_quant_max <= 255 &&
-          out_quant_min <= out_quant_max,
-      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
-      " for output tensor. Min should be <= max and both should be in bounds [0,255]",
-      out_quant_min,
-      out_quant_max);
+  check_quant_range(
+      a.scalar_type(), a_quant_min, a_quant_max, "input tensor a");
+  check_quant_range(
+      b.scalar_type(), b_quant_min, b_quant_max, "input tensor b");
+  check_quant_range(
+      out.scalar_type(), out_quant_min, out_quant_max, "output tensor");
 
   // downsize to maintain numerical consistency with fbgemm
   float a_scale = static_cast<float>(a_scale_d);
@@ -149,7 +226,37 @@ Tensor& quantized_add_out(
     break;
 
   switch (a.scalar_type()) {
-    ET_FORALL_INT_TYPES(ADD_TENSORS)
+    case ScalarType::Byte:
+      add_tensors_fixed_point<uint8_t>(
+          a,
+          a_scale,
+          a_zero_point,
+          b,
+          b_scale,
+          b_zero_point,
+          out,
+          out_scale,
+          out_zero_point,
+          out_quant_min,
+          out_quant_max);
+      break;
+    case ScalarType::Char:
+      add_tensors_fixed_point<int8_t>(
+          a,
+          a_scale,
+          a_zero_point,
+          b,
+          b_scale,
+          b_zero_point,
+          out,
+          out_scale,
+          out_zero_point,
+          out_quant_min,
+          out_quant_max);
+      break;
+    ADD_TENSORS(int16_t, Short)
+    ADD_TENSORS(int32_t, Int)
+    ADD_TENSORS(int64_t, Long)
     default:
       ET_CHECK_MSG(
           false,
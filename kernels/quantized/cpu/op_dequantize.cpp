@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -61,6 +63,38 @@ void check_dequantize_per_tensor_args(
       quant_max);
 }
 
+/**
+ * Dequantizes `size` contiguous elements that share one scale and zero point.
+ */
+template <typename IN_CTYPE, typename OUT_CTYPE>
+void dequantize_contiguous(
+    const IN_CTYPE* in,
+    OUT_CTYPE* out,
+    size_t size,
+    float scale,
+    int64_t zero_point) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = static_cast<OUT_CTYPE>((in[i] - zero_point) * scale);
+  }
+}
+
+// 8 and 16 bit to float dequantization uses the vectorized kernel, which
+// produces the same values as the loop above.
+#define DEQUANTIZE_CONTIGUOUS_VEC(IN_CTYPE)                      \
+  void dequantize_contiguous(                                    \
+      const IN_CTYPE* in,                                        \
+      float* out,                                                \
+      size_t size,                                               \
+      float scale,                                               \
+      int64_t zero_point) {                                      \
+    vec_dequantize_f32(                                          \
+        out, in, scale, static_cast<int32_t>(zero_point), size); \
+  }
+DEQUANTIZE_CONTIGUOUS_VEC(int8_t)
+DEQUANTIZE_CONTIGUOUS_VEC(uint8_t)
+DEQUANTIZE_CONTIGUOUS_VEC(int16_t)
+#undef DEQUANTIZE_CONTIGUOUS_VEC
+
 } // namespace
 
 /**
@@ -97,12 +131,14 @@ Tensor& dequantize_per_tensor_out(
      * get inlined without LTO, particularly in ATen mode. */                  \
     auto* out_data_ptr = out.mutable_data_ptr<OUT_CTYPE>();                    \
     const auto* input_data_ptr = input.const_data_ptr<IN_CTYPE>();             \
-    const auto input_numel = input.numel();                                    \
-    for (size_t i = 0; i < input_numel; i++) {                                 \
-      out_data_ptr[i] = static_cast<OUT_CTYPE>(                                \
-          (input_data_ptr[i] - static_cast<int32_t>(zero_point)) *             \
-          static_cast<float>(scale));                                          \
-    }                                                                          \
+    elementwise_parallel_for(input.numel(), [&](int64_t begin, int64_t end) {  \
+      dequantize_contiguous(                                                   \
+          input_data_ptr + begin,                                              \
+          out_data_ptr + begin,                                                \
+          end - begin,                                                         \
+          static_cast<float>(scale),                                           \
+          zero_point);                                                         \
+    });                                                                        \
   } break;
 #define CALCULATE_INT_TYPE(IN_CTYPE, in_dtype)               \
   case ScalarType::in_dtype:                                 \
@@ -223,15 +259,6 @@ Tensor& dequantize_per_channel_out(
   check_dequantize_per_tensor_args(
       input, quant_min, quant_max, dtype, out_dtype, out);
 
-  // a list contains all dimensions except axis
-  int64_t dims[kTensorDimensionLimit];
-  for (int64_t i = 0; i < input.dim() - 1; i++) {
-    if (i < axis) {
-      dims[i] = i;
-    } else {
-      dims[i] = i + 1;
-    }
-  }
   const float* scale_data = scale.const_data_ptr<float>();
   const int64_t* zero_point_data;
   if (opt_zero_points.has_value()) {
@@ -240,8 +267,20 @@ Tensor& dequantize_per_channel_out(
     zero_point_data = nullptr;
   }
 
-  exec_aten::optional<exec_aten::ArrayRef<int64_t>> optional_dim_list{
-      exec_aten::ArrayRef<int64_t>{dims, size_t(input.dim() - 1)}};
+  // View the input as [outer, channels, inner]: every run of `inner`
+  // contiguous elements shares the scale and zero point of its channel, so
+  // the runs are dequantized independently and split across threads.
+  const size_t channels = input.size(axis);
+  size_t outer = 1;
+  for (int64_t i = 0; i < axis; i++) {
+    outer *= input.size(i);
+  }
+  size_t inner = 1;
+  for (int64_t i = axis + 1; i < input.dim(); i++) {
+    inner *= input.size(i);
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, kElementwiseGrainSize / std::max<int64_t>(1, inner));
 
   // Actual dequantization logic
   // input, out are the input and output tensors
@@ -249,8 +288,6 @@ Tensor& dequantize_per_channel_out(
   // input.size(axis).
   //   i.e. if the tensor has shape (N,C,H,W), axis being 1, then channel_ix
   //   will be 0, 1, 2, ... C-1
-  // in_ix is the flat index of the element you are dequantizing.
-  //   in other words you are dequantizing in_data[in_ix]
 #define DEQUANTIZE_IMPL(CTYPE_IN, CTYPE_OUT, out_dtype)                        \
   case ScalarType::out_dtype:                                                  \
     if (input.dim() == 1) {                                                    \
@@ -279,22 +316,24 @@ Tensor& dequantize_per_channel_out(
           dim);                                                                \
       break;                                                                   \
     }                                                                          \
-    for (size_t channel_ix = 0; channel_ix < input.size(axis); ++channel_ix) { \
-      float _scale = scale_data[channel_ix];                                   \
-      int64_t _zero_point = 0;                                                 \
-      if (zero_point_data != nullptr) {                                        \
-        _zero_point = zero_point_data[channel_ix];                             \
-      }                                                                        \
+    {                                                                          \
       auto* out_data_ptr = out.mutable_data_ptr<CTYPE_OUT>();                  \
       const auto* input_data_ptr = input.const_data_ptr<CTYPE_IN>();           \
-      apply_over_dim_list(                                                     \
-          [input_data_ptr, out_data_ptr, _scale, _zero_point](size_t in_ix) {  \
-            out_data_ptr[in_ix] = static_cast<CTYPE_OUT>(                      \
-                (input_data_ptr[in_ix] - _zero_point) * _scale);               \
+      elementwise_parallel_for(                                                \
+          outer * channels,                                                    \
+          [&](int64_t begin, int64_t end) {                                    \
+            for (int64_t row = begin; row < end; ++row) {                      \
+              const size_t channel_ix = row % channels;                        \
+              dequantize_contiguous(                                           \
+                  input_data_ptr + row * inner,                                \
+                  out_data_ptr + row * inner,                                  \
+                  inner,                                                       \
+                  scale_data[channel_ix],                                      \
+                  zero_point_data != nullptr ? zero_point_data[channel_ix]     \
+                                             : 0);                             \
+            }                                                                  \
           },                                                                   \
-          input,                                                               \
-          optional_dim_list,                                                   \
-          channel_ix);                                                         \
+          grain_size);                                                         \
     }                                                                          \
     break;
 #define CALCULATE_FLOAT_TYPE(CTYPE_IN, in_dtype)             \
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+constexpr int32_t kActivationQuantMin = -128;
+constexpr int32_t kActivationQuantMax = 127;
+
+bool check_quantized_dynamic_linear_args(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    const optional<Tensor>& opt_bias,
+    int64_t group_size,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(in.dim() >= 1);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight_scales, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(out, in.dim()));
+
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_size_at_dims(in, in.dim() - 1, weight, 1));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_size_at_dims(weight_scales, 0, weight, 0));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      group_size > 0 && weight.size(1) % group_size == 0,
+      "group_size %" PRId64 " must evenly divide the input features",
+      group_size);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight_scales.size(1) == weight.size(1) / group_size,
+      "weight_scales must hold one scale per group");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      in.scalar_type() == ScalarType::Float, "input dtype must be Float");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight.scalar_type() == ScalarType::Char, "weight dtype must be int8");
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, weight_scales, out));
+
+  if (opt_weight_zero_points.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensors_have_same_shape(opt_weight_zero_points.value(), weight_scales));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensors_have_same_dtype(opt_weight_zero_points.value(), in));
+  }
+  if (opt_bias.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(opt_bias.value(), 1));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensors_have_same_size_at_dims(opt_bias.value(), 0, weight, 0));
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(opt_bias.value(), in));
+  }
+  return true;
+}
+
+/// Quantizes one token to int8 with the asymmetric scale and zero point that
+/// quantized_decomposed::choose_qparams_per_token_asymmetric would pick, and
+/// stores the sum of every group of quantized values in `group_sums`.
+void quantize_token(
+    const float* x,
+    int64_t n,
+    int64_t group_size,
+    int8_t* q,
+    float* scale_out,
+    int32_t* zero_point_out,
+    int32_t* group_sums) {
+  float min_val = 0.0f;
+  float max_val = 0.0f;
+  for (int64_t k = 0; k < n; ++k) {
+    min_val = std::min(min_val, x[k]);
+    max_val = std::max(max_val, x[k]);
+  }
+  const float scale = std::max(
+      (max_val - min_val) /
+          static_cast<float>(kActivationQuantMax - kActivationQuantMin),
+      FLT_EPSILON);
+  const float descaled_min = min_val / scale;
+  const float descaled_max = max_val / scale;
+  const float zero_point_from_min_error = kActivationQuantMin + descaled_min;
+  const float zero_point_from_max_error = kActivationQuantMax + descaled_max;
+  float zero_point = zero_point_from_min_error + zero_point_from_max_error > 0
+      ? kActivationQuantMin - descaled_min
+      : kActivationQuantMax - descaled_max;
+  zero_point = std::nearbyint(std::min<float>(
+      std::max<float>(zero_point, kActivationQuantMin), kActivationQuantMax));
+
+  vec_quantize_f32<int8_t>(
+      q,
+      x,
+      1.0f / scale,
+      static_cast<int32_t>(zero_point),
+      kActivationQuantMin,
+      kActivationQuantMax,
+      n);
+
+  for (int64_t g = 0; g < n / group_size; ++g) {
+    int32_t sum = 0;
+    for (int64_t k = g * group_size; k < (g + 1) * group_size; ++k) {
+      sum += q[k];
+    }
+    group_sums[g] = sum;
+  }
+  *scale_out = scale;
+  *zero_point_out = static_cast<int32_t>(zero_point);
+}
+
+} // namespace
+
+/// Computes linear(dequantize(quantize(in)), dequantize(weight), bias) where
+/// the input is quantized per token to int8 on the fly and the weight is
+/// quantized per output channel in groups of `group_size` input features.
+/// The dot products run on the int8 values directly; the zero points are
+/// folded in afterwards from the group sums, so each activation is quantized
+/// once and each weight byte is read once per token.
+Tensor& quantized_dynamic_linear_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    const optional<Tensor>& opt_bias,
+    int64_t group_size,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_quantized_dynamic_linear_args(
+          in,
+          weight,
+          weight_scales,
+          opt_weight_zero_points,
+          opt_bias,
+          group_size,
+          out),
+      InvalidArgument,
+      out);
+
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  for (size_t d = 0; d < in.dim() - 1; ++d) {
+    output_sizes[d] = in.size(d);
+  }
+  output_sizes[in.dim() - 1] = weight.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, static_cast<size_t>(in.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t n = weight.size(1);
+  const int64_t p = weight.size(0);
+  const int64_t m = n == 0 ? 0 : in.numel() / n;
+  const int64_t num_groups = n / group_size;
+
+  Result<void*> q_in = ctx.allocate_temp(m * n * sizeof(int8_t));
+  Result<void*> in_scales = ctx.allocate_temp(m * sizeof(float));
+  Result<void*> in_zero_points = ctx.allocate_temp(m * sizeof(int32_t));
+  Result<void*> in_group_sums =
+      ctx.allocate_temp(m * num_groups * sizeof(int32_t));
+  ET_KERNEL_CHECK(
+      ctx,
+      q_in.ok() && in_scales.ok() && in_zero_points.ok() &&
+          in_group_sums.ok(),
+      MemoryAllocationFailed,
+      out);
+
+  const float* in_data = in.const_data_ptr<float>();
+  int8_t* q_in_data = static_cast<int8_t*>(q_in.get());
+  float* in_scales_data = static_cast<float*>(in_scales.get());
+  int32_t* in_zero_points_data = static_cast<int32_t*>(in_zero_points.get());
+  int32_t* in_group_sums_data = static_cast<int32_t*>(in_group_sums.get());
+
+  elementwise_parallel_for(
+      m,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          quantize_token(
+              in_data + i * n,
+              n,
+              group_size,
+              q_in_data + i * n,
+              in_scales_data + i,
+              in_zero_points_data + i,
+              in_group_sums_data + i * num_groups);
+        }
+      },
+      std::max<int64_t>(1, kElementwiseGrainSize / std::max<int64_t>(1, n)));
+
+  const int8_t* weight_data = weight.const_data_ptr<int8_t>();
+  const float* scales_data = weight_scales.const_data_ptr<float>();
+  const float* zero_points_data = opt_weight_zero_points.has_value()
+      ? opt_weight_zero_points.value().const_data_ptr<float>()
+      : nullptr;
+  const float* bias_data =
+      opt_bias.has_value() ? opt_bias.value().const_data_ptr<float>() : nullptr;
+  float* out_data = out.mutable_data_ptr<float>();
+
+  // Split the output features so that each chunk does at least a grain's
+  // worth of multiply-adds.
+  elementwise_parallel_for(
+      p,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t j = begin; j < end; ++j) {
+          const int8_t* w_row = weight_data + j * n;
+          for (int64_t i = 0; i < m; ++i) {
+            const int8_t* q_row = q_in_data + i * n;
+            const int64_t zi = in_zero_points_data[i];
+            float acc = 0.0f;
+            for (int64_t g = 0; g < num_groups; ++g) {
+              const int64_t offset = g * group_size;
+              int32_t w_sum = 0;
+              const int64_t dot = vec_dot_i8_i32(
+                  q_row + offset, w_row + offset, group_size, &w_sum);
+              const int64_t zw = zero_points_data == nullptr
+                  ? 0
+                  : static_cast<int64_t>(
+                        std::nearbyint(zero_points_data[j * num_groups + g]));
+              // sum((qi - zi) * (qw - zw)) expanded over the group.
+              const int64_t corrected = dot - zi * w_sum -
+                  zw * in_group_sums_data[i * num_groups + g] +
+                  group_size * zi * zw;
+              acc += scales_data[j * num_groups + g] *
+                  static_cast<float>(corrected);
+            }
+            out_data[i * p + j] = in_scales_data[i] * acc +
+                (bias_data == nullptr ? 0.0f : bias_data[j]);
+          }
+        }
+      },
+      std::max<int64_t>(
+          1, kElementwiseGrainSize / std::max<int64_t>(1, m * n)));
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
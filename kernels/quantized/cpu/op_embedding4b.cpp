@@ -6,6 +6,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -131,6 +133,34 @@ static inline int32_t weight_value(const unsigned char* w_data, int32_t index) {
   }
 }
 
+/**
+ * Dequantizes the packed 4-bit values [begin, end) of one embedding row, which
+ * share a scale and zero point, into out.
+ */
+template <typename CTYPE_OUT>
+void dequantize_4bit_range(
+    CTYPE_OUT* out,
+    const uint8_t* w_data,
+    int64_t begin,
+    int64_t end,
+    float scale,
+    float zp) {
+  for (int64_t j = begin; j < end; ++j) {
+    *out++ = static_cast<CTYPE_OUT>(
+        (static_cast<float>(weight_value(w_data, j)) - zp) * scale);
+  }
+}
+
+void dequantize_4bit_range(
+    float* out,
+    const uint8_t* w_data,
+    int64_t begin,
+    int64_t end,
+    float scale,
+    float zp) {
+  vec_dequantize_i4_f32(out, w_data, begin, end, scale, zp);
+}
+
 /**
  * Retrieves the embeddings specified by indices, dequantizes them, and stores
  * them in out. Weight will always be uint8
@@ -142,16 +172,18 @@ void embedding_4bit_per_channel(
     const optional<Tensor>& opt_weight_zero_points,
     const Tensor& indices,
     Tensor& out) {
-  auto embedding_dim = weight.size(1) * 2;
+  const int64_t embedding_dim = weight.size(1) * 2;
 
-  int32_t num_groups_per_channel = 1;
+  int64_t num_groups_per_channel = 1;
   if (weight_scales.dim() == 2) {
     num_groups_per_channel = weight_scales.size(1);
   }
-  int32_t group_size = embedding_dim / num_groups_per_channel;
+  const int64_t group_size = embedding_dim / num_groups_per_channel;
 
   CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
   const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const uint8_t* weight_data = weight.const_data_ptr<uint8_t>();
+  const int64_t weight_row_bytes = weight.size(1);
 
   const CTYPE_PARAMS* scales = weight_scales.const_data_ptr<CTYPE_PARAMS>();
   const CTYPE_PARAMS* zero_points = nullptr;
@@ -159,33 +191,39 @@ void embedding_4bit_per_channel(
     zero_points = opt_weight_zero_points.value().const_data_ptr<CTYPE_PARAMS>();
   }
 
-  for (int i = 0; i < indices.numel(); i++) {
-    int64_t index = indices_ptr[i];
-    // If using groupwise embedding
-    int32_t qparams_index = index * num_groups_per_channel;
-    CTYPE_PARAMS zp = 0.0;
-    const CTYPE_PARAMS* scale_ptr = scales + qparams_index;
-    const CTYPE_PARAMS* zero_points_ptr = nullptr;
-    if (opt_weight_zero_points.has_value()) {
-      zero_points_ptr = zero_points + qparams_index;
-    }
-
-    const uint8_t* w_data =
-        weight.const_data_ptr<uint8_t>() + weight.size(1) * index;
-
-    for (int j = 0; j < embedding_dim; ++j) {
-      int32_t group_id = j / group_size;
-      const CTYPE_PARAMS scale = scale_ptr[group_id];
-      if (opt_weight_zero_points.has_value()) {
-        zp = zero_points_ptr[group_id];
-      }
-      out_data[j] = static_cast<CTYPE_OUT>(
-          (static_cast<float>(weight_value(w_data, j)) -
-           static_cast<float>(zp)) *
-          static_cast<float>(scale));
-    }
-    out_data += embedding_dim;
-  }
+  // Tokens are independent, so long prefills gather their rows on several
+  // threads, each row unpacked one quantization group at a time.
+  const int64_t grain_size =
+      std::max<int64_t>(1, kElementwiseGrainSize / embedding_dim);
+  elementwise_parallel_for(
+      indices.numel(),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const int64_t index = indices_ptr[i];
+          // If using groupwise embedding
+          const int64_t qparams_index = index * num_groups_per_channel;
+          const uint8_t* w_data = weight_data + weight_row_bytes * index;
+          CTYPE_OUT* out_row = out_data + i * embedding_dim;
+
+          for (int64_t group_id = 0; group_id < num_groups_per_channel;
+               ++group_id) {
+            const float scale =
+                static_cast<float>(scales[qparams_index + group_id]);
+            const float zp = zero_points != nullptr
+                ? static_cast<float>(zero_points[qparams_index + group_id])
+                : 0.0f;
+            const int64_t group_begin = group_id * group_size;
+            dequantize_4bit_range(
+                out_row + group_begin,
+                w_data,
+                group_begin,
+                group_begin + group_size,
+                scale,
+                zp);
+          }
+        }
+      },
+      grain_size);
 }
 
 void resize_out_tensor(
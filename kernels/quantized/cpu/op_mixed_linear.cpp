@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 #include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -94,18 +95,34 @@ Tensor& quantized_mixed_linear_out(
         g = (n + weight_scales.size(1) - 1) / weight_scales.size(1);
       };
 
-      // FIXME: this currently ignores dtype
-      vec_quantized_matmul_transb_int8<
-          CTYPE_OUT, // T *z
-          CTYPE>( // U *x, U *s
-          out.mutable_data_ptr<CTYPE_OUT>(),
-          in.const_data_ptr<CTYPE>(),
-          weight.const_data_ptr<int8_t>(),
-          weight_scales.const_data_ptr<CTYPE>(),
-          m,
-          n,
+      CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+      const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+      const int8_t* weight_data = weight.const_data_ptr<int8_t>();
+      const CTYPE* scales_data = weight_scales.const_data_ptr<CTYPE>();
+
+      // Split the output features so that each chunk does at least a grain's
+      // worth of multiply-adds.
+      const int64_t grain_size = std::max<int64_t>(
+          1, kElementwiseGrainSize / std::max<int64_t>(1, m * n));
+      elementwise_parallel_for(
           p,
-          g);
+          [&](int64_t begin, int64_t end) {
+            // FIXME: this currently ignores dtype
+            vec_quantized_matmul_transb_int8_cols<
+                CTYPE_OUT, // T *z
+                CTYPE>( // U *x, U *s
+                out_data,
+                in_data,
+                weight_data,
+                scales_data,
+                m,
+                n,
+                p,
+                g,
+                begin,
+                end);
+          },
+          grain_size);
     });
   });
 
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
 #include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -74,14 +75,30 @@ Tensor& quantized_mixed_mm_out(
     size_t n = in.size(1);
     size_t p = weight.size(1);
 
-    vec_quantized_matmul_int8<CTYPE>(
-        out.mutable_data_ptr<CTYPE>(),
-        in.const_data_ptr<CTYPE>(),
-        weight.const_data_ptr<int8_t>(),
-        weight_scales.const_data_ptr<CTYPE>(),
-        m,
-        n,
-        p);
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+    const int8_t* weight_data = weight.const_data_ptr<int8_t>();
+    const CTYPE* scales_data = weight_scales.const_data_ptr<CTYPE>();
+
+    // Split the output columns so that each chunk does at least a grain's
+    // worth of multiply-adds.
+    const int64_t grain_size = std::max<int64_t>(
+        1, kElementwiseGrainSize / std::max<int64_t>(1, m * n));
+    elementwise_parallel_for(
+        p,
+        [&](int64_t begin, int64_t end) {
+          vec_quantized_matmul_int8_cols<CTYPE>(
+              out_data,
+              in_data,
+              weight_data,
+              scales_data,
+              m,
+              n,
+              p,
+              begin,
+              end);
+        },
+        grain_size);
   });
 
   return out;
@@ -6,7 +6,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -102,6 +103,53 @@ T quantize_val(
   return static_cast<T>(qvalue);
 }
 
+namespace {
+
+/**
+ * Quantizes `size` contiguous elements that share one scale and zero point.
+ */
+template <typename IN_CTYPE, typename OUT_CTYPE>
+void quantize_contiguous(
+    const IN_CTYPE* in,
+    OUT_CTYPE* out,
+    size_t size,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = quantize_val<OUT_CTYPE, IN_CTYPE>(
+        scale, zero_point, in[i], quant_min, quant_max);
+  }
+}
+
+// Float to 8 and 16 bit quantization uses the vectorized kernel, which
+// produces the same values as quantize_val().
+#define QUANTIZE_CONTIGUOUS_VEC(OUT_CTYPE) \
+  void quantize_contiguous(                \
+      const float* in,                     \
+      OUT_CTYPE* out,                      \
+      size_t size,                         \
+      double scale,                        \
+      int64_t zero_point,                  \
+      int64_t quant_min,                   \
+      int64_t quant_max) {                 \
+    vec_quantize_f32(                      \
+        out,                               \
+        in,                                \
+        1.0f / static_cast<float>(scale),  \
+        static_cast<int32_t>(zero_point),  \
+        static_cast<int32_t>(quant_min),   \
+        static_cast<int32_t>(quant_max),   \
+        size);                             \
+  }
+QUANTIZE_CONTIGUOUS_VEC(int8_t)
+QUANTIZE_CONTIGUOUS_VEC(uint8_t)
+QUANTIZE_CONTIGUOUS_VEC(int16_t)
+#undef QUANTIZE_CONTIGUOUS_VEC
+
+} // namespace
+
 Tensor& quantize_per_tensor_out(
     const Tensor& input,
     double scale,
@@ -124,12 +172,16 @@ Tensor& quantize_per_tensor_out(
      * get inlined without LTO, particularly in ATen mode. */                  \
     auto* out_data_ptr = out.mutable_data_ptr<OUT_CTYPE>();                    \
     const auto* input_data_ptr = input.const_data_ptr<IN_CTYPE>();             \
-    const auto input_numel = input.numel();                                    \
-    for (size_t i = 0; i < input_numel; i++) {                                 \
-      IN_CTYPE value = input_data_ptr[i];                                      \
-      out_data_ptr[i] = quantize_val<OUT_CTYPE, IN_CTYPE>(                     \
-          scale, zero_point, value, quant_min, quant_max);                     \
-    }                                                                          \
+    elementwise_parallel_for(input.numel(), [&](int64_t begin, int64_t end) {  \
+      quantize_contiguous(                                                     \
+          input_data_ptr + begin,                                              \
+          out_data_ptr + begin,                                                \
+          end - begin,                                                         \
+          scale,                                                               \
+          zero_point,                                                          \
+          quant_min,                                                           \
+          quant_max);                                                          \
+    });                                                                        \
   } break;
 #define CALCULATE_FLOAT_TYPE(IN_CTYPE, in_dtype)         \
   case ScalarType::in_dtype:                             \
@@ -282,55 +334,45 @@ Tensor& quantize_per_channel_out(
 
   check_quantize_per_tensor_args(input, quant_min, quant_max, dtype, out);
 
-  // a list contains all dimensions except axis
-  int64_t dims[input.dim() - 1];
-  for (int64_t i = 0; i < input.dim() - 1; i++) {
-    if (i < axis) {
-      dims[i] = i;
-    } else {
-      dims[i] = i - 1;
-    }
-  }
   const double* scale_data = scale.const_data_ptr<double>();
   const int64_t* zero_point_data = zero_point.const_data_ptr<int64_t>();
 
-  exec_aten::optional<exec_aten::ArrayRef<int64_t>> optional_dim_list{
-      exec_aten::ArrayRef<int64_t>{dims, size_t(input.dim() - 1)}};
-
-  // Actual quantization logic
-  // input, out are the input and output tensors
-  // channel_ix is the index along the axis dimension. 0 <= channel_ix <
-  // input.size(axis).
-  //   i.e. if the tensor has shape (N,C,H,W), axis being 1, then channel_ix
-  //   will be 0, 1, 2, ... C-1
-  // in_ix is the flat index of the element you are quantizing.
-  //   in other words you are quantizing in_data[in_ix]
-#define QUANTIZE_IMPL(CTYPE_IN, CTYPE_OUT, out_dtype)                          \
-  case ScalarType::out_dtype:                                                  \
-    for (size_t channel_ix = 0; channel_ix < input.size(axis); ++channel_ix) { \
-      double _scale = scale_data[channel_ix];                                  \
-      int64_t _zero_point = zero_point_data[channel_ix];                       \
-      auto* out_data_ptr = out.mutable_data_ptr<CTYPE_OUT>();                  \
-      const auto* input_data_ptr = input.const_data_ptr<CTYPE_IN>();           \
-      apply_over_dim_list(                                                     \
-          [input_data_ptr,                                                     \
-           out_data_ptr,                                                       \
-           _scale,                                                             \
-           _zero_point,                                                        \
-           quant_min,                                                          \
-           quant_max](size_t in_ix) {                                          \
-            out_data_ptr[in_ix] = quantize_val<CTYPE_OUT, CTYPE_IN>(           \
-                _scale,                                                        \
-                _zero_point,                                                   \
-                input_data_ptr[in_ix],                                         \
-                quant_min,                                                     \
-                quant_max);                                                    \
-          },                                                                   \
-          input,                                                               \
-          optional_dim_list,                                                   \
-          channel_ix);                                                         \
-    }                                                                          \
-    break;
+  // View the input as [outer, channels, inner]: every run of `inner`
+  // contiguous elements shares the scale and zero point of its channel, so
+  // the runs are quantized independently and split across threads.
+  const size_t channels = input.size(axis);
+  size_t outer = 1;
+  for (int64_t i = 0; i < axis; i++) {
+    outer *= input.size(i);
+  }
+  size_t inner = 1;
+  for (int64_t i = axis + 1; i < input.dim(); i++) {
+    inner *= input.size(i);
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, kElementwiseGrainSize / std::max<int64_t>(1, inner));
+
+#define QUANTIZE_IMPL(CTYPE_IN, CTYPE_OUT, out_dtype)                        \
+  case ScalarType::out_dtype: {                                              \
+    auto* out_data_ptr = out.mutable_data_ptr<CTYPE_OUT>();                  \
+    const auto* input_data_ptr = input.const_data_ptr<CTYPE_IN>();           \
+    elementwise_parallel_for(                                                \
+        outer * channels,                                                    \
+        [&](int64_t begin, int64_t end) {                                    \
+          for (int64_t row = begin; row < end; ++row) {                      \
+            const size_t channel_ix = row % channels;                        \
+            quantize_contiguous(                                             \
+                input_data_ptr + row * inner,                                \
+                out_data_ptr + row * inner,                                  \
+                inner,                                                       \
+                scale_data[channel_ix],                                      \
+                zero_point_data[channel_ix],                                 \
+                quant_min,                                                   \
+                quant_max);                                                  \
+          }                                                                  \
+        },                                                                   \
+        grain_size);                                                         \
+  } break;
 #define CALCULATE_FLOAT_TYPE(CTYPE_IN, in_dtype)         \
   case ScalarType::in_dtype:                             \
     switch (out.scalar_type()) {                         \
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/parallel_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+bool check_quant_range(ScalarType dtype, int64_t quant_min, int64_t quant_max) {
+  const int64_t lower = dtype == ScalarType::Char ? -128 : 0;
+  const int64_t upper = dtype == ScalarType::Char ? 127 : 255;
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      quant_min >= lower && quant_max <= upper && quant_min <= quant_max,
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      ". Min should be <= max and both should be in bounds [%" PRId64
+      ",%" PRId64 "]",
+      quant_min,
+      quant_max,
+      lower,
+      upper);
+  return true;
+}
+
+/**
+ * Applies relu to a and requantizes it into out. When a and out share their
+ * qparams this is an exact max against the zero point; otherwise the scale
+ * ratio is applied as a Q31 fixed-point multiplier, which can differ from
+ * Dq -> fp relu -> Q by a step close to rounding ties. Ratios too large for
+ * the fixed-point path go through float instead.
+ */
+template <class CTYPE>
+void relu_tensor(
+    const Tensor& a,
+    float a_scale,
+    int32_t a_zero_point,
+    Tensor& out,
+    float out_scale,
+    int32_t out_zero_point,
+    int32_t out_quant_min,
+    int32_t out_quant_max) {
+  const auto data_a = a.const_data_ptr<CTYPE>();
+  auto data_out = out.mutable_data_ptr<CTYPE>();
+
+  int32_t multiplier = 0;
+  int32_t shift = 0;
+  quantize_multiplier_q31(
+      static_cast<double>(a_scale) / out_scale, &multiplier, &shift);
+
+  // An 8-bit difference can be shifted left by up to 23 bits before the Q31
+  // multiply.
+  if (shift < -23) {
+    const float inv_out_scale = 1.0f / out_scale;
+    for (size_t i = 0; i < a.numel(); ++i) {
+      const float value = std::max(0.0f, (data_a[i] - a_zero_point) * a_scale);
+      const int64_t q = static_cast<int64_t>(
+          out_zero_point + std::nearbyint(inv_out_scale * value));
+      data_out[i] = static_cast<CTYPE>(std::min<int64_t>(
+          std::max<int64_t>(q, out_quant_min), out_quant_max));
+    }
+    return;
+  }
+
+  elementwise_parallel_for(a.numel(), [&](int64_t begin, int64_t end) {
+    vec_quantized_relu<CTYPE>(
+        data_out + begin,
+        data_a + begin,
+        a_zero_point,
+        multiplier,
+        shift,
+        out_zero_point,
+        out_quant_min,
+        out_quant_max,
+        end - begin);
+  });
+}
+
+} // namespace
+
+/**
+ * Perform element wise relu of the quantized input tensor into out. Should be
+ * numerically equivalent to Dq -> fp relu -> Q, see relu_tensor() for the
+ * rounding.
+ *
+ * PREREQ: a and out should have the same dtype, Byte or Char, and quant_min
+ * and quant_max should be within that dtype's range.
+ */
+Tensor& quantized_relu_out(
+    RuntimeContext& ctx,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    int64_t a_quant_min,
+    int64_t a_quant_max,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, a.sizes()) == Error::Ok, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_shape_and_dtype(a, out), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      check_quant_range(a.scalar_type(), a_quant_min, a_quant_max) &&
+          check_quant_range(out.scalar_type(), out_quant_min, out_quant_max),
+      InvalidArgument,
+      out);
+
+  // downsize to maintain numerical consistency with quantized_add_out
+  const float a_scale_f = static_cast<float>(a_scale);
+  const float out_scale_f = static_cast<float>(out_scale);
+
+  switch (a.scalar_type()) {
+    case ScalarType::Byte:
+      relu_tensor<uint8_t>(
+          a,
+          a_scale_f,
+          static_cast<int32_t>(a_zero_point),
+          out,
+          out_scale_f,
+          static_cast<int32_t>(out_zero_point),
+          static_cast<int32_t>(out_quant_min),
+          static_cast<int32_t>(out_quant_max));
+      break;
+    case ScalarType::Char:
+      relu_tensor<int8_t>(
+          a,
+          a_scale_f,
+          static_cast<int32_t>(a_zero_point),
+          out,
+          out_scale_f,
+          static_cast<int32_t>(out_zero_point),
+          static_cast<int32_t>(out_quant_min),
+          static_cast<int32_t>(out_quant_max));
+      break;
+    default:
+      ET_KERNEL_CHECK_MSG(
+          ctx,
+          false,
+          InvalidArgument,
+          out,
+          "Unhandled dtype %" PRId8,
+          static_cast<int8_t>(a.scalar_type()));
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
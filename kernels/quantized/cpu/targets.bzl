@@ -4,6 +4,10 @@ load("@fbsource//xplat/executorch/kernels/portable:op_registration_util.bzl", "d
 _QUANT_OPS = (
     op_target(
         name = "op_add",
+        deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
     ),
     op_target(
         name = "op_choose_qparams",
@@ -14,37 +18,66 @@ _QUANT_OPS = (
     op_target(
         name = "op_dequantize",
         deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
         _aten_mode_deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
         ],
     ),
+    op_target(
+        name = "op_dynamic_linear",
+        deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
+    ),
     op_target(
         name = "op_embedding",
     ),
     op_target(
         name = "op_embedding4b",
+        deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
     ),
     op_target(
         name = "op_mixed_mm",
         deps = [
             "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
         ],
     ),
     op_target(
         name = "op_mixed_linear",
         deps = [
             "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
+    ),
+    op_target(
+        name = "op_mul",
+        deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
         ],
     ),
     op_target(
         name = "op_quantize",
         deps = [
-            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
         ],
-        _aten_mode_deps = [
-            "//executorch/kernels/portable/cpu/util:reduce_util_aten",
+    ),
+    op_target(
+        name = "op_relu",
+        deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/portable/cpu/util:parallel_util",
         ],
     ),
 )
@@ -16,7 +16,11 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -411,3 +415,54 @@ TEST(OpQuantizeAddTest, TopOfRangeTest) {
 
   EXPECT_TENSOR_EQ(qoutput, expected);
 }
+
+TEST(OpQuantizeAddTest, Int8MatchesFloatPatternWithinOneStep) {
+  // Long enough to cover the vectorized fixed-point loop and its tail.
+  constexpr int32_t kSize = 301;
+  const float a_scale = 0.05f;
+  const int32_t a_zero_point = -3;
+  const float b_scale = 0.02f;
+  const int32_t b_zero_point = 7;
+  const float out_scale = 0.06f;
+  const int32_t out_zero_point = -10;
+
+  std::vector<int8_t> a_data(kSize);
+  std::vector<int8_t> b_data(kSize);
+  std::vector<int8_t> expected_data(kSize);
+  for (int32_t i = 0; i < kSize; ++i) {
+    a_data[i] = static_cast<int8_t>((i * 37) % 256 - 128);
+    b_data[i] = static_cast<int8_t>((i * 91 + 5) % 256 - 128);
+    const float value = (a_data[i] - a_zero_point) * a_scale +
+        (b_data[i] - b_zero_point) * b_scale;
+    const float q = out_zero_point + std::nearbyint(value * (1.0f / out_scale));
+    expected_data[i] =
+        static_cast<int8_t>(std::min(std::max(q, -128.0f), 127.0f));
+  }
+
+  TensorFactory<ScalarType::Char> tfo;
+  Tensor qinput1 = tfo.make({kSize}, a_data);
+  Tensor qinput2 = tfo.make({kSize}, b_data);
+  Tensor qoutput = tfo.zeros({kSize});
+
+  quantized_add_out(
+      qinput1,
+      a_scale,
+      a_zero_point,
+      -128,
+      127,
+      qinput2,
+      b_scale,
+      b_zero_point,
+      -128,
+      127,
+      out_scale,
+      out_zero_point,
+      -128,
+      127,
+      qoutput);
+
+  const int8_t* out_data = qoutput.const_data_ptr<int8_t>();
+  for (int32_t i = 0; i < kSize; ++i) {
+    EXPECT_LE(std::abs(out_data[i] - expected_data[i]), 1) << "at " << i;
+  }
+}
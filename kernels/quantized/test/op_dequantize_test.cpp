@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -185,3 +186,37 @@ TEST(OpDequantizeOutTest, DequantizePerChannel) {
       out);
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpDequantizeOutTest, DequantizePerChannelInnerAxis) {
+  TensorFactory<ScalarType::Char> tf_char;
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Shape (2, 3, 10), dequantized along axis 1. Rows of 10 cover both the
+  // vectorized body and its tail.
+  Tensor input = tf_char.full({2, 3, 10}, 10);
+  Tensor scale = tf_float.make({3}, {0.5, 1, 2});
+  Tensor zero_point = tf_long.make({3}, {-2, 0, 4});
+
+  TensorFactory<ScalarType::Float> tfo;
+  Tensor out = tfo.zeros({2, 3, 10});
+  std::vector<float> expected_data;
+  for (int n = 0; n < 2; ++n) {
+    // (10 + 2) * 0.5, (10 - 0) * 1, (10 - 4) * 2
+    for (float value : {6.0f, 10.0f, 12.0f}) {
+      expected_data.insert(expected_data.end(), 10, value);
+    }
+  }
+  dequantize_per_channel_out(
+      input,
+      scale,
+      zero_point,
+      /*axis=*/1,
+      -128,
+      127,
+      ScalarType::Char,
+      optional<ScalarType>(),
+      out);
+
+  EXPECT_TENSOR_EQ(out, tfo.make({2, 3, 10}, expected_data));
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the aten operator
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::MemoryAllocator;
+using torch::executor::native::quantized_dynamic_linear_out;
+using torch::executor::testing::TensorFactory;
+
+class OpQuantizedDynamicLinearTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+};
+
+namespace {
+
+/// Quantizes and dequantizes a token the way
+/// choose_qparams_per_token_asymmetric + quantize_per_token +
+/// dequantize_per_token do.
+std::vector<float> fake_quantize_token(const float* x, int64_t n) {
+  float min_val = 0.0f;
+  float max_val = 0.0f;
+  for (int64_t k = 0; k < n; ++k) {
+    min_val = std::min(min_val, x[k]);
+    max_val = std::max(max_val, x[k]);
+  }
+  const float scale = std::max((max_val - min_val) / 255.0f, FLT_EPSILON);
+  const float descaled_min = min_val / scale;
+  const float descaled_max = max_val / scale;
+  float zero_point = (-128 + descaled_min) + (127 + descaled_max) > 0
+      ? -128 - descaled_min
+      : 127 - descaled_max;
+  zero_point = std::nearbyint(std::min(std::max(zero_point, -128.0f), 127.0f));
+
+  std::vector<float> result(n);
+  for (int64_t k = 0; k < n; ++k) {
+    const float q = std::min(
+        std::max(std::nearbyint(x[k] * (1.0f / scale) + zero_point), -128.0f),
+        127.0f);
+    result[k] = (q - zero_point) * scale;
+  }
+  return result;
+}
+
+/// Runs the kernel and compares it with a float linear over the fake
+/// quantized input and dequantized weight.
+void test_dynamic_linear(
+    const std::vector<int32_t>& in_sizes,
+    int64_t p,
+    int64_t group_size,
+    bool with_zero_points,
+    bool with_bias) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  const int64_t n = in_sizes.back();
+  const int64_t num_groups = n / group_size;
+  int64_t m = 1;
+  for (size_t d = 0; d + 1 < in_sizes.size(); ++d) {
+    m *= in_sizes[d];
+  }
+
+  std::vector<float> in_data(m * n);
+  for (size_t k = 0; k < in_data.size(); ++k) {
+    in_data[k] = std::sin(0.37f * k) * 3.0f + 0.5f;
+  }
+  std::vector<int8_t> weight_data(p * n);
+  for (size_t k = 0; k < weight_data.size(); ++k) {
+    weight_data[k] = static_cast<int8_t>((k * 7) % 16) - 8;
+  }
+  std::vector<float> scales_data(p * num_groups);
+  std::vector<float> zero_points_data(p * num_groups, 0.0f);
+  for (size_t k = 0; k < scales_data.size(); ++k) {
+    scales_data[k] = 0.01f * (1 + k % 5);
+    if (with_zero_points) {
+      zero_points_data[k] = static_cast<float>(k % 3) - 1.0f;
+    }
+  }
+  std::vector<float> bias_data(p);
+  for (int64_t j = 0; j < p; ++j) {
+    bias_data[j] = with_bias ? 0.25f * j - 0.5f : 0.0f;
+  }
+
+  std::vector<float> expected_data(m * p);
+  for (int64_t i = 0; i < m; ++i) {
+    const std::vector<float> x = fake_quantize_token(in_data.data() + i * n, n);
+    for (int64_t j = 0; j < p; ++j) {
+      float acc = 0.0f;
+      for (int64_t k = 0; k < n; ++k) {
+        const int64_t g = j * num_groups + k / group_size;
+        acc += x[k] * (weight_data[j * n + k] - zero_points_data[g]) *
+            scales_data[g];
+      }
+      expected_data[i * p + j] = acc + bias_data[j];
+    }
+  }
+
+  std::vector<int32_t> out_sizes = in_sizes;
+  out_sizes.back() = p;
+  const std::vector<int32_t> weight_sizes = {
+      static_cast<int32_t>(p), static_cast<int32_t>(n)};
+  const std::vector<int32_t> scales_sizes = {
+      static_cast<int32_t>(p), static_cast<int32_t>(num_groups)};
+
+  Tensor input = tf.make(in_sizes, in_data);
+  Tensor weight = tf_char.make(weight_sizes, weight_data);
+  Tensor weight_scales = tf.make(scales_sizes, scales_data);
+  optional<Tensor> opt_weight_zp;
+  if (with_zero_points) {
+    opt_weight_zp = tf.make(scales_sizes, zero_points_data);
+  }
+  optional<Tensor> opt_bias;
+  if (with_bias) {
+    opt_bias = tf.make({static_cast<int32_t>(p)}, bias_data);
+  }
+  Tensor out = tf.zeros(out_sizes);
+  Tensor expected = tf.make(out_sizes, expected_data);
+
+  std::array<uint8_t, 16384> temp;
+  MemoryAllocator temp_allocator(temp.size(), temp.data());
+  RuntimeContext ctx(nullptr, &temp_allocator);
+
+  quantized_dynamic_linear_out(
+      ctx,
+      input,
+      weight,
+      weight_scales,
+      opt_weight_zp,
+      opt_bias,
+      group_size,
+      out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-4);
+}
+
+} // namespace
+
+TEST_F(OpQuantizedDynamicLinearTest, SymmetricWeights) {
+  test_dynamic_linear(
+      {2, 8},
+      /*p=*/3,
+      /*group_size=*/4,
+      /*with_zero_points=*/false,
+      /*with_bias=*/false);
+}
+
+TEST_F(OpQuantizedDynamicLinearTest, ZeroPointsAndBias) {
+  test_dynamic_linear(
+      {2, 3, 8},
+      /*p=*/5,
+      /*group_size=*/4,
+      /*with_zero_points=*/true,
+      /*with_bias=*/true);
+}
+
+TEST_F(OpQuantizedDynamicLinearTest, WideGroups) {
+  // Long enough groups to cover the vectorized dot product and its tail.
+  test_dynamic_linear(
+      {3, 96},
+      /*p=*/7,
+      /*group_size=*/48,
+      /*with_zero_points=*/true,
+      /*with_bias=*/true);
+}
+
+TEST_F(OpQuantizedDynamicLinearTest, FailsWithoutTempMemory) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf.ones({1, 4});
+  Tensor weight = tf_char.ones({2, 4});
+  Tensor weight_scales = tf.ones({2, 1});
+  Tensor out = tf.zeros({1, 2});
+
+  RuntimeContext ctx{};
+  quantized_dynamic_linear_out(
+      ctx,
+      input,
+      weight,
+      weight_scales,
+      optional<Tensor>(),
+      optional<Tensor>(),
+      /*group_size=*/4,
+      out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::MemoryAllocationFailed);
+}
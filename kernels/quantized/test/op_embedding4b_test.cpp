@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -101,6 +102,47 @@ TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbedding) {
   EXPECT_TENSOR_EQ(out, expected);
 }
 
+TEST(OpQuantizedEmbedding4bTest, TestWideGroupWiseQuantizedEmbedding) {
+  et_pal_init();
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Rows of 70 values in two groups of 35, so the second group starts on a
+  // low nibble and both groups are long enough for the vectorized unpack.
+  constexpr int32_t kRows = 3, kRowBytes = 35, kDim = 2 * kRowBytes;
+  constexpr int32_t kGroups = 2, kGroupSize = kDim / kGroups;
+  std::vector<uint8_t> weight_data(kRows * kRowBytes);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<uint8_t>(i * 73 + 11);
+  }
+  const std::vector<float> scales_data = {0.5, 1.0, 1.5, 2.0, 2.5, 3.0};
+  const std::vector<float> zero_points_data = {1, -5, 0, 2, -3, -1};
+  const std::vector<int64_t> indices_data = {2, 0, 1, 2};
+
+  std::vector<float> expected_data;
+  for (int64_t index : indices_data) {
+    for (int32_t j = 0; j < kDim; ++j) {
+      const uint8_t packed = weight_data[index * kRowBytes + j / 2];
+      const int32_t q = ((j & 1) ? (packed & 0x0F) : (packed >> 4)) - 8;
+      const int32_t qparams = index * kGroups + j / kGroupSize;
+      expected_data.push_back(
+          (q - zero_points_data[qparams]) * scales_data[qparams]);
+    }
+  }
+
+  Tensor qweight = tfb.make({kRows, kRowBytes}, weight_data);
+  Tensor weight_scales = tf.make({kRows, kGroups}, scales_data);
+  Tensor weight_zero_points = tf.make({kRows, kGroups}, zero_points_data);
+  Tensor indices = tfl.make({4}, indices_data);
+  Tensor out = tf.zeros({4, kDim});
+
+  quantized_embedding_4bit_out(
+      qweight, weight_scales, weight_zero_points, -8, 7, indices, out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({4, kDim}, expected_data));
+}
+
 TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbeddingDeath1) {
   et_pal_init();
   TensorFactory<ScalarType::Byte> tfb;
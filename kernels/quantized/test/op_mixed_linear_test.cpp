@@ -140,3 +140,48 @@ TEST_F(OpQuantizedMixedDtypeLinearTest, HalfInputHalfOutput_Partials) {
   test_dtype_partials<ScalarType::Half, ScalarType::Half>();
 }
 #endif
+
+TEST_F(OpQuantizedMixedDtypeLinearTest, FloatInputFloatOutput_Wide) {
+  // Wide enough to cover both the vectorized dot products and their tails.
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  constexpr int m = 2, n = 37, p = 3, groups = 2, g = (n + groups - 1) / groups;
+  std::vector<float> in_data(m * n);
+  std::vector<int8_t> weight_data(p * n);
+  std::vector<float> scales_data(p * groups);
+  for (int k = 0; k < m * n; ++k) {
+    in_data[k] = 0.25f * (k % 7) - 0.5f;
+  }
+  for (int k = 0; k < p * n; ++k) {
+    weight_data[k] = static_cast<int8_t>((k * 37) % 255 - 127);
+  }
+  for (int k = 0; k < p * groups; ++k) {
+    scales_data[k] = 0.01f * (k + 1);
+  }
+
+  std::vector<float> expected_data(m * p);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < p; ++j) {
+      float sum = 0;
+      for (int k = 0; k < n; ++k) {
+        sum += in_data[i * n + k] * weight_data[j * n + k] *
+            scales_data[j * groups + k / g];
+      }
+      expected_data[i * p + j] = sum;
+    }
+  }
+
+  Tensor input = tf.make({m, n}, in_data);
+  Tensor weight = tf_char.make({p, n}, weight_data);
+  Tensor weight_scales = tf.make({p, groups}, scales_data);
+  const optional<Tensor> opt_weight_zp{};
+  const optional<ScalarType> opt_dtype_out{};
+  Tensor out = tf.zeros({m, p});
+
+  RuntimeContext ctx{};
+  quantized_mixed_linear_out(
+      ctx, input, weight, weight_scales, opt_weight_zp, opt_dtype_out, out);
+
+  EXPECT_TENSOR_CLOSE(out, tf.make({m, p}, expected_data));
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::native::quantized_mul_out;
+using torch::executor::testing::TensorFactory;
+
+class OpQuantizedMulTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(OpQuantizedMulTest, ExactValues) {
+  TensorFactory<ScalarType::Byte> tf;
+
+  // (8 - 2) * 0.5 = 3, (14 - 4) * 0.25 = 2.5, 3 * 2.5 / 0.1 + 5 = 80
+  Tensor a = tf.full({3, 5}, 8);
+  Tensor b = tf.full({3, 5}, 14);
+  Tensor out = tf.zeros({3, 5});
+
+  RuntimeContext ctx{};
+  quantized_mul_out(
+      ctx, a, 0.5, 2, 0, 255, b, 0.25, 4, 0, 255, 0.1, 5, 0, 255, out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_EQ(out, tf.full({3, 5}, 80));
+}
+
+TEST_F(OpQuantizedMulTest, Int8MatchesFloatPatternWithinOneStep) {
+  // Long enough to cover the vectorized fixed-point loop and its tail.
+  constexpr int32_t kSize = 301;
+  const float a_scale = 0.05f;
+  const int32_t a_zero_point = -3;
+  const float b_scale = 0.02f;
+  const int32_t b_zero_point = 7;
+  const float out_scale = 0.03f;
+  const int32_t out_zero_point = 4;
+
+  std::vector<int8_t> a_data(kSize);
+  std::vector<int8_t> b_data(kSize);
+  std::vector<int8_t> expected_data(kSize);
+  for (int32_t i = 0; i < kSize; ++i) {
+    a_data[i] = static_cast<int8_t>((i * 37) % 256 - 128);
+    b_data[i] = static_cast<int8_t>((i * 91 + 5) % 256 - 128);
+    const float value = ((a_data[i] - a_zero_point) * a_scale) *
+        ((b_data[i] - b_zero_point) * b_scale);
+    const float q = out_zero_point + std::nearbyint(value * (1.0f / out_scale));
+    expected_data[i] =
+        static_cast<int8_t>(std::min(std::max(q, -128.0f), 127.0f));
+  }
+
+  TensorFactory<ScalarType::Char> tf;
+  Tensor a = tf.make({kSize}, a_data);
+  Tensor b = tf.make({kSize}, b_data);
+  Tensor out = tf.zeros({kSize});
+
+  RuntimeContext ctx{};
+  quantized_mul_out(
+      ctx,
+      a,
+      a_scale,
+      a_zero_point,
+      -128,
+      127,
+      b,
+      b_scale,
+      b_zero_point,
+      -128,
+      127,
+      out_scale,
+      out_zero_point,
+      -128,
+      127,
+      out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  const int8_t* out_data = out.const_data_ptr<int8_t>();
+  for (int32_t i = 0; i < kSize; ++i) {
+    EXPECT_LE(std::abs(out_data[i] - expected_data[i]), 1) << "at " << i;
+  }
+}
+
+TEST_F(OpQuantizedMulTest, InvalidQuantRangeFails) {
+  TensorFactory<ScalarType::Byte> tf;
+
+  Tensor a = tf.ones({2, 2});
+  Tensor b = tf.ones({2, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  RuntimeContext ctx{};
+  quantized_mul_out(
+      ctx, a, 1.0, 0, 0, 255, b, 1.0, 0, 0, 255, 1.0, 0, -1, 256, out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::InvalidArgument);
+}
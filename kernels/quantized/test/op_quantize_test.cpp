@@ -14,7 +14,9 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -136,3 +138,71 @@ TEST(OpQuantizeOutTest, QuantizePerChannel) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+/// Quantizes `value` the way the scalar kernel does, rounding half to even.
+static int64_t reference_quantize(
+    float value,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  float inv_scale = 1.0f / static_cast<float>(scale);
+  int64_t q = static_cast<int64_t>(
+      static_cast<int32_t>(zero_point) + std::nearbyint(inv_scale * value));
+  return std::min<int64_t>(std::max<int64_t>(q, quant_min), quant_max);
+}
+
+template <ScalarType DTYPE>
+void test_matches_reference(int64_t quant_min, int64_t quant_max) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<DTYPE> tfo;
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+
+  // 37 elements cover both the vectorized body and its tail, and the
+  // multiples of 0.25 land exactly halfway between quantized values.
+  const double scale = 0.5;
+  const int64_t zero_point = 3;
+  std::vector<float> data(37);
+  std::vector<CTYPE> expected_data(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = (static_cast<float>(i) - 18.0f) * 0.25f * (i % 2 ? 1 : 500);
+    expected_data[i] = static_cast<CTYPE>(reference_quantize(
+        data[i], scale, zero_point, quant_min, quant_max));
+  }
+  const int32_t size = data.size();
+
+  Tensor input = tf.make({size}, data);
+  Tensor out = tfo.zeros({size});
+  quantize_per_tensor_out(
+      input, scale, zero_point, quant_min, quant_max, DTYPE, out);
+
+  EXPECT_TENSOR_EQ(out, tfo.make({size}, expected_data));
+}
+
+TEST(OpQuantizeOutTest, MatchesScalarReference) {
+  test_matches_reference<ScalarType::Byte>(0, 255);
+  test_matches_reference<ScalarType::Char>(-128, 127);
+  test_matches_reference<ScalarType::Char>(-8, 7);
+  test_matches_reference<ScalarType::Short>(-32768, 32767);
+  test_matches_reference<ScalarType::Int>(-1000, 1000);
+}
+
+TEST(OpQuantizeOutTest, QuantizePerChannelInnerAxis) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+  TensorFactory<ScalarType::Char> tfo;
+
+  // Shape (2, 3, 2), quantized along axis 1.
+  Tensor input = tf_float.full({2, 3, 2}, 4);
+  Tensor scale = tf_double.make({3}, {0.5, 1, 2});
+  Tensor zero_point = tf_long.make({3}, {-1, 0, 1});
+  Tensor out = tfo.zeros({2, 3, 2});
+
+  // 4 / 0.5 - 1, 4 / 1 + 0, 4 / 2 + 1
+  Tensor expected = tfo.make({2, 3, 2}, {7, 7, 4, 4, 3, 3, 7, 7, 4, 4, 3, 3});
+  quantize_per_channel_out(
+      input, scale, zero_point, 1, -128, 127, ScalarType::Char, out);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::native::quantized_relu_out;
+using torch::executor::testing::TensorFactory;
+
+class OpQuantizedReluTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(OpQuantizedReluTest, SameQParamsClampsAtZeroPoint) {
+  TensorFactory<ScalarType::Char> tf;
+
+  Tensor a = tf.make(
+      {2, 6}, {-128, -20, -11, -10, -9, 0, 5, 50, 100, 127, -1, -100});
+  Tensor out = tf.zeros({2, 6});
+  Tensor expected =
+      tf.make({2, 6}, {-10, -10, -10, -10, -9, 0, 5, 50, 100, 127, -1, -10});
+
+  RuntimeContext ctx{};
+  quantized_relu_out(ctx, a, 0.1, -10, -128, 127, 0.1, -10, -128, 127, out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST_F(OpQuantizedReluTest, RequantizeMatchesFloatPatternWithinOneStep) {
+  // Long enough to cover the vectorized fixed-point loop and its tail.
+  constexpr int32_t kSize = 301;
+  const float a_scale = 0.05f;
+  const int32_t a_zero_point = 100;
+  const float out_scale = 0.03f;
+  const int32_t out_zero_point = 3;
+
+  std::vector<uint8_t> a_data(kSize);
+  std::vector<uint8_t> expected_data(kSize);
+  for (int32_t i = 0; i < kSize; ++i) {
+    a_data[i] = static_cast<uint8_t>((i * 37) % 256);
+    const float value = std::max(0.0f, (a_data[i] - a_zero_point) * a_scale);
+    const float q = out_zero_point + std::nearbyint(value * (1.0f / out_scale));
+    expected_data[i] =
+        static_cast<uint8_t>(std::min(std::max(q, 0.0f), 255.0f));
+  }
+
+  TensorFactory<ScalarType::Byte> tf;
+  Tensor a = tf.make({kSize}, a_data);
+  Tensor out = tf.zeros({kSize});
+
+  RuntimeContext ctx{};
+  quantized_relu_out(
+      ctx,
+      a,
+      a_scale,
+      a_zero_point,
+      0,
+      255,
+      out_scale,
+      out_zero_point,
+      0,
+      255,
+      out);
+
+  EXPECT_EQ(ctx.failure_state(), Error::Ok);
+  const uint8_t* out_data = out.const_data_ptr<uint8_t>();
+  for (int32_t i = 0; i < kSize; ++i) {
+    EXPECT_LE(std::abs(out_data[i] - expected_data[i]), 1) << "at " << i;
+  }
+}
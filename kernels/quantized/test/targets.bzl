@@ -26,6 +26,12 @@ def define_common_targets():
         "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
     ])
     op_test("op_embedding4b_test", kernel_name = "quantized")
+    op_test("op_dynamic_linear_test", kernel_name = "quantized", deps = [
+        "//executorch/kernels/quantized/cpu:op_dynamic_linear",
+        "//executorch/kernels/quantized:generated_lib_headers",
+        "//executorch/kernels/portable:generated_lib_headers",
+        "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+    ])
     op_test("op_mixed_mm_test", kernel_name = "quantized", deps = [
         "//executorch/kernels/quantized/cpu:op_mixed_mm",
         "//executorch/kernels/quantized:generated_lib_headers",
@@ -38,3 +44,13 @@ def define_common_targets():
         "//executorch/kernels/portable:generated_lib_headers",
         "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
     ])
+    op_test("op_mul_test", kernel_name = "quantized", deps = [
+        "//executorch/kernels/quantized/cpu:op_mul",
+        "//executorch/kernels/quantized:generated_lib_headers",
+        "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+    ])
+    op_test("op_relu_test", kernel_name = "quantized", deps = [
+        "//executorch/kernels/quantized/cpu:op_relu",
+        "//executorch/kernels/quantized:generated_lib_headers",
+        "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+    ])
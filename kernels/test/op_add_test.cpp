@@ -288,6 +288,38 @@ TEST_F(OpAddOutKernelTest, BroadcastSupported) {
   EXPECT_TENSOR_EQ(out, tf.ones({5, 2, 3, 4}));
 }
 
+TEST_F(OpAddOutKernelTest, BroadcastChannelsLast) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // A per-channel bias added to an NHWC activation.
+  Tensor a = tf.make_channels_last(
+      {1, 2, 2, 2}, {1, 10, 2, 20, 3, 30, 4, 40});
+  Tensor b = tf.make({2, 1, 1}, {100, 200});
+  Tensor out = tf.full_channels_last({1, 2, 2, 2}, 0);
+
+  op_add_out(a, b, 1, out);
+
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make_channels_last(
+          {1, 2, 2, 2}, {101, 210, 102, 220, 103, 230, 104, 240}));
+}
+
+TEST_F(OpAddOutKernelTest, MixedDimOrders) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor a = tf.make({1, 2, 2, 2}, {1, 2, 3, 4, 10, 20, 30, 40});
+  Tensor b = tf.make_channels_last(
+      {1, 2, 2, 2}, {1, 10, 2, 20, 3, 30, 4, 40});
+  Tensor out = tf.full_channels_last({1, 2, 2, 2}, 0);
+
+  op_add_out(a, b, 1, out);
+
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make_channels_last({1, 2, 2, 2}, {2, 20, 4, 40, 6, 60, 8, 80}));
+}
+
 //
 // Death Tests
 //
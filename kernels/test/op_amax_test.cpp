@@ -309,3 +309,46 @@ TEST_F(OpAmaxOutTest, InfinityAndNANTest) {
       out, tf_float.make({2, 3, 1}, {INFINITY, INFINITY, NAN, NAN, NAN, NAN}));
   // clang-format on
 }
+
+TEST_F(OpAmaxOutTest, LargerTensorEachDimPasses) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Large enough for every reduction below to cover vectorized loops and
+  // their tails in optimized kernels.
+  const std::vector<int32_t> sizes = {3, 37, 300};
+  std::vector<float> data(3 * 37 * 300);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i * 37 % 101) - 50;
+  }
+  data[1234] = NAN;
+  Tensor in = tf.make(sizes, data);
+
+  const std::vector<std::vector<int64_t>> dim_lists = {{0}, {1}, {2}, {0, 2}};
+  for (const auto& dims : dim_lists) {
+    std::vector<int32_t> out_sizes = sizes;
+    for (const auto d : dims) {
+      out_sizes[d] = 1;
+    }
+    std::vector<float> expected(
+        out_sizes[0] * out_sizes[1] * out_sizes[2], -INFINITY);
+    for (int32_t i = 0; i < sizes[0]; ++i) {
+      for (int32_t j = 0; j < sizes[1]; ++j) {
+        for (int32_t k = 0; k < sizes[2]; ++k) {
+          const int32_t out_ix =
+              ((i % out_sizes[0]) * out_sizes[1] + j % out_sizes[1]) *
+                  out_sizes[2] +
+              k % out_sizes[2];
+          const float v = data[(i * sizes[1] + j) * sizes[2] + k];
+          if (std::isnan(v) || v > expected[out_ix]) {
+            expected[out_ix] = v;
+          }
+        }
+      }
+    }
+
+    Tensor out = tf.zeros(out_sizes);
+    op_amax_out(
+        in, ArrayRef<int64_t>{dims.data(), dims.size()}, /*keepdim=*/true, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(out_sizes, expected));
+  }
+}
@@ -14,6 +14,8 @@
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -108,3 +110,25 @@ TEST_F(OpArgmaxTest, SanityCheckNullDim) {
   EXPECT_TENSOR_EQ(out, expected);
   // clang-format on
 }
+
+TEST_F(OpArgmaxTest, LongRowsKeepFirstResultAndNaN) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Rows long enough to be searched in several chunks.
+  constexpr int64_t kRowSize = 20000;
+  std::vector<float> data(2 * kRowSize);
+  for (int64_t i = 0; i < kRowSize; ++i) {
+    data[i] = data[kRowSize + i] = static_cast<float>(i % 100) / 100;
+  }
+  data[12345] = data[17000] = 5;
+  data[kRowSize + 3] = 5;
+  data[kRowSize + 15000] = NAN;
+  Tensor in = tf.make({2, kRowSize}, data);
+
+  Tensor out = tfl.zeros({2});
+  Tensor ret = op_argmax_out(in, -1, false, out);
+
+  EXPECT_TENSOR_EQ(out, ret);
+  EXPECT_TENSOR_EQ(out, tfl.make({2}, {12345, 15000}));
+}
@@ -1049,3 +1049,87 @@ TEST_F(OpAvgPool2DOutTest, SanityCheck4DCeilModeNoIncludePadding) {
       out);
   EXPECT_TENSOR_CLOSE(out, out_expected);
 }
+
+TEST_F(OpAvgPool2DOutTest, SanityCheckChannelsLast) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  exec_aten::Tensor self = tfFloat.make_channels_last(
+      {1, 3, 3, 4},
+      {-5.5, -2.0, 1.5,  1.5,  5.0,  -3.0, -3.0, 0.5, 4.0,  4.0,  -4.0, -0.5,
+       -0.5, 3.0,  -5.0, -5.0, -1.5, 2.0,  2.0,  5.5, -2.5, -2.5, 1.0,  4.5,
+       4.5,  -3.5, 0.0,  0.0,  3.5,  -4.5, -4.5, -1.0, 2.5, 2.5,  -5.5, -2.0});
+  ::std::vector<int64_t> kernel_size_vec = {2, 2};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {1, 2};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  bool ceil_mode = false;
+  bool count_include_pad = true;
+  exec_aten::optional<int64_t> divisor_override;
+  exec_aten::Tensor out = tfFloat.full_channels_last({1, 3, 4, 3}, 0);
+  exec_aten::Tensor out_expected = tfFloat.make_channels_last(
+      {1, 3, 4, 3},
+      {-1.375, -0.5,   0.375,  -0.375, 1.375,  0.25,   1.0,    -1.0,   -0.125,
+       -1.5,   0.25,   -0.875, -1.125, 2.375,  0.125,  0.375,  -0.75,  1.0,
+       1.0,    -0.125, -1.25,  -1.875, 1.625,  -0.625, 0.0,    -1.125, 0.625,
+       1.125,  -0.875, 0.0,    -1.125, 0.625,  -0.5,   0.625,  -1.375, -0.5});
+  op_avg_pool2d_out(
+      self,
+      kernel_size,
+      stride,
+      padding,
+      ceil_mode,
+      count_include_pad,
+      divisor_override,
+      out);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+}
+
+TEST_F(OpAvgPool2DOutTest, SanityCheckWideRowsNoIncludePadding) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  // Rows wide enough for several outputs between the left and right padding.
+  exec_aten::Tensor self = tfFloat.make(
+      {1, 1, 3, 19},
+      {-8.0, 4.0,  -1.0, -6.0, 6.0,  1.0,  -4.0, 8.0,  3.0,  -2.0, -7.0, 5.0,
+       0.0,  -5.0, 7.0,  2.0,  -3.0, -8.0, 4.0,  -1.0, -6.0, 6.0,  1.0,  -4.0,
+       8.0,  3.0,  -2.0, -7.0, 5.0,  0.0,  -5.0, 7.0,  2.0,  -3.0, -8.0, 4.0,
+       -1.0, -6.0, 6.0,  1.0,  -4.0, 8.0,  3.0,  -2.0, -7.0, 5.0,  0.0,  -5.0,
+       7.0,  2.0,  -3.0, -8.0, 4.0,  -1.0, -6.0, 6.0,  1.0});
+  ::std::vector<int64_t> kernel_size_vec = {2, 3};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {0, 1};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  bool ceil_mode = false;
+  bool count_include_pad = false;
+  exec_aten::optional<int64_t> divisor_override;
+  exec_aten::Tensor out = tfFloat.zeros({1, 1, 2, 19});
+  exec_aten::Tensor out_expected = tfFloat.make(
+      {1, 1, 2, 19},
+      {-2.75,     -1.0,      -0.333333, 0.333333,  1.0,       1.666667,
+       2.333333,  0.166667,  0.833333,  -1.333333, -0.666667, 0.0,
+       0.666667,  1.333333,  -0.833333, -0.166667, -2.333333, -1.666667,
+       -2.75,     0.0,       0.333333,  1.0,       1.666667,  2.333333,
+       0.166667,  0.833333,  -1.333333, -0.666667, 0.0,       0.666667,
+       1.333333,  -0.833333, -0.166667, -2.333333, -1.666667, -1.0,
+       -0.333333, 0.0});
+  op_avg_pool2d_out(
+      self,
+      kernel_size,
+      stride,
+      padding,
+      ceil_mode,
+      count_include_pad,
+      divisor_override,
+      out);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+}
@@ -728,3 +728,65 @@ TEST_F(OpConvCorrectnessTest, InvalidOutputPadding) {
           groups,
           out));
 }
+
+TEST_F(OpConvCorrectnessTest, 2DGroupedChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Random-looking data, so that misplaced elements show up.
+  std::vector<float> input_data(2 * 4 * 7 * 6);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>((i * 37) % 17) / 8 - 1;
+  }
+  std::vector<float> weight_data(6 * 2 * 3 * 3);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<float>((i * 11) % 13) / 6 - 1;
+  }
+  Tensor input = tf.make({2, 4, 7, 6}, input_data);
+  Tensor weight = tf.make({6, 2, 3, 3}, weight_data);
+  optional<Tensor> bias(tf.make({6}, {1, 2, 3, 4, 5, 6}));
+  Tensor out = tf.zeros({2, 6, 7, 6});
+
+  int64_t stride[] = {1, 1};
+  int64_t padding[] = {1, 1};
+  int64_t dilation[] = {1, 1};
+  int64_t output_padding[] = {0};
+  int64_t groups = 2;
+
+  op_convolution_out(
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      groups,
+      out);
+
+  Tensor input_channels_last = tf.make_channels_last(
+      {2, 4, 7, 6}, get_channels_last_data<float>(input));
+  Tensor weight_channels_last = tf.make_channels_last(
+      {6, 2, 3, 3}, get_channels_last_data<float>(weight));
+  Tensor out_channels_last = tf.full_channels_last({2, 6, 7, 6}, 0);
+
+  op_convolution_out(
+      input_channels_last,
+      weight_channels_last,
+      bias,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      groups,
+      out_channels_last);
+
+  // The channels-last result may sum in a different order.
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out_channels_last,
+      tf.make_channels_last(
+          {2, 6, 7, 6}, get_channels_last_data<float>(out)),
+      1e-5,
+      1e-5);
+}
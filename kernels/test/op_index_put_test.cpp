@@ -987,6 +987,44 @@ TEST_F(OpIndexPutOutTest, NonLinearIndices) {
   EXPECT_TENSOR_EQ(ret, expected);
 }
 
+TEST_F(OpIndexPutOutTest, InPlaceRowUpdate) {
+  // ATen does not allow out to alias the input of index_put.out.
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel does not support out aliasing self";
+  }
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // An update of rows 2 and 0 along dim 1, as in a KV cache.
+  // clang-format off
+  Tensor x = tf.make(
+      {2, 3, 2},
+      {
+        1,  2,  3,  4,  5,  6,
+        7,  8,  9, 10, 11, 12,
+      });
+  optional<Tensor> indices[] = {
+      optional<Tensor>(), optional<Tensor>(tfl.make({2}, {2, -3}))};
+  Tensor values = tf.make(
+      {2, 2, 2},
+      {
+        20, 21, 22, 23,
+        24, 25, 26, 27,
+      });
+  Tensor expected = tf.make(
+      {2, 3, 2},
+      {
+        22, 23,  3,  4, 20, 21,
+        26, 27,  9, 10, 24, 25,
+      });
+  // clang-format on
+
+  Tensor ret = op_index_put_out(x, indices, values, /*accumulate=*/false, x);
+
+  EXPECT_TENSOR_EQ(ret, x);
+  EXPECT_TENSOR_EQ(x, expected);
+}
+
 //
 // Dynamic Shape Tests
 //
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpLinearOutTest : public OperatorTest {
+ protected:
+  Tensor& op_linear_out(
+      const Tensor& self,
+      const Tensor& weight,
+      const optional<Tensor>& bias,
+      Tensor& out) {
+    return torch::executor::aten::linear_outf(
+        context_, self, weight, bias, out);
+  }
+
+  template <class CTYPE, exec_aten::ScalarType DTYPE>
+  void test_dtype() {
+    TensorFactory<DTYPE> tf;
+
+    if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+      if (DTYPE == ScalarType::Half) {
+        GTEST_SKIP()
+            << "skip Half because torch::executor::aten::linear_out does not support Half";
+        return;
+      }
+    }
+
+    // matmul gives 4 * 2 * 3 = 24, plus a bias of 1 gives 25
+    Tensor x = tf.full({3, 4}, 2);
+    Tensor weight = tf.full({5, 4}, 3);
+    Tensor bias = tf.full({5}, 1);
+
+    // Output shape should be (3, 5)
+    Tensor out = tf.zeros({3, 5});
+
+    op_linear_out(x, weight, bias, out);
+
+    Tensor expected = tf.full({3, 5}, 25);
+
+    EXPECT_TENSOR_EQ(out, expected);
+  }
+};
+
+TEST_F(OpLinearOutTest, OutputDim) {
+  TensorFactory<ScalarType::Int> tf;
+
+  // 3 tensors with compatible dimensions: (3, 5), (3, 4) and (5, 4).
+  Tensor x = tf.ones({3, 4});
+  Tensor weight = tf.ones({5, 4});
+  Tensor out = tf.zeros({3, 5});
+
+  Tensor ret = op_linear_out(x, weight, exec_aten::nullopt, out);
+
+  // Should always return the provided out Tensor.
+  EXPECT_TENSOR_EQ(ret, out);
+
+  // Expected tensor, filled with 4.
+  Tensor expected = tf.full({3, 5}, 4);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+/// A generic smoke test that works for any dtype that supports ones() and
+/// zeros().
+TEST_F(OpLinearOutTest, AllDtypesSupported) {
+#define TEST_ENTRY(ctype, dtype) test_dtype<ctype, ScalarType::dtype>();
+  ET_FORALL_REAL_TYPES_AND(Half, TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpLinearOutTest, ComputesTransposedWeightProduct) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor x = tf.make({2, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor weight = tf.make({2, 3}, {1, 0, -1, 2, 1, 0});
+  Tensor bias = tf.make({2}, {0.5, -0.5});
+  Tensor out = tf.zeros({2, 2});
+
+  op_linear_out(x, weight, bias, out);
+
+  // x @ weight^T = [[-2, 4], [-2, 13]], plus the bias.
+  Tensor expected = tf.make({2, 2}, {-1.5, 3.5, -1.5, 12.5});
+
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST_F(OpLinearOutTest, BatchedInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Leading dims of the input are kept in the output.
+  Tensor x = tf.make({2, 2, 2}, {1, 2, 3, 4, 5, 6, 7, 8});
+  Tensor weight = tf.make({3, 2}, {1, 0, 0, 1, 1, 1});
+  Tensor out = tf.zeros({2, 2, 3});
+
+  op_linear_out(x, weight, exec_aten::nullopt, out);
+
+  Tensor expected = tf.make(
+      {2, 2, 3}, {1, 2, 3, 3, 4, 7, 5, 6, 11, 7, 8, 15});
+
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST_F(OpLinearOutTest, VectorInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor x = tf.make({3}, {1, 2, 3});
+  Tensor weight = tf.make({2, 3}, {1, 1, 1, 0, 1, 0});
+  Tensor bias = tf.make({2}, {1, 1});
+  Tensor out = tf.zeros({2});
+
+  op_linear_out(x, weight, bias, out);
+
+  Tensor expected = tf.make({2}, {7, 3});
+
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST_F(OpLinearOutTest, InfinityTensorPasses) {
+  TensorFactory<ScalarType::Float> tff;
+
+  Tensor x = tff.full({3, 4}, std::numeric_limits<float>::infinity());
+  Tensor weight = tff.full({5, 4}, 3);
+
+  // Output shape should be (3, 5)
+  Tensor out = tff.zeros({3, 5});
+
+  Tensor expected = tff.full({3, 5}, std::numeric_limits<float>::infinity());
+
+  EXPECT_TENSOR_EQ(op_linear_out(x, weight, exec_aten::nullopt, out), expected);
+}
+
+TEST_F(OpLinearOutTest, MismatchedDimensionsDies) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor x = tf.full({2, 2}, 3);
+
+  Tensor wrong_weight = tf.full({2, 3}, 1);
+  Tensor right_weight = tf.full({2, 2}, 1);
+
+  Tensor out = tf.full({2, 2}, 0);
+
+  Tensor expected = tf.full({2, 2}, 6);
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_linear_out(x, wrong_weight, exec_aten::nullopt, out));
+
+  EXPECT_TENSOR_EQ(
+      op_linear_out(x, right_weight, exec_aten::nullopt, out), expected);
+}
+
+TEST_F(OpLinearOutTest, MismatchedBiasSizeDies) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel can broadcast the bias";
+  }
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor x = tf.ones({2, 3});
+  Tensor weight = tf.ones({4, 3});
+  Tensor wrong_bias = tf.ones({3});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_linear_out(x, weight, wrong_bias, out));
+}
+
+TEST_F(OpLinearOutTest, DynamicShapeUpperBoundLargerThanExpected) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor x = tf.make({2, 2}, {1, 2, 3, 4});
+  Tensor weight = tf.make({3, 2}, {1, 0, 0, 1, 1, 1});
+  Tensor expected = tf.make({2, 3}, {1, 2, 3, 3, 4, 7});
+
+  Tensor out =
+      tf.zeros({10, 10}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
+  op_linear_out(x, weight, exec_aten::nullopt, out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
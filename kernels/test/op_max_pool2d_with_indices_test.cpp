@@ -287,3 +287,82 @@ TEST_F(OpMaxPool2DWithIndicesOutTest, SanityTest3D) {
   EXPECT_TENSOR_CLOSE(out, out_expected);
   EXPECT_TENSOR_CLOSE(indices, indices_expected);
 }
+
+TEST_F(OpMaxPool2DWithIndicesOutTest, SanityTestChannelsLast) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Long> tfLong;
+
+  exec_aten::Tensor self = tfFloat.make_channels_last(
+      {1, 3, 3, 4},
+      {-5.5, -2.0, 1.5,  1.5,  5.0,  -3.0, -3.0, 0.5, 4.0,  4.0,  -4.0, -0.5,
+       -0.5, 3.0,  -5.0, 2.0,  -1.5, 2.0,  2.0,  5.5, -2.5, -2.5, 1.0,  4.5,
+       4.5,  -3.5, 0.0,  0.0,  3.5,  -4.5, -4.5, -1.0, 2.5, 2.5,  -5.5, -2.0});
+  ::std::vector<int64_t> kernel_size_vec = {2, 2};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {0, 0};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  ::std::vector<int64_t> dilation_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> dilation =
+      exec_aten::ArrayRef<int64_t>(dilation_vec.data(), dilation_vec.size());
+  bool ceil_mode = false;
+  exec_aten::Tensor out = tfFloat.full_channels_last({1, 3, 2, 3}, 0);
+  exec_aten::Tensor indices = tfLong.full_channels_last({1, 3, 2, 3}, 0);
+  exec_aten::Tensor out_expected = tfFloat.make_channels_last(
+      {1, 3, 2, 3},
+      {2.0, 5.0, 2.0, 2.0, 5.5, 4.0, 4.0, 5.5, 4.5,
+       4.5, 3.5, 2.0, 2.0, 5.5, 2.5, 2.5, 5.5, 4.5});
+  exec_aten::Tensor indices_expected = tfLong.make_channels_last(
+      {1, 3, 2, 3}, {5, 1, 5, 5, 6, 2, 3, 6, 7, 8, 9, 5, 5, 6, 10, 11, 6, 7});
+  op_max_pool2d_with_indices_out(
+      self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+  EXPECT_TENSOR_CLOSE(indices, indices_expected);
+}
+
+TEST_F(OpMaxPool2DWithIndicesOutTest, SanityTestWideRows) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Long> tfLong;
+
+  // Rows wide enough for several outputs between the left and right padding.
+  exec_aten::Tensor self = tfFloat.make(
+      {1, 1, 3, 19},
+      {-8.0, 4.0,  -1.0, -6.0, 6.0,  1.0,  -4.0, 8.0,  3.0,  -2.0, -7.0, 5.0,
+       0.0,  -5.0, 7.0,  2.0,  -3.0, -8.0, 4.0,  -1.0, -6.0, 6.0,  1.0,  -4.0,
+       8.0,  3.0,  -2.0, -7.0, 5.0,  0.0,  -5.0, 7.0,  2.0,  -3.0, -8.0, 4.0,
+       -1.0, -6.0, 6.0,  1.0,  -4.0, 8.0,  3.0,  -2.0, -7.0, 5.0,  0.0,  -5.0,
+       7.0,  2.0,  -3.0, -8.0, 4.0,  -1.0, -6.0, 6.0,  1.0});
+  ::std::vector<int64_t> kernel_size_vec = {2, 3};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {0, 1};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  ::std::vector<int64_t> dilation_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> dilation =
+      exec_aten::ArrayRef<int64_t>(dilation_vec.data(), dilation_vec.size());
+  bool ceil_mode = false;
+  exec_aten::Tensor out = tfFloat.zeros({1, 1, 2, 19});
+  exec_aten::Tensor indices = tfLong.zeros({1, 1, 2, 19});
+  exec_aten::Tensor out_expected = tfFloat.make(
+      {1, 1, 2, 19},
+      {4.0, 6.0, 6.0, 6.0, 8.0, 8.0, 8.0, 8.0, 8.0, 5.0, 5.0, 7.0, 7.0,
+       7.0, 7.0, 7.0, 4.0, 4.0, 4.0, 6.0, 6.0, 8.0, 8.0, 8.0, 8.0, 8.0,
+       5.0, 5.0, 7.0, 7.0, 7.0, 7.0, 7.0, 4.0, 4.0, 6.0, 6.0, 6.0});
+  exec_aten::Tensor indices_expected = tfLong.make(
+      {1, 1, 2, 19},
+      {1,  21, 21, 4,  24, 24, 7,  7,  7,  28, 11, 31, 31,
+       14, 14, 14, 35, 18, 18, 38, 21, 41, 41, 24, 24, 24,
+       45, 28, 48, 48, 31, 31, 31, 52, 35, 55, 55, 55});
+  op_max_pool2d_with_indices_out(
+      self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+  EXPECT_TENSOR_CLOSE(indices, indices_expected);
+}
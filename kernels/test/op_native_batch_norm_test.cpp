@@ -514,6 +514,39 @@ TEST_F(OpNativeBatchNormLegitNoTrainingOutTest, SampleAtomicTest4D) {
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
 
+TEST_F(OpNativeBatchNormLegitNoTrainingOutTest, ChannelsLast) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  exec_aten::Tensor input = tfFloat.make_channels_last(
+      {1, 2, 2, 2}, {1, 10, 2, 20, 3, 30, 4, 40});
+  exec_aten::optional<exec_aten::Tensor> weight =
+      exec_aten::optional<exec_aten::Tensor>(tfFloat.make({2}, {2, 3}));
+  exec_aten::optional<exec_aten::Tensor> bias =
+      exec_aten::optional<exec_aten::Tensor>(tfFloat.make({2}, {1, -1}));
+  exec_aten::Tensor running_mean = tfFloat.make({2}, {2, 20});
+  exec_aten::Tensor running_var = tfFloat.make({2}, {4, 100});
+  double momentum = 0.1;
+  double eps = 0;
+  exec_aten::Tensor out0 = tfFloat.full_channels_last({1, 2, 2, 2}, 0);
+  exec_aten::Tensor out1 = tfFloat.zeros({0});
+  exec_aten::Tensor out2 = tfFloat.zeros({0});
+  // (input - mean) / sqrt(var) * weight + bias, per channel.
+  exec_aten::Tensor out0_expected = tfFloat.make_channels_last(
+      {1, 2, 2, 2}, {0, -4, 1, -1, 2, 2, 3, 5});
+  op_native_batch_norm_legit_no_training_out(
+      input,
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      momentum,
+      eps,
+      out0,
+      out1,
+      out2);
+  EXPECT_TENSOR_CLOSE(out0, out0_expected);
+}
+
 TEST_F(OpNativeBatchNormLegitNoTrainingOutTest, SampleAtomicTestDouble) {
   torch::executor::testing::TensorFactory<exec_aten::ScalarType::Double>
       tfDouble;
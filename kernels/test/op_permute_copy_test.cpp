@@ -301,6 +301,46 @@ TEST_F(OpPermuteCopyTest, FiveDPermute) {
   // clang-format on
 }
 
+TEST_F(OpPermuteCopyTest, LargerTensorPermutes) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Big enough to need several transpose tiles, with partial tiles on every
+  // edge.
+  const std::vector<int32_t> sizes = {2, 19, 13, 11};
+  std::vector<float> in_data(2 * 19 * 13 * 11);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(i);
+  }
+  Tensor in = tf.make(sizes, in_data);
+
+  const std::vector<std::vector<int64_t>> perms = {
+      {0, 2, 3, 1}, {0, 3, 1, 2}, {2, 0, 1, 3}, {3, 2, 1, 0}, {1, 0, 3, 2}};
+  for (const auto& perm : perms) {
+    std::vector<int32_t> out_sizes(4);
+    for (size_t i = 0; i < 4; ++i) {
+      out_sizes[i] = sizes[perm[i]];
+    }
+    // Walk the output in order, reading the matching input element.
+    std::vector<float> expected;
+    int64_t in_strides[4] = {19 * 13 * 11, 13 * 11, 11, 1};
+    for (int64_t a = 0; a < out_sizes[0]; ++a) {
+      for (int64_t b = 0; b < out_sizes[1]; ++b) {
+        for (int64_t c = 0; c < out_sizes[2]; ++c) {
+          for (int64_t d = 0; d < out_sizes[3]; ++d) {
+            const int64_t in_index = a * in_strides[perm[0]] +
+                b * in_strides[perm[1]] + c * in_strides[perm[2]] +
+                d * in_strides[perm[3]];
+            expected.push_back(in_data[in_index]);
+          }
+        }
+      }
+    }
+    Tensor out = tf.zeros(out_sizes);
+    op_permute_copy_out(in, ArrayRef<int64_t>(perm.data(), perm.size()), out);
+    EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected));
+  }
+}
+
 TEST_F(OpPermuteCopyTest, AllDimensionsSizeOne) {
   TensorFactory<ScalarType::Int> tf;
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::SupportedFeatures;
+using torch::executor::testing::TensorFactory;
+
+class OpSiluOutTest : public OperatorTest {
+ protected:
+  Tensor& op_silu_out(const Tensor& self, Tensor& out) {
+    return torch::executor::aten::silu_outf(context_, self, out);
+  }
+
+  template <ScalarType DTYPE>
+  void test_silu_out() {
+    TensorFactory<DTYPE> tf;
+
+    const std::vector<int32_t> sizes = {2, 3};
+
+    Tensor out = tf.zeros(sizes);
+
+    op_silu_out(tf.make(sizes, /*data=*/{-4, -1, 0, 0.5, 1, 4}), out);
+
+    // x * sigmoid(x)
+    EXPECT_TENSOR_CLOSE(
+        out,
+        tf.make(
+            sizes,
+            /*data=*/
+            {-0.0719448, -0.268941, 0, 0.31123, 0.731059, 3.92806}));
+  }
+};
+
+TEST_F(OpSiluOutTest, FloatTypesSupported) {
+  test_silu_out<ScalarType::Float>();
+  test_silu_out<ScalarType::Double>();
+}
+
+TEST_F(OpSiluOutTest, HalfSupported) {
+  if (SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "Test Half support only for ExecuTorch mode";
+  }
+  test_silu_out<ScalarType::Half>();
+}
+
+TEST_F(OpSiluOutTest, LongInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Longer than a vector, with a remainder.
+  const int32_t size = 71;
+  std::vector<float> data(size);
+  std::vector<float> expected(size);
+  for (int32_t i = 0; i < size; ++i) {
+    data[i] = static_cast<float>(i - 35) / 8.0f;
+    expected[i] = data[i] / (1.0f + std::exp(-data[i]));
+  }
+
+  Tensor out = tf.zeros({size});
+  op_silu_out(tf.make({size}, data), out);
+
+  EXPECT_TENSOR_CLOSE(out, tf.make({size}, expected));
+}
+
+TEST_F(OpSiluOutTest, MismatchedDtypeDies) {
+  if (SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel can handle mismatched dtypes";
+  }
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_out;
+
+  Tensor in = tf.ones({2, 2});
+  Tensor out = tf_out.zeros({2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_silu_out(in, out));
+}
+
+TEST_F(OpSiluOutTest, IntegerInputDies) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor in = tf.ones({2, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_silu_out(in, out));
+}
+
+TEST_F(OpSiluOutTest, MismatchedShapesDies) {
+  if (SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel can handle mismatched shapes";
+  }
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({4});
+  Tensor out = tf.zeros({2, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_silu_out(in, out));
+}
@@ -863,3 +863,48 @@ TEST_F(OpSliceScatterTensorOutTest, DynamicShapeTest) {
   EXPECT_TENSOR_EQ(ret_default_end, out);
   EXPECT_TENSOR_EQ(ret_default_end, expected);
 }
+
+TEST_F(OpSliceScatterTensorOutTest, InPlaceUpdate) {
+  // ATen does not allow out to alias the input of slice_scatter.out.
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel does not support out aliasing self";
+  }
+  TensorFactory<ScalarType::Float> tf;
+
+  // clang-format off
+  Tensor input = tf.make(
+      /*sizes=*/{2, 4, 2},
+      /*data=*/{
+        1,  2,  3,  4,  5,  6,  7,  8,
+        9, 10, 11, 12, 13, 14, 15, 16,
+      });
+  Tensor src = tf.make(
+      /*sizes=*/{2, 2, 2},
+      /*data=*/{
+        20, 21, 22, 23,
+        24, 25, 26, 27,
+      });
+  Tensor expected_step_1 = tf.make(
+      /*sizes=*/{2, 4, 2},
+      /*data=*/{
+        1,  2, 20, 21, 22, 23,  7,  8,
+        9, 10, 24, 25, 26, 27, 15, 16,
+      });
+  Tensor expected_step_2 = tf.make(
+      /*sizes=*/{2, 4, 2},
+      /*data=*/{
+        20, 21, 20, 21, 22, 23,  7,  8,
+        24, 25, 24, 25, 26, 27, 15, 16,
+      });
+  // clang-format on
+
+  Tensor ret = op_slice_scatter_out(
+      input, src, /*dim=*/1, /*start=*/1, /*end=*/3, /*step=*/1, input);
+  EXPECT_TENSOR_EQ(ret, input);
+  EXPECT_TENSOR_EQ(input, expected_step_1);
+
+  ret = op_slice_scatter_out(
+      input, src, /*dim=*/1, /*start=*/0, /*end=*/4, /*step=*/2, input);
+  EXPECT_TENSOR_EQ(ret, input);
+  EXPECT_TENSOR_EQ(input, expected_step_2);
+}
@@ -14,6 +14,9 @@
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include <gtest/gtest.h>
 
 using namespace ::testing;
@@ -319,3 +322,62 @@ TEST_F(OpSoftmaxOutTest, DynamicShapeUnbound) {
   Tensor ret = op_softmax_out(x, 1, false, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpSoftmaxOutTest, MatchesReferenceAlongEachDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Rows longer than a vector, and an inner dim that is not a multiple of the
+  // vector width, so that both the reduction and the partial lanes are used.
+  const std::vector<int32_t> sizes = {3, 37, 5};
+  std::vector<float> data(3 * 37 * 5);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 7) % 23) / 4.0f - 2.0f;
+  }
+  Tensor x = tf.make(sizes, data);
+
+  for (int64_t dim = 0; dim < 3; ++dim) {
+    int64_t outer = 1;
+    int64_t inner = 1;
+    for (int64_t i = 0; i < dim; ++i) {
+      outer *= sizes[i];
+    }
+    for (int64_t i = dim + 1; i < 3; ++i) {
+      inner *= sizes[i];
+    }
+    const int64_t n = sizes[dim];
+
+    std::vector<float> expected_data(data.size());
+    for (int64_t o = 0; o < outer; ++o) {
+      for (int64_t j = 0; j < inner; ++j) {
+        const int64_t base = o * n * inner + j;
+        float max_in = data[base];
+        for (int64_t d = 1; d < n; ++d) {
+          max_in = std::max(max_in, data[base + d * inner]);
+        }
+        float sum = 0;
+        for (int64_t d = 0; d < n; ++d) {
+          sum += std::exp(data[base + d * inner] - max_in);
+        }
+        for (int64_t d = 0; d < n; ++d) {
+          expected_data[base + d * inner] =
+              std::exp(data[base + d * inner] - max_in) / sum;
+        }
+      }
+    }
+
+    Tensor out = tf.zeros(sizes);
+    op_softmax_out(x, dim, /*half_to_float=*/false, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected_data));
+  }
+}
+
+TEST_F(OpSoftmaxOutTest, LargeInputsDoNotOverflow) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor x = tf.make({1, 3}, {1000, 1001, 1002});
+  Tensor out = tf.zeros({1, 3});
+
+  op_softmax_out(x, /*dim=*/1, /*half_to_float=*/false, out);
+
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 3}, {0.0900306, 0.244728, 0.665241}));
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpTopkValuesTest : public OperatorTest {
+ protected:
+  ::std::tuple<Tensor&, Tensor&> op_topk_values(
+      const Tensor& input,
+      int64_t k,
+      int64_t dim,
+      bool largest,
+      bool sorted,
+      Tensor& values,
+      Tensor& indices) {
+    return torch::executor::aten::topk_outf(
+        context_, input, k, dim, largest, sorted, values, indices);
+  }
+
+  template <ScalarType DTYPE>
+  void test_dtype() {
+    TensorFactory<DTYPE> tf;
+    TensorFactory<ScalarType::Long> tf_long;
+
+    Tensor input = tf.make({2, 5}, {3, 9, 1, 7, 5, 2, 0, 8, 6, 4});
+    Tensor values = tf.zeros({2, 2});
+    Tensor indices = tf_long.zeros({2, 2});
+
+    op_topk_values(input, 2, -1, true, true, values, indices);
+
+    EXPECT_TENSOR_EQ(values, tf.make({2, 2}, {9, 7, 8, 6}));
+    EXPECT_TENSOR_EQ(indices, tf_long.make({2, 2}, {1, 3, 2, 3}));
+  }
+};
+
+TEST_F(OpTopkValuesTest, AllRealDtypesSupported) {
+#define TEST_ENTRY(ctype, dtype) test_dtype<ScalarType::dtype>();
+  ET_FORALL_REAL_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpTopkValuesTest, Smallest) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf.make({2, 4}, {0.5, -1.5, 2.0, -0.25, 4.0, 3.0, 1.0, 2.5});
+  Tensor values = tf.zeros({2, 3});
+  Tensor indices = tf_long.zeros({2, 3});
+
+  op_topk_values(input, 3, 1, false, true, values, indices);
+
+  EXPECT_TENSOR_EQ(
+      values, tf.make({2, 3}, {-1.5, -0.25, 0.5, 1.0, 2.5, 3.0}));
+  EXPECT_TENSOR_EQ(indices, tf_long.make({2, 3}, {1, 3, 0, 2, 3, 1}));
+}
+
+TEST_F(OpTopkValuesTest, InnerDim) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Selects down the columns, whose elements are 3 apart.
+  Tensor input = tf.make(
+      {2, 4, 3},
+      {1.0,  8.0,  -3.0, 4.0,  2.0,  6.0,  -5.0, 7.0,  0.0,  3.0,  -1.0, 9.0,
+       10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0, 20.0, 21.0});
+  Tensor values = tf.zeros({2, 2, 3});
+  Tensor indices = tf_long.zeros({2, 2, 3});
+
+  op_topk_values(input, 2, 1, true, true, values, indices);
+
+  EXPECT_TENSOR_EQ(
+      values,
+      tf.make(
+          {2, 2, 3},
+          {4.0, 8.0, 9.0, 3.0, 7.0, 6.0, 19.0, 20.0, 21.0, 16.0, 17.0, 18.0}));
+  EXPECT_TENSOR_EQ(
+      indices, tf_long.make({2, 2, 3}, {1, 0, 3, 3, 2, 1, 3, 3, 3, 2, 2, 2}));
+}
+
+TEST_F(OpTopkValuesTest, LongRows) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Rows of a permutation of 0..n-1: element i is i * 37 % n, so value v is
+  // at index v * 73 % n.
+  constexpr int32_t n = 100;
+  std::vector<float> input_data(2 * n);
+  for (int32_t i = 0; i < n; ++i) {
+    input_data[i] = static_cast<float>(i * 37 % n);
+    input_data[n + i] = -input_data[i];
+  }
+  Tensor input = tf.make({2, n}, input_data);
+
+  // Both a small k and one too large to keep on the stack.
+  for (const int32_t k : {3, 70}) {
+    std::vector<float> expected_values;
+    std::vector<int64_t> expected_indices;
+    for (int32_t i = 0; i < k; ++i) {
+      expected_values.push_back(n - 1 - i);
+      expected_indices.push_back((n - 1 - i) * 73 % n);
+    }
+    for (int32_t i = 0; i < k; ++i) {
+      expected_values.push_back(-i);
+      expected_indices.push_back(i * 73 % n);
+    }
+    Tensor values = tf.zeros({2, k});
+    Tensor indices = tf_long.zeros({2, k});
+
+    op_topk_values(input, k, 1, true, true, values, indices);
+
+    EXPECT_TENSOR_EQ(values, tf.make({2, k}, expected_values));
+    EXPECT_TENSOR_EQ(indices, tf_long.make({2, k}, expected_indices));
+  }
+}
+
+TEST_F(OpTopkValuesTest, NaNIsLargest) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf.make({5}, {1.0, NAN, 3.0, -2.0, 0.0});
+  Tensor values = tf.zeros({2});
+  Tensor indices = tf_long.zeros({2});
+
+  op_topk_values(input, 2, 0, true, true, values, indices);
+  EXPECT_TENSOR_CLOSE(values, tf.make({2}, {NAN, 3.0}));
+  EXPECT_TENSOR_EQ(indices, tf_long.make({2}, {1, 2}));
+
+  op_topk_values(input, 2, 0, false, true, values, indices);
+  EXPECT_TENSOR_EQ(values, tf.make({2}, {-2.0, 0.0}));
+  EXPECT_TENSOR_EQ(indices, tf_long.make({2}, {3, 4}));
+}
+
+TEST_F(OpTopkValuesTest, ZeroK) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf.make({2, 3}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+  Tensor values = tf.zeros({2, 0});
+  Tensor indices = tf_long.zeros({2, 0});
+
+  op_topk_values(input, 0, 1, true, true, values, indices);
+
+  EXPECT_TENSOR_EQ(values, tf.zeros({2, 0}));
+  EXPECT_TENSOR_EQ(indices, tf_long.zeros({2, 0}));
+}
+
+TEST_F(OpTopkValuesTest, KTooLargeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf.ones({2, 3});
+  Tensor values = tf.zeros({2, 4});
+  Tensor indices = tf_long.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_topk_values(input, 4, 1, true, true, values, indices));
+}
+
+TEST_F(OpTopkValuesTest, WrongIndicesDtypeDies) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel can handle Int indices";
+  }
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+
+  Tensor input = tf.ones({2, 3});
+  Tensor values = tf.zeros({2, 2});
+  Tensor indices = tf_int.zeros({2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_topk_values(input, 2, 1, true, true, values, indices));
+}
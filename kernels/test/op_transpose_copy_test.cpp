@@ -146,6 +146,33 @@ TEST_F(OpTransposeIntCopyTest, ThreeDTranspose) {
   // clang-format on
 }
 
+TEST_F(OpTransposeIntCopyTest, LargerTensorTranspose) {
+  TensorFactory<ScalarType::Long> tf;
+
+  // Several transpose tiles per matrix, with partial tiles on both edges.
+  const std::vector<int32_t> sizes = {3, 37, 70};
+  std::vector<int64_t> in_data(3 * 37 * 70);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<int64_t>(i);
+  }
+  Tensor t = tf.make(sizes, in_data);
+
+  std::vector<int64_t> expected;
+  for (int64_t b = 0; b < 3; ++b) {
+    for (int64_t j = 0; j < 70; ++j) {
+      for (int64_t i = 0; i < 37; ++i) {
+        expected.push_back(in_data[(b * 37 + i) * 70 + j]);
+      }
+    }
+  }
+
+  const std::vector<int32_t> new_sizes = {3, 70, 37};
+  Tensor out = tf.zeros(new_sizes);
+
+  op_transpose_copy_int_out(t, 1, 2, out);
+  EXPECT_TENSOR_EQ(out, tf.make(new_sizes, expected));
+}
+
 // transpose an out of bounds dim
 TEST_F(OpTransposeIntCopyTest, OutOfBoundDimDies) {
   TensorFactory<ScalarType::Float> tf;
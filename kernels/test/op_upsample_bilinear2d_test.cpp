@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::OptionalArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpUpsampleBilinear2dTest : public OperatorTest {
+ protected:
+  Tensor& op_upsample_bilinear2d_out(
+      const Tensor& in,
+      OptionalArrayRef<int64_t> output_size,
+      bool align_corners,
+      OptionalArrayRef<double> scale_factors,
+      Tensor& out) {
+    return torch::executor::aten::upsample_bilinear2d_outf(
+        context_, in, output_size, align_corners, scale_factors, out);
+  }
+
+  template <ScalarType DTYPE>
+  void test_align_corners() {
+    TensorFactory<DTYPE> tf;
+
+    Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+    Tensor out = tf.zeros({1, 1, 3, 3});
+    int64_t output_size[] = {3, 3};
+
+    Tensor ret = op_upsample_bilinear2d_out(
+        in, ArrayRef<int64_t>(output_size, 2), true, exec_aten::nullopt, out);
+
+    // clang-format off
+    Tensor expected = tf.make({1, 1, 3, 3}, {
+      1.0, 1.5, 2.0,
+      2.0, 2.5, 3.0,
+      3.0, 3.5, 4.0});
+    // clang-format on
+    EXPECT_TENSOR_EQ(out, ret);
+    EXPECT_TENSOR_CLOSE(out, expected);
+  }
+};
+
+TEST_F(OpUpsampleBilinear2dTest, AlignCornersAllFloatTypes) {
+#define TEST_ENTRY(ctype, dtype) test_align_corners<ScalarType::dtype>();
+  ET_FORALL_FLOATH_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpUpsampleBilinear2dTest, ScaleFactorsHalfPixelCenters) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+  double scale_factors[] = {2.0, 2.0};
+
+  op_upsample_bilinear2d_out(
+      in, exec_aten::nullopt, false, ArrayRef<double>(scale_factors, 2), out);
+
+  // clang-format off
+  Tensor expected = tf.make({1, 1, 4, 4}, {
+    1.00, 1.25, 1.75, 2.00,
+    1.50, 1.75, 2.25, 2.50,
+    2.50, 2.75, 3.25, 3.50,
+    3.00, 3.25, 3.75, 4.00});
+  // clang-format on
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST_F(OpUpsampleBilinear2dTest, WideRowsMatchLinearRamp) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Bilinear interpolation with aligned corners reproduces a linear function
+  // of the coordinates. The output rows span several tiles of columns.
+  const int64_t in_h = 5, in_w = 7, out_h = 9, out_w = 300;
+  std::vector<float> in_data;
+  for (int64_t c = 0; c < 2; ++c) {
+    for (int64_t h = 0; h < in_h; ++h) {
+      for (int64_t w = 0; w < in_w; ++w) {
+        in_data.push_back(c * 100 + h * 10 + w);
+      }
+    }
+  }
+  std::vector<float> expected_data;
+  for (int64_t c = 0; c < 2; ++c) {
+    for (int64_t h = 0; h < out_h; ++h) {
+      for (int64_t w = 0; w < out_w; ++w) {
+        expected_data.push_back(
+            c * 100 + 10.0 * h * (in_h - 1) / (out_h - 1) +
+            1.0 * w * (in_w - 1) / (out_w - 1));
+      }
+    }
+  }
+  Tensor in = tf.make({1, 2, in_h, in_w}, in_data);
+  Tensor out = tf.zeros({1, 2, out_h, out_w});
+  int64_t output_size[] = {out_h, out_w};
+
+  op_upsample_bilinear2d_out(
+      in, ArrayRef<int64_t>(output_size, 2), true, exec_aten::nullopt, out);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out, tf.make({1, 2, out_h, out_w}, expected_data), 1e-4, 1e-4);
+}
+
+TEST_F(OpUpsampleBilinear2dTest, SameSizeCopiesInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({2, 1, 2, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+  Tensor out = tf.zeros({2, 1, 2, 3});
+  int64_t output_size[] = {2, 3};
+
+  op_upsample_bilinear2d_out(
+      in, ArrayRef<int64_t>(output_size, 2), false, exec_aten::nullopt, out);
+
+  EXPECT_TENSOR_EQ(out, in);
+}
+
+TEST_F(OpUpsampleBilinear2dTest, ResizesOutput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 2, 3, 4});
+  Tensor out = tf.zeros(
+      {2, 2, 8, 8}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
+  double scale_factors[] = {2.0, 1.5};
+
+  op_upsample_bilinear2d_out(
+      in, exec_aten::nullopt, false, ArrayRef<double>(scale_factors, 2), out);
+
+  EXPECT_TENSOR_EQ(out, tf.ones({1, 2, 6, 6}));
+}
+
+TEST_F(OpUpsampleBilinear2dTest, BothOrNeitherSizeArgumentDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+  int64_t output_size[] = {4, 4};
+  double scale_factors[] = {2.0, 2.0};
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_bilinear2d_out(
+          in,
+          ArrayRef<int64_t>(output_size, 2),
+          false,
+          ArrayRef<double>(scale_factors, 2),
+          out));
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_bilinear2d_out(
+          in, exec_aten::nullopt, false, exec_aten::nullopt, out));
+}
+
+TEST_F(OpUpsampleBilinear2dTest, NonFourDimInputDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 2, 2});
+  Tensor out = tf.zeros({1, 4, 4});
+  int64_t output_size[] = {4, 4};
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_bilinear2d_out(
+          in,
+          ArrayRef<int64_t>(output_size, 2),
+          false,
+          exec_aten::nullopt,
+          out));
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::OptionalArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpUpsampleNearest2dTest : public OperatorTest {
+ protected:
+  Tensor& op_upsample_nearest2d_out(
+      const Tensor& in,
+      OptionalArrayRef<int64_t> output_size,
+      OptionalArrayRef<double> scale_factors,
+      Tensor& out) {
+    return torch::executor::aten::upsample_nearest2d_outf(
+        context_, in, output_size, scale_factors, out);
+  }
+
+  template <ScalarType DTYPE>
+  void test_upsample_2x() {
+    TensorFactory<DTYPE> tf;
+
+    Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+    Tensor out = tf.zeros({1, 1, 4, 4});
+    double scale_factors[] = {2.0, 2.0};
+
+    Tensor ret = op_upsample_nearest2d_out(
+        in, exec_aten::nullopt, ArrayRef<double>(scale_factors, 2), out);
+
+    // clang-format off
+    Tensor expected = tf.make({1, 1, 4, 4}, {
+      1, 1, 2, 2,
+      1, 1, 2, 2,
+      3, 3, 4, 4,
+      3, 3, 4, 4});
+    // clang-format on
+    EXPECT_TENSOR_EQ(out, ret);
+    EXPECT_TENSOR_EQ(out, expected);
+  }
+};
+
+TEST_F(OpUpsampleNearest2dTest, Upsample2xAllRealTypes) {
+#define TEST_ENTRY(ctype, dtype) test_upsample_2x<ScalarType::dtype>();
+  ET_FORALL_REALH_TYPES(TEST_ENTRY);
+#undef TEST_ENTRY
+}
+
+TEST_F(OpUpsampleNearest2dTest, FractionalOutputSize) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 1, 3, 5});
+  int64_t output_size[] = {3, 5};
+
+  op_upsample_nearest2d_out(
+      in, ArrayRef<int64_t>(output_size, 2), exec_aten::nullopt, out);
+
+  // clang-format off
+  Tensor expected = tf.make({1, 1, 3, 5}, {
+    1, 1, 1, 2, 2,
+    1, 1, 1, 2, 2,
+    3, 3, 3, 4, 4});
+  // clang-format on
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST_F(OpUpsampleNearest2dTest, Downsample) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make(
+      {1, 1, 4, 4}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
+  Tensor out = tf.zeros({1, 1, 2, 2});
+  double scale_factors[] = {0.5, 0.5};
+
+  op_upsample_nearest2d_out(
+      in, exec_aten::nullopt, ArrayRef<double>(scale_factors, 2), out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({1, 1, 2, 2}, {0, 2, 8, 10}));
+}
+
+TEST_F(OpUpsampleNearest2dTest, WideRowsAndSameWidth) {
+  TensorFactory<ScalarType::Int> tf;
+
+  // The output rows span several tiles of columns.
+  const int64_t in_h = 3, in_w = 200;
+  std::vector<int32_t> in_data;
+  for (int64_t c = 0; c < 2; ++c) {
+    for (int64_t h = 0; h < in_h; ++h) {
+      for (int64_t w = 0; w < in_w; ++w) {
+        in_data.push_back(c * 1000 + h * in_w + w);
+      }
+    }
+  }
+  Tensor in = tf.make({1, 2, in_h, in_w}, in_data);
+
+  std::vector<int32_t> expected_2x;
+  std::vector<int32_t> expected_rows;
+  for (int64_t c = 0; c < 2; ++c) {
+    for (int64_t h = 0; h < 2 * in_h; ++h) {
+      for (int64_t w = 0; w < 2 * in_w; ++w) {
+        expected_2x.push_back(c * 1000 + (h / 2) * in_w + w / 2);
+      }
+      for (int64_t w = 0; w < in_w; ++w) {
+        expected_rows.push_back(c * 1000 + (h / 2) * in_w + w);
+      }
+    }
+  }
+
+  Tensor out = tf.zeros({1, 2, 2 * in_h, 2 * in_w});
+  int64_t output_size[] = {2 * in_h, 2 * in_w};
+  op_upsample_nearest2d_out(
+      in, ArrayRef<int64_t>(output_size, 2), exec_aten::nullopt, out);
+  EXPECT_TENSOR_EQ(out, tf.make({1, 2, 2 * in_h, 2 * in_w}, expected_2x));
+
+  Tensor out_rows = tf.zeros({1, 2, 2 * in_h, in_w});
+  int64_t rows_size[] = {2 * in_h, in_w};
+  op_upsample_nearest2d_out(
+      in, ArrayRef<int64_t>(rows_size, 2), exec_aten::nullopt, out_rows);
+  EXPECT_TENSOR_EQ(out_rows, tf.make({1, 2, 2 * in_h, in_w}, expected_rows));
+}
+
+TEST_F(OpUpsampleNearest2dTest, MismatchedDtypeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor out = tf_int.zeros({1, 1, 4, 4});
+  int64_t output_size[] = {4, 4};
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_nearest2d_out(
+          in, ArrayRef<int64_t>(output_size, 2), exec_aten::nullopt, out));
+}
+
+TEST_F(OpUpsampleNearest2dTest, NonPositiveOutputSizeDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+  int64_t output_size[] = {0, 4};
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_nearest2d_out(
+          in, ArrayRef<int64_t>(output_size, 2), exec_aten::nullopt, out));
+}
@@ -398,3 +398,53 @@ TEST_F(OpVarCorrectionOutTest, SmokeTest) {
       x, ArrayRef<int64_t>{1}, correction, /*keepdim=*/false, out);
   EXPECT_TENSOR_CLOSE(out, expected);
 }
+
+TEST_F(OpVarOutTest, LargerTensorEachDimPasses) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Large enough for every reduction below to cover vectorized loops and
+  // their tails in optimized kernels.
+  const std::vector<int32_t> sizes = {3, 37, 300};
+  std::vector<float> data(3 * 37 * 300);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i % 7;
+  }
+  Tensor self = tf.make(sizes, data);
+
+  const std::vector<std::vector<int64_t>> dim_lists = {{0}, {1}, {2}, {0, 2}};
+  for (const auto& dims : dim_lists) {
+    std::vector<int32_t> out_sizes = sizes;
+    int32_t num = 1;
+    for (const auto d : dims) {
+      out_sizes[d] = 1;
+      num *= sizes[d];
+    }
+    const size_t out_numel = out_sizes[0] * out_sizes[1] * out_sizes[2];
+    std::vector<double> sum(out_numel);
+    std::vector<double> sum2(out_numel);
+    for (int32_t i = 0; i < sizes[0]; ++i) {
+      for (int32_t j = 0; j < sizes[1]; ++j) {
+        for (int32_t k = 0; k < sizes[2]; ++k) {
+          const int32_t out_ix =
+              ((i % out_sizes[0]) * out_sizes[1] + j % out_sizes[1]) *
+                  out_sizes[2] +
+              k % out_sizes[2];
+          const double v = data[(i * sizes[1] + j) * sizes[2] + k];
+          sum[out_ix] += v;
+          sum2[out_ix] += v * v;
+        }
+      }
+    }
+    std::vector<float> expected(out_numel);
+    for (size_t i = 0; i < out_numel; ++i) {
+      expected[i] = (sum2[i] - sum[i] * sum[i] / num) / (num - 1);
+    }
+
+    Tensor out = tf.zeros(out_sizes);
+    optional<ArrayRef<int64_t>> optional_dim_list{
+        ArrayRef<int64_t>{dims.data(), dims.size()}};
+    op_var_out(
+        self, optional_dim_list, /*unbiased=*/true, /*keepdim=*/true, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(out_sizes, expected));
+  }
+}
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <executorch/runtime/backend/backend_options.h>
+#include <executorch/runtime/core/array_ref.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/memory_allocator.h>
 
@@ -19,10 +21,19 @@ namespace runtime {
  */
 class BackendExecutionContext final {
  public:
+  /**
+   * Waits for the work that an asynchronous execute() call left running, and
+   * returns its status.
+   */
+  using CompletionFn = Error (*)(void* completion_context);
+
   BackendExecutionContext(
       EventTracer* event_tracer = nullptr,
-      MemoryAllocator* temp_allocator = nullptr)
-      : event_tracer_(event_tracer), temp_allocator_(temp_allocator) {}
+      MemoryAllocator* temp_allocator = nullptr,
+      ArrayRef<BackendOption> backend_options = {})
+      : event_tracer_(event_tracer),
+        temp_allocator_(temp_allocator),
+        backend_options_(backend_options) {}
 
   /**
    * Returns a pointer to an instance of EventTracer to do profiling/debugging
@@ -52,9 +63,49 @@ class BackendExecutionContext final {
     return temp_allocator_;
   }
 
+  /**
+   * Returns the options that the app set on the method for this execution,
+   * see Method::set_backend_options(). They apply to every delegate of the
+   * method, so backends ignore keys they do not know.
+   */
+  ArrayRef<BackendOption> get_backend_options() const {
+    return backend_options_;
+  }
+
+  /**
+   * Lets execute() return while the backend is still running, for example on
+   * an accelerator, so that the runtime can run CPU instructions meanwhile.
+   *
+   * The runtime calls `completion_fn` exactly once, before any instruction
+   * that uses the memory of the delegate's arguments runs and before the
+   * method execution ends. Until then the backend may keep writing to its
+   * outputs, but they must already have their final sizes when execute()
+   * returns. Work that is left running must not use the temp allocator.
+   *
+   * The runtime may call `completion_fn` right away, for example while event
+   * tracing, so backends need not handle the synchronous case differently.
+   */
+  void set_completion(CompletionFn completion_fn, void* completion_context) {
+    completion_fn_ = completion_fn;
+    completion_context_ = completion_context;
+  }
+
+  /// Returns the function set by set_completion(), or nullptr.
+  CompletionFn completion_fn() const {
+    return completion_fn_;
+  }
+
+  /// Returns the context set by set_completion().
+  void* completion_context() const {
+    return completion_context_;
+  }
+
  private:
   EventTracer* event_tracer_ = nullptr;
   MemoryAllocator* temp_allocator_ = nullptr;
+  ArrayRef<BackendOption> backend_options_;
+  CompletionFn completion_fn_ = nullptr;
+  void* completion_context_ = nullptr;
 };
 
 } // namespace runtime
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Option keys that backends are encouraged to use for common tuning knobs, so
+ * that apps can tune several backends the same way. Backends define their own
+ * keys for anything else.
+ */
+/// Int: the number of threads the backend may use.
+constexpr const char kNumThreadsBackendOption[] = "num_threads";
+/// String: a backend-specific power mode, like "high_performance".
+constexpr const char kPowerModeBackendOption[] = "power_mode";
+/// String: the arithmetic precision to run at, like "fp16".
+constexpr const char kPrecisionBackendOption[] = "precision";
+/// Int: how much profiling data the backend collects. 0 disables profiling.
+constexpr const char kProfilingLevelBackendOption[] = "profiling_level";
+
+/**
+ * A runtime setting for a backend. Unlike a CompileSpec, which is fixed when
+ * the model is exported, options are chosen by the app on the device.
+ *
+ * The key, and the value of string options, are not copied: they must outlive
+ * every use of the option.
+ */
+struct BackendOption {
+  enum class Type : uint8_t {
+    Bool,
+    Int,
+    String,
+  };
+
+  const char* key;
+  Type type;
+  union {
+    bool bool_value;
+    int64_t int_value;
+    const char* string_value;
+  };
+
+  BackendOption(const char* key_, bool value)
+      : key(key_), type(Type::Bool), bool_value(value) {}
+  BackendOption(const char* key_, int64_t value)
+      : key(key_), type(Type::Int), int_value(value) {}
+  BackendOption(const char* key_, int value)
+      : key(key_), type(Type::Int), int_value(value) {}
+  BackendOption(const char* key_, const char* value)
+      : key(key_), type(Type::String), string_value(value) {}
+};
+
+namespace internal {
+inline const BackendOption* find_backend_option(
+    ArrayRef<BackendOption> options,
+    const char* key) {
+  // The last option with the key wins, so callers can append overrides.
+  for (size_t i = options.size(); i > 0; --i) {
+    if (std::strcmp(options[i - 1].key, key) == 0) {
+      return &options[i - 1];
+    }
+  }
+  return nullptr;
+}
+} // namespace internal
+
+/**
+ * Returns the value of the bool option `key`, Error::NotFound if there is
+ * none, or Error::InvalidArgument if it is not a bool.
+ */
+inline Result<bool> get_bool_backend_option(
+    ArrayRef<BackendOption> options,
+    const char* key) {
+  const BackendOption* option = internal::find_backend_option(options, key);
+  if (option == nullptr) {
+    return Error::NotFound;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      option->type == BackendOption::Type::Bool,
+      InvalidArgument,
+      "Backend option %s is not a bool",
+      key);
+  return option->bool_value;
+}
+
+/**
+ * Returns the value of the int option `key`, Error::NotFound if there is
+ * none, or Error::InvalidArgument if it is not an int.
+ */
+inline Result<int64_t> get_int_backend_option(
+    ArrayRef<BackendOption> options,
+    const char* key) {
+  const BackendOption* option = internal::find_backend_option(options, key);
+  if (option == nullptr) {
+    return Error::NotFound;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      option->type == BackendOption::Type::Int,
+      InvalidArgument,
+      "Backend option %s is not an int",
+      key);
+  return option->int_value;
+}
+
+/**
+ * Returns the value of the string option `key`, Error::NotFound if there is
+ * none, or Error::InvalidArgument if it is not a string.
+ */
+inline Result<const char*> get_string_backend_option(
+    ArrayRef<BackendOption> options,
+    const char* key) {
+  const BackendOption* option = internal::find_backend_option(options, key);
+  if (option == nullptr) {
+    return Error::NotFound;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      option->type == BackendOption::Type::String,
+      InvalidArgument,
+      "Backend option %s is not a string",
+      key);
+  return option->string_value;
+}
+
+} // namespace runtime
+} // namespace executorch
@@ -42,6 +42,13 @@ Error register_backend(const Backend& backend) {
   return getBackendRegistry().register_backend(backend);
 }
 
+Error set_backend_options(const char* name, ArrayRef<BackendOption> options) {
+  PyTorchBackendInterface* backend = get_backend_class(name);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend != nullptr, NotFound, "Backend %s is not registered.", name);
+  return backend->set_options(options);
+}
+
 Error BackendRegistry::register_backend(const Backend& backend) {
   if (registrationTableSize_ >= kRegistrationTableMaxSize) {
     return Error::Internal;
@@ -12,6 +12,7 @@
 
 #include <executorch/runtime/backend/backend_execution_context.h>
 #include <executorch/runtime/backend/backend_init_context.h>
+#include <executorch/runtime/backend/backend_options.h>
 #include <executorch/runtime/core/array_ref.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
@@ -91,7 +92,9 @@ class PyTorchBackendInterface {
    *     executable unit. This executable unit should be ready to execute the
    *     delegate blobs.
    * @param[in] args The method’s inputs and outputs.
-   * @retval Error::Ok if successful.
+   * @retval Error::Ok if successful. Backends that return before their work
+   *     finishes report its status through the function they pass to
+   *     BackendExecutionContext::set_completion().
    */
   ET_NODISCARD virtual Error execute(
       BackendExecutionContext& context,
@@ -108,6 +111,40 @@ class PyTorchBackendInterface {
    *     `init()`.
    */
   virtual void destroy(ET_UNUSED DelegateHandle* handle) const {}
+
+  /**
+   * Prepares a delegate instance for its first execution without executing
+   * it, e.g. by allocating the memory it runs in or by building state that
+   * execute() would otherwise build lazily. Called by Method::warmup(), never
+   * concurrently with execute() on the same handle.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @retval Error::Ok if successful, including when there is nothing to do.
+   */
+  ET_NODISCARD virtual Error warmup(ET_UNUSED DelegateHandle* handle) const {
+    return Error::Ok;
+  }
+
+  /**
+   * Applies runtime options, like a thread count or a power mode, to the
+   * backend. Called by set_backend_options(), possibly while other threads
+   * initialize or execute delegates, so implementations must synchronize.
+   * Options usually apply to the delegates initialized or executed afterwards.
+   *
+   * Unlike the options passed to each execution through
+   * BackendExecutionContext::get_backend_options(), these are addressed to
+   * this backend only, so unknown keys are errors.
+   *
+   * @param[in] options The options to apply. They are not used after this
+   *     call returns.
+   * @retval Error::Ok if all options were applied.
+   * @retval Error::NotSupported if the backend does not support an option.
+   * @retval Error::InvalidArgument if an option has the wrong type or an
+   *     invalid value.
+   */
+  ET_NODISCARD virtual Error set_options(ArrayRef<BackendOption> options) {
+    return options.empty() ? Error::Ok : Error::NotSupported;
+  }
 };
 
 struct Backend {
@@ -170,6 +207,17 @@ PyTorchBackendInterface* get_backend_class(const char* name);
  */
 ET_NODISCARD Error register_backend(const Backend& backend);
 
+/**
+ * Applies runtime options to the registered backend with the given name. See
+ * PyTorchBackendInterface::set_options().
+ *
+ * @param[in] name Name of the backend, as passed to register_backend().
+ * @param[in] options The options to apply.
+ * @retval Error::NotFound if no backend is registered with the name.
+ */
+ET_NODISCARD Error
+set_backend_options(const char* name, ArrayRef<BackendOption> options);
+
 } // namespace runtime
 } // namespace executorch
 
@@ -58,10 +58,32 @@ class DataLoader {
     size_t segment_index;
 
     /// An optional, null-terminated string describing the segment. For
-    /// `Backend` segments, this is the backend ID. Null for other segment
-    /// types.
+    /// `Backend` segments, this is the backend ID or the key of named data.
+    /// For `Constant` segments loaded one tensor at a time, this is the fully
+    /// qualified name of the tensor if the program records it. Null
+    /// otherwise.
     const char* descriptor;
 
+    /**
+     * How the segment is stored.
+     */
+    enum class Compression {
+      /// As is.
+      None,
+      /// A sequence of LZ4 blocks, see SegmentCompression in program.fbs.
+      Lz4Blocks,
+    };
+
+    /// How the requested data is stored. For anything but `None`, `load()`
+    /// must return the `uncompressed_size` bytes of the decompressed data
+    /// rather than the `size` bytes stored at `offset`. Loaders that can't
+    /// decompress the data return it as stored, which Program detects; see
+    /// extension/data_loader/decompressing_data_loader.h.
+    Compression compression = Compression::None;
+
+    /// The size of the decompressed data, for compressed segments.
+    size_t uncompressed_size = 0;
+
     SegmentInfo() = default;
 
     explicit SegmentInfo(
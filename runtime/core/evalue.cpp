@@ -11,12 +11,8 @@
 namespace executorch {
 namespace runtime {
 template <>
-exec_aten::ArrayRef<exec_aten::optional<exec_aten::Tensor>>
-BoxedEvalueList<exec_aten::optional<exec_aten::Tensor>>::get() const {
-  for (typename exec_aten::ArrayRef<
-           exec_aten::optional<exec_aten::Tensor>>::size_type i = 0;
-       i < wrapped_vals_.size();
-       i++) {
+void BoxedEvalueList<exec_aten::optional<exec_aten::Tensor>>::unwrap() const {
+  for (uint32_t i = 0; i < size_; i++) {
     if (wrapped_vals_[i] == nullptr) {
       unwrapped_vals_[i] = exec_aten::nullopt;
     } else {
@@ -24,8 +20,6 @@ BoxedEvalueList<exec_aten::optional<exec_aten::Tensor>>::get() const {
           wrapped_vals_[i]->to<exec_aten::optional<exec_aten::Tensor>>();
     }
   }
-  return exec_aten::ArrayRef<exec_aten::optional<exec_aten::Tensor>>{
-      unwrapped_vals_, wrapped_vals_.size()};
 }
 } // namespace runtime
 } // namespace executorch
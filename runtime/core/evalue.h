@@ -50,12 +50,13 @@ struct evalue_to_ref_overload_return<exec_aten::Tensor> {
  * value table is element 2 in the list, but during execution the value in
  * element 2 changes (in the case of tensor this means the TensorImpl* stored in
  * the tensor changes). To solve this instead they must be created dynamically
- * whenever they are used.
+ * whenever they are used, unless the owner of the values table knows that they
+ * will not change and caches the list, see cache().
  */
 template <typename T>
 class BoxedEvalueList {
  public:
-  BoxedEvalueList() = default;
+  BoxedEvalueList() : size_(0), cached_(false) {}
   /*
    * Wrapped_vals is a list of pointers into the values table of the runtime
    * whose destinations correlate with the elements of the list, unwrapped_vals
@@ -63,22 +64,59 @@ class BoxedEvalueList {
    * unwrapped vals.
    */
   BoxedEvalueList(EValue** wrapped_vals, T* unwrapped_vals, int size)
-      : wrapped_vals_(wrapped_vals, size), unwrapped_vals_(unwrapped_vals) {}
+      : wrapped_vals_(wrapped_vals),
+        size_(static_cast<uint32_t>(size)),
+        cached_(false),
+        unwrapped_vals_(unwrapped_vals) {}
   /*
-   * Constructs and returns the list of T specified by the EValue pointers
+   * Constructs and returns the list of T specified by the EValue pointers, or
+   * returns the cached list without touching them if cache() was called.
    */
-  exec_aten::ArrayRef<T> get() const;
+  exec_aten::ArrayRef<T> get() const {
+    if (!cached_) {
+      unwrap();
+    }
+    return exec_aten::ArrayRef<T>{unwrapped_vals_, size_};
+  }
+
+  /*
+   * Unwraps the list now and makes get() return it as is from then on. Only
+   * valid while the EValues of the list keep their values, or if refresh() is
+   * called after they change.
+   */
+  void cache() {
+    unwrap();
+    cached_ = 1;
+  }
+
+  /*
+   * Unwraps a cached list again, after some of its EValues changed.
+   */
+  void refresh() {
+    if (cached_) {
+      unwrap();
+    }
+  }
+
+  bool cached() const {
+    return cached_ != 0;
+  }
 
  private:
-  // Source of truth for the list
-  exec_aten::ArrayRef<EValue*> wrapped_vals_;
+  // Writes the unwrapped EValues to unwrapped_vals_.
+  void unwrap() const;
+
+  // Source of truth for the list, size_ elements. Not an ArrayRef so that the
+  // cached flag fits in the size and EValue does not grow.
+  EValue** wrapped_vals_ = nullptr;
+  uint32_t size_ : 31;
+  uint32_t cached_ : 1;
   // Same size as wrapped_vals
-  mutable T* unwrapped_vals_;
+  mutable T* unwrapped_vals_ = nullptr;
 };
 
 template <>
-exec_aten::ArrayRef<exec_aten::optional<exec_aten::Tensor>>
-BoxedEvalueList<exec_aten::optional<exec_aten::Tensor>>::get() const;
+void BoxedEvalueList<exec_aten::optional<exec_aten::Tensor>>::unwrap() const;
 
 // Aggregate typing system similar to IValue only slimmed down with less
 // functionality, no dependencies on atomic, and fewer supported types to better
@@ -507,14 +545,11 @@ EVALUE_DEFINE_TO(
 #undef EVALUE_DEFINE_TO
 
 template <typename T>
-exec_aten::ArrayRef<T> BoxedEvalueList<T>::get() const {
-  for (typename exec_aten::ArrayRef<T>::size_type i = 0;
-       i < wrapped_vals_.size();
-       i++) {
+void BoxedEvalueList<T>::unwrap() const {
+  for (uint32_t i = 0; i < size_; i++) {
     ET_CHECK(wrapped_vals_[i] != nullptr);
     unwrapped_vals_[i] = wrapped_vals_[i]->template to<T>();
   }
-  return exec_aten::ArrayRef<T>{unwrapped_vals_, wrapped_vals_.size()};
 }
 
 } // namespace runtime
@@ -389,6 +389,26 @@ class EventTracer {
     debug_handle_ = debug_handle;
   }
 
+  /**
+   * Sets the work done by the operator call being executed, to be recorded by
+   * the event tracer with the next profiling event that ends, i.e. the
+   * OPERATOR_CALL event of the call. Method sets it from the cost functions
+   * registered with register_op_costs(), after the kernel returns.
+   *
+   * @param[in] flops Arithmetic operations done by the call.
+   * @param[in] bytes_read Bytes of tensor data read by the call.
+   * @param[in] bytes_written Bytes of tensor data written by the call.
+   */
+  void set_op_cost(
+      uint64_t flops,
+      uint64_t bytes_read,
+      uint64_t bytes_written) {
+    has_op_cost_ = true;
+    op_cost_flops_ = flops;
+    op_cost_bytes_read_ = bytes_read;
+    op_cost_bytes_written_ = bytes_written;
+  }
+
   /**
    * When running a program wrapped in a bundled program, log the bundled input
    * index of the current bundled input being tested out on this method.
@@ -458,6 +478,12 @@ class EventTracer {
   int bundled_input_index_ = kUnsetBundledInputIndex;
   EventTracerDebugLogLevel event_tracer_debug_level_ =
       EventTracerDebugLogLevel::kNoLogging;
+  // Set by set_op_cost(). Implementations that record it should clear
+  // has_op_cost_ when they do.
+  bool has_op_cost_ = false;
+  uint64_t op_cost_flops_ = 0;
+  uint64_t op_cost_bytes_read_ = 0;
+  uint64_t op_cost_bytes_written_ = 0;
 };
 
 } // namespace runtime
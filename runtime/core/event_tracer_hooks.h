@@ -33,6 +33,26 @@ namespace executorch {
 namespace runtime {
 namespace internal {
 
+/// Whether the hooks in this file are compiled in.
+#ifdef ET_EVENT_TRACER_ENABLED
+constexpr bool kEventTracerEnabled = true;
+#else //! ET_EVENT_TRACER_ENABLED
+constexpr bool kEventTracerEnabled = false;
+#endif
+
+/**
+ * Returns the EventTracer to hand to kernels and delegates: event_tracer when
+ * the hooks are compiled in, and a constant nullptr otherwise.
+ *
+ * Without ET_EVENT_TRACER_ENABLED every hook is a no-op, so the pointer is
+ * never used. Passing a constant instead lets the compiler drop the load of
+ * the pointer from the execution loop, and fold away the null checks of
+ * callees that are inlined.
+ */
+inline EventTracer* event_tracer_if_enabled(EventTracer* event_tracer) {
+  return kEventTracerEnabled ? event_tracer : nullptr;
+}
+
 /**
  * This class enables scope based profiling where needed using RAII.
  * Profiling will be started when the object is created and will end
@@ -238,6 +258,24 @@ inline void event_tracer_log_evalue_output(
 #endif
 }
 
+/// Set the work done by the operator call being executed.
+inline void event_tracer_set_op_cost(
+    EventTracer* event_tracer,
+    uint64_t flops,
+    uint64_t bytes_read,
+    uint64_t bytes_written) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  if (event_tracer) {
+    event_tracer->set_op_cost(flops, bytes_read, bytes_written);
+  }
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+  (void)flops;
+  (void)bytes_read;
+  (void)bytes_written;
+#endif
+}
+
 // Set the bundled input index of the current bundled input being used by the
 // method.
 inline void event_tracer_set_bundled_input_index(
@@ -868,11 +868,19 @@ inline exec_aten::ScalarType promoteTypes(
 //
 
 #ifdef ET_INTERNAL_CHECK_SELECTIVE_BUILD
-#define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)  \
-  case enum_type: {                                           \
-    ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type);             \
-    using CTYPE_ALIAS = ScalarTypeToCppType<enum_type>::type; \
-    return __VA_ARGS__();                                     \
+// With dtype selective build, the case of a dtype that was not selected for
+// the operator is discarded at compile time, so that the kernel code for it
+// is never generated, whatever the optimization level. Reaching it at runtime
+// aborts.
+#define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)                \
+  case enum_type: {                                                         \
+    if constexpr (should_include_kernel_dtype(et_switch_name, enum_type)) { \
+      using CTYPE_ALIAS = ScalarTypeToCppType<enum_type>::type;             \
+      return __VA_ARGS__();                                                 \
+    } else {                                                                \
+      ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type);                         \
+      break;                                                                \
+    }                                                                       \
   }
 #else
 #define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)  \
@@ -1001,6 +1009,14 @@ inline exec_aten::ScalarType promoteTypes(
   ET_INTERNAL_SWITCH_CASE(                                                    \
       exec_aten::ScalarType::ADDITIONAL, CTYPE_ALIAS, __VA_ARGS__)
 
+#define ET_INTERNAL_SWITCH_CASE_FLOAT_TYPES_AND2(                   \
+    ADDITIONAL1, ADDITIONAL2, CTYPE_ALIAS, ...)                     \
+  ET_INTERNAL_SWITCH_CASE_FLOAT_TYPES(CTYPE_ALIAS, __VA_ARGS__)     \
+  ET_INTERNAL_SWITCH_CASE(                                          \
+      exec_aten::ScalarType::ADDITIONAL1, CTYPE_ALIAS, __VA_ARGS__) \
+  ET_INTERNAL_SWITCH_CASE(                                          \
+      exec_aten::ScalarType::ADDITIONAL2, CTYPE_ALIAS, __VA_ARGS__)
+
 #define ET_INTERNAL_SWITCH_CASE_QINT_TYPES(CTYPE_ALIAS, ...)     \
   ET_INTERNAL_SWITCH_CASE(                                       \
       exec_aten::ScalarType::QInt8, CTYPE_ALIAS, __VA_ARGS__)    \
@@ -1154,9 +1170,22 @@ inline exec_aten::ScalarType promoteTypes(
       ET_INTERNAL_SWITCH_CASE_FLOAT_TYPES_AND(         \
           ADDITIONAL, CTYPE_ALIAS, __VA_ARGS__))
 
+#define ET_SWITCH_FLOAT_TYPES_AND2(                                  \
+    ADDITIONAL1, ADDITIONAL2, TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
+  ET_INTERNAL_SWITCH(                                                \
+      TYPE,                                                          \
+      CONTEXT,                                                       \
+      NAME,                                                          \
+      ET_INTERNAL_SWITCH_CASE_FLOAT_TYPES_AND2(                      \
+          ADDITIONAL1, ADDITIONAL2, CTYPE_ALIAS, __VA_ARGS__))
+
 #define ET_SWITCH_FLOATH_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
   ET_SWITCH_FLOAT_TYPES_AND(Half, TYPE, CONTEXT, NAME, CTYPE_ALIAS, __VA_ARGS__)
 
+#define ET_SWITCH_FLOATHBF16_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
+  ET_SWITCH_FLOAT_TYPES_AND2(                                             \
+      Half, BFloat16, TYPE, CONTEXT, NAME, CTYPE_ALIAS, __VA_ARGS__)
+
 #define ET_SWITCH_QINT_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
   ET_INTERNAL_SWITCH(                                               \
       TYPE,                                                         \
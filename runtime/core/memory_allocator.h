@@ -150,6 +150,16 @@ class MemoryAllocator {
     return size_;
   }
 
+  /**
+   * Returns the number of bytes handed out since construction or the last
+   * reset(), including padding added for alignment. A buffer of this size
+   * would have been large enough for all of those allocations. Subclasses that
+   * do not allocate from the base buffer should override this.
+   */
+  virtual size_t used_size() const {
+    return static_cast<size_t>(cur_ - begin_);
+  }
+
   // Resets the current pointer to the base address. It does nothing to
   // the contents.
   virtual void reset() {
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Data that a program stores once and that any of its delegates can look up
+ * by key, such as weights that the delegates of several methods share.
+ */
+class NamedDataMap {
+ public:
+  virtual ~NamedDataMap() = default;
+
+  /**
+   * Loads the data stored under `key`.
+   *
+   * Delegates that process the data, for example by packing weights, can use
+   * the key to share the result between their instances.
+   *
+   * @param[in] key The key of the data.
+   *
+   * @returns The data, owned by the caller, on success.
+   * @retval Error::NotFound There is no data stored under `key`.
+   */
+  ET_NODISCARD virtual Result<FreeableBuffer> get_data(
+      const char* key) const = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
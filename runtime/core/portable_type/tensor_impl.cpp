@@ -93,6 +93,12 @@ Error TensorImpl::internal_resize_contiguous(ArrayRef<SizesType> new_sizes) {
       // TODO(T175194371): Unbounded dynamic tensor resizing is not yet
       // supported: treat them as upper-bounded.
     case TensorShapeDynamism::DYNAMIC_UNBOUND: {
+      // Shapes usually repeat across executions, e.g. when serving a few
+      // bucketed input sizes, so the out tensor often already has the
+      // requested size and its numel and strides are up to date.
+      if (std::equal(sizes_, sizes_ + dim_, new_sizes.begin())) {
+        return Error::Ok;
+      }
       const auto new_numel = compute_numel(new_sizes.data(), dim_);
       ET_CHECK_OR_RETURN_ERROR(
           new_numel <= numel_bound_,
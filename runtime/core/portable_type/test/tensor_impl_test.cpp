@@ -191,6 +191,42 @@ TEST_F(TensorImplTest, TestSetSizesContigUpperBounded) {
   EXPECT_NE(err, Error::Ok);
 }
 
+TEST_F(TensorImplTest, TestSetSizesContigSameSizes) {
+  SizesType sizes[2] = {3, 2};
+  DimOrderType dim_order[2] = {0, 1};
+  StridesType strides[2] = {2, 1};
+  float data[6] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  TensorImpl t(
+      ScalarType::Float,
+      2,
+      sizes,
+      data,
+      dim_order,
+      strides,
+      TensorShapeDynamism::DYNAMIC_BOUND);
+
+  SizesType new_sizes_1[2] = {1, 4};
+  Error err = resize_tensor_impl(&t, {new_sizes_1, 2});
+  EXPECT_EQ(err, Error::Ok);
+
+  // Resizing again to the same sizes keeps the numel and strides.
+  SizesType new_sizes_2[2] = {1, 4};
+  err = resize_tensor_impl(&t, {new_sizes_2, 2});
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_EQ(t.numel(), 4);
+  auto strides_ref = t.strides();
+  EXPECT_EQ(strides_ref[0], 4);
+  EXPECT_EQ(strides_ref[1], 1);
+
+  // Even when they match the original sizes.
+  SizesType new_sizes_3[2] = {3, 2};
+  err = resize_tensor_impl(&t, {new_sizes_3, 2});
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_EQ(t.numel(), 6);
+  EXPECT_EQ(strides_ref[0], 2);
+  EXPECT_EQ(strides_ref[1], 1);
+}
+
 TEST_F(TensorImplTest, TestZeroDimSetEmptySizesContig) {
   SizesType sizes[0] = {};
   DimOrderType dim_order[0] = {};
@@ -164,6 +164,32 @@ TEST(TestEValue, BoxedEvalueList) {
   EXPECT_EQ(unwrapped[2], 3);
 }
 
+TEST(TestEValue, CachedBoxedEvalueList) {
+  EValue values[2] = {EValue((int64_t)1), EValue((int64_t)2)};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  int64_t storage[2] = {0, 0};
+  BoxedEvalueList<int64_t> x{values_p, storage, 2};
+  EXPECT_FALSE(x.cached());
+
+  x.cache();
+  EXPECT_TRUE(x.cached());
+  EXPECT_EQ(x.get()[1], 2);
+
+  // A cached list does not see changes to its values until refreshed.
+  values[1] = EValue((int64_t)5);
+  EXPECT_EQ(x.get()[1], 2);
+  x.refresh();
+  EXPECT_EQ(x.get()[1], 5);
+
+  // The flag is copied with the list, and does not grow EValue.
+  EValue e(x);
+  EXPECT_TRUE(e.payload.copyable_union.as_int_list.cached());
+  EXPECT_EQ(e.toIntList()[1], 5);
+  EXPECT_EQ(
+      sizeof(BoxedEvalueList<int64_t>),
+      sizeof(exec_aten::ArrayRef<EValue*>) + sizeof(int64_t*));
+}
+
 TEST(TestEValue, toOptionalTensorList) {
   // create list, empty evalue ctor gets tag::None
   EValue values[2] = {EValue(), EValue()};
@@ -280,5 +280,16 @@ TEST(TestEventTracer, SimpleEventTracerTestLogging) {
   event_tracer_log_evalue_output(nullptr, test_eval);
 }
 
+TEST(TestEventTracer, EventTracerIfEnabled) {
+  using executorch::runtime::internal::event_tracer_if_enabled;
+  using executorch::runtime::internal::kEventTracerEnabled;
+
+  // The hooks are compiled in for this test, so the tracer is passed through.
+  static_assert(kEventTracerEnabled, "ET_EVENT_TRACER_ENABLED is defined");
+  DummyEventTracer dummy;
+  EXPECT_EQ(event_tracer_if_enabled(&dummy), &dummy);
+  EXPECT_EQ(event_tracer_if_enabled(nullptr), nullptr);
+}
+
 // TODO(T163645377): Add more test coverage to log and verify events passed into
 // DummyTracer.
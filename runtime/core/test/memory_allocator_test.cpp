@@ -96,6 +96,26 @@ TEST_F(MemoryAllocatorTest, MemoryAllocatorTooLargeFailButSucceedAfterwards) {
   ASSERT_NE(nullptr, allocator.allocate(kPoolSize - 1, /*alignment=*/1));
 }
 
+TEST_F(MemoryAllocatorTest, UsedSizeTracksAllocations) {
+  alignas(16) uint8_t mem_pool[64];
+  MemoryAllocator allocator(sizeof(mem_pool), mem_pool);
+  EXPECT_EQ(allocator.used_size(), 0);
+
+  ASSERT_NE(nullptr, allocator.allocate(3, /*alignment=*/1));
+  EXPECT_EQ(allocator.used_size(), 3);
+
+  // Alignment padding counts towards the used size.
+  ASSERT_NE(nullptr, allocator.allocate(4, /*alignment=*/16));
+  EXPECT_EQ(allocator.used_size(), 20);
+
+  // Failed allocations do not.
+  ASSERT_EQ(nullptr, allocator.allocate(64, /*alignment=*/1));
+  EXPECT_EQ(allocator.used_size(), 20);
+
+  allocator.reset();
+  EXPECT_EQ(allocator.used_size(), 0);
+}
+
 template <typename T>
 static void test_allocate_instance() {
   std::array<uint8_t, 256> buffer;
@@ -9,8 +9,10 @@
 #include <executorch/runtime/executor/method.h>
 
 #include <cinttypes> // @donotremove
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
@@ -37,6 +39,18 @@ namespace runtime {
 // @lint-ignore CLANGTIDY facebook-hte-ShadowingClass
 class BackendDelegate final {
  public:
+  /**
+   * The state that Init() gathers from the program before it calls the
+   * backend's init() method.
+   */
+  struct Prepared {
+    const char* backend_id;
+    PyTorchBackendInterface* backend;
+    FreeableBuffer processed;
+    CompileSpec* compile_specs;
+    size_t num_compile_specs;
+  };
+
   /**
    * Initializes an already-allocated BackendDelegate from its serialized
    * representation.
@@ -54,6 +68,33 @@ class BackendDelegate final {
       const Program* program,
       BackendInitContext& backend_init_context,
       BackendDelegate* out) {
+    Prepared prepared;
+    Error err = Prepare(delegate, program, backend_init_context, &prepared);
+    if (err != Error::Ok) {
+      return err;
+    }
+    return Init(prepared, backend_init_context, out);
+  }
+
+  /**
+   * Looks up the backend of a delegate, and loads its data and compile specs
+   * from the program. Uses the program's data loader and the allocator of
+   * `backend_init_context`, so must not run concurrently with other calls
+   * that use them.
+   *
+   * @param[in] delegate The serialized backend delegate to load.
+   * @param[in] program The serialized program to load from.
+   * @param[in] backend_init_context The context that provides the allocator.
+   * @param[out] out The prepared state to pass to Init(). On failure, nothing
+   *     needs to be freed.
+   *
+   * @returns Error::Ok on success, or an error otherwise.
+   */
+  static Error Prepare(
+      const executorch_flatbuffer::BackendDelegate& delegate,
+      const Program* program,
+      BackendInitContext& backend_init_context,
+      Prepared* out) {
     // Look up the backend.
     ET_CHECK_OR_RETURN_ERROR(
         delegate.id() != nullptr, InvalidProgram, "Missing backend id");
@@ -85,24 +126,51 @@ class BackendDelegate final {
       ET_LOG(Error, "Failed to get compile specs for backend %s", backend_id);
       return err;
     }
-    size_t num_compile_specs = delegate.compile_specs()->size();
 
-    out->backend_ = backend;
+    out->backend_id = backend_id;
+    out->backend = backend;
+    // FreeableBuffer can't be assigned, so replace the empty one in place.
+    out->processed.~FreeableBuffer();
+    new (&out->processed) FreeableBuffer(std::move(processed_data.get()));
+    out->compile_specs = compile_specs;
+    out->num_compile_specs = delegate.compile_specs()->size();
+    return Error::Ok;
+  }
+
+  /**
+   * Initializes an already-allocated BackendDelegate by calling the backend's
+   * init() method. Calls for different delegates may run concurrently if the
+   * allocator of `backend_init_context` supports it.
+   *
+   * @param[in] prepared The state returned by Prepare(). Its data moves into
+   *     `out`, or is freed on failure.
+   * @param[in] backend_init_context The context pointer to pass to the
+   *     backend's init() method.
+   * @param[out] out The BackendDelegate to initialize.
+   *
+   * @returns Error::Ok if the initialization succeeded, or an error otherwise.
+   */
+  static Error Init(
+      Prepared& prepared,
+      BackendInitContext& backend_init_context,
+      BackendDelegate* out) {
+    out->backend_ = prepared.backend;
     out->handle_ = nullptr;
     // Pass a pointer to this buffer to the backend. It's safe for the backend
     // to point its handle to this object, since it will outlive the backend.
-    new (&out->segment_) FreeableBuffer(std::move(processed_data.get()));
+    new (&out->segment_) FreeableBuffer(std::move(prepared.processed));
 
     // Initialize the delegate.
-    Result<DelegateHandle*> handle = backend->init(
+    Result<DelegateHandle*> handle = prepared.backend->init(
         backend_init_context,
         &out->segment_,
-        ArrayRef<CompileSpec>(compile_specs, num_compile_specs));
+        ArrayRef<CompileSpec>(
+            prepared.compile_specs, prepared.num_compile_specs));
     if (!handle.ok()) {
       ET_LOG(
           Error,
           "Init failed for backend %s: 0x%" PRIx32,
-          backend_id,
+          prepared.backend_id,
           static_cast<uint32_t>(handle.error()));
       out->segment_.Free();
       return handle.error();
@@ -124,6 +192,10 @@ class BackendDelegate final {
     return backend_->execute(backend_execution_context, handle_, args);
   }
 
+  Error Warmup() const {
+    return backend_->warmup(handle_);
+  }
+
  private:
   // Not constructible.
   BackendDelegate() = delete;
@@ -202,6 +274,38 @@ class BackendDelegate final {
   DelegateHandle* handle_;
 };
 
+/**
+ * An instruction decoded from its flatbuffer representation at init time, so
+ * that executing it does not need to touch the flatbuffer.
+ */
+struct Instruction {
+  executorch_flatbuffer::InstructionArguments type;
+  /// KernelCall: the resolved kernel.
+  OpFunction kernel;
+  /// KernelCall: the unboxed entry point of the kernel and its arguments, as
+  /// bound at init time, or null if the kernel must be called through
+  /// `kernel`. See OpBindFunction.
+  BoundOpFunction bound_kernel;
+  void** bound_args;
+  /// KernelCall, DelegateCall: the list of parameters for the call.
+  InstructionArgs args;
+  /// DelegateCall: the delegate index. JumpFalseCall: the condition value
+  /// index. MoveCall: the source value index. FreeCall: the value index.
+  size_t index;
+  /// JumpFalseCall: the destination instruction index. MoveCall: the
+  /// destination value index. KernelCall with loop_back_edge: the
+  /// destination of the JumpFalseCall that follows it.
+  size_t target;
+  /// KernelCall: whether the call compares a loop counter to the trip count
+  /// for the JumpFalseCall right after it, which is how loops are emitted.
+  /// The comparison and the jump are then done in place of the two
+  /// instructions. See mark_loop_back_edges().
+  bool loop_back_edge;
+  /// The most temp allocator memory that one execution of the instruction has
+  /// used so far, in bytes.
+  size_t temp_memory_peak;
+};
+
 /**
  * Runtime state for a chain of instructions.
  */
@@ -209,14 +313,34 @@ struct Chain {
   /// Pointer to the associated flatbuffer chain.
   const executorch_flatbuffer::Chain* s_chain_;
 
-  /// Each entry is a list of parameters for a kernel or delegate call.
-  Span<InstructionArgs> argument_lists_;
-  /// Each instruction will have one kernel (not for delegate).
-  OpFunction* kernels_;
+  /// The decoded instructions of the chain, validated at init time.
+  Span<Instruction> instructions_;
+
+  /// Instruction indices in the order used by parallel execution. Consecutive
+  /// entries that belong to the same group may run at the same time. Null if
+  /// the chain must always run sequentially.
+  uint32_t* parallel_order_;
+  /// End offset into parallel_order_ of each group.
+  uint32_t* parallel_group_ends_;
+  size_t n_parallel_groups_;
 };
 
 namespace {
 
+/// Lets delegates look up the named data of the program while they initialize.
+class ProgramNamedDataMap final : public NamedDataMap {
+ public:
+  explicit ProgramNamedDataMap(const Program* program) : program_(program) {}
+
+  ET_NODISCARD Result<FreeableBuffer> get_data(
+      const char* key) const override {
+    return program_->get_named_data(key);
+  }
+
+ private:
+  const Program* program_;
+};
+
 Result<InstructionArgs> gen_instruction_arguments(
     MemoryAllocator* method_allocator,
     size_t num_values,
@@ -277,8 +401,476 @@ Result<bool> parse_cond_value(const EValue& cond_value) {
   return true;
 }
 
+/**
+ * Sets Instruction::loop_back_edge on the `executorch_prim::eq.Scalar` calls
+ * of `chain` that only decide the JumpFalseCall right after them, e.g. the
+ * `iteration_index == sym_size` check at the end of each iteration of a
+ * control_flow.map loop.
+ */
+void mark_loop_back_edges(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const EValue* values,
+    Chain& chain) {
+  const auto& instructions = chain.instructions_;
+  for (size_t i = 0; i + 1 < instructions.size(); ++i) {
+    Instruction& instruction = instructions[i];
+    const Instruction& jump = instructions[i + 1];
+    if (instruction.type !=
+            executorch_flatbuffer::InstructionArguments::KernelCall ||
+        jump.type !=
+            executorch_flatbuffer::InstructionArguments::JumpFalseCall ||
+        instruction.args.size() != 3 ||
+        instruction.args[2] != &values[jump.index]) {
+      continue;
+    }
+    const auto op = plan->operators()->Get(chain.s_chain_->instructions()
+                                               ->Get(i)
+                                               ->instr_args_as_KernelCall()
+                                               ->op_index());
+    if (std::strcmp(op->name()->c_str(), "executorch_prim::eq") == 0 &&
+        std::strcmp(op->overload()->c_str(), "Scalar") == 0) {
+      instruction.loop_back_edge = true;
+      instruction.target = jump.target;
+    }
+  }
+}
+
+/// Maximum number of consecutive KernelCall instructions that are scheduled
+/// together for parallel execution. Bounds the cost of building the schedule,
+/// which is quadratic in this value.
+constexpr size_t kMaxParallelWindow = 64;
+
+/// Maximum number of kernel calls that run at the same time.
+constexpr size_t kMaxParallelKernels = 16;
+
+/// Alignment of the temp allocator slice given to each concurrent kernel.
+constexpr size_t kParallelTempAlignment = 16;
+
+/**
+ * Returns the number of bytes that the serialized tensor may use. Uses the
+ * serialized sizes so that dynamic-shape tensors report their full capacity,
+ * regardless of their current shape.
+ */
+size_t get_serialized_nbytes(const executorch_flatbuffer::Tensor* s_tensor) {
+  const auto sizes = s_tensor->sizes();
+  size_t numel = 1;
+  if (sizes != nullptr) {
+    for (size_t i = 0; i < sizes->size(); ++i) {
+      numel *= static_cast<size_t>(sizes->Get(i));
+    }
+  }
+  const auto scalar_type =
+      static_cast<exec_aten::ScalarType>(s_tensor->scalar_type());
+  return numel * elementSize(scalar_type);
+}
+
+/**
+ * Where the data of one tensor value may live, as seen by the parallel
+ * scheduler. Only the serialized plan is used, never the current data
+ * pointers, so the schedule stays valid when set_input(), share_input(),
+ * set_output_data_ptr() or a memory plan bucket later point tensors elsewhere.
+ */
+struct TensorExtent {
+  size_t value_index;
+  /// Whether the tensor belongs to a method input or output. The user provides
+  /// their memory, and Method::io_tensors_disjoint() checks before each
+  /// parallel execution that distinct ones do not share any.
+  bool is_io;
+  /// Whether the tensor is neither an input or output, nor memory-planned, nor
+  /// constant. Nothing is known about its memory, so it may share memory with
+  /// any input, output or other such tensor.
+  bool is_external;
+  /// The allocation of the tensor in the base memory plan, or nullptr if it is
+  /// not memory-planned.
+  const executorch_flatbuffer::AllocationDetails* allocation;
+  size_t nbytes;
+};
+
+/**
+ * Returns the extent of the tensor at `value_index`. `io` holds one bit per
+ * value, set for the tensors of the method inputs and outputs.
+ */
+TensorExtent get_tensor_extent(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const uint8_t* io,
+    size_t value_index) {
+  const auto s_tensor = plan->values()->Get(value_index)->val_as_Tensor();
+  TensorExtent extent{
+      value_index,
+      ((io[value_index / 8] >> (value_index % 8)) & 1) != 0,
+      false,
+      s_tensor->allocation_info(),
+      get_serialized_nbytes(s_tensor)};
+  extent.is_external = !extent.is_io && extent.allocation == nullptr &&
+      s_tensor->data_buffer_idx() == 0;
+  return extent;
+}
+
+/// Returns the allocation that `bucket` gives the tensor at `value_index`.
+const executorch_flatbuffer::AllocationDetails* get_bucket_allocation(
+    const executorch_flatbuffer::MemoryPlanBucket* bucket,
+    const TensorExtent& extent) {
+  const auto* value_indices = bucket->value_indices();
+  for (size_t i = 0; value_indices != nullptr && i < value_indices->size();
+       ++i) {
+    if (static_cast<size_t>(value_indices->Get(i)) == extent.value_index) {
+      return bucket->allocations()->Get(i);
+    }
+  }
+  return extent.allocation;
+}
+
+bool allocations_overlap(
+    const executorch_flatbuffer::AllocationDetails* a,
+    size_t a_nbytes,
+    const executorch_flatbuffer::AllocationDetails* b,
+    size_t b_nbytes) {
+  if (a->memory_id() != b->memory_id()) {
+    return false;
+  }
+  const uint64_t a_offset = (uint64_t(a->memory_offset_high()) << 32) |
+      a->memory_offset_low();
+  const uint64_t b_offset = (uint64_t(b->memory_offset_high()) << 32) |
+      b->memory_offset_low();
+  return a_offset < b_offset + b_nbytes && b_offset < a_offset + a_nbytes;
+}
+
+/**
+ * Returns true if the two tensors may share memory during some execution.
+ * Memory provided by the user is assumed not to alias the planned memory of
+ * the method, which the method overwrites while it runs.
+ */
+bool extents_overlap(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const TensorExtent& a,
+    const TensorExtent& b) {
+  if (a.value_index == b.value_index ||
+      (a.is_external && (b.is_external || b.is_io)) ||
+      (b.is_external && a.is_io)) {
+    return true;
+  }
+  if (a.allocation == nullptr || b.allocation == nullptr) {
+    // Constant data is never written, and user memory does not alias planned
+    // memory.
+    return false;
+  }
+  if (allocations_overlap(a.allocation, a.nbytes, b.allocation, b.nbytes)) {
+    return true;
+  }
+  // Any of the memory plan buckets may be selected at execution time.
+  const auto* buckets = plan->memory_plan_buckets();
+  for (size_t i = 0; buckets != nullptr && i < buckets->size(); ++i) {
+    if (allocations_overlap(
+            get_bucket_allocation(buckets->Get(i), a),
+            a.nbytes,
+            get_bucket_allocation(buckets->Get(i), b),
+            b.nbytes)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Calls `fn(tensor_value_index)` for every tensor held by the value at
+ * `value_index`: the value itself if it is a Tensor, or the elements of a
+ * tensor list.
+ */
+template <typename Fn>
+void for_each_tensor_index(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    size_t value_index,
+    Fn fn) {
+  const auto s_value = plan->values()->Get(value_index);
+  const flatbuffers::Vector<int32_t>* items = nullptr;
+  switch (s_value->val_type()) {
+    case executorch_flatbuffer::KernelTypes::Tensor:
+      fn(value_index);
+      return;
+    case executorch_flatbuffer::KernelTypes::TensorList:
+      items = s_value->val_as_TensorList()->items();
+      break;
+    case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+      items = s_value->val_as_OptionalTensorList()->items();
+      break;
+    default:
+      return;
+  }
+  for (size_t i = 0; i < items->size(); ++i) {
+    // Optional tensor lists use -1 for None entries.
+    if (items->Get(i) >= 0) {
+      fn(static_cast<size_t>(items->Get(i)));
+    }
+  }
+}
+
+/**
+ * Returns true if a kernel call that writes the value at index `written`
+ * cannot run at the same time as another one that uses the value at index
+ * `used`.
+ */
+bool values_conflict(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const uint8_t* io,
+    size_t written,
+    size_t used) {
+  if (written == used) {
+    return true;
+  }
+  bool conflict = false;
+  for_each_tensor_index(plan, written, [&](size_t written_tensor) {
+    if (conflict) {
+      return;
+    }
+    const TensorExtent written_extent =
+        get_tensor_extent(plan, io, written_tensor);
+    for_each_tensor_index(plan, used, [&](size_t used_tensor) {
+      if (!conflict &&
+          extents_overlap(
+              plan,
+              written_extent,
+              get_tensor_extent(plan, io, used_tensor))) {
+        conflict = true;
+      }
+    });
+  });
+  return conflict;
+}
+
+/**
+ * Returns true if the operator is an ATen out variant, which writes nothing
+ * but its out arguments. The emitter passes those last: as the last argument
+ * if there is one, or as a tensor list holding all of them.
+ *
+ * Other operators, and internal ATen ones whose names start with an
+ * underscore, may write any of their arguments, so the parallel scheduler runs
+ * them on their own.
+ */
+bool is_out_variant(const executorch_flatbuffer::Operator* op) {
+  const char* name = op->name()->c_str();
+  const char* overload =
+      op->overload() != nullptr ? op->overload()->c_str() : "";
+  static constexpr char kAtenPrefix[] = "aten::";
+  static constexpr size_t kAtenPrefixLength = sizeof(kAtenPrefix) - 1;
+  if (std::strncmp(name, kAtenPrefix, kAtenPrefixLength) != 0 ||
+      name[kAtenPrefixLength] == '_') {
+    return false;
+  }
+  const size_t overload_length = std::strlen(overload);
+  return std::strcmp(overload, "out") == 0 ||
+      (overload_length > 4 &&
+       std::strcmp(overload + overload_length - 4, "_out") == 0);
+}
+
+void mark_value_referenced(size_t value_index, uint8_t* referenced) {
+  referenced[value_index / 8] |= uint8_t(1) << (value_index % 8);
+}
+
+/**
+ * Returns true if two calls to out variants must not run at the same time:
+ * if the last argument of either one may share memory with any argument of
+ * the other.
+ */
+bool kernel_calls_conflict(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const EValue* values,
+    const uint8_t* io,
+    InstructionArgs a_args,
+    InstructionArgs b_args) {
+  if (a_args.size() == 0 || b_args.size() == 0) {
+    return true;
+  }
+  const size_t a_out = static_cast<size_t>(a_args[a_args.size() - 1] - values);
+  const size_t b_out = static_cast<size_t>(b_args[b_args.size() - 1] - values);
+  for (size_t i = 0; i < b_args.size(); ++i) {
+    if (values_conflict(
+            plan, io, a_out, static_cast<size_t>(b_args[i] - values))) {
+      return true;
+    }
+  }
+  for (size_t i = 0; i < a_args.size(); ++i) {
+    if (values_conflict(
+            plan, io, b_out, static_cast<size_t>(a_args[i] - values))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Returns true if the data of the two tensors share any bytes.
+bool tensor_data_overlaps(
+    const exec_aten::Tensor& a,
+    const exec_aten::Tensor& b) {
+  const auto* a_data = static_cast<const uint8_t*>(a.const_data_ptr());
+  const auto* b_data = static_cast<const uint8_t*>(b.const_data_ptr());
+  if (a_data == nullptr || b_data == nullptr) {
+    return false;
+  }
+  return a_data < b_data + b.nbytes() && b_data < a_data + a.nbytes();
+}
+
+/// Returns true if a tensor held by `value` shares data with `tensor`.
+bool value_data_overlaps(const EValue& value, const exec_aten::Tensor& tensor) {
+  if (value.isTensor()) {
+    return tensor_data_overlaps(value.toTensor(), tensor);
+  }
+  if (value.isTensorList()) {
+    for (const auto& t : value.toTensorList()) {
+      if (tensor_data_overlaps(t, tensor)) {
+        return true;
+      }
+    }
+  } else if (value.isListOptionalTensor()) {
+    for (const auto& t : value.toListOptionalTensor()) {
+      if (t.has_value() && tensor_data_overlaps(t.value(), tensor)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// Returns true if the two values are the same or hold tensors that share
+/// data.
+bool values_overlap(const EValue& a, const EValue& b) {
+  if (&a == &b) {
+    return true;
+  }
+  if (b.isTensor()) {
+    return value_data_overlaps(a, b.toTensor());
+  }
+  if (b.isTensorList()) {
+    for (const auto& t : b.toTensorList()) {
+      if (value_data_overlaps(a, t)) {
+        return true;
+      }
+    }
+  } else if (b.isListOptionalTensor()) {
+    for (const auto& t : b.toListOptionalTensor()) {
+      if (t.has_value() && value_data_overlaps(a, t.value())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// Returns true if any argument of `a` overlaps any argument of `b`.
+bool args_overlap(InstructionArgs a, InstructionArgs b) {
+  for (size_t i = 0; i < a.size(); ++i) {
+    for (size_t j = 0; j < b.size(); ++j) {
+      if (values_overlap(*a[i], *b[j])) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Task state for one delegate initialized by init_delegates_in_parallel().
+ */
+struct ParallelDelegateInit {
+  BackendDelegate::Prepared prepared;
+  BackendInitContext* backend_init_context;
+  BackendDelegate* out;
+  Error error;
+};
+
+void run_parallel_delegate_init(void* context, size_t task_index) {
+  auto& task = static_cast<ParallelDelegateInit*>(context)[task_index];
+  task.error =
+      BackendDelegate::Init(task.prepared, *task.backend_init_context, task.out);
+}
+
+/**
+ * Task state for one kernel call run by execute_kernels_in_parallel().
+ */
+struct ParallelKernelCall {
+  OpFunction kernel;
+  EValue** args;
+  BoundOpFunction bound_kernel;
+  void** bound_args;
+  uint8_t* temp_buffer;
+  uint32_t temp_buffer_size;
+  size_t temp_used;
+  Error error;
+};
+
+void run_parallel_kernel_call(void* context, size_t task_index) {
+  auto& call = static_cast<ParallelKernelCall*>(context)[task_index];
+  MemoryAllocator temp_allocator(call.temp_buffer_size, call.temp_buffer);
+  KernelRuntimeContext kernel_context(
+      /*event_tracer=*/nullptr,
+      call.temp_buffer != nullptr ? &temp_allocator : nullptr);
+  if (call.bound_kernel != nullptr) {
+    call.bound_kernel(kernel_context, call.bound_args);
+  } else {
+    call.kernel(kernel_context, call.args);
+  }
+  call.temp_used = temp_allocator.used_size();
+  call.error = kernel_context.failure_state();
+}
+
 } // namespace
 
+Error Method::init_delegates_in_parallel(
+    const NamedDataMap& named_data_map,
+    TaskRunner* runner) {
+  EXECUTORCH_SCOPE_PROF("Method::init_delegates_in_parallel");
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto& delegates = *serialization_plan_->delegates();
+  const size_t n_delegate = delegates.size();
+  ParallelDelegateInit* tasks = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+      method_allocator, ParallelDelegateInit, n_delegate);
+  BackendInitContext backend_init_context(method_allocator, &named_data_map);
+
+  // Reading the program uses its data loader, which may not be thread-safe,
+  // so only the backends' init() calls run concurrently.
+  for (size_t i = 0; i < n_delegate; ++i) {
+    new (&tasks[i]) ParallelDelegateInit{
+        BackendDelegate::Prepared(),
+        &backend_init_context,
+        &delegates_[i],
+        Error::Ok};
+    Error err = BackendDelegate::Prepare(
+        *delegates.Get(i), program_, backend_init_context, &tasks[i].prepared);
+    if (err != Error::Ok) {
+      for (size_t j = 0; j <= i; ++j) {
+        tasks[j].~ParallelDelegateInit();
+      }
+      return err;
+    }
+  }
+
+  const size_t max_batch = runner->max_concurrency();
+  for (size_t done = 0; done < n_delegate;) {
+    const size_t remaining = n_delegate - done;
+    const size_t batch = remaining < max_batch ? remaining : max_batch;
+    runner->run(run_parallel_delegate_init, &tasks[done], batch);
+    done += batch;
+  }
+
+  // Report the error of the first delegate that failed, whatever order they
+  // ran in, and destroy the others since ~Method() will not see them.
+  Error first_error = Error::Ok;
+  for (size_t i = 0; i < n_delegate; ++i) {
+    if (first_error == Error::Ok) {
+      first_error = tasks[i].error;
+    }
+  }
+  for (size_t i = 0; i < n_delegate; ++i) {
+    if (first_error != Error::Ok && tasks[i].error == Error::Ok) {
+      delegates_[i].~BackendDelegate();
+    }
+    tasks[i].~ParallelDelegateInit();
+  }
+  if (first_error == Error::Ok) {
+    n_delegate_ = n_delegate;
+  }
+  return first_error;
+}
+
 Error Method::parse_values() {
   auto flatbuffer_values = serialization_plan_->values();
   ET_CHECK_OR_RETURN_ERROR(
@@ -292,6 +884,32 @@ Error Method::parse_values() {
   // safe for errors to return without updating any state.
   n_value_ = 0;
 
+  // If the Program loads constants lazily, this Method owns the data of the
+  // constant tensors it uses. Count them so there is a slot for each one.
+  size_t max_constant_data = 0;
+  if (program_->has_lazy_constants()) {
+    for (size_t i = 0; i < n_value; ++i) {
+      auto serialization_value = flatbuffer_values->Get(i);
+      if (serialization_value != nullptr &&
+          serialization_value->val_type() ==
+              executorch_flatbuffer::KernelTypes::Tensor &&
+          serialization_value->val() != nullptr) {
+        const auto s_tensor = serialization_value->val_as_Tensor();
+        if (s_tensor->data_buffer_idx() > 0 &&
+            s_tensor->allocation_info() == nullptr) {
+          ++max_constant_data;
+        }
+      }
+    }
+    if (max_constant_data > 0) {
+      constant_data_ = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+          memory_manager_->method_allocator(),
+          FreeableBuffer,
+          max_constant_data);
+    }
+  }
+  n_constant_data_ = 0;
+
   for (size_t i = 0; i < n_value; ++i) {
     auto serialization_value = flatbuffer_values->Get(i);
     // Ensure that the `val_as_X()` calls will return non-null pointers.
@@ -373,8 +991,18 @@ Error Method::parse_values() {
         new (&values_[i]) EValue(fb_str->c_str(), fb_str->size());
       } break;
       case executorch_flatbuffer::KernelTypes::Tensor: {
+        const auto s_tensor = serialization_value->val_as_Tensor();
+        FreeableBuffer* lazy_constant_data = nullptr;
+        if (constant_data_ != nullptr && s_tensor->data_buffer_idx() > 0 &&
+            s_tensor->allocation_info() == nullptr) {
+          // ~Method() frees every slot below n_constant_data_, so construct
+          // the slot before handing it out.
+          lazy_constant_data =
+              new (&constant_data_[n_constant_data_]) FreeableBuffer();
+          ++n_constant_data_;
+        }
         auto t = deserialization::parseTensor(
-            program_, memory_manager_, serialization_value->val_as_Tensor());
+            program_, memory_manager_, s_tensor, lazy_constant_data);
         if (!t.ok()) {
           ET_LOG(
               Error,
@@ -478,14 +1106,99 @@ Error populate_operator_name(
 
   return Error::Ok;
 }
+
+/**
+ * Returns true if `name` is what populate_operator_name() makes of `op`.
+ */
+bool operator_name_equals(
+    const executorch_flatbuffer::Operator* op,
+    const char* name) {
+  if (op->name() == nullptr) {
+    return false;
+  }
+  const size_t name_length = op->name()->size();
+  if (strncmp(name, op->name()->c_str(), name_length) != 0) {
+    return false;
+  }
+  name += name_length;
+  if (op->overload() == nullptr || op->overload()->size() == 0) {
+    return *name == '\0';
+  }
+  return *name == '.' && strcmp(name + 1, op->overload()->c_str()) == 0;
+}
+
+/**
+ * Computes the cost of a call of `op` with `args` and hands it to
+ * `event_tracer`, if a cost function is registered for the op.
+ */
+void set_op_cost(
+    EventTracer* event_tracer,
+    const executorch_flatbuffer::Operator* op,
+    InstructionArgs args) {
+  constexpr size_t kTempBufferSizeForName = 100;
+  char operator_name[kTempBufferSizeForName];
+  if (populate_operator_name(op, kTempBufferSizeForName, operator_name) !=
+      Error::Ok) {
+    return;
+  }
+  const OpCostFunction cost_fn = get_op_cost_function(operator_name);
+  if (cost_fn == nullptr) {
+    return;
+  }
+  const OpCost cost = cost_fn(args.data(), args.size());
+  internal::event_tracer_set_op_cost(
+      event_tracer, cost.flops, cost.bytes_read, cost.bytes_written);
+}
+
+// A snapshot saved to a Method::InitCache is this header followed by, for
+// each KernelCall instruction in chain and instruction order, the uint32_t
+// index in get_kernels() of the kernel it resolved to.
+struct InitSnapshotHeader {
+  uint32_t magic;
+  uint32_t num_kernel_calls;
+  // The size of get_kernels() when the snapshot was saved, so that snapshots
+  // of another registry are ignored without checking every operator.
+  uint32_t num_kernels;
+};
+
+constexpr size_t kInitSnapshotWords =
+    sizeof(InitSnapshotHeader) / sizeof(uint32_t);
+static_assert(
+    sizeof(InitSnapshotHeader) == kInitSnapshotWords * sizeof(uint32_t),
+    "Snapshot kernel indices must follow the header without padding");
+
+// "ETI1" when read as a little-endian uint32_t, so that snapshots saved on a
+// machine of the other byte order do not match.
+constexpr uint32_t kInitSnapshotMagic = 0x31495445;
+
+/**
+ * Returns the kernel at `kernel_index` in get_kernels() if it is the one that
+ * get_kernel() resolves operator `op_index` of `plan` to, or null.
+ *
+ * PREREQ: !has_specialized_kernels(), so that each name has a single kernel
+ * whatever the arguments.
+ */
+const Kernel* get_snapshot_kernel(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t op_index,
+    uint32_t kernel_index) {
+  const auto ops = plan->operators();
+  const ArrayRef<Kernel> kernels = get_kernels();
+  if (ops == nullptr || op_index < 0 || op_index >= ops->size() ||
+      kernel_index >= kernels.size() ||
+      !operator_name_equals(ops->Get(op_index), kernels[kernel_index].name_)) {
+    return nullptr;
+  }
+  return &kernels[kernel_index];
+}
 } // namespace
 
 Error Method::resolve_operator(
     int32_t op_index,
-    OpFunction* kernels,
-    size_t kernel_index,
-    InstructionArgs args,
-    size_t n_args) {
+    Instruction* instruction,
+    const Kernel** kernel) {
+  const InstructionArgs args = instruction->args;
+  const size_t n_args = args.size();
   // TODO(T153505381, T153506819) Investigate optimizing this function for both
   // space and time.
 
@@ -532,23 +1245,44 @@ Error Method::resolve_operator(
     }
   }
   // search kernel
-  if (hasOpsFn(operator_name, ArrayRef<TensorMeta>(meta, count))) {
-    kernels[kernel_index] =
-        getOpsFn(operator_name, ArrayRef<TensorMeta>(meta, count));
-    return Error::Ok;
-  } else {
+  const Kernel* resolved =
+      get_kernel(operator_name, ArrayRef<TensorMeta>(meta, count));
+  if (resolved == nullptr) {
     ET_LOG(Error, "Missing operator: [%d] %s", op_index, operator_name);
     return Error::OperatorMissing;
   }
+  if (kernel != nullptr) {
+    *kernel = resolved;
+  }
+  return use_kernel(*resolved, instruction);
+}
+
+Error Method::use_kernel(const Kernel& kernel, Instruction* instruction) {
+  instruction->kernel = kernel.op_;
+
+  // Bind the arguments once here if the kernel can be called unboxed.
+  if (kernel.bind_ != nullptr && kernel.bound_op_ != nullptr) {
+    const InstructionArgs args = instruction->args;
+    void** bound_args = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        memory_manager_->method_allocator(), void*, args.size());
+    if (kernel.bind_(args.data(), args.size(), bound_args)) {
+      instruction->bound_kernel = kernel.bound_op_;
+      instruction->bound_args = bound_args;
+    }
+  }
+  return Error::Ok;
 }
 
 Result<Method> Method::load(
     executorch_flatbuffer::ExecutionPlan* s_plan,
     const Program* program,
     MemoryManager* memory_manager,
-    EventTracer* event_tracer) {
+    EventTracer* event_tracer,
+    TaskRunner* delegate_init_runner,
+    InitCache* init_cache) {
   Method method(program, memory_manager, event_tracer);
-  Error err = method.init(s_plan);
+  Error err = method.init(
+      s_plan, /*source=*/nullptr, delegate_init_runner, init_cache);
   if (err != Error::Ok) {
     return err;
   } else {
@@ -557,7 +1291,31 @@ Result<Method> Method::load(
   }
 }
 
-Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
+Result<Method> Method::clone(
+    MemoryManager* memory_manager,
+    EventTracer* event_tracer) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(), InvalidState, "Cannot clone an uninitialized Method");
+  ET_CHECK_OR_RETURN_ERROR(
+      memory_manager != nullptr && memory_manager != memory_manager_,
+      InvalidArgument,
+      "Clone requires a MemoryManager of its own");
+  EXECUTORCH_SCOPE_PROF("Method::clone");
+  internal::event_tracer_create_event_block(event_tracer, "Default");
+  Method method(program_, memory_manager, event_tracer);
+  Error err = method.init(serialization_plan_, this);
+  if (err != Error::Ok) {
+    return err;
+  }
+  ET_CHECK(method.initialized());
+  return method;
+}
+
+Error Method::init(
+    executorch_flatbuffer::ExecutionPlan* s_plan,
+    const Method* source,
+    TaskRunner* delegate_init_runner,
+    InitCache* init_cache) {
   EXECUTORCH_SCOPE_PROF("Method::init");
   internal::EventTracerProfileScope event_tracer_profile_scope =
       internal::EventTracerProfileScope(event_tracer_, "Method::init");
@@ -571,6 +1329,8 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
       InitializationState::InitializationFailed; // Until proven otherwise
   serialization_plan_ = s_plan;
   auto method_allocator = memory_manager_->method_allocator();
+  temp_allocator_id_ =
+      internal::event_tracer_track_allocator(event_tracer_, "temp_allocator");
 
   {
     // Parse the elements of the values_ array.
@@ -589,14 +1349,26 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     delegates_ = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
         method_allocator, BackendDelegate, n_delegate);
 
+    const ProgramNamedDataMap program_named_data(program_);
+
     // n_delegate_ counts the number of successfully-initialized delegates for
     // ~Method() to clean up, and is incremented at the bottom of the loop. This
     // makes it safe for errors to return without updating any state.
     n_delegate_ = 0;
 
-    for (size_t i = 0; i < n_delegate; ++i) {
+    if (delegate_init_runner != nullptr && n_delegate > 0) {
+      // Sets n_delegate_ once all of the delegates are initialized.
+      Error err =
+          init_delegates_in_parallel(program_named_data, delegate_init_runner);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+
+    for (size_t i = n_delegate_; i < n_delegate; ++i) {
       const auto& delegate = *delegates->Get(i);
-      BackendInitContext backend_init_context(method_allocator);
+      BackendInitContext backend_init_context(
+          method_allocator, &program_named_data);
       Error err = BackendDelegate::Init(
           delegate, program_, backend_init_context, &delegates_[i]);
       if (err != Error::Ok) {
@@ -618,6 +1390,57 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     chains_ =
         ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, Chain, n_chains_);
 
+    // With an init cache, take the kernels from its snapshot if it has one
+    // for this method, and record the resolved ones to save a new snapshot if
+    // not. Clones take them from their source instead.
+    const bool use_init_cache = init_cache != nullptr && source == nullptr &&
+        serialization_plan_->name() != nullptr && !has_specialized_kernels();
+    size_t n_kernel_calls = 0;
+    if (use_init_cache) {
+      for (size_t i = 0; i < n_chains_; ++i) {
+        const auto s_instructions = chains->Get(i)->instructions();
+        if (s_instructions == nullptr) {
+          continue;
+        }
+        for (const auto instruction : *s_instructions) {
+          if (instruction != nullptr &&
+              instruction->instr_args_type() ==
+                  executorch_flatbuffer::InstructionArguments::KernelCall) {
+            n_kernel_calls++;
+          }
+        }
+      }
+    }
+    Result<FreeableBuffer> snapshot = use_init_cache
+        ? init_cache->load(serialization_plan_->name()->c_str())
+        : Result<FreeableBuffer>(Error::NotFound);
+    const uint8_t* snapshot_kernels = nullptr;
+    if (snapshot.ok() &&
+        snapshot->size() ==
+            sizeof(InitSnapshotHeader) + n_kernel_calls * sizeof(uint32_t)) {
+      InitSnapshotHeader header;
+      std::memcpy(&header, snapshot->data(), sizeof(header));
+      if (header.magic == kInitSnapshotMagic &&
+          header.num_kernel_calls == n_kernel_calls &&
+          header.num_kernels == get_kernels().size()) {
+        snapshot_kernels =
+            static_cast<const uint8_t*>(snapshot->data()) + sizeof(header);
+      }
+    }
+    bool snapshot_matches = snapshot_kernels != nullptr;
+    // The new snapshot. Uses the temp allocator if there is one, since it is
+    // only needed until save() returns.
+    MemoryAllocator* snapshot_allocator =
+        memory_manager_->temp_allocator() != nullptr
+        ? memory_manager_->temp_allocator()
+        : method_allocator;
+    uint32_t* new_snapshot = nullptr;
+    if (use_init_cache && n_kernel_calls > 0) {
+      new_snapshot = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+          snapshot_allocator, uint32_t, kInitSnapshotWords + n_kernel_calls);
+    }
+    size_t kernel_call_idx = 0;
+
     // Try resolving all operators before failing, to make it easier to debug
     // multiple problems at once.
     Error delayed_error = Error::Ok;
@@ -631,10 +1454,8 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
           "Missing instructions in chain %zu",
           i);
       auto num_instructions = s_instructions->size();
-      auto chain_instruction_kernels = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-          method_allocator, OpFunction, num_instructions);
-      auto chain_instruction_arg_lists = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-          method_allocator, InstructionArgs, num_instructions);
+      auto chain_instructions = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+          method_allocator, Instruction, num_instructions);
 
       // Set up the argument lists ahead of time and store pointers to them to
       // use when the instructions are called
@@ -648,6 +1469,18 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             "Null instruction at index %zu",
             instr_idx);
 
+        Instruction& decoded = chain_instructions[instr_idx];
+        decoded = Instruction{
+            instruction->instr_args_type(),
+            /*kernel=*/nullptr,
+            /*bound_kernel=*/nullptr,
+            /*bound_args=*/nullptr,
+            /*args=*/InstructionArgs(),
+            /*index=*/0,
+            /*target=*/0,
+            /*loop_back_edge=*/false,
+            /*temp_memory_peak=*/0,
+        };
         switch (instruction->instr_args_type()) {
           case executorch_flatbuffer::InstructionArguments::KernelCall: {
             const auto arg_idxs =
@@ -663,13 +1496,54 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
-            auto err = resolve_operator(
-                instruction->instr_args_as_KernelCall()->op_index(),
-                chain_instruction_kernels,
-                instr_idx,
-                res.get(),
-                arg_idxs->size());
+            decoded.args = res.get();
+            if (source != nullptr) {
+              // The source was initialized from the same plan, so its chains
+              // line up with ours.
+              const Instruction& source_instruction =
+                  source->chains_[i].instructions_[instr_idx];
+              decoded.kernel = source_instruction.kernel;
+              if (source_instruction.bound_kernel != nullptr) {
+                // The bound arguments point into the source's values; point
+                // them at the same places in ours.
+                void** bound_args = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+                    method_allocator, void*, arg_idxs->size());
+                for (size_t j = 0; j < arg_idxs->size(); ++j) {
+                  const auto offset =
+                      static_cast<const char*>(
+                          source_instruction.bound_args[j]) -
+                      reinterpret_cast<const char*>(source->values_);
+                  bound_args[j] = reinterpret_cast<char*>(values_) + offset;
+                }
+                decoded.bound_kernel = source_instruction.bound_kernel;
+                decoded.bound_args = bound_args;
+              }
+              break;
+            }
+            const int32_t op_index =
+                instruction->instr_args_as_KernelCall()->op_index();
+            const Kernel* kernel = nullptr;
+            if (snapshot_kernels != nullptr) {
+              uint32_t kernel_index;
+              std::memcpy(
+                  &kernel_index,
+                  snapshot_kernels + kernel_call_idx * sizeof(uint32_t),
+                  sizeof(uint32_t));
+              kernel = get_snapshot_kernel(
+                  serialization_plan_, op_index, kernel_index);
+            }
+            Error err;
+            if (kernel != nullptr) {
+              err = use_kernel(*kernel, &decoded);
+            } else {
+              snapshot_matches = false;
+              err = resolve_operator(op_index, &decoded, &kernel);
+            }
+            if (new_snapshot != nullptr && kernel != nullptr) {
+              new_snapshot[kInitSnapshotWords + kernel_call_idx] =
+                  static_cast<uint32_t>(kernel - get_kernels().data());
+            }
+            kernel_call_idx++;
             if (err == Error::OperatorMissing) {
               num_instructions_missing_op++;
             } else if (err == Error::MemoryAllocationFailed) {
@@ -694,31 +1568,79 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.args = res.get();
+            // Validate the index at load time so we can trust it during
+            // execution.
+            auto delegate_idx =
+                instruction->instr_args_as_DelegateCall()->delegate_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                delegate_idx >= 0 && delegate_idx < n_delegate_,
+                InvalidProgram,
+                "DELEGATE_CALL index %" PRId32
+                " negative or >= num delegates %zu at instruction %zu",
+                delegate_idx,
+                n_delegate_,
+                instr_idx);
+            decoded.index = static_cast<size_t>(delegate_idx);
           } break;
           case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
             // Validate the index at load time so we can trust it during
             // execution.
-            auto index =
-                instruction->instr_args_as_JumpFalseCall()->cond_value_index();
+            const auto jf_call = instruction->instr_args_as_JumpFalseCall();
+            auto index = jf_call->cond_value_index();
             ET_CHECK_OR_RETURN_ERROR(
                 index >= 0 && index < n_value_,
                 InvalidProgram,
                 "Index %d negative or >= %zu",
                 index,
                 n_value_);
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            // An out-of-range destination is reported by the bounds check at
+            // the top of execute_instruction() once the jump is taken.
+            ET_CHECK_OR_RETURN_ERROR(
+                jf_call->destination_instruction() >= 0,
+                InvalidProgram,
+                "Negative jump destination %d at instruction %zu",
+                jf_call->destination_instruction(),
+                instr_idx);
+            decoded.index = static_cast<size_t>(index);
+            decoded.target =
+                static_cast<size_t>(jf_call->destination_instruction());
+          } break;
+          case executorch_flatbuffer::InstructionArguments::MoveCall: {
+            const auto move_call = instruction->instr_args_as_MoveCall();
+            ET_CHECK_OR_RETURN_ERROR(
+                move_call->move_from() >= 0 &&
+                    move_call->move_from() < n_value_ &&
+                    move_call->move_to() >= 0 &&
+                    move_call->move_to() < n_value_,
+                InvalidProgram,
+                "MoveCall index out of range at instruction %zu",
+                instr_idx);
+            decoded.index = static_cast<size_t>(move_call->move_from());
+            decoded.target = static_cast<size_t>(move_call->move_to());
+          } break;
+          case executorch_flatbuffer::InstructionArguments::FreeCall: {
+            const auto free_call = instruction->instr_args_as_FreeCall();
+            ET_CHECK_OR_RETURN_ERROR(
+                free_call->value_index() >= 0 &&
+                    free_call->value_index() < n_value_ &&
+                    values_[free_call->value_index()].isTensor(),
+                InvalidProgram,
+                "FreeCall index %d is not a tensor at instruction %zu",
+                free_call->value_index(),
+                instr_idx);
+            decoded.index = static_cast<size_t>(free_call->value_index());
           } break;
           default: {
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            // Reported as an error if the instruction is executed.
           } break;
         }
       }
       chains_[i] = Chain{
           s_chain,
-          Span<InstructionArgs>(chain_instruction_arg_lists, num_instructions),
-          chain_instruction_kernels,
+          Span<Instruction>(chain_instructions, num_instructions),
       };
+      mark_loop_back_edges(serialization_plan_, values_, chains_[i]);
     }
     ET_CHECK_OR_RETURN_ERROR(
         num_instructions_missing_op == 0,
@@ -729,6 +1651,21 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     if (delayed_error != Error::Ok) {
       return delayed_error;
     }
+
+    if (new_snapshot != nullptr && !snapshot_matches) {
+      const InitSnapshotHeader header{
+          kInitSnapshotMagic,
+          static_cast<uint32_t>(n_kernel_calls),
+          static_cast<uint32_t>(get_kernels().size())};
+      std::memcpy(new_snapshot, &header, sizeof(header));
+      init_cache->save(
+          serialization_plan_->name()->c_str(),
+          new_snapshot,
+          (kInitSnapshotWords + n_kernel_calls) * sizeof(uint32_t));
+    }
+    if (new_snapshot != nullptr && snapshot_allocator != method_allocator) {
+      snapshot_allocator->reset();
+    }
   }
 
   // Validate input values and get tensor pre-allocation info.
@@ -765,14 +1702,75 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     }
   }
 
+  {
+    Error err = validate_memory_plan_buckets();
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
   step_state_ = StepState{0, 0};
 
+  cache_static_lists();
+
   init_state_ = InitializationState::Initialized;
   return Error::Ok;
 }
 
 ET_NODISCARD Error
 Method::set_input(const EValue& input_evalue, size_t input_idx) {
+  return set_input_impl(input_evalue, input_idx, /*alias_planned=*/false);
+}
+
+ET_NODISCARD Error
+Method::share_input(const EValue& input_evalue, size_t input_idx) {
+  return set_input_impl(input_evalue, input_idx, /*alias_planned=*/true);
+}
+
+bool Method::can_alias_planned_input(
+    size_t input_idx,
+    const exec_aten::Tensor& t_src) const {
+  const void* data = t_src.const_data_ptr();
+  if (data == nullptr ||
+      reinterpret_cast<uintptr_t>(data) % alignof(std::max_align_t) != 0) {
+    return false;
+  }
+  // Outputs are read after the alias ends.
+  const size_t index = get_input_index(input_idx);
+  for (size_t i = 0; i < outputs_size(); ++i) {
+    if (get_output_index(i) == index) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Error Method::restore_planned_input(size_t input_idx) {
+  const size_t index = get_input_index(input_idx);
+  const EValue& input = values_[index];
+  if (!input.isTensor()) {
+    return Error::Ok;
+  }
+  const auto* s_tensor =
+      serialization_plan_->values()->Get(index)->val_as_Tensor();
+  if (s_tensor == nullptr || s_tensor->allocation_info() == nullptr) {
+    return Error::Ok;
+  }
+  Result<void*> address = deserialization::getMemPlannedPtr(
+      s_tensor->allocation_info(),
+      /*nbytes=*/0,
+      memory_manager_->planned_memory());
+  if (!address.ok()) {
+    return address.error();
+  }
+  const exec_aten::Tensor& t = input.toTensor();
+  return internal::set_tensor_data(t, address.get(), t.nbytes());
+}
+
+ET_NODISCARD Error Method::set_input_impl(
+    const EValue& input_evalue,
+    size_t input_idx,
+    bool alias_planned) {
   ET_CHECK_OR_RETURN_ERROR(
       initialized(),
       InvalidState,
@@ -828,10 +1826,17 @@ Method::set_input(const EValue& input_evalue, size_t input_idx) {
         input_idx,
         static_cast<uint32_t>(err));
     Error error;
-    if (pre_allocated_input_) {
-      error = internal::copy_tensor_data(t_dst, t_src);
-    } else {
+    if (!pre_allocated_input_) {
+      error = internal::share_tensor_data(t_dst, t_src);
+    } else if (alias_planned && can_alias_planned_input(input_idx, t_src)) {
       error = internal::share_tensor_data(t_dst, t_src);
+      aliased_planned_inputs_ = true;
+    } else {
+      if (aliased_planned_inputs_) {
+        // A previous share_input() may have pointed the input elsewhere.
+        ET_CHECK_OK_OR_RETURN_ERROR(restore_planned_input(input_idx));
+      }
+      error = internal::copy_tensor_data(t_dst, t_src);
     }
     ET_CHECK_OR_RETURN_ERROR(
         error == Error::Ok,
@@ -929,6 +1934,50 @@ Method::set_inputs(const exec_aten::ArrayRef<EValue>& input_evalues) {
   return Error::Ok;
 }
 
+bool Method::output_is_retargetable(size_t value_index) const {
+  // Constant outputs are never written.
+  const auto* s_tensor =
+      serialization_plan_->values()->Get(value_index)->val_as_Tensor();
+  if (s_tensor == nullptr || s_tensor->allocation_info() == nullptr) {
+    return false;
+  }
+  // Inputs hold the caller's data, not the method's.
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    if (get_input_index(i) == value_index) {
+      return false;
+    }
+  }
+  // Views and moves replace the data pointer of the output while executing,
+  // which would undo the new one.
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    const Chain& chain = chains_[chain_idx];
+    for (size_t i = 0; i < chain.instructions_.size(); ++i) {
+      const Instruction& instruction = chain.instructions_[i];
+      if (instruction.type ==
+          executorch_flatbuffer::InstructionArguments::MoveCall) {
+        if (instruction.target == value_index) {
+          return false;
+        }
+      } else if (
+          instruction.type ==
+              executorch_flatbuffer::InstructionArguments::KernelCall &&
+          instruction.args.size() > 0 &&
+          instruction.args[instruction.args.size() - 1] ==
+              &values_[value_index]) {
+        const auto op_index = chain.s_chain_->instructions()
+                                  ->Get(i)
+                                  ->instr_args_as_KernelCall()
+                                  ->op_index();
+        const auto* op = serialization_plan_->operators()->Get(op_index);
+        if (strcmp(op->name()->c_str(), "executorch_prim::et_view") == 0) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
 ET_NODISCARD Error
 Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
   // Check method state
@@ -937,25 +1986,16 @@ Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
       InvalidState,
       "Outputs can not be retrieved until method has been initialized.");
 
-  // ET_CHECK_OR_RETURN_ERROR(
-  //     !pre_allocated_output_,
-  //     InvalidState,
-  //     "Overriding output data pointer allocated by memory plan is not
-  //     allowed.");
-  // TODO(T188740925): for now, return error without logs.
-  if (pre_allocated_output_) {
-    return Error::InvalidState;
-  }
-
   // Check the args
   ET_CHECK_OR_RETURN_ERROR(
-      output_idx <= outputs_size(),
+      output_idx < outputs_size(),
       InvalidArgument,
       "output_idx: %zu num_outputs: %zu",
       output_idx,
       outputs_size());
 
-  auto& output = mutable_value(get_output_index(output_idx));
+  const size_t index = get_output_index(output_idx);
+  auto& output = mutable_value(index);
   ET_CHECK_OR_RETURN_ERROR(
       output.isTensor(),
       InvalidArgument,
@@ -963,17 +2003,28 @@ Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
       (size_t)output.tag);
 
   auto& t = output.toTensor();
+  size_t required_size = t.nbytes();
+  if (pre_allocated_output_ && t.const_data_ptr() != nullptr) {
+    // The final kernel writing a memory-planned output can write to the
+    // caller's buffer instead, as long as nothing else repoints the output.
+    // TODO(T188740925): for now, return error without logs, callers probe
+    // every output with this.
+    if (!output_is_retargetable(index)) {
+      return Error::InvalidState;
+    }
+    // Dynamic outputs may grow up to the sizes they were planned for.
+    Result<TensorInfo> planned = method_meta().output_tensor_meta(output_idx);
+    if (!planned.ok()) {
+      return planned.error();
+    }
+    required_size = planned->nbytes();
+  }
   ET_CHECK_OR_RETURN_ERROR(
-      output.isTensor(),
-      InvalidArgument,
-      "output type: %zu is not tensor",
-      (size_t)output.tag);
-  ET_CHECK_OR_RETURN_ERROR(
-      t.nbytes() <= size,
+      required_size <= size,
       InvalidArgument,
       "buffer size: %zu is smaller then expected tensor size: %zu",
       size,
-      t.nbytes());
+      required_size);
 
   // Set data
   return internal::set_tensor_data(t, buffer, size);
@@ -1025,20 +2076,47 @@ ET_NODISCARD Error Method::get_inputs(EValue* input_evalues, size_t length) {
 
 Error Method::execute_instruction() {
   auto& chain = chains_[step_state_.chain_idx];
-  auto instructions = chain.s_chain_->instructions();
 
   ET_CHECK_OR_RETURN_ERROR(
-      step_state_.instr_idx < instructions->size(),
+      step_state_.instr_idx < chain.instructions_.size(),
       Internal,
       "Instr index %zu >= chain[%zu] instr count %zu",
       step_state_.instr_idx,
       step_state_.chain_idx,
-      (size_t)instructions->size());
+      chain.instructions_.size());
 
-  auto instruction = instructions->Get(step_state_.instr_idx);
+  // All of the fields used here were decoded and validated at init time.
+  Instruction& instruction = chain.instructions_[step_state_.instr_idx];
   size_t next_instr_idx = step_state_.instr_idx + 1;
+  // Calls only need the delegate calls still running on their own arguments.
+  // Everything else may touch any value, so it waits for all of them.
+  if (instruction.type ==
+          executorch_flatbuffer::InstructionArguments::KernelCall ||
+      instruction.type ==
+          executorch_flatbuffer::InstructionArguments::DelegateCall) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        wait_for_delegate_calls_using(instruction.args));
+  } else {
+    ET_CHECK_OK_OR_RETURN_ERROR(wait_for_pending_delegate_calls());
+  }
   Error err = Error::Ok;
-  switch (instruction->instr_args_type()) {
+  if (instruction.loop_back_edge && event_tracer_ == nullptr) {
+    // Compare the loop counter and take the jump of the next instruction
+    // here, without going through the kernel and the condition value. Not
+    // done with an event tracer, so that both instructions are still
+    // profiled.
+    const EValue& counter = *instruction.args[0];
+    const EValue& trip_count = *instruction.args[1];
+    if (counter.isInt() && trip_count.isInt()) {
+      const bool done = counter.toInt() == trip_count.toInt();
+      // The JumpFalseCall may also be reached by other jumps.
+      *instruction.args[2] = EValue(done);
+      step_state_.instr_idx =
+          done ? step_state_.instr_idx + 2 : instruction.target;
+      return Error::Ok;
+    }
+  }
+  switch (instruction.type) {
     case executorch_flatbuffer::InstructionArguments::KernelCall: {
       EXECUTORCH_SCOPE_PROF("OPERATOR_CALL");
       internal::EventTracerProfileScope event_tracer_scope =
@@ -1047,15 +2125,23 @@ Error Method::execute_instruction() {
       // The temp_allocator passed can be null, but calling allocate_temp will
       // fail
       KernelRuntimeContext context(
-          event_tracer_, memory_manager_->temp_allocator());
-      auto args = chain.argument_lists_[step_state_.instr_idx];
-      chain.kernels_[step_state_.instr_idx](context, args.data());
+          internal::event_tracer_if_enabled(event_tracer_),
+          memory_manager_->temp_allocator());
+      const auto& args = instruction.args;
+      if (instruction.bound_kernel != nullptr) {
+        instruction.bound_kernel(context, instruction.bound_args);
+      } else {
+        instruction.kernel(context, args.data());
+      }
       // We reset the temp_allocator after the switch statement
       err = context.failure_state();
       if (err != Error::Ok) {
         // We know that instr_args_as_KernelCall is non-null because it was
         // checked at init time.
-        auto op_index = instruction->instr_args_as_KernelCall()->op_index();
+        auto op_index = chain.s_chain_->instructions()
+                            ->Get(step_state_.instr_idx)
+                            ->instr_args_as_KernelCall()
+                            ->op_index();
         auto op = serialization_plan_->operators()->Get(op_index);
         ET_LOG(
             Error,
@@ -1075,30 +2161,48 @@ Error Method::execute_instruction() {
         // TODO(T153804650): Consider logging the EValues to help with
         // debugging. This is a failure path, and it doesn't matter if it's a
         // little slow. Do the same for DelegateCall errors.
+      } else if (
+          internal::event_tracer_if_enabled(event_tracer_) != nullptr &&
+          has_op_costs()) {
+        // Record the work done by the call with its OPERATOR_CALL event,
+        // which ends with this scope.
+        auto op_index = chain.s_chain_->instructions()
+                            ->Get(step_state_.instr_idx)
+                            ->instr_args_as_KernelCall()
+                            ->op_index();
+        set_op_cost(
+            event_tracer_,
+            serialization_plan_->operators()->Get(op_index),
+            args);
       }
     } break;
     case executorch_flatbuffer::InstructionArguments::DelegateCall: {
       EXECUTORCH_SCOPE_PROF("DELEGATE_CALL");
       internal::EventTracerProfileScope event_tracer_profile_scope =
           internal::EventTracerProfileScope(event_tracer_, "DELEGATE_CALL");
-      // We know that instr_args_as_DelegateCall is non-null because it was
-      // checked at init time.
-      auto delegate_idx =
-          instruction->instr_args_as_DelegateCall()->delegate_index();
-      ET_CHECK_OR_RETURN_ERROR(
-          delegate_idx < n_delegate_,
-          Internal,
-          "DELEGATE_CALL index %" PRIu32
-          " >= num delegates %zu at instruction %zu",
-          delegate_idx,
-          n_delegate_,
-          step_state_.instr_idx);
       BackendExecutionContext backend_execution_context(
-          /*event_tracer*/ event_tracer_,
-          /*temp_allocator*/ memory_manager_->temp_allocator());
-      err = delegates_[delegate_idx].Execute(
-          backend_execution_context,
-          chain.argument_lists_[step_state_.instr_idx].data());
+          /*event_tracer*/ internal::event_tracer_if_enabled(event_tracer_),
+          /*temp_allocator*/ memory_manager_->temp_allocator(),
+          /*backend_options*/ backend_options_);
+      err = delegates_[instruction.index].Execute(
+          backend_execution_context, instruction.args.data());
+      if (err == Error::Ok &&
+          backend_execution_context.completion_fn() != nullptr) {
+        // The delegate is still running. Let the following instructions run
+        // meanwhile, unless its outputs must be logged below or there is no
+        // room to track it.
+        const bool log_args = event_tracer_ != nullptr;
+        if (!log_args &&
+            n_pending_delegate_calls_ < kMaxPendingDelegateCalls) {
+          pending_delegate_calls_[n_pending_delegate_calls_++] = {
+              backend_execution_context.completion_fn(),
+              backend_execution_context.completion_context(),
+              instruction.args};
+        } else {
+          err = backend_execution_context.completion_fn()(
+              backend_execution_context.completion_context());
+        }
+      }
       if (err != Error::Ok) {
         ET_LOG(
             Error,
@@ -1113,10 +2217,8 @@ Error Method::execute_instruction() {
       // log everything. This will be changed in the future when the inputs and
       // ouputs are separate lists.
 #ifdef ET_EVENT_TRACER_ENABLED
-      for (size_t i = 0;
-           i < chain.argument_lists_[step_state_.instr_idx].size();
-           i++) {
-        EValue* arg = chain.argument_lists_[step_state_.instr_idx].data()[i];
+      for (size_t i = 0; i < instruction.args.size(); i++) {
+        EValue* arg = instruction.args.data()[i];
         internal::event_tracer_log_evalue(event_tracer_, *arg);
       }
 #endif
@@ -1125,16 +2227,12 @@ Error Method::execute_instruction() {
       EXECUTORCH_SCOPE_PROF("JF_CALL");
       internal::EventTracerProfileScope event_tracer_profile_scope =
           internal::EventTracerProfileScope(event_tracer_, "JF_CALL");
-      // We know that instr_args_as_JumpFalseCall is non-null because it was
-      // checked at init time.
-      auto jf_call = instruction->instr_args_as_JumpFalseCall();
       // We know that index is a valid values_ index because it was checked at
       // init time.
-      auto index = jf_call->cond_value_index();
-      Result<bool> jf_result = parse_cond_value(values_[index]);
+      Result<bool> jf_result = parse_cond_value(values_[instruction.index]);
       if (jf_result.ok()) {
         if (!jf_result.get()) {
-          next_instr_idx = jf_call->destination_instruction();
+          next_instr_idx = instruction.target;
         }
       } else {
         err = jf_result.error();
@@ -1144,30 +2242,35 @@ Error Method::execute_instruction() {
       EXECUTORCH_SCOPE_PROF("MOVE_CALL");
       internal::EventTracerProfileScope event_tracer_profile_scope =
           internal::EventTracerProfileScope(event_tracer_, "MOVE_CALL");
-      // We know that instr_args_as_MoveCall is non-null because it was checked
-      // at init time.
-      auto move_call = instruction->instr_args_as_MoveCall();
-      mutable_value(move_call->move_to()) = get_value(move_call->move_from());
+      // We know that both indices are valid values_ indices because they were
+      // checked at init time.
+      values_[instruction.target] = values_[instruction.index];
     } break;
     case executorch_flatbuffer::InstructionArguments::FreeCall: {
       EXECUTORCH_SCOPE_PROF("FREE_CALL");
       internal::EventTracerProfileScope event_tracer_profile_scope =
           internal::EventTracerProfileScope(event_tracer_, "FREE_CALL");
-      // We know that instr_args_as_FreeCall is non-null because it was checked
-      // at init time.
-      auto free_call = instruction->instr_args_as_FreeCall();
-      auto t = values_[free_call->value_index()].toTensor();
+      // We know that index refers to a tensor because it was checked at init
+      // time.
+      auto t = values_[instruction.index].toTensor();
       internal::reset_data_ptr(t);
     } break;
     default:
       ET_LOG(
           Error,
           "Unknown instruction: %hhu",
-          static_cast<uint8_t>(instruction->instr_args_type()));
+          static_cast<uint8_t>(instruction.type));
       err = Error::InvalidProgram;
   }
-  // Reset the temp allocator for every instruction.
+  // Record how much temp memory the instruction used, then reset the temp
+  // allocator for every instruction.
   if (memory_manager_->temp_allocator() != nullptr) {
+    const size_t temp_used = memory_manager_->temp_allocator()->used_size();
+    record_temp_memory_use(instruction, temp_used);
+    if (temp_used > 0) {
+      internal::event_tracer_track_allocation(
+          event_tracer_, temp_allocator_id_, temp_used);
+    }
     memory_manager_->temp_allocator()->reset();
   }
   if (err == Error::Ok) {
@@ -1176,12 +2279,739 @@ Error Method::execute_instruction() {
   return err;
 }
 
+void Method::record_temp_memory_use(Instruction& instruction, size_t used) {
+  if (used > instruction.temp_memory_peak) {
+    instruction.temp_memory_peak = used;
+  }
+  if (used > temp_memory_peak_) {
+    temp_memory_peak_ = used;
+  }
+}
+
+size_t Method::temp_memory_peak_bytes() const {
+  return temp_memory_peak_;
+}
+
+Result<size_t> Method::instruction_temp_memory_peak_bytes(
+    size_t chain_idx,
+    size_t instr_idx) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(), InvalidState, "Method not initialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      chain_idx < n_chains_,
+      InvalidArgument,
+      "Chain index %zu >= %zu",
+      chain_idx,
+      n_chains_);
+  ET_CHECK_OR_RETURN_ERROR(
+      instr_idx < chains_[chain_idx].instructions_.size(),
+      InvalidArgument,
+      "Instruction index %zu >= %zu",
+      instr_idx,
+      chains_[chain_idx].instructions_.size());
+  return chains_[chain_idx].instructions_[instr_idx].temp_memory_peak;
+}
+
+Error Method::init_parallel_plan() {
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto plan = serialization_plan_;
+
+  // One bit per value, set for the tensors of the method inputs and outputs,
+  // whose memory the user may provide.
+  const size_t n_io_bytes = (n_value_ + 7) / 8;
+  uint8_t* io =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, uint8_t, n_io_bytes);
+  memset(io, 0, n_io_bytes);
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    for_each_tensor_index(plan, get_input_index(i), [&](size_t tensor_index) {
+      mark_value_referenced(tensor_index, io);
+    });
+  }
+  for (size_t i = 0; i < outputs_size(); ++i) {
+    for_each_tensor_index(plan, get_output_index(i), [&](size_t tensor_index) {
+      mark_value_referenced(tensor_index, io);
+    });
+  }
+
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    Chain& chain = chains_[chain_idx];
+    const auto& instructions = chain.instructions_;
+    const size_t n_instructions = instructions.size();
+
+    // Jumps may land in the middle of a group, so chains that contain them
+    // always run sequentially.
+    bool has_jump = false;
+    for (size_t i = 0; i < n_instructions; ++i) {
+      has_jump |= instructions[i].type ==
+          executorch_flatbuffer::InstructionArguments::JumpFalseCall;
+    }
+    if (has_jump || n_instructions == 0) {
+      chain.parallel_order_ = nullptr;
+      chain.parallel_group_ends_ = nullptr;
+      chain.n_parallel_groups_ = 0;
+      continue;
+    }
+    uint32_t* order = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        method_allocator, uint32_t, n_instructions);
+    uint32_t* group_ends = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        method_allocator, uint32_t, n_instructions);
+    size_t n_order = 0;
+    size_t n_groups = 0;
+
+    size_t instr_idx = 0;
+    while (instr_idx < n_instructions) {
+      const Instruction& instruction = instructions[instr_idx];
+      if (instruction.type !=
+          executorch_flatbuffer::InstructionArguments::KernelCall) {
+        // Everything other than a kernel call is a group of its own.
+        order[n_order++] = static_cast<uint32_t>(instr_idx);
+        group_ends[n_groups++] = static_cast<uint32_t>(n_order);
+        ++instr_idx;
+        continue;
+      }
+
+      // Assign each kernel call in a window of consecutive calls a level one
+      // higher than that of any earlier call it conflicts with. Calls with the
+      // same level are independent of each other, and running the levels in
+      // order satisfies every dependency. Calls to operators other than out
+      // variants get a level of their own, above every earlier call and below
+      // every later one.
+      const size_t window_begin = instr_idx;
+      uint32_t levels[kMaxParallelWindow];
+      uint32_t min_level = 0;
+      uint32_t max_level = 0;
+      while (instr_idx < n_instructions &&
+             instr_idx - window_begin < kMaxParallelWindow &&
+             instructions[instr_idx].type ==
+                 executorch_flatbuffer::InstructionArguments::KernelCall) {
+        const size_t w = instr_idx - window_begin;
+        const auto& args = instructions[instr_idx].args;
+        const bool is_out = is_out_variant(plan->operators()->Get(
+            chain.s_chain_->instructions()
+                ->Get(instr_idx)
+                ->instr_args_as_KernelCall()
+                ->op_index()));
+        uint32_t level = min_level;
+        if (!is_out) {
+          level = w == 0 ? min_level : max_level + 1;
+          min_level = level + 1;
+        } else {
+          for (size_t prev = 0; prev < w; ++prev) {
+            if (levels[prev] + 1 > level &&
+                kernel_calls_conflict(
+                    plan,
+                    values_,
+                    io,
+                    instructions[window_begin + prev].args,
+                    args)) {
+              level = levels[prev] + 1;
+            }
+          }
+        }
+        levels[w] = level;
+        max_level = level > max_level ? level : max_level;
+        ++instr_idx;
+      }
+      for (uint32_t level = 0; level <= max_level; ++level) {
+        const size_t group_begin = n_order;
+        for (size_t w = 0; w < instr_idx - window_begin; ++w) {
+          if (levels[w] == level) {
+            order[n_order++] = static_cast<uint32_t>(window_begin + w);
+          }
+        }
+        if (n_order > group_begin) {
+          group_ends[n_groups++] = static_cast<uint32_t>(n_order);
+        }
+      }
+    }
+
+    chain.parallel_order_ = order;
+    chain.parallel_group_ends_ = group_ends;
+    chain.n_parallel_groups_ = n_groups;
+  }
+  return Error::Ok;
+}
+
+void Method::cache_static_lists() {
+  MemoryAllocator* temp_allocator = memory_manager_->temp_allocator();
+  if (temp_allocator == nullptr || n_value_ == 0) {
+    return;
+  }
+  // One bit per value, set if an instruction may replace the value: moves
+  // assign to their target, and kernels and delegates may assign to any of
+  // their arguments except tensors, which they only write through.
+  const size_t n_written_bytes = (n_value_ + 7) / 8;
+  uint8_t* written = temp_allocator->allocateList<uint8_t>(n_written_bytes);
+  if (written == nullptr) {
+    return;
+  }
+  memset(written, 0, n_written_bytes);
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    for (const Instruction& instruction : chains_[chain_idx].instructions_) {
+      if (instruction.type ==
+          executorch_flatbuffer::InstructionArguments::MoveCall) {
+        mark_value_referenced(instruction.target, written);
+      } else if (
+          instruction.type ==
+              executorch_flatbuffer::InstructionArguments::KernelCall ||
+          instruction.type ==
+              executorch_flatbuffer::InstructionArguments::DelegateCall) {
+        for (EValue* arg : instruction.args) {
+          if (!arg->isTensor()) {
+            mark_value_referenced(static_cast<size_t>(arg - values_), written);
+          }
+        }
+      }
+    }
+  }
+
+  const auto* s_values = serialization_plan_->values();
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto s_value = s_values->Get(i);
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    switch (s_value->val_type()) {
+      case executorch_flatbuffer::KernelTypes::IntList:
+        items = s_value->val_as_IntList()->items();
+        break;
+      case executorch_flatbuffer::KernelTypes::TensorList:
+        items = s_value->val_as_TensorList()->items();
+        break;
+      case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+        items = s_value->val_as_OptionalTensorList()->items();
+        break;
+      default:
+        continue;
+    }
+    // Only cache lists whose elements already hold a value of the right type,
+    // so that unwrapping them cannot fail, and keep that value.
+    bool is_static = true;
+    for (size_t j = 0; is_static && j < items->size(); ++j) {
+      if (items->Get(j) < 0) {
+        // None entry of an optional tensor list.
+        continue;
+      }
+      const size_t index = static_cast<size_t>(items->Get(j));
+      const bool is_written = ((written[index / 8] >> (index % 8)) & 1) != 0;
+      const EValue& item = values_[index];
+      bool has_type = item.isTensor();
+      if (values_[i].isIntList()) {
+        has_type = item.isInt();
+      } else if (values_[i].isListOptionalTensor()) {
+        has_type |= item.isNone();
+      }
+      is_static = !is_written && has_type;
+    }
+    if (!is_static) {
+      continue;
+    }
+    auto& payload = values_[i].payload.copyable_union;
+    switch (values_[i].tag) {
+      case Tag::ListInt:
+        payload.as_int_list.cache();
+        break;
+      case Tag::ListTensor:
+        payload.as_tensor_list.cache();
+        break;
+      case Tag::ListOptionalTensor:
+        payload.as_list_optional_tensor.cache();
+        break;
+      default:
+        break;
+    }
+  }
+  temp_allocator->reset();
+}
+
+void Method::refresh_cached_lists() {
+  if (!cached_lists_dirty_) {
+    return;
+  }
+  for (size_t i = 0; i < n_value_; ++i) {
+    auto& payload = values_[i].payload.copyable_union;
+    switch (values_[i].tag) {
+      case Tag::ListInt:
+        payload.as_int_list.refresh();
+        break;
+      case Tag::ListTensor:
+        payload.as_tensor_list.refresh();
+        break;
+      case Tag::ListOptionalTensor:
+        payload.as_list_optional_tensor.refresh();
+        break;
+      default:
+        break;
+    }
+  }
+  cached_lists_dirty_ = false;
+}
+
+Error Method::validate_memory_plan_buckets() {
+  const auto* buckets = serialization_plan_->memory_plan_buckets();
+  if (buckets == nullptr || buckets->size() == 0) {
+    return Error::Ok;
+  }
+  // Each bucket bounds every dimension of every input tensor.
+  size_t num_input_dims = 0;
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    const EValue& input = values_[get_input_index(i)];
+    if (input.isTensor()) {
+      num_input_dims += input.toTensor().dim();
+    }
+  }
+  const auto* s_values = serialization_plan_->values();
+  for (size_t b = 0; b < buckets->size(); ++b) {
+    const auto* bucket = buckets->Get(b);
+    ET_CHECK_OR_RETURN_ERROR(
+        bucket->input_sizes() != nullptr &&
+            bucket->input_sizes()->size() == num_input_dims,
+        InvalidProgram,
+        "Memory plan bucket %zu does not bound the %zu input dimensions",
+        b,
+        num_input_dims);
+    const auto* value_indices = bucket->value_indices();
+    const auto* allocations = bucket->allocations();
+    ET_CHECK_OR_RETURN_ERROR(
+        value_indices != nullptr && allocations != nullptr &&
+            value_indices->size() == allocations->size(),
+        InvalidProgram,
+        "Memory plan bucket %zu has mismatched allocations",
+        b);
+    for (size_t i = 0; i < value_indices->size(); ++i) {
+      const size_t index = value_indices->Get(i);
+      ET_CHECK_OR_RETURN_ERROR(
+          index < n_value_ && values_[index].isTensor(),
+          InvalidProgram,
+          "Memory plan bucket %zu moves value %zu, which is not a tensor",
+          b,
+          index);
+      const auto* s_tensor = s_values->Get(index)->val_as_Tensor();
+      ET_CHECK_OR_RETURN_ERROR(
+          s_tensor != nullptr && s_tensor->allocation_info() != nullptr &&
+              s_tensor->data_buffer_idx() == 0,
+          InvalidProgram,
+          "Memory plan bucket %zu moves value %zu, which is not memory-planned",
+          b,
+          index);
+      // Tensors are at their upper bound sizes until the first execution.
+      Result<void*> address = deserialization::getMemPlannedPtr(
+          allocations->Get(i),
+          values_[index].toTensor().nbytes(),
+          memory_manager_->planned_memory());
+      if (!address.ok()) {
+        ET_LOG(
+            Error,
+            "Memory plan bucket %zu places value %zu outside planned memory",
+            b,
+            index);
+        return address.error();
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::select_memory_plan() {
+  const auto* buckets = serialization_plan_->memory_plan_buckets();
+  if (buckets == nullptr || buckets->size() == 0) {
+    return Error::Ok;
+  }
+  int32_t selected = -1;
+  for (size_t b = 0; b < buckets->size() && selected < 0; ++b) {
+    const auto* input_sizes = buckets->Get(b)->input_sizes();
+    size_t dim_idx = 0;
+    bool fits = true;
+    for (size_t i = 0; fits && i < inputs_size(); ++i) {
+      const EValue& input = values_[get_input_index(i)];
+      if (!input.isTensor()) {
+        continue;
+      }
+      for (const auto size : input.toTensor().sizes()) {
+        if (dim_idx >= input_sizes->size() ||
+            size > input_sizes->Get(dim_idx)) {
+          fits = false;
+          break;
+        }
+        ++dim_idx;
+      }
+    }
+    if (fits) {
+      selected = static_cast<int32_t>(b);
+    }
+  }
+  if (selected == active_memory_plan_) {
+    return Error::Ok;
+  }
+  if (active_memory_plan_ >= 0) {
+    ET_CHECK_OK_OR_RETURN_ERROR(apply_memory_plan_bucket(
+        buckets->Get(active_memory_plan_), /*to_bucket=*/false));
+    active_memory_plan_ = -1;
+  }
+  if (selected >= 0) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        apply_memory_plan_bucket(buckets->Get(selected), /*to_bucket=*/true));
+    active_memory_plan_ = selected;
+  }
+  return Error::Ok;
+}
+
+Error Method::apply_memory_plan_bucket(
+    const executorch_flatbuffer::MemoryPlanBucket* bucket,
+    bool to_bucket) {
+  const auto* value_indices = bucket->value_indices();
+  for (size_t i = 0; i < value_indices->size(); ++i) {
+    const size_t index = value_indices->Get(i);
+    const executorch_flatbuffer::AllocationDetails* allocation = to_bucket
+        ? bucket->allocations()->Get(i)
+        : serialization_plan_->values()
+              ->Get(index)
+              ->val_as_Tensor()
+              ->allocation_info();
+    // validate_memory_plan_buckets() checked the bounds.
+    Result<void*> address = deserialization::getMemPlannedPtr(
+        allocation, /*nbytes=*/0, memory_manager_->planned_memory());
+    if (!address.ok()) {
+      return address.error();
+    }
+    const exec_aten::Tensor& t = values_[index].toTensor();
+    bool is_output = false;
+    for (size_t o = 0; o < outputs_size() && !is_output; ++o) {
+      is_output = get_output_index(o) == index;
+    }
+    if (is_output) {
+      // Leave outputs that set_output_data_ptr() pointed at caller memory:
+      // they are not where the plan that is being left put them.
+      const executorch_flatbuffer::AllocationDetails* current = to_bucket
+          ? serialization_plan_->values()
+                ->Get(index)
+                ->val_as_Tensor()
+                ->allocation_info()
+          : bucket->allocations()->Get(i);
+      Result<void*> current_address = deserialization::getMemPlannedPtr(
+          current, /*nbytes=*/0, memory_manager_->planned_memory());
+      if (!current_address.ok()) {
+        return current_address.error();
+      }
+      if (t.const_data_ptr() != current_address.get()) {
+        continue;
+      }
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        internal::set_tensor_data(t, address.get(), t.nbytes()));
+  }
+  return Error::Ok;
+}
+
+namespace {
+
+// The stride at which Method::warmup() touches memory. Pages are at least this
+// large on the platforms the runtime targets.
+constexpr size_t kWarmupPageSize = 4096;
+
+// Reads a byte of every page of [data, data + size), so that the pages are
+// mapped in.
+void prefault_for_read(const void* data, size_t size) {
+  const volatile uint8_t* bytes = static_cast<const volatile uint8_t*>(data);
+  for (size_t i = 0; i < size; i += kWarmupPageSize) {
+    (void)bytes[i];
+  }
+}
+
+// Writes a byte of every page of [data, data + size) back unchanged, so that
+// the pages are mapped in and backed by memory of their own.
+void prefault_for_write(void* data, size_t size) {
+  volatile uint8_t* bytes = static_cast<volatile uint8_t*>(data);
+  for (size_t i = 0; i < size; i += kWarmupPageSize) {
+    bytes[i] = bytes[i];
+  }
+}
+
+} // namespace
+
+Error Method::warmup() {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(), InvalidState, "Method not initialized");
+  EXECUTORCH_SCOPE_PROF("Method::warmup");
+  internal::EventTracerProfileScope event_tracer_profile_scope =
+      internal::EventTracerProfileScope(event_tracer_, "Method::warmup");
+
+  // Planned memory, and the temp allocator that kernels allocate from.
+  HierarchicalAllocator* planned_memory = memory_manager_->planned_memory();
+  if (planned_memory != nullptr) {
+    const MethodMeta meta = method_meta();
+    for (size_t i = 0; i < meta.num_memory_planned_buffers(); ++i) {
+      const Result<int64_t> size = meta.memory_planned_buffer_size(i);
+      if (!size.ok() || size.get() <= 0) {
+        continue;
+      }
+      Result<void*> buffer = planned_memory->get_offset_address(
+          static_cast<uint32_t>(i), 0, static_cast<size_t>(size.get()));
+      if (buffer.ok()) {
+        prefault_for_write(buffer.get(), static_cast<size_t>(size.get()));
+      }
+    }
+  }
+  MemoryAllocator* temp_allocator = memory_manager_->temp_allocator();
+  if (temp_allocator != nullptr && temp_allocator->base_address() != nullptr) {
+    prefault_for_write(temp_allocator->base_address(), temp_allocator->size());
+  }
+
+  // Constants, and any other memory the tensors already point to.
+  for (size_t i = 0; i < n_value_; ++i) {
+    if (values_[i].isTensor()) {
+      const auto& tensor = values_[i].toTensor();
+      if (tensor.const_data_ptr() != nullptr) {
+        prefault_for_read(tensor.const_data_ptr(), tensor.nbytes());
+      }
+    }
+  }
+
+  for (size_t i = 0; i < n_delegate_; ++i) {
+    Error err = delegates_[i].Warmup();
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Warmup of delegate %zu failed: 0x%" PRIx32,
+          i,
+          static_cast<uint32_t>(err));
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::enable_parallel_execution(TaskRunner* task_runner) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Parallel execution can not be enabled until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Parallel execution can not be enabled mid execution.");
+  if (task_runner == nullptr) {
+    task_runner_ = nullptr;
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      task_runner->max_concurrency() > 0,
+      InvalidArgument,
+      "TaskRunner must allow at least one concurrent task");
+  ET_CHECK_OR_RETURN_ERROR(
+      internal::event_tracer_if_enabled(event_tracer_) == nullptr,
+      NotSupported,
+      "Parallel execution does not support event tracing");
+  const auto temp_allocator = memory_manager_->temp_allocator();
+  ET_CHECK_OR_RETURN_ERROR(
+      temp_allocator == nullptr || temp_allocator->size() > 0,
+      NotSupported,
+      "Parallel execution requires a temp allocator with a fixed-size buffer");
+
+  if (!parallel_plan_initialized_) {
+    Error err = init_parallel_plan();
+    if (err != Error::Ok) {
+      return err;
+    }
+    parallel_plan_initialized_ = true;
+  }
+  task_runner_ = task_runner;
+  return Error::Ok;
+}
+
+bool Method::io_tensors_disjoint() const {
+  const auto plan = serialization_plan_;
+  const size_t n_io = inputs_size() + outputs_size();
+  auto get_io_index = [&](size_t i) {
+    return i < inputs_size() ? get_input_index(i)
+                             : get_output_index(i - inputs_size());
+  };
+  bool disjoint = true;
+  for (size_t a = 0; a < n_io && disjoint; ++a) {
+    for_each_tensor_index(plan, get_io_index(a), [&](size_t a_tensor) {
+      const auto* a_data = static_cast<const uint8_t*>(
+          values_[a_tensor].toTensor().const_data_ptr());
+      const size_t a_nbytes =
+          get_serialized_nbytes(plan->values()->Get(a_tensor)->val_as_Tensor());
+      for (size_t b = a; b < n_io && disjoint && a_data != nullptr; ++b) {
+        for_each_tensor_index(plan, get_io_index(b), [&](size_t b_tensor) {
+          const auto* b_data = static_cast<const uint8_t*>(
+              values_[b_tensor].toTensor().const_data_ptr());
+          const size_t b_nbytes = get_serialized_nbytes(
+              plan->values()->Get(b_tensor)->val_as_Tensor());
+          if (a_tensor != b_tensor && b_data != nullptr &&
+              a_data < b_data + b_nbytes && b_data < a_data + a_nbytes) {
+            disjoint = false;
+          }
+        });
+      }
+    });
+  }
+  return disjoint;
+}
+
+Error Method::execute_kernels_in_parallel(
+    const uint32_t* instr_idxs,
+    size_t num_instrs) {
+  auto& chain = chains_[step_state_.chain_idx];
+  auto temp_allocator = memory_manager_->temp_allocator();
+  size_t max_batch = task_runner_->max_concurrency();
+  max_batch = max_batch < kMaxParallelKernels ? max_batch : kMaxParallelKernels;
+
+  for (size_t i = 0; i < num_instrs; ++i) {
+    ET_CHECK_OK_OR_RETURN_ERROR(wait_for_delegate_calls_using(
+        chain.instructions_[instr_idxs[i]].args));
+  }
+
+  ParallelKernelCall calls[kMaxParallelKernels];
+  for (size_t done = 0; done < num_instrs;) {
+    const size_t remaining = num_instrs - done;
+    const size_t batch = remaining < max_batch ? remaining : max_batch;
+
+    // Give each kernel an equal, non-overlapping slice of the temp allocator.
+    size_t slice_size = 0;
+    if (temp_allocator != nullptr) {
+      slice_size = (temp_allocator->size() / batch) &
+          ~(kParallelTempAlignment - 1);
+      // Leave room for aligning the first slice.
+      slice_size = slice_size > kParallelTempAlignment
+          ? slice_size - kParallelTempAlignment
+          : 0;
+    }
+    for (size_t i = 0; i < batch; ++i) {
+      const size_t instr_idx = instr_idxs[done + i];
+      calls[i].kernel = chain.instructions_[instr_idx].kernel;
+      calls[i].args = chain.instructions_[instr_idx].args.data();
+      calls[i].bound_kernel = chain.instructions_[instr_idx].bound_kernel;
+      calls[i].bound_args = chain.instructions_[instr_idx].bound_args;
+      calls[i].temp_buffer = slice_size > 0
+          ? static_cast<uint8_t*>(
+                temp_allocator->allocate(slice_size, kParallelTempAlignment))
+          : nullptr;
+      calls[i].temp_buffer_size = calls[i].temp_buffer != nullptr
+          ? static_cast<uint32_t>(slice_size)
+          : 0;
+      calls[i].temp_used = 0;
+      calls[i].error = Error::Ok;
+    }
+
+    task_runner_->run(run_parallel_kernel_call, calls, batch);
+
+    if (temp_allocator != nullptr) {
+      temp_allocator->reset();
+    }
+    for (size_t i = 0; i < batch; ++i) {
+      record_temp_memory_use(
+          chain.instructions_[instr_idxs[done + i]], calls[i].temp_used);
+    }
+    for (size_t i = 0; i < batch; ++i) {
+      if (calls[i].error != Error::Ok) {
+        const size_t instr_idx = instr_idxs[done + i];
+        // We know that instr_args_as_KernelCall is non-null because it was
+        // checked at init time.
+        auto op_index = chain.s_chain_->instructions()
+                            ->Get(instr_idx)
+                            ->instr_args_as_KernelCall()
+                            ->op_index();
+        auto op = serialization_plan_->operators()->Get(op_index);
+        ET_LOG(
+            Error,
+            "KernelCall failed at instruction %zu:%zu in operator %s.%s: 0x%x",
+            step_state_.chain_idx,
+            instr_idx,
+            op->name()->c_str(),
+            op->overload()->c_str(),
+            (unsigned int)calls[i].error);
+        return calls[i].error;
+      }
+    }
+    done += batch;
+  }
+  return Error::Ok;
+}
+
+Error Method::execute_chain_in_parallel() {
+  auto& chain = chains_[step_state_.chain_idx];
+  size_t group_begin = 0;
+  for (size_t group = 0; group < chain.n_parallel_groups_; ++group) {
+    const size_t group_end = chain.parallel_group_ends_[group];
+    Error status;
+    if (group_end - group_begin == 1) {
+      step_state_.instr_idx = chain.parallel_order_[group_begin];
+      status = execute_instruction();
+    } else {
+      status = execute_kernels_in_parallel(
+          &chain.parallel_order_[group_begin], group_end - group_begin);
+    }
+    if (status != Error::Ok) {
+      return status;
+    }
+    group_begin = group_end;
+  }
+  step_state_.instr_idx = chain.instructions_.size();
+  return Error::Ok;
+}
+
+Error Method::wait_for_delegate_calls_using(InstructionArgs args) {
+  Error first_error = Error::Ok;
+  size_t n_kept = 0;
+  for (size_t i = 0; i < n_pending_delegate_calls_; ++i) {
+    PendingDelegateCall& call = pending_delegate_calls_[i];
+    if (!args_overlap(call.args, args)) {
+      // Keep the original order, so that waits happen in issue order.
+      pending_delegate_calls_[n_kept++] = call;
+      continue;
+    }
+    Error err = call.wait(call.wait_context);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Delegate call failed while running asynchronously: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+      if (first_error == Error::Ok) {
+        first_error = err;
+      }
+    }
+  }
+  n_pending_delegate_calls_ = n_kept;
+  return first_error;
+}
+
+Error Method::wait_for_pending_delegate_calls() {
+  Error first_error = Error::Ok;
+  for (size_t i = 0; i < n_pending_delegate_calls_; ++i) {
+    PendingDelegateCall& call = pending_delegate_calls_[i];
+    Error err = call.wait(call.wait_context);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Delegate call failed while running asynchronously: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+      if (first_error == Error::Ok) {
+        first_error = err;
+      }
+    }
+  }
+  n_pending_delegate_calls_ = 0;
+  return first_error;
+}
+
+void Method::finish_pending_delegate_calls() {
+  // The execution already failed, so only the first error is reported.
+  (void)wait_for_pending_delegate_calls();
+}
+
 Error Method::reset_execution() {
   ET_CHECK_OR_RETURN_ERROR(
       step_state_.chain_idx == n_chains_,
       InvalidState,
       "Cannot reset until EndOfMethod has been reached.");
   step_state_ = StepState{0, 0};
+  if (aliased_planned_inputs_) {
+    // Inputs bound by share_input() only last for one execution.
+    for (size_t i = 0; i < inputs_size(); ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(restore_planned_input(i));
+    }
+    aliased_planned_inputs_ = false;
+  }
   return Error::Ok;
 }
 
@@ -1224,9 +3054,12 @@ Error Method::step() {
   if (step_state_.chain_idx == n_chains_) {
     return Error::EndOfMethod;
   }
+  if (step_state_.chain_idx == 0 && step_state_.instr_idx == 0) {
+    refresh_cached_lists();
+    ET_CHECK_OK_OR_RETURN_ERROR(select_memory_plan());
+  }
 
-  auto num_instructions =
-      chains_[step_state_.chain_idx].s_chain_->instructions()->size();
+  auto num_instructions = chains_[step_state_.chain_idx].instructions_.size();
 
   // Special case chains with no instructions. These appear for example in a
   // model that just returns the input/a constant.
@@ -1237,6 +3070,7 @@ Error Method::step() {
 
   auto status = execute_instruction();
   if (status != Error::Ok) {
+    finish_pending_delegate_calls();
     return status;
   }
 
@@ -1244,6 +3078,10 @@ Error Method::step() {
   if (step_state_.instr_idx == num_instructions) {
     step_state_.instr_idx = 0;
     step_state_.chain_idx += 1;
+    if (step_state_.chain_idx == n_chains_) {
+      // The caller may read the outputs once the method ends.
+      ET_CHECK_OK_OR_RETURN_ERROR(wait_for_pending_delegate_calls());
+    }
     log_outputs();
   }
   return Error::Ok;
@@ -1262,22 +3100,29 @@ Error Method::execute() {
       initialized(),
       NotSupported,
       "Cannot execute until method has been initialized.");
+  refresh_cached_lists();
+  ET_CHECK_OK_OR_RETURN_ERROR(select_memory_plan());
+  const bool run_in_parallel =
+      task_runner_ != nullptr && io_tensors_disjoint();
 
   // Chains are executed sequentially today, but future async designs may
   // branch and run many in parallel or out of order.
   for (step_state_.chain_idx = 0; step_state_.chain_idx < n_chains_;
        ++step_state_.chain_idx) {
     Chain& chain = chains_[step_state_.chain_idx];
-    auto instructions = chain.s_chain_->instructions();
-    ET_CHECK_OR_RETURN_ERROR(
-        instructions != nullptr,
-        Internal,
-        "chain %zu has no instructions field",
-        step_state_.chain_idx);
 
     // Loop over instructions
     step_state_.instr_idx = 0;
-    while (step_state_.instr_idx < chain.s_chain_->instructions()->size()) {
+    if (run_in_parallel && chain.parallel_order_ != nullptr) {
+      auto status = execute_chain_in_parallel();
+      if (status != Error::Ok) {
+        finish_pending_delegate_calls();
+        return status;
+      }
+      continue;
+    }
+    const size_t num_instructions = chain.instructions_.size();
+    while (step_state_.instr_idx < num_instructions) {
       EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
           static_cast<int32_t>(step_state_.chain_idx),
           static_cast<uint32_t>(step_state_.instr_idx));
@@ -1288,11 +3133,14 @@ Error Method::execute() {
               static_cast<DebugHandle>(step_state_.instr_idx));
       auto status = execute_instruction();
       if (status != Error::Ok) {
+        finish_pending_delegate_calls();
         return status;
       }
     }
   }
 
+  // Delegates may still be writing the outputs.
+  ET_CHECK_OK_OR_RETURN_ERROR(wait_for_pending_delegate_calls());
   log_outputs();
 
   // TODO(jakeszwe, dbort): Decide on calling execute back to back without
@@ -1336,6 +3184,7 @@ const EValue& Method::get_input(size_t i) const {
 }
 
 EValue& Method::mutable_input(size_t i) {
+  cached_lists_dirty_ = true;
   return mutable_value(get_input_index(i));
 }
 
@@ -1354,6 +3203,7 @@ const EValue& Method::get_output(size_t i) const {
 }
 
 EValue& Method::mutable_output(size_t i) {
+  cached_lists_dirty_ = true;
   return mutable_value(get_output_index(i));
 }
 
@@ -1362,6 +3212,8 @@ EventTracer* Method::get_event_tracer() {
 }
 
 Method::~Method() {
+  // Delegates must not write to the values after they are gone.
+  finish_pending_delegate_calls();
   // Destroy the values. It's necessary in ATen mode, where the refcount of
   // Tensors needs to be decremented properly.
   if (values_ != nullptr) {
@@ -1375,6 +3227,12 @@ Method::~Method() {
       delegates_[i].~BackendDelegate();
     }
   }
+  // Free lazily-loaded constants only after nothing can point to them.
+  if (constant_data_ != nullptr) {
+    for (size_t i = 0; i < n_constant_data_; i++) {
+      constant_data_[i].~FreeableBuffer();
+    }
+  }
   // All other fields are trivially destructible.
 }
 } // namespace runtime
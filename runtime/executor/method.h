@@ -8,12 +8,15 @@
 
 #pragma once
 
+#include <executorch/runtime/backend/backend_options.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/freeable_buffer.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method_meta.h>
+#include <executorch/runtime/executor/task_runner.h>
 #include <executorch/runtime/platform/compiler.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
@@ -22,6 +25,7 @@ namespace executorch_flatbuffer {
 struct Chain;
 struct ExecutionPlan;
 struct EValue;
+struct MemoryPlanBucket;
 } // namespace executorch_flatbuffer
 
 namespace executorch {
@@ -32,7 +36,10 @@ class Program;
 
 // Forward declare internal types.
 class BackendDelegate;
+class NamedDataMap;
 struct Chain;
+struct Instruction;
+struct Kernel;
 class KernelRuntimeContext;
 using OpFunction = void (*)(KernelRuntimeContext&, EValue**);
 /// A list of pointers into the master values table that together compose the
@@ -63,13 +70,26 @@ class Method final {
         chains_(rhs.chains_),
         init_state_(rhs.init_state_),
         pre_allocated_input_(rhs.pre_allocated_input_),
-        pre_allocated_output_(rhs.pre_allocated_output_) {
+        pre_allocated_output_(rhs.pre_allocated_output_),
+        aliased_planned_inputs_(rhs.aliased_planned_inputs_),
+        n_pending_delegate_calls_(rhs.n_pending_delegate_calls_),
+        cached_lists_dirty_(rhs.cached_lists_dirty_),
+        active_memory_plan_(rhs.active_memory_plan_),
+        parallel_plan_initialized_(rhs.parallel_plan_initialized_),
+        task_runner_(rhs.task_runner_),
+        backend_options_(rhs.backend_options_),
+        temp_memory_peak_(rhs.temp_memory_peak_),
+        temp_allocator_id_(rhs.temp_allocator_id_),
+        n_constant_data_(rhs.n_constant_data_),
+        constant_data_(rhs.constant_data_) {
     // Required: clear out fields that the dtor looks at, so that we don't free
     // anything twice.
     rhs.n_value_ = 0;
     rhs.values_ = nullptr;
     rhs.n_delegate_ = 0;
     rhs.delegates_ = nullptr;
+    rhs.n_constant_data_ = 0;
+    rhs.constant_data_ = nullptr;
 
     // Helpful: Try to ensure that any other interactions with the old object
     // result in failures.
@@ -83,6 +103,13 @@ class Method final {
     rhs.chains_ = nullptr;
     rhs.pre_allocated_input_ = false;
     rhs.pre_allocated_output_ = false;
+    rhs.aliased_planned_inputs_ = false;
+    rhs.n_pending_delegate_calls_ = 0;
+    rhs.cached_lists_dirty_ = false;
+    rhs.active_memory_plan_ = -1;
+    rhs.parallel_plan_initialized_ = false;
+    rhs.task_runner_ = nullptr;
+    rhs.backend_options_ = {};
   }
 
   /**
@@ -105,6 +132,25 @@ class Method final {
    */
   ET_NODISCARD Error set_input(const EValue& input_evalue, size_t input_idx);
 
+  /**
+   * Like set_input(), but memory-planned tensor inputs alias the data of
+   * `input_evalue` for the next execution instead of copying it into the
+   * planned memory, which saves a copy of large inputs.
+   *
+   * The tensor's data must stay valid and unchanged until the execution ends,
+   * and inputs that the method mutates write to it. Inputs are copied as
+   * set_input() does if the data is not aligned to alignof(std::max_align_t)
+   * or if the input is also a method output. After the execution ends, the
+   * input uses its planned memory again.
+   *
+   * @param[in] input_evalue The evalue to alias or copy into the method input.
+   * @param[in] input_idx Zero-based index of the input to set. Must be less
+   *     than the value returned by inputs_size().
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  ET_NODISCARD Error share_input(const EValue& input_evalue, size_t input_idx);
+
   /**
    * Sets the values of all method inputs.
    *
@@ -128,16 +174,23 @@ class Method final {
    * point those tensors to the buffer provided here, so the user should take
    * care that the life span of this memory outlasts the executor forward.
    *
+   * Outputs that the memory plan placed are pointed at the buffer as well, so
+   * the kernels that produce them write directly to it and the outputs need
+   * not be copied out after execution. The output then stays in the buffer
+   * for later executions. This is not possible for outputs that are
+   * constants, method inputs, or views of other tensors.
+   *
    * @param[in] buffer The block of memory to point the specified tensor at.
    *
    * @param[in] size the length of buffer in bytes, must be >= the nbytes of the
-   * specified tensor.
+   * specified tensor, or of its planned upper bound size if the memory plan
+   * placed it.
    *
    * @param[in] output_idx The index of the output to set the data_ptr for. Must
-   *     correspond to a tensor, and that tensor must not have had a buffer
-   *     allocated by the memory plan.
+   *     correspond to a tensor.
    *
-   * @returns Error::Ok on success, non-Ok on failure.
+   * @returns Error::Ok on success, Error::InvalidState if the output can not
+   *     be pointed at other memory, other non-Ok values on failure.
    */
   ET_NODISCARD Error
   set_output_data_ptr(void* buffer, size_t size, size_t output_idx);
@@ -213,6 +266,155 @@ class Method final {
   /// DEPRECATED: Use `reset_execution()` instead.
   ET_DEPRECATED ET_NODISCARD Error experimental_reset_execution();
 
+  /**
+   * EXPERIMENTAL: Lets execute() run kernel calls that do not depend on each
+   * other at the same time, using `task_runner` to provide the threads.
+   *
+   * The first call builds a schedule from the serialized program: within a
+   * run of consecutive KernelCall instructions, two calls to ATen out variants
+   * may run together if neither one's out argument, which the emitter passes
+   * last, may share memory with an argument of the other. Tensors are compared
+   * by their planned allocations in every memory plan bucket. The memory of
+   * the method inputs and outputs, which set_input(), share_input() and
+   * set_output_data_ptr() can point anywhere, is checked at each execute():
+   * if two of them share memory, that execution runs sequentially. Calls to
+   * other operators, delegate calls, moves, frees and chains containing jumps
+   * still run sequentially. step() is not affected.
+   *
+   * Concurrent kernels split the temp allocator evenly between them, and do
+   * not see the event tracer.
+   *
+   * @param[in] task_runner Runs the concurrent kernel calls. Must outlive the
+   *     Method or the next call to this method. Pass nullptr to go back to
+   *     fully sequential execution.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::NotSupported if the Method has an event tracer, or its temp
+   *     allocator is not backed by a fixed-size buffer.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  enable_parallel_execution(TaskRunner* task_runner);
+
+  /**
+   * Sets runtime options that every delegate of this Method sees when it
+   * executes, through BackendExecutionContext::get_backend_options(). Use it
+   * to tune one model, e.g. to run it at a lower precision; use
+   * set_backend_options() with a backend name for settings that apply to the
+   * whole backend. Backends ignore keys they do not know.
+   *
+   * @param[in] options The options. Not copied: they must outlive the Method
+   *     or the next call to this method. Pass an empty list to clear them.
+   */
+  void set_backend_options(ArrayRef<BackendOption> options) {
+    backend_options_ = options;
+  }
+
+  /**
+   * Prepares the Method for its first execution without executing it, so
+   * that the first execute() is not slowed down by page faults and lazily
+   * built delegate state. Call it off the critical path, e.g. on a background
+   * thread after loading, but never concurrently with execute().
+   *
+   * Touches every page of the memory-planned buffers and of the temp
+   * allocator, reads every page of the data of the tensors, e.g. constants
+   * that are mapped from the program file, and calls the warmup() hook of
+   * every delegate. The contents of the memory, including inputs that were
+   * already set, are unchanged.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState The Method is not initialized.
+   * @returns The error of the first delegate whose warmup failed.
+   */
+  ET_NODISCARD Error warmup();
+
+  /**
+   * Keeps snapshots of the operators that Method::init() resolved, so that
+   * later loads of the same method skip resolving them: no operator names are
+   * formatted, no TensorMeta lists are allocated from the method allocator,
+   * and the kernel registry is not searched.
+   *
+   * A snapshot records the index in get_kernels() of the kernel that each
+   * KernelCall instruction resolved to, and is opaque to the cache. The
+   * Method checks each index against the operator name before using it, and
+   * only uses snapshots when every registered kernel is a fallback kernel, so
+   * a snapshot of another program or kernel registry is never wrong, only
+   * ignored and replaced. See extension/method_init_cache for one that maps
+   * snapshots from files.
+   */
+  class InitCache {
+   public:
+    virtual ~InitCache() = default;
+
+    /**
+     * Returns the snapshot last passed to save() for the method, or an
+     * error if there is none. The Method releases it before init() returns.
+     *
+     * @param[in] method_name The name of the method being loaded.
+     */
+    virtual Result<FreeableBuffer> load(const char* method_name) = 0;
+
+    /**
+     * Called once the method is initialized when load() returned no snapshot
+     * or one that did not match, with the snapshot to return next time.
+     *
+     * @param[in] method_name The name of the method that was loaded.
+     * @param[in] data The snapshot. Only valid during this call.
+     * @param[in] size The size of `data` in bytes.
+     */
+    virtual void
+    save(const char* method_name, const void* data, size_t size) = 0;
+  };
+
+  /**
+   * Creates another instance of this Method that can execute independently of
+   * it, e.g. to serve concurrent requests with the same model.
+   *
+   * The new instance shares the Program and its constant data with this one,
+   * and reuses the operators that this Method already resolved, so it skips
+   * the kernel registry lookups that dominate load time. It gets its own
+   * values, delegate instances and planned memory from `memory_manager`.
+   * Inputs, outputs, backend options and the parallel execution setting are
+   * not copied.
+   *
+   * @param[in] memory_manager The allocators used by the new instance. Must
+   *     not be the MemoryManager of this Method or of any other live instance.
+   * @param[in] event_tracer The event tracer used by the new instance, if any.
+   *
+   * @returns The new instance on success, or an error on failure. This Method
+   *     does not need to outlive the new instance.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<Method> clone(
+      MemoryManager* memory_manager,
+      EventTracer* event_tracer = nullptr) const;
+
+  /**
+   * Returns the most temp allocator memory, in bytes, that a single
+   * instruction has used during the executions of this Method so far.
+   *
+   * After executing the Method on representative inputs, a temp allocator of
+   * this size is large enough for sequential execution, so this can be used to
+   * size the temp allocator exactly. With parallel execution, every kernel in a
+   * concurrent group needs this much of its own slice.
+   *
+   * Memory is measured with MemoryAllocator::used_size(), so alignment padding
+   * is included. When an event tracer is set, each instruction's usage is also
+   * reported to it as an allocation by the "temp_allocator" allocator.
+   */
+  ET_EXPERIMENTAL size_t temp_memory_peak_bytes() const;
+
+  /**
+   * Returns the most temp allocator memory, in bytes, that one execution of
+   * the specified instruction has used so far.
+   *
+   * @param[in] chain_idx The index of the chain that holds the instruction.
+   * @param[in] instr_idx The index of the instruction in the chain.
+   *
+   * @retval Error::InvalidArgument The instruction does not exist.
+   */
+  ET_EXPERIMENTAL Result<size_t> instruction_temp_memory_peak_bytes(
+      size_t chain_idx,
+      size_t instr_idx) const;
+
   /**
    * Returns the MethodMeta that corresponds to the calling Method.
    */
@@ -287,21 +489,53 @@ class Method final {
         chains_(nullptr),
         init_state_(InitializationState::Uninitialized),
         pre_allocated_input_(false),
-        pre_allocated_output_(false) {}
+        pre_allocated_output_(false),
+        aliased_planned_inputs_(false),
+        n_pending_delegate_calls_(0),
+        cached_lists_dirty_(false),
+        active_memory_plan_(-1),
+        parallel_plan_initialized_(false),
+        task_runner_(nullptr),
+        backend_options_(),
+        temp_memory_peak_(0),
+        temp_allocator_id_(0),
+        n_constant_data_(0),
+        constant_data_(nullptr) {}
 
   /// Static factory used by Program.
   ET_NODISCARD static Result<Method> load(
       executorch_flatbuffer::ExecutionPlan* s_plan,
       const Program* program,
       MemoryManager* memory_manager,
-      EventTracer* event_tracer);
+      EventTracer* event_tracer,
+      TaskRunner* delegate_init_runner = nullptr,
+      InitCache* init_cache = nullptr);
 
   /**
    * Initialize the method from its serialized representation.
    *
+   * @param[in] s_plan The serialized method.
+   * @param[in] source If non-null, an initialized Method loaded from the same
+   *     `s_plan` whose resolved operators should be reused.
+   * @param[in] delegate_init_runner If non-null, initializes the delegates
+   *     concurrently on this runner.
+   * @param[in] init_cache If non-null and `source` is null, the operators are
+   *     taken from its snapshot where it matches, and a new snapshot is saved
+   *     to it where it does not.
+   *
    * @returns Error::Ok on success, non-Ok on failure.
    */
-  ET_NODISCARD Error init(executorch_flatbuffer::ExecutionPlan* s_plan);
+  ET_NODISCARD Error init(
+      executorch_flatbuffer::ExecutionPlan* s_plan,
+      const Method* source = nullptr,
+      TaskRunner* delegate_init_runner = nullptr,
+      InitCache* init_cache = nullptr);
+
+  // Initializes all of delegates_ with up to runner->max_concurrency() init()
+  // calls at once, and sets n_delegate_ on success.
+  ET_NODISCARD Error init_delegates_in_parallel(
+      const NamedDataMap& named_data_map,
+      TaskRunner* runner);
 
   /// Returns true if the Method was successfully initialized.
   inline bool initialized() const {
@@ -316,6 +550,43 @@ class Method final {
   // Executes a single instruction using the state in step_state_
   ET_NODISCARD Error execute_instruction();
 
+  // Updates the temp memory statistics after `instruction` used `used` bytes
+  // of the temp allocator.
+  void record_temp_memory_use(Instruction& instruction, size_t used);
+
+  // Executes the chain at step_state_.chain_idx using its parallel schedule.
+  ET_NODISCARD Error execute_chain_in_parallel();
+
+  // Runs a group of independent KernelCall instructions of the current chain
+  // on task_runner_.
+  ET_NODISCARD Error
+  execute_kernels_in_parallel(const uint32_t* instr_idxs, size_t num_instrs);
+
+  /**
+   * A delegate call whose backend returned from execute() before finishing,
+   * see BackendExecutionContext::set_completion().
+   */
+  struct PendingDelegateCall {
+    Error (*wait)(void* wait_context);
+    void* wait_context;
+    InstructionArgs args;
+  };
+
+  // The most delegate calls that may run asynchronously at once. Further
+  // calls are waited for as soon as they return.
+  static constexpr size_t kMaxPendingDelegateCalls = 4;
+
+  // Waits for the pending delegate calls whose arguments overlap `args`, and
+  // returns the first error any of them reported.
+  ET_NODISCARD Error wait_for_delegate_calls_using(InstructionArgs args);
+
+  // Waits for all pending delegate calls, and returns the first error any of
+  // them reported.
+  ET_NODISCARD Error wait_for_pending_delegate_calls();
+
+  // Waits for all pending delegate calls after the execution failed.
+  void finish_pending_delegate_calls();
+
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
@@ -334,6 +605,30 @@ class Method final {
   InitializationState init_state_;
   bool pre_allocated_input_;
   bool pre_allocated_output_;
+  // Set when share_input() pointed a memory-planned input at caller memory.
+  bool aliased_planned_inputs_;
+  // Delegate calls that may still be running, in the order they were issued.
+  PendingDelegateCall pending_delegate_calls_[kMaxPendingDelegateCalls];
+  size_t n_pending_delegate_calls_;
+  // Set when the caller may have changed values that cached lists point to,
+  // see cache_static_lists().
+  bool cached_lists_dirty_;
+  // Index of the memory plan bucket that the planned tensors use, or -1 for
+  // the default plan. See select_memory_plan().
+  int32_t active_memory_plan_;
+
+  bool parallel_plan_initialized_;
+  TaskRunner* task_runner_;
+  // Passed to every delegate call, see set_backend_options().
+  ArrayRef<BackendOption> backend_options_;
+
+  size_t temp_memory_peak_;
+  AllocatorID temp_allocator_id_;
+
+  /// Constant data loaded for this Method when the Program loads constants
+  /// lazily. Entries may be empty.
+  size_t n_constant_data_;
+  FreeableBuffer* constant_data_;
 
   /**
    * Parses the elements of the values_ array. On error, n_value_ will be set to
@@ -342,12 +637,87 @@ class Method final {
    */
   ET_NODISCARD Error parse_values();
 
+  /**
+   * Builds the parallel schedule of every chain. See
+   * enable_parallel_execution().
+   */
+  ET_NODISCARD Error init_parallel_plan();
+
+  /**
+   * Returns true if no two distinct tensors of the method inputs and outputs
+   * currently share memory. The parallel schedule assumes that they don't, so
+   * execute() runs sequentially otherwise.
+   */
+  bool io_tensors_disjoint() const;
+
+  /**
+   * Unwraps the lists whose elements no instruction can replace once, so that
+   * list-taking kernels do not unwrap them on every call. Needs the temp
+   * allocator for scratch memory; lists stay unwrapped on use without one.
+   */
+  void cache_static_lists();
+
+  /// Unwraps the cached lists again if cached_lists_dirty_ is set.
+  void refresh_cached_lists();
+
+  /**
+   * Checks that the memory plan buckets of the method only move
+   * memory-planned tensors, and only inside the planned memory even at their
+   * upper bound sizes.
+   */
+  ET_NODISCARD Error validate_memory_plan_buckets();
+
+  /**
+   * Moves the tensors of the memory plan buckets to the first bucket that
+   * fits the current inputs, or back to their default locations if no bucket
+   * does. Only intermediate and output tensors move, and each execution
+   * recomputes them, so no data is copied.
+   */
+  ET_NODISCARD Error select_memory_plan();
+
+  /**
+   * Points the tensors that `bucket` moves at their locations in it if
+   * `to_bucket` is true, and at their default locations otherwise.
+   */
+  ET_NODISCARD Error apply_memory_plan_bucket(
+      const executorch_flatbuffer::MemoryPlanBucket* bucket,
+      bool to_bucket);
+
+  ET_NODISCARD Error set_input_impl(
+      const EValue& input_evalue,
+      size_t input_idx,
+      bool alias_planned);
+
+  /// Returns true if share_input() may alias `t_src` for the input.
+  bool can_alias_planned_input(
+      size_t input_idx,
+      const exec_aten::Tensor& t_src) const;
+
+  /// Points the input back at its planned memory, if it has any.
+  ET_NODISCARD Error restore_planned_input(size_t input_idx);
+
+  /**
+   * Returns true if set_output_data_ptr() may point the memory-planned tensor
+   * at `value_index` at other memory.
+   */
+  bool output_is_retargetable(size_t value_index) const;
+
+  /**
+   * Resolves the kernel of a KernelCall instruction whose `args` are set, and
+   * binds its arguments if the kernel can be called unboxed.
+   *
+   * @param[out] kernel If not null, set to the resolved kernel on success.
+   */
   ET_NODISCARD Error resolve_operator(
       int32_t op_index,
-      OpFunction* kernels,
-      size_t kernel_index,
-      InstructionArgs args,
-      size_t n_args);
+      Instruction* instruction,
+      const Kernel** kernel = nullptr);
+
+  /**
+   * Makes a KernelCall instruction whose `args` are set call `kernel`, binding
+   * its arguments if the kernel can be called unboxed.
+   */
+  ET_NODISCARD Error use_kernel(const Kernel& kernel, Instruction* instruction);
 
   void log_outputs();
 };
@@ -10,6 +10,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/executor/memory_manager.h>
@@ -60,11 +61,58 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
   return Error::InvalidArgument;
 }
 
+/**
+ * Loads a whole segment, asking the loader to decompress it if it's stored
+ * compressed.
+ */
+Result<FreeableBuffer> load_segment_data(
+    const DataLoader* loader,
+    size_t segment_base_offset,
+    const executorch_flatbuffer::DataSegment* segment,
+    DataLoader::SegmentInfo segment_info) {
+  switch (segment->compression()) {
+    case executorch_flatbuffer::SegmentCompression::NONE:
+      return loader->load(
+          segment_base_offset + segment->offset(),
+          segment->size(),
+          segment_info);
+    case executorch_flatbuffer::SegmentCompression::LZ4_BLOCKS:
+      segment_info.compression =
+          DataLoader::SegmentInfo::Compression::Lz4Blocks;
+      break;
+    default:
+      ET_LOG(
+          Error,
+          "Segment %zu has unknown compression %d",
+          segment_info.segment_index,
+          static_cast<int>(segment->compression()));
+      return Error::NotSupported;
+  }
+  segment_info.uncompressed_size = segment->uncompressed_size();
+  Result<FreeableBuffer> data = loader->load(
+      segment_base_offset + segment->offset(), segment->size(), segment_info);
+  if (!data.ok()) {
+    return data.error();
+  }
+  // Compressed data is never the size of the uncompressed data, so a loader
+  // that returns it as stored is caught here.
+  ET_CHECK_OR_RETURN_ERROR(
+      data->size() == segment->uncompressed_size(),
+      NotSupported,
+      "Segment %zu is compressed but the data loader returned %zu bytes "
+      "instead of %" PRIu64 "; load it through a DecompressingDataLoader",
+      segment_info.segment_index,
+      data->size(),
+      segment->uncompressed_size());
+  return data;
+}
+
 } // namespace
 
 /* static */ Result<Program> Program::load(
     DataLoader* loader,
-    Program::Verification verification) {
+    Program::Verification verification,
+    Program::ConstantLoading constant_loading) {
   EXECUTORCH_SCOPE_PROF("Program::load");
 
   // See if the program size is in the header.
@@ -177,9 +225,24 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
     const executorch_flatbuffer::DataSegment* data_segment =
         segments->Get(constant_segment->segment_index());
-    Result<FreeableBuffer> constant_segment_data = loader->load(
-        segment_base_offset + data_segment->offset(),
-        data_segment->size(),
+    // A compressed segment can't be loaded one tensor at a time.
+    if (constant_loading == ConstantLoading::Lazy &&
+        data_segment->compression() ==
+            executorch_flatbuffer::SegmentCompression::NONE) {
+      // Methods will load the constants they use one tensor at a time.
+      return Program(
+          loader,
+          segment_base_offset,
+          std::move(program_data.get()),
+          flatbuffer_program,
+          /*constant_segment_data=*/FreeableBuffer{},
+          /*lazy_constants=*/true);
+    }
+
+    Result<FreeableBuffer> constant_segment_data = load_segment_data(
+        loader,
+        segment_base_offset,
+        data_segment,
         DataLoader::SegmentInfo(
             DataLoader::SegmentInfo::Type::Constant,
             constant_segment->segment_index()));
@@ -235,7 +298,9 @@ Result<const char*> Program::get_method_name(size_t plan_index) const {
 Result<Method> Program::load_method(
     const char* method_name,
     MemoryManager* memory_manager,
-    EventTracer* event_tracer) const {
+    EventTracer* event_tracer,
+    TaskRunner* delegate_init_runner,
+    Method::InitCache* init_cache) const {
   EXECUTORCH_SCOPE_PROF("Program::load_method");
   internal::event_tracer_create_event_block(event_tracer, "Default");
   internal::EventTracerProfileScope event_tracer_scope =
@@ -251,7 +316,13 @@ Result<Method> Program::load_method(
   if (!plan.ok()) {
     return plan.error();
   }
-  return Method::load(plan.get(), this, memory_manager, event_tracer);
+  return Method::load(
+      plan.get(),
+      this,
+      memory_manager,
+      event_tracer,
+      delegate_init_runner,
+      init_cache);
 }
 
 Result<MethodMeta> Program::method_meta(const char* method_name) const {
@@ -282,6 +353,12 @@ Result<const void*> Program::get_constant_buffer_data(
   auto internal_program =
       static_cast<const executorch_flatbuffer::Program*>(internal_program_);
 
+  ET_CHECK_OR_RETURN_ERROR(
+      !lazy_constants_,
+      NotSupported,
+      "Constants are loaded lazily; constant buffer %zu is owned by the Method",
+      buffer_index);
+
   // Constant data is either in a separate segment (constant_segment_data) and
   // loaded during Program::load, or stored inside the flatbuffer data
   // (constant_buffer).
@@ -340,6 +417,45 @@ Result<const void*> Program::get_constant_buffer_data(
   }
 }
 
+Result<FreeableBuffer> Program::load_constant_data(
+    size_t buffer_index,
+    size_t nbytes,
+    const char* name) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      lazy_constants_, InvalidState, "Constants are not loaded lazily");
+  // Program::load() already checked that the segment index is valid.
+  const auto* constant_segment = internal_program_->constant_segment();
+  size_t num_elems = constant_segment->offsets()->size();
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer_index < num_elems,
+      InvalidArgument,
+      "Constant segment buffer index %zu invalid for program constant segment range %zu",
+      buffer_index,
+      num_elems);
+
+  // Offsets are relative to the beginning of the constant segment.
+  uint64_t offset =
+      static_cast<uint64_t>((*constant_segment->offsets())[buffer_index]);
+  const auto* data_segment =
+      internal_program_->segments()->Get(constant_segment->segment_index());
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + nbytes <= data_segment->size(),
+      InvalidArgument,
+      "Constant segment offset %" PRIu64
+      " + size_bytes %zu invalid for program constant segment size %" PRIu64,
+      offset,
+      nbytes,
+      data_segment->size());
+
+  return loader_->load(
+      segment_base_offset_ + data_segment->offset() + offset,
+      nbytes,
+      DataLoader::SegmentInfo(
+          DataLoader::SegmentInfo::Type::Constant,
+          constant_segment->segment_index(),
+          name));
+}
+
 Result<const char*> Program::get_output_flattening_encoding(
     const char* method_name) const {
   auto plan = get_execution_plan(internal_program_, method_name);
@@ -406,8 +522,26 @@ Result<FreeableBuffer> Program::LoadSegment(
   // Could fail if offset and size are out of bound for the data, or if this
   // is reading from a file and fails, or for many other reasons depending on
   // the implementation of the loader.
-  return loader_->load(
-      segment_base_offset_ + segment->offset(), segment->size(), segment_info);
+  return load_segment_data(
+      loader_, segment_base_offset_, segment, segment_info);
+}
+
+Result<FreeableBuffer> Program::get_named_data(const char* key) const {
+  const auto* named_data = internal_program_->named_data();
+  if (named_data != nullptr) {
+    for (size_t i = 0; i < named_data->size(); ++i) {
+      const auto* entry = named_data->Get(i);
+      if (entry->key() != nullptr &&
+          std::strcmp(entry->key()->c_str(), key) == 0) {
+        return LoadSegment(DataLoader::SegmentInfo(
+            DataLoader::SegmentInfo::Type::Backend,
+            entry->segment_index(),
+            key));
+      }
+    }
+  }
+  ET_LOG(Error, "No named data for key '%s'", key);
+  return Error::NotFound;
 }
 
 Error Program::load_mutable_subsegment_into(
@@ -474,6 +608,16 @@ Error Program::load_mutable_subsegment_into(
   auto segment =
       internal_program_->segments()->Get(segment_offsets->segment_index());
 
+  // Parts of a compressed segment can't be loaded on their own.
+  if (segment->compression() !=
+      executorch_flatbuffer::SegmentCompression::NONE) {
+    ET_LOG(
+        Error,
+        "Mutable segment %u is compressed",
+        segment_offsets->segment_index());
+    return Error::NotSupported;
+  }
+
   // Check size
   if (offset + size > segment->size()) {
     ET_LOG(
@@ -68,6 +68,30 @@ class Program final {
     InternalConsistency,
   };
 
+  /**
+   * When to load constant tensor data that is stored in a separate segment of
+   * the program file. Has no effect on constants stored inside the program
+   * flatbuffer.
+   */
+  enum class ConstantLoading : uint8_t {
+    /**
+     * Load the whole constant segment in Program::load(). All methods share
+     * the same copy of the data.
+     */
+    Eager,
+    /**
+     * Load each constant tensor through the DataLoader when a Method that uses
+     * it is loaded. The data is owned by that Method, and is freed when the
+     * Method is destroyed; destroying a rarely-used Method therefore evicts
+     * the constants that only it uses. Methods that share a constant each
+     * load their own copy of it, unless the DataLoader itself shares the data
+     * (e.g. by mapping the file). Constants whose name the program records
+     * are loaded with it as the segment descriptor, which lets a DataLoader
+     * serve them from elsewhere.
+     */
+    Lazy,
+  };
+
   /**
    * Loads a Program from the provided loader. The Program will hold a pointer
    * to the loader, which must outlive the returned Program instance.
@@ -77,10 +101,13 @@ class Program final {
    *     instance.
    * @param[in] verification The type of verification to do before returning
    *     success.
+   * @param[in] constant_loading When to load constant data stored in a
+   *     separate segment.
    */
   ET_NODISCARD static Result<Program> load(
       DataLoader* loader,
-      Verification verification = Verification::Minimal);
+      Verification verification = Verification::Minimal,
+      ConstantLoading constant_loading = ConstantLoading::Eager);
 
   /// DEPRECATED: Use the lowercase `load()` instead.
   ET_DEPRECATED ET_NODISCARD static Result<Program> Load(
@@ -95,9 +122,18 @@ class Program final {
 
   /**
    * Get the constant buffer inside Program with index buffer_idx.
+   *
+   * The data is never copied: it points into the data that the DataLoader
+   * returned for the program or its constant segment. With a DataLoader that
+   * maps the file, like MmapDataLoader, constants are used in place and keep
+   * the alignment they were serialized with.
+   *
    * @param[in] buffer_idx the index of the buffer in the constant_buffer.
    * @param[in] nbytes the number of bytes to read from the buffer.
    * @return The buffer with corresponding index.
+   * @retval Error::NotSupported The Program was loaded with
+   *     ConstantLoading::Lazy and the constants live in a separate segment, so
+   *     there is no shared copy of the data to point into.
    */
   Result<const void*> get_constant_buffer_data(size_t buffer_idx, size_t nbytes)
       const;
@@ -125,13 +161,26 @@ class Program final {
    * @param[in] memory_manager The allocators to use during initialization and
    *     execution of the loaded method.
    * @param[in] event_tracer The event tracer to use for this method run.
+   * @param[in] delegate_init_runner If non-null, the backend delegates of the
+   *     method are initialized concurrently on this runner, which shortens
+   *     the load of methods that have several delegates. The method allocator
+   *     of `memory_manager` must then support concurrent allocate() calls,
+   *     see SynchronizedMemoryAllocator. If several delegates fail, the error
+   *     of the first one in the method is returned.
+   * @param[in] init_cache If non-null, the operators of the method are taken
+   *     from the snapshot that this cache saved for it on an earlier load,
+   *     where it still matches, instead of being resolved in the kernel
+   *     registry; otherwise a new snapshot is saved to it. Does not need to
+   *     outlive this call.
    *
    * @returns The loaded method on success, or an error on failure.
    */
   Result<Method> load_method(
       const char* method_name,
       MemoryManager* memory_manager,
-      EventTracer* event_tracer = nullptr) const;
+      EventTracer* event_tracer = nullptr,
+      TaskRunner* delegate_init_runner = nullptr,
+      Method::InitCache* init_cache = nullptr) const;
 
   /**
    * Gathers metadata for the named method.
@@ -229,6 +278,19 @@ class Program final {
   ET_NODISCARD Result<FreeableBuffer> LoadSegment(
       const DataLoader::SegmentInfo& segment_info) const;
 
+  /**
+   * Loads the named data stored under `key` for the delegates of the program.
+   *
+   * @param[in] key The key of the data in Program.named_data.
+   *
+   * @returns The data as a FreeableBuffer, owned by the caller.
+   * @retval Error::NotFound The program does not contain data under `key`.
+   * @returns Other errors depending on the implementation of
+   *     DataLoader: The Program.segment table is inconsistent, or the
+   *     data cannot be accessed.
+   */
+  ET_NODISCARD Result<FreeableBuffer> get_named_data(const char* key) const;
+
   /**
    * Loads a portion of a mutable segment into the provided buffer.
    *
@@ -253,19 +315,42 @@ class Program final {
       size_t size,
       void* buffer) const;
 
+  /// Returns true if constants must be loaded with load_constant_data().
+  bool has_lazy_constants() const {
+    return lazy_constants_;
+  }
+
+  /**
+   * Loads the data of a constant tensor from the constant segment through the
+   * DataLoader. Only valid if lazy_constants_ is true.
+   *
+   * @param[in] buffer_idx The index of the tensor in the constant segment.
+   * @param[in] nbytes The number of bytes to load.
+   * @param[in] name The fully qualified name of the tensor if the program
+   *     records it, passed to the DataLoader as the segment descriptor.
+   *
+   * @returns The loaded data, owned by the caller, or an error on failure.
+   */
+  ET_NODISCARD Result<FreeableBuffer> load_constant_data(
+      size_t buffer_idx,
+      size_t nbytes,
+      const char* name = nullptr) const;
+
  private:
   Program(
       DataLoader* loader,
       size_t segment_base_offset,
       FreeableBuffer&& program_data,
       const executorch_flatbuffer::Program* internal_program,
-      FreeableBuffer&& constant_segment_data)
+      FreeableBuffer&& constant_segment_data,
+      bool lazy_constants = false)
       : program_data_(std::move(program_data)),
         // Don't need the loader if there are no segments.
         loader_(segment_base_offset > 0 ? loader : nullptr),
         internal_program_(internal_program),
         segment_base_offset_(segment_base_offset),
-        constant_segment_data_(std::move(constant_segment_data)) {}
+        constant_segment_data_(std::move(constant_segment_data)),
+        lazy_constants_(lazy_constants) {}
 
   // Not copyable or assignable.
   Program(const Program& rhs) = delete;
@@ -286,8 +371,12 @@ class Program final {
   /// be present in internal_program_.
   size_t segment_base_offset_;
 
-  /// Constant segment data.
+  /// Constant segment data. Empty if lazy_constants_ is true.
   FreeableBuffer constant_segment_data_;
+
+  /// True if constants live in a segment that is loaded one tensor at a time
+  /// through load_constant_data().
+  bool lazy_constants_;
 };
 
 } // namespace runtime
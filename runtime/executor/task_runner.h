@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Runs batches of independent tasks, possibly concurrently.
+ *
+ * The core runtime does not own any threads. Clients that want a Method to run
+ * independent kernel calls at the same time provide an implementation of this
+ * interface backed by their threading library of choice; see
+ * Method::enable_parallel_execution().
+ */
+class TaskRunner {
+ public:
+  /**
+   * A task to run. `context` is the pointer passed to run(), and `task_index`
+   * is in the range [0, num_tasks).
+   */
+  using TaskFunction = void (*)(void* context, size_t task_index);
+
+  /**
+   * Returns the maximum number of tasks that this runner may execute at the
+   * same time. Callers never pass more than this many tasks to a single run()
+   * call. Must be at least 1.
+   */
+  virtual size_t max_concurrency() const = 0;
+
+  /**
+   * Calls `task(context, i)` exactly once for every i in [0, num_tasks), and
+   * returns after all of the calls have returned. The calls may happen on any
+   * thread, in any order, and concurrently with each other.
+   */
+  virtual void run(TaskFunction task, void* context, size_t num_tasks) = 0;
+
+  virtual ~TaskRunner() = default;
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -18,10 +18,23 @@ namespace executorch {
 namespace runtime {
 namespace deserialization {
 
+/**
+ * Deserializes `s_tensor`.
+ *
+ * @param[in] program The Program that contains the tensor.
+ * @param[in] memory_manager The source of memory for the tensor.
+ * @param[in] s_tensor The tensor to deserialize.
+ * @param[in] lazy_constant_data If the tensor is a constant and `program` loads
+ *     constants lazily, receives the constant data that the tensor points to.
+ *     The caller must keep it alive for as long as it uses the tensor. Must
+ *     point to an empty FreeableBuffer. May be null if the tensor is known not
+ *     to be a lazily-loaded constant.
+ */
 ET_NODISCARD Result<exec_aten::Tensor> parseTensor(
     const Program* program,
     MemoryManager* memory_manager,
-    const executorch_flatbuffer::Tensor* s_tensor);
+    const executorch_flatbuffer::Tensor* s_tensor,
+    FreeableBuffer* lazy_constant_data = nullptr);
 
 ET_NODISCARD Result<BoxedEvalueList<exec_aten::Tensor>> parseTensorList(
     const flatbuffers::Vector<int32_t>* tensor_indices,
@@ -88,6 +101,8 @@ parseListOptionalType(
  * @param[in] program The Program to use for constant buffer data.
  * @param[in] nbytes The amount of memory to get from the allocator.
  * @param[in] allocator The source of memory for non-constant tensors.
+ * @param[in] lazy_constant_data Receives the constant data if `program` loads
+ *     constants lazily; see parseTensor().
  *
  * @returns On success, the data pointer to use for the tensor. On failure, a
  *     non-Ok Error.
@@ -96,6 +111,22 @@ ET_NODISCARD Result<void*> getTensorDataPtr(
     const executorch_flatbuffer::Tensor* s_tensor,
     const Program* program,
     size_t nbytes,
+    HierarchicalAllocator* allocator,
+    FreeableBuffer* lazy_constant_data = nullptr);
+
+/**
+ * Returns the memory-planned buffer that `allocation_info` describes.
+ *
+ * @param[in] allocation_info The memory id and offset of the buffer.
+ * @param[in] nbytes The size of the buffer, which must fit in the planned
+ *     memory.
+ * @param[in] allocator The planned memory.
+ *
+ * @returns On success, the address of the buffer. On failure, a non-Ok Error.
+ */
+ET_NODISCARD Result<void*> getMemPlannedPtr(
+    const executorch_flatbuffer::AllocationDetails* allocation_info,
+    size_t nbytes,
     HierarchicalAllocator* allocator);
 
 } // namespace deserialization
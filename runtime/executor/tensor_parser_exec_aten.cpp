@@ -31,11 +31,20 @@ class TensorParser final {
     return program->load_mutable_subsegment_into(
         mutable_data_segments_index, offset_index, size, buffer);
   }
-};
 
-namespace {
+  static bool has_lazy_constants(const Program* program) {
+    return program->has_lazy_constants();
+  }
+
+  ET_NODISCARD static Result<FreeableBuffer> load_constant_data(
+      const Program* program,
+      size_t buffer_idx,
+      size_t nbytes,
+      const char* name) {
+    return program->load_constant_data(buffer_idx, nbytes, name);
+  }
+};
 
-// Retrieve the buffer specified by the allocation_info
 ET_NODISCARD Result<void*> getMemPlannedPtr(
     const executorch_flatbuffer::AllocationDetails* allocation_info,
     size_t nbytes,
@@ -66,7 +75,6 @@ ET_NODISCARD Result<void*> getMemPlannedPtr(
   }
   return allocator->get_offset_address(memory_id, memory_offset, nbytes);
 }
-} // namespace
 
 ET_NODISCARD Result<BoxedEvalueList<exec_aten::Tensor>> parseTensorList(
     const flatbuffers::Vector<int32_t>* tensor_indices,
@@ -101,7 +109,8 @@ ET_NODISCARD Result<void*> getTensorDataPtr(
     const executorch_flatbuffer::Tensor* s_tensor,
     const Program* program,
     size_t nbytes,
-    HierarchicalAllocator* allocator) {
+    HierarchicalAllocator* allocator,
+    FreeableBuffer* lazy_constant_data) {
   auto data_buffer_idx = s_tensor->data_buffer_idx();
   const executorch_flatbuffer::AllocationDetails* allocation_info =
       s_tensor->allocation_info();
@@ -122,6 +131,30 @@ ET_NODISCARD Result<void*> getTensorDataPtr(
 
     // Constant
   } else if (data_buffer_idx > 0 && allocation_info == nullptr) {
+    if (TensorParser::has_lazy_constants(program)) {
+      ET_CHECK_OR_RETURN_ERROR(
+          lazy_constant_data != nullptr,
+          NotSupported,
+          "No storage for lazily-loaded constant buffer %" PRIu32,
+          data_buffer_idx);
+      // The name lets the DataLoader serve the tensor from elsewhere, e.g.
+      // GGUFDataLoader from the weights of a GGUF file.
+      const auto* extra_info = s_tensor->extra_tensor_info();
+      const char* name =
+          extra_info != nullptr && extra_info->fully_qualified_name() != nullptr
+          ? extra_info->fully_qualified_name()->c_str()
+          : nullptr;
+      auto loaded = TensorParser::load_constant_data(
+          program, data_buffer_idx, nbytes, name);
+      if (!loaded.ok()) {
+        return loaded.error();
+      }
+      // FreeableBuffer can't be move-assigned, so replace it in place.
+      lazy_constant_data->~FreeableBuffer();
+      new (lazy_constant_data) FreeableBuffer(std::move(loaded.get()));
+      return const_cast<void*>(lazy_constant_data->data());
+    }
+
     auto const_data =
         program->get_constant_buffer_data(data_buffer_idx, nbytes);
     if (!const_data.ok()) {
@@ -31,17 +31,24 @@ using namespace ::testing;
 using exec_aten::ArrayRef;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
+using executorch::runtime::BackendOption;
 using executorch::runtime::CompileSpec;
 using executorch::runtime::DataLoader;
 using executorch::runtime::DelegateHandle;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
+using executorch::runtime::get_int_backend_option;
+using executorch::runtime::get_string_backend_option;
+using executorch::runtime::kNumThreadsBackendOption;
+using executorch::runtime::kPrecisionBackendOption;
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Method;
 using executorch::runtime::Program;
 using executorch::runtime::PyTorchBackendInterface;
 using executorch::runtime::Result;
+using executorch::runtime::set_backend_options;
+using executorch::runtime::TaskRunner;
 using executorch::runtime::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
@@ -58,6 +65,7 @@ class StubBackend final : public PyTorchBackendInterface {
       MemoryAllocator*)>;
   using ExecuteFn = std::function<Error(DelegateHandle*, EValue**)>;
   using DestroyFn = std::function<void(DelegateHandle*)>;
+  using SetOptionsFn = std::function<Error(ArrayRef<BackendOption>)>;
 
   // Default name that this backend is registered as.
   static constexpr char kName[] = "StubBackend";
@@ -94,10 +102,21 @@ class StubBackend final : public PyTorchBackendInterface {
     execute_fn_ = fn;
   }
 
+  void install_completion(
+      BackendExecutionContext::CompletionFn fn,
+      void* completion_context) {
+    completion_fn_ = fn;
+    completion_context_ = completion_context;
+  }
+
   Error execute(
-      ET_UNUSED BackendExecutionContext& context,
+      BackendExecutionContext& context,
       DelegateHandle* handle,
       EValue** args) const override {
+    if (completion_fn_ != nullptr) {
+      context.set_completion(completion_fn_, completion_context_);
+    }
+    last_execute_options_ = context.get_backend_options();
     if (execute_fn_) {
       return execute_fn_.value()(handle, args);
     }
@@ -115,6 +134,24 @@ class StubBackend final : public PyTorchBackendInterface {
     }
   }
 
+  void install_set_options(SetOptionsFn fn) {
+    set_options_fn_ = fn;
+  }
+
+  Error set_options(ArrayRef<BackendOption> options) override {
+    if (set_options_fn_) {
+      return set_options_fn_.value()(options);
+    }
+    return PyTorchBackendInterface::set_options(options);
+  }
+
+  /**
+   * Returns the options that the last execute() call saw in its context.
+   */
+  ArrayRef<BackendOption> last_execute_options() const {
+    return last_execute_options_;
+  }
+
   /**
    * Resets to the original constructed state.
    */
@@ -123,6 +160,10 @@ class StubBackend final : public PyTorchBackendInterface {
     init_fn_.reset();
     execute_fn_.reset();
     destroy_fn_.reset();
+    set_options_fn_.reset();
+    last_execute_options_ = {};
+    completion_fn_ = nullptr;
+    completion_context_ = nullptr;
   }
 
   /**
@@ -155,6 +196,10 @@ class StubBackend final : public PyTorchBackendInterface {
   std::optional<InitFn> init_fn_;
   std::optional<ExecuteFn> execute_fn_;
   std::optional<DestroyFn> destroy_fn_;
+  std::optional<SetOptionsFn> set_options_fn_;
+  mutable ArrayRef<BackendOption> last_execute_options_;
+  BackendExecutionContext::CompletionFn completion_fn_ = nullptr;
+  void* completion_context_ = nullptr;
 };
 
 bool StubBackend::registered_ = false;
@@ -484,6 +529,147 @@ TEST_P(BackendIntegrationTest, EndToEndTestWithProcessedAsHandle) {
   EXPECT_EQ(execute_handle, destroy_handle);
 }
 
+TEST_P(BackendIntegrationTest, AsyncDelegateCallIsWaitedForOnce) {
+  struct Completion {
+    int calls = 0;
+    Error status = Error::Ok;
+  } completion;
+  StubBackend::singleton().install_completion(
+      [](void* context) -> Error {
+        auto* c = static_cast<Completion*>(context);
+        c->calls++;
+        return c->status;
+      },
+      &completion);
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  // The delegate call has finished by the time execute() returns.
+  EXPECT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(completion.calls, 1);
+
+  // Errors reported by the completion fail the execution.
+  completion.status = Error::InvalidState;
+  EXPECT_EQ(method->execute(), Error::InvalidState);
+  EXPECT_EQ(completion.calls, 2);
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_P(BackendIntegrationTest, BackendOptionsReachTheBackend) {
+  // Backend-wide options go to the named backend.
+  int64_t num_threads = 0;
+  StubBackend::singleton().install_set_options(
+      [&](ArrayRef<BackendOption> options) -> Error {
+        Result<int64_t> value =
+            get_int_backend_option(options, kNumThreadsBackendOption);
+        if (!value.ok()) {
+          return value.error();
+        }
+        num_threads = value.get();
+        return Error::Ok;
+      });
+  BackendOption backend_options[] = {{kNumThreadsBackendOption, 2}};
+  EXPECT_EQ(
+      set_backend_options(StubBackend::kName, backend_options), Error::Ok);
+  EXPECT_EQ(num_threads, 2);
+  EXPECT_EQ(
+      set_backend_options("NotARegisteredBackend", backend_options),
+      Error::NotFound);
+
+  // Method options are passed to every execution.
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  BackendOption method_options[] = {{kPrecisionBackendOption, "fp16"}};
+  method->set_backend_options(method_options);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  EXPECT_EQ(method->execute(), Error::Ok);
+  torch::executor::util::FreeInputs(inputs);
+  Result<const char*> precision = get_string_backend_option(
+      StubBackend::singleton().last_execute_options(),
+      kPrecisionBackendOption);
+  ASSERT_EQ(precision.error(), Error::Ok);
+  EXPECT_STREQ(precision.get(), "fp16");
+}
+
+namespace {
+/**
+ * Runs tasks on the calling thread, and counts them.
+ */
+class CountingTaskRunner final : public TaskRunner {
+ public:
+  size_t max_concurrency() const override {
+    return 2;
+  }
+
+  void run(TaskFunction task, void* context, size_t num_tasks) override {
+    for (size_t i = 0; i < num_tasks; ++i) {
+      ++num_tasks_run;
+      task(context, i);
+    }
+  }
+
+  size_t num_tasks_run = 0;
+};
+} // namespace
+
+TEST_P(BackendIntegrationTest, DelegatesInitializeOnTaskRunner) {
+  size_t num_inits = 0;
+  Error init_error = Error::Ok;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED MemoryAllocator* runtime_allocator)
+          -> Result<DelegateHandle*> {
+        ++num_inits;
+        if (init_error != Error::Ok) {
+          return init_error;
+        }
+        return nullptr;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  CountingTaskRunner runner;
+  {
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method = program->load_method(
+        "forward", &mmm.get(), /*event_tracer=*/nullptr, &runner);
+    ASSERT_EQ(method.error(), Error::Ok);
+    EXPECT_GT(num_inits, 0);
+    EXPECT_EQ(runner.num_tasks_run, num_inits);
+
+    exec_aten::ArrayRef<void*> inputs =
+        torch::executor::util::PrepareInputTensors(*method);
+    EXPECT_EQ(method->execute(), Error::Ok);
+    torch::executor::util::FreeInputs(inputs);
+  }
+
+  // Init errors are reported as in sequential loading.
+  init_error = Error::InvalidProgram;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method(
+      "forward", &mmm.get(), /*event_tracer=*/nullptr, &runner);
+  EXPECT_EQ(method.error(), Error::InvalidProgram);
+}
+
 /**
  * Tests that the DataLoader's load is receiving the correct segment info for
  * different types of segments.
@@ -6,10 +6,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
@@ -21,11 +27,20 @@
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
+using executorch::runtime::AllocatorID;
+using executorch::runtime::ChainID;
+using executorch::runtime::DebugHandle;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::EventTracerEntry;
+using executorch::runtime::kUnsetChainId;
+using executorch::runtime::kUnsetDebugHandle;
+using executorch::runtime::LoggedEValueType;
+using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Method;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::TaskRunner;
 using executorch::runtime::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
@@ -56,6 +71,9 @@ class MethodTest : public ::testing::Test {
 
     load_program(std::getenv("ET_MODULE_ADD_PATH"), "add");
     load_program(std::getenv("ET_MODULE_INDEX_PATH"), "index");
+    load_program(
+        std::getenv("ET_MODULE_INDEPENDENT_OPS_PATH"), "independent_ops");
+    load_program(std::getenv("ET_MODULE_MAP_PATH"), "map");
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
     load_program(
@@ -273,6 +291,66 @@ TEST_F(MethodTest, AliasedIOTest) {
   }
 }
 
+TEST_F(MethodTest, PlannedOutputWritesToCallerBuffer) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+
+  // The output of ModuleAdd is a memory-planned 2x2 float tensor.
+  ASSERT_NE(method->get_output(0).toTensor().const_data_ptr(), nullptr);
+  float buffer[4] = {};
+  EXPECT_EQ(
+      method->set_output_data_ptr(buffer, sizeof(buffer) - 1, 0),
+      Error::InvalidArgument);
+  ASSERT_EQ(method->set_output_data_ptr(buffer, sizeof(buffer), 0), Error::Ok);
+  ASSERT_EQ(method->get_output(0).toTensor().const_data_ptr(), buffer);
+
+  // The add kernel writes ones + ones directly to the buffer.
+  ASSERT_EQ(method->execute(), Error::Ok);
+  ASSERT_EQ(method->get_output(0).toTensor().const_data_ptr(), buffer);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_FLOAT_EQ(buffer[i], 2.f);
+  }
+
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_F(MethodTest, SharedPlannedInputIsNotCopied) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  const void* planned_data = method->get_input(0).toTensor().const_data_ptr();
+  ASSERT_NE(planned_data, nullptr);
+
+  alignas(std::max_align_t) float data[4] = {1.f, 2.f, 3.f, 4.f};
+  int32_t sizes[2] = {2, 2};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {2, 1};
+  exec_aten::TensorImpl impl(
+      exec_aten::ScalarType::Float, 2, sizes, data, dim_order, strides);
+  ASSERT_EQ(
+      method->share_input(EValue(exec_aten::Tensor(&impl)), 0), Error::Ok);
+  EXPECT_EQ(method->get_input(0).toTensor().const_data_ptr(), data);
+
+  // The other input is ones.
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& output = method->get_output(0).toTensor();
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[i], data[i] + 1.f);
+  }
+
+  // The alias only lasts for one execution.
+  EXPECT_EQ(method->get_input(0).toTensor().const_data_ptr(), planned_data);
+
+  torch::executor::util::FreeInputs(inputs);
+}
+
 TEST_F(MethodTest, ConstantSegmentTest) {
   // Execute model with constants stored in segment.
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
@@ -285,6 +363,42 @@ TEST_F(MethodTest, ConstantSegmentTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, LazyConstantSegmentTest) {
+  // Load the constants of each method only when the method is loaded.
+  const char* path = std::getenv("ET_MODULE_LINEAR_CONSTANT_SEGMENT_PATH");
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(
+      &loader.get(),
+      Program::Verification::Minimal,
+      Program::ConstantLoading::Lazy);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+
+  // The result matches the eagerly-loaded program.
+  ManagedMemoryManager eager_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> eager_method =
+      programs_["linear_constant_segment"]->load_method(
+          "forward", &eager_mmm.get());
+  ASSERT_EQ(eager_method.error(), Error::Ok);
+  err = eager_method->execute();
+  ASSERT_EQ(err, Error::Ok);
+
+  const auto& expected = eager_method->get_output(0).toTensor();
+  const auto& actual = method->get_output(0).toTensor();
+  ASSERT_EQ(actual.numel(), expected.numel());
+  for (size_t i = 0; i < expected.numel(); ++i) {
+    EXPECT_FLOAT_EQ(
+        actual.const_data_ptr<float>()[i], expected.const_data_ptr<float>()[i]);
+  }
+}
+
 TEST_F(MethodTest, ConstantBufferTest) {
   // Execute model with constants stored in the program flatbuffer.
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
@@ -297,6 +411,427 @@ TEST_F(MethodTest, ConstantBufferTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+namespace {
+/**
+ * Runs tasks on the calling thread in reverse order, to make sure that the
+ * Method does not depend on the order of tasks in a group.
+ */
+class ReverseOrderTaskRunner final : public TaskRunner {
+ public:
+  size_t max_concurrency() const override {
+    return 4;
+  }
+
+  void run(TaskFunction task, void* context, size_t num_tasks) override {
+    ++num_runs;
+    for (size_t i = num_tasks; i > 0; --i) {
+      task(context, i - 1);
+    }
+  }
+
+  size_t num_runs = 0;
+};
+} // namespace
+
+TEST_F(MethodTest, ParallelExecutionMatchesSequential) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  // The add, mul and sub of this program only read the inputs, so they can
+  // run as one parallel group.
+  Result<Method> method =
+      programs_["independent_ops"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ASSERT_EQ(method->outputs_size(), 3);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  std::vector<std::vector<float>> expected_data;
+  for (size_t i = 0; i < method->outputs_size(); ++i) {
+    const auto& expected = method->get_output(i).toTensor();
+    expected_data.emplace_back(
+        expected.const_data_ptr<float>(),
+        expected.const_data_ptr<float>() + expected.numel());
+  }
+
+  ReverseOrderTaskRunner task_runner;
+  err = method->enable_parallel_execution(&task_runner);
+  ASSERT_EQ(err, Error::Ok);
+  err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  // The kernels ran as tasks, in the reverse of their program order.
+  EXPECT_GT(task_runner.num_runs, 0);
+
+  for (size_t i = 0; i < method->outputs_size(); ++i) {
+    const auto& actual = method->get_output(i).toTensor();
+    ASSERT_EQ(actual.numel(), expected_data[i].size());
+    for (size_t j = 0; j < expected_data[i].size(); ++j) {
+      EXPECT_FLOAT_EQ(
+          actual.const_data_ptr<float>()[j], expected_data[i][j]);
+    }
+  }
+
+  // Going back to sequential execution still works.
+  err = method->enable_parallel_execution(nullptr);
+  ASSERT_EQ(err, Error::Ok);
+  err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_F(MethodTest, ParallelExecutionWithAliasedOutputsRunsSequentially) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["independent_ops"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+
+  ReverseOrderTaskRunner task_runner;
+  Error err = method->enable_parallel_execution(&task_runner);
+  ASSERT_EQ(err, Error::Ok);
+
+  // Point the outputs of the add and the mul at the same buffer after the
+  // schedule was built. Running them together would race on it.
+  const size_t nbytes = method->get_output(0).toTensor().nbytes();
+  std::vector<uint8_t> buffer(nbytes);
+  for (size_t i = 0; i < 2; ++i) {
+    err = method->set_output_data_ptr(buffer.data(), buffer.size(), i);
+    if (err == Error::InvalidState) {
+      torch::executor::util::FreeInputs(inputs);
+      GTEST_SKIP() << "The outputs of this program can not be retargeted";
+    }
+    ASSERT_EQ(err, Error::Ok);
+  }
+
+  err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  // The kernels ran in program order instead, so the mul wrote last.
+  EXPECT_EQ(task_runner.num_runs, 0);
+  const auto& x = method->get_input(0).toTensor();
+  const auto& y = method->get_input(1).toTensor();
+  const auto* out = reinterpret_cast<const float*>(buffer.data());
+  for (size_t i = 0; i < static_cast<size_t>(x.numel()); ++i) {
+    EXPECT_FLOAT_EQ(
+        out[i], x.const_data_ptr<float>()[i] * y.const_data_ptr<float>()[i]);
+  }
+
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_F(MethodTest, CloneExecutesIndependently) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Cloning into the same MemoryManager would alias planned memory.
+  Result<Method> bad_clone = method->clone(&mmm.get());
+  EXPECT_EQ(bad_clone.error(), Error::InvalidArgument);
+
+  ManagedMemoryManager clone_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> clone = method->clone(&clone_mmm.get());
+  ASSERT_EQ(clone.error(), Error::Ok);
+  EXPECT_EQ(clone->inputs_size(), method->inputs_size());
+  EXPECT_EQ(clone->outputs_size(), method->outputs_size());
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  exec_aten::ArrayRef<void*> clone_inputs =
+      torch::executor::util::PrepareInputTensors(*clone);
+
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  err = clone->execute();
+  ASSERT_EQ(err, Error::Ok);
+
+  // Both instances computed the same result into different planned buffers.
+  const auto& expected = method->get_output(0).toTensor();
+  const auto& actual = clone->get_output(0).toTensor();
+  EXPECT_NE(actual.const_data_ptr(), expected.const_data_ptr());
+  ASSERT_EQ(actual.numel(), expected.numel());
+  for (size_t i = 0; i < expected.numel(); ++i) {
+    EXPECT_FLOAT_EQ(
+        actual.const_data_ptr<float>()[i], expected.const_data_ptr<float>()[i]);
+  }
+
+  torch::executor::util::FreeInputs(clone_inputs);
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_F(MethodTest, TempMemoryPeakIsTracked) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(method->temp_memory_peak_bytes(), 0);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+
+  // The method-wide peak is the largest per-instruction peak.
+  Result<size_t> first = method->instruction_temp_memory_peak_bytes(0, 0);
+  ASSERT_EQ(first.error(), Error::Ok);
+  EXPECT_LE(first.get(), method->temp_memory_peak_bytes());
+  EXPECT_LE(method->temp_memory_peak_bytes(), kDefaultRuntimeMemBytes);
+
+  // Out-of-range instructions are rejected.
+  EXPECT_EQ(
+      method->instruction_temp_memory_peak_bytes(1000, 0).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      method->instruction_temp_memory_peak_bytes(0, 100000).error(),
+      Error::InvalidArgument);
+
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_F(MethodTest, WarmupKeepsInputs) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  const auto& output = method->get_output(0).toTensor();
+  const std::vector<float> expected(
+      output.const_data_ptr<float>(),
+      output.const_data_ptr<float>() + output.numel());
+
+  // Warming up touches the planned memory the inputs live in, but leaves
+  // their contents alone.
+  ASSERT_EQ(method->warmup(), Error::Ok);
+  err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  const auto& actual = method->get_output(0).toTensor();
+  ASSERT_EQ(actual.numel(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_FLOAT_EQ(actual.const_data_ptr<float>()[i], expected[i]);
+  }
+  torch::executor::util::FreeInputs(inputs);
+
+  // A moved-from Method cannot be warmed up.
+  Method moved(std::move(method.get()));
+  EXPECT_EQ(method->warmup(), Error::InvalidState);
+  EXPECT_EQ(moved.warmup(), Error::Ok);
+}
+
+namespace {
+
+// A Method::InitCache that keeps its snapshots in memory.
+class InMemoryInitCache final : public Method::InitCache {
+ public:
+  Result<FreeableBuffer> load(const char* method_name) override {
+    auto it = snapshots.find(method_name);
+    if (it == snapshots.end()) {
+      return Error::NotFound;
+    }
+    return FreeableBuffer(it->second.data(), it->second.size(), nullptr);
+  }
+
+  void save(const char* method_name, const void* data, size_t size) override {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    snapshots[method_name].assign(bytes, bytes + size);
+    num_saves++;
+  }
+
+  std::unordered_map<std::string, std::vector<uint8_t>> snapshots;
+  size_t num_saves = 0;
+};
+
+} // namespace
+
+TEST_F(MethodTest, InitCacheSnapshotIsReused) {
+  InMemoryInitCache cache;
+  {
+    ManagedMemoryManager mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method = programs_["add"]->load_method(
+        "forward", &mmm.get(), nullptr, nullptr, &cache);
+    ASSERT_EQ(method.error(), Error::Ok);
+  }
+  // The first load resolved the operators and saved them.
+  EXPECT_EQ(cache.num_saves, 1);
+  ASSERT_EQ(cache.snapshots.count("forward"), 1);
+  const std::vector<uint8_t> saved = cache.snapshots["forward"];
+
+  // The next load uses the snapshot and does not save another one.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method(
+      "forward", &mmm.get(), nullptr, nullptr, &cache);
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(cache.num_saves, 1);
+
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  torch::executor::util::FreeInputs(inputs);
+
+  // A snapshot that points at other kernels is not used, and is replaced.
+  std::vector<uint8_t>& snapshot = cache.snapshots["forward"];
+  ASSERT_GT(snapshot.size(), 3 * sizeof(uint32_t));
+  std::memset(snapshot.data() + 3 * sizeof(uint32_t), 0xff, sizeof(uint32_t));
+  {
+    ManagedMemoryManager stale_mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> stale = programs_["add"]->load_method(
+        "forward", &stale_mmm.get(), nullptr, nullptr, &cache);
+    ASSERT_EQ(stale.error(), Error::Ok);
+  }
+  EXPECT_EQ(cache.num_saves, 2);
+  EXPECT_EQ(cache.snapshots["forward"], saved);
+
+  // So is a snapshot of another size.
+  cache.snapshots["forward"].resize(2);
+  {
+    ManagedMemoryManager short_mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> reloaded = programs_["add"]->load_method(
+        "forward", &short_mmm.get(), nullptr, nullptr, &cache);
+    ASSERT_EQ(reloaded.error(), Error::Ok);
+  }
+  EXPECT_EQ(cache.num_saves, 3);
+  EXPECT_EQ(cache.snapshots["forward"], saved);
+}
+
+namespace {
+/**
+ * Records nothing. Method does not combine the loop counter check with its
+ * jump when an event tracer is set, so loading a method with this one runs
+ * every instruction as its own step.
+ */
+class NoOpEventTracer final : public executorch::runtime::EventTracer {
+ public:
+  void create_event_block(ET_UNUSED const char* name) override {}
+
+  EventTracerEntry start_profiling(
+      ET_UNUSED const char* name,
+      ET_UNUSED ChainID chain_id = kUnsetChainId,
+      ET_UNUSED DebugHandle debug_handle = kUnsetDebugHandle) override {
+    return EventTracerEntry();
+  }
+
+  EventTracerEntry start_profiling_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index) override {
+    return EventTracerEntry();
+  }
+
+  void end_profiling_delegate(
+      ET_UNUSED EventTracerEntry event_tracer_entry,
+      ET_UNUSED const void* metadata = nullptr,
+      ET_UNUSED size_t metadata_len = 0) override {}
+
+  void log_profiling_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index,
+      ET_UNUSED et_timestamp_t start_time,
+      ET_UNUSED et_timestamp_t end_time,
+      ET_UNUSED const void* metadata = nullptr,
+      ET_UNUSED size_t metadata_len = 0) override {}
+
+  void end_profiling(ET_UNUSED EventTracerEntry prof_entry) override {}
+
+  void track_allocation(ET_UNUSED AllocatorID id, ET_UNUSED size_t size)
+      override {}
+
+  AllocatorID track_allocator(ET_UNUSED const char* name) override {
+    return 0;
+  }
+
+  void log_evalue(
+      ET_UNUSED const EValue& evalue,
+      ET_UNUSED LoggedEValueType evalue_type) override {}
+
+  void log_intermediate_output_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index,
+      ET_UNUSED const exec_aten::Tensor& output) override {}
+
+  void log_intermediate_output_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index,
+      ET_UNUSED const ArrayRef<exec_aten::Tensor> output) override {}
+
+  void log_intermediate_output_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index,
+      ET_UNUSED const int& output) override {}
+
+  void log_intermediate_output_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index,
+      ET_UNUSED const bool& output) override {}
+
+  void log_intermediate_output_delegate(
+      ET_UNUSED const char* name,
+      ET_UNUSED DebugHandle delegate_debug_index,
+      ET_UNUSED const double& output) override {}
+};
+
+/// Runs `method` to the end with step(), returning the number of steps.
+size_t count_steps(Method& method) {
+  size_t steps = 0;
+  Error err = Error::Ok;
+  while ((err = method.step()) == Error::Ok) {
+    ++steps;
+  }
+  EXPECT_EQ(err, Error::EndOfMethod);
+  EXPECT_EQ(method.reset_execution(), Error::Ok);
+  return steps;
+}
+} // namespace
+
+TEST_F(MethodTest, LoopCounterCheckAndJumpRunAsOneStep) {
+  // The map program adds y to each of the 5 rows of xs in a loop.
+  constexpr int64_t kIterations = 5;
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["map"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+
+  NoOpEventTracer tracer;
+  ManagedMemoryManager traced_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> traced_method =
+      programs_["map"]->load_method("forward", &traced_mmm.get(), &tracer);
+  ASSERT_EQ(traced_method.error(), Error::Ok);
+  exec_aten::ArrayRef<void*> traced_inputs =
+      torch::executor::util::PrepareInputTensors(*traced_method);
+
+  // Each iteration ends with the counter check and its jump. They take one
+  // step instead of two, except with an event tracer.
+  const size_t steps = count_steps(*method);
+  const size_t traced_steps = count_steps(*traced_method);
+  EXPECT_EQ(traced_steps - steps, static_cast<size_t>(kIterations));
+
+  // The counter is reset at the end, so running again takes as many steps.
+  EXPECT_EQ(count_steps(*method), steps);
+
+  // Both ran every iteration: each row of ones plus ones.
+  for (Method* m : {&method.get(), &traced_method.get()}) {
+    const auto& out = m->get_output(0).toTensor();
+    ASSERT_EQ(out.dim(), 2);
+    ASSERT_EQ(out.size(0), kIterations);
+    ASSERT_EQ(out.size(1), 2);
+    for (ssize_t i = 0; i < out.numel(); ++i) {
+      EXPECT_FLOAT_EQ(out.const_data_ptr<float>()[i], 2.0f);
+    }
+  }
+
+  torch::executor::util::FreeInputs(traced_inputs);
+  torch::executor::util::FreeInputs(inputs);
+}
+
 // TODO(T161163608): Test is disabled due to a resize bug in tensor_index_out of
 // the portable op lib
 
@@ -275,6 +275,15 @@ TEST_F(ProgramTest, LoadSegmentWithNoSegments) {
   EXPECT_NE(segment.error(), Error::Ok);
 }
 
+TEST_F(ProgramTest, GetNamedDataWithNoNamedData) {
+  Result<Program> program =
+      Program::load(add_loader_.get(), kDefaultVerification);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  Result<FreeableBuffer> data = program->get_named_data("some-weight");
+  EXPECT_EQ(data.error(), Error::NotFound);
+}
+
 TEST_F(ProgramTest, ShortDataHeader) {
   Result<FreeableBuffer> header = add_loader_->load(
       /*offset=*/0,
@@ -424,6 +433,42 @@ TEST_F(ProgramTest, LoadConstantSegment) {
   EXPECT_GE(flatbuffer_program->constant_segment()->offsets()->size(), 1);
 }
 
+TEST_F(ProgramTest, LazyConstantSegmentIsNotLoadedUpFront) {
+  const char* linear_path =
+      std::getenv("ET_MODULE_LINEAR_CONSTANT_SEGMENT_PATH");
+  Result<FileDataLoader> linear_loader = FileDataLoader::from(linear_path);
+  ASSERT_EQ(linear_loader.error(), Error::Ok);
+
+  Result<Program> program = Program::load(
+      &linear_loader.get(),
+      Program::Verification::Minimal,
+      Program::ConstantLoading::Lazy);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  // There is no shared copy of the constants to point into.
+  Result<const void*> data = program->get_constant_buffer_data(
+      /*buffer_idx=*/1, /*nbytes=*/sizeof(float));
+  EXPECT_EQ(data.error(), Error::NotSupported);
+}
+
+TEST_F(ProgramTest, LazyConstantLoadingIgnoredWithoutConstantSegment) {
+  // Constants inside the flatbuffer are always available.
+  const char* linear_path =
+      std::getenv("ET_MODULE_LINEAR_CONSTANT_BUFFER_PATH");
+  Result<FileDataLoader> linear_loader = FileDataLoader::from(linear_path);
+  ASSERT_EQ(linear_loader.error(), Error::Ok);
+
+  Result<Program> program = Program::load(
+      &linear_loader.get(),
+      Program::Verification::Minimal,
+      Program::ConstantLoading::Lazy);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  Result<const void*> data = program->get_constant_buffer_data(
+      /*buffer_idx=*/1, /*nbytes=*/sizeof(float));
+  EXPECT_EQ(data.error(), Error::Ok);
+}
+
 TEST_F(ProgramTest, LoadConstantSegmentWithNoConstantSegment) {
   // Load the serialized ModuleLinear data, with constants in the flatbuffer and
   // no constants in the segment.
@@ -22,6 +22,17 @@ namespace runtime {
  *
  * NOTE: Will not be passed to operators if running in ATen mode as those
  * operators do not expect to receive a KernelRuntimeContext argument.
+ *
+ * In-place execution: when a program is planned with
+ * MemoryPlanningPass(inplace_elementwise=True), the `out` tensor of an
+ * elementwise kernel such as relu.out, add.out or clamp.out may be the same
+ * tensor as one of its inputs, with the same data pointer, sizes, dtype and
+ * dim order. Such kernels must read element i of every input before writing
+ * element i of `out`, and must not read element i again afterwards, so a
+ * single pass that loads, computes and stores each element or vector is safe.
+ * Kernels that stage partial results in `out`, or that read inputs out of
+ * order (reductions, softmax, transposes), must not be added to the planner's
+ * allow-list in exir/passes/memory_planning_pass.py.
  */
 class KernelRuntimeContext {
  public:
@@ -35,6 +35,63 @@ Error register_kernels(const ArrayRef<Kernel>& kernels) {
   return success;
 }
 
+namespace {
+
+// 32-bit FNV-1a.
+constexpr uint32_t kFnvOffsetBasis = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+
+uint32_t hash_kernel(const char* name, const KernelKey& key) {
+  uint32_t h = kFnvOffsetBasis;
+  for (const char* c = name; *c != '\0'; ++c) {
+    h = (h ^ static_cast<uint8_t>(*c)) * kFnvPrime;
+  }
+  // Separate the name from the key so that fallback and specialized kernels
+  // of the same op always hash differently.
+  h = (h ^ (key.is_fallback() ? 0xffu : 0xfeu)) * kFnvPrime;
+  if (!key.is_fallback()) {
+    const char* data = key.data();
+    for (size_t i = 0; i < KernelKey::MAX_SIZE && data[i] != '\0'; ++i) {
+      h = (h ^ static_cast<uint8_t>(data[i])) * kFnvPrime;
+    }
+  }
+  return h;
+}
+
+} // namespace
+
+int32_t OperatorRegistry::find_kernel(const char* name, const KernelKey& key)
+    const {
+  const uint32_t hash = hash_kernel(name, key);
+  constexpr uint32_t mask = kKernelIndexSize - 1;
+  for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    const uint32_t entry = this->kernel_index_[slot];
+    if (entry == 0) {
+      return -1;
+    }
+    const uint32_t idx = entry - 1;
+    if (this->kernel_hashes_[idx] == hash &&
+        strcmp(this->kernels_[idx].name_, name) == 0 &&
+        this->kernels_[idx].kernel_key_ == key) {
+      return static_cast<int32_t>(idx);
+    }
+  }
+}
+
+void OperatorRegistry::index_kernel(uint32_t kernel_idx) {
+  const Kernel& kernel = this->kernels_[kernel_idx];
+  const uint32_t hash = hash_kernel(kernel.name_, kernel.kernel_key_);
+  this->kernel_hashes_[kernel_idx] = hash;
+  constexpr uint32_t mask = kKernelIndexSize - 1;
+  uint32_t slot = hash & mask;
+  // The table is at least twice as large as kernels_, so there is always an
+  // empty slot.
+  while (this->kernel_index_[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  this->kernel_index_[slot] = kernel_idx + 1;
+}
+
 Error OperatorRegistry::register_kernels(const ArrayRef<Kernel>& kernels) {
   // Operator registration happens in static initialization time when PAL init
   // may or may not happen already. Here we are assuming et_pal_init() doesn't
@@ -67,17 +124,15 @@ Error OperatorRegistry::register_kernels(const ArrayRef<Kernel>& kernels) {
   const char* lib_name = et_pal_get_shared_library_name(kernels.data());
 
   for (const auto& kernel : kernels) {
-    // linear search. This is fine if the number of kernels are small.
-    for (int32_t i = 0; i < this->num_kernels_; i++) {
-      Kernel k = this->kernels_[i];
-      if (strcmp(kernel.name_, k.name_) == 0 &&
-          kernel.kernel_key_ == k.kernel_key_) {
-        ET_LOG(Error, "Re-registering %s, from %s", k.name_, lib_name);
-        ET_LOG_KERNEL_KEY(k.kernel_key_);
-        return Error::InvalidArgument;
-      }
+    if (find_kernel(kernel.name_, kernel.kernel_key_) != -1) {
+      ET_LOG(Error, "Re-registering %s, from %s", kernel.name_, lib_name);
+      ET_LOG_KERNEL_KEY(kernel.kernel_key_);
+      return Error::InvalidArgument;
     }
-    this->kernels_[this->num_kernels_++] = kernel;
+    this->kernels_[this->num_kernels_] = kernel;
+    index_kernel(this->num_kernels_);
+    this->num_kernels_++;
+    this->has_specialized_kernels_ |= !kernel.kernel_key_.is_fallback();
   }
   ET_LOG(
       Debug,
@@ -138,16 +193,8 @@ bool OperatorRegistry::hasOpsFn(
   make_kernel_key_string(meta_list, buf);
   KernelKey kernel_key = KernelKey(buf);
 
-  for (size_t idx = 0; idx < this->num_kernels_; idx++) {
-    if (strcmp(this->kernels_[idx].name_, name) == 0) {
-      if (this->kernels_[idx].kernel_key_.is_fallback() ||
-          this->kernels_[idx].kernel_key_ == kernel_key) {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return find_kernel(name, kernel_key) != -1 ||
+      find_kernel(name, KernelKey()) != -1;
 }
 
 const OpFunction& getOpsFn(const char* name, ArrayRef<TensorMeta> kernel_key) {
@@ -157,26 +204,34 @@ const OpFunction& getOpsFn(const char* name, ArrayRef<TensorMeta> kernel_key) {
 const OpFunction& OperatorRegistry::getOpsFn(
     const char* name,
     ArrayRef<TensorMeta> meta_list) {
+  const Kernel* kernel = get_kernel(name, meta_list);
+  if (kernel == nullptr) {
+    ET_LOG_TENSOR_META(meta_list);
+  }
+  ET_CHECK_MSG(kernel != nullptr, "kernel '%s' not found.", name);
+  return kernel->op_;
+}
+
+const Kernel* get_kernel(const char* name, ArrayRef<TensorMeta> meta_list) {
+  return getOperatorRegistry().get_kernel(name, meta_list);
+}
+
+const Kernel* OperatorRegistry::get_kernel(
+    const char* name,
+    ArrayRef<TensorMeta> meta_list) {
   char buf[KernelKey::MAX_SIZE] = {0};
   make_kernel_key_string(meta_list, buf);
   KernelKey kernel_key = KernelKey(buf);
 
-  int32_t fallback_idx = -1;
-  for (size_t idx = 0; idx < this->num_kernels_; idx++) {
-    if (strcmp(this->kernels_[idx].name_, name) == 0) {
-      if (this->kernels_[idx].kernel_key_ == kernel_key) {
-        return this->kernels_[idx].op_;
-      }
-      if (this->kernels_[idx].kernel_key_.is_fallback()) {
-        fallback_idx = idx;
-      }
-    }
+  const int32_t idx = find_kernel(name, kernel_key);
+  if (idx != -1) {
+    return &this->kernels_[idx];
   }
+  const int32_t fallback_idx = find_kernel(name, KernelKey());
   if (fallback_idx != -1) {
-    return this->kernels_[fallback_idx].op_;
+    return &this->kernels_[fallback_idx];
   }
-  ET_CHECK_MSG(false, "kernel '%s' not found.", name);
-  ET_LOG_TENSOR_META(meta_list);
+  return nullptr;
 }
 
 ArrayRef<Kernel> get_kernels() {
@@ -187,5 +242,52 @@ ArrayRef<Kernel> OperatorRegistry::get_kernels() {
   return ArrayRef<Kernel>(this->kernels_, this->num_kernels_);
 }
 
+bool has_specialized_kernels() {
+  return getOperatorRegistry().has_specialized_kernels();
+}
+
+namespace {
+
+// Registered cost functions. Lookups are by name and only happen when an
+// event tracer is attached, so a plain array is enough.
+OpCostEntry registered_op_costs[kMaxNumOfOpCosts];
+uint32_t num_registered_op_costs = 0;
+
+} // namespace
+
+Error register_op_costs(const ArrayRef<OpCostEntry>& op_costs) {
+  if (op_costs.size() + num_registered_op_costs > kMaxNumOfOpCosts) {
+    ET_LOG(
+        Error,
+        "Cannot register %zu op costs: %" PRIu32 " of at most %" PRIu32
+        " are already registered.",
+        op_costs.size(),
+        num_registered_op_costs,
+        kMaxNumOfOpCosts);
+    return Error::Internal;
+  }
+  for (const auto& op_cost : op_costs) {
+    if (get_op_cost_function(op_cost.name_) != nullptr) {
+      ET_LOG(Error, "Re-registering the cost of %s", op_cost.name_);
+      return Error::InvalidArgument;
+    }
+    registered_op_costs[num_registered_op_costs++] = op_cost;
+  }
+  return Error::Ok;
+}
+
+OpCostFunction get_op_cost_function(const char* name) {
+  for (uint32_t i = 0; i < num_registered_op_costs; ++i) {
+    if (strcmp(registered_op_costs[i].name_, name) == 0) {
+      return registered_op_costs[i].cost_;
+    }
+  }
+  return nullptr;
+}
+
+bool has_op_costs() {
+  return num_registered_op_costs > 0;
+}
+
 } // namespace runtime
 } // namespace executorch
@@ -42,6 +42,23 @@ namespace runtime {
 class KernelRuntimeContext; // Forward declaration
 using OpFunction = void (*)(KernelRuntimeContext&, EValue**);
 
+/**
+ * Calls a kernel with arguments bound by an OpBindFunction, skipping the
+ * per-call unboxing of EValues that an OpFunction does.
+ */
+using BoundOpFunction = void (*)(KernelRuntimeContext&, void**);
+
+/**
+ * Binds the arguments of a kernel call once, at Method init time. Checks the
+ * type of each of the `num_args` EValues in `stack` and sets `bound_args[i]`
+ * to the value held by `*stack[i]`, e.g. its Tensor or int64_t. The pointers
+ * stay valid, and keep seeing new values, as long as the EValues live.
+ * Returns false if some argument cannot be bound, in which case the kernel
+ * must be called through its OpFunction.
+ */
+using OpBindFunction =
+    bool (*)(EValue** stack, size_t num_args, void** bound_args);
+
 /**
  * Dtype and dim order metadata for a Tensor argument to an operator.
  * Used by the Executor to hold the tensor metadata info and retrieve kernel.
@@ -177,6 +194,12 @@ struct Kernel {
   // Data is not owned by the Kernel struct.
   KernelKey kernel_key_;
   OpFunction op_;
+  /**
+   * Optional unboxed entry point of the kernel, and the function that binds
+   * its arguments. Both are null for kernels that can only be called boxed.
+   */
+  OpBindFunction bind_ = nullptr;
+  BoundOpFunction bound_op_ = nullptr;
   /**
    * We are doing a copy of the string pointer instead of duplicating the string
    * itself, we require the lifetime of the operator name to be at least as long
@@ -187,6 +210,13 @@ struct Kernel {
   explicit Kernel(const char* name, KernelKey key, OpFunction func)
       : name_(name), kernel_key_(key), op_(func) {}
 
+  explicit Kernel(
+      const char* name,
+      OpFunction func,
+      OpBindFunction bind,
+      BoundOpFunction bound_func)
+      : name_(name), op_(func), bind_(bind), bound_op_(bound_func) {}
+
   Kernel() {}
 };
 
@@ -200,6 +230,22 @@ constexpr uint32_t kMaxNumOfKernels = MAX_KERNEL_NUM;
 constexpr uint32_t kMaxNumOfKernels =
     kOperatorTableMaxSize * kMaxNumOfKernelPerOp;
 #endif
+
+namespace internal {
+// Returns the smallest power of two that is >= n.
+constexpr uint32_t next_power_of_two(uint32_t n) {
+  uint32_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+} // namespace internal
+
+// Number of slots in the open-addressing index over the registered kernels.
+// Kept at a load factor of at most 0.5 so that probe sequences stay short.
+constexpr uint32_t kKernelIndexSize =
+    internal::next_power_of_two(2 * kMaxNumOfKernels);
 /**
  * See OperatorRegistry::hasOpsFn()
  */
@@ -212,11 +258,23 @@ const OpFunction& getOpsFn(
     const char* name,
     ArrayRef<TensorMeta> meta_list = {});
 
+/**
+ * See OperatorRegistry::get_kernel()
+ */
+const Kernel* get_kernel(
+    const char* name,
+    ArrayRef<TensorMeta> meta_list = {});
+
 /**
  * See OperatorRegistry::get_kernels()
  */
 ArrayRef<Kernel> get_kernels();
 
+/**
+ * See OperatorRegistry::has_specialized_kernels()
+ */
+bool has_specialized_kernels();
+
 /**
  * See OperatorRegistry::register_kernels(). Notice that the returned Error
  * object should be handled internally and the reason for keep returning is to
@@ -249,16 +307,100 @@ struct OperatorRegistry {
    */
   const OpFunction& getOpsFn(const char* name, ArrayRef<TensorMeta> meta_list);
 
+  /**
+   * Returns the kernel that getOpsFn() would return the function of, or null
+   * if there is none.
+   */
+  const Kernel* get_kernel(const char* name, ArrayRef<TensorMeta> meta_list);
+
   /**
    * Return all registered operators.
    */
   ArrayRef<Kernel> get_kernels();
 
+  /**
+   * Returns true if any kernel was registered with a non-fallback KernelKey,
+   * i.e. if get_kernel() can depend on the TensorMeta list and not only on
+   * the name.
+   */
+  bool has_specialized_kernels() const {
+    return has_specialized_kernels_;
+  }
+
  private:
+  /**
+   * Returns the index into kernels_ of the kernel registered under the given
+   * name and key, or -1 if there is none.
+   */
+  int32_t find_kernel(const char* name, const KernelKey& key) const;
+
+  /**
+   * Adds kernels_[kernel_idx] to the lookup index.
+   */
+  void index_kernel(uint32_t kernel_idx);
+
   Kernel kernels_[kMaxNumOfKernels];
+  // Hash of (name, kernel key) for each entry of kernels_.
+  uint32_t kernel_hashes_[kMaxNumOfKernels] = {};
+  // Open-addressing hash table with linear probing. Each slot holds the
+  // index into kernels_ plus one, so that zero marks an empty slot.
+  uint32_t kernel_index_[kKernelIndexSize] = {};
   uint32_t num_kernels_;
+  bool has_specialized_kernels_ = false;
+};
+
+/**
+ * Work done by one call of an operator: the floating point or integer
+ * arithmetic operations it performs and the bytes of tensor data it reads and
+ * writes. Tools divide these by the time of the call to tell compute-bound
+ * calls from memory-bound ones.
+ */
+struct OpCost {
+  uint64_t flops = 0;
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
 };
 
+/**
+ * Computes the OpCost of a call of an operator from its `num_args` arguments
+ * in `stack`, laid out as for the OpFunction of the operator. It is called
+ * after the kernel, so output tensors have their final shapes.
+ */
+using OpCostFunction = OpCost (*)(EValue** stack, size_t num_args);
+
+/**
+ * Bundles an op name, e.g. "aten::mm.out", with the function that computes
+ * the cost of its calls.
+ */
+struct OpCostEntry {
+  const char* name_;
+  OpCostFunction cost_;
+};
+
+// Maximum number of operators that can have an OpCostFunction.
+constexpr uint32_t kMaxNumOfOpCosts = kOperatorTableMaxSize;
+
+/**
+ * Registers the cost functions of operators. Unlike kernels, they are
+ * optional: when an event tracer is attached to a Method, the costs of the
+ * kernel calls it makes are computed with them and handed to
+ * EventTracer::set_op_cost(). An op can only have one cost function, no
+ * matter how many kernels it has.
+ */
+ET_NODISCARD Error register_op_costs(const ArrayRef<OpCostEntry>& op_costs);
+
+/**
+ * Returns the cost function registered for the op `name`, or null if there is
+ * none.
+ */
+OpCostFunction get_op_cost_function(const char* name);
+
+/**
+ * Returns true if any cost function was registered, so that callers can skip
+ * looking them up by name otherwise.
+ */
+bool has_op_costs();
+
 } // namespace runtime
 } // namespace executorch
 
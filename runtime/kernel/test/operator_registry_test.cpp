@@ -7,6 +7,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string>
 #include <vector>
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -23,12 +24,20 @@ using exec_aten::Tensor;
 using executorch::runtime::ArrayRef;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::get_kernel;
+using executorch::runtime::get_op_cost_function;
+using executorch::runtime::getOpsFn;
+using executorch::runtime::has_op_costs;
 using executorch::runtime::hasOpsFn;
 using executorch::runtime::Kernel;
 using executorch::runtime::KernelKey;
 using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::OpCost;
+using executorch::runtime::OpCostEntry;
+using executorch::runtime::OpCostFunction;
 using executorch::runtime::OpFunction;
 using executorch::runtime::register_kernels;
+using executorch::runtime::register_op_costs;
 using executorch::runtime::TensorMeta;
 using executorch::runtime::testing::make_kernel_key;
 
@@ -283,3 +292,108 @@ TEST_F(OperatorRegistryTest, ExecutorUsesFallbackKernel) {
   auto val = values[0].toScalar().to<int64_t>();
   ASSERT_EQ(val, 100);
 }
+
+TEST_F(OperatorRegistryTest, GetKernelReturnsRegisteredKernel) {
+  OpFunction func = [](KernelRuntimeContext& context, EValue** stack) {
+    (void)context;
+    (void)stack;
+  };
+  auto s1 = register_kernels({Kernel("test::garply", func)});
+  EXPECT_EQ(s1, Error::Ok);
+
+  const Kernel* kernel = get_kernel("test::garply");
+  ASSERT_NE(kernel, nullptr);
+  EXPECT_EQ(kernel->op_, func);
+  EXPECT_EQ(kernel->bind_, nullptr);
+  EXPECT_EQ(kernel->bound_op_, nullptr);
+
+  EXPECT_EQ(get_kernel("test::not_garply"), nullptr);
+}
+
+TEST_F(OperatorRegistryTest, ExecutorPrefersSpecializedOverFallbackKernel) {
+  char buf_long_contiguous[BUF_SIZE];
+  make_kernel_key({{ScalarType::Long, {0, 1, 2, 3}}}, buf_long_contiguous);
+  KernelKey key = KernelKey(buf_long_contiguous);
+
+  Kernel kernels[] = {
+      Kernel(
+          "test::grault",
+          KernelKey{},
+          [](KernelRuntimeContext& context, EValue** stack) {
+            (void)context;
+            *(stack[0]) = Scalar(50);
+          }),
+      Kernel(
+          "test::grault",
+          key,
+          [](KernelRuntimeContext& context, EValue** stack) {
+            (void)context;
+            *(stack[0]) = Scalar(100);
+          })};
+  auto s1 = register_kernels(kernels);
+  EXPECT_EQ(s1, Error::Ok);
+
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = ArrayRef<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+  EXPECT_TRUE(hasOpsFn("test::grault", ArrayRef<TensorMeta>(meta_long)));
+  EXPECT_TRUE(hasOpsFn("test::grault", ArrayRef<TensorMeta>(meta_float)));
+
+  EValue values[1];
+  values[0] = Scalar(0);
+  EValue* evalues[1];
+  evalues[0] = &values[0];
+  KernelRuntimeContext context{};
+
+  getOpsFn("test::grault", ArrayRef<TensorMeta>(meta_long))(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 100);
+
+  // No kernel is specialized for float, so the fallback is used.
+  getOpsFn("test::grault", ArrayRef<TensorMeta>(meta_float))(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 50);
+}
+
+TEST_F(OperatorRegistryTest, LookupManyKernels) {
+  constexpr size_t kNumKernels = 500;
+  static std::vector<std::string> names;
+  names.reserve(kNumKernels);
+  std::vector<Kernel> kernels;
+  for (size_t i = 0; i < kNumKernels; i++) {
+    names.push_back("test::many_" + std::to_string(i));
+    kernels.emplace_back(
+        names.back().c_str(), [](KernelRuntimeContext&, EValue**) {});
+  }
+  auto s1 = register_kernels(ArrayRef<Kernel>(kernels.data(), kernels.size()));
+  EXPECT_EQ(s1, Error::Ok);
+
+  for (size_t i = 0; i < kNumKernels; i++) {
+    EXPECT_TRUE(hasOpsFn(names[i].c_str()));
+  }
+  EXPECT_FALSE(hasOpsFn("test::many_"));
+  EXPECT_FALSE(hasOpsFn("test::many_500"));
+}
+
+TEST_F(OperatorRegistryTest, RegisterOpCosts) {
+  OpCostEntry op_costs[] = {
+      {"test::cost_foo",
+       [](EValue**, size_t num_args) {
+         OpCost cost;
+         cost.flops = num_args;
+         return cost;
+       }},
+  };
+  EXPECT_EQ(get_op_cost_function("test::cost_foo"), nullptr);
+  auto s1 = register_op_costs(ArrayRef<OpCostEntry>(op_costs));
+  EXPECT_EQ(s1, Error::Ok);
+  EXPECT_TRUE(has_op_costs());
+
+  OpCostFunction cost_fn = get_op_cost_function("test::cost_foo");
+  ASSERT_NE(cost_fn, nullptr);
+  EXPECT_EQ(cost_fn(nullptr, 3).flops, 3);
+  EXPECT_EQ(get_op_cost_function("test::cost_bar"), nullptr);
+
+  // An op can only have one cost function.
+  auto s2 = register_op_costs(ArrayRef<OpCostEntry>(op_costs));
+  EXPECT_EQ(s2, Error::InvalidArgument);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/sdk/aggregating_tracer/aggregating_tracer.h>
+
+namespace torch {
+namespace executor {
+
+AggregatingTracer::AggregatingTracer(Span<InstructionStats> stats)
+    : stats_(stats) {}
+
+void AggregatingTracer::create_event_block(const char* name) {
+  (void)name;
+}
+
+EventTracerEntry AggregatingTracer::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  (void)name;
+  EventTracerEntry prof_entry;
+  prof_entry.event_id = -1;
+  prof_entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  if (chain_id == kUnsetChainId) {
+    prof_entry.chain_id = chain_id_;
+    prof_entry.debug_handle = debug_handle_;
+  } else {
+    prof_entry.chain_id = chain_id;
+    prof_entry.debug_handle = debug_handle;
+  }
+  ++depth_;
+  prof_entry.start_time = et_pal_current_ticks();
+  return prof_entry;
+}
+
+void AggregatingTracer::end_profiling(EventTracerEntry prof_entry) {
+  const et_timestamp_t end_time = et_pal_current_ticks();
+  // Events nested in another one are already part of its duration.
+  if (--depth_ != 0 || prof_entry.chain_id == kUnsetChainId) {
+    return;
+  }
+  if (prof_entry.debug_handle >= stats_.size()) {
+    ++num_dropped_events_;
+    return;
+  }
+  const et_timestamp_t duration = end_time - prof_entry.start_time;
+  InstructionStats& stats = stats_[prof_entry.debug_handle];
+  ++stats.count;
+  stats.total_ticks += duration;
+  if (duration > stats.max_ticks) {
+    stats.max_ticks = duration;
+  }
+}
+
+EventTracerEntry AggregatingTracer::start_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index) {
+  (void)name;
+  (void)delegate_debug_index;
+  // Delegate events are inside the DELEGATE_CALL instruction, which is
+  // already timed as a whole.
+  EventTracerEntry prof_entry;
+  prof_entry.event_id = -1;
+  prof_entry.chain_id = chain_id_;
+  prof_entry.debug_handle = debug_handle_;
+  prof_entry.start_time = 0;
+  prof_entry.delegate_event_id_type = DelegateDebugIdType::kInt;
+  return prof_entry;
+}
+
+void AggregatingTracer::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    const void* metadata,
+    size_t metadata_len) {
+  (void)prof_entry;
+  (void)metadata;
+  (void)metadata_len;
+}
+
+void AggregatingTracer::log_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const void* metadata,
+    size_t metadata_len) {
+  (void)name;
+  (void)delegate_debug_index;
+  (void)start_time;
+  (void)end_time;
+  (void)metadata;
+  (void)metadata_len;
+}
+
+void AggregatingTracer::track_allocation(AllocatorID id, size_t size) {
+  (void)id;
+  (void)size;
+}
+
+AllocatorID AggregatingTracer::track_allocator(const char* name) {
+  (void)name;
+  return 0;
+}
+
+void AggregatingTracer::log_evalue(
+    const EValue& evalue,
+    LoggedEValueType evalue_type) {
+  (void)evalue;
+  (void)evalue_type;
+}
+
+void AggregatingTracer::log_intermediate_output_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    const Tensor& output) {
+  (void)name;
+  (void)delegate_debug_index;
+  (void)output;
+}
+
+void AggregatingTracer::log_intermediate_output_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    const ArrayRef<Tensor> output) {
+  (void)name;
+  (void)delegate_debug_index;
+  (void)output;
+}
+
+void AggregatingTracer::log_intermediate_output_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    const int& output) {
+  (void)name;
+  (void)delegate_debug_index;
+  (void)output;
+}
+
+void AggregatingTracer::log_intermediate_output_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    const bool& output) {
+  (void)name;
+  (void)delegate_debug_index;
+  (void)output;
+}
+
+void AggregatingTracer::log_intermediate_output_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    const double& output) {
+  (void)name;
+  (void)delegate_debug_index;
+  (void)output;
+}
+
+void AggregatingTracer::reset() {
+  for (InstructionStats& stats : stats_) {
+    stats = InstructionStats();
+  }
+  num_dropped_events_ = 0;
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Cost of one instruction of a method, aggregated over all of its executions.
+ * Times are in platform ticks, see ticks_to_ns().
+ */
+struct InstructionStats {
+  /// Number of times the instruction was executed.
+  uint64_t count = 0;
+  /// Sum of the durations of the executions.
+  et_timestamp_t total_ticks = 0;
+  /// Longest execution.
+  et_timestamp_t max_ticks = 0;
+};
+
+/**
+ * An EventTracer that only keeps the count, total and max duration of each
+ * instruction of a method, in an array provided by the caller. It never
+ * allocates, copies strings or logs values, so unlike ETDumpGen it is cheap
+ * enough to leave enabled in production and sample from time to time.
+ *
+ * Only the outermost profiling event of an instruction is counted, so the
+ * time of an instruction includes any event that a kernel or delegate logs
+ * inside it. Events outside of instructions, such as Method::init, are
+ * ignored. Instructions are identified by their index in their chain; the
+ * stats of instructions at or beyond stats.size() are dropped and counted by
+ * num_dropped_events().
+ *
+ * Like Method, this class is not thread safe: read the stats between
+ * executions, on the thread that executes the method or after synchronizing
+ * with it.
+ */
+class AggregatingTracer : public EventTracer {
+ public:
+  /**
+   * @param[in] stats Array the stats are aggregated into, with one entry per
+   *     instruction. Must outlive the tracer. Its contents are not cleared.
+   */
+  explicit AggregatingTracer(Span<InstructionStats> stats);
+
+  void create_event_block(const char* name) override;
+  EventTracerEntry start_profiling(
+      const char* name,
+      ChainID chain_id = kUnsetChainId,
+      DebugHandle debug_handle = kUnsetDebugHandle) override;
+  void end_profiling(EventTracerEntry prof_entry) override;
+  EventTracerEntry start_profiling_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index) override;
+  void end_profiling_delegate(
+      EventTracerEntry prof_entry,
+      const void* metadata,
+      size_t metadata_len) override;
+  void log_profiling_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const void* metadata,
+      size_t metadata_len) override;
+  void track_allocation(AllocatorID id, size_t size) override;
+  AllocatorID track_allocator(const char* name) override;
+  void log_evalue(
+      const EValue& evalue,
+      LoggedEValueType evalue_type =
+          LoggedEValueType::kIntermediateOutput) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      const Tensor& output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      const ArrayRef<Tensor> output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      const int& output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      const bool& output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      const double& output) override;
+
+  /// The stats, indexed by instruction.
+  Span<InstructionStats> stats() const {
+    return stats_;
+  }
+
+  /// Number of instruction events dropped because stats was too small.
+  size_t num_dropped_events() const {
+    return num_dropped_events_;
+  }
+
+  /// Zeroes the stats and the dropped event count.
+  void reset();
+
+ private:
+  Span<InstructionStats> stats_;
+  size_t num_dropped_events_ = 0;
+  // Number of profiling events that have started and not ended yet.
+  size_t depth_ = 0;
+};
+
+} // namespace executor
+} // namespace torch
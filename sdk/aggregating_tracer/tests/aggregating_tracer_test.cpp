@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/aggregating_tracer/aggregating_tracer.h>
+
+using namespace ::testing;
+using torch::executor::AggregatingTracer;
+using torch::executor::EventTracerEntry;
+using torch::executor::InstructionStats;
+using torch::executor::Span;
+
+class AggregatingTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Profiles one event of the given instruction the way Method does.
+  void run_instruction(AggregatingTracer& tracer, uint32_t instr_idx) {
+    tracer.set_chain_debug_handle(0, instr_idx);
+    EventTracerEntry entry = tracer.start_profiling("OPERATOR_CALL");
+    tracer.end_profiling(entry);
+    tracer.set_chain_debug_handle(
+        torch::executor::kUnsetChainId, torch::executor::kUnsetDebugHandle);
+  }
+
+  InstructionStats stats_[4];
+};
+
+TEST_F(AggregatingTracerTest, CountsEachInstruction) {
+  AggregatingTracer tracer(Span<InstructionStats>(stats_, 4));
+  for (int i = 0; i < 3; ++i) {
+    run_instruction(tracer, 0);
+    run_instruction(tracer, 2);
+  }
+  run_instruction(tracer, 2);
+
+  EXPECT_EQ(stats_[0].count, 3);
+  EXPECT_EQ(stats_[1].count, 0);
+  EXPECT_EQ(stats_[2].count, 4);
+  EXPECT_EQ(stats_[3].count, 0);
+  for (const InstructionStats& stats : stats_) {
+    EXPECT_LE(stats.max_ticks, stats.total_ticks);
+  }
+  EXPECT_EQ(tracer.num_dropped_events(), 0);
+}
+
+TEST_F(AggregatingTracerTest, NestedEventsCountOnce) {
+  AggregatingTracer tracer(Span<InstructionStats>(stats_, 4));
+  tracer.set_chain_debug_handle(0, 1);
+  EventTracerEntry step = tracer.start_profiling("Method::step");
+  EventTracerEntry call = tracer.start_profiling("OPERATOR_CALL");
+  EventTracerEntry delegate = tracer.start_profiling_delegate(nullptr, 7);
+  tracer.end_profiling_delegate(delegate, nullptr, 0);
+  tracer.end_profiling(call);
+  EXPECT_EQ(stats_[1].count, 0);
+  tracer.end_profiling(step);
+
+  EXPECT_EQ(stats_[1].count, 1);
+  EXPECT_EQ(stats_[1].total_ticks, stats_[1].max_ticks);
+}
+
+TEST_F(AggregatingTracerTest, IgnoresEventsOutsideInstructions) {
+  AggregatingTracer tracer(Span<InstructionStats>(stats_, 4));
+  EventTracerEntry init = tracer.start_profiling("Method::init");
+  tracer.end_profiling(init);
+
+  for (const InstructionStats& stats : stats_) {
+    EXPECT_EQ(stats.count, 0);
+  }
+  EXPECT_EQ(tracer.num_dropped_events(), 0);
+}
+
+TEST_F(AggregatingTracerTest, DropsInstructionsBeyondTheStats) {
+  AggregatingTracer tracer(Span<InstructionStats>(stats_, 2));
+  run_instruction(tracer, 1);
+  run_instruction(tracer, 2);
+  run_instruction(tracer, 3);
+
+  EXPECT_EQ(stats_[1].count, 1);
+  EXPECT_EQ(stats_[2].count, 0);
+  EXPECT_EQ(tracer.num_dropped_events(), 2);
+}
+
+TEST_F(AggregatingTracerTest, ResetClearsTheStats) {
+  AggregatingTracer tracer(Span<InstructionStats>(stats_, 2));
+  run_instruction(tracer, 0);
+  run_instruction(tracer, 5);
+  tracer.reset();
+
+  EXPECT_EQ(stats_[0].count, 0);
+  EXPECT_EQ(stats_[0].total_ticks, 0);
+  EXPECT_EQ(tracer.num_dropped_events(), 0);
+
+  run_instruction(tracer, 0);
+  EXPECT_EQ(stats_[0].count, 1);
+}
@@ -390,6 +390,106 @@ ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
   return Error::Ok;
 }
 
+ET_NODISCARD Result<size_t> GetNumBundledTestCases(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr) {
+  ET_CHECK_OR_RETURN_ERROR(
+      bundled_program_flatbuffer::BundledProgramBufferHasIdentifier(
+          bundled_program_ptr),
+      NotSupported,
+      "The input buffer should be a bundled program.");
+
+  auto method_test = get_method_test_suite(
+      bundled_program_flatbuffer::GetBundledProgram(bundled_program_ptr),
+      method);
+
+  if (!method_test.ok()) {
+    return method_test.error();
+  }
+
+  return static_cast<size_t>(method_test.get()->test_cases()->size());
+}
+
+ET_NODISCARD Result<PerfExpectation> GetBundledPerfExpectation(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr,
+    size_t testset_idx) {
+  ET_CHECK_OR_RETURN_ERROR(
+      bundled_program_flatbuffer::BundledProgramBufferHasIdentifier(
+          bundled_program_ptr),
+      NotSupported,
+      "The input buffer should be a bundled program.");
+
+  auto method_test = get_method_test_suite(
+      bundled_program_flatbuffer::GetBundledProgram(bundled_program_ptr),
+      method);
+
+  if (!method_test.ok()) {
+    return method_test.error();
+  }
+
+  auto test_cases = method_test.get()->test_cases();
+  ET_CHECK_OR_RETURN_ERROR(
+      testset_idx < test_cases->size(),
+      InvalidArgument,
+      "Test case %zu out of range: the method has %zu",
+      testset_idx,
+      static_cast<size_t>(test_cases->size()));
+
+  auto bundled_expectation = test_cases->Get(testset_idx)->perf_expectation();
+
+  PerfExpectation expectation;
+  if (bundled_expectation != nullptr) {
+    expectation.latency_us = bundled_expectation->latency_us();
+    expectation.memory_bytes =
+        static_cast<size_t>(bundled_expectation->memory_bytes());
+  }
+  return expectation;
+}
+
+ET_NODISCARD Error VerifyPerfWithBundledExpectation(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr,
+    size_t testset_idx,
+    double latency_us,
+    size_t memory_bytes,
+    double tolerance) {
+  auto expectation =
+      GetBundledPerfExpectation(method, bundled_program_ptr, testset_idx);
+  if (!expectation.ok()) {
+    return expectation.error();
+  }
+
+  bool regressed = false;
+  const double expected_latency_us = expectation->latency_us;
+  if (expected_latency_us > 0 &&
+      latency_us > expected_latency_us * (1 + tolerance)) {
+    ET_LOG(
+        Error,
+        "Test case %zu: latency %.1f us exceeds the expected %.1f us by more "
+        "than %.0f%%",
+        testset_idx,
+        latency_us,
+        expected_latency_us,
+        tolerance * 100);
+    regressed = true;
+  }
+  const size_t expected_memory_bytes = expectation->memory_bytes;
+  if (expected_memory_bytes > 0 &&
+      memory_bytes > expected_memory_bytes * (1 + tolerance)) {
+    ET_LOG(
+        Error,
+        "Test case %zu: memory %zu bytes exceeds the expected %zu bytes by "
+        "more than %.0f%%",
+        testset_idx,
+        memory_bytes,
+        expected_memory_bytes,
+        tolerance * 100);
+    regressed = true;
+  }
+  return regressed ? Error::NotFound : Error::Ok;
+}
+
 ET_NODISCARD Error GetProgramData(
     void* file_data,
     size_t file_data_len,
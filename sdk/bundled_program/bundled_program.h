@@ -56,6 +56,68 @@ ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
     double rtol = 1e-5,
     double atol = 1e-8);
 
+/**
+ * Performance expected from a method on the inputs of a bundled test case. A
+ * value of 0 means no expectation.
+ */
+struct PerfExpectation {
+  /// Expected duration of one execution of the method, in microseconds.
+  double latency_us = 0;
+  /// Expected bytes allocated at runtime for the method: the method allocator
+  /// after loading it plus the peak of the temp allocator during execution.
+  size_t memory_bytes = 0;
+};
+
+/**
+ * Returns the number of bundled test cases of the Method.
+ *
+ * @param[in] method The Method whose test cases to count.
+ * @param[in] bundled_program_ptr The bundled program.
+ */
+ET_NODISCARD Result<size_t> GetNumBundledTestCases(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr);
+
+/**
+ * Returns the performance expected from the Method on the testset_idx-th
+ * bundled input. The expectation is all zeros if the test case has none.
+ *
+ * @param[in] method The Method to check.
+ * @param[in] bundled_program_ptr The bundled program contains the expectation.
+ * @param[in] testset_idx The index of the test case.
+ */
+ET_NODISCARD Result<PerfExpectation> GetBundledPerfExpectation(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr,
+    size_t testset_idx);
+
+/**
+ * Compares the performance measured for the Method on the testset_idx-th
+ * bundled input with the bundled expectation. A measurement is a regression
+ * when it exceeds the expected value by more than the given fraction of it.
+ *
+ * @param[in] method The Method that was measured.
+ * @param[in] bundled_program_ptr The bundled program contains the expectation.
+ * @param[in] testset_idx The index of the test case.
+ * @param[in] latency_us The measured duration of one execution, in
+ *     microseconds.
+ * @param[in] memory_bytes The measured bytes allocated at runtime, as
+ *     described in PerfExpectation.
+ * @param[in] tolerance Allowed regression, as a fraction of the expected
+ *     values.
+ *
+ * @returns Return Error::Ok if no measurement regressed or the test case has
+ * no expectation, Error::NotFound on regressions like for mismatched outputs,
+ * or the error happens during execution.
+ */
+ET_NODISCARD Error VerifyPerfWithBundledExpectation(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr,
+    size_t testset_idx,
+    double latency_us,
+    size_t memory_bytes,
+    double tolerance = 0.1);
+
 /**
  * Finds the serialized ExecuTorch program data in the provided bundled program
  * file data.
@@ -49,12 +49,15 @@ DataContainer: TypeAlias = Union[list, tuple, dict]
 class MethodTestCase:
     """Test case with inputs and expected outputs
     The expected_outputs are optional and only required if the user wants to verify model outputs after execution.
+    The expected latency and memory are optional and only required if the user wants to check the model for performance regressions.
     """
 
     def __init__(
         self,
         inputs: MethodInputType,
         expected_outputs: Optional[MethodOutputType] = None,
+        expected_latency_us: Optional[float] = None,
+        expected_memory_bytes: Optional[int] = None,
     ) -> None:
         """Single test case for verifying specific method
 
@@ -67,6 +70,13 @@ class MethodTestCase:
 
             expected_outputs: Expected output of given input for verification. It can be None if user only wants to use the test case for profiling.
 
+            expected_latency_us: Expected duration of one execution of the method on the given input, in microseconds, on the target
+                    device. The runtime can fail the test case when it runs slower than this. It can be None if there is no expectation.
+
+            expected_memory_bytes: Expected bytes allocated at runtime for the method, that is the method allocator after loading
+                    the method plus the peak of the temp allocator during execution. The runtime can fail the test case when it uses
+                    more than this. It can be None if there is no expectation.
+
         Returns:
             self
         """
@@ -78,6 +88,15 @@ class MethodTestCase:
             # pyre-ignore [6]: Misalign data type for between MethodTestCase attribute and sanity check.
             self.expected_outputs = self._flatten_and_sanity_check(expected_outputs)
 
+        assert (
+            expected_latency_us is None or expected_latency_us > 0
+        ), f"The expected latency should be positive, but get {expected_latency_us}."
+        assert (
+            expected_memory_bytes is None or expected_memory_bytes > 0
+        ), f"The expected memory should be positive, but get {expected_memory_bytes}."
+        self.expected_latency_us: Optional[float] = expected_latency_us
+        self.expected_memory_bytes: Optional[int] = expected_memory_bytes
+
     def _flatten_and_sanity_check(
         self, unflatten_data: DataContainer
     ) -> List[ConfigValue]:
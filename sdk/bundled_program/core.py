@@ -18,7 +18,11 @@ import torch.fx
 from executorch.exir import ExecutorchProgram, ExecutorchProgramManager
 from executorch.exir._serialize import _serialize_pte_binary
 from executorch.exir.tensor import get_scalar_type, scalar_type_enum, TensorSpec
-from executorch.sdk.bundled_program.config import ConfigValue, MethodTestSuite
+from executorch.sdk.bundled_program.config import (
+    ConfigValue,
+    MethodTestCase,
+    MethodTestSuite,
+)
 
 from executorch.sdk.bundled_program.version import BUNDLED_PROGRAM_SCHEMA_VERSION
 
@@ -110,7 +114,11 @@ class BundledProgram:
                     )
                 bundled_test_cases.append(
                     bp_schema.BundledMethodTestCase(
-                        inputs=inputs, expected_outputs=expected_outputs
+                        inputs=inputs,
+                        expected_outputs=expected_outputs,
+                        perf_expectation=self._emit_perf_expectation(
+                            method_test_suite.test_cases[i]
+                        ),
                     )
                 )
 
@@ -160,6 +168,20 @@ class BundledProgram:
             )
         )
 
+    def _emit_perf_expectation(
+        self, test_case: MethodTestCase
+    ) -> Optional[bp_schema.BundledPerfExpectation]:
+        if (
+            test_case.expected_latency_us is None
+            and test_case.expected_memory_bytes is None
+        ):
+            return None
+        # 0 means no expectation in the schema.
+        return bp_schema.BundledPerfExpectation(
+            latency_us=test_case.expected_latency_us or 0.0,
+            memory_bytes=test_case.expected_memory_bytes or 0,
+        )
+
     def _emit_prim(self, val: ConfigValue, bundled_values: List[bp_schema.Value]):
         if type(val) is int:
             bundled_values.append(bp_schema.Value(val=bp_schema.Int(int_val=val)))
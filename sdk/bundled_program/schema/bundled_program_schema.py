@@ -7,7 +7,7 @@
 # pyre-strict
 
 from dataclasses import dataclass
-from typing import List, Union
+from typing import List, Optional, Union
 
 from executorch.exir.scalar_type import ScalarType
 
@@ -55,6 +55,20 @@ class Value:
     val: "ValueUnion"
 
 
+@dataclass
+class BundledPerfExpectation:
+    """Performance expected from a method on the inputs of a test case."""
+
+    # Expected duration of one execution of the method, in microseconds.
+    # 0 means no expectation.
+    latency_us: float
+
+    # Expected bytes allocated at runtime for the method: the method allocator
+    # after loading it plus the peak of the temp allocator during execution.
+    # 0 means no expectation.
+    memory_bytes: int
+
+
 @dataclass
 class BundledMethodTestCase:
     """All inputs and referenced outputs needs for single verification."""
@@ -68,6 +82,9 @@ class BundledMethodTestCase:
     # of program outputs.
     expected_outputs: List[Value]
 
+    # Optional performance expected from the method on the inputs.
+    perf_expectation: Optional[BundledPerfExpectation] = None
+
 
 @dataclass
 class BundledMethodTestSuite:
@@ -8,6 +8,8 @@
 
 import unittest
 
+import executorch.sdk.bundled_program.schema as bp_schema
+
 from executorch.sdk.bundled_program.core import BundledProgram
 
 from executorch.sdk.bundled_program.serialize import (
@@ -33,3 +35,32 @@ class TestSerialize(unittest.TestCase):
             regenerate_bundled_program_in_schema,
             "Regenerated bundled program mismatches original one",
         )
+
+    def test_bundled_program_serialization_with_perf_expectation(self) -> None:
+        executorch_program, method_test_suites = get_common_executorch_program()
+        test_case = method_test_suites[0].test_cases[0]
+        test_case.expected_latency_us = 1500.0
+        test_case.expected_memory_bytes = 4096
+
+        bundled_program = BundledProgram(executorch_program, method_test_suites)
+        regenerate_bundled_program_in_schema = (
+            deserialize_from_flatbuffer_to_bundled_program(
+                serialize_from_bundled_program_to_flatbuffer(bundled_program)
+            )
+        )
+        self.assertEqual(
+            bundled_program.serialize_to_schema(),
+            regenerate_bundled_program_in_schema,
+            "Regenerated bundled program mismatches original one",
+        )
+
+        method_test_suite = next(
+            s
+            for s in regenerate_bundled_program_in_schema.method_test_suites
+            if s.method_name == method_test_suites[0].method_name
+        )
+        self.assertEqual(
+            method_test_suite.test_cases[0].perf_expectation,
+            bp_schema.BundledPerfExpectation(latency_us=1500.0, memory_bytes=4096),
+        )
+        self.assertIsNone(method_test_suite.test_cases[1].perf_expectation)
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/sdk/etdump/chrome_trace.h>
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/sdk/etdump/etdump_schema_flatcc_reader.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+// Tracks of the trace.
+constexpr int kRuntimeTid = 0;
+constexpr int kDelegateTid = 1;
+
+void append_json_string(std::string& json, const char* str) {
+  json += '"';
+  for (const char* c = str; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      json += '\\';
+      json += *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+      json += escaped;
+    } else {
+      json += *c;
+    }
+  }
+  json += '"';
+}
+
+void append_int(std::string& json, const char* key, int64_t value) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), ",\"%s\":%" PRId64, key, value);
+  json += buf;
+}
+
+// Chrome traces are in microseconds.
+void append_us(std::string& json, const char* key, double ns) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), ",\"%s\":%.3f", key, ns / 1000.0);
+  json += buf;
+}
+
+// Same as the Inspector: timestamps that went backwards wrapped around 32
+// bits on the device.
+uint64_t elapsed_ticks(uint64_t start, uint64_t end) {
+  constexpr uint64_t kMaxUint32 = std::numeric_limits<uint32_t>::max();
+  if (end >= start) {
+    return end - start;
+  }
+  if (start > kMaxUint32 || end > kMaxUint32) {
+    return 0;
+  }
+  return (kMaxUint32 - start) + end;
+}
+
+class ChromeTraceWriter {
+ public:
+  ChromeTraceWriter(ETDumpWriter* out, double ns_per_tick)
+      : out_(out), ns_per_tick_(ns_per_tick) {}
+
+  Error begin() {
+    json_ =
+        "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+        "{\"ph\":\"M\",\"pid\":0,\"name\":\"process_name\","
+        "\"args\":{\"name\":\"ExecuTorch\"}},\n"
+        "{\"ph\":\"M\",\"pid\":0,\"tid\":0,\"name\":\"thread_name\","
+        "\"args\":{\"name\":\"Runtime\"}},\n"
+        "{\"ph\":\"M\",\"pid\":0,\"tid\":1,\"name\":\"thread_name\","
+        "\"args\":{\"name\":\"Delegates\"}}";
+    return flush();
+  }
+
+  Error end() {
+    json_ = "\n]}\n";
+    return flush();
+  }
+
+  Error add_run_data(etdump_RunData_table_t run_data) {
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    const size_t num_events = etdump_Event_vec_len(events);
+
+    // Span of the whole block.
+    bool has_profile_events = false;
+    uint64_t block_start = 0;
+    uint64_t block_end = 0;
+    for (size_t i = 0; i < num_events; ++i) {
+      etdump_ProfileEvent_table_t event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, i));
+      if (event == nullptr || is_delegate_event(event)) {
+        continue;
+      }
+      const uint64_t start = etdump_ProfileEvent_start_time(event);
+      const uint64_t end = start +
+          elapsed_ticks(start, etdump_ProfileEvent_end_time(event));
+      if (!has_profile_events || start < block_start) {
+        block_start = start;
+      }
+      if (!has_profile_events || end > block_end) {
+        block_end = end;
+      }
+      has_profile_events = true;
+    }
+    if (has_profile_events) {
+      const char* name = etdump_RunData_name(run_data);
+      begin_event(name != nullptr ? name : "", "block", kRuntimeTid);
+      append_us(json_, "ts", block_start * ns_per_tick_);
+      append_us(json_, "dur", (block_end - block_start) * ns_per_tick_);
+      json_ += ",\"args\":{\"bundled_input_index\":";
+      json_ += std::to_string(etdump_RunData_bundled_input_index(run_data));
+      json_ += "}}";
+      Error err = flush();
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+
+    for (size_t i = 0; i < num_events; ++i) {
+      etdump_ProfileEvent_table_t event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, i));
+      if (event == nullptr) {
+        continue;
+      }
+      Error err = add_profile_event(event);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+    return Error::Ok;
+  }
+
+ private:
+  static bool is_delegate_event(etdump_ProfileEvent_table_t event) {
+    const char* id_str = etdump_ProfileEvent_delegate_debug_id_str(event);
+    return etdump_ProfileEvent_delegate_debug_id_int(event) != -1 ||
+        (id_str != nullptr && id_str[0] != '\0');
+  }
+
+  void begin_event(const char* name, const char* category, int tid) {
+    json_ += ",\n{\"ph\":\"X\",\"pid\":0,\"tid\":";
+    json_ += std::to_string(tid);
+    json_ += ",\"cat\":\"";
+    json_ += category;
+    json_ += "\",\"name\":";
+    append_json_string(json_, name);
+  }
+
+  Error add_profile_event(etdump_ProfileEvent_table_t event) {
+    const bool is_delegate = is_delegate_event(event);
+    const int32_t delegate_id_int =
+        etdump_ProfileEvent_delegate_debug_id_int(event);
+    const char* delegate_id_str =
+        etdump_ProfileEvent_delegate_debug_id_str(event);
+
+    // Like the Inspector, delegate events are named by their debug id.
+    std::string name;
+    if (!is_delegate) {
+      const char* event_name = etdump_ProfileEvent_name(event);
+      name = event_name != nullptr ? event_name : "";
+    } else if (delegate_id_int != -1) {
+      name = std::to_string(delegate_id_int);
+    } else {
+      name = delegate_id_str;
+    }
+    begin_event(
+        name.c_str(),
+        is_delegate ? "delegate" : "runtime",
+        is_delegate ? kDelegateTid : kRuntimeTid);
+
+    const uint64_t start = etdump_ProfileEvent_start_time(event);
+    const uint64_t end = etdump_ProfileEvent_end_time(event);
+    append_us(json_, "ts", start * ns_per_tick_);
+    append_us(json_, "dur", elapsed_ticks(start, end) * ns_per_tick_);
+
+    json_ += ",\"args\":{\"instruction_id\":";
+    json_ += std::to_string(etdump_ProfileEvent_instruction_id(event));
+    if (is_delegate && delegate_id_int != -1) {
+      append_int(json_, "delegate_debug_id", delegate_id_int);
+    } else if (is_delegate) {
+      json_ += ",\"delegate_debug_id\":";
+      append_json_string(json_, delegate_id_str);
+    }
+    if (etdump_ProfileEvent_perf_counters_is_present(event)) {
+      etdump_PerfCounters_table_t counters =
+          etdump_ProfileEvent_perf_counters(event);
+      const struct {
+        const char* key;
+        int64_t value;
+      } values[] = {
+          {"cycles", etdump_PerfCounters_cycles(counters)},
+          {"instructions", etdump_PerfCounters_instructions(counters)},
+          {"cache_references", etdump_PerfCounters_cache_references(counters)},
+          {"cache_misses", etdump_PerfCounters_cache_misses(counters)},
+          {"stalled_cycles_frontend",
+           etdump_PerfCounters_stalled_cycles_frontend(counters)},
+          {"stalled_cycles_backend",
+           etdump_PerfCounters_stalled_cycles_backend(counters)},
+      };
+      for (const auto& value : values) {
+        if (value.value >= 0) {
+          append_int(json_, value.key, value.value);
+        }
+      }
+    }
+    if (etdump_ProfileEvent_op_cost_is_present(event)) {
+      etdump_OpCost_table_t op_cost = etdump_ProfileEvent_op_cost(event);
+      append_int(json_, "flops", etdump_OpCost_flops(op_cost));
+      append_int(json_, "bytes_read", etdump_OpCost_bytes_read(op_cost));
+      append_int(json_, "bytes_written", etdump_OpCost_bytes_written(op_cost));
+    }
+    json_ += "}}";
+    return flush();
+  }
+
+  Error flush() {
+    Error err = out_->write(json_.data(), json_.size());
+    json_.clear();
+    return err;
+  }
+
+  ETDumpWriter* out_;
+  const double ns_per_tick_;
+  std::string json_;
+};
+
+} // namespace
+
+Error write_chrome_trace(
+    const void* etdump_data,
+    size_t etdump_size,
+    ETDumpWriter* out,
+    double ns_per_tick) {
+  ChromeTraceWriter writer(out, ns_per_tick);
+  Error err = writer.begin();
+  if (err != Error::Ok) {
+    return err;
+  }
+
+  const uint8_t* data = static_cast<const uint8_t*>(etdump_data);
+  size_t offset = 0;
+  // Stop at the end of the data, or at padding after the last ETDump.
+  while (etdump_size - offset >= sizeof(flatbuffers_uoffset_t)) {
+    flatbuffers_uoffset_t size;
+    memcpy(&size, data + offset, sizeof(size));
+    if (size == 0) {
+      break;
+    }
+    const size_t chunk_size = sizeof(size) + size;
+    if (chunk_size > etdump_size - offset) {
+      ET_LOG(
+          Error,
+          "ETDump at offset %zu has a size of %zu but only %zu bytes are left",
+          offset,
+          chunk_size,
+          etdump_size - offset);
+      return Error::InvalidArgument;
+    }
+
+    // The ETDumps in a stream are not aligned, and flatcc reads fields in
+    // place.
+    const uint8_t* chunk = data + offset;
+    void* aligned_chunk = nullptr;
+    if (reinterpret_cast<uintptr_t>(chunk) % alignof(uint64_t) != 0) {
+      aligned_chunk = malloc(chunk_size);
+      if (aligned_chunk == nullptr) {
+        return Error::MemoryAllocationFailed;
+      }
+      memcpy(aligned_chunk, chunk, chunk_size);
+      chunk = static_cast<const uint8_t*>(aligned_chunk);
+    }
+
+    size_t buf_size = 0;
+    const void* buf = flatbuffers_read_size_prefix(chunk, &buf_size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    if (etdump == nullptr) {
+      ET_LOG(Error, "Data at offset %zu is not an ETDump", offset);
+      free(aligned_chunk);
+      return Error::InvalidArgument;
+    }
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    for (size_t i = 0; i < etdump_RunData_vec_len(run_data_vec); ++i) {
+      err = writer.add_run_data(etdump_RunData_vec_at(run_data_vec, i));
+      if (err != Error::Ok) {
+        break;
+      }
+    }
+    free(aligned_chunk);
+    if (err != Error::Ok) {
+      return err;
+    }
+    offset += chunk_size;
+  }
+
+  return writer.end();
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/sdk/etdump/etdump_flatcc.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Converts ETDump data to the Chrome trace event JSON format, which can be
+ * opened in Perfetto (ui.perfetto.dev) or chrome://tracing, so that op and
+ * delegate timelines can be looked at without the Python Inspector.
+ *
+ * Each block of the ETDump is drawn as a span covering its events. Profiling
+ * events of the runtime and its kernels are on one track, and events logged by
+ * delegates are on a second one, so that delegate work overlaps the
+ * DELEGATE_CALL that contains it. Instruction ids, delegate debug ids, the
+ * hardware counters recorded with ETDumpGen::set_perf_counters() and the op
+ * costs of OPERATOR_CALL events are attached as arguments of each event. Debug
+ * and allocation events are skipped.
+ *
+ * Delegate events logged with log_profiling_delegate() keep the timestamps
+ * that the delegate gave them, which may not be in the same unit as the
+ * others.
+ *
+ * The data is not verified, so it must come from a trusted ETDumpGen.
+ *
+ * @param[in] etdump_data One or more size-prefixed ETDumps back to back, as
+ *     returned by ETDumpGen::get_etdump_data() or written by the streaming
+ *     mode of ETDumpGen.
+ * @param[in] etdump_size Size of etdump_data in bytes.
+ * @param[in] out Receives the JSON, in pieces.
+ * @param[in] ns_per_tick Duration in nanoseconds of one unit of the event
+ *     timestamps on the device that generated the ETDump. 1 for the default
+ *     POSIX platform.
+ *
+ * @retval Error::Ok The whole trace was written.
+ * @retval Error::InvalidArgument The data is not a sequence of size-prefixed
+ *     ETDumps.
+ * @returns Any error that out returned, after which nothing else is written.
+ */
+ET_NODISCARD Error write_chrome_trace(
+    const void* etdump_data,
+    size_t etdump_size,
+    ETDumpWriter* out,
+    double ns_per_tick = 1.0);
+
+} // namespace executor
+} // namespace torch
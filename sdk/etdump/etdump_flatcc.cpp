@@ -12,6 +12,7 @@
 #include <flatcc/flatcc_types.h>
 #include <stdio.h>
 #include <string.h>
+#include <cinttypes>
 #include "executorch/runtime/core/exec_aten/exec_aten.h"
 #include "executorch/runtime/core/exec_aten/util/scalar_type_util.h"
 #include "executorch/runtime/platform/assert.h"
@@ -134,6 +135,9 @@ void ETDumpGen::reset() {
 }
 
 void ETDumpGen::create_event_block(const char* name) {
+  if (etdump_writer != nullptr && num_blocks > 0) {
+    write_etdump_to_stream();
+  }
   if (etdump_gen_state == ETDumpGen_Adding_Events) {
     etdump_RunData_events_end(builder);
   } else if (etdump_gen_state == ETDumpGen_Done) {
@@ -197,6 +201,9 @@ EventTracerEntry ETDumpGen::start_profiling(
     prof_entry.chain_id = chain_id;
     prof_entry.debug_handle = debug_handle;
   }
+  if (perf_counters != nullptr) {
+    start_perf_counters();
+  }
   prof_entry.start_time = et_pal_current_ticks();
   return prof_entry;
 }
@@ -219,6 +226,9 @@ EventTracerEntry ETDumpGen::start_profiling_delegate(
   prof_entry.event_id = delegate_debug_index == static_cast<unsigned int>(-1)
       ? create_string_entry(name)
       : delegate_debug_index;
+  if (perf_counters != nullptr) {
+    start_perf_counters();
+  }
   prof_entry.start_time = et_pal_current_ticks();
   return prof_entry;
 }
@@ -229,6 +239,8 @@ void ETDumpGen::end_profiling_delegate(
     size_t metadata_len) {
   et_timestamp_t end_time = et_pal_current_ticks();
   check_ready_to_add_events();
+  etdump_PerfCounters_ref_t perf_counters_ref =
+      perf_counters != nullptr ? end_perf_counters() : 0;
 
   // Start building the ProfileEvent entry.
   etdump_ProfileEvent_start(builder);
@@ -250,6 +262,9 @@ void ETDumpGen::end_profiling_delegate(
   flatbuffers_uint8_vec_ref_t vec_ref = flatbuffers_uint8_vec_create_pe(
       builder, (const uint8_t*)metadata, metadata_len);
   etdump_ProfileEvent_delegate_debug_metadata_add(builder, vec_ref);
+  if (perf_counters_ref != 0) {
+    etdump_ProfileEvent_perf_counters_add(builder, perf_counters_ref);
+  }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder);
   etdump_RunData_events_push_start(builder);
   etdump_Event_profile_event_add(builder, id);
@@ -282,6 +297,9 @@ void ETDumpGen::log_profiling_delegate(
   flatbuffers_uint8_vec_ref_t vec_ref = flatbuffers_uint8_vec_create_pe(
       builder, (const uint8_t*)metadata, metadata_len);
   etdump_ProfileEvent_delegate_debug_metadata_add(builder, vec_ref);
+  if (perf_counters_ref != 0) {
+    etdump_ProfileEvent_perf_counters_add(builder, perf_counters_ref);
+  }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder);
   etdump_RunData_events_push_start(builder);
   etdump_Event_profile_event_add(builder, id);
@@ -331,8 +349,10 @@ void ETDumpGen::log_intermediate_output_delegate_helper(
   ET_CHECK_MSG(
       (name == nullptr) ^ (delegate_debug_index == -1),
       "Only name or delegate_debug_index can be valid. Check DelegateMappingBuilder documentation for more details.");
-  if (debug_buffer.empty()) {
-    ET_CHECK_MSG(0, "Must pre-set debug buffer with set_debug_buffer()\n");
+  if (!has_debug_output()) {
+    ET_CHECK_MSG(
+        0,
+        "Must pre-set debug buffer with set_debug_buffer() or a debug writer with set_streaming_writers()\n");
     return;
   }
 
@@ -412,6 +432,14 @@ void ETDumpGen::end_profiling(EventTracerEntry prof_entry) {
       prof_entry.delegate_event_id_type == DelegateDebugIdType::kNone,
       "Delegate events must use end_profiling_delegate to mark the end of a delegate profiling event.");
   check_ready_to_add_events();
+  etdump_PerfCounters_ref_t perf_counters_ref =
+      perf_counters != nullptr ? end_perf_counters() : 0;
+  etdump_OpCost_ref_t op_cost_ref = 0;
+  if (has_op_cost_) {
+    op_cost_ref = etdump_OpCost_create(
+        builder, op_cost_flops_, op_cost_bytes_read_, op_cost_bytes_written_);
+    has_op_cost_ = false;
+  }
 
   etdump_ProfileEvent_start(builder);
   etdump_ProfileEvent_start_time_add(builder, prof_entry.start_time);
@@ -421,6 +449,12 @@ void ETDumpGen::end_profiling(EventTracerEntry prof_entry) {
   if (prof_entry.event_id != -1) {
     etdump_ProfileEvent_name_add(builder, prof_entry.event_id);
   }
+  if (perf_counters_ref != 0) {
+    etdump_ProfileEvent_perf_counters_add(builder, perf_counters_ref);
+  }
+  if (op_cost_ref != 0) {
+    etdump_ProfileEvent_op_cost_add(builder, op_cost_ref);
+  }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder);
   etdump_RunData_events_push_start(builder);
   etdump_Event_profile_event_add(builder, id);
@@ -452,6 +486,14 @@ void ETDumpGen::track_allocation(
 }
 
 etdump_result ETDumpGen::get_etdump_data() {
+  if (etdump_writer != nullptr) {
+    write_etdump_to_stream();
+    return {nullptr, 0};
+  }
+  return finish_etdump();
+}
+
+etdump_result ETDumpGen::finish_etdump() {
   etdump_result result;
   if (etdump_gen_state == ETDumpGen_Adding_Events) {
     etdump_RunData_events_end(builder);
@@ -481,14 +523,131 @@ etdump_result ETDumpGen::get_etdump_data() {
   return result;
 }
 
+void ETDumpGen::write_etdump_to_stream() {
+  etdump_result result = finish_etdump();
+  if (result.buf != nullptr) {
+    // Write exactly the size prefix and the buffer it covers, so that the
+    // stream can be split on the prefixes.
+    size_t size = 0;
+    const uint8_t* data =
+        (const uint8_t*)flatbuffers_read_size_prefix(result.buf, &size);
+    const size_t total_size = (size_t)(data - (uint8_t*)result.buf) + size;
+    Error err = etdump_writer->write(result.buf, total_size);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to write %zu bytes of ETDump: 0x%" PRIx32,
+          total_size,
+          static_cast<uint32_t>(err));
+    }
+    free(result.buf);
+  }
+  // Drops the finished blocks; the builder keeps its memory for the next
+  // ones.
+  reset();
+}
+
 void ETDumpGen::set_debug_buffer(Span<uint8_t> buffer) {
   debug_buffer = buffer;
 }
 
+void ETDumpGen::set_streaming_writers(
+    ETDumpWriter* etdump_writer,
+    ETDumpWriter* debug_writer) {
+  ET_CHECK_MSG(
+      !is_static_etdump(),
+      "Streaming is only supported by an ETDumpGen without a static buffer.");
+  ET_CHECK_MSG(
+      etdump_gen_state == ETDumpGen_Init,
+      "Streaming writers must be set before the first block is created.");
+  this->etdump_writer = etdump_writer;
+  this->debug_writer = debug_writer;
+  debug_writer_offset = 0;
+}
+
+void ETDumpGen::set_perf_counters(PerfCounters* perf_counters) {
+  this->perf_counters = perf_counters;
+  perf_event_depth = 0;
+}
+
+void ETDumpGen::start_perf_counters() {
+  if (perf_event_depth < kMaxNestedPerfEvents) {
+    perf_counters->read(&perf_counter_starts[perf_event_depth]);
+  }
+  perf_event_depth++;
+}
+
+etdump_PerfCounters_ref_t ETDumpGen::end_perf_counters() {
+  if (perf_event_depth == 0) {
+    // The event started before the perf counters were set.
+    return 0;
+  }
+  perf_event_depth--;
+  if (perf_event_depth >= kMaxNestedPerfEvents) {
+    return 0;
+  }
+  PerfCounterValues end_values;
+  if (!perf_counters->read(&end_values)) {
+    return 0;
+  }
+  const PerfCounterValues& start_values =
+      perf_counter_starts[perf_event_depth];
+  int64_t deltas[kNumPerfCounters];
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    deltas[i] = start_values.values[i] >= 0 && end_values.values[i] >= 0
+        ? end_values.values[i] - start_values.values[i]
+        : -1;
+  }
+  // Counters left at their default of -1 are not written.
+  etdump_PerfCounters_start(builder);
+  etdump_PerfCounters_cycles_add(
+      builder, deltas[static_cast<size_t>(PerfCounter::Cycles)]);
+  etdump_PerfCounters_instructions_add(
+      builder, deltas[static_cast<size_t>(PerfCounter::Instructions)]);
+  etdump_PerfCounters_cache_references_add(
+      builder, deltas[static_cast<size_t>(PerfCounter::CacheReferences)]);
+  etdump_PerfCounters_cache_misses_add(
+      builder, deltas[static_cast<size_t>(PerfCounter::CacheMisses)]);
+  etdump_PerfCounters_stalled_cycles_frontend_add(
+      builder, deltas[static_cast<size_t>(PerfCounter::StalledCyclesFrontend)]);
+  etdump_PerfCounters_stalled_cycles_backend_add(
+      builder, deltas[static_cast<size_t>(PerfCounter::StalledCyclesBackend)]);
+  return etdump_PerfCounters_end(builder);
+}
+
+bool ETDumpGen::has_debug_output() {
+  return !debug_buffer.empty() || debug_writer != nullptr;
+}
+
 size_t ETDumpGen::copy_tensor_to_debug_buffer(exec_aten::Tensor tensor) {
   if (tensor.nbytes() == 0) {
     return static_cast<size_t>(-1);
   }
+  if (debug_writer != nullptr) {
+    static const uint8_t kPadding[64] = {};
+    const size_t padding = (64 - debug_writer_offset % 64) % 64;
+    Error err = Error::Ok;
+    if (padding > 0) {
+      err = debug_writer->write(kPadding, padding);
+      if (err == Error::Ok) {
+        debug_writer_offset += padding;
+      }
+    }
+    if (err == Error::Ok) {
+      err = debug_writer->write(tensor.const_data_ptr(), tensor.nbytes());
+    }
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to write %zu bytes of debug data: 0x%" PRIx32,
+          tensor.nbytes(),
+          static_cast<uint32_t>(err));
+      return static_cast<size_t>(-1);
+    }
+    const size_t offset = debug_writer_offset;
+    debug_writer_offset += tensor.nbytes();
+    return offset;
+  }
   uint8_t* offset_ptr =
       alignPointer(debug_buffer.data() + debug_buffer_offset, 64);
   debug_buffer_offset = (offset_ptr - debug_buffer.data()) + tensor.nbytes();
@@ -500,7 +659,7 @@ size_t ETDumpGen::copy_tensor_to_debug_buffer(exec_aten::Tensor tensor) {
 }
 
 void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
-  if (debug_buffer.empty()) {
+  if (!has_debug_output()) {
     return;
   }
 
@@ -8,10 +8,12 @@
 
 #pragma once
 
+#include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/span.h>
 #include <cstdint>
 #include "executorch/runtime/core/event_tracer.h"
 #include "executorch/runtime/platform/platform.h"
+#include "executorch/sdk/etdump/perf_counters.h"
 
 #define ETDUMP_VERSION 0
 
@@ -65,6 +67,21 @@ struct etdump_static_allocator {
   size_t front_left{0};
 };
 
+/**
+ * Destination of a streaming ETDumpGen, e.g. a file or a socket. See
+ * ETDumpGen::set_streaming_writers().
+ */
+class ETDumpWriter {
+ public:
+  virtual ~ETDumpWriter() = default;
+
+  /**
+   * Appends size bytes at data to the stream. The data is only valid during
+   * the call.
+   */
+  virtual Error write(const void* data, size_t size) = 0;
+};
+
 class ETDumpGen : public EventTracer {
  public:
   ETDumpGen(Span<uint8_t> buffer = {nullptr, (size_t)0});
@@ -137,6 +154,34 @@ class ETDumpGen : public EventTracer {
       DebugHandle delegate_debug_index,
       const double& output) override;
   void set_debug_buffer(Span<uint8_t> buffer);
+  /**
+   * Switches to streaming mode, where the memory used does not grow with the
+   * number of blocks. Whenever a new block is created, the blocks before it
+   * are written to etdump_writer as a size-prefixed ETDump, and
+   * get_etdump_data() writes the remaining blocks the same way and returns an
+   * empty result. The stream is a sequence of these ETDumps, each of which
+   * starts with its size as a little-endian uint32.
+   *
+   * If debug_writer is set, logged tensors are written to it as they are
+   * logged, 64-byte aligned from the start of the stream, instead of being
+   * copied into the debug buffer. Tensor offsets in the ETDumps are then
+   * offsets in that stream.
+   *
+   * Only supported by an ETDumpGen that allocates its own memory, i.e. that
+   * was constructed without a buffer. The writers must outlive it.
+   */
+  void set_streaming_writers(
+      ETDumpWriter* etdump_writer,
+      ETDumpWriter* debug_writer = nullptr);
+  /**
+   * Records the hardware counters read by perf_counters over each profiling
+   * event, except the delegate events logged after the fact with
+   * log_profiling_delegate(). Must not be called while an event is in
+   * progress. perf_counters only counts the thread that created it, which
+   * should be the one executing the method, and must outlive this object.
+   * Pass nullptr to stop recording.
+   */
+  void set_perf_counters(PerfCounters* perf_counters);
   etdump_result get_etdump_data();
   size_t get_num_blocks();
   bool is_static_etdump();
@@ -150,8 +195,24 @@ class ETDumpGen : public EventTracer {
   int bundled_input_index = -1;
   ETDumpGen_State etdump_gen_state = ETDumpGen_Init;
   struct etdump_static_allocator alloc;
+  ETDumpWriter* etdump_writer = nullptr;
+  ETDumpWriter* debug_writer = nullptr;
+  size_t debug_writer_offset = 0;
+  // Counter values at the start of the profiling events in progress, the
+  // innermost last. Events nested deeper than this are not counted.
+  static constexpr size_t kMaxNestedPerfEvents = 8;
+  PerfCounters* perf_counters = nullptr;
+  PerfCounterValues perf_counter_starts[kMaxNestedPerfEvents];
+  size_t perf_event_depth = 0;
 
   void check_ready_to_add_events();
+  void start_perf_counters();
+  // Adds the counters of the innermost event to the builder, returns the
+  // reference to them or 0 if the event was not counted.
+  uint32_t end_perf_counters();
+  etdump_result finish_etdump();
+  void write_etdump_to_stream();
+  bool has_debug_output();
   int64_t create_string_entry(const char* name);
   size_t copy_tensor_to_debug_buffer(exec_aten::Tensor tensor);
 
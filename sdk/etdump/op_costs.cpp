@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/sdk/etdump/op_costs.h>
+
+#include <executorch/runtime/kernel/operator_registry.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+using ::executorch::runtime::OpCost;
+using ::executorch::runtime::OpCostEntry;
+using ::executorch::runtime::register_op_costs;
+using exec_aten::Tensor;
+
+uint64_t nbytes(const EValue& value) {
+  if (value.isTensor()) {
+    return value.toTensor().nbytes();
+  }
+  if (value.isTensorList()) {
+    uint64_t total = 0;
+    for (const Tensor& tensor : value.toTensorList()) {
+      total += tensor.nbytes();
+    }
+    return total;
+  }
+  return 0;
+}
+
+/**
+ * The bytes that a call of an .out op with `num_args` arguments must move:
+ * all of its tensor arguments are read, except `out`, its last argument,
+ * which is written.
+ */
+OpCost out_op_bytes(EValue** stack, size_t num_args) {
+  OpCost cost;
+  if (num_args == 0) {
+    return cost;
+  }
+  for (size_t i = 0; i + 1 < num_args; ++i) {
+    cost.bytes_read += nbytes(*stack[i]);
+  }
+  cost.bytes_written = nbytes(*stack[num_args - 1]);
+  return cost;
+}
+
+const Tensor& out_tensor(EValue** stack, size_t num_args) {
+  return stack[num_args - 1]->toTensor();
+}
+
+OpCost copy_cost(EValue** stack, size_t num_args) {
+  return out_op_bytes(stack, num_args);
+}
+
+// One FLOP per output element.
+OpCost elementwise_cost(EValue** stack, size_t num_args) {
+  OpCost cost = out_op_bytes(stack, num_args);
+  cost.flops = out_tensor(stack, num_args).numel();
+  return cost;
+}
+
+// mm.out(self, mat2, out): [M, K] x [K, N].
+OpCost mm_cost(EValue** stack, size_t num_args) {
+  OpCost cost = out_op_bytes(stack, num_args);
+  const Tensor& self = stack[0]->toTensor();
+  cost.flops = 2 * static_cast<uint64_t>(out_tensor(stack, num_args).numel()) *
+      self.size(self.dim() - 1);
+  return cost;
+}
+
+// addmm.out(self, mat1, mat2, beta, alpha, out): the product, plus self.
+OpCost addmm_cost(EValue** stack, size_t num_args) {
+  OpCost cost = out_op_bytes(stack, num_args);
+  const Tensor& mat1 = stack[1]->toTensor();
+  const uint64_t out_numel = out_tensor(stack, num_args).numel();
+  cost.flops = 2 * out_numel * mat1.size(mat1.dim() - 1) + out_numel;
+  return cost;
+}
+
+// convolution.out(input, weight, bias, stride, padding, dilation, transposed,
+// output_padding, groups, out). Each output element of a convolution, and
+// each input element of a transposed one, takes one multiply-add per weight
+// of an output channel, i.e. weight.numel() / weight.size(0) of them.
+OpCost convolution_cost(EValue** stack, size_t num_args) {
+  OpCost cost = out_op_bytes(stack, num_args);
+  const Tensor& input = stack[0]->toTensor();
+  const Tensor& weight = stack[1]->toTensor();
+  const bool transposed = stack[6]->toBool();
+  const Tensor& out = out_tensor(stack, num_args);
+  if (weight.dim() == 0 || weight.size(0) == 0) {
+    return cost;
+  }
+  const uint64_t macs_per_element = weight.numel() / weight.size(0);
+  const uint64_t elements = transposed ? input.numel() : out.numel();
+  cost.flops = 2 * elements * macs_per_element;
+  if (!stack[2]->isNone()) {
+    cost.flops += out.numel();
+  }
+  return cost;
+}
+
+const OpCostEntry kDefaultOpCosts[] = {
+    {"aten::mm.out", mm_cost},
+    // bmm is an mm per batch, and out holds all of their outputs.
+    {"aten::bmm.out", mm_cost},
+    {"aten::addmm.out", addmm_cost},
+    {"aten::convolution.out", convolution_cost},
+    {"aten::add.out", elementwise_cost},
+    {"aten::add.Scalar_out", elementwise_cost},
+    {"aten::sub.out", elementwise_cost},
+    {"aten::sub.Scalar_out", elementwise_cost},
+    {"aten::mul.out", elementwise_cost},
+    {"aten::mul.Scalar_out", elementwise_cost},
+    {"aten::div.out", elementwise_cost},
+    {"aten::div.Scalar_out", elementwise_cost},
+    {"aten::clone.out", copy_cost},
+    {"aten::cat.out", copy_cost},
+    {"aten::permute_copy.out", copy_cost},
+    {"aten::_to_copy.out", copy_cost},
+};
+
+} // namespace
+
+Error register_default_op_costs() {
+  return register_op_costs(ArrayRef<OpCostEntry>(
+      kDefaultOpCosts, sizeof(kDefaultOpCosts) / sizeof(kDefaultOpCosts[0])));
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Registers cost functions (see register_op_costs()) for common portable
+ * operators, so that an ETDump records the FLOPs and bytes moved by each of
+ * their calls and the Inspector can report the achieved GFLOP/s and GB/s per
+ * op:
+ *
+ * - aten::mm, bmm, addmm and convolution count two FLOPs per multiply-add.
+ * - Elementwise add, sub, mul and div count one FLOP per output element.
+ * - Copies such as clone, cat and permute_copy only move bytes.
+ *
+ * Bytes read are the sizes of the input tensors, and bytes written the size
+ * of the output, i.e. what the call must move at the least. Call it once,
+ * before executing the methods to profile; calling it again fails with
+ * Error::InvalidArgument.
+ */
+ET_NODISCARD Error register_default_op_costs();
+
+} // namespace executor
+} // namespace torch
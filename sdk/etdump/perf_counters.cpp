@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/sdk/etdump/perf_counters.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+
+#if defined(__linux__)
+
+namespace {
+
+struct CounterConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+// Indexed by PerfCounter.
+constexpr CounterConfig kCounterConfigs[kNumPerfCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+};
+
+int open_counter(const CounterConfig& counter_config, int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = counter_config.type;
+  attr.config = counter_config.config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // The group is enabled at once when all of its counters are open.
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  // Counting the kernel is not allowed by default on Android.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(
+      __NR_perf_event_open,
+      &attr,
+      /*pid=*/0,
+      /*cpu=*/-1,
+      group_fd,
+      /*flags=*/0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  int group_fd = -1;
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    fds_[i] = open_counter(kCounterConfigs[i], group_fd);
+    if (fds_[i] < 0) {
+      continue;
+    }
+    if (group_fd < 0) {
+      group_fd = fds_[i];
+    }
+    ++num_available_;
+  }
+  if (group_fd < 0) {
+    ET_LOG(Info, "No hardware performance counter is available");
+    return;
+  }
+  ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+  // Close the group leader last.
+  for (size_t i = kNumPerfCounters; i > 0; --i) {
+    if (fds_[i - 1] >= 0) {
+      close(fds_[i - 1]);
+    }
+  }
+}
+
+bool PerfCounters::read(PerfCounterValues* values) const {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    values->values[i] = -1;
+  }
+  if (num_available_ == 0) {
+    return false;
+  }
+  // With PERF_FORMAT_GROUP, reading the leader returns the number of counters
+  // followed by their values, in the order in which they were opened.
+  uint64_t buffer[1 + kNumPerfCounters];
+  const size_t expected_size = (1 + num_available_) * sizeof(uint64_t);
+  int group_fd = -1;
+  for (size_t i = 0; i < kNumPerfCounters && group_fd < 0; ++i) {
+    group_fd = fds_[i];
+  }
+  if (::read(group_fd, buffer, sizeof(buffer)) !=
+          static_cast<ssize_t>(expected_size) ||
+      buffer[0] != num_available_) {
+    return false;
+  }
+  size_t next_value = 1;
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    if (fds_[i] >= 0) {
+      values->values[i] = static_cast<int64_t>(buffer[next_value++]);
+    }
+  }
+  return true;
+}
+
+#else // !defined(__linux__)
+
+PerfCounters::PerfCounters() {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    fds_[i] = -1;
+  }
+  ET_LOG(Info, "Hardware performance counters are only supported on Linux");
+}
+
+PerfCounters::~PerfCounters() {}
+
+bool PerfCounters::read(PerfCounterValues* values) const {
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    values->values[i] = -1;
+  }
+  return false;
+}
+
+#endif // defined(__linux__)
+
+} // namespace executor
+} // namespace torch
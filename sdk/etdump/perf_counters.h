@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+
+/// The hardware counters that PerfCounters tries to read.
+enum class PerfCounter : uint8_t {
+  Cycles,
+  Instructions,
+  CacheReferences,
+  CacheMisses,
+  StalledCyclesFrontend,
+  StalledCyclesBackend,
+};
+
+constexpr size_t kNumPerfCounters = 6;
+
+/// Values of the counters, indexed by PerfCounter. -1 if not available.
+struct PerfCounterValues {
+  int64_t values[kNumPerfCounters];
+
+  int64_t& operator[](PerfCounter counter) {
+    return values[static_cast<size_t>(counter)];
+  }
+
+  int64_t operator[](PerfCounter counter) const {
+    return values[static_cast<size_t>(counter)];
+  }
+};
+
+/**
+ * Reads the hardware performance counters of the calling thread through the
+ * Linux perf_event interface, so that ETDumpGen can record how many cycles,
+ * instructions and cache misses each profiled event took.
+ *
+ * The counters are opened as one group when the object is created, and the
+ * ones that the CPU or the kernel does not support (stalled cycles are often
+ * missing, and perf_event_paranoid may forbid all of them) are skipped. On
+ * other platforms no counter is available.
+ *
+ * Only the thread that created the object is counted, so work that an
+ * operator hands to a threadpool is not included. The values of events nested
+ * in each other overlap, like their timestamps do.
+ */
+class PerfCounters final {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  PerfCounters(PerfCounters&&) = delete;
+  PerfCounters& operator=(PerfCounters&&) = delete;
+
+  /// Whether the counter could be opened.
+  bool is_available(PerfCounter counter) const {
+    return fds_[static_cast<size_t>(counter)] >= 0;
+  }
+
+  /// Number of counters that could be opened.
+  size_t num_available() const {
+    return num_available_;
+  }
+
+  /**
+   * Reads the current value of all the counters with a single system call.
+   *
+   * @param[out] values The values of the available counters, -1 for the
+   *     others.
+   * @returns Whether the values could be read; if not they are all -1.
+   */
+  bool read(PerfCounterValues* values) const;
+
+ private:
+  // File descriptor of each counter, -1 if it is not available. The first
+  // available one leads the group.
+  int fds_[kNumPerfCounters];
+  size_t num_available_ = 0;
+};
+
+} // namespace executor
+} // namespace torch
@@ -108,6 +108,24 @@ class PROFILE_EVENT_ENUM(Enum):
     LOAD_MODEL = "Program::load_method"
 
 
+# Counters that could not be read are -1
+@dataclass
+class PerfCounters:
+    cycles: int
+    instructions: int
+    cache_references: int
+    cache_misses: int
+    stalled_cycles_frontend: int
+    stalled_cycles_backend: int
+
+
+@dataclass
+class OpCost:
+    flops: int
+    bytes_read: int
+    bytes_written: int
+
+
 @dataclass
 class ProfileEvent:
     name: Optional[str]
@@ -118,6 +136,8 @@ class ProfileEvent:
     delegate_debug_metadata: Optional[bytes]
     start_time: int
     end_time: int
+    perf_counters: Optional[PerfCounters] = None
+    op_cost: Optional[OpCost] = None
 
 
 @dataclass
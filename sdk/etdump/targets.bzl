@@ -94,10 +94,12 @@ def define_common_targets():
             srcs = [
                 "etdump_flatcc.cpp",
                 "emitter.cpp",
+                "perf_counters.cpp",
             ],
             exported_headers = [
                 "etdump_flatcc.h",
                 "emitter.h",
+                "perf_counters.h",
             ],
             deps = [
                 "//executorch/runtime/platform:platform",
@@ -112,3 +114,44 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
         )
+
+    runtime.cxx_library(
+        name = "op_costs",
+        srcs = [
+            "op_costs.cpp",
+        ],
+        exported_headers = [
+            "op_costs.h",
+        ],
+        deps = [
+            "//executorch/runtime/kernel:operator_registry",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "chrome_trace",
+        srcs = [
+            "chrome_trace.cpp",
+        ],
+        exported_headers = [
+            "chrome_trace.h",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        exported_deps = [
+            ":etdump_flatcc",
+            ":etdump_schema_flatcc",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
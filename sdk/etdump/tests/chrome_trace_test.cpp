@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/etdump/chrome_trace.h>
+#include <executorch/sdk/etdump/etdump_flatcc.h>
+
+using namespace ::testing;
+using torch::executor::Error;
+using torch::executor::ETDumpGen;
+using torch::executor::ETDumpWriter;
+using torch::executor::EventTracerEntry;
+using torch::executor::write_chrome_trace;
+
+namespace {
+
+class StringETDumpWriter : public ETDumpWriter {
+ public:
+  Error write(const void* data, size_t size) override {
+    str.append(static_cast<const char*>(data), size);
+    return Error::Ok;
+  }
+
+  std::string str;
+};
+
+class FailingETDumpWriter : public ETDumpWriter {
+ public:
+  Error write(const void* data, size_t size) override {
+    (void)data;
+    (void)size;
+    return Error::AccessFailed;
+  }
+};
+
+size_t count(const std::string& str, const std::string& pattern) {
+  size_t n = 0;
+  for (size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+} // namespace
+
+class ChromeTraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Logs one execution with an operator and a delegate event in it.
+  static void log_execution(ETDumpGen& gen) {
+    gen.create_event_block("Execute");
+    EventTracerEntry execute = gen.start_profiling("Method::execute");
+    EventTracerEntry op = gen.start_profiling("native_call_add.out", 0, 1);
+    gen.end_profiling(op);
+    gen.set_chain_debug_handle(0, 2);
+    EventTracerEntry delegate_call = gen.start_profiling("DELEGATE_CALL", 0, 2);
+    gen.log_profiling_delegate(nullptr, 7, 10, 20, nullptr, 0);
+    gen.log_profiling_delegate("fused \"conv\"", -1, 20, 30, nullptr, 0);
+    gen.end_profiling(delegate_call);
+    gen.end_profiling(execute);
+  }
+};
+
+TEST_F(ChromeTraceTest, ConvertsProfileEvents) {
+  ETDumpGen gen;
+  log_execution(gen);
+  torch::executor::etdump_result result = gen.get_etdump_data();
+  ASSERT_NE(result.buf, nullptr);
+
+  StringETDumpWriter out;
+  ASSERT_EQ(write_chrome_trace(result.buf, result.size, &out), Error::Ok);
+  free(result.buf);
+  const std::string& json = out.str;
+
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+  EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+  // The block, three runtime events and two delegate events.
+  EXPECT_EQ(count(json, "\"ph\":\"X\""), 6);
+  EXPECT_EQ(count(json, "\"cat\":\"block\",\"name\":\"Execute\""), 1);
+  EXPECT_EQ(count(json, "\"name\":\"native_call_add.out\""), 1);
+  EXPECT_EQ(count(json, "\"tid\":1,\"cat\":\"delegate\""), 2);
+  EXPECT_EQ(count(json, "\"name\":\"7\""), 1);
+  EXPECT_EQ(count(json, "\"delegate_debug_id\":7"), 1);
+  // Names are escaped.
+  EXPECT_EQ(count(json, "\"name\":\"fused \\\"conv\\\"\""), 1);
+  // Delegate timestamps are kept as logged: 10 to 20 ticks of 1ns.
+  EXPECT_EQ(count(json, "\"ts\":0.010,\"dur\":0.010"), 1);
+}
+
+TEST_F(ChromeTraceTest, ConvertsAStreamOfETDumps) {
+  ETDumpGen gen;
+  StringETDumpWriter stream;
+  gen.set_streaming_writers(&stream);
+  for (int i = 0; i < 3; ++i) {
+    log_execution(gen);
+  }
+  gen.get_etdump_data();
+
+  StringETDumpWriter out;
+  ASSERT_EQ(
+      write_chrome_trace(stream.str.data(), stream.str.size(), &out),
+      Error::Ok);
+  EXPECT_EQ(count(out.str, "\"cat\":\"block\""), 3);
+  EXPECT_EQ(count(out.str, "\"name\":\"native_call_add.out\""), 3);
+}
+
+TEST_F(ChromeTraceTest, RejectsInvalidData) {
+  // A size prefix larger than the data.
+  const uint32_t data[4] = {64, 0, 0, 0};
+  StringETDumpWriter out;
+  EXPECT_EQ(
+      write_chrome_trace(data, sizeof(data), &out), Error::InvalidArgument);
+
+  // A buffer without the ETDump identifier.
+  const uint32_t not_etdump[4] = {12, 8, 0, 0};
+  EXPECT_EQ(
+      write_chrome_trace(not_etdump, sizeof(not_etdump), &out),
+      Error::InvalidArgument);
+}
+
+TEST_F(ChromeTraceTest, ReturnsWriterErrors) {
+  FailingETDumpWriter out;
+  EXPECT_EQ(write_chrome_trace(nullptr, 0, &out), Error::AccessFailed);
+}
@@ -19,10 +19,38 @@
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace torch {
 namespace executor {
 
+namespace {
+
+// Keeps each write as a separate chunk, in memory from malloc so that the
+// flatbuffers in it are aligned.
+class VectorETDumpWriter : public ETDumpWriter {
+ public:
+  ~VectorETDumpWriter() override {
+    for (auto& chunk : chunks) {
+      free(chunk.first);
+    }
+  }
+
+  Error write(const void* data, size_t size) override {
+    void* chunk = malloc(size);
+    memcpy(chunk, data, size);
+    chunks.emplace_back(chunk, size);
+    total_size += size;
+    return Error::Ok;
+  }
+
+  std::vector<std::pair<void*, size_t>> chunks;
+  size_t total_size = 0;
+};
+
+} // namespace
+
 class ProfilerETDumpTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -713,5 +741,155 @@ TEST_F(ProfilerETDumpTest, WriteAfterGetETDumpData) {
   }
 }
 
+TEST_F(ProfilerETDumpTest, RecordsPerfCounters) {
+  PerfCounters perf_counters;
+  for (size_t i = 0; i < 2; i++) {
+    etdump_gen[i]->set_perf_counters(&perf_counters);
+    etdump_gen[i]->create_event_block("test_block");
+    EventTracerEntry outer = etdump_gen[i]->start_profiling("outer", 0, 1);
+    EventTracerEntry inner = etdump_gen[i]->start_profiling("inner", 0, 1);
+    etdump_gen[i]->end_profiling(inner);
+    etdump_gen[i]->end_profiling(outer);
+
+    etdump_result result = etdump_gen[i]->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    etdump_Event_vec_t events =
+        etdump_RunData_events(etdump_RunData_vec_at(run_data_vec, 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+
+    for (size_t j = 0; j < 2; j++) {
+      etdump_ProfileEvent_table_t event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, j));
+      // Counters are only recorded where the kernel and the CPU expose them.
+      if (perf_counters.num_available() == 0) {
+        EXPECT_FALSE(etdump_ProfileEvent_perf_counters_is_present(event));
+        continue;
+      }
+      ASSERT_TRUE(etdump_ProfileEvent_perf_counters_is_present(event));
+      etdump_PerfCounters_table_t counters =
+          etdump_ProfileEvent_perf_counters(event);
+      EXPECT_EQ(
+          etdump_PerfCounters_cycles(counters) >= 0,
+          perf_counters.is_available(PerfCounter::Cycles));
+      EXPECT_EQ(
+          etdump_PerfCounters_instructions(counters) >= 0,
+          perf_counters.is_available(PerfCounter::Instructions));
+    }
+
+    if (!etdump_gen[i]->is_static_etdump()) {
+      free(result.buf);
+    }
+    etdump_gen[i]->set_perf_counters(nullptr);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, RecordsOpCost) {
+  for (size_t i = 0; i < 2; i++) {
+    etdump_gen[i]->create_event_block("test_block");
+    EventTracerEntry outer = etdump_gen[i]->start_profiling("outer", 0, 1);
+    EventTracerEntry inner = etdump_gen[i]->start_profiling("inner", 0, 1);
+    etdump_gen[i]->end_profiling(inner);
+    // The cost goes with the next event that ends, and only that one.
+    etdump_gen[i]->set_op_cost(100, 20, 10);
+    etdump_gen[i]->end_profiling(outer);
+    EventTracerEntry next = etdump_gen[i]->start_profiling("next", 0, 2);
+    etdump_gen[i]->end_profiling(next);
+
+    etdump_result result = etdump_gen[i]->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    etdump_Event_vec_t events =
+        etdump_RunData_events(etdump_RunData_vec_at(run_data_vec, 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 3);
+
+    EXPECT_FALSE(etdump_ProfileEvent_op_cost_is_present(
+        etdump_Event_profile_event(etdump_Event_vec_at(events, 0))));
+    etdump_ProfileEvent_table_t outer_event =
+        etdump_Event_profile_event(etdump_Event_vec_at(events, 1));
+    ASSERT_TRUE(etdump_ProfileEvent_op_cost_is_present(outer_event));
+    etdump_OpCost_table_t op_cost = etdump_ProfileEvent_op_cost(outer_event);
+    EXPECT_EQ(etdump_OpCost_flops(op_cost), 100);
+    EXPECT_EQ(etdump_OpCost_bytes_read(op_cost), 20);
+    EXPECT_EQ(etdump_OpCost_bytes_written(op_cost), 10);
+    EXPECT_FALSE(etdump_ProfileEvent_op_cost_is_present(
+        etdump_Event_profile_event(etdump_Event_vec_at(events, 2))));
+
+    if (!etdump_gen[i]->is_static_etdump()) {
+      free(result.buf);
+    }
+  }
+}
+
+TEST_F(ProfilerETDumpTest, StreamingWritesEachBlock) {
+  ETDumpGen* gen = etdump_gen[0];
+  VectorETDumpWriter etdump_writer;
+  VectorETDumpWriter debug_writer;
+  gen->set_streaming_writers(&etdump_writer, &debug_writer);
+
+  testing::TensorFactory<ScalarType::Float> tf;
+  EValue evalue(tf.ones({3, 2}));
+  const char* block_names[3] = {"block_0", "block_1", "block_2"};
+  for (size_t i = 0; i < 3; i++) {
+    gen->create_event_block(block_names[i]);
+    // The previous blocks have been written out.
+    EXPECT_EQ(etdump_writer.chunks.size(), i);
+    EXPECT_EQ(gen->get_num_blocks(), 1);
+    EventTracerEntry entry = gen->start_profiling("test_event", 0, 1);
+    gen->end_profiling(entry);
+    gen->log_evalue(evalue);
+  }
+  etdump_result result = gen->get_etdump_data();
+  EXPECT_EQ(result.buf, nullptr);
+  EXPECT_EQ(result.size, 0);
+  ASSERT_EQ(etdump_writer.chunks.size(), 3);
+
+  for (size_t i = 0; i < 3; i++) {
+    size_t size = 0;
+    void* buf =
+        flatbuffers_read_size_prefix(etdump_writer.chunks[i].first, &size);
+    EXPECT_EQ(
+        size + sizeof(flatbuffers_uoffset_t), etdump_writer.chunks[i].second);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 1);
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, 0);
+    EXPECT_EQ(
+        std::string(etdump_RunData_name(run_data)), block_names[i]);
+
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+    etdump_Value_table_t value = etdump_DebugEvent_debug_entry(
+        etdump_Event_debug_event(etdump_Event_vec_at(events, 1)));
+    ASSERT_EQ(etdump_Value_tensor_is_present(value), true);
+    // Tensors are 64-byte aligned in the debug stream.
+    EXPECT_EQ(etdump_Tensor_offset(etdump_Value_tensor(value)), i * 64);
+  }
+
+  // Two paddings and three tensors of 6 floats.
+  EXPECT_EQ(debug_writer.total_size, 2 * 64 + 6 * sizeof(float));
+  ASSERT_EQ(debug_writer.chunks.size(), 5);
+  const float* data = (const float*)debug_writer.chunks[4].first;
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_EQ(data[i], 1.0f);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, StreamingNeedsDynamicMemory) {
+  VectorETDumpWriter etdump_writer;
+  ET_EXPECT_DEATH(etdump_gen[1]->set_streaming_writers(&etdump_writer), "");
+}
+
 } // namespace executor
 } // namespace torch
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/etdump/op_costs.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::get_op_cost_function;
+using executorch::runtime::OpCost;
+using executorch::runtime::OpCostFunction;
+using torch::executor::Error;
+using torch::executor::EValue;
+using torch::executor::register_default_op_costs;
+using torch::executor::testing::TensorFactory;
+
+class OpCostsTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    torch::executor::runtime_init();
+    ASSERT_EQ(register_default_op_costs(), Error::Ok);
+  }
+
+  static OpCost cost_of(const char* name, EValue* values, size_t num_values) {
+    EValue* stack[16];
+    for (size_t i = 0; i < num_values; ++i) {
+      stack[i] = &values[i];
+    }
+    OpCostFunction cost_fn = get_op_cost_function(name);
+    EXPECT_NE(cost_fn, nullptr);
+    return cost_fn != nullptr ? cost_fn(stack, num_values) : OpCost();
+  }
+
+  TensorFactory<ScalarType::Float> tf;
+};
+
+TEST_F(OpCostsTest, RegisteringTwiceFails) {
+  EXPECT_EQ(register_default_op_costs(), Error::InvalidArgument);
+}
+
+TEST_F(OpCostsTest, Mm) {
+  // [2, 3] x [3, 4]
+  EValue values[] = {
+      EValue(tf.zeros({2, 3})),
+      EValue(tf.zeros({3, 4})),
+      EValue(tf.zeros({2, 4}))};
+  OpCost cost = cost_of("aten::mm.out", values, 3);
+  EXPECT_EQ(cost.flops, 2 * 2 * 3 * 4);
+  EXPECT_EQ(cost.bytes_read, (6 + 12) * sizeof(float));
+  EXPECT_EQ(cost.bytes_written, 8 * sizeof(float));
+}
+
+TEST_F(OpCostsTest, Bmm) {
+  // 5 x [2, 3] x [3, 4]
+  EValue values[] = {
+      EValue(tf.zeros({5, 2, 3})),
+      EValue(tf.zeros({5, 3, 4})),
+      EValue(tf.zeros({5, 2, 4}))};
+  EXPECT_EQ(cost_of("aten::bmm.out", values, 3).flops, 2 * 5 * 2 * 3 * 4);
+}
+
+TEST_F(OpCostsTest, Convolution) {
+  // A 3x3 convolution of 2 input channels into 4 output channels, over a 5x5
+  // output. The stride, padding, dilation and output padding do not change
+  // the cost given the shapes, so they are left out.
+  EValue values[] = {
+      EValue(tf.zeros({1, 2, 5, 5})),
+      EValue(tf.zeros({4, 2, 3, 3})),
+      EValue(tf.zeros({4})),
+      EValue(),
+      EValue(),
+      EValue(),
+      EValue(false),
+      EValue(),
+      EValue(static_cast<int64_t>(1)),
+      EValue(tf.zeros({1, 4, 5, 5}))};
+  OpCost cost = cost_of("aten::convolution.out", values, 10);
+  // Two FLOPs per weight of an output channel per output element, plus the
+  // bias.
+  EXPECT_EQ(cost.flops, 2 * 100 * 18 + 100);
+  EXPECT_EQ(cost.bytes_read, (50 + 72 + 4) * sizeof(float));
+  EXPECT_EQ(cost.bytes_written, 100 * sizeof(float));
+}
+
+TEST_F(OpCostsTest, Add) {
+  EValue values[] = {
+      EValue(tf.zeros({2, 3})),
+      EValue(tf.zeros({1, 3})),
+      EValue(exec_aten::Scalar(1)),
+      EValue(tf.zeros({2, 3}))};
+  OpCost cost = cost_of("aten::add.out", values, 4);
+  EXPECT_EQ(cost.flops, 6);
+  EXPECT_EQ(cost.bytes_read, (6 + 3) * sizeof(float));
+  EXPECT_EQ(cost.bytes_written, 6 * sizeof(float));
+}
+
+TEST_F(OpCostsTest, Clone) {
+  EValue values[] = {
+      EValue(tf.zeros({2, 3})), EValue(), EValue(tf.zeros({2, 3}))};
+  OpCost cost = cost_of("aten::clone.out", values, 3);
+  EXPECT_EQ(cost.flops, 0);
+  EXPECT_EQ(cost.bytes_read, 6 * sizeof(float));
+  EXPECT_EQ(cost.bytes_written, 6 * sizeof(float));
+}
+
+TEST_F(OpCostsTest, UnknownOp) {
+  EXPECT_EQ(get_op_cost_function("aten::unknown.out"), nullptr);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/etdump/perf_counters.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+const PerfCounter kAllCounters[] = {
+    PerfCounter::Cycles,
+    PerfCounter::Instructions,
+    PerfCounter::CacheReferences,
+    PerfCounter::CacheMisses,
+    PerfCounter::StalledCyclesFrontend,
+    PerfCounter::StalledCyclesBackend,
+};
+
+// Does some work that the compiler cannot remove.
+uint64_t busy_loop(uint64_t n) {
+  volatile uint64_t sum = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    sum = sum + i * i;
+  }
+  return sum;
+}
+
+} // namespace
+
+class PerfCountersTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(PerfCountersTest, OnlyAvailableCountersHaveValues) {
+  PerfCounters perf_counters;
+  size_t num_available = 0;
+  for (PerfCounter counter : kAllCounters) {
+    num_available += perf_counters.is_available(counter) ? 1 : 0;
+  }
+  EXPECT_EQ(perf_counters.num_available(), num_available);
+
+  PerfCounterValues values;
+  const bool ok = perf_counters.read(&values);
+  // No counter is available where the CPU, the kernel or perf_event_paranoid
+  // does not allow them, and then nothing can be read.
+  EXPECT_EQ(ok, num_available > 0);
+  for (PerfCounter counter : kAllCounters) {
+    if (ok && perf_counters.is_available(counter)) {
+      EXPECT_GE(values[counter], 0);
+    } else {
+      EXPECT_EQ(values[counter], -1);
+    }
+  }
+}
+
+TEST_F(PerfCountersTest, CountersAdvanceWithWork) {
+  PerfCounters perf_counters;
+  if (!perf_counters.is_available(PerfCounter::Instructions)) {
+    GTEST_SKIP() << "The instruction counter is not available here";
+  }
+
+  PerfCounterValues before;
+  PerfCounterValues after;
+  ASSERT_TRUE(perf_counters.read(&before));
+  busy_loop(1000 * 1000);
+  ASSERT_TRUE(perf_counters.read(&after));
+
+  // A million iterations take at least a million instructions.
+  EXPECT_GE(
+      after[PerfCounter::Instructions] - before[PerfCounter::Instructions],
+      1000 * 1000);
+  for (PerfCounter counter : kAllCounters) {
+    if (perf_counters.is_available(counter)) {
+      EXPECT_GE(after[counter], before[counter]);
+    }
+  }
+}
+
+TEST_F(PerfCountersTest, SeveralInstancesCountIndependently) {
+  PerfCounters first;
+  PerfCounters second;
+  EXPECT_EQ(first.num_available(), second.num_available());
+
+  PerfCounterValues values;
+  EXPECT_EQ(second.read(&values), second.num_available() > 0);
+}
+
+} // namespace executor
+} // namespace torch
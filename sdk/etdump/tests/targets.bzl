@@ -19,3 +19,39 @@ def define_common_targets():
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
         ],
     )
+
+    runtime.cxx_test(
+        name = "chrome_trace_test",
+        srcs = [
+            "chrome_trace_test.cpp",
+        ],
+        deps = [
+            "//executorch/sdk/etdump:chrome_trace",
+            "//executorch/sdk/etdump:etdump_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_costs_test",
+        srcs = [
+            "op_costs_test.cpp",
+        ],
+        deps = [
+            "//executorch/sdk/etdump:op_costs",
+            "//executorch/runtime/kernel:operator_registry",
+            "//executorch/runtime/platform:platform",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "perf_counters_test",
+        srcs = [
+            "perf_counters_test.cpp",
+        ],
+        deps = [
+            "//executorch/sdk/etdump:etdump_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
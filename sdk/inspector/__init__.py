@@ -4,7 +4,22 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from executorch.sdk.inspector._inspector import Event, EventBlock, Inspector, PerfData
+from executorch.sdk.inspector._inspector import (
+    Event,
+    EventBlock,
+    Inspector,
+    OpCostData,
+    PerfCounterData,
+    PerfData,
+)
 from executorch.sdk.inspector._inspector_utils import TimeScale
 
-__all__ = ["Event", "EventBlock", "Inspector", "PerfData", "TimeScale"]
+__all__ = [
+    "Event",
+    "EventBlock",
+    "Inspector",
+    "OpCostData",
+    "PerfCounterData",
+    "PerfData",
+    "TimeScale",
+]
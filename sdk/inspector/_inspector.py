@@ -210,6 +210,23 @@ class EventSignature:
                 )
             ]
 
+        # The runtime records the cost of an operator call with its
+        # OPERATOR_CALL event. Share it with the other events of the
+        # instruction, such as the one named after the kernel.
+        op_cost = next(
+            (event.op_cost for event in profile_events if event.op_cost is not None),
+            None,
+        )
+        if op_cost is not None:
+            profile_events = [
+                (
+                    dataclasses.replace(event, op_cost=op_cost)
+                    if event.op_cost is None
+                    else event
+                )
+                for event in profile_events
+            ]
+
         # Generate the ProfileEventSignature
         return [
             (
@@ -283,6 +300,84 @@ class PerfData:
         return max(self.raw)
 
 
+@dataclass
+class PerfCounterData:
+    """
+    Hardware performance counters of an Event, summed over all of its runs.
+    A counter is None if it was not read on every run.
+    """
+
+    cycles: Optional[int] = None
+    instructions: Optional[int] = None
+    cache_references: Optional[int] = None
+    cache_misses: Optional[int] = None
+    stalled_cycles_frontend: Optional[int] = None
+    stalled_cycles_backend: Optional[int] = None
+
+    @staticmethod
+    def _gen_from_perf_counters(
+        perf_counters: List[flatcc.PerfCounters],
+    ) -> "PerfCounterData":
+        def total(name: str) -> Optional[int]:
+            values = [getattr(counters, name) for counters in perf_counters]
+            return sum(values) if all(value >= 0 for value in values) else None
+
+        return PerfCounterData(
+            **{
+                field.name: total(field.name)
+                for field in dataclasses.fields(PerfCounterData)
+            }
+        )
+
+    @property
+    def ipc(self) -> Optional[float]:
+        """Instructions per cycle"""
+        if self.instructions is None or not self.cycles:
+            return None
+        return self.instructions / self.cycles
+
+    @property
+    def cache_miss_rate(self) -> Optional[float]:
+        """Fraction of the cache references that missed"""
+        if self.cache_misses is None or not self.cache_references:
+            return None
+        return self.cache_misses / self.cache_references
+
+
+@dataclass
+class OpCostData:
+    """
+    Work done by an Event in one run, averaged over its runs, as computed by
+    the op cost functions registered in the runtime (see register_op_costs()
+    in runtime/kernel/operator_registry.h).
+    """
+
+    flops: float
+    bytes_read: float
+    bytes_written: float
+
+    @staticmethod
+    def _gen_from_op_costs(op_costs: List[flatcc.OpCost]) -> "OpCostData":
+        return OpCostData(
+            flops=sum(cost.flops for cost in op_costs) / len(op_costs),
+            bytes_read=sum(cost.bytes_read for cost in op_costs) / len(op_costs),
+            bytes_written=sum(cost.bytes_written for cost in op_costs)
+            / len(op_costs),
+        )
+
+    @property
+    def bytes(self) -> float:
+        """Bytes read and written"""
+        return self.bytes_read + self.bytes_written
+
+    @property
+    def arithmetic_intensity(self) -> Optional[float]:
+        """FLOPs per byte moved"""
+        if not self.bytes:
+            return None
+        return self.flops / self.bytes
+
+
 @dataclass
 class Event:
     """
@@ -304,6 +399,8 @@ class Event:
             Available as Event.raw_delegate_debug_metadatas
 
         debug_data: A list containing intermediate data collected.
+        perf_counter_data: Hardware performance counters of the event, if the runtime recorded them (see PerfCounterData).
+        op_cost_data: FLOPs and bytes moved by the event, if the runtime has a cost function for its operator (see OpCostData).
 
         _instruction_id: Instruction Identifier for Symbolication
         _delegate_metadata_parser: Optional Parser for _delegate_debug_metadatas
@@ -321,6 +418,8 @@ class Event:
     _delegate_debug_metadatas: List[str] = dataclasses.field(default_factory=list)
 
     debug_data: ProgramOutput = dataclasses.field(default_factory=list)
+    perf_counter_data: Optional[PerfCounterData] = None
+    op_cost_data: Optional[OpCostData] = None
     _instruction_id: Optional[int] = None
 
     _delegate_metadata_parser: Optional[Callable[[List[str]], Dict[str, Any]]] = None
@@ -373,7 +472,7 @@ class Event:
         def truncated_list(long_list: List[str]) -> str:
             return f"['{long_list[0]}', '{long_list[1]}' ... '{long_list[-1]}'] ({len(long_list)} total)"
 
-        return {
+        event_dict = {
             "event_name": self.name,
             "raw": [self.perf_data.raw if self.perf_data else None],
             "p10" + _units: self.perf_data.p10 if self.perf_data else None,
@@ -396,6 +495,18 @@ class Event:
             "delegate_backend_name": self.delegate_backend_name,
             "debug_data": [self.debug_data],
         }
+        # Only add the counter columns when the runtime recorded them
+        if self.perf_counter_data is not None:
+            event_dict["ipc"] = self.perf_counter_data.ipc
+            event_dict["cache_miss_rate"] = self.perf_counter_data.cache_miss_rate
+        # Only add the op cost columns when the runtime recorded them
+        if self.op_cost_data is not None:
+            event_dict["flops"] = self.op_cost_data.flops
+            event_dict["bytes"] = self.op_cost_data.bytes
+            event_dict["arithmetic_intensity"] = (
+                self.op_cost_data.arithmetic_intensity
+            )
+        return event_dict
 
     @staticmethod
     def _gen_from_inference_events(
@@ -480,6 +591,8 @@ class Event:
             is_delegated_op
             perf_data
             delegate_debug_metadatas
+            perf_counter_data
+            op_cost_data
         """
 
         # Fill out fields from profile event signature
@@ -507,6 +620,8 @@ class Event:
         # Fill out fields from profile event
         data = []
         delegate_debug_metadatas = []
+        perf_counters = []
+        op_costs = []
         for event in events:
             if (profile_events := event.profile_events) is not None:
                 if len(profile_events) != 1:
@@ -552,10 +667,21 @@ class Event:
                     if profile_event.delegate_debug_metadata
                     else ""
                 )
+                if profile_event.perf_counters is not None:
+                    perf_counters.append(profile_event.perf_counters)
+                if profile_event.op_cost is not None:
+                    op_costs.append(profile_event.op_cost)
 
         # Update fields
         if len(data) > 0:
             ret_event.perf_data = PerfData(data)
+        # Counters are only meaningful if every run recorded them
+        if len(perf_counters) > 0 and len(perf_counters) == len(data):
+            ret_event.perf_counter_data = PerfCounterData._gen_from_perf_counters(
+                perf_counters
+            )
+        if len(op_costs) > 0:
+            ret_event.op_cost_data = OpCostData._gen_from_op_costs(op_costs)
         if any(delegate_debug_metadatas):
             ret_event._delegate_debug_metadatas = delegate_debug_metadatas
 
@@ -652,7 +778,10 @@ class EventBlock:
     reference_output: Optional[ProgramOutput] = None
 
     def to_dataframe(
-        self, include_units: bool = False, include_delegate_debug_data: bool = False
+        self,
+        include_units: bool = False,
+        include_delegate_debug_data: bool = False,
+        ridge_point: Optional[float] = None,
     ) -> pd.DataFrame:
         """
         Converts the EventBlock into a DataFrame with each row being an event instance
@@ -663,6 +792,10 @@ class EventBlock:
         Args:
             include_units: Whether headers should include units (default false)
             include_delegate_debug_data: Whether to show the delegate debug data
+            ridge_point: Peak FLOP/s divided by peak bytes/s of the device the
+                ETDump comes from. If given, events with an op cost are labeled
+                "compute" or "memory" bound, depending on which side of it
+                their arithmetic intensity is.
 
         Returns:
             A pandas DataFrame containing the data of each Event instance in this EventBlock.
@@ -701,8 +834,53 @@ class EventBlock:
             if any(not data.empty for data in delegate_data):
                 df = pd.concat([df, pd.DataFrame(delegate_data)], axis=1)
 
+        # Add the achieved throughput of the events with an op cost
+        if any(event.op_cost_data is not None for event in self.events):
+            df = pd.concat(
+                [df, pd.DataFrame(self._gen_roofline_data(ridge_point))], axis=1
+            )
+
         return df
 
+    def _gen_roofline_data(self, ridge_point: Optional[float]) -> Dict[str, List]:
+        """
+        Returns the achieved GFLOP/s and GB/s of each event, and whether it is
+        compute or memory bound if a ridge point is given. Values are None for
+        events without an op cost or perf data, and throughputs also when the
+        events are timed in cycles.
+        """
+        seconds_per_unit = (
+            1 / TIME_SCALE_DICT[self.target_time_scale]
+            if self.target_time_scale != TimeScale.CYCLES
+            else None
+        )
+        data: Dict[str, List] = {"gflops_per_s": [], "gbytes_per_s": []}
+        if ridge_point is not None:
+            data["bound"] = []
+        for event in self.events:
+            op_cost = event.op_cost_data
+            seconds = (
+                event.perf_data.avg * seconds_per_unit
+                if op_cost is not None
+                and event.perf_data is not None
+                and seconds_per_unit is not None
+                else None
+            )
+            data["gflops_per_s"].append(
+                op_cost.flops / seconds / 1e9 if seconds else None
+            )
+            data["gbytes_per_s"].append(
+                op_cost.bytes / seconds / 1e9 if seconds else None
+            )
+            if ridge_point is not None:
+                intensity = op_cost.arithmetic_intensity if op_cost else None
+                data["bound"].append(
+                    None
+                    if intensity is None
+                    else "compute" if intensity >= ridge_point else "memory"
+                )
+        return data
+
     @staticmethod
     def _gen_from_etdump(
         etdump: ETDumpFlatCC,
@@ -1078,11 +1256,13 @@ class Inspector:
         self,
         include_units: bool = True,
         include_delegate_debug_data: bool = False,
+        ridge_point: Optional[float] = None,
     ) -> pd.DataFrame:
         """
         Args:
             include_units: Whether headers should include units (default true)
             include_delegate_debug_data: Whether to include delegate debug metadata (default false)
+            ridge_point: Peak FLOP/s divided by peak bytes/s of the device, to label the events with an op cost as compute or memory bound (default None)
 
         Returns:
             Returns a pandas DataFrame of the Events in each EventBlock in the inspector, with each row representing an Event.
@@ -1092,6 +1272,7 @@ class Inspector:
             event_block.to_dataframe(
                 include_units=include_units,
                 include_delegate_debug_data=include_delegate_debug_data,
+                ridge_point=ridge_point,
             )
             for event_block in self.event_blocks
         ]
@@ -1102,6 +1283,7 @@ class Inspector:
         file: IO[str] = sys.stdout,
         include_units: bool = True,
         include_delegate_debug_data: bool = False,
+        ridge_point: Optional[float] = None,
     ) -> None:
         """
         Displays the underlying EventBlocks in a structured tabular format, with each row representing an Event.
@@ -1111,11 +1293,14 @@ class Inspector:
                 Not used if this is in an IPython environment such as a Jupyter notebook.
             include_units: Whether headers should include units (default true)
             include_delegate_debug_data: Whether to include delegate debug metadata (default false)
+            ridge_point: Peak FLOP/s divided by peak bytes/s of the device, to label the events with an op cost as compute or memory bound (default None)
 
         Returns:
             None
         """
-        combined_df = self.to_dataframe(include_units, include_delegate_debug_data)
+        combined_df = self.to_dataframe(
+            include_units, include_delegate_debug_data, ridge_point
+        )
 
         # Filter out some columns and rows for better readability when printing
         filtered_column_df = combined_df.drop(columns=EXCLUDED_COLUMNS_WHEN_PRINTING)
@@ -23,6 +23,7 @@ from executorch.sdk.etrecord.tests.etrecord_test import TestETRecord
 from executorch.sdk.inspector import _inspector, Event, EventBlock, Inspector, PerfData
 from executorch.sdk.inspector._inspector import (
     DebugEventSignature,
+    EventSignature,
     flatcc,
     InstructionEvent,
     InstructionEventSignature,
@@ -234,6 +235,102 @@ class TestInspector(unittest.TestCase):
         # Value of the perf data after scaling is done. 200/10 - 100/10.
         self.assertEqual(event.perf_data.raw[0], 10)
 
+    def test_inspector_perf_counters(self):
+        def profile_event(cycles, instructions, cache_misses):
+            return ProfileEvent(
+                name="test_event",
+                chain_index=0,
+                instruction_id=0,
+                delegate_debug_id_int=None,
+                delegate_debug_id_str=None,
+                start_time=100,
+                end_time=200,
+                delegate_debug_metadata=None,
+                perf_counters=flatcc.PerfCounters(
+                    cycles=cycles,
+                    instructions=instructions,
+                    cache_references=100,
+                    cache_misses=cache_misses,
+                    stalled_cycles_frontend=-1,
+                    stalled_cycles_backend=-1,
+                ),
+            )
+
+        event = Event(name="")
+        event_signature = ProfileEventSignature(name="test_event", instruction_id=0)
+        instruction_events = [
+            InstructionEvent(
+                signature=InstructionEventSignature(0, 0),
+                profile_events=[profile_event(1000, 1500, 10)],
+            ),
+            InstructionEvent(
+                signature=InstructionEventSignature(0, 0),
+                profile_events=[profile_event(3000, 2500, 30)],
+            ),
+        ]
+        Event._populate_profiling_related_fields(
+            event, event_signature, instruction_events, 1
+        )
+
+        # Counters are summed over the runs
+        self.assertEqual(event.perf_counter_data.cycles, 4000)
+        self.assertEqual(event.perf_counter_data.instructions, 4000)
+        self.assertEqual(event.perf_counter_data.cache_misses, 40)
+        self.assertIsNone(event.perf_counter_data.stalled_cycles_frontend)
+        self.assertEqual(event.perf_counter_data.ipc, 1.0)
+        self.assertEqual(event.perf_counter_data.cache_miss_rate, 0.2)
+        self.assertEqual(event.asdict()["ipc"], 1.0)
+
+    def test_inspector_op_cost(self):
+        def profile_event(name, op_cost=None):
+            return ProfileEvent(
+                name=name,
+                chain_index=0,
+                instruction_id=0,
+                delegate_debug_id_int=None,
+                delegate_debug_id_str=None,
+                start_time=0,
+                end_time=2000000,
+                delegate_debug_metadata=None,
+                op_cost=op_cost,
+            )
+
+        # The runtime records the cost with OPERATOR_CALL only
+        instruction_event = InstructionEvent(
+            signature=InstructionEventSignature(0, 0),
+            profile_events=[
+                profile_event("native_call_mm.out"),
+                profile_event(
+                    "OPERATOR_CALL",
+                    flatcc.OpCost(
+                        flops=2000000, bytes_read=800000, bytes_written=200000
+                    ),
+                ),
+            ],
+        )
+        signatures = EventSignature.gen_from_instruction_event(instruction_event)
+        self.assertEqual(len(signatures), 2)
+        event_signature, kernel_event = signatures[0]
+        self.assertEqual(
+            event_signature.profile_event_signature.name, "native_call_mm.out"
+        )
+
+        event = Event(name="")
+        Event._populate_profiling_related_fields(
+            event, event_signature.profile_event_signature, [kernel_event], 1000000
+        )
+        self.assertEqual(event.op_cost_data.flops, 2000000)
+        self.assertEqual(event.op_cost_data.bytes, 1000000)
+        self.assertEqual(event.op_cost_data.arithmetic_intensity, 2.0)
+        self.assertEqual(event.asdict()["arithmetic_intensity"], 2.0)
+
+        # 2 ms per run
+        event_block = EventBlock(name=EVENT_BLOCK_NAME, events=[event])
+        roofline_data = event_block._gen_roofline_data(ridge_point=10.0)
+        self.assertAlmostEqual(roofline_data["gflops_per_s"][0], 1.0)
+        self.assertAlmostEqual(roofline_data["gbytes_per_s"][0], 0.5)
+        self.assertEqual(roofline_data["bound"], ["memory"])
+
     def test_inspector_get_exported_program(self):
         # Create a context manager to patch functions called by Inspector.__init__
         with patch.object(
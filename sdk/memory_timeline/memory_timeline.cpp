@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/sdk/memory_timeline/memory_timeline.h>
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/schema/program_generated.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+constexpr size_t kNotUsed = std::numeric_limits<size_t>::max();
+
+// Calls fn with the index of every tensor that a value refers to.
+template <typename Fn>
+void for_each_tensor_index(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    int32_t value_index,
+    Fn fn) {
+  if (value_index < 0 ||
+      static_cast<uint32_t>(value_index) >= plan->values()->size()) {
+    return;
+  }
+  const auto s_value = plan->values()->Get(value_index);
+  const flatbuffers::Vector<int32_t>* items = nullptr;
+  switch (s_value->val_type()) {
+    case executorch_flatbuffer::KernelTypes::Tensor:
+      fn(static_cast<size_t>(value_index));
+      return;
+    case executorch_flatbuffer::KernelTypes::TensorList:
+      items = s_value->val_as_TensorList()->items();
+      break;
+    case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+      items = s_value->val_as_OptionalTensorList()->items();
+      break;
+    default:
+      return;
+  }
+  if (items == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < items->size(); ++i) {
+    // Optional tensor lists use -1 for None entries.
+    if (items->Get(i) >= 0 &&
+        static_cast<uint32_t>(items->Get(i)) < plan->values()->size()) {
+      fn(static_cast<size_t>(items->Get(i)));
+    }
+  }
+}
+
+// Calls fn with every value that an instruction references.
+template <typename Fn>
+void for_each_instruction_value(
+    const executorch_flatbuffer::Instruction* instruction,
+    Fn fn) {
+  if (instruction == nullptr || instruction->instr_args() == nullptr) {
+    return;
+  }
+  const flatbuffers::Vector<int32_t>* args = nullptr;
+  switch (instruction->instr_args_type()) {
+    case executorch_flatbuffer::InstructionArguments::KernelCall:
+      args = instruction->instr_args_as_KernelCall()->args();
+      break;
+    case executorch_flatbuffer::InstructionArguments::DelegateCall:
+      args = instruction->instr_args_as_DelegateCall()->args();
+      break;
+    case executorch_flatbuffer::InstructionArguments::MoveCall:
+      fn(instruction->instr_args_as_MoveCall()->move_from());
+      fn(instruction->instr_args_as_MoveCall()->move_to());
+      return;
+    case executorch_flatbuffer::InstructionArguments::JumpFalseCall:
+      fn(instruction->instr_args_as_JumpFalseCall()->cond_value_index());
+      return;
+    case executorch_flatbuffer::InstructionArguments::FreeCall:
+      fn(instruction->instr_args_as_FreeCall()->value_index());
+      return;
+    default:
+      return;
+  }
+  if (args == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < args->size(); ++i) {
+    fn(args->Get(i));
+  }
+}
+
+ET_PRINTFLIKE(2, 3)
+void append_format(std::string& str, const char* format, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  str += buf;
+}
+
+} // namespace
+
+Result<MemoryTimeline> MemoryTimeline::load(
+    const void* program_data,
+    size_t program_size,
+    const char* method_name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      executorch_flatbuffer::ProgramBufferHasIdentifier(program_data),
+      InvalidProgram,
+      "Not a program");
+  flatbuffers::Verifier verifier(
+      static_cast<const uint8_t*>(program_data), program_size);
+  ET_CHECK_OR_RETURN_ERROR(
+      executorch_flatbuffer::VerifyProgramBuffer(verifier),
+      InvalidProgram,
+      "Verification failed; data may be truncated or corrupt");
+
+  const auto program = executorch_flatbuffer::GetProgram(program_data);
+  const executorch_flatbuffer::ExecutionPlan* plan = nullptr;
+  if (program->execution_plan() != nullptr) {
+    for (size_t i = 0; i < program->execution_plan()->size(); ++i) {
+      const auto candidate = program->execution_plan()->Get(i);
+      if (candidate->name() != nullptr &&
+          strcmp(candidate->name()->c_str(), method_name) == 0) {
+        plan = candidate;
+        break;
+      }
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      plan != nullptr, InvalidArgument, "No method named '%s'", method_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      plan->values() != nullptr, InvalidProgram, "Missing values");
+
+  MemoryTimeline timeline;
+  timeline.method_name_ = method_name;
+  // Buffer 0 of the program is reserved, see MethodMeta.
+  const auto buffer_sizes = plan->non_const_buffer_sizes();
+  timeline.num_buffers_ =
+      buffer_sizes != nullptr && buffer_sizes->size() > 0
+      ? buffer_sizes->size() - 1
+      : 0;
+
+  // First and last instruction that reference each value.
+  const size_t n_values = plan->values()->size();
+  std::vector<size_t> first_use(n_values, kNotUsed);
+  std::vector<size_t> last_use(n_values, 0);
+  auto use = [&](size_t value_index, size_t instruction) {
+    if (first_use[value_index] == kNotUsed) {
+      first_use[value_index] = instruction;
+    }
+    last_use[value_index] = instruction;
+  };
+  size_t instruction = 0;
+  if (plan->chains() != nullptr) {
+    for (size_t c = 0; c < plan->chains()->size(); ++c) {
+      const auto instructions = plan->chains()->Get(c)->instructions();
+      const size_t chain_size =
+          instructions != nullptr ? instructions->size() : 0;
+      timeline.chain_sizes_.push_back(chain_size);
+      for (size_t i = 0; i < chain_size; ++i, ++instruction) {
+        for_each_instruction_value(
+            instructions->Get(i), [&](int32_t value_index) {
+              for_each_tensor_index(plan, value_index, [&](size_t tensor) {
+                use(tensor, instruction);
+              });
+            });
+      }
+    }
+  }
+  timeline.num_instructions_ = instruction;
+  if (timeline.num_instructions_ > 0) {
+    // The caller owns the inputs and outputs before and after execution.
+    if (plan->inputs() != nullptr) {
+      for (size_t i = 0; i < plan->inputs()->size(); ++i) {
+        for_each_tensor_index(plan, plan->inputs()->Get(i), [&](size_t t) {
+          if (first_use[t] == kNotUsed) {
+            last_use[t] = 0;
+          }
+          first_use[t] = 0;
+        });
+      }
+    }
+    if (plan->outputs() != nullptr) {
+      for (size_t i = 0; i < plan->outputs()->size(); ++i) {
+        for_each_tensor_index(plan, plan->outputs()->Get(i), [&](size_t t) {
+          if (first_use[t] == kNotUsed) {
+            first_use[t] = timeline.num_instructions_ - 1;
+          }
+          last_use[t] = timeline.num_instructions_ - 1;
+        });
+      }
+    }
+  }
+
+  timeline.planned_bytes_.assign(
+      timeline.num_buffers_ * timeline.num_instructions_, 0);
+  for (size_t i = 0; i < n_values; ++i) {
+    if (first_use[i] == kNotUsed) {
+      continue;
+    }
+    const auto s_value = plan->values()->Get(i);
+    if (s_value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+      continue;
+    }
+    const auto s_tensor = s_value->val_as_Tensor();
+    const auto allocation_info = s_tensor->allocation_info();
+    if (allocation_info == nullptr || allocation_info->memory_id() == 0 ||
+        allocation_info->memory_id() > timeline.num_buffers_) {
+      continue;
+    }
+    size_t numel = 1;
+    if (s_tensor->sizes() != nullptr) {
+      for (size_t d = 0; d < s_tensor->sizes()->size(); ++d) {
+        numel *= static_cast<size_t>(s_tensor->sizes()->Get(d));
+      }
+    }
+    PlannedTensorLifetime tensor;
+    tensor.value_index = i;
+    tensor.buffer_index = allocation_info->memory_id() - 1;
+    tensor.offset = static_cast<size_t>(allocation_info->memory_offset_low()) |
+        (static_cast<size_t>(allocation_info->memory_offset_high()) << 32);
+    tensor.nbytes = numel *
+        elementSize(static_cast<exec_aten::ScalarType>(s_tensor->scalar_type()));
+    tensor.first_instruction = first_use[i];
+    tensor.last_instruction = last_use[i];
+    timeline.tensors_.push_back(tensor);
+
+    size_t* bytes = &timeline.planned_bytes_
+                         [tensor.buffer_index * timeline.num_instructions_];
+    for (size_t instr = tensor.first_instruction;
+         instr <= tensor.last_instruction;
+         ++instr) {
+      bytes[instr] += tensor.nbytes;
+    }
+  }
+
+  return timeline;
+}
+
+size_t MemoryTimeline::peak_instruction() const {
+  size_t peak = 0;
+  size_t peak_bytes = 0;
+  for (size_t instr = 0; instr < num_instructions_; ++instr) {
+    size_t bytes = 0;
+    for (size_t buffer = 0; buffer < num_buffers_; ++buffer) {
+      bytes += planned_bytes(buffer, instr);
+    }
+    if (bytes > peak_bytes) {
+      peak = instr;
+      peak_bytes = bytes;
+    }
+  }
+  return peak;
+}
+
+Error MemoryTimeline::record_allocator_usage(
+    const Method& method,
+    size_t method_allocator_bytes) {
+  std::vector<size_t> temp_bytes;
+  temp_bytes.reserve(num_instructions_);
+  for (size_t c = 0; c < chain_sizes_.size(); ++c) {
+    for (size_t i = 0; i < chain_sizes_[c]; ++i) {
+      Result<size_t> peak = method.instruction_temp_memory_peak_bytes(c, i);
+      ET_CHECK_OR_RETURN_ERROR(
+          peak.ok(),
+          InvalidArgument,
+          "Method has no instruction %zu in chain %zu",
+          i,
+          c);
+      temp_bytes.push_back(peak.get());
+    }
+  }
+  temp_bytes_ = std::move(temp_bytes);
+  method_allocator_bytes_ = method_allocator_bytes;
+  return Error::Ok;
+}
+
+std::string MemoryTimeline::to_chrome_trace() const {
+  // Planned buffers are tracks 0..num_buffers_-1 of process 0, the allocators
+  // are counters of process 1.
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  append_format(
+      json,
+      "{\"ph\":\"M\",\"pid\":0,\"name\":\"process_name\","
+      "\"args\":{\"name\":\"Planned memory (%s)\"}},\n"
+      "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+      "\"args\":{\"name\":\"Allocators (%s)\"}}",
+      method_name_.c_str(),
+      method_name_.c_str());
+  for (size_t buffer = 0; buffer < num_buffers_; ++buffer) {
+    append_format(
+        json,
+        ",\n{\"ph\":\"M\",\"pid\":0,\"tid\":%zu,\"name\":\"thread_name\","
+        "\"args\":{\"name\":\"Buffer %zu\"}}",
+        buffer,
+        buffer);
+  }
+
+  // Tensors are async slices so that Perfetto lays out the overlapping ones
+  // in separate rows.
+  for (const PlannedTensorLifetime& tensor : tensors_) {
+    append_format(
+        json,
+        ",\n{\"ph\":\"b\",\"pid\":0,\"tid\":%zu,\"cat\":\"buffer_%zu\","
+        "\"id\":%zu,\"name\":\"value %zu\",\"ts\":%zu,"
+        "\"args\":{\"offset\":%zu,\"nbytes\":%zu}}",
+        tensor.buffer_index,
+        tensor.buffer_index,
+        tensor.value_index,
+        tensor.value_index,
+        tensor.first_instruction,
+        tensor.offset,
+        tensor.nbytes);
+    append_format(
+        json,
+        ",\n{\"ph\":\"e\",\"pid\":0,\"tid\":%zu,\"cat\":\"buffer_%zu\","
+        "\"id\":%zu,\"name\":\"value %zu\",\"ts\":%zu}",
+        tensor.buffer_index,
+        tensor.buffer_index,
+        tensor.value_index,
+        tensor.value_index,
+        tensor.last_instruction + 1);
+  }
+
+  for (size_t instr = 0; instr < num_instructions_; ++instr) {
+    for (size_t buffer = 0; buffer < num_buffers_; ++buffer) {
+      append_format(
+          json,
+          ",\n{\"ph\":\"C\",\"pid\":0,\"name\":\"buffer_%zu_live_bytes\","
+          "\"ts\":%zu,\"args\":{\"bytes\":%zu}}",
+          buffer,
+          instr,
+          planned_bytes(buffer, instr));
+    }
+    append_format(
+        json,
+        ",\n{\"ph\":\"C\",\"pid\":1,\"name\":\"temp_allocator_bytes\","
+        "\"ts\":%zu,\"args\":{\"bytes\":%zu}}",
+        instr,
+        temp_bytes(instr));
+  }
+  append_format(
+      json,
+      ",\n{\"ph\":\"C\",\"pid\":1,\"name\":\"method_allocator_bytes\","
+      "\"ts\":0,\"args\":{\"bytes\":%zu}}",
+      method_allocator_bytes_);
+  json += "\n]}\n";
+  return json;
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method.h>
+
+namespace torch {
+namespace executor {
+
+/// Where a memory-planned tensor lives, and when.
+struct PlannedTensorLifetime {
+  /// Index of the tensor in the values of the method.
+  size_t value_index;
+  /// Index of the planned buffer, as in MethodMeta::memory_planned_buffer_size.
+  size_t buffer_index;
+  /// Offset of the tensor data in the buffer.
+  size_t offset;
+  /// Size of the tensor data, for the upper bound shape if it is dynamic.
+  size_t nbytes;
+  /// First and last instruction that use the tensor, counted across chains.
+  /// Inputs are live from the first instruction and outputs until the last.
+  size_t first_instruction;
+  size_t last_instruction;
+};
+
+/**
+ * How the memory of a method is used over its instructions, to find the ops
+ * responsible for its peak memory and tune memory planning.
+ *
+ * The lifetimes of memory-planned tensors are read from the program: a tensor
+ * is live from the first to the last instruction whose arguments reference
+ * it. Instructions are numbered across the chains of the method, in order,
+ * and jumps are ignored. The usage of the method and temp allocators comes
+ * from a Method loaded from the same program, see record_allocator_usage().
+ *
+ * This is a development tool: it allocates, and expects a program that has
+ * already been loaded successfully.
+ */
+class MemoryTimeline final {
+ public:
+  /**
+   * Computes the lifetimes of the planned tensors of a method.
+   *
+   * @param[in] program_data The serialized program, as in a .pte file. Must be
+   *     aligned like Program::load() requires, and only needs to outlive this
+   *     call.
+   * @param[in] program_size Size of program_data in bytes.
+   * @param[in] method_name The method to look at.
+   *
+   * @retval Error::InvalidProgram The data is not a valid program.
+   * @retval Error::InvalidArgument The program has no such method.
+   */
+  ET_NODISCARD static Result<MemoryTimeline> load(
+      const void* program_data,
+      size_t program_size,
+      const char* method_name);
+
+  /// Number of instructions in all the chains of the method.
+  size_t num_instructions() const {
+    return num_instructions_;
+  }
+
+  /// Number of memory-planned buffers.
+  size_t num_buffers() const {
+    return num_buffers_;
+  }
+
+  /// The memory-planned tensors, by value index.
+  const std::vector<PlannedTensorLifetime>& tensors() const {
+    return tensors_;
+  }
+
+  /**
+   * Bytes of planned tensors live in a buffer during an instruction. Tensors
+   * that alias the same memory are counted separately.
+   */
+  size_t planned_bytes(size_t buffer_index, size_t instruction) const {
+    return planned_bytes_[buffer_index * num_instructions_ + instruction];
+  }
+
+  /// Instruction with the most planned bytes live in all buffers.
+  size_t peak_instruction() const;
+
+  /**
+   * Records how much the allocators of a method loaded from the same program
+   * hold. The temp allocator usage is the peak of each instruction over the
+   * executions so far, see Method::instruction_temp_memory_peak_bytes(), so
+   * the method should have been executed on representative inputs.
+   *
+   * @param[in] method The loaded method.
+   * @param[in] method_allocator_bytes MemoryAllocator::used_size() of the
+   *     method allocator after loading the method.
+   *
+   * @retval Error::InvalidArgument The method does not have the same
+   *     instructions as the one this timeline was loaded from.
+   */
+  ET_NODISCARD Error
+  record_allocator_usage(const Method& method, size_t method_allocator_bytes);
+
+  /// Temp allocator bytes used by an instruction, 0 until recorded.
+  size_t temp_bytes(size_t instruction) const {
+    return temp_bytes_.empty() ? 0 : temp_bytes_[instruction];
+  }
+
+  /**
+   * Returns the timeline in the Chrome trace event JSON format, to open in
+   * Perfetto (ui.perfetto.dev) or chrome://tracing. Time is the instruction
+   * index, one microsecond per instruction. Each planned buffer has a counter
+   * of its live bytes and a track with the lifetime, offset and size of each of
+   * its tensors; the temp and method allocators have counters too.
+   */
+  std::string to_chrome_trace() const;
+
+ private:
+  MemoryTimeline() = default;
+
+  std::string method_name_;
+  size_t num_instructions_ = 0;
+  size_t num_buffers_ = 0;
+  // Instruction counts of the chains, to find instructions in a Method.
+  std::vector<size_t> chain_sizes_;
+  std::vector<PlannedTensorLifetime> tensors_;
+  // Indexed by buffer_index * num_instructions_ + instruction.
+  std::vector<size_t> planned_bytes_;
+  std::vector<size_t> temp_bytes_;
+  size_t method_allocator_bytes_ = 0;
+};
+
+} // namespace executor
+} // namespace torch
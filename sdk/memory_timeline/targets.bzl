@@ -0,0 +1,29 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_library(
+        name = "memory_timeline",
+        srcs = [
+            "memory_timeline.cpp",
+        ],
+        exported_headers = [
+            "memory_timeline.h",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+            "//executorch/schema:program",
+        ],
+        exported_deps = [
+            "//executorch/runtime/executor:program",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/memory_timeline/memory_timeline.h>
+#include <executorch/util/util.h>
+
+using namespace ::testing;
+using executorch::runtime::testing::ManagedMemoryManager;
+using torch::executor::DataLoader;
+using torch::executor::Error;
+using torch::executor::FreeableBuffer;
+using torch::executor::MemoryTimeline;
+using torch::executor::Method;
+using torch::executor::PlannedTensorLifetime;
+using torch::executor::Program;
+using torch::executor::Result;
+using torch::executor::util::FileDataLoader;
+
+constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
+constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024U;
+
+class MemoryTimelineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+
+    const char* path = std::getenv("ET_MODULE_ADD_PATH");
+    Result<FileDataLoader> loader = FileDataLoader::from(path);
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+
+    Result<size_t> size = loader_->size();
+    ASSERT_EQ(size.error(), Error::Ok);
+    Result<FreeableBuffer> data = loader_->load(
+        0,
+        size.get(),
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(data.error(), Error::Ok);
+    program_data_ = std::make_unique<FreeableBuffer>(std::move(data.get()));
+  }
+
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<FreeableBuffer> program_data_;
+};
+
+TEST_F(MemoryTimelineTest, ComputesTensorLifetimes) {
+  Result<MemoryTimeline> timeline = MemoryTimeline::load(
+      program_data_->data(), program_data_->size(), "forward");
+  ASSERT_EQ(timeline.error(), Error::Ok);
+
+  ASSERT_GT(timeline->num_instructions(), 0);
+  ASSERT_GT(timeline->num_buffers(), 0);
+  // The two inputs and the output of ModuleAdd are planned 2x2 float tensors.
+  ASSERT_GE(timeline->tensors().size(), 3);
+  size_t total_bytes = 0;
+  for (const PlannedTensorLifetime& tensor : timeline->tensors()) {
+    EXPECT_EQ(tensor.nbytes, 16);
+    EXPECT_LE(tensor.first_instruction, tensor.last_instruction);
+    EXPECT_LT(tensor.last_instruction, timeline->num_instructions());
+    EXPECT_LT(tensor.buffer_index, timeline->num_buffers());
+    total_bytes += tensor.nbytes;
+  }
+
+  // Nothing is live in addition to the planned tensors.
+  const size_t peak = timeline->peak_instruction();
+  ASSERT_LT(peak, timeline->num_instructions());
+  size_t peak_bytes = 0;
+  for (size_t buffer = 0; buffer < timeline->num_buffers(); ++buffer) {
+    peak_bytes += timeline->planned_bytes(buffer, peak);
+  }
+  EXPECT_GT(peak_bytes, 0);
+  EXPECT_LE(peak_bytes, total_bytes);
+
+  const std::string json = timeline->to_chrome_trace();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+  EXPECT_NE(json.find("\"buffer_0_live_bytes\""), std::string::npos);
+}
+
+TEST_F(MemoryTimelineTest, RecordsAllocatorUsage) {
+  Result<Program> program = Program::load(loader_.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  torch::executor::util::FreeInputs(inputs);
+
+  Result<MemoryTimeline> timeline = MemoryTimeline::load(
+      program_data_->data(), program_data_->size(), "forward");
+  ASSERT_EQ(timeline.error(), Error::Ok);
+  const size_t method_allocator_bytes =
+      mmm.get().method_allocator()->used_size();
+  EXPECT_EQ(
+      timeline->record_allocator_usage(method.get(), method_allocator_bytes),
+      Error::Ok);
+  // Portable add does not use the temp allocator.
+  for (size_t i = 0; i < timeline->num_instructions(); ++i) {
+    EXPECT_EQ(timeline->temp_bytes(i), 0);
+  }
+  EXPECT_NE(
+      timeline->to_chrome_trace().find("\"method_allocator_bytes\""),
+      std::string::npos);
+}
+
+TEST_F(MemoryTimelineTest, RejectsUnknownMethod) {
+  Result<MemoryTimeline> timeline = MemoryTimeline::load(
+      program_data_->data(), program_data_->size(), "not_a_method");
+  EXPECT_EQ(timeline.error(), Error::InvalidArgument);
+}
+
+TEST_F(MemoryTimelineTest, RejectsInvalidProgram) {
+  const uint32_t data[8] = {};
+  Result<MemoryTimeline> timeline =
+      MemoryTimeline::load(data, sizeof(data), "forward");
+  EXPECT_EQ(timeline.error(), Error::InvalidProgram);
+}
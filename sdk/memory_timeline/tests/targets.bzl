@@ -0,0 +1,28 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets(is_fbcode = False):
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # The test loads a program exported in fbcode, like the tests of
+    # //executorch/runtime/executor/test.
+    if not runtime.is_oss and is_fbcode:
+        runtime.cxx_test(
+            name = "memory_timeline_test",
+            srcs = [
+                "memory_timeline_test.cpp",
+            ],
+            deps = [
+                "//executorch/sdk/memory_timeline:memory_timeline",
+                "//executorch/runtime/executor/test:managed_memory_manager",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/kernels/portable:generated_lib",
+                "//executorch/util:util",
+            ],
+            env = {
+                "ET_MODULE_ADD_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAdd.pte])",
+            },
+        )
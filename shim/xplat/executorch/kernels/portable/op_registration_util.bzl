@@ -462,6 +462,12 @@ ATEN_OPS = (
             ":scalar_utils",
         ],
     ),
+    op_target(
+        name = "op_elementwise_chain",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:parallel_util",
+        ],
+    ),
     op_target(
         name = "op_embedding",
         deps = [
@@ -749,6 +755,12 @@ ATEN_OPS = (
             ":scalar_utils",
         ],
     ),
+    op_target(
+        name = "op_max_pool2d",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_max_pool2d_with_indices",
         deps = [
@@ -1110,6 +1122,12 @@ ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:copy_ops_util",
         ],
     ),
+    op_target(
+        name = "op_topk",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:topk_util",
+        ],
+    ),
     op_target(
         name = "op_transpose_copy",
         deps = ["//executorch/kernels/portable/cpu/util:transpose_util"],
@@ -1138,6 +1156,18 @@ ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:copy_ops_util",
         ],
     ),
+    op_target(
+        name = "op_upsample_bilinear2d",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_nearest2d",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
     op_target(
         name = "op_var",
         deps = [
@@ -88,6 +88,34 @@ class ModuleAdd(nn.Module):
         return (torch.randn(2, 2), torch.randn(2, 2), 1.0)
 
 
+class ModuleIndependentOps(nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x, y):
+        # None of the ops reads the output of another, so they can run in
+        # parallel.
+        return torch.add(x, y), torch.mul(x, y), torch.sub(x, y)
+
+    def get_random_inputs(self):
+        return (torch.randn(2, 2), torch.randn(2, 2))
+
+
+class ModuleMap(nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, xs, y):
+        def f(x, y):
+            return x + y
+
+        # Emitted as a loop with one iteration per row of xs.
+        return torch.ops.higher_order.map(f, xs, y)
+
+    def get_random_inputs(self):
+        return (torch.randn(5, 2), torch.randn(2))
+
+
 class ModuleAddHalf(nn.Module):
     def __init__(self):
         super().__init__()
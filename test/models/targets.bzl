@@ -65,6 +65,8 @@ def define_common_targets():
         "ModuleLinear",
         "ModuleMultipleEntry",
         "ModuleIndex",
+        "ModuleIndependentOps",
+        "ModuleMap",
         "ModuleDynamicCatUnallocatedIO",
         "ModuleSimpleTrain",
     ]